@@ -24,6 +24,8 @@
 
 #define GLM_FORCE_RADIANS
 
+#include <cstdint>
+#include <cstring>
 #include <fstream>
 #include <iostream>
 #include <iterator>
@@ -36,14 +38,6 @@
 #include <wx/log.h>
 #include <wx/stdpaths.h>
 
-#include <boost/version.hpp>
-
-#if BOOST_VERSION >= 106800
-#include <boost/uuid/detail/sha1.hpp>
-#else
-#include <boost/uuid/sha1.hpp>
-#endif
-
 #include <glm/glm.hpp>
 #include <glm/ext.hpp>
 
@@ -57,23 +51,29 @@
 #include <filename_resolver.h>
 #include <pgm_base.h>
 #include <project.h>
+#include <richio.h>
 #include <settings/settings_manager.h>
+#include <streamwrapper.h>
+#include <thread_pool.h>
 
 
 #define MASK_3D_CACHE "3D_CACHE"
 
 static std::mutex mutex3D_cache;
 static std::mutex mutex3D_cacheManager;
+static std::mutex mutex3D_cacheFile;
+static std::mutex mutex3D_cacheIndex;
 
+/// the name, in the cache directory, of the index of the model file hashes
+#define CACHE_INDEX_FILE wxT( "hashes.idx" )
 
-static bool isSHA1Same( const unsigned char* shaA, const unsigned char* shaB ) noexcept
-{
-    for( int i = 0; i < 20; ++i )
-        if( shaA[i] != shaB[i] )
-            return false;
+/// the first bytes of a render data (.3dr) file, and the version of its layout
+static const char     RENDER_DATA_MAGIC[8] = { 'K', 'I', 'C', 'A', 'D', '3', 'D', 'R' };
+static const uint32_t RENDER_DATA_VERSION = 1;
 
-    return true;
-}
+/// the flags of the optional arrays of a mesh in a render data file
+#define RENDER_DATA_TEXCOORDS 1
+#define RENDER_DATA_COLORS    2
 
 
 static bool checkTag( const char* aTag, void* aPluginMgrPtr )
@@ -87,40 +87,127 @@ static bool checkTag( const char* aTag, void* aPluginMgrPtr )
 }
 
 
-static const wxString sha1ToWXString( const unsigned char* aSHA1Sum )
+static const wxString hashToWXString( uint64_t aHash )
 {
-    unsigned char uc;
-    unsigned char tmp;
-    char          sha1[41];
-    int           j = 0;
+    char hex[17];
+
+    snprintf( hex, sizeof( hex ), "%016llx", (unsigned long long) aHash );
+
+    return wxString::FromUTF8Unchecked( hex );
+}
+
+
+/**
+ * Compute a MurmurHash64A style hash of a file, read by blocks of 4096 bytes.  The hash
+ * only names the cache files and need not be cryptographic: it is several times faster
+ * than a SHA1 digest, which matters for the large STEP models.
+ */
+static bool hashFile( const wxString& aFileName, uint64_t& aHash )
+{
+    #ifdef _WIN32
+    FILE* fp = _wfopen( aFileName.wc_str(), L"rb" );
+    #else
+    FILE* fp = fopen( aFileName.ToUTF8(), "rb" );
+    #endif
+
+    if( NULL == fp )
+        return false;
 
-    for( int i = 0; i < 20; ++i )
+    const uint64_t m = 0xc6a4a7935bd1e995ULL;
+    const int      r = 47;
+    uint64_t       h = 0x3d4d4f44454c5321ULL;
+    uint64_t       length = 0;
+    unsigned char  block[4096];
+    size_t         bsize = 0;
+
+    while( ( bsize = fread( block, 1, sizeof( block ), fp ) ) > 0 )
     {
-        uc = aSHA1Sum[i];
-        tmp = uc / 16;
+        size_t nwords = bsize / 8;
 
-        if( tmp > 9 )
-            tmp += 87;
-        else
-            tmp += 48;
+        for( size_t i = 0; i < nwords; ++i )
+        {
+            uint64_t k;
+            memcpy( &k, block + i * 8, 8 );
 
-        sha1[j++] = tmp;
-        tmp = uc % 16;
+            k *= m;
+            k ^= k >> r;
+            k *= m;
 
-        if( tmp > 9 )
-            tmp += 87;
-        else
-            tmp += 48;
+            h ^= k;
+            h *= m;
+        }
+
+        // the tail is only ever found in the last block of a regular file
+        if( size_t tail = bsize & 7 )
+        {
+            for( size_t i = 0; i < tail; ++i )
+                h ^= (uint64_t) block[nwords * 8 + i] << ( 8 * i );
+
+            h *= m;
+        }
 
-        sha1[j++] = tmp;
+        length += bsize;
     }
 
-    sha1[j] = 0;
+    bool ok = !ferror( fp );
+    fclose( fp );
+
+    // the length is mixed at the end rather than in the seed, as the file is streamed
+    h ^= length * m;
+    h ^= h >> r;
+    h *= m;
+    h ^= h >> r;
 
-    return wxString::FromUTF8Unchecked( sha1 );
+    aHash = h;
+    return ok;
 }
 
 
+/**
+ * The bytes of a file mapped in memory, with the mapping code of MAPPED_FILE_LINE_READER.
+ */
+class MAPPED_CACHE_FILE : public MAPPED_FILE_LINE_READER
+{
+public:
+    MAPPED_CACHE_FILE( const wxString& aFileName ) :
+            MAPPED_FILE_LINE_READER( aFileName ),
+            m_pos( 0 )
+    {}
+
+    /// Copy the next @a aSize bytes of the file to @a aDest; false past the end of the file
+    bool Read( void* aDest, size_t aSize )
+    {
+        if( !Has( aSize, 1 ) )
+            return false;
+
+        memcpy( aDest, m_data + m_pos, aSize );
+        m_pos += aSize;
+        return true;
+    }
+
+    /// @return true if there are @a aCount objects of @a aSize bytes left in the file
+    bool Has( size_t aCount, size_t aSize ) const
+    {
+        return aCount <= ( m_size - m_pos ) / aSize;
+    }
+
+    /// Read an array of @a aCount objects into a new[] array, NULL on error
+    template <typename T>
+    T* ReadArray( size_t aCount )
+    {
+        if( !Has( aCount, sizeof( T ) ) )
+            return NULL;
+
+        T* array = new T[aCount];
+        Read( array, aCount * sizeof( T ) );
+        return array;
+    }
+
+private:
+    size_t m_pos;
+};
+
+
 class S3D_CACHE_ENTRY
 {
 private:
@@ -128,28 +215,34 @@ private:
     S3D_CACHE_ENTRY( const S3D_CACHE_ENTRY& source );
     S3D_CACHE_ENTRY& operator=( const S3D_CACHE_ENTRY& source );
 
-    wxString m_CacheBaseName;  // base name of cache file (a SHA1 digest)
+    wxString m_CacheBaseName;  // base name of cache files (the file hash)
 
 public:
     S3D_CACHE_ENTRY();
     ~S3D_CACHE_ENTRY();
 
-    void SetSHA1( const unsigned char* aSHA1Sum );
+    void SetHash( uint64_t aHash );
     const wxString GetCacheBaseName();
 
+    wxString      fileName;     // full path of the model file
     wxDateTime    modTime;      // file modification time
-    unsigned char sha1sum[20];
+    long long     fileSize;
+    uint64_t      hash;
+    bool          sceneLoaded;  // has the scene data been searched for (it may be NULL) ?
     std::string   pluginInfo;   // PluginName:Version string
     SCENEGRAPH*   sceneData;
     S3DMODEL*     renderData;
+    std::mutex    lock;         // held while the entry is loaded or checked
 };
 
 
 S3D_CACHE_ENTRY::S3D_CACHE_ENTRY()
 {
+    fileSize = -1;
+    hash = 0;
+    sceneLoaded = false;
     sceneData = NULL;
     renderData = NULL;
-    memset( sha1sum, 0, 20 );
 }
 
 
@@ -162,24 +255,17 @@ S3D_CACHE_ENTRY::~S3D_CACHE_ENTRY()
 }
 
 
-void S3D_CACHE_ENTRY::SetSHA1( const unsigned char* aSHA1Sum )
+void S3D_CACHE_ENTRY::SetHash( uint64_t aHash )
 {
-    if( NULL == aSHA1Sum )
-    {
-        wxLogTrace( MASK_3D_CACHE, "%s:%s:%d\n * [BUG] NULL passed for aSHA1Sum",
-                    __FILE__, __FUNCTION__, __LINE__ );
-
-        return;
-    }
-
-    memcpy( sha1sum, aSHA1Sum, 20 );
+    hash = aHash;
+    m_CacheBaseName.clear();
 }
 
 
 const wxString S3D_CACHE_ENTRY::GetCacheBaseName()
 {
     if( m_CacheBaseName.empty() )
-        m_CacheBaseName = sha1ToWXString( sha1sum );
+        m_CacheBaseName = hashToWXString( hash );
 
     return m_CacheBaseName;
 }
@@ -190,11 +276,56 @@ S3D_CACHE::S3D_CACHE()
     m_FNResolver = new FILENAME_RESOLVER;
     m_project = nullptr;
     m_Plugins = new S3D_PLUGIN_MANAGER;
+    m_FileHashesLoaded = false;
+    m_FileHashesDirty = false;
+
+    m_memoryAccount.Set( "3D models",
+            [this]()
+            {
+                MEMORY_ACCOUNTING::USAGE    usage;
+                std::lock_guard<std::mutex> lock( mutex3D_cache );
+
+                for( S3D_CACHE_ENTRY* entry : m_CacheList )
+                {
+                    usage.m_Items++;
+
+                    // An entry being loaded is not counted
+                    std::unique_lock<std::mutex> entryLock( entry->lock, std::try_to_lock );
+
+                    if( !entryLock || !entry->renderData )
+                        continue;
+
+                    const S3DMODEL* model = entry->renderData;
+
+                    usage.m_Bytes += sizeof( S3DMODEL )
+                                     + model->m_MaterialsSize * sizeof( SMATERIAL );
+
+                    for( unsigned ii = 0; ii < model->m_MeshesSize; ii++ )
+                    {
+                        const SMESH& mesh = model->m_Meshes[ii];
+                        size_t       vertexSize = 2 * sizeof( SFVEC3F );
+
+                        if( mesh.m_Texcoords )
+                            vertexSize += sizeof( SFVEC2F );
+
+                        if( mesh.m_Color )
+                            vertexSize += sizeof( SFVEC3F );
+
+                        usage.m_Bytes += sizeof( SMESH ) + mesh.m_VertexSize * vertexSize
+                                         + mesh.m_FaceIdxSize * sizeof( unsigned int );
+                    }
+                }
+
+                return usage;
+            } );
 }
 
 
 S3D_CACHE::~S3D_CACHE()
 {
+    m_memoryAccount.Reset();
+
+    saveHashIndex();
     FlushCache();
 
     delete m_FNResolver;
@@ -202,7 +333,8 @@ S3D_CACHE::~S3D_CACHE()
 }
 
 
-SCENEGRAPH* S3D_CACHE::load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCachePtr )
+SCENEGRAPH* S3D_CACHE::load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCachePtr,
+                             bool aNeedScene )
 {
     if( aCachePtr )
         *aCachePtr = NULL;
@@ -217,57 +349,84 @@ SCENEGRAPH* S3D_CACHE::load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCach
         return NULL;
     }
 
-    // check cache if file is already loaded
-    std::lock_guard<std::mutex> lock( mutex3D_cache );
+    // check cache if file is already loaded.  The map is only locked to find or add the
+    // entry, so that distinct models are loaded concurrently.
+    S3D_CACHE_ENTRY*             ep = NULL;
+    std::unique_lock<std::mutex> entryLock;
 
-    std::map< wxString, S3D_CACHE_ENTRY*, rsort_wxString >::iterator mi;
-    mi = m_CacheMap.find( full3Dpath );
+    {
+        std::lock_guard<std::mutex> lock( mutex3D_cache );
+
+        std::map< wxString, S3D_CACHE_ENTRY*, rsort_wxString >::iterator mi;
+        mi = m_CacheMap.find( full3Dpath );
+
+        if( mi == m_CacheMap.end() )
+        {
+            // a cache item does not exist; lock it before anyone else can see it
+            ep = new S3D_CACHE_ENTRY;
+            entryLock = std::unique_lock<std::mutex>( ep->lock );
+
+            m_CacheList.push_back( ep );
+            m_CacheMap.insert( std::pair< wxString, S3D_CACHE_ENTRY* >( full3Dpath, ep ) );
+
+            if( NULL != aCachePtr )
+                *aCachePtr = ep;
+        }
+        else
+        {
+            ep = mi->second;
+        }
+    }
 
-    if( mi != m_CacheMap.end() )
+    if( entryLock )
+    {
+        // a new entry: hash the file to find its cache files
+        ep->fileName = full3Dpath;
+        checkCache( full3Dpath, ep );
+    }
+    else
     {
+        entryLock = std::unique_lock<std::mutex>( ep->lock );
+
         wxFileName fname( full3Dpath );
 
         if( fname.FileExists() )    // Only check if file exists. If not, it will
         {                           // use the same model in cache.
-            bool reload = false;
             wxDateTime fmdate = fname.GetModificationTime();
+            long long  fsize = fname.GetSize().GetValue();
+            uint64_t   hash = 0;
 
-            if( fmdate != mi->second->modTime )
+            if( fmdate != ep->modTime || fsize != ep->fileSize )
             {
-                unsigned char hashSum[20];
-                getSHA1( full3Dpath, hashSum );
-                mi->second->modTime = fmdate;
+                ep->modTime = fmdate;
+                ep->fileSize = fsize;
 
-                if( !isSHA1Same( hashSum, mi->second->sha1sum ) )
+                if( getHash( full3Dpath, fmdate, fsize, hash ) && hash != ep->hash )
                 {
-                    mi->second->SetSHA1( hashSum );
-                    reload = true;
-                }
-            }
+                    ep->SetHash( hash );
 
-            if( reload )
-            {
-                if( NULL != mi->second->sceneData )
-                {
-                    S3D::DestroyNode( mi->second->sceneData );
-                    mi->second->sceneData = NULL;
-                }
+                    if( NULL != ep->sceneData )
+                    {
+                        S3D::DestroyNode( ep->sceneData );
+                        ep->sceneData = NULL;
+                    }
 
-                if( NULL != mi->second->renderData )
-                    S3D::Destroy3DModel( &mi->second->renderData );
+                    if( NULL != ep->renderData )
+                        S3D::Destroy3DModel( &ep->renderData );
 
-                mi->second->sceneData = m_Plugins->Load3DModel( full3Dpath, mi->second->pluginInfo );
+                    ep->sceneLoaded = false;
+                }
             }
         }
+    }
 
-        if( NULL != aCachePtr )
-            *aCachePtr = mi->second;
+    if( aNeedScene && !ep->sceneLoaded )
+        loadScene( ep );
 
-        return mi->second->sceneData;
-    }
+    if( NULL != aCachePtr )
+        *aCachePtr = ep;
 
-    // a cache item does not exist; search the Filename->Cachename map
-    return checkCache( full3Dpath, aCachePtr );
+    return ep->sceneData;
 }
 
 
@@ -277,79 +436,49 @@ SCENEGRAPH* S3D_CACHE::Load( const wxString& aModelFile )
 }
 
 
-SCENEGRAPH* S3D_CACHE::checkCache( const wxString& aFileName, S3D_CACHE_ENTRY** aCachePtr )
+bool S3D_CACHE::checkCache( const wxString& aFileName, S3D_CACHE_ENTRY* aCacheItem )
 {
-    if( aCachePtr )
-        *aCachePtr = NULL;
+    wxFileName fname( aFileName );
+    uint64_t   hash = 0;
 
-    unsigned char sha1sum[20];
+    aCacheItem->modTime = fname.GetModificationTime();
+    aCacheItem->fileSize = fname.GetSize().GetValue();
 
-    if( !getSHA1( aFileName, sha1sum ) || m_CacheDir.empty() )
+    if( !getHash( aFileName, aCacheItem->modTime, aCacheItem->fileSize, hash )
+            || m_CacheDir.empty() )
     {
         // just in case we can't get a hash digest (for example, on access issues)
-        // or we do not have a configured cache file directory, we create an
-        // entry to prevent further attempts at loading the file
-        S3D_CACHE_ENTRY* ep = new S3D_CACHE_ENTRY;
-        m_CacheList.push_back( ep );
-        wxFileName fname( aFileName );
-        ep->modTime = fname.GetModificationTime();
-
-        if( m_CacheMap.insert( std::pair< wxString, S3D_CACHE_ENTRY* >
-            ( aFileName, ep ) ).second == false )
-        {
-            wxLogTrace( MASK_3D_CACHE, "%s:%s:%d\n * [BUG] duplicate entry in map file; key = '%s'",
-                        __FILE__, __FUNCTION__, __LINE__, aFileName );
-
-            m_CacheList.pop_back();
-            delete ep;
-        }
-        else
-        {
-            if( aCachePtr )
-                *aCachePtr = ep;
-
-        }
-
-        return NULL;
+        // or we do not have a configured cache file directory, we keep the
+        // empty entry to prevent further attempts at loading the file
+        aCacheItem->sceneLoaded = true;
+        return false;
     }
 
-    S3D_CACHE_ENTRY* ep = new S3D_CACHE_ENTRY;
-    m_CacheList.push_back( ep );
-    wxFileName fname( aFileName );
-    ep->modTime = fname.GetModificationTime();
-
-    if( m_CacheMap.insert( std::pair< wxString, S3D_CACHE_ENTRY* >
-                               ( aFileName, ep ) ).second == false )
-    {
-        wxLogTrace( MASK_3D_CACHE, "%s:%s:%d\n * [BUG] duplicate entry in map file; key = '%s'",
-                    __FILE__, __FUNCTION__, __LINE__, aFileName );
-
-        m_CacheList.pop_back();
-        delete ep;
-        return NULL;
-    }
+    aCacheItem->SetHash( hash );
+    return true;
+}
 
-    if( aCachePtr )
-        *aCachePtr = ep;
 
-    ep->SetSHA1( sha1sum );
+void S3D_CACHE::loadScene( S3D_CACHE_ENTRY* aCacheItem )
+{
+    aCacheItem->sceneLoaded = true;
 
-    wxString bname = ep->GetCacheBaseName();
+    wxString bname = aCacheItem->GetCacheBaseName();
     wxString cachename = m_CacheDir + bname + wxT( ".3dc" );
 
-    if( wxFileName::FileExists( cachename ) && loadCacheData( ep ) )
-        return ep->sceneData;
-
-    ep->sceneData = m_Plugins->Load3DModel( aFileName, ep->pluginInfo );
+    if( wxFileName::FileExists( cachename ) && loadCacheData( aCacheItem ) )
+        return;
 
-    if( NULL != ep->sceneData )
-        saveCacheData( ep );
+    aCacheItem->sceneData = m_Plugins->Load3DModel( aCacheItem->fileName,
+                                                    aCacheItem->pluginInfo );
 
-    return ep->sceneData;
+    if( NULL != aCacheItem->sceneData )
+        saveCacheData( aCacheItem );
 }
 
 
-bool S3D_CACHE::getSHA1( const wxString& aFileName, unsigned char* aSHA1Sum )
+bool S3D_CACHE::getHash( const wxString& aFileName, const wxDateTime& aModTime,
+                         long long aFileSize, uint64_t& aHash )
 {
     if( aFileName.empty() )
     {
@@ -359,49 +488,102 @@ bool S3D_CACHE::getSHA1( const wxString& aFileName, unsigned char* aSHA1Sum )
         return false;
     }
 
-    if( NULL == aSHA1Sum )
+    long long modTime = aModTime.IsValid() ? aModTime.GetValue().GetValue() : 0;
+
     {
-        wxLogTrace( MASK_3D_CACHE, "%s\n * [BUG] NULL pointer passed for aMD5Sum",
-                    __FILE__, __FUNCTION__, __LINE__ );
+        std::lock_guard<std::mutex> lock( mutex3D_cacheIndex );
+
+        loadHashIndex();
+
+        auto it = m_FileHashes.find( aFileName );
 
+        // an unchanged file is not read again
+        if( it != m_FileHashes.end() && it->second.size == aFileSize
+                && it->second.modTime == modTime && aModTime.IsValid() )
+        {
+            aHash = it->second.hash;
+            return true;
+        }
+    }
+
+    // the files are hashed outside of the lock, so that LoadModels() hashes them concurrently
+    if( !hashFile( aFileName, aHash ) )
         return false;
+
+    std::lock_guard<std::mutex> lock( mutex3D_cacheIndex );
+
+    m_FileHashes[aFileName] = { aFileSize, modTime, aHash };
+    m_FileHashesDirty = true;
+
+    return true;
+}
+
+
+void S3D_CACHE::loadHashIndex()
+{
+    if( m_FileHashesLoaded || m_CacheDir.empty() )
+        return;
+
+    m_FileHashesLoaded = true;
+
+    wxString    fname = m_CacheDir + CACHE_INDEX_FILE;
+    std::string line;
+
+    OPEN_ISTREAM( index, fname.ToUTF8() );
+
+    // each line is "<hash> <size> <modification time> <file name>"
+    while( std::getline( index, line ) )
+    {
+        std::istringstream fields( line );
+        std::string        hash;
+        FILE_HASH          entry;
+
+        if( !( fields >> hash >> entry.size >> entry.modTime ) || hash.size() != 16 )
+            continue;
+
+        entry.hash = strtoull( hash.c_str(), NULL, 16 );
+
+        std::string name;
+        std::getline( fields >> std::ws, name );
+
+        if( !name.empty() )
+            m_FileHashes[wxString::FromUTF8( name.c_str() )] = entry;
     }
 
-    #ifdef _WIN32
-    FILE* fp = _wfopen( aFileName.wc_str(), L"rb" );
-    #else
-    FILE* fp = fopen( aFileName.ToUTF8(), "rb" );
-    #endif
+    CLOSE_STREAM( index );
+}
 
-    if( NULL == fp )
-        return false;
 
-    boost::uuids::detail::sha1 dblock;
-    unsigned char block[4096];
-    size_t bsize = 0;
+void S3D_CACHE::saveHashIndex()
+{
+    std::lock_guard<std::mutex> lock( mutex3D_cacheIndex );
+
+    if( !m_FileHashesDirty || m_CacheDir.empty() )
+        return;
 
-    while( ( bsize = fread( &block, 1, 4096, fp ) ) > 0 )
-        dblock.process_bytes( block, bsize );
+    wxString fname = m_CacheDir + CACHE_INDEX_FILE;
+    wxString tmpname = fname + wxT( ".tmp" );
 
-    fclose( fp );
-    unsigned int digest[5];
-    dblock.get_digest( digest );
+    OPEN_OSTREAM( index, tmpname.ToUTF8() );
 
-    // ensure MSB order
-    for( int i = 0; i < 5; ++i )
+    for( const auto& file : m_FileHashes )
     {
-        int idx = i << 2;
-        unsigned int tmp = digest[i];
-        aSHA1Sum[idx+3] = tmp & 0xff;
-        tmp >>= 8;
-        aSHA1Sum[idx+2] = tmp & 0xff;
-        tmp >>= 8;
-        aSHA1Sum[idx+1] = tmp & 0xff;
-        tmp >>= 8;
-        aSHA1Sum[idx] = tmp & 0xff;
+        index << hashToWXString( file.second.hash ).ToStdString() << ' '
+              << file.second.size << ' ' << file.second.modTime << ' '
+              << file.first.ToUTF8().data() << '\n';
     }
 
-    return true;
+    bool ok = index.good();
+    CLOSE_STREAM( index );
+
+    if( !ok )
+    {
+        wxLogTrace( MASK_3D_CACHE, " * [3D model] cannot write the hash index '%s'", tmpname );
+        return;
+    }
+
+    if( wxRenameFile( tmpname, fname, true ) )
+        m_FileHashesDirty = false;
 }
 
 
@@ -495,6 +677,9 @@ bool S3D_CACHE::saveCacheData( S3D_CACHE_ENTRY* aCacheItem )
         }
     }
 
+    // The writer renumbers the node names: one at a time
+    std::lock_guard<std::mutex> lock( mutex3D_cacheFile );
+
     return S3D::WriteCache( fname.ToUTF8(), true, (SGNODE*)aCacheItem->sceneData,
         aCacheItem->pluginInfo.c_str() );
 }
@@ -654,27 +839,202 @@ void S3D_CACHE::ClosePlugins()
 S3DMODEL* S3D_CACHE::GetModel( const wxString& aModelFileName )
 {
     S3D_CACHE_ENTRY* cp = NULL;
-    SCENEGRAPH* sp = load( aModelFileName, &cp );
 
-    if( !sp )
-        return NULL;
+    // the scene is not needed if the render data is in its cache file
+    load( aModelFileName, &cp, false );
 
     if( !cp )
-    {
-        wxLogTrace( MASK_3D_CACHE,
-                    "%s:%s:%d\n  * [BUG] model loaded with no associated S3D_CACHE_ENTRY",
-                    __FILE__, __FUNCTION__, __LINE__ );
-
         return NULL;
-    }
 
+    std::lock_guard<std::mutex> lock( cp->lock );
+
+    // the entry may have been reloaded since load() returned
     if( cp->renderData )
         return cp->renderData;
 
-    S3DMODEL* mp = S3D::GetModel( sp );
-    cp->renderData = mp;
+    if( !cp->sceneLoaded && loadRenderData( cp ) )
+        return cp->renderData;
+
+    if( !cp->sceneLoaded )
+        loadScene( cp );
+
+    if( !cp->sceneData )
+        return NULL;
+
+    cp->renderData = S3D::GetModel( cp->sceneData );
+
+    if( cp->renderData )
+        saveRenderData( cp );
+
+    return cp->renderData;
+}
+
+
+bool S3D_CACHE::loadRenderData( S3D_CACHE_ENTRY* aCacheItem )
+{
+    if( m_CacheDir.empty() )
+        return false;
+
+    wxString fname = m_CacheDir + aCacheItem->GetCacheBaseName() + wxT( ".3dr" );
+
+    if( !wxFileName::FileExists( fname ) )
+        return false;
+
+    S3DMODEL* model = S3D::New3DModel();
+    bool      ok = false;
+
+    try
+    {
+        MAPPED_CACHE_FILE file( fname );
+        char              magic[8];
+        uint32_t          header[3];    // version, materials and meshes
+
+        ok = file.Read( magic, sizeof( magic ) ) && !memcmp( magic, RENDER_DATA_MAGIC, 8 )
+             && file.Read( header, sizeof( header ) ) && header[0] == RENDER_DATA_VERSION
+             && file.Has( header[2], 4 * sizeof( uint32_t ) );
+
+        if( ok )
+        {
+            model->m_MaterialsSize = header[1];
+            model->m_Materials = file.ReadArray<SMATERIAL>( header[1] );
+            ok = header[1] == 0 || model->m_Materials;
+        }
+
+        if( ok )
+        {
+            model->m_MeshesSize = header[2];
+            model->m_Meshes = new SMESH[header[2]]();
+        }
+
+        for( unsigned int i = 0; ok && i < model->m_MeshesSize; ++i )
+        {
+            SMESH&   mesh = model->m_Meshes[i];
+            uint32_t sizes[4];          // vertices, face indices, material and flags
+
+            if( !file.Read( sizes, sizeof( sizes ) ) )
+            {
+                ok = false;
+                break;
+            }
+
+            mesh.m_VertexSize = sizes[0];
+            mesh.m_FaceIdxSize = sizes[1];
+            mesh.m_MaterialIdx = sizes[2];
+
+            mesh.m_Positions = file.ReadArray<SFVEC3F>( sizes[0] );
+            mesh.m_Normals = file.ReadArray<SFVEC3F>( sizes[0] );
+
+            if( sizes[3] & RENDER_DATA_TEXCOORDS )
+                mesh.m_Texcoords = file.ReadArray<SFVEC2F>( sizes[0] );
+
+            if( sizes[3] & RENDER_DATA_COLORS )
+                mesh.m_Color = file.ReadArray<SFVEC3F>( sizes[0] );
+
+            mesh.m_FaceIdx = file.ReadArray<unsigned int>( sizes[1] );
+
+            ok = mesh.m_Positions && mesh.m_Normals && mesh.m_FaceIdx
+                 && ( !( sizes[3] & RENDER_DATA_TEXCOORDS ) || mesh.m_Texcoords )
+                 && ( !( sizes[3] & RENDER_DATA_COLORS ) || mesh.m_Color )
+                 && mesh.m_MaterialIdx < model->m_MaterialsSize;
+
+            // the renderers index the arrays without checking
+            for( unsigned int j = 0; ok && j < mesh.m_FaceIdxSize; ++j )
+                ok = mesh.m_FaceIdx[j] < mesh.m_VertexSize;
+        }
+    }
+    catch( const IO_ERROR& )
+    {
+        ok = false;
+    }
+
+    if( !ok )
+    {
+        wxLogTrace( MASK_3D_CACHE, " * [3D model] invalid render data file '%s'", fname );
+        S3D::Destroy3DModel( &model );
+        return false;
+    }
+
+    aCacheItem->renderData = model;
+    return true;
+}
+
+
+bool S3D_CACHE::saveRenderData( S3D_CACHE_ENTRY* aCacheItem )
+{
+    if( m_CacheDir.empty() )
+        return false;
+
+    const S3DMODEL* model = aCacheItem->renderData;
+    wxString        fname = m_CacheDir + aCacheItem->GetCacheBaseName() + wxT( ".3dr" );
+    wxString        tmpname = fname + wxT( ".tmp" );
+
+    // two models with the same contents share their cache files
+    std::lock_guard<std::mutex> lock( mutex3D_cacheFile );
+
+    #ifdef _WIN32
+    FILE* fp = _wfopen( tmpname.wc_str(), L"wb" );
+    #else
+    FILE* fp = fopen( tmpname.ToUTF8(), "wb" );
+    #endif
+
+    if( NULL == fp )
+        return false;
+
+    uint32_t header[3] = { RENDER_DATA_VERSION, model->m_MaterialsSize, model->m_MeshesSize };
+    bool     ok = fwrite( RENDER_DATA_MAGIC, sizeof( RENDER_DATA_MAGIC ), 1, fp ) == 1
+                  && fwrite( header, sizeof( header ), 1, fp ) == 1;
+
+    if( ok && model->m_MaterialsSize )
+        ok = fwrite( model->m_Materials, sizeof( SMATERIAL ), model->m_MaterialsSize, fp )
+             == model->m_MaterialsSize;
+
+    for( unsigned int i = 0; ok && i < model->m_MeshesSize; ++i )
+    {
+        const SMESH& mesh = model->m_Meshes[i];
+        uint32_t     sizes[4] = { mesh.m_VertexSize, mesh.m_FaceIdxSize, mesh.m_MaterialIdx, 0 };
+
+        if( mesh.m_Texcoords )
+            sizes[3] |= RENDER_DATA_TEXCOORDS;
+
+        if( mesh.m_Color )
+            sizes[3] |= RENDER_DATA_COLORS;
+
+        auto write = [&]( const void* aData, size_t aSize, size_t aCount )
+        {
+            return aCount == 0 || fwrite( aData, aSize, aCount, fp ) == aCount;
+        };
+
+        ok = write( sizes, sizeof( sizes ), 1 )
+             && write( mesh.m_Positions, sizeof( SFVEC3F ), mesh.m_VertexSize )
+             && write( mesh.m_Normals, sizeof( SFVEC3F ), mesh.m_VertexSize )
+             && ( !mesh.m_Texcoords
+                  || write( mesh.m_Texcoords, sizeof( SFVEC2F ), mesh.m_VertexSize ) )
+             && ( !mesh.m_Color || write( mesh.m_Color, sizeof( SFVEC3F ), mesh.m_VertexSize ) )
+             && write( mesh.m_FaceIdx, sizeof( unsigned int ), mesh.m_FaceIdxSize );
+    }
+
+    ok = ( fclose( fp ) == 0 ) && ok;
+
+    if( !ok || !wxRenameFile( tmpname, fname, true ) )
+    {
+        wxLogTrace( MASK_3D_CACHE, " * [3D model] cannot write render data file '%s'", fname );
+        wxRemoveFile( tmpname );
+        return false;
+    }
+
+    return true;
+}
+
+
+void S3D_CACHE::LoadModels( const std::vector<wxString>& aModelFileNames )
+{
+    THREAD_POOL::GetInstance().ParallelFor( aModelFileNames.size(),
+            [&]( size_t i )
+            {
+                GetModel( aModelFileNames[i] );
+            } );
 
-    return mp;
+    saveHashIndex();
 }
 
 
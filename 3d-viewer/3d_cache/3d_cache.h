@@ -32,14 +32,18 @@
 #include "3d_info.h"
 #include <core/typeinfo.h>
 #include "kicad_string.h"
+#include <memory_accounting.h>
+#include <cstdint>
 #include <list>
 #include <map>
+#include <vector>
 #include "plugins/3dapi/c3dmodel.h"
 #include <project.h>
 #include <wx/string.h>
 
 class  PGM_BASE;
 class  S3D_CACHE_ENTRY;
+class  wxDateTime;
 class  SCENEGRAPH;
 class  FILENAME_RESOLVER;
 class  S3D_PLUGIN_MANAGER;
@@ -68,29 +72,55 @@ private:
     wxString            m_CacheDir;
     wxString            m_ConfigDir;       /// base configuration path for 3D items
 
-    /** Find or create cache entry for file name
+    /// the size and modification time of a model file when it was hashed
+    struct FILE_HASH
+    {
+        long long size;
+        long long modTime;              ///< milliseconds since the epoch
+        uint64_t  hash;
+    };
+
+    /// hashes of the model files by full path, persisted in the cache directory
+    std::map< wxString, FILE_HASH > m_FileHashes;
+    bool                            m_FileHashesLoaded;
+    bool                            m_FileHashesDirty;
+
+    /// the memory of the render data of the models
+    MEMORY_ACCOUNT                  m_memoryAccount;
+
+    /** Identify a new cache entry for file name
      *
-     * Searches the cache list for the given filename and retrieves
-     * the cache data; a cache entry is created if one does not
-     * already exist.
+     * Sets the hash of a new cache entry, which names its cache files.  The
+     * scene data is only loaded when needed, see loadScene().
      *
-     * @param[in]   aFileName   file name (full or partial path)
-     * @param[out]  aCachePtr   optional return address for cache entry pointer
-     * @return      SCENEGRAPH object associated with file name
-     * @retval      NULL    on error
+     * @param[in]   aFileName   file name (full path)
+     * @param[in]   aCacheItem  the new cache entry, locked by the caller
+     * @retval      false   if the file cannot be hashed or there is no cache
+     *                      directory; the entry is then kept empty
      */
-    SCENEGRAPH* checkCache( const wxString& aFileName, S3D_CACHE_ENTRY** aCachePtr = NULL );
+    bool checkCache( const wxString& aFileName, S3D_CACHE_ENTRY* aCacheItem );
+
+    // load the scene data of an entry from its cache file, or else with the plugins
+    void loadScene( S3D_CACHE_ENTRY* aCacheItem );
 
     /**
-     * Function getSHA1
-     * calculates the SHA1 hash of the given file
+     * Function getHash
+     * returns the hash of the given file, which is only read again if its size
+     * or modification time differ from the ones of the hash index
      *
      * @param[in]   aFileName   file name (full path)
-     * @param[out]  aSHA1Sum    a 20 byte character array to hold the SHA1 hash
+     * @param[in]   aModTime    the modification time of the file
+     * @param[in]   aFileSize   the size of the file
+     * @param[out]  aHash       the hash of the file contents
      * @retval      true        success
      * @retval      false       failure
      */
-    bool getSHA1( const wxString& aFileName, unsigned char* aSHA1Sum );
+    bool getHash( const wxString& aFileName, const wxDateTime& aModTime, long long aFileSize,
+                  uint64_t& aHash );
+
+    // read and write the hash index; the caller of loadHashIndex() locks it
+    void loadHashIndex();
+    void saveHashIndex();
 
     // load scene data from a cache file
     bool loadCacheData( S3D_CACHE_ENTRY* aCacheItem );
@@ -98,8 +128,16 @@ private:
     // save scene data to a cache file
     bool saveCacheData( S3D_CACHE_ENTRY* aCacheItem );
 
+    // load render data from its memory mapped cache file, without building the scene
+    bool loadRenderData( S3D_CACHE_ENTRY* aCacheItem );
+
+    // save render data to a cache file
+    bool saveRenderData( S3D_CACHE_ENTRY* aCacheItem );
+
     // the real load function (can supply a cache entry pointer to member functions)
-    SCENEGRAPH* load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCachePtr = NULL );
+    // (the scene data is only loaded if aNeedScene is set)
+    SCENEGRAPH* load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCachePtr = NULL,
+                      bool aNeedScene = true );
 
 public:
     S3D_CACHE();
@@ -183,6 +221,17 @@ public:
      * @return is a pointer to the render data or NULL if not available
      */
     S3DMODEL* GetModel( const wxString& aModelFileName );
+
+    /**
+     * Function LoadModels
+     * loads the render data of several models on all the cores, so that the
+     * following calls to GetModel() find them in the cache.  GetModel() is
+     * thread safe: distinct models load concurrently, but the loads of a
+     * given plugin still run one at a time.
+     *
+     * @param aModelFileNames are the distinct paths of the models to be loaded
+     */
+    void LoadModels( const std::vector<wxString>& aModelFileNames );
 };
 
 #endif  // CACHE_3D_H
@@ -31,6 +31,7 @@
 
 #include <map>
 #include <list>
+#include <mutex>
 #include <string>
 #include <wx/string.h>
 
@@ -47,6 +48,10 @@ private:
     /// mapping of extensions to available plugins
     std::multimap< const wxString, KICAD_PLUGIN_LDR_3D* > m_ExtMap;
 
+    /// the plugins keep global state: each one loads a single model at a time, but
+    /// distinct plugins may run concurrently
+    std::map< KICAD_PLUGIN_LDR_3D*, std::mutex > m_PluginLocks;
+
     /// list of file filters
     std::list< wxString > m_FileFilters;
 
@@ -82,6 +87,10 @@ public:
      */
     std::list< wxString > const* GetFileFilters( void ) const noexcept;
 
+    /**
+     * Function Load3DModel
+     * loads a model with the first plugin able to read it.  Thread safe.
+     */
     SCENEGRAPH* Load3DModel( const wxString& aFileName, std::string& aPluginInfo );
 
     /**
@@ -49,6 +49,7 @@ const wxChar *BOARD_ADAPTER::m_logTrace = wxT( "KI_TRACE_EDA_CINFO3D_VISU" );
 
 BOARD_ADAPTER::BOARD_ADAPTER() :
         m_board( nullptr ),
+        m_listenedBoard( nullptr ),
         m_3d_model_manager( nullptr ),
         m_colors( nullptr ),
         m_layerZcoordTop(),
@@ -91,6 +92,11 @@ BOARD_ADAPTER::BOARD_ADAPTER() :
     m_calc_seg_min_factor3DU = 0.0f;
     m_calc_seg_max_factor3DU = 0.0f;
 
+    m_dirtyHoles = false;
+    m_layersSerial = 0;
+    m_incrementalBuild = false;
+    m_updatedHoles = false;
+
     SetFlag( FL_USE_REALISTIC_MODE, true );
     SetFlag( FL_MODULE_ATTRIBUTES_NORMAL, true );
     SetFlag( FL_SHOW_BOARD_BODY, true );
@@ -122,10 +128,133 @@ BOARD_ADAPTER::BOARD_ADAPTER() :
 
 BOARD_ADAPTER::~BOARD_ADAPTER()
 {
+    if( m_listenedBoard )
+        m_listenedBoard->RemoveListener( this );
+
     destroyLayers();
 }
 
 
+void BOARD_ADAPTER::SetBoard( BOARD* aBoard )
+{
+    m_board = aBoard;
+
+    if( m_listenedBoard == aBoard )
+        return;
+
+    if( m_listenedBoard )
+        m_listenedBoard->RemoveListener( this );
+
+    m_listenedBoard = aBoard;
+
+    if( m_listenedBoard )
+        m_listenedBoard->AddListener( this );
+
+    // the items of another board are not known: the next build rebuilds all the layers
+    m_itemLayers.clear();
+    m_layersSettings.board = nullptr;
+}
+
+
+BOARD_ADAPTER::ITEM_LAYERS BOARD_ADAPTER::getItemLayers( const BOARD_ITEM* aItem )
+{
+    ITEM_LAYERS itemLayers = { aItem->GetLayerSet(), false };
+
+    switch( aItem->Type() )
+    {
+    case PCB_MODULE_T:
+    {
+        const MODULE* module = static_cast<const MODULE*>( aItem );
+
+        itemLayers.layers.reset();
+        itemLayers.layers.set( module->Reference().GetLayer() );
+        itemLayers.layers.set( module->Value().GetLayer() );
+
+        for( const D_PAD* pad : module->Pads() )
+        {
+            itemLayers.layers |= pad->GetLayerSet();
+            itemLayers.drilled |= pad->GetDrillSize().x != 0;
+        }
+
+        for( const BOARD_ITEM* item : module->GraphicalItems() )
+            itemLayers.layers |= item->GetLayerSet();
+
+        break;
+    }
+
+    case PCB_PAD_T:
+        itemLayers.drilled = static_cast<const D_PAD*>( aItem )->GetDrillSize().x != 0;
+        break;
+
+    case PCB_VIA_T:
+        itemLayers.drilled = true;
+        break;
+
+    default:
+        break;
+    }
+
+    return itemLayers;
+}
+
+
+void BOARD_ADAPTER::markItemChanged( const BOARD_ITEM* aItem, bool aRemoved )
+{
+    // a marker has no shape in the 3D view
+    if( aItem->Type() == PCB_MARKER_T )
+        return;
+
+    auto it = m_itemLayers.find( aItem );
+
+    if( it != m_itemLayers.end() )
+    {
+        m_dirtyLayers |= it->second.layers;
+        m_dirtyHoles |= it->second.drilled;
+
+        if( aRemoved )
+            m_itemLayers.erase( it );
+    }
+
+    if( aRemoved )
+        return;
+
+    ITEM_LAYERS itemLayers = getItemLayers( aItem );
+
+    m_dirtyLayers |= itemLayers.layers;
+    m_dirtyHoles |= itemLayers.drilled;
+    m_itemLayers[aItem] = itemLayers;
+}
+
+
+void BOARD_ADAPTER::OnBoardItemAdded( BOARD& aBoard, BOARD_ITEM* aBoardItem )
+{
+    markItemChanged( aBoardItem, false );
+}
+
+
+void BOARD_ADAPTER::OnBoardItemRemoved( BOARD& aBoard, BOARD_ITEM* aBoardItem )
+{
+    markItemChanged( aBoardItem, true );
+}
+
+
+void BOARD_ADAPTER::OnBoardItemChanged( BOARD& aBoard, BOARD_ITEM* aBoardItem )
+{
+    markItemChanged( aBoardItem, false );
+}
+
+
+void BOARD_ADAPTER::OnBoardDestroyed( BOARD& aBoard )
+{
+    if( m_listenedBoard == &aBoard )
+    {
+        m_listenedBoard = nullptr;
+        m_itemLayers.clear();
+        m_layersSettings.board = nullptr;
+    }
+}
+
+
 bool BOARD_ADAPTER::Is3DLayerEnabled( PCB_LAYER_ID aLayer ) const
 {
     wxASSERT( aLayer < PCB_LAYER_ID_COUNT );
@@ -422,17 +551,42 @@ void BOARD_ADAPTER::InitSettings( REPORTER* aStatusTextReporter, REPORTER* aWarn
 
     m_boardBoundingBox = CBBOX( boardMin, boardMax );
 
+    // Only the layers of the items changed since the last build are rebuilt, if the board
+    // outline, the scale and the options are the same
+    LAYERS_SETTINGS settings = { m_board, m_drawFlags, m_render_engine, m_copperLayersCount,
+                                 m_biuTo3Dunits, m_epoxyThickness3DU, LSET() };
+
+    for( int layer_id = 0; layer_id < PCB_LAYER_ID_COUNT; ++layer_id )
+    {
+        if( Is3DLayerEnabled( ToLAYER_ID( layer_id ) ) )
+            settings.enabledLayers.set( layer_id );
+    }
+
+    m_incrementalBuild = m_layersSerial != 0 && settings == m_layersSettings
+                         && m_listenedBoard == m_board && !m_dirtyLayers.test( Edge_Cuts );
+
+    m_updatedLayers = m_incrementalBuild ? m_dirtyLayers : LSET::AllLayersMask();
+    m_updatedHoles = m_incrementalBuild ? m_dirtyHoles : true;
+
+    m_layersSettings = settings;
+    m_dirtyLayers.reset();
+    m_dirtyHoles = false;
+    m_layersSerial++;
+
 #ifdef PRINT_STATISTICS_3D_VIEWER
     unsigned stats_startCreateBoardPolyTime = GetRunningMicroSecs();
 #endif
 
-    if( aStatusTextReporter )
-        aStatusTextReporter->Report( _( "Build board body" ) );
+    if( !m_incrementalBuild )
+    {
+        if( aStatusTextReporter )
+            aStatusTextReporter->Report( _( "Build board body" ) );
 
-    if( !createBoardPolygon() )
-        aWarningTextReporter->Report( _( "Warning: Board outline is not closed" ) );
-    else
-        aWarningTextReporter->Report( wxEmptyString );
+        if( !createBoardPolygon() )
+            aWarningTextReporter->Report( _( "Warning: Board outline is not closed" ) );
+        else
+            aWarningTextReporter->Report( wxEmptyString );
+    }
 
 #ifdef PRINT_STATISTICS_3D_VIEWER
     unsigned stats_stopCreateBoardPolyTime = GetRunningMicroSecs();
@@ -442,7 +596,24 @@ void BOARD_ADAPTER::InitSettings( REPORTER* aStatusTextReporter, REPORTER* aWarn
     if( aStatusTextReporter )
         aStatusTextReporter->Report( _( "Create layers" ) );
 
-    createLayers( aStatusTextReporter );
+    createLayers( aStatusTextReporter, m_updatedLayers, m_updatedHoles );
+
+    if( !m_incrementalBuild )
+    {
+        m_itemLayers.clear();
+
+        for( TRACK* track : m_board->Tracks() )
+            m_itemLayers[track] = getItemLayers( track );
+
+        for( MODULE* module : m_board->Modules() )
+            m_itemLayers[module] = getItemLayers( module );
+
+        for( BOARD_ITEM* item : m_board->Drawings() )
+            m_itemLayers[item] = getItemLayers( item );
+
+        for( ZONE_CONTAINER* zone : m_board->Zones() )
+            m_itemLayers[zone] = getItemLayers( zone );
+    }
 
 #ifdef PRINT_STATISTICS_3D_VIEWER
     unsigned stats_stopCreateLayersTime = GetRunningMicroSecs();
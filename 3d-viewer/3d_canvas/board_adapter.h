@@ -26,6 +26,7 @@
 #define BOARD_ADAPTER_H
 
 #include <array>
+#include <unordered_map>
 #include <vector>
 #include "../3d_rendering/3d_render_raytracing/accelerators/ccontainer2d.h"
 #include "../3d_rendering/3d_render_raytracing/accelerators/ccontainer.h"
@@ -40,6 +41,7 @@
 #include <class_track.h>
 #include <wx/gdicmn.h>
 #include <pcb_base_frame.h>
+#include <class_board.h>
 #include <class_pcb_text.h>
 #include <class_drawsegment.h>
 #include <class_dimension.h>
@@ -64,8 +66,11 @@ typedef std::map< PCB_LAYER_ID, SHAPE_POLY_SET *> MAP_POLY;
 /**
  *  Class BOARD_ADAPTER
  *  Helper class to handle information needed to display 3D board
+ *
+ *  The adapter listens to the changes of its board: after an edit, InitSettings() only
+ *  rebuilds the layers of the changed items, if nothing else changed since the last build.
  */
-class BOARD_ADAPTER
+class BOARD_ADAPTER : public BOARD_LISTENER
 {
  public:
 
@@ -123,10 +128,7 @@ class BOARD_ADAPTER
      * @brief SetBoard - Set current board to be rendered
      * @param aBoard: board to process
      */
-    void SetBoard( BOARD *aBoard ) noexcept
-    {
-        m_board = aBoard;
-    }
+    void SetBoard( BOARD *aBoard );
 
     /**
      * @brief GetBoard - Get current board to be rendered
@@ -150,6 +152,44 @@ class BOARD_ADAPTER
      */
     void InitSettings( REPORTER* aStatusTextReporter, REPORTER* aWarningTextReporter );
 
+    /**
+     * @brief GetLayersSerial - the number of the last InitSettings() build, so that a
+     * renderer can tell whether it has seen the build before the last one
+     */
+    unsigned int GetLayersSerial() const noexcept
+    {
+        return m_layersSerial;
+    }
+
+    /**
+     * @brief IsIncrementalBuild - did the last InitSettings() only rebuild some layers ?
+     * Then GetUpdatedLayers() and AreHolesUpdated() tell which ones.
+     */
+    bool IsIncrementalBuild() const noexcept
+    {
+        return m_incrementalBuild;
+    }
+
+    const LSET& GetUpdatedLayers() const noexcept
+    {
+        return m_updatedLayers;
+    }
+
+    /**
+     * @brief AreHolesUpdated - were the through holes, the vias and the pad holes rebuilt
+     * by the last InitSettings() ?
+     */
+    bool AreHolesUpdated() const noexcept
+    {
+        return m_updatedHoles;
+    }
+
+    // BOARD_LISTENER overrides, recording the layers to rebuild
+    void OnBoardItemAdded( BOARD& aBoard, BOARD_ITEM* aBoardItem ) override;
+    void OnBoardItemRemoved( BOARD& aBoard, BOARD_ITEM* aBoardItem ) override;
+    void OnBoardItemChanged( BOARD& aBoard, BOARD_ITEM* aBoardItem ) override;
+    void OnBoardDestroyed( BOARD& aBoard ) override;
+
     /**
      * @brief BiuTo3Dunits - Board integer units To 3D units
      * @return the conversion factor to transform a position from the board to 3d units
@@ -543,8 +583,48 @@ class BOARD_ADAPTER
      * @return false if the outline could not be created
      */
     bool createBoardPolygon();
-    void createLayers( REPORTER *aStatusTextReporter );
-    void destroyLayers();
+
+    /**
+     * Build the 2D objects of aLayers, and of the holes if aHoles is set; the other ones are
+     * kept.  The items of the board are all recorded in m_itemLayers by a full build.
+     */
+    void createLayers( REPORTER *aStatusTextReporter,
+                       const LSET& aLayers = LSET::AllLayersMask(), bool aHoles = true );
+    void destroyLayers( const LSET& aLayers = LSET::AllLayersMask(), bool aHoles = true );
+
+    /// The layers an item is built on, and whether it has a hole, when it was last seen
+    struct ITEM_LAYERS
+    {
+        LSET layers;
+        bool drilled;
+    };
+
+    static ITEM_LAYERS getItemLayers( const BOARD_ITEM* aItem );
+
+    /// Record the layers of an item to rebuild, with the ones it was on before
+    void markItemChanged( const BOARD_ITEM* aItem, bool aRemoved );
+
+    /// The settings the layers were built with: a change of any of them rebuilds them all
+    struct LAYERS_SETTINGS
+    {
+        BOARD*            board;
+        std::vector<bool> drawFlags;
+        RENDER_ENGINE     renderEngine;
+        unsigned int      copperLayersCount;
+        double            biuTo3Dunits;
+        float             epoxyThickness3DU;    ///< the renderers bake the Z positions
+        LSET              enabledLayers;
+
+        bool operator==( const LAYERS_SETTINGS& aOther ) const
+        {
+            return board == aOther.board && drawFlags == aOther.drawFlags
+                   && renderEngine == aOther.renderEngine
+                   && copperLayersCount == aOther.copperLayersCount
+                   && biuTo3Dunits == aOther.biuTo3Dunits
+                   && epoxyThickness3DU == aOther.epoxyThickness3DU
+                   && enabledLayers == aOther.enabledLayers;
+        }
+    };
 
     // Helper functions to create the board
      void createNewTrack( const TRACK* aTrack, CGENERICCONTAINER2D *aDstContainer,
@@ -633,6 +713,7 @@ public:
 private:
 
     BOARD*              m_board;
+    BOARD*              m_listenedBoard;    ///< the board this adapter is a listener of
     S3D_CACHE*          m_3d_model_manager;
     COLOR_SETTINGS*     m_colors;
 
@@ -746,6 +827,24 @@ private:
     float m_calc_seg_max_factor3DU;
 
 
+    // Incremental builds
+
+    /// the settings of the last build, valid if m_layersSerial is not 0
+    LAYERS_SETTINGS m_layersSettings;
+
+    /// the layers of the items changed since the last build, and if one of them is drilled
+    LSET            m_dirtyLayers;
+    bool            m_dirtyHoles;
+
+    /// the layers of each item of the board, to rebuild the old ones of a changed item
+    std::unordered_map<const BOARD_ITEM*, ITEM_LAYERS> m_itemLayers;
+
+    unsigned int    m_layersSerial;
+    bool            m_incrementalBuild;
+    LSET            m_updatedLayers;
+    bool            m_updatedHoles;
+
+
     // Statistics
 
     /// Number of tracks in the board
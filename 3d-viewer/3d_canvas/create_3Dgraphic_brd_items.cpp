@@ -86,43 +86,21 @@ void BOARD_ADAPTER::AddShapeWithClearanceToContainer( const TEXTE_PCB* aText,
                                                       PCB_LAYER_ID aLayerId,
                                                       int aClearanceValue )
 {
-    wxSize size = aText->GetTextSize();
-
-    if( aText->IsMirrored() )
-        size.x = -size.x;
-
     s_boardItem    = (const BOARD_ITEM *) &aText;
     s_dstcontainer = aDstContainer;
     s_textWidth    = aText->GetEffectiveTextPenWidth() + ( 2 * aClearanceValue );
     s_biuTo3Dunits = m_biuTo3Dunits;
 
-    // not actually used, but needed by GRText
-    const COLOR4D dummy_color = COLOR4D::BLACK;
-    bool          forceBold = true;
-    int           penWidth = 0;         // force max width for bold
+    // penWidth 0 forces max width for bold
+    std::shared_ptr<const std::vector<wxPoint>> segments =
+            aText->GetStrokeSegments( aText->GetTextAngle(), 0 );
 
-    if( aText->IsMultilineAllowed() )
+    for( size_t ii = 0; ii + 1 < segments->size(); ii += 2 )
     {
-        wxArrayString strings_list;
-        wxStringSplit( aText->GetShownText(), strings_list, '\n' );
-        std::vector<wxPoint> positions;
-        positions.reserve( strings_list.Count() );
-        aText->GetLinePositions( positions, strings_list.Count());
-
-        for( unsigned ii = 0; ii < strings_list.Count(); ++ii )
-        {
-            wxString txt = strings_list.Item( ii );
+        const wxPoint& start = ( *segments )[ii];
+        const wxPoint& end = ( *segments )[ii + 1];
 
-            GRText( nullptr, positions[ii], dummy_color, txt, aText->GetTextAngle(), size,
-                    aText->GetHorizJustify(), aText->GetVertJustify(), penWidth,
-                    aText->IsItalic(), forceBold, addTextSegmToContainer );
-        }
-    }
-    else
-    {
-        GRText( nullptr, aText->GetTextPos(), dummy_color, aText->GetShownText(),
-                aText->GetTextAngle(), size, aText->GetHorizJustify(), aText->GetVertJustify(),
-                penWidth, aText->IsItalic(), forceBold, addTextSegmToContainer );
+        addTextSegmToContainer( start.x, start.y, end.x, end.y, nullptr );
     }
 }
 
@@ -218,16 +196,18 @@ void BOARD_ADAPTER::AddGraphicsShapesWithClearanceToContainer( const MODULE* aMo
     for( TEXTE_MODULE* text : texts )
     {
         s_textWidth = text->GetEffectiveTextPenWidth() + ( 2 * aInflateValue );
-        wxSize size = text->GetTextSize();
-        bool   forceBold = true;
-        int    penWidth = 0;        // force max width for bold
 
-        if( text->IsMirrored() )
-            size.x = -size.x;
+        // penWidth 0 forces max width for bold
+        std::shared_ptr<const std::vector<wxPoint>> segments =
+                text->GetStrokeSegments( text->GetDrawRotation(), 0 );
 
-        GRText( NULL, text->GetTextPos(), BLACK, text->GetShownText(), text->GetDrawRotation(),
-                size, text->GetHorizJustify(), text->GetVertJustify(), penWidth, text->IsItalic(),
-                forceBold, addTextSegmToContainer );
+        for( size_t ii = 0; ii + 1 < segments->size(); ii += 2 )
+        {
+            const wxPoint& start = ( *segments )[ii];
+            const wxPoint& end = ( *segments )[ii + 1];
+
+            addTextSegmToContainer( start.x, start.y, end.x, end.y, nullptr );
+        }
     }
 }
 
@@ -547,8 +527,8 @@ void BOARD_ADAPTER::createNewPadWithClearance( const D_PAD* aPad,
     case PAD_SHAPE_CUSTOM:
     {
         SHAPE_POLY_SET polyList;     // Will contain the pad outlines in board coordinates
-        polyList.Append( aPad->GetCustomShapeAsPolygon() );
-        aPad->CustomShapeAsPolygonToBoardPosition( &polyList, aPad->ShapePos(), aPad->GetOrientation() );
+        polyList.Append( aPad->GetBoardPolygon() );
+        polyList.Move( VECTOR2I( aPad->ShapePos() - aPad->GetPosition() ) );
 
         if( aClearanceValue.x )
             polyList.Inflate( aClearanceValue.x, 32 );
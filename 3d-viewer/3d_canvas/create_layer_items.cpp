@@ -49,56 +49,43 @@
 #include <class_zone.h>
 #include <class_text_mod.h>
 #include <convert_basic_shapes_to_polygon.h>
+#include <thread_pool.h>
 #include <trigo.h>
 #include <utility>
 #include <vector>
-#include <thread>
 #include <algorithm>
-#include <atomic>
 
 #include <profile.h>
 
-void BOARD_ADAPTER::destroyLayers()
+/// Delete the entries of aMap on aLayers
+template <typename MAP>
+static void destroyMapLayers( MAP& aMap, const LSET& aLayers )
 {
-    if( !m_layers_poly.empty() )
+    for( auto it = aMap.begin(); it != aMap.end(); )
     {
-        for( auto& poly : m_layers_poly )
-            delete poly.second;
-
-        m_layers_poly.clear();
-    }
-
-    if( !m_layers_inner_holes_poly.empty() )
-    {
-        for( auto& poly : m_layers_inner_holes_poly )
-            delete poly.second;
-
-        m_layers_inner_holes_poly.clear();
-    }
-
-    if( !m_layers_outer_holes_poly.empty() )
-    {
-        for( auto& poly : m_layers_outer_holes_poly )
-            delete poly.second;
-
-        m_layers_outer_holes_poly.clear();
+        if( aLayers.test( it->first ) )
+        {
+            delete it->second;
+            it = aMap.erase( it );
+        }
+        else
+        {
+            ++it;
+        }
     }
+}
 
-    if( !m_layers_container2D.empty() )
-    {
-        for( auto& poly : m_layers_container2D )
-            delete poly.second;
 
-        m_layers_container2D.clear();
-    }
+void BOARD_ADAPTER::destroyLayers( const LSET& aLayers, bool aHoles )
+{
+    destroyMapLayers( m_layers_poly, aLayers );
+    destroyMapLayers( m_layers_inner_holes_poly, aLayers );
+    destroyMapLayers( m_layers_outer_holes_poly, aLayers );
+    destroyMapLayers( m_layers_container2D, aLayers );
+    destroyMapLayers( m_layers_holes2D, aLayers );
 
-    if( !m_layers_holes2D.empty() )
-    {
-        for( auto& poly : m_layers_holes2D )
-            delete poly.second;
-
-        m_layers_holes2D.clear();
-    }
+    if( !aHoles )
+        return;
 
     m_through_holes_inner.Clear();
     m_through_holes_outer.Clear();
@@ -113,9 +100,10 @@ void BOARD_ADAPTER::destroyLayers()
 }
 
 
-void BOARD_ADAPTER::createLayers( REPORTER *aStatusTextReporter )
+void BOARD_ADAPTER::createLayers( REPORTER *aStatusTextReporter, const LSET& aLayers,
+                                  bool aHoles )
 {
-    destroyLayers();
+    destroyLayers( aLayers, aHoles );
 
     // Build Copper layers
     // Based on: https://github.com/KiCad/kicad-source-mirror/blob/master/3d-viewer/3d_draw.cpp#L692
@@ -134,8 +122,13 @@ void BOARD_ADAPTER::createLayers( REPORTER *aStatusTextReporter )
     m_stats_track_med_width         = 0;
     m_stats_nr_vias                 = 0;
     m_stats_via_med_hole_diameter   = 0;
-    m_stats_nr_holes                = 0;
-    m_stats_hole_med_diameter       = 0;
+
+    // the pad holes are only counted when they are built
+    if( aHoles )
+    {
+        m_stats_nr_holes            = 0;
+        m_stats_hole_med_diameter   = 0;
+    }
 
     // Prepare track list, convert in a vector. Calc statistic for the holes
     // /////////////////////////////////////////////////////////////////////////
@@ -183,6 +176,8 @@ void BOARD_ADAPTER::createLayers( REPORTER *aStatusTextReporter )
     layer_id.clear();
     layer_id.reserve( m_copperLayersCount );
 
+    bool has_copper_layers = false;
+
     for( unsigned i = 0; i < arrayDim( cu_seq ); ++i )
         cu_seq[i] = ToLAYER_ID( B_Cu - i );
 
@@ -193,6 +188,11 @@ void BOARD_ADAPTER::createLayers( REPORTER *aStatusTextReporter )
         if( !Is3DLayerEnabled( curr_layer_id ) ) // Skip non enabled layers
             continue;
 
+        has_copper_layers = true;
+
+        if( !aLayers.test( curr_layer_id ) )    // Keep the layers which did not change
+            continue;
+
         layer_id.push_back( curr_layer_id );
 
         CBVHCONTAINER2D *layerContainer = new CBVHCONTAINER2D;
@@ -295,31 +295,52 @@ void BOARD_ADAPTER::createLayers( REPORTER *aStatusTextReporter )
                                                                   hole_inner_radius + thickness,
                                                                   *track ) );
                 }
-                else if( curr_layer_id == layer_id[0] ) // it only adds once the THT holes
-                {
-                    // Add through hole object
-                    // /////////////////////////////////////////////////////////
-                    m_through_holes_outer.Add( new CFILLEDCIRCLE2D( via_center,
-                                                                    hole_inner_radius + thickness,
-                                                                    *track ) );
-
-                    m_through_holes_vias_outer.Add(
-                                new CFILLEDCIRCLE2D( via_center,
-                                                     hole_inner_radius + thickness,
-                                                     *track ) );
-
-                    m_through_holes_inner.Add( new CFILLEDCIRCLE2D( via_center,
-                                                                    hole_inner_radius,
-                                                                    *track ) );
-
-                    //m_through_holes_vias_inner.Add( new CFILLEDCIRCLE2D( via_center,
-                    //                                                     hole_inner_radius,
-                    //                                                     *track ) );
-                }
             }
         }
     }
 
+    // Create THTs objects and add it to holes containers (a through via is on all the
+    // copper layers, they are only built with the holes)
+    // /////////////////////////////////////////////////////////////////////////
+    if( aHoles && has_copper_layers )
+    {
+        for( const TRACK* track : trackList )
+        {
+            if( track->Type() != PCB_VIA_T )
+                continue;
+
+            const VIA* via = static_cast<const VIA*>( track );
+
+            if( via->GetViaType() != VIATYPE::THROUGH )
+                continue;
+
+            const float   holediameter      = via->GetDrillValue() * BiuTo3Dunits();
+            const float   thickness         = GetCopperThickness3DU();
+            const float   hole_inner_radius = ( holediameter / 2.0f );
+
+            const SFVEC2F via_center(
+                    via->GetStart().x * m_biuTo3Dunits, -via->GetStart().y * m_biuTo3Dunits );
+
+            // Add through hole object
+            // /////////////////////////////////////////////////////////////////
+            m_through_holes_outer.Add( new CFILLEDCIRCLE2D( via_center,
+                                                            hole_inner_radius + thickness,
+                                                            *track ) );
+
+            m_through_holes_vias_outer.Add( new CFILLEDCIRCLE2D( via_center,
+                                                                 hole_inner_radius + thickness,
+                                                                 *track ) );
+
+            m_through_holes_inner.Add( new CFILLEDCIRCLE2D( via_center,
+                                                            hole_inner_radius,
+                                                            *track ) );
+
+            //m_through_holes_vias_inner.Add( new CFILLEDCIRCLE2D( via_center,
+            //                                                     hole_inner_radius,
+            //                                                     *track ) );
+        }
+    }
+
 #ifdef PRINT_STATISTICS_3D_VIEWER
     printf( "T04: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time  ) / 1e3 );
     start_Time = GetRunningMicroSecs();
@@ -389,30 +410,42 @@ void BOARD_ADAPTER::createLayers( REPORTER *aStatusTextReporter )
                     TransformCircleToPolygon( *layerInnerHolesPoly, via->GetStart(),
                             holediameter / 2, ARC_HIGH_DEF );
                 }
-                else if( curr_layer_id == layer_id[0] ) // it only adds once the THT holes
-                {
-                    const int holediameter = via->GetDrillValue();
-                    const int hole_outer_radius = (holediameter / 2)+ GetCopperThicknessBIU();
+            }
+        }
+    }
 
-                    // Add through hole contourns
-                    // /////////////////////////////////////////////////////////
-                    TransformCircleToPolygon( m_through_outer_holes_poly, via->GetStart(),
-                            hole_outer_radius, ARC_HIGH_DEF );
+    // Add through hole contourns of the THT vias
+    // /////////////////////////////////////////////////////////////////////////
+    if( aHoles && has_copper_layers )
+    {
+        for( const TRACK* track : trackList )
+        {
+            if( track->Type() != PCB_VIA_T )
+                continue;
 
-                    TransformCircleToPolygon( m_through_inner_holes_poly, via->GetStart(),
-                            holediameter / 2, ARC_HIGH_DEF );
+            const VIA* via = static_cast<const VIA*>( track );
+
+            if( via->GetViaType() != VIATYPE::THROUGH )
+                continue;
 
-                    // Add samething for vias only
+            const int holediameter = via->GetDrillValue();
+            const int hole_outer_radius = (holediameter / 2)+ GetCopperThicknessBIU();
 
-                    TransformCircleToPolygon( m_through_outer_holes_vias_poly, via->GetStart(),
-                            hole_outer_radius, ARC_HIGH_DEF );
+            TransformCircleToPolygon( m_through_outer_holes_poly, via->GetStart(),
+                    hole_outer_radius, ARC_HIGH_DEF );
 
-                    //TransformCircleToPolygon( m_through_inner_holes_vias_poly,
-                    //                          via->GetStart(),
-                    //                          holediameter / 2,
-                    //                          GetNrSegmentsCircle( holediameter ) );
-                }
-            }
+            TransformCircleToPolygon( m_through_inner_holes_poly, via->GetStart(),
+                    holediameter / 2, ARC_HIGH_DEF );
+
+            // Add samething for vias only
+
+            TransformCircleToPolygon( m_through_outer_holes_vias_poly, via->GetStart(),
+                    hole_outer_radius, ARC_HIGH_DEF );
+
+            //TransformCircleToPolygon( m_through_inner_holes_vias_poly,
+            //                          via->GetStart(),
+            //                          holediameter / 2,
+            //                          GetNrSegmentsCircle( holediameter ) );
         }
     }
 
@@ -455,30 +488,33 @@ void BOARD_ADAPTER::createLayers( REPORTER *aStatusTextReporter )
 
     // Add holes of modules
     // /////////////////////////////////////////////////////////////////////////
-    for( MODULE* module : m_board->Modules() )
+    if( aHoles )
     {
-        for( D_PAD* pad : module->Pads() )
+        for( MODULE* module : m_board->Modules() )
         {
-            const wxSize padHole = pad->GetDrillSize();
+            for( D_PAD* pad : module->Pads() )
+            {
+                const wxSize padHole = pad->GetDrillSize();
 
-            if( !padHole.x )    // Not drilled pad like SMD pad
-                continue;
+                if( !padHole.x )    // Not drilled pad like SMD pad
+                    continue;
 
-            // The hole in the body is inflated by copper thickness,
-            // if not plated, no copper
-            const int inflate = (pad->GetAttribute () != PAD_ATTRIB_HOLE_NOT_PLATED) ?
-                                GetCopperThicknessBIU() : 0;
+                // The hole in the body is inflated by copper thickness,
+                // if not plated, no copper
+                const int inflate = (pad->GetAttribute () != PAD_ATTRIB_HOLE_NOT_PLATED) ?
+                                    GetCopperThicknessBIU() : 0;
 
-            m_stats_nr_holes++;
-            m_stats_hole_med_diameter += ( ( pad->GetDrillSize().x +
-                                             pad->GetDrillSize().y ) / 2.0f ) * m_biuTo3Dunits;
+                m_stats_nr_holes++;
+                m_stats_hole_med_diameter += ( ( pad->GetDrillSize().x +
+                                                 pad->GetDrillSize().y ) / 2.0f ) * m_biuTo3Dunits;
 
-            m_through_holes_outer.Add( createNewPadDrill( pad, inflate ) );
-            m_through_holes_inner.Add( createNewPadDrill( pad,       0 ) );
+                m_through_holes_outer.Add( createNewPadDrill( pad, inflate ) );
+                m_through_holes_inner.Add( createNewPadDrill( pad,       0 ) );
+            }
         }
+        if( m_stats_nr_holes )
+            m_stats_hole_med_diameter /= (float)m_stats_nr_holes;
     }
-    if( m_stats_nr_holes )
-        m_stats_hole_med_diameter /= (float)m_stats_nr_holes;
 
 #ifdef PRINT_STATISTICS_3D_VIEWER
     printf( "T07: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time  ) / 1e3 );
@@ -487,27 +523,30 @@ void BOARD_ADAPTER::createLayers( REPORTER *aStatusTextReporter )
 
     // Add contours of the pad holes (pads can be Circle or Segment holes)
     // /////////////////////////////////////////////////////////////////////////
-    for( MODULE* module : m_board->Modules() )
+    if( aHoles )
     {
-        for( D_PAD* pad : module->Pads() )
+        for( MODULE* module : m_board->Modules() )
         {
-            const wxSize padHole = pad->GetDrillSize();
+            for( D_PAD* pad : module->Pads() )
+            {
+                const wxSize padHole = pad->GetDrillSize();
 
-            if( !padHole.x ) // Not drilled pad like SMD pad
-                continue;
+                if( !padHole.x ) // Not drilled pad like SMD pad
+                    continue;
 
-            // The hole in the body is inflated by copper thickness.
-            const int inflate = GetCopperThicknessBIU();
+                // The hole in the body is inflated by copper thickness.
+                const int inflate = GetCopperThicknessBIU();
 
-            if( pad->GetAttribute () != PAD_ATTRIB_HOLE_NOT_PLATED )
-            {
-                pad->BuildPadDrillShapePolygon( m_through_outer_holes_poly, inflate );
-                pad->BuildPadDrillShapePolygon( m_through_inner_holes_poly, 0 );
-            }
-            else
-            {
-                // If not plated, no copper.
-                pad->BuildPadDrillShapePolygon( m_through_outer_holes_poly_NPTH, inflate );
+                if( pad->GetAttribute () != PAD_ATTRIB_HOLE_NOT_PLATED )
+                {
+                    pad->BuildPadDrillShapePolygon( m_through_outer_holes_poly, inflate );
+                    pad->BuildPadDrillShapePolygon( m_through_inner_holes_poly, 0 );
+                }
+                else
+                {
+                    // If not plated, no copper.
+                    pad->BuildPadDrillShapePolygon( m_through_outer_holes_poly_NPTH, inflate );
+                }
             }
         }
     }
@@ -690,39 +729,21 @@ void BOARD_ADAPTER::createLayers( REPORTER *aStatusTextReporter )
 
         // Add zones objects
         // /////////////////////////////////////////////////////////////////////
-        std::atomic<size_t> nextZone( 0 );
-        std::atomic<size_t> threadsFinished( 0 );
-
-        size_t parallelThreadCount = std::max<size_t>( std::thread::hardware_concurrency(), 2 );
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-        {
-            std::thread t = std::thread( [&]()
-            {
-                for( size_t areaId = nextZone.fetch_add( 1 );
-                            areaId < static_cast<size_t>( m_board->GetAreaCount() );
-                            areaId = nextZone.fetch_add( 1 ) )
+        THREAD_POOL::GetInstance().ParallelFor( m_board->GetAreaCount(),
+                [&]( size_t areaId )
                 {
                     const ZONE_CONTAINER* zone = m_board->GetArea( areaId );
 
                     if( zone == nullptr )
-                        break;
+                        return;
 
                     auto layerContainer = m_layers_container2D.find( zone->GetLayer() );
 
-                    if( layerContainer != m_layers_container2D.end() )
+                    if( layerContainer != m_layers_container2D.end()
+                            && aLayers.test( zone->GetLayer() ) )
                         AddSolidAreasShapesToContainer( zone, layerContainer->second,
                                                         zone->GetLayer() );
-                }
-
-                threadsFinished++;
-            } );
-
-            t.detach();
-        }
-
-        while( threadsFinished < parallelThreadCount )
-            std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
-
+                } );
     }
 
 #ifdef PRINT_STATISTICS_3D_VIEWER
@@ -741,7 +762,7 @@ void BOARD_ADAPTER::createLayers( REPORTER *aStatusTextReporter )
 
             auto layerContainer = m_layers_poly.find( zone->GetLayer() );
 
-            if( layerContainer != m_layers_poly.end() )
+            if( layerContainer != m_layers_poly.end() && aLayers.test( zone->GetLayer() ) )
                 zone->TransformSolidAreasShapesToPolygonSet( *layerContainer->second );
         }
     }
@@ -760,35 +781,15 @@ void BOARD_ADAPTER::createLayers( REPORTER *aStatusTextReporter )
     if( GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS )
             && ( m_render_engine == RENDER_ENGINE::OPENGL_LEGACY ) )
     {
-        std::atomic<size_t> nextItem( 0 );
-        std::atomic<size_t> threadsFinished( 0 );
-
-        size_t parallelThreadCount = std::min<size_t>(
-                std::max<size_t>( std::thread::hardware_concurrency(), 2 ),
-                layer_id.size() );
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-        {
-            std::thread t = std::thread( [&nextItem, &threadsFinished, &layer_id, this]()
-            {
-                for( size_t i = nextItem.fetch_add( 1 );
-                            i < layer_id.size();
-                            i = nextItem.fetch_add( 1 ) )
+        THREAD_POOL::GetInstance().ParallelFor( layer_id.size(),
+                [&layer_id, this]( size_t i )
                 {
                     auto layerPoly = m_layers_poly.find( layer_id[i] );
 
                     if( layerPoly != m_layers_poly.end() )
                         // This will make a union of all added contours
                         layerPoly->second->Simplify( SHAPE_POLY_SET::PM_FAST );
-                }
-
-                threadsFinished++;
-            } );
-
-            t.detach();
-        }
-
-        while( threadsFinished < parallelThreadCount )
-            std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+                } );
     }
 
 #ifdef PRINT_STATISTICS_3D_VIEWER
@@ -807,12 +808,12 @@ void BOARD_ADAPTER::createLayers( REPORTER *aStatusTextReporter )
         {
             // found
             SHAPE_POLY_SET *polyLayer = m_layers_outer_holes_poly[layer];
-            polyLayer->Simplify( SHAPE_POLY_SET::PM_FAST );
+            polyLayer->SimplifyParallel( SHAPE_POLY_SET::PM_FAST );
 
             wxASSERT( m_layers_inner_holes_poly.find( layer ) != m_layers_inner_holes_poly.end() );
 
             polyLayer = m_layers_inner_holes_poly[layer];
-            polyLayer->Simplify( SHAPE_POLY_SET::PM_FAST );
+            polyLayer->SimplifyParallel( SHAPE_POLY_SET::PM_FAST );
         }
     }
 
@@ -823,11 +824,14 @@ void BOARD_ADAPTER::createLayers( REPORTER *aStatusTextReporter )
 
 
     // This will make a union of all added contourns
-    m_through_inner_holes_poly.Simplify( SHAPE_POLY_SET::PM_FAST );
-    m_through_outer_holes_poly.Simplify( SHAPE_POLY_SET::PM_FAST );
-    m_through_outer_holes_poly_NPTH.Simplify( SHAPE_POLY_SET::PM_FAST );
-    m_through_outer_holes_vias_poly.Simplify( SHAPE_POLY_SET::PM_FAST );
-    //m_through_inner_holes_vias_poly.Simplify( SHAPE_POLY_SET::PM_FAST ); // Not in use
+    if( aHoles )
+    {
+        m_through_inner_holes_poly.SimplifyParallel( SHAPE_POLY_SET::PM_FAST );
+        m_through_outer_holes_poly.SimplifyParallel( SHAPE_POLY_SET::PM_FAST );
+        m_through_outer_holes_poly_NPTH.SimplifyParallel( SHAPE_POLY_SET::PM_FAST );
+        m_through_outer_holes_vias_poly.SimplifyParallel( SHAPE_POLY_SET::PM_FAST );
+        //m_through_inner_holes_vias_poly.Simplify( SHAPE_POLY_SET::PM_FAST ); // Not in use
+    }
 
 #ifdef PRINT_STATISTICS_3D_VIEWER
     unsigned stats_endCopperLayersTime = GetRunningMicroSecs();
@@ -871,7 +875,7 @@ void BOARD_ADAPTER::createLayers( REPORTER *aStatusTextReporter )
     {
         const PCB_LAYER_ID curr_layer_id = *seq;
 
-        if( !Is3DLayerEnabled( curr_layer_id ) )
+        if( !Is3DLayerEnabled( curr_layer_id ) || !aLayers.test( curr_layer_id ) )
             continue;
 
         CBVHCONTAINER2D *layerContainer = new CBVHCONTAINER2D;
@@ -1039,21 +1043,27 @@ void BOARD_ADAPTER::createLayers( REPORTER *aStatusTextReporter )
     if( aStatusTextReporter )
         aStatusTextReporter->Report( _( "Build BVH for holes and vias" ) );
 
-    m_through_holes_inner.BuildBVH();
-    m_through_holes_outer.BuildBVH();
+    if( aHoles )
+    {
+        m_through_holes_inner.BuildBVH();
+        m_through_holes_outer.BuildBVH();
+    }
 
     if( !m_layers_holes2D.empty() )
     {
         for( auto& hole : m_layers_holes2D)
-            hole.second->BuildBVH();
+        {
+            if( aLayers.test( hole.first ) )
+                hole.second->BuildBVH();
+        }
     }
 
     // We only need the Solder mask to initialize the BVH
     // because..?
-    if( m_layers_container2D[B_Mask] )
+    if( aLayers.test( B_Mask ) && m_layers_container2D[B_Mask] )
         m_layers_container2D[B_Mask]->BuildBVH();
 
-    if( m_layers_container2D[F_Mask] )
+    if( aLayers.test( F_Mask ) && m_layers_container2D[F_Mask] )
         m_layers_container2D[F_Mask]->BuildBVH();
 
 #ifdef PRINT_STATISTICS_3D_VIEWER
@@ -89,8 +89,8 @@ void BOARD_ADAPTER::buildPadShapePolygon( const D_PAD* aPad,
         SHAPE_POLY_SET polyList;     // Will contain the pad outlines in board coordinates
         auto           inflate_val = std::max( aInflateValue.x, aInflateValue.y );
 
-        polyList.Append( aPad->GetCustomShapeAsPolygon() );
-        aPad->CustomShapeAsPolygonToBoardPosition( &polyList, aPad->ShapePos(), aPad->GetOrientation() );
+        polyList.Append( aPad->GetBoardPolygon() );
+        polyList.Move( VECTOR2I( aPad->ShapePos() - aPad->GetPosition() ) );
 
         if( inflate_val > 0 )
         {
@@ -36,6 +36,17 @@
 #include <trigo.h>
 #include <project.h>
 #include <profile.h>        // To use GetRunningMicroSecs or another profiling utility
+#include <base_units.h>
+#include <thread_pool.h>
+
+#include <algorithm>
+#include <functional>
+#include <set>
+
+/**
+  * Scale convertion from 3d model units to pcb units
+  */
+#define UNITS3D_TO_UNITSPCB (IU_PER_MM)
 
 
 void C3D_RENDER_OGL_LEGACY::add_object_to_triangle_layer( const CFILLEDCIRCLE2D * aFilledCircle,
@@ -338,8 +349,6 @@ void C3D_RENDER_OGL_LEGACY::reload( REPORTER* aStatusTextReporter, REPORTER* aWa
 {
     m_reloadRequested = false;
 
-    ogl_free_all_display_lists();
-
     COBJECT2D_STATS::Instance().ResetStats();
 
 #ifdef PRINT_STATISTICS_3D_VIEWER
@@ -350,6 +359,20 @@ void C3D_RENDER_OGL_LEGACY::reload( REPORTER* aStatusTextReporter, REPORTER* aWa
 
     m_boardAdapter.InitSettings( aStatusTextReporter, aWarningTextReporter );
 
+    // After a board edit only the layers the adapter rebuilt are loaded again, if the
+    // display lists are the ones of its previous build.  The 3D models are then kept.
+    const bool incremental = m_boardAdapter.IsIncrementalBuild()
+                             && m_boardAdapter.GetLayersSerial() == m_layersSerial + 1;
+    const LSET layers = incremental ? m_boardAdapter.GetUpdatedLayers() : LSET::AllLayersMask();
+    const bool holes = !incremental || m_boardAdapter.AreHolesUpdated();
+
+    m_layersSerial = m_boardAdapter.GetLayersSerial();
+
+    if( incremental )
+        ogl_free_layers_display_lists( layers, holes );
+    else
+        ogl_free_all_display_lists();
+
 #ifdef PRINT_STATISTICS_3D_VIEWER
     unsigned stats_endReloadTime = GetRunningMicroSecs();
 #endif
@@ -361,121 +384,127 @@ void C3D_RENDER_OGL_LEGACY::reload( REPORTER* aStatusTextReporter, REPORTER* aWa
     unsigned stats_start_OpenGL_Load_Time = GetRunningMicroSecs();
 #endif
 
-    if( aStatusTextReporter )
-        aStatusTextReporter->Report( _( "Load OpenGL: board" ) );
+    if( !incremental )
+    {
+        if( aStatusTextReporter )
+            aStatusTextReporter->Report( _( "Load OpenGL: board" ) );
 
-    // Create Board
-    // /////////////////////////////////////////////////////////////////////////
+        // Create Board
+        // /////////////////////////////////////////////////////////////////////////
 
-    CCONTAINER2D boardContainer;
-    SHAPE_POLY_SET tmpBoard = m_boardAdapter.GetBoardPoly();
-    Convert_shape_line_polygon_to_triangles( tmpBoard,
-                                             boardContainer,
-                                             m_boardAdapter.BiuTo3Dunits(),
-                                             (const BOARD_ITEM &)*m_boardAdapter.GetBoard() );
+        CCONTAINER2D boardContainer;
+        SHAPE_POLY_SET tmpBoard = m_boardAdapter.GetBoardPoly();
+        Convert_shape_line_polygon_to_triangles( tmpBoard,
+                                                 boardContainer,
+                                                 m_boardAdapter.BiuTo3Dunits(),
+                                                 (const BOARD_ITEM &)*m_boardAdapter.GetBoard() );
 
-    const LIST_OBJECT2D &listBoardObject2d = boardContainer.GetList();
+        const LIST_OBJECT2D &listBoardObject2d = boardContainer.GetList();
 
-    if( listBoardObject2d.size() > 0 )
-    {
-        // We will set a unitary Z so it will in future used with transformations
-        // since the board poly will be used not only to draw itself but also the
-        // solder mask layers.
-        const float layer_z_top = 1.0f;
-        const float layer_z_bot = 0.0f;
+        if( listBoardObject2d.size() > 0 )
+        {
+            // We will set a unitary Z so it will in future used with transformations
+            // since the board poly will be used not only to draw itself but also the
+            // solder mask layers.
+            const float layer_z_top = 1.0f;
+            const float layer_z_bot = 0.0f;
 
-        CLAYER_TRIANGLES *layerTriangles = new CLAYER_TRIANGLES( listBoardObject2d.size() );
+            CLAYER_TRIANGLES *layerTriangles = new CLAYER_TRIANGLES( listBoardObject2d.size() );
 
-        // Convert the list of objects(triangles) to triangle layer structure
-        for( LIST_OBJECT2D::const_iterator itemOnLayer = listBoardObject2d.begin();
-             itemOnLayer != listBoardObject2d.end();
-             ++itemOnLayer )
-        {
-            const COBJECT2D *object2d_A = static_cast<const COBJECT2D *>(*itemOnLayer);
+            // Convert the list of objects(triangles) to triangle layer structure
+            for( LIST_OBJECT2D::const_iterator itemOnLayer = listBoardObject2d.begin();
+                 itemOnLayer != listBoardObject2d.end();
+                 ++itemOnLayer )
+            {
+                const COBJECT2D *object2d_A = static_cast<const COBJECT2D *>(*itemOnLayer);
 
-            wxASSERT( object2d_A->GetObjectType() == OBJECT2D_TYPE::TRIANGLE );
+                wxASSERT( object2d_A->GetObjectType() == OBJECT2D_TYPE::TRIANGLE );
 
-            const CTRIANGLE2D *tri = (const CTRIANGLE2D *)object2d_A;
+                const CTRIANGLE2D *tri = (const CTRIANGLE2D *)object2d_A;
 
-            const SFVEC2F &v1 = tri->GetP1();
-            const SFVEC2F &v2 = tri->GetP2();
-            const SFVEC2F &v3 = tri->GetP3();
+                const SFVEC2F &v1 = tri->GetP1();
+                const SFVEC2F &v2 = tri->GetP2();
+                const SFVEC2F &v3 = tri->GetP3();
 
-            add_triangle_top_bot( layerTriangles,
-                                  v1,
-                                  v2,
-                                  v3,
-                                  layer_z_top,
-                                  layer_z_bot );
-        }
+                add_triangle_top_bot( layerTriangles,
+                                      v1,
+                                      v2,
+                                      v3,
+                                      layer_z_top,
+                                      layer_z_bot );
+            }
 
-        const SHAPE_POLY_SET &boardPoly = m_boardAdapter.GetBoardPoly();
+            const SHAPE_POLY_SET &boardPoly = m_boardAdapter.GetBoardPoly();
 
-        wxASSERT( boardPoly.OutlineCount() > 0 );
+            wxASSERT( boardPoly.OutlineCount() > 0 );
 
-        if( boardPoly.OutlineCount() > 0 )
-        {
-            layerTriangles->AddToMiddleContourns( boardPoly,
-                                                  layer_z_bot,
-                                                  layer_z_top,
-                                                  m_boardAdapter.BiuTo3Dunits(),
-                                                  false );
+            if( boardPoly.OutlineCount() > 0 )
+            {
+                layerTriangles->AddToMiddleContourns( boardPoly,
+                                                      layer_z_bot,
+                                                      layer_z_top,
+                                                      m_boardAdapter.BiuTo3Dunits(),
+                                                      false );
 
-            m_ogl_disp_list_board = new CLAYERS_OGL_DISP_LISTS( *layerTriangles,
-                                                                m_ogl_circle_texture,
-                                                                layer_z_top,
-                                                                layer_z_top );
-        }
+                m_ogl_disp_list_board = new CLAYERS_OGL_DISP_LISTS( *layerTriangles,
+                                                                    m_ogl_circle_texture,
+                                                                    layer_z_top,
+                                                                    layer_z_top );
+            }
 
-        delete layerTriangles;
+            delete layerTriangles;
+        }
     }
 
     // Create Through Holes and vias
     // /////////////////////////////////////////////////////////////////////////
 
-    if( aStatusTextReporter )
-        aStatusTextReporter->Report( _( "Load OpenGL: holes and vias" ) );
-
-    m_ogl_disp_list_through_holes_outer = generate_holes_display_list(
-            m_boardAdapter.GetThroughHole_Outer().GetList(),
-            m_boardAdapter.GetThroughHole_Outer_poly(),
-            1.0f,
-            0.0f,
-            false );
-
-    SHAPE_POLY_SET bodyHoles = m_boardAdapter.GetThroughHole_Outer_poly();
-
-    bodyHoles.BooleanAdd( m_boardAdapter.GetThroughHole_Outer_poly_NPTH(),
-                          SHAPE_POLY_SET::PM_FAST );
-
-    m_ogl_disp_list_through_holes_outer_with_npth = generate_holes_display_list(
-            m_boardAdapter.GetThroughHole_Outer().GetList(),
-            bodyHoles,
-            1.0f,
-            0.0f,
-            false );
-
-    m_ogl_disp_list_through_holes_inner = generate_holes_display_list(
-            m_boardAdapter.GetThroughHole_Inner().GetList(),
-            m_boardAdapter.GetThroughHole_Inner_poly(),
-            1.0f,
-            0.0f,
-            true );
-
-
-    m_ogl_disp_list_through_holes_vias_outer = generate_holes_display_list(
-            m_boardAdapter.GetThroughHole_Vias_Outer().GetList(),
-            m_boardAdapter.GetThroughHole_Vias_Outer_poly(),
-            1.0f,
-            0.0f,
-            false );
-
-    // Not in use
-    //m_ogl_disp_list_through_holes_vias_inner = generate_holes_display_list(
-    //      m_boardAdapter.GetThroughHole_Vias_Inner().GetList(),
-    //      m_boardAdapter.GetThroughHole_Vias_Inner_poly(),
-    //      1.0f, 0.0f,
-    //      false );
+    if( holes )
+    {
+        if( aStatusTextReporter )
+            aStatusTextReporter->Report( _( "Load OpenGL: holes and vias" ) );
+
+        m_ogl_disp_list_through_holes_outer = generate_holes_display_list(
+                m_boardAdapter.GetThroughHole_Outer().GetList(),
+                m_boardAdapter.GetThroughHole_Outer_poly(),
+                1.0f,
+                0.0f,
+                false );
+
+        SHAPE_POLY_SET bodyHoles = m_boardAdapter.GetThroughHole_Outer_poly();
+
+        bodyHoles.BooleanAdd( m_boardAdapter.GetThroughHole_Outer_poly_NPTH(),
+                              SHAPE_POLY_SET::PM_FAST );
+
+        m_ogl_disp_list_through_holes_outer_with_npth = generate_holes_display_list(
+                m_boardAdapter.GetThroughHole_Outer().GetList(),
+                bodyHoles,
+                1.0f,
+                0.0f,
+                false );
+
+        m_ogl_disp_list_through_holes_inner = generate_holes_display_list(
+                m_boardAdapter.GetThroughHole_Inner().GetList(),
+                m_boardAdapter.GetThroughHole_Inner_poly(),
+                1.0f,
+                0.0f,
+                true );
+
+
+        m_ogl_disp_list_through_holes_vias_outer = generate_holes_display_list(
+                m_boardAdapter.GetThroughHole_Vias_Outer().GetList(),
+                m_boardAdapter.GetThroughHole_Vias_Outer_poly(),
+                1.0f,
+                0.0f,
+                false );
+
+        // Not in use
+        //m_ogl_disp_list_through_holes_vias_inner = generate_holes_display_list(
+        //      m_boardAdapter.GetThroughHole_Vias_Inner().GetList(),
+        //      m_boardAdapter.GetThroughHole_Vias_Inner_poly(),
+        //      1.0f, 0.0f,
+        //      false );
+    }
 
     const MAP_POLY & innerMapHoles = m_boardAdapter.GetPolyMapHoles_Inner();
     const MAP_POLY & outerMapHoles = m_boardAdapter.GetPolyMapHoles_Outer();
@@ -497,6 +526,9 @@ void C3D_RENDER_OGL_LEGACY::reload( REPORTER* aStatusTextReporter, REPORTER* aWa
             const SHAPE_POLY_SET *poly = static_cast<const SHAPE_POLY_SET *>(ii->second);
             const CBVHCONTAINER2D *container = map_holes.at( layer_id );
 
+            if( !layers.test( layer_id ) )
+                continue;
+
             get_layer_z_pos( layer_id, layer_z_top, layer_z_bot );
 
             m_ogl_disp_lists_layers_holes_outer[layer_id] = generate_holes_display_list(
@@ -511,6 +543,9 @@ void C3D_RENDER_OGL_LEGACY::reload( REPORTER* aStatusTextReporter, REPORTER* aWa
             const SHAPE_POLY_SET *poly = static_cast<const SHAPE_POLY_SET *>(ii->second);
             const CBVHCONTAINER2D *container = map_holes.at( layer_id );
 
+            if( !layers.test( layer_id ) )
+                continue;
+
             get_layer_z_pos( layer_id, layer_z_top, layer_z_bot );
 
             m_ogl_disp_lists_layers_holes_inner[layer_id] = generate_holes_display_list(
@@ -519,20 +554,24 @@ void C3D_RENDER_OGL_LEGACY::reload( REPORTER* aStatusTextReporter, REPORTER* aWa
     }
 
     // Generate vertical cylinders of vias and pads (copper)
-    generate_3D_Vias_and_Pads();
+    if( holes )
+        generate_3D_Vias_and_Pads();
 
     // Add layers maps
 
     if( aStatusTextReporter )
         aStatusTextReporter->Report( _( "Load OpenGL: layers" ) );
 
+    std::vector<PCB_LAYER_ID>         layerIds;
+    std::vector<const LIST_OBJECT2D*> layerObjects;
+
     for( MAP_CONTAINER_2D::const_iterator ii = m_boardAdapter.GetMapLayers().begin();
          ii != m_boardAdapter.GetMapLayers().end();
          ++ii )
     {
         PCB_LAYER_ID layer_id = static_cast<PCB_LAYER_ID>(ii->first);
 
-        if( !m_boardAdapter.Is3DLayerEnabled( layer_id ) )
+        if( !m_boardAdapter.Is3DLayerEnabled( layer_id ) || !layers.test( layer_id ) )
             continue;
 
         const CBVHCONTAINER2D *container2d = static_cast<const CBVHCONTAINER2D *>(ii->second);
@@ -541,73 +580,34 @@ void C3D_RENDER_OGL_LEGACY::reload( REPORTER* aStatusTextReporter, REPORTER* aWa
         if( listObject2d.size() == 0 )
             continue;
 
-        float layer_z_bot = 0.0f;
-        float layer_z_top = 0.0f;
-
-        get_layer_z_pos( layer_id, layer_z_top, layer_z_bot );
-
-        // Calculate an estimation for the nr of triangles based on the nr of objects
-        unsigned int nrTrianglesEstimation = listObject2d.size() * 8;
-
-        CLAYER_TRIANGLES *layerTriangles = new CLAYER_TRIANGLES( nrTrianglesEstimation );
-
-        m_triangles[layer_id] = layerTriangles;
+        layerIds.push_back( layer_id );
+        layerObjects.push_back( &listObject2d );
+    }
 
-        // Load the 2D (X,Y axis) component of shapes
-        for( LIST_OBJECT2D::const_iterator itemOnLayer = listObject2d.begin();
-             itemOnLayer != listObject2d.end();
-             ++itemOnLayer )
-        {
-            const COBJECT2D *object2d_A = static_cast<const COBJECT2D *>(*itemOnLayer);
+    // The triangles of the layers are generated concurrently.  The display lists are then
+    // created on this thread, the one of the OpenGL context.
+    std::vector<CLAYER_TRIANGLES*> layerTriangles( layerIds.size(), nullptr );
 
-            switch( object2d_A->GetObjectType() )
+    THREAD_POOL::GetInstance().ParallelFor( layerIds.size(),
+            [&]( size_t i )
             {
-            case OBJECT2D_TYPE::FILLED_CIRCLE:
-                add_object_to_triangle_layer( (const CFILLEDCIRCLE2D *)object2d_A,
-                                              layerTriangles, layer_z_top, layer_z_bot );
-                break;
-
-            case OBJECT2D_TYPE::POLYGON4PT:
-                add_object_to_triangle_layer( (const CPOLYGON4PTS2D *)object2d_A,
-                                              layerTriangles, layer_z_top, layer_z_bot );
-                break;
-
-            case OBJECT2D_TYPE::RING:
-                add_object_to_triangle_layer( (const CRING2D *)object2d_A,
-                                              layerTriangles, layer_z_top, layer_z_bot );
-                break;
-
-            case OBJECT2D_TYPE::TRIANGLE:
-                add_object_to_triangle_layer( (const CTRIANGLE2D *)object2d_A,
-                                              layerTriangles, layer_z_top, layer_z_bot );
-                break;
-
-            case OBJECT2D_TYPE::ROUNDSEG:
-                add_object_to_triangle_layer( (const CROUNDSEGMENT2D *) object2d_A,
-                                              layerTriangles, layer_z_top, layer_z_bot );
-                break;
+                layerTriangles[i] = generate_layer_triangles( layerIds[i], *layerObjects[i] );
+            } );
 
-            default:
-                wxFAIL_MSG("C3D_RENDER_OGL_LEGACY: Object type is not implemented");
-                break;
-            }
-        }
+    for( size_t i = 0; i < layerIds.size(); ++i )
+    {
+        PCB_LAYER_ID layer_id = layerIds[i];
 
-        const MAP_POLY &map_poly = m_boardAdapter.GetPolyMap();
+        float layer_z_bot = 0.0f;
+        float layer_z_top = 0.0f;
 
-        // Load the vertical (Z axis)  component of shapes
-        if( map_poly.find( layer_id ) != map_poly.end() )
-        {
-            const SHAPE_POLY_SET *polyList = map_poly.at( layer_id );
+        get_layer_z_pos( layer_id, layer_z_top, layer_z_bot );
 
-            if( polyList->OutlineCount() > 0 )
-                layerTriangles->AddToMiddleContourns( *polyList, layer_z_bot, layer_z_top,
-                                                      m_boardAdapter.BiuTo3Dunits(), false );
-        }
+        m_triangles[layer_id] = layerTriangles[i];
 
         // Create display list
         // /////////////////////////////////////////////////////////////////////
-        m_ogl_disp_lists_layers[layer_id] = new CLAYERS_OGL_DISP_LISTS( *layerTriangles,
+        m_ogl_disp_lists_layers[layer_id] = new CLAYERS_OGL_DISP_LISTS( *layerTriangles[i],
                                                                         m_ogl_circle_texture,
                                                                         layer_z_bot,
                                                                         layer_z_top );
@@ -627,6 +627,7 @@ void C3D_RENDER_OGL_LEGACY::reload( REPORTER* aStatusTextReporter, REPORTER* aWa
         aStatusTextReporter->Report( _( "Loading 3D models" ) );
 
     load_3D_models( aStatusTextReporter );
+    load_3D_model_instances();
 
 #ifdef PRINT_STATISTICS_3D_VIEWER
     unsigned stats_end_models_Load_Time = GetRunningMicroSecs();
@@ -654,6 +655,75 @@ void C3D_RENDER_OGL_LEGACY::reload( REPORTER* aStatusTextReporter, REPORTER* aWa
 }
 
 
+CLAYER_TRIANGLES* C3D_RENDER_OGL_LEGACY::generate_layer_triangles(
+        PCB_LAYER_ID aLayerId, const LIST_OBJECT2D& aListObject2d )
+{
+    float layer_z_bot = 0.0f;
+    float layer_z_top = 0.0f;
+
+    get_layer_z_pos( aLayerId, layer_z_top, layer_z_bot );
+
+    // Calculate an estimation for the nr of triangles based on the nr of objects
+    unsigned int nrTrianglesEstimation = aListObject2d.size() * 8;
+
+    CLAYER_TRIANGLES *layerTriangles = new CLAYER_TRIANGLES( nrTrianglesEstimation );
+
+    // Load the 2D (X,Y axis) component of shapes
+    for( LIST_OBJECT2D::const_iterator itemOnLayer = aListObject2d.begin();
+         itemOnLayer != aListObject2d.end();
+         ++itemOnLayer )
+    {
+        const COBJECT2D *object2d_A = static_cast<const COBJECT2D *>(*itemOnLayer);
+
+        switch( object2d_A->GetObjectType() )
+        {
+        case OBJECT2D_TYPE::FILLED_CIRCLE:
+            add_object_to_triangle_layer( (const CFILLEDCIRCLE2D *)object2d_A,
+                                          layerTriangles, layer_z_top, layer_z_bot );
+            break;
+
+        case OBJECT2D_TYPE::POLYGON4PT:
+            add_object_to_triangle_layer( (const CPOLYGON4PTS2D *)object2d_A,
+                                          layerTriangles, layer_z_top, layer_z_bot );
+            break;
+
+        case OBJECT2D_TYPE::RING:
+            add_object_to_triangle_layer( (const CRING2D *)object2d_A,
+                                          layerTriangles, layer_z_top, layer_z_bot );
+            break;
+
+        case OBJECT2D_TYPE::TRIANGLE:
+            add_object_to_triangle_layer( (const CTRIANGLE2D *)object2d_A,
+                                          layerTriangles, layer_z_top, layer_z_bot );
+            break;
+
+        case OBJECT2D_TYPE::ROUNDSEG:
+            add_object_to_triangle_layer( (const CROUNDSEGMENT2D *) object2d_A,
+                                          layerTriangles, layer_z_top, layer_z_bot );
+            break;
+
+        default:
+            wxFAIL_MSG("C3D_RENDER_OGL_LEGACY: Object type is not implemented");
+            break;
+        }
+    }
+
+    const MAP_POLY &map_poly = m_boardAdapter.GetPolyMap();
+
+    // Load the vertical (Z axis)  component of shapes
+    if( map_poly.find( aLayerId ) != map_poly.end() )
+    {
+        const SHAPE_POLY_SET *polyList = map_poly.at( aLayerId );
+
+        if( polyList->OutlineCount() > 0 )
+            layerTriangles->AddToMiddleContourns( *polyList, layer_z_bot, layer_z_top,
+                                                  m_boardAdapter.BiuTo3Dunits(), false );
+    }
+
+    return layerTriangles;
+}
+
+
 void C3D_RENDER_OGL_LEGACY::add_triangle_top_bot( CLAYER_TRIANGLES *aDst,
                                                   const SFVEC2F &v0,
                                                   const SFVEC2F &v1,
@@ -901,6 +971,29 @@ void C3D_RENDER_OGL_LEGACY::load_3D_models( REPORTER *aStatusTextReporter )
        (!m_boardAdapter.GetFlag( FL_MODULE_ATTRIBUTES_VIRTUAL )) )
         return;
 
+    // Load the models missing from our cache map on all the cores first: only the
+    // conversion to openGL lists below must run on this thread
+    std::set<wxString>    missingFiles;
+    std::vector<wxString> filesToLoad;
+
+    for( auto module : m_boardAdapter.GetBoard()->Modules() )
+    {
+        for( const MODULE_3D_SETTINGS& model : module->Models() )
+        {
+            if( model.m_Show && !model.m_Filename.empty()
+                    && m_3dmodel_map.find( model.m_Filename ) == m_3dmodel_map.end()
+                    && missingFiles.insert( model.m_Filename ).second )
+            {
+                filesToLoad.push_back( model.m_Filename );
+            }
+        }
+    }
+
+    if( aStatusTextReporter && !filesToLoad.empty() )
+        aStatusTextReporter->Report( _( "Loading 3D models" ) );
+
+    m_boardAdapter.Get3DCacheManager()->LoadModels( filesToLoad );
+
     // Go for all modules
     for( auto module : m_boardAdapter.GetBoard()->Modules() )
     {
@@ -950,3 +1043,74 @@ void C3D_RENDER_OGL_LEGACY::load_3D_models( REPORTER *aStatusTextReporter )
         }
     }
 }
+
+
+void C3D_RENDER_OGL_LEGACY::load_3D_model_instances()
+{
+    m_3dmodel_instances.clear();
+
+    const float biuTo3Dunits = m_boardAdapter.BiuTo3Dunits();
+    const float modelunit_to_3d_units_factor = biuTo3Dunits * UNITS3D_TO_UNITSPCB;
+
+    for( auto module : m_boardAdapter.GetBoard()->Modules() )
+    {
+        if( module->Models().empty() )
+            continue;
+
+        const wxPoint pos = module->GetPosition();
+        const float   zpos = m_boardAdapter.GetModulesZcoord3DIU( module->IsFlipped() );
+
+        glm::mat4 moduleMtx( 1 );
+        moduleMtx = glm::translate( moduleMtx,
+                                    { pos.x * biuTo3Dunits, -pos.y * biuTo3Dunits, zpos } );
+
+        if( module->GetOrientation() )
+            moduleMtx = glm::rotate( moduleMtx,
+                                     glm::radians( (float) module->GetOrientation() / 10.0f ),
+                                     { 0.0f, 0.0f, 1.0f } );
+
+        if( module->IsFlipped() )
+        {
+            moduleMtx = glm::rotate( moduleMtx, glm::radians( 180.0f ), { 0.0f, 1.0f, 0.0f } );
+            moduleMtx = glm::rotate( moduleMtx, glm::radians( 180.0f ), { 0.0f, 0.0f, 1.0f } );
+        }
+
+        moduleMtx = glm::scale( moduleMtx, glm::vec3( modelunit_to_3d_units_factor ) );
+
+        for( const MODULE_3D_SETTINGS& sM : module->Models() )
+        {
+            if( sM.m_Filename.empty() )
+                continue;
+
+            auto cache_i = m_3dmodel_map.find( sM.m_Filename );
+
+            if( cache_i == m_3dmodel_map.end() || !cache_i->second )
+                continue;
+
+            glm::mat4 mtx = glm::translate( moduleMtx,
+                                            { sM.m_Offset.x, sM.m_Offset.y, sM.m_Offset.z } );
+            mtx = glm::rotate(
+                    mtx, glm::radians( (float) -sM.m_Rotation.z ), { 0.0f, 0.0f, 1.0f } );
+            mtx = glm::rotate(
+                    mtx, glm::radians( (float) -sM.m_Rotation.y ), { 0.0f, 1.0f, 0.0f } );
+            mtx = glm::rotate(
+                    mtx, glm::radians( (float) -sM.m_Rotation.x ), { 1.0f, 0.0f, 0.0f } );
+            mtx = glm::scale( mtx, { sM.m_Scale.x, sM.m_Scale.y, sM.m_Scale.z } );
+
+            MODEL_INSTANCE instance;
+            instance.m_model = cache_i->second;
+            instance.m_transform = mtx;
+            instance.m_opacity = sM.m_Opacity;
+            instance.m_attributes = (MODULE_ATTR_T) module->GetAttributes();
+            instance.m_flipped = module->IsFlipped();
+
+            m_3dmodel_instances.push_back( instance );
+        }
+    }
+
+    std::stable_sort( m_3dmodel_instances.begin(), m_3dmodel_instances.end(),
+                      []( const MODEL_INSTANCE& a, const MODEL_INSTANCE& b )
+                      {
+                          return std::less<const C_OGL_3DMODEL*>()( a.m_model, b.m_model );
+                      } );
+}
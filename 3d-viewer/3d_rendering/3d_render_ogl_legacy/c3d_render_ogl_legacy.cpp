@@ -44,6 +44,8 @@
 
 #include <base_units.h>
 
+#include <cfloat>
+
 /**
   * Scale convertion from 3d model units to pcb units
   */
@@ -74,6 +76,7 @@ C3D_RENDER_OGL_LEGACY::C3D_RENDER_OGL_LEGACY( BOARD_ADAPTER& aAdapter, CCAMERA&
     m_last_grid_type     = GRID3D_TYPE::NONE;
 
     m_3dmodel_map.clear();
+    m_layersSerial = 0;
 }
 
 
@@ -1051,6 +1054,7 @@ void C3D_RENDER_OGL_LEGACY::ogl_free_all_display_lists()
     }
 
     m_3dmodel_map.clear();
+    m_3dmodel_instances.clear();
 
 
     delete m_ogl_disp_list_board;
@@ -1079,6 +1083,65 @@ void C3D_RENDER_OGL_LEGACY::ogl_free_all_display_lists()
 }
 
 
+void C3D_RENDER_OGL_LEGACY::ogl_free_layers_display_lists( const LSET& aLayers, bool aHoles )
+{
+    for( MAP_OGL_DISP_LISTS* map : { &m_ogl_disp_lists_layers,
+                                     &m_ogl_disp_lists_layers_holes_outer,
+                                     &m_ogl_disp_lists_layers_holes_inner } )
+    {
+        for( MAP_OGL_DISP_LISTS::iterator ii = map->begin(); ii != map->end(); )
+        {
+            if( aLayers.test( ii->first ) )
+            {
+                delete ii->second;
+                ii = map->erase( ii );
+            }
+            else
+            {
+                ++ii;
+            }
+        }
+    }
+
+    for( MAP_TRIANGLES::iterator ii = m_triangles.begin(); ii != m_triangles.end(); )
+    {
+        if( aLayers.test( ii->first ) )
+        {
+            delete ii->second;
+            ii = m_triangles.erase( ii );
+        }
+        else
+        {
+            ++ii;
+        }
+    }
+
+    if( !aHoles )
+        return;
+
+    delete m_ogl_disp_list_through_holes_outer_with_npth;
+    m_ogl_disp_list_through_holes_outer_with_npth = 0;
+
+    delete m_ogl_disp_list_through_holes_outer;
+    m_ogl_disp_list_through_holes_outer = 0;
+
+    delete m_ogl_disp_list_through_holes_inner;
+    m_ogl_disp_list_through_holes_inner = 0;
+
+    delete m_ogl_disp_list_through_holes_vias_outer;
+    m_ogl_disp_list_through_holes_vias_outer = 0;
+
+    delete m_ogl_disp_list_via;
+    m_ogl_disp_list_via = 0;
+
+    delete m_ogl_disp_list_pads_holes;
+    m_ogl_disp_list_pads_holes = 0;
+
+    delete m_ogl_disp_list_vias_and_pad_holes_outer_contourn_and_caps;
+    m_ogl_disp_list_vias_and_pad_holes_outer_contourn_and_caps = 0;
+}
+
+
 void C3D_RENDER_OGL_LEGACY::render_solder_mask_layer(PCB_LAYER_ID aLayerID,
                                                      float aZPosition,
                                                      bool aDrawMiddleSegments,
@@ -1158,113 +1221,125 @@ void C3D_RENDER_OGL_LEGACY::render_3D_models( bool aRenderTopOrBot,
 {
     C_OGL_3DMODEL::BeginDrawMulti();
 
-    // Go for all modules
-    for( auto module : m_boardAdapter.GetBoard()->Modules() )
-    {
-        if( !module->Models().empty() )
-            if( m_boardAdapter.ShouldModuleBeDisplayed((MODULE_ATTR_T) module->GetAttributes() ) )
-                if( ( aRenderTopOrBot && !module->IsFlipped() )
-                        || ( !aRenderTopOrBot && module->IsFlipped() ) )
-                    render_3D_module( module, aRenderTransparentOnly );
-    }
+    const bool showBBoxes = m_boardAdapter.GetFlag( FL_RENDER_OPENGL_SHOW_MODEL_BBOX );
 
-    C_OGL_3DMODEL::EndDrawMulti();
-}
+    const glm::mat4 viewProj = m_camera.GetProjectionMatrix() * m_camera.GetViewMatrix();
 
+    // The opaque instances of a model, by level of detail
+    std::vector<const glm::mat4*> opaqueTransforms[C_OGL_3DMODEL::lod_max_count];
 
-void C3D_RENDER_OGL_LEGACY::render_3D_module( const MODULE* module,
-                                              bool aRenderTransparentOnly )
-{
-    if( !module->Models().empty() )
+    // Go for all the models, the instances of each one are grouped
+    for( size_t ii = 0; ii < m_3dmodel_instances.size(); )
     {
-        const double zpos = m_boardAdapter.GetModulesZcoord3DIU( module->IsFlipped() );
+        const C_OGL_3DMODEL* modelPtr = m_3dmodel_instances[ii].m_model;
 
-        glPushMatrix();
+        for( std::vector<const glm::mat4*>& transforms : opaqueTransforms )
+            transforms.clear();
 
-        wxPoint pos = module->GetPosition();
+        for( ; ii < m_3dmodel_instances.size() && m_3dmodel_instances[ii].m_model == modelPtr;
+             ++ii )
+        {
+            const MODEL_INSTANCE& instance = m_3dmodel_instances[ii];
 
-        glTranslatef( pos.x * m_boardAdapter.BiuTo3Dunits(),
-                      -pos.y * m_boardAdapter.BiuTo3Dunits(),
-                       zpos );
+            if( instance.m_flipped == aRenderTopOrBot
+                    || !m_boardAdapter.ShouldModuleBeDisplayed( instance.m_attributes ) )
+                continue;
 
-        if( module->GetOrientation() )
-            glRotated( (double) module->GetOrientation() / 10.0, 0.0, 0.0, 1.0 );
+            bool opaque = instance.m_opacity >= 1.0;
 
-        if( module->IsFlipped() )
-        {
-            glRotatef( 180.0f, 0.0f, 1.0f, 0.0f );
-            glRotatef( 180.0f, 0.0f, 0.0f, 1.0f );
-        }
+            if( !aRenderTransparentOnly && modelPtr->Have_opaque() && opaque )
+            {
+                const float pixels = get_3D_model_pixel_size( modelPtr,
+                                                              viewProj * instance.m_transform );
 
-        double modelunit_to_3d_units_factor = m_boardAdapter.BiuTo3Dunits() * UNITS3D_TO_UNITSPCB;
+                opaqueTransforms[modelPtr->GetLod( pixels )].push_back( &instance.m_transform );
+            }
+            else if( aRenderTransparentOnly && ( modelPtr->Have_transparent() || !opaque ) )
+            {
+                glPushMatrix();
+                glMultMatrixf( glm::value_ptr( instance.m_transform ) );
 
-        glScaled( modelunit_to_3d_units_factor,
-                  modelunit_to_3d_units_factor,
-                  modelunit_to_3d_units_factor );
+                modelPtr->Draw_transparent( instance.m_opacity );
 
-        // Get the list of model files for this model
-        for( auto& sM : module->Models () )
-        {
-            if( sM.m_Filename.empty() )
-                continue;
+                glPopMatrix();
 
-            // Check if the model is present in our cache map
-            auto cache_i = m_3dmodel_map.find( sM.m_Filename );
+                if( showBBoxes )
+                    render_3D_model_bbox( modelPtr, instance.m_transform );
+            }
+        }
 
-            if( cache_i == m_3dmodel_map.end() )
-                continue;
+        for( unsigned int lod = 0; lod < C_OGL_3DMODEL::lod_max_count; ++lod )
+        {
+            modelPtr->Draw_opaque_instances( opaqueTransforms[lod], lod );
 
-            if( const C_OGL_3DMODEL *modelPtr = cache_i->second )
+            if( showBBoxes )
             {
-                bool opaque = sM.m_Opacity >= 1.0;
+                for( const glm::mat4* transform : opaqueTransforms[lod] )
+                    render_3D_model_bbox( modelPtr, *transform );
+            }
+        }
+    }
+
+    C_OGL_3DMODEL::EndDrawMulti();
+}
 
-                if( ( !aRenderTransparentOnly && modelPtr->Have_opaque() && opaque ) ||
-                    ( aRenderTransparentOnly && ( modelPtr->Have_transparent() || !opaque ) ) )
-                {
-                    glPushMatrix();
-
-                    // FIXME: don't do this over and over again unless the
-                    // values have changed.  cache the matrix somewhere.
-                    glm::mat4 mtx( 1 );
-                    mtx = glm::translate( mtx, { sM.m_Offset.x, sM.m_Offset.y, sM.m_Offset.z } );
-                    mtx = glm::rotate(
-                            mtx, glm::radians( (float) -sM.m_Rotation.z ), { 0.0f, 0.0f, 1.0f } );
-                    mtx = glm::rotate(
-                            mtx, glm::radians( (float) -sM.m_Rotation.y ), { 0.0f, 1.0f, 0.0f } );
-                    mtx = glm::rotate(
-                            mtx, glm::radians( (float) -sM.m_Rotation.x ), { 1.0f, 0.0f, 0.0f } );
-                    mtx = glm::scale( mtx, { sM.m_Scale.x, sM.m_Scale.y, sM.m_Scale.z } );
-                    glMultMatrixf( glm::value_ptr( mtx ) );
-
-                    if( aRenderTransparentOnly )
-                        modelPtr->Draw_transparent( sM.m_Opacity );
-                    else
-                        modelPtr->Draw_opaque();
-
-                    if( m_boardAdapter.GetFlag( FL_RENDER_OPENGL_SHOW_MODEL_BBOX ) )
-                    {
-                        glEnable( GL_BLEND );
-                        glBlendFunc( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA );
 
-                        glDisable( GL_LIGHTING );
+float C3D_RENDER_OGL_LEGACY::get_3D_model_pixel_size( const C_OGL_3DMODEL* aModel,
+                                                      const glm::mat4& aModelViewProj ) const
+{
+    const CBBOX& bbox = aModel->GetBBox();
 
-                        glLineWidth( 1 );
-                        modelPtr->Draw_bboxes();
+    if( !bbox.IsInitialized() )
+        return 0.0f;
 
-                        glLineWidth( 4 );
-                        modelPtr->Draw_bbox();
+    SFVEC2F ndcMin( FLT_MAX );
+    SFVEC2F ndcMax( -FLT_MAX );
 
-                        glEnable( GL_LIGHTING );
-                        glDisable( GL_BLEND );
-                    }
+    for( unsigned int i = 0; i < 8; ++i )
+    {
+        const glm::vec4 corner( ( i & 1 ) ? bbox.Max().x : bbox.Min().x,
+                                ( i & 2 ) ? bbox.Max().y : bbox.Min().y,
+                                ( i & 4 ) ? bbox.Max().z : bbox.Min().z,
+                                1.0f );
 
-                    glPopMatrix();
-                }
-            }
-        }
+        const glm::vec4 clip = aModelViewProj * corner;
 
-        glPopMatrix();
+        // Crossing the camera plane, keep the full mesh
+        if( clip.w <= FLT_EPSILON )
+            return FLT_MAX;
+
+        const SFVEC2F ndc = SFVEC2F( clip.x, clip.y ) / clip.w;
+
+        ndcMin = glm::min( ndcMin, ndc );
+        ndcMax = glm::max( ndcMax, ndc );
     }
+
+    return std::max( ( ndcMax.x - ndcMin.x ) * m_windowSize.x,
+                     ( ndcMax.y - ndcMin.y ) * m_windowSize.y ) * 0.5f;
+}
+
+
+void C3D_RENDER_OGL_LEGACY::render_3D_model_bbox( const C_OGL_3DMODEL* aModel,
+                                                  const glm::mat4& aTransform )
+{
+    glPushMatrix();
+    glMultMatrixf( glm::value_ptr( aTransform ) );
+
+    glEnable( GL_BLEND );
+    glBlendFunc( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA );
+
+    glDisable( GL_LIGHTING );
+
+    glLineWidth( 1 );
+    aModel->Draw_bboxes();
+
+    glLineWidth( 4 );
+    aModel->Draw_bbox();
+
+    glEnable( GL_LIGHTING );
+    glDisable( GL_BLEND );
+
+    glPopMatrix();
 }
 
 
@@ -77,6 +77,9 @@ private:
     void ogl_set_arrow_material();
 
     void ogl_free_all_display_lists();
+
+    /// Free the display lists of aLayers, and of the holes if aHoles is set
+    void ogl_free_layers_display_lists( const LSET& aLayers, bool aHoles );
     MAP_OGL_DISP_LISTS      m_ogl_disp_lists_layers;
     MAP_OGL_DISP_LISTS      m_ogl_disp_lists_layers_holes_outer;
     MAP_OGL_DISP_LISTS      m_ogl_disp_lists_layers_holes_inner;
@@ -107,6 +110,22 @@ private:
 
     MAP_3DMODEL m_3dmodel_map;
 
+    /// A model placed on the board by a footprint
+    struct MODEL_INSTANCE
+    {
+        const C_OGL_3DMODEL* m_model;
+        glm::mat4            m_transform;   ///< from the model to the board 3D units
+        float                m_opacity;
+        MODULE_ATTR_T        m_attributes;  ///< of the footprint
+        bool                 m_flipped;
+    };
+
+    /// The models of the footprints, the instances of a model grouped to bind it once a frame
+    std::vector<MODEL_INSTANCE> m_3dmodel_instances;
+
+    /// the BOARD_ADAPTER build the display lists were generated from
+    unsigned int m_layersSerial;
+
 private:
     CLAYERS_OGL_DISP_LISTS *generate_holes_display_list( const LIST_OBJECT2D &aListHolesObject2d,
                                                          const SHAPE_POLY_SET &aPoly,
@@ -171,10 +190,20 @@ private:
                             unsigned int aNr_sides_per_circle,
                             CLAYER_TRIANGLES *aDstLayer );
 
+    /**
+     * Generates the triangles of the copper or technical layer aLayerId.  Does not use
+     * OpenGL: called concurrently for the layers, the triangles are uploaded afterwards.
+     */
+    CLAYER_TRIANGLES* generate_layer_triangles( PCB_LAYER_ID aLayerId,
+                                                const LIST_OBJECT2D& aListObject2d );
+
     void generate_3D_Vias_and_Pads();
 
     void load_3D_models( REPORTER *aStatusTextReporter );
 
+    /// Place the models of m_3dmodel_map on the footprints of the board
+    void load_3D_model_instances();
+
     /**
      * @brief render_3D_models
      * @param aRenderTopOrBot - true will render Top, false will render bottom
@@ -183,7 +212,11 @@ private:
      */
     void render_3D_models( bool aRenderTopOrBot, bool aRenderTransparentOnly );
 
-    void render_3D_module( const MODULE* module, bool aRenderTransparentOnly );
+    void render_3D_model_bbox( const C_OGL_3DMODEL* aModel, const glm::mat4& aTransform );
+
+    /// @return the size in pixels of the bounding box of aModel, drawn with aModelViewProj
+    float get_3D_model_pixel_size( const C_OGL_3DMODEL* aModel,
+                                   const glm::mat4& aModelViewProj ) const;
 
     void setLight_Front( bool enabled );
     void setLight_Top( bool enabled );
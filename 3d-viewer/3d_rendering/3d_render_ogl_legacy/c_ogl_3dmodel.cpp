@@ -34,7 +34,9 @@
 #include "../common_ogl/ogl_utils.h"
 #include "../3d_math.h"
 #include <wx/debug.h>
+#include <cfloat>
 #include <chrono>
+#include <unordered_map>
 
 const wxChar * C_OGL_3DMODEL::m_logTrace = wxT( "KI_TRACE_EDA_OGL_3DMODEL" );
 
@@ -121,6 +123,7 @@ C_OGL_3DMODEL::C_OGL_3DMODEL( const S3DMODEL &a3DModel,
     {
         std::vector<VERTEX> m_vertices;
         std::vector<GLuint> m_indices;
+        std::vector<std::vector<GLuint>> m_lod_indices;   // from the level of detail 1
     };
 
     std::vector<MESH_GROUP> mesh_groups( m_materials.size() );
@@ -277,6 +280,46 @@ C_OGL_3DMODEL::C_OGL_3DMODEL( const S3DMODEL &a3DModel,
     }
 
 
+    // generate the levels of detail of the detailed models.  they are decimated from
+    // the full mesh, and kept only if they save enough triangles over the previous level
+    m_lod_resolutions.push_back( 0 );
+
+    unsigned int lod_index_count = 0;
+
+    for( auto& mg : mesh_groups )
+        lod_index_count += mg.m_indices.size();
+
+    if( lod_index_count >= 3 * 2000 && m_model_bbox.IsInitialized() )
+    {
+        static const unsigned int lod_resolutions[lod_max_count - 1] = { 64, 24, 8 };
+
+        for( unsigned int resolution : lod_resolutions )
+        {
+            std::vector<std::vector<GLuint>> lod_indices( mesh_groups.size() );
+            unsigned int                     index_count = 0;
+
+            for( unsigned int mg_i = 0; mg_i < mesh_groups.size(); ++mg_i )
+            {
+                DecimateIndices( mesh_groups[mg_i].m_vertices, mesh_groups[mg_i].m_indices,
+                                 m_model_bbox, resolution, lod_indices[mg_i] );
+                index_count += lod_indices[mg_i].size();
+            }
+
+            if( index_count * 4 > lod_index_count * 3 )
+                continue;
+
+            for( unsigned int mg_i = 0; mg_i < mesh_groups.size(); ++mg_i )
+                mesh_groups[mg_i].m_lod_indices.push_back( std::move( lod_indices[mg_i] ) );
+
+            m_lod_resolutions.push_back( resolution );
+            lod_index_count = index_count;
+
+            wxLogTrace( m_logTrace, wxT( "  level of detail %u: %u indices" ),
+                        static_cast<unsigned int>( m_lod_resolutions.size() - 1 ),
+                        index_count );
+        }
+    }
+
     // merge the mesh group geometry data.
     unsigned int total_vertex_count = 0;
     unsigned int total_index_count = 0;
@@ -285,6 +328,9 @@ C_OGL_3DMODEL::C_OGL_3DMODEL( const S3DMODEL &a3DModel,
     {
         total_vertex_count += mg.m_vertices.size();
         total_index_count += mg.m_indices.size();
+
+        for( auto& lod : mg.m_lod_indices )
+            total_index_count += lod.size();
     }
 
     wxLogTrace( m_logTrace, wxT( "  total %u vertices, %u indices" ),
@@ -322,21 +368,32 @@ C_OGL_3DMODEL::C_OGL_3DMODEL( const S3DMODEL &a3DModel,
         auto& mg = mesh_groups[mg_i];
         auto& mat = m_materials[mg_i];
 
-        if( m_index_buffer_type == GL_UNSIGNED_SHORT )
+        for( unsigned int lod = 0; lod < m_lod_resolutions.size(); ++lod )
         {
-            auto idx_out = reinterpret_cast<GLushort*>(
-                reinterpret_cast<uintptr_t>( tmp_idx.get() ) + idx_offset );
+            const std::vector<GLuint>& indices = lod == 0 ? mg.m_indices
+                                                          : mg.m_lod_indices[lod - 1];
 
-            for( auto idx : mg.m_indices )
-                *idx_out++ = static_cast<GLushort>( idx + prev_vtx_count );
-        }
-        else if( m_index_buffer_type == GL_UNSIGNED_INT )
-        {
-            auto idx_out = reinterpret_cast<GLuint*>(
-                reinterpret_cast<uintptr_t>( tmp_idx.get() ) + idx_offset );
+            if( m_index_buffer_type == GL_UNSIGNED_SHORT )
+            {
+                auto idx_out = reinterpret_cast<GLushort*>(
+                    reinterpret_cast<uintptr_t>( tmp_idx.get() ) + idx_offset );
+
+                for( auto idx : indices )
+                    *idx_out++ = static_cast<GLushort>( idx + prev_vtx_count );
+            }
+            else if( m_index_buffer_type == GL_UNSIGNED_INT )
+            {
+                auto idx_out = reinterpret_cast<GLuint*>(
+                    reinterpret_cast<uintptr_t>( tmp_idx.get() ) + idx_offset );
+
+                for( auto idx : indices )
+                    *idx_out++ = static_cast<GLuint>( idx + prev_vtx_count );
+            }
 
-            for( auto idx : mg.m_indices )
-                *idx_out++ = static_cast<GLuint>( idx + prev_vtx_count );
+            mat.m_render_idx_buffer_offset[lod] = idx_offset;
+            mat.m_render_idx_count[lod] = indices.size();
+
+            idx_offset += indices.size() * idx_size;
         }
 
         glBufferSubData( GL_ARRAY_BUFFER,
@@ -344,11 +401,7 @@ C_OGL_3DMODEL::C_OGL_3DMODEL( const S3DMODEL &a3DModel,
                          mg.m_vertices.size() * sizeof( VERTEX ),
                          mg.m_vertices.data() );
 
-        mat.m_render_idx_buffer_offset = idx_offset;
-        mat.m_render_idx_count = mg.m_indices.size();
-
         prev_vtx_count += mg.m_vertices.size();
-        idx_offset += mg.m_indices.size() * idx_size;
         vtx_offset += mg.m_vertices.size() * sizeof( VERTEX );
     }
 
@@ -367,6 +420,145 @@ C_OGL_3DMODEL::C_OGL_3DMODEL( const S3DMODEL &a3DModel,
                    end_time - start_time).count() );
 }
 
+unsigned int C_OGL_3DMODEL::GetLod( float aPixels ) const
+{
+    // a level is used while its grid cells are not larger than a pixel
+    for( unsigned int lod = m_lod_resolutions.size(); lod > 1; --lod )
+    {
+        if( aPixels <= m_lod_resolutions[lod - 1] )
+            return lod - 1;
+    }
+
+    return 0;
+}
+
+
+void C_OGL_3DMODEL::DecimateIndices( const std::vector<VERTEX>& aVertices,
+                                     const std::vector<GLuint>& aIndices,
+                                     const CBBOX& aBBox, unsigned int aResolution,
+                                     std::vector<GLuint>& aIndicesOut )
+{
+    aIndicesOut.clear();
+
+    const float cell_size = std::max( aBBox.GetMaxDimension(), FLT_EPSILON ) / aResolution;
+
+    // the error quadric of the planes of the faces around a cell, as the 10 terms of the
+    // symmetric 4x4 matrix
+    struct QUADRIC
+    {
+        double m[10] = {};
+
+        void Add( const glm::dvec3& aNormal, double aD, double aWeight )
+        {
+            const double a = aNormal.x, b = aNormal.y, c = aNormal.z;
+
+            m[0] += aWeight * a * a; m[1] += aWeight * a * b; m[2] += aWeight * a * c;
+            m[3] += aWeight * a * aD; m[4] += aWeight * b * b; m[5] += aWeight * b * c;
+            m[6] += aWeight * b * aD; m[7] += aWeight * c * c; m[8] += aWeight * c * aD;
+            m[9] += aWeight * aD * aD;
+        }
+
+        double Error( const glm::vec3& aPos ) const
+        {
+            const double x = aPos.x, y = aPos.y, z = aPos.z;
+
+            return m[0] * x * x + 2 * m[1] * x * y + 2 * m[2] * x * z + 2 * m[3] * x
+                 + m[4] * y * y + 2 * m[5] * y * z + 2 * m[6] * y
+                 + m[7] * z * z + 2 * m[8] * z
+                 + m[9];
+        }
+    };
+
+    // find the cell of each vertex
+    std::unordered_map<uint64_t, unsigned int> cells;
+    std::vector<unsigned int>                  vertex_cell( aVertices.size() );
+
+    auto cellCoord = [aResolution]( float aCoord ) -> uint64_t
+    {
+        return (uint64_t) glm::clamp( aCoord, 0.0f, (float) aResolution );
+    };
+
+    for( unsigned int vtx_i = 0; vtx_i < aVertices.size(); ++vtx_i )
+    {
+        const glm::vec3 cell = ( aVertices[vtx_i].m_pos - aBBox.Min() ) / cell_size;
+
+        const uint64_t key = cellCoord( cell.x )
+                           | ( cellCoord( cell.y ) << 21 )
+                           | ( cellCoord( cell.z ) << 42 );
+
+        vertex_cell[vtx_i] = cells.emplace( key, cells.size() ).first->second;
+    }
+
+    std::vector<QUADRIC> quadrics( cells.size() );
+
+    const unsigned int tri_count = aIndices.size() / 3;
+
+    auto validTriangle = [&]( unsigned int aTri ) -> bool
+    {
+        return aIndices[aTri * 3 + 0] < aVertices.size()
+            && aIndices[aTri * 3 + 1] < aVertices.size()
+            && aIndices[aTri * 3 + 2] < aVertices.size();
+    };
+
+    for( unsigned int tri_i = 0; tri_i < tri_count; ++tri_i )
+    {
+        if( !validTriangle( tri_i ) )
+            continue;
+
+        const glm::dvec3 p0( aVertices[aIndices[tri_i * 3 + 0]].m_pos );
+        const glm::dvec3 p1( aVertices[aIndices[tri_i * 3 + 1]].m_pos );
+        const glm::dvec3 p2( aVertices[aIndices[tri_i * 3 + 2]].m_pos );
+
+        glm::dvec3   normal = glm::cross( p1 - p0, p2 - p0 );
+        const double length = glm::length( normal );
+
+        if( length <= 0.0 )
+            continue;
+
+        normal /= length;
+
+        // weighted by the area of the face
+        for( unsigned int i = 0; i < 3; ++i )
+            quadrics[vertex_cell[aIndices[tri_i * 3 + i]]].Add( normal, -glm::dot( normal, p0 ),
+                                                                length * 0.5 );
+    }
+
+    // keep the vertex of each cell which moves the faces the least
+    std::vector<unsigned int> representative( cells.size(), 0 );
+    std::vector<double>       best_error( cells.size(), DBL_MAX );
+
+    for( unsigned int vtx_i = 0; vtx_i < aVertices.size(); ++vtx_i )
+    {
+        const unsigned int cell = vertex_cell[vtx_i];
+        const double       error = quadrics[cell].Error( aVertices[vtx_i].m_pos );
+
+        if( error < best_error[cell] )
+        {
+            best_error[cell] = error;
+            representative[cell] = vtx_i;
+        }
+    }
+
+    // remap the triangles, the ones collapsed to a line or a point are dropped
+    for( unsigned int tri_i = 0; tri_i < tri_count; ++tri_i )
+    {
+        if( !validTriangle( tri_i ) )
+            continue;
+
+        const GLuint a = representative[vertex_cell[aIndices[tri_i * 3 + 0]]];
+        const GLuint b = representative[vertex_cell[aIndices[tri_i * 3 + 1]]];
+        const GLuint c = representative[vertex_cell[aIndices[tri_i * 3 + 2]]];
+
+        if( a == b || b == c || a == c )
+            continue;
+
+        aIndicesOut.push_back( a );
+        aIndicesOut.push_back( b );
+        aIndicesOut.push_back( c );
+    }
+}
+
+
 void C_OGL_3DMODEL::BeginDrawMulti()
 {
     glEnableClientState( GL_VERTEX_ARRAY );
@@ -391,11 +583,8 @@ void C_OGL_3DMODEL::EndDrawMulti()
 }
 
 
-void C_OGL_3DMODEL::Draw( bool aTransparent, float aOpacity ) const
+void C_OGL_3DMODEL::bindBuffers() const
 {
-    if( aOpacity <= FLT_EPSILON )
-        return;
-
     glBindBuffer( GL_ARRAY_BUFFER, m_vertex_buffer );
     glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, m_index_buffer );
 
@@ -413,6 +602,37 @@ void C_OGL_3DMODEL::Draw( bool aTransparent, float aOpacity ) const
 
     glTexCoordPointer( 2, GL_FLOAT, sizeof( VERTEX ),
                        reinterpret_cast<const void*>( offsetof( VERTEX, m_tex_uv ) ) );
+}
+
+
+void C_OGL_3DMODEL::setMaterial( const MATERIAL& aMaterial, float aOpacity ) const
+{
+    switch( m_material_mode )
+    {
+    case MATERIAL_MODE::NORMAL:
+        OGL_SetMaterial( aMaterial, aOpacity );
+    break;
+
+    case MATERIAL_MODE::DIFFUSE_ONLY:
+        OGL_SetDiffuseOnlyMaterial( aMaterial.m_Diffuse, aOpacity );
+    break;
+
+    case MATERIAL_MODE::CAD_MODE:
+        OGL_SetDiffuseOnlyMaterial( MaterialDiffuseToColorCAD( aMaterial.m_Diffuse ), aOpacity );
+    break;
+
+    default:
+    break;
+    }
+}
+
+
+void C_OGL_3DMODEL::Draw( bool aTransparent, float aOpacity ) const
+{
+    if( aOpacity <= FLT_EPSILON )
+        return;
+
+    bindBuffers();
 
     const SFVEC4F param = SFVEC4F( 1.0f, 1.0f, 1.0f, aOpacity );
 
@@ -426,29 +646,53 @@ void C_OGL_3DMODEL::Draw( bool aTransparent, float aOpacity ) const
             ( aOpacity >= 1.0f ) )
             continue;
 
-        switch( m_material_mode )
-        {
-        case MATERIAL_MODE::NORMAL:
-            OGL_SetMaterial( mat, aOpacity );
-        break;
+        setMaterial( mat, aOpacity );
 
-        case MATERIAL_MODE::DIFFUSE_ONLY:
-            OGL_SetDiffuseOnlyMaterial( mat.m_Diffuse, aOpacity );
-        break;
+        glDrawElements( GL_TRIANGLES, mat.m_render_idx_count[0], m_index_buffer_type,
+                        reinterpret_cast<const void*>( mat.m_render_idx_buffer_offset[0] ) );
+    }
 
-        case MATERIAL_MODE::CAD_MODE:
-            OGL_SetDiffuseOnlyMaterial( MaterialDiffuseToColorCAD( mat.m_Diffuse ), aOpacity );
-        break;
+    // EndDrawMulti();
+}
 
-        default:
-        break;
-      }
 
-      glDrawElements( GL_TRIANGLES, mat.m_render_idx_count, m_index_buffer_type,
-                      reinterpret_cast<const void*>( mat.m_render_idx_buffer_offset ) );
-    }
+void C_OGL_3DMODEL::Draw_opaque_instances( const std::vector<const glm::mat4*>& aTransforms,
+                                           unsigned int aLod ) const
+{
+    if( aTransforms.empty() )
+        return;
 
-    // EndDrawMulti();
+    wxASSERT( aLod < m_lod_resolutions.size() || m_lod_resolutions.empty() );
+
+    bindBuffers();
+
+    const SFVEC4F param = SFVEC4F( 1.0f );
+
+    glTexEnvfv( GL_TEXTURE_ENV, GL_TEXTURE_ENV_COLOR, (const float*)&param.x );
+
+    // The material changes cost more than the matrices, so draw all the instances
+    // of a material before setting the next one
+    for( auto& mat : m_materials )
+    {
+        if( mat.IsTransparent() )
+            continue;
+
+        setMaterial( mat, 1.0f );
+
+        if( mat.m_render_idx_count[aLod] == 0 )
+            continue;
+
+        for( const glm::mat4* transform : aTransforms )
+        {
+            glPushMatrix();
+            glMultMatrixf( glm::value_ptr( *transform ) );
+
+            glDrawElements( GL_TRIANGLES, mat.m_render_idx_count[aLod], m_index_buffer_type,
+                            reinterpret_cast<const void*>( mat.m_render_idx_buffer_offset[aLod] ) );
+
+            glPopMatrix();
+        }
+    }
 }
 
 C_OGL_3DMODEL::~C_OGL_3DMODEL()
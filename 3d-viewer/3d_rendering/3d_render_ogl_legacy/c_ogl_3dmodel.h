@@ -60,6 +60,24 @@ public:
      */
     void Draw_transparent( float aOpacity ) const { Draw( true, aOpacity ); }
 
+    /**
+     * @brief Draw_opaque_instances - render the model at each of the transforms (relative to
+     * the current matrix) into the current context.  The buffers are bound and each material
+     * is set once for all the instances
+     */
+    void Draw_opaque_instances( const std::vector<const glm::mat4*>& aTransforms,
+                                unsigned int aLod = 0 ) const;
+
+    /// The maximum number of levels of detail of a model, including the full mesh
+    static constexpr unsigned int lod_max_count = 4;
+
+    /**
+     * @brief GetLod - get the coarsest level of detail which still looks like the full mesh
+     * @param aPixels - the size of the model on the screen
+     * @return the level of detail, 0 for the full mesh
+     */
+    unsigned int GetLod( float aPixels ) const;
+
     /**
      * @brief Have_opaque - return true if have opaque meshs to render
      */
@@ -127,8 +145,9 @@ private:
     // all meshes are grouped by material for rendering purposes.
     struct MATERIAL : SMATERIAL
     {
-        unsigned int m_render_idx_buffer_offset = 0;
-        unsigned int m_render_idx_count = 0;
+        // the index range of each level of detail, the first one is the full mesh
+        unsigned int m_render_idx_buffer_offset[lod_max_count] = {};
+        unsigned int m_render_idx_count[lod_max_count] = {};
 
         MATERIAL( const SMATERIAL &aOther ) : SMATERIAL( aOther ) { }
         bool IsTransparent() const { return m_Transparency > FLT_EPSILON; }
@@ -136,6 +155,11 @@ private:
 
     std::vector<MATERIAL> m_materials;
 
+    // the levels of detail share the vertices of the full mesh: their triangles are
+    // remapped on a grid of m_lod_resolutions[i] cells along the longest side of the
+    // model (0 for the full mesh)
+    std::vector<unsigned int> m_lod_resolutions;
+
     // a model can consist of transparent and opaque parts.  remember which
     // ones are present during initial buffer and data setup.  use it later
     // during rendering.
@@ -155,7 +179,24 @@ private:
                           VERTEX *aVtxOut, GLuint *aIdxOut,
                           const glm::vec4 &aColor );
 
+    /**
+     * Decimate a mesh by vertex clustering: the vertices of each cell of a grid are merged
+     * into the one with the lowest quadric error of the faces around the cell.
+     * @param aResolution the number of cells along the longest side of aBBox
+     * @param aIndicesOut the triangles left, which use the input vertices
+     */
+    static void DecimateIndices( const std::vector<VERTEX>& aVertices,
+                                 const std::vector<GLuint>& aIndices,
+                                 const CBBOX& aBBox, unsigned int aResolution,
+                                 std::vector<GLuint>& aIndicesOut );
+
     void Draw( bool aTransparent, float aOpacity ) const;
+
+    /// Bind the buffers of the model and set the vertex attribute pointers
+    void bindBuffers() const;
+
+    /// Set the render state of one of the materials of the model
+    void setMaterial( const MATERIAL& aMaterial, float aOpacity ) const;
 };
 
 #endif // _C_OGL_3DMODEL_H_
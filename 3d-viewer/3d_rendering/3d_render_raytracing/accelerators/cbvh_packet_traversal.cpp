@@ -28,8 +28,14 @@
  */
 
 #include "cbvh_pbrt.h"
+#include "../raypacket_simd.h"
+#include "../shapes3D/ctriangle.h"
 #include <wx/debug.h>
 
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
 
 #define BVH_RANGED_TRAVERSAL
 //#define BVH_PARTITION_TRAVERSAL
@@ -45,48 +51,31 @@ struct StackNode
 };
 
 
-static inline unsigned int getFirstHit( const RAYPACKET &aRayPacket,
-                                        const CBBOX &aBBox,
-                                        unsigned int ia,
-                                        HITINFO_PACKET *aHitInfoPacket )
-{
-    float hitT;
-
-    if( aBBox.Intersect( aRayPacket.m_ray[ia], &hitT ) )
-        if( hitT < aHitInfoPacket[ia].m_HitInfo.m_tHit )
-            return ia;
-
-    if( !aRayPacket.m_Frustum.Intersect( aBBox ) )
-        return RAYPACKET_RAYS_PER_PACKET;
-
-    for( unsigned int i = ia + 1; i < RAYPACKET_RAYS_PER_PACKET; ++i )
-    {
-        if( aBBox.Intersect( aRayPacket.m_ray[i], &hitT ) )
-            if( hitT < aHitInfoPacket[i].m_HitInfo.m_tHit )
-                return i;
-    }
-
-    return RAYPACKET_RAYS_PER_PACKET;
-}
-
-
 #ifdef BVH_RANGED_TRAVERSAL
 
-static inline unsigned int getLastHit( const RAYPACKET &aRayPacket,
-                                       const CBBOX &aBBox,
-                                       unsigned int ia,
-                                       HITINFO_PACKET *aHitInfoPacket )
+/// @return the index of the first set bit of a non null mask
+static inline unsigned int firstRay( uint64_t aMask )
 {
-    for( unsigned int ie = (RAYPACKET_RAYS_PER_PACKET - 1); ie > ia; --ie )
-    {
-        float hitT;
+#ifdef _MSC_VER
+    unsigned long idx;
+    _BitScanForward64( &idx, aMask );
+    return idx;
+#else
+    return __builtin_ctzll( aMask );
+#endif
+}
 
-        if( aBBox.Intersect( aRayPacket.m_ray[ie], &hitT ) )
-            if( hitT < aHitInfoPacket[ie].m_HitInfo.m_tHit )
-                return ie + 1;
-    }
 
-    return ia + 1;
+/// @return the index after the last set bit of a non null mask
+static inline unsigned int endRay( uint64_t aMask )
+{
+#ifdef _MSC_VER
+    unsigned long idx;
+    _BitScanReverse64( &idx, aMask );
+    return idx + 1;
+#else
+    return 64 - __builtin_clzll( aMask );
+#endif
 }
 
 
@@ -107,16 +96,26 @@ bool CBVH_PBRT::Intersect( const RAYPACKET &aRayPacket,
     int todoOffset = 0, nodeNum = 0;
     StackNode todo[MAX_TODOS];
 
+    // The hit distances, as an array for the SIMD kernels
+    float tHit[RAYPACKET_RAYS_PER_PACKET];
+
+    for( unsigned int i = 0; i < RAYPACKET_RAYS_PER_PACKET; ++i )
+        tHit[i] = aHitInfoPacket[i].m_HitInfo.m_tHit;
+
     unsigned int ia = 0;
 
     while( true )
     {
         const LinearBVHNode *curCell = &m_nodes[nodeNum];
 
-        ia = getFirstHit( aRayPacket, curCell->bounds, ia, aHitInfoPacket );
+        // All the rays from the first alive one entering the cell
+        const uint64_t hits = RAYPACKET_IntersectBBox( aRayPacket.m_soa, curCell->bounds,
+                                                       tHit, ia );
 
-        if( ia < RAYPACKET_RAYS_PER_PACKET )
+        if( hits )
         {
+            ia = firstRay( hits );
+
             if( curCell->nPrimitives == 0 )
             {
                 StackNode &node = todo[todoOffset++];
@@ -127,28 +126,33 @@ bool CBVH_PBRT::Intersect( const RAYPACKET &aRayPacket,
             }
             else
             {
-                const unsigned int ie = getLastHit( aRayPacket,
-                                                    curCell->bounds,
-                                                    ia,
-                                                    aHitInfoPacket );
+                const unsigned int ie = endRay( hits );
 
                 for( int j = 0; j < curCell->nPrimitives; ++j )
                 {
                     const COBJECT *obj = m_primitives[curCell->primitivesOffset + j];
 
-                    if( aRayPacket.m_Frustum.Intersect( obj->GetBBox() ) )
+                    if( !aRayPacket.m_Frustum.Intersect( obj->GetBBox() ) )
+                        continue;
+
+                    uint64_t candidates;
+
+                    if( obj->GetObjectType() == OBJECT3D_TYPE::TRIANGLE )
+                        candidates = static_cast<const CTRIANGLE *>( obj )->IntersectPacket(
+                                aRayPacket, tHit, ia, ie );
+                    else
+                        candidates = RAYPACKET_RangeMask( ia, ie );
+
+                    for( ; candidates; candidates &= candidates - 1 )
                     {
-                        for( unsigned int i = ia; i < ie; ++i )
-                        {
-                            const bool hitted = obj->Intersect( aRayPacket.m_ray[i],
-                                                                aHitInfoPacket[i].m_HitInfo );
+                        const unsigned int i = firstRay( candidates );
 
-                            if( hitted )
-                            {
-                                anyHitted |= hitted;
-                                aHitInfoPacket[i].m_hitresult |= hitted;
-                                aHitInfoPacket[i].m_HitInfo.m_acc_node_info = nodeNum;
-                            }
+                        if( obj->Intersect( aRayPacket.m_ray[i], aHitInfoPacket[i].m_HitInfo ) )
+                        {
+                            anyHitted = true;
+                            aHitInfoPacket[i].m_hitresult = true;
+                            aHitInfoPacket[i].m_HitInfo.m_acc_node_info = nodeNum;
+                            tHit[i] = aHitInfoPacket[i].m_HitInfo.m_tHit;
                         }
                     }
                 }
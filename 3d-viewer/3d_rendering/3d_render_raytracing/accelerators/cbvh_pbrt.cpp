@@ -69,9 +69,12 @@
 #include "cbvh_pbrt.h"
 #include "../../../3d_fastmath.h"
 #include <macros.h>
+#include <thread_pool.h>
 
 #include <boost/range/algorithm/nth_element.hpp>
 #include <boost/range/algorithm/partition.hpp>
+#include <array>
+#include <atomic>
 #include <cstdlib>
 #include <vector>
 
@@ -175,6 +178,16 @@ inline uint32_t EncodeMorton3( const SFVEC3F &v )
 }
 
 
+/**
+ * Runs aWork( ii ) for all ii in [0, aCount), spread on the thread pool.
+ */
+template <typename WORK>
+static void parallelFor( size_t aCount, WORK aWork )
+{
+    THREAD_POOL::GetInstance().ParallelFor( aCount, aWork );
+}
+
+
 static void RadixSort( std::vector<MortonPrimitive> *v )
 {
     std::vector<MortonPrimitive> tempVector( v->size() );
@@ -185,6 +198,15 @@ static void RadixSort( std::vector<MortonPrimitive> *v )
     wxASSERT( (nBits % bitsPerPass) == 0 );
 
     const int nPasses = nBits / bitsPerPass;
+    const int nBuckets = 1 << bitsPerPass;
+    const int bitMask = (1 << bitsPerPass) - 1;
+
+    // Each chunk of the vector is counted and scattered by its own thread.  The chunks are
+    // scattered in order, so the sort stays stable.
+    const size_t chunkSize = 1 << 16;
+    const size_t nChunks = std::max<size_t>( ( v->size() + chunkSize - 1 ) / chunkSize, 1 );
+
+    std::vector<std::array<int, nBuckets>> bucketStart( nChunks );
 
     for( int pass = 0; pass < nPasses; ++pass )
     {
@@ -196,34 +218,54 @@ static void RadixSort( std::vector<MortonPrimitive> *v )
         std::vector<MortonPrimitive> &out = (pass & 1) ? *v : tempVector;
 
         // Count number of zero bits in array for current radix sort bit
-        const int nBuckets = 1 << bitsPerPass;
-        int bucketCount[nBuckets] = {0};
-        const int bitMask = (1 << bitsPerPass) - 1;
+        parallelFor( nChunks,
+                [&]( size_t aChunk )
+                {
+                    std::array<int, nBuckets>& bucketCount = bucketStart[aChunk];
+                    const size_t               end = std::min( in.size(),
+                                                               ( aChunk + 1 ) * chunkSize );
 
-        for( uint32_t i = 0; i < in.size(); ++i )
-        {
-            const MortonPrimitive &mp = in[i];
-            int bucket = (mp.mortonCode >> lowBit) & bitMask;
+                    bucketCount.fill( 0 );
 
-            wxASSERT( (bucket >= 0) && (bucket < nBuckets) );
+                    for( size_t i = aChunk * chunkSize; i < end; ++i )
+                    {
+                        int bucket = (in[i].mortonCode >> lowBit) & bitMask;
 
-            ++bucketCount[bucket];
-        }
+                        wxASSERT( (bucket >= 0) && (bucket < nBuckets) );
 
-        // Compute starting index in output array for each bucket
-        int startIndex[nBuckets];
-        startIndex[0] = 0;
+                        ++bucketCount[bucket];
+                    }
+                } );
 
-        for( int i = 1; i < nBuckets; ++i )
-            startIndex[i] = startIndex[i - 1] + bucketCount[i - 1];
+        // Compute starting index in output array for each bucket of each chunk
+        int startIndex = 0;
 
-        // Store sorted values in output array
-        for( uint32_t i = 0; i < in.size(); ++i )
+        for( int bucket = 0; bucket < nBuckets; ++bucket )
         {
-            const MortonPrimitive &mp = in[i];
-            int bucket = (mp.mortonCode >> lowBit) & bitMask;
-            out[startIndex[bucket]++] = mp;
+            for( size_t chunk = 0; chunk < nChunks; ++chunk )
+            {
+                const int count = bucketStart[chunk][bucket];
+
+                bucketStart[chunk][bucket] = startIndex;
+                startIndex += count;
+            }
         }
+
+        // Store sorted values in output array
+        parallelFor( nChunks,
+                [&]( size_t aChunk )
+                {
+                    std::array<int, nBuckets>& startIdx = bucketStart[aChunk];
+                    const size_t               end = std::min( in.size(),
+                                                               ( aChunk + 1 ) * chunkSize );
+
+                    for( size_t i = aChunk * chunkSize; i < end; ++i )
+                    {
+                        const MortonPrimitive &mp = in[i];
+                        int bucket = (mp.mortonCode >> lowBit) & bitMask;
+                        out[startIdx[bucket]++] = mp;
+                    }
+                } );
     }
 
     // Copy final result from _tempVector_, if needed
@@ -271,17 +313,27 @@ CBVH_PBRT::CBVH_PBRT( const CGENERICCONTAINER &aObjectContainer,
     // Build BVH tree for primitives using _primitiveInfo_
     int totalNodes = 0;
 
-    CONST_VECTOR_OBJECT orderedPrims;
-    orderedPrims.clear();
-    orderedPrims.reserve( m_primitives.size() );
+    // The builds put the primitives of each leaf at its own place: they can run in parallel
+    CONST_VECTOR_OBJECT orderedPrims( m_primitives.size() );
 
     BVHBuildNode *root;
 
     if( m_splitMethod == SPLITMETHOD::HLBVH )
+    {
         root = HLBVHBuild( primitiveInfo, &totalNodes, orderedPrims);
+    }
     else
+    {
+        // Build the subtrees of the first levels in parallel, a few more than the cores to
+        // balance the work
+        int parallelLevels = 0;
+
+        while( ( 1u << parallelLevels ) < 2 * THREAD_POOL::GetInstance().GetThreadCount() )
+            parallelLevels++;
+
         root = recursiveBuild( primitiveInfo, 0, m_primitives.size(),
-                               &totalNodes, orderedPrims);
+                               &totalNodes, orderedPrims, parallelLevels );
+    }
 
     wxASSERT( m_primitives.size() == orderedPrims.size() );
 
@@ -456,7 +508,8 @@ BVHBuildNode *CBVH_PBRT::recursiveBuild ( std::vector<BVHPrimitiveInfo> &primiti
                                           int start,
                                           int end,
                                           int *totalNodes,
-                                          CONST_VECTOR_OBJECT &orderedPrims )
+                                          CONST_VECTOR_OBJECT &orderedPrims,
+                                          int parallelLevels )
 {
     wxASSERT( totalNodes != NULL );
     wxASSERT( start >= 0 );
@@ -470,7 +523,11 @@ BVHBuildNode *CBVH_PBRT::recursiveBuild ( std::vector<BVHPrimitiveInfo> &primiti
 
     // !TODO: implement an memory Arena
     BVHBuildNode *node = static_cast<BVHBuildNode *>( malloc( sizeof( BVHBuildNode ) ) );
-    m_addresses_pointer_to_mm_free.push_back( node );
+
+    {
+        std::lock_guard<std::mutex> lock( m_addressesLock );
+        m_addresses_pointer_to_mm_free.push_back( node );
+    }
 
     node->bounds.Reset();
     node->firstPrimOffset = 0;
@@ -491,13 +548,13 @@ BVHBuildNode *CBVH_PBRT::recursiveBuild ( std::vector<BVHPrimitiveInfo> &primiti
     if( nPrimitives == 1 )
     {
         // Create leaf _BVHBuildNode_
-        int firstPrimOffset = orderedPrims.size();
+        int firstPrimOffset = start;
 
         for( int i = start; i < end; ++i )
         {
             int primitiveNr = primitiveInfo[i].primitiveNumber;
             wxASSERT( primitiveNr < (int)m_primitives.size() );
-            orderedPrims.push_back( m_primitives[ primitiveNr ] );
+            orderedPrims[i] = m_primitives[ primitiveNr ];
         }
 
         node->InitLeaf( firstPrimOffset, nPrimitives, bounds );
@@ -520,7 +577,7 @@ BVHBuildNode *CBVH_PBRT::recursiveBuild ( std::vector<BVHPrimitiveInfo> &primiti
                   centroidBounds.Min()[dim] ) < (FLT_EPSILON + FLT_EPSILON) )
         {
             // Create leaf _BVHBuildNode_
-            const int firstPrimOffset = orderedPrims.size();
+            const int firstPrimOffset = start;
 
             for( int i = start; i < end; ++i )
             {
@@ -533,7 +590,7 @@ BVHBuildNode *CBVH_PBRT::recursiveBuild ( std::vector<BVHPrimitiveInfo> &primiti
 
                 wxASSERT( obj != NULL );
 
-                orderedPrims.push_back( obj );
+                orderedPrims[i] = obj;
             }
 
             node->InitLeaf( firstPrimOffset, nPrimitives, bounds );
@@ -689,7 +746,7 @@ BVHBuildNode *CBVH_PBRT::recursiveBuild ( std::vector<BVHPrimitiveInfo> &primiti
                     else
                     {
                         // Create leaf _BVHBuildNode_
-                        const int firstPrimOffset = orderedPrims.size();
+                        const int firstPrimOffset = start;
 
                         for( int i = start; i < end; ++i )
                         {
@@ -697,7 +754,7 @@ BVHBuildNode *CBVH_PBRT::recursiveBuild ( std::vector<BVHPrimitiveInfo> &primiti
 
                             wxASSERT( primitiveNr < (int)m_primitives.size() );
 
-                            orderedPrims.push_back( m_primitives[ primitiveNr ] );
+                            orderedPrims[i] = m_primitives[ primitiveNr ];
                         }
 
                         node->InitLeaf( firstPrimOffset, nPrimitives, bounds );
@@ -709,17 +766,36 @@ BVHBuildNode *CBVH_PBRT::recursiveBuild ( std::vector<BVHPrimitiveInfo> &primiti
             }
             }
 
-            node->InitInterior( dim,
-                                recursiveBuild( primitiveInfo,
-                                                start,
-                                                mid,
-                                                totalNodes,
-                                                orderedPrims ),
-                                recursiveBuild( primitiveInfo,
-                                                mid,
-                                                end,
-                                                totalNodes,
-                                                orderedPrims) );
+            BVHBuildNode *children[2];
+
+            if( ( parallelLevels > 0 ) && ( nPrimitives > 4096 ) )
+            {
+                // The two halves of the primitives are disjoint: build the first one in a
+                // task of the thread pool, with its own node count
+                int        firstNodes = 0;
+                TASK_GROUP first;
+
+                first.Run( [&]()
+                           {
+                               children[0] = recursiveBuild( primitiveInfo, start, mid,
+                                                             &firstNodes, orderedPrims,
+                                                             parallelLevels - 1 );
+                           } );
+
+                children[1] = recursiveBuild( primitiveInfo, mid, end, totalNodes,
+                                              orderedPrims, parallelLevels - 1 );
+                first.Wait();
+                *totalNodes += firstNodes;
+            }
+            else
+            {
+                children[0] = recursiveBuild( primitiveInfo, start, mid, totalNodes,
+                                              orderedPrims, 0 );
+                children[1] = recursiveBuild( primitiveInfo, mid, end, totalNodes,
+                                              orderedPrims, 0 );
+            }
+
+            node->InitInterior( dim, children[0], children[1] );
         }
     }
 
@@ -738,28 +814,38 @@ BVHBuildNode *CBVH_PBRT::HLBVHBuild( const std::vector<BVHPrimitiveInfo> &primit
     for( unsigned int i = 0; i < primitiveInfo.size(); ++i )
         bounds.Union( primitiveInfo[i].centroid );
 
-    // Compute Morton indices of primitives
+    // Compute Morton indices of primitives, by chunks on all the cores
     std::vector<MortonPrimitive> mortonPrims( primitiveInfo.size() );
 
-    for( int i = 0; i < (int)primitiveInfo.size(); ++i )
+    const size_t mortonChunkSize = 4096;
+
+    auto computeMortonCodes = [&]( size_t aChunk )
     {
-        // Initialize _mortonPrims[i]_ for _i_th primitive
-        const int mortonBits  = 10;
-        const int mortonScale = 1 << mortonBits;
+        const size_t chunkEnd = std::min( primitiveInfo.size(), ( aChunk + 1 ) * mortonChunkSize );
+
+        for( size_t i = aChunk * mortonChunkSize; i < chunkEnd; ++i )
+        {
+            // Initialize _mortonPrims[i]_ for _i_th primitive
+            const int mortonBits  = 10;
+            const int mortonScale = 1 << mortonBits;
 
-        wxASSERT( primitiveInfo[i].primitiveNumber < (int)primitiveInfo.size() );
+            wxASSERT( primitiveInfo[i].primitiveNumber < (int)primitiveInfo.size() );
 
-        mortonPrims[i].primitiveIndex = primitiveInfo[i].primitiveNumber;
+            mortonPrims[i].primitiveIndex = primitiveInfo[i].primitiveNumber;
 
-        const SFVEC3F centroidOffset = bounds.Offset( primitiveInfo[i].centroid );
+            const SFVEC3F centroidOffset = bounds.Offset( primitiveInfo[i].centroid );
 
-        wxASSERT( (centroidOffset.x >= 0.0f) && (centroidOffset.x <= 1.0f) );
-        wxASSERT( (centroidOffset.y >= 0.0f) && (centroidOffset.y <= 1.0f) );
-        wxASSERT( (centroidOffset.z >= 0.0f) && (centroidOffset.z <= 1.0f) );
+            wxASSERT( (centroidOffset.x >= 0.0f) && (centroidOffset.x <= 1.0f) );
+            wxASSERT( (centroidOffset.y >= 0.0f) && (centroidOffset.y <= 1.0f) );
+            wxASSERT( (centroidOffset.z >= 0.0f) && (centroidOffset.z <= 1.0f) );
 
-        mortonPrims[i].mortonCode = EncodeMorton3( centroidOffset *
-                                                   SFVEC3F( (float)mortonScale ) );
-    }
+            mortonPrims[i].mortonCode = EncodeMorton3( centroidOffset *
+                                                       SFVEC3F( (float)mortonScale ) );
+        }
+    };
+
+    parallelFor( ( primitiveInfo.size() + mortonChunkSize - 1 ) / mortonChunkSize,
+                 computeMortonCodes );
 
     // Radix sort primitive Morton indices
     RadixSort( &mortonPrims );
@@ -810,12 +896,11 @@ BVHBuildNode *CBVH_PBRT::HLBVHBuild( const std::vector<BVHPrimitiveInfo> &primit
     }
 
     // Create LBVHs for treelets in parallel
-    int atomicTotal = 0;
-    int orderedPrimsOffset = 0;
+    std::atomic<int> atomicTotal( 0 );
 
     orderedPrims.resize( m_primitives.size() );
 
-    for( int index = 0; index < (int)treeletsToBuild.size(); ++index )
+    auto buildTreelet = [&]( size_t index )
     {
         // Generate _index_th LBVH treelet
         int nodesCreated = 0;
@@ -823,9 +908,16 @@ BVHBuildNode *CBVH_PBRT::HLBVHBuild( const std::vector<BVHPrimitiveInfo> &primit
 
         LBVHTreelet &tr = treeletsToBuild[index];
 
+        // The treelets are in primitive order: the primitives of this one start at its
+        // first primitive
+        int orderedPrimsOffset = tr.startIndex;
+
         wxASSERT( tr.startIndex < (int)mortonPrims.size() );
 
-        tr.buildNodes = emitLBVH( tr.buildNodes,
+        // emitLBVH() moves the pointer past the nodes it used: keep the root
+        BVHBuildNode *nodes = tr.buildNodes;
+
+        tr.buildNodes = emitLBVH( nodes,
                                   primitiveInfo,
                                   &mortonPrims[tr.startIndex],
                                   tr.numPrimitives,
@@ -835,7 +927,9 @@ BVHBuildNode *CBVH_PBRT::HLBVHBuild( const std::vector<BVHPrimitiveInfo> &primit
                                   firstBit );
 
         atomicTotal += nodesCreated;
-    }
+    };
+
+    parallelFor( treeletsToBuild.size(), buildTreelet );
 
     *totalNodes = atomicTotal;
 
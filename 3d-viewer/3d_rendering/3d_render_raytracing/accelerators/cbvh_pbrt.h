@@ -73,6 +73,7 @@
 #include "caccelerator.h"
 #include <cstdint>
 #include <list>
+#include <mutex>
 
 // Forward Declarations
 struct BVHBuildNode;
@@ -127,7 +128,8 @@ private:
                                   int start,
                                   int end,
                                   int *totalNodes,
-                                  CONST_VECTOR_OBJECT &orderedPrims );
+                                  CONST_VECTOR_OBJECT &orderedPrims,
+                                  int parallelLevels );
 
     BVHBuildNode *HLBVHBuild( const std::vector<BVHPrimitiveInfo> &primitiveInfo,
                               int *totalNodes,
@@ -158,6 +160,7 @@ private:
     LinearBVHNode       *m_nodes;
 
     std::list<void *> m_addresses_pointer_to_mm_free;
+    std::mutex        m_addressesLock;  ///< the nodes are allocated by several build threads
 
     // Partition traversal
     unsigned int m_I[RAYPACKET_RAYS_PER_PACKET];
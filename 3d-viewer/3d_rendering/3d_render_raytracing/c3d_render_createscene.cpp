@@ -48,6 +48,8 @@
 #include <base_units.h>
 #include <profile.h>        // To use GetRunningMicroSecs or another profiling utility
 
+#include <set>
+
 /**
   * Scale convertion from 3d model units to pcb units
   */
@@ -1283,6 +1285,28 @@ void C3D_RENDER_RAYTRACING::add_3D_vias_and_pads_to_container()
 
 void C3D_RENDER_RAYTRACING::load_3D_models()
 {
+    // Load the models on all the cores first: only their insertion in the containers below
+    // must run on this thread
+    std::set<wxString>    modelFiles;
+    std::vector<wxString> filesToLoad;
+
+    for( auto module : m_boardAdapter.GetBoard()->Modules() )
+    {
+        if( !m_boardAdapter.ShouldModuleBeDisplayed( (MODULE_ATTR_T) module->GetAttributes() ) )
+            continue;
+
+        for( const MODULE_3D_SETTINGS& model : module->Models() )
+        {
+            if( ( static_cast<float>( model.m_Opacity ) > FLT_EPSILON ) && model.m_Show
+                    && !model.m_Filename.empty() && modelFiles.insert( model.m_Filename ).second )
+            {
+                filesToLoad.push_back( model.m_Filename );
+            }
+        }
+    }
+
+    m_boardAdapter.Get3DCacheManager()->LoadModels( filesToLoad );
+
     // Go for all modules
     for( auto module : m_boardAdapter.GetBoard()->Modules() )
     {
@@ -32,7 +32,6 @@
 #include <atomic>
 #include <chrono>
 #include <climits>
-#include <thread>
 
 #include "c3d_render_raytracing.h"
 #include "mortoncodes.h"
@@ -41,11 +40,19 @@
 #include "3d_math.h"
 #include "../common_ogl/ogl_utils.h"
 #include <profile.h>        // To use GetRunningMicroSecs or another profiling utility
+#include <thread_pool.h>
 
 // This should be used in future for the function
 // convertLinearToSRGB
 //#include <glm/gtc/color_space.hpp>
 
+/// Size (in pixels) of the square tiles the post processing shader is run by
+static const unsigned int SSAO_TILE_DIM = 32;
+
+/// From this frame size (in pixels) the post processing shader runs at half resolution
+static const unsigned int SSAO_HALF_RES_MIN_PIXELS = 2560 * 1440;
+
+
 C3D_RENDER_RAYTRACING::C3D_RENDER_RAYTRACING( BOARD_ADAPTER& aAdapter, CCAMERA& aCamera ) :
                        C3D_RENDER_BASE( aAdapter, aCamera ),
                        m_postshader_ssao( aCamera )
@@ -63,6 +70,7 @@ C3D_RENDER_RAYTRACING::C3D_RENDER_RAYTRACING( BOARD_ADAPTER& aAdapter, CCAMERA&
     m_outlineBoard2dObjects = NULL;
     m_firstHitinfo = NULL;
     m_shaderBuffer = NULL;
+    m_shaderHalfBuffer = NULL;
     m_camera_light = NULL;
 
     m_xoffset = 0;
@@ -72,6 +80,7 @@ C3D_RENDER_RAYTRACING::C3D_RENDER_RAYTRACING( BOARD_ADAPTER& aAdapter, CCAMERA&
     m_rt_render_state = RT_RENDER_STATE_MAX; // Set to an initial invalid state
     m_stats_start_rendering_time = 0;
     m_nrBlocksRenderProgress = 0;
+    m_antiAliasPending = false;
 }
 
 
@@ -88,6 +97,9 @@ C3D_RENDER_RAYTRACING::~C3D_RENDER_RAYTRACING()
     delete[] m_shaderBuffer;
     m_shaderBuffer = NULL;
 
+    delete[] m_shaderHalfBuffer;
+    m_shaderHalfBuffer = NULL;
+
     opengl_delete_pbo();
 }
 
@@ -130,6 +142,11 @@ void C3D_RENDER_RAYTRACING::restart_render_state()
     m_rt_render_state = RT_RENDER_STATE_TRACING;
     m_nrBlocksRenderProgress = 0;
 
+    // The progressive render traces the blocks without anti-aliasing first, then
+    // anti-aliases only the pixels found on edges
+    m_antiAliasPending = m_boardAdapter.GetFlag( FL_RENDER_RAYTRACING_PROGRESSIVE ) &&
+                         m_boardAdapter.GetFlag( FL_RENDER_RAYTRACING_ANTI_ALIASING );
+
     m_postshader_ssao.InitFrame();
 
     m_blockPositionsWasProcessed.resize( m_blockPositions.size() );
@@ -138,6 +155,22 @@ void C3D_RENDER_RAYTRACING::restart_render_state()
     std::fill( m_blockPositionsWasProcessed.begin(),
                m_blockPositionsWasProcessed.end(),
                0 );
+
+    m_blockAntiAliasMask.resize( m_blockPositions.size() );
+
+    std::fill( m_blockAntiAliasMask.begin(), m_blockAntiAliasMask.end(), 0 );
+}
+
+
+void C3D_RENDER_RAYTRACING::start_anti_aliasing()
+{
+    m_rt_render_state = RT_RENDER_STATE_ANTI_ALIASING;
+    m_nrBlocksRenderProgress = 0;
+    m_antiAliasPending = false;
+
+    std::fill( m_blockPositionsWasProcessed.begin(),
+               m_blockPositionsWasProcessed.end(),
+               0 );
 }
 
 
@@ -327,11 +360,23 @@ void C3D_RENDER_RAYTRACING::render( GLubyte *ptrPBO , REPORTER *aStatusTextRepor
 
         m_BgColorTop_LinearRGB = ConvertSRGBToLinear( (SFVEC3F)m_boardAdapter.m_BgColorTop );
         m_BgColorBot_LinearRGB = ConvertSRGBToLinear( (SFVEC3F)m_boardAdapter.m_BgColorBot );
+
+        if( m_boardAdapter.GetFlag( FL_RENDER_RAYTRACING_PROGRESSIVE ) )
+        {
+            // Show the coarse preview at once, the blocks will be traced over it
+            render_preview( ptrPBO );
+
+            if( aStatusTextReporter )
+                aStatusTextReporter->Report( _( "Rendering: preview" ) );
+
+            return;
+        }
     }
 
     switch( m_rt_render_state )
     {
     case RT_RENDER_STATE_TRACING:
+    case RT_RENDER_STATE_ANTI_ALIASING:
             rt_render_tracing( ptrPBO, aStatusTextReporter );
         break;
 
@@ -366,27 +411,27 @@ void C3D_RENDER_RAYTRACING::rt_render_tracing( GLubyte *ptrPBO ,
 {
     m_isPreview = false;
 
+    const bool antiAliasPass = m_rt_render_state == RT_RENDER_STATE_ANTI_ALIASING;
+
+    // Without the progressive render, the blocks are anti-aliased while traced
+    const bool antiAlias = m_boardAdapter.GetFlag( FL_RENDER_RAYTRACING_ANTI_ALIASING ) &&
+                           !m_boardAdapter.GetFlag( FL_RENDER_RAYTRACING_PROGRESSIVE );
+
     auto startTime = std::chrono::steady_clock::now();
-    bool breakLoop = false;
 
     std::atomic<size_t> numBlocksRendered( 0 );
-    std::atomic<size_t> currentBlock( 0 );
-    std::atomic<size_t> threadsFinished( 0 );
+    TASK_GROUP          renderGroup;
 
-    size_t parallelThreadCount = std::min<size_t>(
-            std::max<size_t>( std::thread::hardware_concurrency(), 2 ),
-            m_blockPositions.size() );
-    for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-    {
-        std::thread t = std::thread( [&]()
-        {
-            for( size_t iBlock = currentBlock.fetch_add( 1 );
-                        iBlock < m_blockPositions.size() && !breakLoop;
-                        iBlock = currentBlock.fetch_add( 1 ) )
+    renderGroup.ParallelFor( m_blockPositions.size(),
+            [&]( size_t iBlock )
             {
                 if( !m_blockPositionsWasProcessed[iBlock] )
                 {
-                    rt_render_trace_block( ptrPBO, iBlock );
+                    if( !antiAliasPass )
+                        rt_render_trace_block( ptrPBO, iBlock, antiAlias, ~(uint64_t) 0 );
+                    else if( m_blockAntiAliasMask[iBlock] )
+                        rt_render_trace_block( ptrPBO, iBlock, true, m_blockAntiAliasMask[iBlock] );
+
                     numBlocksRendered++;
                     m_blockPositionsWasProcessed[iBlock] = 1;
 
@@ -394,32 +439,29 @@ void C3D_RENDER_RAYTRACING::rt_render_tracing( GLubyte *ptrPBO ,
                     // to display the progress
                     if( std::chrono::duration_cast<std::chrono::milliseconds>(
                             std::chrono::steady_clock::now() - startTime ).count() > 150 )
-                        breakLoop = true;
+                        renderGroup.Cancel();
                 }
-            }
-
-            threadsFinished++;
-        } );
-
-        t.detach();
-    }
-
-    while( threadsFinished < parallelThreadCount )
-        std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+            } );
 
     m_nrBlocksRenderProgress += numBlocksRendered;
 
     if( aStatusTextReporter )
-        aStatusTextReporter->Report( wxString::Format( _( "Rendering: %.0f %%" ),
+        aStatusTextReporter->Report( wxString::Format( antiAliasPass ?
+                                                       _( "Rendering: anti-aliasing %.0f %%" ) :
+                                                       _( "Rendering: %.0f %%" ),
                                                        (float)(m_nrBlocksRenderProgress * 100) /
                                                        (float)m_blockPositions.size() ) );
 
-    // Check if it finish the rendering and if should continue to a post processing
-    // or mark it as finished
+    // Check if it finish the rendering and if should continue to a post processing,
+    // to the anti-aliasing of the progressive render or mark it as finished.
+    // The post processing runs on the image not anti-aliased yet too, so the shaded
+    // picture is shown while the edges are refined.
     if( m_nrBlocksRenderProgress >= m_blockPositions.size() )
     {
         if( m_boardAdapter.GetFlag( FL_RENDER_RAYTRACING_POST_PROCESSING ) )
             m_rt_render_state = RT_RENDER_STATE_POST_PROCESS_SHADE;
+        else if( m_antiAliasPending )
+            start_anti_aliasing();
         else
             m_rt_render_state = RT_RENDER_STATE_FINISH;
     }
@@ -502,13 +544,16 @@ void C3D_RENDER_RAYTRACING::rt_shades_packet(const SFVEC3F *bgColorY,
                                               const RAY     *aRayPkt,
                                               HITINFO_PACKET *aHitPacket,
                                               bool is_testShadow,
-                                              SFVEC3F *aOutHitColor )
+                                              SFVEC3F *aOutHitColor,
+                                              uint64_t aPixels )
 {
     for( unsigned int y = 0, i = 0; y < RAYPACKET_DIM; ++y )
     {
         for( unsigned int x = 0; x < RAYPACKET_DIM; ++x, ++i )
         {
-            if( aHitPacket[i].m_hitresult == true )
+            if( !( ( aPixels >> i ) & 1 ) )
+                aOutHitColor[i] = bgColorY[y];
+            else if( aHitPacket[i].m_hitresult == true )
             {
                 aOutHitColor[i] = shadeHit( bgColorY[y],
                                             aRayPkt[i],
@@ -530,7 +575,8 @@ void C3D_RENDER_RAYTRACING::rt_trace_AA_packet( const SFVEC3F *aBgColorY,
                                                 const HITINFO_PACKET *aHitPck_X0Y0,
                                                 const HITINFO_PACKET *aHitPck_AA_X1Y1,
                                                 const RAY *aRayPck,
-                                                SFVEC3F *aOutHitColor )
+                                                SFVEC3F *aOutHitColor,
+                                                uint64_t aPixels )
 {
     const bool is_testShadow =  m_boardAdapter.GetFlag( FL_RENDER_RAYTRACING_SHADOWS );
 
@@ -538,6 +584,9 @@ void C3D_RENDER_RAYTRACING::rt_trace_AA_packet( const SFVEC3F *aBgColorY,
     {
         for( unsigned int x = 0; x < RAYPACKET_DIM; ++x, ++i )
         {
+            if( !( ( aPixels >> i ) & 1 ) )
+                continue;
+
             const RAY &rayAA = aRayPck[i];
 
             HITINFO hitAA;
@@ -653,9 +702,62 @@ void C3D_RENDER_RAYTRACING::rt_trace_AA_packet( const SFVEC3F *aBgColorY,
 
 #define DISP_FACTOR 0.075f
 
+// Luminance difference of neighbour pixels above which the progressive render anti-aliases them
+#define AA_CONTRAST_THRESHOLD 0.04f
+
+/**
+ * @return the mask of the pixels of the packet lying on an edge: their neighbour hits
+ *         another object, or its color is too different.
+ */
+static uint64_t HITINFO_PACKET_edges( const HITINFO_PACKET *aHitPacket,
+                                      const SFVEC3F *aHitColor )
+{
+    const SFVEC3F lumWeights( 0.2126f, 0.7152f, 0.0722f );
+
+    auto differ = [&]( unsigned int a, unsigned int b ) -> bool
+    {
+        if( aHitPacket[a].m_hitresult != aHitPacket[b].m_hitresult )
+            return true;
+
+        if( aHitPacket[a].m_hitresult &&
+            ( aHitPacket[a].m_HitInfo.pHitObject != aHitPacket[b].m_HitInfo.pHitObject ) )
+            return true;
+
+        return glm::abs( glm::dot( aHitColor[a] - aHitColor[b], lumWeights ) ) >
+               AA_CONTRAST_THRESHOLD;
+    };
+
+    uint64_t edges = 0;
+
+    for( unsigned int y = 0, i = 0; y < RAYPACKET_DIM; ++y )
+    {
+        for( unsigned int x = 0; x < RAYPACKET_DIM; ++x, ++i )
+        {
+            // Compare with the right and the bottom neighbours
+            if( ( x < (RAYPACKET_DIM - 1) ) && differ( i, i + 1 ) )
+                edges |= ( (uint64_t) 3 ) << i;
+
+            if( ( y < (RAYPACKET_DIM - 1) ) && differ( i, i + RAYPACKET_DIM ) )
+                edges |= ( (uint64_t) 1 << i ) | ( (uint64_t) 1 << ( i + RAYPACKET_DIM ) );
+        }
+    }
+
+    return edges;
+}
+
+
 void C3D_RENDER_RAYTRACING::rt_render_trace_block( GLubyte *ptrPBO ,
-                                                   signed int iBlock )
+                                                   signed int iBlock,
+                                                   bool aAntiAlias,
+                                                   uint64_t aPixels )
 {
+    const bool postProcessing = m_boardAdapter.GetFlag( FL_RENDER_RAYTRACING_POST_PROCESSING );
+
+    // The anti-aliasing pass of the progressive render keeps the shaded picture on the
+    // screen, the post processing will show its result
+    const bool writePBO = !( postProcessing &&
+                             ( m_rt_render_state == RT_RENDER_STATE_ANTI_ALIASING ) );
+
     // Initialize ray packets
     // /////////////////////////////////////////////////////////////////////////
     const SFVEC2UI &blockPos = m_blockPositions[iBlock];
@@ -688,7 +790,7 @@ void C3D_RENDER_RAYTRACING::rt_render_trace_block( GLubyte *ptrPBO ,
     {
 
         // If block is empty then set shades and continue
-        if( m_boardAdapter.GetFlag( FL_RENDER_RAYTRACING_POST_PROCESSING ) )
+        if( postProcessing )
         {
             for( unsigned int y = 0; y < RAYPACKET_DIM; ++y )
             {
@@ -698,6 +800,7 @@ void C3D_RENDER_RAYTRACING::rt_render_trace_block( GLubyte *ptrPBO ,
 
                 for( unsigned int x = 0; x < RAYPACKET_DIM; ++x )
                 {
+                    if( ( aPixels >> ( x + y * RAYPACKET_DIM ) ) & 1 )
                         m_postshader_ssao.SetPixelData( blockPos.x + x,
                                                         yBlockPos,
                                                         SFVEC3F( 0.0f ),
@@ -714,9 +817,9 @@ void C3D_RENDER_RAYTRACING::rt_render_trace_block( GLubyte *ptrPBO ,
         // (as the final color will be computed on post processing)
         // but it is used for report progress
 
-        const bool isFinalColor = !m_boardAdapter.GetFlag( FL_RENDER_RAYTRACING_POST_PROCESSING );
+        const bool isFinalColor = !postProcessing;
 
-        for( unsigned int y = 0; y < RAYPACKET_DIM; ++y )
+        for( unsigned int y = 0; y < RAYPACKET_DIM && writePBO; ++y )
         {
             const SFVEC3F &outColor = bgColor[y];
 
@@ -724,6 +827,9 @@ void C3D_RENDER_RAYTRACING::rt_render_trace_block( GLubyte *ptrPBO ,
 
             for( unsigned int x = 0; x < RAYPACKET_DIM; ++x )
             {
+                if( !( ( aPixels >> ( x + y * RAYPACKET_DIM ) ) & 1 ) )
+                    continue;
+
                 GLubyte *ptr = &ptrPBO[ (yConst + x) * 4 ];
 
                 rt_final_color( ptr, outColor, isFinalColor );
@@ -744,9 +850,14 @@ void C3D_RENDER_RAYTRACING::rt_render_trace_block( GLubyte *ptrPBO ,
                       blockPacket.m_ray,
                       hitPacket_X0Y0,
                       m_boardAdapter.GetFlag( FL_RENDER_RAYTRACING_SHADOWS ),
-                      hitColor_X0Y0 );
+                      hitColor_X0Y0,
+                      aPixels );
+
+    // Find the pixels the progressive render will anti-alias
+    if( !aAntiAlias && m_antiAliasPending )
+        m_blockAntiAliasMask[iBlock] = HITINFO_PACKET_edges( hitPacket_X0Y0, hitColor_X0Y0 );
 
-    if( m_boardAdapter.GetFlag( FL_RENDER_RAYTRACING_ANTI_ALIASING ) )
+    if( aAntiAlias )
     {
         SFVEC3F hitColor_AA_X1Y1[RAYPACKET_RAYS_PER_PACKET];
 
@@ -778,8 +889,8 @@ void C3D_RENDER_RAYTRACING::rt_render_trace_block( GLubyte *ptrPBO ,
                               blockPacket_AA_X1Y1.m_ray,
                               hitPacket_AA_X1Y1,
                               m_boardAdapter.GetFlag( FL_RENDER_RAYTRACING_SHADOWS ),
-                              hitColor_AA_X1Y1
-                              );
+                              hitColor_AA_X1Y1,
+                              aPixels );
         }
 
         SFVEC3F hitColor_AA_X1Y0[RAYPACKET_RAYS_PER_PACKET];
@@ -818,17 +929,20 @@ void C3D_RENDER_RAYTRACING::rt_render_trace_block( GLubyte *ptrPBO ,
         rt_trace_AA_packet( bgColor,
                             hitPacket_X0Y0, hitPacket_AA_X1Y1,
                             blockRayPck_AA_X1Y0,
-                            hitColor_AA_X1Y0 );
+                            hitColor_AA_X1Y0,
+                            aPixels );
 
         rt_trace_AA_packet( bgColor,
                             hitPacket_X0Y0, hitPacket_AA_X1Y1,
                             blockRayPck_AA_X0Y1,
-                            hitColor_AA_X0Y1 );
+                            hitColor_AA_X0Y1,
+                            aPixels );
 
         rt_trace_AA_packet( bgColor,
                             hitPacket_X0Y0, hitPacket_AA_X1Y1,
                             blockRayPck_AA_X1Y1_half,
-                            hitColor_AA_X0Y1_half );
+                            hitColor_AA_X0Y1_half,
+                            aPixels );
 
         // Average the result
         for( unsigned int i = 0; i < RAYPACKET_RAYS_PER_PACKET; ++i )
@@ -851,7 +965,7 @@ void C3D_RENDER_RAYTRACING::rt_render_trace_block( GLubyte *ptrPBO ,
 
     const uint32_t ptrInc = (m_realBufferSize.x - RAYPACKET_DIM) * 4;
 
-    if( m_boardAdapter.GetFlag( FL_RENDER_RAYTRACING_POST_PROCESSING ) )
+    if( postProcessing )
     {
         SFVEC2I bPos;
         bPos.y = blockPos.y;
@@ -864,23 +978,28 @@ void C3D_RENDER_RAYTRACING::rt_render_trace_block( GLubyte *ptrPBO ,
             {
                 const SFVEC3F &hColor = hitColor_X0Y0[i];
 
-                if( hitPacket_X0Y0[i].m_hitresult == true )
-                    m_postshader_ssao.SetPixelData( bPos.x, bPos.y,
-                                                    hitPacket_X0Y0[i].m_HitInfo.m_HitNormal,
-                                                    hColor,
-                                                    blockPacket.m_ray[i].at(
-                                                        hitPacket_X0Y0[i].m_HitInfo.m_tHit ),
-                                                    hitPacket_X0Y0[i].m_HitInfo.m_tHit,
-                                                    hitPacket_X0Y0[i].m_HitInfo.m_ShadowFactor );
-                else
-                    m_postshader_ssao.SetPixelData( bPos.x, bPos.y,
-                                                    SFVEC3F( 0.0f ),
-                                                    hColor,
-                                                    SFVEC3F( 0.0f ),
-                                                    0,
-                                                    1.0f );
+                // Keep the pixels not traced again
+                if( ( aPixels >> i ) & 1 )
+                {
+                    if( hitPacket_X0Y0[i].m_hitresult == true )
+                        m_postshader_ssao.SetPixelData( bPos.x, bPos.y,
+                                                        hitPacket_X0Y0[i].m_HitInfo.m_HitNormal,
+                                                        hColor,
+                                                        blockPacket.m_ray[i].at(
+                                                            hitPacket_X0Y0[i].m_HitInfo.m_tHit ),
+                                                        hitPacket_X0Y0[i].m_HitInfo.m_tHit,
+                                                        hitPacket_X0Y0[i].m_HitInfo.m_ShadowFactor );
+                    else
+                        m_postshader_ssao.SetPixelData( bPos.x, bPos.y,
+                                                        SFVEC3F( 0.0f ),
+                                                        hColor,
+                                                        SFVEC3F( 0.0f ),
+                                                        0,
+                                                        1.0f );
 
-                rt_final_color( ptr, hColor, false );
+                    if( writePBO )
+                        rt_final_color( ptr, hColor, false );
+                }
 
                 bPos.x++;
                 ptr += 4;
@@ -896,7 +1015,9 @@ void C3D_RENDER_RAYTRACING::rt_render_trace_block( GLubyte *ptrPBO ,
         {
             for( unsigned int x = 0; x < RAYPACKET_DIM; ++x, ++i )
             {
-                rt_final_color( ptr, hitColor_X0Y0[i], true );
+                if( ( aPixels >> i ) & 1 )
+                    rt_final_color( ptr, hitColor_X0Y0[i], true );
+
                 ptr += 4;
             }
 
@@ -916,36 +1037,53 @@ void C3D_RENDER_RAYTRACING::rt_render_post_process_shade( GLubyte *ptrPBO,
         if( aStatusTextReporter )
             aStatusTextReporter->Report( _("Rendering: Post processing shader") );
 
-        std::atomic<size_t> nextBlock( 0 );
-        std::atomic<size_t> threadsFinished( 0 );
+        // The samples of a pixel are spread around it, so the shader runs by
+        // tiles that keep the buffers it reads in cache
+        const SFVEC2UI shadeSize = m_shaderHalfBuffer ? m_shaderHalfSize : m_realBufferSize;
+        SFVEC3F*       shadeBuffer = m_shaderHalfBuffer ? m_shaderHalfBuffer : m_shaderBuffer;
+        const int      shadeStep = m_shaderHalfBuffer ? 2 : 1;
 
-        size_t parallelThreadCount = std::max<size_t>( std::thread::hardware_concurrency(), 2 );
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-        {
-            std::thread t = std::thread( [&]()
-            {
-                for( size_t y = nextBlock.fetch_add( 1 );
-                            y < m_realBufferSize.y;
-                            y = nextBlock.fetch_add( 1 ) )
+        const unsigned int tilesX = ( shadeSize.x + SSAO_TILE_DIM - 1 ) / SSAO_TILE_DIM;
+        const unsigned int tilesY = ( shadeSize.y + SSAO_TILE_DIM - 1 ) / SSAO_TILE_DIM;
+
+        THREAD_POOL::GetInstance().ParallelFor( tilesX * tilesY,
+                [&]( size_t aTile )
                 {
-                    SFVEC3F *ptr = &m_shaderBuffer[ y * m_realBufferSize.x ];
+                    const unsigned int x0 = ( aTile % tilesX ) * SSAO_TILE_DIM;
+                    const unsigned int y0 = ( aTile / tilesX ) * SSAO_TILE_DIM;
+                    const unsigned int x1 = glm::min( x0 + SSAO_TILE_DIM, shadeSize.x );
+                    const unsigned int y1 = glm::min( y0 + SSAO_TILE_DIM, shadeSize.y );
 
-                    for( signed int x = 0; x < (int)m_realBufferSize.x; ++x )
+                    for( unsigned int y = y0; y < y1; ++y )
                     {
-                        *ptr = m_postshader_ssao.Shade( SFVEC2I( x, y ) );
-                        ptr++;
+                        SFVEC3F *ptr = &shadeBuffer[ y * shadeSize.x + x0 ];
+
+                        for( unsigned int x = x0; x < x1; ++x )
+                        {
+                            *ptr = m_postshader_ssao.Shade( SFVEC2I( x * shadeStep,
+                                                                     y * shadeStep ) );
+                            ptr++;
+                        }
                     }
-                }
+                } );
 
-                threadsFinished++;
-            } );
+        if( m_shaderHalfBuffer )
+        {
+            THREAD_POOL::GetInstance().ParallelFor( m_realBufferSize.y,
+                    [&]( size_t y )
+                    {
+                        SFVEC3F *ptr = &m_shaderBuffer[ y * m_realBufferSize.x ];
 
-            t.detach();
+                        for( signed int x = 0; x < (int)m_realBufferSize.x; ++x )
+                        {
+                            *ptr = m_postshader_ssao.UpsampleBilateral( m_shaderHalfBuffer,
+                                                                        shadeSize,
+                                                                        SFVEC2I( x, y ) );
+                            ptr++;
+                        }
+                    } );
         }
 
-        while( threadsFinished < parallelThreadCount )
-            std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
-
         // Set next state
         m_rt_render_state = RT_RENDER_STATE_POST_PROCESS_BLUR_AND_FINISH;
     }
@@ -965,17 +1103,8 @@ void C3D_RENDER_RAYTRACING::rt_render_post_process_blur_finish( GLubyte *ptrPBO,
     if( m_boardAdapter.GetFlag( FL_RENDER_RAYTRACING_POST_PROCESSING ) )
     {
         // Now blurs the shader result and compute the final color
-        std::atomic<size_t> nextBlock( 0 );
-        std::atomic<size_t> threadsFinished( 0 );
-
-        size_t parallelThreadCount = std::max<size_t>( std::thread::hardware_concurrency(), 2 );
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-        {
-            std::thread t = std::thread( [&]()
-            {
-                for( size_t y = nextBlock.fetch_add( 1 );
-                            y < m_realBufferSize.y;
-                            y = nextBlock.fetch_add( 1 ) )
+        THREAD_POOL::GetInstance().ParallelFor( m_realBufferSize.y,
+                [&]( size_t y )
                 {
                     GLubyte *ptr = &ptrPBO[ y * m_realBufferSize.x * 4 ];
 
@@ -1055,24 +1184,18 @@ void C3D_RENDER_RAYTRACING::rt_render_post_process_blur_finish( GLubyte *ptrPBO,
 
                         ptr += 4;
                     }
-                }
-
-                threadsFinished++;
-            } );
-
-            t.detach();
-        }
-
-        while( threadsFinished < parallelThreadCount )
-            std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+                } );
 
 
         // Debug code
         //m_postshader_ssao.DebugBuffersOutputAsImages();
     }
 
-    // End rendering
-    m_rt_render_state = RT_RENDER_STATE_FINISH;
+    // End rendering, unless the progressive render has the edges to anti-alias
+    if( m_antiAliasPending )
+        start_anti_aliasing();
+    else
+        m_rt_render_state = RT_RENDER_STATE_FINISH;
 }
 
 
@@ -1080,19 +1203,8 @@ void C3D_RENDER_RAYTRACING::render_preview( GLubyte *ptrPBO )
 {
     m_isPreview = true;
 
-    std::atomic<size_t> nextBlock( 0 );
-    std::atomic<size_t> threadsFinished( 0 );
-
-    size_t parallelThreadCount = std::min<size_t>(
-            std::max<size_t>( std::thread::hardware_concurrency(), 2 ),
-            m_blockPositions.size() );
-    for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-    {
-        std::thread t = std::thread( [&]()
-        {
-            for( size_t iBlock = nextBlock.fetch_add( 1 );
-                        iBlock < m_blockPositionsFast.size();
-                        iBlock = nextBlock.fetch_add( 1 ) )
+    THREAD_POOL::GetInstance().ParallelFor( m_blockPositionsFast.size(),
+            [&]( size_t iBlock )
             {
                 const SFVEC2UI &windowPosUI = m_blockPositionsFast[ iBlock ];
                 const SFVEC2I windowsPos = SFVEC2I( windowPosUI.x + m_xoffset,
@@ -1693,16 +1805,7 @@ void C3D_RENDER_RAYTRACING::render_preview( GLubyte *ptrPBO )
                         SetPixel( ptr + 12, BlendColor( cRBC, BlendColor( cRB , cC ) ) );
                     }
                 }
-            }
-
-            threadsFinished++;
-        } );
-
-        t.detach();
-    }
-
-    while( threadsFinished < parallelThreadCount )
-        std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+            } );
 }
 
 
@@ -2148,5 +2251,14 @@ void C3D_RENDER_RAYTRACING::initialize_block_positions()
     delete[] m_shaderBuffer;
     m_shaderBuffer = new SFVEC3F[m_realBufferSize.x * m_realBufferSize.y];
 
+    // On large frames the ambient occlusion is shaded at half resolution
+    delete[] m_shaderHalfBuffer;
+    m_shaderHalfBuffer = NULL;
+
+    m_shaderHalfSize = SFVEC2UI( ( m_realBufferSize.x + 1 ) / 2, ( m_realBufferSize.y + 1 ) / 2 );
+
+    if( m_realBufferSize.x * m_realBufferSize.y >= SSAO_HALF_RES_MIN_PIXELS )
+        m_shaderHalfBuffer = new SFVEC3F[m_shaderHalfSize.x * m_shaderHalfSize.y];
+
     opengl_init_pbo();
 }
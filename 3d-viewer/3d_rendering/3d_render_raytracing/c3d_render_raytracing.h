@@ -39,6 +39,7 @@
 #include "cmaterial.h"
 #include <plugins/3dapi/c3dmodel.h>
 
+#include <cstdint>
 #include <map>
 
 /// Vector of materials
@@ -50,6 +51,7 @@ typedef std::map< const S3DMODEL * , MODEL_MATERIALS > MAP_MODEL_MATERIALS;
 typedef enum
 {
     RT_RENDER_STATE_TRACING = 0,
+    RT_RENDER_STATE_ANTI_ALIASING,
     RT_RENDER_STATE_POST_PROCESS_SHADE,
     RT_RENDER_STATE_POST_PROCESS_BLUR_AND_FINISH,
     RT_RENDER_STATE_FINISH,
@@ -78,23 +80,27 @@ private:
     void reload( REPORTER* aStatusTextReporter, REPORTER* aWarningTextReporter );
 
     void restart_render_state();
+    void start_anti_aliasing();
     void rt_render_tracing( GLubyte *ptrPBO , REPORTER *aStatusTextReporter );
     void rt_render_post_process_shade( GLubyte *ptrPBO , REPORTER *aStatusTextReporter );
     void rt_render_post_process_blur_finish( GLubyte *ptrPBO , REPORTER *aStatusTextReporter );
-    void rt_render_trace_block( GLubyte *ptrPBO , signed int iBlock );
+    void rt_render_trace_block( GLubyte *ptrPBO , signed int iBlock,
+                                bool aAntiAlias, uint64_t aPixels );
     void rt_final_color( GLubyte *ptrPBO, const SFVEC3F &rgbColor, bool applyColorSpaceConversion );
 
     void rt_shades_packet( const SFVEC3F *bgColorY,
                            const RAY *aRayPkt,
                            HITINFO_PACKET *aHitPacket,
                            bool is_testShadow,
-                           SFVEC3F *aOutHitColor );
+                           SFVEC3F *aOutHitColor,
+                           uint64_t aPixels );
 
     void rt_trace_AA_packet( const SFVEC3F *aBgColorY,
                              const HITINFO_PACKET *aHitPck_X0Y0,
                              const HITINFO_PACKET *aHitPck_AA_X1Y1,
                              const RAY *aRayPck,
-                             SFVEC3F *aOutHitColor );
+                             SFVEC3F *aOutHitColor,
+                             uint64_t aPixels );
 
     // Materials
     void setupMaterials();
@@ -134,6 +140,9 @@ private:
     /// Save the number of blocks progress of the render
     size_t m_nrBlocksRenderProgress;
 
+    /// The anti-aliasing of the progressive render is still to be done
+    bool m_antiAliasPending;
+
     CPOSTSHADER_SSAO m_postshader_ssao;
 
     CLIGHTCONTAINER m_lights;
@@ -168,6 +177,9 @@ private:
     /// this flags if a position was already processed (cleared each new render)
     std::vector< int > m_blockPositionsWasProcessed;
 
+    /// the pixels of each block to anti-alias, on the progressive render
+    std::vector< uint64_t > m_blockAntiAliasMask;
+
     /// this encodes the Morton code positions (on fast preview mode)
     std::vector< SFVEC2UI > m_blockPositionsFast;
 
@@ -178,6 +190,10 @@ private:
 
     SFVEC3F *m_shaderBuffer;
 
+    /// The post processing shader result at half resolution, NULL for small frames
+    SFVEC3F *m_shaderHalfBuffer;
+    SFVEC2UI m_shaderHalfSize;
+
     // Display Offset
     unsigned int m_xoffset;
     unsigned int m_yoffset;
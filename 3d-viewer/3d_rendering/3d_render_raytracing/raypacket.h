@@ -40,10 +40,23 @@
 #define RAYPACKET_RAYS_PER_PACKET (RAYPACKET_DIM * RAYPACKET_DIM)
 
 
+/**
+ * The rays of a packet as a structure of arrays, indexed by axis then ray, for the SIMD
+ * kernels of raypacket_simd.h
+ */
+struct RAYPACKET_SOA
+{
+    float m_Origin[3][RAYPACKET_RAYS_PER_PACKET];
+    float m_Dir[3][RAYPACKET_RAYS_PER_PACKET];
+    float m_InvDir[3][RAYPACKET_RAYS_PER_PACKET];
+};
+
+
 struct RAYPACKET
 {
-    CFRUSTUM    m_Frustum;
-    RAY         m_ray[RAYPACKET_RAYS_PER_PACKET];
+    CFRUSTUM      m_Frustum;
+    RAY           m_ray[RAYPACKET_RAYS_PER_PACKET];
+    RAYPACKET_SOA m_soa;    ///< a copy of m_ray
 
     RAYPACKET( const CCAMERA &aCamera,
                const SFVEC2I &aWindowsPosition );
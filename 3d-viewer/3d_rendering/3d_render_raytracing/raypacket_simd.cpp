@@ -0,0 +1,422 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file  raypacket_simd.cpp
+ * @brief SIMD kernels testing all the rays of a packet against a box or a triangle.
+ */
+
+#include "raypacket_simd.h"
+#include "shapes3D/cbbox.h"
+#include <geometry/simd_kernels.h>
+
+// Same as the kernels of kimath: SSE2 is part of x86-64, and the AVX2 kernels are built with
+// a target attribute so that the rest of the 3D viewer does not require an AVX2 CPU.  The
+// instruction set is the one selected by GetSimdLevel().
+#if defined( __x86_64__ ) || defined( _M_X64 )
+#define RAYPACKET_SSE2
+#include <emmintrin.h>
+
+#if defined( __GNUC__ ) || defined( __clang__ )
+#define RAYPACKET_AVX2
+#define RAYPACKET_TARGET_AVX2 __attribute__( ( target( "avx2" ) ) )
+#include <immintrin.h>
+#elif defined( _MSC_VER )
+#define RAYPACKET_AVX2
+#define RAYPACKET_TARGET_AVX2
+#include <immintrin.h>
+#endif
+#endif
+
+
+// The slack of the filters.  The scalar tests compute the same values, but the compiler
+// may round them differently.
+#define RAYPACKET_BBOX_MARGIN   1.0e-5f
+#define RAYPACKET_TRI_EPSILON   1.0e-5f
+
+
+/// The box grown by the margin: the slab test below accepts all the rays of the slope test
+static void marginBBox( const CBBOX &aBBox, SFVEC3F &aMin, SFVEC3F &aMax )
+{
+    const SFVEC3F margin = ( glm::abs( aBBox.Min() ) + glm::abs( aBBox.Max() ) ) *
+                           RAYPACKET_BBOX_MARGIN + SFVEC3F( RAYPACKET_BBOX_MARGIN );
+
+    aMin = aBBox.Min() - margin;
+    aMax = aBBox.Max() + margin;
+}
+
+
+static uint64_t intersectBBoxScalar( const RAYPACKET_SOA &aPacket, const SFVEC3F &aMin,
+                                     const SFVEC3F &aMax, const float *aTHit,
+                                     unsigned int aFirst )
+{
+    uint64_t mask = 0;
+
+    for( unsigned int i = aFirst; i < RAYPACKET_RAYS_PER_PACKET; ++i )
+    {
+        float tNear = 0.0f;
+        float tFar = 0.0f;
+
+        for( unsigned int axis = 0; axis < 3; ++axis )
+        {
+            const float o = aPacket.m_Origin[axis][i];
+            const float inv = aPacket.m_InvDir[axis][i];
+            const float t1 = ( aMin[axis] - o ) * inv;
+            const float t2 = ( aMax[axis] - o ) * inv;
+
+            tNear = ( axis == 0 ) ? glm::min( t1, t2 ) : glm::max( tNear, glm::min( t1, t2 ) );
+            tFar = ( axis == 0 ) ? glm::max( t1, t2 ) : glm::min( tFar, glm::max( t1, t2 ) );
+        }
+
+        if( ( tNear <= tFar ) && ( tFar >= 0.0f ) && ( tNear < aTHit[i] ) )
+            mask |= (uint64_t) 1 << i;
+    }
+
+    return mask;
+}
+
+
+static uint64_t intersectTriangleScalar( const RAYPACKET_SOA &aPacket,
+                                         const RAYPACKET_TRIANGLE &aTri, const float *aTHit,
+                                         unsigned int aFirst, unsigned int aEnd )
+{
+    uint64_t mask = 0;
+
+    for( unsigned int i = aFirst; i < aEnd; ++i )
+    {
+        const float dk = aPacket.m_Dir[aTri.k][i];
+        const float du = aPacket.m_Dir[aTri.ku][i];
+        const float dv = aPacket.m_Dir[aTri.kv][i];
+        const float ou = aPacket.m_Origin[aTri.ku][i];
+        const float ov = aPacket.m_Origin[aTri.kv][i];
+
+        const float lnd = 1.0f / ( dk + aTri.nu * du + aTri.nv * dv );
+        const float t = ( aTri.nd - aPacket.m_Origin[aTri.k][i] - aTri.nu * ou - aTri.nv * ov )
+                        * lnd;
+
+        if( !( ( t * ( 1.0f - RAYPACKET_TRI_EPSILON ) < aTHit[i] )
+               && ( t > -RAYPACKET_TRI_EPSILON ) ) )
+            continue;
+
+        const float hu = ou + t * du - aTri.a[aTri.ku];
+        const float hv = ov + t * dv - aTri.a[aTri.kv];
+        const float beta = hv * aTri.bnu + hu * aTri.bnv;
+        const float gamma = hu * aTri.cnu + hv * aTri.cnv;
+        const float dot = aPacket.m_Dir[0][i] * aTri.n.x + aPacket.m_Dir[1][i] * aTri.n.y +
+                          aPacket.m_Dir[2][i] * aTri.n.z;
+
+        // Written as rejections, as in CTRIANGLE::Intersect, for the NaNs
+        if( ( beta < -RAYPACKET_TRI_EPSILON ) || ( gamma < -RAYPACKET_TRI_EPSILON )
+            || ( beta + gamma > 1.0f + RAYPACKET_TRI_EPSILON )
+            || ( dot > RAYPACKET_TRI_EPSILON ) )
+            continue;
+
+        mask |= (uint64_t) 1 << i;
+    }
+
+    return mask;
+}
+
+
+#ifdef RAYPACKET_SSE2
+
+static inline uint64_t intersectBBox4SSE2( const RAYPACKET_SOA &aPacket, unsigned int i,
+                                           const __m128 *aMin, const __m128 *aMax,
+                                           const float *aTHit )
+{
+    __m128 tNear = _mm_setzero_ps();
+    __m128 tFar = _mm_setzero_ps();
+
+    for( unsigned int axis = 0; axis < 3; ++axis )
+    {
+        const __m128 o = _mm_loadu_ps( &aPacket.m_Origin[axis][i] );
+        const __m128 inv = _mm_loadu_ps( &aPacket.m_InvDir[axis][i] );
+        const __m128 t1 = _mm_mul_ps( _mm_sub_ps( aMin[axis], o ), inv );
+        const __m128 t2 = _mm_mul_ps( _mm_sub_ps( aMax[axis], o ), inv );
+
+        tNear = ( axis == 0 ) ? _mm_min_ps( t1, t2 ) : _mm_max_ps( tNear, _mm_min_ps( t1, t2 ) );
+        tFar = ( axis == 0 ) ? _mm_max_ps( t1, t2 ) : _mm_min_ps( tFar, _mm_max_ps( t1, t2 ) );
+    }
+
+    const __m128 hit = _mm_and_ps( _mm_and_ps( _mm_cmple_ps( tNear, tFar ),
+                                               _mm_cmpge_ps( tFar, _mm_setzero_ps() ) ),
+                                   _mm_cmplt_ps( tNear, _mm_loadu_ps( aTHit + i ) ) );
+
+    return (uint64_t) _mm_movemask_ps( hit ) << i;
+}
+
+
+static uint64_t intersectBBoxSSE2( const RAYPACKET_SOA &aPacket, const SFVEC3F &aMin,
+                                   const SFVEC3F &aMax, const float *aTHit,
+                                   unsigned int aFirst )
+{
+    const __m128 bmin[3] = { _mm_set1_ps( aMin.x ), _mm_set1_ps( aMin.y ),
+                             _mm_set1_ps( aMin.z ) };
+    const __m128 bmax[3] = { _mm_set1_ps( aMax.x ), _mm_set1_ps( aMax.y ),
+                             _mm_set1_ps( aMax.z ) };
+    uint64_t mask = 0;
+
+    for( unsigned int i = aFirst & ~3u; i < RAYPACKET_RAYS_PER_PACKET; i += 4 )
+        mask |= intersectBBox4SSE2( aPacket, i, bmin, bmax, aTHit );
+
+    return mask & RAYPACKET_RangeMask( aFirst, RAYPACKET_RAYS_PER_PACKET );
+}
+
+
+static uint64_t intersectTriangleSSE2( const RAYPACKET_SOA &aPacket,
+                                       const RAYPACKET_TRIANGLE &aTri, const float *aTHit,
+                                       unsigned int aFirst, unsigned int aEnd )
+{
+    const __m128 nu = _mm_set1_ps( aTri.nu );
+    const __m128 nv = _mm_set1_ps( aTri.nv );
+    const __m128 nd = _mm_set1_ps( aTri.nd );
+    const __m128 au = _mm_set1_ps( aTri.a[aTri.ku] );
+    const __m128 av = _mm_set1_ps( aTri.a[aTri.kv] );
+    const __m128 epsilon = _mm_set1_ps( RAYPACKET_TRI_EPSILON );
+    const __m128 minusEpsilon = _mm_set1_ps( -RAYPACKET_TRI_EPSILON );
+    const __m128 tScale = _mm_set1_ps( 1.0f - RAYPACKET_TRI_EPSILON );
+    const __m128 maxUV = _mm_set1_ps( 1.0f + RAYPACKET_TRI_EPSILON );
+    uint64_t     mask = 0;
+
+    for( unsigned int i = aFirst & ~3u; i < aEnd; i += 4 )
+    {
+        const __m128 dk = _mm_loadu_ps( &aPacket.m_Dir[aTri.k][i] );
+        const __m128 du = _mm_loadu_ps( &aPacket.m_Dir[aTri.ku][i] );
+        const __m128 dv = _mm_loadu_ps( &aPacket.m_Dir[aTri.kv][i] );
+        const __m128 ok = _mm_loadu_ps( &aPacket.m_Origin[aTri.k][i] );
+        const __m128 ou = _mm_loadu_ps( &aPacket.m_Origin[aTri.ku][i] );
+        const __m128 ov = _mm_loadu_ps( &aPacket.m_Origin[aTri.kv][i] );
+
+        const __m128 lnd = _mm_div_ps( _mm_set1_ps( 1.0f ),
+                _mm_add_ps( _mm_add_ps( dk, _mm_mul_ps( nu, du ) ), _mm_mul_ps( nv, dv ) ) );
+        const __m128 t = _mm_mul_ps( _mm_sub_ps( _mm_sub_ps( _mm_sub_ps( nd, ok ),
+                                                             _mm_mul_ps( nu, ou ) ),
+                                                 _mm_mul_ps( nv, ov ) ),
+                                     lnd );
+
+        const __m128 inRange = _mm_and_ps(
+                _mm_cmplt_ps( _mm_mul_ps( t, tScale ), _mm_loadu_ps( aTHit + i ) ),
+                _mm_cmpgt_ps( t, minusEpsilon ) );
+
+        if( !_mm_movemask_ps( inRange ) )
+            continue;
+
+        const __m128 hu = _mm_sub_ps( _mm_add_ps( ou, _mm_mul_ps( t, du ) ), au );
+        const __m128 hv = _mm_sub_ps( _mm_add_ps( ov, _mm_mul_ps( t, dv ) ), av );
+        const __m128 beta = _mm_add_ps( _mm_mul_ps( hv, _mm_set1_ps( aTri.bnu ) ),
+                                         _mm_mul_ps( hu, _mm_set1_ps( aTri.bnv ) ) );
+        const __m128 gamma = _mm_add_ps( _mm_mul_ps( hu, _mm_set1_ps( aTri.cnu ) ),
+                                          _mm_mul_ps( hv, _mm_set1_ps( aTri.cnv ) ) );
+        const __m128 dot = _mm_add_ps(
+                _mm_add_ps( _mm_mul_ps( _mm_loadu_ps( &aPacket.m_Dir[0][i] ),
+                                        _mm_set1_ps( aTri.n.x ) ),
+                            _mm_mul_ps( _mm_loadu_ps( &aPacket.m_Dir[1][i] ),
+                                        _mm_set1_ps( aTri.n.y ) ) ),
+                _mm_mul_ps( _mm_loadu_ps( &aPacket.m_Dir[2][i] ), _mm_set1_ps( aTri.n.z ) ) );
+
+        // Written as rejections, as in CTRIANGLE::Intersect, for the NaNs
+        const __m128 reject = _mm_or_ps(
+                _mm_or_ps( _mm_cmplt_ps( beta, minusEpsilon ),
+                           _mm_cmplt_ps( gamma, minusEpsilon ) ),
+                _mm_or_ps( _mm_cmpgt_ps( _mm_add_ps( beta, gamma ), maxUV ),
+                           _mm_cmpgt_ps( dot, epsilon ) ) );
+
+        mask |= (uint64_t) _mm_movemask_ps( _mm_andnot_ps( reject, inRange ) ) << i;
+    }
+
+    return mask & RAYPACKET_RangeMask( aFirst, aEnd );
+}
+
+#endif    // RAYPACKET_SSE2
+
+
+#ifdef RAYPACKET_AVX2
+
+RAYPACKET_TARGET_AVX2 static inline uint64_t intersectBBox8AVX2( const RAYPACKET_SOA &aPacket,
+                                                                 unsigned int i,
+                                                                 const __m256 *aMin,
+                                                                 const __m256 *aMax,
+                                                                 const float *aTHit )
+{
+    __m256 tNear = _mm256_setzero_ps();
+    __m256 tFar = _mm256_setzero_ps();
+
+    for( unsigned int axis = 0; axis < 3; ++axis )
+    {
+        const __m256 o = _mm256_loadu_ps( &aPacket.m_Origin[axis][i] );
+        const __m256 inv = _mm256_loadu_ps( &aPacket.m_InvDir[axis][i] );
+        const __m256 t1 = _mm256_mul_ps( _mm256_sub_ps( aMin[axis], o ), inv );
+        const __m256 t2 = _mm256_mul_ps( _mm256_sub_ps( aMax[axis], o ), inv );
+
+        tNear = ( axis == 0 ) ? _mm256_min_ps( t1, t2 )
+                              : _mm256_max_ps( tNear, _mm256_min_ps( t1, t2 ) );
+        tFar = ( axis == 0 ) ? _mm256_max_ps( t1, t2 )
+                             : _mm256_min_ps( tFar, _mm256_max_ps( t1, t2 ) );
+    }
+
+    const __m256 hit = _mm256_and_ps(
+            _mm256_and_ps( _mm256_cmp_ps( tNear, tFar, _CMP_LE_OQ ),
+                           _mm256_cmp_ps( tFar, _mm256_setzero_ps(), _CMP_GE_OQ ) ),
+            _mm256_cmp_ps( tNear, _mm256_loadu_ps( aTHit + i ), _CMP_LT_OQ ) );
+
+    return (uint64_t) _mm256_movemask_ps( hit ) << i;
+}
+
+
+RAYPACKET_TARGET_AVX2 static uint64_t intersectBBoxAVX2( const RAYPACKET_SOA &aPacket,
+                                                         const SFVEC3F &aMin,
+                                                         const SFVEC3F &aMax,
+                                                         const float *aTHit,
+                                                         unsigned int aFirst )
+{
+    const __m256 bmin[3] = { _mm256_set1_ps( aMin.x ), _mm256_set1_ps( aMin.y ),
+                             _mm256_set1_ps( aMin.z ) };
+    const __m256 bmax[3] = { _mm256_set1_ps( aMax.x ), _mm256_set1_ps( aMax.y ),
+                             _mm256_set1_ps( aMax.z ) };
+    uint64_t mask = 0;
+
+    for( unsigned int i = aFirst & ~7u; i < RAYPACKET_RAYS_PER_PACKET; i += 8 )
+        mask |= intersectBBox8AVX2( aPacket, i, bmin, bmax, aTHit );
+
+    return mask & RAYPACKET_RangeMask( aFirst, RAYPACKET_RAYS_PER_PACKET );
+}
+
+
+RAYPACKET_TARGET_AVX2 static uint64_t intersectTriangleAVX2( const RAYPACKET_SOA &aPacket,
+                                                             const RAYPACKET_TRIANGLE &aTri,
+                                                             const float *aTHit,
+                                                             unsigned int aFirst,
+                                                             unsigned int aEnd )
+{
+    const __m256 nu = _mm256_set1_ps( aTri.nu );
+    const __m256 nv = _mm256_set1_ps( aTri.nv );
+    const __m256 nd = _mm256_set1_ps( aTri.nd );
+    const __m256 au = _mm256_set1_ps( aTri.a[aTri.ku] );
+    const __m256 av = _mm256_set1_ps( aTri.a[aTri.kv] );
+    const __m256 epsilon = _mm256_set1_ps( RAYPACKET_TRI_EPSILON );
+    const __m256 minusEpsilon = _mm256_set1_ps( -RAYPACKET_TRI_EPSILON );
+    const __m256 tScale = _mm256_set1_ps( 1.0f - RAYPACKET_TRI_EPSILON );
+    const __m256 maxUV = _mm256_set1_ps( 1.0f + RAYPACKET_TRI_EPSILON );
+    uint64_t     mask = 0;
+
+    for( unsigned int i = aFirst & ~7u; i < aEnd; i += 8 )
+    {
+        const __m256 dk = _mm256_loadu_ps( &aPacket.m_Dir[aTri.k][i] );
+        const __m256 du = _mm256_loadu_ps( &aPacket.m_Dir[aTri.ku][i] );
+        const __m256 dv = _mm256_loadu_ps( &aPacket.m_Dir[aTri.kv][i] );
+        const __m256 ok = _mm256_loadu_ps( &aPacket.m_Origin[aTri.k][i] );
+        const __m256 ou = _mm256_loadu_ps( &aPacket.m_Origin[aTri.ku][i] );
+        const __m256 ov = _mm256_loadu_ps( &aPacket.m_Origin[aTri.kv][i] );
+
+        const __m256 lnd = _mm256_div_ps( _mm256_set1_ps( 1.0f ),
+                _mm256_add_ps( _mm256_add_ps( dk, _mm256_mul_ps( nu, du ) ),
+                               _mm256_mul_ps( nv, dv ) ) );
+        const __m256 t = _mm256_mul_ps(
+                _mm256_sub_ps( _mm256_sub_ps( _mm256_sub_ps( nd, ok ), _mm256_mul_ps( nu, ou ) ),
+                               _mm256_mul_ps( nv, ov ) ),
+                lnd );
+
+        const __m256 inRange = _mm256_and_ps(
+                _mm256_cmp_ps( _mm256_mul_ps( t, tScale ), _mm256_loadu_ps( aTHit + i ),
+                               _CMP_LT_OQ ),
+                _mm256_cmp_ps( t, minusEpsilon, _CMP_GT_OQ ) );
+
+        if( !_mm256_movemask_ps( inRange ) )
+            continue;
+
+        const __m256 hu = _mm256_sub_ps( _mm256_add_ps( ou, _mm256_mul_ps( t, du ) ), au );
+        const __m256 hv = _mm256_sub_ps( _mm256_add_ps( ov, _mm256_mul_ps( t, dv ) ), av );
+        const __m256 beta = _mm256_add_ps( _mm256_mul_ps( hv, _mm256_set1_ps( aTri.bnu ) ),
+                                           _mm256_mul_ps( hu, _mm256_set1_ps( aTri.bnv ) ) );
+        const __m256 gamma = _mm256_add_ps( _mm256_mul_ps( hu, _mm256_set1_ps( aTri.cnu ) ),
+                                            _mm256_mul_ps( hv, _mm256_set1_ps( aTri.cnv ) ) );
+        const __m256 dot = _mm256_add_ps(
+                _mm256_add_ps( _mm256_mul_ps( _mm256_loadu_ps( &aPacket.m_Dir[0][i] ),
+                                              _mm256_set1_ps( aTri.n.x ) ),
+                               _mm256_mul_ps( _mm256_loadu_ps( &aPacket.m_Dir[1][i] ),
+                                              _mm256_set1_ps( aTri.n.y ) ) ),
+                _mm256_mul_ps( _mm256_loadu_ps( &aPacket.m_Dir[2][i] ),
+                               _mm256_set1_ps( aTri.n.z ) ) );
+
+        // Written as rejections, as in CTRIANGLE::Intersect, for the NaNs
+        const __m256 reject = _mm256_or_ps(
+                _mm256_or_ps( _mm256_cmp_ps( beta, minusEpsilon, _CMP_LT_OQ ),
+                              _mm256_cmp_ps( gamma, minusEpsilon, _CMP_LT_OQ ) ),
+                _mm256_or_ps( _mm256_cmp_ps( _mm256_add_ps( beta, gamma ), maxUV, _CMP_GT_OQ ),
+                              _mm256_cmp_ps( dot, epsilon, _CMP_GT_OQ ) ) );
+
+        mask |= (uint64_t) _mm256_movemask_ps( _mm256_andnot_ps( reject, inRange ) ) << i;
+    }
+
+    return mask & RAYPACKET_RangeMask( aFirst, aEnd );
+}
+
+#endif    // RAYPACKET_AVX2
+
+
+uint64_t RAYPACKET_IntersectBBox( const RAYPACKET_SOA &aPacket,
+                                  const CBBOX &aBBox,
+                                  const float *aTHit,
+                                  unsigned int aFirst )
+{
+    SFVEC3F bmin;
+    SFVEC3F bmax;
+
+    marginBBox( aBBox, bmin, bmax );
+
+    switch( GetSimdLevel() )
+    {
+#ifdef RAYPACKET_AVX2
+    case SIMD_LEVEL::AVX2:
+        return intersectBBoxAVX2( aPacket, bmin, bmax, aTHit, aFirst );
+#endif
+#ifdef RAYPACKET_SSE2
+    case SIMD_LEVEL::SSE2:
+        return intersectBBoxSSE2( aPacket, bmin, bmax, aTHit, aFirst );
+#endif
+    default:
+        return intersectBBoxScalar( aPacket, bmin, bmax, aTHit, aFirst );
+    }
+}
+
+
+uint64_t RAYPACKET_IntersectTriangle( const RAYPACKET_SOA &aPacket,
+                                      const RAYPACKET_TRIANGLE &aTriangle,
+                                      const float *aTHit,
+                                      unsigned int aFirst,
+                                      unsigned int aEnd )
+{
+    switch( GetSimdLevel() )
+    {
+#ifdef RAYPACKET_AVX2
+    case SIMD_LEVEL::AVX2:
+        return intersectTriangleAVX2( aPacket, aTriangle, aTHit, aFirst, aEnd );
+#endif
+#ifdef RAYPACKET_SSE2
+    case SIMD_LEVEL::SSE2:
+        return intersectTriangleSSE2( aPacket, aTriangle, aTHit, aFirst, aEnd );
+#endif
+    default:
+        return intersectTriangleScalar( aPacket, aTriangle, aTHit, aFirst, aEnd );
+    }
+}
@@ -0,0 +1,84 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file  raypacket_simd.h
+ * @brief SIMD kernels testing all the rays of a packet against a box or a triangle.
+ *
+ * The kernels are filters: they never reject a ray hitting the object with the scalar
+ * tests, but may keep a few grazing it.  The exact test still runs on the rays they keep,
+ * so the picture is the same whichever instruction set is used (see GetSimdLevel()).
+ */
+
+#ifndef _RAYPACKET_SIMD_H_
+#define _RAYPACKET_SIMD_H_
+
+#include "raypacket.h"
+#include <cstdint>
+
+class CBBOX;
+
+static_assert( RAYPACKET_RAYS_PER_PACKET == 64, "the packet masks are 64 bit wide" );
+
+
+/// The constants of the projected triangle test of CTRIANGLE::Intersect
+struct RAYPACKET_TRIANGLE
+{
+    unsigned int k, ku, kv;     ///< the dominant axis of the normal, and the two others
+    float nu, nv, nd;
+    float bnu, bnv;
+    float cnu, cnv;
+    SFVEC3F a;                  ///< the first vertex
+    SFVEC3F n;                  ///< the face normal
+};
+
+
+/**
+ * @return the mask of the rays of the packet, from aFirst, which may enter aBBox before the
+ *         distances of aTHit (one per ray of the packet).
+ */
+uint64_t RAYPACKET_IntersectBBox( const RAYPACKET_SOA &aPacket,
+                                  const CBBOX &aBBox,
+                                  const float *aTHit,
+                                  unsigned int aFirst );
+
+/**
+ * @return the mask of the rays of the packet, in [aFirst, aEnd), which may hit the front
+ *         face of aTriangle before the distances of aTHit.
+ */
+uint64_t RAYPACKET_IntersectTriangle( const RAYPACKET_SOA &aPacket,
+                                      const RAYPACKET_TRIANGLE &aTriangle,
+                                      const float *aTHit,
+                                      unsigned int aFirst,
+                                      unsigned int aEnd );
+
+
+/// @return the mask of the rays in [aFirst, aEnd)
+inline uint64_t RAYPACKET_RangeMask( unsigned int aFirst, unsigned int aEnd )
+{
+    const uint64_t end = ( aEnd >= 64 ) ? ~(uint64_t) 0 : ( ( (uint64_t) 1 << aEnd ) - 1 );
+
+    return end & ~( ( (uint64_t) 1 << aFirst ) - 1 );
+}
+
+#endif // _RAYPACKET_SIMD_H_
@@ -30,6 +30,8 @@
 #include "cpolygon2d.h"
 #include <wx/debug.h>
 #include <fctsys.h>
+#include <geometry/poly_set_index.h>
+#include <math/util.h>              // for KiROUND
 
 #ifdef PRINT_STATISTICS_3D_VIEWER
 #include <stdio.h>
@@ -417,6 +419,9 @@ void Convert_path_polygon_to_polygon_blocks_and_dummy_blocks(
 
     BOX2I pathBounds = path.BBox();
 
+    // Shared by the calls for the other polygons of aMainPath
+    std::shared_ptr<const POLY_SET_INDEX> mainPathIndex = aMainPath.GetIndex();
+
     // Convert the points to segments class
     CBBOX2D bbox;
     bbox.Reset();
@@ -424,11 +429,7 @@ void Convert_path_polygon_to_polygon_blocks_and_dummy_blocks(
     // Contains the main list of segments and each segment normal interpolated
     SEGMENTS_WIDTH_NORMALS segments_and_normals;
 
-    // Contains a closed polygon used to calc if points are inside
-    SEGMENTS segments;
-
     segments_and_normals.reserve( path.PointCount() );
-    segments.reserve( path.PointCount() );
 
     SFVEC2F prevPoint;
 
@@ -451,10 +452,6 @@ void Convert_path_polygon_to_polygon_blocks_and_dummy_blocks(
             SEGMENT_WITH_NORMALS sn;
             sn.m_Start = point;
             segments_and_normals.push_back( sn );
-
-            POLYSEGMENT ps;
-            ps.m_Start = point;
-            segments.push_back( ps );
         }
     }
 
@@ -481,13 +478,6 @@ void Convert_path_polygon_to_polygon_blocks_and_dummy_blocks(
 
         segments_and_normals[i].m_Precalc_slope = slope;
 
-        // Calculate constants for each segment
-        segments[i].m_inv_JY_minus_IY = 1.0f / ( segments_and_normals[j].m_Start.y -
-                                                 segments_and_normals[i].m_Start.y );
-
-        segments[i].m_JX_minus_IX = ( segments_and_normals[j].m_Start.x -
-                                      segments_and_normals[i].m_Start.x );
-
         // The normal orientation expect a fixed polygon orientation (!TODO: which one?)
         //tmpSegmentNormals[i] = glm::normalize( SFVEC2F( -slope.y, +slope.x ) );
         tmpSegmentNormals[i] = glm::normalize( SFVEC2F( slope.y, -slope.x ) );
@@ -604,20 +594,15 @@ void Convert_path_polygon_to_polygon_blocks_and_dummy_blocks(
 
             if( extractedSegments.empty() )
             {
-
-                SFVEC2F p1( blockBox.Min().x, blockBox.Min().y );
-                SFVEC2F p2( blockBox.Max().x, blockBox.Min().y );
-                SFVEC2F p3( blockBox.Max().x, blockBox.Max().y );
-                SFVEC2F p4( blockBox.Min().x, blockBox.Max().y );
-
-                if( polygon_IsPointInside( segments, p1 ) ||
-                    polygon_IsPointInside( segments, p2 ) ||
-                    polygon_IsPointInside( segments, p3 ) ||
-                    polygon_IsPointInside( segments, p4 ) )
+                // The block does not intersect the outline, so it is inside of the polygon
+                // if its center is.  The center is tested in board units with the index of
+                // the polygons, rather than against every segment of the outline.
+                const SFVEC2F  center = blockBox.GetCenter();
+                const VECTOR2I centerBiu( KiROUND(  center.x / aBiuTo3DunitsScale ),
+                                          KiROUND( -center.y / aBiuTo3DunitsScale ) );
+
+                if( mainPathIndex->Contains( centerBiu, aPolyIndex, 1 ) )
                 {
-                    // In this case, the segments are not intersecting the
-                    // polygon, so it means that if any point is inside it,
-                    // then all other are inside the polygon.
                     // This is a full bbox inside, so add a dummy box
 
                     aDstContainer.Add( new CDUMMYBLOCK2D( blockBox, aBoardItem ) );
@@ -105,6 +105,8 @@ public:
     const CBBOX &GetBBox() const { return m_bbox; }
 
     const SFVEC3F &GetCentroid() const { return m_centroid; }
+
+    OBJECT3D_TYPE GetObjectType() const { return m_obj_type; }
 };
 
 
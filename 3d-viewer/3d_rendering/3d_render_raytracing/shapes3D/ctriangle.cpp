@@ -32,6 +32,7 @@
 
 
 #include "ctriangle.h"
+#include "../raypacket_simd.h"
 
 
 void CTRIANGLE::pre_calc_const()
@@ -264,6 +265,28 @@ bool CTRIANGLE::Intersect( const RAY &aRay, HITINFO &aHitInfo ) const
 }
 
 
+uint64_t CTRIANGLE::IntersectPacket( const RAYPACKET &aRayPacket, const float *aTHit,
+                                     unsigned int aFirst, unsigned int aEnd ) const
+{
+    RAYPACKET_TRIANGLE tri;
+
+    tri.k   = m_k;
+    tri.ku  = s_modulo[m_k + 1];
+    tri.kv  = s_modulo[m_k + 2];
+    tri.nu  = m_nu;
+    tri.nv  = m_nv;
+    tri.nd  = m_nd;
+    tri.bnu = m_bnu;
+    tri.bnv = m_bnv;
+    tri.cnu = m_cnu;
+    tri.cnv = m_cnv;
+    tri.a   = m_vertex[0];
+    tri.n   = m_n;
+
+    return RAYPACKET_IntersectTriangle( aRayPacket.m_soa, tri, aTHit, aFirst, aEnd );
+}
+
+
 bool CTRIANGLE::IntersectP( const RAY &aRay,
                             float aMaxDistance ) const
 {
@@ -35,6 +35,7 @@
 #define _CTRIANGLE_H_
 
 #include "cobject.h"
+#include <cstdint>
 
 /**
  * A triangle object
@@ -69,6 +70,13 @@ public:
     bool Intersects( const CBBOX &aBBox ) const override;
     SFVEC3F GetDiffuseColor( const HITINFO &aHitInfo ) const override;
 
+    /**
+     * @return the mask of the rays of the packet, in [aFirst, aEnd), which may hit the
+     *         triangle before their aTHit distance: only these need the Intersect() test.
+     */
+    uint64_t IntersectPacket( const RAYPACKET &aRayPacket, const float *aTHit,
+                              unsigned int aFirst, unsigned int aEnd ) const;
+
 private:
     void pre_calc_const();
 
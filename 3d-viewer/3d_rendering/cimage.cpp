@@ -30,11 +30,11 @@
 #include "cimage.h"
 #include "buffers_debug.h"
 #include <cstring> // For memcpy
+#include <thread_pool.h>
 
 #include <algorithm>
-#include <atomic>
-#include <thread>
-#include <chrono>
+#include <vector>
+#include <wx/debug.h>
 
 #ifndef CLAMP
 #define CLAMP(n, min, max) {if( n < min ) n=min; else if( n > max ) n = max;}
@@ -465,62 +465,210 @@ static const S_FILTER FILTERS[] =   {
 // clang-format on
 
 
-// !TODO: This functions can be optimized slipting it between the edges and
-//        do it without use the getpixel function.
-//        Optimization can be done to m_pixels[ix + iy * m_width]
-//        but keep in mind the parallel process of the algorithm
+/**
+ * Run aFunc( y ) for each row y of an image, on the thread pool.
+ */
+template <typename FUNC>
+static void forEachRow( unsigned int aHeight, FUNC aFunc )
+{
+    // The rows are handed out by bands: a single row costs less than taking it
+    const unsigned int rowsPerBand = 32;
+    const unsigned int bandCount = ( aHeight + rowsPerBand - 1 ) / rowsPerBand;
+
+    if( bandCount <= 1 )
+    {
+        for( unsigned int iy = 0; iy < aHeight; ++iy )
+            aFunc( iy );
+
+        return;
+    }
+
+    THREAD_POOL::GetInstance().ParallelFor( bandCount,
+            [&]( size_t aBand )
+            {
+                unsigned int end = std::min( aHeight, (unsigned int) ( aBand + 1 ) * rowsPerBand );
+
+                for( unsigned int iy = aBand * rowsPerBand; iy < end; ++iy )
+                    aFunc( iy );
+            } );
+}
+
+
+/// A non zero weight of a 1D kernel
+struct FILTER_TAP
+{
+    int offset;     ///< from the filtered pixel, -2 to 2
+    int weight;
+};
+
+
+/**
+ * Factor a 5x5 kernel into a horizontal and a vertical 1D kernels, when it is separable:
+ * kernel[x][y] * aPivot == aHorizontal(x) * aVertical(y).
+ * @return false if the kernel is not separable.
+ */
+static bool separateFilter( const S_FILTER& aFilter, std::vector<FILTER_TAP>& aHorizontal,
+                            std::vector<FILTER_TAP>& aVertical, int& aPivot )
+{
+    int px = -1;
+    int py = -1;
+
+    for( int x = 0; x < 5 && px < 0; ++x )
+    {
+        for( int y = 0; y < 5; ++y )
+        {
+            if( aFilter.kernel[x][y] != 0 )
+            {
+                px = x;
+                py = y;
+                break;
+            }
+        }
+    }
+
+    if( px < 0 )
+        return false;
+
+    aPivot = aFilter.kernel[px][py];
+
+    for( int x = 0; x < 5; ++x )
+    {
+        for( int y = 0; y < 5; ++y )
+        {
+            if( aFilter.kernel[x][y] * aPivot != aFilter.kernel[x][py] * aFilter.kernel[px][y] )
+                return false;
+        }
+    }
+
+    aHorizontal.clear();
+    aVertical.clear();
+
+    for( int i = 0; i < 5; ++i )
+    {
+        if( aFilter.kernel[i][py] != 0 )
+            aHorizontal.push_back( { i - 2, aFilter.kernel[i][py] } );
+
+        if( aFilter.kernel[px][i] != 0 )
+            aVertical.push_back( { i - 2, aFilter.kernel[px][i] } );
+    }
+
+    return true;
+}
+
+
 void CIMAGE::EfxFilter( CIMAGE* aInImg, IMAGE_FILTER aFilterType )
 {
-    S_FILTER filter = FILTERS[static_cast<int>( aFilterType )];
+    const S_FILTER& filter = FILTERS[static_cast<int>( aFilterType )];
 
     aInImg->m_wraping = IMAGE_WRAP::CLAMP;
     m_wraping         = IMAGE_WRAP::CLAMP;
 
-    std::atomic<size_t> nextRow( 0 );
-    std::atomic<size_t> threadsFinished( 0 );
+    wxASSERT( aInImg->m_width == m_width && aInImg->m_height == m_height );
+
+    if( m_wxh == 0 )
+        return;
+
+    const int width = m_width;
+    const int height = m_height;
+
+    auto clampX = [width]( int x ) { return x < 0 ? 0 : ( x >= width ? width - 1 : x ); };
+    auto clampY = [height]( int y ) { return y < 0 ? 0 : ( y >= height ? height - 1 : y ); };
+
+    auto storePixel = [&]( int aX, int aY, int v )
+    {
+        v /= (int) filter.div;
+        v += filter.offset;
+        CLAMP( v, 0, 255 );
+        m_pixels[aX + aY * width] = v;
+    };
 
-    size_t parallelThreadCount = std::max<size_t>( std::thread::hardware_concurrency(), 2 );
+    std::vector<FILTER_TAP> horizontal;
+    std::vector<FILTER_TAP> vertical;
+    int                     pivot;
 
-    for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+    if( separateFilter( filter, horizontal, vertical, pivot ) )
     {
-        std::thread t = std::thread( [&]()
+        // Two 1D passes, through a buffer of the horizontal sums.  The sums are integer, so
+        // the result is the same as the one of the 5x5 kernel
+        std::vector<int> rowSums( m_wxh );
+
+        forEachRow( m_height, [&]( unsigned int iy )
         {
-            for( size_t iy = nextRow.fetch_add( 1 );
-                        iy < m_height;
-                        iy = nextRow.fetch_add( 1 ) )
+            const unsigned char* src = &aInImg->m_pixels[iy * width];
+            int*                 dst = &rowSums[iy * width];
+
+            // The pixels far enough from the edges need no clamp, so the loop vectorizes
+            for( int ix = 0; ix < width; ++ix )
             {
-                for( size_t ix = 0; ix < m_width; ix++ )
+                int v = 0;
+
+                if( ix >= 2 && ix < width - 2 )
+                {
+                    for( const FILTER_TAP& tap : horizontal )
+                        v += src[ix + tap.offset] * tap.weight;
+                }
+                else
                 {
-                    int v = 0;
-
-                    for( size_t sy = 0; sy < 5; sy++ )
-                    {
-                        for( size_t sx = 0; sx < 5; sx++ )
-                        {
-                            int factor = filter.kernel[sx][sy];
-                            unsigned char pixelv = aInImg->Getpixel( ix + sx - 2,
-                                                                     iy + sy - 2 );
-
-                            v += pixelv * factor;
-                        }
-                    }
-
-                    v /= filter.div;
-                    v += filter.offset;
-                    CLAMP(v, 0, 255);
-                    //TODO: This needs to write to a separate buffer
-                    m_pixels[ix + iy * m_width] = v;
+                    for( const FILTER_TAP& tap : horizontal )
+                        v += src[clampX( ix + tap.offset )] * tap.weight;
                 }
+
+                dst[ix] = v;
             }
+        } );
+
+        forEachRow( m_height, [&]( unsigned int iy )
+        {
+            const int* rows[5];
+
+            for( size_t i = 0; i < vertical.size(); ++i )
+                rows[i] = &rowSums[clampY( (int) iy + vertical[i].offset ) * width];
 
-            threadsFinished++;
+            for( int ix = 0; ix < width; ++ix )
+            {
+                int v = 0;
+
+                for( size_t i = 0; i < vertical.size(); ++i )
+                    v += rows[i][ix] * vertical[i].weight;
+
+                storePixel( ix, iy, v / pivot );
+            }
         } );
 
-        t.detach();
+        return;
     }
 
-    while( threadsFinished < parallelThreadCount )
-        std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+    forEachRow( m_height, [&]( unsigned int iy )
+    {
+        const unsigned char* rows[5];
+
+        for( int sy = 0; sy < 5; sy++ )
+            rows[sy] = &aInImg->m_pixels[clampY( (int) iy + sy - 2 ) * width];
+
+        for( int ix = 0; ix < width; ix++ )
+        {
+            int v = 0;
+
+            if( ix >= 2 && ix < width - 2 )
+            {
+                for( int sy = 0; sy < 5; sy++ )
+                {
+                    for( int sx = 0; sx < 5; sx++ )
+                        v += rows[sy][ix + sx - 2] * filter.kernel[sx][sy];
+                }
+            }
+            else
+            {
+                for( int sy = 0; sy < 5; sy++ )
+                {
+                    for( int sx = 0; sx < 5; sx++ )
+                        v += rows[sy][clampX( ix + sx - 2 )] * filter.kernel[sx][sy];
+                }
+            }
+
+            storePixel( ix, iy, v );
+        }
+    } );
 }
 
 
@@ -178,7 +178,8 @@ public:
      * Function EfxFilter
      * apply a filter to the input image and stores it in the image class
      * this <- FilterType(aInImg)
-     * @param aInImg input image
+     * The separable kernels are applied as two 1D passes, on all the cores for large images.
+     * @param aInImg input image, of the same size as this image
      * @param aFilterType filter type to apply
      */
     void EfxFilter( CIMAGE* aInImg, IMAGE_FILTER aFilterType );
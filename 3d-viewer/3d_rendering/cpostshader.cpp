@@ -188,6 +188,46 @@ const float &CPOSTSHADER::GetShadowFactorAt( const SFVEC2I &aPos ) const
 }
 
 
+SFVEC3F CPOSTSHADER::UpsampleBilateral( const SFVEC3F *aHalfBuffer,
+                                        const SFVEC2UI &aHalfSize,
+                                        const SFVEC2I &aPos ) const
+{
+    const float depth = m_depth[ getIndex( aPos ) ];
+
+    // Nothing was hit, the shaders return no shade there
+    if( depth <= FLT_EPSILON )
+        return SFVEC3F( 0.0f );
+
+    // An even coordinate falls on a half resolution sample, an odd one between two
+    const int hx0 = glm::min( aPos.x / 2, (int)aHalfSize.x - 1 );
+    const int hy0 = glm::min( aPos.y / 2, (int)aHalfSize.y - 1 );
+    const int hx1 = glm::min( hx0 + ( aPos.x & 1 ), (int)aHalfSize.x - 1 );
+    const int hy1 = glm::min( hy0 + ( aPos.y & 1 ), (int)aHalfSize.y - 1 );
+
+    const int hxs[2] = { hx0, hx1 };
+    const int hys[2] = { hy0, hy1 };
+
+    SFVEC3F sum( 0.0f );
+    float   weightSum = 0.0f;
+
+    for( unsigned int j = 0; j < 2; ++j )
+    {
+        for( unsigned int i = 0; i < 2; ++i )
+        {
+            const float sampleDepth = m_depth[ getIndex( SFVEC2I( hxs[i] * 2, hys[j] * 2 ) ) ];
+            const float depthDiff = ( depth - sampleDepth ) / depth;
+
+            const float weight = 1.0f / ( 1.0e-4f + depthDiff * depthDiff );
+
+            sum += aHalfBuffer[ hxs[i] + hys[j] * aHalfSize.x ] * weight;
+            weightSum += weight;
+        }
+    }
+
+    return sum / weightSum;
+}
+
+
 void CPOSTSHADER::DebugBuffersOutputAsImages() const
 {
     DBG_SaveBuffer( "m_shadow_att_factor", m_shadow_att_factor, m_size.x, m_size.y );
@@ -63,6 +63,20 @@ public:
 
     const SFVEC3F &GetColorAtNotProtected( const SFVEC2I &aPos ) const;
 
+    /**
+     * @brief UpsampleBilateral - upsample a shader result computed at half resolution
+     * The half resolution buffer holds the shade of the full resolution pixels (2x, 2y).
+     * The (up to) 4 nearest samples are interpolated, weighted by how close their depth
+     * is to the depth of aPos, so the shade does not bleed across object edges.
+     * @param aHalfBuffer - the half resolution shade buffer
+     * @param aHalfSize - the size of aHalfBuffer
+     * @param aPos - the full resolution pixel to upsample
+     * @return the upsampled shade at aPos
+     */
+    SFVEC3F UpsampleBilateral( const SFVEC3F *aHalfBuffer,
+                               const SFVEC2UI &aHalfSize,
+                               const SFVEC2I &aPos ) const;
+
     void DebugBuffersOutputAsImages() const;
 
 protected:
@@ -80,9 +94,6 @@ protected:
     float GetDepthNormalizedAt( const SFVEC2I &aPos ) const;
     float GetMaxDepth() const { return m_tmax; }
 
-private:
-    void destroy_buffers();
-
     inline unsigned int getIndex( const SFVEC2F &aPos ) const
     {
         SFVEC2F clampPos;
@@ -106,6 +117,9 @@ private:
         return (unsigned int)( clampPos.x + m_size.x * clampPos.y );
     }
 
+private:
+    void destroy_buffers();
+
 protected:
     const CCAMERA &m_camera;
 
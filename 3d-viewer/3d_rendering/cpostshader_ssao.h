@@ -49,17 +49,13 @@ private:
 
     float ec_depth( const SFVEC2F &tc ) const;
 
-    float aoFF( const SFVEC2I &aShaderPos,
+    float aoFF( unsigned int aSampleIdx,
                 const SFVEC3F &ddiff,
-                const SFVEC3F &cnorm,
-                int c1,
-                int c2 ) const;
+                const SFVEC3F &cnorm ) const;
 
-    float giFF( const SFVEC2I &aShaderPos,
+    float giFF( unsigned int aSampleIdx,
                 const SFVEC3F &ddiff,
-                const SFVEC3F &cnorm,
-                int c1,
-                int c2 ) const;
+                const SFVEC3F &cnorm ) const;
 
     /**
      * @brief giColorCurve - Apply a curve transformation to the original color
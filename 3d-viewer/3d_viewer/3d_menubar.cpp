@@ -156,6 +156,11 @@ void EDA_3D_VIEWER::CreateMenuBar()
         return m_boardAdapter.GetFlag( FL_RENDER_RAYTRACING_ANTI_ALIASING );
     };
 
+    auto progressiveRenderCondition = [this]( const SELECTION& aSel )
+    {
+        return m_boardAdapter.GetFlag( FL_RENDER_RAYTRACING_PROGRESSIVE );
+    };
+
     auto postProcessCondition = [this]( const SELECTION& aSel )
     {
         return m_boardAdapter.GetFlag( FL_RENDER_RAYTRACING_POST_PROCESSING );
@@ -213,6 +218,7 @@ void EDA_3D_VIEWER::CreateMenuBar()
     raySubmenu->AddCheckItem( EDA_3D_ACTIONS::showRefractions,      useRefractionsCondition );
     raySubmenu->AddCheckItem( EDA_3D_ACTIONS::showReflections,      useReflectionsCondition );
     raySubmenu->AddCheckItem( EDA_3D_ACTIONS::antiAliasing,         antiAliasingCondition );
+    raySubmenu->AddCheckItem( EDA_3D_ACTIONS::progressiveRender,    progressiveRenderCondition );
 
     raySubmenu->AddCheckItem( EDA_3D_ACTIONS::postProcessing,       postProcessCondition );
 
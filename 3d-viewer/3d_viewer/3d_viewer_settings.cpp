@@ -79,6 +79,8 @@ EDA_3D_VIEWER_SETTINGS::EDA_3D_VIEWER_SETTINGS() :
             &m_Render.raytrace_post_processing, true ) );
     m_params.emplace_back(  new PARAM<bool>( "render.raytrace_procedural_textures",
             &m_Render.raytrace_procedural_textures, true ) );
+    m_params.emplace_back( new PARAM<bool>( "render.raytrace_progressive",
+            &m_Render.raytrace_progressive, true ) );
     m_params.emplace_back( new PARAM<bool>( "render.raytrace_reflections",
             &m_Render.raytrace_reflections, true ) );
     m_params.emplace_back( new PARAM<bool>( "render.raytrace_refractions",
@@ -45,6 +45,7 @@ public:
         bool raytrace_backfloor;
         bool raytrace_post_processing;
         bool raytrace_procedural_textures;
+        bool raytrace_progressive;
         bool raytrace_reflections;
         bool raytrace_refractions;
         bool raytrace_shadows;
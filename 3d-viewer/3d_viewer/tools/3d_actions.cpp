@@ -233,6 +233,12 @@ TOOL_ACTION EDA_3D_ACTIONS::antiAliasing( "3DViewer.Control.antiAliasing",
          _( "Anti-aliasing" ), _( "Render with improved quality on final render (slow)" ),
          nullptr, AF_NONE, (void*) FL_RENDER_RAYTRACING_ANTI_ALIASING );
 
+TOOL_ACTION EDA_3D_ACTIONS::progressiveRender( "3DViewer.Control.progressiveRender",
+         AS_GLOBAL, 0, "",
+         _( "Progressive Render" ),
+         _( "Show a coarse preview first and anti-alias only the edges on final render" ),
+         nullptr, AF_NONE, (void*) FL_RENDER_RAYTRACING_PROGRESSIVE );
+
 TOOL_ACTION EDA_3D_ACTIONS::postProcessing( "3DViewer.Control.postProcessing",
         AS_GLOBAL, 0, "",
         _( "Post-processing" ),
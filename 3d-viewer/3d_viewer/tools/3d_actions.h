@@ -82,6 +82,7 @@ public:
     static TOOL_ACTION showRefractions;
     static TOOL_ACTION showReflections;
     static TOOL_ACTION antiAliasing;
+    static TOOL_ACTION progressiveRender;
     static TOOL_ACTION postProcessing;
     static TOOL_ACTION toggleRealisticMode;
     static TOOL_ACTION toggleBoardBody;
@@ -193,6 +193,7 @@ int EDA_3D_CONTROLLER::ToggleVisibility( const TOOL_EVENT& aEvent )
     case FL_RENDER_RAYTRACING_REFRACTIONS:
     case FL_RENDER_RAYTRACING_REFLECTIONS:
     case FL_RENDER_RAYTRACING_ANTI_ALIASING:
+    case FL_RENDER_RAYTRACING_PROGRESSIVE:
     case FL_AXIS:
         m_canvas->Request_refresh();
         break;
@@ -329,6 +330,7 @@ void EDA_3D_CONTROLLER::setTransitions()
     Go( &EDA_3D_CONTROLLER::ToggleVisibility,   EDA_3D_ACTIONS::showRefractions.MakeEvent() );
     Go( &EDA_3D_CONTROLLER::ToggleVisibility,   EDA_3D_ACTIONS::showReflections.MakeEvent() );
     Go( &EDA_3D_CONTROLLER::ToggleVisibility,   EDA_3D_ACTIONS::antiAliasing.MakeEvent() );
+    Go( &EDA_3D_CONTROLLER::ToggleVisibility,   EDA_3D_ACTIONS::progressiveRender.MakeEvent() );
     Go( &EDA_3D_CONTROLLER::ToggleVisibility,   EDA_3D_ACTIONS::postProcessing.MakeEvent() );
     Go( &EDA_3D_CONTROLLER::ToggleVisibility,   EDA_3D_ACTIONS::toggleRealisticMode.MakeEvent() );
     Go( &EDA_3D_CONTROLLER::ToggleVisibility,   EDA_3D_ACTIONS::toggleBoardBody.MakeEvent() );
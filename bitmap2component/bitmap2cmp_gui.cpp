@@ -167,6 +167,7 @@ BM2CMP_FRAME::BM2CMP_FRAME( KIWAY* aKiway, wxWindow* aParent ) :
     //Set icon for aspect ratio
     m_AspectRatioLocked = true;
     m_AspectRatio = 1;
+    m_pendingThreshold = -1.0;
     m_AspectRatioLockButton->SetBitmap( KiBitmap( locked_xpm ) );
 
     // Give an icon
@@ -188,6 +189,7 @@ BM2CMP_FRAME::BM2CMP_FRAME( KIWAY* aKiway, wxWindow* aParent ) :
 
 BM2CMP_FRAME::~BM2CMP_FRAME()
 {
+    cancelBinarize();
     SaveSettings( config() );
     /*
      * This needed for OSX: avoids further OnDraw processing after this
@@ -402,6 +404,7 @@ bool BM2CMP_FRAME::OpenProjectFiles( const std::vector<wxString>& aFileSet, int
     m_GreyscalePicturePanel->SetVirtualSize( w, h );
     m_BNPicturePanel->SetVirtualSize( w, h );
 
+    cancelBinarize();
     m_Greyscale_Image.Destroy();
     m_Greyscale_Image = m_Pict_Image.ConvertToGreyscale( );
 
@@ -588,32 +591,113 @@ void BM2CMP_FRAME::ToggleAspectRatioLock( wxCommandEvent& event )
 }
 
 
-void BM2CMP_FRAME::Binarize( double aThreshold )
+/**
+ * @return the RGB data (allocated by malloc) of the black and white image of a greyscale
+ * image, aAlpha being its alpha channel or NULL
+ *
+ * Reads only the raw data of the image: it can run on another thread.
+ */
+static unsigned char* binarizeData( const unsigned char* aGrey, const unsigned char* aAlpha,
+                                    int aWidth, int aHeight, double aThreshold )
 {
-    int           h = m_Greyscale_Image.GetHeight();
-    int           w = m_Greyscale_Image.GetWidth();
-    unsigned char threshold = aThreshold * 255;
-    unsigned char alpha_thresh = 0.7 * threshold;
+    size_t         count = (size_t) aWidth * aHeight;
+    unsigned char  threshold = aThreshold * 255;
+    unsigned char  alpha_thresh = 0.7 * threshold;
+    unsigned char* data = (unsigned char*) malloc( count * 3 );
 
-    for( int y = 0; y < h; y++ )
-        for( int x = 0; x < w; x++ )
-        {
-            unsigned char pixout;
-            auto pixin   = m_Greyscale_Image.GetGreen( x, y );
-            auto alpha   = m_Greyscale_Image.HasAlpha() ?
-                    m_Greyscale_Image.GetAlpha( x, y ) : wxALPHA_OPAQUE;
+    if( !data )
+        return nullptr;
 
-            if( pixin < threshold && alpha > alpha_thresh )
-                pixout = 0;
-            else
-                pixout = 255;
+    for( size_t ii = 0; ii < count; ii++ )
+    {
+        unsigned char pixin = aGrey[ii * 3 + 1];
+        unsigned char alpha = aAlpha ? aAlpha[ii] : wxALPHA_OPAQUE;
+        unsigned char pixout = ( pixin < threshold && alpha > alpha_thresh ) ? 0 : 255;
 
-            m_NB_Image.SetRGB( x, y, pixout, pixout, pixout );
+        data[ii * 3] = data[ii * 3 + 1] = data[ii * 3 + 2] = pixout;
+    }
+
+    return data;
+}
+
+
+void BM2CMP_FRAME::Binarize( double aThreshold )
+{
+    cancelBinarize();
+
+    setBinarizedImage( binarizeData( m_Greyscale_Image.GetData(), m_Greyscale_Image.GetAlpha(),
+                                     m_Greyscale_Image.GetWidth(),
+                                     m_Greyscale_Image.GetHeight(), aThreshold ) );
+}
 
-        }
 
+void BM2CMP_FRAME::setBinarizedImage( unsigned char* aData )
+{
+    if( !aData )
+    {
+        wxMessageBox( _( "Error allocating memory for the black and white image" ) );
+        return;
+    }
+
+    m_NB_Image = wxImage( m_Greyscale_Image.GetWidth(), m_Greyscale_Image.GetHeight(), aData );
     m_BN_Bitmap = wxBitmap( m_NB_Image );
+}
+
+
+void BM2CMP_FRAME::startBinarize( double aThreshold )
+{
+    if( m_binarizeJob.valid() )
+    {
+        m_pendingThreshold = aThreshold;
+        return;
+    }
+
+    // The greyscale image is not changed while the job runs: see cancelBinarize()
+    const unsigned char* grey = m_Greyscale_Image.GetData();
+    const unsigned char* alpha = m_Greyscale_Image.GetAlpha();
+    int                  w = m_Greyscale_Image.GetWidth();
+    int                  h = m_Greyscale_Image.GetHeight();
+
+    m_binarizeJob = std::async( std::launch::async,
+            [this, grey, alpha, w, h, aThreshold]()
+            {
+                unsigned char* data = binarizeData( grey, alpha, w, h, aThreshold );
+
+                CallAfter( [this]()
+                           {
+                               onBinarizeDone();
+                           } );
+
+                return data;
+            } );
+}
+
+
+void BM2CMP_FRAME::onBinarizeDone()
+{
+    // Already collected by cancelBinarize()
+    if( !m_binarizeJob.valid() )
+        return;
 
+    setBinarizedImage( m_binarizeJob.get() );
+    Refresh();
+
+    if( m_pendingThreshold >= 0.0 )
+    {
+        double threshold = m_pendingThreshold;
+
+        m_pendingThreshold = -1.0;
+        startBinarize( threshold );
+    }
+}
+
+
+void BM2CMP_FRAME::cancelBinarize()
+{
+    if( m_binarizeJob.valid() )
+        free( m_binarizeJob.get() );
+
+    m_pendingThreshold = -1.0;
 }
 
 
@@ -637,6 +721,7 @@ void BM2CMP_FRAME::OnNegativeClicked( wxCommandEvent&  )
 {
     if( m_checkNegative->GetValue() != m_Negative )
     {
+        cancelBinarize();
         NegateGreyscaleImage();
 
         m_Greyscale_Bitmap = wxBitmap( m_Greyscale_Image );
@@ -650,8 +735,8 @@ void BM2CMP_FRAME::OnNegativeClicked( wxCommandEvent&  )
 
 void BM2CMP_FRAME::OnThresholdChange( wxScrollEvent& event )
 {
-    Binarize( (double)m_sliderThreshold->GetValue()/m_sliderThreshold->GetMax() );
-    Refresh();
+    // The slider is not blocked by big images: they are binarized on a background thread
+    startBinarize( (double)m_sliderThreshold->GetValue()/m_sliderThreshold->GetMax() );
 }
 
 
@@ -870,6 +955,10 @@ void BM2CMP_FRAME::exportPcbnewFormat()
 
 void BM2CMP_FRAME::ExportToBuffer( std::string& aOutput, OUTPUT_FMT_ID aFormat )
 {
+    // Export the image of the current threshold, when still binarized in the background
+    if( m_binarizeJob.valid() )
+        Binarize( (double)m_sliderThreshold->GetValue()/m_sliderThreshold->GetMax() );
+
     // Create a potrace bitmap
     int h = m_NB_Image.GetHeight();
     int w = m_NB_Image.GetWidth();
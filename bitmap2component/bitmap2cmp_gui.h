@@ -29,6 +29,8 @@
 #include <common.h> // for EDA_UNITS
 #include <potracelib.h>
 
+#include <future>
+
 
 class IMAGE_SIZE
 {
@@ -129,6 +131,21 @@ private:
     void OnExportLogo();
 
     void Binarize( double aThreshold ); // aThreshold = 0.0 (black level) to 1.0 (white level)
+
+    /**
+     * Binarize the greyscale image on a background thread, and show it when done.  While a
+     * binarization runs, only the last threshold asked for is kept, binarized after it.
+     */
+    void startBinarize( double aThreshold );
+
+    /// Show the image binarized on the background thread, and start the next one, if any
+    void onBinarizeDone();
+
+    /// Wait for the background binarization, dropping it and the threshold asked for after it
+    void cancelBinarize();
+
+    /// Show the binarized image aData (as allocated by malloc, owned by m_NB_Image then)
+    void setBinarizedImage( unsigned char* aData );
     void OnNegativeClicked( wxCommandEvent& event ) override;
     void OnThresholdChange( wxScrollEvent& event ) override;
 
@@ -171,5 +188,8 @@ private:
     bool       m_exportToClipboard;
     bool       m_AspectRatioLocked;
     double     m_AspectRatio;
+
+    std::future<unsigned char*> m_binarizeJob;      ///< the background binarization
+    double                      m_pendingThreshold; ///< to binarize after it, < 0 if none
 };
 #endif// BITMOP2CMP_GUI_H_
@@ -33,6 +33,7 @@
 
 #include <common.h>
 #include <layers_id_colors_and_visibility.h>
+#include <thread_pool.h>
 
 #include <potracelib.h>
 
@@ -53,6 +54,87 @@ static void bm_free( potrace_bitmap_t* bm )
 }
 
 
+/// The bitmaps are traced in bands of this many rows at least
+static const int MIN_BAND_HEIGHT = 256;
+
+
+/**
+ * @return true if the row aY of a potrace bitmap has no black pixel
+ */
+static bool isBlankRow( const potrace_bitmap_t* aBitmap, int aY )
+{
+    const potrace_word* row = aBitmap->map + (ptrdiff_t) aY * aBitmap->dy;
+
+    for( int ii = 0; ii < std::abs( aBitmap->dy ); ii++ )
+    {
+        if( row[ii] )
+            return false;
+    }
+
+    return true;
+}
+
+
+/// Rows of a potrace bitmap, traced together
+struct BITMAP_BAND
+{
+    int              m_Start;      ///< the first row, in the whole bitmap
+    potrace_bitmap_t m_Bitmap;     ///< a view of the rows, with the data of the whole bitmap
+};
+
+
+/**
+ * Split a potrace bitmap in about aCount bands of rows which can be traced separately.
+ *
+ * A band starts on a blank row: no shape is in two bands, so the paths of the bands are only
+ * to be moved to the position of their band, no seam to stitch.  A bitmap without blank row
+ * is a single band.
+ */
+static std::vector<BITMAP_BAND> splitBitmap( potrace_bitmap_t* aBitmap, size_t aCount )
+{
+    std::vector<BITMAP_BAND> bands;
+    int bandHeight = std::max( MIN_BAND_HEIGHT, aBitmap->h / (int) std::max<size_t>( aCount, 1 ) );
+    int start = 0;
+
+    auto addBand = [&]( int aEnd )
+    {
+        BITMAP_BAND band;
+        band.m_Start = start;
+        band.m_Bitmap = *aBitmap;
+        band.m_Bitmap.h = aEnd - start;
+        band.m_Bitmap.map = aBitmap->map + (ptrdiff_t) start * aBitmap->dy;
+        bands.push_back( band );
+        start = aEnd;
+    };
+
+    for( int y = bandHeight; y < aBitmap->h; y++ )
+    {
+        if( y - start >= bandHeight && isBlankRow( aBitmap, y ) )
+            addBand( y );
+    }
+
+    addBand( aBitmap->h );
+
+    return bands;
+}
+
+
+/**
+ * Move the paths traced in a band of a bitmap to their position in the bitmap.
+ */
+static void offsetPaths( potrace_path_t* aPaths, double aOffsetY )
+{
+    for( potrace_path_t* path = aPaths; path; path = path->next )
+    {
+        for( int ii = 0; ii < path->curve.n; ii++ )
+        {
+            for( int jj = 0; jj < 3; jj++ )
+                path->curve.c[ii][jj].y += aOffsetY;
+        }
+    }
+}
+
+
 static void BezierToPolyline( std::vector <potrace_dpoint_t>& aCornersBuffer,
                               potrace_dpoint_t                p1,
                               potrace_dpoint_t                p2,
@@ -68,7 +150,6 @@ BITMAPCONV_INFO::BITMAPCONV_INFO( std::string& aData ):
     m_PixmapHeight = 0;
     m_ScaleX  = 1.0;
     m_ScaleY  = 1.0;
-    m_Paths   = NULL;
     m_CmpName = "LOGO";
 }
 
@@ -78,7 +159,6 @@ int BITMAPCONV_INFO::ConvertBitmap( potrace_bitmap_t* aPotrace_bitmap,
                       BMP2CMP_MOD_LAYER aModLayer )
 {
     potrace_param_t* param;
-    potrace_state_t* st;
 
     // set tracing parameters, starting from defaults
     param = potrace_param_default();
@@ -96,15 +176,35 @@ int BITMAPCONV_INFO::ConvertBitmap( potrace_bitmap_t* aPotrace_bitmap,
                                 // Potrace default is 2
     param->opttolerance = 0.2;  // curve optimization tolerance. Potrace default is 0.2
 
-    /* convert the bitmap to curves */
-    st = potrace_trace( param, aPotrace_bitmap );
+    /* convert the bitmap to curves, each band of it on a thread */
+    std::vector<BITMAP_BAND> bands =
+            splitBitmap( aPotrace_bitmap, THREAD_POOL::GetInstance().GetThreadCount() );
+    std::vector<potrace_state_t*> states( bands.size(), nullptr );
 
-    if( !st || st->status != POTRACE_STATUS_OK )
+    THREAD_POOL::GetInstance().ParallelFor( bands.size(),
+            [&]( size_t aIndex )
+            {
+                states[aIndex] = potrace_trace( param, &bands[aIndex].m_Bitmap );
+            } );
+
+    auto freeStates = [&]()
     {
-        if( st )
+        for( potrace_state_t* st : states )
         {
-            potrace_state_free( st );
+            if( st )
+                potrace_state_free( st );
         }
+    };
+
+    bool traced = std::all_of( states.begin(), states.end(),
+                               []( potrace_state_t* st )
+                               {
+                                   return st && st->status == POTRACE_STATUS_OK;
+                               } );
+
+    if( !traced )
+    {
+        freeStates();
         potrace_param_free( param );
 
         char msg[256];
@@ -115,7 +215,15 @@ int BITMAPCONV_INFO::ConvertBitmap( potrace_bitmap_t* aPotrace_bitmap,
 
     m_PixmapWidth  = aPotrace_bitmap->w;
     m_PixmapHeight = aPotrace_bitmap->h;     // the bitmap size in pixels
-    m_Paths   = st->plist;
+    m_Paths.clear();
+
+    for( size_t ii = 0; ii < bands.size(); ii++ )
+    {
+        offsetPaths( states[ii]->plist, bands[ii].m_Start );
+
+        if( states[ii]->plist )
+            m_Paths.push_back( states[ii]->plist );
+    }
 
     switch( aFormat )
     {
@@ -154,7 +262,7 @@ int BITMAPCONV_INFO::ConvertBitmap( potrace_bitmap_t* aPotrace_bitmap,
 
 
     bm_free( aPotrace_bitmap );
-    potrace_state_free( st );
+    freeStates();
     potrace_param_free( param );
 
     return 0;
@@ -410,88 +518,89 @@ void BITMAPCONV_INFO::createOutputData( BMP2CMP_MOD_LAYER aModLayer )
     /* draw each as a polygon with no hole.
      * Bezier curves are approximated by a polyline
      */
-    potrace_path_t* paths = m_Paths;    // the list of paths
-
-    if(!m_Paths)
+    if( m_Paths.empty() )
     {
         m_errors += "No path in black and white image: no outline created\n";
     }
 
-    while( paths != NULL )
+    for( potrace_path_t* paths : m_Paths )
     {
-        int cnt  = paths->curve.n;
-        int* tag = paths->curve.tag;
-        c = paths->curve.c;
-        potrace_dpoint_t startpoint = c[cnt - 1][2];
-        for( int i = 0; i < cnt; i++ )
+        while( paths != NULL )
         {
-            switch( tag[i] )
+            int cnt  = paths->curve.n;
+            int* tag = paths->curve.tag;
+            c = paths->curve.c;
+            potrace_dpoint_t startpoint = c[cnt - 1][2];
+            for( int i = 0; i < cnt; i++ )
             {
-            case POTRACE_CORNER:
-                cornersBuffer.push_back( c[i][1] );
-                cornersBuffer.push_back( c[i][2] );
-                startpoint = c[i][2];
-                break;
-
-            case POTRACE_CURVETO:
-                BezierToPolyline( cornersBuffer, startpoint, c[i][0], c[i][1], c[i][2] );
-                startpoint = c[i][2];
-                break;
+                switch( tag[i] )
+                {
+                case POTRACE_CORNER:
+                    cornersBuffer.push_back( c[i][1] );
+                    cornersBuffer.push_back( c[i][2] );
+                    startpoint = c[i][2];
+                    break;
+
+                case POTRACE_CURVETO:
+                    BezierToPolyline( cornersBuffer, startpoint, c[i][0], c[i][1], c[i][2] );
+                    startpoint = c[i][2];
+                    break;
+                }
             }
-        }
 
-        // Store current path
-        if( main_outline )
-        {
-            main_outline = false;
-
-            // build the current main polygon
-            polyset_areas.NewOutline();
-            for( unsigned int i = 0; i < cornersBuffer.size(); i++ )
+            // Store current path
+            if( main_outline )
             {
-                polyset_areas.Append( int( cornersBuffer[i].x * m_ScaleX ),
-                                      int( cornersBuffer[i].y * m_ScaleY ) );
+                main_outline = false;
+
+                // build the current main polygon
+                polyset_areas.NewOutline();
+                for( unsigned int i = 0; i < cornersBuffer.size(); i++ )
+                {
+                    polyset_areas.Append( int( cornersBuffer[i].x * m_ScaleX ),
+                                          int( cornersBuffer[i].y * m_ScaleY ) );
+                }
             }
-        }
-        else
-        {
-            // Add current hole in polyset_holes
-            polyset_holes.NewOutline();
-            for( unsigned int i = 0; i < cornersBuffer.size(); i++ )
+            else
             {
-                polyset_holes.Append( int( cornersBuffer[i].x * m_ScaleX ),
-                                      int( cornersBuffer[i].y * m_ScaleY ) );
+                // Add current hole in polyset_holes
+                polyset_holes.NewOutline();
+                for( unsigned int i = 0; i < cornersBuffer.size(); i++ )
+                {
+                    polyset_holes.Append( int( cornersBuffer[i].x * m_ScaleX ),
+                                          int( cornersBuffer[i].y * m_ScaleY ) );
+                }
             }
-        }
 
-        cornersBuffer.clear();
-
-        /* at the end of a group of a positive path and its negative children, fill.
-         */
-        if( paths->next == NULL || paths->next->sign == '+' )
-        {
-            polyset_areas.Simplify( SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
-            polyset_holes.Simplify( SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
-            polyset_areas.BooleanSubtract( polyset_holes, SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
+            cornersBuffer.clear();
 
-            // Ensure there are no self intersecting polygons
-            polyset_areas.NormalizeAreaOutlines();
-
-            // Convert polygon with holes to a unique polygon
-            polyset_areas.Fracture( SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
-
-            // Output current resulting polygon(s)
-            for( int ii = 0; ii < polyset_areas.OutlineCount(); ii++ )
+            /* at the end of a group of a positive path and its negative children, fill.
+             */
+            if( paths->next == NULL || paths->next->sign == '+' )
             {
-                SHAPE_LINE_CHAIN& poly = polyset_areas.Outline( ii );
-                outputOnePolygon( poly, getBoardLayerName( aModLayer ));
+                polyset_areas.Simplify( SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
+                polyset_holes.Simplify( SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
+                polyset_areas.BooleanSubtract( polyset_holes, SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
+
+                // Ensure there are no self intersecting polygons
+                polyset_areas.NormalizeAreaOutlines();
+
+                // Convert polygon with holes to a unique polygon
+                polyset_areas.Fracture( SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
+
+                // Output current resulting polygon(s)
+                for( int ii = 0; ii < polyset_areas.OutlineCount(); ii++ )
+                {
+                    SHAPE_LINE_CHAIN& poly = polyset_areas.Outline( ii );
+                    outputOnePolygon( poly, getBoardLayerName( aModLayer ));
+                }
+
+                polyset_areas.RemoveAllContours();
+                polyset_holes.RemoveAllContours();
+                main_outline = true;
             }
-
-            polyset_areas.RemoveAllContours();
-            polyset_holes.RemoveAllContours();
-            main_outline = true;
+            paths = paths->next;
         }
-        paths = paths->next;
     }
 
     outputDataEnd();
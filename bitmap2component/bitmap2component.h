@@ -26,6 +26,7 @@
 
 #include <geometry/shape_poly_set.h>
 #include <potracelib.h>
+#include <vector>
 
 // for consistency this enum should conform to the
 // indices in m_radioBoxFormat from bitmap2cmp_gui.cpp
@@ -59,7 +60,8 @@ private:
     int m_PixmapHeight;             // the bitmap size in pixels
     double             m_ScaleX;
     double             m_ScaleY;    // the conversion scale
-    potrace_path_t*    m_Paths;     // the list of paths, from potrace (list of lines and bezier curves)
+    std::vector<potrace_path_t*> m_Paths;   // the lists of paths, from potrace (list of lines
+                                            // and bezier curves), one per traced band of rows
     std::string m_CmpName;          // The string used as cmp/footprint name
     std::string&  m_Data;           // the buffer containing the conversion
     std::string   m_errors;         // a buffer to return error messages
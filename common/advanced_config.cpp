@@ -80,6 +80,53 @@ static const wxChar RealtimeConnectivity[] = wxT( "RealtimeConnectivity" );
  */
 static const wxChar CoroutineStackSize[] = wxT( "CoroutineStackSize" );
 
+/**
+ * Number of threads drawing the cached items of the Cairo canvas, each one in its own band
+ * of the screen.  0 uses one thread per core, 1 draws the items without tiling
+ */
+static const wxChar CairoRenderThreads[] = wxT( "CairoRenderThreads" );
+
+/**
+ * Save the .kicad_pcb and .kicad_sch files gzip compressed, for the very big boards kept on
+ * network shares.  The files are recognized when opened, compressed or not, so this only
+ * changes how they are saved.  Off by default: the text files can be diffed
+ */
+static const wxChar CompressSavedFiles[] = wxT( "CompressSavedFiles" );
+
+/**
+ * Save the connections found between the copper items of a board in a .kicad_pcb-snapshot
+ * file next to it.  When the board is reopened unchanged, its connectivity is restored from
+ * the snapshot instead of searched, which takes a while on very big boards
+ */
+static const wxChar SaveConnectivitySnapshots[] = wxT( "SaveConnectivitySnapshots" );
+
+/**
+ * Number of worker threads running the parallel work (zone filling, connectivity, 3D
+ * rendering...).  0 uses one thread per core; set it lower to leave cores to other programs
+ */
+static const wxChar MaxThreads[] = wxT( "MaxThreads" );
+
+/**
+ * Keep the zone fills saved in the pcbnew undo and redo lists compressed, and uncompress them
+ * only when undoing or redoing.  A refill of big zones keeps all the old fills for its undo
+ */
+static const wxChar CompactUndoFills[] = wxT( "CompactUndoFills" );
+
+/**
+ * Record the timings of the loading, filling, DRC, connectivity and redrawing, and save them
+ * in this file when the application exits.  The file is a Chrome trace, opened by
+ * chrome://tracing or https://ui.perfetto.dev.  The KICAD_TRACE_EVENTS environment variable
+ * overrides it
+ */
+static const wxChar TraceEventsFile[] = wxT( "TraceEventsFile" );
+
+/**
+ * Estimate the memory held by the zone fills, undo history, GAL caches, connectivity, 3D
+ * models and library caches.  The estimates are shown by Help > Memory Usage and written on
+ * the KICAD_MEMORY trace
+ */
+static const wxChar MemoryAccounting[] = wxT( "MemoryAccounting" );
+
 } // namespace KEYS
 
 
@@ -160,6 +207,13 @@ ADVANCED_CFG::ADVANCED_CFG()
     m_EnableUsePadProperty = false;
     m_realTimeConnectivity = true;
     m_coroutineStackSize = AC_STACK::default_stack;
+    m_CairoRenderThreads = 0;
+    m_CompressSavedFiles = false;
+    m_SaveConnectivitySnapshots = false;
+    m_MaxThreads = 0;
+    m_CompactUndoFills = true;
+    m_TraceEventsFile = wxEmptyString;
+    m_MemoryAccounting = false;
 
     loadFromConfigFile();
 }
@@ -203,6 +257,27 @@ void ADVANCED_CFG::loadSettings( wxConfigBase& aCfg )
                                                &m_coroutineStackSize, AC_STACK::default_stack,
                                                AC_STACK::min_stack, AC_STACK::max_stack ) );
 
+    configParams.push_back( new PARAM_CFG_INT( true, AC_KEYS::CairoRenderThreads,
+                                               &m_CairoRenderThreads, 0, 0, 64 ) );
+
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::CompressSavedFiles,
+                                                &m_CompressSavedFiles, false ) );
+
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::SaveConnectivitySnapshots,
+                                                &m_SaveConnectivitySnapshots, false ) );
+
+    configParams.push_back( new PARAM_CFG_INT( true, AC_KEYS::MaxThreads,
+                                               &m_MaxThreads, 0, 0, 1024 ) );
+
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::CompactUndoFills,
+                                                &m_CompactUndoFills, true ) );
+
+    configParams.push_back( new PARAM_CFG_WXSTRING( true, AC_KEYS::TraceEventsFile,
+                                                    &m_TraceEventsFile, wxEmptyString ) );
+
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::MemoryAccounting,
+                                                &m_MemoryAccounting, false ) );
+
     wxConfigLoadSetups( &aCfg, configParams );
 
     for( auto param : configParams )
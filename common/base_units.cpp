@@ -34,6 +34,8 @@
  *       depending on the application.
  */
 
+#include <cmath>
+
 #include <base_units.h>
 #include <common.h>
 #include <math/util.h>      // for KiROUND
@@ -53,6 +55,88 @@
 #endif
 
 
+/**
+ * Writes aValue / 10^aDecimals to aBuf as a plain decimal number, without trailing zeros.
+ *
+ * This is exact, locale independent, and gives the same text as the %g format for numbers
+ * of up to 10 significant digits.  aBuf must hold at least 25 chars.
+ *
+ * @return the length of the text.
+ */
+static int formatDecimal( char* aBuf, long long aValue, int aDecimals )
+{
+    char                digits[24];
+    int                 count = 0;
+    int                 len = 0;
+    unsigned long long  magnitude = aValue < 0 ? 0ULL - (unsigned long long) aValue
+                                               : (unsigned long long) aValue;
+
+    do
+    {
+        digits[count++] = '0' + magnitude % 10;
+        magnitude /= 10;
+    } while( magnitude );
+
+    // Drop the trailing zeros of the fraction (all of them for 0)
+    int first = 0;
+
+    if( aValue == 0 )
+        aDecimals = 0;
+
+    while( aDecimals > 0 && digits[first] == '0' )
+    {
+        first++;
+        aDecimals--;
+    }
+
+    // Pad the fraction with leading zeros
+    while( count - first <= aDecimals )
+        digits[count++] = '0';
+
+    if( aValue < 0 )
+        aBuf[len++] = '-';
+
+    for( int i = count - 1; i >= first; i-- )
+    {
+        aBuf[len++] = digits[i];
+
+        if( i - first == aDecimals && aDecimals > 0 )
+            aBuf[len++] = '.';
+    }
+
+    aBuf[len] = '\0';
+    return len;
+}
+
+
+/**
+ * @return true if aValue is an integer smaller than aLimit (and not -0, printed as "-0").
+ */
+static bool isWholeNumber( double aValue, double aLimit )
+{
+    return fabs( aValue ) < aLimit && aValue == (double) (long long) aValue
+           && ( aValue != 0.0 || !std::signbit( aValue ) );
+}
+
+
+/**
+ * The number of decimals of a number in internal units, when IU_PER_MM is a power of 10
+ * (it is for all the applications).  -1 otherwise.
+ */
+static constexpr int iuDecimals( double aIuPerMm )
+{
+    int decimals = 0;
+
+    while( aIuPerMm >= 10.0 )
+    {
+        aIuPerMm /= 10.0;
+        decimals++;
+    }
+
+    return aIuPerMm == 1.0 ? decimals : -1;
+}
+
+
 // Helper function to print a float number without using scientific notation
 // and no trailing 0
 // So we cannot always just use the %g or the %f format to print a fp number
@@ -64,7 +148,12 @@ std::string Double2Str( double aValue )
     char    buf[50];
     int     len;
 
-    if( aValue != 0.0 && fabs( aValue ) <= 0.0001 )
+    // Integers are printed as they are by %g, without the locale dependent sprintf()
+    if( isWholeNumber( aValue, 1e15 ) )
+    {
+        len = formatDecimal( buf, (long long) aValue, 0 );
+    }
+    else if( aValue != 0.0 && fabs( aValue ) <= 0.0001 )
     {
         // For these small values, %f works fine,
         // and %g gives an exponent
@@ -534,6 +623,16 @@ std::string FormatInternalUnits( int aValue )
     double  engUnits = aValue;
     int     len;
 
+    // An int has at most 10 digits: it is printed exactly as by the formats below, which
+    // never use an exponent for it
+    constexpr int decimals = iuDecimals( IU_PER_MM );
+
+    if( decimals >= 0 )
+    {
+        len = formatDecimal( buf, aValue, decimals );
+        return std::string( buf, len );
+    }
+
     engUnits /= IU_PER_MM;
 
     if( engUnits != 0.0 && fabs( engUnits ) <= 0.0001 )
@@ -562,7 +661,11 @@ std::string FormatAngle( double aAngle )
     char temp[50];
     int len;
 
-    len = snprintf( temp, sizeof(temp), "%.10g", aAngle / 10.0 );
+    // Angles are mostly whole tenths of degree, printed exactly by %.10g up to 1e9 tenths
+    if( isWholeNumber( aAngle, 1e9 ) )
+        len = formatDecimal( temp, (long long) aAngle, 1 );
+    else
+        len = snprintf( temp, sizeof(temp), "%.10g", aAngle / 10.0 );
 
     return std::string( temp, len );
 }
@@ -31,6 +31,7 @@
 #include <gal/color4d.h>  // for COLOR4D
 #include <gr_basic.h>
 #include <math/util.h>      // for KiROUND
+#include <atomic>
 #include <memory>         // for make_unique, unique_ptr
 #include <plotter.h>
 #include <richio.h>
@@ -50,6 +51,7 @@ BITMAP_BASE::BITMAP_BASE( const wxPoint& pos )
     m_ppi    = 300;                 // the bitmap definition. the default is 300PPI
     m_pixelScaleFactor = 254000.0 / m_ppi;    // a value OK for bitmaps using 300 PPI
                                               // for Eeschema which uses currently 254000PPI
+    updateImageId();
 }
 
 
@@ -67,6 +69,16 @@ BITMAP_BASE::BITMAP_BASE( const BITMAP_BASE& aSchBitmap )
         m_image = new wxImage( *aSchBitmap.m_image );
         m_bitmap = new wxBitmap( *m_image );
     }
+
+    updateImageId();
+}
+
+
+void BITMAP_BASE::updateImageId()
+{
+    static std::atomic<int> s_nextImageId( 1 );
+
+    m_imageId = s_nextImageId++;
 }
 
 
@@ -81,6 +93,7 @@ void BITMAP_BASE::ImportData( BITMAP_BASE* aItem )
     m_scale   = aItem->m_scale;
     m_ppi     = aItem->m_ppi;
     m_pixelScaleFactor = aItem->m_pixelScaleFactor;
+    updateImageId();
 }
 
 
@@ -96,6 +109,7 @@ bool BITMAP_BASE::ReadImageFile( wxInputStream& aInStream )
     delete m_image;
     m_image = new_image.release();
     m_bitmap = new wxBitmap( *m_image );
+    updateImageId();
 
     return true;
 }
@@ -114,6 +128,7 @@ bool BITMAP_BASE::ReadImageFile( const wxString& aFullFilename )
     delete m_image;
     m_image  = new_image;
     m_bitmap = new wxBitmap( *m_image );
+    updateImageId();
 
     return true;
 }
@@ -203,6 +218,7 @@ bool BITMAP_BASE::LoadData( LINE_READER& aLine, wxString& aErrorMsg )
             wxMemoryInputStream istream( stream );
             m_image->LoadFile( istream, wxBITMAP_TYPE_PNG );
             m_bitmap = new wxBitmap( *m_image );
+            updateImageId();
             break;
         }
 
@@ -45,6 +45,10 @@ using KIGFX::COLOR4D;
 // Create only once, as seeding is *very* expensive
 static boost::uuids::random_generator randomGenerator;
 
+// The random generator is not thread-safe, and items (such as DRC markers) may be created
+// from worker threads
+static std::mutex randomGeneratorMutex;
+
 // These don't have the same performance penalty, but might as well be consistent
 static boost::uuids::string_generator stringGenerator;
 static boost::uuids::nil_generator nilGenerator;
@@ -54,9 +58,10 @@ KIID niluuid( 0 );
 
 
 KIID::KIID() :
-        m_uuid( randomGenerator() ),
         m_cached_timestamp( 0 )
 {
+    std::lock_guard<std::mutex> lock( randomGeneratorMutex );
+    m_uuid = randomGenerator();
 }
 
 
@@ -98,6 +103,7 @@ KIID::KIID( const wxString& aString ) :
         {
             // Failed to parse string representation; best we can do is assign a new
             // random one.
+            std::lock_guard<std::mutex> lock( randomGeneratorMutex );
             m_uuid = randomGenerator();
         }
     }
@@ -171,6 +177,8 @@ void KIID::ConvertTimestampToUuid()
     if( !IsLegacyTimestamp() )
         return;
 
+    std::lock_guard<std::mutex> lock( randomGeneratorMutex );
+
     m_cached_timestamp = 0;
     m_uuid = randomGenerator();
 }
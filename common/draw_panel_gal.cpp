@@ -42,9 +42,11 @@
 #include <tool/tool_dispatcher.h>
 #include <tool/tool_manager.h>
 
-#ifdef PROFILE
 #include <profile.h>
-#endif /* PROFILE */
+#include <trace_events.h>
+#include <trace_helpers.h>
+
+#include <algorithm>
 
 
 EDA_DRAW_PANEL_GAL::EDA_DRAW_PANEL_GAL( wxWindow* aParentWindow, wxWindowID aWindowId,
@@ -60,7 +62,12 @@ EDA_DRAW_PANEL_GAL::EDA_DRAW_PANEL_GAL( wxWindow* aParentWindow, wxWindowID aWin
           m_options( aOptions ),
           m_eventDispatcher( nullptr ),
           m_lostFocus( false ),
-          m_stealsFocus( true )
+          m_stealsFocus( true ),
+          m_showFrameStats( false ),
+          m_updateItemsTime( 0.0 ),
+          m_clearTargetsTime( 0.0 ),
+          m_redrawTime( 0.0 ),
+          m_frameTime( 0.0 )
 {
     m_parent        = aParentWindow;
     m_currentCursor = wxStockCursor( wxCURSOR_ARROW );
@@ -158,6 +165,8 @@ void EDA_DRAW_PANEL_GAL::SetFocus()
 
 void EDA_DRAW_PANEL_GAL::onPaint( wxPaintEvent& WXUNUSED( aEvent ) )
 {
+    TRACE_SCOPE trace( "redraw" );
+
     // Update current zoom settings if the canvas is managed by a EDA frame
     // (i.e. not by a preview panel in a dialog)
     if( GetParentEDAFrame() && GetParentEDAFrame()->GetScreen() )
@@ -176,9 +185,10 @@ void EDA_DRAW_PANEL_GAL::onPaint( wxPaintEvent& WXUNUSED( aEvent ) )
     if( m_drawing )
         return;
 
-#ifdef PROFILE
     PROF_COUNTER totalRealTime;
-#endif /* PROFILE */
+    double       updateItemsTime = 0.0;
+    double       clearTargetsTime = 0.0;
+    double       redrawTime = 0.0;
 
     wxASSERT( m_painter );
 
@@ -187,10 +197,16 @@ void EDA_DRAW_PANEL_GAL::onPaint( wxPaintEvent& WXUNUSED( aEvent ) )
 
     try
     {
+        PROF_COUNTER updateItemsCnt;
         m_view->UpdateItems();
+        updateItemsTime = updateItemsCnt.msecs();
 
         KIGFX::GAL_DRAWING_CONTEXT ctx( m_gal );
 
+        // The statistics change on every frame
+        if( m_showFrameStats )
+            m_view->MarkTargetDirty( KIGFX::TARGET_OVERLAY );
+
         m_gal->SetClearColor( settings->GetBackgroundColor() );
         m_gal->SetGridColor( settings->GetGridColor() );
         m_gal->SetCursorColor( settings->GetCursorColor() );
@@ -207,15 +223,22 @@ void EDA_DRAW_PANEL_GAL::onPaint( wxPaintEvent& WXUNUSED( aEvent ) )
                 m_view->IsTargetDirty( KIGFX::TARGET_NONCACHED ) )
                 m_gal->ClearScreen();
 
+            PROF_COUNTER clearTargetsCnt;
             m_view->ClearTargets();
+            clearTargetsTime = clearTargetsCnt.msecs();
 
             // Grid has to be redrawn only when the NONCACHED target is redrawn
             if( m_view->IsTargetDirty( KIGFX::TARGET_NONCACHED ) )
                 m_gal->DrawGrid();
 
+            PROF_COUNTER redrawCnt;
             m_view->Redraw();
+            redrawTime = redrawCnt.msecs();
         }
 
+        if( m_showFrameStats )
+            drawFrameStats();
+
         m_gal->DrawCursor( m_viewControls->GetCursorPosition() );
     }
     catch( std::runtime_error& err )
@@ -229,16 +252,108 @@ void EDA_DRAW_PANEL_GAL::onPaint( wxPaintEvent& WXUNUSED( aEvent ) )
                             wxString( err.what() ) );
     }
 
-#ifdef PROFILE
     totalRealTime.Stop();
-    wxLogTrace( "GAL_PROFILE", "EDA_DRAW_PANEL_GAL::onPaint(): %.1f ms", totalRealTime.msecs() );
-#endif /* PROFILE */
+
+    m_updateItemsTime = updateItemsTime;
+    m_clearTargetsTime = clearTargetsTime;
+    m_redrawTime = redrawTime;
+    m_frameTime = totalRealTime.msecs();
+
+    // frame, update items, clear targets, redraw, end drawing, GPU items, GPU compositing (ms),
+    // cached items memory (bytes)
+    const KIGFX::GAL_FRAME_STATS& stats = m_gal->GetFrameStats();
+
+    wxLogTrace( traceGalProfile, "%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%llu", m_frameTime,
+                m_updateItemsTime, m_clearTargetsTime, m_redrawTime, stats.m_endDrawingTime,
+                stats.m_gpuItemsTime, stats.m_gpuCompositingTime,
+                (unsigned long long) stats.m_cacheMemory );
 
     m_lastRefresh = wxGetLocalTimeMillis();
     m_drawing = false;
 }
 
 
+void EDA_DRAW_PANEL_GAL::drawFrameStats()
+{
+    const KIGFX::GAL_FRAME_STATS& stats = m_gal->GetFrameStats();
+    std::vector<wxString>         lines;
+
+    auto gpuTime = []( double aTime )
+    {
+        return aTime < 0.0 ? wxString( "n/a" ) : wxString::Format( "%.2f ms", aTime );
+    };
+
+    lines.push_back( wxString::Format( _( "Frame: %.2f ms" ), m_frameTime ) );
+    lines.push_back( wxString::Format( _( "Update items: %.2f ms" ), m_updateItemsTime ) );
+    lines.push_back( wxString::Format( _( "Clear targets: %.2f ms" ), m_clearTargetsTime ) );
+    lines.push_back( wxString::Format( _( "Redraw: %.2f ms" ), m_redrawTime ) );
+    lines.push_back( wxString::Format( _( "End drawing: %.2f ms" ), stats.m_endDrawingTime ) );
+    lines.push_back( _( "GPU items: " ) + gpuTime( stats.m_gpuItemsTime ) );
+    lines.push_back( _( "GPU compositing: " ) + gpuTime( stats.m_gpuCompositingTime ) );
+    lines.push_back( wxString::Format( _( "Cached items: %.1f MB" ),
+                                       stats.m_cacheMemory / ( 1024.0 * 1024.0 ) ) );
+
+    // The layers with the most drawn items
+    std::vector<std::pair<int, int>> counts( m_view->GetDrawnItemCounts().begin(),
+                                             m_view->GetDrawnItemCounts().end() );
+    int total = 0;
+
+    for( const std::pair<int, int>& count : counts )
+        total += count.second;
+
+    std::sort( counts.begin(), counts.end(),
+            []( const std::pair<int, int>& a, const std::pair<int, int>& b )
+            {
+                return a.second > b.second;
+            } );
+
+    lines.push_back( wxString::Format( _( "Drawn items: %d" ), total ) );
+
+    for( size_t i = 0; i < std::min<size_t>( counts.size(), 5 ); ++i )
+    {
+        lines.push_back( wxString::Format( _( "  layer %d: %d" ), counts[i].first,
+                                           counts[i].second ) );
+    }
+
+    const double glyphHeight = 12.0;    // pixels
+    const double linePitch = glyphHeight * 1.4;
+    double       worldScale = m_gal->GetWorldScale();
+    bool         flipX = m_view->IsMirroredX();
+
+    m_gal->SetTarget( KIGFX::TARGET_OVERLAY );
+    m_gal->Save();
+    m_gal->SetGlyphSize( VECTOR2D( glyphHeight / worldScale, glyphHeight / worldScale ) );
+    m_gal->SetLineWidth( 1.5 / worldScale );
+    m_gal->SetHorizontalJustify( flipX ? GR_TEXT_HJUSTIFY_RIGHT : GR_TEXT_HJUSTIFY_LEFT );
+    m_gal->SetVerticalJustify( GR_TEXT_VJUSTIFY_TOP );
+    m_gal->SetIsFill( false );
+    m_gal->SetIsStroke( true );
+    m_gal->SetStrokeColor( m_painter->GetSettings()->GetCursorColor() );
+
+    for( size_t i = 0; i < lines.size(); ++i )
+    {
+        VECTOR2D pos = m_view->ToWorld( VECTOR2D( 10.0, 10.0 + i * linePitch ) );
+        m_gal->BitmapText( lines[i], pos, 0.0 );
+    }
+
+    m_gal->Restore();
+    m_gal->SetTarget( KIGFX::TARGET_NONCACHED );
+}
+
+
+void EDA_DRAW_PANEL_GAL::SetShowFrameStats( bool aShow )
+{
+    m_showFrameStats = aShow;
+    m_gal->SetCollectFrameStats( aShow );
+
+    // Clear the statistics of the last frame off the overlay
+    if( m_view )
+        m_view->MarkTargetDirty( KIGFX::TARGET_OVERLAY );
+
+    Refresh();
+}
+
+
 void EDA_DRAW_PANEL_GAL::onSize( wxSizeEvent& aEvent )
 {
     KIGFX::GAL_CONTEXT_LOCKER locker( m_gal );
@@ -447,6 +562,8 @@ bool EDA_DRAW_PANEL_GAL::SwitchBackend( GAL_TYPE aGalType )
         m_view->ReverseDrawOrder( aGalType == GAL_TYPE_OPENGL );
     }
 
+    m_gal->SetCollectFrameStats( m_showFrameStats );
+
     m_backend = aGalType;
 
     return result;
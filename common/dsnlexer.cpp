@@ -24,10 +24,16 @@
  */
 
 
+#include <algorithm>
 #include <cstdarg>
 #include <cstdio>
 #include <cstdlib>         // bsearch()
 #include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
 
 #include <macros.h>
 #include <fctsys.h>
@@ -39,6 +45,161 @@
 #define FMT_CLIPBOARD       _( "clipboard" )
 
 
+//-----<KEYWORD_HASH>---------------------------------------------------------
+
+/**
+ * KEYWORD_HASH
+ * is a perfect hash of a keywords table: a token is looked up with a single probe and a
+ * single compare, without allocating nor hashing a std::string.
+ * <p>
+ * It is built with the "hash and displace" method.  The keywords are spread over buckets by
+ * a first hash, then each bucket, the largest first, gets the seed of a second hash which
+ * sends all its keywords to free slots of the table.  The table is built once for each
+ * keywords table, and shared by all the lexers using it.
+ */
+class KEYWORD_HASH
+{
+public:
+    KEYWORD_HASH( const KEYWORD* aKeywords, unsigned aCount );
+
+    /**
+     * Function ForTable
+     * returns the hash of @a aKeywords, built on the first call for this table.
+     */
+    static const KEYWORD_HASH& ForTable( const KEYWORD* aKeywords, unsigned aCount );
+
+    int Find( const char* aText, size_t aLength ) const
+    {
+        uint32_t bucket = hash( aText, aLength, 0 ) % m_seeds.size();
+        uint32_t slot = hash( aText, aLength, m_seeds[bucket] ) & m_mask;
+
+        const KEYWORD* keyword = m_slots[slot];
+
+        if( keyword && m_lengths[slot] == aLength && !memcmp( keyword->name, aText, aLength ) )
+            return keyword->token;
+
+        return DSN_SYMBOL;      // not a keyword, some arbitrary symbol.
+    }
+
+private:
+    /// FNV-1a, with a final mix so the low bits can be used as a slot index
+    static uint32_t hash( const char* aText, size_t aLength, uint32_t aSeed )
+    {
+        uint32_t h = 2166136261u ^ ( aSeed * 0x9e3779b9u );
+
+        for( size_t i = 0; i < aLength; ++i )
+        {
+            h ^= (unsigned char) aText[i];
+            h *= 16777619u;
+        }
+
+        h ^= h >> 16;
+        h *= 0x85ebca6bu;
+        h ^= h >> 13;
+        h *= 0xc2b2ae35u;
+        h ^= h >> 16;
+
+        return h;
+    }
+
+    uint32_t                    m_mask;
+    std::vector<uint32_t>       m_seeds;        ///< second hash seed of each bucket
+    std::vector<const KEYWORD*> m_slots;
+    std::vector<size_t>         m_lengths;      ///< length of the keyword in each slot
+};
+
+
+KEYWORD_HASH::KEYWORD_HASH( const KEYWORD* aKeywords, unsigned aCount )
+{
+    // Half empty slots make the seeds quick to find
+    size_t size = 1;
+
+    while( size < 2 * aCount )
+        size <<= 1;
+
+    m_mask = size - 1;
+    m_slots.assign( size, nullptr );
+    m_lengths.assign( size, 0 );
+    m_seeds.assign( std::max<size_t>( aCount / 4, 1 ), 0 );
+
+    std::vector<std::vector<const KEYWORD*>> buckets( m_seeds.size() );
+
+    for( unsigned i = 0; i < aCount; ++i )
+    {
+        const KEYWORD* keyword = &aKeywords[i];
+
+        buckets[hash( keyword->name, strlen( keyword->name ), 0 ) % m_seeds.size()]
+                .push_back( keyword );
+    }
+
+    std::vector<size_t> order( buckets.size() );
+
+    for( size_t i = 0; i < order.size(); ++i )
+        order[i] = i;
+
+    std::stable_sort( order.begin(), order.end(),
+            [&]( size_t a, size_t b )
+            {
+                return buckets[a].size() > buckets[b].size();
+            } );
+
+    std::vector<uint32_t> slots;
+
+    for( size_t b : order )
+    {
+        if( buckets[b].empty() )
+            break;
+
+        // Keywords appearing twice in the table would never fit
+        const uint32_t maxSeed = 1 << 20;
+        uint32_t       seed;
+
+        for( seed = 1; seed < maxSeed; ++seed )
+        {
+            slots.clear();
+
+            for( const KEYWORD* keyword : buckets[b] )
+            {
+                uint32_t slot = hash( keyword->name, strlen( keyword->name ), seed ) & m_mask;
+
+                if( m_slots[slot] || std::find( slots.begin(), slots.end(), slot ) != slots.end() )
+                    break;
+
+                slots.push_back( slot );
+            }
+
+            if( slots.size() == buckets[b].size() )
+                break;
+        }
+
+        wxCHECK2_MSG( seed < maxSeed, continue, "Duplicate keywords in a lexer table" );
+
+        m_seeds[b] = seed;
+
+        for( size_t i = 0; i < slots.size(); ++i )
+        {
+            m_slots[slots[i]] = buckets[b][i];
+            m_lengths[slots[i]] = strlen( buckets[b][i]->name );
+        }
+    }
+}
+
+
+const KEYWORD_HASH& KEYWORD_HASH::ForTable( const KEYWORD* aKeywords, unsigned aCount )
+{
+    static std::mutex lock;
+    static std::map<std::pair<const KEYWORD*, unsigned>, std::unique_ptr<KEYWORD_HASH>> hashes;
+
+    std::lock_guard<std::mutex> guard( lock );
+    std::unique_ptr<KEYWORD_HASH>& table = hashes[ std::make_pair( aKeywords, aCount ) ];
+
+    if( !table )
+        table.reset( new KEYWORD_HASH( aKeywords, aCount ) );
+
+    return *table;
+}
+
+
 //-----<DSNLEXER>-------------------------------------------------------------
 
 void DSNLEXER::init()
@@ -54,22 +215,7 @@ void DSNLEXER::init()
 
     curOffset = 0;
 
-#if 1
-    if( keywordCount > 11 )
-    {
-        // resize the hashtable bucket count
-        keyword_hash.reserve( keywordCount );
-    }
-
-    // fill the specialized "C string" hashtable from keywords[]
-    const KEYWORD*  it  = keywords;
-    const KEYWORD*  end = it + keywordCount;
-
-    for( ; it < end; ++it )
-    {
-        keyword_hash[it->name] = it->token;
-    }
-#endif
+    keywordHash = &KEYWORD_HASH::ForTable( keywords, keywordCount );
 }
 
 
@@ -259,11 +405,7 @@ int DSNLEXER::findToken( const std::string& tok )
 
 inline int DSNLEXER::findToken( const std::string& tok )
 {
-    KEYWORD_MAP::const_iterator it = keyword_hash.find( tok.c_str() );
-    if( it != keyword_hash.end() )
-        return it->second;
-
-    return DSN_SYMBOL;      // not a keyword, some arbitrary symbol.
+    return keywordHash->Find( tok.data(), tok.size() );
 }
 #endif
 
@@ -437,6 +579,58 @@ int DSNLEXER::NeedNUMBER( const char* aExpectation )
 }
 
 
+void DSNLEXER::readListText( std::string& aText )
+{
+    const char* begin = next;
+    const char* cur = next;
+    int         depth = 1;
+
+    for( ;; )
+    {
+        bool inString = false;
+
+        for( ; cur < limit && depth > 0; ++cur )
+        {
+            if( inString )
+            {
+                if( *cur == '\\' && cur + 1 < limit )
+                    ++cur;
+                else if( *cur == '"' )
+                    inString = false;
+            }
+            else if( *cur == '"' )
+                inString = true;
+            else if( *cur == '(' )
+                ++depth;
+            else if( *cur == ')' )
+                --depth;
+        }
+
+        aText.append( begin, cur );
+
+        if( depth == 0 )
+            break;
+
+        if( readLine() == 0 )
+        {
+            THROW_PARSE_ERROR( _( "Unexpected end of file" ), CurSource(), CurLine(),
+                               CurLineNumber(), CurOffset() );
+        }
+
+        begin = start;
+        cur = start;
+
+        while( cur < limit && isspace( (unsigned char) *cur ) )
+            ++cur;
+
+        if( cur < limit && *cur == '#' )
+            cur = limit;
+    }
+
+    next = cur;
+}
+
+
 /**
  * Function isSpace
  * tests for whitespace.  Our whitespace, by our definition, is a subset of ASCII,
@@ -697,7 +891,15 @@ L_read:
                 }
 
                 else
-                    curText += *head++;
+                {
+                    // copy the plain characters up to the next escape or quote at once
+                    const char* run = head;
+
+                    while( head<limit && *head != '\\' && *head != '"' )
+                        ++head;
+
+                    curText.append( run, head );
+                }
 
             }   // while
 
@@ -777,11 +979,11 @@ L_read:
     }           // specctraMode
 
     // non-quoted token, read it into curText.
-    curText.clear();
-
     head = cur;
     while( head<limit && !isSep( *head ) )
-        curText += *head++;
+        ++head;
+
+    curText.assign( cur, head );
 
     if( isNumber( curText.c_str(), curText.c_str() + curText.size() ) )
     {
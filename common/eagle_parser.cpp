@@ -30,6 +30,7 @@
 #include <sstream>
 #include <iomanip>
 #include <cstdio>
+#include <cstring>
 
 constexpr auto DEFAULT_ALIGNMENT = ETEXT::BOTTOM_LEFT;
 
@@ -260,6 +261,503 @@ NODE_MAP MapChildren( wxXmlNode* aCurrentNode )
 }
 
 
+void EAGLE_XML_READER::OnElement( const wxString& aPath, ELEMENT_HANDLER aHandler )
+{
+    m_elementHandlers[aPath] = std::move( aHandler );
+}
+
+
+void EAGLE_XML_READER::OnStart( const wxString& aPath, START_HANDLER aHandler )
+{
+    m_startHandlers[aPath] = std::move( aHandler );
+}
+
+
+void EAGLE_XML_READER::Parse( const wxString& aFileName )
+{
+    std::unique_ptr<FILE, int (*)( FILE* )> file( wxFopen( aFileName, "rb" ), &fclose );
+
+    if( !file )
+        THROW_IO_ERROR( wxString::Format( _( "Unable to read file \"%s\"" ), aFileName ) );
+
+    m_file = file.get();
+    m_buffer.resize( 64 * 1024 );
+    m_bufferPos = 0;
+    m_bufferLen = 0;
+    m_line = 1;
+    m_path.clear();
+    m_open.clear();
+    m_root.reset();
+
+    int c;
+
+    while( ( c = getChar() ) != EOF )
+    {
+        if( c != '<' )
+        {
+            readText( c );
+        }
+        else if( peekChar() == '/' )
+        {
+            getChar();
+            readEndTag();
+        }
+        else if( peekChar() == '?' )
+        {
+            if( !skipPast( "?>" ) )
+                error( "unterminated processing instruction" );
+        }
+        else if( peekChar() == '!' )
+        {
+            getChar();
+
+            if( peekChar() == '-' )
+            {
+                getChar();
+
+                if( getChar() != '-' || !skipPast( "-->" ) )
+                    error( "malformed comment" );
+            }
+            else if( peekChar() == '[' )
+            {
+                for( const char* p = "[CDATA["; *p; ++p )
+                {
+                    if( getChar() != *p )
+                        error( "malformed CDATA section" );
+                }
+
+                readCData();
+            }
+            else
+            {
+                skipDeclaration();
+            }
+        }
+        else
+        {
+            readStartTag();
+        }
+    }
+
+    m_file = nullptr;
+
+    if( !m_open.empty() )
+        error( wxString::Format( "unexpected end of file in <%s>", m_open.back().m_name ) );
+}
+
+
+bool EAGLE_XML_READER::fillBuffer()
+{
+    if( m_bufferPos < m_bufferLen )
+        return true;
+
+    m_bufferLen = fread( m_buffer.data(), 1, m_buffer.size(), m_file );
+    m_bufferPos = 0;
+
+    return m_bufferLen > 0;
+}
+
+
+int EAGLE_XML_READER::getChar()
+{
+    if( !fillBuffer() )
+        return EOF;
+
+    int c = (unsigned char) m_buffer[m_bufferPos++];
+
+    // End of lines are all read as '\n', as required by XML
+    if( c == '\r' )
+    {
+        if( peekChar() == '\n' )
+            m_bufferPos++;
+
+        c = '\n';
+    }
+
+    if( c == '\n' )
+        m_line++;
+
+    return c;
+}
+
+
+int EAGLE_XML_READER::peekChar()
+{
+    if( !fillBuffer() )
+        return EOF;
+
+    return (unsigned char) m_buffer[m_bufferPos];
+}
+
+
+bool EAGLE_XML_READER::skipPast( const char* aEnd )
+{
+    size_t      len = strlen( aEnd );
+    std::string tail;
+    int         c;
+
+    while( ( c = getChar() ) != EOF )
+    {
+        tail += (char) c;
+
+        if( tail.size() > len )
+            tail.erase( 0, 1 );
+
+        if( tail == aEnd )
+            return true;
+    }
+
+    return false;
+}
+
+
+void EAGLE_XML_READER::skipDeclaration()
+{
+    // <!DOCTYPE ...>, with an optional internal subset between brackets
+    int  depth = 0;
+    int  quote = 0;
+    int  c;
+
+    while( ( c = getChar() ) != EOF )
+    {
+        if( quote )
+        {
+            if( c == quote )
+                quote = 0;
+        }
+        else if( c == '"' || c == '\'' )
+        {
+            quote = c;
+        }
+        else if( c == '[' )
+        {
+            depth++;
+        }
+        else if( c == ']' )
+        {
+            depth--;
+        }
+        else if( c == '>' && depth <= 0 )
+        {
+            return;
+        }
+    }
+
+    error( "unterminated declaration" );
+}
+
+
+static bool isXmlSpace( int c )
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+
+static bool isNameEnd( int c )
+{
+    return c == EOF || isXmlSpace( c ) || c == '/' || c == '>' || c == '=';
+}
+
+
+std::string EAGLE_XML_READER::readName( int aFirst )
+{
+    if( isNameEnd( aFirst ) )
+        error( "missing name" );
+
+    std::string name( 1, (char) aFirst );
+
+    while( !isNameEnd( peekChar() ) )
+        name += (char) getChar();
+
+    return name;
+}
+
+
+void EAGLE_XML_READER::readEntity( std::string& aText )
+{
+    std::string entity;
+    int         c;
+
+    while( ( c = getChar() ) != ';' )
+    {
+        if( c == EOF || entity.size() > 10 )
+            error( "malformed entity" );
+
+        entity += (char) c;
+    }
+
+    if( entity == "amp" )
+        aText += '&';
+    else if( entity == "lt" )
+        aText += '<';
+    else if( entity == "gt" )
+        aText += '>';
+    else if( entity == "quot" )
+        aText += '"';
+    else if( entity == "apos" )
+        aText += '\'';
+    else if( entity.size() > 1 && entity[0] == '#' )
+    {
+        bool          hex = entity[1] == 'x';
+        unsigned long code = strtoul( entity.c_str() + ( hex ? 2 : 1 ), nullptr, hex ? 16 : 10 );
+
+        // UTF-8 encoding of the character
+        if( code < 0x80 )
+        {
+            aText += (char) code;
+        }
+        else if( code < 0x800 )
+        {
+            aText += (char) ( 0xC0 | ( code >> 6 ) );
+            aText += (char) ( 0x80 | ( code & 0x3F ) );
+        }
+        else if( code < 0x10000 )
+        {
+            aText += (char) ( 0xE0 | ( code >> 12 ) );
+            aText += (char) ( 0x80 | ( ( code >> 6 ) & 0x3F ) );
+            aText += (char) ( 0x80 | ( code & 0x3F ) );
+        }
+        else
+        {
+            aText += (char) ( 0xF0 | ( code >> 18 ) );
+            aText += (char) ( 0x80 | ( ( code >> 12 ) & 0x3F ) );
+            aText += (char) ( 0x80 | ( ( code >> 6 ) & 0x3F ) );
+            aText += (char) ( 0x80 | ( code & 0x3F ) );
+        }
+    }
+    else
+    {
+        error( wxString::Format( "unknown entity &%s;", wxString::FromUTF8( entity.c_str() ) ) );
+    }
+}
+
+
+std::string EAGLE_XML_READER::readAttributeValue( bool aDecode )
+{
+    std::string value;
+    int         quote = getChar();
+    int         c;
+
+    if( quote != '"' && quote != '\'' )
+        error( "missing attribute value" );
+
+    while( ( c = getChar() ) != quote )
+    {
+        if( c == EOF || c == '<' )
+            error( "unterminated attribute value" );
+
+        if( !aDecode )
+            continue;
+
+        if( c == '&' )
+            readEntity( value );
+        else
+            value += isXmlSpace( c ) ? ' ' : (char) c;
+    }
+
+    return value;
+}
+
+
+void EAGLE_XML_READER::readStartTag()
+{
+    wxString name = wxString::FromUTF8( readName( getChar() ).c_str() );
+    wxString path = m_path.IsEmpty() ? name : m_path + "/" + name;
+    bool     building = m_root != nullptr;
+
+    auto elementIt = building ? m_elementHandlers.end() : m_elementHandlers.find( path );
+    auto startIt = building ? m_startHandlers.end() : m_startHandlers.find( path );
+
+    bool wanted = building || elementIt != m_elementHandlers.end()
+                  || startIt != m_startHandlers.end();
+
+    std::unique_ptr<wxXmlNode> node;
+    int                        c;
+
+    if( wanted )
+    {
+        node.reset( new wxXmlNode( nullptr, wxXML_ELEMENT_NODE, name, wxEmptyString, nullptr,
+                                   nullptr, m_line ) );
+    }
+
+    // The attributes, up to the end of the tag
+    for( ;; )
+    {
+        while( isXmlSpace( peekChar() ) )
+            getChar();
+
+        c = getChar();
+
+        if( c == '>' || c == '/' )
+            break;
+
+        if( c == EOF )
+            error( wxString::Format( "unterminated tag <%s>", name ) );
+
+        std::string attrName = readName( c );
+
+        while( isXmlSpace( peekChar() ) )
+            getChar();
+
+        if( getChar() != '=' )
+            error( wxString::Format( "missing value of attribute %s",
+                                     wxString::FromUTF8( attrName.c_str() ) ) );
+
+        while( isXmlSpace( peekChar() ) )
+            getChar();
+
+        std::string value = readAttributeValue( wanted );
+
+        if( node )
+            node->AddAttribute( wxString::FromUTF8( attrName.c_str() ),
+                                wxString::FromUTF8( value.c_str() ) );
+    }
+
+    bool empty = c == '/';
+
+    if( empty && getChar() != '>' )
+        error( wxString::Format( "malformed tag <%s>", name ) );
+
+    if( startIt != m_startHandlers.end() )
+        startIt->second( *node );
+
+    OPEN_ELEMENT open = { name, m_path.length(), nullptr, nullptr, nullptr };
+
+    if( building )
+    {
+        open.m_node = node.release();
+        addChild( open.m_node );
+    }
+    else if( elementIt != m_elementHandlers.end() )
+    {
+        m_root = std::move( node );
+        open.m_node = m_root.get();
+        open.m_handler = &elementIt->second;
+    }
+
+    m_open.push_back( open );
+    m_path = path;
+
+    if( empty )
+        endElement();
+}
+
+
+void EAGLE_XML_READER::readEndTag()
+{
+    std::string name = readName( getChar() );
+
+    while( isXmlSpace( peekChar() ) )
+        getChar();
+
+    if( getChar() != '>' )
+        error( "malformed end tag" );
+
+    if( m_open.empty() || m_open.back().m_name != wxString::FromUTF8( name.c_str() ) )
+        error( wxString::Format( "unexpected end tag </%s>", wxString::FromUTF8( name.c_str() ) ) );
+
+    endElement();
+}
+
+
+void EAGLE_XML_READER::endElement()
+{
+    OPEN_ELEMENT open = m_open.back();
+
+    m_open.pop_back();
+    m_path.Truncate( open.m_pathLength );
+
+    if( open.m_handler )
+        ( *open.m_handler )( std::move( m_root ) );
+}
+
+
+void EAGLE_XML_READER::readText( int aFirst )
+{
+    bool        building = !m_open.empty() && m_open.back().m_node;
+    std::string text;
+    bool        whiteOnly = true;
+    int         c = aFirst;
+
+    for( ;; )
+    {
+        if( building )
+        {
+            if( c == '&' )
+            {
+                readEntity( text );
+                whiteOnly = false;
+            }
+            else
+            {
+                text += (char) c;
+                whiteOnly &= isXmlSpace( c );
+            }
+        }
+
+        c = peekChar();
+
+        if( c == '<' || c == EOF )
+            break;
+
+        c = getChar();
+    }
+
+    // Like wxXmlDocument, skip the white space between the elements
+    if( building && !whiteOnly )
+    {
+        addChild( new wxXmlNode( nullptr, wxXML_TEXT_NODE, "text",
+                                 wxString::FromUTF8( text.c_str() ), nullptr, nullptr, m_line ) );
+    }
+}
+
+
+void EAGLE_XML_READER::readCData()
+{
+    bool        building = !m_open.empty() && m_open.back().m_node;
+    std::string text;
+    int         c;
+
+    while( text.size() < 3 || text.compare( text.size() - 3, 3, "]]>" ) != 0 )
+    {
+        if( ( c = getChar() ) == EOF )
+            error( "unterminated CDATA section" );
+
+        text += (char) c;
+    }
+
+    text.resize( text.size() - 3 );
+
+    if( building )
+    {
+        addChild( new wxXmlNode( nullptr, wxXML_CDATA_SECTION_NODE, "cdata",
+                                 wxString::FromUTF8( text.c_str() ), nullptr, nullptr, m_line ) );
+    }
+}
+
+
+void EAGLE_XML_READER::addChild( wxXmlNode* aNode )
+{
+    OPEN_ELEMENT& parent = m_open.back();
+
+    // Append after the last child: wxXmlNode::AddChild() walks the whole list
+    aNode->SetParent( parent.m_node );
+
+    if( parent.m_lastChild )
+        parent.m_lastChild->SetNext( aNode );
+    else
+        parent.m_node->SetChildren( aNode );
+
+    parent.m_lastChild = aNode;
+}
+
+
+void EAGLE_XML_READER::error( const wxString& aMessage ) const
+{
+    throw XML_PARSER_ERROR( wxString::Format( "%s, line %d", aMessage, m_line ) );
+}
+
+
 wxPoint ConvertArcCenter( const wxPoint& aStart, const wxPoint& aEnd, double aAngle )
 {
     // Eagle give us start and end.
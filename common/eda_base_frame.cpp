@@ -23,6 +23,7 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
  */
 
+#include <advanced_config.h>
 #include <bitmaps.h>
 #include <dialog_shim.h>
 #include <dialogs/panel_common_settings.h>
@@ -304,6 +305,9 @@ void EDA_BASE_FRAME::AddStandardHelpMenu( wxMenuBar* aMenuBar )
     helpMenu->Add( ACTIONS::getInvolved );
     helpMenu->Add( ACTIONS::reportBug );
 
+    if( ADVANCED_CFG::GetCfg().m_MemoryAccounting )
+        helpMenu->Add( ACTIONS::showMemoryUsage );
+
     helpMenu->AppendSeparator();
     helpMenu->Add( _( "&About KiCad" ), "", wxID_ABOUT, about_xpm );
 
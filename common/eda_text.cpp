@@ -101,7 +101,8 @@ EDA_TEXT::EDA_TEXT( const wxString& text ) :
 
 EDA_TEXT::EDA_TEXT( const EDA_TEXT& aText ) :
         m_text( aText.m_text ),
-        m_e( aText.m_e )
+        m_e( aText.m_e ),
+        m_strokeSegments( std::atomic_load( &aText.m_strokeSegments ) )
 {
     m_shown_text = UnescapeString( m_text );
     m_shown_text_has_text_var_refs = m_shown_text.Contains( wxT( "${" ) );
@@ -182,6 +183,8 @@ bool EDA_TEXT::Replace( wxFindReplaceData& aSearchData )
 
 int EDA_TEXT::LenSize( const wxString& aLine, int aThickness ) const
 {
+    std::lock_guard<std::mutex> lock( basic_gal.m_Mutex );
+
     basic_gal.SetFontItalic( IsItalic() );
     basic_gal.SetFontBold( IsBold() );
     basic_gal.SetLineWidth( (float) aThickness );
@@ -577,36 +580,62 @@ static void addTextSegmToBuffer( int x0, int y0, int xf, int yf, void* aData )
 
 void EDA_TEXT::TransformTextShapeToSegmentList( std::vector<wxPoint>& aCornerBuffer ) const
 {
-    wxSize size = GetTextSize();
+    std::shared_ptr<const std::vector<wxPoint>> segments = GetStrokeSegments( GetTextAngle(), 0 );
 
-    if( IsMirrored() )
-        size.x = -size.x;
+    aCornerBuffer.insert( aCornerBuffer.end(), segments->begin(), segments->end() );
+}
 
-    bool forceBold = true;
-    int  penWidth = 0;      // use max-width for bold text
 
-    COLOR4D color = COLOR4D::BLACK;  // not actually used, but needed by GRText
+std::shared_ptr<const std::vector<wxPoint>> EDA_TEXT::GetStrokeSegments( double aAngle,
+                                                                         int aPenWidth ) const
+{
+    wxString                               text = GetShownText();
+    std::shared_ptr<const STROKE_SEGMENTS> cache = std::atomic_load( &m_strokeSegments );
 
-    if( IsMultilineAllowed() )
+    if( !cache || cache->m_Angle != aAngle || cache->m_PenWidth != aPenWidth
+            || !( cache->m_Effects == m_e ) || cache->m_Text != text )
     {
-        wxArrayString strings_list;
-        wxStringSplit( GetShownText(), strings_list, wxChar('\n') );
-        std::vector<wxPoint> positions;
-        positions.reserve( strings_list.Count() );
-        GetLinePositions( positions, strings_list.Count());
+        auto newCache = std::make_shared<STROKE_SEGMENTS>();
+        newCache->m_Text = text;
+        newCache->m_Effects = m_e;
+        newCache->m_Angle = aAngle;
+        newCache->m_PenWidth = aPenWidth;
 
-        for( unsigned ii = 0; ii < strings_list.Count(); ii++ )
+        wxSize size = GetTextSize();
+
+        if( IsMirrored() )
+            size.x = -size.x;
+
+        bool    forceBold = true;
+        COLOR4D color = COLOR4D::BLACK;  // not actually used, but needed by GRText
+
+        if( IsMultilineAllowed() )
         {
-            wxString txt = strings_list.Item( ii );
-            GRText( NULL, positions[ii], color, txt, GetTextAngle(), size, GetHorizJustify(),
-                    GetVertJustify(), penWidth, IsItalic(), forceBold, addTextSegmToBuffer,
-                    &aCornerBuffer );
+            wxArrayString strings_list;
+            wxStringSplit( text, strings_list, wxChar('\n') );
+            std::vector<wxPoint> positions;
+            positions.reserve( strings_list.Count() );
+            GetLinePositions( positions, strings_list.Count());
+
+            for( unsigned ii = 0; ii < strings_list.Count(); ii++ )
+            {
+                wxString txt = strings_list.Item( ii );
+                GRText( NULL, positions[ii], color, txt, aAngle, size, GetHorizJustify(),
+                        GetVertJustify(), aPenWidth, IsItalic(), forceBold, addTextSegmToBuffer,
+                        &newCache->m_Segments );
+            }
         }
+        else
+        {
+            GRText( NULL, GetTextPos(), color, text, aAngle, size, GetHorizJustify(),
+                    GetVertJustify(), aPenWidth, IsItalic(), forceBold, addTextSegmToBuffer,
+                    &newCache->m_Segments );
+        }
+
+        // Two threads laying out the same text both store an up to date cache: keep either
+        cache = newCache;
+        std::atomic_store( &m_strokeSegments, cache );
     }
-    else
-    {
-        GRText( NULL, GetTextPos(), color, GetText(), GetTextAngle(), size, GetHorizJustify(),
-                GetVertJustify(), penWidth, IsItalic(), forceBold, addTextSegmToBuffer,
-                &aCornerBuffer );
-    }
+
+    return std::shared_ptr<const std::vector<wxPoint>>( cache, &cache->m_Segments );
 }
@@ -19,6 +19,8 @@
  */
 
 #include <footprint_filter.h>
+#include <algorithm>
+#include <iterator>
 #include <stdexcept>
 #include <wx/tokenzr.h>
 
@@ -51,47 +53,36 @@ void FOOTPRINT_FILTER_IT::increment()
         return;
     }
 
-    int             filter_type = m_filter->m_filter_type;
-    FOOTPRINT_LIST* list        = m_filter->m_list;
-    wxString&       lib_name    = m_filter->m_lib_name;
+    m_filter->prepare();
 
-    for( ++m_pos; m_pos < list->GetCount(); ++m_pos )
-    {
-        FOOTPRINT_INFO& candidate = list->GetItem( m_pos );
-
-        if( filter_type == FOOTPRINT_FILTER::UNFILTERED_FP_LIST )
-            break;
+    int                        filter_type = m_filter->m_filter_type;
+    FOOTPRINT_LIST*            list        = m_filter->m_list;
+    const std::vector<size_t>& candidates  = m_filter->m_candidates;
 
-        if( filter_type & FOOTPRINT_FILTER::FILTERING_BY_LIBRARY )
-        {
-            if( !lib_name.IsEmpty() && !candidate.InLibrary( lib_name ) )
-                continue;
-        }
+    for( ++m_pos; m_pos < candidates.size(); ++m_pos )
+    {
+        size_t index = candidates[m_pos];
 
+        // The library and pin count criteria are already applied to the candidates
         if( filter_type & FOOTPRINT_FILTER::FILTERING_BY_COMPONENT_FP_FILTER )
         {
-            if( !FootprintFilterMatch( candidate ) )
-                continue;
-        }
-
-        if( filter_type & FOOTPRINT_FILTER::FILTERING_BY_PIN_COUNT )
-        {
-            if( !PinCountMatch( candidate ) )
+            if( !FootprintFilterMatch( index ) )
                 continue;
         }
 
         if( ( filter_type & FOOTPRINT_FILTER::FILTERING_BY_TEXT_PATTERN ) )
         {
-            wxString searchStr = wxString::Format( wxT( "%s:%s %s" ),
-                                                   candidate.GetLibNickname(),
-                                                   candidate.GetFootprintName(),
-                                                   candidate.GetSearchText() );
-            int      matches, position;
-            bool     exclude = false;
+            FOOTPRINT_INFO& candidate = list->GetItem( index );
+            wxString        searchStr = wxString::Format( wxT( "%s:%s %s" ),
+                                                          candidate.GetLibNickname(),
+                                                          candidate.GetFootprintName(),
+                                                          candidate.GetSearchText() ).Lower();
+            int             matches, position;
+            bool            exclude = false;
 
             for( auto& matcher : m_filter->m_pattern_filters )
             {
-                if( !matcher->Find( searchStr.Lower(), matches, position ) )
+                if( !matcher->Find( searchStr, matches, position ) )
                 {
                     exclude = true;
                     break;
@@ -117,50 +108,34 @@ bool FOOTPRINT_FILTER_IT::equal( FOOTPRINT_FILTER_IT const& aOther ) const
 
 FOOTPRINT_INFO& FOOTPRINT_FILTER_IT::dereference() const
 {
-    if( m_filter && m_filter->m_list && m_pos < m_filter->m_list->GetCount() )
-        return m_filter->m_list->GetItem( m_pos );
+    if( m_filter && m_filter->m_list && m_pos < m_filter->m_candidates.size() )
+        return m_filter->m_list->GetItem( m_filter->m_candidates[m_pos] );
     else
         throw std::out_of_range( "Attempt to dereference past FOOTPRINT_FILTER::end()" );
 }
 
 
-bool FOOTPRINT_FILTER_IT::FootprintFilterMatch( FOOTPRINT_INFO& aItem )
+bool FOOTPRINT_FILTER_IT::FootprintFilterMatch( size_t aIndex )
 {
     if( m_filter->m_footprint_filters.empty() )
         return true;
 
-    // The matching is case insensitive
-    wxString name;
-
-    for( auto const& each_filter : m_filter->m_footprint_filters )
+    // The matching is case insensitive: the names are indexed in lower case
+    for( size_t ii = 0; ii < m_filter->m_footprint_filters.size(); ++ii )
     {
-        name.Empty();
-
         // If the filter contains a ':' character, include the library name in the pattern
-        if( each_filter->GetPattern().Contains( ":" ) )
-        {
-            name = aItem.GetLibNickname().Lower() + ":";
-        }
+        const wxString& name = m_filter->m_footprint_filters_with_lib[ii]
+                                       ? m_filter->m_lower_full_names[aIndex]
+                                       : m_filter->m_lower_names[aIndex];
 
-        name += aItem.GetFootprintName().Lower();
-
-        if( each_filter->Find( name ) != EDA_PATTERN_NOT_FOUND )
-        {
+        if( m_filter->m_footprint_filters[ii]->Find( name ) != EDA_PATTERN_NOT_FOUND )
             return true;
-        }
     }
 
     return false;
 }
 
 
-bool FOOTPRINT_FILTER_IT::PinCountMatch( FOOTPRINT_INFO& aItem )
-{
-    return m_filter->m_pin_count >= 0 &&
-        (unsigned) m_filter->m_pin_count == aItem.GetUniquePadCount();
-}
-
-
 FOOTPRINT_FILTER::FOOTPRINT_FILTER( FOOTPRINT_LIST& aList ) : FOOTPRINT_FILTER()
 {
     SetList( aList );
@@ -168,7 +143,8 @@ FOOTPRINT_FILTER::FOOTPRINT_FILTER( FOOTPRINT_LIST& aList ) : FOOTPRINT_FILTER()
 
 
 FOOTPRINT_FILTER::FOOTPRINT_FILTER()
-        : m_list( nullptr ), m_pin_count( -1 ), m_filter_type( UNFILTERED_FP_LIST )
+        : m_list( nullptr ), m_pin_count( -1 ), m_filter_type( UNFILTERED_FP_LIST ),
+          m_indexed( false ), m_candidates_valid( false )
 {
 }
 
@@ -176,12 +152,20 @@ FOOTPRINT_FILTER::FOOTPRINT_FILTER()
 void FOOTPRINT_FILTER::SetList( FOOTPRINT_LIST& aList )
 {
     m_list = &aList;
+
+    m_indexed = false;
+    m_lower_names.clear();
+    m_lower_full_names.clear();
+    m_by_library.clear();
+    m_by_pin_count.clear();
+    m_candidates_valid = false;
 }
 
 
 void FOOTPRINT_FILTER::ClearFilters()
 {
     m_filter_type = UNFILTERED_FP_LIST;
+    m_candidates_valid = false;
 }
 
 
@@ -189,6 +173,7 @@ void FOOTPRINT_FILTER::FilterByLibrary( const wxString& aLibName )
 {
     m_lib_name = aLibName;
     m_filter_type |= FILTERING_BY_LIBRARY;
+    m_candidates_valid = false;
 }
 
 
@@ -196,17 +181,20 @@ void FOOTPRINT_FILTER::FilterByPinCount( int aPinCount )
 {
     m_pin_count = aPinCount;
     m_filter_type |= FILTERING_BY_PIN_COUNT;
+    m_candidates_valid = false;
 }
 
 
 void FOOTPRINT_FILTER::FilterByFootprintFilters( const wxArrayString& aFilters )
 {
     m_footprint_filters.clear();
+    m_footprint_filters_with_lib.clear();
 
     for( const wxString& each_pattern : aFilters )
     {
         m_footprint_filters.push_back( std::make_unique<EDA_PATTERN_MATCH_WILDCARD_EXPLICIT>() );
         m_footprint_filters.back()->SetPattern( each_pattern.Lower() );
+        m_footprint_filters_with_lib.push_back( each_pattern.Contains( ":" ) );
     }
 
     m_filter_type |= FILTERING_BY_COMPONENT_FP_FILTER;
@@ -216,6 +204,7 @@ void FOOTPRINT_FILTER::FilterByFootprintFilters( const wxArrayString& aFilters )
 void FOOTPRINT_FILTER::FilterByTextPattern( wxString const& aPattern )
 {
     m_filter_pattern = aPattern;
+    m_pattern_filters.clear();
 
     wxStringTokenizer tokenizer( aPattern.Lower() );
 
@@ -229,6 +218,82 @@ void FOOTPRINT_FILTER::FilterByTextPattern( wxString const& aPattern )
 }
 
 
+void FOOTPRINT_FILTER::buildIndex()
+{
+    if( m_indexed || !m_list )
+        return;
+
+    size_t count = m_list->GetCount();
+
+    m_lower_names.reserve( count );
+    m_lower_full_names.reserve( count );
+
+    for( size_t ii = 0; ii < count; ++ii )
+    {
+        FOOTPRINT_INFO& item = m_list->GetItem( ii );
+
+        m_lower_names.push_back( item.GetFootprintName().Lower() );
+        m_lower_full_names.push_back( item.GetLibNickname().Lower() + ":" + m_lower_names.back() );
+        m_by_library[item.GetLibNickname()].push_back( ii );
+    }
+
+    m_indexed = true;
+}
+
+
+void FOOTPRINT_FILTER::prepare()
+{
+    if( m_candidates_valid )
+        return;
+
+    buildIndex();
+
+    m_candidates.clear();
+    m_candidates_valid = true;
+
+    // The pad counts are only known once the footprints are loaded: index them once needed
+    if( ( m_filter_type & FILTERING_BY_PIN_COUNT ) && m_by_pin_count.empty() )
+    {
+        for( size_t ii = 0; ii < m_list->GetCount(); ++ii )
+            m_by_pin_count[m_list->GetItem( ii ).GetUniquePadCount()].push_back( ii );
+    }
+
+    const std::vector<size_t>* byLibrary = nullptr;
+    const std::vector<size_t>* byPinCount = nullptr;
+    static const std::vector<size_t> none;
+
+    if( ( m_filter_type & FILTERING_BY_LIBRARY ) && !m_lib_name.IsEmpty() )
+    {
+        auto it = m_by_library.find( m_lib_name );
+        byLibrary = ( it != m_by_library.end() ) ? &it->second : &none;
+    }
+
+    if( m_filter_type & FILTERING_BY_PIN_COUNT )
+    {
+        auto it = m_by_pin_count.find( (unsigned) m_pin_count );
+        byPinCount = ( m_pin_count >= 0 && it != m_by_pin_count.end() ) ? &it->second : &none;
+    }
+
+    // Both are sorted by position: the candidates keep the order of the list
+    if( byLibrary && byPinCount )
+    {
+        std::set_intersection( byLibrary->begin(), byLibrary->end(), byPinCount->begin(),
+                               byPinCount->end(), std::back_inserter( m_candidates ) );
+    }
+    else if( byLibrary || byPinCount )
+    {
+        m_candidates = byLibrary ? *byLibrary : *byPinCount;
+    }
+    else
+    {
+        m_candidates.resize( m_list->GetCount() );
+
+        for( size_t ii = 0; ii < m_candidates.size(); ++ii )
+            m_candidates[ii] = ii;
+    }
+}
+
+
 FOOTPRINT_FILTER_IT FOOTPRINT_FILTER::begin()
 {
     return FOOTPRINT_FILTER_IT( *this );
@@ -238,6 +303,11 @@ FOOTPRINT_FILTER_IT FOOTPRINT_FILTER::begin()
 FOOTPRINT_FILTER_IT FOOTPRINT_FILTER::end()
 {
     FOOTPRINT_FILTER_IT end_it( *this );
-    end_it.m_pos = m_list ? m_list->GetCount() : 0;
+
+    if( m_list && m_list->GetCount() )
+        end_it.m_pos = m_candidates.size();
+    else
+        end_it.m_pos = 0;
+
     return end_it;
 }
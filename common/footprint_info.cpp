@@ -141,10 +141,7 @@ FOOTPRINT_LIST* FOOTPRINT_LIST::GetInstance( KIWAY& aKiway )
         return nullptr;
 
     if( !footprintInfo->GetCount() )
-    {
-        wxTextFile footprintInfoCache( aKiway.Prj().GetProjectPath() + "fp-info-cache" );
-        footprintInfo->ReadCacheFromFile( &footprintInfoCache );
-    }
+        footprintInfo->ReadCacheFromFile( aKiway.Prj().GetProjectPath() + "fp-info-cache" );
 
     return footprintInfo;
 }
@@ -43,6 +43,9 @@ using namespace LIB_TABLE_T;
 
 static const wxChar global_tbl_name[] = wxT( "fp-lib-table" );
 
+/// The loading of #GFootprintTable started by LoadGlobalTableInBackground()
+static LIB_TABLE_BACKGROUND_LOAD globalTableLoad;
+
 
 bool FP_LIB_TABLE_ROW::operator==( const FP_LIB_TABLE_ROW& aRow ) const
 {
@@ -60,7 +63,8 @@ void FP_LIB_TABLE_ROW::SetType( const wxString& aType )
 
 
 FP_LIB_TABLE::FP_LIB_TABLE( FP_LIB_TABLE* aFallBackTable ) :
-    LIB_TABLE( aFallBackTable )
+    LIB_TABLE( aFallBackTable ),
+    m_fpNameIndexTimestamp( 0 )
 {
     // not copying fall back, simply search aFallBackTable separately
     // if "nickName not found".
@@ -438,24 +442,70 @@ MODULE* FP_LIB_TABLE::FootprintLoadWithOptionalNickname( const LIB_ID& aFootprin
         return FootprintLoad( nickname, fpname );
     }
 
-    // nickname is empty, sequentially search (alphabetically) all libs/nicks for first match:
-    else
+    // nickname is empty, look the footprint name up in the index
+    bool      indexed = false;
+    long long indexTimestamp = 0;
+
     {
-        std::vector<wxString> nicks = GetLogicalLibs();
+        std::lock_guard<std::mutex> lock( m_fpNameIndexMutex );
 
-        // Search each library going through libraries alphabetically.
-        for( unsigned i = 0;  i < nicks.size();  ++i )
+        if( !m_fpNameIndex.empty() )
         {
-            // FootprintLoad() returns NULL on not found, does not throw exception
-            // unless there's an IO_ERROR.
-            MODULE* ret = FootprintLoad( nicks[i], fpname );
+            auto it = m_fpNameIndex.find( fpname );
 
-            if( ret )
-                return ret;
+            indexed = true;
+            indexTimestamp = m_fpNameIndexTimestamp;
+
+            if( it != m_fpNameIndex.end() )
+                nickname = it->second;
         }
+    }
 
+    if( nickname.size() && HasLibrary( nickname, true ) )
+    {
+        if( MODULE* ret = FootprintLoad( nickname, fpname ) )
+            return ret;
+    }
+    else if( indexed && nickname.empty() && GenerateTimestamp( nullptr ) == indexTimestamp )
+    {
+        // In none of the libraries, which did not change since the index was built
         return NULL;
     }
+
+    // no index, or an out of date one: sequentially search (alphabetically) all libs/nicks
+    // for first match
+    std::vector<wxString> nicks = GetLogicalLibs();
+
+    // Search each library going through libraries alphabetically.
+    for( unsigned i = 0;  i < nicks.size();  ++i )
+    {
+        // FootprintLoad() returns NULL on not found, does not throw exception
+        // unless there's an IO_ERROR.
+        MODULE* ret = FootprintLoad( nicks[i], fpname );
+
+        if( ret )
+            return ret;
+    }
+
+    return NULL;
+}
+
+
+void FP_LIB_TABLE::SetFootprintNameIndex( std::unordered_map<wxString, wxString> aIndex,
+                                          long long aTimestamp )
+{
+    std::lock_guard<std::mutex> lock( m_fpNameIndexMutex );
+
+    m_fpNameIndex = std::move( aIndex );
+    m_fpNameIndexTimestamp = aTimestamp;
+}
+
+
+bool FP_LIB_TABLE::HasFootprintNameIndex() const
+{
+    std::lock_guard<std::mutex> lock( m_fpNameIndexMutex );
+
+    return !m_fpNameIndex.empty();
 }
 
 
@@ -509,6 +559,25 @@ bool FP_LIB_TABLE::LoadGlobalTable( FP_LIB_TABLE& aTable )
 }
 
 
+void FP_LIB_TABLE::LoadGlobalTableInBackground(
+        std::function<void( const IO_ERROR& )> aOnError )
+{
+    globalTableLoad.Start( []()
+                           {
+                               LoadGlobalTable( GFootprintTable );
+                           },
+                           std::move( aOnError ) );
+}
+
+
+FP_LIB_TABLE& FP_LIB_TABLE::GetGlobalLibTable()
+{
+    globalTableLoad.Wait();
+
+    return GFootprintTable;
+}
+
+
 wxString FP_LIB_TABLE::GetGlobalTableFileName()
 {
     wxFileName fn;
@@ -32,11 +32,13 @@
 #include <gal/cairo/cairo_compositor.h>
 #include <wx/log.h>
 
+#include <algorithm>
+
 using namespace KIGFX;
 
 CAIRO_COMPOSITOR::CAIRO_COMPOSITOR( cairo_t** aMainContext ) :
     m_current( 0 ), m_currentContext( aMainContext ), m_mainContext( *aMainContext ),
-    m_currentAntialiasingMode( CAIRO_ANTIALIAS_DEFAULT )
+    m_currentAntialiasingMode( CAIRO_ANTIALIAS_DEFAULT ), m_clipBuffer( 0 )
 {
     // Do not have uninitialized members:
     cairo_matrix_init_identity( &m_matrix );
@@ -142,8 +144,90 @@ void CAIRO_COMPOSITOR::Begin()
 
 void CAIRO_COMPOSITOR::ClearBuffer( const COLOR4D& aColor )
 {
-    // Clear the pixel storage
-    memset( m_buffers[m_current].bitmap, 0x00, m_bufferSize * sizeof(int) );
+    if( m_current + 1 != m_clipBuffer )
+    {
+        // Clear the pixel storage
+        memset( m_buffers[m_current].bitmap, 0x00, m_bufferSize * sizeof(int) );
+        return;
+    }
+
+    // Clear the clipped part only
+    int left = std::max( 0, m_clipRect.GetLeft() );
+    int right = std::min( (int) m_width, m_clipRect.GetRight() );
+    int top = std::max( 0, m_clipRect.GetTop() );
+    int bottom = std::min( (int) m_height, m_clipRect.GetBottom() );
+
+    cairo_surface_flush( m_buffers[m_current].surface );
+
+    for( int y = top; y < bottom && left < right; y++ )
+    {
+        uint8_t* row = (uint8_t*) m_buffers[m_current].bitmap + y * m_stride;
+
+        memset( row + left * sizeof( uint32_t ), 0x00, ( right - left ) * sizeof( uint32_t ) );
+    }
+
+    cairo_surface_mark_dirty( m_buffers[m_current].surface );
+}
+
+
+void CAIRO_COMPOSITOR::SetClipRect( unsigned int aBufferHandle, const BOX2I* aRect )
+{
+    wxASSERT_MSG( aBufferHandle <= usedBuffers(), wxT( "Tried to use a not existing buffer" ) );
+
+    // Lift the previous clipping first, there is only one clipped buffer
+    if( m_clipBuffer != 0 && m_clipBuffer <= usedBuffers() )
+        cairo_reset_clip( m_buffers[m_clipBuffer - 1].context );
+
+    m_clipBuffer = aRect ? aBufferHandle : 0;
+
+    if( !aRect )
+        return;
+
+    m_clipRect = *aRect;
+
+    // The clipping rectangle is given in pixels, so it is set with the identity matrix
+    cairo_t*       context = m_buffers[aBufferHandle - 1].context;
+    cairo_matrix_t matrix;
+
+    cairo_get_matrix( context, &matrix );
+    cairo_identity_matrix( context );
+    cairo_new_path( context );
+    cairo_rectangle( context, m_clipRect.GetX(), m_clipRect.GetY(), m_clipRect.GetWidth(),
+                     m_clipRect.GetHeight() );
+    cairo_clip( context );
+    cairo_set_matrix( context, &matrix );
+}
+
+
+void CAIRO_COMPOSITOR::ScrollBuffer( unsigned int aBufferHandle, const VECTOR2I& aOffset )
+{
+    wxASSERT_MSG( aBufferHandle <= usedBuffers(), wxT( "Tried to use a not existing buffer" ) );
+
+    const CAIRO_BUFFER& buffer = m_buffers[aBufferHandle - 1];
+    int                 width = (int) m_width - std::abs( aOffset.x );
+    int                 height = (int) m_height - std::abs( aOffset.y );
+
+    if( width <= 0 || height <= 0 )
+        return;
+
+    int      srcX = std::max( 0, -aOffset.x );
+    int      dstX = std::max( 0, aOffset.x );
+    uint8_t* bits = (uint8_t*) buffer.bitmap;
+
+    cairo_surface_flush( buffer.surface );
+
+    // Move the rows in an order that does not overwrite the rows still to be moved
+    for( int i = 0; i < height; i++ )
+    {
+        int row = aOffset.y > 0 ? height - 1 - i : i;
+        int srcY = row + std::max( 0, -aOffset.y );
+        int dstY = row + std::max( 0, aOffset.y );
+
+        memmove( bits + dstY * m_stride + dstX * sizeof( uint32_t ),
+                 bits + srcY * m_stride + srcX * sizeof( uint32_t ), width * sizeof( uint32_t ) );
+    }
+
+    cairo_surface_mark_dirty( buffer.surface );
 }
 
 
@@ -180,4 +264,5 @@ void CAIRO_COMPOSITOR::clean()
     }
 
     m_buffers.clear();
+    m_clipBuffer = 0;
 }
@@ -32,9 +32,12 @@
 #include <gal/cairo/cairo_gal.h>
 #include <gal/cairo/cairo_compositor.h>
 #include <gal/definitions.h>
+#include <advanced_config.h>
 #include <geometry/shape_poly_set.h>
 #include <math/util.h>      // for KiROUND
 #include <bitmap_base.h>
+#include <profile.h>
+#include <thread_pool.h>
 
 #include <limits>
 
@@ -43,6 +46,113 @@
 using namespace KIGFX;
 
 
+namespace KIGFX {
+class CAIRO_BITMAP_CACHE
+{
+public:
+    CAIRO_BITMAP_CACHE()
+    {
+    }
+
+    ~CAIRO_BITMAP_CACHE();
+
+    cairo_surface_t* RequestBitmap( const BITMAP_BASE* aBitmap );
+
+private:
+
+    struct CACHED_BITMAP
+    {
+        int              imageId;
+        cairo_surface_t* surface;
+    };
+
+    cairo_surface_t* cacheBitmap( const BITMAP_BASE* aBitmap );
+
+    std::map<const BITMAP_BASE*, CACHED_BITMAP> m_bitmaps;
+};
+
+};
+
+
+CAIRO_BITMAP_CACHE::~CAIRO_BITMAP_CACHE()
+{
+    for( auto b = m_bitmaps.begin(); b != m_bitmaps.end(); ++b )
+        cairo_surface_destroy( b->second.surface );
+}
+
+
+cairo_surface_t* CAIRO_BITMAP_CACHE::RequestBitmap( const BITMAP_BASE* aBitmap )
+{
+    auto it = m_bitmaps.find( aBitmap );
+
+    if( it != m_bitmaps.end() )
+    {
+        // The image id changes with the image data, and is not reused by another bitmap
+        // allocated at the same address
+        if( it->second.imageId == aBitmap->GetImageID() )
+            return it->second.surface;
+
+        // A surface still in use by a context is referenced by it: destroying ours is safe
+        cairo_surface_destroy( it->second.surface );
+        m_bitmaps.erase( it );
+    }
+
+    return cacheBitmap( aBitmap );
+}
+
+
+cairo_surface_t* CAIRO_BITMAP_CACHE::cacheBitmap( const BITMAP_BASE* aBitmap )
+{
+    int w = aBitmap->GetSizePixels().x;
+    int h = aBitmap->GetSizePixels().y;
+
+    cairo_surface_t* image = cairo_image_surface_create( CAIRO_FORMAT_ARGB32, w, h );
+    cairo_surface_flush( image );
+
+    unsigned char* pix_buffer = cairo_image_surface_get_data( image );
+    int            stride = cairo_image_surface_get_stride( image );
+
+    // The pixel buffer of the initial bitmap:
+    const wxImage& bm_pix_buffer = *aBitmap->GetImageData();
+
+    uint32_t mask_color = ( bm_pix_buffer.GetMaskRed() << 16 ) +
+            ( bm_pix_buffer.GetMaskGreen() << 8 ) +
+            ( bm_pix_buffer.GetMaskBlue() );
+
+    // Copy the source bitmap to the cairo bitmap buffer.
+    // In cairo bitmap buffer, a ARGB32 bitmap is an ARGB pixel packed into a uint_32
+    // 24 low bits only are used for color, top 8 are transparency.
+    for( int row = 0; row < h; row++ )
+    {
+        uint32_t* pix_ptr = (uint32_t*) ( pix_buffer + row * stride );
+
+        for( int col = 0; col < w; col++ )
+        {
+            // Build the RGB24 pixel:
+            uint32_t pixel = bm_pix_buffer.GetRed( col, row ) << 16;
+            pixel += bm_pix_buffer.GetGreen( col, row ) << 8;
+            pixel += bm_pix_buffer.GetBlue( col, row );
+
+            if( bm_pix_buffer.HasAlpha() )
+                pixel += bm_pix_buffer.GetAlpha( col, row ) << 24;
+            else if( bm_pix_buffer.HasMask() && pixel == mask_color )
+                pixel += ( wxALPHA_TRANSPARENT << 24 );
+            else
+                pixel += ( wxALPHA_OPAQUE << 24 );
+
+            // Write the pixel to the cairo image buffer:
+            *pix_ptr++ = pixel;
+        }
+    }
+
+    cairo_surface_mark_dirty( image );
+
+    m_bitmaps[ aBitmap ] = { aBitmap->GetImageID(), image };
+
+    return image;
+}
+
+
 
 CAIRO_GAL_BASE::CAIRO_GAL_BASE( GAL_DISPLAY_OPTIONS& aDisplayOptions ) :
     GAL( aDisplayOptions )
@@ -52,6 +162,9 @@ CAIRO_GAL_BASE::CAIRO_GAL_BASE( GAL_DISPLAY_OPTIONS& aDisplayOptions ) :
     isElementAdded      = false;
     groupCounter        = 0;
     currentGroup        = nullptr;
+    renderThreads       = 1;
+    deferGroups         = false;
+    bitmapCache         = std::make_unique<CAIRO_BITMAP_CACHE>();
 
     lineWidth = 1.0;
     linePixelWidth = 1.0;
@@ -83,9 +196,6 @@ CAIRO_GAL_BASE::~CAIRO_GAL_BASE()
 
     if( context )
         cairo_destroy( context );
-
-    for( auto imageSurface : imageSurfaces )
-        cairo_surface_destroy( imageSurface );
 }
 
 
@@ -471,50 +581,11 @@ void CAIRO_GAL_BASE::DrawBitmap( const BITMAP_BASE& aBitmap )
     cairo_translate( currentContext, -w / 2.0, -h / 2.0 );
 
     cairo_new_path( currentContext );
-    cairo_surface_t* image = cairo_image_surface_create( CAIRO_FORMAT_ARGB32, w, h );
-    cairo_surface_flush( image );
-
-    unsigned char* pix_buffer = cairo_image_surface_get_data( image );
-    // The pixel buffer of the initial bitmap:
-    const wxImage& bm_pix_buffer = *aBitmap.GetImageData();
-
-    uint32_t mask_color = ( bm_pix_buffer.GetMaskRed() << 16 ) +
-            ( bm_pix_buffer.GetMaskGreen() << 8 ) +
-            ( bm_pix_buffer.GetMaskBlue() );
-
-    // Copy the source bitmap to the cairo bitmap buffer.
-    // In cairo bitmap buffer, a ARGB32 bitmap is an ARGB pixel packed into a uint_32
-    // 24 low bits only are used for color, top 8 are transparency.
-    for( int row = 0; row < h; row++ )
-    {
-        for( int col = 0; col < w; col++ )
-        {
-            // Build the RGB24 pixel:
-            uint32_t pixel = bm_pix_buffer.GetRed( col, row ) << 16;
-            pixel += bm_pix_buffer.GetGreen( col, row ) << 8;
-            pixel += bm_pix_buffer.GetBlue( col, row );
-
-            if( bm_pix_buffer.HasAlpha() )
-                pixel += bm_pix_buffer.GetAlpha( col, row ) << 24;
-            else if( bm_pix_buffer.HasMask() && pixel == mask_color )
-                pixel += ( wxALPHA_TRANSPARENT << 24 );
-            else
-                pixel += ( wxALPHA_OPAQUE << 24 );
-
-            // Write the pixel to the cairo image buffer:
-            uint32_t* pix_ptr = (uint32_t*) pix_buffer;
-            *pix_ptr = pixel;
-            pix_buffer += 4;
-        }
-    }
+    cairo_surface_t* image = bitmapCache->RequestBitmap( &aBitmap );
 
-    cairo_surface_mark_dirty( image );
     cairo_set_source_surface( currentContext, image, 0, 0 );
     cairo_paint( currentContext );
 
-    // store the image handle so it can be destroyed later
-    imageSurfaces.push_back( image );
-
     isElementAdded = true;
 
     cairo_restore( currentContext );
@@ -530,6 +601,7 @@ void CAIRO_GAL_BASE::ResizeScreen( int aWidth, int aHeight )
 void CAIRO_GAL_BASE::Flush()
 {
     storePath();
+    flushGroups();
 }
 
 
@@ -774,32 +846,61 @@ void CAIRO_GAL_BASE::EndGroup()
 
 
 void CAIRO_GAL_BASE::DrawGroup( int aGroupNumber )
+{
+    storePath();
+
+    // Tiles are painted OVER the context, so other operators have to be used directly
+    if( deferGroups && cairo_get_operator( currentContext ) == CAIRO_OPERATOR_OVER )
+    {
+        DEFERRED_GROUP deferred;
+
+        deferred.m_group = aGroupNumber;
+        cairo_get_matrix( currentContext, &deferred.m_matrix );
+        deferredGroups.push_back( deferred );
+        return;
+    }
+
+    GROUP_STATE state = { isFillEnabled, isStrokeEnabled, fillColor, strokeColor };
+
+    replayGroup( currentContext, aGroupNumber, state );
+
+    isFillEnabled = state.m_isFillEnabled;
+    isStrokeEnabled = state.m_isStrokeEnabled;
+    fillColor = state.m_fillColor;
+    strokeColor = state.m_strokeColor;
+}
+
+
+void CAIRO_GAL_BASE::replayGroup( cairo_t* aContext, int aGroupNumber,
+                                  GROUP_STATE& aState ) const
 {
     // This method implements a small Virtual Machine - all stored commands
     // are executed; nested calling is also possible
 
-    storePath();
+    auto group = groups.find( aGroupNumber );
 
-    for( GROUP::iterator it = groups[aGroupNumber].begin();
-         it != groups[aGroupNumber].end(); ++it )
+    if( group == groups.end() )
+        return;
+
+    for( GROUP::const_iterator it = group->second.begin(); it != group->second.end(); ++it )
     {
         switch( it->command )
         {
         case CMD_SET_FILL:
-            isFillEnabled = it->argument.boolArg;
+            aState.m_isFillEnabled = it->argument.boolArg;
             break;
 
         case CMD_SET_STROKE:
-            isStrokeEnabled = it->argument.boolArg;
+            aState.m_isStrokeEnabled = it->argument.boolArg;
             break;
 
         case CMD_SET_FILLCOLOR:
-            fillColor = COLOR4D( it->argument.dblArg[0], it->argument.dblArg[1], it->argument.dblArg[2],
+            aState.m_fillColor = COLOR4D( it->argument.dblArg[0], it->argument.dblArg[1], it->argument.dblArg[2],
                                  it->argument.dblArg[3] );
             break;
 
         case CMD_SET_STROKECOLOR:
-            strokeColor = COLOR4D( it->argument.dblArg[0], it->argument.dblArg[1], it->argument.dblArg[2],
+            aState.m_strokeColor = COLOR4D( it->argument.dblArg[0], it->argument.dblArg[1], it->argument.dblArg[2],
                                    it->argument.dblArg[3] );
             break;
 
@@ -807,23 +908,25 @@ void CAIRO_GAL_BASE::DrawGroup( int aGroupNumber )
             {
                 // Make lines appear at least 1 pixel wide, no matter of zoom
                 double x = 1.0, y = 1.0;
-                cairo_device_to_user_distance( currentContext, &x, &y );
+                cairo_device_to_user_distance( aContext, &x, &y );
                 double minWidth = std::min( fabs( x ), fabs( y ) );
-                cairo_set_line_width( currentContext, std::max( it->argument.dblArg[0], minWidth ) );
+                cairo_set_line_width( aContext, std::max( it->argument.dblArg[0], minWidth ) );
             }
             break;
 
 
         case CMD_STROKE_PATH:
-            cairo_set_source_rgba( currentContext, strokeColor.r, strokeColor.g, strokeColor.b, strokeColor.a );
-            cairo_append_path( currentContext, it->cairoPath );
-            cairo_stroke( currentContext );
+            cairo_set_source_rgba( aContext, aState.m_strokeColor.r, aState.m_strokeColor.g,
+                                   aState.m_strokeColor.b, aState.m_strokeColor.a );
+            cairo_append_path( aContext, it->cairoPath );
+            cairo_stroke( aContext );
             break;
 
         case CMD_FILL_PATH:
-            cairo_set_source_rgba( currentContext, fillColor.r, fillColor.g, fillColor.b, strokeColor.a );
-            cairo_append_path( currentContext, it->cairoPath );
-            cairo_fill( currentContext );
+            cairo_set_source_rgba( aContext, aState.m_fillColor.r, aState.m_fillColor.g,
+                                   aState.m_fillColor.b, aState.m_strokeColor.a );
+            cairo_append_path( aContext, it->cairoPath );
+            cairo_fill( aContext );
             break;
 
             /*
@@ -831,38 +934,142 @@ void CAIRO_GAL_BASE::DrawGroup( int aGroupNumber )
             cairo_matrix_t matrix;
             cairo_matrix_init( &matrix, it->argument.dblArg[0], it->argument.dblArg[1], it->argument.dblArg[2],
                                it->argument.dblArg[3], it->argument.dblArg[4], it->argument.dblArg[5] );
-            cairo_transform( currentContext, &matrix );
+            cairo_transform( aContext, &matrix );
             break;
             */
 
         case CMD_ROTATE:
-            cairo_rotate( currentContext, it->argument.dblArg[0] );
+            cairo_rotate( aContext, it->argument.dblArg[0] );
             break;
 
         case CMD_TRANSLATE:
-            cairo_translate( currentContext, it->argument.dblArg[0], it->argument.dblArg[1] );
+            cairo_translate( aContext, it->argument.dblArg[0], it->argument.dblArg[1] );
             break;
 
         case CMD_SCALE:
-            cairo_scale( currentContext, it->argument.dblArg[0], it->argument.dblArg[1] );
+            cairo_scale( aContext, it->argument.dblArg[0], it->argument.dblArg[1] );
             break;
 
         case CMD_SAVE:
-            cairo_save( currentContext );
+            cairo_save( aContext );
             break;
 
         case CMD_RESTORE:
-            cairo_restore( currentContext );
+            cairo_restore( aContext );
             break;
 
         case CMD_CALL_GROUP:
-            DrawGroup( it->argument.intArg );
+            replayGroup( aContext, it->argument.intArg, aState );
             break;
         }
     }
 }
 
 
+void CAIRO_GAL_BASE::flushGroups()
+{
+    if( deferredGroups.empty() )
+        return;
+
+    GROUP_STATE state = { isFillEnabled, isStrokeEnabled, fillColor, strokeColor };
+
+    // The part of the context that can be drawn, in device coordinates
+    double x1, y1, x2, y2;
+
+    cairo_save( currentContext );
+    cairo_identity_matrix( currentContext );
+    cairo_clip_extents( currentContext, &x1, &y1, &x2, &y2 );
+    cairo_restore( currentContext );
+
+    int left = std::max( 0, (int) floor( x1 ) );
+    int top = std::max( 0, (int) floor( y1 ) );
+    int right = std::min( screenSize.x, (int) ceil( x2 ) );
+    int bottom = std::min( screenSize.y, (int) ceil( y2 ) );
+
+    // Too small tiles are not worth a thread
+    const int minTileHeight = 64;
+    int tileCount = std::min( renderThreads, ( bottom - top ) / minTileHeight );
+
+    if( right <= left || bottom <= top || tileCount < 2 )
+    {
+        for( const DEFERRED_GROUP& deferred : deferredGroups )
+        {
+            cairo_set_matrix( currentContext, &deferred.m_matrix );
+            replayGroup( currentContext, deferred.m_group, state );
+        }
+
+        tileCount = 0;
+    }
+
+    // The tiles inherit the settings of the context that are not changed by the groups
+    cairo_antialias_t antialias = cairo_get_antialias( currentContext );
+    cairo_line_cap_t  lineCap = cairo_get_line_cap( currentContext );
+    cairo_line_join_t lineJoin = cairo_get_line_join( currentContext );
+    double            width = cairo_get_line_width( currentContext );
+
+    std::vector<cairo_surface_t*> tiles( tileCount, nullptr );
+    std::vector<GROUP_STATE>      tileStates( tileCount, state );
+
+    auto tileTop = [&]( size_t aTile )
+    {
+        return top + ( bottom - top ) * (int) aTile / tileCount;
+    };
+
+    THREAD_POOL::GetInstance().ParallelFor( tileCount,
+            [&]( size_t i )
+            {
+                int              height = tileTop( i + 1 ) - tileTop( i );
+                cairo_surface_t* tile = cairo_image_surface_create( CAIRO_FORMAT_ARGB32,
+                                                                    right - left, height );
+                cairo_surface_set_device_offset( tile, -left, -tileTop( i ) );
+
+                cairo_t* tileContext = cairo_create( tile );
+
+                cairo_set_antialias( tileContext, antialias );
+                cairo_set_line_cap( tileContext, lineCap );
+                cairo_set_line_join( tileContext, lineJoin );
+                cairo_set_line_width( tileContext, width );
+
+                // Each tile replays all the groups, so it ends with the same state
+                for( const DEFERRED_GROUP& deferred : deferredGroups )
+                {
+                    cairo_set_matrix( tileContext, &deferred.m_matrix );
+                    replayGroup( tileContext, deferred.m_group, tileStates[i] );
+                }
+
+                cairo_destroy( tileContext );
+                cairo_surface_set_device_offset( tile, 0, 0 );
+                tiles[i] = tile;
+            } );
+
+    if( tileCount > 0 )
+    {
+        // Painting the tiles over the context is the same as drawing the groups on it,
+        // as the groups are drawn with the OVER operator
+        cairo_save( currentContext );
+        cairo_identity_matrix( currentContext );
+
+        for( int i = 0; i < tileCount; ++i )
+        {
+            cairo_set_source_surface( currentContext, tiles[i], left, tileTop( i ) );
+            cairo_paint( currentContext );
+            cairo_surface_destroy( tiles[i] );
+        }
+
+        cairo_restore( currentContext );
+        state = tileStates[0];
+    }
+
+    cairo_set_matrix( currentContext, &deferredGroups.back().m_matrix );
+    deferredGroups.clear();
+
+    isFillEnabled = state.m_isFillEnabled;
+    isStrokeEnabled = state.m_isStrokeEnabled;
+    fillColor = state.m_fillColor;
+    strokeColor = state.m_strokeColor;
+}
+
+
 void CAIRO_GAL_BASE::ChangeGroupColor( int aGroupNumber, const COLOR4D& aNewColor )
 {
     storePath();
@@ -891,6 +1098,7 @@ void CAIRO_GAL_BASE::ChangeGroupDepth( int aGroupNumber, int aDepth )
 void CAIRO_GAL_BASE::DeleteGroup( int aGroupNumber )
 {
     storePath();
+    flushGroups();
 
     // Delete the Cairo paths
     std::deque<GROUP_ELEMENT>::iterator it, end;
@@ -917,6 +1125,7 @@ void CAIRO_GAL_BASE::ClearCache()
 
 void CAIRO_GAL_BASE::SetNegativeDrawMode( bool aSetting )
 {
+    flushGroups();
     cairo_set_operator( currentContext, aSetting ? CAIRO_OPERATOR_CLEAR : CAIRO_OPERATOR_OVER );
 }
 
@@ -934,11 +1143,6 @@ void CAIRO_GAL_BASE::EnableDepthTest( bool aEnabled )
 
 void CAIRO_GAL_BASE::resetContext()
 {
-    for( auto imageSurface : imageSurfaces )
-        cairo_surface_destroy( imageSurface );
-
-    imageSurfaces.clear();
-
     ClearScreen();
 
     // Compute the world <-> screen transformations
@@ -1210,6 +1414,13 @@ CAIRO_GAL::CAIRO_GAL( GAL_DISPLAY_OPTIONS& aDisplayOptions,
     mainBuffer          = 0;
     overlayBuffer       = 0;
     validCompositor     = false;
+    mainBufferComplete  = false;
+
+    renderThreads = ADVANCED_CFG::GetCfg().m_CairoRenderThreads;
+
+    if( renderThreads <= 0 )
+        renderThreads = (int) THREAD_POOL::GetInstance().GetThreadCount() + 1;
+
     SetTarget( TARGET_NONCACHED );
 
     parentWindow  = aParent;
@@ -1267,8 +1478,13 @@ void CAIRO_GAL::beginDrawing()
 
 void CAIRO_GAL::endDrawing()
 {
+    PROF_COUNTER endDrawingTime;
+
     CAIRO_GAL_BASE::endDrawing();
 
+    compositor->SetClipRect( mainBuffer, nullptr );
+    mainBufferComplete = true;
+
     // Merge buffers on the screen
     compositor->DrawBuffer( mainBuffer );
     compositor->DrawBuffer( overlayBuffer );
@@ -1300,6 +1516,9 @@ void CAIRO_GAL::endDrawing()
     clientDC.Blit( 0, 0, screenSize.x, screenSize.y, &mdc, 0, 0, wxCOPY );
 
     deinitSurface();
+
+    if( collectFrameStats )
+        frameStats.m_endDrawingTime = endDrawingTime.msecs();
 }
 
 
@@ -1347,6 +1566,9 @@ void CAIRO_GAL::EndGroup()
 
 void CAIRO_GAL::SetTarget( RENDER_TARGET aTarget )
 {
+    // The deferred groups belong to the current target
+    flushGroups();
+
     // If the compositor is not set, that means that there is a recaching process going on
     // and we do not need the compositor now
     if( !validCompositor )
@@ -1370,6 +1592,9 @@ void CAIRO_GAL::SetTarget( RENDER_TARGET aTarget )
     }
 
     currentTarget = aTarget;
+
+    // Only the cached items are drawn from groups in a large number
+    deferGroups = renderThreads > 1 && aTarget == TARGET_CACHED;
 }
 
 
@@ -1381,6 +1606,8 @@ RENDER_TARGET CAIRO_GAL::GetTarget() const
 
 void CAIRO_GAL::ClearTarget( RENDER_TARGET aTarget )
 {
+    flushGroups();
+
     // Save the current state
     unsigned int currentBuffer = compositor->GetBuffer();
 
@@ -1405,6 +1632,29 @@ void CAIRO_GAL::ClearTarget( RENDER_TARGET aTarget )
 }
 
 
+bool CAIRO_GAL::SetClipRect( const BOX2I& aRect )
+{
+    // A partial redraw of new buffers would leave garbage on the screen
+    if( !validCompositor || !mainBufferComplete )
+        return false;
+
+    compositor->SetClipRect( mainBuffer, &aRect );
+
+    return true;
+}
+
+
+bool CAIRO_GAL::ScrollTargets( const VECTOR2I& aOffset )
+{
+    if( !validCompositor || !mainBufferComplete )
+        return false;
+
+    compositor->ScrollBuffer( mainBuffer, aOffset );
+
+    return true;
+}
+
+
 void CAIRO_GAL::initSurface()
 {
     if( isInitialized )
@@ -1472,6 +1722,7 @@ void CAIRO_GAL::setCompositor()
     overlayBuffer = compositor->CreateBuffer();
 
     validCompositor = true;
+    mainBufferComplete = false;
 }
 
 
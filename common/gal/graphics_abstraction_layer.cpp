@@ -60,6 +60,7 @@ GAL::GAL( GAL_DISPLAY_OPTIONS& aDisplayOptions ) :
     SetLineWidth( 1.0f );
     computeWorldScale();
     SetAxesEnabled( false );
+    collectFrameStats = false;
 
     // Set grid defaults
     SetGridVisibility( true );
@@ -50,6 +50,15 @@ CACHED_CONTAINER::CACHED_CONTAINER( unsigned int aSize ) :
 {
     // In the beginning there is only free space
     m_freeChunks.insert( std::make_pair( aSize, 0 ) );
+
+    m_memoryAccount.Set( "GAL caches",
+            [this]()
+            {
+                MEMORY_ACCOUNTING::USAGE usage;
+                usage.m_Bytes = (size_t) m_currentSize * VERTEX_SIZE;
+                usage.m_Items = m_items.size();
+                return usage;
+            } );
 }
 
 
@@ -124,7 +133,7 @@ VERTEX* CACHED_CONTAINER::Allocate( unsigned int aSize )
         }
     }
 
-    VERTEX* reserved = &m_vertices[m_chunkOffset + itemSize];
+    VERTEX* reserved = GetVertices( m_chunkOffset + itemSize );
 
     // Now the item officially possesses the memory chunk
     m_item->setSize( newSize );
@@ -225,21 +234,7 @@ bool CACHED_CONTAINER::reallocate( unsigned int aSize )
     // Is there enough space to store vertices?
     if( newChunk == m_freeChunks.end() )
     {
-        bool result;
-
-        // Would it be enough to double the current space?
-        if( aSize < m_freeSpace + m_currentSize )
-        {
-            // Yes: exponential growing
-            result = defragmentResize( m_currentSize * 2 );
-        }
-        else
-        {
-            // No: grow to the nearest greater power of 2
-            result = defragmentResize( pow( 2, ceil( log2( m_currentSize * 2 + aSize ) ) ) );
-        }
-
-        if( !result )
+        if( !makeRoom( aSize ) )
             return false;
 
         newChunk = m_freeChunks.lower_bound( aSize );
@@ -261,7 +256,8 @@ bool CACHED_CONTAINER::reallocate( unsigned int aSize )
                     (int) m_item, oldChunkOffset, newChunkOffset );
 #endif
         // The item was reallocated, so we have to copy all the old data to the new place
-        memcpy( &m_vertices[newChunkOffset], &m_vertices[m_chunkOffset], itemSize * VERTEX_SIZE );
+        memcpy( GetVertices( newChunkOffset ), GetVertices( m_chunkOffset ),
+                itemSize * VERTEX_SIZE );
 
         // Free the space used by the previous chunk
         addFreeChunk( m_chunkOffset, m_chunkSize );
@@ -280,6 +276,20 @@ bool CACHED_CONTAINER::reallocate( unsigned int aSize )
 }
 
 
+bool CACHED_CONTAINER::makeRoom( unsigned int aSize )
+{
+    // Would it be enough to double the current space?
+    if( aSize < m_freeSpace + m_currentSize )
+    {
+        // Yes: exponential growing
+        return defragmentResize( m_currentSize * 2 );
+    }
+
+    // No: grow to the nearest greater power of 2
+    return defragmentResize( pow( 2, ceil( log2( m_currentSize * 2 + aSize ) ) ) );
+}
+
+
 void CACHED_CONTAINER::defragment( VERTEX* aTarget )
 {
     // Defragmentation
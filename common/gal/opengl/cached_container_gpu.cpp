@@ -28,7 +28,7 @@
 #include <gal/opengl/shader.h>
 #include <gal/opengl/utils.h>
 
-#include <list>
+#include <algorithm>
 
 #ifdef __WXDEBUG__
 #include <wx/log.h>
@@ -38,25 +38,18 @@
 using namespace KIGFX;
 
 CACHED_CONTAINER_GPU::CACHED_CONTAINER_GPU( unsigned int aSize ) :
-    CACHED_CONTAINER( aSize ), m_isMapped( false ), m_glBufferHandle( -1 )
+    CACHED_CONTAINER( aSize ), m_isMapped( false )
 {
-    m_useCopyBuffer = GLEW_ARB_copy_buffer;
+    // The free chunk of the first buffer has been added by CACHED_CONTAINER()
+    VERTEX_BUFFER buffer = { 0, 0, aSize, NULL };
 
-    wxString vendor( glGetString(GL_VENDOR) );
-    
-    // workaround for intel GPU drivers: disable glCopyBuffer, causes crashes/freezes on certain driver versions
-    if( vendor.Contains ( "Intel ") )
-    {
-        wxLogDebug("Disabling glCopyBuffer() on intel GPU\n");
-        m_useCopyBuffer = false;
-    }
-
-    
-    glGenBuffers( 1, &m_glBufferHandle );
-    glBindBuffer( GL_ARRAY_BUFFER, m_glBufferHandle );
-    glBufferData( GL_ARRAY_BUFFER, m_currentSize * VERTEX_SIZE, NULL, GL_DYNAMIC_DRAW );
+    glGenBuffers( 1, &buffer.m_handle );
+    glBindBuffer( GL_ARRAY_BUFFER, buffer.m_handle );
+    glBufferData( GL_ARRAY_BUFFER, aSize * VERTEX_SIZE, NULL, GL_DYNAMIC_DRAW );
     glBindBuffer( GL_ARRAY_BUFFER, 0 );
     checkGlError( "allocating video memory for cached container" );
+
+    m_buffers.push_back( buffer );
 }
 
 
@@ -65,7 +58,20 @@ CACHED_CONTAINER_GPU::~CACHED_CONTAINER_GPU()
     if( m_isMapped )
         Unmap();
 
-    glDeleteBuffers( 1, &m_glBufferHandle );
+    for( const VERTEX_BUFFER& buffer : m_buffers )
+        glDeleteBuffers( 1, &buffer.m_handle );
+}
+
+
+unsigned int CACHED_CONTAINER_GPU::FindBuffer( unsigned int aOffset ) const
+{
+    // There are few buffers, as each one is as large as all the previous ones
+    unsigned int idx = m_buffers.size() - 1;
+
+    while( m_buffers[idx].m_offset > aOffset )
+        --idx;
+
+    return idx;
 }
 
 
@@ -73,8 +79,13 @@ void CACHED_CONTAINER_GPU::Map()
 {
     wxCHECK( !IsMapped(), /*void*/ );
 
-    glBindBuffer( GL_ARRAY_BUFFER, m_glBufferHandle );
-    m_vertices = static_cast<VERTEX*>( glMapBuffer( GL_ARRAY_BUFFER, GL_READ_WRITE ) );
+    for( VERTEX_BUFFER& buffer : m_buffers )
+    {
+        glBindBuffer( GL_ARRAY_BUFFER, buffer.m_handle );
+        buffer.m_vertices = static_cast<VERTEX*>( glMapBuffer( GL_ARRAY_BUFFER, GL_READ_WRITE ) );
+    }
+
+    glBindBuffer( GL_ARRAY_BUFFER, 0 );
 
     if( checkGlError( "mapping vertices buffer" ) == GL_NO_ERROR )
         m_isMapped = true;
@@ -85,179 +96,85 @@ void CACHED_CONTAINER_GPU::Unmap()
 {
     wxCHECK( IsMapped(), /*void*/ );
 
-    glUnmapBuffer( GL_ARRAY_BUFFER );
+    for( VERTEX_BUFFER& buffer : m_buffers )
+    {
+        glBindBuffer( GL_ARRAY_BUFFER, buffer.m_handle );
+        glUnmapBuffer( GL_ARRAY_BUFFER );
+        buffer.m_vertices = NULL;
+    }
+
     checkGlError( "unmapping vertices buffer" );
     glBindBuffer( GL_ARRAY_BUFFER, 0 );
-    m_vertices = NULL;
     checkGlError( "unbinding vertices buffer" );
 
     m_isMapped = false;
 }
 
 
-bool CACHED_CONTAINER_GPU::defragmentResize( unsigned int aNewSize )
+void CACHED_CONTAINER_GPU::Clear()
 {
-    if( !m_useCopyBuffer )
-        return defragmentResizeMemcpy( aNewSize );
+    CACHED_CONTAINER::Clear();
 
-    wxCHECK( IsMapped(), false );
+    // Chunks must not span several buffers
+    m_freeChunks.clear();
 
-    wxLogTrace( "GAL_CACHED_CONTAINER_GPU",
-            wxT( "Resizing & defragmenting container from %d to %d" ), m_currentSize, aNewSize );
+    for( const VERTEX_BUFFER& buffer : m_buffers )
+        m_freeChunks.insert( std::make_pair( buffer.m_size, buffer.m_offset ) );
+}
 
-    // No shrinking if we cannot fit all the data
-    if( usedSpace() > aNewSize )
-        return false;
 
+bool CACHED_CONTAINER_GPU::addBuffer( unsigned int aSize )
+{
 #ifdef __WXDEBUG__
     PROF_COUNTER totalTime;
 #endif /* __WXDEBUG__ */
 
-    GLuint newBuffer;
+    VERTEX_BUFFER buffer = { 0, m_currentSize, aSize, NULL };
 
-    // glCopyBufferSubData requires a buffer to be unmapped
-    glUnmapBuffer( GL_ARRAY_BUFFER );
-
-    // Create a new destination buffer
-    glGenBuffers( 1, &newBuffer );
-
-    // It would be best to use GL_COPY_WRITE_BUFFER here,
-    // but it is not available everywhere
-#ifdef __WXDEBUG__
-    GLint eaBuffer = -1;
-    glGetIntegerv( GL_ELEMENT_ARRAY_BUFFER_BINDING, &eaBuffer );
-    wxASSERT( eaBuffer == 0 );
-#endif /* __WXDEBUG__ */
-    glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, newBuffer );
-    glBufferData( GL_ELEMENT_ARRAY_BUFFER, aNewSize * VERTEX_SIZE, NULL, GL_DYNAMIC_DRAW );
-    checkGlError( "creating buffer during defragmentation" );
+    glGenBuffers( 1, &buffer.m_handle );
+    glBindBuffer( GL_ARRAY_BUFFER, buffer.m_handle );
+    glBufferData( GL_ARRAY_BUFFER, aSize * VERTEX_SIZE, NULL, GL_DYNAMIC_DRAW );
 
-    ITEMS::iterator it, it_end;
-    int newOffset = 0;
-
-    // Defragmentation
-    for( it = m_items.begin(), it_end = m_items.end(); it != it_end; ++it )
-    {
-        VERTEX_ITEM* item = *it;
-        int itemOffset    = item->GetOffset();
-        int itemSize      = item->GetSize();
-
-        // Move an item to the new container
-        glCopyBufferSubData( GL_ARRAY_BUFFER, GL_ELEMENT_ARRAY_BUFFER,
-                itemOffset * VERTEX_SIZE, newOffset * VERTEX_SIZE, itemSize * VERTEX_SIZE );
-
-        // Update new offset
-        item->setOffset( newOffset );
+    if( m_isMapped )
+        buffer.m_vertices = static_cast<VERTEX*>( glMapBuffer( GL_ARRAY_BUFFER, GL_READ_WRITE ) );
 
-        // Move to the next free space
-        newOffset += itemSize;
-    }
+    glBindBuffer( GL_ARRAY_BUFFER, 0 );
 
-    // Move the current item and place it at the end
-    if( m_item->GetSize() > 0 )
+    if( checkGlError( "allocating video memory for cached container", false ) != GL_NO_ERROR
+            || ( m_isMapped && !buffer.m_vertices ) )
     {
-        glCopyBufferSubData( GL_ARRAY_BUFFER, GL_ELEMENT_ARRAY_BUFFER,
-                m_item->GetOffset() * VERTEX_SIZE, newOffset * VERTEX_SIZE,
-                m_item->GetSize() * VERTEX_SIZE );
-
-        m_item->setOffset( newOffset );
-        m_chunkOffset = newOffset;
+        glDeleteBuffers( 1, &buffer.m_handle );
+        return false;
     }
 
-    // Cleanup
-    glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, 0 );
-    glBindBuffer( GL_ARRAY_BUFFER, 0 );
-
-    // Previously we have unmapped the array buffer, now when it is also
-    // unbound, it may be officially marked as unmapped
-    m_isMapped = false;
-    glDeleteBuffers( 1, &m_glBufferHandle );
-
-    // Switch to the new vertex buffer
-    m_glBufferHandle = newBuffer;
-    Map();
-    checkGlError( "switching buffers during defragmentation" );
+    m_buffers.push_back( buffer );
+    m_currentSize += aSize;
+    addFreeChunk( buffer.m_offset, aSize );
 
 #ifdef __WXDEBUG__
     totalTime.Stop();
 
     wxLogTrace( "GAL_CACHED_CONTAINER_GPU",
-                "Defragmented container storing %d vertices / %.1f ms",
-                m_currentSize - m_freeSpace, totalTime.msecs() );
+                "Added a buffer of %d vertices (%d buffers, %d vertices) / %.1f ms",
+                aSize, (int) m_buffers.size(), m_currentSize, totalTime.msecs() );
 #endif /* __WXDEBUG__ */
 
-    m_freeSpace += ( aNewSize - m_currentSize );
-    m_currentSize = aNewSize;
-
-    // Now there is only one big chunk of free memory
-    m_freeChunks.clear();
-    m_freeChunks.insert( std::make_pair( m_freeSpace, m_currentSize - m_freeSpace ) );
-
     return true;
 }
 
 
-bool CACHED_CONTAINER_GPU::defragmentResizeMemcpy( unsigned int aNewSize )
+bool CACHED_CONTAINER_GPU::makeRoom( unsigned int aSize )
 {
-    wxCHECK( IsMapped(), false );
+    // Double the container size, with a buffer large enough for the requested chunk
+    return addBuffer( std::max( aSize, m_currentSize ) );
+}
 
-    wxLogTrace( "GAL_CACHED_CONTAINER_GPU",
-            wxT( "Resizing & defragmenting container (memcpy) from %d to %d" ),
-            m_currentSize, aNewSize );
 
-    // No shrinking if we cannot fit all the data
-    if( usedSpace() > aNewSize )
+bool CACHED_CONTAINER_GPU::defragmentResize( unsigned int aNewSize )
+{
+    // The stored data does not move, so there is no shrinking
+    if( aNewSize <= m_currentSize )
         return false;
 
-#ifdef __WXDEBUG__
-    PROF_COUNTER totalTime;
-#endif /* __WXDEBUG__ */
-
-    GLuint newBuffer;
-    VERTEX* newBufferMem;
-
-    // Create the destination buffer
-    glGenBuffers( 1, &newBuffer );
-
-    // It would be best to use GL_COPY_WRITE_BUFFER here,
-    // but it is not available everywhere
-#ifdef __WXDEBUG__
-    GLint eaBuffer = -1;
-    glGetIntegerv( GL_ELEMENT_ARRAY_BUFFER_BINDING, &eaBuffer );
-    wxASSERT( eaBuffer == 0 );
-#endif /* __WXDEBUG__ */
-    glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, newBuffer );
-    glBufferData( GL_ELEMENT_ARRAY_BUFFER, aNewSize * VERTEX_SIZE, NULL, GL_DYNAMIC_DRAW );
-    newBufferMem = static_cast<VERTEX*>( glMapBuffer( GL_ELEMENT_ARRAY_BUFFER, GL_WRITE_ONLY ) );
-    checkGlError( "creating buffer during defragmentation" );
-
-    defragment( newBufferMem );
-
-    // Cleanup
-    glUnmapBuffer( GL_ELEMENT_ARRAY_BUFFER );
-    glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, 0 );
-    Unmap();
-    glDeleteBuffers( 1, &m_glBufferHandle );
-
-    // Switch to the new vertex buffer
-    m_glBufferHandle = newBuffer;
-    Map();
-    checkGlError( "switching buffers during defragmentation" );
-
-#ifdef __WXDEBUG__
-    totalTime.Stop();
-
-    wxLogTrace( "GAL_CACHED_CONTAINER_GPU",
-                "Defragmented container storing %d vertices / %.1f ms",
-                m_currentSize - m_freeSpace, totalTime.msecs() );
-#endif /* __WXDEBUG__ */
-
-    m_freeSpace += ( aNewSize - m_currentSize );
-    m_currentSize = aNewSize;
-
-    // Now there is only one big chunk of free memory
-    m_freeChunks.clear();
-    m_freeChunks.insert( std::make_pair( m_freeSpace, m_currentSize - m_freeSpace ) );
-
-    return true;
+    return addBuffer( aNewSize - m_currentSize );
 }
@@ -27,8 +27,11 @@
 #include <gal/opengl/cached_container_ram.h>
 #include <gal/opengl/noncached_container.h>
 #include <gal/opengl/shader.h>
+#include <gal/opengl/shared_mesh.h>
 #include <gal/opengl/utils.h>
 
+#include <glm/gtc/type_ptr.hpp>
+
 #include <typeinfo>
 #include <confirm.h>
 
@@ -73,11 +76,9 @@ void GPU_MANAGER::SetShader( SHADER& aShader )
 
 // Cached manager
 GPU_CACHED_MANAGER::GPU_CACHED_MANAGER( VERTEX_CONTAINER* aContainer ) :
-    GPU_MANAGER( aContainer ), m_buffersInitialized( false ), m_indicesPtr( NULL ),
-    m_indicesBuffer( 0 ), m_indicesSize( 0 ), m_indicesCapacity( 0 )
+    GPU_MANAGER( aContainer ), m_buffersInitialized( false ), m_indicesBuffer( 0 ),
+    m_indicesSize( 0 )
 {
-    // Allocate the biggest possible buffer for indices
-    resizeIndices( aContainer->GetSize() );
 }
 
 
@@ -102,13 +103,18 @@ void GPU_CACHED_MANAGER::BeginDrawing()
         m_buffersInitialized = true;
     }
 
-    if( m_container->IsDirty() )
-        resizeIndices( m_container->GetSize() );
+    CACHED_CONTAINER* cached = static_cast<CACHED_CONTAINER*>( m_container );
 
     // Number of vertices to be drawn in the EndDrawing()
     m_indicesSize = 0;
-    // Set the indices pointer to the beginning of the indices-to-draw buffer
-    m_indicesPtr = m_indices.get();
+
+    // The vectors keep their capacity between frames
+    m_indices.resize( cached->GetBufferCount() );
+
+    for( std::vector<GLuint>& indices : m_indices )
+        indices.clear();
+
+    m_meshes.clear();
 
     m_isDrawing = true;
 }
@@ -118,10 +124,18 @@ void GPU_CACHED_MANAGER::DrawIndices( unsigned int aOffset, unsigned int aSize )
 {
     wxASSERT( m_isDrawing );
 
-    // Copy indices of items that should be drawn to GPU memory
-    for( unsigned int i = aOffset; i < aOffset + aSize; *m_indicesPtr++ = i++ );
+    CACHED_CONTAINER* cached = static_cast<CACHED_CONTAINER*>( m_container );
 
-    m_indicesSize += aSize;
+    // An item is always stored in a single vertex buffer
+    addIndices( cached->FindBuffer( aOffset ), aOffset, aSize );
+}
+
+
+void GPU_CACHED_MANAGER::DrawMesh( const MESH_INSTANCE& aMesh )
+{
+    wxASSERT( m_isDrawing );
+
+    m_meshes.push_back( &aMesh );
 }
 
 
@@ -129,9 +143,10 @@ void GPU_CACHED_MANAGER::DrawAll()
 {
     wxASSERT( m_isDrawing );
 
-    for( unsigned int i = 0; i < m_indicesSize; *m_indicesPtr++ = i++ );
+    CACHED_CONTAINER* cached = static_cast<CACHED_CONTAINER*>( m_container );
 
-    m_indicesSize = m_container->GetSize();
+    for( unsigned int i = 0; i < cached->GetBufferCount(); ++i )
+        addIndices( i, cached->GetBufferOffset( i ), cached->GetBufferSize( i ) );
 }
 
 
@@ -148,7 +163,7 @@ void GPU_CACHED_MANAGER::EndDrawing()
     if( cached->IsMapped() )
         cached->Unmap();
 
-    if( m_indicesSize == 0 )
+    if( m_indicesSize == 0 && m_meshes.empty() )
     {
         m_isDrawing = false;
         return;
@@ -163,24 +178,61 @@ void GPU_CACHED_MANAGER::EndDrawing()
     glEnableClientState( GL_VERTEX_ARRAY );
     glEnableClientState( GL_COLOR_ARRAY );
 
-    // Bind vertices data buffers
-    glBindBuffer( GL_ARRAY_BUFFER, cached->GetBufferHandle() );
-    glVertexPointer( COORD_STRIDE, GL_FLOAT, VERTEX_SIZE, (GLvoid*) COORD_OFFSET );
-    glColorPointer( COLOR_STRIDE, GL_UNSIGNED_BYTE, VERTEX_SIZE, (GLvoid*) COLOR_OFFSET );
-
     if( m_shader != NULL )    // Use shader if applicable
     {
         m_shader->Use();
         glEnableVertexAttribArray( m_shaderAttrib );
-        glVertexAttribPointer( m_shaderAttrib, SHADER_STRIDE, GL_FLOAT, GL_FALSE,
-                               VERTEX_SIZE, (GLvoid*) SHADER_OFFSET );
     }
 
     glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, m_indicesBuffer );
-    glBufferData( GL_ELEMENT_ARRAY_BUFFER, m_indicesSize * sizeof(int),
-            (GLvoid*) m_indices.get(), GL_DYNAMIC_DRAW );
 
-    glDrawElements( GL_TRIANGLES, m_indicesSize, GL_UNSIGNED_INT, 0 );
+    for( unsigned int i = 0; i < m_indices.size(); ++i )
+    {
+        const std::vector<GLuint>& indices = m_indices[i];
+
+        if( indices.empty() )
+            continue;
+
+        // Bind vertices data buffers
+        glBindBuffer( GL_ARRAY_BUFFER, cached->GetBufferHandle( i ) );
+        glVertexPointer( COORD_STRIDE, GL_FLOAT, VERTEX_SIZE, (GLvoid*) COORD_OFFSET );
+        glColorPointer( COLOR_STRIDE, GL_UNSIGNED_BYTE, VERTEX_SIZE, (GLvoid*) COLOR_OFFSET );
+
+        if( m_shader != NULL )
+        {
+            glVertexAttribPointer( m_shaderAttrib, SHADER_STRIDE, GL_FLOAT, GL_FALSE,
+                                   VERTEX_SIZE, (GLvoid*) SHADER_OFFSET );
+        }
+
+        glBufferData( GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint),
+                      (GLvoid*) indices.data(), GL_DYNAMIC_DRAW );
+
+        glDrawElements( GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0 );
+    }
+
+    if( !m_meshes.empty() )
+    {
+        // Meshes have a single color and no shader parameters
+        glDisableClientState( GL_COLOR_ARRAY );
+
+        if( m_shader != NULL )
+        {
+            glDisableVertexAttribArray( m_shaderAttrib );
+            glVertexAttrib4f( m_shaderAttrib, SHADER_NONE, 0.0f, 0.0f, 0.0f );
+        }
+
+        for( const MESH_INSTANCE* mesh : m_meshes )
+        {
+            glBindBuffer( GL_ARRAY_BUFFER, mesh->m_mesh->GetBuffer() );
+            glVertexPointer( 2, GL_FLOAT, 0, 0 );
+            glColor4ubv( mesh->m_color );
+
+            glPushMatrix();
+            glMultMatrixf( glm::value_ptr( mesh->m_transform ) );
+            glDrawArrays( GL_TRIANGLES, 0, mesh->m_mesh->GetVertexCount() );
+            glPopMatrix();
+        }
+    }
 
 #ifdef __WXDEBUG__
     wxLogTrace( "GAL_PROFILE", wxT( "Cached manager size: %d" ), m_indicesSize );
@@ -210,13 +262,24 @@ void GPU_CACHED_MANAGER::EndDrawing()
 }
 
 
-void GPU_CACHED_MANAGER::resizeIndices( unsigned int aNewSize )
+void GPU_CACHED_MANAGER::addIndices( unsigned int aBuffer, unsigned int aOffset,
+                                     unsigned int aSize )
 {
-    if( aNewSize > m_indicesCapacity )
-    {
-        m_indicesCapacity = aNewSize;
-        m_indices.reset( new GLuint[m_indicesCapacity] );
-    }
+    // Buffers may be added to the container while drawing
+    if( aBuffer >= m_indices.size() )
+        m_indices.resize( aBuffer + 1 );
+
+    std::vector<GLuint>& indices = m_indices[aBuffer];
+    size_t               first = indices.size();
+    GLuint               index = aOffset - static_cast<CACHED_CONTAINER*>( m_container )
+                                                   ->GetBufferOffset( aBuffer );
+
+    indices.resize( first + aSize );
+
+    // Copy indices of items that should be drawn to GPU memory
+    for( GLuint* ptr = &indices[first], *end = ptr + aSize; ptr < end; *ptr++ = index++ );
+
+    m_indicesSize += aSize;
 }
 
 
@@ -239,6 +302,12 @@ void GPU_NONCACHED_MANAGER::DrawIndices( unsigned int aOffset, unsigned int aSiz
 }
 
 
+void GPU_NONCACHED_MANAGER::DrawMesh( const MESH_INSTANCE& aMesh )
+{
+    wxASSERT_MSG( false, wxT( "Not implemented yet" ) );
+}
+
+
 void GPU_NONCACHED_MANAGER::DrawAll()
 {
     // This is the default use case, nothing has to be done
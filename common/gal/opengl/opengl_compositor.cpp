@@ -32,7 +32,9 @@
 #include <gal/opengl/utils.h>
 
 #include <gal/color4d.h>
+#include <math/util.h>
 
+#include <algorithm>
 #include <cassert>
 #include <memory>
 #include <stdexcept>
@@ -42,7 +44,8 @@ using namespace KIGFX;
 OPENGL_COMPOSITOR::OPENGL_COMPOSITOR() :
     m_initialized( false ), m_curBuffer( 0 ),
     m_mainFbo( 0 ), m_depthBuffer( 0 ), m_curFbo( DIRECT_RENDERING ),
-    m_currentAntialiasingMode( OPENGL_ANTIALIASING_MODE::NONE )
+    m_currentAntialiasingMode( OPENGL_ANTIALIASING_MODE::NONE ), m_clipBuffer( 0 ),
+    m_scrollTexture( 0 )
 {
     m_antialiasing = std::make_unique<ANTIALIASING_NONE>( this );
 }
@@ -290,6 +293,8 @@ void OPENGL_COMPOSITOR::SetBuffer( unsigned int aBufferHandle )
     {
         glViewport( 0, 0, GetScreenSize().x, GetScreenSize().y );
     }
+
+    updateScissor();
 }
 
 
@@ -302,6 +307,118 @@ void OPENGL_COMPOSITOR::ClearBuffer( const COLOR4D& aColor )
 }
 
 
+void OPENGL_COMPOSITOR::SetClipRect( unsigned int aBufferHandle, const BOX2I* aRect )
+{
+    m_clipBuffer = aRect ? aBufferHandle : 0;
+
+    if( aRect )
+        m_clipRect = *aRect;
+
+    if( m_initialized )
+        updateScissor();
+}
+
+
+void OPENGL_COMPOSITOR::ScrollBuffer( unsigned int aBufferHandle, const VECTOR2I& aOffset )
+{
+    assert( m_initialized );
+    assert( aBufferHandle != 0 && aBufferHandle <= usedBuffers() );
+
+    unsigned int    oldBuffer = GetBuffer();
+    const VECTOR2U& dims = m_buffers[aBufferHandle - 1].dimensions;
+
+    // A texture cannot be copied onto itself, so the buffer goes through a scratch texture
+    if( !m_scrollTexture || m_scrollTextureSize != dims )
+    {
+        if( m_scrollTexture )
+            glDeleteTextures( 1, &m_scrollTexture );
+
+        glActiveTexture( GL_TEXTURE0 );
+        glGenTextures( 1, &m_scrollTexture );
+        glBindTexture( GL_TEXTURE_2D, m_scrollTexture );
+        glTexImage2D( GL_TEXTURE_2D, 0, GL_RGBA8, dims.x, dims.y, 0, GL_RGBA,
+                      GL_UNSIGNED_BYTE, NULL );
+        glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST );
+        glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST );
+        checkGlError( "creating scroll texture" );
+
+        m_scrollTextureSize = dims;
+    }
+
+    SetBuffer( aBufferHandle );
+
+    glReadBuffer( m_buffers[aBufferHandle - 1].attachmentPoint );
+    glActiveTexture( GL_TEXTURE0 );
+    glBindTexture( GL_TEXTURE_2D, m_scrollTexture );
+    glCopyTexSubImage2D( GL_TEXTURE_2D, 0, 0, 0, 0, 0, dims.x, dims.y );
+    checkGlError( "copying buffer to scroll texture" );
+
+    // Draw the copy back, shifted (the Y axis of the buffer points up)
+    float dx = 2.0f * aOffset.x / dims.x;
+    float dy = -2.0f * aOffset.y / dims.y;
+
+    glPushAttrib( GL_ENABLE_BIT );
+    glDisable( GL_DEPTH_TEST );
+    glDisable( GL_BLEND );
+    glEnable( GL_TEXTURE_2D );
+
+    glMatrixMode( GL_MODELVIEW );
+    glPushMatrix();
+    glLoadIdentity();
+    glMatrixMode( GL_PROJECTION );
+    glPushMatrix();
+    glLoadIdentity();
+
+    glBegin( GL_TRIANGLES );
+    glTexCoord2f(  0.0f,  1.0f );
+    glVertex2f  ( -1.0f + dx,  1.0f + dy );
+    glTexCoord2f(  0.0f,  0.0f );
+    glVertex2f  ( -1.0f + dx, -1.0f + dy );
+    glTexCoord2f(  1.0f,  1.0f );
+    glVertex2f  (  1.0f + dx,  1.0f + dy );
+
+    glTexCoord2f(  1.0f,  1.0f );
+    glVertex2f  (  1.0f + dx,  1.0f + dy );
+    glTexCoord2f(  0.0f,  0.0f );
+    glVertex2f  ( -1.0f + dx, -1.0f + dy );
+    glTexCoord2f(  1.0f,  0.0f );
+    glVertex2f  (  1.0f + dx, -1.0f + dy );
+    glEnd();
+
+    glPopMatrix();
+    glMatrixMode( GL_MODELVIEW );
+    glPopMatrix();
+
+    glPopAttrib();
+    glBindTexture( GL_TEXTURE_2D, 0 );
+
+    SetBuffer( oldBuffer );
+}
+
+
+void OPENGL_COMPOSITOR::updateScissor()
+{
+    if( m_clipBuffer == 0 || m_curFbo == DIRECT_RENDERING || m_curBuffer + 1 != m_clipBuffer )
+    {
+        glDisable( GL_SCISSOR_TEST );
+        return;
+    }
+
+    // The clipping rectangle is given in pixels of the screen, with the Y axis pointing down
+    const VECTOR2U& dims = m_buffers[m_curBuffer].dimensions;
+    double          scaleX = m_width ? (double) dims.x / m_width : 1.0;
+    double          scaleY = m_height ? (double) dims.y / m_height : 1.0;
+    int             left = KiROUND( m_clipRect.GetLeft() * scaleX );
+    int             right = KiROUND( m_clipRect.GetRight() * scaleX );
+    int             top = KiROUND( m_clipRect.GetTop() * scaleY );
+    int             bottom = KiROUND( m_clipRect.GetBottom() * scaleY );
+
+    glScissor( left, (int) dims.y - bottom, std::max( 0, right - left ),
+               std::max( 0, bottom - top ) );
+    glEnable( GL_SCISSOR_TEST );
+}
+
+
 VECTOR2U OPENGL_COMPOSITOR::GetScreenSize() const
 {
     return { m_width, m_height };
@@ -399,6 +516,13 @@ void OPENGL_COMPOSITOR::clean()
     }
 
     m_buffers.clear();
+    m_clipBuffer = 0;
+
+    if( m_scrollTexture )
+    {
+        glDeleteTextures( 1, &m_scrollTexture );
+        m_scrollTexture = 0;
+    }
 
     glDeleteFramebuffersEXT( 1, &m_mainFbo );
     glDeleteRenderbuffersEXT( 1, &m_depthBuffer );
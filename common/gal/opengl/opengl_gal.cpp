@@ -33,6 +33,7 @@
 #endif
 
 #include <gal/opengl/opengl_gal.h>
+#include <gal/opengl/shared_mesh.h>
 #include <gal/opengl/utils.h>
 #include <gal/definitions.h>
 #include <gl_context_mgr.h>
@@ -42,9 +43,9 @@
 #include <math/util.h>      // for KiROUND
 
 #include <macros.h>
+#include <profile.h>
 
 #ifdef __WXDEBUG__
-#include <profile.h>
 #include <wx/log.h>
 #endif /* __WXDEBUG__ */
 
@@ -241,7 +242,11 @@ OPENGL_GAL::OPENGL_GAL( GAL_DISPLAY_OPTIONS& aDisplayOptions, wxWindow* aParent,
 
     // Initialize the flags
     isFramebufferInitialized = false;
+    isMainBufferComplete = false;
     isBitmapFontInitialized  = false;
+    gpuTimerQueries[0][0] = 0;
+    gpuTimerPending[0] = gpuTimerPending[1] = false;
+    gpuTimerFrame = 0;
     isInitialized            = false;
     isGrouping               = false;
     groupCounter             = 0;
@@ -301,6 +306,10 @@ OPENGL_GAL::~OPENGL_GAL()
     glFlush();
     gluDeleteTess( tesselator );
     ClearCache();
+    SHARED_MESH_CACHE::Get().ReleaseBuffers();
+
+    if( gpuTimerQueries[0][0] )
+        glDeleteQueries( 4, &gpuTimerQueries[0][0] );
 
     delete compositor;
 
@@ -395,6 +404,9 @@ void OPENGL_GAL::beginDrawing()
     if( !isInitialized )
         init();
 
+    // Delete the shared meshes dropped by any canvas since the last frame
+    SHARED_MESH_CACHE::Get().ReleaseBuffers();
+
     // Set up the view port
     glMatrixMode( GL_PROJECTION );
     glLoadIdentity();
@@ -410,6 +422,7 @@ void OPENGL_GAL::beginDrawing()
         overlayBuffer = compositor->CreateBuffer();
 
         isFramebufferInitialized = true;
+        isMainBufferComplete = false;
     }
 
     compositor->Begin();
@@ -528,15 +541,34 @@ void OPENGL_GAL::endDrawing()
     PROF_COUNTER totalRealTime( "OPENGL_GAL::endDrawing()", true );
 #endif /* __WXDEBUG__ */
 
+    PROF_COUNTER endDrawingTime;
+    bool         gpuTimers = collectFrameStats && GLEW_ARB_timer_query;
+
+    if( gpuTimers )
+    {
+        if( !gpuTimerQueries[0][0] )
+            glGenQueries( 4, &gpuTimerQueries[0][0] );
+
+        glBeginQuery( GL_TIME_ELAPSED, gpuTimerQueries[gpuTimerFrame][0] );
+    }
+
     // Cached & non-cached containers are rendered to the same buffer
     compositor->SetBuffer( mainBuffer );
     nonCachedManager->EndDrawing();
     cachedManager->EndDrawing();
+    compositor->SetClipRect( mainBuffer, nullptr );
+    isMainBufferComplete = true;
 
     // Overlay container is rendered to a different buffer
     compositor->SetBuffer( overlayBuffer );
     overlayManager->EndDrawing();
 
+    if( gpuTimers )
+    {
+        glEndQuery( GL_TIME_ELAPSED );
+        glBeginQuery( GL_TIME_ELAPSED, gpuTimerQueries[gpuTimerFrame][1] );
+    }
+
     // Be sure that the framebuffer is not colorized (happens on specific GPU&drivers combinations)
     glColor4d( 1.0, 1.0, 1.0, 1.0 );
 
@@ -544,10 +576,25 @@ void OPENGL_GAL::endDrawing()
     compositor->DrawBuffer( mainBuffer );
     compositor->DrawBuffer( overlayBuffer );
     compositor->Present();
+
+    if( gpuTimers )
+    {
+        glEndQuery( GL_TIME_ELAPSED );
+        gpuTimerPending[gpuTimerFrame] = true;
+        readGpuTimers();
+    }
+
     blitCursor();
 
     SwapBuffers();
 
+    if( collectFrameStats )
+    {
+        frameStats.m_endDrawingTime = endDrawingTime.msecs();
+        frameStats.m_cacheMemory = cachedManager->GetMemoryUsage()
+                                   + SHARED_MESH_CACHE::Get().GetMemoryUsage();
+    }
+
 #ifdef __WXDEBUG__
     totalRealTime.Stop();
     wxLogTrace( "GAL_PROFILE", wxT( "OPENGL_GAL::endDrawing(): %.1f ms" ), totalRealTime.msecs() );
@@ -937,6 +984,64 @@ void OPENGL_GAL::DrawPolyline( const SHAPE_LINE_CHAIN& aLineChain )
 }
 
 
+void OPENGL_GAL::readGpuTimers()
+{
+    gpuTimerFrame = 1 - gpuTimerFrame;
+
+    if( !gpuTimerPending[gpuTimerFrame] )
+        return;
+
+    GLuint available = 0;
+
+    glGetQueryObjectuiv( gpuTimerQueries[gpuTimerFrame][1], GL_QUERY_RESULT_AVAILABLE,
+                         &available );
+
+    // Never wait for the GPU, the previous results are kept instead
+    if( !available )
+        return;
+
+    GLuint64 itemsTime = 0;
+    GLuint64 compositingTime = 0;
+
+    glGetQueryObjectui64v( gpuTimerQueries[gpuTimerFrame][0], GL_QUERY_RESULT, &itemsTime );
+    glGetQueryObjectui64v( gpuTimerQueries[gpuTimerFrame][1], GL_QUERY_RESULT,
+                           &compositingTime );
+
+    frameStats.m_gpuItemsTime = itemsTime / 1e6;
+    frameStats.m_gpuCompositingTime = compositingTime / 1e6;
+    gpuTimerPending[gpuTimerFrame] = false;
+}
+
+
+void OPENGL_GAL::DrawPolylines( const std::vector<VECTOR2D>& aPoints,
+                                const std::vector<int>& aSizes )
+{
+    int segments = 0;
+
+    for( int size : aSizes )
+        segments += std::max( 0, size - 1 );
+
+    if( segments == 0 )
+        return;
+
+    currentManager->Color( strokeColor.r, strokeColor.g, strokeColor.b, strokeColor.a );
+
+    // Allocate the vertices of all the segments at once
+    if( !currentManager->Reserve( 6 * segments ) )
+        return;
+
+    const VECTOR2D* points = aPoints.data();
+
+    for( int size : aSizes )
+    {
+        for( int i = 1; i < size; ++i )
+            drawLineQuad( points[i - 1], points[i], false );
+
+        points += size;
+    }
+}
+
+
 void OPENGL_GAL::DrawPolygon( const std::deque<VECTOR2D>& aPointList )
 {
     auto points = std::unique_ptr<GLdouble[]>( new GLdouble[3 * aPointList.size()] );
@@ -978,17 +1083,26 @@ void OPENGL_GAL::drawTriangulatedPolyset( const SHAPE_POLY_SET& aPolySet )
 
     if( isFillEnabled )
     {
-        for( unsigned int j = 0; j < aPolySet.TriangulatedPolyCount(); ++j )
-        {
-            auto triPoly = aPolySet.TriangulatedPolygon( j );
+        // Large triangulations (zone fills) are stored once for all the canvases
+        std::shared_ptr<SHARED_MESH> mesh;
 
-            for( size_t i = 0; i < triPoly->GetTriangleCount(); i++ )
+        if( isGrouping )
+            mesh = SHARED_MESH_CACHE::Get().Acquire( aPolySet );
+
+        if( !mesh || !currentManager->Mesh( mesh, layerDepth ) )
+        {
+            for( unsigned int j = 0; j < aPolySet.TriangulatedPolyCount(); ++j )
             {
-                VECTOR2I a, b, c;
-                triPoly->GetTriangle( i, a, b, c );
-                currentManager->Vertex( a.x, a.y, layerDepth );
-                currentManager->Vertex( b.x, b.y, layerDepth );
-                currentManager->Vertex( c.x, c.y, layerDepth );
+                auto triPoly = aPolySet.TriangulatedPolygon( j );
+
+                for( size_t i = 0; i < triPoly->GetTriangleCount(); i++ )
+                {
+                    VECTOR2I a, b, c;
+                    triPoly->GetTriangle( i, a, b, c );
+                    currentManager->Vertex( a.x, a.y, layerDepth );
+                    currentManager->Vertex( b.x, b.y, layerDepth );
+                    currentManager->Vertex( c.x, c.y, layerDepth );
+                }
             }
         }
     }
@@ -1598,6 +1712,42 @@ void OPENGL_GAL::ClearTarget( RENDER_TARGET aTarget )
 }
 
 
+bool OPENGL_GAL::SetClipRect( const BOX2I& aRect )
+{
+    // A partial redraw of new buffers would leave garbage on the screen
+    if( !isFramebufferInitialized || !isMainBufferComplete )
+        return false;
+
+    double scaleFactor = GetBackingScaleFactor();
+    BOX2I  rect( VECTOR2I( KiROUND( aRect.GetX() * scaleFactor ),
+                           KiROUND( aRect.GetY() * scaleFactor ) ),
+                 VECTOR2I( KiROUND( aRect.GetWidth() * scaleFactor ),
+                           KiROUND( aRect.GetHeight() * scaleFactor ) ) );
+
+    compositor->SetClipRect( mainBuffer, &rect );
+
+    return true;
+}
+
+
+bool OPENGL_GAL::ScrollTargets( const VECTOR2I& aOffset )
+{
+    if( !isFramebufferInitialized || !isMainBufferComplete )
+        return false;
+
+    // A fractional shift of the buffer pixels would blur the kept contents
+    VECTOR2D offset = VECTOR2D( aOffset ) * GetBackingScaleFactor();
+    VECTOR2I pixels( KiROUND( offset.x ), KiROUND( offset.y ) );
+
+    if( offset != VECTOR2D( pixels ) )
+        return false;
+
+    compositor->ScrollBuffer( mainBuffer, pixels );
+
+    return true;
+}
+
+
 void OPENGL_GAL::DrawCursor( const VECTOR2D& aCursorPosition )
 {
     // Now we should only store the position of the mouse cursor
@@ -1608,7 +1758,8 @@ void OPENGL_GAL::DrawCursor( const VECTOR2D& aCursorPosition )
 }
 
 
-void OPENGL_GAL::drawLineQuad( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint )
+void OPENGL_GAL::drawLineQuad( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint,
+                               bool aReserve )
 {
     /* Helper drawing:                   ____--- v3       ^
      *                           ____---- ...   \          \
@@ -1630,7 +1781,8 @@ void OPENGL_GAL::drawLineQuad( const VECTOR2D& aStartPoint, const VECTOR2D& aEnd
 
     VECTOR2D vs( v2.x - v1.x, v2.y - v1.y );
 
-    currentManager->Reserve( 6 );
+    if( aReserve )
+        currentManager->Reserve( 6 );
 
     // Line width is maintained by the vertex shader
     currentManager->Shader( SHADER_LINE_A, lineWidth, vs.x, vs.y );
@@ -0,0 +1,126 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <gal/opengl/shared_mesh.h>
+#include <gal/opengl/utils.h>
+#include <geometry/shape_poly_set.h>
+
+using namespace KIGFX;
+
+SHARED_MESH::SHARED_MESH( GLuint aBuffer, unsigned int aVertexCount ) :
+    m_buffer( aBuffer ), m_vertexCount( aVertexCount )
+{
+    SHARED_MESH_CACHE::Get().m_memoryUsage += aVertexCount * 2 * sizeof( GLfloat );
+}
+
+
+SHARED_MESH::~SHARED_MESH()
+{
+    SHARED_MESH_CACHE& cache = SHARED_MESH_CACHE::Get();
+
+    cache.m_memoryUsage -= m_vertexCount * 2 * sizeof( GLfloat );
+    cache.m_releasedBuffers.push_back( m_buffer );
+}
+
+
+SHARED_MESH_CACHE& SHARED_MESH_CACHE::Get()
+{
+    static SHARED_MESH_CACHE cache;
+
+    return cache;
+}
+
+
+std::shared_ptr<SHARED_MESH> SHARED_MESH_CACHE::Acquire( const SHAPE_POLY_SET& aPolySet )
+{
+    unsigned int triangles = 0;
+
+    for( unsigned int j = 0; j < aPolySet.TriangulatedPolyCount(); ++j )
+        triangles += aPolySet.TriangulatedPolygon( j )->GetTriangleCount();
+
+    if( triangles < MIN_TRIANGLES )
+        return nullptr;
+
+    std::string key = aPolySet.GetHash().Format();
+    auto        it = m_meshes.find( key );
+
+    if( it != m_meshes.end() )
+    {
+        if( std::shared_ptr<SHARED_MESH> mesh = it->second.lock() )
+            return mesh;
+    }
+
+    std::vector<GLfloat> coords;
+    coords.reserve( triangles * 6 );
+
+    for( unsigned int j = 0; j < aPolySet.TriangulatedPolyCount(); ++j )
+    {
+        auto triPoly = aPolySet.TriangulatedPolygon( j );
+
+        for( size_t i = 0; i < triPoly->GetTriangleCount(); i++ )
+        {
+            VECTOR2I a, b, c;
+            triPoly->GetTriangle( i, a, b, c );
+
+            coords.insert( coords.end(), { (GLfloat) a.x, (GLfloat) a.y, (GLfloat) b.x,
+                                           (GLfloat) b.y, (GLfloat) c.x, (GLfloat) c.y } );
+        }
+    }
+
+    GLuint buffer;
+
+    glGenBuffers( 1, &buffer );
+    glBindBuffer( GL_ARRAY_BUFFER, buffer );
+    glBufferData( GL_ARRAY_BUFFER, coords.size() * sizeof( GLfloat ), coords.data(),
+                  GL_STATIC_DRAW );
+    glBindBuffer( GL_ARRAY_BUFFER, 0 );
+
+    if( checkGlError( "uploading a shared mesh", false ) != GL_NO_ERROR )
+    {
+        glDeleteBuffers( 1, &buffer );
+        return nullptr;
+    }
+
+    auto mesh = std::make_shared<SHARED_MESH>( buffer, triangles * 3 );
+    m_meshes[key] = mesh;
+
+    return mesh;
+}
+
+
+void SHARED_MESH_CACHE::ReleaseBuffers()
+{
+    if( m_releasedBuffers.empty() )
+        return;
+
+    glDeleteBuffers( m_releasedBuffers.size(), m_releasedBuffers.data() );
+    m_releasedBuffers.clear();
+
+    for( auto it = m_meshes.begin(); it != m_meshes.end(); )
+    {
+        if( it->second.expired() )
+            it = m_meshes.erase( it );
+        else
+            ++it;
+    }
+}
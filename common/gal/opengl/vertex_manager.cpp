@@ -154,6 +154,38 @@ bool VERTEX_MANAGER::Vertices( const VERTEX aVertices[], unsigned int aSize )
 }
 
 
+bool VERTEX_MANAGER::Mesh( const std::shared_ptr<SHARED_MESH>& aMesh, GLfloat aDepth )
+{
+    if( !m_container->IsCached() )
+        return false;
+
+    VERTEX_ITEM* item = static_cast<CACHED_CONTAINER*>( m_container.get() )->GetItem();
+
+    if( !item )
+        return false;
+
+    MESH_INSTANCE instance;
+
+    instance.m_mesh = aMesh;
+    instance.m_transform = m_noTransform ? glm::mat4( 1.0f ) : m_transform;
+
+    // The vertices get the depth the transformation gives to aDepth, as in putVertex()
+    GLfloat depth = ( instance.m_transform * glm::vec4( 0.0f, 0.0f, aDepth, 1.0f ) ).z;
+
+    for( int col = 0; col < 3; ++col )
+        instance.m_transform[col][2] = 0.0f;
+
+    instance.m_transform[3][2] = depth;
+
+    for( unsigned int i = 0; i < COLOR_STRIDE; ++i )
+        instance.m_color[i] = m_color[i];
+
+    item->m_meshes.push_back( instance );
+
+    return true;
+}
+
+
 void VERTEX_MANAGER::SetItem( VERTEX_ITEM& aItem ) const
 {
     m_container->SetItem( &aItem );
@@ -172,8 +204,16 @@ void VERTEX_MANAGER::FreeItem( VERTEX_ITEM& aItem ) const
 }
 
 
-void VERTEX_MANAGER::ChangeItemColor( const VERTEX_ITEM& aItem, const COLOR4D& aColor ) const
+void VERTEX_MANAGER::ChangeItemColor( VERTEX_ITEM& aItem, const COLOR4D& aColor ) const
 {
+    for( MESH_INSTANCE& mesh : aItem.m_meshes )
+    {
+        mesh.m_color[0] = aColor.r * 255.0;
+        mesh.m_color[1] = aColor.g * 255.0;
+        mesh.m_color[2] = aColor.b * 255.0;
+        mesh.m_color[3] = aColor.a * 255.0;
+    }
+
     unsigned int size   = aItem.GetSize();
     unsigned int offset = aItem.GetOffset();
 
@@ -192,8 +232,11 @@ void VERTEX_MANAGER::ChangeItemColor( const VERTEX_ITEM& aItem, const COLOR4D& a
 }
 
 
-void VERTEX_MANAGER::ChangeItemDepth( const VERTEX_ITEM& aItem, GLfloat aDepth ) const
+void VERTEX_MANAGER::ChangeItemDepth( VERTEX_ITEM& aItem, GLfloat aDepth ) const
 {
+    for( MESH_INSTANCE& mesh : aItem.m_meshes )
+        mesh.m_transform[3][2] = aDepth;
+
     unsigned int size   = aItem.GetSize();
     unsigned int offset = aItem.GetOffset();
 
@@ -241,7 +284,11 @@ void VERTEX_MANAGER::DrawItem( const VERTEX_ITEM& aItem ) const
     int size = aItem.GetSize();
     int offset = aItem.GetOffset();
 
-    m_gpu->DrawIndices( offset, size );
+    if( size > 0 )
+        m_gpu->DrawIndices( offset, size );
+
+    for( const MESH_INSTANCE& mesh : aItem.m_meshes )
+        m_gpu->DrawMesh( mesh );
 }
 
 
@@ -289,3 +336,9 @@ void VERTEX_MANAGER::EnableDepthTest( bool aEnabled )
 {
     m_gpu->EnableDepthTest( aEnabled );
 }
+
+
+size_t VERTEX_MANAGER::GetMemoryUsage() const
+{
+    return (size_t) m_container->GetSize() * VERTEX_SIZE;
+}
@@ -42,78 +42,72 @@ const double STROKE_FONT::STROKE_FONT_SCALE = 1.0 / 21.0;
 const double STROKE_FONT::ITALIC_TILT = 1.0 / 8;
 
 
-GLYPH_LIST*         g_newStrokeFontGlyphs = nullptr;     ///< Glyph list
-std::vector<BOX2D>* g_newStrokeFontGlyphBoundingBoxes;   ///< Bounding boxes of the glyphs
-
-
 STROKE_FONT::STROKE_FONT( GAL* aGal ) :
     m_gal( aGal ), m_glyphs( nullptr ), m_glyphBoundingBoxes( nullptr )
 {
 }
 
 
-bool STROKE_FONT::LoadNewStrokeFont( const char* const aNewStrokeFont[], int aNewStrokeFontSize )
+GLYPH_LIST* STROKE_FONT::parseStrokeFont( const char* const aNewStrokeFont[],
+                                          int aNewStrokeFontSize )
 {
-    if( g_newStrokeFontGlyphs )
-    {
-        m_glyphs = g_newStrokeFontGlyphs;
-        m_glyphBoundingBoxes = g_newStrokeFontGlyphBoundingBoxes;
-        return true;
-    }
-
-    g_newStrokeFontGlyphs = new GLYPH_LIST;
-    g_newStrokeFontGlyphs->reserve( aNewStrokeFontSize );
-
-    g_newStrokeFontGlyphBoundingBoxes = new std::vector<BOX2D>;
-    g_newStrokeFontGlyphBoundingBoxes->reserve( aNewStrokeFontSize );
+    GLYPH_LIST* font = new GLYPH_LIST;
+    size_t      pointCount = 0;
+    size_t      strokeCount = 0;
 
+    // First pass: count the points and strokes, to store them without any reallocation.
+    // The font has tens of thousands of glyphs, this pass is cheap compared to reallocating
     for( int j = 0; j < aNewStrokeFontSize; j++ )
     {
-        GLYPH*   glyph = new GLYPH;
-        double   glyphStartX = 0.0;
-        double   glyphEndX = 0.0;
-        double   glyphWidth = 0.0;
-
-        std::vector<VECTOR2D>* pointList = nullptr;
-
-        int strokes = 0;
-        int i = 0;
+        bool penDown = false;
 
-        while( aNewStrokeFont[j][i] )
+        for( int i = 2; aNewStrokeFont[j][i] && aNewStrokeFont[j][i + 1]; i += 2 )
         {
+            if( aNewStrokeFont[j][i] == ' ' && aNewStrokeFont[j][i + 1] == 'R' )
+            {
+                penDown = false;
+            }
+            else
+            {
+                if( !penDown )
+                    strokeCount++;
 
-            if( aNewStrokeFont[j][i] == ' ' && aNewStrokeFont[j][i+1] == 'R' )
-                strokes++;
-
-            i += 2;
+                penDown = true;
+                pointCount++;
+            }
         }
+    }
 
-        glyph->reserve( strokes + 1 );
+    font->m_Points.reserve( pointCount );
+    font->m_StrokeStart.reserve( strokeCount + 1 );
+    font->m_GlyphStart.reserve( aNewStrokeFontSize + 1 );
+    font->m_BoundingBoxes.reserve( aNewStrokeFontSize );
 
-        i = 0;
+    for( int j = 0; j < aNewStrokeFontSize; j++ )
+    {
+        double glyphStartX = 0.0;
+        double glyphEndX = 0.0;
+        bool   penDown = false;
 
-        while( aNewStrokeFont[j][i] )
-        {
-            VECTOR2D    point( 0.0, 0.0 );
-            char        coordinate[2] = { 0, };
+        VECTOR2D min( 0, 0 );
+        VECTOR2D max( 0, 0 );
+
+        font->m_GlyphStart.push_back( (int) font->m_StrokeStart.size() );
 
-            for( int k : { 0, 1 } )
-                coordinate[k] = aNewStrokeFont[j][i + k];
+        for( int i = 0; aNewStrokeFont[j][i] && aNewStrokeFont[j][i + 1]; i += 2 )
+        {
+            char coordinate[2] = { aNewStrokeFont[j][i], aNewStrokeFont[j][i + 1] };
 
             if( i < 2 )
             {
                 // The first two values contain the width of the char
                 glyphStartX = ( coordinate[0] - 'R' ) * STROKE_FONT_SCALE;
                 glyphEndX   = ( coordinate[1] - 'R' ) * STROKE_FONT_SCALE;
-                glyphWidth  = glyphEndX - glyphStartX;
             }
             else if( ( coordinate[0] == ' ' ) && ( coordinate[1] == 'R' ) )
             {
-                if( pointList )
-                    pointList->shrink_to_fit();
-
                 // Raise pen
-                pointList = nullptr;
+                penDown = false;
             }
             else
             {
@@ -125,35 +119,48 @@ bool STROKE_FONT::LoadNewStrokeFont( const char* const aNewStrokeFont[], int aNe
                 //  * the stroke coordinates are stored in reduced form (-1.0 to +1.0),
                 //    and the actual size is stroke coordinate * glyph size
                 //  * a few shapes have a height slightly bigger than 1.0 ( like '{' '[' )
-                point.x = (double) ( coordinate[0] - 'R' ) * STROKE_FONT_SCALE - glyphStartX;
+                VECTOR2D point;
+                point.x = (double) ( coordinate[0] - 'R' ) * STROKE_FONT_SCALE
+                          - glyphStartX;
                 #define FONT_OFFSET -10
                 // FONT_OFFSET is here for historical reasons, due to the way the stroke font
                 // was built. It allows shapes coordinates like W M ... to be >= 0
                 // Only shapes like j y have coordinates < 0
-                point.y = (double) ( coordinate[1] - 'R' + FONT_OFFSET ) * STROKE_FONT_SCALE;
+                point.y = (double) ( coordinate[1] - 'R' + FONT_OFFSET )
+                          * STROKE_FONT_SCALE;
 
-                if( !pointList )
-                {
-                    pointList = new std::vector<VECTOR2D>;
-                    glyph->push_back( pointList );
-                }
+                if( !penDown )
+                    font->m_StrokeStart.push_back( (int) font->m_Points.size() );
 
-                pointList->push_back( point );
-            }
+                penDown = true;
+                font->m_Points.push_back( point );
 
-            i += 2;
+                min.y = std::min( min.y, point.y );
+                max.y = std::max( max.y, point.y );
+            }
         }
 
-        if( pointList )
-            pointList->shrink_to_fit();
-
-        // Compute the bounding box of the glyph
-        g_newStrokeFontGlyphBoundingBoxes->emplace_back( computeBoundingBox( glyph, glyphWidth ) );
-        g_newStrokeFontGlyphs->push_back( glyph );
+        // The bounding box of the glyph: its advance and the vertical extent of its strokes
+        max.x = glyphEndX - glyphStartX;
+        font->m_BoundingBoxes.emplace_back( min, max - min );
     }
 
-    m_glyphs = g_newStrokeFontGlyphs;
-    m_glyphBoundingBoxes = g_newStrokeFontGlyphBoundingBoxes;
+    font->m_StrokeStart.push_back( (int) font->m_Points.size() );
+    font->m_GlyphStart.push_back( (int) font->m_StrokeStart.size() - 1 );
+
+    return font;
+}
+
+
+bool STROKE_FONT::LoadNewStrokeFont( const char* const aNewStrokeFont[], int aNewStrokeFontSize )
+{
+    // The font is parsed once (thread-safe static initialization), then shared by all the
+    // GALs and the BASIC_GAL of the plotters.  It lives until the application exits
+    static const GLYPH_LIST* newStrokeFont = parseStrokeFont( aNewStrokeFont,
+                                                              aNewStrokeFontSize );
+
+    m_glyphs = newStrokeFont;
+    m_glyphBoundingBoxes = &newStrokeFont->m_BoundingBoxes;
     return true;
 }
 
@@ -167,24 +174,6 @@ double STROKE_FONT::GetInterline( double aGlyphHeight )
 }
 
 
-BOX2D STROKE_FONT::computeBoundingBox( const GLYPH* aGLYPH, double aGlyphWidth ) const
-{
-    VECTOR2D min( 0, 0 );
-    VECTOR2D max( aGlyphWidth, 0 );
-
-    for( const std::vector<VECTOR2D>* pointList : *aGLYPH )
-    {
-        for( const VECTOR2D& point : *pointList )
-        {
-            min.y = std::min( min.y, point.y );
-            max.y = std::max( max.y, point.y );
-        }
-    }
-
-    return BOX2D( min, max - min );
-}
-
-
 void STROKE_FONT::Draw( const UTF8& aText, const VECTOR2D& aPosition, double aRotationAngle )
 {
     if( aText.empty() )
@@ -333,6 +322,10 @@ void STROKE_FONT::drawSingleLineText( const UTF8& aText )
 
     yOffset = 0;
 
+    // The strokes of all the glyphs are drawn at once, at the end of the line
+    m_strokePoints.clear();
+    m_strokeSizes.clear();
+
     for( UTF8::uni_iter chIt = aText.ubegin(), end = aText.uend(); chIt < end; ++chIt )
     {
         // Handle tabs as locked to the nearest 4th column (counting in spaces)
@@ -416,7 +409,6 @@ void STROKE_FONT::drawSingleLineText( const UTF8& aText )
             dd = substitute - ' ';
         }
 
-        const GLYPH* glyph = m_glyphs->at( dd );
         const BOX2D& bbox  = m_glyphBoundingBoxes->at( dd );
 
         if( in_overbar )
@@ -444,12 +436,15 @@ void STROKE_FONT::drawSingleLineText( const UTF8& aText )
             last_had_overbar = false;
         }
 
-        for( const std::vector<VECTOR2D>* ptList : *glyph )
+        for( int stroke = m_glyphs->m_GlyphStart[dd]; stroke < m_glyphs->m_GlyphStart[dd + 1];
+             ++stroke )
         {
-            std::deque<VECTOR2D> ptListScaled;
+            int first = m_glyphs->m_StrokeStart[stroke];
+            int last = m_glyphs->m_StrokeStart[stroke + 1];
 
-            for( const VECTOR2D& pt : *ptList )
+            for( int ii = first; ii < last; ++ii )
             {
+                const VECTOR2D& pt = m_glyphs->m_Points[ii];
                 VECTOR2D scaledPt( pt.x * glyphSize.x + xOffset, pt.y * glyphSize.y + yOffset );
 
                 if( m_gal->IsFontItalic() )
@@ -462,15 +457,16 @@ void STROKE_FONT::drawSingleLineText( const UTF8& aText )
                         scaledPt.x -= scaledPt.y * STROKE_FONT::ITALIC_TILT;
                 }
 
-                ptListScaled.push_back( scaledPt );
+                m_strokePoints.push_back( scaledPt );
             }
 
-            m_gal->DrawPolyline( ptListScaled );
+            m_strokeSizes.push_back( last - first );
         }
 
         xOffset += glyphSize.x * bbox.GetEnd().x;
     }
 
+    m_gal->DrawPolylines( m_strokePoints, m_strokeSizes );
     m_gal->Restore();
 }
 
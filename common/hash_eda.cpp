@@ -28,6 +28,7 @@
 #include <class_text_mod.h>
 #include <class_edge_mod.h>
 #include <class_pad.h>
+#include <class_track.h>
 
 #include <functional>
 
@@ -180,6 +181,44 @@ size_t hash_eda( const EDA_ITEM* aItem, int aFlags )
         }
         break;
 
+    case PCB_TRACE_T:
+    case PCB_ARC_T:
+    case PCB_VIA_T:
+        {
+            const TRACK* track = static_cast<const TRACK*>( aItem );
+            ret += hash_board_item( track, aFlags );
+            ret += hash<int>{}( static_cast<int>( track->Type() ) << 12 );
+            ret += hash<int>{}( track->GetWidth() << 3 );
+
+            if( aItem->Type() == PCB_VIA_T )
+            {
+                const VIA* via = static_cast<const VIA*>( aItem );
+                ret += hash<int>{}( static_cast<int>( via->GetViaType() ) << 14 );
+                ret += hash<int>{}( via->GetDrillValue() << 2 );
+            }
+
+            if( aItem->Type() == PCB_ARC_T )
+            {
+                const ARC* arc = static_cast<const ARC*>( aItem );
+                ret += hash<int>{}( arc->GetMid().x << 10 );
+                ret += hash<int>{}( arc->GetMid().y << 11 );
+            }
+
+            // Unlike the footprint items, the ends of a track are not interchangeable with
+            // each other's coordinates, so they get distinct shifts.
+            if( aFlags & POSITION )
+            {
+                ret += hash<int>{}( track->GetStart().x << 1 );
+                ret += hash<int>{}( track->GetStart().y << 2 );
+                ret += hash<int>{}( track->GetEnd().x << 3 );
+                ret += hash<int>{}( track->GetEnd().y << 4 );
+            }
+
+            if( aFlags & NET )
+                ret += hash<int>{}( track->GetNetCode() << 6 );
+        }
+        break;
+
     default:
         wxASSERT_MSG( false, "Unhandled type in function hashModItem() (exporter_gencad.cpp)" );
     }
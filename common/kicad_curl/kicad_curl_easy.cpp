@@ -25,10 +25,14 @@
 #include <kicad_curl/kicad_curl.h>
 #include <kicad_curl/kicad_curl_easy.h>
 
+#include <algorithm>
+#include <cctype>
 #include <cstdarg>
 #include <cstddef>
 #include <exception>
 #include <ki_exception.h>   // THROW_IO_ERROR
+#include <map>
+#include <mutex>
 #include <sstream>
 
 
@@ -44,6 +48,88 @@ static size_t write_callback( void* contents, size_t size, size_t nmemb, void* u
 }
 
 
+static size_t header_callback( char* buffer, size_t size, size_t nitems, void* userp )
+{
+    size_t      realsize = size * nitems;
+    std::string line( buffer, realsize );
+    auto*       headers = (std::map<std::string, std::string>*) userp;
+
+    // A new response (after a redirect, or a "100 Continue") starts with its status line
+    if( line.compare( 0, 5, "HTTP/" ) == 0 )
+    {
+        headers->clear();
+        return realsize;
+    }
+
+    size_t colon = line.find( ':' );
+
+    if( colon == std::string::npos )
+        return realsize;
+
+    std::string name = line.substr( 0, colon );
+    std::string value = line.substr( colon + 1 );
+
+    std::transform( name.begin(), name.end(), name.begin(),
+                    []( unsigned char c ) { return (char) std::tolower( c ); } );
+
+    value.erase( 0, value.find_first_not_of( " \t" ) );
+    value.erase( value.find_last_not_of( " \t\r\n" ) + 1 );
+
+    (*headers)[name] = value;
+
+    return realsize;
+}
+
+
+/**
+ * The curl share handle of the application, and the locks curl needs to use it from
+ * several threads.  It is never released, as the requests may run until the exit.
+ */
+class KICAD_CURL_SHARE
+{
+public:
+    static CURLSH* Get()
+    {
+        static KICAD_CURL_SHARE* share = new KICAD_CURL_SHARE;
+
+        return share->m_share;
+    }
+
+private:
+    KICAD_CURL_SHARE()
+    {
+        m_share = curl_share_init();
+
+        if( !m_share )
+            return;
+
+        curl_share_setopt( m_share, CURLSHOPT_LOCKFUNC, lock );
+        curl_share_setopt( m_share, CURLSHOPT_UNLOCKFUNC, unlock );
+        curl_share_setopt( m_share, CURLSHOPT_USERDATA, this );
+        curl_share_setopt( m_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS );
+        curl_share_setopt( m_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION );
+#if LIBCURL_VERSION_NUM >= 0x073900     // 7.57.0
+        curl_share_setopt( m_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT );
+#endif
+    }
+
+    static void lock( CURL*, curl_lock_data aData, curl_lock_access, void* aUser )
+    {
+        static_cast<KICAD_CURL_SHARE*>( aUser )->m_locks[aData % LOCK_COUNT].lock();
+    }
+
+    static void unlock( CURL*, curl_lock_data aData, void* aUser )
+    {
+        static_cast<KICAD_CURL_SHARE*>( aUser )->m_locks[aData % LOCK_COUNT].unlock();
+    }
+
+    static constexpr int LOCK_COUNT = CURL_LOCK_DATA_LAST;
+
+    CURLSH*    m_share;
+    std::mutex m_locks[LOCK_COUNT];
+};
+
+
 KICAD_CURL_EASY::KICAD_CURL_EASY() :
     m_headers( NULL )
 {
@@ -62,6 +148,8 @@ KICAD_CURL_EASY::KICAD_CURL_EASY() :
 
     curl_easy_setopt( m_CURL, CURLOPT_WRITEFUNCTION, write_callback );
     curl_easy_setopt( m_CURL, CURLOPT_WRITEDATA, (void*) &m_buffer );
+    curl_easy_setopt( m_CURL, CURLOPT_HEADERFUNCTION, header_callback );
+    curl_easy_setopt( m_CURL, CURLOPT_HEADERDATA, (void*) &m_responseHeaders );
 }
 
 
@@ -83,6 +171,7 @@ void KICAD_CURL_EASY::Perform()
 
     // bonus: retain worst case memory allocation, should re-use occur
     m_buffer.clear();
+    m_responseHeaders.clear();
 
     CURLcode res = curl_easy_perform( m_CURL );
 
@@ -144,6 +233,37 @@ bool KICAD_CURL_EASY::SetFollowRedirects( bool aFollow )
 }
 
 
+bool KICAD_CURL_EASY::SetShareConnections()
+{
+    CURLSH* share = KICAD_CURL_SHARE::Get();
+
+    return share && setOption<CURLSH*>( CURLOPT_SHARE, share ) == CURLE_OK;
+}
+
+
+long KICAD_CURL_EASY::GetResponseCode()
+{
+    long code = 0;
+
+    curl_easy_getinfo( m_CURL, CURLINFO_RESPONSE_CODE, &code );
+
+    return code;
+}
+
+
+std::string KICAD_CURL_EASY::GetResponseHeader( const std::string& aName ) const
+{
+    std::string name = aName;
+
+    std::transform( name.begin(), name.end(), name.begin(),
+                    []( unsigned char c ) { return (char) std::tolower( c ); } );
+
+    auto it = m_responseHeaders.find( name );
+
+    return it != m_responseHeaders.end() ? it->second : std::string();
+}
+
+
 std::string KICAD_CURL_EASY::Escape( const std::string& aUrl )
 {
     char* escaped = curl_easy_escape( m_CURL, aUrl.c_str(), aUrl.length() );
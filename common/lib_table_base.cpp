@@ -337,7 +337,7 @@ void LIB_TABLE::Load( const wxString& aFileName )
     // It's OK if footprint library tables are missing.
     if( wxFileName::IsFileReadable( aFileName ) )
     {
-        FILE_LINE_READER    reader( aFileName );
+        MAPPED_FILE_LINE_READER reader( aFileName );
         LIB_TABLE_LEXER     lexer( &reader );
 
         Parse( &lexer );
@@ -449,3 +449,45 @@ UTF8 LIB_TABLE::FormatOptions( const PROPERTIES* aProperties )
 
     return ret;
 }
+
+
+void LIB_TABLE_BACKGROUND_LOAD::Start( std::function<void()> aLoad,
+                                       std::function<void( const IO_ERROR& )> aOnError )
+{
+    std::lock_guard<std::mutex> lock( m_mutex );
+
+    m_onError = std::move( aOnError );
+    m_load = std::async( std::launch::async, std::move( aLoad ) ).share();
+}
+
+
+void LIB_TABLE_BACKGROUND_LOAD::Wait()
+{
+    std::shared_future<void> load;
+
+    {
+        std::lock_guard<std::mutex> lock( m_mutex );
+        load = m_load;
+    }
+
+    if( !load.valid() )
+        return;
+
+    try
+    {
+        load.get();
+    }
+    catch( const IO_ERROR& ioe )
+    {
+        std::function<void( const IO_ERROR& )> onError;
+
+        {
+            std::lock_guard<std::mutex> lock( m_mutex );
+            std::swap( onError, m_onError );
+        }
+
+        // Outside of the lock: the handler may show a dialog, which may use the table
+        if( onError )
+            onError( ioe );
+    }
+}
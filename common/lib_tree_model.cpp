@@ -22,6 +22,8 @@
 #include <lib_tree_model.h>
 
 #include <algorithm>
+#include <functional>
+#include <iterator>
 #include <eda_pattern_match.h>
 #include <lib_tree_item.h>
 #include <utility>
@@ -50,12 +52,139 @@ static int matchPosScore(int aPosition, int aMaximum)
 }
 
 
-void LIB_TREE_NODE::ResetScore()
+// Lowercases the texts an item is matched against, the first time it is searched.
+static void normalizeSearchText( LIB_TREE_NODE& aNode )
+{
+    if( !aNode.m_Normalized )
+    {
+        aNode.m_MatchName = aNode.m_MatchName.Lower();
+        aNode.m_SearchText = aNode.m_SearchText.Lower();
+        aNode.m_Normalized = true;
+    }
+}
+
+
+// Calls aFunc with the key of each trigram of aText.  The code points fit in 21 bits.
+template <typename FUNC>
+static void forEachTrigram( const wxString& aText, FUNC aFunc )
+{
+    uint64_t key = 0;
+    int      count = 0;
+
+    for( wxUniChar c : aText )
+    {
+        key = ( ( key << 21 ) | (uint64_t) c.GetValue() ) & ( ( (uint64_t) 1 << 63 ) - 1 );
+
+        if( ++count >= 3 )
+            aFunc( key );
+    }
+}
+
+
+void LIB_TREE_SEARCH_INDEX::Add( LIB_TREE_NODE* aNode, const wxString& aText )
+{
+    if( m_nodes.empty() || m_nodes.back() != aNode )
+        m_nodes.push_back( aNode );
+
+    uint32_t id = m_nodes.size() - 1;
+
+    forEachTrigram( aText,
+            [&]( uint64_t aKey )
+            {
+                std::vector<uint32_t>& posting = m_postings[aKey];
+
+                if( posting.empty() || posting.back() != id )
+                    posting.push_back( id );
+            } );
+}
+
+
+void LIB_TREE_SEARCH_INDEX::Finish()
+{
+    for( auto& entry : m_postings )
+        entry.second.shrink_to_fit();
+}
+
+
+bool LIB_TREE_SEARCH_INDEX::FindCandidates( const wxString& aTerm,
+                                            std::vector<LIB_TREE_NODE*>& aCandidates ) const
+{
+    aCandidates.clear();
+
+    if( !IsPlainTerm( aTerm ) )
+        return false;
+
+    std::vector<const std::vector<uint32_t>*> postings;
+    bool                                      missing = false;
+
+    forEachTrigram( aTerm,
+            [&]( uint64_t aKey )
+            {
+                auto it = m_postings.find( aKey );
+
+                if( it == m_postings.end() )
+                    missing = true;
+                else
+                    postings.push_back( &it->second );
+            } );
+
+    if( missing )
+        return true;
+
+    if( postings.empty() )
+        return false;
+
+    // The postings are sorted, as the ids are given in order: intersect them from the
+    // shortest one
+    std::sort( postings.begin(), postings.end(),
+               []( const std::vector<uint32_t>* a, const std::vector<uint32_t>* b )
+               {
+                   return a->size() < b->size();
+               } );
+
+    std::vector<uint32_t> ids = *postings[0];
+    std::vector<uint32_t> common;
+
+    for( size_t i = 1; i < postings.size() && !ids.empty(); ++i )
+    {
+        common.clear();
+        std::set_intersection( ids.begin(), ids.end(), postings[i]->begin(),
+                               postings[i]->end(), std::back_inserter( common ) );
+        ids.swap( common );
+    }
+
+    for( uint32_t id : ids )
+        aCandidates.push_back( m_nodes[id] );
+
+    std::sort( aCandidates.begin(), aCandidates.end(), std::less<LIB_TREE_NODE*>() );
+
+    return true;
+}
+
+
+bool LIB_TREE_SEARCH_INDEX::IsPlainTerm( const wxString& aTerm )
+{
+    // The syntax of the regular expression, wildcard and relational matchers
+    static const wxString special = wxT( ".*+?^${}()|[]\\<>=" );
+
+    for( wxUniChar c : aTerm )
+    {
+        if( special.Find( c ) != wxNOT_FOUND )
+            return false;
+    }
+
+    return true;
+}
+
+
+void LIB_TREE_NODE::ResetScore( bool aKeepExcluded )
 {
     for( auto& child: m_Children )
-        child->ResetScore();
+        child->ResetScore( aKeepExcluded );
 
-    m_Score = kLowestDefaultScore;
+    // Only the items are excluded, the libraries are scored from them
+    if( !aKeepExcluded || m_Type != LIBID || m_Score > 0 )
+        m_Score = kLowestDefaultScore;
 }
 
 
@@ -211,12 +340,7 @@ void LIB_TREE_NODE_LIB_ID::UpdateScore( EDA_COMBINED_MATCHER& aMatcher )
     if( m_Score <= 0 )
         return; // Leaf nodes without scores are out of the game.
 
-    if( !m_Normalized )
-    {
-        m_MatchName = m_MatchName.Lower();
-        m_SearchText = m_SearchText.Lower();
-        m_Normalized = true;
-    }
+    normalizeSearchText( *this );
 
     // Keywords and description we only count if the match string is at
     // least two characters long. That avoids spurious, low quality
@@ -270,6 +394,7 @@ LIB_TREE_NODE_LIB::LIB_TREE_NODE_LIB( LIB_TREE_NODE* aParent, wxString const& aN
     m_Desc = aDesc;
     m_Parent = aParent;
     m_LibId.SetLibNickname( aName );
+    m_searchIndexValid = false;
 }
 
 
@@ -277,10 +402,36 @@ LIB_TREE_NODE_LIB_ID& LIB_TREE_NODE_LIB::AddItem( LIB_TREE_ITEM* aItem )
 {
     LIB_TREE_NODE_LIB_ID* item = new LIB_TREE_NODE_LIB_ID( this, aItem );
     m_Children.push_back( std::unique_ptr<LIB_TREE_NODE>( item ) );
+    m_searchIndexValid = false;
     return *item;
 }
 
 
+void LIB_TREE_NODE_LIB::AssignIntrinsicRanks( bool presorted )
+{
+    LIB_TREE_NODE::AssignIntrinsicRanks( presorted );
+
+    m_searchIndex.Clear();
+    m_searchIndexValid = false;
+}
+
+
+void LIB_TREE_NODE_LIB::buildSearchIndex()
+{
+    m_searchIndex.Clear();
+
+    for( auto& child: m_Children )
+    {
+        normalizeSearchText( *child );
+        m_searchIndex.Add( child.get(), child->m_MatchName );
+        m_searchIndex.Add( child.get(), child->m_SearchText );
+    }
+
+    m_searchIndex.Finish();
+    m_searchIndexValid = true;
+}
+
+
 void LIB_TREE_NODE_LIB::UpdateScore( EDA_COMBINED_MATCHER& aMatcher )
 {
     m_Score = 0;
@@ -289,9 +440,40 @@ void LIB_TREE_NODE_LIB::UpdateScore( EDA_COMBINED_MATCHER& aMatcher )
 
     if( m_Children.size() )
     {
+        if( !m_searchIndexValid )
+        {
+            // The items changed since the last search, so none of them is excluded yet
+            for( auto& child: m_Children )
+            {
+                if( child->m_Score <= 0 )
+                    child->m_Score = kLowestDefaultScore;
+            }
+
+            buildSearchIndex();
+        }
+
+        // All the items match the name of their library, so the index is no use then
+        std::vector<LIB_TREE_NODE*> candidates;
+        int                         found_pos = EDA_PATTERN_NOT_FOUND;
+        int                         matchers_fired = 0;
+        bool                        useIndex =
+                !aMatcher.Find( m_MatchName, matchers_fired, found_pos )
+                && m_searchIndex.FindCandidates( aMatcher.GetPattern(), candidates );
+
         for( auto& child: m_Children )
         {
-            child->UpdateScore( aMatcher );
+            if( useIndex && child->m_Score > 0
+                    && !std::binary_search( candidates.begin(), candidates.end(), child.get(),
+                                            std::less<LIB_TREE_NODE*>() ) )
+            {
+                // The term is in none of the texts of the item: no match
+                child->m_Score = 0;
+            }
+            else
+            {
+                child->UpdateScore( aMatcher );
+            }
+
             m_Score = std::max( m_Score, child->m_Score );
         }
     }
@@ -23,12 +23,64 @@
 #define LIB_TREE_MODEL_H
 
 #include <vector>
+#include <cstdint>
 #include <memory>
+#include <unordered_map>
 #include <wx/string.h>
 #include <lib_tree_item.h>
 
 
 class EDA_COMBINED_MATCHER;
+class LIB_TREE_NODE;
+
+
+/**
+ * An inverted index of the trigrams of the normalized search texts of library tree nodes.
+ *
+ * A plain search term (one without any wildcard, regular expression or relational syntax)
+ * can only be found in the texts holding all its trigrams, so only these nodes need to be
+ * matched against it.
+ */
+class LIB_TREE_SEARCH_INDEX
+{
+public:
+    /**
+     * Add the trigrams of a text of \a aNode.  The texts of a node must be added one after
+     * the other, and before Finish() is called.
+     */
+    void Add( LIB_TREE_NODE* aNode, const wxString& aText );
+
+    /**
+     * Prepare the index for the lookups, once all the nodes are added.
+     */
+    void Finish();
+
+    void Clear()
+    {
+        m_nodes.clear();
+        m_postings.clear();
+    }
+
+    /**
+     * Find the nodes which may hold \a aTerm in one of their texts.
+     *
+     * @param aTerm is the normalized search term.
+     * @param aCandidates receives the candidate nodes, sorted by address.
+     * @return false if the term cannot be looked up (it is a pattern, or shorter than a
+     *         trigram), in which case all the nodes are candidates.
+     */
+    bool FindCandidates( const wxString& aTerm, std::vector<LIB_TREE_NODE*>& aCandidates ) const;
+
+    /**
+     * @return true if \a aTerm is a plain string, which all the matchers of the search look
+     *         up as a substring.
+     */
+    static bool IsPlainTerm( const wxString& aTerm );
+
+private:
+    std::vector<LIB_TREE_NODE*>                          m_nodes;
+    std::unordered_map<uint64_t, std::vector<uint32_t>>  m_postings;   // indices in m_nodes
+};
 
 
 /**
@@ -116,14 +168,18 @@ public:
 
     /**
      * Initialize score to kLowestDefaultScore, recursively.
+     *
+     * When \a aKeepExcluded is set the items already excluded by the previous search keep
+     * their null score: the new search must then be a narrower one (see
+     * LIB_TREE_MODEL_ADAPTER::UpdateSearchString()).
      */
-    void ResetScore();
+    void ResetScore( bool aKeepExcluded = false );
 
     /**
      * Store intrinsic ranks on all children of this node. See m_IntrinsicRank
      * member doc for more information.
      */
-    void AssignIntrinsicRanks( bool presorted = false );
+    virtual void AssignIntrinsicRanks( bool presorted = false );
 
     /**
      * Sort child nodes quickly and recursively (IntrinsicRanks must have been set).
@@ -254,7 +310,23 @@ public:
      */
     LIB_TREE_NODE_LIB_ID& AddItem( LIB_TREE_ITEM* aItem );
 
+    /**
+     * Assign the ranks of the items, which also drops the search index: the items are
+     * ranked again each time they change.
+     */
+    virtual void AssignIntrinsicRanks( bool presorted = false ) override;
+
+    /**
+     * Score the items, only matching a plain search term against the items holding all
+     * its trigrams.
+     */
     virtual void UpdateScore( EDA_COMBINED_MATCHER& aMatcher ) override;
+
+private:
+    void buildSearchIndex();
+
+    LIB_TREE_SEARCH_INDEX m_searchIndex;      // Built at the first search
+    bool                  m_searchIndexValid;
 };
 
 
@@ -186,7 +186,13 @@ void LIB_TREE_MODEL_ADAPTER::DoAddLibrary( wxString const& aNodeName, wxString c
 
 void LIB_TREE_MODEL_ADAPTER::UpdateSearchString( wxString const& aSearch )
 {
-    m_tree.ResetScore();
+    // The terms of a plain search are only found as substrings, so typing more of it can
+    // only exclude more items: the ones it already excluded are not searched again
+    bool narrower = !m_lastSearch.IsEmpty() && aSearch.StartsWith( m_lastSearch )
+                    && LIB_TREE_SEARCH_INDEX::IsPlainTerm( aSearch );
+
+    m_tree.ResetScore( narrower );
+    m_lastSearch = aSearch;
 
     for( auto& child: m_tree.m_Children )
     {
@@ -369,6 +369,8 @@ private:
     int                     m_colWidths[NUM_COLS];
     wxArrayString           m_pinnedLibs;
 
+    wxString                m_lastSearch;   // To narrow the previous search results
+
     /**
      * Find any results worth highlighting and expand them, according to given criteria
      * The highest-scoring node is written to aHighScore
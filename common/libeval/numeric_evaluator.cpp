@@ -50,6 +50,7 @@ NUMERIC_EVALUATOR::NUMERIC_EVALUATOR( EDA_UNITS aUnits, bool aUseMils )
 
     m_parseError = false;
     m_parseFinished = false;
+    m_usesVars = false;
 
     m_parser = numEval::ParseAlloc( malloc );
 
@@ -140,6 +141,30 @@ bool NUMERIC_EVALUATOR::Process( const wxString& aString )
         return true;
     }
 
+    // Grids evaluate the same strings over and over: reuse the result of a previous evaluation
+    auto cached = m_cache.find( aString );
+
+    if( cached != m_cache.end()
+            && ( !cached->second.usesVars || cached->second.varsBefore == m_varMap ) )
+    {
+        const CacheEntry& entry = cached->second;
+
+        snprintf( m_token.token, m_token.OutLen, "%s", entry.result.c_str() );
+        m_parseError = entry.parseError;
+        m_parseFinished = true;
+
+        if( entry.usesVars )
+            m_varMap = entry.varsAfter;
+
+        return !m_parseError;
+    }
+
+    CacheEntry entry;
+    m_usesVars = false;
+
+    if( !m_varMap.empty() )
+        entry.varsBefore = m_varMap;
+
     do
     {
         tok = getToken();
@@ -153,6 +178,20 @@ bool NUMERIC_EVALUATOR::Process( const wxString& aString )
         }
     } while( tok.token );
 
+    if( m_cache.size() >= CacheSize )
+        m_cache.clear();
+
+    entry.result = m_token.token ? m_token.token : "";
+    entry.parseError = m_parseError;
+    entry.usesVars = m_usesVars;
+
+    if( m_usesVars )
+        entry.varsAfter = m_varMap;
+    else
+        entry.varsBefore.clear();
+
+    m_cache[ aString ] = std::move( entry );
+
     return !m_parseError;
 }
 
@@ -371,11 +410,14 @@ NUMERIC_EVALUATOR::Token NUMERIC_EVALUATOR::getToken()
 
 void NUMERIC_EVALUATOR::SetVar( const wxString& aString, double aValue )
 {
+    m_usesVars = true;
     m_varMap[ aString ] = aValue;
 }
 
 double NUMERIC_EVALUATOR::GetVar( const wxString& aString )
 {
+    m_usesVars = true;
+
     if( m_varMap[ aString ] )
         return m_varMap[ aString ];
     else
@@ -0,0 +1,104 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <memory_accounting.h>
+
+#include <advanced_config.h>
+#include <trace_helpers.h>
+
+#include <wx/log.h>
+
+
+MEMORY_ACCOUNTING::MEMORY_ACCOUNTING( bool aEnabled ) :
+        m_enabled( aEnabled ),
+        m_nextId( 1 )
+{
+}
+
+
+MEMORY_ACCOUNTING& MEMORY_ACCOUNTING::GetInstance()
+{
+    static MEMORY_ACCOUNTING instance( ADVANCED_CFG::GetCfg().m_MemoryAccounting );
+
+    return instance;
+}
+
+
+int MEMORY_ACCOUNTING::Add( const std::string& aSubsystem, ESTIMATOR aEstimator )
+{
+    if( !m_enabled )
+        return 0;
+
+    std::lock_guard<std::mutex> lock( m_mutex );
+    int                         id = m_nextId++;
+
+    m_entries[id] = { aSubsystem, std::move( aEstimator ) };
+    return id;
+}
+
+
+void MEMORY_ACCOUNTING::Remove( int aId )
+{
+    // Waits for a running Collect(): the estimator may use the object being destroyed
+    std::lock_guard<std::mutex> lock( m_mutex );
+
+    m_entries.erase( aId );
+}
+
+
+std::map<std::string, MEMORY_ACCOUNTING::USAGE> MEMORY_ACCOUNTING::Collect() const
+{
+    std::lock_guard<std::mutex>  lock( m_mutex );
+    std::map<std::string, USAGE> usages;
+
+    for( const std::pair<const int, ENTRY>& entry : m_entries )
+    {
+        USAGE  usage = entry.second.m_Estimator();
+        USAGE& total = usages[entry.second.m_Subsystem];
+
+        total.m_Bytes += usage.m_Bytes;
+        total.m_Items += usage.m_Items;
+    }
+
+    return usages;
+}
+
+
+void MEMORY_ACCOUNTING::Trace( const wxString& aContext ) const
+{
+    if( !m_enabled || !wxLog::IsAllowedTraceMask( traceMemory ) )
+        return;
+
+    size_t totalBytes = 0;
+
+    for( const std::pair<const std::string, USAGE>& usage : Collect() )
+    {
+        wxLogTrace( traceMemory, "%s: %s: %.1f MB in %zu items", aContext,
+                    usage.first.c_str(), usage.second.m_Bytes / 1048576.0,
+                    usage.second.m_Items );
+
+        totalBytes += usage.second.m_Bytes;
+    }
+
+    wxLogTrace( traceMemory, "%s: total: %.1f MB", aContext, totalBytes / 1048576.0 );
+}
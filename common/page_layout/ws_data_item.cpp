@@ -546,6 +546,7 @@ WS_DATA_ITEM_TEXT::WS_DATA_ITEM_TEXT( const wxString& aTextBase ) :
     m_Bold = false;
     m_Orient = 0.0;
     m_LineWidth = 0.0;      // 0 means use default value
+    m_measured = false;
 }
 
 
@@ -698,6 +699,15 @@ void WS_DATA_ITEM_TEXT::SetConstrainedTextSize()
 
     if( m_BoundingBoxSize.x || m_BoundingBoxSize.y )
     {
+        CONSTRAINED_SIZE_INPUTS inputs = { m_FullText, m_ConstrainedTextSize, m_BoundingBoxSize,
+                                           m_Orient, m_Hjustify, m_Vjustify, m_Italic, m_Bold };
+
+        if( m_measured && inputs == m_measuredInputs )
+        {
+            m_ConstrainedTextSize = m_measuredSize;
+            return;
+        }
+
         // to know the X and Y size of the line, we should use
         // EDA_TEXT::GetTextBox()
         // but this function uses integers
@@ -724,6 +734,10 @@ void WS_DATA_ITEM_TEXT::SetConstrainedTextSize()
 
         if( m_BoundingBoxSize.y &&  size.y > m_BoundingBoxSize.y )
             m_ConstrainedTextSize.y *= m_BoundingBoxSize.y / size.y;
+
+        m_measured = true;
+        m_measuredInputs = std::move( inputs );
+        m_measuredSize = m_ConstrainedTextSize;
     }
 }
 
@@ -132,6 +132,10 @@ void PGM_BASE::Destroy()
 
     delete m_locale;
     m_locale = 0;
+
+    // The settings are written in the background: wait for the last saves
+    if( m_settings_manager )
+        m_settings_manager->FlushWrites();
 }
 
 
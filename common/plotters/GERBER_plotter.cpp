@@ -44,6 +44,10 @@
 #include <gbr_metadata.h>
 
 
+// The size of the stdio buffers of the Gerber files
+static const size_t GERBER_FILE_BUFFER_SIZE = 1 << 20;
+
+
 GERBER_PLOTTER::GERBER_PLOTTER()
 {
     workFile  = NULL;
@@ -98,10 +102,53 @@ void GERBER_PLOTTER::SetGerberCoordinatesFormat( int aResolution, bool aUseInche
 }
 
 
+/**
+ * Write the decimal digits of aValue at aBuf, without terminating null.
+ * @return the end of the written chars
+ */
+static char* formatInt( char* aBuf, int aValue )
+{
+    char     digits[12];
+    int      count = 0;
+    unsigned value = aValue < 0 ? 0u - (unsigned) aValue : (unsigned) aValue;
+
+    if( aValue < 0 )
+        *aBuf++ = '-';
+
+    do
+    {
+        digits[count++] = char( '0' + value % 10 );
+        value /= 10;
+    } while( value );
+
+    while( count )
+        *aBuf++ = digits[--count];
+
+    return aBuf;
+}
+
+
 void GERBER_PLOTTER::emitDcode( const DPOINT& pt, int dcode )
 {
+    // Same as fprintf( "X%dY%dD%02d*\n" ), but this is the bulk of a Gerber file and the
+    // format string does not need to be parsed for each coordinate
+    char  line[48];
+    char* end = line;
+
+    *end++ = 'X';
+    end = formatInt( end, KiROUND( pt.x ) );
+    *end++ = 'Y';
+    end = formatInt( end, KiROUND( pt.y ) );
+    *end++ = 'D';
+
+    if( dcode >= 0 && dcode < 10 )
+        *end++ = '0';
+
+    end = formatInt( end, dcode );
+    *end++ = '*';
+    *end++ = '\n';
 
-    fprintf( outputFile, "X%dY%dD%02d*\n", KiROUND( pt.x ), KiROUND( pt.y ), dcode );
+    fwrite( line, 1, end - line, outputFile );
 }
 
 void GERBER_PLOTTER::ClearAllAttributes()
@@ -196,6 +243,10 @@ bool GERBER_PLOTTER::StartPlot()
     if( outputFile == NULL )
         return false;
 
+    // Large plots are millions of short records: write them by large blocks
+    setvbuf( workFile, NULL, _IOFBF, GERBER_FILE_BUFFER_SIZE );
+    setvbuf( finalFile, NULL, _IOFBF, GERBER_FILE_BUFFER_SIZE );
+
     for( unsigned ii = 0; ii < m_headerExtraLines.GetCount(); ii++ )
     {
         if( ! m_headerExtraLines[ii].IsEmpty() )
@@ -257,6 +308,7 @@ bool GERBER_PLOTTER::EndPlot()
     fclose( workFile );
     workFile   = wxFopen( m_workFilename, wxT( "rt" ));
     wxASSERT( workFile );
+    setvbuf( workFile, NULL, _IOFBF, GERBER_FILE_BUFFER_SIZE );
     outputFile = finalFile;
 
     // Placement of apertures in RS274X
@@ -302,18 +354,13 @@ void GERBER_PLOTTER::SetCurrentLineWidth( int aWidth, void* aData )
 int GERBER_PLOTTER::GetOrCreateAperture( const wxSize& aSize,
                         APERTURE::APERTURE_TYPE aType, int aApertureAttribute )
 {
-    int last_D_code = 9;
-
     // Search an existing aperture
-    for( int idx = 0; idx < (int)m_apertures.size(); ++idx )
-    {
-        APERTURE* tool = &m_apertures[idx];
-        last_D_code = tool->m_DCode;
+    auto it = m_apertureIndex.find( { aType, aSize, aApertureAttribute } );
 
-        if( (tool->m_Type == aType) && (tool->m_Size == aSize) &&
-            (tool->m_ApertureAttribute == aApertureAttribute) )
-            return idx;
-    }
+    if( it != m_apertureIndex.end() )
+        return it->second;
+
+    int last_D_code = m_apertures.empty() ? 9 : m_apertures.back().m_DCode;
 
     // Allocate a new aperture
     APERTURE new_tool;
@@ -323,6 +370,7 @@ int GERBER_PLOTTER::GetOrCreateAperture( const wxSize& aSize,
     new_tool.m_ApertureAttribute = aApertureAttribute;
 
     m_apertures.push_back( new_tool );
+    m_apertureIndex[ { aType, aSize, aApertureAttribute } ] = m_apertures.size() - 1;
 
     return m_apertures.size() - 1;
 }
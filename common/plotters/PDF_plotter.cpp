@@ -36,7 +36,21 @@
 #include <macros.h>
 #include <wx/zstream.h>
 #include <wx/mstream.h>
+#include <wx/filename.h>
 #include <math/util.h>      // for KiROUND
+#include <richio.h>         // for StrPrintf
+#include <thread_pool.h>
+
+#include <algorithm>
+
+
+/// A page stream compressed by a task of the thread pool, written once the task is done
+struct PDF_PENDING_STREAM
+{
+    int         m_Handle = -1;
+    std::string m_Data;         ///< the compressed stream
+    TASK_GROUP  m_Task;
+};
 
 
 /*
@@ -429,9 +443,32 @@ void PDF_PLOTTER::PlotImage( const wxImage & aImage, const wxPoint& aPos,
 }
 
 
+/**
+ * Compress aSize bytes at aData in a ZLIB stream.  Somewhat standard parameters to compress
+ * in DEFLATE.  The PDF spec is misleading, it says it wants a DEFLATE stream but it really
+ * want a ZLIB stream! (a DEFLATE stream would be generated with -15 instead of 15)
+ * rc = deflateInit2( &zstrm, Z_BEST_COMPRESSION, Z_DEFLATED, 15, 8, Z_DEFAULT_STRATEGY );
+ */
+static std::string deflatePdfData( const void* aData, size_t aSize )
+{
+    // NULL means memos owns the memory, but provide a hint on optimum size needed.
+    wxMemoryOutputStream memos( NULL, std::max<size_t>( 2000, aSize ) );
+
+    {
+        wxZlibOutputStream zos( memos, wxZ_BEST_COMPRESSION, wxZLIB_ZLIB );
+
+        zos.Write( aData, aSize );
+    }   // flush the zip stream using zos destructor
+
+    wxStreamBuffer* sb = memos.GetOutputStreamBuffer();
+
+    return std::string( static_cast<const char*>( sb->GetBufferStart() ), sb->Tell() );
+}
+
+
 /**
  * Allocate a new handle in the table of the PDF object. The
- * handle must be completed using startPdfObject. It's an in-RAM operation
+ * handle must be completed using startPdfObject or addPdfObject. It's an in-RAM operation
  * only, no output is done.
  */
 int PDF_PLOTTER::allocPdfObject()
@@ -448,7 +485,6 @@ int PDF_PLOTTER::allocPdfObject()
 int PDF_PLOTTER::startPdfObject(int handle)
 {
     wxASSERT( outputFile );
-    wxASSERT( !workFile );
 
     if( handle < 0)
         handle = allocPdfObject();
@@ -465,11 +501,65 @@ int PDF_PLOTTER::startPdfObject(int handle)
 void PDF_PLOTTER::closePdfObject()
 {
     wxASSERT( outputFile );
-    wxASSERT( !workFile );
     fputs( "endobj\n", outputFile );
 }
 
 
+/**
+ * Store a PDF object which is not a stream, and returns its handle if the parameter is -1.
+ * These objects are small and many (one per page at least): they are written together
+ * at the end of the plot, in a compressed object stream
+ */
+int PDF_PLOTTER::addPdfObject( const std::string& aContent, int aHandle )
+{
+    if( aHandle < 0 )
+        aHandle = allocPdfObject();
+
+    m_objects.emplace_back( aHandle, aContent );
+    return aHandle;
+}
+
+
+/**
+ * Write a stream object, with its already compressed data.  aDictEntries are added to the
+ * Length and Filter entries of the stream dictionary
+ */
+void PDF_PLOTTER::writePdfStream( int aHandle, const std::string& aData,
+                                  const std::string& aDictEntries )
+{
+    startPdfObject( aHandle );
+    fprintf( outputFile, "<< /Length %u /Filter /FlateDecode %s>>\n"
+                         "stream\n", (unsigned) aData.size(), aDictEntries.c_str() );
+    fwrite( aData.data(), 1, aData.size(), outputFile );
+    fputs( "\nendstream\n", outputFile );
+    closePdfObject();
+}
+
+
+/**
+ * Write the page streams whose compression is finished, in the order of the pages.
+ * If aWaitAll is true, wait for all of them.  Also wait for the oldest ones when too many
+ * are pending, to keep the memory used by the uncompressed pages bounded.
+ */
+void PDF_PLOTTER::writePendingStreams( bool aWaitAll )
+{
+    const size_t maxPending = std::max<size_t>( 2, THREAD_POOL::GetInstance().GetThreadCount() );
+
+    while( !m_pendingStreams.empty() )
+    {
+        PDF_PENDING_STREAM& stream = *m_pendingStreams.front();
+
+        if( !aWaitAll && m_pendingStreams.size() <= maxPending && !stream.m_Task.IsDone() )
+            break;
+
+        stream.m_Task.Wait();
+
+        writePdfStream( stream.m_Handle, stream.m_Data );
+        m_pendingStreams.pop_front();
+    }
+}
+
+
 /**
  * Starts a PDF stream (for the page). Returns the object handle opened
  * Pass -1 (default) for a fresh object. Especially from PDF 1.5 streams
@@ -480,83 +570,96 @@ int PDF_PLOTTER::startPdfStream(int handle)
 {
     wxASSERT( outputFile );
     wxASSERT( !workFile );
-    handle = startPdfObject( handle );
 
-    // This is guaranteed to be handle+1 but needs to be allocated since
-    // you could allocate more object during stream preparation
-    streamLengthHandle = allocPdfObject();
-    fprintf( outputFile,
-             "<< /Length %d 0 R /Filter /FlateDecode >>\n" // Length is deferred
-             "stream\n", handle + 1 );
+    if( handle < 0 )
+        handle = allocPdfObject();
+
+    // The object is written when its content is compressed (see closePdfStream)
+    streamHandle = handle;
+
+    openWorkFile();
+    return handle;
+}
+
+
+/**
+ * Open the temporary file accumulating the stream of a page
+ */
+void PDF_PLOTTER::openWorkFile()
+{
+    // A page plotted on its own has no output file name, and can be plotted together with
+    // other ones: it gets a unique file
+    if( filename.IsEmpty() )
+        workFilename = wxFileName::CreateTempFileName( wxT( "kicad_pdf_page" ) );
+    else
+        workFilename = filename + wxT(".tmp");
 
-    // Open a temporary file to accumulate the stream
-    workFilename = filename + wxT(".tmp");
     workFile = wxFopen( workFilename, wxT( "w+b" ));
     wxASSERT( workFile );
-    return handle;
 }
 
 
 /**
- * Finish the current PDF stream (writes the deferred length, too)
+ * Close and junk the temporary file of the page, and return the stream it accumulated
  */
-void PDF_PLOTTER::closePdfStream()
+std::string PDF_PLOTTER::closeWorkFile()
 {
     wxASSERT( workFile );
 
-    long stream_len = ftell( workFile );
+    long        stream_len = ftell( workFile );
+    std::string data;
 
     if( stream_len < 0 )
     {
         wxASSERT( false );
-        return;
+        stream_len = 0;
     }
 
-    // Rewind the file, read in the page stream and DEFLATE it
+    // Rewind the file, read in the page stream
     fseek( workFile, 0, SEEK_SET );
-    unsigned char *inbuf = new unsigned char[stream_len];
+    data.resize( stream_len );
 
-    int rc = fread( inbuf, 1, stream_len, workFile );
+    int rc = stream_len ? fread( &data[0], 1, stream_len, workFile ) : 0;
     wxASSERT( rc == stream_len );
     (void) rc;
 
-    // We are done with the temporary file, junk it
     fclose( workFile );
     workFile = 0;
     ::wxRemoveFile( workFilename );
 
-    // NULL means memos owns the memory, but provide a hint on optimum size needed.
-    wxMemoryOutputStream    memos( NULL, std::max( 2000l, stream_len ) ) ;
-
-    {
-        /* Somewhat standard parameters to compress in DEFLATE. The PDF spec is
-         * misleading, it says it wants a DEFLATE stream but it really want a ZLIB
-         * stream! (a DEFLATE stream would be generated with -15 instead of 15)
-         * rc = deflateInit2( &zstrm, Z_BEST_COMPRESSION, Z_DEFLATED, 15,
-         *                    8, Z_DEFAULT_STRATEGY );
-         */
+    return data;
+}
 
-        wxZlibOutputStream      zos( memos, wxZ_BEST_COMPRESSION, wxZLIB_ZLIB );
 
-        zos.Write( inbuf, stream_len );
+/**
+ * Compress the stream aData by the thread pool, while the next pages are plotted.  The
+ * stream is written once compressed, in the order of the queued streams
+ */
+void PDF_PLOTTER::queuePdfStream( int aHandle, std::string aData )
+{
+    std::shared_ptr<PDF_PENDING_STREAM> stream = std::make_shared<PDF_PENDING_STREAM>();
 
-        delete[] inbuf;
+    stream->m_Handle = aHandle;
 
-    }   // flush the zip stream using zos destructor
+    // The task keeps the stream alive, as it writes into it
+    stream->m_Task.Run( [stream, data = std::move( aData )]()
+                        {
+                            stream->m_Data = deflatePdfData( data.data(), data.size() );
+                        } );
 
-    wxStreamBuffer* sb = memos.GetOutputStreamBuffer();
+    m_pendingStreams.push_back( std::move( stream ) );
 
-    unsigned out_count = sb->Tell();
-
-    fwrite( sb->GetBufferStart(), 1, out_count, outputFile );
+    writePendingStreams( false );
+}
 
-    fputs( "endstream\n", outputFile );
-    closePdfObject();
 
-    // Writing the deferred length as an indirect object
-    startPdfObject( streamLengthHandle );
-    fprintf( outputFile, "%u\n", out_count );
-    closePdfObject();
+/**
+ * Finish the current PDF stream.  Its content is compressed by the thread pool while the
+ * next pages are plotted, and the stream is written once compressed
+ */
+void PDF_PLOTTER::closePdfStream()
+{
+    queuePdfStream( streamHandle, closeWorkFile() );
 }
 
 /**
@@ -564,7 +667,6 @@ void PDF_PLOTTER::closePdfStream()
  */
 void PDF_PLOTTER::StartPage()
 {
-    wxASSERT( outputFile );
     wxASSERT( !workFile );
 
     // Compute the paper size in IUs
@@ -573,7 +675,10 @@ void PDF_PLOTTER::StartPage()
     paperSize.y *= 10.0 / iuPerDeviceUnit;
 
     // Open the content stream; the page object will go later
-    pageStreamHandle = startPdfStream();
+    if( outputFile )
+        pageStreamHandle = startPdfStream();
+    else
+        openWorkFile();     // A detached page
 
     /* Now, until ClosePage *everything* must be wrote in workFile, to be
        compressed later in closePdfStream */
@@ -595,9 +700,44 @@ void PDF_PLOTTER::ClosePage()
     // Close the page stream (and compress it)
     closePdfStream();
 
-    // Emit the page object and put it in the page list for later
-    pageHandles.push_back( startPdfObject() );
+    addPageObject( pageInfo, pageStreamHandle );
+
+    // Mark the page stream as idle
+    pageStreamHandle = 0;
+}
+
+
+void PDF_PLOTTER::StartDetachedPage()
+{
+    wxASSERT( !outputFile );
+
+    StartPage();
+}
+
+
+std::string PDF_PLOTTER::EndDetachedPage()
+{
+    return closeWorkFile();
+}
+
+
+void PDF_PLOTTER::AddDetachedPage( const PAGE_INFO& aPageInfo, std::string aContent )
+{
+    wxASSERT( outputFile );
+    wxASSERT( !workFile );
+
+    int handle = allocPdfObject();
+
+    queuePdfStream( handle, std::move( aContent ) );
+    addPageObject( aPageInfo, handle );
+}
+
 
+/**
+ * Add the page object of a page, to the page list
+ */
+void PDF_PLOTTER::addPageObject( const PAGE_INFO& aPageInfo, int aStreamHandle )
+{
     /* Page size is in 1/72 of inch (default user space units)
        Works like the bbox in postscript but there is no need for
        swapping the sizes, since PDF doesn't require a portrait page.
@@ -605,9 +745,11 @@ void PDF_PLOTTER::ClosePage()
        to use */
 
     const double BIGPTsPERMIL = 0.072;
-    wxSize psPaperSize = pageInfo.GetSizeMils();
+    wxSize psPaperSize = aPageInfo.GetSizeMils();
 
-    fprintf( outputFile,
+    // Emit the page object and put it in the page list for later.  All the pages share
+    // the same resources: the font dictionary is only written once.
+    pageHandles.push_back( addPdfObject( StrPrintf(
              "<<\n"
              "/Type /Page\n"
              "/Parent %d 0 R\n"
@@ -616,16 +758,12 @@ void PDF_PLOTTER::ClosePage()
              "    /Font %d 0 R >>\n"
              "/MediaBox [0 0 %d %d]\n"
              "/Contents %d 0 R\n"
-             ">>\n",
+             ">>",
              pageTreeHandle,
              fontResDictHandle,
              int( ceil( psPaperSize.x * BIGPTsPERMIL ) ),
              int( ceil( psPaperSize.y * BIGPTsPERMIL ) ),
-             pageStreamHandle );
-    closePdfObject();
-
-    // Mark the page stream as idle
-    pageStreamHandle = 0;
+             aStreamHandle ) ) );
 }
 
 /**
@@ -634,12 +772,26 @@ void PDF_PLOTTER::ClosePage()
  * each page parameters can be set
  */
 bool PDF_PLOTTER::StartPlot()
+{
+    StartDetachedPlot();
+
+    /* Now, the PDF is read from the end, (more or less)... so we start
+       with the page stream for page 1. Other more important stuff is written
+       at the end */
+    StartPage();
+    return true;
+}
+
+
+bool PDF_PLOTTER::StartDetachedPlot()
 {
     wxASSERT( outputFile );
 
     // First things first: the customary null object
     xrefTable.clear();
     xrefTable.push_back( 0 );
+    m_objects.clear();
+    pageHandles.clear();
 
     /* The header (that's easy!). The second line is binary junk required
        to make the file binary from the beginning (the important thing is
@@ -654,10 +806,6 @@ bool PDF_PLOTTER::StartPlot()
        (it *could* be inherited via the Pages tree */
     fontResDictHandle = allocPdfObject();
 
-    /* Now, the PDF is read from the end, (more or less)... so we start
-       with the page stream for page 1. Other more important stuff is written
-       at the end */
-    StartPage();
     return true;
 }
 
@@ -666,8 +814,9 @@ bool PDF_PLOTTER::EndPlot()
 {
     wxASSERT( outputFile );
 
-    // Close the current page (often the only one)
-    ClosePage();
+    // Close the current page (often the only one), if the pages were not added detached
+    if( workFile )
+        ClosePage();
 
     /* We need to declare the resources we're using (fonts in particular)
        The useful standard one is the Helvetica family. Adding external fonts
@@ -688,8 +837,7 @@ bool PDF_PLOTTER::EndPlot()
        the postscript engine) */
     for( int i = 0; i < 4; i++ )
     {
-        fontdefs[i].font_handle = startPdfObject();
-        fprintf( outputFile,
+        fontdefs[i].font_handle = addPdfObject( StrPrintf(
                  "<< /BaseFont %s\n"
                  "   /Type /Font\n"
                  "   /Subtype /Type1\n"
@@ -697,42 +845,37 @@ bool PDF_PLOTTER::EndPlot()
                  /* Adobe is so Mac-based that the nearest thing to Latin1 is
                     the Windows ANSI encoding! */
                  "   /Encoding /WinAnsiEncoding\n"
-                 ">>\n",
-                 fontdefs[i].psname );
-        closePdfObject();
+                 ">>",
+                 fontdefs[i].psname ) );
     }
 
     // Named font dictionary (was allocated, now we emit it)
-    startPdfObject( fontResDictHandle );
-    fputs( "<<\n", outputFile );
+    std::string fontDict = "<<\n";
+
     for( int i = 0; i < 4; i++ )
-    {
-        fprintf( outputFile, "    %s %d 0 R\n",
-                fontdefs[i].rsname, fontdefs[i].font_handle );
-    }
-    fputs( ">>\n", outputFile );
-    closePdfObject();
+        StrPrintf( &fontDict, "    %s %d 0 R\n", fontdefs[i].rsname, fontdefs[i].font_handle );
+
+    fontDict += ">>";
+    addPdfObject( fontDict, fontResDictHandle );
 
     /* The page tree: it's a B-tree but luckily we only have few pages!
        So we use just an array... The handle was allocated at the beginning,
        now we instantiate the corresponding object */
-    startPdfObject( pageTreeHandle );
-    fputs( "<<\n"
-           "/Type /Pages\n"
-           "/Kids [\n", outputFile );
+    std::string pageTree = "<<\n"
+                           "/Type /Pages\n"
+                           "/Kids [\n";
 
     for( unsigned i = 0; i < pageHandles.size(); i++ )
-        fprintf( outputFile, "%d 0 R\n", pageHandles[i] );
+        StrPrintf( &pageTree, "%d 0 R\n", pageHandles[i] );
 
-    fprintf( outputFile,
-            "]\n"
-            "/Count %ld\n"
-             ">>\n", (long) pageHandles.size() );
-    closePdfObject();
+    StrPrintf( &pageTree,
+               "]\n"
+               "/Count %ld\n"
+               ">>", (long) pageHandles.size() );
+    addPdfObject( pageTree, pageTreeHandle );
 
 
     // The info dictionary
-    int infoDictHandle = startPdfObject();
     char date_buf[250];
     time_t ltime = time( NULL );
     strftime( date_buf, 250, "D:%Y%m%d%H%M%S",
@@ -745,57 +888,107 @@ bool PDF_PLOTTER::EndPlot()
         title = title.AfterLast('/');
     }
 
-    fprintf( outputFile,
+    int infoDictHandle = addPdfObject( StrPrintf(
              "<<\n"
              "/Producer (KiCAD PDF)\n"
              "/CreationDate (%s)\n"
              "/Creator (%s)\n"
              "/Title (%s)\n"
-             "/Trapped False\n",
+             "/Trapped False\n"
+             ">>",
              date_buf,
              TO_UTF8( creator ),
-             TO_UTF8( title ) );
-
-    fputs( ">>\n", outputFile );
-    closePdfObject();
+             TO_UTF8( title ) ) );
 
     // The catalog, at last
-    int catalogHandle = startPdfObject();
-    fprintf( outputFile,
+    int catalogHandle = addPdfObject( StrPrintf(
              "<<\n"
              "/Type /Catalog\n"
              "/Pages %d 0 R\n"
              "/Version /1.5\n"
              "/PageMode /UseNone\n"
              "/PageLayout /SinglePage\n"
-             ">>\n", pageTreeHandle );
-    closePdfObject();
+             ">>", pageTreeHandle ) );
+
+    // The page streams still being compressed
+    writePendingStreams( true );
 
-    /* Emit the xref table (format is crucial to the byte, each entry must
-       be 20 bytes long, and object zero must be done in that way). Also
-       the offset must be kept along for the trailer */
+    /* The object stream (PDF 1.5): all the objects which are not streams, compressed
+       together.  It starts with the pairs of object number and offset of each object,
+       relative to the first one */
+    int         objStreamHandle = allocPdfObject();
+    std::string objIndex;
+    std::string objData;
+
+    for( const std::pair<int, std::string>& object : m_objects )
+    {
+        StrPrintf( &objIndex, "%d %u ", object.first, (unsigned) objData.size() );
+        objData += object.second;
+        objData += '\n';
+    }
+
+    objIndex += '\n';
+
+    writePdfStream( objStreamHandle,
+                    deflatePdfData( ( objIndex + objData ).data(),
+                                    objIndex.size() + objData.size() ),
+                    StrPrintf( "/Type /ObjStm /N %u /First %u ", (unsigned) m_objects.size(),
+                               (unsigned) objIndex.size() ) );
+
+    /* The cross-reference stream (PDF 1.5), which replaces the xref table and the trailer.
+       Each entry is 7 bytes: the type, the offset of the object in the file or the object
+       stream holding it (4 bytes, big endian), and its generation or its index in the object
+       stream (2 bytes).  Object zero is the head of the free list */
+    int  xrefHandle = allocPdfObject();
     long xref_start = ftell( outputFile );
-    fprintf( outputFile,
-             "xref\n"
-             "0 %ld\n"
-             "0000000000 65535 f \n", (long) xrefTable.size() );
+
+    xrefTable[xrefHandle] = xref_start;
+
+    std::vector<int> compressedIndex( xrefTable.size(), -1 );
+
+    for( unsigned i = 0; i < m_objects.size(); i++ )
+        compressedIndex[m_objects[i].first] = i;
+
+    std::string xrefData;
+
+    auto addXrefEntry =
+            [&]( int aType, unsigned long aField2, unsigned aField3 )
+            {
+                xrefData += char( aType );
+
+                for( int shift = 24; shift >= 0; shift -= 8 )
+                    xrefData += char( ( aField2 >> shift ) & 0xFF );
+
+                xrefData += char( ( aField3 >> 8 ) & 0xFF );
+                xrefData += char( aField3 & 0xFF );
+            };
+
+    addXrefEntry( 0, 0, 65535 );
+
     for( unsigned i = 1; i < xrefTable.size(); i++ )
     {
-        fprintf( outputFile, "%010ld 00000 n \n", xrefTable[i] );
+        if( compressedIndex[i] >= 0 )
+            addXrefEntry( 2, objStreamHandle, compressedIndex[i] );
+        else
+            addXrefEntry( 1, xrefTable[i], 0 );
     }
 
-    // Done the xref, go for the trailer
+    writePdfStream( xrefHandle, deflatePdfData( xrefData.data(), xrefData.size() ),
+                    StrPrintf( "/Type /XRef /Size %lu /W [1 4 2] /Root %d 0 R /Info %d 0 R ",
+                               (unsigned long) xrefTable.size(), catalogHandle,
+                               infoDictHandle ) );
+
     fprintf( outputFile,
-             "trailer\n"
-             "<< /Size %lu /Root %d 0 R /Info %d 0 R >>\n"
              "startxref\n"
              "%ld\n" // The offset we saved before
              "%%%%EOF\n",
-             (unsigned long) xrefTable.size(), catalogHandle, infoDictHandle, xref_start );
+             xref_start );
 
     fclose( outputFile );
     outputFile = NULL;
 
+    m_objects.clear();
+
     return true;
 }
 
@@ -101,10 +101,17 @@
 #include <plotter.h>
 #include <macros.h>
 #include <kicad_string.h>
+#include <richio.h>
 
 #include <cstdint>
 #include <wx/mstream.h>
 
+// The larger polygons are seldom repeated: they are not worth a lookup
+static const size_t SVG_SHAPE_MAX_CORNERS = 256;
+
+// The merged strokes are written in paths of about this length
+static const size_t SVG_PATH_MAX_LENGTH = 64 * 1024;
+
 /**
  * Function XmlEsc
  * translates '<' to "&lt;", '>' to "&gt;" and so on, according to the spec:
@@ -172,6 +179,7 @@ SVG_PLOTTER::SVG_PLOTTER()
     m_dashed          = PLOT_DASH_TYPE::SOLID;
     m_useInch         = true; // decimils is the default
     m_precision       = 4;    // because there where used before it was changable
+    m_optimized       = false;
 }
 
 
@@ -230,7 +238,10 @@ void SVG_PLOTTER::setFillMode( FILL_T fill )
 void SVG_PLOTTER::setSVGPlotStyle( bool aIsGroup, const std::string& aExtraStyle )
 {
     if( aIsGroup )
+    {
+        flushPath();
         fputs( "</g>\n<g ", outputFile );
+    }
 
     // output the background fill color
     fprintf( outputFile, "style=\"fill:#%6.6lX; ", m_brush_rgb_color );
@@ -299,6 +310,83 @@ void SVG_PLOTTER::setSVGPlotStyle( bool aIsGroup, const std::string& aExtraStyle
     fputs( "\n", outputFile );
 }
 
+
+void SVG_PLOTTER::flushPath()
+{
+    if( m_pathData.empty() )
+        return;
+
+    fprintf( outputFile, "<path d=\"%s\"/>\n", m_pathData.c_str() );
+    m_pathData.clear();
+}
+
+
+void SVG_PLOTTER::appendPathPoint( const DPOINT& aPos, bool aMoveTo )
+{
+    wxPoint pos( KiROUND( aPos.x ), KiROUND( aPos.y ) );
+
+    if( aMoveTo && m_pathData.size() > SVG_PATH_MAX_LENGTH )
+        flushPath();
+
+    // A path restarted in the middle of a stroke begins at its last point
+    if( m_pathData.empty() && !aMoveTo )
+        StrPrintf( &m_pathData, "M%d %d", m_pathPos.x, m_pathPos.y );
+
+    if( m_pathData.empty() )
+        StrPrintf( &m_pathData, "M%d %d", pos.x, pos.y );
+    else
+        StrPrintf( &m_pathData, "%c%d %d", aMoveTo ? 'm' : 'l',
+                   pos.x - m_pathPos.x, pos.y - m_pathPos.y );
+
+    m_pathPos = pos;
+}
+
+
+void SVG_PLOTTER::emitFilledPoly( const std::vector<wxPoint>& aCornerList )
+{
+    DPOINT  dev = userToDeviceCoordinates( aCornerList[0] );
+    wxPoint origin( KiROUND( dev.x ), KiROUND( dev.y ) );
+    wxPoint last = origin;
+    std::string shape;
+
+    for( unsigned ii = 1; ii < aCornerList.size(); ii++ )
+    {
+        dev = userToDeviceCoordinates( aCornerList[ii] );
+        wxPoint pos( KiROUND( dev.x ), KiROUND( dev.y ) );
+
+        StrPrintf( &shape, "l%d %d", pos.x - last.x, pos.y - last.y );
+        last = pos;
+    }
+
+    if( aCornerList.front() == aCornerList.back() )
+        shape += 'z';
+
+    if( aCornerList.size() <= SVG_SHAPE_MAX_CORNERS )
+    {
+        auto it = m_shapes.find( shape );
+
+        if( it != m_shapes.end() )
+        {
+            // The copy inherits the style of the <use> element, i.e. of the current group
+            fprintf( outputFile, "<use xlink:href=\"#s%d\" x=\"%d\" y=\"%d\"/>\n",
+                     it->second.m_Id,
+                     origin.x - it->second.m_Origin.x, origin.y - it->second.m_Origin.y );
+            return;
+        }
+
+        int id = (int) m_shapes.size() + 1;
+        m_shapes.emplace( shape, SVG_SHAPE{ id, origin } );
+
+        fprintf( outputFile, "<path id=\"s%d\" fill-rule=\"evenodd\" d=\"M%d %d%s\"/>\n",
+                 id, origin.x, origin.y, shape.c_str() );
+        return;
+    }
+
+    fprintf( outputFile, "<path fill-rule=\"evenodd\" d=\"M%d %d%s\"/>\n",
+             origin.x, origin.y, shape.c_str() );
+}
+
+
 /* Set the current line width (in IUs) for the next plot
  */
 void SVG_PLOTTER::SetCurrentLineWidth( int aWidth, void* aData )
@@ -327,6 +415,7 @@ void SVG_PLOTTER::StartBlock( void* aData )
 {
     std::string* idstr = reinterpret_cast<std::string*>( aData );
 
+    flushPath();
     fputs( "<g ", outputFile );
     if( idstr )
         fprintf( outputFile, "id=\"%s\"", idstr->c_str() );
@@ -337,6 +426,7 @@ void SVG_PLOTTER::StartBlock( void* aData )
 
 void SVG_PLOTTER::EndBlock( void* aData )
 {
+    flushPath();
     fprintf( outputFile, "</g>\n" );
 
     m_graphics_changed = true;
@@ -383,6 +473,8 @@ void SVG_PLOTTER::SetDash( PLOT_DASH_TYPE dashed )
 
 void SVG_PLOTTER::Rect( const wxPoint& p1, const wxPoint& p2, FILL_T fill, int width )
 {
+    flushPath();
+
     EDA_RECT rect( p1, wxSize( p2.x -p1.x,  p2.y -p1.y ) );
     rect.Normalize();
     DPOINT  org_dev  = userToDeviceCoordinates( rect.GetOrigin() );
@@ -418,6 +510,8 @@ void SVG_PLOTTER::Rect( const wxPoint& p1, const wxPoint& p2, FILL_T fill, int w
 
 void SVG_PLOTTER::Circle( const wxPoint& pos, int diametre, FILL_T fill, int width )
 {
+    flushPath();
+
     DPOINT  pos_dev = userToDeviceCoordinates( pos );
     double  radius  = userToDeviceSize( diametre / 2.0 );
 
@@ -450,6 +544,8 @@ void SVG_PLOTTER::Arc( const wxPoint& centre, double StAngle, double EndAngle, i
      *  the end point
      */
 
+    flushPath();
+
     if( radius <= 0 )
     {
         Circle( centre, width, FILLED_SHAPE, 0 );
@@ -546,6 +642,7 @@ void SVG_PLOTTER::BezierCurve( const wxPoint& aStart, const wxPoint& aControl1,
                            int aTolerance, int aLineThickness )
 {
 #if 1
+    flushPath();
     setFillMode( NO_FILL );
     SetCurrentLineWidth( aLineThickness );
 
@@ -572,6 +669,31 @@ void SVG_PLOTTER::PlotPoly( const std::vector<wxPoint>& aCornerList,
 
     setFillMode( aFill );
     SetCurrentLineWidth( aWidth );
+
+    if( m_optimized && aFill != FILLED_WITH_COLOR )
+    {
+        // The style of the current group is used, so it must be up to date
+        if( m_graphics_changed )
+            setSVGPlotStyle();
+
+        if( aFill == NO_FILL )
+        {
+            // Only strokes are merged: filled contours in a same path would make holes
+            appendPathPoint( userToDeviceCoordinates( aCornerList[0] ), true );
+
+            for( unsigned ii = 1; ii < aCornerList.size(); ii++ )
+                appendPathPoint( userToDeviceCoordinates( aCornerList[ii] ), false );
+        }
+        else
+        {
+            flushPath();
+            emitFilledPoly( aCornerList );
+        }
+
+        return;
+    }
+
+    flushPath();
     fprintf( outputFile, "<path ");
 
     switch( aFill )
@@ -618,6 +740,8 @@ void SVG_PLOTTER::PlotImage( const wxImage& aImage, const wxPoint& aPos,
 {
     wxSize pix_size( aImage.GetWidth(), aImage.GetHeight() );
 
+    flushPath();
+
     // Requested size (in IUs)
     DPOINT drawsize( aScaleFactor * pix_size.x,
                      aScaleFactor * pix_size.y );
@@ -665,6 +789,36 @@ void SVG_PLOTTER::PlotImage( const wxImage& aImage, const wxPoint& aPos,
 
 void SVG_PLOTTER::PenTo( const wxPoint& pos, char plume )
 {
+    if( m_optimized )
+    {
+        if( plume == 'Z' )
+        {
+            penState        = 'Z';
+            penLastpos.x    = -1;
+            penLastpos.y    = -1;
+            return;
+        }
+
+        if( penState == 'Z' )
+        {
+            if( m_fillMode != NO_FILL )
+            {
+                setFillMode( NO_FILL );
+                setSVGPlotStyle();
+            }
+
+            appendPathPoint( userToDeviceCoordinates( pos ), true );
+        }
+        else if( penState != plume || pos != penLastpos )
+        {
+            appendPathPoint( userToDeviceCoordinates( pos ), false );
+        }
+
+        penState    = plume;
+        penLastpos  = pos;
+        return;
+    }
+
     if( plume == 'Z' )
     {
         if( penState != 'Z' )
@@ -714,6 +868,9 @@ bool SVG_PLOTTER::StartPlot()
     wxASSERT( outputFile );
     wxString            msg;
 
+    m_pathData.clear();
+    m_shapes.clear();
+
     static const char*  header[] =
     {
         "<?xml version=\"1.0\" standalone=\"no\"?>\n",
@@ -768,6 +925,7 @@ bool SVG_PLOTTER::StartPlot()
 
 bool SVG_PLOTTER::EndPlot()
 {
+    flushPath();
     fputs( "</g> \n</svg>\n", outputFile );
     fclose( outputFile );
     outputFile = NULL;
@@ -792,6 +950,7 @@ void SVG_PLOTTER::Text( const wxPoint&              aPos,
     setFillMode( NO_FILL );
     SetColor( aColor );
     SetCurrentLineWidth( aWidth );
+    flushPath();
 
     wxPoint text_pos = aPos;
     const char *hjust = "start";
@@ -856,5 +1015,6 @@ void SVG_PLOTTER::Text( const wxPoint&              aPos,
              TO_UTF8( XmlEsc( aText ) ) );
     PLOTTER::Text( aPos, aColor, aText, aOrient, aSize, aH_justify, aV_justify,
                    aWidth, aItalic, aBold, aMultilineAllowed );
+    flushPath();
     fputs( "</g>", outputFile );
 }
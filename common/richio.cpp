@@ -23,11 +23,26 @@
  */
 
 
+#include <algorithm>
 #include <cstdarg>
+#include <cstring>
 #include <config.h> // HAVE_FGETC_NOLOCK
 
 #include <richio.h>
 
+#include <wx/mstream.h>
+#include <wx/wfstream.h>
+#include <wx/zstream.h>
+
+#ifdef __WINDOWS__
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 
 // Fall back to getc() when getc_unlocked() is not available on the target platform.
 #if !defined( HAVE_FGETC_NOLOCK )
@@ -225,6 +240,230 @@ char* FILE_LINE_READER::ReadLine()
 }
 
 
+MAPPED_FILE_LINE_READER::MAPPED_FILE_LINE_READER( const wxString& aFileName,
+            unsigned aStartingLineNumber, unsigned aMaxLineLength ):
+    LINE_READER( aMaxLineLength ),
+    m_data( nullptr ), m_size( 0 ), m_ndx( 0 ), m_mapped( false ),
+    m_savedChar( 0 ), m_saved( false )
+{
+    m_ownLine = m_line;
+    m_source  = aFileName;
+    m_lineNum = aStartingLineNumber;
+
+    bool opened = false;
+
+#ifdef __WINDOWS__
+    m_mapping = nullptr;
+
+    HANDLE file = CreateFileW( aFileName.wc_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                               OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL );
+
+    if( file != INVALID_HANDLE_VALUE )
+    {
+        LARGE_INTEGER size;
+
+        opened = GetFileSizeEx( file, &size );
+        m_size = opened ? (size_t) size.QuadPart : 0;
+
+        // An empty file cannot be mapped, and has no lines anyway
+        if( m_size > 0 )
+        {
+            m_mapping = CreateFileMappingW( file, NULL, PAGE_WRITECOPY, 0, 0, NULL );
+
+            if( m_mapping )
+                m_data = (char*) MapViewOfFile( m_mapping, FILE_MAP_COPY, 0, 0, 0 );
+
+            m_mapped = m_data != nullptr;
+
+            if( !m_mapped )
+            {
+                DWORD count = 0;
+
+                if( m_mapping )
+                    CloseHandle( m_mapping );
+
+                m_buffer.resize( m_size );
+                opened = ReadFile( file, m_buffer.data(), (DWORD) m_size, &count, NULL )
+                         && count == m_size;
+            }
+        }
+
+        CloseHandle( file );
+    }
+#else
+    int file = open( aFileName.fn_str(), O_RDONLY );
+
+    if( file >= 0 )
+    {
+        struct stat info;
+
+        opened = fstat( file, &info ) == 0;
+        m_size = opened ? (size_t) info.st_size : 0;
+
+        // An empty file cannot be mapped, and has no lines anyway
+        if( m_size > 0 )
+        {
+            void* data = mmap( nullptr, m_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0 );
+
+            m_mapped = data != MAP_FAILED;
+
+            if( m_mapped )
+            {
+                m_data = (char*) data;
+                madvise( data, m_size, MADV_SEQUENTIAL );
+            }
+            else
+            {
+                m_buffer.resize( m_size );
+                opened = read( file, m_buffer.data(), m_size ) == (ssize_t) m_size;
+            }
+        }
+
+        close( file );
+    }
+#endif
+
+    if( !opened )
+    {
+        wxString msg = wxString::Format(
+            _( "Unable to open filename \"%s\" for reading" ), aFileName.GetData() );
+        THROW_IO_ERROR( msg );
+    }
+
+    if( !m_mapped )
+        m_data = m_buffer.data();
+
+    if( m_size >= 2 && (unsigned char) m_data[0] == 0x1f && (unsigned char) m_data[1] == 0x8b )
+    {
+        try
+        {
+            decompress();
+        }
+        catch( ... )
+        {
+            // The destructor does not run when the constructor throws
+            unmap();
+            throw;
+        }
+    }
+}
+
+
+MAPPED_FILE_LINE_READER::~MAPPED_FILE_LINE_READER()
+{
+    // LINE_READER deletes its own buffer
+    m_line = m_ownLine;
+
+    unmap();
+}
+
+
+void MAPPED_FILE_LINE_READER::unmap()
+{
+    if( !m_mapped )
+        return;
+
+#ifdef __WINDOWS__
+    UnmapViewOfFile( m_data );
+    CloseHandle( m_mapping );
+#else
+    munmap( m_data, m_size );
+#endif
+
+    m_mapped = false;
+}
+
+
+void MAPPED_FILE_LINE_READER::decompress()
+{
+    wxMemoryInputStream compressed( m_data, m_size );
+    wxZlibInputStream   stream( compressed, wxZLIB_GZIP );
+    std::vector<char>   contents( std::max<size_t>( m_size * 4, 1 << 16 ) );
+    size_t              used = 0;
+
+    for( ;; )
+    {
+        if( used == contents.size() )
+            contents.resize( contents.size() * 2 );
+
+        stream.Read( contents.data() + used, contents.size() - used );
+        used += stream.LastRead();
+
+        if( stream.GetLastError() == wxSTREAM_EOF )
+            break;
+
+        if( !stream.IsOk() )
+        {
+            THROW_IO_ERROR( wxString::Format( _( "Unable to decompress file \"%s\"" ),
+                                              m_source.GetData() ) );
+        }
+    }
+
+    unmap();
+
+    contents.resize( used );
+    m_buffer.swap( contents );
+    m_data = m_buffer.data();
+    m_size = used;
+}
+
+
+char* MAPPED_FILE_LINE_READER::ReadLine()
+{
+    if( m_saved )
+    {
+        m_data[m_ndx] = m_savedChar;
+        m_saved = false;
+    }
+
+    const char* begin = m_data + m_ndx;
+    const char* nl = nullptr;
+
+    if( m_ndx < m_size )
+        nl = (const char*) memchr( begin, '\n', m_size - m_ndx );
+
+    m_length = nl ? nl - begin + 1 : m_size - m_ndx;    // include the newline, so +1
+
+    if( m_length >= m_maxLineLength )
+        THROW_IO_ERROR( _( "Maximum line length exceeded" ) );
+
+    if( m_ndx + m_length < m_size )
+    {
+        // The line ends before the data: terminate it in place
+        m_line = m_data + m_ndx;
+        m_savedChar = m_line[m_length];
+        m_saved = true;
+    }
+    else
+    {
+        // The last line has nothing after it to hold its nul, copy it
+        m_line = m_ownLine;
+
+        if( m_length + 1 > m_capacity )
+        {
+            unsigned length = m_length;
+
+            m_length = 0;
+            expandCapacity( length + 1 );
+            m_ownLine = m_line;
+            m_length = length;
+        }
+
+        if( m_length )
+            memcpy( m_line, begin, m_length );
+    }
+
+    m_line[m_length] = 0;
+    m_ndx += m_length;
+
+    // m_lineNum is incremented even if there was no line read, because this
+    // leads to better error reporting when we hit an end of file.
+    ++m_lineNum;
+
+    return m_length ? m_line : NULL;
+}
+
+
 STRING_LINE_READER::STRING_LINE_READER( const std::string& aString, const wxString& aSource ):
     LINE_READER( LINE_READER_LINE_DEFAULT_MAX ),
     m_lines( aString ), m_ndx( 0 )
@@ -513,6 +752,9 @@ FILE_OUTPUTFORMATTER::FILE_OUTPUTFORMATTER( const wxString& aFileName, const wxC
 
     if( !m_fp )
         THROW_IO_ERROR( strerror( errno ) );
+
+    // Boards and schematics are written by many small Print()s: write them in big blocks
+    setvbuf( m_fp, nullptr, _IOFBF, FILEOUTPUTBUFZ );
 }
 
 
@@ -530,6 +772,53 @@ void FILE_OUTPUTFORMATTER::write( const char* aOutBuf, int aCount )
 }
 
 
+GZIP_FILE_OUTPUTFORMATTER::GZIP_FILE_OUTPUTFORMATTER( const wxString& aFileName,
+                                                      char aQuoteChar ):
+    OUTPUTFORMATTER( OUTPUTFMTBUFZ, aQuoteChar ),
+    m_filename( aFileName )
+{
+    m_file.reset( new wxFFileOutputStream( aFileName, "wb" ) );
+
+    if( !m_file->IsOk() )
+        THROW_IO_ERROR( wxString::Format( _( "Cannot open file \"%s\"" ), aFileName ) );
+
+    m_zip.reset( new wxZlibOutputStream( *m_file, wxZ_DEFAULT_COMPRESSION, wxZLIB_GZIP ) );
+    m_pending.reserve( FILEOUTPUTBUFZ );
+}
+
+
+GZIP_FILE_OUTPUTFORMATTER::~GZIP_FILE_OUTPUTFORMATTER()
+{
+    // Like the fclose() of FILE_OUTPUTFORMATTER, a failure here cannot be reported
+    if( m_zip->IsOk() )
+        m_zip->Write( m_pending.data(), m_pending.size() );
+
+    // Closing the zlib stream writes the gzip trailer
+    m_zip->Close();
+    m_zip.reset();
+}
+
+
+void GZIP_FILE_OUTPUTFORMATTER::write( const char* aOutBuf, int aCount )
+{
+    m_pending.append( aOutBuf, (unsigned) aCount );
+
+    if( m_pending.size() >= FILEOUTPUTBUFZ )
+        flush();
+}
+
+
+void GZIP_FILE_OUTPUTFORMATTER::flush()
+{
+    m_zip->Write( m_pending.data(), m_pending.size() );
+
+    if( !m_zip->IsOk() || m_zip->LastWrite() != m_pending.size() )
+        THROW_IO_ERROR( wxString::Format( _( "Cannot write to file \"%s\"" ), m_filename ) );
+
+    m_pending.clear();
+}
+
+
 //-----<STREAM_OUTPUTFORMATTER>--------------------------------------
 
 void STREAM_OUTPUTFORMATTER::write( const char* aOutBuf, int aCount )
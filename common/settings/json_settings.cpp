@@ -21,6 +21,7 @@
 #include <algorithm>
 #include <fstream>
 #include <iomanip>
+#include <sstream>
 #include <utility>
 
 #include <common.h>
@@ -28,6 +29,7 @@
 #include <settings/json_settings.h>
 #include <settings/nested_settings.h>
 #include <settings/parameters.h>
+#include <settings/settings_manager.h>
 #include <wx/config.h>
 #include <wx/debug.h>
 #include <wx/filename.h>
@@ -116,6 +118,10 @@ void JSON_SETTINGS::LoadFromFile( const std::string& aDirectory )
 
     wxFileName path( aDirectory, m_filename, "json" );
 
+    // Read what was last saved, not what the file was before
+    if( m_manager )
+        m_manager->FlushWrites( path.GetFullPath() );
+
     if( !path.Exists() )
     {
         // Case 1: legacy migration, no .json extension yet
@@ -276,8 +282,14 @@ bool JSON_SETTINGS::SaveToFile( const std::string& aDirectory, bool aForce )
 
     try
     {
-        std::ofstream file( path.GetFullPath().ToStdString() );
-        file << std::setw( 2 ) << *this << std::endl;
+        std::stringstream contents;
+        contents << std::setw( 2 ) << *this << std::endl;
+
+        // The manager writes the file in the background, not to stall the UI on a slow drive
+        if( m_manager )
+            m_manager->QueueWrite( path.GetFullPath(), contents.str() );
+        else if( !SETTINGS_MANAGER::WriteFileAtomically( path.GetFullPath(), contents.str() ) )
+            wxLogTrace( traceSettings, "Warning: could not save %s", m_filename );
     }
     catch( const std::exception& e )
     {
@@ -18,6 +18,7 @@
  * with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <fstream>
 #include <regex>
 #include <wx/debug.h>
 #include <wx/filename.h>
@@ -44,7 +45,8 @@ const char* traceSettings = "SETTINGS";
 
 SETTINGS_MANAGER::SETTINGS_MANAGER() :
         m_common_settings( nullptr ),
-        m_migration_source()
+        m_migration_source(),
+        m_stopWriter( false )
 {
     // Check if the settings directory already exists, and if not, perform a migration if possible
     if( !MigrateIfNeeded() )
@@ -64,11 +66,111 @@ SETTINGS_MANAGER::SETTINGS_MANAGER() :
 
 SETTINGS_MANAGER::~SETTINGS_MANAGER()
 {
+    // The final flush: write what is still queued before the application exits
+    {
+        std::lock_guard<std::mutex> lock( m_writeMutex );
+        m_stopWriter = true;
+    }
+
+    m_writeCondition.notify_all();
+
+    if( m_writer.joinable() )
+        m_writer.join();
+
     m_settings.clear();
     m_color_settings.clear();
 }
 
 
+void SETTINGS_MANAGER::QueueWrite( const wxString& aPath, std::string aContents )
+{
+    {
+        std::lock_guard<std::mutex> lock( m_writeMutex );
+
+        if( m_pendingWrites.count( aPath ) )
+            wxLogTrace( traceSettings, "Coalescing the queued writes of %s", aPath );
+
+        m_pendingWrites[aPath] = std::move( aContents );
+
+        if( !m_writer.joinable() )
+            m_writer = std::thread( &SETTINGS_MANAGER::writerLoop, this );
+    }
+
+    m_writeCondition.notify_all();
+}
+
+
+void SETTINGS_MANAGER::FlushWrites( const wxString& aPath )
+{
+    std::unique_lock<std::mutex> lock( m_writeMutex );
+
+    m_writeCondition.wait( lock,
+            [&]()
+            {
+                if( aPath.IsEmpty() )
+                    return m_pendingWrites.empty() && m_currentWrite.IsEmpty();
+
+                return !m_pendingWrites.count( aPath ) && m_currentWrite != aPath;
+            } );
+}
+
+
+void SETTINGS_MANAGER::writerLoop()
+{
+    std::unique_lock<std::mutex> lock( m_writeMutex );
+
+    while( true )
+    {
+        m_writeCondition.wait( lock,
+                [&]()
+                {
+                    return m_stopWriter || !m_pendingWrites.empty();
+                } );
+
+        // Stop once all is written, for the last saves not to be lost
+        if( m_pendingWrites.empty() )
+            break;
+
+        auto        it = m_pendingWrites.begin();
+        std::string contents = std::move( it->second );
+
+        m_currentWrite = it->first;
+        m_pendingWrites.erase( it );
+
+        lock.unlock();
+
+        if( !WriteFileAtomically( m_currentWrite, contents ) )
+            wxLogTrace( traceSettings, "Warning: could not save %s", m_currentWrite );
+
+        lock.lock();
+
+        m_currentWrite.Clear();
+        m_writeCondition.notify_all();
+    }
+}
+
+
+bool SETTINGS_MANAGER::WriteFileAtomically( const wxString& aPath, const std::string& aContents )
+{
+    wxString tempPath = aPath + wxT( ".tmp" );
+
+    {
+        std::ofstream file( tempPath.ToStdString() );
+
+        file << aContents;
+        file.close();
+
+        if( !file )
+        {
+            wxRemoveFile( tempPath );
+            return false;
+        }
+    }
+
+    return wxRenameFile( tempPath, aPath, true );
+}
+
+
 JSON_SETTINGS* SETTINGS_MANAGER::RegisterSettings( JSON_SETTINGS* aSettings, bool aLoadNow )
 {
     std::unique_ptr<JSON_SETTINGS> ptr( aSettings );
@@ -273,6 +375,9 @@ void SETTINGS_MANAGER::loadAllColorSettings()
 
 void SETTINGS_MANAGER::ReloadColorSettings()
 {
+    // Let the themes being saved be found
+    FlushWrites();
+
     m_color_settings.clear();
     loadAllColorSettings();
 }
@@ -524,6 +524,42 @@ bool WildCompareString( const wxString& pattern, const wxString& string_to_tst,
 }
 
 
+bool ParseDecimal( const char* aText, double* aValue )
+{
+    // The powers of 10 exactly represented by a double
+    static const double pow10[] = { 1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                                    1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15 };
+
+    const char* p = aText;
+    bool        negative = ( *p == '-' );
+    uint64_t    mantissa = 0;       // wraps around harmlessly for the rejected long numbers
+    int         digits = 0;
+    int         decimals = 0;
+
+    if( *p == '-' || *p == '+' )
+        p++;
+
+    for( ; *p >= '0' && *p <= '9'; p++, digits++ )
+        mantissa = mantissa * 10 + ( *p - '0' );
+
+    if( *p == '.' )
+    {
+        for( p++; *p >= '0' && *p <= '9'; p++, digits++, decimals++ )
+            mantissa = mantissa * 10 + ( *p - '0' );
+    }
+
+    // A mantissa below 1e15 and a power of 10 are exact doubles, and their quotient is
+    // correctly rounded, as by strtod()
+    if( *p || digits == 0 || digits > 15 )
+        return false;
+
+    double value = mantissa / pow10[decimals];
+
+    *aValue = negative ? -value : value;
+    return true;
+}
+
+
 bool ApplyModifier( double& value, const wxString& aString )
 {
     static const wxString modifiers( wxT( "pnumkKM" ) );
@@ -0,0 +1,317 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <thread_pool.h>
+
+#include <advanced_config.h>
+
+#include <algorithm>
+#include <chrono>
+
+
+// The pool whose worker is the current thread (if any), and the queue of this worker
+static thread_local THREAD_POOL* t_pool = nullptr;
+static thread_local size_t       t_queue = 0;
+
+
+THREAD_POOL::THREAD_POOL( size_t aThreadCount ) :
+        m_queuedCount( 0 ),
+        m_nextQueue( 0 ),
+        m_stop( false )
+{
+    aThreadCount = std::max<size_t>( aThreadCount, 1 );
+
+    for( size_t ii = 0; ii < aThreadCount; ++ii )
+        m_queues.emplace_back( new WORKER_QUEUE );
+
+    for( size_t ii = 0; ii < aThreadCount; ++ii )
+        m_threads.emplace_back( &THREAD_POOL::workerLoop, this, ii );
+}
+
+
+THREAD_POOL::~THREAD_POOL()
+{
+    {
+        std::lock_guard<std::mutex> lock( m_sleepMutex );
+        m_stop = true;
+    }
+
+    m_sleepCondition.notify_all();
+
+    for( std::thread& thread : m_threads )
+        thread.join();
+}
+
+
+THREAD_POOL& THREAD_POOL::GetInstance()
+{
+    static THREAD_POOL pool( ADVANCED_CFG::GetCfg().m_MaxThreads > 0
+                                     ? ADVANCED_CFG::GetCfg().m_MaxThreads
+                                     : std::thread::hardware_concurrency() );
+
+    return pool;
+}
+
+
+void THREAD_POOL::ParallelFor( size_t aCount, const std::function<void( size_t )>& aFunc,
+                               const std::function<void()>& aIdle )
+{
+    TASK_GROUP group( *this );
+    group.ParallelFor( aCount, aFunc, aIdle );
+}
+
+
+void THREAD_POOL::submit( TASK&& aTask )
+{
+    // A worker queues its tasks in its own queue, the other threads spread them
+    size_t queue = ( t_pool == this ) ? t_queue : m_nextQueue++ % m_queues.size();
+
+    {
+        std::lock_guard<std::mutex> lock( m_queues[queue]->m_Mutex );
+        m_queues[queue]->m_Tasks.push_back( std::move( aTask ) );
+    }
+
+    {
+        // Counted under m_sleepMutex, so a worker cannot miss it when falling asleep
+        std::lock_guard<std::mutex> lock( m_sleepMutex );
+        m_queuedCount++;
+    }
+
+    m_sleepCondition.notify_one();
+}
+
+
+bool THREAD_POOL::popTask( size_t aQueue, bool aNewest, TASK_GROUP* aGroup, TASK& aTask )
+{
+    WORKER_QUEUE&               queue = *m_queues[aQueue];
+    std::lock_guard<std::mutex> lock( queue.m_Mutex );
+
+    auto isWanted =
+            [aGroup]( const TASK& aQueued )
+            {
+                return !aGroup || aQueued.m_Group == aGroup;
+            };
+
+    if( aNewest )
+    {
+        auto it = std::find_if( queue.m_Tasks.rbegin(), queue.m_Tasks.rend(), isWanted );
+
+        if( it == queue.m_Tasks.rend() )
+            return false;
+
+        aTask = std::move( *it );
+        queue.m_Tasks.erase( std::next( it ).base() );
+    }
+    else
+    {
+        auto it = std::find_if( queue.m_Tasks.begin(), queue.m_Tasks.end(), isWanted );
+
+        if( it == queue.m_Tasks.end() )
+            return false;
+
+        aTask = std::move( *it );
+        queue.m_Tasks.erase( it );
+    }
+
+    m_queuedCount--;
+    return true;
+}
+
+
+bool THREAD_POOL::runOneTask( TASK_GROUP* aGroup )
+{
+    size_t count = m_queues.size();
+    size_t first = ( t_pool == this ) ? t_queue : 0;
+    TASK   task;
+    bool   found = ( t_pool == this ) && popTask( t_queue, true, aGroup, task );
+
+    // The newest task of a queue is likely the one using the data in the cache of its worker:
+    // steal the oldest ones
+    for( size_t ii = 1; !found && ii <= count; ++ii )
+        found = popTask( ( first + ii ) % count, false, aGroup, task );
+
+    if( !found )
+        return false;
+
+    std::exception_ptr error;
+
+    if( !task.m_Group->IsCancelled() )
+    {
+        try
+        {
+            task.m_Func();
+        }
+        catch( ... )
+        {
+            error = std::current_exception();
+        }
+    }
+
+    task.m_Group->taskDone( error );
+    return true;
+}
+
+
+void THREAD_POOL::workerLoop( size_t aIndex )
+{
+    t_pool = this;
+    t_queue = aIndex;
+
+    while( true )
+    {
+        if( runOneTask() )
+            continue;
+
+        std::unique_lock<std::mutex> lock( m_sleepMutex );
+
+        m_sleepCondition.wait( lock, [this]() { return m_stop || m_queuedCount > 0; } );
+
+        if( m_stop )
+            return;
+    }
+}
+
+
+TASK_GROUP::TASK_GROUP( THREAD_POOL& aPool ) :
+        m_pool( aPool ),
+        m_pending( 0 ),
+        m_cancelled( false )
+{
+}
+
+
+TASK_GROUP::~TASK_GROUP()
+{
+    try
+    {
+        Wait();
+    }
+    catch( ... )
+    {
+        // The error was not waited for: nobody wants it
+    }
+}
+
+
+void TASK_GROUP::Run( std::function<void()> aTask )
+{
+    m_pending++;
+    m_pool.submit( { std::move( aTask ), this } );
+}
+
+
+void TASK_GROUP::ParallelFor( size_t aCount, const std::function<void( size_t )>& aFunc,
+                              const std::function<void()>& aIdle )
+{
+    if( aCount == 0 )
+        return;
+
+    std::atomic<size_t> nextItem( 0 );
+
+    auto runner = [&]()
+    {
+        for( size_t ii = nextItem++; ii < aCount && !m_cancelled; ii = nextItem++ )
+            aFunc( ii );
+    };
+
+    // The calling thread runs the loop too, unless it has to stay responsive
+    size_t runners = std::min( aCount, m_pool.GetThreadCount() + ( aIdle ? 0 : 1 ) );
+
+    for( size_t ii = aIdle ? 0 : 1; ii < runners; ++ii )
+        Run( runner );
+
+    std::exception_ptr error;
+
+    if( !aIdle )
+    {
+        try
+        {
+            runner();
+        }
+        catch( ... )
+        {
+            error = std::current_exception();
+            Cancel();
+        }
+    }
+
+    // The runners use this stack frame: always wait for them
+    Wait( aIdle );
+
+    if( error )
+        std::rethrow_exception( error );
+}
+
+
+void TASK_GROUP::Wait( const std::function<void()>& aIdle )
+{
+    if( aIdle )
+    {
+        std::unique_lock<std::mutex> lock( m_mutex );
+
+        while( !m_done.wait_for( lock, std::chrono::milliseconds( 100 ),
+                                 [this]() { return m_pending == 0; } ) )
+        {
+            lock.unlock();
+            aIdle();
+            lock.lock();
+        }
+    }
+    else
+    {
+        // Run the queued tasks of this group rather than wait idle.  The tasks of the other
+        // groups are left to the workers: one of them could keep this thread (possibly the
+        // UI thread) busy long after this group is done.
+        while( m_pending > 0 )
+        {
+            if( m_pool.runOneTask( this ) )
+                continue;
+
+            std::unique_lock<std::mutex> lock( m_mutex );
+            m_done.wait_for( lock, std::chrono::milliseconds( 1 ),
+                             [this]() { return m_pending == 0; } );
+        }
+    }
+
+    // Taking the lock also ensures the last taskDone() is finished with this group
+    std::lock_guard<std::mutex> lock( m_mutex );
+
+    if( m_error )
+    {
+        std::exception_ptr error = m_error;
+        m_error = nullptr;
+        std::rethrow_exception( error );
+    }
+}
+
+
+void TASK_GROUP::taskDone( std::exception_ptr aError )
+{
+    std::lock_guard<std::mutex> lock( m_mutex );
+
+    if( aError && !m_error )
+        m_error = aError;
+
+    if( --m_pending == 0 )
+        m_done.notify_all();
+}
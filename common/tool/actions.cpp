@@ -484,6 +484,11 @@ TOOL_ACTION ACTIONS::toggleCursorStyle( "common.Control.toggleCursorStyle",
         _( "Full-Window Crosshairs" ), _( "Switch display of full-window crosshairs" ),
         cursor_shape_xpm );
 
+TOOL_ACTION ACTIONS::toggleFrameStats( "common.Control.toggleFrameStats",
+        AS_GLOBAL, 0, "",
+        _( "Show Rendering Statistics" ),
+        _( "Display the frame times and the drawn items count on top of the canvas" ) );
+
 TOOL_ACTION ACTIONS::highContrastMode( "common.Control.highContrastMode",
         AS_GLOBAL,
         MD_CTRL + 'H', LEGACY_HK_NAME( "Toggle High Contrast Mode" ),
@@ -611,6 +616,12 @@ TOOL_ACTION ACTIONS::reportBug( "common.SuiteControl.reportBug",
         _( "Report a problem with KiCad" ),
         drc_xpm );
 
+TOOL_ACTION ACTIONS::showMemoryUsage( "common.SuiteControl.showMemoryUsage",
+        AS_GLOBAL, 0, "",
+        _( "Memory Usage" ),
+        _( "Show the memory held by the zone fills, undo history, caches..." ),
+        info_xpm );
+
 
 // System-wide selection Events
 
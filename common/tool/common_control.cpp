@@ -39,6 +39,8 @@
 #include <kicad_curl/kicad_curl_easy.h>
 #include <dialog_configure_paths.h>
 #include <eda_doc.h>
+#include <html_messagebox.h>
+#include <memory_accounting.h>
 
 #define URL_GET_INVOLVED "http://kicad-pcb.org/contribute/"
 
@@ -257,6 +259,38 @@ int COMMON_CONTROL::ReportBug( const TOOL_EVENT& aEvent )
 }
 
 
+int COMMON_CONTROL::ShowMemoryUsage( const TOOL_EVENT& aEvent )
+{
+    MEMORY_ACCOUNTING& accounting = MEMORY_ACCOUNTING::GetInstance();
+    size_t             totalBytes = 0;
+    wxString           html = "<table><tr><th align=left>" + _( "Subsystem" ) + "</th>"
+                              "<th align=right>" + _( "Memory" ) + "</th>"
+                              "<th align=right>" + _( "Items" ) + "</th></tr>";
+
+    for( const auto& usage : accounting.Collect() )
+    {
+        html += wxString::Format( "<tr><td>%s</td><td align=right>%.1f MB</td>"
+                                  "<td align=right>%zu</td></tr>",
+                                  usage.first, usage.second.m_Bytes / 1048576.0,
+                                  usage.second.m_Items );
+        totalBytes += usage.second.m_Bytes;
+    }
+
+    html += wxString::Format( "<tr><td><b>%s</b></td><td align=right><b>%.1f MB</b></td>"
+                              "<td></td></tr></table>",
+                              _( "Total" ), totalBytes / 1048576.0 );
+
+    accounting.Trace( "memory usage dialog" );
+
+    HTML_MESSAGE_BOX dlg( m_frame, _( "Memory Usage" ) );
+    dlg.MessageSet( _( "Estimated memory held by the subsystems of this program" ) );
+    dlg.AddHTML_Text( html );
+    dlg.ShowModal();
+
+    return 0;
+}
+
+
 void COMMON_CONTROL::setTransitions()
 {
     Go( &COMMON_CONTROL::ConfigurePaths,     ACTIONS::configurePaths.MakeEvent() );
@@ -272,6 +306,7 @@ void COMMON_CONTROL::setTransitions()
     Go( &COMMON_CONTROL::ListHotKeys,        ACTIONS::listHotKeys.MakeEvent() );
     Go( &COMMON_CONTROL::GetInvolved,        ACTIONS::getInvolved.MakeEvent() );
     Go( &COMMON_CONTROL::ReportBug,          ACTIONS::reportBug.MakeEvent() );
+    Go( &COMMON_CONTROL::ShowMemoryUsage,    ACTIONS::showMemoryUsage.MakeEvent() );
 }
 
 
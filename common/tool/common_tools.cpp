@@ -516,6 +516,16 @@ int COMMON_TOOLS::ToggleCursorStyle( const TOOL_EVENT& aEvent )
 }
 
 
+int COMMON_TOOLS::ToggleFrameStats( const TOOL_EVENT& aEvent )
+{
+    EDA_DRAW_PANEL_GAL* canvas = m_frame->GetCanvas();
+
+    canvas->SetShowFrameStats( !canvas->GetShowFrameStats() );
+
+    return 0;
+}
+
+
 int COMMON_TOOLS::SwitchCanvas( const TOOL_EVENT& aEvent )
 {
     if( aEvent.IsAction( &ACTIONS::acceleratedGraphics ) )
@@ -581,6 +591,7 @@ void COMMON_TOOLS::setTransitions()
     // Misc
     Go( &COMMON_TOOLS::ToggleCursor,       ACTIONS::toggleCursor.MakeEvent() );
     Go( &COMMON_TOOLS::ToggleCursorStyle,  ACTIONS::toggleCursorStyle.MakeEvent() );
+    Go( &COMMON_TOOLS::ToggleFrameStats,   ACTIONS::toggleFrameStats.MakeEvent() );
     Go( &COMMON_TOOLS::SwitchCanvas,       ACTIONS::acceleratedGraphics.MakeEvent() );
     Go( &COMMON_TOOLS::SwitchCanvas,       ACTIONS::standardGraphics.MakeEvent() );
 }
@@ -0,0 +1,167 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+
+#include <tool/coroutine_stack_pool.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include <new>
+
+
+void COROUTINE_STACK_POOL::RELEASER::operator()( char* aStack ) const
+{
+    COROUTINE_STACK_POOL::GetInstance().release( aStack, m_size );
+}
+
+
+COROUTINE_STACK_POOL::~COROUTINE_STACK_POOL()
+{
+    for( const FREE_STACK& stack : m_freeStacks )
+        unmapStack( stack.m_Stack, stack.m_Size );
+}
+
+
+COROUTINE_STACK_POOL& COROUTINE_STACK_POOL::GetInstance()
+{
+    static COROUTINE_STACK_POOL pool;
+
+    return pool;
+}
+
+
+COROUTINE_STACK_POOL::STACK COROUTINE_STACK_POOL::Acquire( size_t& aSize )
+{
+    size_t page = pageSize();
+
+    aSize = ( aSize + page - 1 ) / page * page;
+
+    {
+        std::lock_guard<std::mutex> lock( m_mutex );
+
+        for( auto it = m_freeStacks.begin(); it != m_freeStacks.end(); ++it )
+        {
+            if( it->m_Size == aSize )
+            {
+                char* stack = it->m_Stack;
+                m_freeStacks.erase( it );
+                return STACK( stack, RELEASER( aSize ) );
+            }
+        }
+    }
+
+    char* stack = mapStack( aSize );
+
+    if( !stack )
+        throw std::bad_alloc();
+
+    return STACK( stack, RELEASER( aSize ) );
+}
+
+
+void COROUTINE_STACK_POOL::release( char* aStack, size_t aSize )
+{
+    if( !aStack )
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock( m_mutex );
+
+        if( m_freeStacks.size() < MAX_FREE_STACKS )
+        {
+            m_freeStacks.push_back( { aStack, aSize } );
+            return;
+        }
+    }
+
+    unmapStack( aStack, aSize );
+}
+
+
+size_t COROUTINE_STACK_POOL::pageSize()
+{
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo( &info );
+    return info.dwPageSize;
+#else
+    return sysconf( _SC_PAGESIZE );
+#endif
+}
+
+
+char* COROUTINE_STACK_POOL::mapStack( size_t aSize )
+{
+    // The stacks grow down: the guard page is the lowest one
+    size_t page = pageSize();
+
+#ifdef _WIN32
+    char* mapping = static_cast<char*>( VirtualAlloc( nullptr, aSize + page,
+                                                      MEM_RESERVE | MEM_COMMIT,
+                                                      PAGE_READWRITE ) );
+
+    if( !mapping )
+        return nullptr;
+
+    DWORD previous;
+
+    if( !VirtualProtect( mapping, page, PAGE_NOACCESS, &previous ) )
+    {
+        VirtualFree( mapping, 0, MEM_RELEASE );
+        return nullptr;
+    }
+#else
+    void* address = mmap( nullptr, aSize + page, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+
+    if( address == MAP_FAILED )
+        return nullptr;
+
+    char* mapping = static_cast<char*>( address );
+
+    if( mprotect( mapping, page, PROT_NONE ) != 0 )
+    {
+        munmap( mapping, aSize + page );
+        return nullptr;
+    }
+#endif
+
+    return mapping + page;
+}
+
+
+void COROUTINE_STACK_POOL::unmapStack( char* aStack, size_t aSize )
+{
+    size_t page = pageSize();
+
+#ifdef _WIN32
+    VirtualFree( aStack - page, 0, MEM_RELEASE );
+#else
+    munmap( aStack - page, aSize + page );
+#endif
+}
@@ -0,0 +1,250 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+
+#include <trace_events.h>
+
+#include <advanced_config.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#include <wx/utils.h>
+
+
+// The buffer of the current thread in the recorder it was last used with
+static thread_local uint64_t t_recorderId = 0;
+static thread_local void*    t_buffer = nullptr;
+
+static std::atomic<uint64_t> s_nextRecorderId( 1 );
+
+
+TRACE_EVENTS::TRACE_EVENTS( bool aEnabled, const std::string& aFileName ) :
+        m_enabled( aEnabled ),
+        m_fileName( aFileName ),
+        m_origin( CLOCK::now() ),
+        m_id( s_nextRecorderId++ )
+{
+}
+
+
+TRACE_EVENTS::~TRACE_EVENTS()
+{
+    if( m_enabled && !m_fileName.empty() && !m_buffers.empty() )
+    {
+        // Each kiface links its own recorder: the ones saving after the first one of the
+        // process add a number to the file name, not to overwrite its trace
+        wxString saved;
+        long     count = 0;
+
+        if( wxGetEnv( wxT( "KICAD_TRACE_EVENTS_SAVED" ), &saved ) )
+            saved.ToLong( &count );
+
+        wxSetEnv( wxT( "KICAD_TRACE_EVENTS_SAVED" ), wxString::Format( "%ld", count + 1 ) );
+
+        if( count > 0 )
+            Save( m_fileName + "." + std::to_string( count ) );
+        else
+            Save( m_fileName );
+    }
+
+    for( std::unique_ptr<THREAD_BUFFER>& buffer : m_buffers )
+    {
+        for( CHUNK* chunk = buffer->m_First; chunk; )
+        {
+            CHUNK* next = chunk->m_Next;
+            delete chunk;
+            chunk = next;
+        }
+    }
+}
+
+
+TRACE_EVENTS& TRACE_EVENTS::GetInstance()
+{
+    static const std::string fileName = []()
+            {
+                const char* env = std::getenv( "KICAD_TRACE_EVENTS" );
+
+                if( env && *env )
+                    return std::string( env );
+
+                return ADVANCED_CFG::GetCfg().m_TraceEventsFile.ToStdString();
+            }();
+
+    static TRACE_EVENTS instance( !fileName.empty(), fileName );
+
+    return instance;
+}
+
+
+TRACE_EVENTS::THREAD_BUFFER* TRACE_EVENTS::threadBuffer()
+{
+    if( t_recorderId == m_id )
+        return static_cast<THREAD_BUFFER*>( t_buffer );
+
+    std::lock_guard<std::mutex> lock( m_buffersMutex );
+    THREAD_BUFFER*              buffer = nullptr;
+
+    // The thread may have used another recorder since this one
+    for( std::unique_ptr<THREAD_BUFFER>& candidate : m_buffers )
+    {
+        if( candidate->m_Thread == std::this_thread::get_id() )
+            buffer = candidate.get();
+    }
+
+    if( !buffer )
+    {
+        CHUNK* chunk = new CHUNK;
+        chunk->m_Count = 0;
+        chunk->m_Next = nullptr;
+
+        m_buffers.emplace_back( new THREAD_BUFFER{ std::this_thread::get_id(),
+                                                   (int) m_buffers.size(), chunk, chunk, 0 } );
+        buffer = m_buffers.back().get();
+    }
+
+    t_recorderId = m_id;
+    t_buffer = buffer;
+    return buffer;
+}
+
+
+void TRACE_EVENTS::AddEvent( const char* aName, int64_t aStart, int64_t aEnd )
+{
+    if( !m_enabled )
+        return;
+
+    THREAD_BUFFER* buffer = threadBuffer();
+
+    if( buffer->m_EventCount >= MAX_THREAD_EVENTS )
+        return;
+
+    CHUNK* chunk = buffer->m_Last;
+    size_t count = chunk->m_Count.load( std::memory_order_relaxed );
+
+    if( count == CHUNK_SIZE )
+    {
+        CHUNK* next = new CHUNK;
+        next->m_Count = 0;
+        next->m_Next = nullptr;
+
+        chunk->m_Next.store( next, std::memory_order_release );
+        buffer->m_Last = chunk = next;
+        count = 0;
+    }
+
+    EVENT& event = chunk->m_Events[count];
+
+    strncpy( event.m_Name, aName, MAX_NAME_LENGTH );
+    event.m_Name[MAX_NAME_LENGTH] = '\0';
+    event.m_Start = aStart;
+    event.m_Duration = aEnd - aStart;
+
+    // Publish the event to the thread saving the trace
+    chunk->m_Count.store( count + 1, std::memory_order_release );
+    buffer->m_EventCount++;
+}
+
+
+static void writeJsonString( std::ostream& aStream, const char* aText )
+{
+    aStream << '"';
+
+    for( const char* c = aText; *c; ++c )
+    {
+        if( *c == '"' || *c == '\\' )
+        {
+            aStream << '\\' << *c;
+        }
+        else if( (unsigned char) *c < 0x20 )
+        {
+            char escaped[8];
+            snprintf( escaped, sizeof( escaped ), "\\u%04x", *c );
+            aStream << escaped;
+        }
+        else
+        {
+            aStream << *c;
+        }
+    }
+
+    aStream << '"';
+}
+
+
+std::string TRACE_EVENTS::ToJson() const
+{
+    std::ostringstream json;
+    bool               first = true;
+
+    json << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    std::lock_guard<std::mutex> lock( m_buffersMutex );
+
+    for( const std::unique_ptr<THREAD_BUFFER>& buffer : m_buffers )
+    {
+        for( const CHUNK* chunk = buffer->m_First; chunk;
+                chunk = chunk->m_Next.load( std::memory_order_acquire ) )
+        {
+            size_t count = chunk->m_Count.load( std::memory_order_acquire );
+
+            for( size_t ii = 0; ii < count; ++ii )
+            {
+                const EVENT& event = chunk->m_Events[ii];
+                char         times[64];
+
+                // The times of a Chrome trace are in microseconds
+                snprintf( times, sizeof( times ), "\"ts\":%.3f,\"dur\":%.3f",
+                          event.m_Start / 1000.0, event.m_Duration / 1000.0 );
+
+                json << ( first ? "\n" : ",\n" ) << "{\"name\":";
+                writeJsonString( json, event.m_Name );
+                json << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->m_ThreadIndex << ','
+                     << times << '}';
+
+                first = false;
+            }
+        }
+    }
+
+    json << "\n]}\n";
+
+    return json.str();
+}
+
+
+bool TRACE_EVENTS::Save( const std::string& aFileName ) const
+{
+    std::ofstream file( aFileName, std::ios::out | std::ios::trunc );
+
+    if( !file )
+        return false;
+
+    file << ToJson();
+    return (bool) file;
+}
@@ -48,6 +48,9 @@ const wxChar* const traceZoomScroll = wxT( "KICAD_ZOOM_SCROLL" );
 const wxChar* const traceSymbolResolver = wxT( "KICAD_SYM_RESOLVE" );
 const wxChar* const traceDisplayLocation = wxT( "KICAD_DISPLAY_LOCATION" );
 const wxChar* const traceSchSheetPaths = wxT( "KICAD_SCH_SHEET_PATHS" );
+const wxChar* const traceZoneFiller = wxT( "KICAD_ZONE_FILLER" );
+const wxChar* const traceGalProfile = wxT( "KICAD_GAL_PROFILE" );
+const wxChar* const traceMemory = wxT( "KICAD_MEMORY" );
 
 
 wxString dump( const wxArrayString& aArray )
@@ -36,6 +36,11 @@
 #include <gal/definitions.h>
 #include <gal/graphics_abstraction_layer.h>
 #include <painter.h>
+#include <math/util.h>
+#include <thread_pool.h>
+#include <trace_events.h>
+
+#include <algorithm>
 
 #ifdef __WXDEBUG__
 #include <profile.h>
@@ -43,6 +48,22 @@
 
 namespace KIGFX {
 
+///> Margin (in pixels) of the redrawn part of a target around the changed items, for the
+///> antialiased edges and the minimum line widths
+static const int DIRTY_AREA_MARGIN = 3;
+
+///> Redraw the whole target when the changed items cover more than this part of the screen
+static const double MAX_DIRTY_SCREEN_FRACTION = 0.5;
+
+///> Largest distance (in pixels) of a viewport move from a whole number of pixels that still
+///> lets the previous frame be scrolled
+static const double MAX_SCROLL_ERROR = 0.01;
+
+///> Items smaller than this many pixels on the screen are drawn as a filled square instead
+///> of their cached geometry, see VIEW_ITEM::ViewGetProxyLayer()
+static const double PROXY_SCREEN_SIZE = 2.0;
+
+
 class VIEW;
 
 class VIEW_ITEM_DATA
@@ -53,6 +74,7 @@ public:
         m_flags( KIGFX::VISIBLE ),
         m_requiredUpdate( KIGFX::NONE ),
         m_drawPriority( 0 ),
+        m_colorKey( -1 ),
         m_groups( nullptr ),
         m_groupsSize( 0 ) {}
 
@@ -90,6 +112,8 @@ private:
     int     m_flags;            ///< Visibility flags
     int     m_requiredUpdate;   ///< Flag required for updating
     int     m_drawPriority;     ///< Order to draw this item in a layer, lowest first
+    int     m_colorKey;         ///< Key of the item in VIEW::m_colorKeyIndex, -1 if none
+    BOX2I   m_bbox;             ///< Bounding box the item is indexed with
 
     ///> Helper for storing cached items group ids
     typedef std::pair<int, int> GroupPair;
@@ -293,7 +317,8 @@ VIEW::VIEW( bool aIsDynamic ) :
     m_dynamic( aIsDynamic ),
     m_useDrawPriority( false ),
     m_nextDrawPriority( 0 ),
-    m_reverseDrawOrder( false )
+    m_reverseDrawOrder( false ),
+    m_bulkAdd( false )
 {
     // Set m_boundary to define the max area size. The default area size
     // is defined here as the max value of a int.
@@ -358,14 +383,22 @@ void VIEW::Add( VIEW_ITEM* aItem, int aDrawPriority )
 
     aItem->ViewGetLayers( layers, layers_count );
     aItem->viewPrivData()->saveLayers( layers, layers_count );
+    aItem->viewPrivData()->m_bbox = aItem->ViewBBox();
+
+    // An item removed since BeginBulkAdd() is still in the list
+    if( !m_bulkAdd || m_bulkRemoved.erase( aItem ) == 0 )
+        m_allItems->push_back( aItem );
 
-    m_allItems->push_back( aItem );
+    indexColorKey( aItem );
 
     for( int i = 0; i < layers_count; ++i )
     {
         VIEW_LAYER& l = m_layers[layers[i]];
-        l.items->Insert( aItem );
-        MarkTargetDirty( l.target );
+
+        if( !m_bulkAdd )
+            l.items->Insert( aItem );
+
+        MarkTargetDirty( l.target, aItem->viewPrivData()->m_bbox );
     }
 
     SetVisible( aItem, true );
@@ -373,6 +406,48 @@ void VIEW::Add( VIEW_ITEM* aItem, int aDrawPriority )
 }
 
 
+void VIEW::BeginBulkAdd()
+{
+    m_bulkAdd = true;
+}
+
+
+void VIEW::EndBulkAdd()
+{
+    if( !m_bulkAdd )
+        return;
+
+    m_bulkAdd = false;
+
+    if( !m_bulkRemoved.empty() )
+    {
+        m_allItems->erase( std::remove_if( m_allItems->begin(), m_allItems->end(),
+                                           [this]( VIEW_ITEM* aItem )
+                                           {
+                                               return m_bulkRemoved.count( aItem ) > 0;
+                                           } ),
+                           m_allItems->end() );
+        m_bulkRemoved.clear();
+    }
+
+    // Rebuild the index of each layer from scratch: packing all the items of a
+    // layer at once is much faster than inserting them one by one.
+    int                                              layers[VIEW_MAX_LAYERS], layers_count;
+    std::unordered_map<int, std::vector<VIEW_ITEM*>> layerItems;
+
+    for( VIEW_ITEM* item : *m_allItems )
+    {
+        item->viewPrivData()->getLayers( layers, layers_count );
+
+        for( int i = 0; i < layers_count; ++i )
+            layerItems[layers[i]].push_back( item );
+    }
+
+    for( auto& l : m_layers )
+        l.second.items->BulkLoad( layerItems[l.first] );
+}
+
+
 void VIEW::Remove( VIEW_ITEM* aItem )
 {
     if( !aItem )
@@ -384,13 +459,25 @@ void VIEW::Remove( VIEW_ITEM* aItem )
         return;
 
     wxCHECK( viewData->m_view == this, /*void*/ );
-    auto item = std::find( m_allItems->begin(), m_allItems->end(), aItem );
 
-    if( item != m_allItems->end() )
+    unindexColorKey( aItem );
+
+    if( m_bulkAdd )
     {
-        m_allItems->erase( item );
+        // Searching the list for each item is what makes the removal of many items slow
+        m_bulkRemoved.insert( aItem );
         viewData->clearUpdateFlags();
     }
+    else
+    {
+        auto item = std::find( m_allItems->begin(), m_allItems->end(), aItem );
+
+        if( item != m_allItems->end() )
+        {
+            m_allItems->erase( item );
+            viewData->clearUpdateFlags();
+        }
+    }
 
     int layers[VIEW::VIEW_MAX_LAYERS], layers_count;
     viewData->getLayers( layers, layers_count );
@@ -398,8 +485,11 @@ void VIEW::Remove( VIEW_ITEM* aItem )
     for( int i = 0; i < layers_count; ++i )
     {
         VIEW_LAYER& l = m_layers[layers[i]];
-        l.items->Remove( aItem );
-        MarkTargetDirty( l.target );
+
+        if( !m_bulkAdd )
+            l.items->Remove( aItem, viewData->m_bbox );
+
+        MarkTargetDirty( l.target, viewData->m_bbox );
 
         // Clear the GAL cache
         int prevGroup = viewData->getGroup( layers[i] );
@@ -603,6 +693,8 @@ void VIEW::SetScale( double aScale, VECTOR2D aAnchor )
 
 void VIEW::SetCenter( const VECTOR2D& aCenter )
 {
+    const MATRIX3x3D oldMatrix = m_gal->GetWorldScreenMatrix();
+
     m_center = aCenter;
 
     if( !m_boundary.Contains( aCenter ) )
@@ -621,8 +713,74 @@ void VIEW::SetCenter( const VECTOR2D& aCenter )
     m_gal->SetLookAtPoint( m_center );
     m_gal->ComputeWorldScreenMatrix();
 
-    // Redraw everything after the viewport has changed
-    MarkDirty();
+    // Redraw everything after the viewport has changed, unless it has only been moved
+    if( !markPanned( oldMatrix ) )
+        MarkDirty();
+}
+
+
+bool VIEW::markPanned( const MATRIX3x3D& aOldMatrix )
+{
+    const MATRIX3x3D& matrix = m_gal->GetWorldScreenMatrix();
+
+    for( int i = 0; i < 2; ++i )
+    {
+        for( int j = 0; j < 2; ++j )
+        {
+            if( matrix.m_data[i][j] != aOldMatrix.m_data[i][j] )
+                return false;
+        }
+    }
+
+    VECTOR2D shift( matrix.m_data[0][2] - aOldMatrix.m_data[0][2],
+                    matrix.m_data[1][2] - aOldMatrix.m_data[1][2] );
+    VECTOR2I pixels( KiROUND( shift.x ), KiROUND( shift.y ) );
+    VECTOR2I screenSize = m_gal->GetScreenPixelSize();
+
+    if( std::abs( shift.x - pixels.x ) > MAX_SCROLL_ERROR
+            || std::abs( shift.y - pixels.y ) > MAX_SCROLL_ERROR
+            || std::abs( m_scrollOffset.x + pixels.x ) >= screenSize.x
+            || std::abs( m_scrollOffset.y + pixels.y ) >= screenSize.y )
+    {
+        return false;
+    }
+
+    m_scrollOffset += pixels;
+
+    // The strips of the screen exposed by the move
+    BOX2D exposed[2];
+
+    if( pixels.x > 0 )
+        exposed[0] = BOX2D( VECTOR2D( 0, 0 ), VECTOR2D( pixels.x, screenSize.y ) );
+    else if( pixels.x < 0 )
+        exposed[0] = BOX2D( VECTOR2D( screenSize.x + pixels.x, 0 ),
+                            VECTOR2D( -pixels.x, screenSize.y ) );
+
+    if( pixels.y > 0 )
+        exposed[1] = BOX2D( VECTOR2D( 0, 0 ), VECTOR2D( screenSize.x, pixels.y ) );
+    else if( pixels.y < 0 )
+        exposed[1] = BOX2D( VECTOR2D( 0, screenSize.y + pixels.y ),
+                            VECTOR2D( screenSize.x, -pixels.y ) );
+
+    for( const BOX2D& strip : exposed )
+    {
+        if( strip.GetWidth() == 0 || strip.GetHeight() == 0 )
+            continue;
+
+        BOX2D area( ToWorld( strip.GetOrigin() ), VECTOR2D( 0, 0 ) );
+
+        area.Merge( ToWorld( strip.GetEnd() ) );
+        area.Normalize();
+
+        BOX2I areai( VECTOR2I( area.GetPosition() ), VECTOR2I( area.GetSize() ) );
+
+        MarkTargetDirty( TARGET_CACHED, areai );
+        MarkTargetDirty( TARGET_NONCACHED, areai );
+    }
+
+    MarkTargetDirty( TARGET_OVERLAY );
+
+    return true;
 }
 
 
@@ -795,6 +953,96 @@ void VIEW::UpdateLayerColor( int aLayer )
 }
 
 
+void VIEW::SetColorKeyFunction( std::function<int( const VIEW_ITEM* )> aKeyFunction )
+{
+    m_colorKeyFunction = std::move( aKeyFunction );
+    m_colorKeyIndex.clear();
+
+    for( VIEW_ITEM* item : *m_allItems )
+    {
+        if( item->viewPrivData() )
+            item->viewPrivData()->m_colorKey = -1;
+
+        if( !m_bulkRemoved.count( item ) )
+            indexColorKey( item );
+    }
+}
+
+
+void VIEW::indexColorKey( VIEW_ITEM* aItem )
+{
+    auto viewData = aItem->viewPrivData();
+    int  key = m_colorKeyFunction ? m_colorKeyFunction( aItem ) : -1;
+
+    if( key == viewData->m_colorKey )
+        return;
+
+    unindexColorKey( aItem );
+
+    if( key >= 0 )
+        m_colorKeyIndex[key].insert( aItem );
+
+    viewData->m_colorKey = key;
+}
+
+
+void VIEW::unindexColorKey( VIEW_ITEM* aItem )
+{
+    auto viewData = aItem->viewPrivData();
+
+    if( viewData->m_colorKey < 0 )
+        return;
+
+    auto entry = m_colorKeyIndex.find( viewData->m_colorKey );
+
+    if( entry != m_colorKeyIndex.end() )
+    {
+        entry->second.erase( aItem );
+
+        if( entry->second.empty() )
+            m_colorKeyIndex.erase( entry );
+    }
+
+    viewData->m_colorKey = -1;
+}
+
+
+void VIEW::UpdateColorsOfKeys( const std::set<int>& aKeys )
+{
+    if( m_gal->IsVisible() )
+    {
+        GAL_UPDATE_CONTEXT ctx( m_gal );
+
+        for( int key : aKeys )
+        {
+            auto entry = m_colorKeyIndex.find( key );
+
+            if( entry == m_colorKeyIndex.end() )
+                continue;
+
+            for( VIEW_ITEM* item : entry->second )
+            {
+                auto viewData = item->viewPrivData();
+                int  layers[VIEW::VIEW_MAX_LAYERS], layers_count;
+
+                viewData->getLayers( layers, layers_count );
+
+                for( int i = 0; i < layers_count; ++i )
+                {
+                    const COLOR4D color = m_painter->GetSettings()->GetColor( item, layers[i] );
+                    int group = viewData->getGroup( layers[i] );
+
+                    if( group >= 0 )
+                        m_gal->ChangeGroupColor( group, color );
+                }
+            }
+        }
+    }
+
+    MarkDirty();
+}
+
+
 void VIEW::UpdateAllLayersColor()
 {
     if( m_gal->IsVisible() )
@@ -963,6 +1211,11 @@ struct VIEW::drawItem
         useDrawPriority( aUseDrawPriority ),
         reverseDrawOrder( aReverseDrawOrder )
     {
+        // Cached items are the ones that may be drawn as proxies, but never on paper
+        if( view->IsCached( aLayer ) && view->GetPrintMode() <= 0 )
+            proxySize = PROXY_SCREEN_SIZE / view->m_gal->GetWorldScale();
+        else
+            proxySize = 0.0;
     }
 
     bool operator()( VIEW_ITEM* aItem )
@@ -975,11 +1228,28 @@ struct VIEW::drawItem
         if( !drawCondition )
             return true;
 
+        const BOX2I& bbox = aItem->viewPrivData()->m_bbox;
+
+        if( bbox.GetWidth() < proxySize && bbox.GetHeight() < proxySize )
+        {
+            int proxyLayer = aItem->ViewGetProxyLayer();
+
+            if( proxyLayer == layer )
+            {
+                view->drawProxy( aItem, layer, proxySize );
+                drawnCount++;
+            }
+
+            if( proxyLayer >= 0 )
+                return true;
+        }
+
         if( useDrawPriority )
             drawItems.push_back( aItem );
         else
             view->draw( aItem, layer );
 
+        drawnCount++;
         return true;
     }
 
@@ -1003,24 +1273,53 @@ struct VIEW::drawItem
     VIEW* view;
     int layer, layers[VIEW_MAX_LAYERS];
     bool useDrawPriority, reverseDrawOrder;
+    double proxySize;
+    int drawnCount = 0;
     std::vector<VIEW_ITEM*> drawItems;
 };
 
 
+void VIEW::drawProxy( VIEW_ITEM* aItem, int aLayer, double aSize )
+{
+    BOX2I    bbox = aItem->viewPrivData()->m_bbox;
+    VECTOR2D center( bbox.Centre() );
+    VECTOR2D half( aSize / 2, aSize / 2 );
+
+    // Always cover a few pixels, so the item does not vanish between the pixel centers
+    m_gal->SetIsFill( true );
+    m_gal->SetIsStroke( false );
+    m_gal->SetFillColor( m_painter->GetSettings()->GetColor( aItem, aLayer ) );
+    m_gal->DrawRectangle( center - half, center + half );
+}
+
+
 void VIEW::redrawRect( const BOX2I& aRect )
 {
+    BOX2I wholeArea;
+
+    wholeArea.SetMaximum();
+    m_drawnItemCounts.clear();
+
     for( VIEW_LAYER* l : m_orderedLayers )
     {
         if( l->visible && IsTargetDirty( l->target ) && areRequiredLayersEnabled( l->id ) )
         {
             drawItem drawFunc( this, l->id, m_useDrawPriority, m_reverseDrawOrder );
+            BOX2I    rect = aRect;
+
+            // Only the dirty part of the target was cleared, see ClearTargets()
+            if( m_dirtyAreas[l->target] != wholeArea )
+                rect = rect.Intersect( m_dirtyAreas[l->target] );
 
             m_gal->SetTarget( l->target );
             m_gal->SetLayerDepth( l->renderingOrder );
-            l->items->Query( aRect, drawFunc );
+            l->items->Query( rect, drawFunc );
 
             if( m_useDrawPriority )
                 drawFunc.deferredDraw();
+
+            if( drawFunc.drawnCount > 0 )
+                m_drawnItemCounts[l->id] = drawFunc.drawnCount;
         }
     }
 }
@@ -1113,6 +1412,8 @@ void VIEW::Clear()
     BOX2I r;
     r.SetMaximum();
     m_allItems->clear();
+    m_bulkRemoved.clear();
+    m_colorKeyIndex.clear();
 
     for( LAYER_MAP_ITER i = m_layers.begin(); i != m_layers.end(); ++i )
         i->second.items->RemoveAll();
@@ -1123,16 +1424,101 @@ void VIEW::Clear()
 }
 
 
+void VIEW::MarkTargetDirty( int aTarget, const BOX2I& aArea )
+{
+    wxCHECK( aTarget < TARGETS_NUMBER, /* void */ );
+
+    BOX2I wholeArea;
+
+    wholeArea.SetMaximum();
+
+    if( !m_dirtyTargets[aTarget] )
+        m_dirtyAreas[aTarget] = aArea;
+    else if( m_dirtyAreas[aTarget] != wholeArea )
+        m_dirtyAreas[aTarget] = ( aArea == wholeArea ) ? aArea : m_dirtyAreas[aTarget].Merge( aArea );
+
+    m_dirtyTargets[aTarget] = true;
+}
+
+
+bool VIEW::mergeDirtyAreas( BOX2I& aScreenRect )
+{
+    BOX2I wholeArea;
+    BOX2I area;
+    bool  first = true;
+
+    wholeArea.SetMaximum();
+
+    for( int target : { TARGET_CACHED, TARGET_NONCACHED } )
+    {
+        if( !IsTargetDirty( target ) )
+            continue;
+
+        if( m_dirtyAreas[target] == wholeArea )
+            return false;
+
+        area = first ? m_dirtyAreas[target] : area.Merge( m_dirtyAreas[target] );
+        first = false;
+    }
+
+    area.Inflate( KiROUND( DIRTY_AREA_MARGIN / m_gal->GetWorldScale() ) );
+
+    // The screen area covered by the world area (the view may be flipped)
+    BOX2D screenArea( ToScreen( VECTOR2D( area.GetOrigin() ) ), VECTOR2D( 0, 0 ) );
+
+    screenArea.Merge( ToScreen( VECTOR2D( area.GetEnd() ) ) );
+    screenArea.Normalize();
+
+    VECTOR2D screenSize = m_gal->GetScreenPixelSize();
+
+    if( screenArea.GetWidth() * screenArea.GetHeight()
+            > MAX_DIRTY_SCREEN_FRACTION * screenSize.x * screenSize.y )
+    {
+        return false;
+    }
+
+    aScreenRect = BOX2I( VECTOR2I( KiROUND( screenArea.GetX() ) - 1,
+                                   KiROUND( screenArea.GetY() ) - 1 ),
+                         VECTOR2I( KiROUND( screenArea.GetWidth() ) + 2,
+                                   KiROUND( screenArea.GetHeight() ) + 2 ) );
+
+    m_dirtyAreas[TARGET_CACHED] = area;
+    m_dirtyAreas[TARGET_NONCACHED] = area;
+
+    return true;
+}
+
+
 void VIEW::ClearTargets()
 {
     if( IsTargetDirty( TARGET_CACHED ) || IsTargetDirty( TARGET_NONCACHED ) )
     {
+        BOX2I screenRect;
+        bool  partial = mergeDirtyAreas( screenRect );
+
+        // The contents kept from the previous frame have to follow the viewport moves
+        if( partial && m_scrollOffset != VECTOR2I( 0, 0 ) )
+            partial = m_gal->ScrollTargets( m_scrollOffset );
+
+        partial = partial && m_gal->SetClipRect( screenRect );
+        m_scrollOffset = VECTOR2I( 0, 0 );
+
         // TARGET_CACHED and TARGET_NONCACHED have to be redrawn together, as they contain
         // layers that rely on each other (eg. netnames are noncached, but tracks - are cached)
         m_gal->ClearTarget( TARGET_NONCACHED );
         m_gal->ClearTarget( TARGET_CACHED );
 
-        MarkDirty();
+        if( partial )
+        {
+            // Only the changed part of both targets was cleared
+            m_dirtyTargets[TARGET_CACHED] = true;
+            m_dirtyTargets[TARGET_NONCACHED] = true;
+            MarkTargetDirty( TARGET_OVERLAY );
+        }
+        else
+        {
+            MarkDirty();
+        }
     }
 
     if( IsTargetDirty( TARGET_OVERLAY ) )
@@ -1144,6 +1530,8 @@ void VIEW::ClearTargets()
 
 void VIEW::Redraw()
 {
+    TRACE_SCOPE trace( "view-redraw" );
+
 #ifdef __WXDEBUG__
     PROF_COUNTER totalRealTime;
 #endif /* __WXDEBUG__ */
@@ -1163,6 +1551,7 @@ void VIEW::Redraw()
 
     redrawRect( recti );
     // All targets were redrawn, so nothing is dirty
+    m_scrollOffset = VECTOR2I( 0, 0 );
     markTargetClean( TARGET_CACHED );
     markTargetClean( TARGET_NONCACHED );
     markTargetClean( TARGET_OVERLAY );
@@ -1251,7 +1640,7 @@ void VIEW::invalidateItem( VIEW_ITEM* aItem, int aUpdateFlags )
         }
 
         // Mark those layers as dirty, so the VIEW will be refreshed
-        MarkTargetDirty( m_layers[layerId].target );
+        MarkTargetDirty( m_layers[layerId].target, aItem->viewPrivData()->m_bbox );
     }
 
     aItem->viewPrivData()->clearUpdateFlags();
@@ -1328,12 +1717,29 @@ void VIEW::updateBbox( VIEW_ITEM* aItem )
 
     aItem->ViewGetLayers( layers, layers_count );
 
+    // Redraw both where the item was and where it is now
+    BOX2I dirtyArea;
+    BOX2I previousBBox;
+
+    if( aItem->viewPrivData() )
+    {
+        previousBBox = aItem->viewPrivData()->m_bbox;
+        dirtyArea = previousBBox;
+        aItem->viewPrivData()->m_bbox = aItem->ViewBBox();
+        dirtyArea.Merge( aItem->viewPrivData()->m_bbox );
+    }
+    else
+    {
+        dirtyArea.SetMaximum();
+        previousBBox.SetMaximum();
+    }
+
     for( int i = 0; i < layers_count; ++i )
     {
         VIEW_LAYER& l = m_layers[layers[i]];
-        l.items->Remove( aItem );
+        l.items->Remove( aItem, previousBBox );
         l.items->Insert( aItem );
-        MarkTargetDirty( l.target );
+        MarkTargetDirty( l.target, dirtyArea );
     }
 }
 
@@ -1352,8 +1758,8 @@ void VIEW::updateLayers( VIEW_ITEM* aItem )
     for( int i = 0; i < layers_count; ++i )
     {
         VIEW_LAYER& l = m_layers[layers[i]];
-        l.items->Remove( aItem );
-        MarkTargetDirty( l.target );
+        l.items->Remove( aItem, viewData->m_bbox );
+        MarkTargetDirty( l.target, viewData->m_bbox );
 
         if( IsCached( l.id ) )
         {
@@ -1371,12 +1777,13 @@ void VIEW::updateLayers( VIEW_ITEM* aItem )
     // Add the item to new layer set
     aItem->ViewGetLayers( layers, layers_count );
     viewData->saveLayers( layers, layers_count );
+    viewData->m_bbox = aItem->ViewBBox();
 
     for( int i = 0; i < layers_count; i++ )
     {
         VIEW_LAYER& l = m_layers[layers[i]];
         l.items->Insert( aItem );
-        MarkTargetDirty( l.target );
+        MarkTargetDirty( l.target, viewData->m_bbox );
     }
 }
 
@@ -1418,12 +1825,44 @@ void VIEW::RecacheAllItems()
 }
 
 
+void VIEW::prepareItems()
+{
+    // Below this count, starting the threads costs more than it saves
+    const size_t minParallelCount = 1000;
+
+    if( !m_painter )
+        return;
+
+    std::vector<const VIEW_ITEM*> items;
+
+    for( VIEW_ITEM* item : *m_allItems )
+    {
+        auto viewData = item->viewPrivData();
+
+        if( viewData && ( viewData->m_requiredUpdate & ( GEOMETRY | LAYERS | REPAINT | INITIAL_ADD ) ) )
+            items.push_back( item );
+    }
+
+    if( items.size() < 2 * minParallelCount )
+        return;
+
+    THREAD_POOL::GetInstance().ParallelFor( items.size(),
+            [&]( size_t i )
+            {
+                m_painter->PrepareDraw( items[i] );
+            } );
+}
+
+
 void VIEW::UpdateItems()
 {
     if( m_gal->IsVisible() )
     {
         GAL_UPDATE_CONTEXT ctx( m_gal );
 
+        // The geometry goes to the GAL serially, but its costly parts can be built in parallel
+        prepareItems();
+
         for( VIEW_ITEM* item : *m_allItems )
         {
             auto viewData = item->viewPrivData();
@@ -1548,6 +1987,10 @@ void VIEW::Update( VIEW_ITEM* aItem, int aUpdateFlags )
 
     viewData->m_requiredUpdate |= aUpdateFlags;
 
+    // The key may have changed with the item
+    if( m_colorKeyFunction && viewData->m_view == this )
+        indexColorKey( aItem );
+
 }
 
 
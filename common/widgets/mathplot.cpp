@@ -696,24 +696,23 @@ void mpFXY::Plot( wxDC& dc, mpWindow& w )
         }
         else
         {
-            wxPoint* points = new wxPoint[GetCount()];
-            int      count = 0;
+            std::vector<wxPoint> points;
 
-            while( GetNextXY( x, y ) )
+            if( !GetDecimatedPoints( w, startPx, endPx, points ) )
             {
-                double px = m_scaleX->TransformToPlot( x );
-                double py = m_scaleY->TransformToPlot( y );
+                points.reserve( GetCount() );
 
-                wxCoord x1 = w.x2p( px );
-                wxCoord y1 = w.y2p( py );
+                while( GetNextXY( x, y ) )
+                {
+                    double px = m_scaleX->TransformToPlot( x );
+                    double py = m_scaleY->TransformToPlot( y );
 
-                points[count++] = wxPoint( x1, y1 );
+                    points.emplace_back( w.x2p( px ), w.y2p( py ) );
+                }
             }
 
-            if( count > 0 )
-                dc.DrawLines( count, points );
-
-            delete[] points;
+            if( !points.empty() )
+                dc.DrawLines( points.size(), points.data() );
         }
 
         if( !m_name.IsEmpty() && m_showName )
@@ -3284,6 +3283,8 @@ mpFXYVector::mpFXYVector( const wxString& name, int flags ) : mpFXY( name, flags
     m_minY  = -1;
     m_maxY  = 1;
     m_type  = mpLAYER_PLOT;
+    m_lodValid = false;
+    m_xSorted = false;
 }
 
 
@@ -3369,6 +3370,186 @@ void mpFXYVector::Clear()
 {
     m_xs.clear();
     m_ys.clear();
+    m_lodValid = false;
+}
+
+
+void mpFXYVector::AppendData( const double* xs, const double* ys, size_t count )
+{
+    for( size_t i = 0; i < count; i++ )
+    {
+        if( m_xs.empty() )
+        {
+            m_minX  = m_maxX = xs[i];
+            m_minY  = m_maxY = ys[i];
+        }
+
+        m_minX  = std::min( m_minX, xs[i] );
+        m_maxX  = std::max( m_maxX, xs[i] );
+        m_minY  = std::min( m_minY, ys[i] );
+        m_maxY  = std::max( m_maxY, ys[i] );
+
+        m_xs.push_back( xs[i] );
+        m_ys.push_back( ys[i] );
+    }
+
+    m_lodValid = false;
+}
+
+
+void mpFXYVector::BuildLod()
+{
+    m_lod.clear();
+    m_xSorted = std::is_sorted( m_xs.begin(), m_xs.end() );
+
+    while( ( m_lod.empty() ? m_ys.size() : m_lod.back().m_min.size() ) > LOD_FACTOR )
+    {
+        const std::vector<double>& mins = m_lod.empty() ? m_ys : m_lod.back().m_min;
+        const std::vector<double>& maxs = m_lod.empty() ? m_ys : m_lod.back().m_max;
+        size_t      count = ( mins.size() + LOD_FACTOR - 1 ) / LOD_FACTOR;
+        LOD_LEVEL   level;
+
+        level.m_min.reserve( count );
+        level.m_max.reserve( count );
+
+        for( size_t block = 0; block < count; block++ )
+        {
+            size_t  first   = block * LOD_FACTOR;
+            size_t  last    = std::min( first + LOD_FACTOR, mins.size() );
+            double  ymin    = mins[first];
+            double  ymax    = maxs[first];
+
+            for( size_t i = first + 1; i < last; i++ )
+            {
+                ymin    = std::min( ymin, mins[i] );
+                ymax    = std::max( ymax, maxs[i] );
+            }
+
+            level.m_min.push_back( ymin );
+            level.m_max.push_back( ymax );
+        }
+
+        m_lod.push_back( std::move( level ) );
+    }
+
+    m_lodValid = true;
+}
+
+
+void mpFXYVector::GetRangeMinMax( size_t first, size_t last, double& ymin, double& ymax ) const
+{
+    size_t  level = 0;  // the level of first and last, 0 for the samples
+
+    ymin    = m_ys[first];
+    ymax    = m_ys[first];
+
+    auto take = [&]( size_t index )
+    {
+        ymin    = std::min( ymin, level ? m_lod[level - 1].m_min[index] : m_ys[index] );
+        ymax    = std::max( ymax, level ? m_lod[level - 1].m_max[index] : m_ys[index] );
+    };
+
+    while( first < last )
+    {
+        if( level < m_lod.size() && last - first >= 2 * LOD_FACTOR )
+        {
+            // Take the partial blocks at both ends, and the whole blocks at the next level
+            while( first % LOD_FACTOR )
+                take( first++ );
+
+            while( last % LOD_FACTOR )
+                take( --last );
+
+            first   /= LOD_FACTOR;
+            last    /= LOD_FACTOR;
+            level++;
+        }
+        else
+        {
+            take( first++ );
+        }
+    }
+}
+
+
+bool mpFXYVector::GetDecimatedPoints( mpWindow& w, wxCoord startPx, wxCoord endPx,
+                                      std::vector<wxPoint>& points )
+{
+    size_t count = m_xs.size();
+
+    // Up to 4 points are drawn per pixel column: not worth it for fewer samples
+    if( count < 8 * (size_t) std::max( 1, endPx - startPx ) )
+        return false;
+
+    if( !m_lodValid )
+        BuildLod();
+
+    if( !m_xSorted )
+        return false;
+
+    auto xPx = [&]( size_t i )
+    {
+        return w.x2p( m_scaleX->TransformToPlot( m_xs[i] ) );
+    };
+
+    auto yPx = [&]( double y )
+    {
+        return w.y2p( m_scaleY->TransformToPlot( y ) );
+    };
+
+    // The first sample at or right of pixel column px, from the sample from
+    auto firstAt = [&]( wxCoord px, size_t from )
+    {
+        size_t to = count;
+
+        while( from < to )
+        {
+            size_t mid = from + ( to - from ) / 2;
+
+            if( xPx( mid ) < px )
+                from = mid + 1;
+            else
+                to = mid;
+        }
+
+        return from;
+    };
+
+    size_t i = firstAt( startPx, 0 );
+
+    // The segment coming into the view
+    if( i > 0 )
+        points.emplace_back( xPx( i - 1 ), yPx( m_ys[i - 1] ) );
+
+    while( i < count )
+    {
+        wxCoord column = xPx( i );
+
+        // The segment leaving the view
+        if( column > endPx )
+        {
+            points.emplace_back( column, yPx( m_ys[i] ) );
+            break;
+        }
+
+        size_t next = firstAt( column + 1, i + 1 );
+
+        points.emplace_back( column, yPx( m_ys[i] ) );
+
+        if( next - i > 1 )
+        {
+            double ymin, ymax;
+
+            GetRangeMinMax( i, next, ymin, ymax );
+            points.emplace_back( column, yPx( ymin ) );
+            points.emplace_back( column, yPx( ymax ) );
+            points.emplace_back( column, yPx( m_ys[next - 1] ) );
+        }
+
+        i = next;
+    }
+
+    return true;
 }
 
 
@@ -3384,6 +3565,7 @@ void mpFXYVector::SetData( const std::vector<double>& xs, const std::vector<doub
     // Copy the data:
     m_xs    = xs;
     m_ys    = ys;
+    m_lodValid = false;
 
     // printf("FXYVector::setData %d %d\n", xs.size(), ys.size());
 
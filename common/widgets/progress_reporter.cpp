@@ -26,26 +26,37 @@
 #include <wx/evtloop.h>
 #include <thread>
 
+
+constexpr std::chrono::milliseconds PROGRESS_REPORTER::REFRESH_INTERVAL;
+
+
+// The shard of the progress counters used by the current thread
+static std::atomic_int  s_nextShard( 0 );
+static thread_local int t_shard = -1;
+
+
 PROGRESS_REPORTER::PROGRESS_REPORTER( int aNumPhases ) :
+    m_messageChanged( false ),
     m_phase( 0 ),
     m_numPhases( aNumPhases ),
-    m_progress( 0 ),
-    m_maxProgress( 1 )
+    m_maxProgress( 1 ),
+    m_cancelled( false )
 {
+    clearProgress();
 }
 
 
 void PROGRESS_REPORTER::BeginPhase( int aPhase )
 {
     m_phase.store( aPhase );
-    m_progress.store( 0 );
+    clearProgress();
 }
 
 
 void PROGRESS_REPORTER::AdvancePhase( )
 {
     m_phase.fetch_add( 1 );
-    m_progress.store( 0 );
+    clearProgress();
 }
 
 
@@ -53,6 +64,19 @@ void PROGRESS_REPORTER::Report( const wxString& aMessage )
 {
     std::lock_guard<std::mutex> guard( m_mutex );
     m_rptMessage = aMessage;
+    m_messageChanged = true;
+}
+
+
+bool PROGRESS_REPORTER::takeMessage( wxString& aMessage )
+{
+    // Most refreshes have no new message: don't take the lock for them
+    if( !m_messageChanged.exchange( false ) )
+        return false;
+
+    std::lock_guard<std::mutex> guard( m_mutex );
+    aMessage = m_rptMessage;
+    return true;
 }
 
 
@@ -62,16 +86,37 @@ void PROGRESS_REPORTER::SetMaxProgress( int aMaxProgress )
 }
 
 
-void PROGRESS_REPORTER::AdvanceProgress()
+void PROGRESS_REPORTER::AdvanceProgress( int aCount )
 {
-    m_progress.fetch_add( 1 );
+    if( t_shard < 0 )
+        t_shard = s_nextShard.fetch_add( 1 ) % SHARD_COUNT;
+
+    m_shards[t_shard].m_Count.fetch_add( aCount, std::memory_order_relaxed );
+}
+
+
+int PROGRESS_REPORTER::progress() const
+{
+    int sum = 0;
+
+    for( const SHARD& shard : m_shards )
+        sum += shard.m_Count.load( std::memory_order_relaxed );
+
+    return sum;
+}
+
+
+void PROGRESS_REPORTER::clearProgress()
+{
+    for( SHARD& shard : m_shards )
+        shard.m_Count.store( 0, std::memory_order_relaxed );
 }
 
 
 int PROGRESS_REPORTER::currentProgress() const
 {
     double current = ( 1.0 / (double) m_numPhases ) *
-                     ( (double) m_phase + ( (double) m_progress.load() / (double) m_maxProgress ) );
+                     ( (double) m_phase + ( (double) progress() / (double) m_maxProgress ) );
 
     return (int)( current * 1000 );
 }
@@ -81,19 +126,32 @@ bool PROGRESS_REPORTER::KeepRefreshing( bool aWait )
 {
     if( aWait )
     {
-        while( m_progress < m_maxProgress && m_maxProgress > 0 )
+        while( progress() < m_maxProgress && m_maxProgress > 0 )
         {
             if( !updateUI() )
+            {
+                m_cancelled = true;
                 return false;
+            }
 
             wxMilliSleep( 20 );
         }
         return true;
     }
-    else
-    {
-        return updateUI();
-    }
+
+    // The UI events are the costly part: handle them at a fixed rate, but show a new
+    // message at once (it is often followed by a long step without refresh)
+    auto now = std::chrono::steady_clock::now();
+
+    if( now - m_lastRefresh < REFRESH_INTERVAL && !m_messageChanged )
+        return !m_cancelled;
+
+    m_lastRefresh = now;
+
+    if( !updateUI() )
+        m_cancelled = true;
+
+    return !m_cancelled;
 }
 
 
@@ -124,11 +182,9 @@ bool WX_PROGRESS_REPORTER::updateUI()
     if( cur < 0 || cur > 1000 )
         cur = 0;
 
+    // An empty message keeps the displayed one
     wxString message;
-    {
-        std::lock_guard<std::mutex> guard( m_mutex );
-        message = m_rptMessage;
-    }
+    takeMessage( message );
 
     SetRange( 1000 );
     return wxProgressDialog::Update( cur, message );
@@ -694,6 +694,9 @@ bool CVPCB_MAINFRAME::LoadFootprintFiles()
 
     m_FootprintsList->ReadFootprintFiles( fptbl, nullptr, &progressReporter );
 
+    if( m_footprintListBox )
+        m_footprintListBox->ClearFilterCache();
+
     if( m_FootprintsList->GetErrorCount() )
     {
         m_FootprintsList->DisplayErrors( this );
@@ -33,7 +33,8 @@
 #include <tools/cvpcb_actions.h>
 
 FOOTPRINTS_LISTBOX::FOOTPRINTS_LISTBOX( CVPCB_MAINFRAME* parent, wxWindowID id ) :
-    ITEMS_LISTBOX_BASE( parent, id, wxDefaultPosition, wxDefaultSize, wxLC_SINGLE_SEL|wxNO_BORDER )
+    ITEMS_LISTBOX_BASE( parent, id, wxDefaultPosition, wxDefaultSize, wxLC_SINGLE_SEL|wxNO_BORDER ),
+    m_filteredList( nullptr )
 {
 }
 
@@ -138,30 +139,69 @@ void FOOTPRINTS_LISTBOX::SetFootprints( FOOTPRINT_LIST& aList, const wxString& a
     wxString        msg;
     wxString        oldSelection;
 
-    FOOTPRINT_FILTER filter( aList );
+    if( m_filteredList != &aList )
+    {
+        m_filteredList = &aList;
+        ClearFilterCache();
+    }
+
+    // The criteria the list depends on: the components with the same footprint filters and
+    // pin count share their lists
+    wxString key = wxString::Format( "%d\n%s\n", aFilterType, aLibName );
+
+    m_filter.ClearFilters();
 
     if( aFilterType & FILTERING_BY_COMPONENT_FP_FILTERS && aComponent )
-        filter.FilterByFootprintFilters( aComponent->GetFootprintFilters() );
+    {
+        m_filter.FilterByFootprintFilters( aComponent->GetFootprintFilters() );
+        key << wxJoin( aComponent->GetFootprintFilters(), ' ' );
+    }
+
+    key << "\n";
 
     if( aFilterType & FILTERING_BY_PIN_COUNT && aComponent )
-        filter.FilterByPinCount( aComponent->GetPinCount() );
+    {
+        m_filter.FilterByPinCount( aComponent->GetPinCount() );
+        key << aComponent->GetPinCount();
+    }
+
+    key << "\n";
 
     if( aFilterType & FILTERING_BY_LIBRARY )
-        filter.FilterByLibrary( aLibName );
+        m_filter.FilterByLibrary( aLibName );
 
     if( aFilterType & FILTERING_BY_TEXT_PATTERN )
-        filter.FilterByTextPattern( aFootPrintFilterPattern );
+    {
+        m_filter.FilterByTextPattern( aFootPrintFilterPattern );
+        key << aFootPrintFilterPattern;
+    }
 
     if( GetSelection() >= 0 && GetSelection() < (int)m_footprintList.GetCount() )
         oldSelection = m_footprintList[ GetSelection() ];
 
-    for( auto& i: filter )
+    auto cached = m_filterCache.find( key );
+
+    if( cached != m_filterCache.end() )
+    {
+        newList = cached->second;
+    }
+    else
     {
-        msg.Printf( "%3d %s:%s",
-                    int( newList.GetCount() + 1 ),
-                    i.GetLibNickname(),
-                    i.GetFootprintName() );
-        newList.Add( msg );
+        for( auto& i: m_filter )
+        {
+            msg.Printf( "%3d %s:%s",
+                        int( newList.GetCount() + 1 ),
+                        i.GetLibNickname(),
+                        i.GetFootprintName() );
+            newList.Add( msg );
+        }
+
+        // A bound on the memory held by the cache: the text patterns make a new list for
+        // each key typed
+        if( m_filterCache.size() >= 64 )
+            m_filterCache.clear();
+
+        m_filterCache[key] = newList;
     }
 
     if( newList == m_footprintList )
@@ -187,6 +227,15 @@ void FOOTPRINTS_LISTBOX::SetFootprints( FOOTPRINT_LIST& aList, const wxString& a
 }
 
 
+void FOOTPRINTS_LISTBOX::ClearFilterCache()
+{
+    m_filterCache.clear();
+
+    if( m_filteredList )
+        m_filter.SetList( *m_filteredList );
+}
+
+
 BEGIN_EVENT_TABLE( FOOTPRINTS_LISTBOX, ITEMS_LISTBOX_BASE )
     EVT_CHAR( FOOTPRINTS_LISTBOX::OnChar )
     EVT_LIST_ITEM_SELECTED( ID_CVPCB_FOOTPRINT_LIST, FOOTPRINTS_LISTBOX::OnLeftClick )
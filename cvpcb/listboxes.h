@@ -24,6 +24,8 @@
 #ifndef LISTBOXES_H
 #define LISTBOXES_H
 
+#include <map>
+
 #include <wx/listctrl.h>
 #include <footprint_filter.h>
 
@@ -85,6 +87,13 @@ class FOOTPRINTS_LISTBOX : public ITEMS_LISTBOX_BASE
 private:
     wxArrayString  m_footprintList;
 
+    /// Kept to filter the same list again without indexing it again
+    FOOTPRINT_FILTER                m_filter;
+    FOOTPRINT_LIST*                 m_filteredList;
+
+    /// The lines of the filtered lists already built, by filter criteria
+    std::map<wxString, wxArrayString> m_filterCache;
+
 public:
 
     /**
@@ -124,6 +133,12 @@ public:
     void     SetFootprints( FOOTPRINT_LIST& aList, const wxString& aLibName, COMPONENT* aComponent,
                             const wxString &aFootPrintFilterPattern, int aFilterType );
 
+    /**
+     * Forget the filtered lists built by SetFootprints(): call it when the footprint list
+     * is read again.
+     */
+    void     ClearFilterCache();
+
     wxString GetSelectedFootprint();
 
     /**
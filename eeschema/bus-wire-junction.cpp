@@ -40,6 +40,7 @@
 #include <tool/tool_manager.h>
 #include <tools/ee_actions.h>
 #include <tools/ee_selection_tool.h>
+#include <trace_events.h>
 
 
 void SCH_EDIT_FRAME::GetSchematicConnections( std::vector< wxPoint >& aConnections )
@@ -62,23 +63,13 @@ void SCH_EDIT_FRAME::GetSchematicConnections( std::vector< wxPoint >& aConnectio
 
 bool SCH_EDIT_FRAME::TestDanglingEnds()
 {
-    std::vector<DANGLING_END_ITEM> endPoints;
-    bool hasStateChanged = false;
-
-    for( auto item : GetScreen()->Items() )
-        item->GetEndPoints( endPoints );
-
-    for( auto item : GetScreen()->Items() )
-    {
-        if( item->UpdateDanglingState( endPoints ) )
-        {
-            GetCanvas()->GetView()->Update( item, KIGFX::REPAINT );
-            hasStateChanged = true;
-        }
-        item->GetEndPoints( endPoints );
-    }
+    std::function<void( SCH_ITEM* )> changeHandler =
+            [&]( SCH_ITEM* aChangedItem )
+            {
+                GetCanvas()->GetView()->Update( aChangedItem, KIGFX::REPAINT );
+            };
 
-    return hasStateChanged;
+    return GetScreen()->TestDanglingEnds( nullptr, &changeHandler );
 }
 
 
@@ -138,6 +129,7 @@ bool SCH_EDIT_FRAME::TrimWire( const wxPoint& aStart, const wxPoint& aEnd )
 
 bool SCH_EDIT_FRAME::SchematicCleanUp( SCH_SCREEN* aScreen )
 {
+    TRACE_SCOPE trace( "schematic-cleanup" );
     PICKED_ITEMS_LIST            itemList;
     EE_SELECTION_TOOL*           selectionTool = m_toolManager->GetTool<EE_SELECTION_TOOL>();
     std::vector<SCH_ITEM*>       deletedItems;
@@ -32,8 +32,11 @@
 
 #include <wx/regex.h>
 #include <algorithm>
-#include <vector>
+#include <map>
+#include <set>
+#include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include <fctsys.h>
 #include <refdes_utils.h>
@@ -219,37 +222,19 @@ int SCH_REFERENCE_LIST::GetLastReference( int aIndex, int aMinValue )
 }
 
 
-int SCH_REFERENCE_LIST::CreateFirstFreeRefId( std::vector<int>& aIdList, int aFirstValue )
+int SCH_REFERENCE_LIST::CreateFirstFreeRefId( const std::multiset<int>& aIdsInUse,
+                                              int aFirstValue )
 {
     int expectedId = aFirstValue;
 
-    // We search for expected Id a value >= aFirstValue.
-    // Skip existing Id < aFirstValue
-    unsigned ii = 0;
-
-    for( ; ii < aIdList.size(); ii++ )
-    {
-        if( expectedId <= aIdList[ii] )
-            break;
-    }
-
-    // Ids are sorted by increasing value, from aFirstValue
-    // So we search from aFirstValue the first not used value, i.e. the first hole in list.
-    for( ; ii < aIdList.size(); ii++ )
+    // The first hole in the values in use, from aFirstValue
+    for( auto it = aIdsInUse.lower_bound( expectedId );
+         it != aIdsInUse.end() && *it == expectedId;
+         it = aIdsInUse.lower_bound( expectedId ) )
     {
-        if( expectedId != aIdList[ii] )    // This id is not yet used.
-        {
-            // Insert this free Id, in order to keep list sorted
-            aIdList.insert( aIdList.begin() + ii, expectedId );
-            return expectedId;
-        }
-
         expectedId++;
     }
 
-    // All existing Id are tested, and all values are found in use.
-    // So Create a new one.
-    aIdList.push_back( expectedId );
     return expectedId;
 }
 
@@ -278,6 +263,85 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId, int
     int LastReferenceNumber = 0;
     int NumberOfUnits, Unit;
 
+    /* The references are indexed before the annotation, so that searching for the numbers in
+     * use, the other units of a component or the locked units does not walk the whole list
+     * for each reference.
+     */
+
+    // The reference numbers in use, by reference prefix
+    std::unordered_map<std::string, std::multiset<int>> refsInUse;
+
+    // The numbered references, by reference prefix and number (the units of a package)
+    std::map<std::pair<std::string, int>, std::vector<unsigned>> numberedRefs;
+
+    // The references which are not annotated yet, by reference prefix and value
+    std::map<std::pair<std::string, wxString>, std::set<unsigned>> newRefs;
+
+    // The references of each component, one per sheet instance
+    std::unordered_map<SCH_COMPONENT*, std::vector<unsigned>> componentRefs;
+
+    for( unsigned ii = 0; ii < flatList.size(); ii++ )
+    {
+        SCH_REFERENCE& ref = flatList[ii];
+        std::string    prefix( ref.m_Ref );
+
+        refsInUse[prefix].insert( ref.m_NumRef );
+        numberedRefs[std::make_pair( prefix, ref.m_NumRef )].push_back( ii );
+        componentRefs[ref.GetComp()].push_back( ii );
+
+        if( ref.m_IsNew && !ref.m_Flag )
+            newRefs[std::make_pair( prefix, ref.m_Value->GetText() )].insert( ii );
+    }
+
+    // The locked units of each component, in the order of aLockedUnitMap
+    std::unordered_map<SCH_COMPONENT*,
+            std::vector<std::pair<SCH_REFERENCE*, SCH_REFERENCE_LIST*>>> lockedRefs;
+
+    for( SCH_MULTI_UNIT_REFERENCE_MAP::value_type& pair : aLockedUnitMap )
+    {
+        for( unsigned thisRefI = 0; thisRefI < pair.second.GetCount(); ++thisRefI )
+        {
+            SCH_REFERENCE& thisRef = pair.second[thisRefI];
+            lockedRefs[thisRef.GetComp()].push_back( std::make_pair( &thisRef, &pair.second ) );
+        }
+    }
+
+    // The numbers given up by the references of the current prefix are only reused for the
+    // next prefix (or sheet)
+    std::vector<std::pair<std::string, int>> freedNumbers;
+
+    auto setNumRef = [&]( SCH_REFERENCE& aRef, unsigned aIndex, int aNumRef )
+    {
+        std::string prefix( aRef.m_Ref );
+
+        freedNumbers.push_back( std::make_pair( prefix, aRef.m_NumRef ) );
+
+        aRef.m_NumRef = aNumRef;
+        refsInUse[prefix].insert( aNumRef );
+        numberedRefs[std::make_pair( prefix, aNumRef )].push_back( aIndex );
+    };
+
+    // Same as FindUnit(), from the index
+    auto findUnit = [&]( unsigned aIndex, int aUnit ) -> int
+    {
+        const SCH_REFERENCE& unitRef = flatList[aIndex];
+        std::string          prefix( unitRef.m_Ref );
+
+        for( unsigned ii : numberedRefs[std::make_pair( prefix, unitRef.m_NumRef )] )
+        {
+            const SCH_REFERENCE& ref = flatList[ii];
+
+            if( ii == aIndex || ref.m_IsNew || ref.m_NumRef != unitRef.m_NumRef
+                    || ref.CompareRef( unitRef ) != 0 )
+                continue;
+
+            if( ref.m_Unit == aUnit )
+                return (int) ii;
+        }
+
+        return -1;
+    };
+
     /* calculate index of the first component with the same reference prefix
      * than the current component.  All components having the same reference
      * prefix will receive a reference number with consecutive values:
@@ -306,10 +370,10 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId, int
     // inUseRefs keep trace of previously allocated references
     std::unordered_set<wxString> inUseRefs;
 
-    // This is the list of all Id already in use for a given reference prefix.
-    // Will be refilled for each new reference prefix.
-    std::vector<int>idList;
-    GetRefsInUse( first, idList, minRefId );
+    // This is the list of all Id already in use for the current reference prefix.
+    // All the ids from minRefId to nextFreeId - 1 are in use.
+    std::multiset<int>* idList = &refsInUse[std::string( flatList[first].m_Ref )];
+    int                 nextFreeId = minRefId;
 
     for( unsigned ii = 0; ii < flatList.size(); ii++ )
     {
@@ -320,21 +384,14 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId, int
 
         // Check whether this component is in aLockedUnitMap.
         SCH_REFERENCE_LIST* lockedList = NULL;
-        for( SCH_MULTI_UNIT_REFERENCE_MAP::value_type& pair : aLockedUnitMap )
-        {
-            unsigned n_refs = pair.second.GetCount();
 
-            for( unsigned thisRefI = 0; thisRefI < n_refs; ++thisRefI )
+        for( auto& locked : lockedRefs[ref_unit.GetComp()] )
+        {
+            if( locked.first->IsSameInstance( ref_unit ) )
             {
-                SCH_REFERENCE &thisRef = pair.second[thisRefI];
-
-                if( thisRef.IsSameInstance( ref_unit ) )
-                {
-                    lockedList = &pair.second;
-                    break;
-                }
+                lockedList = locked.second;
+                break;
             }
-            if( lockedList != NULL ) break;
         }
 
         if(  ( flatList[first].CompareRef( ref_unit ) != 0 )
@@ -349,7 +406,16 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId, int
             else
                 minRefId = aStartNumber + 1;
 
-            GetRefsInUse( first, idList, minRefId );
+            for( const std::pair<std::string, int>& freed : freedNumbers )
+            {
+                std::multiset<int>& ids = refsInUse[freed.first];
+                ids.erase( ids.find( freed.second ) );
+            }
+
+            freedNumbers.clear();
+
+            idList = &refsInUse[std::string( ref_unit.m_Ref )];
+            nextFreeId = minRefId;
         }
 
         // Annotation of one part per package components (trivial case).
@@ -357,8 +423,9 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId, int
         {
             if( ref_unit.m_IsNew )
             {
-                LastReferenceNumber = CreateFirstFreeRefId( idList, minRefId );
-                ref_unit.m_NumRef = LastReferenceNumber;
+                LastReferenceNumber = CreateFirstFreeRefId( *idList, nextFreeId );
+                nextFreeId = LastReferenceNumber + 1;
+                setNumRef( ref_unit, ii, LastReferenceNumber );
             }
 
             ref_unit.m_Unit  = 1;
@@ -372,8 +439,9 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId, int
 
         if( ref_unit.m_IsNew )
         {
-            LastReferenceNumber = CreateFirstFreeRefId( idList, minRefId );
-            ref_unit.m_NumRef = LastReferenceNumber;
+            LastReferenceNumber = CreateFirstFreeRefId( *idList, nextFreeId );
+            nextFreeId = LastReferenceNumber + 1;
+            setNumRef( ref_unit, ii, LastReferenceNumber );
 
             if( !ref_unit.IsUnitsLocked() )
                 ref_unit.m_Unit = 1;
@@ -406,9 +474,9 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId, int
                     continue;
 
                 // Find the matching component
-                for( unsigned jj = ii + 1; jj < flatList.size(); jj++ )
+                for( unsigned jj : componentRefs[thisRef.GetComp()] )
                 {
-                    if( ! thisRef.IsSameInstance( flatList[jj] ) )
+                    if( jj <= ii || !thisRef.IsSameInstance( flatList[jj] ) )
                         continue;
 
                     wxString ref_candidate = buildFullReference( ref_unit, thisRef.m_Unit );
@@ -418,7 +486,7 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId, int
                     // multiunits components have duplicate references)
                     if( inUseRefs.find( ref_candidate ) == inUseRefs.end() )
                     {
-                        flatList[jj].m_NumRef = ref_unit.m_NumRef;
+                        setNumRef( flatList[jj], jj, ref_unit.m_NumRef );
                         flatList[jj].m_Unit = thisRef.m_Unit;
                         flatList[jj].m_IsNew = false;
                         flatList[jj].m_Flag = 1;
@@ -435,23 +503,33 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId, int
             * we search for others parts that have the same value and the same
             * reference prefix (ref without ref number)
             */
+            std::string         prefix( ref_unit.m_Ref );
+            std::set<unsigned>& candidates =
+                    newRefs[std::make_pair( prefix, ref_unit.m_Value->GetText() )];
+
             for( Unit = 1; Unit <= NumberOfUnits; Unit++ )
             {
                 if( ref_unit.m_Unit == Unit )
                     continue;
 
-                int found = FindUnit( ii, Unit );
+                int found = findUnit( ii, Unit );
 
                 if( found >= 0 )
                     continue; // this unit exists for this reference (unit already annotated)
 
                 // Search a component to annotate ( same prefix, same value, not annotated)
-                for( unsigned jj = ii + 1; jj < flatList.size(); jj++ )
+                for( auto it = candidates.upper_bound( ii ); it != candidates.end(); )
                 {
-                    auto& cmp_unit = flatList[jj];
+                    unsigned jj = *it;
+                    auto&    cmp_unit = flatList[jj];
 
-                    if( cmp_unit.m_Flag )    // already tested
+                    if( cmp_unit.m_Flag || !cmp_unit.m_IsNew )    // already annotated
+                    {
+                        it = candidates.erase( it );
                         continue;
+                    }
+
+                    ++it;
 
                     if( cmp_unit.CompareRef( ref_unit ) != 0 )
                         continue;
@@ -466,14 +544,11 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId, int
                             cmp_unit.GetSheetPath().Cmp( ref_unit.GetSheetPath() ) != 0 )
                         continue;
 
-                    if( !cmp_unit.m_IsNew )
-                        continue;
-
                     // Component without reference number found, annotate it if possible
                     if( !cmp_unit.IsUnitsLocked()
                         || ( cmp_unit.m_Unit == Unit ) )
                     {
-                        cmp_unit.m_NumRef = ref_unit.m_NumRef;
+                        setNumRef( cmp_unit, jj, ref_unit.m_NumRef );
                         cmp_unit.m_Unit   = Unit;
                         cmp_unit.m_Flag   = 1;
                         cmp_unit.m_IsNew  = false;
@@ -19,12 +19,13 @@
  */
 
 #include <list>
-#include <thread>
 #include <algorithm>
-#include <future>
+#include <functional>
 #include <vector>
 #include <unordered_map>
 #include <profile.h>
+#include <thread_pool.h>
+#include <trace_events.h>
 
 #include <common.h>
 #include <erc.h>
@@ -380,28 +381,65 @@ void CONNECTION_GRAPH::Reset()
 
 void CONNECTION_GRAPH::Recalculate( const SCH_SHEET_LIST& aSheetList, bool aUnconditional )
 {
+    TRACE_SCOPE trace( "schematic-connectivity" );
     PROF_COUNTER recalc_time;
     PROF_COUNTER update_items;
 
-    if( aUnconditional )
-        Reset();
+    // The links between the items of a screen only change with them.  The screens shared by
+    // several sheets are found dirty before their first sheet clears the flags of the items.
+    std::unordered_set<SCH_SCREEN*>    dirty_screens;
+    std::unordered_set<SCH_SHEET_PATH> connected_sheets;
+
+    for( const SCH_SHEET_PATH& sheet : aSheetList )
+    {
+        SCH_SCREEN* screen = sheet.LastScreen();
+
+        if( aUnconditional || screen->IsConnectivityDirty() )
+        {
+            dirty_screens.insert( screen );
+            continue;
+        }
+
+        for( SCH_ITEM* item : screen->Items() )
+        {
+            if( item->IsConnectable() && item->IsConnectivityDirty() )
+            {
+                dirty_screens.insert( screen );
+                break;
+            }
+        }
+    }
+
+    Reset();
 
     for( const SCH_SHEET_PATH& sheet : aSheetList )
     {
         std::vector<SCH_ITEM*> items;
+        bool link_items = dirty_screens.count( sheet.LastScreen() )
+                          || !m_connected_sheets.count( sheet );
 
         for( auto item : sheet.LastScreen()->Items() )
         {
-            if( item->IsConnectable() && ( aUnconditional || item->IsConnectivityDirty() ) )
+            if( item->IsConnectable() )
                 items.push_back( item );
         }
 
-        updateItemConnectivity( sheet, items );
+        updateItemConnectivity( sheet, items, link_items );
 
         // UpdateDanglingState() also adds connected items for SCH_TEXT
-        sheet.LastScreen()->TestDanglingEnds( &sheet );
+        if( link_items )
+            sheet.LastScreen()->TestDanglingEnds( &sheet );
+
+        connected_sheets.insert( sheet );
     }
 
+    for( SCH_SCREEN* screen : dirty_screens )
+        screen->SetConnectivityDirty( false );
+
+    m_connected_sheets = std::move( connected_sheets );
+
+    wxLogTrace( "CONN_PROFILE", "%zu changed screens", dirty_screens.size() );
+
     update_items.Stop();
     wxLogTrace( "CONN_PROFILE", "UpdateItemConnectivity() %0.4f ms", update_items.msecs() );
 
@@ -429,15 +467,20 @@ void CONNECTION_GRAPH::Recalculate( const SCH_SHEET_LIST& aSheetList, bool aUnco
 
 
 void CONNECTION_GRAPH::updateItemConnectivity( SCH_SHEET_PATH aSheet,
-                                               const std::vector<SCH_ITEM*>& aItemList )
+                                               const std::vector<SCH_ITEM*>& aItemList,
+                                               bool aLinkItems )
 {
     std::unordered_map< wxPoint, std::vector<SCH_ITEM*> > connection_map;
 
     for( SCH_ITEM* item : aItemList )
     {
         std::vector< wxPoint > points;
-        item->GetConnectionPoints( points );
-        item->ConnectedItems( aSheet ).clear();
+
+        if( aLinkItems )
+        {
+            item->GetConnectionPoints( points );
+            item->ConnectedItems( aSheet ).clear();
+        }
 
         if( item->Type() == SCH_SHEET_T )
         {
@@ -446,10 +489,14 @@ void CONNECTION_GRAPH::updateItemConnectivity( SCH_SHEET_PATH aSheet,
                 if( !pin->Connection( aSheet ) )
                     pin->InitializeConnection( aSheet )->SetGraph( this );
 
-                pin->ConnectedItems( aSheet ).clear();
                 pin->Connection( aSheet )->Reset();
 
-                connection_map[ pin->GetTextPos() ].push_back( pin );
+                if( aLinkItems )
+                {
+                    pin->ConnectedItems( aSheet ).clear();
+                    connection_map[ pin->GetTextPos() ].push_back( pin );
+                }
+
                 m_items.insert( pin );
             }
         }
@@ -472,14 +519,18 @@ void CONNECTION_GRAPH::updateItemConnectivity( SCH_SHEET_PATH aSheet,
 
                 // because calling the first time is not thread-safe
                 pin->GetDefaultNetName( aSheet );
-                pin->ConnectedItems( aSheet ).clear();
 
                 // Invisible power pins need to be post-processed later
 
                 if( pin->IsPowerConnection() && !pin->IsVisible() )
                     m_invisible_power_pins.emplace_back( std::make_pair( aSheet, pin ) );
 
-                connection_map[ pos ].push_back( pin );
+                if( aLinkItems )
+                {
+                    pin->ConnectedItems( aSheet ).clear();
+                    connection_map[ pos ].push_back( pin );
+                }
+
                 m_items.insert( pin );
             }
         }
@@ -499,9 +550,14 @@ void CONNECTION_GRAPH::updateItemConnectivity( SCH_SHEET_PATH aSheet,
 
             case SCH_BUS_BUS_ENTRY_T:
                 conn->SetType( CONNECTION_TYPE::BUS );
+
                 // clean previous (old) links:
-                static_cast<SCH_BUS_BUS_ENTRY*>( item )->m_connected_bus_items[0] = nullptr;
-                static_cast<SCH_BUS_BUS_ENTRY*>( item )->m_connected_bus_items[1] = nullptr;
+                if( aLinkItems )
+                {
+                    static_cast<SCH_BUS_BUS_ENTRY*>( item )->m_connected_bus_items[0] = nullptr;
+                    static_cast<SCH_BUS_BUS_ENTRY*>( item )->m_connected_bus_items[1] = nullptr;
+                }
+
                 break;
 
             case SCH_PIN_T:
@@ -510,8 +566,11 @@ void CONNECTION_GRAPH::updateItemConnectivity( SCH_SHEET_PATH aSheet,
 
             case SCH_BUS_WIRE_ENTRY_T:
                 conn->SetType( CONNECTION_TYPE::NET );
+
                 // clean previous (old) link:
-                static_cast<SCH_BUS_WIRE_ENTRY*>( item )->m_connected_bus_item = nullptr;
+                if( aLinkItems )
+                    static_cast<SCH_BUS_WIRE_ENTRY*>( item )->m_connected_bus_item = nullptr;
+
                 break;
 
             default:
@@ -749,12 +808,6 @@ void CONNECTION_GRAPH::buildConnectionGraph()
 
     // Resolve drivers for subgraphs and propagate connectivity info
 
-    // We don't want to spin up a new thread for fewer than 8 nets (overhead costs)
-    size_t parallelThreadCount = std::min<size_t>( std::thread::hardware_concurrency(),
-            ( m_subgraphs.size() + 3 ) / 4 );
-
-    std::atomic<size_t> nextSubgraph( 0 );
-    std::vector<std::future<size_t>> returns( parallelThreadCount );
     std::vector<CONNECTION_SUBGRAPH*> dirty_graphs;
 
     std::copy_if( m_subgraphs.begin(), m_subgraphs.end(), std::back_inserter( dirty_graphs ),
@@ -763,106 +816,91 @@ void CONNECTION_GRAPH::buildConnectionGraph()
                       return candidate->m_dirty;
                   } );
 
-    auto update_lambda = [&nextSubgraph, &dirty_graphs]() -> size_t
+    auto update_lambda = [&dirty_graphs]( size_t subgraphId )
     {
-        for( size_t subgraphId = nextSubgraph++; subgraphId < dirty_graphs.size(); subgraphId = nextSubgraph++ )
-        {
-            auto subgraph = dirty_graphs[subgraphId];
+        auto subgraph = dirty_graphs[subgraphId];
 
-            if( !subgraph->m_dirty )
-                continue;
+        if( !subgraph->m_dirty )
+            return;
 
-            // Special processing for some items
-            for( auto item : subgraph->m_items )
+        // Special processing for some items
+        for( auto item : subgraph->m_items )
+        {
+            switch( item->Type() )
             {
-                switch( item->Type() )
-                {
-                case SCH_NO_CONNECT_T:
-                    subgraph->m_no_connect = item;
-                    break;
+            case SCH_NO_CONNECT_T:
+                subgraph->m_no_connect = item;
+                break;
 
-                case SCH_BUS_WIRE_ENTRY_T:
-                    subgraph->m_bus_entry = item;
-                    break;
+            case SCH_BUS_WIRE_ENTRY_T:
+                subgraph->m_bus_entry = item;
+                break;
 
-                case SCH_PIN_T:
-                {
-                    auto pin = static_cast<SCH_PIN*>( item );
+            case SCH_PIN_T:
+            {
+                auto pin = static_cast<SCH_PIN*>( item );
 
-                    if( pin->GetType() == ELECTRICAL_PINTYPE::PT_NC )
-                        subgraph->m_no_connect = item;
+                if( pin->GetType() == ELECTRICAL_PINTYPE::PT_NC )
+                    subgraph->m_no_connect = item;
 
-                    break;
-                }
+                break;
+            }
 
-                default:
-                    break;
-                }
+            default:
+                break;
             }
+        }
 
-            if( !subgraph->ResolveDrivers() )
+        if( !subgraph->ResolveDrivers() )
+        {
+            subgraph->m_dirty = false;
+        }
+        else
+        {
+            // Now the subgraph has only one driver
+            SCH_ITEM* driver = subgraph->m_driver;
+            SCH_SHEET_PATH sheet = subgraph->m_sheet;
+            SCH_CONNECTION* connection = driver->Connection( sheet );
+
+            // TODO(JE) This should live in SCH_CONNECTION probably
+            switch( driver->Type() )
             {
-                subgraph->m_dirty = false;
+            case SCH_LABEL_T:
+            case SCH_GLOBAL_LABEL_T:
+            case SCH_HIER_LABEL_T:
+            {
+                auto text = static_cast<SCH_TEXT*>( driver );
+                connection->ConfigureFromLabel( text->GetShownText() );
+                break;
             }
-            else
+            case SCH_SHEET_PIN_T:
             {
-                // Now the subgraph has only one driver
-                SCH_ITEM* driver = subgraph->m_driver;
-                SCH_SHEET_PATH sheet = subgraph->m_sheet;
-                SCH_CONNECTION* connection = driver->Connection( sheet );
-
-                // TODO(JE) This should live in SCH_CONNECTION probably
-                switch( driver->Type() )
-                {
-                case SCH_LABEL_T:
-                case SCH_GLOBAL_LABEL_T:
-                case SCH_HIER_LABEL_T:
-                {
-                    auto text = static_cast<SCH_TEXT*>( driver );
-                    connection->ConfigureFromLabel( text->GetShownText() );
-                    break;
-                }
-                case SCH_SHEET_PIN_T:
-                {
-                    auto pin = static_cast<SCH_SHEET_PIN*>( driver );
-                    connection->ConfigureFromLabel( pin->GetShownText() );
-                    break;
-                }
-                case SCH_PIN_T:
-                {
-                    auto pin = static_cast<SCH_PIN*>( driver );
-                    // NOTE(JE) GetDefaultNetName is not thread-safe.
-                    connection->ConfigureFromLabel( pin->GetDefaultNetName( sheet ) );
+                auto pin = static_cast<SCH_SHEET_PIN*>( driver );
+                connection->ConfigureFromLabel( pin->GetShownText() );
+                break;
+            }
+            case SCH_PIN_T:
+            {
+                auto pin = static_cast<SCH_PIN*>( driver );
+                // NOTE(JE) GetDefaultNetName is not thread-safe.
+                connection->ConfigureFromLabel( pin->GetDefaultNetName( sheet ) );
 
-                    break;
-                }
-                default:
-                    wxLogTrace( "CONN", "Driver type unsupported: %s",
-                            driver->GetSelectMenuText( EDA_UNITS::MILLIMETRES ) );
-                    break;
-                }
+                break;
+            }
+            default:
+                wxLogTrace( "CONN", "Driver type unsupported: %s",
+                        driver->GetSelectMenuText( EDA_UNITS::MILLIMETRES ) );
+                break;
+            }
 
-                connection->SetDriver( driver );
-                connection->ClearDirty();
+            connection->SetDriver( driver );
+            connection->ClearDirty();
 
-                subgraph->m_dirty = false;
-            }
+            subgraph->m_dirty = false;
         }
-
-        return 1;
     };
 
-    if( parallelThreadCount == 1 )
-        update_lambda();
-    else
-    {
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-            returns[ii] = std::async( std::launch::async, update_lambda );
-
-        // Finalize the threads
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-            returns[ii].wait();
-    }
+    THREAD_POOL::GetInstance().ParallelFor( dirty_graphs.size(), update_lambda );
 
     // Now discard any non-driven subgraphs from further consideration
 
@@ -2029,63 +2067,94 @@ CONNECTION_SUBGRAPH* CONNECTION_GRAPH::GetSubgraphForItem( SCH_ITEM* aItem )
 
 int CONNECTION_GRAPH::RunERC()
 {
-    int error_count = 0;
-
     wxCHECK_MSG( m_schematic, true, "Null m_schematic in CONNECTION_GRAPH::ercCheckLabels" );
 
     ERC_SETTINGS* settings = m_schematic->ErcSettings();
 
-    for( auto&& subgraph : m_subgraphs )
+    // The checks only read the graph, so the subgraphs are checked in parallel.  The markers
+    // are kept per subgraph and added to the screens afterwards, in the order of the serial
+    // checks (SCH_SCREEN::Append() is not thread-safe).
+    std::vector<std::vector<SCH_MARKER*>> markers( m_subgraphs.size() );
+    std::vector<int>                      errors( m_subgraphs.size(), 0 );
+
+    auto run_parallel = [&]( const std::function<void( size_t )>& aCheck )
     {
-        // Graph is supposed to be up-to-date before calling RunERC()
-        wxASSERT( !subgraph->m_dirty );
+        THREAD_POOL::GetInstance().ParallelFor( m_subgraphs.size(), aCheck );
+    };
 
-        /**
-         * NOTE:
-         *
-         * We could check that labels attached to bus subgraphs follow the
-         * proper format (i.e. actually define a bus).
-         *
-         * This check doesn't need to be here right now because labels
-         * won't actually be connected to bus wires if they aren't in the right
-         * format due to their TestDanglingEnds() implementation.
-         */
-
-        if( settings->IsTestEnabled( ERCE_DRIVER_CONFLICT ) && !subgraph->ResolveDrivers() )
-            error_count++;
-
-        if( settings->IsTestEnabled( ERCE_BUS_TO_NET_CONFLICT )
-                && !ercCheckBusToNetConflicts( subgraph ) )
-            error_count++;
-
-        if( settings->IsTestEnabled( ERCE_BUS_ENTRY_CONFLICT )
-                && !ercCheckBusToBusEntryConflicts( subgraph ) )
-            error_count++;
-
-        if( settings->IsTestEnabled( ERCE_BUS_TO_BUS_CONFLICT )
-                && !ercCheckBusToBusConflicts( subgraph ) )
-            error_count++;
-
-        // The following checks are always performed since they don't currently
-        // have an option exposed to the user
-
-        if( !ercCheckNoConnects( subgraph ) )
-            error_count++;
-
-        if( ( settings->IsTestEnabled( ERCE_LABEL_NOT_CONNECTED )
-                || settings->IsTestEnabled( ERCE_GLOBLABEL ) ) && !ercCheckLabels( subgraph ) )
-            error_count++;
+    // The label checks look at the drivers of the hierarchical parents, so all the drivers
+    // are resolved before any subgraph is checked.
+    if( settings->IsTestEnabled( ERCE_DRIVER_CONFLICT ) )
+    {
+        run_parallel( [&]( size_t aIdx )
+                      {
+                          if( !m_subgraphs[aIdx]->ResolveDrivers() )
+                              errors[aIdx]++;
+                      } );
+    }
+
+    run_parallel( [&]( size_t aIdx )
+                  {
+                      CONNECTION_SUBGRAPH*      subgraph = m_subgraphs[aIdx];
+                      std::vector<SCH_MARKER*>& subgraphMarkers = markers[aIdx];
+
+                      // Graph is supposed to be up-to-date before calling RunERC()
+                      wxASSERT( !subgraph->m_dirty );
+
+                      /**
+                       * NOTE:
+                       *
+                       * We could check that labels attached to bus subgraphs follow the
+                       * proper format (i.e. actually define a bus).
+                       *
+                       * This check doesn't need to be here right now because labels
+                       * won't actually be connected to bus wires if they aren't in the right
+                       * format due to their TestDanglingEnds() implementation.
+                       */
+
+                      if( settings->IsTestEnabled( ERCE_BUS_TO_NET_CONFLICT )
+                              && !ercCheckBusToNetConflicts( subgraph, subgraphMarkers ) )
+                          errors[aIdx]++;
+
+                      if( settings->IsTestEnabled( ERCE_BUS_ENTRY_CONFLICT )
+                              && !ercCheckBusToBusEntryConflicts( subgraph, subgraphMarkers ) )
+                          errors[aIdx]++;
+
+                      if( settings->IsTestEnabled( ERCE_BUS_TO_BUS_CONFLICT )
+                              && !ercCheckBusToBusConflicts( subgraph, subgraphMarkers ) )
+                          errors[aIdx]++;
+
+                      // The following checks are always performed since they don't currently
+                      // have an option exposed to the user
+
+                      if( !ercCheckNoConnects( subgraph, subgraphMarkers ) )
+                          errors[aIdx]++;
+
+                      if( ( settings->IsTestEnabled( ERCE_LABEL_NOT_CONNECTED )
+                              || settings->IsTestEnabled( ERCE_GLOBLABEL ) )
+                              && !ercCheckLabels( subgraph, subgraphMarkers ) )
+                          errors[aIdx]++;
+                  } );
+
+    int error_count = 0;
+
+    for( size_t ii = 0; ii < m_subgraphs.size(); ++ii )
+    {
+        SCH_SCREEN* screen = m_subgraphs[ii]->m_sheet.LastScreen();
+
+        for( SCH_MARKER* marker : markers[ii] )
+            screen->Append( marker );
+
+        error_count += errors[ii];
     }
 
     return error_count;
 }
 
 
-bool CONNECTION_GRAPH::ercCheckBusToNetConflicts( const CONNECTION_SUBGRAPH* aSubgraph )
+bool CONNECTION_GRAPH::ercCheckBusToNetConflicts( const CONNECTION_SUBGRAPH* aSubgraph,
+                                                  std::vector<SCH_MARKER*>& aMarkers )
 {
-    auto sheet = aSubgraph->m_sheet;
-    auto screen = sheet.LastScreen();
-
     SCH_ITEM* net_item = nullptr;
     SCH_ITEM* bus_item = nullptr;
     SCH_CONNECTION conn( this );
@@ -2128,7 +2197,7 @@ bool CONNECTION_GRAPH::ercCheckBusToNetConflicts( const CONNECTION_SUBGRAPH* aSu
         ercItem->SetItems( net_item, bus_item );
 
         SCH_MARKER* marker = new SCH_MARKER( ercItem, net_item->GetPosition() );
-        screen->Append( marker );
+        aMarkers.push_back( marker );
 
         return false;
     }
@@ -2137,11 +2206,11 @@ bool CONNECTION_GRAPH::ercCheckBusToNetConflicts( const CONNECTION_SUBGRAPH* aSu
 }
 
 
-bool CONNECTION_GRAPH::ercCheckBusToBusConflicts( const CONNECTION_SUBGRAPH* aSubgraph )
+bool CONNECTION_GRAPH::ercCheckBusToBusConflicts( const CONNECTION_SUBGRAPH* aSubgraph,
+                                                  std::vector<SCH_MARKER*>& aMarkers )
 {
     wxString msg;
     auto sheet = aSubgraph->m_sheet;
-    auto screen = sheet.LastScreen();
 
     SCH_ITEM* label = nullptr;
     SCH_ITEM* port = nullptr;
@@ -2196,7 +2265,7 @@ bool CONNECTION_GRAPH::ercCheckBusToBusConflicts( const CONNECTION_SUBGRAPH* aSu
             ercItem->SetItems( label, port );
 
             SCH_MARKER* marker = new SCH_MARKER( ercItem, label->GetPosition() );
-            screen->Append( marker );
+            aMarkers.push_back( marker );
 
             return false;
         }
@@ -2206,11 +2275,11 @@ bool CONNECTION_GRAPH::ercCheckBusToBusConflicts( const CONNECTION_SUBGRAPH* aSu
 }
 
 
-bool CONNECTION_GRAPH::ercCheckBusToBusEntryConflicts( const CONNECTION_SUBGRAPH* aSubgraph )
+bool CONNECTION_GRAPH::ercCheckBusToBusEntryConflicts( const CONNECTION_SUBGRAPH* aSubgraph,
+                                                       std::vector<SCH_MARKER*>& aMarkers )
 {
     bool conflict = false;
     auto sheet = aSubgraph->m_sheet;
-    auto screen = sheet.LastScreen();
 
     SCH_BUS_WIRE_ENTRY* bus_entry = nullptr;
     SCH_ITEM* bus_wire = nullptr;
@@ -2276,7 +2345,7 @@ bool CONNECTION_GRAPH::ercCheckBusToBusEntryConflicts( const CONNECTION_SUBGRAPH
         ercItem->SetItems( bus_entry, bus_wire );
 
         SCH_MARKER* marker = new SCH_MARKER( ercItem, bus_entry->GetPosition() );
-        screen->Append( marker );
+        aMarkers.push_back( marker );
 
         return false;
     }
@@ -2286,11 +2355,11 @@ bool CONNECTION_GRAPH::ercCheckBusToBusEntryConflicts( const CONNECTION_SUBGRAPH
 
 
 // TODO(JE) Check sheet pins here too?
-bool CONNECTION_GRAPH::ercCheckNoConnects( const CONNECTION_SUBGRAPH* aSubgraph )
+bool CONNECTION_GRAPH::ercCheckNoConnects( const CONNECTION_SUBGRAPH* aSubgraph,
+                                           std::vector<SCH_MARKER*>& aMarkers )
 {
     wxString msg;
     auto sheet = aSubgraph->m_sheet;
-    auto screen = sheet.LastScreen();
 
     if( aSubgraph->m_no_connect != nullptr )
     {
@@ -2329,7 +2398,7 @@ bool CONNECTION_GRAPH::ercCheckNoConnects( const CONNECTION_SUBGRAPH* aSubgraph
             ercItem->SetItems( pin );
 
             SCH_MARKER* marker = new SCH_MARKER( ercItem, pin->GetTransformedPosition() );
-            screen->Append( marker );
+            aMarkers.push_back( marker );
 
             return false;
         }
@@ -2340,7 +2409,7 @@ bool CONNECTION_GRAPH::ercCheckNoConnects( const CONNECTION_SUBGRAPH* aSubgraph
             ercItem->SetItems( aSubgraph->m_no_connect );
 
             SCH_MARKER* marker = new SCH_MARKER( ercItem, aSubgraph->m_no_connect->GetPosition() );
-            screen->Append( marker );
+            aMarkers.push_back( marker );
 
             return false;
         }
@@ -2395,7 +2464,7 @@ bool CONNECTION_GRAPH::ercCheckNoConnects( const CONNECTION_SUBGRAPH* aSubgraph
             ercItem->SetItems( pin );
 
             SCH_MARKER* marker = new SCH_MARKER( ercItem, pin->GetTransformedPosition() );
-            screen->Append( marker );
+            aMarkers.push_back( marker );
 
             return false;
         }
@@ -2405,7 +2474,8 @@ bool CONNECTION_GRAPH::ercCheckNoConnects( const CONNECTION_SUBGRAPH* aSubgraph
 }
 
 
-bool CONNECTION_GRAPH::ercCheckLabels( const CONNECTION_SUBGRAPH* aSubgraph )
+bool CONNECTION_GRAPH::ercCheckLabels( const CONNECTION_SUBGRAPH* aSubgraph,
+                                       std::vector<SCH_MARKER*>& aMarkers )
 {
     // Label connection rules:
     // Local labels are flagged if they don't connect to any pins and don't have a no-connect
@@ -2489,7 +2559,7 @@ bool CONNECTION_GRAPH::ercCheckLabels( const CONNECTION_SUBGRAPH* aSubgraph )
         ercItem->SetItems( text );
 
         SCH_MARKER* marker = new SCH_MARKER( ercItem, text->GetPosition() );
-        aSubgraph->m_sheet.LastScreen()->Append( marker );
+        aMarkers.push_back( marker );
 
         return false;
     }
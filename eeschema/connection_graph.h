@@ -22,6 +22,7 @@
 #define _CONNECTION_GRAPH_H
 
 #include <mutex>
+#include <unordered_set>
 #include <vector>
 
 #include <common.h>
@@ -40,6 +41,7 @@ class CONNECTION_GRAPH;
 class SCHEMATIC;
 class SCH_EDIT_FRAME;
 class SCH_HIERLABEL;
+class SCH_MARKER;
 class SCH_PIN;
 class SCH_SHEET_PIN;
 
@@ -242,6 +244,10 @@ public:
     /**
      * Updates the connection graph for the given list of sheets.
      *
+     * The graphical connectivity of the items is only updated on the screens which changed
+     * since the previous recalculation (or on all of them if \a aUnconditional is set); the
+     * graph itself is built again from all the items.
+     *
      * @param aSheetList is the list of possibly modified sheets
      * @param aUnconditional is true if an unconditional full recalculation should be done
      */
@@ -269,6 +275,9 @@ public:
      *
      * Precondition: graph is up-to-date
      *
+     * The subgraphs are checked in parallel; the markers are added to the screens once all
+     * the subgraphs are checked.
+     *
      * @return the number of errors found
      */
     int RunERC();
@@ -339,6 +348,10 @@ private:
 
     SCHEMATIC* m_schematic;     ///< The schematic this graph represents
 
+    /// The sheets whose item connectivity was updated, to find the new ones (the paths of a
+    /// new sheet instance can refer to an unchanged screen)
+    std::unordered_set<SCH_SHEET_PATH> m_connected_sheets;
+
     /**
      * Updates the graphical connectivity between items (i.e. where they touch)
      * The items passed in must be on the same sheet.
@@ -363,11 +376,16 @@ private:
      *
      * As a side effect, items are loaded into m_items for BuildConnectionGraph()
      *
+     * When the items did not change since their last update, only the first phase is
+     * needed: their connections are reset for the graph, and they keep their links.
+     *
      * @param aSheet is the path to the sheet of all items in the list
      * @param aItemList is a list of items to consider
+     * @param aLinkItems is false to keep the links of the items, which must be unchanged
      */
     void updateItemConnectivity( SCH_SHEET_PATH aSheet,
-                                 const std::vector<SCH_ITEM*>& aItemList );
+                                 const std::vector<SCH_ITEM*>& aItemList,
+                                 bool aLinkItems = true );
 
     /**
      * Generates the connection graph (after all item connectivity has been updated)
@@ -435,9 +453,11 @@ private:
      * For example, a net wire connected to a bus port/pin, or vice versa
      *
      * @param  aSubgraph      is the subgraph to examine
+     * @param  aMarkers       receives the marker of the error found, if any
      * @return                true for no errors, false for errors
      */
-    bool ercCheckBusToNetConflicts( const CONNECTION_SUBGRAPH* aSubgraph );
+    bool ercCheckBusToNetConflicts( const CONNECTION_SUBGRAPH* aSubgraph,
+                                    std::vector<SCH_MARKER*>& aMarkers );
 
     /**
      * Checks one subgraph for conflicting connections between two bus items
@@ -447,9 +467,11 @@ private:
      * sheet pin
      *
      * @param  aSubgraph      is the subgraph to examine
+     * @param  aMarkers       receives the marker of the error found, if any
      * @return                true for no errors, false for errors
      */
-    bool ercCheckBusToBusConflicts( const CONNECTION_SUBGRAPH* aSubgraph );
+    bool ercCheckBusToBusConflicts( const CONNECTION_SUBGRAPH* aSubgraph,
+                                    std::vector<SCH_MARKER*>& aMarkers );
 
     /**
      * Checks one subgraph for conflicting bus entry to bus connections
@@ -461,9 +483,11 @@ private:
      * "USB.DP" but someone might accidentally just enter "DP"
      *
      * @param  aSubgraph      is the subgraph to examine
+     * @param  aMarkers       receives the marker of the error found, if any
      * @return                true for no errors, false for errors
      */
-    bool ercCheckBusToBusEntryConflicts( const CONNECTION_SUBGRAPH* aSubgraph );
+    bool ercCheckBusToBusEntryConflicts( const CONNECTION_SUBGRAPH* aSubgraph,
+                                         std::vector<SCH_MARKER*>& aMarkers );
 
     /**
      * Checks one subgraph for proper presence or absence of no-connect symbols
@@ -472,9 +496,11 @@ private:
      * A pin without a no-connect symbol should have at least one connection
      *
      * @param  aSubgraph      is the subgraph to examine
+     * @param  aMarkers       receives the marker of the error found, if any
      * @return                true for no errors, false for errors
      */
-    bool ercCheckNoConnects( const CONNECTION_SUBGRAPH* aSubgraph );
+    bool ercCheckNoConnects( const CONNECTION_SUBGRAPH* aSubgraph,
+                             std::vector<SCH_MARKER*>& aMarkers );
 
     /**
      * Checks one subgraph for proper connection of labels
@@ -482,10 +508,12 @@ private:
      * Labels should be connected to something
      *
      * @param  aSubgraph      is the subgraph to examine
+     * @param  aMarkers       receives the marker of the error found, if any
      * @param  aCheckGlobalLabels is true if global labels should be checked for loneliness
      * @return                true for no errors, false for errors
      */
-    bool ercCheckLabels( const CONNECTION_SUBGRAPH* aSubgraph );
+    bool ercCheckLabels( const CONNECTION_SUBGRAPH* aSubgraph,
+                         std::vector<SCH_MARKER*>& aMarkers );
 
 };
 
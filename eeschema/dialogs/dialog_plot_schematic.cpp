@@ -33,6 +33,9 @@
 #include <ws_painter.h>
 #include <sch_painter.h>
 #include <schematic.h>
+#include <thread_pool.h>
+
+#include <set>
 
 // static members (static to remember last state):
 int DIALOG_PLOT_SCHEMATIC::m_pageSizeSelect = PAGE_SIZE_AUTO;
@@ -337,6 +340,60 @@ void DIALOG_PLOT_SCHEMATIC::PlotSchematic( bool aPlotAll )
 }
 
 
+void DIALOG_PLOT_SCHEMATIC::plotSheets(
+        const SCH_SHEET_LIST& aSheetList,
+        const std::function<PLOTTER*( size_t aIndex, SCH_SCREEN* aScreen )>& aStartSheet,
+        const std::function<void( size_t aIndex, PLOTTER* aPlotter )>& aEndSheet )
+{
+    // The locale is global to the process: this also keeps it for the plot threads
+    LOCALE_IO toggle;
+
+    THREAD_POOL& pool = THREAD_POOL::GetInstance();
+
+    // Each plot of a batch holds its output file open
+    const size_t maxBatchSize = 2 * pool.GetThreadCount();
+    size_t       first = 0;
+
+    while( first < aSheetList.size() )
+    {
+        std::set<SCH_SCREEN*>    batchScreens;
+        std::vector<SCH_SCREEN*> screens;
+        std::vector<PLOTTER*>    plotters;
+        size_t                   last = first;
+
+        for( ; last < aSheetList.size() && screens.size() < maxBatchSize; ++last )
+        {
+            SCH_SCREEN* screen = aSheetList[last].LastScreen();
+
+            if( !batchScreens.insert( screen ).second )
+                break;
+
+            m_parent->SetCurrentSheet( aSheetList[last] );
+            m_parent->GetCurrentSheet().UpdateAllScreenReferences();
+            m_parent->SetSheetNumberAndCount();
+
+            screens.push_back( screen );
+            plotters.push_back( aStartSheet( last, screen ) );
+        }
+
+        pool.ParallelFor( screens.size(),
+                [&]( size_t aIndex )
+                {
+                    if( plotters[aIndex] )
+                        screens[aIndex]->Plot( plotters[aIndex] );
+                } );
+
+        for( size_t ii = 0; ii < plotters.size(); ++ii )
+        {
+            if( plotters[ii] )
+                aEndSheet( first + ii, plotters[ii] );
+        }
+
+        first = last;
+    }
+}
+
+
 wxFileName DIALOG_PLOT_SCHEMATIC::createPlotFileName( wxString& aPlotFileName,
                                                       wxString& aExtension,
                                                       REPORTER* aReporter )
@@ -35,6 +35,8 @@
 #include <reporter.h>
 #include <widgets/unit_binder.h>
 
+#include <functional>
+
 enum PageFormatReq {
     PAGE_SIZE_AUTO,
     PAGE_SIZE_A4,
@@ -93,14 +95,39 @@ private:
 
     void PlotSchematic( bool aPlotAll );
 
+    /**
+     * Plot the sheets of a list, each one with its own plotter.
+     *
+     * The sheets are plotted in batches of sheets with different screens (the symbol
+     * references of a screen shared by several sheets are the ones of the sheet made current
+     * last).  For each sheet of a batch, made current, aStartSheet is called to create and
+     * start its plotter, and plot its frame reference (the page layout items are shared).
+     * The screens of the batch are then plotted concurrently, and aEndSheet is called for
+     * each of them to end its plot, in the order of the list.  The current sheet is not
+     * restored.
+     *
+     * @param aStartSheet returns the plotter of the sheet of the given index, or nullptr if
+     *                    it cannot be plotted
+     * @param aEndSheet is called with each plotter returned by aStartSheet, to end its plot
+     *                  and delete it
+     */
+    void plotSheets( const SCH_SHEET_LIST& aSheetList,
+                     const std::function<PLOTTER*( size_t aIndex, SCH_SCREEN* aScreen )>& aStartSheet,
+                     const std::function<void( size_t aIndex, PLOTTER* aPlotter )>& aEndSheet );
+
     // PDF
     void    createPDFFile( bool aPlotAll, bool aPlotFrameRef, RENDER_SETTINGS* aRenderSettings );
-    void    plotOneSheetPDF( PLOTTER* aPlotter, SCH_SCREEN* aScreen, bool aPlotFrameRef);
+
+    /**
+     * Plot the background and the frame reference of a page (the screen itself is plotted
+     * by plotSheets())
+     */
+    void    plotPageFramePDF( PLOTTER* aPlotter, SCH_SCREEN* aScreen, bool aPlotFrameRef );
     void    setupPlotPagePDF( PLOTTER* aPlotter, SCH_SCREEN* aScreen );
 
     /**
     * Everything done, close the plot and restore the environment
-    * @param aPlotter the plotter to close and destroy
+    * @param aPlotter the plotter to close and destroy (nullptr if its file was not created)
     * @param aOldsheetpath the stored old sheet path for the current sheet before the plot started
     */
     void    restoreEnvironment( PDF_PLOTTER* aPlotter, SCH_SHEET_PATH& aOldsheetpath );
@@ -130,15 +157,25 @@ private:
 
     // PS
     void    createPSFile( bool aPlotAll, bool aPlotFrameRef, RENDER_SETTINGS* aSettings );
-    bool    plotOneSheetPS( const wxString& aFileName, SCH_SCREEN* aScreen,
-                            RENDER_SETTINGS* aRenderSettings, const PAGE_INFO& aPageInfo,
-                            wxPoint aPlot0ffset, double aScale, bool aPlotFrameRef );
+
+    /**
+     * Open the file of a sheet and start its plot, with its frame reference
+     * @return the plotter, or nullptr if the file cannot be created
+     */
+    PLOTTER* startPlotSheetPS( const wxString& aFileName, SCH_SCREEN* aScreen,
+                               RENDER_SETTINGS* aRenderSettings, const PAGE_INFO& aPageInfo,
+                               wxPoint aPlot0ffset, double aScale, bool aPlotFrameRef );
 
     // SVG
     void    createSVGFile( bool aPlotAll, bool aPlotFrameRef, RENDER_SETTINGS* aSettings );
-    bool    plotOneSheetSVG( const wxString& aFileName, SCH_SCREEN* aScreen,
-                             RENDER_SETTINGS* aRenderSettings, bool aPlotBlackAndWhite,
-                             bool aPlotFrameRef );
+
+    /**
+     * Open the file of a sheet and start its plot, with its frame reference
+     * @return the plotter, or nullptr if the file cannot be created
+     */
+    PLOTTER* startPlotSheetSVG( const wxString& aFileName, SCH_SCREEN* aScreen,
+                                RENDER_SETTINGS* aRenderSettings, bool aPlotBlackAndWhite,
+                                bool aPlotFrameRef );
 
     /**
      * Create a file name with an absolute path name
@@ -190,26 +190,25 @@ bool IFACE::OnKifaceStart( PGM_BASE* aProgram, int aCtlBits )
     }
     else
     {
-        try
-        {
-            // The global table is not related to a specific project.  All projects
-            // will use the same global table.  So the KIFACE::OnKifaceStart() contract
-            // of avoiding anything project specific is not violated here.
-            if( !SYMBOL_LIB_TABLE::LoadGlobalTable( SYMBOL_LIB_TABLE::GetGlobalLibTable() ) )
-                return false;
-        }
-        catch( const IO_ERROR& ioe )
-        {
-            // if we are here, a incorrect global symbol library table was found.
-            // Incorrect global symbol library table is not a fatal error:
-            // the user just has to edit the (partially) loaded table.
-            wxString msg = _(
-                "An error occurred attempting to load the global symbol library table.\n"
-                "Please edit this global symbol library table in Preferences menu."
-                );
-
-            DisplayErrorMessage( NULL, msg, ioe.What() );
-        }
+        // The global table is not related to a specific project.  All projects
+        // will use the same global table.  So the KIFACE::OnKifaceStart() contract
+        // of avoiding anything project specific is not violated here.
+        //
+        // It is loaded in the background: the libraries may be on a network drive, and the
+        // table is only needed once a frame looks for a symbol.
+        SYMBOL_LIB_TABLE::LoadGlobalTableInBackground(
+                []( const IO_ERROR& ioe )
+                {
+                    // if we are here, a incorrect global symbol library table was found.
+                    // Incorrect global symbol library table is not a fatal error:
+                    // the user just has to edit the (partially) loaded table.
+                    wxString msg = _(
+                        "An error occurred attempting to load the global symbol library table.\n"
+                        "Please edit this global symbol library table in Preferences menu."
+                        );
+
+                    DisplayErrorMessage( NULL, msg, ioe.What() );
+                } );
     }
 
     return true;
@@ -32,6 +32,7 @@
 #include <pgm_base.h>
 #include <kiface_i.h>
 #include <richio.h>
+#include <trace_events.h>
 #include <trace_helpers.h>
 #include <tool/tool_manager.h>
 #include <id.h>
@@ -326,7 +327,10 @@ bool SCH_EDIT_FRAME::OpenProjectFiles( const std::vector<wxString>& aFileSet, in
 
         try
         {
-            Schematic().SetRoot( pi->Load( fullFileName, &Schematic() ) );
+            {
+                TRACE_SCOPE trace( "schematic-load" );
+                Schematic().SetRoot( pi->Load( fullFileName, &Schematic() ) );
+            }
 
             GetCurrentSheet().push_back( &Schematic().Root() );
 
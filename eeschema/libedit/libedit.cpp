@@ -192,7 +192,7 @@ bool LIB_EDIT_FRAME::LoadComponentFromCurrentLib( const wxString& aAliasName, in
 
     GetScreen()->ClearUndoRedoList();
     m_toolManager->RunAction( ACTIONS::zoomFitScreen, true );
-    SetShowDeMorgan( GetCurPart()->Flatten()->HasConversion() );
+    SetShowDeMorgan( GetCurPart()->HasConversion() );
 
     if( aUnit > 0 )
         RebuildSymbolUnitsList();
@@ -561,7 +561,7 @@ void LIB_EDIT_FRAME::UpdateAfterSymbolProperties( wxString* aOldName )
     m_treePane->GetLibTree()->SelectLibId( LIB_ID( lib, m_my_part->GetName() ) );
 
     RebuildSymbolUnitsList();
-    SetShowDeMorgan( GetCurPart()->Flatten()->HasConversion() );
+    SetShowDeMorgan( GetCurPart()->HasConversion() );
     updateTitle();
     DisplayCmpDoc();
 
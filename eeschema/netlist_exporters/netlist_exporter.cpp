@@ -25,6 +25,8 @@
 
 #include <netlist_exporter.h>
 
+#include <algorithm>
+
 #include <confirm.h>
 #include <fctsys.h>
 #include <gestfich.h>
@@ -111,3 +113,58 @@ SCH_COMPONENT* NETLIST_EXPORTER::findNextComponent( EDA_ITEM* aItem, SCH_SHEET_P
 
     return comp;
 }
+
+
+void NETLIST_EXPORTER::visitNets( const std::function<void( int aCode, const wxString& aName,
+                                  const std::vector<NET_NODE>& aNodes )>& aVisitor )
+{
+    std::vector<NET_NODE> nodes;
+    int                   code = 0;
+
+    for( const auto& it : m_schematic->ConnectionGraph()->GetNetMap() )
+    {
+        // Code starts at 1
+        code++;
+        nodes.clear();
+
+        for( CONNECTION_SUBGRAPH* subgraph : it.second )
+        {
+            for( SCH_ITEM* item : subgraph->m_items )
+            {
+                if( item->Type() == SCH_PIN_T )
+                    nodes.emplace_back( static_cast<SCH_PIN*>( item ), &subgraph->m_sheet );
+            }
+        }
+
+        // Netlist ordering: Net name, then ref des, then pin name
+        std::sort( nodes.begin(), nodes.end(),
+                []( const NET_NODE& a, const NET_NODE& b )
+                {
+                    if( a.m_Ref == b.m_Ref )
+                        return a.m_Pin->GetNumber() < b.m_Pin->GetNumber();
+
+                    return a.m_Ref < b.m_Ref;
+                } );
+
+        // Some duplicates can exist, for example on multi-unit parts with duplicated
+        // pins across units.  If the user connects the pins on each unit, they will
+        // appear on separate subgraphs.  Remove those here:
+        nodes.erase( std::unique( nodes.begin(), nodes.end(),
+                []( const NET_NODE& a, const NET_NODE& b )
+                {
+                    return a.m_Ref == b.m_Ref && a.m_Pin->GetNumber() == b.m_Pin->GetNumber();
+                } ),
+                nodes.end() );
+
+        // Skip power symbols and virtual components
+        nodes.erase( std::remove_if( nodes.begin(), nodes.end(),
+                []( const NET_NODE& aNode )
+                {
+                    return aNode.m_Ref[0] == wxChar( '#' );
+                } ),
+                nodes.end() );
+
+        if( !nodes.empty() )
+            aVisitor( code, it.first.first, nodes );
+    }
+}
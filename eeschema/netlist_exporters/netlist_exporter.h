@@ -36,6 +36,9 @@
 #include <sch_sheet.h>
 #include <schematic.h>
 
+#include <functional>
+#include <vector>
+
 /**
  * UNIQUE_STRINGS
  * tracks unique wxStrings and is useful in telling if a string
@@ -81,6 +84,23 @@ struct LIB_PART_LESS_THAN
     }
 };
 
+/**
+ * A pin of a net, with the reference of its component on the sheet it is found on.
+ */
+struct NET_NODE
+{
+    NET_NODE( SCH_PIN* aPin, const SCH_SHEET_PATH* aSheet ) :
+            m_Pin( aPin ),
+            m_Sheet( aSheet ),
+            m_Ref( aPin->GetParentComponent()->GetRef( aSheet ) )
+    {}
+
+    SCH_PIN*              m_Pin;
+    const SCH_SHEET_PATH* m_Sheet;
+    wxString              m_Ref;
+};
+
+
 /**
  * NETLIST_EXPORTER
  * is a abstract class used for the netlist exporters that eeschema supports.
@@ -107,6 +127,19 @@ protected:
      */
     SCH_COMPONENT* findNextComponent( EDA_ITEM* aItem, SCH_SHEET_PATH* aSheetPath );
 
+    /**
+     * Walks the nets of the connection graph one at a time, in net code order, so that the
+     * exporters can write each net out as soon as it is found.
+     *
+     * The nodes of a net are its pins sorted by reference then pin number, without the
+     * duplicates (pins shared by the units of a component) and without the power symbols and
+     * virtual components.  The nets without nodes are not visited, but they keep their code.
+     *
+     * @param aVisitor is called with the code (starting at 1), name and nodes of each net.
+     */
+    void visitNets( const std::function<void( int aCode, const wxString& aName,
+                                              const std::vector<NET_NODE>& aNodes )>& aVisitor );
+
 public:
 
     /**
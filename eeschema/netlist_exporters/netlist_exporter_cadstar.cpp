@@ -119,92 +119,45 @@ bool NETLIST_EXPORTER_CADSTAR::writeListOfNets( FILE* f )
     wxString InitNetDescLine;
     wxString netName;
 
-    for( const auto& it : m_schematic->ConnectionGraph()->GetNetMap() )
-    {
-        auto subgraphs = it.second;
-
-        netName.Printf( wxT( "\"%s\"" ), it.first.first );
-
-        std::vector<std::pair<SCH_PIN*, SCH_SHEET_PATH>> sorted_items;
-
-        for( auto subgraph : subgraphs )
-        {
-            auto sheet = subgraph->m_sheet;
-
-            for( auto item : subgraph->m_items )
-                if( item->Type() == SCH_PIN_T )
-                    sorted_items.emplace_back(
-                            std::make_pair( static_cast<SCH_PIN*>( item ), sheet ) );
-        }
-
-        // Netlist ordering: Net name, then ref des, then pin name
-        std::sort( sorted_items.begin(), sorted_items.end(),
-                []( auto a, auto b )
-                {
-                    wxString ref_a = a.first->GetParentComponent()->GetRef( &a.second );
-                    wxString ref_b = b.first->GetParentComponent()->GetRef( &b.second );
-
-                    if( ref_a == ref_b )
-                        return a.first->GetNumber() < b.first->GetNumber();
-
-                    return ref_a < ref_b;
-                } );
-
-        // Some duplicates can exist, for example on multi-unit parts with duplicated
-        // pins across units.  If the user connects the pins on each unit, they will
-        // appear on separate subgraphs.  Remove those here:
-        sorted_items.erase( std::unique( sorted_items.begin(), sorted_items.end(),
-                []( auto a, auto b )
-                {
-                    auto ref_a = a.first->GetParentComponent()->GetRef( &a.second );
-                    auto ref_b = b.first->GetParentComponent()->GetRef( &b.second );
-
-                    return ref_a == ref_b && a.first->GetNumber() == b.first->GetNumber();
-                } ),
-                sorted_items.end() );
-
-        for( const auto& pair : sorted_items )
-        {
-            SCH_PIN*       pin   = pair.first;
-            SCH_SHEET_PATH sheet = pair.second;
-
-            wxString refText = pin->GetParentComponent()->GetRef( &sheet );
-            wxString pinText = pin->GetNumber();
-
-            // Skip power symbols and virtual components
-            if( refText[0] == wxChar( '#' ) )
-                continue;
-
-            switch( print_ter )
+    visitNets( [&]( int aCode, const wxString& aName, const std::vector<NET_NODE>& aNodes )
             {
-            case 0:
+                netName.Printf( wxT( "\"%s\"" ), aName );
+
+                for( const NET_NODE& netNode : aNodes )
                 {
-                    InitNetDescLine.Printf( wxT( "\n%s   %s   %.4s     %s" ),
-                                            GetChars( InitNetDesc ),
-                                            GetChars( refText ),
-                                            GetChars( pinText ),
-                                            GetChars( netName ) );
+                    const wxString& refText = netNode.m_Ref;
+                    wxString        pinText = netNode.m_Pin->GetNumber();
+
+                    switch( print_ter )
+                    {
+                    case 0:
+                        {
+                            InitNetDescLine.Printf( wxT( "\n%s   %s   %.4s     %s" ),
+                                                    GetChars( InitNetDesc ),
+                                                    GetChars( refText ),
+                                                    GetChars( pinText ),
+                                                    GetChars( netName ) );
+                        }
+                        print_ter++;
+                        break;
+
+                    case 1:
+                        ret |= fprintf( f, "%s\n", TO_UTF8( InitNetDescLine ) );
+                        ret |= fprintf( f, "%s       %s   %.4s\n",
+                                        TO_UTF8( StartNetDesc ),
+                                        TO_UTF8( refText ),
+                                        TO_UTF8( pinText ) );
+                        print_ter++;
+                        break;
+
+                    default:
+                        ret |= fprintf( f, "            %s   %.4s\n",
+                                        TO_UTF8( refText ),
+                                        TO_UTF8( pinText ) );
+                        break;
+                    }
                 }
-                print_ter++;
-                break;
-
-            case 1:
-                ret |= fprintf( f, "%s\n", TO_UTF8( InitNetDescLine ) );
-                ret |= fprintf( f, "%s       %s   %.4s\n",
-                                TO_UTF8( StartNetDesc ),
-                                TO_UTF8( refText ),
-                                TO_UTF8( pinText ) );
-                print_ter++;
-                break;
-
-            default:
-                ret |= fprintf( f, "            %s   %.4s\n",
-                                TO_UTF8( refText ),
-                                TO_UTF8( pinText ) );
-                break;
-            }
-        }
-    }
+            } );
 
     return ret >= 0;
 }
@@ -499,10 +499,6 @@ XNODE* NETLIST_EXPORTER_GENERIC::makeListOfNets()
 {
     XNODE*      xnets = node( "nets" );      // auto_ptr if exceptions ever get used.
     wxString    netCodeTxt;
-    wxString    netName;
-    wxString    ref;
-
-    XNODE*      xnet = 0;
 
     /*  output:
         <net code="123" name="/cfcard.sch/WAIT#">
@@ -511,92 +507,44 @@ XNODE* NETLIST_EXPORTER_GENERIC::makeListOfNets()
         </net>
     */
 
-    int code = 0;
-
-    for( const auto& it : m_schematic->ConnectionGraph()->GetNetMap() )
-    {
-        bool     added     = false;
-        wxString net_name  = it.first.first;
-        auto     subgraphs = it.second;
-
-        // Code starts at 1
-        code++;
-
-        XNODE* xnode;
-        std::vector<std::pair<SCH_PIN*, SCH_SHEET_PATH>> sorted_items;
-
-        for( auto subgraph : subgraphs )
-        {
-            auto sheet = subgraph->m_sheet;
-
-            for( auto item : subgraph->m_items )
-                if( item->Type() == SCH_PIN_T )
-                    sorted_items.emplace_back(
-                            std::make_pair( static_cast<SCH_PIN*>( item ), sheet ) );
-        }
-
-        // Netlist ordering: Net name, then ref des, then pin name
-        std::sort( sorted_items.begin(), sorted_items.end(), [] ( auto a, auto b ) {
-                    auto ref_a = a.first->GetParentComponent()->GetRef( &a.second );
-                    auto ref_b = b.first->GetParentComponent()->GetRef( &b.second );
-
-                    if( ref_a == ref_b )
-                        return a.first->GetNumber() < b.first->GetNumber();
-
-                    return ref_a < ref_b;
-                } );
-
-        // Some duplicates can exist, for example on multi-unit parts with duplicated
-        // pins across units.  If the user connects the pins on each unit, they will
-        // appear on separate subgraphs.  Remove those here:
-        sorted_items.erase( std::unique( sorted_items.begin(), sorted_items.end(),
-                [] ( auto a, auto b ) {
-                    auto ref_a = a.first->GetParentComponent()->GetRef( &a.second );
-                    auto ref_b = b.first->GetParentComponent()->GetRef( &b.second );
-
-                    return ref_a == ref_b && a.first->GetNumber() == b.first->GetNumber();
-                } ), sorted_items.end() );
-
-        for( const auto& pair : sorted_items )
-        {
-            SCH_PIN* pin = pair.first;
-            SCH_SHEET_PATH sheet = pair.second;
-
-            auto refText = pin->GetParentComponent()->GetRef( &sheet );
-            const auto& pinText = pin->GetNumber();
-
-            // Skip power symbols and virtual components
-            if( refText[0] == wxChar( '#' ) )
-                continue;
-
-            if( !added )
+    visitNets( [&]( int aCode, const wxString& aName, const std::vector<NET_NODE>& aNodes )
             {
+                XNODE* xnet;
+
                 xnets->AddChild( xnet = node( "net" ) );
-                netCodeTxt.Printf( "%d", code );
+                netCodeTxt.Printf( "%d", aCode );
                 xnet->AddAttribute( "code", netCodeTxt );
-                xnet->AddAttribute( "name", net_name );
-
-                added = true;
-            }
+                xnet->AddAttribute( "name", aName );
 
-            xnet->AddChild( xnode = node( "node" ) );
-            xnode->AddAttribute( "ref", refText );
-            xnode->AddAttribute( "pin", pinText );
+                for( const NET_NODE& netNode : aNodes )
+                {
+                    XNODE* xnode;
 
-            wxString pinName;
+                    xnet->AddChild( xnode = node( "node" ) );
+                    xnode->AddAttribute( "ref", netNode.m_Ref );
+                    xnode->AddAttribute( "pin", netNode.m_Pin->GetNumber() );
 
-            if( pin->GetName() != "~" ) //  ~ is a char used to code empty strings in libs.
-                pinName = pin->GetName();
+                    wxString pinName = pinFunction( netNode.m_Pin );
 
-            if( !pinName.IsEmpty() )
-                xnode->AddAttribute( "pinfunction", pinName );
-        }
-    }
+                    if( !pinName.IsEmpty() )
+                        xnode->AddAttribute( "pinfunction", pinName );
+                }
+            } );
 
     return xnets;
 }
 
 
+wxString NETLIST_EXPORTER_GENERIC::pinFunction( SCH_PIN* aPin )
+{
+    //  ~ is a char used to code empty strings in libs.
+    if( aPin->GetName() != "~" )
+        return aPin->GetName();
+
+    return wxEmptyString;
+}
+
+
 XNODE* NETLIST_EXPORTER_GENERIC::node( const wxString& aName, const wxString& aTextualContent /* = wxEmptyString*/ )
 {
     XNODE* n = new XNODE( wxXML_ELEMENT_NODE, aName );
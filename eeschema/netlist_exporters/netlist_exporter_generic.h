@@ -124,6 +124,11 @@ protected:
      */
     XNODE* makeListOfNets();
 
+    /**
+     * @return the name of \a aPin as written in the netlists, empty when the pin has none.
+     */
+    static wxString pinFunction( SCH_PIN* aPin );
+
     /**
      * Function makeLibraries
      * fills out an XML node with a list of used libraries and returns it.
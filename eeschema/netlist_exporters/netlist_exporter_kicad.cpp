@@ -54,7 +54,67 @@ bool NETLIST_EXPORTER_KICAD::WriteNetlist( const wxString& aOutFileName, unsigne
 
 void NETLIST_EXPORTER_KICAD::Format( OUTPUTFORMATTER* aOut, int aCtl )
 {
-    std::unique_ptr<XNODE> xroot( makeRoot( aCtl ) );
+    // The nets are the bulk of a netlist: they are written out as they are walked instead
+    // of being built into the document tree.  The output is the same as XNODE::Format().
+    std::unique_ptr<XNODE> xroot( makeRoot( aCtl & ~GNL_NETS ) );
 
-    xroot->Format( aOut, 0 );
+    if( !( aCtl & GNL_NETS ) )
+    {
+        xroot->Format( aOut, 0 );
+        return;
+    }
+
+    aOut->Print( 0, "(%s", TO_UTF8( xroot->GetName() ) );
+
+    for( wxXmlAttribute* attr = xroot->GetAttributes(); attr; attr = attr->GetNext() )
+    {
+        aOut->Print( 0, " (%s %s)", TO_UTF8( attr->GetName() ),
+                     aOut->Quotew( attr->GetValue() ).c_str() );
+    }
+
+    for( XNODE* kid = xroot->GetChildren(); kid; kid = kid->GetNext() )
+    {
+        if( kid == xroot->GetChildren() )
+            aOut->Print( 0, "\n" );
+
+        kid->Format( aOut, 1 );
+    }
+
+    // The last section does not end its line: the nets follow it
+    aOut->Print( 0, "\n" );
+    formatNets( aOut, 1 );
+    aOut->Print( 0, ")" );
+}
+
+
+void NETLIST_EXPORTER_KICAD::formatNets( OUTPUTFORMATTER* aOut, int aNestLevel )
+{
+    aOut->Print( aNestLevel, "(nets" );
+
+    visitNets( [&]( int aCode, const wxString& aName, const std::vector<NET_NODE>& aNodes )
+            {
+                aOut->Print( 0, "\n" );
+                aOut->Print( aNestLevel + 1, "(net (code %s) (name %s)",
+                             aOut->Quotew( wxString::Format( "%d", aCode ) ).c_str(),
+                             aOut->Quotew( aName ).c_str() );
+
+                for( const NET_NODE& netNode : aNodes )
+                {
+                    wxString pinName = pinFunction( netNode.m_Pin );
+
+                    aOut->Print( 0, "\n" );
+                    aOut->Print( aNestLevel + 2, "(node (ref %s) (pin %s)",
+                                 aOut->Quotew( netNode.m_Ref ).c_str(),
+                                 aOut->Quotew( netNode.m_Pin->GetNumber() ).c_str() );
+
+                    if( !pinName.IsEmpty() )
+                        aOut->Print( 0, " (pinfunction %s)", aOut->Quotew( pinName ).c_str() );
+
+                    aOut->Print( 0, ")" );
+                }
+
+                aOut->Print( 0, ")" );
+            } );
+
+    aOut->Print( 0, ")" );
 }
@@ -57,6 +57,12 @@ public:
      * @throw IO_ERROR if any problems.
      */
     void Format( OUTPUTFORMATTER* aOutputFormatter, int aCtl );
+
+private:
+    /**
+     * Writes the nets section of the netlist, one net at a time.
+     */
+    void formatNets( OUTPUTFORMATTER* aOut, int aNestLevel );
 };
 
 #endif
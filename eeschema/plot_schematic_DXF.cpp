@@ -54,7 +54,7 @@ void DIALOG_PLOT_SCHEMATIC::CreateDXFFile( bool aPlotAll, bool aPlotFrameRef,
     SCH_SHEET_LIST sheetList;
 
     if( aPlotAll )
-        sheetList.BuildSheetList( &schframe->Schematic().Root() );
+        sheetList = schframe->Schematic().GetSheets();
     else
         sheetList.push_back( schframe->GetCurrentSheet() );
 
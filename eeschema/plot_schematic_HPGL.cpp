@@ -100,7 +100,7 @@ void DIALOG_PLOT_SCHEMATIC::createHPGLFile( bool aPlotAll, bool aPlotFrameRef,
     SCH_SHEET_LIST  sheetList;
 
     if( aPlotAll )
-        sheetList.BuildSheetList( &m_parent->Schematic().Root() );
+        sheetList = m_parent->Schematic().GetSheets();
     else
         sheetList.push_back( m_parent->GetCurrentSheet() );
 
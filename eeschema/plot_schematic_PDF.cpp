@@ -57,7 +57,7 @@ void DIALOG_PLOT_SCHEMATIC::createPDFFile( bool aPlotAll, bool aPlotFrameRef,
     SCH_SHEET_LIST sheetList;
 
     if( aPlotAll )
-        sheetList.BuildSheetList( &m_parent->Schematic().Root() );
+        sheetList = m_parent->Schematic().GetSheets();
     else
         sheetList.push_back( m_parent->GetCurrentSheet() );
 
@@ -71,62 +71,70 @@ void DIALOG_PLOT_SCHEMATIC::createPDFFile( bool aPlotAll, bool aPlotFrameRef,
     wxString msg;
     wxFileName plotFileName;
     REPORTER& reporter = m_MessagesBox->Reporter();
-    LOCALE_IO toggle;       // Switch the locale to standard C
 
-    for( unsigned i = 0; i < sheetList.size(); i++ )
-    {
-        m_parent->SetCurrentSheet( sheetList[i] );
-        m_parent->GetCurrentSheet().UpdateAllScreenReferences();
-        m_parent->SetSheetNumberAndCount();
-        SCH_SCREEN* screen = m_parent->GetCurrentSheet().LastScreen();
-
-        if( i == 0 )
-        {
-
-            try
+    // The pages are plotted concurrently, each one by its own plotter, and added to the
+    // document in the order of the sheets
+    plotSheets( sheetList,
+            [&]( size_t aIndex, SCH_SCREEN* aScreen ) -> PLOTTER*
             {
-                wxString fname = m_parent->GetUniqueFilenameForCurrentSheet();
-                wxString ext = PDF_PLOTTER::GetDefaultFileExtension();
-                plotFileName = createPlotFileName( fname, ext, &reporter );
-
-                if( !plotter->OpenFile( plotFileName.GetFullPath() ) )
+                if( aIndex == 0 )
                 {
-                    msg.Printf( _( "Unable to create file \"%s\".\n" ), plotFileName.GetFullPath() );
-                    reporter.Report( msg, RPT_SEVERITY_ERROR );
-                    delete plotter;
-                    return;
+                    try
+                    {
+                        wxString fname = m_parent->GetUniqueFilenameForCurrentSheet();
+                        wxString ext = PDF_PLOTTER::GetDefaultFileExtension();
+                        plotFileName = createPlotFileName( fname, ext, &reporter );
+
+                        if( !plotter->OpenFile( plotFileName.GetFullPath() ) )
+                        {
+                            msg.Printf( _( "Unable to create file \"%s\".\n" ),
+                                        plotFileName.GetFullPath() );
+                            reporter.Report( msg, RPT_SEVERITY_ERROR );
+                            delete plotter;
+                            plotter = nullptr;
+                        }
+                        else
+                        {
+                            plotter->StartDetachedPlot();
+                        }
+                    }
+                    catch( const IO_ERROR& e )
+                    {
+                        // Cannot plot PDF file
+                        msg.Printf( wxT( "PDF Plotter exception: %s" ), e.What() );
+                        reporter.Report( msg, RPT_SEVERITY_ERROR );
+                        delete plotter;
+                        plotter = nullptr;
+                    }
                 }
 
-                // Open the plotter and do the first page
-                setupPlotPagePDF( plotter, screen );
-                plotter->StartPlot();
-            }
-            catch( const IO_ERROR& e )
+                if( !plotter )
+                    return nullptr;
+
+                PDF_PLOTTER* page = new PDF_PLOTTER();
+                page->SetRenderSettings( aRenderSettings );
+                page->SetColorMode( getModeColor() );
+
+                setupPlotPagePDF( page, aScreen );
+                page->StartDetachedPage();
+                plotPageFramePDF( page, aScreen, aPlotFrameRef );
+
+                return page;
+            },
+            [&]( size_t aIndex, PLOTTER* aPlotter )
             {
-                // Cannot plot PDF file
-                msg.Printf( wxT( "PDF Plotter exception: %s" ), e.What() );
-                reporter.Report( msg, RPT_SEVERITY_ERROR );
-
-                restoreEnvironment( plotter, oldsheetpath );
-                return;
-            }
-
-        }
-        else
-        {
-            /* For the following pages you need to close the (finished) page,
-             *  reconfigure, and then start a new one */
-            plotter->ClosePage();
-            setupPlotPagePDF( plotter, screen );
-            plotter->StartPage();
-        }
-
-        plotOneSheetPDF( plotter, screen, aPlotFrameRef );
-    }
+                PDF_PLOTTER* page = static_cast<PDF_PLOTTER*>( aPlotter );
+
+                plotter->AddDetachedPage( page->PageSettings(), page->EndDetachedPage() );
+                delete page;
+            } );
 
     // Everything done, close the plot and restore the environment
-    msg.Printf( _( "Plot: \"%s\" OK.\n" ), plotFileName.GetFullPath() );
-    reporter.Report( msg, RPT_SEVERITY_ACTION );
+    if( plotter )
+    {
+        msg.Printf( _( "Plot: \"%s\" OK.\n" ), plotFileName.GetFullPath() );
+        reporter.Report( msg, RPT_SEVERITY_ACTION );
+    }
 
     restoreEnvironment( plotter, oldsheetpath );
 }
@@ -135,8 +143,13 @@ void DIALOG_PLOT_SCHEMATIC::createPDFFile( bool aPlotAll, bool aPlotFrameRef,
 void DIALOG_PLOT_SCHEMATIC::restoreEnvironment( PDF_PLOTTER* aPlotter,
                                                 SCH_SHEET_PATH& aOldsheetpath )
 {
-    aPlotter->EndPlot();
-    delete aPlotter;
+    if( aPlotter )
+    {
+        LOCALE_IO toggle;       // Switch the locale to standard C
+
+        aPlotter->EndPlot();
+        delete aPlotter;
+    }
 
     // Restore the previous sheet
     m_parent->SetCurrentSheet( aOldsheetpath );
@@ -145,9 +158,8 @@ void DIALOG_PLOT_SCHEMATIC::restoreEnvironment( PDF_PLOTTER* aPlotter,
 }
 
 
-void DIALOG_PLOT_SCHEMATIC::plotOneSheetPDF( PLOTTER* aPlotter,
-                                             SCH_SCREEN* aScreen,
-                                             bool aPlotFrameRef )
+void DIALOG_PLOT_SCHEMATIC::plotPageFramePDF( PLOTTER* aPlotter, SCH_SCREEN* aScreen,
+                                              bool aPlotFrameRef )
 {
     if( m_plotBackgroundColor->GetValue() )
     {
@@ -167,8 +179,6 @@ void DIALOG_PLOT_SCHEMATIC::plotOneSheetPDF( PLOTTER* aPlotter,
                        aPlotter->RenderSettings()->GetLayerColor( LAYER_SCHEMATIC_WORKSHEET ) :
                        COLOR4D::BLACK );
     }
-
-    aScreen->Plot( aPlotter );
 }
 
 
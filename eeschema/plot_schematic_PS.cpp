@@ -42,7 +42,7 @@ void DIALOG_PLOT_SCHEMATIC::createPSFile( bool aPlotAll, bool aPlotFrameRef,
                                           RENDER_SETTINGS* aRenderSettings )
 {
     SCH_SHEET_PATH  oldsheetpath = m_parent->GetCurrentSheet();  // sheetpath is saved here
-    PAGE_INFO       plotPage;                                    // page size selected to plot
+    REPORTER&       reporter = m_MessagesBox->Reporter();
 
     /* When printing all pages, the printed page is not the current page.
      * In complex hierarchies, we must update component references
@@ -53,73 +53,83 @@ void DIALOG_PLOT_SCHEMATIC::createPSFile( bool aPlotAll, bool aPlotFrameRef,
     SCH_SHEET_LIST  sheetList;
 
     if( aPlotAll )
-        sheetList.BuildSheetList( &m_parent->Schematic().Root() );
+        sheetList = m_parent->Schematic().GetSheets();
     else
         sheetList.push_back( m_parent->GetCurrentSheet() );
 
-    for( unsigned i = 0; i < sheetList.size(); i++ )
-    {
-        m_parent->SetCurrentSheet( sheetList[i] );
-        m_parent->GetCurrentSheet().UpdateAllScreenReferences();
-        m_parent->SetSheetNumberAndCount();
-
-        SCH_SCREEN* screen = m_parent->GetCurrentSheet().LastScreen();
-        PAGE_INFO   actualPage = screen->GetPageSettings();
-
-        switch( m_pageSizeSelect )
-        {
-        case PAGE_SIZE_A:
-            plotPage.SetType( wxT( "A" ) );
-            plotPage.SetPortrait( actualPage.IsPortrait() );
-            break;
-
-        case PAGE_SIZE_A4:
-            plotPage.SetType( wxT( "A4" ) );
-            plotPage.SetPortrait( actualPage.IsPortrait() );
-            break;
-
-        case PAGE_SIZE_AUTO:
-        default:
-            plotPage = actualPage;
-            break;
-        }
-
-        double  scalex  = (double) plotPage.GetWidthMils() / actualPage.GetWidthMils();
-        double  scaley  = (double) plotPage.GetHeightMils() / actualPage.GetHeightMils();
-
-        double  scale = std::min( scalex, scaley );
-
-        wxPoint plot_offset;
-
-        wxString msg;
-        REPORTER& reporter = m_MessagesBox->Reporter();
+    std::vector<wxString> fileNames( sheetList.size() );
 
-        try
-        {
-            wxString fname = m_parent->GetUniqueFilenameForCurrentSheet();
-            wxString ext = PS_PLOTTER::GetDefaultFileExtension();
-            wxFileName plotFileName = createPlotFileName( fname, ext, &reporter );
-
-            if( plotOneSheetPS( plotFileName.GetFullPath(), screen, aRenderSettings, plotPage,
-                                plot_offset, scale, aPlotFrameRef ) )
+    // The sheets are plotted concurrently, each one in its own file
+    plotSheets( sheetList,
+            [&]( size_t aIndex, SCH_SCREEN* aScreen ) -> PLOTTER*
             {
-                msg.Printf( _( "Plot: \"%s\" OK.\n" ), plotFileName.GetFullPath() );
-                reporter.Report( msg, RPT_SEVERITY_ACTION );
-            }
-            else
+                PAGE_INFO plotPage;                                 // page size selected to plot
+                PAGE_INFO actualPage = aScreen->GetPageSettings();
+
+                switch( m_pageSizeSelect )
+                {
+                case PAGE_SIZE_A:
+                    plotPage.SetType( wxT( "A" ) );
+                    plotPage.SetPortrait( actualPage.IsPortrait() );
+                    break;
+
+                case PAGE_SIZE_A4:
+                    plotPage.SetType( wxT( "A4" ) );
+                    plotPage.SetPortrait( actualPage.IsPortrait() );
+                    break;
+
+                case PAGE_SIZE_AUTO:
+                default:
+                    plotPage = actualPage;
+                    break;
+                }
+
+                double  scalex  = (double) plotPage.GetWidthMils() / actualPage.GetWidthMils();
+                double  scaley  = (double) plotPage.GetHeightMils() / actualPage.GetHeightMils();
+
+                double  scale = std::min( scalex, scaley );
+
+                wxPoint plot_offset;
+
+                wxString msg;
+
+                try
+                {
+                    wxString   fname = m_parent->GetUniqueFilenameForCurrentSheet();
+                    wxString   ext = PS_PLOTTER::GetDefaultFileExtension();
+                    wxFileName plotFileName = createPlotFileName( fname, ext, &reporter );
+
+                    fileNames[aIndex] = plotFileName.GetFullPath();
+
+                    PLOTTER* plotter = startPlotSheetPS( fileNames[aIndex], aScreen,
+                                                         aRenderSettings, plotPage, plot_offset,
+                                                         scale, aPlotFrameRef );
+
+                    if( !plotter )
+                    {
+                        // Error
+                        msg.Printf( _( "Unable to create file \"%s\".\n" ), fileNames[aIndex] );
+                        reporter.Report( msg, RPT_SEVERITY_ERROR );
+                    }
+
+                    return plotter;
+                }
+                catch( IO_ERROR& e )
+                {
+                    msg.Printf( wxT( "PS Plotter exception: %s"), e.What() );
+                    reporter.Report( msg, RPT_SEVERITY_ERROR );
+                    return nullptr;
+                }
+            },
+            [&]( size_t aIndex, PLOTTER* aPlotter )
             {
-                // Error
-                msg.Printf( _( "Unable to create file \"%s\".\n" ), plotFileName.GetFullPath() );
-                reporter.Report( msg, RPT_SEVERITY_ERROR );
-            }
-
-        }
-        catch( IO_ERROR& e )
-        {
-            msg.Printf( wxT( "PS Plotter exception: %s"), e.What() );
-            reporter.Report( msg, RPT_SEVERITY_ERROR );
-        }
-    }
+                aPlotter->EndPlot();
+                delete aPlotter;
+
+                wxString msg;
+                msg.Printf( _( "Plot: \"%s\" OK.\n" ), fileNames[aIndex] );
+                reporter.Report( msg, RPT_SEVERITY_ACTION );
+            } );
 
     m_parent->SetCurrentSheet( oldsheetpath );
     m_parent->GetCurrentSheet().UpdateAllScreenReferences();
@@ -127,13 +137,13 @@ void DIALOG_PLOT_SCHEMATIC::createPSFile( bool aPlotAll, bool aPlotFrameRef,
 }
 
 
-bool DIALOG_PLOT_SCHEMATIC::plotOneSheetPS( const wxString&     aFileName,
-                                            SCH_SCREEN*         aScreen,
-                                            RENDER_SETTINGS*    aRenderSettings,
-                                            const PAGE_INFO&    aPageInfo,
-                                            wxPoint             aPlot0ffset,
-                                            double              aScale,
-                                            bool                aPlotFrameRef )
+PLOTTER* DIALOG_PLOT_SCHEMATIC::startPlotSheetPS( const wxString&     aFileName,
+                                                  SCH_SCREEN*         aScreen,
+                                                  RENDER_SETTINGS*    aRenderSettings,
+                                                  const PAGE_INFO&    aPageInfo,
+                                                  wxPoint             aPlot0ffset,
+                                                  double              aScale,
+                                                  bool                aPlotFrameRef )
 {
     PS_PLOTTER* plotter = new PS_PLOTTER();
     plotter->SetRenderSettings( aRenderSettings );
@@ -148,11 +158,9 @@ bool DIALOG_PLOT_SCHEMATIC::plotOneSheetPS( const wxString&     aFileName,
     if( ! plotter->OpenFile( aFileName ) )
     {
         delete plotter;
-        return false;
+        return nullptr;
     }
 
-    LOCALE_IO toggle;       // Switch the locale to standard C
-
     plotter->StartPlot();
 
     if( m_plotBackgroundColor->GetValue() )
@@ -173,10 +181,5 @@ bool DIALOG_PLOT_SCHEMATIC::plotOneSheetPS( const wxString&     aFileName,
                        COLOR4D::BLACK );
     }
 
-    aScreen->Plot( plotter );
-
-    plotter->EndPlot();
-    delete plotter;
-
-    return true;
+    return plotter;
 }
@@ -46,52 +46,61 @@
 void DIALOG_PLOT_SCHEMATIC::createSVGFile( bool aPrintAll, bool aPrintFrameRef,
                                            RENDER_SETTINGS* aRenderSettings )
 {
-    wxString        msg;
     REPORTER&       reporter = m_MessagesBox->Reporter();
     SCH_SHEET_PATH  oldsheetpath = m_parent->GetCurrentSheet();
     SCH_SHEET_LIST  sheetList;
 
     if( aPrintAll )
-        sheetList.BuildSheetList( &m_parent->Schematic().Root() );
+        sheetList = m_parent->Schematic().GetSheets();
     else
         sheetList.push_back( m_parent->GetCurrentSheet() );
 
-    for( unsigned i = 0; i < sheetList.size(); i++ )
-    {
-        SCH_SCREEN*  screen;
-        m_parent->SetCurrentSheet( sheetList[i] );
-        m_parent->GetCurrentSheet().UpdateAllScreenReferences();
-        m_parent->SetSheetNumberAndCount();
-        screen = m_parent->GetCurrentSheet().LastScreen();
-
-        try
-        {
-            wxString fname = m_parent->GetUniqueFilenameForCurrentSheet();
-            wxString ext = SVG_PLOTTER::GetDefaultFileExtension();
-            wxFileName plotFileName = createPlotFileName( fname, ext, &reporter );
-
-            bool success = plotOneSheetSVG( plotFileName.GetFullPath(), screen, aRenderSettings,
-                                            getModeColor() ? false : true, aPrintFrameRef );
-
-            if( !success )
+    std::vector<wxString> fileNames( sheetList.size() );
+
+    // The sheets are plotted concurrently, each one in its own file
+    plotSheets( sheetList,
+            [&]( size_t aIndex, SCH_SCREEN* aScreen ) -> PLOTTER*
             {
-                msg.Printf( _( "Cannot create file \"%s\".\n" ), plotFileName.GetFullPath() );
-                reporter.Report( msg, RPT_SEVERITY_ERROR );
-            }
-            else
+                wxString msg;
+
+                try
+                {
+                    wxString   fname = m_parent->GetUniqueFilenameForCurrentSheet();
+                    wxString   ext = SVG_PLOTTER::GetDefaultFileExtension();
+                    wxFileName plotFileName = createPlotFileName( fname, ext, &reporter );
+
+                    fileNames[aIndex] = plotFileName.GetFullPath();
+
+                    PLOTTER* plotter = startPlotSheetSVG( fileNames[aIndex], aScreen,
+                                                          aRenderSettings,
+                                                          getModeColor() ? false : true,
+                                                          aPrintFrameRef );
+
+                    if( !plotter )
+                    {
+                        msg.Printf( _( "Cannot create file \"%s\".\n" ), fileNames[aIndex] );
+                        reporter.Report( msg, RPT_SEVERITY_ERROR );
+                    }
+
+                    return plotter;
+                }
+                catch( const IO_ERROR& e )
+                {
+                    // Cannot plot SVG file
+                    msg.Printf( wxT( "SVG Plotter exception: %s" ), e.What() );
+                    reporter.Report( msg, RPT_SEVERITY_ERROR );
+                    return nullptr;
+                }
+            },
+            [&]( size_t aIndex, PLOTTER* aPlotter )
             {
-                msg.Printf( _( "Plot: \"%s\" OK.\n" ), plotFileName.GetFullPath() );
+                aPlotter->EndPlot();
+                delete aPlotter;
+
+                wxString msg;
+                msg.Printf( _( "Plot: \"%s\" OK.\n" ), fileNames[aIndex] );
                 reporter.Report( msg, RPT_SEVERITY_ACTION );
-            }
-        }
-        catch( const IO_ERROR& e )
-        {
-            // Cannot plot SVG file
-            msg.Printf( wxT( "SVG Plotter exception: %s" ), e.What() );
-            reporter.Report( msg, RPT_SEVERITY_ERROR );
-            break;
-        }
-    }
+            } );
 
     m_parent->SetCurrentSheet( oldsheetpath );
     m_parent->GetCurrentSheet().UpdateAllScreenReferences();
@@ -99,11 +108,11 @@ void DIALOG_PLOT_SCHEMATIC::createSVGFile( bool aPrintAll, bool aPrintFrameRef,
 }
 
 
-bool DIALOG_PLOT_SCHEMATIC::plotOneSheetSVG( const wxString&  aFileName,
-                                             SCH_SCREEN*      aScreen,
-                                             RENDER_SETTINGS* aRenderSettings,
-                                             bool             aPlotBlackAndWhite,
-                                             bool             aPlotFrameRef )
+PLOTTER* DIALOG_PLOT_SCHEMATIC::startPlotSheetSVG( const wxString&  aFileName,
+                                                   SCH_SCREEN*      aScreen,
+                                                   RENDER_SETTINGS* aRenderSettings,
+                                                   bool             aPlotBlackAndWhite,
+                                                   bool             aPlotFrameRef )
 {
     const PAGE_INFO& pageInfo = aScreen->GetPageSettings();
 
@@ -122,11 +131,9 @@ bool DIALOG_PLOT_SCHEMATIC::plotOneSheetSVG( const wxString&  aFileName,
     if( ! plotter->OpenFile( aFileName ) )
     {
         delete plotter;
-        return false;
+        return nullptr;
     }
 
-    LOCALE_IO   toggle;
-
     plotter->StartPlot();
 
     if( m_plotBackgroundColor->GetValue() )
@@ -147,10 +154,5 @@ bool DIALOG_PLOT_SCHEMATIC::plotOneSheetSVG( const wxString&  aFileName,
                        COLOR4D::BLACK );
     }
 
-    aScreen->Plot( plotter );
-
-    plotter->EndPlot();
-    delete plotter;
-
-    return true;
+    return plotter;
 }
@@ -167,8 +167,9 @@ SCH_COMPONENT::SCH_COMPONENT( const SCH_COMPONENT& aComponent ) :
     m_lib_id      = aComponent.m_lib_id;
     m_isInNetlist = aComponent.m_isInNetlist;
 
-    if( aComponent.m_part )
-        SetLibSymbol( new LIB_PART( *aComponent.m_part.get() ) );
+    // The library symbol is shared: the undo copies of the components cost only their fields
+    m_part = aComponent.m_part;
+    UpdatePins();
 
     const_cast<KIID&>( m_Uuid ) = aComponent.m_Uuid;
 
@@ -277,6 +278,9 @@ wxString SCH_COMPONENT::GetDatasheet() const
 
 void SCH_COMPONENT::UpdatePins()
 {
+    // The items connected to the old pins must be linked to the new ones
+    SetConnectivityDirty();
+
     m_pins.clear();
     m_pinMap.clear();
 
@@ -749,10 +753,8 @@ void SCH_COMPONENT::SwapData( SCH_ITEM* aItem )
 
     std::swap( m_lib_id, component->m_lib_id );
 
-    LIB_PART* part = component->m_part.release();
-    component->m_part.reset( m_part.release() );
+    std::swap( m_part, component->m_part );
     component->UpdatePins();
-    m_part.reset( part );
     UpdatePins();
 
     std::swap( m_Pos, component->m_Pos );
@@ -1627,9 +1629,7 @@ SCH_COMPONENT& SCH_COMPONENT::operator=( const SCH_ITEM& aItem )
 
         m_lib_id    = c->m_lib_id;
 
-        LIB_PART* libSymbol = c->m_part ? new LIB_PART( *c->m_part.get() ) : nullptr;
-
-        m_part.reset( libSymbol );
+        m_part      = c->m_part;
         m_Pos       = c->m_Pos;
         m_unit      = c->m_unit;
         m_convert   = c->m_convert;
@@ -119,7 +119,9 @@ private:
     SCH_FIELDS  m_Fields;       ///< Variable length list of fields.
 
     ///< A flattened copy of a LIB_PART found in the PROJECT's libraries to for this component.
-    std::unique_ptr< LIB_PART > m_part;
+    ///< It is never modified in place, so the copies of a component (e.g. the ones held by the
+    ///< undo list) share it until one of them is given another symbol.
+    std::shared_ptr< LIB_PART > m_part;
 
     SCH_PINS    m_pins;         ///< a SCH_PIN for every LIB_PIN (across all units)
     SCH_PIN_MAP m_pinMap;       ///< the component's pins mapped by LIB_PIN*
@@ -218,7 +220,7 @@ public:
     wxString GetSchSymbolLibraryName() const;
     bool UseLibIdLookup() const { return m_schLibSymbolName.IsEmpty(); }
 
-    std::unique_ptr< LIB_PART >& GetPartRef() { return m_part; }
+    std::shared_ptr< LIB_PART >& GetPartRef() { return m_part; }
 
     /**
      * Set this schematic symbol library symbol reference to \a aLibSymbol
@@ -397,15 +397,12 @@ SCH_SHEET* SCH_EAGLE_PLUGIN::Load( const wxString& aFileName, SCHEMATIC* aSchema
     wxASSERT( !aFileName || aSchematic != nullptr );
     LOCALE_IO toggle; // toggles on, then off, the C locale.
 
-    // Load the document
-    wxXmlDocument xmlDocument;
-
     m_filename  = aFileName;
     m_schematic = aSchematic;
 
-    if( !xmlDocument.Load( m_filename.GetFullPath() ) )
-        THROW_IO_ERROR(
-                wxString::Format( _( "Unable to read file \"%s\"" ), m_filename.GetFullPath() ) );
+    // The document is read twice, as a stream: the sheets and the nets are counted first,
+    // then the elements are loaded one by one, and freed once loaded.
+    int sheetCount = countNets( m_filename.GetFullPath() );
 
     // Delete on exception, if I own m_rootSheet, according to aAppendToMe
     unique_ptr<SCH_SHEET> deleter( aAppendToMe ? nullptr : m_rootSheet );
@@ -463,18 +460,8 @@ SCH_SHEET* SCH_EAGLE_PLUGIN::Load( const wxString& aFileName, SCHEMATIC* aSchema
         m_kiway->Prj().SchSymbolLibTable();
     }
 
-    // Retrieve the root as current node
-    wxXmlNode* currentNode = xmlDocument.GetRoot();
-
-    // If the attribute is found, store the Eagle version;
-    // otherwise, store the dummy "0.0" version.
-    m_version = currentNode->GetAttribute( "version", "0.0" );
-
-    // Map all children into a readable dictionary
-    NODE_MAP children = MapChildren( currentNode );
-
     // Load drawing
-    loadDrawing( children["drawing"] );
+    loadDrawing( m_filename.GetFullPath(), sheetCount );
 
     m_pi->SaveLibrary( getLibFileName().GetFullPath() );
 
@@ -482,153 +469,147 @@ SCH_SHEET* SCH_EAGLE_PLUGIN::Load( const wxString& aFileName, SCHEMATIC* aSchema
 }
 
 
-void SCH_EAGLE_PLUGIN::loadDrawing( wxXmlNode* aDrawingNode )
+void SCH_EAGLE_PLUGIN::loadDrawing( const wxString& aFileName, int aSheetCount )
 {
-    // Map all children into a readable dictionary
-    NODE_MAP drawingChildren = MapChildren( aDrawingNode );
-
-    // Board nodes should not appear in .sch files
-    // wxXmlNode* board = drawingChildren["board"]
+    EAGLE_XML_READER reader;
 
-    // wxXmlNode* grid = drawingChildren["grid"]
-
-    auto layers = drawingChildren["layers"];
-
-    if( layers )
-        loadLayerDefs( layers );
-
-    // wxXmlNode* library = drawingChildren["library"]
-
-    // wxXmlNode* settings = drawingChildren["settings"]
+    // Board nodes should not appear in .sch files, and the grid, library and settings nodes
+    // are not needed
+    reader.OnElement( "eagle/drawing/layers",
+            [&]( std::unique_ptr<wxXmlNode> aLayers )
+            {
+                loadLayerDefs( aLayers.get() );
+            } );
 
     // Load schematic
-    auto schematic = drawingChildren["schematic"];
-
-    if( schematic )
-        loadSchematic( schematic );
-}
-
-
-void SCH_EAGLE_PLUGIN::countNets( wxXmlNode* aSchematicNode )
-{
-    // Map all children into a readable dictionary
-    NODE_MAP schematicChildren = MapChildren( aSchematicNode );
-    // Loop through all the sheets
-
-    wxXmlNode* sheetNode = getChildrenNodes( schematicChildren, "sheets" );
-
-    while( sheetNode )
+    if( aSheetCount > 0 )
     {
-        NODE_MAP sheetChildren = MapChildren( sheetNode );
-        // Loop through all nets
-        // From the DTD: "Net is an electrical connection in a schematic."
-        wxXmlNode* netNode = getChildrenNodes( sheetChildren, "nets" );
-
-        while( netNode )
-        {
-            wxString netName = netNode->GetAttribute( "name" );
+        // Loop through all the libraries
+        reader.OnElement( "eagle/drawing/schematic/libraries/library",
+                [&]( std::unique_ptr<wxXmlNode> aLibrary )
+                {
+                    // Read the library name
+                    wxString libName = aLibrary->GetAttribute( "name" );
 
-            if( m_netCounts.count( netName ) )
-                m_netCounts[netName] = m_netCounts[netName] + 1;
-            else
-                m_netCounts[netName] = 1;
+                    EAGLE_LIBRARY* elib = &m_eagleLibs[libName];
+                    elib->name          = libName;
 
-            // Get next net
-            netNode = netNode->GetNext();
-        }
+                    loadLibrary( aLibrary.get(), elib );
 
-        sheetNode = sheetNode->GetNext();
-    }
-}
+                    // The symbol nodes are freed with the library node
+                    elib->SymbolNodes.clear();
+                } );
 
+        reader.OnElement( "eagle/drawing/schematic/parts/part",
+                [&]( std::unique_ptr<wxXmlNode> aPart )
+                {
+                    std::unique_ptr<EPART> epart( new EPART( aPart.get() ) );
 
-void SCH_EAGLE_PLUGIN::loadSchematic( wxXmlNode* aSchematicNode )
-{
-    // Map all children into a readable dictionary
-    NODE_MAP schematicChildren = MapChildren( aSchematicNode );
-    auto     partNode          = getChildrenNodes( schematicChildren, "parts" );
-    auto     libraryNode       = getChildrenNodes( schematicChildren, "libraries" );
-    auto     sheetNode         = getChildrenNodes( schematicChildren, "sheets" );
+                    // N.B. Eagle parts are case-insensitive in matching but we keep the
+                    // display case
+                    m_partlist[epart->name.Upper()] = std::move( epart );
+                } );
 
-    if( !partNode || !libraryNode || !sheetNode )
-        return;
+        int i = 0;
+        int x = 1;
+        int y = 1;
 
-    while( partNode )
-    {
-        std::unique_ptr<EPART> epart( new EPART( partNode ) );
+        // Loop through all the sheets
+        reader.OnElement( "eagle/drawing/schematic/sheets/sheet",
+                [&]( std::unique_ptr<wxXmlNode> aSheet )
+                {
+                    // The libraries and the parts come before the sheets
+                    if( i++ == 0 )
+                        m_pi->SaveLibrary( getLibFileName().GetFullPath() );
 
-        // N.B. Eagle parts are case-insensitive in matching but we keep the display case
-        m_partlist[epart->name.Upper()] = std::move( epart );
-        partNode                        = partNode->GetNext();
-    }
+                    // If eagle schematic has multiple sheets then create corresponding
+                    // subsheets on the root sheet
+                    if( aSheetCount > 1 )
+                    {
+                        wxPoint pos = wxPoint( x * Mils2iu( 1000 ), y * Mils2iu( 1000 ) );
+                        std::unique_ptr<SCH_SHEET> sheet( new SCH_SHEET( m_rootSheet, pos ) );
+                        SCH_SCREEN*                screen = new SCH_SCREEN( m_schematic );
 
-    // Loop through all the libraries
-    while( libraryNode )
-    {
-        // Read the library name
-        wxString libName = libraryNode->GetAttribute( "name" );
+                        sheet->SetScreen( screen );
+                        sheet->GetScreen()->SetFileName( sheet->GetFileName() );
 
-        EAGLE_LIBRARY* elib = &m_eagleLibs[libName];
-        elib->name          = libName;
+                        m_currentSheet = sheet.get();
+                        loadSheet( aSheet.get(), i );
+                        m_rootSheet->GetScreen()->Append( sheet.release() );
 
-        loadLibrary( libraryNode, &m_eagleLibs[libName] );
+                        x += 2;
 
-        libraryNode = libraryNode->GetNext();
+                        if( x > 10 ) // start next row
+                        {
+                            x = 1;
+                            y += 2;
+                        }
+                    }
+                    else
+                    {
+                        m_currentSheet = m_rootSheet;
+                        loadSheet( aSheet.get(), 0 );
+                    }
+                } );
     }
 
-    m_pi->SaveLibrary( getLibFileName().GetFullPath() );
+    reader.Parse( aFileName );
 
-    // find all nets and count how many sheets they appear on.
-    // local labels will be used for nets found only on that sheet.
-    countNets( aSchematicNode );
+    if( aSheetCount > 0 )
+        loadMissingUnits();
+}
 
-    // Loop through all the sheets
-    int sheet_count = countChildren( sheetNode->GetParent(), "sheet" );
 
-    // If eagle schematic has multiple sheets then create corresponding subsheets on the root sheet
-    if( sheet_count > 1 )
-    {
-        int x, y, i;
-        i = 1;
-        x = 1;
-        y = 1;
+int SCH_EAGLE_PLUGIN::countNets( const wxString& aFileName )
+{
+    EAGLE_XML_READER reader;
+    int              sheetCount = 0;
+    bool             hasParts = false;
+    bool             hasLibraries = false;
 
-        while( sheetNode )
-        {
-            wxPoint                    pos = wxPoint( x * Mils2iu( 1000 ), y * Mils2iu( 1000 ) );
-            std::unique_ptr<SCH_SHEET> sheet( new SCH_SHEET( m_rootSheet, pos ) );
-            SCH_SCREEN*                screen = new SCH_SCREEN( m_schematic );
+    // If the attribute is found, store the Eagle version;
+    // otherwise, store the dummy "0.0" version.
+    reader.OnStart( "eagle",
+            [&]( const wxXmlNode& aEagle )
+            {
+                m_version = aEagle.GetAttribute( "version", "0.0" );
+            } );
 
-            sheet->SetScreen( screen );
-            sheet->GetScreen()->SetFileName( sheet->GetFileName() );
+    reader.OnStart( "eagle/drawing/schematic/parts/part",
+            [&]( const wxXmlNode& )
+            {
+                hasParts = true;
+            } );
 
-            m_currentSheet = sheet.get();
-            loadSheet( sheetNode, i );
-            m_rootSheet->GetScreen()->Append( sheet.release() );
+    reader.OnStart( "eagle/drawing/schematic/libraries/library",
+            [&]( const wxXmlNode& )
+            {
+                hasLibraries = true;
+            } );
 
-            sheetNode = sheetNode->GetNext();
-            x += 2;
+    // Loop through all the sheets
+    reader.OnStart( "eagle/drawing/schematic/sheets/sheet",
+            [&]( const wxXmlNode& )
+            {
+                sheetCount++;
+            } );
 
-            if( x > 10 ) // start next row
+    // Loop through all nets
+    // From the DTD: "Net is an electrical connection in a schematic."
+    reader.OnStart( "eagle/drawing/schematic/sheets/sheet/nets/net",
+            [&]( const wxXmlNode& aNet )
             {
-                x = 1;
-                y += 2;
-            }
+                m_netCounts[aNet.GetAttribute( "name" )]++;
+            } );
 
-            i++;
-        }
-    }
-    else
-    {
-        while( sheetNode )
-        {
-            m_currentSheet = m_rootSheet;
-            loadSheet( sheetNode, 0 );
-            sheetNode = sheetNode->GetNext();
-        }
-    }
+    reader.Parse( aFileName );
+
+    return hasParts && hasLibraries ? sheetCount : 0;
+}
 
 
+void SCH_EAGLE_PLUGIN::loadMissingUnits()
+{
     // Handle the missing component units that need to be instantiated
     // to create the missing implicit connections
 
@@ -129,13 +129,26 @@ public:
     //void SymbolLibOptions( PROPERTIES* aListToAppendTo ) const override;
 
 private:
-    void loadDrawing( wxXmlNode* aDrawingNode );
+    /**
+     * Reads the file as a stream, and loads its elements as they are read.
+     * @param aSheetCount is the number of sheets to load, as returned by countNets().
+     */
+    void loadDrawing( const wxString& aFileName, int aSheetCount );
     void loadLayerDefs( wxXmlNode* aLayers );
-    void loadSchematic( wxXmlNode* aSchematicNode );
     void loadSheet( wxXmlNode* aSheetNode, int sheetcount );
     void loadInstance( wxXmlNode* aInstanceNode );
     EAGLE_LIBRARY* loadLibrary( wxXmlNode* aLibraryNode, EAGLE_LIBRARY* aEagleLib );
-    void countNets( wxXmlNode* aSchematicNode );
+
+    /// Places the component units missing from the sheets, to create their implicit
+    /// connections.
+    void loadMissingUnits();
+
+    /**
+     * Reads the file, without loading it, to count the sheets on which each net appears and
+     * to read the Eagle version.
+     * @return the number of sheets to load: none if the schematic has no parts or libraries.
+     */
+    int countNets( const wxString& aFileName );
 
     /// Moves any labels on the wire to the new end point of the wire.
     void moveLabels( SCH_ITEM* aWire, const wxPoint& aNewEndPoint );
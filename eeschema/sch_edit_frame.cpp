@@ -593,7 +593,7 @@ void SCH_EDIT_FRAME::OnModify()
     GetScreen()->SetSave();
 
     if( ADVANCED_CFG::GetCfg().m_realTimeConnectivity && CONNECTION_GRAPH::m_allowRealTime )
-        RecalculateConnections( NO_CLEANUP );
+        RecalculateConnections( NO_CLEANUP, false );
 
     GetCanvas()->Refresh();
 }
@@ -1011,7 +1011,8 @@ void SCH_EDIT_FRAME::UpdateTitle()
 }
 
 
-void SCH_EDIT_FRAME::RecalculateConnections( SCH_CLEANUP_FLAGS aCleanupFlags )
+void SCH_EDIT_FRAME::RecalculateConnections( SCH_CLEANUP_FLAGS aCleanupFlags,
+                                             bool aUnconditional )
 {
     SCH_SHEET_LIST list = Schematic().GetSheets();
     PROF_COUNTER   timer;
@@ -1030,7 +1031,7 @@ void SCH_EDIT_FRAME::RecalculateConnections( SCH_CLEANUP_FLAGS aCleanupFlags )
     timer.Stop();
     wxLogTrace( "CONN_PROFILE", "SchematicCleanUp() %0.4f ms", timer.msecs() );
 
-    Schematic().ConnectionGraph()->Recalculate( list, true );
+    Schematic().ConnectionGraph()->Recalculate( list, aUnconditional );
 }
 
 
@@ -940,8 +940,11 @@ public:
 
     /**
      * Generates the connection data for the entire schematic hierarchy.
+     *
+     * @param aUnconditional is false to only update the links between the items of the
+     *                       screens which changed since the last update.
      */
-    void RecalculateConnections( SCH_CLEANUP_FLAGS aCleanupFlags );
+    void RecalculateConnections( SCH_CLEANUP_FLAGS aCleanupFlags, bool aUnconditional = true );
 
     /**
      * Allows Eeschema to install its preferences panels into the preferences dialog.
@@ -21,9 +21,12 @@
  */
 
 #include <algorithm>
+#include <atomic>
 #include <boost/algorithm/string/join.hpp>
 #include <cctype>
+#include <map>
 #include <set>
+#include <vector>
 
 #include <wx/mstream.h>
 #include <wx/filename.h>
@@ -474,7 +477,8 @@ static void parseQuotedString( wxString& aString, LINE_READER& aReader,
  */
 class SCH_LEGACY_PLUGIN_CACHE
 {
-    static int      m_modHash;      // Keep track of the modification status of the library.
+    static std::atomic<int> m_modHash;  // Keep track of the modification status of the library.
+                                        // (libraries are loaded concurrently)
 
     wxString        m_fileName;     // Absolute path and file name.
     wxFileName      m_libFileName;  // Absolute path and file name is required here.
@@ -486,6 +490,42 @@ class SCH_LEGACY_PLUGIN_CACHE
     int             m_versionMinor;
     int             m_libType;      // Is this cache a component or symbol library.
 
+    /// The text of a DEF/ENDDEF section, read by Load() to be parsed when one of its symbols
+    /// is needed.
+    struct SYMBOL_BLOCK
+    {
+        std::string           m_text;
+        int                   m_lineNumber;     ///< file line of the DEF line
+        std::vector<wxString> m_names;          ///< the root symbol, then its aliases
+    };
+
+    /// A symbol not parsed yet.
+    struct SYMBOL_INDEX
+    {
+        size_t m_block;
+        bool   m_isPower;
+    };
+
+    std::vector<SYMBOL_BLOCK> m_symbolBlocks;
+    std::map<wxString, SYMBOL_INDEX, LibPartMapSort> m_symbolIndex;   // Symbols not parsed yet.
+
+    /// The D, K and F lines of the old document file for the symbols not parsed yet.
+    typedef std::vector<std::pair<char, wxString>> SYMBOL_DOC;
+
+    std::map<wxString, SYMBOL_DOC> m_symbolDocs;
+
+    static void           applyDoc( LIB_PART* aSymbol, const SYMBOL_DOC& aDoc );
+
+    void                  indexSymbol( const wxString& aName, size_t aBlock, bool aIsPower );
+    void                  readSymbolBlock( FILE_LINE_READER& aReader );
+    void                  parseSymbolBlock( size_t aBlock );
+
+    /// Return the symbol \a aName, parsing it if needed, or NULL if there is no such symbol.
+    LIB_PART*             getSymbol( const wxString& aName );
+
+    /// Parse the symbols not parsed yet, before the whole map is used.
+    void                  parseAllSymbols();
+
     void                  loadHeader( FILE_LINE_READER& aReader );
     static void           loadAliases( std::unique_ptr<LIB_PART>& aPart, LINE_READER& aReader,
                                        LIB_PART_MAP* aMap = nullptr );
@@ -2395,7 +2435,7 @@ void SCH_LEGACY_PLUGIN::saveBusAlias( std::shared_ptr<BUS_ALIAS> aAlias )
 }
 
 
-int SCH_LEGACY_PLUGIN_CACHE::m_modHash = 1;     // starts at 1 and goes up
+std::atomic<int> SCH_LEGACY_PLUGIN_CACHE::m_modHash( 1 );     // starts at 1 and goes up
 
 
 SCH_LEGACY_PLUGIN_CACHE::SCH_LEGACY_PLUGIN_CACHE( const wxString& aFullPathAndFileName ) :
@@ -2479,6 +2519,8 @@ LIB_PART* SCH_LEGACY_PLUGIN_CACHE::removeSymbol( LIB_PART* aPart )
 {
     wxCHECK_MSG( aPart != NULL, NULL, "NULL pointer cannot be removed from library." );
 
+    parseAllSymbols();
+
     LIB_PART* firstChild = NULL;
     LIB_PART_MAP::iterator it = m_symbols.find( aPart->GetName() );
 
@@ -2544,6 +2586,8 @@ void SCH_LEGACY_PLUGIN_CACHE::AddSymbol( const LIB_PART* aPart )
 {
     // aPart is cloned in PART_LIB::AddPart().  The cache takes ownership of aPart.
     wxString name = aPart->GetName();
+
+    parseAllSymbols();
     LIB_PART_MAP::iterator it = m_symbols.find( name );
 
     if( it != m_symbols.end() )
@@ -2613,6 +2657,10 @@ void SCH_LEGACY_PLUGIN_CACHE::Load()
         m_libType = LIBRARY_TYPE_EESCHEMA;
     }
 
+    m_symbolIndex.clear();
+    m_symbolBlocks.clear();
+    m_symbolDocs.clear();
+
     while( reader.ReadLine() )
     {
         line = reader.Line();
@@ -2624,13 +2672,10 @@ void SCH_LEGACY_PLUGIN_CACHE::Load()
         if( m_libType == LIBRARY_TYPE_EESCHEMA && strCompare( "$HEADER", line ) )
             loadHeader( reader );
 
+        // Only the symbol names are read here.  A symbol is parsed when it is first asked
+        // for: a library with thousands of symbols costs little until its symbols are used.
         if( strCompare( "DEF", line ) )
-        {
-            // Read one DEF/ENDDEF part entry from library:
-            LIB_PART* part = LoadPart( reader, m_versionMajor, m_versionMinor, &m_symbols );
-
-            m_symbols[ part->GetName() ] = part;
-        }
+            readSymbolBlock( reader );
     }
 
     ++m_modHash;
@@ -2645,13 +2690,235 @@ void SCH_LEGACY_PLUGIN_CACHE::Load()
 }
 
 
+void SCH_LEGACY_PLUGIN_CACHE::indexSymbol( const wxString& aName, size_t aBlock, bool aIsPower )
+{
+    auto it = m_symbolIndex.find( aName );
+
+    // A later definition wins, as when the symbols were all loaded in file order.  Once
+    // its root symbol is replaced, a block is dropped: its aliases cannot be created.
+    if( it != m_symbolIndex.end() && it->second.m_block != aBlock )
+    {
+        SYMBOL_BLOCK& previous = m_symbolBlocks[it->second.m_block];
+
+        if( aName == previous.m_names[0] )
+        {
+            for( const wxString& name : previous.m_names )
+            {
+                auto prevIt = m_symbolIndex.find( name );
+
+                if( prevIt != m_symbolIndex.end() && prevIt->second.m_block == it->second.m_block )
+                    m_symbolIndex.erase( prevIt );
+            }
+        }
+    }
+
+    m_symbolIndex[aName] = { aBlock, aIsPower };
+    m_symbolBlocks[aBlock].m_names.push_back( aName );
+}
+
+
+void SCH_LEGACY_PLUGIN_CACHE::readSymbolBlock( FILE_LINE_READER& aReader )
+{
+    SYMBOL_BLOCK block;
+    size_t       blockIndex = m_symbolBlocks.size();
+    const char*  line = aReader.Line();
+    bool         inFootprintList = false;
+
+    block.m_lineNumber = aReader.LineNumber();
+    block.m_text = line;
+
+    // DEF name reference unused text_offset draw_pinnumber draw_pinname unit_count
+    //     units_locked option_flag
+    wxStringTokenizer tokens( wxString::FromUTF8( line ), " \r\n\t" );
+    std::vector<wxString> fields;
+
+    while( tokens.HasMoreTokens() )
+        fields.push_back( tokens.GetNextToken() );
+
+    if( fields.size() < 2 )
+        SCH_PARSE_ERROR( "invalid symbol definition", aReader, line );
+
+    // The name of the root symbol, as LoadPart() sets it
+    wxString name = fields[1];
+
+    if( name.IsEmpty() )
+        name = "~";
+    else if( name[0] == '~' )
+        name = name.Right( name.Length() - 1 );
+
+    // The symbols already parsed are kept, as their pointers may be in use.
+    bool skip = m_symbols.count( name ) > 0;
+
+    m_symbolBlocks.push_back( std::move( block ) );
+
+    if( !skip )
+        indexSymbol( name, blockIndex, fields.size() > 9 && fields[9] == "P" );
+
+    while( ( line = aReader.ReadLine() ) != nullptr )
+    {
+        m_symbolBlocks[blockIndex].m_text += line;
+
+        // The footprint filters may have any name
+        if( inFootprintList )
+        {
+            inFootprintList = !strCompare( "$ENDFPLIST", line );
+        }
+        else if( strCompare( "$FPLIST", line ) )
+        {
+            inFootprintList = true;
+        }
+        else if( strCompare( "ALIAS", line, &line ) )
+        {
+            // The aliases are not power symbols, whatever their root
+            wxStringTokenizer aliases( wxString::FromUTF8( line ), " \r\n\t" );
+
+            while( aliases.HasMoreTokens() )
+            {
+                wxString alias = aliases.GetNextToken();
+
+                if( !skip && !m_symbols.count( alias ) )
+                    indexSymbol( alias, blockIndex, false );
+            }
+        }
+        else if( strCompare( "ENDDEF", line ) )
+        {
+            return;
+        }
+    }
+
+    SCH_PARSE_ERROR( "missing ENDDEF", aReader, aReader.Line() );
+}
+
+
+/**
+ * Reads a symbol block, with the line numbers of the library file
+ */
+class LEGACY_SYMBOL_BLOCK_READER : public STRING_LINE_READER
+{
+public:
+    LEGACY_SYMBOL_BLOCK_READER( const std::string& aText, const wxString& aSource,
+                                int aLineNumber ) :
+            STRING_LINE_READER( aText, aSource )
+    {
+        m_lineNum = aLineNumber - 1;
+    }
+};
+
+
+void SCH_LEGACY_PLUGIN_CACHE::parseSymbolBlock( size_t aBlock )
+{
+    SYMBOL_BLOCK&                    block = m_symbolBlocks[aBlock];
+    std::map<wxString, SYMBOL_INDEX> owned;
+
+    // The names defined again later in the file are not this block's anymore
+    for( const wxString& name : block.m_names )
+    {
+        auto it = m_symbolIndex.find( name );
+
+        if( it != m_symbolIndex.end() && it->second.m_block == aBlock )
+        {
+            owned.insert( *it );
+            m_symbolIndex.erase( it );
+        }
+    }
+
+    LEGACY_SYMBOL_BLOCK_READER reader( block.m_text, m_libFileName.GetFullPath(),
+                                       block.m_lineNumber );
+    LIB_PART_MAP               parsed;
+
+    reader.ReadLine();
+
+    try
+    {
+        LIB_PART* part = LoadPart( reader, m_versionMajor, m_versionMinor, &parsed );
+
+        parsed[ part->GetName() ] = part;
+    }
+    catch( const IO_ERROR& )
+    {
+        for( auto& entry : parsed )
+            delete entry.second;
+
+        // Keep the symbols listed, the error is reported each time they are asked for
+        m_symbolIndex.insert( owned.begin(), owned.end() );
+        throw;
+    }
+
+    std::string().swap( block.m_text );
+
+    // The root symbol of a block is always its own: the block is dropped otherwise
+    for( auto& entry : parsed )
+    {
+        if( !owned.count( entry.first ) )
+        {
+            delete entry.second;
+            continue;
+        }
+
+        m_symbols[ entry.first ] = entry.second;
+
+        auto docIt = m_symbolDocs.find( entry.first );
+
+        if( docIt != m_symbolDocs.end() )
+        {
+            applyDoc( entry.second, docIt->second );
+            m_symbolDocs.erase( docIt );
+        }
+    }
+}
+
+
+void SCH_LEGACY_PLUGIN_CACHE::applyDoc( LIB_PART* aSymbol, const SYMBOL_DOC& aDoc )
+{
+    for( const std::pair<char, wxString>& line : aDoc )
+    {
+        switch( line.first )
+        {
+        case 'D': aSymbol->SetDescription( line.second );                 break;
+        case 'K': aSymbol->SetKeyWords( line.second );                    break;
+        case 'F': aSymbol->GetField( DATASHEET )->SetText( line.second ); break;
+        }
+    }
+}
+
+
+LIB_PART* SCH_LEGACY_PLUGIN_CACHE::getSymbol( const wxString& aName )
+{
+    LIB_PART_MAP::iterator it = m_symbols.find( aName );
+
+    if( it != m_symbols.end() )
+        return it->second;
+
+    auto indexIt = m_symbolIndex.find( aName );
+
+    if( indexIt == m_symbolIndex.end() )
+        return NULL;
+
+    parseSymbolBlock( indexIt->second.m_block );
+
+    it = m_symbols.find( aName );
+
+    return it != m_symbols.end() ? it->second : NULL;
+}
+
+
+void SCH_LEGACY_PLUGIN_CACHE::parseAllSymbols()
+{
+    while( !m_symbolIndex.empty() )
+        parseSymbolBlock( m_symbolIndex.begin()->second.m_block );
+
+    m_symbolBlocks.clear();
+    m_symbolDocs.clear();
+}
+
+
 void SCH_LEGACY_PLUGIN_CACHE::loadDocs()
 {
     const char* line;
     wxString    text;
     wxString    aliasName;
     wxFileName  fn = m_libFileName;
-    LIB_PART*   symbol = NULL;;
+    SYMBOL_DOC* symbol = NULL;
 
     fn.SetExt( DOC_EXT );
 
@@ -2688,14 +2955,13 @@ void SCH_LEGACY_PLUGIN_CACHE::loadDocs()
         aliasName.Trim();
         aliasName = LIB_ID::FixIllegalChars( aliasName, LIB_ID::ID_SCH );
 
-        LIB_PART_MAP::iterator it = m_symbols.find( aliasName );
-
-        if( it == m_symbols.end() )
+        // The documentation is kept until the symbol is parsed
+        if( !m_symbols.count( aliasName ) && !m_symbolIndex.count( aliasName ) )
             wxLogWarning( "Symbol '%s' not found in library:\n\n"
                           "'%s'\n\nat line %d offset %d", aliasName, fn.GetFullPath(),
                           reader.LineNumber(), (int) (line - reader.Line() ) );
         else
-            symbol = it->second;
+            symbol = &m_symbolDocs[aliasName];
 
         // Read the curent alias associated doc.
         // if the alias does not exist, just skip the description
@@ -2717,18 +2983,10 @@ void SCH_LEGACY_PLUGIN_CACHE::loadDocs()
             switch( line[0] )
             {
             case 'D':
-                if( symbol )
-                    symbol->SetDescription( text );
-                break;
-
             case 'K':
-                if( symbol )
-                    symbol->SetKeyWords( text );
-                break;
-
             case 'F':
                 if( symbol )
-                    symbol->GetField( DATASHEET )->SetText( text );
+                    symbol->emplace_back( line[0], text );
                 break;
 
             case 0:
@@ -2743,6 +3001,22 @@ void SCH_LEGACY_PLUGIN_CACHE::loadDocs()
             }
         }
     }
+
+    // The symbols already parsed get their documentation now
+    for( auto it = m_symbolDocs.begin(); it != m_symbolDocs.end(); )
+    {
+        LIB_PART_MAP::iterator symbolIt = m_symbols.find( it->first );
+
+        if( symbolIt != m_symbols.end() )
+        {
+            applyDoc( symbolIt->second, it->second );
+            it = m_symbolDocs.erase( it );
+        }
+        else
+        {
+            ++it;
+        }
+    }
 }
 
 
@@ -3761,6 +4035,8 @@ void SCH_LEGACY_PLUGIN_CACHE::Save( bool aSaveDocFile )
     if( !m_isModified )
         return;
 
+    parseAllSymbols();
+
     // Write through symlinks, don't replace them
     wxFileName fn = GetRealFile();
 
@@ -4290,6 +4566,8 @@ void SCH_LEGACY_PLUGIN_CACHE::saveDocFile()
 
 void SCH_LEGACY_PLUGIN_CACHE::DeleteSymbol( const wxString& aSymbolName )
 {
+    parseAllSymbols();
+
     LIB_PART_MAP::iterator it = m_symbols.find( aSymbolName );
 
     if( it == m_symbols.end() )
@@ -4392,13 +4670,23 @@ void SCH_LEGACY_PLUGIN::EnumerateSymbolLib( wxArrayString&    aSymbolNameList,
                               aProperties->find( SYMBOL_LIB_TABLE::PropPowerSymsOnly ) != aProperties->end() );
     cacheLib( aLibraryPath );
 
-    const LIB_PART_MAP& symbols = m_cache->m_symbols;
+    // The names of the symbols not parsed yet are merged in, without parsing them
+    std::set<wxString, LibPartMapSort> names;
 
-    for( LIB_PART_MAP::const_iterator it = symbols.begin();  it != symbols.end();  ++it )
+    for( const auto& symbol : m_cache->m_symbols )
     {
-        if( !powerSymbolsOnly || it->second->IsPower() )
-            aSymbolNameList.Add( it->first );
+        if( !powerSymbolsOnly || symbol.second->IsPower() )
+            names.insert( symbol.first );
+    }
+
+    for( const auto& index : m_cache->m_symbolIndex )
+    {
+        if( !powerSymbolsOnly || index.second.m_isPower )
+            names.insert( index.first );
     }
+
+    for( const wxString& name : names )
+        aSymbolNameList.Add( name );
 }
 
 
@@ -4414,6 +4702,24 @@ void SCH_LEGACY_PLUGIN::EnumerateSymbolLib( std::vector<LIB_PART*>& aSymbolList,
                               aProperties->find( SYMBOL_LIB_TABLE::PropPowerSymsOnly ) != aProperties->end() );
     cacheLib( aLibraryPath );
 
+    if( powerSymbolsOnly )
+    {
+        std::vector<wxString> powerSymbols;
+
+        for( const auto& index : m_cache->m_symbolIndex )
+        {
+            if( index.second.m_isPower )
+                powerSymbols.push_back( index.first );
+        }
+
+        for( const wxString& name : powerSymbols )
+            m_cache->getSymbol( name );
+    }
+    else
+    {
+        m_cache->parseAllSymbols();
+    }
+
     const LIB_PART_MAP& symbols = m_cache->m_symbols;
 
     for( LIB_PART_MAP::const_iterator it = symbols.begin();  it != symbols.end();  ++it )
@@ -4433,12 +4739,7 @@ LIB_PART* SCH_LEGACY_PLUGIN::LoadSymbol( const wxString& aLibraryPath, const wxS
 
     cacheLib( aLibraryPath );
 
-    LIB_PART_MAP::const_iterator it = m_cache->m_symbols.find( aSymbolName );
-
-    if( it == m_cache->m_symbols.end() )
-        return nullptr;
-
-    return it->second;
+    return m_cache->getSymbol( aSymbolName );
 }
 
 
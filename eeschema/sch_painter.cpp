@@ -153,7 +153,8 @@ static LIB_PART* dummy()
 
 SCH_PAINTER::SCH_PAINTER( GAL* aGal ) :
     KIGFX::PAINTER( aGal ),
-    m_schematic( nullptr )
+    m_schematic( nullptr ),
+    m_orientedPartsSweep( 64 )
 { }
 
 
@@ -1404,42 +1405,80 @@ static void orientPart( LIB_PART* part, int orientation )
 }
 
 
+LIB_PART* SCH_PAINTER::getOrientedPart( LIB_PART* aPart, int aOrientation )
+{
+    ORIENTED_PART& cached = m_orientedParts[ std::make_pair( aPart, aOrientation ) ];
+
+    // The part may have been freed, and a new part allocated at the same address
+    if( cached.m_part && cached.m_source.lock().get() != aPart )
+        cached.m_part.reset();
+
+    if( !cached.m_part )
+    {
+        cached.m_source = aPart->SharedPtr();
+        cached.m_part.reset( new LIB_PART( *aPart ) );
+
+        orientPart( cached.m_part.get(), aOrientation );
+    }
+
+    // Drop the copies of the freed parts once in a while
+    if( m_orientedParts.size() > 2 * m_orientedPartsSweep )
+    {
+        for( auto it = m_orientedParts.begin(); it != m_orientedParts.end(); )
+        {
+            if( it->second.m_source.expired() )
+                it = m_orientedParts.erase( it );
+            else
+                ++it;
+        }
+
+        m_orientedPartsSweep = std::max<size_t>( m_orientedParts.size(), 64 );
+    }
+
+    return cached.m_part.get();
+}
+
+
 void SCH_PAINTER::draw( SCH_COMPONENT *aComp, int aLayer )
 {
     // Use dummy part if the actual couldn't be found (or couldn't be locked).
     LIB_PART* originalPart = aComp->GetPartRef() ? aComp->GetPartRef().get() : dummy();
 
-    // Copy the source so we can re-orient and translate it.
-    LIB_PART tempPart( *originalPart );
+    // The re-oriented copy is kept in symbol coordinates, so only the flags are refreshed here
+    LIB_PART* orientedPart = getOrientedPart( originalPart, aComp->GetOrientation() );
 
-    tempPart.SetFlags( aComp->GetFlags() );
+    orientedPart->ClearFlags();
+    orientedPart->SetFlags( aComp->GetFlags() );
 
-    orientPart( &tempPart, aComp->GetOrientation() );
-
-    for( auto& tempItem : tempPart.GetDrawItems() )
+    for( auto& orientedItem : orientedPart->GetDrawItems() )
     {
-        tempItem.SetFlags( aComp->GetFlags() );     // SELECTED, HIGHLIGHTED, BRIGHTENED
-        tempItem.MoveTo( tempItem.GetPosition() + (wxPoint) mapCoords( aComp->GetPosition() ) );
+        orientedItem.ClearFlags();
+        orientedItem.SetFlags( aComp->GetFlags() );     // SELECTED, HIGHLIGHTED, BRIGHTENED
     }
 
-    // Copy the pin info from the component to the temp pins
-    LIB_PINS tempPins;
-    tempPart.GetPins( tempPins, aComp->GetUnit(), aComp->GetConvert() );
+    // Copy the pin info from the component to the oriented pins
+    LIB_PINS orientedPins;
+    orientedPart->GetPins( orientedPins, aComp->GetUnit(), aComp->GetConvert() );
     const SCH_PIN_PTRS compPins = aComp->GetSchPins();
 
-    for( unsigned i = 0; i < tempPins.size() && i < compPins.size(); ++ i )
+    for( unsigned i = 0; i < orientedPins.size() && i < compPins.size(); ++ i )
     {
-        LIB_PIN* tempPin = tempPins[ i ];
+        LIB_PIN* orientedPin = orientedPins[ i ];
         const SCH_PIN* compPin = compPins[ i ];
 
-        tempPin->ClearFlags();
-        tempPin->SetFlags( compPin->GetFlags() );     // SELECTED, HIGHLIGHTED, BRIGHTENED
+        orientedPin->ClearFlags();
+        orientedPin->SetFlags( compPin->GetFlags() );     // SELECTED, HIGHLIGHTED, BRIGHTENED
 
         if( compPin->IsDangling() )
-            tempPin->SetFlags( IS_DANGLING );
+            orientedPin->SetFlags( IS_DANGLING );
     }
 
-    draw( &tempPart, aLayer, false, aComp->GetUnit(), aComp->GetConvert() );
+    m_gal->Save();
+    m_gal->Translate( aComp->GetPosition() );
+
+    draw( orientedPart, aLayer, false, aComp->GetUnit(), aComp->GetConvert() );
+
+    m_gal->Restore();
 
     // The fields are SCH_COMPONENT-specific so don't need to be copied/oriented/translated
     for( SCH_FIELD& field : aComp->GetFields() )
@@ -25,6 +25,9 @@
 #ifndef __SCH_PAINTER_H
 #define __SCH_PAINTER_H
 
+#include <map>
+#include <memory>
+
 #include <sch_component.h>
 
 #include <painter.h>
@@ -173,6 +176,12 @@ private:
     void draw( SCH_LINE* aLine, int aLayer );
     void draw( SCH_BUS_ENTRY_BASE* aEntry, int aLayer );
 
+    /**
+     * @return a copy of \a aPart re-oriented for the given component orientation, in symbol
+     *         coordinates.  The copy is kept until \a aPart is freed.
+     */
+    LIB_PART* getOrientedPart( LIB_PART* aPart, int aOrientation );
+
     void drawPinDanglingSymbol( const VECTOR2I& aPos, bool aDrawingShadows );
     void drawDanglingSymbol( const wxPoint& aPos, bool aDrawingShadows );
 
@@ -199,6 +208,16 @@ private:
     SCH_RENDER_SETTINGS m_schSettings;
 
     SCHEMATIC* m_schematic;
+
+    struct ORIENTED_PART
+    {
+        PART_REF                  m_source;     ///< to tell a freed part from a new one
+        std::unique_ptr<LIB_PART> m_part;
+    };
+
+    /// The re-oriented copies of the component symbols, by symbol and orientation
+    std::map<std::pair<LIB_PART*, int>, ORIENTED_PART> m_orientedParts;
+    size_t                                            m_orientedPartsSweep;
 };
 
 }; // namespace KIGFX
@@ -35,6 +35,7 @@
 #include <sch_text.h>
 
 #include <map>
+#include <set>
 
 /**
  * SCH_REFERENCE
@@ -505,16 +506,13 @@ private:
 
     /**
      * Function CreateFirstFreeRefId
-     * searches for the first free reference number in \a aListId of reference numbers in use.
-     * This function just searches for a hole in a list of incremented numbers, this list must
-     * be sorted by increasing values and each value can be stored only once.  The new value
-     * is added to the list.
-     * @see BuildRefIdInUseList to prepare this list
-     * @param aIdList The buffer that contains the reference numbers in use.
+     * searches for the first free reference number in \a aIdsInUse, the reference numbers in
+     * use for a reference prefix.
+     * @param aIdsInUse The reference numbers in use (a number may be used by several units).
      * @param aFirstValue The first expected free value
-     * @return The first free (not yet used) value.
+     * @return The first free (not yet used) value, not smaller than \a aFirstValue.
      */
-    int CreateFirstFreeRefId( std::vector<int>& aIdList, int aFirstValue );
+    int CreateFirstFreeRefId( const std::multiset<int>& aIdsInUse, int aFirstValue );
 
     // Used for sorting static sortByTimeStamp function
     friend class BACK_ANNOTATE;
@@ -57,11 +57,11 @@
 #include <sch_text.h>
 #include <schematic.h>
 #include <symbol_lib_table.h>
+#include <thread_pool.h>
 #include <tool/common_tools.h>
 
-#include <thread>
 #include <algorithm>
-#include <future>
+#include <unordered_map>
 
 // TODO(JE) Debugging only
 #include <profile.h>
@@ -125,6 +125,7 @@ SCH_SCREEN::SCH_SCREEN( EDA_ITEM* aParent ) :
     m_paper( wxT( "A4" ) )
 {
     m_modification_sync = 0;
+    m_connectivityDirty = true;
 
     SetZoom( 32 );
 
@@ -163,6 +164,14 @@ SCHEMATIC* SCH_SCREEN::Schematic() const
 }
 
 
+void SCH_SCREEN::hierarchyChanged()
+{
+    // Not Schematic(): the screens of the clipboard and of the sheets being loaded have none
+    if( GetParent() && GetParent()->Type() == SCHEMATIC_T )
+        static_cast<SCHEMATIC*>( GetParent() )->HierarchyChanged();
+}
+
+
 void SCH_SCREEN::clearLibSymbols()
 {
     for( auto libSymbol : m_libSymbols )
@@ -243,11 +252,129 @@ void SCH_SCREEN::Append( SCH_ITEM* aItem )
         }
 
         m_rtree.insert( aItem );
+        indexItem( aItem );
         --m_modification_sync;
+        m_connectivityDirty = true;
+
+        if( aItem->Type() == SCH_SHEET_T )
+            hierarchyChanged();
     }
 }
 
 
+/**
+ * @return the field or pin of the symbol or sheet aParent with the KIID aID, or nullptr
+ */
+static SCH_ITEM* findChildItem( SCH_ITEM* aParent, const KIID& aID )
+{
+    if( aParent->Type() == SCH_COMPONENT_T )
+    {
+        SCH_COMPONENT* comp = static_cast<SCH_COMPONENT*>( aParent );
+
+        for( SCH_FIELD& field : comp->GetFields() )
+        {
+            if( field.m_Uuid == aID )
+                return &field;
+        }
+
+        for( SCH_PIN* pin : comp->GetSchPins() )
+        {
+            if( pin->m_Uuid == aID )
+                return pin;
+        }
+    }
+    else if( aParent->Type() == SCH_SHEET_T )
+    {
+        SCH_SHEET* sheet = static_cast<SCH_SHEET*>( aParent );
+
+        for( SCH_FIELD& field : sheet->GetFields() )
+        {
+            if( field.m_Uuid == aID )
+                return &field;
+        }
+
+        for( SCH_SHEET_PIN* pin : sheet->GetPins() )
+        {
+            if( pin->m_Uuid == aID )
+                return pin;
+        }
+    }
+
+    return nullptr;
+}
+
+
+void SCH_SCREEN::indexItem( SCH_ITEM* aItem )
+{
+    m_itemByIdCache[ aItem->m_Uuid ] = aItem;
+
+    if( aItem->Type() == SCH_COMPONENT_T )
+    {
+        SCH_COMPONENT* comp = static_cast<SCH_COMPONENT*>( aItem );
+
+        for( SCH_FIELD& field : comp->GetFields() )
+            m_parentIdCache[ field.m_Uuid ] = comp->m_Uuid;
+
+        for( SCH_PIN* pin : comp->GetSchPins() )
+            m_parentIdCache[ pin->m_Uuid ] = comp->m_Uuid;
+    }
+    else if( aItem->Type() == SCH_SHEET_T )
+    {
+        SCH_SHEET* sheet = static_cast<SCH_SHEET*>( aItem );
+
+        for( SCH_FIELD& field : sheet->GetFields() )
+            m_parentIdCache[ field.m_Uuid ] = sheet->m_Uuid;
+
+        for( SCH_SHEET_PIN* pin : sheet->GetPins() )
+            m_parentIdCache[ pin->m_Uuid ] = sheet->m_Uuid;
+    }
+}
+
+
+void SCH_SCREEN::unindexItem( SCH_ITEM* aItem )
+{
+    auto it = m_itemByIdCache.find( aItem->m_Uuid );
+
+    if( it != m_itemByIdCache.end() && it->second == aItem )
+    {
+        m_itemByIdCache.erase( it );
+    }
+    else
+    {
+        // The KIID of the item changed since it was appended: the index must not keep a
+        // pointer to it.  The fields and pins left in m_parentIdCache only refer to a KIID.
+        for( it = m_itemByIdCache.begin(); it != m_itemByIdCache.end(); )
+        {
+            if( it->second == aItem )
+                it = m_itemByIdCache.erase( it );
+            else
+                ++it;
+        }
+    }
+}
+
+
+SCH_ITEM* SCH_SCREEN::GetIndexedItem( const KIID& aID )
+{
+    auto it = m_itemByIdCache.find( aID );
+
+    if( it != m_itemByIdCache.end() && it->second->m_Uuid == aID )
+        return it->second;
+
+    auto parentIt = m_parentIdCache.find( aID );
+
+    if( parentIt != m_parentIdCache.end() )
+    {
+        it = m_itemByIdCache.find( parentIt->second );
+
+        if( it != m_itemByIdCache.end() )
+            return findChildItem( it->second, aID );
+    }
+
+    return nullptr;
+}
+
+
 void SCH_SCREEN::Append( SCH_SCREEN* aScreen )
 {
     wxCHECK_RET( aScreen, "Invalid screen object." );
@@ -271,8 +398,13 @@ void SCH_SCREEN::Clear( bool aFree )
     else
     {
         m_rtree.clear();
+        m_itemByIdCache.clear();
+        m_parentIdCache.clear();
     }
 
+    m_connectivityDirty = true;
+    hierarchyChanged();
+
     // Clear the project settings
     m_ScreenNumber = m_NumberOfScreens = 1;
 
@@ -293,6 +425,8 @@ void SCH_SCREEN::FreeDrawList()
             } );
 
     m_rtree.clear();
+    m_itemByIdCache.clear();
+    m_parentIdCache.clear();
 
     for( auto item : delete_list )
         delete item;
@@ -310,6 +444,15 @@ bool SCH_SCREEN::Remove( SCH_ITEM* aItem )
 {
     bool retv = m_rtree.remove( aItem );
 
+    if( retv )
+    {
+        unindexItem( aItem );
+        m_connectivityDirty = true;
+
+        if( aItem->Type() == SCH_SHEET_T )
+            hierarchyChanged();
+    }
+
     // Check if the library symbol for the removed schematic symbol is still required.
     if( retv && aItem->Type() == SCH_COMPONENT_T )
     {
@@ -350,6 +493,7 @@ void SCH_SCREEN::DeleteItem( SCH_ITEM* aItem )
 
     SetModify();
     Remove( aItem );
+    m_connectivityDirty = true;
 
     if( aItem->Type() == SCH_SHEET_PIN_T )
     {
@@ -590,6 +734,14 @@ bool SCH_SCREEN::IsTerminalPoint( const wxPoint& aPosition, int aLayer )
 
 
 void SCH_SCREEN::UpdateSymbolLinks( REPORTER* aReporter )
+{
+    RESOLVED_SYMBOLS resolvedSymbols;
+
+    UpdateSymbolLinks( aReporter, resolvedSymbols );
+}
+
+
+void SCH_SCREEN::UpdateSymbolLinks( REPORTER* aReporter, RESOLVED_SYMBOLS& aResolvedSymbols )
 {
     wxCHECK_RET( Schematic(), "Cannot call SCH_SCREEN::UpdateSymbolLinks with no SCHEMATIC" );
 
@@ -665,52 +817,67 @@ void SCH_SCREEN::UpdateSymbolLinks( REPORTER* aReporter )
             continue;
         }
 
-        if( libs->HasLibrary( symbol->GetLibId().GetLibNickname() ) )
+        // Symbols used by several components, in this screen or in the other ones, are
+        // only loaded and flattened once
+        const wxString libId = symbol->GetLibId().Format().wx_str();
+        auto resolved = aResolvedSymbols.find( libId );
+
+        if( resolved == aResolvedSymbols.end() )
         {
-            try
+            if( libs->HasLibrary( symbol->GetLibId().GetLibNickname() ) )
             {
-                tmp = libs->LoadSymbol( symbol->GetLibId() );
+                try
+                {
+                    tmp = libs->LoadSymbol( symbol->GetLibId() );
+                }
+                catch( const IO_ERROR& ioe )
+                {
+                    msg.Printf( _( "I/O error %s resolving library symbol %s" ), ioe.What(),
+                                symbol->GetLibId().Format().wx_str() );
+                    aReporter->ReportTail( msg, RPT_SEVERITY_ERROR );
+                }
             }
-            catch( const IO_ERROR& ioe )
+
+            if( !tmp && legacyLibs )
             {
-                msg.Printf( _( "I/O error %s resolving library symbol %s" ), ioe.What(),
-                            symbol->GetLibId().Format().wx_str() );
-                aReporter->ReportTail( msg, RPT_SEVERITY_ERROR );
-            }
-        }
+                // If here, only the cache library should be loaded if the loaded schematic
+                // is the legacy file format.
+                wxCHECK2( legacyLibs->GetLibraryCount() == 1, continue );
 
-        if( !tmp && legacyLibs )
-        {
-            // If here, only the cache library should be loaded if the loaded schematic
-            // is the legacy file format.
-            wxCHECK2( legacyLibs->GetLibraryCount() == 1, continue );
+                PART_LIB& legacyCacheLib = legacyLibs->at( 0 );
 
-            PART_LIB& legacyCacheLib = legacyLibs->at( 0 );
+                // ...and it better be the cache library.
+                wxCHECK2( legacyCacheLib.IsCache(), continue );
 
-            // ...and it better be the cache library.
-            wxCHECK2( legacyCacheLib.IsCache(), continue );
+                wxString id = symbol->GetLibId().Format();
 
-            wxString id = symbol->GetLibId().Format();
+                id.Replace( ':', '_' );
 
-            id.Replace( ':', '_' );
+                if( aReporter )
+                {
+                    msg.Printf( _( "Falling back to cache to set symbol '%s:%s' link '%s'." ),
+                                symbol->GetField( REFERENCE )->GetText(),
+                                symbol->GetField( VALUE )->GetText(),
+                                id );
+                    aReporter->ReportTail( msg, RPT_SEVERITY_WARNING );
+                }
 
-            if( aReporter )
+                tmp = legacyCacheLib.FindPart( id );
+            }
+
+            // We want a full symbol not just the top level child symbol.
+            if( tmp )
             {
-                msg.Printf( _( "Falling back to cache to set symbol '%s:%s' link '%s'." ),
-                            symbol->GetField( REFERENCE )->GetText(),
-                            symbol->GetField( VALUE )->GetText(),
-                            id );
-                aReporter->ReportTail( msg, RPT_SEVERITY_WARNING );
+                libSymbol = tmp->Flatten();
+                libSymbol->SetParent();
             }
 
-            tmp = legacyCacheLib.FindPart( id );
+            resolved = aResolvedSymbols.emplace( libId, std::move( libSymbol ) ).first;
         }
 
-        if( tmp )
+        if( resolved->second )
         {
-            // We want a full symbol not just the top level child symbol.
-            libSymbol = tmp->Flatten();
-            libSymbol->SetParent();
+            libSymbol = std::make_unique<LIB_PART>( *resolved->second );
 
             m_libSymbols.insert( { symbol->GetSchSymbolLibraryName(),
                                    new LIB_PART( *libSymbol.get() ) } );
@@ -960,7 +1127,7 @@ size_t SCH_SCREEN::CountConnectedItems( const wxPoint& aPos, bool aTestJunctions
 {
     size_t count = 0;
 
-    for( SCH_ITEM* item : Items() )
+    for( SCH_ITEM* item : Items().Overlapping( aPos ) )
     {
         if( ( item->Type() != SCH_JUNCTION_T || aTestJunctions ) && item->IsConnected( aPos ) )
             count++;
@@ -1055,7 +1222,8 @@ void SCH_SCREEN::GetSheets( std::vector<SCH_ITEM*>* aItems )
 }
 
 
-bool SCH_SCREEN::TestDanglingEnds( const SCH_SHEET_PATH* aPath )
+bool SCH_SCREEN::TestDanglingEnds( const SCH_SHEET_PATH* aPath,
+                                   std::function<void( SCH_ITEM* )>* aChangedHandler )
 {
     std::vector< DANGLING_END_ITEM > endPoints;
     bool hasStateChanged = false;
@@ -1063,10 +1231,92 @@ bool SCH_SCREEN::TestDanglingEnds( const SCH_SHEET_PATH* aPath )
     for( SCH_ITEM* item : Items() )
         item->GetEndPoints( endPoints );
 
+    // Index the end points by position, and the wire and bus segments (a start end point
+    // followed by its end) by bounding box.  The accuracy of the label hit test is 1.
+    std::unordered_map<wxPoint, std::vector<size_t>> pointIndex;
+    RTree<size_t, int, 2>                            segmentIndex;
+
+    auto isSegmentStart =
+            [&]( size_t aIdx ) -> bool
+            {
+                DANGLING_END_T type = endPoints[aIdx].GetType();
+
+                return ( type == WIRE_START_END || type == BUS_START_END )
+                       && aIdx + 1 < endPoints.size();
+            };
+
+    for( size_t ii = 0; ii < endPoints.size(); ++ii )
+    {
+        pointIndex[ endPoints[ii].GetPosition() ].push_back( ii );
+
+        if( isSegmentStart( ii ) )
+        {
+            const wxPoint& a = endPoints[ii].GetPosition();
+            const wxPoint& b = endPoints[ii + 1].GetPosition();
+            int            min[2] = { std::min( a.x, b.x ) - 1, std::min( a.y, b.y ) - 1 };
+            int            max[2] = { std::max( a.x, b.x ) + 1, std::max( a.y, b.y ) + 1 };
+
+            segmentIndex.Insert( min, max, ii );
+        }
+    }
+
+    std::vector<DANGLING_END_ITEM> itemEnds;
+    std::vector<size_t>            nearIds;
+    std::vector<DANGLING_END_ITEM> nearEnds;
+
     for( SCH_ITEM* item : Items() )
     {
-        if( item->UpdateDanglingState( endPoints, aPath ) )
+        itemEnds.clear();
+        nearIds.clear();
+        nearEnds.clear();
+
+        item->GetEndPoints( itemEnds );
+
+        for( const DANGLING_END_ITEM& itemEnd : itemEnds )
+        {
+            wxPoint pos = itemEnd.GetPosition();
+            auto    it = pointIndex.find( pos );
+
+            if( it != pointIndex.end() )
+            {
+                for( size_t id : it->second )
+                {
+                    nearIds.push_back( id );
+
+                    // The segments are always passed whole
+                    if( isSegmentStart( id ) )
+                        nearIds.push_back( id + 1 );
+                    else if( id > 0 && isSegmentStart( id - 1 ) )
+                        nearIds.push_back( id - 1 );
+                }
+            }
+
+            int pt[2] = { pos.x, pos.y };
+
+            segmentIndex.Search( pt, pt,
+                    [&]( const size_t& aId ) -> bool
+                    {
+                        nearIds.push_back( aId );
+                        nearIds.push_back( aId + 1 );
+                        return true;
+                    } );
+        }
+
+        // The states of some items depend on the order of the end points: keep the order of
+        // the whole list
+        std::sort( nearIds.begin(), nearIds.end() );
+        nearIds.erase( std::unique( nearIds.begin(), nearIds.end() ), nearIds.end() );
+
+        for( size_t id : nearIds )
+            nearEnds.push_back( endPoints[id] );
+
+        if( item->UpdateDanglingState( nearEnds, aPath ) )
+        {
             hasStateChanged = true;
+
+            if( aChangedHandler )
+                ( *aChangedHandler )( item );
+        }
     }
 
     return hasStateChanged;
@@ -1079,11 +1329,8 @@ SCH_LINE* SCH_SCREEN::GetLine( const wxPoint& aPosition, int aAccuracy, int aLay
     // an accuracy of 0 had problems with rounding errors; use at least 1
     aAccuracy = std::max( aAccuracy, 1 );
 
-    for( SCH_ITEM* item : Items() )
+    for( SCH_ITEM* item : Items().Overlapping( SCH_LINE_T, aPosition, aAccuracy ) )
     {
-        if( item->Type() != SCH_LINE_T )
-            continue;
-
         if( item->GetLayer() != aLayer )
             continue;
 
@@ -1430,8 +1677,10 @@ void SCH_SCREENS::DeleteAllMarkers( enum MARKER_BASE::TYPEMARKER aMarkerType )
 
 void SCH_SCREENS::UpdateSymbolLinks( REPORTER* aReporter )
 {
+    SCH_SCREEN::RESOLVED_SYMBOLS resolvedSymbols;
+
     for( SCH_SCREEN* screen = GetFirst(); screen; screen = GetNext() )
-        screen->UpdateSymbolLinks( aReporter );
+        screen->UpdateSymbolLinks( aReporter, resolvedSymbols );
 
     SCH_SCREEN* first = GetFirst();
 
@@ -1457,31 +1706,11 @@ void SCH_SCREENS::TestDanglingEnds()
     for( SCH_SCREEN* screen = GetFirst(); screen; screen = GetNext() )
         screens.push_back( screen );
 
-    size_t parallelThreadCount = std::min<size_t>( std::thread::hardware_concurrency(),
-            screens.size() );
-
-    std::atomic<size_t> nextScreen( 0 );
-    std::vector<std::future<size_t>> returns( parallelThreadCount );
-
-    auto update_lambda = [&screens, &nextScreen]() -> size_t
-    {
-        for( auto i = nextScreen++; i < screens.size(); i = nextScreen++ )
-            screens[i]->TestDanglingEnds();
-
-        return 1;
-    };
-
-    if( parallelThreadCount == 1 )
-        update_lambda();
-    else
-    {
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-            returns[ii] = std::async( std::launch::async, update_lambda );
-
-        // Finalize the threads
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-            returns[ii].wait();
-    }
+    THREAD_POOL::GetInstance().ParallelFor( screens.size(),
+            [&screens]( size_t i )
+            {
+                screens[i]->TestDanglingEnds();
+            } );
 }
 
 
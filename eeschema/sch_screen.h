@@ -25,8 +25,10 @@
 #ifndef SCREEN_H
 #define SCREEN_H
 
+#include <functional>
 #include <memory>
 #include <stddef.h>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 #include <wx/arrstr.h>
@@ -117,9 +119,18 @@ private:
 
     EE_RTREE m_rtree;
 
+    /// The items of m_rtree by their KIID, to find them without searching the screen
+    std::unordered_map<KIID, SCH_ITEM*> m_itemByIdCache;
+
+    /// The KIID of the symbol or sheet of the fields and pins, by their KIID
+    std::unordered_map<KIID, KIID>      m_parentIdCache;
+
     int m_modification_sync; ///< inequality with PART_LIBS::GetModificationHash()
                              ///< will trigger ResolveAll().
 
+    bool m_connectivityDirty;   ///< Items were added or removed since the last connectivity
+                                ///< update
+
     /// List of bus aliases stored in this screen
     std::unordered_set< std::shared_ptr< BUS_ALIAS > > m_aliases;
 
@@ -148,6 +159,12 @@ private:
 
     void clearLibSymbols();
 
+    void indexItem( SCH_ITEM* aItem );
+    void unindexItem( SCH_ITEM* aItem );
+
+    /// Calls SCHEMATIC::HierarchyChanged() when a sheet is added or removed
+    void hierarchyChanged();
+
 public:
 
     /**
@@ -257,6 +274,17 @@ public:
     SCH_ITEM* GetItem(
             const wxPoint& aPosition, int aAccuracy = 0, KICAD_T aType = SCH_LOCATE_ANY_T );
 
+    /**
+     * Find an item of the screen, or a field or pin of one of its symbols or sheets, by its
+     * KIID through the index of the items appended to the screen.
+     *
+     * The fields and pins are indexed when their symbol or sheet is appended: the ones created
+     * later are not found (SCH_SHEET_LIST::GetItem() searches the screens for them).
+     *
+     * @return the item, or nullptr if not found
+     */
+    SCH_ITEM* GetIndexedItem( const KIID& aID );
+
     void Place( SCH_EDIT_FRAME* frame, wxDC* DC ) { };
 
     /**
@@ -276,6 +304,19 @@ public:
      */
     void UpdateSymbolLinks( REPORTER* aReporter = nullptr );
 
+    /// The flattened library symbols resolved by #UpdateSymbolLinks, by #LIB_ID.  A nullptr
+    /// entry is a #LIB_ID that could not be resolved.
+    typedef std::map<wxString, std::unique_ptr<LIB_PART>> RESOLVED_SYMBOLS;
+
+    /**
+     * Same as #UpdateSymbolLinks( REPORTER* ), each distinct #LIB_ID being resolved only once
+     * for all the screens given the same \a aResolvedSymbols.
+     *
+     * @param aReporter Optional #REPORTER object to write status and error messages into.
+     * @param aResolvedSymbols the library symbols already resolved, updated by this call.
+     */
+    void UpdateSymbolLinks( REPORTER* aReporter, RESOLVED_SYMBOLS& aResolvedSymbols );
+
     /**
      * Initialize the #LIB_PART reference for each #SCH_COMPONENT found in this schematic
      * with the local project library symbols
@@ -328,12 +369,26 @@ public:
 
     bool CheckIfOnDrawList( SCH_ITEM* st );
 
+    /**
+     * @return true if items were added to or removed from the screen since the connectivity
+     *         of its items was last updated (the changed items are flagged themselves).
+     */
+    bool IsConnectivityDirty() const { return m_connectivityDirty; }
+
+    void SetConnectivityDirty( bool aDirty = true ) { m_connectivityDirty = aDirty; }
+
     /**
      * Test all of the connectable objects in the schematic for unused connection points.
+     *
+     * Each item is only tested against the end points at its own connection points, and the
+     * wires and buses passing through them.
+     *
      * @param aPath is a sheet path to pass to UpdateDanglingState if desired
+     * @param aChangedHandler is an optional callback for the items whose state changed
      * @return True if any connection state changes were made.
      */
-    bool TestDanglingEnds( const SCH_SHEET_PATH* aPath = nullptr );
+    bool TestDanglingEnds( const SCH_SHEET_PATH* aPath = nullptr,
+                           std::function<void( SCH_ITEM* )>* aChangedHandler = nullptr );
 
     /**
      * Return all wires and junctions connected to \a aSegment which are not connected any
@@ -24,6 +24,9 @@
  * @brief Schematic and symbol library s-expression file format parser implementations.
  */
 
+#include <cctype>
+#include <cstring>
+
 // For some reason wxWidgets is built with wxUSE_BASE64 unset so expose the wxWidgets
 // base64 code.
 #define wxUSE_BASE64 1
@@ -32,6 +35,7 @@
 #include <wx/tokenzr.h>
 
 #include <common.h>
+#include <kicad_string.h>
 #include <lib_id.h>
 #include <plotter.h>
 
@@ -105,6 +109,214 @@ void SCH_SEXPR_PARSER::ParseLib( LIB_PART_MAP& aSymbolLibMap )
 }
 
 
+/**
+ * Reads a symbol block, with the line numbers of the library file
+ */
+class SYMBOL_BLOCK_READER : public STRING_LINE_READER
+{
+public:
+    SYMBOL_BLOCK_READER( const std::string& aText, const wxString& aSource, int aLineNumber ) :
+            STRING_LINE_READER( aText, aSource )
+    {
+        m_lineNum = aLineNumber - 1;
+    }
+};
+
+
+/**
+ * Reads the token at \a aCur, unquoting it as NextTok() does
+ */
+static std::string readBlockToken( const char* aCur, const char* aLimit )
+{
+    std::string token;
+
+    while( aCur < aLimit && isspace( (unsigned char) *aCur ) )
+        ++aCur;
+
+    if( aCur < aLimit && *aCur == '"' )
+    {
+        for( ++aCur; aCur < aLimit && *aCur != '"'; ++aCur )
+        {
+            if( *aCur == '\\' && aCur + 1 < aLimit )
+            {
+                ++aCur;
+
+                switch( *aCur )
+                {
+                case 'n': token += '\n'; break;
+                case 'r': token += '\r'; break;
+                default:  token += *aCur; break;
+                }
+            }
+            else
+            {
+                token += *aCur;
+            }
+        }
+    }
+    else
+    {
+        for( ; aCur < aLimit && !isspace( (unsigned char) *aCur ) && *aCur != ')'; ++aCur )
+            token += *aCur;
+    }
+
+    return token;
+}
+
+
+/**
+ * Finds the (power) and (extends "parent") lists at the top level of a symbol block
+ */
+static void scanSymbolBlock( LIB_SYMBOL_BLOCK& aBlock )
+{
+    const char* cur = aBlock.m_text.data();
+    const char* limit = cur + aBlock.m_text.size();
+    int         depth = 0;
+    bool        inString = false;
+    bool        lineStart = true;
+
+    aBlock.m_isPower = false;
+
+    for( ; cur < limit; ++cur )
+    {
+        if( inString )
+        {
+            if( *cur == '\\' && cur + 1 < limit )
+                ++cur;
+            else if( *cur == '"' )
+                inString = false;
+
+            continue;
+        }
+
+        if( *cur == '\n' )
+        {
+            lineStart = true;
+            continue;
+        }
+
+        if( lineStart && *cur == '#' )
+        {
+            while( cur + 1 < limit && cur[1] != '\n' )
+                ++cur;
+
+            continue;
+        }
+
+        if( !isspace( (unsigned char) *cur ) )
+            lineStart = false;
+
+        if( *cur == '"' )
+        {
+            inString = true;
+        }
+        else if( *cur == ')' )
+        {
+            --depth;
+        }
+        else if( *cur == '(' && ++depth == 2 )
+        {
+            auto isKeyword =
+                    [&]( const char* aKeyword, size_t aLength )
+                    {
+                        return limit - cur > (ptrdiff_t) aLength
+                               && strncmp( cur + 1, aKeyword, aLength ) == 0
+                               && ( isspace( (unsigned char) cur[aLength + 1] )
+                                    || cur[aLength + 1] == ')' );
+                    };
+
+            if( isKeyword( "power", 5 ) )
+                aBlock.m_isPower = true;
+            else if( isKeyword( "extends", 7 ) )
+                aBlock.m_parentName = FROM_UTF8( readBlockToken( cur + 8, limit ).c_str() );
+        }
+    }
+}
+
+
+void SCH_SEXPR_PARSER::ParseLibIndex( LIB_SYMBOL_BLOCK_MAP& aBlocks )
+{
+    T token;
+
+    NeedLEFT();
+    NextTok();
+    parseHeader( T_kicad_symbol_lib, SEXPR_SYMBOL_LIB_FILE_VERSION );
+
+    for( token = NextTok();  token != T_RIGHT;  token = NextTok() )
+    {
+        if( token != T_LEFT )
+            Expecting( T_LEFT );
+
+        token = NextTok();
+
+        if( token != T_symbol )
+            Expecting( "symbol" );
+
+        LIB_SYMBOL_BLOCK block;
+
+        block.m_lineNumber = CurLineNumber();
+        block.m_fileVersion = m_requiredVersion;
+
+        token = NextTok();
+
+        if( !IsSymbol( token ) )
+        {
+            wxString error;
+
+            error.Printf( _( "Invalid symbol name in\nfile: \"%s\"\nline: %d\noffset: %d" ),
+                          CurSource().c_str(), CurLineNumber(), CurOffset() );
+            THROW_IO_ERROR( error );
+        }
+
+        wxString name = FromUTF8();
+        LIB_ID   id;
+
+        // The symbol name is quoted again in the block, as the file has it
+        block.m_text = "(symbol \"";
+
+        for( char c : CurStr() )
+        {
+            switch( c )
+            {
+            case '\n': block.m_text += "\\n";  break;
+            case '\r': block.m_text += "\\r";  break;
+            case '\\': block.m_text += "\\\\"; break;
+            case '"':  block.m_text += "\\\""; break;
+            default:   block.m_text += c;      break;
+            }
+        }
+
+        block.m_text += '"';
+        readListText( block.m_text );
+        scanSymbolBlock( block );
+
+        if( id.Parse( name, LIB_ID::ID_SCH ) < 0 )
+            name = id.GetLibItemName().wx_str();
+
+        aBlocks[name] = std::move( block );
+    }
+}
+
+
+LIB_PART* SCH_SEXPR_PARSER::ParseSymbolBlock( const LIB_SYMBOL_BLOCK& aBlock,
+                                              const wxString& aSource,
+                                              LIB_PART_MAP& aSymbolLibMap )
+{
+    SYMBOL_BLOCK_READER reader( aBlock.m_text, aSource, aBlock.m_lineNumber );
+    SCH_SEXPR_PARSER    parser( &reader );
+
+    parser.NeedLEFT();
+
+    if( parser.NextTok() != T_symbol )
+        parser.Expecting( T_symbol );
+
+    parser.m_unit = 1;
+    parser.m_convert = 1;
+
+    return parser.ParseSymbol( aSymbolLibMap, aBlock.m_fileVersion );
+}
+
+
 LIB_PART* SCH_SEXPR_PARSER::ParseSymbol( LIB_PART_MAP& aSymbolLibMap, int aFileVersion )
 {
     wxCHECK_MSG( CurTok() == T_symbol, nullptr,
@@ -371,11 +583,16 @@ LIB_ITEM* SCH_SEXPR_PARSER::ParseDrawItem()
 
 double SCH_SEXPR_PARSER::parseDouble()
 {
-    char* tmp;
+    char*  tmp;
+    double fval;
+
+    // Most numbers are plain decimals, converted without strtod()
+    if( ParseDecimal( CurText(), &fval ) )
+        return fval;
 
     errno = 0;
 
-    double fval = strtod( CurText(), &tmp );
+    fval = strtod( CurText(), &tmp );
 
     if( errno )
     {
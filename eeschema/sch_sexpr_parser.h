@@ -94,6 +94,24 @@ public:
 };
 
 
+/**
+ * The text of a library symbol, read by SCH_SEXPR_PARSER::ParseLibIndex() to be parsed
+ * the first time the symbol is needed.
+ */
+struct LIB_SYMBOL_BLOCK
+{
+    std::string m_text;
+    int         m_lineNumber;   ///< file line of the block start
+    int         m_fileVersion;  ///< version of the library file
+    wxString    m_parentName;   ///< name of the symbol this one extends, if any
+    bool        m_isPower;
+};
+
+
+/// Symbol blocks by symbol name, in the order of a #LIB_PART_MAP
+typedef std::map< wxString, LIB_SYMBOL_BLOCK, LibPartMapSort > LIB_SYMBOL_BLOCK_MAP;
+
+
 /**
  * Object to parser s-expression symbol library and schematic file formats.
  */
@@ -223,6 +241,26 @@ public:
 
     void ParseLib( LIB_PART_MAP& aSymbolLibMap );
 
+    /**
+     * Read the symbols of a library file without parsing them.
+     *
+     * Only the name, the (power) flag and the (extends) parent of each symbol are read.  The
+     * text of the symbol is kept in \a aBlocks, to be parsed by ParseSymbolBlock() when the
+     * symbol is needed.
+     */
+    void ParseLibIndex( LIB_SYMBOL_BLOCK_MAP& aBlocks );
+
+    /**
+     * Parse a symbol read by ParseLibIndex().
+     *
+     * @param aBlock is the symbol text.
+     * @param aSource is the library file name, for the error messages.
+     * @param aSymbolLibMap holds the symbol \a aBlock extends, if any.
+     * @throw IO_ERROR if the symbol cannot be parsed.
+     */
+    static LIB_PART* ParseSymbolBlock( const LIB_SYMBOL_BLOCK& aBlock, const wxString& aSource,
+                                       LIB_PART_MAP& aSymbolLibMap );
+
     LIB_PART* ParseSymbol( LIB_PART_MAP& aSymbolLibMap,
                            int aFileVersion = SEXPR_SYMBOL_LIB_FILE_VERSION );
 
@@ -20,8 +20,12 @@
  */
 
 #include <algorithm>
+#include <atomic>
 #include <boost/algorithm/string/join.hpp>
 #include <cctype>
+#include <exception>
+#include <set>
+#include <vector>
 
 // For some reason wxWidgets is built with wxUSE_BASE64 unset so expose the wxWidgets
 // base64 code.
@@ -31,6 +35,7 @@
 #include <wx/filename.h>
 #include <wx/tokenzr.h>
 
+#include <advanced_config.h>
 #include <build_version.h>
 #include <gal/color4d.h>
 #include <pgm_base.h>
@@ -38,6 +43,7 @@
 #include <kiway.h>
 #include <kicad_string.h>
 #include <richio.h>
+#include <thread_pool.h>
 #include <core/typeinfo.h>
 #include <plotter.h>               // PLOT_DASH_TYPE
 #include <properties.h>
@@ -319,12 +325,14 @@ static void formatStroke( OUTPUTFORMATTER* aFormatter, int aNestLevel, int aWidt
  */
 class SCH_SEXPR_PLUGIN_CACHE
 {
-    static int      m_modHash;      // Keep track of the modification status of the library.
+    static std::atomic<int> m_modHash;  // Keep track of the modification status of the library.
+                                        // (libraries are loaded concurrently)
 
     wxString        m_fileName;     // Absolute path and file name.
     wxFileName      m_libFileName;  // Absolute path and file name is required here.
     wxDateTime      m_fileModTime;
     LIB_PART_MAP    m_symbols;      // Map of names of #LIB_PART pointers.
+    LIB_SYMBOL_BLOCK_MAP m_symbolBlocks;    // The symbols of the file not parsed yet.
     bool            m_isWritable;
     bool            m_isModified;
     int             m_versionMajor;
@@ -335,6 +343,12 @@ class SCH_SEXPR_PLUGIN_CACHE
                                    const char** aOutput );
     LIB_PART*       removeSymbol( LIB_PART* aAlias );
 
+    /// Return the symbol \a aName, parsing it if needed, or NULL if there is no such symbol.
+    LIB_PART*       getSymbol( const wxString& aName );
+
+    /// Parse the symbols not parsed yet, before the whole map is used.
+    void            parseAllSymbols();
+
     static void     saveSymbolDrawItem( LIB_ITEM* aItem, OUTPUTFORMATTER& aFormatter,
                                         int aNestLevel );
     static void     saveArc( LIB_ARC* aArc, OUTPUTFORMATTER& aFormatter, int aNestLevel = 0 );
@@ -487,81 +501,119 @@ SCH_SHEET* SCH_SEXPR_PLUGIN::Load( const wxString& aFileName, SCHEMATIC* aSchema
 }
 
 
-// Everything below this comment is recursive.  Modify with care.
-
 void SCH_SEXPR_PLUGIN::loadHierarchy( SCH_SHEET* aSheet )
 {
-    SCH_SCREEN* screen = NULL;
+    // The sheets without a screen, with the path their file name is relative to.  The files
+    // of one level of the hierarchy are parsed together, and their sub-sheets make the next
+    // level.
+    std::vector<std::pair<SCH_SHEET*, wxString>> pending;
 
     if( !aSheet->GetScreen() )
+        pending.emplace_back( aSheet, m_currentPath.top() );
+
+    while( !pending.empty() )
     {
-        // SCH_SCREEN objects store the full path and file name where the SCH_SHEET object only
-        // stores the file name and extension.  Add the project path to the file name and
-        // extension to compare when calling SCH_SHEET::SearchHierarchy().
-        wxFileName fileName = aSheet->GetFileName();
+        std::vector<SCH_SHEET*> toLoad;
 
-        if( !fileName.IsAbsolute() )
-            fileName.MakeAbsolute( m_currentPath.top() );
+        for( const std::pair<SCH_SHEET*, wxString>& entry : pending )
+        {
+            SCH_SHEET*  sheet = entry.first;
+            SCH_SCREEN* screen = NULL;
 
-        // Save the current path so that it gets restored when decending and ascending the
-        // sheet hierarchy which allows for sheet schematic files to be nested in folders
-        // relative to the last path a schematic was loaded from.
-        wxLogTrace( traceSchLegacyPlugin, "Saving path    \"%s\"", m_currentPath.top() );
-        m_currentPath.push( fileName.GetPath() );
-        wxLogTrace( traceSchLegacyPlugin, "Current path   \"%s\"", m_currentPath.top() );
-        wxLogTrace( traceSchLegacyPlugin, "Loading        \"%s\"", fileName.GetFullPath() );
+            // SCH_SCREEN objects store the full path and file name where the SCH_SHEET object
+            // only stores the file name and extension.  Add the path of the parent sheet file
+            // to the file name and extension to compare when calling
+            // SCH_SHEET::SearchHierarchy().  This allows for sheet schematic files to be nested
+            // in folders relative to the last path a schematic was loaded from.
+            wxFileName fileName = sheet->GetFileName();
 
-        m_rootSheet->SearchHierarchy( fileName.GetFullPath(), &screen );
+            if( !fileName.IsAbsolute() )
+                fileName.MakeAbsolute( entry.second );
 
-        if( screen )
-        {
-            aSheet->SetScreen( screen );
-            aSheet->GetScreen()->SetParent( m_schematic );
-            // Do not need to load the sub-sheets - this has already been done.
-        }
-        else
-        {
-            aSheet->SetScreen( new SCH_SCREEN( m_schematic ) );
-            aSheet->GetScreen()->SetFileName( fileName.GetFullPath() );
+            // Also finds the screens created for the previous sheets of this level, so each
+            // file is parsed once
+            m_rootSheet->SearchHierarchy( fileName.GetFullPath(), &screen );
 
-            try
+            if( screen )
             {
-                loadFile( fileName.GetFullPath(), aSheet );
+                sheet->SetScreen( screen );
+                sheet->GetScreen()->SetParent( m_schematic );
+                // Do not need to load the sub-sheets - this has already been done.
             }
-            catch( const IO_ERROR& ioe )
+            else
+            {
+                wxLogTrace( traceSchLegacyPlugin, "Loading        \"%s\"",
+                            fileName.GetFullPath() );
+
+                sheet->SetScreen( new SCH_SCREEN( m_schematic ) );
+                sheet->GetScreen()->SetFileName( fileName.GetFullPath() );
+                toLoad.push_back( sheet );
+            }
+        }
+
+        // The files are independent until their sheets are searched: parse them with a
+        // parser per file, on the thread pool
+        std::vector<std::exception_ptr> errors( toLoad.size() );
+
+        THREAD_POOL::GetInstance().ParallelFor( toLoad.size(),
+                [&]( size_t i )
+                {
+                    try
+                    {
+                        loadFile( toLoad[i]->GetScreen()->GetFileName(), toLoad[i] );
+                    }
+                    catch( ... )
+                    {
+                        errors[i] = std::current_exception();
+                    }
+                } );
+
+        pending.clear();
+
+        for( size_t i = 0; i < toLoad.size(); ++i )
+        {
+            SCH_SCREEN* screen = toLoad[i]->GetScreen();
+
+            if( errors[i] )
             {
-                // If there is a problem loading the root sheet, there is no recovery.
-                if( aSheet == m_rootSheet )
-                    throw( ioe );
+                try
+                {
+                    std::rethrow_exception( errors[i] );
+                }
+                catch( const IO_ERROR& ioe )
+                {
+                    // If there is a problem loading the root sheet, there is no recovery.
+                    if( toLoad[i] == m_rootSheet )
+                        throw;
 
-                // For all subsheets, queue up the error message for the caller.
-                if( !m_error.IsEmpty() )
-                    m_error += "\n";
+                    // For all subsheets, queue up the error message for the caller.
+                    if( !m_error.IsEmpty() )
+                        m_error += "\n";
 
-                m_error += ioe.What();
+                    m_error += ioe.What();
+                }
             }
 
-            // This was moved out of the try{} block so that any sheets definitionsthat
-            // the plugin fully parsed before the exception was raised will be loaded.
-            for( auto aItem : aSheet->GetScreen()->Items().OfType( SCH_SHEET_T ) )
+            // The sheet definitions the parser fully parsed before an exception was raised
+            // are loaded too.
+            wxString path = wxFileName( screen->GetFileName() ).GetPath();
+
+            for( auto aItem : screen->Items().OfType( SCH_SHEET_T ) )
             {
-                wxCHECK2( aItem->Type() == SCH_SHEET_T, /* do nothing */ );
+                wxCHECK2( aItem->Type() == SCH_SHEET_T, continue );
                 auto sheet = static_cast<SCH_SHEET*>( aItem );
 
-                // Recursion starts here.
-                loadHierarchy( sheet );
+                if( !sheet->GetScreen() )
+                    pending.emplace_back( sheet, path );
             }
         }
-
-        m_currentPath.pop();
-        wxLogTrace( traceSchLegacyPlugin, "Restoring path \"%s\"", m_currentPath.top() );
     }
 }
 
 
 void SCH_SEXPR_PLUGIN::loadFile( const wxString& aFileName, SCH_SHEET* aSheet )
 {
-    FILE_LINE_READER reader( aFileName );
+    MAPPED_FILE_LINE_READER reader( aFileName );
 
     SCH_SEXPR_PARSER parser( &reader );
 
@@ -596,9 +648,14 @@ void SCH_SEXPR_PLUGIN::Save( const wxString& aFileName, SCH_SHEET* aSheet, SCHEM
     // works properly.
     wxASSERT( fn.IsAbsolute() );
 
-    FILE_OUTPUTFORMATTER formatter( fn.GetFullPath() );
+    std::unique_ptr<OUTPUTFORMATTER> formatter;
+
+    if( ADVANCED_CFG::GetCfg().m_CompressSavedFiles )
+        formatter.reset( new GZIP_FILE_OUTPUTFORMATTER( fn.GetFullPath() ) );
+    else
+        formatter.reset( new FILE_OUTPUTFORMATTER( fn.GetFullPath() ) );
 
-    m_out = &formatter;     // no ownership
+    m_out = formatter.get();     // no ownership
 
     Format( aSheet );
 }
@@ -1229,7 +1286,7 @@ void SCH_SEXPR_PLUGIN::saveBusAlias( std::shared_ptr<BUS_ALIAS> aAlias, int aNes
 }
 
 
-int SCH_SEXPR_PLUGIN_CACHE::m_modHash = 1;     // starts at 1 and goes up
+std::atomic<int> SCH_SEXPR_PLUGIN_CACHE::m_modHash( 1 );     // starts at 1 and goes up
 
 
 SCH_SEXPR_PLUGIN_CACHE::SCH_SEXPR_PLUGIN_CACHE( const wxString& aFullPathAndFileName ) :
@@ -1307,10 +1364,59 @@ bool SCH_SEXPR_PLUGIN_CACHE::IsFileChanged() const
 }
 
 
+LIB_PART* SCH_SEXPR_PLUGIN_CACHE::getSymbol( const wxString& aName )
+{
+    LIB_PART_MAP::iterator it = m_symbols.find( aName );
+
+    if( it != m_symbols.end() )
+        return it->second;
+
+    LIB_SYMBOL_BLOCK_MAP::iterator blockIt = m_symbolBlocks.find( aName );
+
+    if( blockIt == m_symbolBlocks.end() )
+        return NULL;
+
+    // The block is dropped first, so an extends loop cannot recurse forever.
+    LIB_SYMBOL_BLOCK block = std::move( blockIt->second );
+
+    m_symbolBlocks.erase( blockIt );
+
+    LIB_PART* symbol = nullptr;
+
+    try
+    {
+        // An alias needs its parent in the map.  A missing parent is reported by the parser.
+        if( !block.m_parentName.IsEmpty() )
+            getSymbol( block.m_parentName );
+
+        symbol = SCH_SEXPR_PARSER::ParseSymbolBlock( block, m_libFileName.GetFullPath(),
+                                                     m_symbols );
+    }
+    catch( const IO_ERROR& )
+    {
+        // Keep the symbol listed, the error is reported each time it is asked for
+        m_symbolBlocks[aName] = std::move( block );
+        throw;
+    }
+
+    m_symbols[aName] = symbol;
+    return symbol;
+}
+
+
+void SCH_SEXPR_PLUGIN_CACHE::parseAllSymbols()
+{
+    while( !m_symbolBlocks.empty() )
+        getSymbol( m_symbolBlocks.begin()->first );
+}
+
+
 LIB_PART* SCH_SEXPR_PLUGIN_CACHE::removeSymbol( LIB_PART* aPart )
 {
     wxCHECK_MSG( aPart != NULL, NULL, "NULL pointer cannot be removed from library." );
 
+    parseAllSymbols();
+
     LIB_PART* firstChild = NULL;
     LIB_PART_MAP::iterator it = m_symbols.find( aPart->GetName() );
 
@@ -1376,6 +1482,8 @@ void SCH_SEXPR_PLUGIN_CACHE::AddSymbol( const LIB_PART* aPart )
 {
     // aPart is cloned in PART_LIB::AddPart().  The cache takes ownership of aPart.
     wxString name = aPart->GetName();
+
+    parseAllSymbols();
     LIB_PART_MAP::iterator it = m_symbols.find( name );
 
     if( it != m_symbols.end() )
@@ -1404,11 +1512,19 @@ void SCH_SEXPR_PLUGIN_CACHE::Load()
     wxLogTrace( traceSchLegacyPlugin, "Loading sexpr symbol library file \"%s\"",
                 m_libFileName.GetFullPath() );
 
-    FILE_LINE_READER reader( m_libFileName.GetFullPath() );
+    MAPPED_FILE_LINE_READER reader( m_libFileName.GetFullPath() );
 
     SCH_SEXPR_PARSER parser( &reader );
 
-    parser.ParseLib( m_symbols );
+    // Only the symbol names are read here.  A symbol is parsed when it is first asked for:
+    // a library with thousands of symbols costs little until its symbols are used.
+    m_symbolBlocks.clear();
+    parser.ParseLibIndex( m_symbolBlocks );
+
+    // The symbols already parsed are kept, as their pointers may be in use.
+    for( const auto& symbol : m_symbols )
+        m_symbolBlocks.erase( symbol.first );
+
     ++m_modHash;
 
     // Remember the file modification time of library file when the
@@ -1425,6 +1541,8 @@ void SCH_SEXPR_PLUGIN_CACHE::Save()
 
     LOCALE_IO   toggle;     // toggles on, then off, the C locale.
 
+    parseAllSymbols();
+
     // Write through symlinks, don't replace them.
     wxFileName fn = GetRealFile();
 
@@ -1918,6 +2036,8 @@ void SCH_SEXPR_PLUGIN_CACHE::saveText( LIB_TEXT* aText,
 
 void SCH_SEXPR_PLUGIN_CACHE::DeleteSymbol( const wxString& aSymbolName )
 {
+    parseAllSymbols();
+
     LIB_PART_MAP::iterator it = m_symbols.find( aSymbolName );
 
     if( it == m_symbols.end() )
@@ -2009,13 +2129,23 @@ void SCH_SEXPR_PLUGIN::EnumerateSymbolLib( wxArrayString&    aSymbolNameList,
                               aProperties->find( SYMBOL_LIB_TABLE::PropPowerSymsOnly ) != aProperties->end() );
     cacheLib( aLibraryPath );
 
-    const LIB_PART_MAP& symbols = m_cache->m_symbols;
+    // The names of the symbols not parsed yet are merged in, without parsing them
+    std::set<wxString, LibPartMapSort> names;
 
-    for( LIB_PART_MAP::const_iterator it = symbols.begin();  it != symbols.end();  ++it )
+    for( const auto& symbol : m_cache->m_symbols )
     {
-        if( !powerSymbolsOnly || it->second->IsPower() )
-            aSymbolNameList.Add( it->first );
+        if( !powerSymbolsOnly || symbol.second->IsPower() )
+            names.insert( symbol.first );
+    }
+
+    for( const auto& block : m_cache->m_symbolBlocks )
+    {
+        if( !powerSymbolsOnly || block.second.m_isPower )
+            names.insert( block.first );
     }
+
+    for( const wxString& name : names )
+        aSymbolNameList.Add( name );
 }
 
 
@@ -2031,6 +2161,24 @@ void SCH_SEXPR_PLUGIN::EnumerateSymbolLib( std::vector<LIB_PART*>& aSymbolList,
                               aProperties->find( SYMBOL_LIB_TABLE::PropPowerSymsOnly ) != aProperties->end() );
     cacheLib( aLibraryPath );
 
+    if( powerSymbolsOnly )
+    {
+        std::vector<wxString> powerSymbols;
+
+        for( const auto& block : m_cache->m_symbolBlocks )
+        {
+            if( block.second.m_isPower )
+                powerSymbols.push_back( block.first );
+        }
+
+        for( const wxString& name : powerSymbols )
+            m_cache->getSymbol( name );
+    }
+    else
+    {
+        m_cache->parseAllSymbols();
+    }
+
     const LIB_PART_MAP& symbols = m_cache->m_symbols;
 
     for( LIB_PART_MAP::const_iterator it = symbols.begin();  it != symbols.end();  ++it )
@@ -2050,12 +2198,7 @@ LIB_PART* SCH_SEXPR_PLUGIN::LoadSymbol( const wxString& aLibraryPath, const wxSt
 
     cacheLib( aLibraryPath );
 
-    LIB_PART_MAP::const_iterator it = m_cache->m_symbols.find( aSymbolName );
-
-    if( it == m_cache->m_symbols.end() )
-        return nullptr;
-
-    return it->second;
+    return m_cache->getSymbol( aSymbolName );
 }
 
 
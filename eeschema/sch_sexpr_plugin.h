@@ -127,6 +127,11 @@ public:
     static void FormatPart( LIB_PART* aPart, OUTPUTFORMATTER& aFormatter );
 
 private:
+    /**
+     * Load the screens of \a aSheet and of all its sub-sheets, one level of the hierarchy
+     * after the other.  The files of a level are parsed concurrently, before their sheets
+     * are linked to the hierarchy.
+     */
     void loadHierarchy( SCH_SHEET* aSheet );
     void loadFile( const wxString& aFileName, SCH_SHEET* aSheet );
 
@@ -167,6 +167,18 @@ void SCH_SHEET::SetScreen( SCH_SCREEN* aScreen )
 
     if( m_screen )
         m_screen->IncRefCount();
+
+    if( SCHEMATIC* schematic = Schematic() )
+        schematic->HierarchyChanged();
+}
+
+
+void SCH_SHEET::SetFields( const std::vector<SCH_FIELD>& aFields )
+{
+    m_fields = aFields;     // vector copying, length is changed possibly
+
+    if( SCHEMATIC* schematic = Schematic() )
+        schematic->HierarchyChanged();
 }
 
 
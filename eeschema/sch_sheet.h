@@ -272,10 +272,11 @@ public:
      *
      * @param aFields are the fields to set in this symbol.
      */
-    void SetFields( const std::vector<SCH_FIELD>& aFields )
-    {
-        m_fields = aFields;     // vector copying, length is changed possibly
-    }
+    /**
+     * Set the fields of the sheet.  The "Order" field sorts the sheets of a screen in the
+     * hierarchy: the schematic is told its hierarchy changed.
+     */
+    void SetFields( const std::vector<SCH_FIELD>& aFields );
 
     wxString GetName() const { return m_fields[ SHEETNAME ].GetText(); }
 
@@ -424,6 +424,18 @@ void SCH_SHEET_LIST::ClearModifyStatus()
 
 SCH_ITEM* SCH_SHEET_LIST::GetItem( const KIID& aID, SCH_SHEET_PATH* aPathOut )
 {
+    for( const SCH_SHEET_PATH& sheet : *this )
+    {
+        if( SCH_ITEM* item = sheet.LastScreen()->GetIndexedItem( aID ) )
+        {
+            if( aPathOut )
+                *aPathOut = sheet;
+
+            return item;
+        }
+    }
+
+    // Not indexed (e.g. a pin of a symbol updated since it was added to its screen)
     for( const SCH_SHEET_PATH& sheet : *this )
     {
         SCH_SCREEN* screen = sheet.LastScreen();
@@ -28,7 +28,8 @@
 SCHEMATIC::SCHEMATIC( PROJECT* aPrj ) :
           EDA_ITEM( nullptr, SCHEMATIC_T ),
           m_project( aPrj ),
-          m_rootSheet( nullptr )
+          m_rootSheet( nullptr ),
+          m_sheetListValid( false )
 {
     m_currentSheet    = new SCH_SHEET_PATH();
     m_connectionGraph = new CONNECTION_GRAPH( this );
@@ -49,6 +50,7 @@ void SCHEMATIC::Reset()
     delete m_rootSheet;
 
     m_rootSheet = nullptr;
+    HierarchyChanged();
 
     m_connectionGraph->Reset();
     m_currentSheet->clear();
@@ -60,11 +62,28 @@ void SCHEMATIC::SetRoot( SCH_SHEET* aRootSheet )
     wxCHECK_RET( aRootSheet, "Call to SetRoot with null SCH_SHEET!" );
 
     m_rootSheet = aRootSheet;
+    HierarchyChanged();
 
     m_connectionGraph->Reset();
 }
 
 
+SCH_SHEET_LIST SCHEMATIC::GetSheets() const
+{
+    std::lock_guard<std::mutex> lock( m_sheetListLock );
+
+    if( !m_sheetListValid )
+    {
+        // Building the list can remove the recursive sheets, which calls HierarchyChanged():
+        // the list built is still valid then, without them
+        m_sheetList = SCH_SHEET_LIST( m_rootSheet );
+        m_sheetListValid = true;
+    }
+
+    return m_sheetList;
+}
+
+
 SCH_SCREEN* SCHEMATIC::RootScreen() const
 {
     return IsValid() ? m_rootSheet->GetScreen() : nullptr;
@@ -24,6 +24,9 @@
 #include <sch_sheet_path.h>
 #include <schematic_settings.h>
 
+#include <atomic>
+#include <mutex>
+
 
 class BUS_ALIAS;
 class CONNECTION_GRAPH;
@@ -67,6 +70,11 @@ private:
     // TODO: This should be moved to project settings, not schematic
     ERC_SETTINGS* m_ercSettings;
 
+    /// The hierarchy, built again by GetSheets() after HierarchyChanged()
+    mutable SCH_SHEET_LIST    m_sheetList;
+    mutable std::atomic<bool> m_sheetListValid;
+    mutable std::mutex        m_sheetListLock;
+
 public:
     SCHEMATIC( PROJECT* aPrj );
 
@@ -92,13 +100,19 @@ public:
     }
 
     /**
-     * Builds and returns an updated schematic hierarchy
-     * TODO: can this be cached?
+     * Returns the schematic hierarchy.  It is built once, and again only after
+     * HierarchyChanged(): the list returned is a copy, which may be changed by the caller.
      * @return a SCH_SHEET_LIST containing the schematic hierarchy
      */
-    SCH_SHEET_LIST GetSheets() const
+    SCH_SHEET_LIST GetSheets() const;
+
+    /**
+     * Tells the schematic that a sheet was added, removed, re-pointed to another screen or
+     * reordered (see SCH_SCREEN::GetSheets()).  The screens and the sheets call it themselves.
+     */
+    void HierarchyChanged()
     {
-        return SCH_SHEET_LIST( m_rootSheet );
+        m_sheetListValid = false;
     }
 
     SCH_SHEET& Root() const
@@ -38,6 +38,7 @@
 #include <stdexcept>
 
 #include <algorithm>
+#include <cctype>
 
 using namespace std;
 
@@ -228,6 +229,53 @@ vector<double> NGSPICE::GetPhasePlot( const string& aName, int aMaxLen )
 }
 
 
+static string toLower( string aName )
+{
+    std::transform( aName.begin(), aName.end(), aName.begin(),
+                    []( unsigned char c ) { return std::tolower( c ); } );
+    return aName;
+}
+
+
+size_t NGSPICE::GetRunningPlot( const string& aName, size_t aFrom, vector<double>& aData )
+{
+    // ngspice sends the node voltages by node name and the currents by branch name
+    string         name = toLower( aName );
+    vector<string> candidates = { name };
+
+    if( name.size() > 3 && name.back() == ')' && name[1] == '(' )
+    {
+        string inner = name.substr( 2, name.size() - 3 );
+
+        if( name[0] == 'v' )
+            candidates.push_back( inner );
+        else if( name[0] == 'i' )
+            candidates.push_back( inner + "#branch" );
+    }
+
+    std::lock_guard<std::mutex> lock( m_runningPlotsLock );
+
+    for( const string& candidate : candidates )
+    {
+        for( const auto& plot : m_runningPlots )
+        {
+            if( plot.first != candidate )
+                continue;
+
+            const vector<double>& values = plot.second;
+
+            if( aFrom >= values.size() )
+                return 0;
+
+            aData.insert( aData.end(), values.begin() + aFrom, values.end() );
+            return values.size() - aFrom;
+        }
+    }
+
+    return 0;
+}
+
+
 bool NGSPICE::LoadNetlist( const string& aNetlist )
 {
     LOCALE_IO c_locale;       // ngspice works correctly only with C locale
@@ -257,6 +305,14 @@ bool NGSPICE::LoadNetlist( const string& aNetlist )
 bool NGSPICE::Run()
 {
     LOCALE_IO c_locale;               // ngspice works correctly only with C locale
+
+    {
+        std::lock_guard<std::mutex> lock( m_runningPlotsLock );
+        m_runningPlots.clear();
+    }
+
+    m_lastProgress = std::chrono::steady_clock::time_point();
+
     return Command( "bg_run" );     // bg_* commands execute in a separate thread
 }
 
@@ -391,7 +447,8 @@ void NGSPICE::init_dll()
     m_ngSpice_AllVecs = (ngSpice_AllVecs) m_dll.GetSymbol( "ngSpice_AllVecs" );
     m_ngSpice_Running = (ngSpice_Running) m_dll.GetSymbol( "ngSpice_running" ); // it is not a typo
 
-    m_ngSpice_Init( &cbSendChar, &cbSendStat, &cbControlledExit, NULL, NULL, &cbBGThreadRunning, this );
+    m_ngSpice_Init( &cbSendChar, &cbSendStat, &cbControlledExit, &cbSendData, NULL,
+                    &cbBGThreadRunning, this );
 
     // Load a custom spinit file, to fix the problem with loading .cm files
     // Switch to the executable directory, so the relative paths are correct
@@ -553,6 +610,40 @@ int NGSPICE::cbBGThreadRunning( bool is_running, int id, void* user )
 }
 
 
+int NGSPICE::cbSendData( pvecvaluesall aData, int aCount, int id, void* user )
+{
+    NGSPICE* sim = reinterpret_cast<NGSPICE*>( user );
+
+    {
+        std::lock_guard<std::mutex> lock( sim->m_runningPlotsLock );
+        auto&                       plots = sim->m_runningPlots;
+
+        // The vectors are the same, in the same order, for all the points of a run
+        if( plots.size() != (size_t) aData->veccount )
+        {
+            plots.clear();
+
+            for( int i = 0; i < aData->veccount; i++ )
+                plots.emplace_back( toLower( aData->vecsa[i]->name ), vector<double>() );
+        }
+
+        for( int i = 0; i < aData->veccount; i++ )
+            plots[i].second.push_back( aData->vecsa[i]->creal );
+    }
+
+    // A point can take microseconds: do not flood the reporter with notifications
+    auto now = std::chrono::steady_clock::now();
+
+    if( sim->m_reporter && now - sim->m_lastProgress >= std::chrono::milliseconds( 200 ) )
+    {
+        sim->m_lastProgress = now;
+        sim->m_reporter->OnSimProgress( sim );
+    }
+
+    return 0;
+}
+
+
 int NGSPICE::cbControlledExit( int status, bool immediate, bool exit_upon_quit, int id, void* user )
 {
     // Something went wrong, reload the dll
@@ -30,6 +30,9 @@
 #include <wx/dynlib.h>
 #include <ngspice/sharedspice.h>
 
+#include <chrono>
+#include <mutex>
+
 class wxDynamicLibrary;
 
 class NGSPICE : public SPICE_SIMULATOR {
@@ -77,6 +80,10 @@ public:
     ///> @copydoc SPICE_SIMULATOR::GetPhasePlot()
     std::vector<double> GetPhasePlot( const std::string& aName, int aMaxLen = -1 ) override;
 
+    ///> @copydoc SPICE_SIMULATOR::GetRunningPlot()
+    size_t GetRunningPlot( const std::string& aName, size_t aFrom,
+                           std::vector<double>& aData ) override;
+
     ///> @copydoc SPICE_SIMULATOR::GetNetlist()
     virtual const std::string GetNetlist() const override;
 
@@ -123,6 +130,7 @@ private:
     static int cbSendChar( char* what, int id, void* user );
     static int cbSendStat( char* what, int id, void* user );
     static int cbBGThreadRunning( bool is_running, int id, void* user );
+    static int cbSendData( pvecvaluesall aData, int aCount, int id, void* user );
     static int cbControlledExit( int status, bool immediate, bool exit_upon_quit, int id, void* user );
 
     // Assures ngspice is in a valid state and reinitializes it if need be
@@ -136,6 +144,14 @@ private:
 
     ///> current netlist
     std::string m_netlist;
+
+    ///> Lower case names and values of the vectors of the running simulation, filled by
+    ///> cbSendData() in the simulation thread
+    std::vector<std::pair<std::string, std::vector<double>>> m_runningPlots;
+    std::mutex m_runningPlotsLock;
+
+    ///> Last call of SPICE_REPORTER::OnSimProgress(), to limit the rate of the notifications
+    std::chrono::steady_clock::time_point m_lastProgress;
 };
 
 #endif /* NGSPICE_H */
@@ -97,6 +97,11 @@ public:
         wxQueueEvent( m_parent, event );
     }
 
+    void OnSimProgress( SPICE_SIMULATOR* aObject ) override
+    {
+        wxQueueEvent( m_parent, new wxCommandEvent( EVT_SIM_PROGRESS ) );
+    }
+
 private:
     SIM_PLOT_FRAME* m_parent;
 };
@@ -171,6 +176,7 @@ SIM_PLOT_FRAME::SIM_PLOT_FRAME( KIWAY* aKiway, wxWindow* aParent )
     Connect( EVT_SIM_REPORT, wxCommandEventHandler( SIM_PLOT_FRAME::onSimReport ), NULL, this );
     Connect( EVT_SIM_STARTED, wxCommandEventHandler( SIM_PLOT_FRAME::onSimStarted ), NULL, this );
     Connect( EVT_SIM_FINISHED, wxCommandEventHandler( SIM_PLOT_FRAME::onSimFinished ), NULL, this );
+    Connect( EVT_SIM_PROGRESS, wxCommandEventHandler( SIM_PLOT_FRAME::onSimProgress ), NULL, this );
     Connect( EVT_SIM_CURSOR_UPDATE, wxCommandEventHandler( SIM_PLOT_FRAME::onCursorUpdate ), NULL, this );
 
     // Toolbar buttons
@@ -1474,6 +1480,7 @@ void SIM_PLOT_FRAME::onSimStarted( wxCommandEvent& aEvent )
 {
     m_toolBar->SetToolNormalBitmap( ID_SIM_RUN, KiBitmap( sim_stop_xpm ) );
     SetCursor( wxCURSOR_ARROWWAIT );
+    m_streamedTraces.clear();
 }
 
 
@@ -1549,6 +1556,74 @@ void SIM_PLOT_FRAME::onSimFinished( wxCommandEvent& aEvent )
 }
 
 
+void SIM_PLOT_FRAME::onSimProgress( wxCommandEvent& aEvent )
+{
+    // Only a transient analysis computes its points in the order of the x axis, and the
+    // whole results are read when the simulation finishes anyway
+    if( m_exporter->GetSimType() != ST_TRANSIENT || !IsSimulationRunning() )
+        return;
+
+    SIM_PANEL_BASE* plotPanelWindow = currentPlotWindow();
+
+    if( !plotPanelWindow || plotPanelWindow->GetType() != ST_TRANSIENT )
+        return;
+
+    SIM_PLOT_PANEL* plotPanel = dynamic_cast<SIM_PLOT_PANEL*>( plotPanelWindow );
+    auto            plotInfo = m_plots.find( plotPanelWindow );
+
+    wxCHECK_RET( plotPanel, "not a SIM_PLOT_PANEL" );
+
+    if( plotInfo == m_plots.end() )
+        return;
+
+    std::string         xAxisName = m_simulator->GetXAxis( ST_TRANSIENT );
+    std::vector<double> data_x;
+    std::vector<double> data_y;
+    bool                updated = false;
+
+    for( const auto& it : plotInfo->second.m_traces )
+    {
+        const TRACE_DESC& descriptor = it.second;
+        TRACE*            trace = plotPanel->GetTrace( descriptor.GetTitle() );
+
+        if( !trace )
+            continue;
+
+        // Until the first new points come, a trace shows the results of the previous run
+        bool     first = !m_streamedTraces.count( descriptor.GetTitle() );
+        size_t   from = first ? 0 : trace->GetDataX().size();
+        wxString spiceVector = m_exporter->ComponentToVector(
+                descriptor.GetName(), descriptor.GetType(), descriptor.GetParam() );
+
+        data_x.clear();
+        data_y.clear();
+        m_simulator->GetRunningPlot( xAxisName, from, data_x );
+        m_simulator->GetRunningPlot( (const char*) spiceVector.c_str(), from, data_y );
+
+        // The simulation thread may have added points between the two reads
+        size_t count = std::min( data_x.size(), data_y.size() );
+
+        if( count == 0 )
+            continue;
+
+        if( first )
+        {
+            trace->SetData( std::vector<double>(), std::vector<double>() );
+            m_streamedTraces.insert( descriptor.GetTitle() );
+        }
+
+        trace->AppendData( data_x.data(), data_y.data(), count );
+        updated = true;
+    }
+
+    if( updated )
+    {
+        plotPanel->GetPlotWin()->UpdateAll();
+        plotPanel->ResetScales();
+    }
+}
+
+
 void SIM_PLOT_FRAME::onSimUpdate( wxCommandEvent& aEvent )
 {
     if( IsSimulationRunning() )
@@ -1624,3 +1699,4 @@ wxDEFINE_EVENT( EVT_SIM_REPORT, wxCommandEvent );
 
 wxDEFINE_EVENT( EVT_SIM_STARTED, wxCommandEvent );
 wxDEFINE_EVENT( EVT_SIM_FINISHED, wxCommandEvent );
+wxDEFINE_EVENT( EVT_SIM_PROGRESS, wxCommandEvent );
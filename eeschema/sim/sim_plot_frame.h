@@ -45,6 +45,7 @@
 #include <list>
 #include <memory>
 #include <map>
+#include <set>
 
 class SCH_EDIT_FRAME;
 class SCH_COMPONENT;
@@ -335,6 +336,7 @@ private:
     void onSimReport( wxCommandEvent& aEvent );
     void onSimStarted( wxCommandEvent& aEvent );
     void onSimFinished( wxCommandEvent& aEvent );
+    void onSimProgress( wxCommandEvent& aEvent );
 
     // adjust the sash dimension of splitter windows after reading
     // the config settings
@@ -400,6 +402,9 @@ private:
     ///> Panel that was used as the most recent one for simulations
     SIM_PLOT_PANEL* m_lastSimPlot;
 
+    ///> Traces that already show points of the running simulation
+    std::set<wxString> m_streamedTraces;
+
     ///> imagelists uset to add a small coloured icon to signal names
     ///> and cursors name, the same color as the corresponding signal traces
     wxImageList* m_signalsIconColorList;
@@ -429,5 +434,6 @@ wxDECLARE_EVENT( EVT_SIM_REPORT, wxCommandEvent );
 // Notifications
 wxDECLARE_EVENT( EVT_SIM_STARTED, wxCommandEvent );
 wxDECLARE_EVENT( EVT_SIM_FINISHED, wxCommandEvent );
+wxDECLARE_EVENT( EVT_SIM_PROGRESS, wxCommandEvent );
 
 #endif // __sim_plot_frame__
@@ -113,6 +113,20 @@ public:
         mpFXYVector::SetData( aX, aY );
     }
 
+    /**
+     * @brief Appends points to the data set of the trace, as a running simulation computes them.
+     * @param aX are the X axis values.
+     * @param aY are the Y axis values.
+     * @param aPoints is the number of points in aX and aY.
+     */
+    void AppendData( const double* aX, const double* aY, size_t aPoints )
+    {
+        if( m_cursor )
+            m_cursor->Update();
+
+        mpFXYVector::AppendData( aX, aY, aPoints );
+    }
+
     const std::vector<double>& GetDataX() const
     {
         return m_xs;
@@ -46,6 +46,14 @@ public:
     }
 
     virtual void OnSimStateChange( SPICE_SIMULATOR* aObject, SIM_STATE aNewState ) = 0;
+
+    /**
+     * @brief Called from the simulation thread when new points have been computed, at most a
+     * few times per second.  The points can be read with SPICE_SIMULATOR::GetRunningPlot().
+     */
+    virtual void OnSimProgress( SPICE_SIMULATOR* aObject )
+    {
+    }
 };
 
 #endif /* SPICE_REPORTER_H */
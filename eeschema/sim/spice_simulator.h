@@ -145,6 +145,18 @@ public:
      */
     virtual std::vector<double> GetPhasePlot( const std::string& aName, int aMaxLen = -1 ) = 0;
 
+    /**
+     * @brief Appends the real values of a vector of the running simulation to \a aData.  The
+     * values are collected as the points are computed, so they can be read before the
+     * simulation ends.  It is safe to call while the simulation thread runs.
+     * @param aName is the vector named in Spice convention (e.g. V(3), I(R1)).
+     * @param aFrom is the index of the first value to append, so that only the values that
+     * are new since the last call are copied.
+     * @return Number of values appended. It is 0 if there is no vector with requested name.
+     */
+    virtual size_t GetRunningPlot( const std::string& aName, size_t aFrom,
+                                   std::vector<double>& aData ) = 0;
+
     /**
      * @brief Returns current SPICE netlist used by the simulator.
      * @return The netlist.
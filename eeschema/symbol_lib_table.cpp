@@ -53,6 +53,9 @@ int SYMBOL_LIB_TABLE::m_modifyHash = 1;     // starts at 1 and goes up
 /// the fallback table for multiple projects).
 SYMBOL_LIB_TABLE    g_symbolLibraryTable;
 
+/// The loading of g_symbolLibraryTable started by LoadGlobalTableInBackground()
+static LIB_TABLE_BACKGROUND_LOAD globalTableLoad;
+
 
 bool SYMBOL_LIB_TABLE_ROW::operator==( const SYMBOL_LIB_TABLE_ROW& aRow ) const
 {
@@ -77,8 +80,21 @@ SYMBOL_LIB_TABLE::SYMBOL_LIB_TABLE( SYMBOL_LIB_TABLE* aFallBackTable ) :
 }
 
 
+void SYMBOL_LIB_TABLE::LoadGlobalTableInBackground(
+        std::function<void( const IO_ERROR& )> aOnError )
+{
+    globalTableLoad.Start( []()
+                           {
+                               LoadGlobalTable( g_symbolLibraryTable );
+                           },
+                           std::move( aOnError ) );
+}
+
+
 SYMBOL_LIB_TABLE& SYMBOL_LIB_TABLE::GetGlobalLibTable()
 {
+    globalTableLoad.Wait();
+
     return g_symbolLibraryTable;
 }
 
@@ -358,10 +374,42 @@ LIB_PART* SYMBOL_LIB_TABLE::LoadSymbol( const wxString& aNickname, const wxStrin
 }
 
 
+std::shared_ptr<const LIB_PART> SYMBOL_LIB_TABLE::LoadFlattenedSymbol( const wxString& aNickname,
+                                                                        const wxString& aName )
+{
+    LIB_PART* part = LoadSymbol( aNickname, aName );
+
+    if( !part )
+        return nullptr;
+
+    if( !part->IsAlias() )
+        return std::shared_ptr<const LIB_PART>( part->Flatten() );
+
+    SYMBOL_LIB_TABLE_ROW* row = FindRow( aNickname );
+    PART_SPTR             parent = part->GetParent().lock();
+
+    std::lock_guard<std::mutex> lock( row->flattenedPartsLock );
+
+    SYMBOL_LIB_TABLE_ROW::FLATTENED_PART& cached = row->flattenedParts[aName];
+
+    // A part changed in the library is replaced by another object, and a reloaded library
+    // has all new objects
+    if( !cached.m_Flattened || cached.m_Part.lock().get() != part
+            || cached.m_Parent.lock() != parent )
+    {
+        cached.m_Part = part->SharedPtr();
+        cached.m_Parent = parent;
+        cached.m_Flattened = part->Flatten();
+    }
+
+    return cached.m_Flattened;
+}
+
+
 SYMBOL_LIB_TABLE::SAVE_T SYMBOL_LIB_TABLE::SaveSymbol( const wxString& aNickname,
                                                        const LIB_PART* aSymbol, bool aOverwrite )
 {
-    const SYMBOL_LIB_TABLE_ROW* row = FindRow( aNickname );
+    SYMBOL_LIB_TABLE_ROW* row = FindRow( aNickname );
     wxCHECK( row && row->plugin, SAVE_SKIPPED );
 
     if( !aOverwrite )
@@ -380,6 +428,7 @@ SYMBOL_LIB_TABLE::SAVE_T SYMBOL_LIB_TABLE::SaveSymbol( const wxString& aNickname
     }
 
     row->plugin->SaveSymbol( row->GetFullURI( true ), aSymbol, row->GetProperties() );
+    row->clearFlattenedParts();
 
     return SAVE_OK;
 }
@@ -387,10 +436,10 @@ SYMBOL_LIB_TABLE::SAVE_T SYMBOL_LIB_TABLE::SaveSymbol( const wxString& aNickname
 
 void SYMBOL_LIB_TABLE::DeleteSymbol( const wxString& aNickname, const wxString& aSymbolName )
 {
-    const SYMBOL_LIB_TABLE_ROW* row = FindRow( aNickname );
+    SYMBOL_LIB_TABLE_ROW* row = FindRow( aNickname );
     wxCHECK( row && row->plugin, /* void */ );
-    return row->plugin->DeleteSymbol( row->GetFullURI( true ), aSymbolName,
-                                      row->GetProperties() );
+    row->plugin->DeleteSymbol( row->GetFullURI( true ), aSymbolName, row->GetProperties() );
+    row->clearFlattenedParts();
 }
 
 
@@ -404,9 +453,10 @@ bool SYMBOL_LIB_TABLE::IsSymbolLibWritable( const wxString& aNickname )
 
 void SYMBOL_LIB_TABLE::DeleteSymbolLib( const wxString& aNickname )
 {
-    const SYMBOL_LIB_TABLE_ROW* row = FindRow( aNickname );
+    SYMBOL_LIB_TABLE_ROW* row = FindRow( aNickname );
     wxCHECK( row && row->plugin, /* void */ );
     row->plugin->DeleteSymbolLib( row->GetFullURI( true ), row->GetProperties() );
+    row->clearFlattenedParts();
 }
 
 
@@ -30,6 +30,10 @@
 #include <lib_id.h>
 #include <class_libentry.h>
 
+#include <map>
+#include <memory>
+#include <mutex>
+
 //class LIB_PART;
 class SYMBOL_LIB_TABLE_GRID;
 class DIALOG_SYMBOL_LIB_TABLE;
@@ -95,8 +99,28 @@ private:
         plugin.set( aPlugin );
     }
 
+    /**
+     * A flattened derived part of the library, valid as long as the library holds the same
+     * derived part and parent part objects.
+     */
+    struct FLATTENED_PART
+    {
+        PART_REF                        m_Part;
+        PART_REF                        m_Parent;
+        std::shared_ptr<const LIB_PART> m_Flattened;
+    };
+
+    void clearFlattenedParts()
+    {
+        std::lock_guard<std::mutex> lock( flattenedPartsLock );
+        flattenedParts.clear();
+    }
+
     SCH_PLUGIN::SCH_PLUGIN_RELEASER  plugin;
     LIB_T                            type;
+
+    std::map<wxString, FLATTENED_PART> flattenedParts;
+    std::mutex                         flattenedPartsLock;
 };
 
 
@@ -180,6 +204,24 @@ public:
         return LoadSymbol( aLibId.GetLibNickname(), aLibId.GetLibItemName() );
     }
 
+    /**
+     * Load a #LIB_PART having @a aName from the library given by @a aNickname, flattened.
+     *
+     * The flattened derived parts are cached by the library and shared: they are flattened
+     * again only once the part or its parent changed.  A part must be copied to be modified.
+     *
+     * @return the flattened part, or nullptr if not found.
+     *
+     * @throw IO_ERROR if the library cannot be found or read.
+     */
+    std::shared_ptr<const LIB_PART> LoadFlattenedSymbol( const wxString& aNickname,
+                                                         const wxString& aName );
+
+    std::shared_ptr<const LIB_PART> LoadFlattenedSymbol( const LIB_ID& aLibId )
+    {
+        return LoadFlattenedSymbol( aLibId.GetLibNickname(), aLibId.GetLibItemName() );
+    }
+
     /**
      * The set of return values from SaveSymbol() below.
      */
@@ -267,6 +309,14 @@ public:
      */
     static bool LoadGlobalTable( SYMBOL_LIB_TABLE& aTable );
 
+    /**
+     * Start loading the global symbol library table on a background thread, with
+     * LoadGlobalTable(), not to delay the first frame.
+     *
+     * @param aOnError is called by the first GetGlobalLibTable() if the table cannot be loaded.
+     */
+    static void LoadGlobalTableInBackground( std::function<void( const IO_ERROR& )> aOnError );
+
     /**
      *
      * Fetch the global symbol library table file name.
@@ -285,6 +335,10 @@ public:
      */
     static const wxString GlobalPathEnvVariableName();
 
+    /**
+     * @return the global symbol library table, once its loading started by
+     *         LoadGlobalTableInBackground() is done.
+     */
     static SYMBOL_LIB_TABLE& GetGlobalLibTable();
 
     static const wxString& GetSymbolLibTableFileName();
@@ -22,13 +22,17 @@
 #include <wx/tokenzr.h>
 #include <wx/progdlg.h>
 
+#include <common.h>
 #include <eda_pattern_match.h>
 #include <symbol_lib_table.h>
 #include <class_libentry.h>
 #include <generate_alias_info.h>
+#include <thread_pool.h>
 
 #include <symbol_tree_model_adapter.h>
 
+#include <atomic>
+
 
 bool SYMBOL_TREE_MODEL_ADAPTER::m_show_progress = true;
 
@@ -64,20 +68,83 @@ void SYMBOL_TREE_MODEL_ADAPTER::AddLibraries( const std::vector<wxString>& aNick
                                     aNicknames.size(), aParent );
     }
 
-    unsigned int ii = 0;
-
-    for( const auto& nickname : aNicknames )
+    struct LOADED_LIB
     {
-        if( prg && wxGetUTCTimeMillis() > nextUpdate )
+        std::vector<LIB_PART*> m_Symbols;
+        wxString               m_Error;
+        std::atomic<bool>      m_Done{ false };
+    };
+
+    bool                    onlyPowerSymbols = ( GetFilter() == CMP_FILTER_POWER );
+    std::vector<LOADED_LIB> libs( aNicknames.size() );
+    size_t                  added = 0;
+
+    // Find the rows here: it creates their plugins and indexes the table, so that the
+    // loaders only read the table
+    for( const wxString& nickname : aNicknames )
+        m_libs->FindRow( nickname );
+
+    // The libraries are added to the tree on this thread, in the order of aNicknames, as
+    // soon as they are loaded
+    auto addLoaded = [&]()
+    {
+        while( added < libs.size() && libs[added].m_Done.load() )
+        {
+            LOADED_LIB&     lib = libs[added];
+            const wxString& nickname = aNicknames[added];
+
+            if( !lib.m_Error.IsEmpty() )
+            {
+                wxLogError( wxString::Format( _( "Error loading symbol library %s.\n\n%s" ),
+                                              nickname,
+                                              lib.m_Error ) );
+            }
+            else if( lib.m_Symbols.size() > 0 )
+            {
+                std::vector<LIB_TREE_ITEM*> comp_list( lib.m_Symbols.begin(),
+                                                       lib.m_Symbols.end() );
+
+                DoAddLibrary( nickname, m_libs->GetDescription( nickname ), comp_list, false );
+            }
+
+            added++;
+        }
+
+        if( prg && added < aNicknames.size() && wxGetUTCTimeMillis() > nextUpdate )
         {
-            prg->Update( ii, wxString::Format( _( "Loading library \"%s\"" ), nickname ) );
+            prg->Update( added, wxString::Format( _( "Loading library \"%s\"" ),
+                                                  aNicknames[added] ) );
             nextUpdate = wxGetUTCTimeMillis() + PROGRESS_INTERVAL_MILLIS;
         }
+    };
 
-        AddLibrary( nickname );
-        ii++;
+    {
+        // The plugins switch to the C locale, which is global: it must be switched before
+        // the loaders start, and restored once they are all done
+        LOCALE_IO toggle;
+
+        THREAD_POOL::GetInstance().ParallelFor( aNicknames.size(),
+                [&]( size_t aIdx )
+                {
+                    LOADED_LIB& lib = libs[aIdx];
+
+                    try
+                    {
+                        m_libs->LoadSymbolLib( lib.m_Symbols, aNicknames[aIdx],
+                                               onlyPowerSymbols );
+                    }
+                    catch( const IO_ERROR& ioe )
+                    {
+                        lib.m_Error = ioe.What();
+                    }
+
+                    lib.m_Done.store( true );
+                },
+                addLoaded );
     }
 
+    addLoaded();
+
     m_tree.AssignIntrinsicRanks();
 
     if( prg )
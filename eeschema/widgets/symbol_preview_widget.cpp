@@ -94,11 +94,18 @@ SYMBOL_PREVIEW_WIDGET::SYMBOL_PREVIEW_WIDGET( wxWindow* aParent, KIWAY& aKiway,
 
 
 SYMBOL_PREVIEW_WIDGET::~SYMBOL_PREVIEW_WIDGET()
+{
+    clearPreviewItem();
+}
+
+
+void SYMBOL_PREVIEW_WIDGET::clearPreviewItem()
 {
     if( m_previewItem )
         m_preview->GetView()->Remove( m_previewItem );
 
-    delete m_previewItem;
+    m_previewItem = nullptr;
+    m_previewPart.reset();
 }
 
 
@@ -151,14 +158,12 @@ void SYMBOL_PREVIEW_WIDGET::DisplaySymbol( const LIB_ID& aSymbolID, int aUnit, i
 {
     KIGFX::VIEW* view = m_preview->GetView();
     auto settings = static_cast<KIGFX::SCH_RENDER_SETTINGS*>( view->GetPainter()->GetSettings() );
-    std::unique_ptr< LIB_PART > symbol;
+    std::shared_ptr<const LIB_PART> symbol;
 
     try
     {
-        LIB_PART* tmp = m_kiway.Prj().SchSymbolLibTable()->LoadSymbol( aSymbolID );
-
-        if( tmp )
-            symbol = tmp->Flatten();
+        // This will flatten derived parts so that the correct final symbol can be shown.
+        symbol = m_kiway.Prj().SchSymbolLibTable()->LoadFlattenedSymbol( aSymbolID );
     }
     catch( const IO_ERROR& ioe )
     {
@@ -168,17 +173,16 @@ void SYMBOL_PREVIEW_WIDGET::DisplaySymbol( const LIB_ID& aSymbolID, int aUnit, i
                                       ioe.What() ) );
     }
 
-    if( m_previewItem )
-    {
-        view->Remove( m_previewItem );
-        delete m_previewItem;
-        m_previewItem = nullptr;
-    }
+    clearPreviewItem();
 
     if( symbol )
     {
-        // This will flatten derived parts so that the correct final symbol can be shown.
-        m_previewItem = symbol.release();
+        // A view keeps its data in its items: a part shown by another view is copied
+        if( symbol->viewPrivData() )
+            symbol = std::make_shared<LIB_PART>( *symbol );
+
+        m_previewPart = symbol;
+        m_previewItem = const_cast<LIB_PART*>( symbol.get() );
 
         // If unit isn't specified for a multi-unit part, pick the first.  (Otherwise we'll
         // draw all of them.)
@@ -213,16 +217,14 @@ void SYMBOL_PREVIEW_WIDGET::DisplayPart( LIB_PART* aPart, int aUnit, int aConver
 {
     KIGFX::VIEW* view = m_preview->GetView();
 
-    if( m_previewItem )
-    {
-        view->Remove( m_previewItem );
-        delete m_previewItem;
-        m_previewItem = nullptr;
-    }
+    clearPreviewItem();
 
     if( aPart )
     {
-        m_previewItem = new LIB_PART( *aPart );
+        std::shared_ptr<LIB_PART> copy = std::make_shared<LIB_PART>( *aPart );
+
+        m_previewItem = copy.get();
+        m_previewPart = copy;
 
         // For symbols having a De Morgan body style, use the first style
         auto settings = static_cast<KIGFX::SCH_RENDER_SETTINGS*>( view->GetPainter()->GetSettings() );
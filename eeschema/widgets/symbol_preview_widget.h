@@ -25,6 +25,8 @@
 #include <gal/gal_display_options.h>
 #include <class_draw_panel_gal.h>
 
+#include <memory>
+
 
 class LIB_ID;
 class LIB_PART;
@@ -73,10 +75,15 @@ private:
     wxStaticText*              m_status;
     wxSizer*                   m_statusSizer;
 
+    void clearPreviewItem();
+
     /**
-     * A local copy of the #LIB_PART to display on the canvas.
+     * The #LIB_PART to display on the canvas: a local copy, or a flattened part shared with
+     * the cache of its library (but never with another view, which keeps its data in the
+     * part).
      */
-    LIB_PART*                  m_previewItem;
+    std::shared_ptr<const LIB_PART> m_previewPart;
+    LIB_PART*                       m_previewItem;
 
     /// The bounding box of the current item
     BOX2I                      m_itemBBox;
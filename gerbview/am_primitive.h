@@ -194,11 +194,23 @@ struct APERTURE_MACRO
      * Function GetApertureMacroShape
      * Calculate the primitive shape for flashed items.
      * When an item is flashed, this is the shape of the item
+     * The shape is the one cached by D_CODE::GetMacroShape(), moved to aShapePos.
      * @param aParent = the parent GERBER_DRAW_ITEM which is actually drawn
      * @return The shape of the item
      */
     SHAPE_POLY_SET* GetApertureMacroShape( const GERBER_DRAW_ITEM* aParent, wxPoint aShapePos );
 
+    /**
+     * Function BuildApertureMacroShape
+     * Evaluate the primitives of the macro to build the shape flashed by aParent at aShapePos
+     * (without any cache).
+     * @param aParent = the parent GERBER_DRAW_ITEM, giving the D_CODE parameters
+     * @param aShapePos = the actual shape position
+     * @param aShape = the buffer to fill with the shape
+     */
+    void BuildApertureMacroShape( const GERBER_DRAW_ITEM* aParent, wxPoint aShapePos,
+                                  SHAPE_POLY_SET& aShape );
+
    /**
      * Function DrawApertureMacroShape
      * Draw the primitive shape for flashed items.
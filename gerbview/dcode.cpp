@@ -87,6 +87,35 @@ void D_CODE::Clear_D_CODE_Data()
     m_Rotation   = 0.0;
     m_EdgesCount = 0;
     m_Polygon.RemoveAllContours();
+    m_macroShape.RemoveAllContours();
+    m_macroShapeValid = false;
+}
+
+
+const SHAPE_POLY_SET& D_CODE::GetMacroShape( const GERBER_DRAW_ITEM* aParent )
+{
+    GBR_SHAPE_TRANSFORM transform = aParent->GetShapeTransform();
+
+    if( m_macroShapeValid && transform == m_macroShapeTransform )
+        return m_macroShape;
+
+    m_macroShape.RemoveAllContours();
+
+    if( m_Macro )
+    {
+        // Build the shape flashed at the origin, and remove the offset the item transform
+        // gives to the origin: what is left only depends on the shape transform
+        m_Macro->BuildApertureMacroShape( aParent, wxPoint( 0, 0 ), m_macroShape );
+        m_macroShape.Move( -VECTOR2I( aParent->GetABPosition( wxPoint( 0, 0 ) ) ) );
+
+        if( m_macroShape.OutlineCount() )
+            m_macroShape.CacheTriangulation();
+    }
+
+    m_macroShapeTransform = transform;
+    m_macroShapeValid = true;
+
+    return m_macroShape;
 }
 
 
@@ -75,6 +75,30 @@ enum APERTURE_DEF_HOLETYPE {
 struct APERTURE_MACRO;
 
 
+/**
+ * GBR_SHAPE_TRANSFORM
+ * is the part of the transform of a GERBER_DRAW_ITEM (see GERBER_DRAW_ITEM::GetABPosition())
+ * which changes the shape of a flash, i.e. all of it but the offsets.  The items flashing a
+ * D_CODE with the same GBR_SHAPE_TRANSFORM draw the same shape at different positions.
+ */
+struct GBR_SHAPE_TRANSFORM
+{
+    bool        m_UnitsMetric;
+    bool        m_SwapAxis;
+    bool        m_MirrorA;
+    bool        m_MirrorB;
+    wxRealPoint m_DrawScale;
+    double      m_Rotation;         ///< layer and image rotations, in degrees
+
+    bool operator==( const GBR_SHAPE_TRANSFORM& aOther ) const
+    {
+        return m_UnitsMetric == aOther.m_UnitsMetric && m_SwapAxis == aOther.m_SwapAxis
+               && m_MirrorA == aOther.m_MirrorA && m_MirrorB == aOther.m_MirrorB
+               && m_DrawScale == aOther.m_DrawScale && m_Rotation == aOther.m_Rotation;
+    }
+};
+
+
 /**
  * D_CODE
  * holds a gerber DCODE (also called Aperture) definition.
@@ -90,6 +114,10 @@ private:
      */
     std::vector<double>   m_am_params;
 
+    SHAPE_POLY_SET        m_macroShape;           ///< see GetMacroShape()
+    GBR_SHAPE_TRANSFORM   m_macroShapeTransform;  ///< the transform m_macroShape is built for
+    bool                  m_macroShapeValid;
+
 public:
     wxSize                m_Size;           ///< Horizontal and vertical dimensions.
     APERTURE_T            m_Shape;          ///< shape ( Line, rectangle, circle , oval .. )
@@ -122,6 +150,7 @@ public:
     void AppendParam( double aValue )
     {
         m_am_params.push_back( aValue );
+        m_macroShapeValid = false;
     }
 
     /**
@@ -151,11 +180,23 @@ public:
     void SetMacro( APERTURE_MACRO* aMacro )
     {
         m_Macro = aMacro;
+        m_macroShapeValid = false;
     }
 
 
     APERTURE_MACRO* GetMacro() const { return m_Macro; }
 
+    /**
+     * Function GetMacroShape
+     * returns the shape of the aperture macro of this D_CODE when flashed by \a aParent,
+     * relative to the position of the flash: it must be moved by
+     * aParent->GetABPosition( flash position ) to be drawn.
+     * The shape (with its triangulation) is built once and reused for all the flashes
+     * having the same GBR_SHAPE_TRANSFORM as \a aParent.
+     * @param aParent = a GERBER_DRAW_ITEM flashing this D_CODE
+     */
+    const SHAPE_POLY_SET& GetMacroShape( const GERBER_DRAW_ITEM* aParent );
+
     /**
      * Function ShowApertureType
      * returns a character string telling what type of aperture type \a aType is.
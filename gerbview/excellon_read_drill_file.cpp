@@ -242,7 +242,8 @@ static EXCELLON_CMD excellon_G_CmdList[] =
 };
 
 
-bool GERBVIEW_FRAME::Read_EXCELLON_File( const wxString& aFullFileName )
+bool GERBVIEW_FRAME::Read_EXCELLON_File( const wxString& aFullFileName,
+                                         EXCELLON_IMAGE* aLoadedImage )
 {
     wxString msg;
     int layerId = GetActiveLayer();      // current layer used in GerbView
@@ -253,10 +254,20 @@ bool GERBVIEW_FRAME::Read_EXCELLON_File( const wxString& aFullFileName )
     if( gerber_layer )
         Erase_Current_DrawLayer( false );
 
-    EXCELLON_IMAGE* drill_layer = new EXCELLON_IMAGE( layerId );
+    EXCELLON_IMAGE* drill_layer = aLoadedImage;
+    bool            success = true;
 
-    // Read the Excellon drill file:
-    bool success = drill_layer->LoadFile( aFullFileName );
+    if( drill_layer )
+    {
+        drill_layer->m_GraphicLayer = layerId;
+    }
+    else
+    {
+        drill_layer = new EXCELLON_IMAGE( layerId );
+
+        // Read the Excellon drill file:
+        success = drill_layer->LoadFile( aFullFileName );
+    }
 
     if( !success )
     {
@@ -388,6 +399,7 @@ bool EXCELLON_IMAGE::LoadFile( const wxString & aFullFileName )
     delete m_FileFunction;
     m_FileFunction = new X2_ATTRIBUTE_FILEFUNCTION( dummy );
 
+    BuildItemsIndex();
     m_InUse = true;
 
     return true;
@@ -36,6 +36,8 @@
 #include <gerbview_layer_widget.h>
 #include <wildcards_and_files_ext.h>
 #include <widgets/progress_reporter.h>
+#include <thread_pool.h>
+
 
 // HTML Messages used more than one time:
 #define MSG_NO_MORE_LAYER _( "<b>No more available layers</b> in Gerbview to load files" )
@@ -269,6 +271,61 @@ bool GERBVIEW_FRAME::loadListOfGerberAndDrillFiles( const wxString& aPath,
     // Create progress dialog (only used if more than 1 file to load
     std::unique_ptr<WX_PROGRESS_REPORTER> progress = nullptr;
 
+    // The files are independent: read them all in parallel first.  Adding their images to
+    // the frame and the view, below, stays on this thread and in the order of the list.
+    // A file which cannot be read is left to the loop, which reads it again to report it.
+    std::vector<std::unique_ptr<GERBER_FILE_IMAGE>> loadedImages( aFilenameList.GetCount() );
+
+    if( aFilenameList.GetCount() > 1 )
+    {
+        progress = std::make_unique<WX_PROGRESS_REPORTER>( this,
+                        _( "Loading Gerber files..." ), 2, false );
+        progress->Report( _( "Reading files..." ) );
+        progress->SetMaxProgress( aFilenameList.GetCount() );
+
+        // Switching the locale is not thread safe: do it once here, the parsers of the
+        // worker threads then only nest their LOCALE_IO in this one
+        LOCALE_IO toggleIo;
+
+        auto read_lambda = [&]( size_t i )
+        {
+            wxFileName fn = aFilenameList[i];
+
+            if( !fn.IsAbsolute() )
+                fn.SetPath( aPath );
+
+            if( fn.FileExists() )
+            {
+                std::unique_ptr<GERBER_FILE_IMAGE> image;
+                bool                               ok;
+
+                if( aFileType && (*aFileType)[i] == 1 )
+                {
+                    EXCELLON_IMAGE* drill = new EXCELLON_IMAGE( 0 );
+                    image.reset( drill );
+                    ok = drill->LoadFile( fn.GetFullPath() );
+                }
+                else
+                {
+                    image = std::make_unique<GERBER_FILE_IMAGE>( 0 );
+                    ok = image->LoadGerberFile( fn.GetFullPath() );
+                }
+
+                if( ok )
+                    loadedImages[i] = std::move( image );
+            }
+
+            progress->AdvanceProgress();
+        };
+
+        // The files are read by the workers while this thread refreshes the progress
+        THREAD_POOL::GetInstance().ParallelFor( loadedImages.size(), read_lambda,
+                                                [&]() { progress->KeepRefreshing(); } );
+
+        progress->AdvancePhase();
+        progress->SetMaxProgress( aFilenameList.GetCount() - 1 );
+    }
+
     for( unsigned ii = 0; ii < aFilenameList.GetCount(); ii++ )
     {
         filename = aFilenameList[ii];
@@ -290,15 +347,7 @@ bool GERBVIEW_FRAME::loadListOfGerberAndDrillFiles( const wxString& aPath,
 
         m_lastFileName = filename.GetFullPath();
 
-        if( !progress && ( aFilenameList.GetCount() > 1 ) )
-        {
-            progress = std::make_unique<WX_PROGRESS_REPORTER>( this,
-                            _( "Loading Gerber files..." ), 1, false );
-            progress->SetMaxProgress( aFilenameList.GetCount() - 1 );
-            progress->Report( wxString::Format( _("Loading %u/%zu %s" ), ii+1,
-                                            aFilenameList.GetCount(), m_lastFileName ) );
-        }
-        else if( progress )
+        if( progress )
         {
             progress->Report( wxString::Format( _("Loading %u/%zu %s" ), ii+1,
                                             aFilenameList.GetCount(), m_lastFileName ) );
@@ -309,37 +358,42 @@ bool GERBVIEW_FRAME::loadListOfGerberAndDrillFiles( const wxString& aPath,
 
         visibility[ layer ] = true;
 
-        if( aFileType && (*aFileType)[ii] == 1 )
+        bool isDrillFile = aFileType && (*aFileType)[ii] == 1;
+        bool read;
+
+        if( isDrillFile )
         {
-            LoadExcellonFiles( filename.GetFullPath() );
-            layer = GetActiveLayer();   // Loading NC drill file changes the active layer
+            read = Read_EXCELLON_File( filename.GetFullPath(),
+                        static_cast<EXCELLON_IMAGE*>( loadedImages[ii].release() ) );
         }
         else
         {
-            if( Read_GERBER_File( filename.GetFullPath() ) )
-            {
-                UpdateFileHistory( m_lastFileName );
+            read = Read_GERBER_File( filename.GetFullPath(), loadedImages[ii].release() );
+        }
+
+        if( read )
+        {
+            UpdateFileHistory( m_lastFileName, isDrillFile ? &m_drillFileHistory : nullptr );
+
+            layer = getNextAvailableLayer( layer );
 
-                layer = getNextAvailableLayer( layer );
+            if( layer == NO_AVAILABLE_LAYERS && ii < aFilenameList.GetCount()-1 )
+            {
+                success = false;
+                reporter.Report( MSG_NO_MORE_LAYER, RPT_SEVERITY_ERROR );
 
-                if( layer == NO_AVAILABLE_LAYERS && ii < aFilenameList.GetCount()-1 )
+                // Report the name of not loaded files:
+                ii += 1;
+                while( ii < aFilenameList.GetCount() )
                 {
-                    success = false;
-                    reporter.Report( MSG_NO_MORE_LAYER, RPT_SEVERITY_ERROR );
-
-                    // Report the name of not loaded files:
-                    ii += 1;
-                    while( ii < aFilenameList.GetCount() )
-                    {
-                        filename = aFilenameList[ii++];
-                        wxString txt = wxString::Format( MSG_NOT_LOADED, filename.GetFullName() );
-                        reporter.Report( txt, RPT_SEVERITY_ERROR );
-                    }
-                    break;
+                    filename = aFilenameList[ii++];
+                    wxString txt = wxString::Format( MSG_NOT_LOADED, filename.GetFullName() );
+                    reporter.Report( txt, RPT_SEVERITY_ERROR );
                 }
-
-                SetActiveLayer( layer, false );
+                break;
             }
+
+            SetActiveLayer( layer, false );
         }
 
         if( progress )
@@ -18,6 +18,8 @@
  */
 
 #include "gerber_collectors.h"
+#include <gbr_layout.h>
+#include <gerber_file_image_list.h>
 
 const KICAD_T GERBER_COLLECTOR::AllItems[] = {
     GERBER_LAYOUT_T,
@@ -60,7 +62,32 @@ void GERBER_COLLECTOR::Collect( EDA_ITEM* aItem, const KICAD_T aScanList[],
     // the Inspect() function.
     SetRefPos( aRefPos );
 
-    aItem->Visit( m_inspector, NULL, m_ScanTypes );
+    if( aItem->Type() == GERBER_LAYOUT_T )
+    {
+        // Only the items whose bounding box contains the point can be hit: ask the images
+        // for them instead of testing all the items
+        GERBER_FILE_IMAGE_LIST* images = static_cast<GBR_LAYOUT*>( aItem )->GetImagesList();
+        EDA_RECT                area( aRefPos, wxSize( 0, 0 ) );
+
+        for( unsigned layer = 0; layer < images->ImagesMaxCount(); ++layer )
+        {
+            GERBER_FILE_IMAGE* gerber = images->GetGbrImage( layer );
+
+            if( gerber == NULL )    // Graphic layer not yet used
+                continue;
+
+            gerber->QueryItems( area,
+                    [&]( GERBER_DRAW_ITEM* aDrawItem ) -> bool
+                    {
+                        Inspect( aDrawItem, NULL );
+                        return true;
+                    } );
+        }
+    }
+    else
+    {
+        aItem->Visit( m_inspector, NULL, m_ScanTypes );
+    }
 
     // record the length of the primary list before concatenating on to it.
     m_PrimaryLength = m_List.size();
@@ -37,6 +37,10 @@
 #include <geometry/shape_arc.h>
 #include <math/util.h>      // for KiROUND
 
+/// The net attributes of the items not given any
+static const GBR_NETLIST_METADATA s_noNetAttributes;
+
+
 GERBER_DRAW_ITEM::GERBER_DRAW_ITEM( GERBER_FILE_IMAGE* aGerberImageFile ) :
     EDA_ITEM( (EDA_ITEM*)NULL, GERBER_DRAW_ITEM_T )
 {
@@ -51,6 +55,7 @@ GERBER_DRAW_ITEM::GERBER_DRAW_ITEM( GERBER_FILE_IMAGE* aGerberImageFile ) :
     m_mirrorB       = false;
     m_drawScale.x   = m_drawScale.y = 1.0;
     m_lyrRotation   = 0;
+    m_netAttributes = &s_noNetAttributes;
 
     if( m_GerberImageFile )
         SetLayerParameters();
@@ -64,14 +69,7 @@ GERBER_DRAW_ITEM::~GERBER_DRAW_ITEM()
 
 void GERBER_DRAW_ITEM::SetNetAttributes( const GBR_NETLIST_METADATA& aNetAttributes )
 {
-    m_netAttributes = aNetAttributes;
-
-    if( ( m_netAttributes.m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_CMP ) ||
-        ( m_netAttributes.m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_PAD ) )
-        m_GerberImageFile->m_ComponentsList.insert( std::make_pair( m_netAttributes.m_Cmpref, 0 ) );
-
-    if( ( m_netAttributes.m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_NET ) )
-        m_GerberImageFile->m_NetnamesList.insert( std::make_pair( m_netAttributes.m_Netname, 0 ) );
+    m_netAttributes = m_GerberImageFile->InternNetAttributes( aNetAttributes );
 }
 
 
@@ -178,6 +176,39 @@ wxPoint GERBER_DRAW_ITEM::GetABPosition( const wxPoint& aXYPosition ) const
 }
 
 
+GBR_SHAPE_TRANSFORM GERBER_DRAW_ITEM::GetShapeTransform() const
+{
+    GBR_SHAPE_TRANSFORM transform;
+
+    transform.m_UnitsMetric = m_UnitsMetric;
+    transform.m_SwapAxis = m_swapAxis;
+    transform.m_MirrorA = m_mirrorA;
+    transform.m_MirrorB = m_mirrorB;
+    transform.m_DrawScale = m_drawScale;
+    transform.m_Rotation = m_lyrRotation + m_GerberImageFile->m_ImageRotation;
+
+    return transform;
+}
+
+
+SHAPE_POLY_SET& GERBER_DRAW_ITEM::GetABPolygon()
+{
+    if( m_ABPolygon.OutlineCount() == 0 && m_Polygon.OutlineCount() > 0 )
+    {
+        std::vector<VECTOR2I> pts = m_Polygon.COutline( 0 ).CPoints();
+
+        for( VECTOR2I& pt : pts )
+            pt = GetABPosition( pt );
+
+        SHAPE_LINE_CHAIN chain( pts );
+        chain.SetClosed( true );
+        m_ABPolygon.AddOutline( chain );
+    }
+
+    return m_ABPolygon;
+}
+
+
 wxPoint GERBER_DRAW_ITEM::GetXYPosition( const wxPoint& aABPosition ) const
 {
     // do the inverse transform made by GetABPosition
@@ -429,6 +460,7 @@ void GERBER_DRAW_ITEM::MoveAB( const wxPoint& aMoveVector )
     m_ArcCentre += xymove;
 
     m_Polygon.Move( VECTOR2I( xymove ) );
+    m_ABPolygon.RemoveAllContours();
 }
 
 
@@ -439,6 +471,7 @@ void GERBER_DRAW_ITEM::MoveXY( const wxPoint& aMoveVector )
     m_ArcCentre += aMoveVector;
 
     m_Polygon.Move( VECTOR2I( aMoveVector ) );
+    m_ABPolygon.RemoveAllContours();
 }
 
 
@@ -715,41 +748,41 @@ void GERBER_DRAW_ITEM::GetMsgPanelInfo( EDA_DRAW_FRAME* aFrame, std::vector<MSG_
     aList.emplace_back( _( "AB axis" ), msg, DARKRED );
 
     // Display net info, if exists
-    if( m_netAttributes.m_NetAttribType == GBR_NETLIST_METADATA::GBR_NETINFO_UNSPECIFIED )
+    if( m_netAttributes->m_NetAttribType == GBR_NETLIST_METADATA::GBR_NETINFO_UNSPECIFIED )
         return;
 
     // Build full net info:
     wxString net_msg;
     wxString cmp_pad_msg;
 
-    if( ( m_netAttributes.m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_NET ) )
+    if( ( m_netAttributes->m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_NET ) )
     {
         net_msg = _( "Net:" );
         net_msg << " ";
 
-        if( m_netAttributes.m_Netname.IsEmpty() )
+        if( m_netAttributes->m_Netname.IsEmpty() )
             net_msg << "<no net>";
         else
-            net_msg << UnescapeString( m_netAttributes.m_Netname );
+            net_msg << UnescapeString( m_netAttributes->m_Netname );
     }
 
-    if( ( m_netAttributes.m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_PAD ) )
+    if( ( m_netAttributes->m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_PAD ) )
     {
-        if( m_netAttributes.m_PadPinFunction.IsEmpty() )
+        if( m_netAttributes->m_PadPinFunction.IsEmpty() )
             cmp_pad_msg.Printf( _( "Cmp: %s  Pad: %s" ),
-                                m_netAttributes.m_Cmpref,
-                                m_netAttributes.m_Padname.GetValue() );
+                                m_netAttributes->m_Cmpref,
+                                m_netAttributes->m_Padname.GetValue() );
         else
             cmp_pad_msg.Printf( _( "Cmp: %s  Pad: %s  Fct %s" ),
-                                m_netAttributes.m_Cmpref,
-                                m_netAttributes.m_Padname.GetValue(),
-                                m_netAttributes.m_PadPinFunction.GetValue() );
+                                m_netAttributes->m_Cmpref,
+                                m_netAttributes->m_Padname.GetValue(),
+                                m_netAttributes->m_PadPinFunction.GetValue() );
     }
 
-    else if( ( m_netAttributes.m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_CMP ) )
+    else if( ( m_netAttributes->m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_CMP ) )
     {
         cmp_pad_msg = _( "Cmp:" );
-        cmp_pad_msg << " " << m_netAttributes.m_Cmpref;
+        cmp_pad_msg << " " << m_netAttributes->m_Cmpref;
     }
 
     aList.emplace_back( net_msg, cmp_pad_msg, DARKCYAN );
@@ -879,9 +912,13 @@ bool GERBER_DRAW_ITEM::HitTest( const wxPoint& aRefPos, int aAccuracy ) const
         }
 
     case GBR_SPOT_MACRO:
-        // Aperture macro polygons are already in absolute coordinates
-        auto p = GetDcodeDescr()->GetMacro()->GetApertureMacroShape( this, m_Start );
-        return p->Contains( VECTOR2I( aRefPos ), -1, aAccuracy );
+    {
+        // Aperture macro polygons are in absolute coordinates, relative to the flash position
+        const SHAPE_POLY_SET& shape = GetDcodeDescr()->GetMacroShape( this );
+        VECTOR2I              refPos = VECTOR2I( aRefPos ) - VECTOR2I( GetABPosition( m_Start ) );
+
+        return shape.Contains( refPos, -1, aAccuracy );
+    }
     }
 
     // TODO: a better analyze of the shape (perhaps create a D_CODE::HitTest for flashed items)
@@ -113,16 +113,18 @@ private:
     wxRealPoint m_drawScale;                // A and B scaling factor
     wxPoint     m_layerOffset;              // Offset for A and B axis, from OF parameter
     double      m_lyrRotation;              // Fine rotation, from OR parameter, in degrees
-    GBR_NETLIST_METADATA m_netAttributes;   ///< the string given by a %TO attribute set in aperture
-                                            ///< (dcode). Stored in each item, because %TO is
-                                            ///< a dynamic object attribute
+    const GBR_NETLIST_METADATA* m_netAttributes; ///< the string given by a %TO attribute set in
+                                            ///< aperture (dcode). Stored for each item, because
+                                            ///< %TO is a dynamic object attribute. Shared by the
+                                            ///< items of the image having the same attributes
+    SHAPE_POLY_SET m_ABPolygon;             ///< m_Polygon in A,B axis, see GetABPolygon()
 
 public:
     GERBER_DRAW_ITEM( GERBER_FILE_IMAGE* aGerberparams );
     ~GERBER_DRAW_ITEM();
 
     void SetNetAttributes( const GBR_NETLIST_METADATA& aNetAttributes );
-    const GBR_NETLIST_METADATA& GetNetAttributes() const { return m_netAttributes; }
+    const GBR_NETLIST_METADATA& GetNetAttributes() const { return *m_netAttributes; }
 
     /**
      * Function GetLayer
@@ -222,6 +224,21 @@ public:
      */
     wxPoint GetXYPosition( const wxPoint& aABPosition ) const;
 
+    /**
+     * Function GetShapeTransform
+     * @return the part of the transform of GetABPosition() which changes the shape of a flash
+     * (all of it but the offsets).
+     */
+    GBR_SHAPE_TRANSFORM GetShapeTransform() const;
+
+    /**
+     * Function GetABPolygon
+     * returns the first outline of m_Polygon (the region of a GBR_POLYGON item) in A,B axis.
+     * It is converted once, and kept (with its triangulation when drawn by OpenGL) for the
+     * next redraws, until the item is moved.
+     */
+    SHAPE_POLY_SET& GetABPolygon();
+
     /**
      * Function GetDcodeDescr
      * returns the GetDcodeDescr of this object, or NULL.
@@ -95,6 +95,7 @@ GERBER_FILE_IMAGE::GERBER_FILE_IMAGE( int aLayer ) :
 
     m_Selected_Tool = 0;
     m_FileFunction = NULL;          // file function parameters
+    m_lastNetAttributes = nullptr;
 
     ResetDefaultValues();
 
@@ -388,6 +389,78 @@ void GERBER_FILE_IMAGE::RemoveAttribute( X2_ATTRIBUTE& aAttribute )
 }
 
 
+void GERBER_FILE_IMAGE::BuildItemsIndex()
+{
+    std::vector<std::pair<GBR_ITEMS_RTREE::Rect, GERBER_DRAW_ITEM*>> items;
+
+    items.reserve( m_drawings.size() );
+
+    for( GERBER_DRAW_ITEM* item : m_drawings )
+    {
+        EDA_RECT bbox = item->GetBoundingBox();
+        bbox.Normalize();
+
+        items.push_back( { { { bbox.GetX(), bbox.GetY() },
+                             { bbox.GetRight(), bbox.GetBottom() } }, item } );
+    }
+
+    m_itemsIndex.reset( new GBR_ITEMS_RTREE() );
+    m_itemsIndex->BulkLoad( items );
+}
+
+
+const GBR_NETLIST_METADATA* GERBER_FILE_IMAGE::InternNetAttributes(
+        const GBR_NETLIST_METADATA& aNetAttributes )
+{
+    if( m_lastNetAttributes && *m_lastNetAttributes == aNetAttributes )
+        return m_lastNetAttributes;
+
+    std::vector<std::unique_ptr<GBR_NETLIST_METADATA>>& candidates =
+            m_netAttributesPool[ aNetAttributes.m_Netname ];
+
+    for( const std::unique_ptr<GBR_NETLIST_METADATA>& candidate : candidates )
+    {
+        if( *candidate == aNetAttributes )
+        {
+            m_lastNetAttributes = candidate.get();
+            return m_lastNetAttributes;
+        }
+    }
+
+    candidates.push_back( std::make_unique<GBR_NETLIST_METADATA>( aNetAttributes ) );
+    m_lastNetAttributes = candidates.back().get();
+
+    if( ( aNetAttributes.m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_CMP ) ||
+        ( aNetAttributes.m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_PAD ) )
+        m_ComponentsList.insert( std::make_pair( aNetAttributes.m_Cmpref, 0 ) );
+
+    if( ( aNetAttributes.m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_NET ) )
+        m_NetnamesList.insert( std::make_pair( aNetAttributes.m_Netname, 0 ) );
+
+    return m_lastNetAttributes;
+}
+
+
+void GERBER_FILE_IMAGE::QueryItems( const EDA_RECT& aArea,
+                                    const std::function<bool( GERBER_DRAW_ITEM* )>& aVisitor )
+{
+    if( !m_itemsIndex )
+        BuildItemsIndex();
+
+    EDA_RECT area = aArea;
+    area.Normalize();
+
+    const int min[2] = { area.GetX(), area.GetY() };
+    const int max[2] = { area.GetRight(), area.GetBottom() };
+
+    m_itemsIndex->Search( min, max,
+            [&]( GERBER_DRAW_ITEM* aItem ) -> bool
+            {
+                return aVisitor( aItem );
+            } );
+}
+
+
 SEARCH_RESULT GERBER_FILE_IMAGE::Visit( INSPECTOR inspector, void* testData, const KICAD_T scanTypes[] )
 {
     KICAD_T        stype;
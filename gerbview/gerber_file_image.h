@@ -25,6 +25,8 @@
 #ifndef GERBER_FILE_IMAGE_H
 #define GERBER_FILE_IMAGE_H
 
+#include <functional>
+#include <memory>
 #include <vector>
 #include <set>
 
@@ -32,6 +34,7 @@
 #include <gerber_draw_item.h>
 #include <am_primitive.h>
 #include <gbr_netlist_metadata.h>
+#include <geometry/rtree.h>
 
 // An useful macro used when reading gerber files;
 #define IsNumber( x ) ( ( ( (x) >= '0' ) && ( (x) <='9' ) )   \
@@ -115,6 +118,11 @@ class GERBER_FILE_IMAGE : public EDA_ITEM
     GERBER_LAYER       m_GBRLayerParams;                    // hold params for the current gerber layer
     GERBER_DRAW_ITEMS  m_drawings;                              // linked list of Gerber Items to draw
 
+    using GBR_ITEMS_RTREE = RTree<GERBER_DRAW_ITEM*, int, 2, double>;
+
+    std::unique_ptr<GBR_ITEMS_RTREE> m_itemsIndex;              // spatial index of m_drawings, built
+                                                                // when the file is loaded
+
 public:
     bool               m_InUse;                                 // true if this image is currently in use
                                                                 // (a file is loaded in it)
@@ -183,6 +191,11 @@ public:
     std::map<wxString, int> m_NetnamesList;                     // list of net names
 
 private:
+    // The distinct net attributes of the items, shared by all the items having them.
+    // Sorted by net name, they live as long as the image (and so its items).
+    std::map<wxString, std::vector<std::unique_ptr<GBR_NETLIST_METADATA>>> m_netAttributesPool;
+    const GBR_NETLIST_METADATA* m_lastNetAttributes;            // the last attributes interned
+
     wxArrayString      m_messagesList;                          // A list of messages created when reading a file
     int                m_hasNegativeItems;                      // true if the image is negative or has some negative items
                                                                 // Used to optimize drawing, because when there are no
@@ -290,8 +303,30 @@ public:
     void AddItemToList( GERBER_DRAW_ITEM* aItem )
     {
         m_drawings.push_back( aItem );
+        m_itemsIndex.reset();
     }
 
+    /**
+     * Build the spatial index of the items from their bounding boxes.  Called at the end of
+     * the load: the items do not move afterwards.
+     */
+    void BuildItemsIndex();
+
+    /**
+     * Call aVisitor for each item whose bounding box intersects aArea, until it returns false.
+     * The index is built first if the items changed since the last call.
+     */
+    void QueryItems( const EDA_RECT& aArea,
+                     const std::function<bool( GERBER_DRAW_ITEM* )>& aVisitor );
+
+    /**
+     * Return the shared copy of aNetAttributes, created on first use.  Consecutive items
+     * (all the draws of a net, or the flashes of a pad) are given the same attributes, so
+     * they are stored once per image and not in each item.
+     * The components and net names lists are updated when a new copy is created.
+     */
+    const GBR_NETLIST_METADATA* InternNetAttributes( const GBR_NETLIST_METADATA& aNetAttributes );
+
     /**
      * @return the last GERBER_DRAW_ITEM* item of the items list
      */
@@ -41,6 +41,7 @@ class GERBER_LAYER_WIDGET;
 class GBR_LAYER_BOX_SELECTOR;
 class GERBER_DRAW_ITEM;
 class GERBER_FILE_IMAGE;
+class EXCELLON_IMAGE;
 class GERBER_FILE_IMAGE_LIST;
 class REPORTER;
 
@@ -509,7 +510,14 @@ public:
      * @return true if file was opened successfully.
      */
     bool LoadGerberFiles( const wxString& aFileName );
-    bool Read_GERBER_File( const wxString&   GERBER_FullFileName );
+
+    /**
+     * Read a Gerber file on the active layer.
+     * @param aLoadedImage is the image of the file if it has already been read, or nullptr to
+     *                     read it now.  The frame takes ownership of it.
+     */
+    bool Read_GERBER_File( const wxString& GERBER_FullFileName,
+                           GERBER_FILE_IMAGE* aLoadedImage = nullptr );
 
     /**
      * function LoadExcellonFiles
@@ -520,7 +528,14 @@ public:
      * @return true if file was opened successfully.
      */
     bool LoadExcellonFiles( const wxString& aFileName );
-    bool Read_EXCELLON_File( const wxString& aFullFileName );
+
+    /**
+     * Read a NC drill file on the active layer.
+     * @param aLoadedImage is the image of the file if it has already been read, or nullptr to
+     *                     read it now.  The frame takes ownership of it.
+     */
+    bool Read_EXCELLON_File( const wxString& aFullFileName,
+                             EXCELLON_IMAGE* aLoadedImage = nullptr );
 
     /**
      * function LoadZipArchiveFileLoadZipArchiveFile
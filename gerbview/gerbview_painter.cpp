@@ -258,16 +258,11 @@ void GERBVIEW_PAINTER::draw( /*const*/ GERBER_DRAW_ITEM* aItem, int aLayer )
         if( !isFilled )
             m_gal->SetLineWidth( m_gerbviewSettings.m_outlineWidth );
 
-        std::vector<VECTOR2I> pts = aItem->m_Polygon.COutline( 0 ).CPoints();
+        // The region is converted to A,B axis (and triangulated) once, not at each redraw
+        SHAPE_POLY_SET& absolutePolygon = aItem->GetABPolygon();
 
-        for( auto& pt : pts )
-            pt = aItem->GetABPosition( pt );
-
-
-        SHAPE_POLY_SET   absolutePolygon;
-        SHAPE_LINE_CHAIN chain( pts );
-        chain.SetClosed( true );
-        absolutePolygon.AddOutline( chain );
+        if( absolutePolygon.OutlineCount() == 0 )
+            break;
 
         // Degenerated polygons (having < 3 points) are drawn as lines
         // to avoid issues in draw polygon functions
@@ -278,7 +273,7 @@ void GERBVIEW_PAINTER::draw( /*const*/ GERBER_DRAW_ITEM* aItem, int aLayer )
             // On Opengl, a not convex filled polygon is usually drawn by using triangles as primitives.
             // CacheTriangulation() can create basic triangle primitives to draw the polygon solid shape
             // on Opengl
-            if( m_gal->IsOpenGlEngine() )
+            if( m_gal->IsOpenGlEngine() && !absolutePolygon.IsTriangulationUpToDate() )
                 absolutePolygon.CacheTriangulation();
 
             m_gal->DrawPolygon( absolutePolygon );
@@ -565,20 +560,26 @@ void GERBVIEW_PAINTER::drawFlashedShape( GERBER_DRAW_ITEM* aItem, bool aFilled )
 void GERBVIEW_PAINTER::drawApertureMacro( GERBER_DRAW_ITEM* aParent, bool aFilled )
 {
     D_CODE* code = aParent->GetDcodeDescr();
-    APERTURE_MACRO* macro = code->GetMacro();
 
-    SHAPE_POLY_SET* macroShape = macro->GetApertureMacroShape( aParent, aParent->m_Start );
+    // The shape (and its triangulation) is shared by all the flashes of the D_CODE with the
+    // same orientation: it is only moved to the flash position
+    const SHAPE_POLY_SET& macroShape = code->GetMacroShape( aParent );
 
     if( !m_gerbviewSettings.m_polygonFill )
         m_gal->SetLineWidth( m_gerbviewSettings.m_outlineWidth );
 
+    m_gal->Save();
+    m_gal->Translate( VECTOR2D( aParent->GetABPosition( aParent->m_Start ) ) );
+
     if( !aFilled )
     {
-        for( int i = 0; i < macroShape->OutlineCount(); i++ )
-            m_gal->DrawPolyline( macroShape->COutline( i ) );
+        for( int i = 0; i < macroShape.OutlineCount(); i++ )
+            m_gal->DrawPolyline( macroShape.COutline( i ) );
     }
     else
-        m_gal->DrawPolygon( *macroShape );
+        m_gal->DrawPolygon( macroShape );
+
+    m_gal->Restore();
 }
 
 
@@ -35,9 +35,12 @@
 #include <html_messagebox.h>
 #include <macros.h>
 
+#include <vector>
+
 /* Read a gerber file, RS274D, RS274X or RS274X2 format.
  */
-bool GERBVIEW_FRAME::Read_GERBER_File( const wxString& GERBER_FullFileName )
+bool GERBVIEW_FRAME::Read_GERBER_File( const wxString& GERBER_FullFileName,
+                                       GERBER_FILE_IMAGE* aLoadedImage )
 {
     wxString msg;
 
@@ -50,11 +53,21 @@ bool GERBVIEW_FRAME::Read_GERBER_File( const wxString& GERBER_FullFileName )
         Erase_Current_DrawLayer( false );
     }
 
-    gerber = new GERBER_FILE_IMAGE( layer );
+    bool success = true;
 
-    // Read the gerber file. The image will be added only if it can be read
-    // to avoid broken data.
-    bool success = gerber->LoadGerberFile( GERBER_FullFileName );
+    if( aLoadedImage )
+    {
+        gerber = aLoadedImage;
+        gerber->m_GraphicLayer = layer;
+    }
+    else
+    {
+        gerber = new GERBER_FILE_IMAGE( layer );
+
+        // Read the gerber file. The image will be added only if it can be read
+        // to avoid broken data.
+        success = gerber->LoadGerberFile( GERBER_FullFileName );
+    }
 
     if( !success )
     {
@@ -111,8 +124,6 @@ bool GERBVIEW_FRAME::Read_GERBER_File( const wxString& GERBER_FullFileName )
 // size of a single line of text from a gerber file.
 // warning: some files can have *very long* lines, so the buffer must be large.
 #define GERBER_BUFZ 1000000
-// A large buffer to store one line
-static char lineBuffer[GERBER_BUFZ+1];
 
 bool GERBER_FILE_IMAGE::LoadGerberFile( const wxString& aFullFileName )
 {
@@ -135,6 +146,11 @@ bool GERBER_FILE_IMAGE::LoadGerberFile( const wxString& aFullFileName )
 
     wxString msg;
 
+    // A large buffer to store one line.  It is not static: several files can be read at the
+    // same time by different threads.
+    std::vector<char> buffer( GERBER_BUFZ + 1 );
+    char*             lineBuffer = buffer.data();
+
     while( true )
     {
         if( fgets( lineBuffer, GERBER_BUFZ, m_Current_File ) == NULL )
@@ -219,6 +235,7 @@ bool GERBER_FILE_IMAGE::LoadGerberFile( const wxString& aFullFileName )
 
     fclose( m_Current_File );
 
+    BuildItemsIndex();
     m_InUse = true;
 
     return true;
@@ -24,6 +24,8 @@
 #ifndef ADVANCED_CFG__H
 #define ADVANCED_CFG__H
 
+#include <wx/string.h>
+
 class wxConfigBase;
 
 /**
@@ -83,6 +85,41 @@ public:
      */
     int m_coroutineStackSize;
 
+    /**
+     * Number of threads drawing the cached items of the Cairo canvas (0 for one per core)
+     */
+    int m_CairoRenderThreads;
+
+    /**
+     * Save the boards and schematics gzip compressed (they are read back either way)
+     */
+    bool m_CompressSavedFiles;
+
+    /**
+     * Save the connections of the boards next to them, to reopen them faster
+     */
+    bool m_SaveConnectivitySnapshots;
+
+    /**
+     * Number of worker threads of the THREAD_POOL (0 for one per core)
+     */
+    int m_MaxThreads;
+
+    /**
+     * Keep the zone fills of the undo and redo lists compressed
+     */
+    bool m_CompactUndoFills;
+
+    /**
+     * File the TRACE_EVENTS are saved in when the application exits (empty to not record them)
+     */
+    wxString m_TraceEventsFile;
+
+    /**
+     * Estimate the memory held by the big subsystems (see MEMORY_ACCOUNTING)
+     */
+    bool m_MemoryAccounting;
+
 
 private:
     ADVANCED_CFG();
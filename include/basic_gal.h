@@ -26,6 +26,7 @@
 #define BASIC_GAL_H
 
 #include <eda_rect.h>
+#include <mutex>
 
 #include <gal/stroke_font.h>
 #include <gal/graphics_abstraction_layer.h>
@@ -62,6 +63,10 @@ public:
     wxDC* m_DC;
     COLOR4D m_Color;
 
+    /// basic_gal is shared by the code drawing, plotting and measuring texts, which can run
+    /// in several threads (the plots of PlotBoardLayers()): lock this mutex while using it
+    std::mutex m_Mutex;
+
 private:
     TRANSFORM_PRM m_transform;
     std::stack <TRANSFORM_PRM>  m_transformHistory;
@@ -117,6 +122,7 @@ public:
      * @param aPointList is a list of 2D-Vectors containing the polyline points.
      */
     virtual void DrawPolyline( const std::deque<VECTOR2D>& aPointList ) override;
+    virtual void DrawPolyline( const VECTOR2D aPointList[], int aListSize ) override;
 
     /** Start and end points are defined as 2D-Vectors.
      * @param aStartPoint   is the start point of the line.
@@ -149,6 +155,9 @@ private:
     // Apply the roation/translation transform to aPoint
     const VECTOR2D transform( const VECTOR2D& aPoint ) const;
 
+    // Draw a polyline given in the final coordinates
+    void doDrawPolyline( const std::vector<wxPoint>& aLocalPointList );
+
     // A clip box, to clip drawings in a wxDC (mandatory to avoid draw issues)
     EDA_RECT  m_clipBox;        // The clip box
     bool      m_isClipped;      // Allows/disallows clipping
@@ -60,6 +60,7 @@ private:
                                     // to internal KiCad units
                                     // Usually does not change
     int       m_ppi;                // the bitmap definition. the default is 300PPI
+    int       m_imageId;            // a unique id, changed each time the image data changes
 
 
 public:
@@ -87,8 +88,16 @@ public:
     {
         delete m_image;
         m_image = aImage;
+        updateImageId();
     }
 
+    /**
+     * @return an id unique to the current image data of this bitmap.
+     * It changes each time the image data changes, and is never shared by two bitmaps,
+     * so it can be used to cache what is built from the image data.
+     */
+    int GetImageID() const { return m_imageId; }
+
     double GetScale() const { return m_scale; }
     void SetScale( double aScale ) { m_scale = aScale; }
 
@@ -97,7 +106,11 @@ public:
      * Rebuild the internal bitmap used to draw/plot image
      * must be called after a m_image change
      */
-    void RebuildBitmap() { *m_bitmap = wxBitmap( *m_image ); }
+    void RebuildBitmap()
+    {
+        *m_bitmap = wxBitmap( *m_image );
+        updateImageId();
+    }
 
     void SetBitmap( wxBitmap* aBitMap )
     {
@@ -247,6 +260,10 @@ public:
      */
     void PlotImage( PLOTTER* aPlotter, const wxPoint& aPos,
                     KIGFX::COLOR4D aDefaultColor, int aDefaultPensize );
+
+private:
+    /// Give a new unique id to the image data, after it was changed
+    void updateImageId();
 };
 
 
@@ -213,6 +213,7 @@ public:
     NETCLASSES                       m_NetClasses;
     std::vector<DRC_SELECTOR*>       m_DRCRuleSelectors;
     std::vector<DRC_RULE*>           m_DRCRules;
+    std::shared_ptr<DRC_RULE_TABLE>  m_DRCRuleTable;     // m_DRCRuleSelectors, compiled
 
     // Temporary storage for rule matching.
     std::vector<DRC_SELECTOR*>       m_matched;
@@ -186,6 +186,15 @@ public:
      */
     void SetStealsFocus( bool aStealsFocus ) { m_stealsFocus = aStealsFocus; }
 
+    /**
+     * Show or hide the rendering statistics (frame times, drawn items, GPU memory) on top
+     * of the view.  The same figures are traced, one line per frame, to the traceGalProfile
+     * trace mask.
+     */
+    void SetShowFrameStats( bool aShow );
+
+    bool GetShowFrameStats() const { return m_showFrameStats; }
+
     /**
      * Function SetCurrentCursor
      * Set the current cursor shape for this panel
@@ -215,6 +224,9 @@ protected:
     void onShowTimer( wxTimerEvent& aEvent );
     void onSetCursor( wxSetCursorEvent& event );
 
+    ///> Draws the statistics of the previous frame on the overlay target
+    void drawFrameStats();
+
     static const int MinRefreshPeriod = 17;      ///< 60 FPS.
 
     wxCursor                 m_currentCursor;    ///< Current mouse cursor shape id.
@@ -261,6 +273,15 @@ protected:
     /// Flag to indicate whether the panel should take focus at certain times (when moused over,
     /// and on various mouse/key events)
     bool                     m_stealsFocus;
+
+    /// Are the rendering statistics shown on top of the view?
+    bool                     m_showFrameStats;
+
+    /// Durations of the steps of the last frame, in milliseconds
+    double                   m_updateItemsTime;
+    double                   m_clearTargetsTime;
+    double                   m_redrawTime;
+    double                   m_frameTime;
 };
 
 #endif
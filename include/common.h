@@ -114,6 +114,21 @@ private:
 
 extern KIID niluuid;
 
+
+#ifndef SWIG
+namespace std
+{
+    template <>
+    struct hash<KIID>
+    {
+        size_t operator()( const KIID& aId ) const
+        {
+            return aId.Hash();
+        }
+    };
+}
+#endif
+
 // declare KIID_VECT_LIST as std::vector<KIID> both for c++ and swig:
 DECL_VEC_FOR_SWIG( KIID_VECT_LIST, KIID )
 
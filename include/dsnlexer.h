@@ -70,6 +70,9 @@ enum DSN_SYNTAX_T {
 };
 
 
+class KEYWORD_HASH;
+
+
 /**
  * DSNLEXER
  * implements a lexical analyzer for the SPECCTRA DSN file format.  It
@@ -110,7 +113,8 @@ protected:
 
     const KEYWORD*      keywords;               ///< table sorted by CMake for bsearch()
     unsigned            keywordCount;           ///< count of keywords table
-    KEYWORD_MAP         keyword_hash;           ///< fast, specialized "C string" hashtable
+    const KEYWORD_HASH* keywordHash;            ///< perfect hash of keywords[], shared by
+                                                ///< all the lexers of the same table
 
     void init();
 
@@ -155,6 +159,19 @@ protected:
         return false;
     }
 
+    /**
+     * Function readListText
+     * appends to \a aText the raw text of the list whose opening parenthesis was already
+     * read, up to and including its closing parenthesis, without tokenizing it.  The quoted
+     * strings and the comment lines are skipped as NextTok() does.  The next token follows
+     * the closing parenthesis.
+     *
+     * This lets a parser keep the text of a list to parse it later, e.g. on another thread.
+     *
+     * @throw IO_ERROR if the end of the input is reached first.
+     */
+    void readListText( std::string& aText );
+
 #endif
 
 public:
@@ -29,6 +29,8 @@
 #define _EAGLE_PARSER_H_
 
 #include <cerrno>
+#include <functional>
+#include <memory>
 #include <unordered_map>
 
 #include <wx/xml/xml.h>
@@ -365,6 +367,90 @@ public:
  */
 NODE_MAP MapChildren( wxXmlNode* aCurrentNode );
 
+
+/**
+ * EAGLE_XML_READER
+ * reads an Eagle XML file sequentially, and hands over the elements of chosen paths as soon
+ * as they are read.
+ *
+ * Only the elements of the handled paths are built, as wxXmlNode trees like those of
+ * wxXmlDocument, and freed once handled unless the handler keeps them.  The rest of the
+ * document is skipped.  The memory used is then bounded by the largest handled element,
+ * instead of the whole document.
+ */
+class EAGLE_XML_READER
+{
+public:
+    ///> Receives an element and its children
+    typedef std::function<void( std::unique_ptr<wxXmlNode> aNode )> ELEMENT_HANDLER;
+
+    ///> Receives an element with its attributes only, when it starts
+    typedef std::function<void( const wxXmlNode& aNode )> START_HANDLER;
+
+    /**
+     * Function OnElement
+     * handles the elements at \a aPath, given as the names of their ancestors and their own
+     * name separated by slashes (e.g. "eagle/drawing/board/signals/signal").
+     */
+    void OnElement( const wxString& aPath, ELEMENT_HANDLER aHandler );
+
+    /**
+     * Function OnStart
+     * handles the start of the elements at \a aPath, whose children are not built.
+     */
+    void OnStart( const wxString& aPath, START_HANDLER aHandler );
+
+    /**
+     * Function Parse
+     * reads the file and calls the handlers, in the order of the document.
+     * @throw IO_ERROR if the file cannot be read, XML_PARSER_ERROR if it is not well formed,
+     *        and whatever the handlers throw.
+     */
+    void Parse( const wxString& aFileName );
+
+private:
+    struct OPEN_ELEMENT
+    {
+        wxString   m_name;
+        size_t     m_pathLength;    ///< length of the path of the parent
+        wxXmlNode* m_node;          ///< the node being built, nullptr if skipped
+        wxXmlNode* m_lastChild;
+        const ELEMENT_HANDLER* m_handler;   ///< set for the root of the handled element
+    };
+
+    bool fillBuffer();
+    int  getChar();
+    int  peekChar();
+    bool skipPast( const char* aEnd );
+
+    void skipDeclaration();
+    void readStartTag();
+    void readEndTag();
+    void readText( int aFirst );
+    void readCData();
+    void readEntity( std::string& aText );
+    std::string readName( int aFirst );
+    std::string readAttributeValue( bool aDecode );
+
+    void endElement();
+    void addChild( wxXmlNode* aNode );
+
+    [[noreturn]] void error( const wxString& aMessage ) const;
+
+    std::unordered_map<wxString, ELEMENT_HANDLER> m_elementHandlers;
+    std::unordered_map<wxString, START_HANDLER>   m_startHandlers;
+
+    FILE*                       m_file = nullptr;
+    std::vector<char>           m_buffer;
+    size_t                      m_bufferPos = 0;
+    size_t                      m_bufferLen = 0;
+    int                         m_line = 1;
+
+    wxString                    m_path;
+    std::vector<OPEN_ELEMENT>   m_open;
+    std::unique_ptr<wxXmlNode>  m_root;          ///< the element being built
+};
+
 ///> Convert an Eagle curve end to a KiCad center for S_ARC
 wxPoint ConvertArcCenter( const wxPoint& aStart, const wxPoint& aEnd, double aAngle );
 
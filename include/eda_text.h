@@ -32,6 +32,8 @@
 #include "kicad_string.h"
 #include "painter.h"
 
+#include <memory>
+
 class SHAPE_POLY_SET;
 
 using KIGFX::RENDER_SETTINGS;
@@ -100,6 +102,13 @@ struct TEXT_EFFECTS
 
     void Bit( int aBit, bool aValue )   { aValue ? bits |= (1<<aBit) : bits &= ~(1<<aBit); }
     bool Bit( int aBit ) const          { return bits & (1<<aBit); }
+
+    bool operator==( const TEXT_EFFECTS& aOther ) const
+    {
+        return bits == aOther.bits && hjustify == aOther.hjustify
+               && vjustify == aOther.vjustify && size == aOther.size
+               && penwidth == aOther.penwidth && angle == aOther.angle && pos == aOther.pos;
+    }
 };
 
 
@@ -278,6 +287,21 @@ public:
      */
     void TransformTextShapeToSegmentList( std::vector<wxPoint>& aCornerBuffer ) const;
 
+    /**
+     * Return the segments of the shown text shape, 2 points per segment, laid out with the
+     * given orientation and pen width.
+     *
+     * The segments are cached until the text or its attributes change, so that the consumers
+     * of the text shape (DRC, zone filler, 3D viewer) do not run the stroke font layout again.
+     * Can be called from several threads.
+     *
+     * @param aAngle = the orientation of the text in 0.1 degrees (the draw orientation of
+     *                 footprint texts)
+     * @param aPenWidth = the pen width of the layout, 0 for the width of the bold text
+     */
+    std::shared_ptr<const std::vector<wxPoint>> GetStrokeSegments( double aAngle,
+                                                                   int aPenWidth ) const;
+
     /**
      * Convert the text bounding box to a rectangular polygon depending on the text
      * orientation, the bounding box is not always horizontal or vertical
@@ -371,6 +395,20 @@ private:
 
     TEXT_EFFECTS  m_e;                    // Private bitflags for text styling.  API above
                                           // provides accessor funcs.
+
+    /// The segments of the text shape, and the text and attributes they were laid out for
+    struct STROKE_SEGMENTS
+    {
+        wxString             m_Text;
+        TEXT_EFFECTS         m_Effects;
+        double               m_Angle;
+        int                  m_PenWidth;
+        std::vector<wxPoint> m_Segments;
+    };
+
+    // Replaced (never modified) when laid out again, shared by the copies of the text
+    mutable std::shared_ptr<const STROKE_SEGMENTS> m_strokeSegments;
+
     enum TE_FLAGS {
         TE_MIRROR,
         TE_ITALIC,
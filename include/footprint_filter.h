@@ -20,6 +20,9 @@
 #ifndef FOOTPRINT_FILTER_H
 #define FOOTPRINT_FILTER_H
 
+#include <map>
+#include <vector>
+
 #include <boost/iterator/iterator_facade.hpp>
 #include <eda_pattern_match.h>
 #include <footprint_info.h>
@@ -28,6 +31,10 @@
 /**
  * Footprint display filter. Takes a list of footprints and filtering settings,
  * and provides an iterable view of the filtered data.
+ *
+ * The filter indexes the footprints of its list (lower case names, libraries and pad counts)
+ * the first time it is iterated over: keep the filter, and change its criteria, to filter the
+ * same list again quickly.
  */
 class FOOTPRINT_FILTER
 {
@@ -46,7 +53,8 @@ public:
     FOOTPRINT_FILTER();
 
     /**
-     * Set the list to filter.
+     * Set the list to filter.  The list is indexed again, even if it is the same one: call
+     * it when the contents of the list have changed.
      */
     void SetList( FOOTPRINT_LIST& aList );
 
@@ -95,18 +103,14 @@ public:
         bool equal( ITERATOR const& aOther ) const;
         FOOTPRINT_INFO& dereference() const;
 
-        size_t            m_pos;
+        size_t            m_pos;        ///< in the m_candidates of the filter
         FOOTPRINT_FILTER* m_filter;
 
         /**
-         * Check if the stored component matches an item by footprint filter.
+         * Check if the stored component matches the item at \a aIndex of the list by
+         * footprint filter.
          */
-        bool FootprintFilterMatch( FOOTPRINT_INFO& aItem );
-
-        /**
-         * Check if the stored component matches an item by pin count.
-         */
-        bool PinCountMatch( FOOTPRINT_INFO& aItem );
+        bool FootprintFilterMatch( size_t aIndex );
     };
 
     /**
@@ -121,6 +125,17 @@ public:
     ITERATOR end();
 
 private:
+    /**
+     * Build the index of the list, if not done yet.
+     */
+    void buildIndex();
+
+    /**
+     * Set m_candidates, from the library and pin count criteria and the index, if they
+     * changed since the last time.
+     */
+    void prepare();
+
     /**
      * Filter setting constants. The filter type is a bitwise OR of these flags,
      * and only footprints matching all selected filter types are shown.
@@ -143,6 +158,20 @@ private:
 
     std::vector<std::unique_ptr<EDA_COMBINED_MATCHER>> m_pattern_filters;
     std::vector<std::unique_ptr<EDA_PATTERN_MATCH>>    m_footprint_filters;
+
+    /// For each footprint filter, whether it includes the library name (a ':')
+    std::vector<bool>                                  m_footprint_filters_with_lib;
+
+    // The index of the list, by position in the list
+    bool                                         m_indexed;
+    std::vector<wxString>                        m_lower_names;      ///< "name"
+    std::vector<wxString>                        m_lower_full_names; ///< "library:name"
+    std::map<wxString, std::vector<size_t>>      m_by_library;
+    std::map<unsigned, std::vector<size_t>>      m_by_pin_count;     ///< unique pad count
+
+    /// The positions of the footprints matching the library and pin count criteria
+    std::vector<size_t>                          m_candidates;
+    bool                                         m_candidates_valid;
 };
 
 #endif // FOOTPRINT_FILTER_H
@@ -207,8 +207,17 @@ public:
     {
     }
 
-    virtual void WriteCacheToFile( wxTextFile* aFile ) { };
-    virtual void ReadCacheFromFile( wxTextFile* aFile ) { };
+    /**
+     * Save the list to the cache directory \a aCachePath, one file per library.  Only the
+     * libraries read since the last save are written.
+     */
+    virtual void WriteCacheToFile( const wxString& aCachePath ) { };
+
+    /**
+     * Load the list from the cache directory \a aCachePath.  The libraries changed since
+     * they were cached are read again by the next ReadFootprintFiles().
+     */
+    virtual void ReadCacheFromFile( const wxString& aCachePath ) { };
 
     /**
      * @return the number of items stored in list
@@ -29,6 +29,9 @@
 #include <lib_table_base.h>
 #include <io_mgr.h>
 
+#include <mutex>
+#include <unordered_map>
+
 class MODULE;
 class FP_LIB_TABLE_GRID;
 
@@ -269,6 +272,10 @@ public:
      * Function FootprintLoadWithOptionalNickname
      * loads a footprint having @a aFootprintId with possibly an empty nickname.
      *
+     * A footprint without nickname is looked up in the index given by SetFootprintNameIndex(),
+     * and only searched for in each library in turn, alphabetically, without index or when
+     * the index is out of date.
+     *
      * @param aFootprintId the [nickname] & footprint name of the footprint to load.
      *
      * @return  MODULE* - if found caller owns it, else NULL if not found.
@@ -279,6 +286,22 @@ public:
      */
     MODULE* FootprintLoadWithOptionalNickname( const LIB_ID& aFootprintId );
 
+    /**
+     * Function SetFootprintNameIndex
+     * sets the index FootprintLoadWithOptionalNickname() finds the library of a footprint
+     * without nickname with.
+     *
+     * @param aIndex maps each footprint name to the first library of GetLogicalLibs() holding
+     *               a footprint of this name.
+     * @param aTimestamp is the GenerateTimestamp() of all the libraries when the index was
+     *                   built: a name missing from the index is searched for in the libraries
+     *                   only if they changed since.
+     */
+    void SetFootprintNameIndex( std::unordered_map<wxString, wxString> aIndex,
+                                long long aTimestamp );
+
+    bool HasFootprintNameIndex() const;
+
     /**
      * Function LoadGlobalTable
      * loads the global footprint library table into \a aTable.
@@ -294,6 +317,20 @@ public:
      */
     static bool LoadGlobalTable( FP_LIB_TABLE& aTable );
 
+    /**
+     * Start loading the global footprint library table (#GFootprintTable) on a background
+     * thread, with LoadGlobalTable(), not to delay the first frame.
+     *
+     * @param aOnError is called by the first GetGlobalLibTable() if the table cannot be loaded.
+     */
+    static void LoadGlobalTableInBackground( std::function<void( const IO_ERROR& )> aOnError );
+
+    /**
+     * @return the global footprint library table, once its loading started by
+     *         LoadGlobalTableInBackground() is done.
+     */
+    static FP_LIB_TABLE& GetGlobalLibTable();
+
     /**
      * Function GetGlobalTableFileName
      *
@@ -311,6 +348,13 @@ public:
      * KiCad on program start up, <b>if</b> it is not set already in the environment.
      */
     static const wxString GlobalPathEnvVariableName();
+
+private:
+    ///> The index of SetFootprintNameIndex(), guarded by m_fpNameIndexMutex as the footprint
+    ///> preview loads its footprints on a thread
+    std::unordered_map<wxString, wxString> m_fpNameIndex;
+    long long                              m_fpNameIndexTimestamp;
+    mutable std::mutex                     m_fpNameIndexMutex;
 };
 
 
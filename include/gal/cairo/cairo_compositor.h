@@ -71,6 +71,12 @@ public:
     /// @copydoc COMPOSITOR::ClearBuffer()
     virtual void ClearBuffer( const COLOR4D& aColor ) override;
 
+    /// @copydoc COMPOSITOR::SetClipRect()
+    virtual void SetClipRect( unsigned int aBufferHandle, const BOX2I* aRect ) override;
+
+    /// @copydoc COMPOSITOR::ScrollBuffer()
+    virtual void ScrollBuffer( unsigned int aBufferHandle, const VECTOR2I& aOffset ) override;
+
     /// @copydoc COMPOSITOR::DrawBuffer()
     virtual void DrawBuffer( unsigned int aBufferHandle ) override;
 
@@ -137,6 +143,10 @@ protected:
 
     cairo_antialias_t       m_currentAntialiasingMode;
 
+    /// The clipped buffer handle (0 if there is none) and its clipping rectangle
+    unsigned int            m_clipBuffer;
+    BOX2I                   m_clipRect;
+
     /**
      * Function clean()
      * performs freeing of resources.
@@ -31,6 +31,7 @@
 
 #include <map>
 #include <iterator>
+#include <vector>
 
 #include <cairo.h>
 
@@ -54,6 +55,7 @@
 namespace KIGFX
 {
 class CAIRO_COMPOSITOR;
+class CAIRO_BITMAP_CACHE;
 
 class CAIRO_GAL_BASE : public GAL
 {
@@ -292,6 +294,27 @@ protected:
     unsigned int                groupCounter;       ///< Counter used for generating keys for groups
     GROUP*                      currentGroup;       ///< Currently used group
 
+    /// The state changed by the commands of a group
+    struct GROUP_STATE
+    {
+        bool    m_isFillEnabled;
+        bool    m_isStrokeEnabled;
+        COLOR4D m_fillColor;
+        COLOR4D m_strokeColor;
+    };
+
+    /// A group drawing deferred to the next flushGroups() call
+    struct DEFERRED_GROUP
+    {
+        int            m_group;
+        cairo_matrix_t m_matrix;                    ///< Context matrix at DrawGroup() time
+    };
+
+    // Variables for the tiled rendering of groups
+    int                         renderThreads;      ///< Threads drawing the deferred groups
+    bool                        deferGroups;        ///< Are DrawGroup() calls deferred ?
+    std::vector<DEFERRED_GROUP> deferredGroups;     ///< Groups waiting to be drawn
+
     double lineWidth;
     double linePixelWidth;
     double lineWidthInPixels;
@@ -304,14 +327,31 @@ protected:
     cairo_t*            context;                ///< Cairo image
     cairo_surface_t*    surface;                ///< Cairo surface
 
-    /// List of surfaces that were created by painting images, to be cleaned up later
-    std::vector<cairo_surface_t*> imageSurfaces;
+    /// Image surfaces of the drawn bitmaps, converted once per bitmap change
+    std::unique_ptr<CAIRO_BITMAP_CACHE> bitmapCache;
 
     std::vector<cairo_matrix_t> xformStack;
 
     void flushPath();
     void storePath();                           ///< Store the actual path
 
+    /**
+     * @brief Executes the commands of a group on a context. The GAL state is not used, so
+     * several groups can be replayed on different contexts at the same time.
+     *
+     * @param aContext is the context to draw on.
+     * @param aGroupNumber is the group to be drawn.
+     * @param aState is the state before the group, updated by the group commands.
+     */
+    void replayGroup( cairo_t* aContext, int aGroupNumber, GROUP_STATE& aState ) const;
+
+    /**
+     * @brief Draws the deferred groups. The drawn part of the current context is split into
+     * horizontal tiles, each one rendered on its own thread into an image surface, and then
+     * painted onto the context in the tiles order.
+     */
+    void flushGroups();
+
     /**
      * @brief Blits cursor into the current screen.
      */
@@ -383,6 +423,12 @@ public:
 
     virtual void ClearTarget( RENDER_TARGET aTarget ) override;
 
+    /// @copydoc GAL::SetClipRect()
+    virtual bool SetClipRect( const BOX2I& aRect ) override;
+
+    /// @copydoc GAL::ScrollTargets()
+    virtual bool ScrollTargets( const VECTOR2I& aOffset ) override;
+
     /**
      * Function PostPaint
      * posts an event to m_paint_listener.  A post is used so that the actual drawing
@@ -414,6 +460,7 @@ protected:
     unsigned int            overlayBuffer;          ///< Handle to the overlay buffer
     RENDER_TARGET           currentTarget;          ///< Current rendering target
     bool                    validCompositor;        ///< Compositor initialization flag
+    bool                    mainBufferComplete;     ///< Does the main buffer hold a frame?
 
     // Variables related to wxWidgets
     wxWindow*               parentWindow;           ///< Parent window
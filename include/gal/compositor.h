@@ -31,6 +31,8 @@
 #ifndef COMPOSITOR_H_
 #define COMPOSITOR_H_
 
+#include <math/box2.h>
+
 namespace KIGFX
 {
 
@@ -95,6 +97,26 @@ public:
      */
     virtual void ClearBuffer( const COLOR4D& aColor ) = 0;
 
+    /**
+     * Function SetClipRect()
+     * restricts the drawing and the clearing of a buffer to a rectangle, so the rest of its
+     * contents is kept. Only one buffer may be clipped at a time.
+     *
+     * @param aBufferHandle is the handle of the clipped buffer.
+     * @param aRect is the clipping rectangle (in pixels of the output buffer), or nullptr to
+     * lift the clipping.
+     */
+    virtual void SetClipRect( unsigned int aBufferHandle, const BOX2I* aRect ) = 0;
+
+    /**
+     * Function ScrollBuffer()
+     * shifts the contents of a buffer. The pixels exposed by the shift are left undefined.
+     *
+     * @param aBufferHandle is the handle of the shifted buffer.
+     * @param aOffset is the shift (in pixels of the output buffer).
+     */
+    virtual void ScrollBuffer( unsigned int aBufferHandle, const VECTOR2I& aOffset ) = 0;
+
     /**
      * Function Begin()
      * Call this at the beginning of each frame
@@ -31,6 +31,7 @@
 #include <stack>
 #include <limits>
 
+#include <math/box2.h>
 #include <math/matrix3x3.h>
 
 #include <gal/color4d.h>
@@ -46,6 +47,28 @@ class BITMAP_BASE;
 namespace KIGFX
 {
 
+/**
+ * @brief Measures of the last frame drawn by a GAL, for the analysis of rendering performance.
+ *
+ * The times are in milliseconds, negative if the GAL does not measure them.
+ */
+struct GAL_FRAME_STATS
+{
+    ///> CPU time of the end of the frame: upload and drawing of the vertex containers,
+    ///> compositing and buffer swap
+    double m_endDrawingTime = -1.0;
+
+    ///> GPU time of drawing the vertex containers to the rendering targets
+    double m_gpuItemsTime = -1.0;
+
+    ///> GPU time of compositing the targets, antialiasing included
+    double m_gpuCompositingTime = -1.0;
+
+    ///> Memory used by the cached items (bytes)
+    size_t m_cacheMemory = 0;
+};
+
+
 /**
  * @brief Class GAL is the abstract interface for drawing on a 2D-surface.
  *
@@ -115,6 +138,24 @@ public:
     virtual void DrawPolyline( const VECTOR2D aPointList[], int aListSize ) {};
     virtual void DrawPolyline( const SHAPE_LINE_CHAIN& aLineChain ) {};
 
+    /**
+     * @brief Draw a set of polylines at once, used for the strokes of the glyphs of a text.
+     *
+     * @param aPoints are the points of all the polylines, one polyline after another.
+     * @param aSizes are the numbers of points of the polylines.
+     */
+    virtual void DrawPolylines( const std::vector<VECTOR2D>& aPoints,
+                                const std::vector<int>& aSizes )
+    {
+        const VECTOR2D* points = aPoints.data();
+
+        for( int size : aSizes )
+        {
+            DrawPolyline( points, size );
+            points += size;
+        }
+    };
+
     /**
      * @brief Draw a circle using world coordinates.
      *
@@ -825,6 +866,26 @@ public:
      */
     virtual void ClearTarget( RENDER_TARGET aTarget ) {};
 
+    /**
+     * @brief Restricts the clearing and the drawing of the cached and the non-cached targets
+     * to a part of the screen, until the end of the drawing. The rest of their contents is kept
+     * from the previous frame.
+     *
+     * @param aRect is the redrawn part of the screen (in pixels).
+     * @return false if the targets cannot be partially redrawn, they have to be redrawn in full.
+     */
+    virtual bool SetClipRect( const BOX2I& aRect ) { return false; };
+
+    /**
+     * @brief Shifts the contents of the cached and the non-cached targets, kept from the
+     * previous frame, by a number of pixels. The parts of the screen exposed by the shift have
+     * to be redrawn.
+     *
+     * @param aOffset is the shift (in pixels).
+     * @return false if the targets cannot be shifted, they have to be redrawn in full.
+     */
+    virtual bool ScrollTargets( const VECTOR2I& aOffset ) { return false; };
+
     /**
      * @brief Sets negative draw mode in the renderer
      *
@@ -1037,6 +1098,23 @@ public:
 
     virtual void EnableDepthTest( bool aEnabled = false ) {};
 
+    /**
+     * @brief Enables the measure of the frames, see GetFrameStats(). It has a small cost, so
+     * it is disabled by default.
+     */
+    void SetCollectFrameStats( bool aEnabled )
+    {
+        collectFrameStats = aEnabled;
+    }
+
+    /**
+     * @brief Returns the measures of the last frame, if they are collected.
+     */
+    const GAL_FRAME_STATS& GetFrameStats() const
+    {
+        return frameStats;
+    }
+
 protected:
 
     GAL_DISPLAY_OPTIONS&    options;
@@ -1091,6 +1169,9 @@ protected:
     bool               fullscreenCursor;       ///< Shape of the cursor (fullscreen or small cross)
     VECTOR2D           cursorPosition;         ///< Current cursor position (world coordinates)
 
+    bool               collectFrameStats;      ///< Should the frames be measured
+    GAL_FRAME_STATS    frameStats;             ///< Measures of the last frame
+
     /// Instance of object that stores information about how to draw texts
     STROKE_FONT        strokeFont;
 
@@ -26,6 +26,7 @@
 #define CACHED_CONTAINER_H_
 
 #include <gal/opengl/vertex_container.h>
+#include <memory_accounting.h>
 #include <map>
 #include <set>
 
@@ -54,6 +55,14 @@ public:
     ///> @copydoc VERTEX_CONTAINER::SetItem()
     virtual void SetItem( VERTEX_ITEM* aItem ) override;
 
+    /**
+     * Returns the item being modified, or NULL if there is none.
+     */
+    VERTEX_ITEM* GetItem() const
+    {
+        return m_item;
+    }
+
     ///> @copydoc VERTEX_CONTAINER::FinishItem()
     virtual void FinishItem() override;
 
@@ -67,9 +76,41 @@ public:
     virtual void Clear() override;
 
     /**
-     * Returns handle to the vertex buffer. It might be negative if the buffer is not initialized.
+     * Returns the number of vertex buffers storing the container data.
+     */
+    virtual unsigned int GetBufferCount() const
+    {
+        return 1;
+    }
+
+    /**
+     * Returns handle to a vertex buffer. It might be negative if the buffer is not initialized.
+     */
+    virtual unsigned int GetBufferHandle( unsigned int aBuffer = 0 ) const = 0;
+
+    /**
+     * Returns the container offset of the first vertex stored in a vertex buffer.
+     */
+    virtual unsigned int GetBufferOffset( unsigned int aBuffer ) const
+    {
+        return 0;
+    }
+
+    /**
+     * Returns the number of vertices a vertex buffer can store.
+     */
+    virtual unsigned int GetBufferSize( unsigned int aBuffer ) const
+    {
+        return GetSize();
+    }
+
+    /**
+     * Returns the index of the vertex buffer storing the vertex at a container offset.
      */
-    virtual unsigned int GetBufferHandle() const = 0;
+    virtual unsigned int FindBuffer( unsigned int aOffset ) const
+    {
+        return 0;
+    }
 
     /**
      * Returns true if vertex buffer is currently mapped.
@@ -106,6 +147,9 @@ protected:
     ///> Maximal vertex index number stored in the container
     unsigned int m_maxIndex;
 
+    ///> The memory of the vertices (declared last, to be removed first)
+    MEMORY_ACCOUNT m_memoryAccount;
+
     /**
      * Resizes the chunk that stores the current item to the given size. The current item has
      * its offset adjusted after the call, and the new chunk parameters are stored
@@ -116,6 +160,15 @@ protected:
      */
     bool reallocate( unsigned int aSize );
 
+    /**
+     * Makes room for a chunk of at least aSize vertices, when there is no free chunk large
+     * enough.  The default implementation defragments the container and doubles its size.
+     *
+     * @param aSize is the requested chunk size.
+     * @return false in case of failure (e.g. memory shortage)
+     */
+    virtual bool makeRoom( unsigned int aSize );
+
     /**
      * Removes empty spaces between chunks and optionally resizes the container.
      * After the operation there is continous space for storing vertices at the end of the container.
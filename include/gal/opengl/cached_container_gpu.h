@@ -27,11 +27,17 @@
 
 #include <gal/opengl/cached_container.h>
 
+#include <vector>
+
 namespace KIGFX
 {
 
 /**
  * @brief Specialization of CACHED_CONTAINER that stores data in video memory via memory mapping.
+ *
+ * The vertices are stored in a list of vertex buffers.  When the container is full, a new
+ * buffer is added to the list, so the stored data is never moved to grow the container.
+ * An item is always stored in a single buffer.
  */
 
 class CACHED_CONTAINER_GPU : public CACHED_CONTAINER
@@ -40,9 +46,35 @@ public:
     CACHED_CONTAINER_GPU( unsigned int aSize = DEFAULT_SIZE );
     ~CACHED_CONTAINER_GPU();
 
-    unsigned int GetBufferHandle() const override
+    unsigned int GetBufferCount() const override
+    {
+        return m_buffers.size();
+    }
+
+    unsigned int GetBufferHandle( unsigned int aBuffer = 0 ) const override
+    {
+        return m_buffers[aBuffer].m_handle;
+    }
+
+    unsigned int GetBufferOffset( unsigned int aBuffer ) const override
+    {
+        return m_buffers[aBuffer].m_offset;
+    }
+
+    unsigned int GetBufferSize( unsigned int aBuffer ) const override
+    {
+        return m_buffers[aBuffer].m_size;
+    }
+
+    ///> @copydoc CACHED_CONTAINER::FindBuffer()
+    unsigned int FindBuffer( unsigned int aOffset ) const override;
+
+    ///> @copydoc VERTEX_CONTAINER::GetVertices()
+    VERTEX* GetVertices( unsigned int aOffset ) const override
     {
-        return m_glBufferHandle;
+        const VERTEX_BUFFER& buffer = m_buffers[FindBuffer( aOffset )];
+
+        return buffer.m_vertices + ( aOffset - buffer.m_offset );
     }
 
     bool IsMapped() const override
@@ -56,26 +88,45 @@ public:
     ///> @copydoc VERTEX_CONTAINER::Unmap()
     void Unmap() override;
 
+    ///> @copydoc VERTEX_CONTAINER::Clear()
+    void Clear() override;
+
 protected:
+    ///> A vertex buffer storing a part of the container
+    struct VERTEX_BUFFER
+    {
+        GLuint       m_handle;      ///< Vertex buffer handle
+        unsigned int m_offset;      ///< Container offset of the first vertex in the buffer
+        unsigned int m_size;        ///< Number of vertices the buffer can store
+        VERTEX*      m_vertices;    ///< Mapped buffer memory, NULL if the buffer is not mapped
+    };
+
     ///> Flag saying if vertex buffer is currently mapped
     bool m_isMapped;
 
-    ///> Vertex buffer handle
-    unsigned int m_glBufferHandle;
+    ///> Vertex buffers, sorted by their offsets
+    std::vector<VERTEX_BUFFER> m_buffers;
+
+    /**
+     * Adds a vertex buffer at the end of the container.
+     *
+     * @param aSize is the buffer size, expressed in number of vertices
+     * @return false in case of failure (e.g. memory shortage)
+     */
+    bool addBuffer( unsigned int aSize );
 
-    ///> Flag saying whether it is safe to use glCopyBufferSubData
-    bool m_useCopyBuffer;
+    ///> @copydoc CACHED_CONTAINER::makeRoom()
+    bool makeRoom( unsigned int aSize ) override;
 
     /**
      * Function defragmentResize()
-     * removes empty spaces between chunks and optionally resizes the container.
-     * After the operation there is continous space for storing vertices at the end of the container.
+     * grows the container by adding a vertex buffer.  The stored data is not moved, so the
+     * container cannot be shrunk.
      *
      * @param aNewSize is the new size of container, expressed in number of vertices
      * @return false in case of failure (e.g. memory shortage)
      */
     bool defragmentResize( unsigned int aNewSize ) override;
-    bool defragmentResizeMemcpy( unsigned int aNewSize );
 };
 } // namespace KIGFX
 
@@ -60,7 +60,7 @@ public:
      * Function GetBufferHandle()
      * returns handle to the vertex buffer. It might be negative if the buffer is not initialized.
      */
-    unsigned int GetBufferHandle() const override
+    unsigned int GetBufferHandle( unsigned int aBuffer = 0 ) const override
     {
         return m_verticesBuffer;    // make common with CACHED_CONTAINER_RAM
     }
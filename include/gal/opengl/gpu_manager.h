@@ -26,7 +26,7 @@
 #define GPU_MANAGER_H_
 
 #include <gal/opengl/vertex_common.h>
-#include <boost/scoped_array.hpp>
+#include <vector>
 
 namespace KIGFX
 {
@@ -34,6 +34,7 @@ class SHADER;
 class VERTEX_CONTAINER;
 class CACHED_CONTAINER;
 class NONCACHED_CONTAINER;
+struct MESH_INSTANCE;
 
 /**
  * @brief Class to handle uploading vertices and indices to GPU in drawing purposes.
@@ -60,6 +61,13 @@ public:
      */
     virtual void DrawIndices( unsigned int aOffset, unsigned int aSize ) = 0;
 
+    /**
+     * Function DrawMesh()
+     * Makes the GPU draw a shared mesh.
+     * @param aMesh is the mesh to be drawn, it has to be valid until EndDrawing().
+     */
+    virtual void DrawMesh( const MESH_INSTANCE& aMesh ) = 0;
+
     /**
      * Function DrawIndices()
      * Makes the GPU draw all the vertices stored in the container.
@@ -117,6 +125,9 @@ public:
     ///> @copydoc GPU_MANAGER::DrawIndices()
     virtual void DrawIndices( unsigned int aOffset, unsigned int aSize ) override;
 
+    ///> @copydoc GPU_MANAGER::DrawMesh()
+    virtual void DrawMesh( const MESH_INSTANCE& aMesh ) override;
+
     ///> @copydoc GPU_MANAGER::DrawAll()
     virtual void DrawAll() override;
 
@@ -130,26 +141,24 @@ public:
     void Unmap();
 
 protected:
-    ///> Resizes the indices buffer to aNewSize if necessary
-    void resizeIndices( unsigned int aNewSize );
+    ///> Adds the indices of a range of vertices stored in a single vertex buffer
+    void addIndices( unsigned int aBuffer, unsigned int aOffset, unsigned int aSize );
 
     ///> Buffers initialization flag
     bool m_buffersInitialized;
 
-    ///> Pointer to the current indices buffer
-    boost::scoped_array<GLuint> m_indices;
-
-    ///> Pointer to the first free cell in the indices buffer
-    GLuint* m_indicesPtr;
+    ///> Indices to be drawn, for each vertex buffer of the container.  They are relative to
+    ///> the first vertex of their buffer.
+    std::vector<std::vector<GLuint>> m_indices;
 
     ///> Handle to indices buffer
     GLuint  m_indicesBuffer;
 
-    ///> Number of indices stored in the indices buffer
+    ///> Number of indices stored in the indices buffers
     unsigned int m_indicesSize;
 
-    ///> Current indices buffer size
-    unsigned int m_indicesCapacity;
+    ///> Shared meshes to be drawn
+    std::vector<const MESH_INSTANCE*> m_meshes;
 };
 
 
@@ -164,6 +173,9 @@ public:
     ///> @copydoc GPU_MANAGER::DrawIndices()
     virtual void DrawIndices( unsigned int aOffset, unsigned int aSize ) override;
 
+    ///> @copydoc GPU_MANAGER::DrawMesh()
+    virtual void DrawMesh( const MESH_INSTANCE& aMesh ) override;
+
     ///> @copydoc GPU_MANAGER::DrawAll()
     virtual void DrawAll() override;
 
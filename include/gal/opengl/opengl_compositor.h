@@ -70,6 +70,12 @@ public:
     /// @copydoc COMPOSITOR::ClearBuffer()
     virtual void ClearBuffer( const COLOR4D& aColor ) override;
 
+    /// @copydoc COMPOSITOR::SetClipRect()
+    virtual void SetClipRect( unsigned int aBufferHandle, const BOX2I* aRect ) override;
+
+    /// @copydoc COMPOSITOR::ScrollBuffer()
+    virtual void ScrollBuffer( unsigned int aBufferHandle, const VECTOR2I& aOffset ) override;
+
     /// @copydoc COMPOSITOR::DrawBuffer()
     virtual void DrawBuffer( unsigned int aBufferHandle ) override;
 
@@ -117,9 +123,20 @@ protected:
     OPENGL_ANTIALIASING_MODE m_currentAntialiasingMode;
     std::unique_ptr<OPENGL_PRESENTOR> m_antialiasing;
 
+    /// The clipped buffer handle (0 if there is none) and its clipping rectangle
+    unsigned int    m_clipBuffer;
+    BOX2I           m_clipRect;
+
+    /// Texture holding a copy of a buffer while it is scrolled (0 if not created yet)
+    GLuint          m_scrollTexture;
+    VECTOR2U        m_scrollTextureSize;
+
     /// Binds a specific Framebuffer Object.
     void bindFb( unsigned int aFb );
 
+    /// Enables the scissor test if the current buffer is the clipped one, disables it otherwise.
+    void updateScissor();
+
     /**
      * Function clean()
      * performs freeing of resources.
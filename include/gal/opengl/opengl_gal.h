@@ -131,6 +131,10 @@ public:
     virtual void DrawPolyline( const VECTOR2D aPointList[], int aListSize ) override;
     virtual void DrawPolyline( const SHAPE_LINE_CHAIN& aLineChain ) override;
 
+    /// @copydoc GAL::DrawPolylines()
+    virtual void DrawPolylines( const std::vector<VECTOR2D>& aPoints,
+                                const std::vector<int>& aSizes ) override;
+
     /// @copydoc GAL::DrawPolygon()
     virtual void DrawPolygon( const std::deque<VECTOR2D>& aPointList ) override;
     virtual void DrawPolygon( const VECTOR2D aPointList[], int aListSize ) override;
@@ -228,6 +232,12 @@ public:
     /// @copydoc GAL::ClearTarget()
     virtual void ClearTarget( RENDER_TARGET aTarget ) override;
 
+    /// @copydoc GAL::SetClipRect()
+    virtual bool SetClipRect( const BOX2I& aRect ) override;
+
+    /// @copydoc GAL::ScrollTargets()
+    virtual bool ScrollTargets( const VECTOR2I& aOffset ) override;
+
     /// @copydoc GAL::SetNegativeDrawMode()
     virtual void SetNegativeDrawMode( bool aSetting ) override {}
 
@@ -311,6 +321,13 @@ private:
 
     // Internal flags
     bool                    isFramebufferInitialized;   ///< Are the framebuffers initialized?
+    bool                    isMainBufferComplete;       ///< Does the main buffer hold a frame?
+
+    // GPU timer queries of the frame statistics: the items and the compositing times, for two
+    // frames, so the results of the previous frame are read without waiting for the GPU
+    GLuint                  gpuTimerQueries[2][2];
+    bool                    gpuTimerPending[2];         ///< Were the queries of a frame issued?
+    int                     gpuTimerFrame;              ///< Index of the current frame queries
     static bool             isBitmapFontLoaded;         ///< Is the bitmap font texture loaded?
     bool                    isBitmapFontInitialized;    ///< Is the shader set to use bitmap fonts?
     bool                    isInitialized;              ///< Basic initialization flag, has to be done
@@ -354,8 +371,11 @@ private:
      *
      * @param aStartPoint is the start point of the line.
      * @param aEndPoint is the end point of the line.
+     * @param aReserve has to be false if the space for the quad vertices has already been
+     * reserved in the current vertex manager.
      */
-    void drawLineQuad( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint );
+    void drawLineQuad( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint,
+                       bool aReserve = true );
 
     /**
      * @brief Draw a semicircle. Depending on settings (isStrokeEnabled & isFilledEnabled) it runs
@@ -458,6 +478,12 @@ private:
      */
     void blitCursor();
 
+    /**
+     * @brief Moves to the GPU timer queries of the next frame, and reads the results of the
+     * previous frame if they are available.
+     */
+    void readGpuTimers();
+
     /**
      * @brief Returns a valid key that can be used as a new group number.
      *
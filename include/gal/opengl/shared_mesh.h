@@ -0,0 +1,140 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file shared_mesh.h
+ * @brief Triangle meshes stored once in video memory and drawn by all the OpenGL canvases.
+ */
+
+#ifndef SHARED_MESH_H_
+#define SHARED_MESH_H_
+
+#define GLM_FORCE_RADIANS
+#include <glm/glm.hpp>
+#include <gal/opengl/vertex_common.h>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+class SHAPE_POLY_SET;
+
+namespace KIGFX
+{
+
+/**
+ * @brief Triangles stored in a vertex buffer of the OpenGL context shared by all the GAL
+ * canvases, so the canvases draw them without keeping their own copy.
+ */
+class SHARED_MESH
+{
+public:
+    SHARED_MESH( GLuint aBuffer, unsigned int aVertexCount );
+
+    ///> The vertex buffer is deleted by the next SHARED_MESH_CACHE::ReleaseBuffers() call,
+    ///> as the OpenGL context may not be current here.
+    ~SHARED_MESH();
+
+    ///> Returns the handle of the buffer storing the XY coordinates of the vertices
+    GLuint GetBuffer() const
+    {
+        return m_buffer;
+    }
+
+    unsigned int GetVertexCount() const
+    {
+        return m_vertexCount;
+    }
+
+private:
+    GLuint       m_buffer;
+    unsigned int m_vertexCount;
+};
+
+
+/**
+ * @brief A shared mesh drawn by a VERTEX_ITEM.
+ */
+struct MESH_INSTANCE
+{
+    std::shared_ptr<SHARED_MESH> m_mesh;
+
+    ///> Transformation of the mesh vertices.  It sets their depth as well.
+    glm::mat4                    m_transform;
+
+    GLubyte                      m_color[COLOR_STRIDE];
+};
+
+
+/**
+ * @brief The meshes of the polygon set triangulations, keyed by the polygon set hash.
+ *
+ * A zone fill shown in several canvases is uploaded once, and it is uploaded again only when
+ * the fill changes.
+ */
+class SHARED_MESH_CACHE
+{
+public:
+    static SHARED_MESH_CACHE& Get();
+
+    /**
+     * Returns the mesh of the triangulation of a polygon set, uploading it if needed.  The
+     * shared OpenGL context must be current.
+     *
+     * @param aPolySet is a polygon set with an up to date triangulation.
+     * @return the mesh, or nullptr if the set is too small to be worth a mesh or in case of error.
+     */
+    std::shared_ptr<SHARED_MESH> Acquire( const SHAPE_POLY_SET& aPolySet );
+
+    /**
+     * Deletes the vertex buffers of the meshes that are not used anymore.  The shared OpenGL
+     * context must be current.
+     */
+    void ReleaseBuffers();
+
+    ///> Returns the size of the video memory used by the meshes (in bytes)
+    size_t GetMemoryUsage() const
+    {
+        return m_memoryUsage;
+    }
+
+    ///> Smaller triangulations are stored in the canvas caches, like the other items
+    static constexpr unsigned int MIN_TRIANGLES = 256;
+
+private:
+    friend class SHARED_MESH;
+
+    SHARED_MESH_CACHE() : m_memoryUsage( 0 ) {}
+
+    std::map<std::string, std::weak_ptr<SHARED_MESH>> m_meshes;
+
+    ///> Buffers of the destroyed meshes, waiting for a current context to be deleted
+    std::vector<GLuint> m_releasedBuffers;
+
+    size_t m_memoryUsage;
+};
+
+} // namespace KIGFX
+
+#endif /* SHARED_MESH_H_ */
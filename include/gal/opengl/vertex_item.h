@@ -31,8 +31,10 @@
 #define VERTEX_ITEM_H_
 
 #include <gal/opengl/vertex_common.h>
+#include <gal/opengl/shared_mesh.h>
 #include <gal/color4d.h>
 #include <cstddef>
+#include <vector>
 
 namespace KIGFX
 {
@@ -79,6 +81,9 @@ private:
     unsigned int            m_offset;
     unsigned int            m_size;
 
+    ///> Shared meshes drawn with the item vertices
+    std::vector<MESH_INSTANCE> m_meshes;
+
     /**
      * Function SetOffset()
      * Sets data offset in the container.
@@ -46,6 +46,7 @@ class SHADER;
 class VERTEX_ITEM;
 class VERTEX_CONTAINER;
 class GPU_MANAGER;
+class SHARED_MESH;
 
 class VERTEX_MANAGER
 {
@@ -134,6 +135,18 @@ public:
      */
     bool Vertices( const VERTEX aVertices[], unsigned int aSize );
 
+    /**
+     * Function Mesh()
+     * adds a shared mesh to the currently set item. The mesh is drawn with the color set by
+     * Color(), and has the current transformation matrix applied. Only cached managers store
+     * meshes.
+     *
+     * @param aMesh is the mesh to be added.
+     * @param aDepth is the Z coordinate of the mesh vertices.
+     * @return True if successful, false otherwise.
+     */
+    bool Mesh( const std::shared_ptr<SHARED_MESH>& aMesh, GLfloat aDepth );
+
     /**
      * Function Color()
      * changes currently used color that will be applied to newly added vertices.
@@ -291,7 +304,7 @@ public:
      * @param aItem is the item to change.
      * @param aColor is the new color to be applied.
      */
-    void ChangeItemColor( const VERTEX_ITEM& aItem, const COLOR4D& aColor ) const;
+    void ChangeItemColor( VERTEX_ITEM& aItem, const COLOR4D& aColor ) const;
 
     /**
      * Function ChangeItemDepth()
@@ -300,7 +313,7 @@ public:
      * @param aItem is the item to change.
      * @param aDepth is the new color to be applied.
      */
-    void ChangeItemDepth( const VERTEX_ITEM& aItem, GLfloat aDepth ) const;
+    void ChangeItemDepth( VERTEX_ITEM& aItem, GLfloat aDepth ) const;
 
     /**
      * Function GetVertices()
@@ -355,6 +368,12 @@ public:
      */
     void EnableDepthTest( bool aEnabled );
 
+    /**
+     * Function GetMemoryUsage()
+     * returns the size of the memory reserved for the vertices (in bytes).
+     */
+    size_t GetMemoryUsage() const;
+
 protected:
     /**
      * Function putVertex()
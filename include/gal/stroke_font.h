@@ -31,6 +31,7 @@
 
 #include <deque>
 #include <algorithm>
+#include <vector>
 
 #include <utf8.h>
 
@@ -42,8 +43,23 @@ namespace KIGFX
 {
 class GAL;
 
-typedef std::vector<std::vector<VECTOR2D>*> GLYPH;
-typedef std::vector<GLYPH*>                 GLYPH_LIST;
+/**
+ * The glyphs of a stroke font, stored flat: the points of all the strokes of all the glyphs
+ * are in a single array, so the font is loaded with a few allocations only and drawn from
+ * contiguous memory.
+ *
+ * The strokes of glyph ii are [m_GlyphStart[ii], m_GlyphStart[ii+1]), the points of stroke
+ * jj are [m_StrokeStart[jj], m_StrokeStart[jj+1]).
+ */
+struct GLYPH_LIST
+{
+    std::vector<VECTOR2D> m_Points;
+    std::vector<int>      m_StrokeStart;
+    std::vector<int>      m_GlyphStart;
+    std::vector<BOX2D>    m_BoundingBoxes;
+
+    int GetGlyphCount() const { return (int) m_BoundingBoxes.size(); }
+};
 
 /**
  * @brief Class STROKE_FONT implements stroke font drawing.
@@ -118,6 +134,11 @@ private:
     const GLYPH_LIST*         m_glyphs;               ///< Glyph list
     const std::vector<BOX2D>* m_glyphBoundingBoxes;   ///< Bounding boxes of the glyphs
 
+    ///> Points and point counts of the strokes of the line of text being drawn, kept between
+    ///> the lines to reuse their memory
+    std::vector<VECTOR2D>     m_strokePoints;
+    std::vector<int>          m_strokeSizes;
+
     /**
      * @brief Compute the X and Y size of a given text. The text is expected to be
      * a only one line text.
@@ -135,13 +156,14 @@ private:
     double computeOverbarVerticalPosition() const;
 
     /**
-     * @brief Compute the bounding box of a given glyph.
+     * Parse the strings of a Hershey format font into a flat glyph list.
      *
-     * @param aGlyph is the glyph.
-     * @param aGlyphWidth is the x-component of the bounding box size.
-     * @return is the complete bounding box size.
+     * @param aNewStrokeFont is the pointer to the font data.
+     * @param aNewStrokeFontSize is the size of the font data.
+     * @return the glyph list, to be freed by the caller.
      */
-    BOX2D computeBoundingBox( const GLYPH* aGlyph, double aGlyphWidth ) const;
+    static GLYPH_LIST* parseStrokeFont( const char* const aNewStrokeFont[],
+                                        int aNewStrokeFontSize );
 
     /**
      * @brief Draws a single line of text. Multiline texts should be split before using the
@@ -107,7 +107,7 @@ public:
 
     void Clear() { clear(); }
 
-    const wxString& GetValue() { return m_field; }
+    const wxString& GetValue() const { return m_field; }
 
     void SetField( const wxString& aField, bool aUseUTF8, bool aEscapeString )
     {
@@ -116,7 +116,13 @@ public:
         m_escapeString = aEscapeString;
     }
 
-    bool IsEmpty() { return m_field.IsEmpty(); }
+    bool IsEmpty() const { return m_field.IsEmpty(); }
+
+    bool operator==( const GBR_DATA_FIELD& aOther ) const
+    {
+        return m_useUTF8 == aOther.m_useUTF8 && m_escapeString == aOther.m_escapeString
+               && m_field == aOther.m_field;
+    }
 
     std::string GetGerberString();
 
@@ -182,6 +188,15 @@ public:
     {
     }
 
+    bool operator==( const GBR_NETLIST_METADATA& aOther ) const
+    {
+        return m_NetAttribType == aOther.m_NetAttribType && m_NotInNet == aOther.m_NotInNet
+               && m_TryKeepPreviousAttributes == aOther.m_TryKeepPreviousAttributes
+               && m_Netname == aOther.m_Netname && m_Cmpref == aOther.m_Cmpref
+               && m_Padname == aOther.m_Padname && m_PadPinFunction == aOther.m_PadPinFunction
+               && m_ExtraData == aOther.m_ExtraData;
+    }
+
     /** Clear the extra data string printed at end of net attributes
      */
     void ClearExtraData()
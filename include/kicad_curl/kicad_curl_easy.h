@@ -32,6 +32,7 @@
  * so including kicad_curl.h could be needed in a few sources
  */
 
+#include <map>
 #include <string>
 
 typedef void CURL;
@@ -108,6 +109,30 @@ public:
      */
     bool SetFollowRedirects( bool aFollow );
 
+    /**
+     * Function SetShareConnections
+     * makes the request use the DNS cache, TLS sessions and connections shared by all the
+     * KICAD_CURL_EASY of the application, whatever their thread.  Several requests to the
+     * same server then set up the connection only once.
+     *
+     * @return bool - True if successful, false if not
+     */
+    bool SetShareConnections();
+
+    /**
+     * Function GetResponseCode
+     * returns the HTTP status code of the last response received by Perform(), e.g. 304
+     * for a conditional request whose document did not change.
+     */
+    long GetResponseCode();
+
+    /**
+     * Function GetResponseHeader
+     * returns the value of the header \a aName (case insensitive) of the last response
+     * received by Perform(), or an empty string if there is no such header.
+     */
+    std::string GetResponseHeader( const std::string& aName ) const;
+
     /**
      * Function GetErrorText
      * fetches CURL's "friendly" error string for a given error code
@@ -144,6 +169,9 @@ private:
     CURL*           m_CURL;
     curl_slist*     m_headers;
     std::string     m_buffer;
+
+    ///> headers of the last response, by lower case name
+    std::map<std::string, std::string> m_responseHeaders;
 };
 
 #endif // KICAD_CURL_EASY_H_
@@ -99,6 +99,18 @@ std::string EscapedUTF8( wxString aString );
  */
 wxString EscapedHTML( const wxString& aString );
 
+/**
+ * Convert a plain decimal number like "-12.345" without strtod() and its locale.
+ *
+ * Only numbers of up to 15 digits without an exponent are converted, as their conversion
+ * is exact: the result is the same as the one of strtod() in the C locale.
+ *
+ * @param aText is the nul terminated text of the number, without any other char.
+ * @param aValue receives the number.
+ * @return true if \a aText was converted, false if it must be left to strtod().
+ */
+bool ParseDecimal( const char* aText, double* aValue );
+
 /**
  * Read one line line from \a aFile.
  *
@@ -26,7 +26,10 @@
 #ifndef _LIB_TABLE_BASE_H_
 #define _LIB_TABLE_BASE_H_
 
+#include <functional>
+#include <future>
 #include <map>
+#include <mutex>
 #include <boost/noncopyable.hpp>
 #include <boost/ptr_container/ptr_vector.hpp>
 #include <memory>
@@ -518,4 +521,33 @@ protected:
     LIB_TABLE* fallBack;
 };
 
+
+/**
+ * The loading of a global library table on a background thread, started by its kiface not to
+ * delay the first frame when the libraries are on a slow (network) drive.
+ *
+ * The table must not be used before Wait() returns: its accessor calls it.
+ */
+class LIB_TABLE_BACKGROUND_LOAD
+{
+public:
+    /**
+     * Start running \a aLoad on a background thread.
+     *
+     * @param aOnError is called by Wait(), on its thread (the main thread), if \a aLoad threw
+     *                 an IO_ERROR.
+     */
+    void Start( std::function<void()> aLoad, std::function<void( const IO_ERROR& )> aOnError );
+
+    /**
+     * Return once the load started by Start(), if any, is done.
+     */
+    void Wait();
+
+private:
+    std::mutex                              m_mutex;
+    std::shared_future<void>                m_load;
+    std::function<void( const IO_ERROR& )>  m_onError;     ///< reset once called
+};
+
 #endif  // _LIB_TABLE_BASE_H_
@@ -153,6 +153,21 @@ protected:
     /* Used by processing loop */
     void parse( int token, numEval::TokenType value );
 
+    /* Result of a previous evaluation of an input string.  The entries of an input string using
+     * variables are only valid for the variables they were evaluated with.
+     */
+    struct CacheEntry
+    {
+        std::string                result;
+        bool                       parseError;
+        bool                       usesVars;
+        std::map<wxString, double> varsBefore;  // variables before and after the evaluation
+        std::map<wxString, double> varsAfter;   // (if usesVars)
+    };
+
+    /* Maximum number of cached input strings (the cache is cleared when full) */
+    static const size_t CacheSize = 1024;
+
 private:
     void* m_parser; // the current lemon parser state machine
 
@@ -179,6 +194,9 @@ private:
     wxString m_originalText;
 
     std::map<wxString, double> m_varMap;
+
+    std::map<wxString, CacheEntry> m_cache;
+    bool m_usesVars;          // a variable was read or set by the current input string
 };
 
 
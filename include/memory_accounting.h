@@ -0,0 +1,147 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file memory_accounting.h
+ * @brief Estimates of the memory held by the big subsystems, to tell where it goes.
+ */
+
+#ifndef MEMORY_ACCOUNTING_H
+#define MEMORY_ACCOUNTING_H
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+
+#include <wx/string.h>
+
+
+/**
+ * The memory held by the subsystems of the application (zone fills, undo history, GAL
+ * caches...), as estimated by the subsystems themselves.
+ *
+ * Nothing is counted as the memory is allocated: each object holding a lot of memory
+ * registers a function estimating it, called only when the figures are asked for.  The
+ * accounting is enabled by the MemoryAccounting advanced config; when it is not, nothing is
+ * registered.  Each kiface has its own accounting.
+ */
+class MEMORY_ACCOUNTING
+{
+public:
+    struct USAGE
+    {
+        size_t m_Bytes = 0;
+        size_t m_Items = 0;     ///< the objects (zones, commands, models...) holding them
+    };
+
+    using ESTIMATOR = std::function<USAGE()>;
+
+    explicit MEMORY_ACCOUNTING( bool aEnabled );
+
+    MEMORY_ACCOUNTING( const MEMORY_ACCOUNTING& ) = delete;
+    MEMORY_ACCOUNTING& operator=( const MEMORY_ACCOUNTING& ) = delete;
+
+    /**
+     * @return the accounting of the application, enabled by ADVANCED_CFG::m_MemoryAccounting
+     */
+    static MEMORY_ACCOUNTING& GetInstance();
+
+    bool IsEnabled() const { return m_enabled; }
+
+    /**
+     * Register an estimator of the memory held by an object.
+     *
+     * The estimators are called on the thread asking for the figures (the main thread), with
+     * a lock held: they must not register or remove estimators.
+     *
+     * @param aSubsystem is the name of the subsystem the memory is accounted to
+     * @return the id to remove the estimator with, or 0 if the accounting is disabled
+     */
+    int Add( const std::string& aSubsystem, ESTIMATOR aEstimator );
+
+    void Remove( int aId );
+
+    /**
+     * @return the sum of the estimates of each subsystem
+     */
+    std::map<std::string, USAGE> Collect() const;
+
+    /**
+     * Collect() the estimates and write them on the KICAD_MEMORY trace.
+     * @param aContext tells what happened before (board loaded...)
+     */
+    void Trace( const wxString& aContext ) const;
+
+private:
+    struct ENTRY
+    {
+        std::string m_Subsystem;
+        ESTIMATOR   m_Estimator;
+    };
+
+    bool                 m_enabled;
+    int                  m_nextId;
+    mutable std::mutex   m_mutex;
+    std::map<int, ENTRY> m_entries;
+};
+
+
+/**
+ * The registration of an estimator of MEMORY_ACCOUNTING, removed when destroyed.  Meant to
+ * be a member of the object it accounts for:
+ *
+ *     m_memoryAccount.Set( "zone fills", [this]() { ... } );
+ *
+ * It is not copied with its object: a copy registers its own estimator.
+ */
+class MEMORY_ACCOUNT
+{
+public:
+    MEMORY_ACCOUNT() : m_id( 0 ) {}
+
+    ~MEMORY_ACCOUNT() { Reset(); }
+
+    MEMORY_ACCOUNT( const MEMORY_ACCOUNT& ) : m_id( 0 ) {}
+    MEMORY_ACCOUNT& operator=( const MEMORY_ACCOUNT& ) { return *this; }
+
+    void Set( const std::string& aSubsystem, MEMORY_ACCOUNTING::ESTIMATOR aEstimator )
+    {
+        Reset();
+        m_id = MEMORY_ACCOUNTING::GetInstance().Add( aSubsystem, std::move( aEstimator ) );
+    }
+
+    void Reset()
+    {
+        if( m_id )
+            MEMORY_ACCOUNTING::GetInstance().Remove( m_id );
+
+        m_id = 0;
+    }
+
+private:
+    int m_id;
+};
+
+#endif // MEMORY_ACCOUNTING_H
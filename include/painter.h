@@ -104,6 +104,17 @@ public:
      */
     virtual bool Draw( const VIEW_ITEM* aItem, int aLayer ) = 0;
 
+    /**
+     * Function PrepareDraw
+     * Computes ahead of Draw() the geometry of an item that is expensive to build (e.g. the
+     * triangulation of its polygons), without touching the GAL.  The VIEW calls it for many
+     * items at once from several threads, so it must only modify the item it is given.
+     * @param aItem is the item that is going to be drawn.
+     */
+    virtual void PrepareDraw( const VIEW_ITEM* aItem )
+    {
+    }
+
 protected:
     /// Instance of graphic abstraction layer that gives an interface to call
     /// commands used to draw (eg. DrawLine, DrawCircle, etc.)
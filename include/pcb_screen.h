@@ -32,6 +32,7 @@
 
 #include <base_screen.h>
 #include <class_board_item.h>
+#include <memory_accounting.h>
 
 
 class UNDO_REDO_CONTAINER;
@@ -45,6 +46,9 @@ public:
     PCB_LAYER_ID m_Route_Layer_TOP;
     PCB_LAYER_ID m_Route_Layer_BOTTOM;
 
+private:
+    MEMORY_ACCOUNT m_memoryAccount;     ///< the memory of the undo and redo lists
+
 public:
 
     /**
@@ -32,7 +32,10 @@
 #ifndef PLOT_COMMON_H_
 #define PLOT_COMMON_H_
 
+#include <deque>
+#include <memory>
 #include <vector>
+#include <unordered_map>
 #include <math/box2.h>
 #include <gr_text.h>
 #include <page_info.h>
@@ -42,6 +45,7 @@ class COLOR_SETTINGS;
 class SHAPE_POLY_SET;
 class SHAPE_LINE_CHAIN;
 class GBR_NETLIST_METADATA;
+struct PDF_PENDING_STREAM;
 
 /**
  * Enum PlotFormat
@@ -457,6 +461,11 @@ public:
         // NOP for most plotters. Only for SVG plotter
     }
 
+    virtual void SetSvgOptimized( bool aOptimized )
+    {
+        // NOP for most plotters. Only for SVG plotter
+    }
+
     /**
      * calling this function allows one to define the beginning of a group
      * of drawing items, for instance in SVG  or Gerber format.
@@ -840,7 +849,7 @@ public:
             pageTreeHandle( 0 ),
             fontResDictHandle( 0 ),
             pageStreamHandle( 0 ),
-            streamLengthHandle( 0 ),
+            streamHandle( 0 ),
             workFile( nullptr )
     {
     }
@@ -869,6 +878,34 @@ public:
     virtual bool EndPlot() override;
     virtual void StartPage();
     virtual void ClosePage();
+
+    /**
+     * Start the plot without opening its first page: the pages are then added by
+     * AddDetachedPage().
+     */
+    bool StartDetachedPlot();
+
+    /**
+     * Open a page on a plotter without output file, to be added to the document of another
+     * plotter.  The pages of a document can so be plotted concurrently, each one by its own
+     * plotter; the page settings and the viewport must be set before.
+     */
+    void StartDetachedPage();
+
+    /**
+     * Close the page opened by StartDetachedPage()
+     * @return the content stream of the page, to give to AddDetachedPage()
+     */
+    std::string EndDetachedPage();
+
+    /**
+     * Add a page plotted by another plotter after the pages of the document, no page being
+     * open.  It is compressed by a worker thread, as the pages plotted by this plotter.
+     * @param aPageInfo is the page settings the page was plotted with
+     * @param aContent is the content returned by EndDetachedPage()
+     */
+    void AddDetachedPage( const PAGE_INFO& aPageInfo, std::string aContent );
+
     virtual void SetCurrentLineWidth( int width, void* aData = NULL ) override;
     virtual void SetDash( PLOT_DASH_TYPE dashed ) override;
 
@@ -911,16 +948,31 @@ protected:
     int allocPdfObject();
     int startPdfObject(int handle = -1);
     void closePdfObject();
+    int addPdfObject( const std::string& aContent, int aHandle = -1 );
     int startPdfStream(int handle = -1);
     void closePdfStream();
+    void writePdfStream( int aHandle, const std::string& aData,
+                         const std::string& aDictEntries = std::string() );
+    void writePendingStreams( bool aWaitAll );
+    void queuePdfStream( int aHandle, std::string aData );
+    void openWorkFile();
+    std::string closeWorkFile();
+    void addPageObject( const PAGE_INFO& aPageInfo, int aStreamHandle );
     int pageTreeHandle;		 /// Handle to the root of the page tree object
     int fontResDictHandle;	 /// Font resource dictionary
     std::vector<int> pageHandles;/// Handles to the page objects
     int pageStreamHandle;	 /// Handle of the page content object
-    int streamLengthHandle;      /// Handle to the deferred stream length
+    int streamHandle;            /// Handle of the stream accumulated in workFile
     wxString workFilename;
     FILE* workFile;  	         /// Temporary file to costruct the stream before zipping
-    std::vector<long> xrefTable; /// The PDF xref offset table
+    std::vector<long> xrefTable; /// The PDF xref offset table (0 for the compressed objects)
+
+    /// The objects which are not streams (handle and content), written together in a
+    /// compressed object stream at the end of the plot
+    std::vector<std::pair<int, std::string>> m_objects;
+
+    /// The streams being compressed by the thread pool, in the order they are written
+    std::deque<std::shared_ptr<PDF_PENDING_STREAM>> m_pendingStreams;
 };
 
 class SVG_PLOTTER : public PSLIKE_PLOTTER
@@ -980,6 +1032,15 @@ public:
      */
     virtual void SetSvgCoordinatesFormat( unsigned aResolution, bool aUseInches = false ) override;
 
+    /**
+     * Function SetSvgOptimized
+     * In optimized mode, the consecutive strokes drawn with the same style are merged into
+     * a single path using relative integer coordinates, and a filled polygon drawn again
+     * with the same shape is only referenced by a \<use\> of its first copy.
+     * The picture is the same, the file is much smaller.
+     */
+    virtual void SetSvgOptimized( bool aOptimized ) override { m_optimized = aOptimized; }
+
     /**
      * calling this function allows one to define the beginning of a group
      * of drawing items (used in SVG format to separate components)
@@ -1028,6 +1089,39 @@ protected:
                                         // 3-4 in other moduls (avoid values >4 to avoid overflow)
                                         // see also comment for m_useInch.
 
+    bool           m_optimized;         // true to merge the strokes and reuse the polygons
+    std::string    m_pathData;          // the merged strokes not yet written (optimized mode)
+    wxPoint        m_pathPos;           // the last point of m_pathData, in device units
+
+    struct SVG_SHAPE
+    {
+        int         m_Id;               // the number of its "id" attribute
+        wxPoint     m_Origin;           // the first point of its first copy, in device units
+    };
+
+    // The filled polygons already written, by their path relative to their first point
+    std::unordered_map<std::string, SVG_SHAPE> m_shapes;
+
+    /**
+     * function flushPath()
+     * output the merged strokes of m_pathData as a single path (optimized mode)
+     */
+    void flushPath();
+
+    /**
+     * function appendPathPoint()
+     * add a point, in device units, to the merged strokes (optimized mode)
+     * @param aMoveTo true to start a new subpath, false to draw a line from the last point
+     */
+    void appendPathPoint( const DPOINT& aPos, bool aMoveTo );
+
+    /**
+     * function emitFilledPoly()
+     * output a filled polygon, or a reference to a previous polygon of same shape
+     * (optimized mode)
+     */
+    void emitFilledPoly( const std::vector<wxPoint>& aCornerList );
+
     /**
      * function emitSetRGBColor()
      * initialize m_pen_rgb_color from reduced values r, g ,b
@@ -1410,6 +1504,37 @@ protected:
     std::vector<APERTURE> m_apertures; // The list of available apertures
     int     m_currentApertureIdx;      // The index of the current aperture in m_apertures
 
+    /// The key of an aperture in m_apertureIndex.  The rotation of the regular polygons
+    /// is stored in their size, so it is part of the key
+    struct APERTURE_KEY
+    {
+        APERTURE::APERTURE_TYPE m_Type;
+        wxSize                  m_Size;
+        int                     m_ApertureAttribute;
+
+        bool operator==( const APERTURE_KEY& aOther ) const
+        {
+            return m_Type == aOther.m_Type && m_Size == aOther.m_Size
+                   && m_ApertureAttribute == aOther.m_ApertureAttribute;
+        }
+    };
+
+    struct APERTURE_KEY_HASH
+    {
+        size_t operator()( const APERTURE_KEY& aKey ) const
+        {
+            size_t seed = std::hash<int>()( aKey.m_Type );
+
+            for( int value : { aKey.m_Size.x, aKey.m_Size.y, aKey.m_ApertureAttribute } )
+                seed ^= std::hash<int>()( value ) + 0x9e3779b9 + ( seed << 6 ) + ( seed >> 2 );
+
+            return seed;
+        }
+    };
+
+    /// The index in m_apertures of each aperture, to find them without scanning the list
+    std::unordered_map<APERTURE_KEY, int, APERTURE_KEY_HASH> m_apertureIndex;
+
     bool    m_gerberUnitInch;          // true if the gerber units are inches, false for mm
     int     m_gerberUnitFmt;           // number of digits in mantissa.
                                        // usually 6 in Inches and 5 or 6  in mm
@@ -111,6 +111,15 @@ public:
         return m_highlightEnabled;
     }
 
+    /**
+     * @return true if the items with their HIGHLIGHTED flag set are highlighted, instead of
+     * the nets
+     */
+    inline bool IsHighlightItems() const
+    {
+        return m_highlightItems;
+    }
+
     /**
      * Function GetHighlightNetCode
      * Returns netcode of currently highlighted net.
@@ -29,6 +29,7 @@
 // "richio" after its author, Richard Hollenbeck, aka Dick Hollenbeck.
 
 
+#include <memory>
 #include <vector>
 #include <utf8.h>
 
@@ -39,6 +40,9 @@
 
 #include <ki_exception.h>
 
+class wxFFileOutputStream;
+class wxZlibOutputStream;
+
 
 /**
  * Function StrPrintf
@@ -247,6 +251,66 @@ public:
 };
 
 
+/**
+ * MAPPED_FILE_LINE_READER
+ * is a LINE_READER that maps a whole file in memory, instead of reading it character by
+ * character.  The lines returned by ReadLine() are not copied: they point into the (copy on
+ * write) mapping, and are nul terminated by temporarily overwriting the first character
+ * of the next line, which is put back by the next ReadLine().
+ * <p>
+ * Unlike FILE_LINE_READER, the file is not read in text mode, so on Windows the lines keep
+ * their '\r' before the '\n'.  This is fine for the s-expression files, where '\r' is a
+ * blank.  If the file cannot be mapped (on some network file systems), it is read into a
+ * buffer at once instead.
+ * <p>
+ * A gzip compressed file, recognized by its magic bytes, is decompressed into a buffer at
+ * once, so the compressed boards and schematics are read as the plain ones.
+ */
+class MAPPED_FILE_LINE_READER : public LINE_READER
+{
+protected:
+    char*               m_data;         ///< the file contents
+    size_t              m_size;         ///< the file size
+    size_t              m_ndx;          ///< offset of the next line in m_data
+    bool                m_mapped;       ///< is m_data a mapping or m_buffer ?
+    std::vector<char>   m_buffer;       ///< the file contents when they cannot be mapped
+    char*               m_ownLine;      ///< the copy buffer of LINE_READER
+    char                m_savedChar;    ///< the character overwritten by the line's nul
+    bool                m_saved;        ///< is m_savedChar to be put back ?
+
+#ifdef __WINDOWS__
+    void*               m_mapping;      ///< the file mapping handle
+#endif
+
+public:
+
+    /**
+     * Constructor MAPPED_FILE_LINE_READER
+     * opens and maps @a aFileName.
+     *
+     * @param aFileName is the name of the file to open and to use for error reporting purposes.
+     * @param aStartingLineNumber is the initial line number to report on error, see
+     *  FILE_LINE_READER.
+     * @param aMaxLineLength is the maximum supported line length.
+     *
+     * @throw IO_ERROR if @a aFileName cannot be opened.
+     */
+    MAPPED_FILE_LINE_READER( const wxString& aFileName,
+            unsigned aStartingLineNumber = 0,
+            unsigned aMaxLineLength = LINE_READER_LINE_DEFAULT_MAX );
+
+    ~MAPPED_FILE_LINE_READER();
+
+    char* ReadLine() override;
+
+private:
+    /// Replace the gzip compressed contents of the file by their decompressed bytes
+    void decompress();
+
+    void unmap();
+};
+
+
 /**
  * STRING_LINE_READER
  * is a LINE_READER that reads from a multiline 8 bit wide std::string
@@ -306,7 +370,8 @@ public:
 };
 
 
-#define OUTPUTFMTBUFZ    500        ///< default buffer size for any OUTPUT_FORMATTER
+#define OUTPUTFMTBUFZ    500            ///< default buffer size for any OUTPUT_FORMATTER
+#define FILEOUTPUTBUFZ   ( 1 << 20 )    ///< stdio buffer size of a FILE_OUTPUTFORMATTER
 
 /**
  * OUTPUTFORMATTER
@@ -433,6 +498,17 @@ public:
 
      std::string Quotew( const wxString& aWrapee );
 
+    /**
+     * Output \a aText as is, e.g. the text prepared by a STRING_FORMATTER.
+     *
+     * @throw IO_ERROR, if there is a problem outputting, such as a full disk.
+     */
+    void Write( const std::string& aText )
+    {
+        if( !aText.empty() )
+            write( aText.data(), (int) aText.size() );
+    }
+
     //-----</interface functions>-----------------------------------------
 };
 
@@ -518,6 +594,41 @@ protected:
 };
 
 
+/**
+ * GZIP_FILE_OUTPUTFORMATTER
+ * writes a gzip compressed file, for the boards and schematics too big to be kept as text.
+ * MAPPED_FILE_LINE_READER reads them back transparently.
+ */
+class GZIP_FILE_OUTPUTFORMATTER : public OUTPUTFORMATTER
+{
+public:
+
+    /**
+     * Constructor
+     * @param aFileName is the full filename to open and save to.
+     * @param aQuoteChar is a char used for quoting problematic strings
+            (with whitespace or special characters in them).
+     * @throw IO_ERROR if the file cannot be opened.
+     */
+    GZIP_FILE_OUTPUTFORMATTER( const wxString& aFileName, char aQuoteChar = '"' );
+
+    ~GZIP_FILE_OUTPUTFORMATTER();
+
+protected:
+    //-----<OUTPUTFORMATTER>------------------------------------------------
+    void write( const char* aOutBuf, int aCount ) override;
+    //-----</OUTPUTFORMATTER>-----------------------------------------------
+
+    /// Compress the pending bytes
+    void flush();
+
+    std::unique_ptr<wxFFileOutputStream> m_file;
+    std::unique_ptr<wxZlibOutputStream>  m_zip;
+    std::string                          m_pending;  ///< the many small Print()s, compressed in blocks
+    wxString                             m_filename;
+};
+
+
 /**
  * STREAM_OUTPUTFORMATTER
  * implements OUTPUTFORMATTER to a wxWidgets wxOutputStream.  The stream is
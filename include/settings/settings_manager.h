@@ -21,6 +21,11 @@
 #ifndef _SETTINGS_MANAGER_H
 #define _SETTINGS_MANAGER_H
 
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
+
 #include <common.h> // for wxString hash
 #include <settings/color_settings.h>
 
@@ -214,8 +219,36 @@ public:
      */
     static std::string GetSettingsVersion();
 
+    /**
+     * Queues the writing of a settings file, done on a background thread.
+     *
+     * The writes of a file are coalesced: only the last contents queued before the thread gets
+     * to the file are written.
+     *
+     * @param aPath is the full path of the file
+     * @param aContents is the whole contents of the file
+     */
+    void QueueWrite( const wxString& aPath, std::string aContents );
+
+    /**
+     * Waits for the queued write of a file, if any, to be done.
+     * @param aPath is the full path of the file, or empty to wait for all the queued writes
+     */
+    void FlushWrites( const wxString& aPath = wxEmptyString );
+
+    /**
+     * Writes a settings file atomically: to a temporary file, renamed over the file once
+     * complete, for a crash or a full disk never to leave a truncated file.
+     *
+     * @return true if the file was written
+     */
+    static bool WriteFileAtomically( const wxString& aPath, const std::string& aContents );
+
 private:
 
+    /// The loop of the thread writing the queued files
+    void writerLoop();
+
     /**
      * Determines the base path for user settings files.
      *
@@ -269,6 +302,17 @@ private:
 
     /// True if settings loaded successfully at construction
     bool m_ok;
+
+    /// The contents of the files to write, by path
+    std::map<wxString, std::string> m_pendingWrites;
+
+    /// The file being written by the writer thread, if any
+    wxString m_currentWrite;
+
+    std::mutex              m_writeMutex;
+    std::condition_variable m_writeCondition;   ///< for the writer thread and FlushWrites()
+    std::thread             m_writer;           ///< started by the first QueueWrite()
+    bool                    m_stopWriter;
 };
 
 #endif
@@ -0,0 +1,180 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class TASK_GROUP;
+
+
+/**
+ * A pool of worker threads running the parallel work of the application.
+ *
+ * Each worker has its own queue of tasks: it runs the last task it queued itself, and takes
+ * the oldest task of another worker when its own queue is empty.  A thread waiting for a
+ * group of tasks runs the queued tasks of this group meanwhile, so the parallel loops can be
+ * nested (a task running a parallel loop) without blocking the workers or starting more
+ * threads.  It never runs the tasks of other groups, which may be much longer than the ones
+ * it waits for.
+ *
+ * The threads are started once, by the first use of the pool.
+ */
+class THREAD_POOL
+{
+public:
+    /**
+     * @param aThreadCount is the number of worker threads (at least one)
+     */
+    explicit THREAD_POOL( size_t aThreadCount );
+    ~THREAD_POOL();
+
+    THREAD_POOL( const THREAD_POOL& ) = delete;
+    THREAD_POOL& operator=( const THREAD_POOL& ) = delete;
+
+    /**
+     * @return the pool shared by the application, with ADVANCED_CFG::m_MaxThreads workers
+     *         (one per core if not set)
+     */
+    static THREAD_POOL& GetInstance();
+
+    size_t GetThreadCount() const { return m_queues.size(); }
+
+    /**
+     * Run aFunc( ii ) for each ii in [0, aCount), on the workers and the calling thread, and
+     * return when all are done.
+     *
+     * @param aIdle if given, the calling thread does not run the loop but calls aIdle every
+     *              100 ms until it is done (to refresh a progress dialog)
+     */
+    void ParallelFor( size_t aCount, const std::function<void( size_t )>& aFunc,
+                      const std::function<void()>& aIdle = nullptr );
+
+private:
+    friend class TASK_GROUP;
+
+    struct TASK
+    {
+        std::function<void()> m_Func;
+        TASK_GROUP*           m_Group;
+    };
+
+    struct WORKER_QUEUE
+    {
+        std::mutex       m_Mutex;
+        std::deque<TASK> m_Tasks;
+    };
+
+    void submit( TASK&& aTask );
+
+    /**
+     * Run one queued task: one of the current worker first, else the oldest of another one.
+     * @param aGroup if given, only a task of this group is run
+     * @return false if there was no task to run
+     */
+    bool runOneTask( TASK_GROUP* aGroup = nullptr );
+
+    bool popTask( size_t aQueue, bool aNewest, TASK_GROUP* aGroup, TASK& aTask );
+
+    void workerLoop( size_t aIndex );
+
+    std::vector<std::unique_ptr<WORKER_QUEUE>> m_queues;
+    std::vector<std::thread>                   m_threads;
+
+    std::atomic<size_t>     m_queuedCount;  ///< tasks in all the queues
+    std::atomic<size_t>     m_nextQueue;    ///< the queue of the next task of another thread
+    std::mutex              m_sleepMutex;
+    std::condition_variable m_sleepCondition;
+    bool                    m_stop;
+};
+
+
+/**
+ * A set of tasks run by a THREAD_POOL, which can be waited for or cancelled together.
+ *
+ * The tasks of a cancelled group which have not started are not run; the running ones can
+ * poll IsCancelled() to stop early.  An exception thrown by a task is thrown again by Wait().
+ */
+class TASK_GROUP
+{
+public:
+    TASK_GROUP( THREAD_POOL& aPool = THREAD_POOL::GetInstance() );
+
+    /// Waits for the tasks of the group
+    ~TASK_GROUP();
+
+    TASK_GROUP( const TASK_GROUP& ) = delete;
+    TASK_GROUP& operator=( const TASK_GROUP& ) = delete;
+
+    /**
+     * Queue a task of the group.
+     */
+    void Run( std::function<void()> aTask );
+
+    /**
+     * Same as THREAD_POOL::ParallelFor(), the items being skipped once the group is cancelled.
+     */
+    void ParallelFor( size_t aCount, const std::function<void( size_t )>& aFunc,
+                      const std::function<void()>& aIdle = nullptr );
+
+    /**
+     * Return when all the tasks of the group are done.
+     *
+     * The calling thread runs the queued tasks of the group meanwhile (never the ones of
+     * other groups).
+     *
+     * @param aIdle if given, the calling thread does not run tasks but calls aIdle every
+     *              100 ms until they are done
+     */
+    void Wait( const std::function<void()>& aIdle = nullptr );
+
+    void Cancel() { m_cancelled = true; }
+
+    bool IsCancelled() const { return m_cancelled; }
+
+    /// @return true if all the tasks of the group are done (to poll them without waiting)
+    bool IsDone() const { return m_pending == 0; }
+
+private:
+    friend class THREAD_POOL;
+
+    void taskDone( std::exception_ptr aError );
+
+    THREAD_POOL&            m_pool;
+    std::atomic<size_t>     m_pending;
+    std::atomic<bool>       m_cancelled;
+    std::mutex              m_mutex;
+    std::condition_variable m_done;
+    std::exception_ptr      m_error;        ///< the first exception thrown by a task
+};
+
+#endif // THREAD_POOL_H
@@ -96,6 +96,7 @@ public:
     static TOOL_ACTION centerContents;
     static TOOL_ACTION toggleCursor;
     static TOOL_ACTION toggleCursorStyle;
+    static TOOL_ACTION toggleFrameStats;
     static TOOL_ACTION highContrastMode;
 
     static TOOL_ACTION refreshPreview;      // Similar to a synthetic mouseMoved event, but also
@@ -171,6 +172,7 @@ public:
     static TOOL_ACTION listHotKeys;
     static TOOL_ACTION getInvolved;
     static TOOL_ACTION reportBug;
+    static TOOL_ACTION showMemoryUsage;
 
     /**
      * Function TranslateLegacyId()
@@ -56,6 +56,7 @@ public:
     int ListHotKeys( const TOOL_EVENT& aEvent );
     int GetInvolved( const TOOL_EVENT& aEvent );
     int ReportBug( const TOOL_EVENT& aEvent );
+    int ShowMemoryUsage( const TOOL_EVENT& aEvent );
 
     ///> Sets up handlers for various events.
     void setTransitions() override;
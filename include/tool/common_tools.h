@@ -66,6 +66,7 @@ public:
     int CursorControl( const TOOL_EVENT& aEvent );
     int ToggleCursor( const TOOL_EVENT& aEvent );
     int ToggleCursorStyle( const TOOL_EVENT& aEvent );
+    int ToggleFrameStats( const TOOL_EVENT& aEvent );
 
     // Units control
     int ImperialUnits( const TOOL_EVENT& aEvent );
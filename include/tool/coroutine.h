@@ -37,6 +37,7 @@
 #include <libcontext.h>
 #include <memory>
 #include <advanced_config.h>
+#include <tool/coroutine_stack_pool.h>
 
 /**
  *  Class COROUNTINE.
@@ -304,8 +305,8 @@ private:
         void* sp = nullptr;
 
         #ifndef LIBCONTEXT_HAS_OWN_STACK
-        // fixme: Clean up stack stuff. Add a guard
-        m_stack.reset( new char[stackSize] );
+        // A stack overflow hits the guard page of the stack
+        m_stack = COROUTINE_STACK_POOL::GetInstance().Acquire( stackSize );
 
         // align to 16 bytes
         sp = (void*)((((ptrdiff_t) m_stack.get()) + stackSize - 0xf) & (~0x0f));
@@ -376,8 +377,8 @@ private:
         }
     }
 
-    ///< coroutine stack
-    std::unique_ptr<char[]> m_stack;
+    ///< coroutine stack, given back to the pool with the coroutine
+    COROUTINE_STACK_POOL::STACK m_stack;
 
     int m_stacksize;
 
@@ -0,0 +1,100 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+
+#ifndef COROUTINE_STACK_POOL_H
+#define COROUTINE_STACK_POOL_H
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+
+/**
+ * The stacks of the coroutines.
+ *
+ * A stack is mapped from the system in whole pages, with an inaccessible guard page below it,
+ * so a stack overflow faults at once instead of overwriting the memory below the stack.  The
+ * released stacks are kept (not cleared) for the next coroutines, so running a tool does not
+ * map and unmap a stack each time.
+ */
+class COROUTINE_STACK_POOL
+{
+public:
+    /// Gives a stack back to its pool
+    class RELEASER
+    {
+    public:
+        RELEASER( size_t aSize = 0 ) :
+                m_size( aSize )
+        {}
+
+        void operator()( char* aStack ) const;
+
+    private:
+        size_t m_size;  ///< the usable size of the stack
+    };
+
+    using STACK = std::unique_ptr<char[], RELEASER>;
+
+    ~COROUTINE_STACK_POOL();
+
+    /**
+     * @return the pool of the application
+     */
+    static COROUTINE_STACK_POOL& GetInstance();
+
+    /**
+     * Get a stack of at least aSize usable bytes, from the released ones if possible.
+     *
+     * @param aSize is the requested size, rounded up to whole pages on return.
+     * @return the lowest usable address of the stack, which is released to the pool when
+     *         the returned pointer is reset.
+     */
+    STACK Acquire( size_t& aSize );
+
+private:
+    /// The number of released stacks kept for later coroutines
+    static const size_t MAX_FREE_STACKS = 8;
+
+    struct FREE_STACK
+    {
+        char*  m_Stack;
+        size_t m_Size;
+    };
+
+    void release( char* aStack, size_t aSize );
+
+    static size_t pageSize();
+
+    /// Map a stack of aSize bytes (whole pages) below which a guard page is mapped
+    static char* mapStack( size_t aSize );
+
+    static void unmapStack( char* aStack, size_t aSize );
+
+    std::mutex              m_mutex;
+    std::vector<FREE_STACK> m_freeStacks;
+};
+
+#endif // COROUTINE_STACK_POOL_H
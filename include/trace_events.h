@@ -0,0 +1,185 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+
+/**
+ * @file trace_events.h
+ * @brief Recording of timed scopes, saved as a Chrome trace (also read by Perfetto).
+ */
+
+#ifndef TRACE_EVENTS_H
+#define TRACE_EVENTS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+/**
+ * The timed scopes of a run of the application, saved in a file at exit to be attached to a
+ * bug report and opened in chrome://tracing or https://ui.perfetto.dev.
+ *
+ * Each thread records its events in its own buffer, without locking: a buffer is a list of
+ * fixed size chunks which are only appended to, so the saving can read them meanwhile.
+ *
+ * The recording is enabled by naming the trace file, with the KICAD_TRACE_EVENTS environment
+ * variable or the TraceEventsFile advanced config.  When it is not enabled, a TRACE_SCOPE
+ * costs a test of a flag.  Each kiface has its own recorder: the first one saving its trace
+ * uses the file name, the next ones add .1, .2... to it.
+ */
+class TRACE_EVENTS
+{
+public:
+    /**
+     * @param aEnabled is false to not record anything
+     * @param aFileName is the file saved when the recorder is destroyed, if not empty
+     */
+    explicit TRACE_EVENTS( bool aEnabled, const std::string& aFileName = std::string() );
+    ~TRACE_EVENTS();
+
+    TRACE_EVENTS( const TRACE_EVENTS& ) = delete;
+    TRACE_EVENTS& operator=( const TRACE_EVENTS& ) = delete;
+
+    /**
+     * @return the recorder of the application, saving the trace file named by
+     *         KICAD_TRACE_EVENTS, else by ADVANCED_CFG::m_TraceEventsFile
+     */
+    static TRACE_EVENTS& GetInstance();
+
+    bool IsEnabled() const { return m_enabled; }
+
+    /**
+     * @return the time of the trace clock, in nanoseconds since the recorder was created
+     */
+    int64_t Now() const
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>( CLOCK::now() - m_origin )
+                .count();
+    }
+
+    /**
+     * Record a scope of the calling thread.
+     *
+     * @param aName is the name of the scope, truncated to MAX_NAME_LENGTH characters
+     * @param aStart and aEnd are times of Now()
+     */
+    void AddEvent( const char* aName, int64_t aStart, int64_t aEnd );
+
+    /**
+     * Write the events recorded so far as the JSON of a Chrome trace.
+     */
+    std::string ToJson() const;
+
+    /**
+     * Write the events recorded so far to a file.
+     * @return false if the file cannot be written
+     */
+    bool Save( const std::string& aFileName ) const;
+
+    static constexpr size_t MAX_NAME_LENGTH = 47;
+
+    ///< Events beyond this count are dropped, to bound the memory of a thread
+    static constexpr size_t MAX_THREAD_EVENTS = 1 << 20;
+
+private:
+    using CLOCK = std::chrono::steady_clock;
+
+    struct EVENT
+    {
+        char    m_Name[MAX_NAME_LENGTH + 1];
+        int64_t m_Start;
+        int64_t m_Duration;
+    };
+
+    static constexpr size_t CHUNK_SIZE = 1024;
+
+    struct CHUNK
+    {
+        EVENT               m_Events[CHUNK_SIZE];
+        std::atomic<size_t> m_Count;
+        std::atomic<CHUNK*> m_Next;
+    };
+
+    struct THREAD_BUFFER
+    {
+        std::thread::id m_Thread;
+        int             m_ThreadIndex;  ///< the tid of the events in the trace
+        CHUNK*          m_First;
+        CHUNK*          m_Last;         ///< the chunk being filled, only used by its thread
+        size_t          m_EventCount;
+    };
+
+    THREAD_BUFFER* threadBuffer();
+
+    bool                                        m_enabled;
+    std::string                                 m_fileName;
+    CLOCK::time_point                           m_origin;
+    uint64_t                                    m_id;   ///< tells the recorders apart
+
+    mutable std::mutex                          m_buffersMutex;
+    std::vector<std::unique_ptr<THREAD_BUFFER>> m_buffers;
+};
+
+
+/**
+ * Record the time spent in a scope in the trace of the application, for example:
+ *
+ *     void ZONE_FILLER::Fill( ... )
+ *     {
+ *         TRACE_SCOPE trace( "zone-fill" );
+ *         ...
+ *
+ * @param aName is the name of the scope, copied when the scope ends
+ */
+class TRACE_SCOPE
+{
+public:
+    explicit TRACE_SCOPE( const char* aName,
+                          TRACE_EVENTS& aEvents = TRACE_EVENTS::GetInstance() ) :
+            m_events( aEvents ),
+            m_name( aName ),
+            m_start( aEvents.IsEnabled() ? aEvents.Now() : 0 )
+    {
+    }
+
+    ~TRACE_SCOPE()
+    {
+        if( m_events.IsEnabled() )
+            m_events.AddEvent( m_name, m_start, m_events.Now() );
+    }
+
+    TRACE_SCOPE( const TRACE_SCOPE& ) = delete;
+    TRACE_SCOPE& operator=( const TRACE_SCOPE& ) = delete;
+
+private:
+    TRACE_EVENTS& m_events;
+    const char*   m_name;
+    int64_t       m_start;
+};
+
+#endif // TRACE_EVENTS_H
@@ -174,6 +174,30 @@ extern const wxChar* const traceSymbolResolver;
  */
 extern const wxChar* const traceSchSheetPaths;
 
+/**
+ * Flag to enable debug output of the zone filler: the time taken by each phase of the fill
+ * of each zone, and the size of the resulting polygons.
+ *
+ * Use "KICAD_ZONE_FILLER" to enable.
+ */
+extern const wxChar* const traceZoneFiller;
+
+/**
+ * Flag to enable the output of the rendering statistics of the GAL canvases, one line per
+ * frame, while they are shown (see EDA_DRAW_PANEL_GAL::SetShowFrameStats()).
+ *
+ * Use "KICAD_GAL_PROFILE" to enable.
+ */
+extern const wxChar* const traceGalProfile;
+
+/**
+ * Flag to enable the output of the memory estimates of the subsystems (see
+ * MEMORY_ACCOUNTING), when a board is loaded and when they are shown in a dialog.
+ *
+ * Use "KICAD_MEMORY" to enable.
+ */
+extern const wxChar* const traceMemory;
+
 ///@}
 
 /**
@@ -25,12 +25,16 @@
 #ifndef __VIEW_H
 #define __VIEW_H
 
+#include <functional>
+#include <map>
 #include <vector>
 #include <set>
 #include <unordered_map>
+#include <unordered_set>
 #include <memory>
 
 #include <math/box2.h>
+#include <math/matrix3x3.h>
 #include <gal/definitions.h>
 
 #include <view/view_overlay.h>
@@ -95,6 +99,21 @@ public:
      */
     virtual void Remove( VIEW_ITEM* aItem );
 
+    /**
+     * Function BeginBulkAdd()
+     * Defers the spatial indexing of the items added to or removed from the view until
+     * EndBulkAdd(), which then builds the index of each layer in one go.  Use it when adding
+     * or removing many items at once, e.g. when loading a board or pushing a large commit.
+     * The view cannot be queried nor drawn until EndBulkAdd().
+     */
+    void BeginBulkAdd();
+
+    /**
+     * Function EndBulkAdd()
+     * Indexes the items added and forgets the items removed since BeginBulkAdd().
+     */
+    void EndBulkAdd();
+
 
     /**
      * Function Query()
@@ -485,7 +504,23 @@ public:
      * Applies the new coloring scheme to all layers. The used scheme is held by RENDER_SETTINGS.
      * @see RENDER_SETTINGS
      */
-    void UpdateAllLayersColor();
+    virtual void UpdateAllLayersColor();
+
+    /**
+     * Sets the function giving the color key of an item, to index the items by key (the net
+     * code of the board items): the items whose color depends on their key can then be
+     * recolored without going through all the items.  The index follows Add(), Remove(),
+     * Update() and Clear().
+     *
+     * @param aKeyFunction returns the key of an item, or a negative value to not index it
+     */
+    void SetColorKeyFunction( std::function<int( const VIEW_ITEM* )> aKeyFunction );
+
+    /**
+     * Applies the coloring scheme to the items of some color keys only, on all their layers.
+     * @see SetColorKeyFunction()
+     */
+    void UpdateColorsOfKeys( const std::set<int>& aKeys );
 
     /**
      * Function SetTopLayer()
@@ -577,6 +612,16 @@ public:
         return m_dirtyTargets[aTarget];
     }
 
+    /**
+     * Function GetDrawnItemCounts()
+     * Returns the number of items drawn on each layer by the last redraw, for the rendering
+     * statistics. Layers without drawn items are not listed.
+     */
+    const std::map<int, int>& GetDrawnItemCounts() const
+    {
+        return m_drawnItemCounts;
+    }
+
     /**
      * Function MarkTargetDirty()
      * Sets or clears target 'dirty' flag.
@@ -586,8 +631,18 @@ public:
     {
         wxCHECK( aTarget < TARGETS_NUMBER, /* void */ );
         m_dirtyTargets[aTarget] = true;
+        m_dirtyAreas[aTarget].SetMaximum();
     }
 
+    /**
+     * Function MarkTargetDirty()
+     * Sets the target 'dirty' flag, for a part of the world only.  The GAL may then redraw
+     * this part of the target and keep the rest of it.
+     * @param aTarget is the target to set.
+     * @param aArea is the area to redraw, in world coordinates.
+     */
+    void MarkTargetDirty( int aTarget, const BOX2I& aArea );
+
     /// Returns true if the layer is cached
     inline bool IsCached( int aLayer ) const
     {
@@ -610,7 +665,7 @@ public:
     void MarkDirty()
     {
         for( int i = 0; i < TARGETS_NUMBER; ++i )
-            m_dirtyTargets[i] = true;
+            MarkTargetDirty( i );
     }
 
     /**
@@ -735,8 +790,28 @@ protected:
     {
         wxCHECK( aTarget < TARGETS_NUMBER, /* void */ );
         m_dirtyTargets[aTarget] = false;
+        m_dirtyAreas[aTarget] = BOX2I();
     }
 
+    /**
+     * Function mergeDirtyAreas()
+     * Sets the dirty area of both the cached and the non-cached targets (which share the same
+     * buffer) to the merge of their dirty areas, inflated to cover the antialiased edges.
+     * @param aScreenRect is set to the part of the screen covered by this area.
+     * @return false if the targets have to be redrawn in full.
+     */
+    bool mergeDirtyAreas( BOX2I& aScreenRect );
+
+    /**
+     * Function markPanned()
+     * Marks the targets dirty after the viewport has been moved, if it has been moved only.
+     * The previous frame is then scrolled and only the parts of the screen exposed by the move
+     * are redrawn.
+     * @param aOldMatrix is the world to screen matrix before the move.
+     * @return false if the viewport has not been simply moved by a number of pixels.
+     */
+    bool markPanned( const MATRIX3x3D& aOldMatrix );
+
     /**
      * Function draw()
      * Draws an item, but on a specified layers. It has to be marked that some of drawing settings
@@ -784,9 +859,28 @@ protected:
      */
     void invalidateItem( VIEW_ITEM* aItem, int aUpdateFlags );
 
+    /**
+     * Function prepareItems()
+     * Lets the painter prepare in parallel the items that are going to be redrawn by
+     * UpdateItems().
+     */
+    void prepareItems();
+
+    /**
+     * Function drawProxy()
+     * Draws an item too small to be seen in detail as a filled square of aSize world units.
+     */
+    void drawProxy( VIEW_ITEM* aItem, int aLayer, double aSize );
+
     /// Updates colors that are used for an item to be drawn
     void updateItemColor( VIEW_ITEM* aItem, int aLayer );
 
+    /// Moves an item to the index entry of its current color key
+    void indexColorKey( VIEW_ITEM* aItem );
+
+    /// Removes an item from the color key index
+    void unindexColorKey( VIEW_ITEM* aItem );
+
     /// Updates all informations needed to draw an item
     void updateItemGeometry( VIEW_ITEM* aItem, int aLayer );
 
@@ -854,6 +948,16 @@ protected:
     /// Flags to mark targets as dirty, so they have to be redrawn on the next refresh event
     bool m_dirtyTargets[TARGETS_NUMBER];
 
+    /// Parts of the dirty targets to redraw (in world coordinates), a maximum box for the whole
+    /// target
+    BOX2I m_dirtyAreas[TARGETS_NUMBER];
+
+    /// Number of items drawn on each layer by the last redraw
+    std::map<int, int> m_drawnItemCounts;
+
+    /// Shift of the screen contents (in pixels) since the last redraw, see markPanned()
+    VECTOR2I m_scrollOffset;
+
     /// Rendering order modifier for layers that are marked as top layers
     static const int TOP_LAYER_MODIFIER;
 
@@ -867,6 +971,18 @@ protected:
     /// Flag to reverse the draw order when using draw priority
     bool m_reverseDrawOrder;
 
+    /// Flag to defer the indexing of the added items (see BeginBulkAdd())
+    bool m_bulkAdd;
+
+    /// The items removed since BeginBulkAdd(), still in m_allItems until EndBulkAdd()
+    std::unordered_set<VIEW_ITEM*> m_bulkRemoved;
+
+    /// Gives the color key of the items (see SetColorKeyFunction())
+    std::function<int( const VIEW_ITEM* )> m_colorKeyFunction;
+
+    /// The items of each color key
+    std::unordered_map<int, std::unordered_set<VIEW_ITEM*>> m_colorKeyIndex;
+
     /// A control for printing: m_printMode <= 0 means no printing mode (normal draw mode
     /// m_printMode > 0 is a printing mode (currently means "we are in printing mode")
     int m_printMode;
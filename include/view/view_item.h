@@ -143,6 +143,17 @@ public:
         return 0;
     }
 
+    /**
+     * Function ViewGetProxyLayer()
+     * Returns the layer on which the item is drawn as a filled square, when it is only a
+     * couple of pixels wide on the screen. It is not drawn on its other layers at that size.
+     * @return the proxy layer, or -1 to always draw the item in full (the default).
+     */
+    virtual int ViewGetProxyLayer() const
+    {
+        return -1;
+    }
+
 public:
 
     VIEW_ITEM_DATA* viewPrivData() const
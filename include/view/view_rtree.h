@@ -29,6 +29,8 @@
 
 #include <geometry/rtree.h>
 
+#include <vector>
+
 namespace KIGFX
 {
 typedef RTree<VIEW_ITEM*, int, 2, double> VIEW_RTREE_BASE;
@@ -55,6 +57,28 @@ public:
         VIEW_RTREE_BASE::Insert( mmin, mmax, aItem );
     }
 
+    /**
+     * Function BulkLoad()
+     * Replaces the content of the tree by aItems.  Much faster than inserting the items
+     * one by one, and gives a tree which is faster to search.
+     */
+    void BulkLoad( const std::vector<VIEW_ITEM*>& aItems )
+    {
+        std::vector<std::pair<Rect, VIEW_ITEM*>> items;
+
+        items.reserve( aItems.size() );
+
+        for( VIEW_ITEM* item : aItems )
+        {
+            const BOX2I& bbox = item->ViewBBox();
+
+            items.push_back( { { { bbox.GetX(), bbox.GetY() },
+                                 { bbox.GetRight(), bbox.GetBottom() } }, item } );
+        }
+
+        VIEW_RTREE_BASE::BulkLoad( items );
+    }
+
     /**
      * Function Remove()
      * Removes an item from the tree. Removal is done by comparing pointers, attepmting to remove a copy
@@ -71,6 +95,21 @@ public:
         VIEW_RTREE_BASE::Remove( mmin, mmax, aItem );
     }
 
+    /**
+     * Function Remove()
+     * Removes an item from the tree, looking for it first in aBBox (the bounding box it was
+     * inserted with), then in the whole tree.
+     */
+    void Remove( VIEW_ITEM* aItem, const BOX2I& aBBox )
+    {
+        const int       mmin[2] = { aBBox.GetX(), aBBox.GetY() };
+        const int       mmax[2] = { aBBox.GetRight(), aBBox.GetBottom() };
+
+        // 1 == not found: the item was indexed with another bounding box
+        if( VIEW_RTREE_BASE::Remove( mmin, mmax, aItem ) )
+            Remove( aItem );
+    }
+
     /**
      * Function Query()
      * Executes a function object aVisitor for each item whose bounding box intersects
@@ -639,6 +639,20 @@ protected:
      */
     void UpdateViewBoundary( wxCoord xnew, wxCoord ynew );
 
+    /** Gives the points of a continuous plot when there are many more samples than pixels.
+     *  The default implementation gives none: all the samples are drawn.
+     *  @param w The window to plot to
+     *  @param startPx The first visible pixel column
+     *  @param endPx The last visible pixel column
+     *  @param points Returns the points to draw
+     *  @return true if the points were given
+     */
+    virtual bool GetDecimatedPoints( mpWindow& w, wxCoord startPx, wxCoord endPx,
+                                     std::vector<wxPoint>& points )
+    {
+        return false;
+    }
+
     DECLARE_DYNAMIC_CLASS( mpFXY )
 };
 
@@ -1579,6 +1593,14 @@ public:
      */
     virtual void SetData( const std::vector<double>& xs, const std::vector<double>& ys );
 
+    /** Appends points to the internal data.  This method DOES NOT refresh the mpWindow.
+     * @param xs The x values of the points
+     * @param ys The y values of the points
+     * @param count The number of points
+     * @sa SetData
+     */
+    void AppendData( const double* xs, const double* ys, size_t count );
+
     /** Clears all the data, leaving the layer empty.
      * @sa SetData
      */
@@ -1589,6 +1611,42 @@ protected:
      */
     std::vector<double> m_xs, m_ys;
 
+    /** Number of blocks of a level of the LOD pyramid summarized by a block of the next level.
+     */
+    static constexpr size_t LOD_FACTOR = 16;
+
+    /** A level of the LOD pyramid: the min and max y values of the blocks of LOD_FACTOR^n
+     *  consecutive samples.  The samples themselves are the level 0.
+     */
+    struct LOD_LEVEL
+    {
+        std::vector<double> m_min, m_max;
+    };
+
+    /** The LOD pyramid, built at the first plot that needs it.
+     */
+    std::vector<LOD_LEVEL> m_lod;
+    bool m_lodValid;
+
+    /** True if the x values are sorted (checked when building the LOD pyramid).
+     */
+    bool m_xSorted;
+
+    /** Builds the LOD pyramid of the data.
+     */
+    void BuildLod();
+
+    /** Gives the min and max y values of the samples in [first, last) from the LOD pyramid.
+     */
+    void GetRangeMinMax( size_t first, size_t last, double& ymin, double& ymax ) const;
+
+    /** Gives the first, min, max and last points of the samples of each pixel column, which
+     *  draw the same envelope as all the samples.
+     *  Overridden in this implementation.
+     */
+    bool GetDecimatedPoints( mpWindow& w, wxCoord startPx, wxCoord endPx,
+                             std::vector<wxPoint>& points ) override;
+
     /** The internal counter for the "GetNextXY" interface
      */
     size_t m_index;
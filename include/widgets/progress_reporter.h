@@ -25,8 +25,10 @@
 #ifndef __PROGRESS_REPORTER
 #define __PROGRESS_REPORTER
 
-#include <mutex>
+#include <array>
 #include <atomic>
+#include <chrono>
+#include <mutex>
 
 #include <wx/progdlg.h>
 #include <wx/gauge.h>
@@ -36,6 +38,10 @@
  * and message methods can be called from sub-threads.  The KeepRefreshing method *MUST*
  * be called only from the main thread (primarily a MSW requirement, which won't allow
  * access to UI objects allocated from a separate thread).
+ *
+ * Each thread counts its progress in its own shard of the counter, so the workers do not
+ * fight for a cache line; the shards are summed by the main thread, which updates the UI
+ * at most every REFRESH_INTERVAL.
  */
 class PROGRESS_REPORTER
 {
@@ -71,15 +77,25 @@ class PROGRESS_REPORTER
 
         /**
          * Increment the progress bar length (inside the current virtual zone)
+         * @param aCount is the number of items done, to report a batch of items at once
          */
-        void AdvanceProgress();
+        void AdvanceProgress( int aCount = 1 );
 
         /**
          * Update the UI dialog.  *MUST* only be called from the main thread.
          * Returns false if the user clicked Cancel.
+         *
+         * The dialog is only updated if it was not in the last REFRESH_INTERVAL, so this
+         * can be called often.
          */
         bool KeepRefreshing( bool aWait = false );
 
+        /**
+         * @return true if the user clicked Cancel.  Cheap enough to be polled by the
+         *         workers for each item.
+         */
+        bool IsCancelled() const { return m_cancelled.load( std::memory_order_relaxed ); }
+
         /** change the title displayed on the window caption
          * *MUST* only be called from the main thread.
          * Has meaning only for some reporters.
@@ -90,16 +106,45 @@ class PROGRESS_REPORTER
 
     protected:
 
+        ///> The minimum time between two updates of the UI by KeepRefreshing()
+        static constexpr std::chrono::milliseconds REFRESH_INTERVAL{ 50 };
+
         int currentProgress() const;
 
         virtual bool updateUI() = 0;
 
+        /**
+         * Copy the message to aMessage.
+         * @return false (aMessage being left alone) if it did not change since the last call
+         */
+        bool takeMessage( wxString& aMessage );
+
         wxString           m_rptMessage;
         mutable std::mutex m_mutex;
+        std::atomic_bool   m_messageChanged;
         std::atomic_int    m_phase;
         std::atomic_int    m_numPhases;
-        std::atomic_int    m_progress;
         std::atomic_int    m_maxProgress;
+        std::atomic_bool   m_cancelled;
+
+    private:
+
+        static constexpr int SHARD_COUNT = 16;
+
+        ///> A part of the progress counter, alone in its cache line
+        struct SHARD
+        {
+            std::atomic_int m_Count;
+            char            m_Padding[64 - sizeof( std::atomic_int )];
+        };
+
+        ///> @return the sum of the shards
+        int progress() const;
+
+        void clearProgress();
+
+        std::array<SHARD, SHARD_COUNT>        m_shards;
+        std::chrono::steady_clock::time_point m_lastRefresh;
 };
 
 
@@ -314,6 +314,34 @@ public:
     DSIZE               m_ConstrainedTextSize;  // Actual text size, if constrained by
                                                 // the m_BoundingBoxSize constraint
 
+private:
+    // The inputs of the last text measurement of SetConstrainedTextSize(), which is skipped
+    // while they do not change (as for most of the texts from a sheet to the next one)
+    struct CONSTRAINED_SIZE_INPUTS
+    {
+        wxString            m_Text;
+        DSIZE               m_TextSize;
+        DSIZE               m_BoundingBoxSize;
+        double              m_Orient;
+        EDA_TEXT_HJUSTIFY_T m_Hjustify;
+        EDA_TEXT_VJUSTIFY_T m_Vjustify;
+        bool                m_Italic;
+        bool                m_Bold;
+
+        bool operator==( const CONSTRAINED_SIZE_INPUTS& aOther ) const
+        {
+            return m_Text == aOther.m_Text && m_TextSize == aOther.m_TextSize
+                   && m_BoundingBoxSize == aOther.m_BoundingBoxSize
+                   && m_Orient == aOther.m_Orient && m_Hjustify == aOther.m_Hjustify
+                   && m_Vjustify == aOther.m_Vjustify && m_Italic == aOther.m_Italic
+                   && m_Bold == aOther.m_Bold;
+        }
+    };
+
+    bool                    m_measured;         // m_measuredInputs and m_measuredSize are set
+    CONSTRAINED_SIZE_INPUTS m_measuredInputs;
+    DSIZE                   m_measuredSize;     // m_ConstrainedTextSize for m_measuredInputs
+
 
 public:
     WS_DATA_ITEM_TEXT( const wxString& aTextBase );
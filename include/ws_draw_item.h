@@ -31,6 +31,8 @@
 #include "msgpanel.h"
 #include <geometry/shape_poly_set.h>
 
+#include <unordered_set>
+
 class WS_DATA_ITEM;
 class TITLE_BLOCK;
 class PAGE_INFO;
@@ -351,6 +353,7 @@ class WS_DRAW_ITEM_LIST
 {
 protected:
     std::vector <WS_DRAW_ITEM_BASE*> m_graphicList;     // Items to draw/plot
+    std::unordered_set<WS_DRAW_ITEM_BASE*> m_graphicSet; // The items of m_graphicList
     unsigned           m_idx;             // for GetFirst, GetNext functions
     double             m_milsToIu;        // the scalar to convert pages units ( mils)
                                           // to draw/plot units.
@@ -456,10 +459,16 @@ public:
     void Append( WS_DRAW_ITEM_BASE* aItem )
     {
         m_graphicList.push_back( aItem );
+        m_graphicSet.insert( aItem );
     }
 
     void Remove( WS_DRAW_ITEM_BASE* aItem )
     {
+        // The data items remove their previous draw items before appending the new ones:
+        // usually they are not in this list, don't search them
+        if( !m_graphicSet.erase( aItem ) )
+            return;
+
         auto newEnd = std::remove( m_graphicList.begin(), m_graphicList.end(), aItem );
         m_graphicList.erase( newEnd, m_graphicList.end() );
     }
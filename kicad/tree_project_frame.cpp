@@ -119,7 +119,7 @@ const wxString GerberFileExtensionWildCard( ".((gbr|gbrjob|(gb|gt)[alops])|pho)"
 
 BEGIN_EVENT_TABLE( TREE_PROJECT_FRAME, wxSashLayoutWindow )
     EVT_TREE_ITEM_ACTIVATED( ID_PROJECT_TREE, TREE_PROJECT_FRAME::OnSelect )
-    EVT_TREE_ITEM_EXPANDED( ID_PROJECT_TREE, TREE_PROJECT_FRAME::OnExpand )
+    EVT_TREE_ITEM_EXPANDING( ID_PROJECT_TREE, TREE_PROJECT_FRAME::OnExpand )
     EVT_TREE_ITEM_RIGHT_CLICK( ID_PROJECT_TREE, TREE_PROJECT_FRAME::OnRight )
     EVT_MENU( ID_PROJECT_TXTEDIT, TREE_PROJECT_FRAME::OnOpenSelectedFileWithTextEditor )
     EVT_MENU( ID_PROJECT_SWITCH_TO_OTHER, TREE_PROJECT_FRAME::OnSwitchToSelectedProject )
@@ -290,7 +290,7 @@ wxString TREE_PROJECT_FRAME::GetFileExt( TreeFileType type )
 
 
 wxTreeItemId TREE_PROJECT_FRAME::AddItemToTreeProject(
-        const wxString& aName, wxTreeItemId& aRoot, bool aCanResetFileWatcher, bool aRecurse )
+        const wxString& aName, wxTreeItemId& aRoot, bool aCheckDuplicates )
 {
     wxTreeItemId newItemId;
     TreeFileType    type = TREE_UNKNOWN;
@@ -415,7 +415,10 @@ wxTreeItemId TREE_PROJECT_FRAME::AddItemToTreeProject(
 
     // also check to see if it is already there.
     wxTreeItemIdValue   cookie;
-    wxTreeItemId        kid = m_TreeProject->GetFirstChild( aRoot, cookie );
+    wxTreeItemId        kid;
+
+    if( aCheckDuplicates )
+        kid = m_TreeProject->GetFirstChild( aRoot, cookie );
 
     while( kid.IsOk() )
     {
@@ -447,45 +450,66 @@ wxTreeItemId TREE_PROJECT_FRAME::AddItemToTreeProject(
     else
         data->SetRootFile( false );
 
-#ifndef __WINDOWS__
-    bool subdir_populated = false;
-#endif
+    // The directory is read when expanded: until then, assume it is not empty so it can be
+    // expanded
+    if( TREE_DIRECTORY == type )
+        m_TreeProject->SetItemHasChildren( newItemId, true );
 
-    // This section adds dirs and files found in the subdirs
-    // in this case AddFile is recursive, but for the first level only.
-    if( TREE_DIRECTORY == type && aRecurse )
-    {
-        wxDir   dir( aName );
+    return newItemId;
+}
 
-        if( dir.IsOpened() )    // protected dirs will not open properly.
-        {
-            wxString        dir_filename;
 
-            data->SetPopulated( true );
-#ifndef __WINDOWS__
-            subdir_populated = aCanResetFileWatcher;
-#endif
+void TREE_PROJECT_FRAME::populateDirectory( const wxTreeItemId& aDir )
+{
+    TREEPROJECT_ITEM* itemData = GetItemIdData( aDir );
+
+    if( !itemData || itemData->GetType() != TREE_DIRECTORY || itemData->IsPopulated() )
+        return;
+
+    wxString     fileName = itemData->GetFileName();
+    wxDir        dir( fileName );
+    wxTreeItemId dirId = aDir;
 
-            if( dir.GetFirst( &dir_filename ) )
+    if( dir.IsOpened() )    // protected dirs will not open properly.
+    {
+        wxString dir_filename;
+
+        if( dir.GetFirst( &dir_filename ) )
+        {
+            do    // Add name to tree item, but do not read the subdirs
             {
-                do    // Add name in tree, but do not recurse
-                {
-                    wxString path = aName + wxFileName::GetPathSeparator() + dir_filename;
-                    AddItemToTreeProject( path, newItemId, false, false );
-                } while( dir.GetNext( &dir_filename ) );
-            }
+                wxString name = fileName + wxFileName::GetPathSeparator() + dir_filename;
+                AddItemToTreeProject( name, dirId, false );
+            } while( dir.GetNext( &dir_filename ) );
         }
 
-        // Sort filenames by alphabetic order
-        m_TreeProject->SortChildren( newItemId );
+        itemData->SetPopulated( true );       // set state to populated
+        watchDirectory( fileName );
     }
 
+    if( m_TreeProject->GetChildrenCount( aDir, false ) == 0 )
+        m_TreeProject->SetItemHasChildren( aDir, false );
+
+    // Sort filenames by alphabetic order
+    m_TreeProject->SortChildren( aDir );
+}
+
+
+void TREE_PROJECT_FRAME::watchDirectory( const wxString& aPath )
+{
+    // Under Windows, the whole project tree is already watched (see FileWatcherReset())
 #ifndef __WINDOWS__
-    if( subdir_populated )
-        FileWatcherReset();
-#endif
+    if( !m_watcher || !wxFileName::IsDirReadable( aPath ) )
+        return;
 
-    return newItemId;
+    wxFileName fn;
+    fn.AssignDir( aPath );
+    fn.DontFollowLink();
+
+    wxLogTrace( tracePathsAndFiles, "%s: add '%s'\n", __func__, TO_UTF8( aPath ) );
+
+    m_watcher->Add( fn );
+#endif
 }
 
 
@@ -829,63 +853,8 @@ void TREE_PROJECT_FRAME::OnSelect( wxTreeEvent& Event )
 
 void TREE_PROJECT_FRAME::OnExpand( wxTreeEvent& Event )
 {
-    wxTreeItemId        itemId      = Event.GetItem();
-    TREEPROJECT_ITEM*   tree_data   = GetItemIdData( itemId );
-
-    if( !tree_data )
-        return;
-
-    if( tree_data->GetType() != TREE_DIRECTORY )
-        return;
-
-    // explore list of non populated subdirs, and populate them
-    wxTreeItemIdValue   cookie;
-    wxTreeItemId        kid = m_TreeProject->GetFirstChild( itemId, cookie );
-
-#ifndef __WINDOWS__
-    bool subdir_populated = false;
-#endif
-
-    for( ; kid.IsOk(); kid = m_TreeProject->GetNextChild( itemId, cookie ) )
-    {
-        TREEPROJECT_ITEM* itemData = GetItemIdData( kid );
-
-        if( !itemData || itemData->GetType() != TREE_DIRECTORY )
-            continue;
-
-        if( itemData->IsPopulated() )
-            continue;
-
-        wxString    fileName = itemData->GetFileName();
-        wxDir       dir( fileName );
-
-        if( dir.IsOpened() )
-        {
-            wxString    dir_filename;
-
-            if( dir.GetFirst( &dir_filename ) )
-            {
-                do    // Add name to tree item, but do not recurse in subdirs:
-                {
-                    wxString name = fileName + wxFileName::GetPathSeparator() + dir_filename;
-                    AddItemToTreeProject( name, kid, false );
-                } while( dir.GetNext( &dir_filename ) );
-            }
-
-            itemData->SetPopulated( true );       // set state to populated
-#ifndef __WINDOWS__
-            subdir_populated = true;
-#endif
-        }
-
-        // Sort filenames by alphabetic order
-        m_TreeProject->SortChildren( kid );
-    }
-
-#ifndef __WINDOWS__
-    if( subdir_populated )
-        FileWatcherReset();
-#endif
+    // Only the directories being expanded are read, whatever the size of the project tree
+    populateDirectory( Event.GetItem() );
 }
 
 
@@ -991,6 +960,12 @@ void TREE_PROJECT_FRAME::OnFileSystemEvent( wxFileSystemWatcherEvent& event )
     if( !root_id.IsOk() )
         return;
 
+    TREEPROJECT_ITEM* subdirData = GetItemIdData( root_id );
+
+    // A directory not read yet will be read with its changes when expanded
+    if( subdirData && subdirData->GetType() == TREE_DIRECTORY && !subdirData->IsPopulated() )
+        return;
+
     wxTreeItemIdValue  cookie;  // dummy variable needed by GetFirstChild()
     wxTreeItemId kid = m_TreeProject->GetFirstChild( root_id, cookie );
 
@@ -1091,7 +1066,8 @@ void TREE_PROJECT_FRAME::FileWatcherReset()
 
     // Add directories which should be monitored.
     // under windows, we add the curr dir and all subdirs
-    // under unix, we add only the curr dir and the populated subdirs
+    // under unix, we add only the curr dir and the populated subdirs (the next ones are added
+    // when they are populated, see watchDirectory())
     // see  http://docs.wxwidgets.org/trunk/classwx_file_system_watcher.htm
     // under unix, the file watcher needs more work to be efficient
     // moreover, under wxWidgets 2.9.4, AddTree does not work properly.
@@ -1127,7 +1103,7 @@ void TREE_PROJECT_FRAME::FileWatcherReset()
 
         TREEPROJECT_ITEM* itemData = GetItemIdData( kid );
 
-        if( itemData && itemData->GetType() == TREE_DIRECTORY )
+        if( itemData && itemData->GetType() == TREE_DIRECTORY && itemData->IsPopulated() )
         {
             // we can see wxString under a debugger, not a wxFileName
             const wxString& path = itemData->GetFileName();
@@ -1140,7 +1116,7 @@ void TREE_PROJECT_FRAME::FileWatcherReset()
                 m_watcher->Add( fn );
 
                 // if kid is a subdir, push in list to explore it later
-                if( itemData->IsPopulated() && m_TreeProject->GetChildrenCount( kid ) )
+                if( m_TreeProject->GetChildrenCount( kid ) )
                     subdirs_id.push( kid );
             }
         }
@@ -100,7 +100,8 @@ private:
     void OnSelect( wxTreeEvent& Event );
 
     /**
-     * Called on a click on the + or - button of an item with children
+     * Called before an item with children is expanded: reads the contents of a directory the
+     * first time it is expanded
      */
     void OnExpand( wxTreeEvent& Event );
 
@@ -156,14 +157,27 @@ private:
      * Function AddItemToTreeProject
      * @brief  Add the file or directory aName to the project tree
      * @param aName = the filename or the directory name to add in tree
+     * The contents of a directory are only read when it is expanded (see populateDirectory()).
      * @param aRoot = the wxTreeItemId item where to add sub tree items
-     * @param aCanResetFileWatcher = true to reset file watcher if additional conditions are met
-     * @param aRecurse = true to add file or subdir names to the current tree item
-     *                   false to stop file add.
+     * @param aCheckDuplicates = false when aRoot is known not to hold aName yet, to
+     *                           avoid comparing it to all the files of aRoot
      * @return the Id for the new tree item
      */
     wxTreeItemId AddItemToTreeProject( const wxString& aName, wxTreeItemId& aRoot,
-            bool aCanResetFileWatcher = true, bool aRecurse = true );
+            bool aCheckDuplicates = true );
+
+    /**
+     * Function populateDirectory
+     * adds the files and subdirectories of the directory item aDir to the tree, and watches
+     * the directory for changes.  Its subdirectories are not read.
+     */
+    void populateDirectory( const wxTreeItemId& aDir );
+
+    /**
+     * Function watchDirectory
+     * adds the directory aPath to the watched paths, once it has been populated.
+     */
+    void watchDirectory( const wxString& aPath );
 
     /**
      * Function findSubdirTreeItem
@@ -0,0 +1,124 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef __APPROXIMATION_CACHE_H
+#define __APPROXIMATION_CACHE_H
+
+#include <array>
+#include <cstring>              // for memcpy
+#include <mutex>
+#include <stdint.h>
+#include <unordered_map>
+
+
+/**
+ * APPROXIMATION_CACHE
+ *
+ * A small thread safe cache of the polygonal approximations of curved shapes (arcs, circles,
+ * rounded pads...), which are built over and over with the same error tolerance by the zone
+ * filler, the DRC, the plotters and the 3D viewer.
+ *
+ * The key is made of the N integer parameters of the approximation (the error tolerance
+ * included); doubles are stored with Bits().  The values are meant to be cheap to copy,
+ * usually shared pointers to const shapes.  The cache is simply emptied when it reaches
+ * its maximum size.
+ */
+template <size_t N, class VALUE>
+class APPROXIMATION_CACHE
+{
+public:
+    typedef std::array<int64_t, N> KEY;
+
+    APPROXIMATION_CACHE( size_t aMaxEntries ) :
+            m_maxEntries( aMaxEntries )
+    {}
+
+    /**
+     * Function Get()
+     * @return the value cached for aKey if any, otherwise the one returned by aBuild(),
+     *         which is then cached.  aBuild() is called without holding the cache lock, so
+     *         two threads may build the same value.
+     */
+    template <class BUILD>
+    VALUE Get( const KEY& aKey, BUILD aBuild )
+    {
+        {
+            std::lock_guard<std::mutex> lock( m_lock );
+            auto                        it = m_cache.find( aKey );
+
+            if( it != m_cache.end() )
+                return it->second;
+        }
+
+        VALUE value = aBuild();
+
+        std::lock_guard<std::mutex> lock( m_lock );
+
+        if( m_cache.size() >= m_maxEntries )
+            m_cache.clear();
+
+        m_cache.emplace( aKey, value );
+
+        return value;
+    }
+
+    void Clear()
+    {
+        std::lock_guard<std::mutex> lock( m_lock );
+        m_cache.clear();
+    }
+
+    size_t size() const
+    {
+        std::lock_guard<std::mutex> lock( m_lock );
+        return m_cache.size();
+    }
+
+    ///> The bits of a double, to be used in a key
+    static int64_t Bits( double aValue )
+    {
+        int64_t bits;
+        memcpy( &bits, &aValue, sizeof( bits ) );
+        return bits;
+    }
+
+private:
+    struct KEY_HASH
+    {
+        size_t operator()( const KEY& aKey ) const
+        {
+            size_t seed = 0;
+
+            for( int64_t v : aKey )
+                seed ^= std::hash<int64_t>()( v ) + 0x9e3779b9 + ( seed << 6 ) + ( seed >> 2 );
+
+            return seed;
+        }
+    };
+
+    mutable std::mutex                       m_lock;
+    std::unordered_map<KEY, VALUE, KEY_HASH> m_cache;
+    size_t                                   m_maxEntries;
+};
+
+#endif // __APPROXIMATION_CACHE_H
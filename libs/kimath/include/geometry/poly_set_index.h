@@ -0,0 +1,174 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef __POLY_SET_INDEX_H
+#define __POLY_SET_INDEX_H
+
+#include <vector>
+
+#include <geometry/seg.h>
+#include <geometry/shape_poly_set.h>
+#include <math/box2.h>
+#include <math/vector2d.h>
+
+
+/**
+ * POLY_SET_INDEX
+ *
+ * A fast point containment and edge crossing index of the polygons of a SHAPE_POLY_SET.
+ * The edges of each contour are sorted into horizontal rows, so a query only tests the
+ * edges of the rows it covers instead of every edge of the set.
+ *
+ * The index holds a copy of the vertices and is never modified once built, so it may be
+ * queried from several threads.  Use SHAPE_POLY_SET::GetIndex() to get the (shared) index
+ * of a set rather than building one for each query.
+ */
+class POLY_SET_INDEX
+{
+public:
+    POLY_SET_INDEX( const SHAPE_POLY_SET& aSet );
+
+    /**
+     * Function Contains
+     * gives the same result as SHAPE_POLY_SET::Contains( aP, aSubpolyIndex, aAccuracy ).
+     * @param aSubpolyIndex is the polygon to test, or -1 for any polygon of the set.
+     * @param aAccuracy is the accuracy of the outline test (see SHAPE_LINE_CHAIN::PointInside).
+     */
+    bool Contains( const VECTOR2I& aP, int aSubpolyIndex = -1, int aAccuracy = 0 ) const;
+
+    /**
+     * Function ContainsPoints
+     * runs Contains() for each point of aPoints.
+     * @return a vector of the results, in the order of aPoints.
+     */
+    std::vector<bool> ContainsPoints( const std::vector<VECTOR2I>& aPoints,
+                                      int aSubpolyIndex = -1, int aAccuracy = 0 ) const;
+
+    /**
+     * Function Collide
+     * @return true if aP is inside a polygon (outside of its holes), or if an edge of the
+     *         set (outline or hole) is within aClearance of aP.  Points on an edge collide.
+     */
+    bool Collide( const VECTOR2I& aP, int aClearance = 0, int aSubpolyIndex = -1 ) const;
+
+    /**
+     * Function Intersects
+     * @return true if aSeg crosses or touches an edge of the set (outline or hole).  A segment
+     *         entirely inside or outside of the polygons does not intersect them.
+     */
+    bool Intersects( const SEG& aSeg, int aSubpolyIndex = -1 ) const;
+
+    ///> Returns the bounding box of the polygons, or of the aSubpolyIndex-th one
+    const BOX2I& BBox( int aSubpolyIndex = -1 ) const
+    {
+        return aSubpolyIndex < 0 ? m_bbox : m_polygons[aSubpolyIndex].m_bbox;
+    }
+
+    int OutlineCount() const
+    {
+        return (int) m_polygons.size();
+    }
+
+    /**
+     * Function Matches
+     * @return true if the polygons of aSet are the ones the index was built from, i.e. if it
+     *         is (still) a valid index of aSet.
+     */
+    bool Matches( const SHAPE_POLY_SET& aSet ) const;
+
+private:
+    /**
+     * ROWS
+     * sorts a list of items spanning vertical ranges into rows of equal height.
+     */
+    class ROWS
+    {
+    public:
+        ///> aRanges is the min and max y of each item
+        void Build( const std::vector<std::pair<int, int>>& aRanges, int aMinY, int aMaxY,
+                    int aRowCount );
+
+        /**
+         * Calls aVisitor( item ) for each item whose range may intersect [aMinY, aMaxY], once
+         * per item, until it returns true.
+         * @return true if aVisitor returned true.
+         */
+        template <class VISITOR>
+        bool Query( int aMinY, int aMaxY, VISITOR aVisitor ) const;
+
+    private:
+        int row( int64_t aY ) const;
+
+        int64_t          m_minY = 0;
+        int64_t          m_rowHeight = 1;
+        std::vector<int> m_rowStart;     ///< first entry of each row in m_items, plus the end
+        std::vector<int> m_items;
+        std::vector<int> m_firstRow;     ///< the first row of each item
+    };
+
+    struct CONTOUR
+    {
+        std::vector<VECTOR2I> m_points;
+        BOX2I                 m_bbox;
+        bool                  m_closed;
+        ROWS                  m_rows;    ///< of the edges, edge i going from point i to i+1
+
+        int EdgeCount() const
+        {
+            return m_closed ? (int) m_points.size() : (int) m_points.size() - 1;
+        }
+
+        SEG Edge( int aIndex ) const
+        {
+            return SEG( m_points[aIndex], m_points[( aIndex + 1 ) % m_points.size()] );
+        }
+
+        ///> The result of SHAPE_LINE_CHAIN::PointInside( aP, aAccuracy )
+        bool PointInside( const VECTOR2I& aP, int aAccuracy ) const;
+
+        ///> True if an edge is within aDist of aP (with the tolerance of PointOnEdge())
+        bool EdgeNear( const VECTOR2I& aP, int aDist ) const;
+
+        ///> True if an edge is at most at aDist of aP, exactly
+        bool EdgeWithin( const VECTOR2I& aP, int aDist ) const;
+
+        bool Intersects( const SEG& aSeg ) const;
+    };
+
+    struct POLYGON
+    {
+        std::vector<CONTOUR> m_contours; ///< the outline, then the holes
+        BOX2I                m_bbox;
+    };
+
+    bool containsSingle( const VECTOR2I& aP, const POLYGON& aPolygon, int aAccuracy ) const;
+
+    template <class VISITOR>
+    bool queryPolygons( int aSubpolyIndex, int aMinY, int aMaxY, VISITOR aVisitor ) const;
+
+    std::vector<POLYGON> m_polygons;
+    ROWS                 m_polygonRows;
+    BOX2I                m_bbox;
+};
+
+#endif // __POLY_SET_INDEX_H
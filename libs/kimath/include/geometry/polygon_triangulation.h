@@ -47,8 +47,11 @@
 #define __POLYGON_TRIANGULATION_H
 
 #include <algorithm>
-#include <deque>
 #include <cmath>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
 
 #include <clipper.hpp>
 #include <geometry/shape_line_chain.h>
@@ -95,10 +98,8 @@ private:
          */
         Vertex* split( Vertex* b )
         {
-            parent->m_vertices.emplace_back( i, x, y, parent );
-            Vertex* a2 = &parent->m_vertices.back();
-            parent->m_vertices.emplace_back( b->i, b->x, b->y, parent );
-            Vertex* b2 = &parent->m_vertices.back();
+            Vertex* a2 = parent->vertexPool().Create( i, x, y, parent );
+            Vertex* b2 = parent->vertexPool().Create( b->i, b->x, b->y, parent );
             Vertex* an = next;
             Vertex* bp = b->prev;
 
@@ -179,8 +180,9 @@ private:
          */
         void zSort()
         {
-            std::deque<Vertex*> queue;
+            std::vector<Vertex*>& queue = parent->m_zSortBuffer;
 
+            queue.clear();
             queue.push_back( this );
 
             for( auto p = next; p && p != this; p = p->next )
@@ -232,8 +234,55 @@ private:
         Vertex* nextZ = nullptr;
     };
 
+    /**
+     * VERTEX_POOL
+     * Allocates the vertex nodes in large blocks, which are kept for the next polygons
+     * tesselated on the same thread: once the pool is large enough, tesselating a polygon
+     * does not allocate any node.
+     */
+    class VERTEX_POOL
+    {
+    public:
+        Vertex* Create( size_t aIndex, double aX, double aY, PolygonTriangulation* aParent )
+        {
+            if( m_used == m_blocks.size() * BLOCK_SIZE )
+                m_blocks.emplace_back( new STORAGE[BLOCK_SIZE] );
+
+            STORAGE* slot = &m_blocks[m_used / BLOCK_SIZE][m_used % BLOCK_SIZE];
+            m_used++;
+
+            return new( slot ) Vertex( aIndex, aX, aY, aParent );
+        }
+
+        ///> Forgets all the nodes (which need no destruction), keeping their memory
+        void Reset()
+        {
+            m_used = 0;
+        }
+
+    private:
+        static_assert( std::is_trivially_destructible<Vertex>::value,
+                       "the pool does not destroy the vertices" );
+
+        typedef std::aligned_storage<sizeof( Vertex ), alignof( Vertex )>::type STORAGE;
+
+        static constexpr size_t BLOCK_SIZE = 4096;
+
+        std::vector<std::unique_ptr<STORAGE[]>> m_blocks;
+        size_t                                  m_used = 0;
+    };
+
+    ///> The vertex pool of the current thread.  Only one polygon may be tesselated at a time
+    ///> on a thread, which TesselatePolygon() guarantees.
+    static VERTEX_POOL& vertexPool()
+    {
+        static thread_local VERTEX_POOL pool;
+
+        return pool;
+    }
+
     BOX2I m_bbox;
-    std::deque<Vertex> m_vertices;
+    std::vector<Vertex*> m_zSortBuffer;
     SHAPE_POLY_SET::TRIANGULATED_POLYGON& m_result;
 
     /**
@@ -635,9 +684,8 @@ private:
     Vertex* insertVertex( const VECTOR2I& pt, Vertex* last )
     {
         m_result.AddVertex( pt );
-        m_vertices.emplace_back( m_result.GetVertexCount() - 1, pt.x, pt.y, this );
 
-        Vertex* p = &m_vertices.back();
+        Vertex* p = vertexPool().Create( m_result.GetVertexCount() - 1, pt.x, pt.y, this );
         if( !last )
         {
             p->prev = p;
@@ -660,6 +708,7 @@ public:
     {
         m_bbox = aPoly.BBox();
         m_result.Clear();
+        vertexPool().Reset();
 
         if( !m_bbox.GetWidth() || !m_bbox.GetHeight() )
             return false;
@@ -674,7 +723,7 @@ public:
         firstVertex->updateList();
 
         auto retval = earcutList( firstVertex );
-        m_vertices.clear();
+        vertexPool().Reset();
         return retval;
     }
 };
@@ -177,6 +177,8 @@ public:
     const SHAPE_LINE_CHAIN ConvertToPolyline( double aAccuracy = 500.0 ) const;
 
 private:
+    ///> The uncached ConvertToPolyline()
+    const SHAPE_LINE_CHAIN buildPolyline( double aAccuracy ) const;
 
     bool ccw( const VECTOR2I& aA, const VECTOR2I& aB, const VECTOR2I& aC ) const
     {
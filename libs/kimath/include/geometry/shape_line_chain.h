@@ -28,6 +28,8 @@
 
 
 #include <algorithm>                    // for max
+#include <functional>
+#include <memory>
 #include <sstream>
 #include <vector>
 #include <wx/gdicmn.h>                  // for wxPoint
@@ -121,7 +123,8 @@ public:
               m_arcs( aShape.m_arcs ),
               m_closed( aShape.m_closed ),
               m_width( aShape.m_width ),
-              m_bbox( aShape.m_bbox )
+              m_bbox( aShape.m_bbox ),
+              m_bvh( std::atomic_load( &aShape.m_bvh ) )
     {}
 
     SHAPE_LINE_CHAIN( const std::vector<int>& aV);
@@ -169,7 +172,18 @@ public:
     virtual ~SHAPE_LINE_CHAIN()
     {}
 
-    SHAPE_LINE_CHAIN& operator=(const SHAPE_LINE_CHAIN&) = default;
+    SHAPE_LINE_CHAIN& operator=( const SHAPE_LINE_CHAIN& aOther )
+    {
+        m_points = aOther.m_points;
+        m_shapes = aOther.m_shapes;
+        m_arcs = aOther.m_arcs;
+        m_closed = aOther.m_closed;
+        m_width = aOther.m_width;
+        m_bbox = aOther.m_bbox;
+        m_bvh = std::atomic_load( &aOther.m_bvh );
+
+        return *this;
+    }
 
     SHAPE* Clone() const override;
 
@@ -183,6 +197,7 @@ public:
         m_arcs.clear();
         m_shapes.clear();
         m_closed = false;
+        invalidateBVH();
     }
 
     /**
@@ -195,6 +210,7 @@ public:
     void SetClosed( bool aClosed )
     {
         m_closed = aClosed;
+        invalidateBVH();
     }
 
     /**
@@ -304,6 +320,7 @@ public:
             aIndex -= PointCount();
 
         m_points[aIndex] = aPos;
+        invalidateBVH();
 
         if( m_shapes[aIndex] != SHAPE_IS_PT )
             convertArc( m_shapes[aIndex] );
@@ -400,6 +417,20 @@ public:
      */
     bool Collide( const SEG& aSeg, int aClearance = 0 ) const override;
 
+    /**
+     * Function QuerySegments()
+     *
+     * Calls aVisitor, in increasing index order, with the index of each segment whose
+     * bounding box intersects aBox (boundaries included).  The visitor returns false to
+     * stop the query.  Chains of at least BVH_MIN_SEGMENTS segments build a bounding volume
+     * hierarchy of their segments on the first query, so the query is logarithmic; the
+     * hierarchy is dropped by any change to the chain.  Queries may run concurrently.
+     */
+    void QuerySegments( const BOX2I& aBox, const std::function<bool( int )>& aVisitor ) const;
+
+    ///> Minimum number of segments for which the segment queries use a hierarchy
+    static const int BVH_MIN_SEGMENTS = 128;
+
     /**
      * Function Distance()
      *
@@ -460,6 +491,7 @@ public:
             m_points.push_back( aP );
             m_shapes.push_back( ssize_t( SHAPE_IS_PT ) );
             m_bbox.Merge( aP );
+            invalidateBVH();
         }
     }
 
@@ -670,10 +702,11 @@ public:
     void convertArc( ssize_t aArcIndex );
 
     /**
-     * Creates a new Clipper path from the SHAPE_LINE_CHAIN in a given orientation
-     *
+     * Returns a view of the points of the SHAPE_LINE_CHAIN in a given orientation, to be
+     * added to the Clipper engine without copying them.  The view is valid as long as the
+     * points are not modified.
      */
-    ClipperLib::Path convertToClipper( bool aRequiredOrientation ) const;
+    ClipperLib::IntPairPath clipperPath( bool aRequiredOrientation ) const;
 
     /**
      * Find the segment nearest the given point.
@@ -731,6 +764,8 @@ public:
 
         for( auto& arc : m_arcs )
             arc.Move( aVector );
+
+        invalidateBVH();
     }
 
     /**
@@ -783,6 +818,23 @@ public:
 
 private:
 
+    class SEGMENT_BVH;
+
+    ///> Returns the index of the first segment ending at aP or at most aDist from it, or -1
+    int findEdgeNear( const VECTOR2I& aP, int aDist ) const;
+
+    ///> Returns the segment hierarchy, building it if needed, or null for short chains
+    std::shared_ptr<const SEGMENT_BVH> segmentBVH() const;
+
+    ///> QuerySegments() for the segments from aFirst on, without the std::function overhead
+    template <class VISITOR>
+    void querySegments( const BOX2I& aBox, int aFirst, VISITOR aVisitor ) const;
+
+    void invalidateBVH()
+    {
+        m_bvh.reset();
+    }
+
     constexpr static ssize_t SHAPE_IS_PT = -1;
 
     /// array of vertices
@@ -808,6 +860,9 @@ private:
 
     /// cached bounding box
     BOX2I m_bbox;
+
+    /// lazily built hierarchy of the segment bounding boxes (see QuerySegments())
+    mutable std::shared_ptr<const SEGMENT_BVH> m_bvh;
 };
 
 
@@ -26,6 +26,7 @@
 #ifndef __SHAPE_POLY_SET_H
 #define __SHAPE_POLY_SET_H
 
+#include <atomic>
 #include <cstdio>
 #include <deque>                        // for deque
 #include <iosfwd>                       // for string, stringstream
@@ -43,6 +44,7 @@
 #include <math/vector2d.h>              // for VECTOR2I
 #include <md5_hash.h>
 
+class POLY_SET_INDEX;
 
 /**
  * SHAPE_POLY_SET
@@ -119,6 +121,16 @@ class SHAPE_POLY_SET : public SHAPE
                 return m_vertices.size();
             }
 
+            const TRI& GetTriangleIndices( int index ) const
+            {
+                return m_triangles[ index ];
+            }
+
+            const VECTOR2I& GetVertex( int index ) const
+            {
+                return m_vertices[ index ];
+            }
+
         private:
 
             std::deque<TRI> m_triangles;
@@ -240,7 +252,7 @@ class SHAPE_POLY_SET : public SHAPE
 
             const T& Get()
             {
-                return m_poly->Polygon( m_currentPolygon )[m_currentContour].CPoint(
+                return m_poly->CPolygon( m_currentPolygon )[m_currentContour].CPoint(
                         m_currentVertex );
             }
 
@@ -363,7 +375,8 @@ class SHAPE_POLY_SET : public SHAPE
 
             T Get()
             {
-                return m_poly->Polygon( m_currentPolygon )[m_currentContour].Segment( m_currentSegment );
+                return m_poly->CPolygon( m_currentPolygon )[m_currentContour].CSegment(
+                        m_currentSegment );
             }
 
             T operator*()
@@ -446,9 +459,10 @@ class SHAPE_POLY_SET : public SHAPE
 
         /**
          * Copy constructor SHAPE_POLY_SET
-         * Performs a deep copy of \p aOther into \p this.
+         * Copies \p aOther into \p this.  The copy shares the polygons and the triangulation
+         * of \p aOther until one of the two sets is modified, so it is cheap.
          * @param aOther is the SHAPE_POLY_SET object that will be copied.
-         * @param aDeepCopy if true, make new copies of the triangulated unique_ptr vector
+         * @param aDeepCopy is unused (triangulations are shared, as they are never modified)
          */
         SHAPE_POLY_SET( const SHAPE_POLY_SET& aOther, bool aDeepCopy = false );
 
@@ -587,6 +601,7 @@ class SHAPE_POLY_SET : public SHAPE
         ///> Returns the reference to aIndex-th outline in the set
         SHAPE_LINE_CHAIN& Outline( int aIndex )
         {
+            m_polys.Leak();
             return m_polys[aIndex][0];
         }
 
@@ -609,12 +624,14 @@ class SHAPE_POLY_SET : public SHAPE
         ///> Returns the reference to aHole-th hole in the aIndex-th outline
         SHAPE_LINE_CHAIN& Hole( int aOutline, int aHole )
         {
+            m_polys.Leak();
             return m_polys[aOutline][aHole + 1];
         }
 
         ///> Returns the aIndex-th subpolygon in the set
         POLYGON& Polygon( int aIndex )
         {
+            m_polys.Leak();
             return m_polys[aIndex];
         }
 
@@ -862,6 +879,17 @@ class SHAPE_POLY_SET : public SHAPE
         void BooleanAdd( const SHAPE_POLY_SET& a, const SHAPE_POLY_SET& b,
                          POLYGON_MODE aFastMode );
 
+        /**
+         * Function BooleanAdd
+         * stores the union of all the sets of aSets in itself.  The sets are merged in groups
+         * of neighbouring sets first, and the groups then in pairs, in parallel; this is much
+         * faster than a single union of everything.  The result covers the same area as
+         * the flat union, up to the rounding of intersection points; the vertices may come
+         * in a different order.
+         * For aFastMode meaning, see function booleanOp
+         */
+        void BooleanAdd( const std::vector<SHAPE_POLY_SET>& aSets, POLYGON_MODE aFastMode );
+
         ///> Performs boolean polyset difference between a and b, store the result in it self
         ///> For aFastMode meaning, see function booleanOp
         void BooleanSubtract( const SHAPE_POLY_SET& a, const SHAPE_POLY_SET& b,
@@ -895,14 +923,20 @@ class SHAPE_POLY_SET : public SHAPE
          *                          CHOP_ACUTE_CORNERS to chop angles less than 90°,
          *                          ROUND_ACUTE_CORNERS to round off angles less than 90°,
          *                          ROUND_ALL_CORNERS to round regardless of angles
+         * @param aCompactCorners - true to build the convex corners smaller than one segment of
+         *                          the approximated circle from a single (outer) vertex instead
+         *                          of two.  Use it for intermediate results that are offsetted
+         *                          again, so that each round does not double the vertex count.
          */
         void Inflate( int aAmount, int aCircleSegmentsCount,
-                      CORNER_STRATEGY aCornerStrategy = ROUND_ALL_CORNERS );
+                      CORNER_STRATEGY aCornerStrategy = ROUND_ALL_CORNERS,
+                      bool aCompactCorners = false );
 
         void Deflate( int aAmount, int aCircleSegmentsCount,
-                      CORNER_STRATEGY aCornerStrategy = ROUND_ALL_CORNERS )
+                      CORNER_STRATEGY aCornerStrategy = ROUND_ALL_CORNERS,
+                      bool aCompactCorners = false )
         {
-            Inflate( -aAmount, aCircleSegmentsCount, aCornerStrategy );
+            Inflate( -aAmount, aCircleSegmentsCount, aCornerStrategy, aCompactCorners );
         }
 
         /**
@@ -932,6 +966,11 @@ class SHAPE_POLY_SET : public SHAPE
         ///> For aFastMode meaning, see function booleanOp
         void Simplify( POLYGON_MODE aFastMode );
 
+        ///> Same as Simplify(), but merges the outlines in parallel (see the multi-set
+        ///> BooleanAdd()).  Use it for sets made of many overlapping outlines, such as the
+        ///> shapes of all the items of a layer.
+        void SimplifyParallel( POLYGON_MODE aFastMode );
+
         /**
          * Function NormalizeAreaOutlines
          * Convert a self-intersecting polygon to one (or more) non self-intersecting polygon(s)
@@ -1057,6 +1096,17 @@ class SHAPE_POLY_SET : public SHAPE
         bool Contains( const VECTOR2I& aP, int aSubpolyIndex = -1, int aAccuracy = 0,
                        bool aUseBBoxCaches = false ) const;
 
+        /**
+         * Function GetIndex
+         * returns the containment index of the polygons (see POLY_SET_INDEX), building it on
+         * first use.  The index is kept until the set is modified, and is shared with the
+         * copies of the set.
+         *
+         * The index is not kept when Outline(), Hole() or Polygon() have been called on the
+         * set (see POLYSET_STORAGE), so hold on to the returned index for repeated queries.
+         */
+        std::shared_ptr<const POLY_SET_INDEX> GetIndex() const;
+
         ///> Returns true if the set is empty (no polygons at all)
         bool IsEmpty() const
         {
@@ -1238,6 +1288,13 @@ class SHAPE_POLY_SET : public SHAPE
         void booleanOp( ClipperLib::ClipType aType, const SHAPE_POLY_SET& aShape,
                         const SHAPE_POLY_SET& aOtherShape, POLYGON_MODE aFastMode );
 
+        ///> Stores the union of aSets in itself, using a single Clipper pass
+        void unionOp( const std::vector<const SHAPE_POLY_SET*>& aSets, POLYGON_MODE aFastMode );
+
+        ///> Stores the union of aParts in itself: the engine of the multi-set BooleanAdd()
+        void unionParts( const std::vector<const SHAPE_POLY_SET*>& aParts,
+                         POLYGON_MODE aFastMode );
+
         /**
          * containsSingle function
          * Checks whether the point aP is inside the aSubpolyIndex-th polygon of the polyset. If
@@ -1291,22 +1348,273 @@ class SHAPE_POLY_SET : public SHAPE
 
         typedef std::vector<POLYGON> POLYSET;
 
-        POLYSET m_polys;
+        /**
+         * POLYSET_STORAGE
+         * holds the polygons of the set.  The storage is shared between copies of a set until
+         * one of them is modified (copy-on-write), so copying a set does not copy its vertices.
+         * Every non-const access makes the storage unique to the set first.
+         *
+         * Outline(), Hole() and Polygon() return non-const references, which may be used to
+         * modify the set at any later time; once one of them has been called, the storage is
+         * no longer shared and copies of the set are deep copies, until the set is cleared or
+         * assigned to.
+         *
+         * Note that a const reference into a shared storage keeps seeing the old polygons if
+         * the set it was taken from is modified afterwards.
+         */
+        class POLYSET_STORAGE
+        {
+        public:
+            POLYSET_STORAGE() :
+                    m_data( new SHARED_POLYSET() ),
+                    m_leaked( false )
+            {}
+
+            POLYSET_STORAGE( const POLYSET_STORAGE& aOther ) :
+                    m_data( aOther.share() ),
+                    m_leaked( false ),
+                    m_index( aOther.CachedIndex() )
+            {}
+
+            ~POLYSET_STORAGE()
+            {
+                release();
+            }
+
+            POLYSET_STORAGE& operator=( const POLYSET_STORAGE& aOther )
+            {
+                if( this != &aOther )
+                {
+                    SHARED_POLYSET* data = aOther.share();
+
+                    release();
+                    m_data = data;
+                    m_leaked = false;
+                    std::atomic_store( &m_index, aOther.CachedIndex() );
+                }
+
+                return *this;
+            }
+
+            ///> Returns true if another set uses the same storage
+            bool IsShared() const { return !isUnique(); }
+
+            ///> Makes the storage unique, and keeps it unique (see above)
+            void Leak()
+            {
+                detach();
+                m_leaked = true;
+            }
+
+            ///> Returns the index of the polygons built by CacheIndex(), if still valid
+            std::shared_ptr<const POLY_SET_INDEX> CachedIndex() const
+            {
+                return m_leaked ? nullptr : std::atomic_load( &m_index );
+            }
+
+            /**
+             * Keeps aIndex, the index of the current polygons, until they are modified.  Nothing
+             * is kept once the polygons have been leaked.
+             * @return the index kept by another thread in the meantime if any, else aIndex.
+             */
+            std::shared_ptr<const POLY_SET_INDEX> CacheIndex(
+                    std::shared_ptr<const POLY_SET_INDEX> aIndex ) const
+            {
+                std::shared_ptr<const POLY_SET_INDEX> expected;
+
+                if( m_leaked )
+                    return aIndex;
+
+                if( !std::atomic_compare_exchange_strong( &m_index, &expected, aIndex ) )
+                    return expected;
+
+                return aIndex;
+            }
+
+            size_t size() const { return m_data->m_polys.size(); }
+            bool empty() const { return m_data->m_polys.empty(); }
+
+            const POLYGON& operator[]( size_t aIndex ) const { return m_data->m_polys[aIndex]; }
+            const POLYGON& back() const { return m_data->m_polys.back(); }
+            POLYSET::const_iterator begin() const { return m_data->m_polys.cbegin(); }
+            POLYSET::const_iterator end() const { return m_data->m_polys.cend(); }
+
+            POLYGON& operator[]( size_t aIndex )
+            {
+                detach();
+                return m_data->m_polys[aIndex];
+            }
+
+            POLYGON& back()
+            {
+                detach();
+                return m_data->m_polys.back();
+            }
+
+            POLYSET::iterator begin()
+            {
+                detach();
+                return m_data->m_polys.begin();
+            }
+
+            POLYSET::iterator end()
+            {
+                detach();
+                return m_data->m_polys.end();
+            }
+
+            void push_back( const POLYGON& aPolygon )
+            {
+                detach();
+                m_data->m_polys.push_back( aPolygon );
+            }
+
+            void push_back( POLYGON&& aPolygon )
+            {
+                detach();
+                m_data->m_polys.push_back( std::move( aPolygon ) );
+            }
+
+            POLYSET::iterator erase( POLYSET::iterator aPos )
+            {
+                detach();
+                return m_data->m_polys.erase( aPos );
+            }
+
+            template <class InputIt>
+            void insert( POLYSET::iterator aPos, InputIt aFirst, InputIt aLast )
+            {
+                detach();
+                m_data->m_polys.insert( aPos, aFirst, aLast );
+            }
+
+            void clear()
+            {
+                if( !isUnique() )
+                {
+                    release();
+                    m_data = new SHARED_POLYSET();
+                }
+                else
+                {
+                    m_data->m_polys.clear();
+                }
+
+                m_leaked = false;
+                std::atomic_store( &m_index, std::shared_ptr<const POLY_SET_INDEX>() );
+            }
+
+        private:
+            /**
+             * The polygons, and the number of storages using them.  The storages count their
+             * owners themselves rather than through a shared_ptr, whose use_count() is a relaxed
+             * load: a storage which finds itself the only owner must also see all the reads of
+             * the owners which have released the polygons in the meantime, possibly on other
+             * threads, before it modifies them in place.
+             */
+            struct SHARED_POLYSET
+            {
+                SHARED_POLYSET() :
+                        m_owners( 1 )
+                {}
+
+                SHARED_POLYSET( const POLYSET& aPolys ) :
+                        m_polys( aPolys ),
+                        m_owners( 1 )
+                {}
+
+                POLYSET          m_polys;
+                std::atomic<int> m_owners;
+            };
+
+            ///> Returns the storage to be used by a copy of this one, with its new owner counted
+            SHARED_POLYSET* share() const
+            {
+                if( m_leaked )
+                    return new SHARED_POLYSET( m_data->m_polys );
+
+                m_data->m_owners.fetch_add( 1, std::memory_order_relaxed );
+                return m_data;
+            }
+
+            ///> Stops using the storage; the releasing decrement pairs with isUnique()
+            void release()
+            {
+                if( m_data->m_owners.fetch_sub( 1, std::memory_order_acq_rel ) == 1 )
+                    delete m_data;
+            }
+
+            ///> Returns true if no other set uses the storage, which may then be modified in place
+            bool isUnique() const
+            {
+                return m_data->m_owners.load( std::memory_order_acquire ) == 1;
+            }
+
+            ///> Called before any non-const access
+            void detach()
+            {
+                if( !isUnique() )
+                {
+                    SHARED_POLYSET* copy = new SHARED_POLYSET( m_data->m_polys );
+
+                    release();
+                    m_data = copy;
+                }
+
+                if( m_index )
+                    std::atomic_store( &m_index, std::shared_ptr<const POLY_SET_INDEX>() );
+            }
+
+            SHARED_POLYSET* m_data;
+            bool            m_leaked;
+
+            ///> Index of the polygons, shared with the copies of the storage
+            mutable std::shared_ptr<const POLY_SET_INDEX> m_index;
+        };
+
+        POLYSET_STORAGE m_polys;
 
     public:
 
         SHAPE_POLY_SET& operator=( const SHAPE_POLY_SET& );
 
+        ///> Returns true if the polygons are shared with a copy of the set (copy-on-write)
+        bool IsStorageShared() const { return m_polys.IsShared(); }
+
         void CacheTriangulation();
         bool IsTriangulationUpToDate() const;
 
+        /**
+         * Function SetTriangulation
+         * installs a triangulation built earlier (for instance, read from a file) instead of
+         * computing one with CacheTriangulation().
+         * @param aTriangulation is the triangulated polygons.
+         * @param aChecksum is the GetHash().Format() string of the polygons aTriangulation was
+         *                  built from.
+         * @return true if the triangulation was accepted, false if it does not match the
+         *         current polygons (the set is then left unchanged).
+         */
+        bool SetTriangulation( std::vector<std::unique_ptr<TRIANGULATED_POLYGON>>&& aTriangulation,
+                               const std::string& aChecksum );
+
+        /**
+         * Function ShareTriangulation
+         * takes the triangulation of another set, for instance a copy triangulated by another
+         * thread.
+         * @param aOther is the set to take the triangulation from.
+         * @return true if the triangulation was taken, false if aOther is not triangulated or
+         *         has other polygons (the set is then left unchanged).
+         */
+        bool ShareTriangulation( const SHAPE_POLY_SET& aOther );
+
         MD5_HASH GetHash() const;
 
     private:
 
         MD5_HASH checksum() const;
 
-        std::vector<std::unique_ptr<TRIANGULATED_POLYGON>> m_triangulatedPolys;
+        ///> Triangulations are never modified once built, so copies of the set share them
+        std::vector<std::shared_ptr<TRIANGULATED_POLYGON>> m_triangulatedPolys;
         bool m_triangulationValid = false;
         MD5_HASH m_hash;
 
@@ -0,0 +1,164 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file simd_kernels.h
+ * @brief vectorized edge filters for the point-in-polygon and point-to-outline tests.
+ *
+ * The kernels only reject edges, SIMD_EDGE_BLOCK of them at a time: the exact (scalar) test
+ * is still run on the few edges which pass the filter, so the results are identical to the
+ * plain loops whichever instruction set is used.
+ */
+
+#ifndef SIMD_KERNELS_H
+#define SIMD_KERNELS_H
+
+#include <stdint.h>          // for uint32_t
+
+enum class SIMD_LEVEL
+{
+    SCALAR,
+    SSE2,
+    AVX2
+};
+
+///> Number of edges handled by one call of the kernels below
+const int SIMD_EDGE_BLOCK = 8;
+
+/**
+ * Function GetSimdLevel
+ * @return the instruction set used by the kernels (by default, the best one supported by
+ *         the CPU).
+ */
+SIMD_LEVEL GetSimdLevel();
+
+/**
+ * Function SetSimdLevel
+ * selects the instruction set used by the kernels, for tests and benchmarks.  Not thread
+ * safe: do not call it while any geometry is being processed.
+ * @return the level actually selected, which is never better than the CPU supports.
+ */
+SIMD_LEVEL SetSimdLevel( SIMD_LEVEL aLevel );
+
+/**
+ * Function StraddlingEdges
+ * tests the edges between SIMD_EDGE_BLOCK + 1 consecutive points against a horizontal line.
+ * @param aXY points to the points, as interleaved x, y ints.
+ * @param aY is the ordinate of the line.
+ * @return a mask whose bit i is set when ( y[i] > aY ) != ( y[i+1] > aY ).
+ */
+uint32_t StraddlingEdges( const int* aXY, int aY );
+
+/**
+ * Function EdgesTouchingBox
+ * tests the edges between SIMD_EDGE_BLOCK + 1 consecutive points against a box.
+ * @param aXY points to the points, as interleaved x, y ints.
+ * @return a mask whose bit i is set when the bounding box of the edge from point i to point
+ *         i+1 intersects the box (boundaries included).
+ */
+uint32_t EdgesTouchingBox( const int* aXY, int aMinX, int aMinY, int aMaxX, int aMaxY );
+
+
+/**
+ * Function RayCrossingParity
+ * runs the crossing test of a ray cast from a point on each edge of a closed contour
+ * straddling the ray's line, and returns the parity of the number of crossings.
+ * @param aPoints are the contour vertices (POINT must be a pair of ints x, y).
+ * @param aY is the ordinate of the horizontal ray.
+ * @param aCrosses is called as aCrosses( p1, p2 ) for each edge with ( p1.y > aY ) !=
+ *                 ( p2.y > aY ), and returns true if the ray crosses it.
+ * @return true for an odd number of crossings.
+ */
+template <class POINT, class CROSSES>
+bool RayCrossingParity( const POINT* aPoints, int aCount, int aY, CROSSES aCrosses )
+{
+    static_assert( sizeof( POINT ) == 2 * sizeof( int ), "POINT must be a pair of ints" );
+
+    const int* xy = reinterpret_cast<const int*>( aPoints );
+    bool       odd = false;
+    int        i = 0;
+
+    for( ; i + SIMD_EDGE_BLOCK < aCount; i += SIMD_EDGE_BLOCK )
+    {
+        uint32_t mask = StraddlingEdges( xy + 2 * i, aY );
+
+        for( int k = i; mask; k++, mask >>= 1 )
+        {
+            if( ( mask & 1 ) && aCrosses( aPoints[k], aPoints[k + 1] ) )
+                odd = !odd;
+        }
+    }
+
+    for( ; i < aCount; i++ )
+    {
+        const POINT& p1 = aPoints[i];
+        const POINT& p2 = aPoints[i + 1 == aCount ? 0 : i + 1];
+
+        if( ( ( p1.y > aY ) != ( p2.y > aY ) ) && aCrosses( p1, p2 ) )
+            odd = !odd;
+    }
+
+    return odd;
+}
+
+
+/**
+ * Function FirstEdgeInBox
+ * finds the first edge of a line chain passing a test, testing only the edges whose bounding
+ * box intersects a given box.
+ * @param aPoints are the chain vertices (POINT must be a pair of ints x, y).
+ * @param aClosed adds the edge from the last to the first vertex.
+ * @param aTest is called as aTest( a, b ) for the candidate edges, in order.
+ * @return the index of the first edge for which aTest returned true, or -1.
+ */
+template <class POINT, class TEST>
+int FirstEdgeInBox( const POINT* aPoints, int aCount, bool aClosed, int aMinX, int aMinY,
+                    int aMaxX, int aMaxY, TEST aTest )
+{
+    static_assert( sizeof( POINT ) == 2 * sizeof( int ), "POINT must be a pair of ints" );
+
+    const int* xy = reinterpret_cast<const int*>( aPoints );
+    int        edgeCount = aClosed ? aCount : aCount - 1;
+    int        i = 0;
+
+    for( ; i + SIMD_EDGE_BLOCK < aCount; i += SIMD_EDGE_BLOCK )
+    {
+        uint32_t mask = EdgesTouchingBox( xy + 2 * i, aMinX, aMinY, aMaxX, aMaxY );
+
+        for( int k = i; mask; k++, mask >>= 1 )
+        {
+            if( ( mask & 1 ) && aTest( aPoints[k], aPoints[k + 1] ) )
+                return k;
+        }
+    }
+
+    for( ; i < edgeCount; i++ )
+    {
+        if( aTest( aPoints[i], aPoints[i + 1 == aCount ? 0 : i + 1] ) )
+            return i;
+    }
+
+    return -1;
+}
+
+#endif    // SIMD_KERNELS_H
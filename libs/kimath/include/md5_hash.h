@@ -30,8 +30,8 @@ public:
     bool operator==( const MD5_HASH& aOther ) const;
     bool operator!=( const MD5_HASH& aOther ) const;
 
-    /** @return Build a hexadecimal string from the 16 bytes of MD5_HASH
-     *  Mainly for debug purposes.
+    /** @return Build a hexadecimal string (32 characters, no separator) from the 16 bytes
+     *  of MD5_HASH.
      */
     std::string Format();
 
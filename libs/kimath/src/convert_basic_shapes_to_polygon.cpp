@@ -27,9 +27,12 @@
 
 #include <algorithm>                    // for max, min
 #include <math.h>                       // for atan2
+#include <memory>
 #include <type_traits>                  // for swap
+#include <vector>
 
 #include <convert_basic_shapes_to_polygon.h>
+#include <geometry/approximation_cache.h>
 #include <geometry/geometry_utils.h>
 #include <geometry/shape_line_chain.h>  // for SHAPE_LINE_CHAIN
 #include <geometry/shape_poly_set.h>    // for SHAPE_POLY_SET, SHAPE_POLY_SE...
@@ -38,26 +41,47 @@
 #include <trigo.h>
 
 
+/**
+ * The corners of the polygonal approximation of a circle centered on 0,0.  They only depend
+ * on the radius and the error, so they are cached, and just moved to the circle center.
+ */
+static std::shared_ptr<const std::vector<wxPoint>> circleCorners( int aRadius, int aError )
+{
+    static APPROXIMATION_CACHE<2, std::shared_ptr<const std::vector<wxPoint>>> s_cache( 256 );
+
+    return s_cache.Get( { aRadius, aError },
+            [&]()
+            {
+                auto    corners = std::make_shared<std::vector<wxPoint>>();
+                wxPoint corner_position;
+                int     numSegs = std::max( GetArcToSegmentCount( aRadius, aError, 360.0 ), 6 );
+                int     delta = 3600 / numSegs;   // rotate angle in 0.1 degree
+                double  correction = GetCircletoPolyCorrectionFactor( numSegs );
+                int     radius = aRadius * correction;    // make segments outside the circles
+                double  halfstep = delta/2.0;    // the starting value for rot angles
+
+                corners->reserve( numSegs );
+
+                for( int ii = 0; ii < numSegs; ii++ )
+                {
+                    corner_position.x   = radius;
+                    corner_position.y   = 0;
+                    double angle = (ii * delta) + halfstep;
+                    RotatePoint( &corner_position, angle );
+                    corners->push_back( corner_position );
+                }
+
+                return corners;
+            } );
+}
+
+
 void TransformCircleToPolygon( SHAPE_LINE_CHAIN& aBuffer,
                                wxPoint aCenter, int aRadius,
                                int aError )
 {
-    wxPoint corner_position;
-    int     numSegs = std::max( GetArcToSegmentCount( aRadius, aError, 360.0 ), 6 );
-    int     delta = 3600 / numSegs;   // rotate angle in 0.1 degree
-    double  correction = GetCircletoPolyCorrectionFactor( numSegs );
-    int     radius = aRadius * correction;    // make segments outside the circles
-    double  halfstep = delta/2.0;    // the starting value for rot angles
-
-    for( int ii = 0; ii < numSegs; ii++ )
-    {
-        corner_position.x   = radius;
-        corner_position.y   = 0;
-        double angle = (ii * delta) + halfstep;
-        RotatePoint( &corner_position, angle );
-        corner_position += aCenter;
-        aBuffer.Append( corner_position.x, corner_position.y );
-    }
+    for( const wxPoint& corner : *circleCorners( aRadius, aError ) )
+        aBuffer.Append( corner.x + aCenter.x, corner.y + aCenter.y );
 
     aBuffer.SetClosed( true );
 }
@@ -66,29 +90,17 @@ void TransformCircleToPolygon( SHAPE_LINE_CHAIN& aBuffer,
 void TransformCircleToPolygon( SHAPE_POLY_SET& aCornerBuffer, wxPoint aCenter, int aRadius,
                                int aError )
 {
-    wxPoint corner_position;
-    int     numSegs = std::max( GetArcToSegmentCount( aRadius, aError, 360.0 ), 6 );
-    int     delta = 3600 / numSegs;   // rotate angle in 0.1 degree
-    double  correction = GetCircletoPolyCorrectionFactor( numSegs );
-    int     radius = aRadius * correction;    // make segments outside the circles
-    double  halfstep = delta/2.0;    // the starting value for rot angles
-
     aCornerBuffer.NewOutline();
 
-    for( int ii = 0; ii < numSegs; ii++ )
-    {
-        corner_position.x   = radius;
-        corner_position.y   = 0;
-        double angle = (ii * delta) + halfstep;
-        RotatePoint( &corner_position, angle );
-        corner_position += aCenter;
-        aCornerBuffer.Append( corner_position.x, corner_position.y );
-    }
+    for( const wxPoint& corner : *circleCorners( aRadius, aError ) )
+        aCornerBuffer.Append( corner.x + aCenter.x, corner.y + aCenter.y );
 }
 
 
-void TransformOvalToPolygon( SHAPE_POLY_SET& aCornerBuffer, wxPoint aStart, wxPoint aEnd,
-                             int aWidth, int aError )
+/**
+ * The oval from 0,0 to aEnd (with aEnd.x >= 0), see TransformOvalToPolygon() below
+ */
+static SHAPE_POLY_SET buildOval( wxPoint aEnd, int aWidth, int aError )
 {
     // To build the polygonal shape outside the actual shape, we use a bigger
     // radius to build rounded ends.
@@ -108,25 +120,14 @@ void TransformOvalToPolygon( SHAPE_POLY_SET& aCornerBuffer, wxPoint aStart, wxPo
 
     radius = radius * correction;    // make segments outside the circles
 
-    // end point is the coordinate relative to aStart
-    wxPoint endp    = aEnd - aStart;
-    wxPoint startp  = aStart;
     wxPoint corner;
     SHAPE_POLY_SET polyshape;
 
     polyshape.NewOutline();
 
-    // normalize the position in order to have endp.x >= 0
-    // it makes calculations more easy to understand
-    if( endp.x < 0 )
-    {
-        endp    = aStart - aEnd;
-        startp  = aEnd;
-    }
-
     // delta_angle is in radian
-    double delta_angle = atan2( (double)endp.y, (double)endp.x );
-    int seg_len        = KiROUND( EuclideanNorm( endp ) );
+    double delta_angle = atan2( (double)aEnd.y, (double)aEnd.x );
+    int seg_len        = KiROUND( EuclideanNorm( aEnd ) );
 
 
     // Compute the outlines of the segment, and creates a polygon
@@ -184,8 +185,37 @@ void TransformOvalToPolygon( SHAPE_POLY_SET& aCornerBuffer, wxPoint aStart, wxPo
         // due to the shape of initial polygons
     }
 
-    // Rotate and move the polygon to its right location
+    // Rotate the polygon to its right orientation
     polyshape.Rotate( delta_angle, VECTOR2I( 0, 0 ) );
+
+    return polyshape;
+}
+
+
+void TransformOvalToPolygon( SHAPE_POLY_SET& aCornerBuffer, wxPoint aStart, wxPoint aEnd,
+                             int aWidth, int aError )
+{
+    // end point is the coordinate relative to aStart
+    wxPoint endp    = aEnd - aStart;
+    wxPoint startp  = aStart;
+
+    // normalize the position in order to have endp.x >= 0
+    // it makes calculations more easy to understand
+    if( endp.x < 0 )
+    {
+        endp    = aStart - aEnd;
+        startp  = aEnd;
+    }
+
+    // The oval is built at 0,0 and moved to its position, so it is cached by its size
+    static APPROXIMATION_CACHE<4, std::shared_ptr<const SHAPE_POLY_SET>> s_cache( 1024 );
+
+    SHAPE_POLY_SET polyshape = *s_cache.Get( { endp.x, endp.y, aWidth, aError },
+            [&]()
+            {
+                return std::make_shared<SHAPE_POLY_SET>( buildOval( endp, aWidth, aError ) );
+            } );
+
     polyshape.Move( startp );
 
     aCornerBuffer.Append( polyshape);
@@ -232,17 +262,18 @@ void GetRoundRectCornerCenters( wxPoint aCenters[4], int aRadius,
 }
 
 
-void TransformRoundChamferedRectToPolygon( SHAPE_POLY_SET& aCornerBuffer,
-                                  const wxPoint& aPosition, const wxSize& aSize,
-                                  double aRotation, int aCornerRadius,
-                                  double aChamferRatio, int aChamferCorners,
-                                  int aApproxErrorMax, int aMinSegPerCircleCount )
+/**
+ * The round or chamfered rect of TransformRoundChamferedRectToPolygon() centered on 0,0
+ */
+static SHAPE_POLY_SET buildRoundChamferedRect( const wxSize& aSize, double aRotation,
+                                               int aCornerRadius, double aChamferRatio,
+                                               int aChamferCorners, int aApproxErrorMax,
+                                               int aMinSegPerCircleCount )
 {
-    // Build the basic shape in orientation 0.0, position 0,0 for chamfered corners
-    // or in actual position/orientation for round rect only
+    // Build the basic shape in orientation 0.0 for chamfered corners
+    // or in actual orientation for round rect only
     wxPoint corners[4];
-    GetRoundRectCornerCenters( corners, aCornerRadius,
-                               aChamferCorners ? wxPoint( 0, 0 ) : aPosition,
+    GetRoundRectCornerCenters( corners, aCornerRadius, wxPoint( 0, 0 ),
                                aSize, aChamferCorners ? 0.0 : aRotation );
 
     SHAPE_POLY_SET outline;
@@ -256,11 +287,7 @@ void TransformRoundChamferedRectToPolygon( SHAPE_POLY_SET& aCornerBuffer,
     outline.Inflate( aCornerRadius, numSegs );
 
     if( aChamferCorners == RECT_NO_CHAMFER )      // no chamfer
-    {
-        // Add the outline:
-        aCornerBuffer.Append( outline );
-        return;
-    }
+        return outline;
 
     // Now we have the round rect outline, in position 0,0 orientation 0.0.
     // Chamfer the corner(s).
@@ -311,10 +338,38 @@ void TransformRoundChamferedRectToPolygon( SHAPE_POLY_SET& aCornerBuffer,
         outline.BooleanSubtract( chamfered_corner, SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
     }
 
-    // Rotate and move the outline:
+    // Rotate the outline:
     if( aRotation != 0.0 )
         outline.Rotate( DECIDEG2RAD( -aRotation ), VECTOR2I( 0, 0 ) );
 
+    return outline;
+}
+
+
+void TransformRoundChamferedRectToPolygon( SHAPE_POLY_SET& aCornerBuffer,
+                                  const wxPoint& aPosition, const wxSize& aSize,
+                                  double aRotation, int aCornerRadius,
+                                  double aChamferRatio, int aChamferCorners,
+                                  int aApproxErrorMax, int aMinSegPerCircleCount )
+{
+    typedef APPROXIMATION_CACHE<8, std::shared_ptr<const SHAPE_POLY_SET>> RECT_CACHE;
+
+    // The shape is built at 0,0 and moved to its position, so pads of the same size and
+    // orientation share the (costly) polygon operations.
+    static RECT_CACHE s_cache( 1024 );
+
+    RECT_CACHE::KEY key = { aSize.x, aSize.y, RECT_CACHE::Bits( aRotation ), aCornerRadius,
+                            RECT_CACHE::Bits( aChamferRatio ), aChamferCorners, aApproxErrorMax,
+                            aMinSegPerCircleCount };
+
+    SHAPE_POLY_SET outline = *s_cache.Get( key,
+            [&]()
+            {
+                return std::make_shared<SHAPE_POLY_SET>( buildRoundChamferedRect( aSize,
+                        aRotation, aCornerRadius, aChamferRatio, aChamferCorners,
+                        aApproxErrorMax, aMinSegPerCircleCount ) );
+            } );
+
     outline.Move( VECTOR2I( aPosition ) );
 
     // Add the outline:
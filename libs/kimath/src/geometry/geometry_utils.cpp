@@ -69,7 +69,8 @@ int GetArcToSegmentCount( int aRadius, int aErrorMax, double aArcAngleDegree )
 // so one can disable the shape expansion by calling KeepPolyInsideShape( true )
 // Important: calling KeepPolyInsideShape( false ) after calculations is
 // mandatory to break oher calculations
-static bool s_disable_arc_correction = false;
+// The option is per thread, as the layers of a board can be plotted by several threads.
+static thread_local bool s_disable_arc_correction = false;
 
 // Enable (aInside = false) or disable (aInside = true) polygonal shape expansion
 // when converting pads shapes and other items shapes to polygons:
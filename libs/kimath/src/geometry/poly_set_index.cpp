@@ -0,0 +1,397 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <algorithm>
+#include <climits>
+
+#include <geometry/poly_set_index.h>
+#include <math/util.h>                  // for rescale
+
+
+///> Number of edges per row, on average
+static const int EDGES_PER_ROW = 4;
+
+///> Upper limit of the number of rows of a contour
+static const int MAX_ROWS = 4096;
+
+
+static int clampToInt( int64_t aValue )
+{
+    return (int) std::max<int64_t>( INT_MIN, std::min<int64_t>( INT_MAX, aValue ) );
+}
+
+
+// True if the bounding box of the segment aA, aB misses the box aP +/- aMargin
+static bool outsideBox( const VECTOR2I& aA, const VECTOR2I& aB, const VECTOR2I& aP,
+                        int64_t aMargin )
+{
+    return std::max( aA.x, aB.x ) < aP.x - aMargin || std::min( aA.x, aB.x ) > aP.x + aMargin
+           || std::max( aA.y, aB.y ) < aP.y - aMargin || std::min( aA.y, aB.y ) > aP.y + aMargin;
+}
+
+
+void POLY_SET_INDEX::ROWS::Build( const std::vector<std::pair<int, int>>& aRanges, int aMinY,
+                                  int aMaxY, int aRowCount )
+{
+    int64_t height = (int64_t) aMaxY - aMinY + 1;
+
+    aRowCount = std::max( aRowCount, 1 );
+
+    m_minY = aMinY;
+    m_rowHeight = std::max<int64_t>( 1, ( height + aRowCount - 1 ) / aRowCount );
+
+    int rowCount = (int) ( ( height + m_rowHeight - 1 ) / m_rowHeight );
+
+    m_rowStart.assign( rowCount + 1, 0 );
+    m_firstRow.resize( aRanges.size() );
+
+    for( size_t i = 0; i < aRanges.size(); i++ )
+    {
+        m_firstRow[i] = row( aRanges[i].first );
+
+        for( int r = m_firstRow[i]; r <= row( aRanges[i].second ); r++ )
+            m_rowStart[r + 1]++;
+    }
+
+    for( int r = 0; r < rowCount; r++ )
+        m_rowStart[r + 1] += m_rowStart[r];
+
+    std::vector<int> fill( m_rowStart.begin(), m_rowStart.end() - 1 );
+
+    m_items.resize( m_rowStart.back() );
+
+    for( size_t i = 0; i < aRanges.size(); i++ )
+    {
+        for( int r = m_firstRow[i]; r <= row( aRanges[i].second ); r++ )
+            m_items[fill[r]++] = (int) i;
+    }
+}
+
+
+int POLY_SET_INDEX::ROWS::row( int64_t aY ) const
+{
+    int64_t r = ( aY - m_minY ) / m_rowHeight;
+
+    return (int) std::max<int64_t>( 0, std::min<int64_t>( r, (int) m_rowStart.size() - 2 ) );
+}
+
+
+template <class VISITOR>
+bool POLY_SET_INDEX::ROWS::Query( int aMinY, int aMaxY, VISITOR aVisitor ) const
+{
+    int rowCount = (int) m_rowStart.size() - 1;
+
+    if( rowCount <= 0 || aMaxY < m_minY || aMinY >= m_minY + rowCount * m_rowHeight )
+        return false;
+
+    int r0 = row( aMinY );
+    int r1 = row( aMaxY );
+
+    for( int r = r0; r <= r1; r++ )
+    {
+        for( int k = m_rowStart[r]; k < m_rowStart[r + 1]; k++ )
+        {
+            int item = m_items[k];
+
+            // An item spanning several rows is only visited in the first of them
+            if( std::max( r0, m_firstRow[item] ) == r && aVisitor( item ) )
+                return true;
+        }
+    }
+
+    return false;
+}
+
+
+POLY_SET_INDEX::POLY_SET_INDEX( const SHAPE_POLY_SET& aSet )
+{
+    std::vector<std::pair<int, int>> ranges;
+
+    m_polygons.resize( aSet.OutlineCount() );
+
+    for( int ii = 0; ii < aSet.OutlineCount(); ii++ )
+    {
+        const SHAPE_POLY_SET::POLYGON& src = aSet.CPolygon( ii );
+        POLYGON&                       poly = m_polygons[ii];
+
+        poly.m_contours.resize( src.size() );
+
+        for( size_t jj = 0; jj < src.size(); jj++ )
+        {
+            CONTOUR& contour = poly.m_contours[jj];
+
+            contour.m_points = src[jj].CPoints();
+            contour.m_closed = src[jj].IsClosed();
+
+            if( contour.m_points.empty() )
+                continue;
+
+            contour.m_bbox.Compute( contour.m_points );
+
+            ranges.clear();
+
+            for( int e = 0; e < contour.EdgeCount(); e++ )
+            {
+                const SEG edge = contour.Edge( e );
+                ranges.emplace_back( std::min( edge.A.y, edge.B.y ),
+                                     std::max( edge.A.y, edge.B.y ) );
+            }
+
+            contour.m_rows.Build( ranges, contour.m_bbox.GetY(), contour.m_bbox.GetBottom(),
+                                  std::min( (int) ranges.size() / EDGES_PER_ROW, MAX_ROWS ) );
+        }
+
+        if( !poly.m_contours.empty() )
+            poly.m_bbox = poly.m_contours[0].m_bbox;
+
+        if( ii == 0 )
+            m_bbox = poly.m_bbox;
+        else
+            m_bbox.Merge( poly.m_bbox );
+    }
+
+    ranges.clear();
+
+    for( const POLYGON& poly : m_polygons )
+        ranges.emplace_back( poly.m_bbox.GetY(), poly.m_bbox.GetBottom() );
+
+    m_polygonRows.Build( ranges, m_bbox.GetY(), m_bbox.GetBottom(),
+                         std::min( (int) ranges.size() / EDGES_PER_ROW, MAX_ROWS ) );
+}
+
+
+bool POLY_SET_INDEX::Matches( const SHAPE_POLY_SET& aSet ) const
+{
+    if( aSet.OutlineCount() != OutlineCount() )
+        return false;
+
+    for( int ii = 0; ii < aSet.OutlineCount(); ii++ )
+    {
+        const SHAPE_POLY_SET::POLYGON& src = aSet.CPolygon( ii );
+        const POLYGON&                 poly = m_polygons[ii];
+
+        if( src.size() != poly.m_contours.size() )
+            return false;
+
+        for( size_t jj = 0; jj < src.size(); jj++ )
+        {
+            if( src[jj].IsClosed() != poly.m_contours[jj].m_closed
+                    || src[jj].CPoints() != poly.m_contours[jj].m_points )
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+
+bool POLY_SET_INDEX::CONTOUR::PointInside( const VECTOR2I& aP, int aAccuracy ) const
+{
+    if( !m_closed || m_points.size() < 3 )
+        return false;
+
+    // Same ray test as SHAPE_LINE_CHAIN::PointInside(), on the edges straddling the ray only
+    bool inside = false;
+
+    m_rows.Query( aP.y, aP.y,
+            [&]( int aEdge ) -> bool
+            {
+                const VECTOR2I& p1 = m_points[aEdge];
+                const VECTOR2I& p2 = m_points[( aEdge + 1 ) % m_points.size()];
+
+                if( ( p1.y > aP.y ) != ( p2.y > aP.y ) )
+                {
+                    const auto diff = p2 - p1;
+                    const int  d = rescale( diff.x, ( aP.y - p1.y ), diff.y );
+
+                    if( aP.x - p1.x < d )
+                        inside = !inside;
+                }
+
+                return false;
+            } );
+
+    if( aAccuracy == 0 )
+        return inside && !EdgeNear( aP, 1 );
+    else if( aAccuracy == 1 )
+        return inside;
+    else
+        return inside || EdgeNear( aP, aAccuracy );
+}
+
+
+bool POLY_SET_INDEX::CONTOUR::EdgeNear( const VECTOR2I& aP, int aDist ) const
+{
+    // See SHAPE_LINE_CHAIN::findEdgeNear()
+    int64_t margin = std::max( aDist, -1 ) + 2;
+
+    return m_rows.Query( clampToInt( aP.y - margin ), clampToInt( aP.y + margin ),
+            [&]( int aEdge ) -> bool
+            {
+                const SEG edge = Edge( aEdge );
+
+                if( outsideBox( edge.A, edge.B, aP, margin ) )
+                    return false;
+
+                return edge.A == aP || edge.B == aP || edge.Distance( aP ) <= aDist;
+            } );
+}
+
+
+bool POLY_SET_INDEX::CONTOUR::EdgeWithin( const VECTOR2I& aP, int aDist ) const
+{
+    int64_t                 margin = (int64_t) aDist + 1;
+    VECTOR2I::extended_type dist2 = (VECTOR2I::extended_type) aDist * aDist;
+
+    return m_rows.Query( clampToInt( aP.y - margin ), clampToInt( aP.y + margin ),
+            [&]( int aEdge ) -> bool
+            {
+                const SEG edge = Edge( aEdge );
+
+                if( outsideBox( edge.A, edge.B, aP, margin ) )
+                    return false;
+
+                return edge.SquaredDistance( aP ) <= dist2;
+            } );
+}
+
+
+bool POLY_SET_INDEX::CONTOUR::Intersects( const SEG& aSeg ) const
+{
+    BOX2I segBox( aSeg.A, aSeg.B - aSeg.A );
+
+    segBox.Normalize();
+
+    if( !m_bbox.Intersects( segBox ) )
+        return false;
+
+    return m_rows.Query( segBox.GetY(), segBox.GetBottom(),
+            [&]( int aEdge ) -> bool
+            {
+                const SEG edge = Edge( aEdge );
+
+                if( std::max( edge.A.x, edge.B.x ) < segBox.GetX()
+                        || std::min( edge.A.x, edge.B.x ) > segBox.GetRight() )
+                    return false;
+
+                return (bool) edge.Intersect( aSeg );
+            } );
+}
+
+
+template <class VISITOR>
+bool POLY_SET_INDEX::queryPolygons( int aSubpolyIndex, int aMinY, int aMaxY,
+                                    VISITOR aVisitor ) const
+{
+    if( aSubpolyIndex >= 0 )
+        return aVisitor( m_polygons[aSubpolyIndex] );
+
+    return m_polygonRows.Query( aMinY, aMaxY,
+            [&]( int aPolygon ) -> bool
+            {
+                return aVisitor( m_polygons[aPolygon] );
+            } );
+}
+
+
+bool POLY_SET_INDEX::containsSingle( const VECTOR2I& aP, const POLYGON& aPolygon,
+                                     int aAccuracy ) const
+{
+    if( aPolygon.m_contours.empty() || !aPolygon.m_contours[0].PointInside( aP, aAccuracy ) )
+        return false;
+
+    // As in SHAPE_POLY_SET::containsSingle(), the accuracy does not apply to the holes
+    for( size_t ii = 1; ii < aPolygon.m_contours.size(); ii++ )
+    {
+        if( aPolygon.m_contours[ii].PointInside( aP, 1 ) )
+            return false;
+    }
+
+    return true;
+}
+
+
+bool POLY_SET_INDEX::Contains( const VECTOR2I& aP, int aSubpolyIndex, int aAccuracy ) const
+{
+    // With aAccuracy > 1, a point out of the bounding box of a polygon may still be within
+    // aAccuracy of its outline
+    int64_t margin = std::max( aAccuracy, 0 ) + 2;
+
+    return queryPolygons( aSubpolyIndex, clampToInt( aP.y - margin ), clampToInt( aP.y + margin ),
+            [&]( const POLYGON& aPolygon ) -> bool
+            {
+                return containsSingle( aP, aPolygon, aAccuracy );
+            } );
+}
+
+
+std::vector<bool> POLY_SET_INDEX::ContainsPoints( const std::vector<VECTOR2I>& aPoints,
+                                                  int aSubpolyIndex, int aAccuracy ) const
+{
+    std::vector<bool> result( aPoints.size() );
+
+    for( size_t ii = 0; ii < aPoints.size(); ii++ )
+        result[ii] = Contains( aPoints[ii], aSubpolyIndex, aAccuracy );
+
+    return result;
+}
+
+
+bool POLY_SET_INDEX::Collide( const VECTOR2I& aP, int aClearance, int aSubpolyIndex ) const
+{
+    int64_t margin = (int64_t) std::max( aClearance, 0 ) + 1;
+
+    return queryPolygons( aSubpolyIndex, clampToInt( aP.y - margin ), clampToInt( aP.y + margin ),
+            [&]( const POLYGON& aPolygon ) -> bool
+            {
+                if( containsSingle( aP, aPolygon, 1 ) )
+                    return true;
+
+                for( const CONTOUR& contour : aPolygon.m_contours )
+                {
+                    if( contour.EdgeWithin( aP, std::max( aClearance, 0 ) ) )
+                        return true;
+                }
+
+                return false;
+            } );
+}
+
+
+bool POLY_SET_INDEX::Intersects( const SEG& aSeg, int aSubpolyIndex ) const
+{
+    return queryPolygons( aSubpolyIndex, std::min( aSeg.A.y, aSeg.B.y ),
+                          std::max( aSeg.A.y, aSeg.B.y ),
+            [&]( const POLYGON& aPolygon ) -> bool
+            {
+                for( const CONTOUR& contour : aPolygon.m_contours )
+                {
+                    if( contour.Intersects( aSeg ) )
+                        return true;
+                }
+
+                return false;
+            } );
+}
@@ -27,6 +27,7 @@
  */
 
 #include <geometry/polygon_test_point_inside.h>
+#include <geometry/simd_kernels.h>
 
 /* this algo uses the the Jordan curve theorem to find if a point is inside or outside a polygon:
  * It run a semi-infinite line horizontally (increasing x, fixed y)
@@ -55,49 +56,38 @@
 bool TestPointInsidePolygon( const wxPoint *aPolysList, int aCount, const wxPoint &aRefPoint )
 {
     // count intersection points to right of (refx,refy). If odd number, point (refx,refy) is inside polyline
-    int ics, ice;
-    int count = 0;
-    // find all intersection points of line with polyline sides
-    for( ics = 0, ice = aCount-1; ics < aCount; ice = ics++ )
-    {
-        int seg_startX = aPolysList[ics].x;
-        int seg_startY = aPolysList[ics].y;
-        int seg_endX   = aPolysList[ice].x;
-        int seg_endY   = aPolysList[ice].y;
+    // find all intersection points of line with polyline sides.
+    // The trivial cases, segments above or below the ref point (or with one of its ends at the
+    // same Y pos as the ref point, so we eliminate one end point of 2 consecutive segments) are
+    // skipped by RayCrossingParity.
+    // Note: also horizontal segments are skipped if ref point is on this horizontal line
+    // So reference points on horizontal segments outlines always are seen as outside the polygon
+    bool inside = RayCrossingParity( aPolysList, aCount, aRefPoint.y,
+            [&aRefPoint]( const wxPoint& aEnd, const wxPoint& aStart ) -> bool
+            {
+                /* refy is between seg_startY and seg_endY.
+                 * see if an horizontal semi infinite line from refx is intersecting the segment
+                 */
 
-        /* Trivial cases: skip if ref above or below the segment to test */
-        if( ( seg_startY > aRefPoint.y ) && (seg_endY > aRefPoint.y ) )
-            continue;
+                // calculate the x position of the intersection of this segment and the semi
+                // infinite line. this is more easier if we move the X,Y axis origin to the
+                // segment start point:
+                int    seg_endX = aEnd.x - aStart.x;
+                int    seg_endY = aEnd.y - aStart.y;
+                double newrefx = (double) ( aRefPoint.x - aStart.x );
+                double newrefy = (double) ( aRefPoint.y - aStart.y );
 
-        // segment below ref point, or one of its ends has the same Y pos as the ref point: skip
-        // So we eliminate one end point of 2 consecutive segments.
-        // Note: also we skip horizontal segments if ref point is on this horizontal line
-        // So reference points on horizontal segments outlines always are seen as outside the polygon
-        if( ( seg_startY <= aRefPoint.y ) && (seg_endY <= aRefPoint.y ) )
-            continue;
+                // Now calculate the x intersection coordinate of the line from (0,0) to
+                // (seg_endX,seg_endY) with the horizontal line at the new refy position
+                // the line slope  = seg_endY/seg_endX;
+                // and the x pos relative to the new origin is intersec_x = refy/slope
+                // Note: because horizontal segments are skipped, 1/slope exists
+                // (seg_endY never == O)
+                double intersec_x = ( newrefy * seg_endX ) / seg_endY;
 
-        /* refy is between seg_startY and seg_endY.
-         * note: here: horizontal segments (seg_startY == seg_endY) are skipped,
-         * either by the first test or by the second test
-         * see if an horizontal semi infinite line from refx is intersecting the segment
-         */
+                // Intersection found with the semi-infinite line from refx to infinite
+                return newrefx < intersec_x;
+            } );
 
-        // calculate the x position of the intersection of this segment and the semi infinite line
-        // this is more easier if we move the X,Y axis origin to the segment start point:
-        seg_endX -= seg_startX;
-        seg_endY -= seg_startY;
-        double newrefx = (double) (aRefPoint.x - seg_startX);
-        double newrefy = (double) (aRefPoint.y - seg_startY);
-
-        // Now calculate the x intersection coordinate of the line from (0,0) to (seg_endX,seg_endY)
-        // with the horizontal line at the new refy position
-        // the line slope  = seg_endY/seg_endX;
-        // and the x pos relative to the new origin is intersec_x = refy/slope
-        // Note: because horizontal segments are skipped, 1/slope exists (seg_endY never == O)
-        double intersec_x = (newrefy * seg_endX) / seg_endY;
-        if( newrefx < intersec_x )  // Intersection found with the semi-infinite line from refx to infinite
-            count++;
-    }
-
-    return count & 1 ? INSIDE : OUTSIDE;
+    return inside ? INSIDE : OUTSIDE;
 }
@@ -25,8 +25,10 @@
 
 #include <algorithm>
 #include <math.h>
+#include <memory>
 #include <vector>
 
+#include <geometry/approximation_cache.h>
 #include <geometry/geometry_utils.h>
 #include <geometry/seg.h>               // for SEG
 #include <geometry/shape_arc.h>
@@ -272,6 +274,25 @@ int SHAPE_ARC::GetRadius() const
 }
 
 const SHAPE_LINE_CHAIN SHAPE_ARC::ConvertToPolyline( double aAccuracy ) const
+{
+    typedef APPROXIMATION_CACHE<6, std::shared_ptr<const SHAPE_LINE_CHAIN>> ARC_CACHE;
+
+    // The vertices are truncated to integers, so the approximation is not translation
+    // invariant: the whole arc is part of the key.
+    static ARC_CACHE s_cache( 4096 );
+
+    ARC_CACHE::KEY key = { m_p0.x, m_p0.y, m_pc.x, m_pc.y,
+                           ARC_CACHE::Bits( m_centralAngle ), ARC_CACHE::Bits( aAccuracy ) };
+
+    return *s_cache.Get( key,
+            [&]()
+            {
+                return std::make_shared<SHAPE_LINE_CHAIN>( buildPolyline( aAccuracy ) );
+            } );
+}
+
+
+const SHAPE_LINE_CHAIN SHAPE_ARC::buildPolyline( double aAccuracy ) const
 {
     SHAPE_LINE_CHAIN rv;
     double r = GetRadius();
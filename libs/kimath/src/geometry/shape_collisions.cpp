@@ -158,14 +158,13 @@ static inline bool Collide( const SHAPE_CIRCLE& aA, const SHAPE_LINE_CHAIN& aB,
 {
     bool found = false;
 
-    for( int s = 0; s < aB.SegmentCount(); s++ )
-    {
-        if( aA.Collide( aB.CSegment( s ), aClearance ) )
-        {
-            found = true;
-            break;
-        }
-    }
+    // The margin covers the rounding of SEG::Distance()
+    aB.QuerySegments( aA.BBox( std::abs( aClearance ) + 2 ),
+            [&]( int s ) -> bool
+            {
+                found = aA.Collide( aB.CSegment( s ), aClearance );
+                return !found;
+            } );
 
     if( !aNeedMTV || !found )
         return found;
@@ -227,11 +226,17 @@ static inline bool Collide( const SHAPE_CIRCLE& aA, const SHAPE_SEGMENT& aSeg, i
 static inline bool Collide( const SHAPE_LINE_CHAIN& aA, const SHAPE_LINE_CHAIN& aB, int aClearance,
                             bool aNeedMTV, VECTOR2I& aMTV )
 {
-    for( int i = 0; i < aB.SegmentCount(); i++ )
-        if( aA.Collide( aB.CSegment( i ), aClearance ) )
-            return true;
+    bool found = false;
 
-    return false;
+    // Only the segments of aB near aA can collide with it
+    aB.QuerySegments( aA.BBox( std::abs( aClearance ) + 2 ),
+            [&]( int i ) -> bool
+            {
+                found = aA.Collide( aB.CSegment( i ), aClearance );
+                return !found;
+            } );
+
+    return found;
 }
 
 
@@ -252,13 +257,16 @@ static inline bool Collide( const SHAPE_SIMPLE& aA, const SHAPE_SIMPLE& aB, int
 static inline bool Collide( const SHAPE_RECT& aA, const SHAPE_LINE_CHAIN& aB, int aClearance,
                             bool aNeedMTV, VECTOR2I& aMTV )
 {
-    for( int s = 0; s < aB.SegmentCount(); s++ )
-    {
-        if( aA.Collide( aB.CSegment( s ), aClearance ) )
-            return true;
-    }
+    bool found = false;
 
-    return false;
+    aB.QuerySegments( aA.BBox( std::abs( aClearance ) + 2 ),
+            [&]( int s ) -> bool
+            {
+                found = aA.Collide( aB.CSegment( s ), aClearance );
+                return !found;
+            } );
+
+    return found;
 }
 
 
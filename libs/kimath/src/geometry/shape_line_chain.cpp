@@ -30,12 +30,208 @@
 #include <clipper.hpp>
 #include <geometry/seg.h>    // for SEG, OPT_VECTOR2I
 #include <geometry/shape_line_chain.h>
+#include <geometry/simd_kernels.h>
 #include <math/box2.h>       // for BOX2I
 #include <math/util.h>  // for rescale
 #include <math/vector2d.h>   // for VECTOR2, VECTOR2I
 
 class SHAPE;
 
+
+/**
+ * SHAPE_LINE_CHAIN::SEGMENT_BVH
+ *
+ * A bounding volume hierarchy of the segments of a line chain, in index order: the leaves
+ * hold the bounding box of LEAF_SIZE consecutive segments, and each upper level merges the
+ * boxes of pairs of nodes of the level below.  Since consecutive segments of a chain are
+ * close to each other, this is nearly as tight as a spatially sorted tree, and queries
+ * naturally return the segments in increasing index order.
+ */
+class SHAPE_LINE_CHAIN::SEGMENT_BVH
+{
+public:
+    SEGMENT_BVH( const SHAPE_LINE_CHAIN& aChain )
+    {
+        int               count = aChain.SegmentCount();
+        std::vector<NODE> leaves( ( count + LEAF_SIZE - 1 ) / LEAF_SIZE );
+
+        for( int i = 0; i < count; i++ )
+        {
+            const SEG s = aChain.CSegment( i );
+            NODE&     leaf = leaves[i / LEAF_SIZE];
+
+            if( i % LEAF_SIZE == 0 )
+                leaf = { s.A.x, s.A.y, s.A.x, s.A.y };
+
+            leaf.Merge( s.A );
+            leaf.Merge( s.B );
+        }
+
+        m_levels.push_back( std::move( leaves ) );
+
+        while( m_levels.back().size() > 1 )
+        {
+            const std::vector<NODE>& below = m_levels.back();
+            std::vector<NODE>        level( ( below.size() + 1 ) / 2 );
+
+            for( size_t i = 0; i < level.size(); i++ )
+            {
+                level[i] = below[2 * i];
+
+                if( 2 * i + 1 < below.size() )
+                    level[i].Merge( below[2 * i + 1] );
+            }
+
+            m_levels.push_back( std::move( level ) );
+        }
+    }
+
+    /**
+     * Calls aVisitor( aFirstSeg, aLastSeg ) for each run of at most LEAF_SIZE segments,
+     * from aFirst on, whose leaf intersects the given box.
+     * @return false if the visitor stopped the query.
+     */
+    template <class VISITOR>
+    bool Query( int aMinX, int aMinY, int aMaxX, int aMaxY, int aFirst, int aCount,
+                VISITOR& aVisitor ) const
+    {
+        NODE box = { aMinX, aMinY, aMaxX, aMaxY };
+
+        return query( box, (int) m_levels.size() - 1, 0, aFirst, aCount, aVisitor );
+    }
+
+    static const int LEAF_SIZE = 8;
+
+private:
+    struct NODE
+    {
+        int m_minX, m_minY, m_maxX, m_maxY;
+
+        void Merge( const VECTOR2I& aP )
+        {
+            m_minX = std::min( m_minX, aP.x );
+            m_minY = std::min( m_minY, aP.y );
+            m_maxX = std::max( m_maxX, aP.x );
+            m_maxY = std::max( m_maxY, aP.y );
+        }
+
+        void Merge( const NODE& aNode )
+        {
+            m_minX = std::min( m_minX, aNode.m_minX );
+            m_minY = std::min( m_minY, aNode.m_minY );
+            m_maxX = std::max( m_maxX, aNode.m_maxX );
+            m_maxY = std::max( m_maxY, aNode.m_maxY );
+        }
+
+        bool Intersects( const NODE& aNode ) const
+        {
+            return m_minX <= aNode.m_maxX && aNode.m_minX <= m_maxX
+                   && m_minY <= aNode.m_maxY && aNode.m_minY <= m_maxY;
+        }
+    };
+
+    template <class VISITOR>
+    bool query( const NODE& aBox, int aLevel, int aNode, int aFirst, int aCount,
+                VISITOR& aVisitor ) const
+    {
+        // The segments below the node are [first, last)
+        int first = ( aNode * LEAF_SIZE ) << aLevel;
+        int last = std::min( ( ( aNode + 1 ) * LEAF_SIZE ) << aLevel, aCount );
+
+        if( last <= aFirst || !m_levels[aLevel][aNode].Intersects( aBox ) )
+            return true;
+
+        if( aLevel == 0 )
+            return aVisitor( std::max( first, aFirst ), last );
+
+        if( !query( aBox, aLevel - 1, 2 * aNode, aFirst, aCount, aVisitor ) )
+            return false;
+
+        if( 2 * aNode + 1 < (int) m_levels[aLevel - 1].size() )
+            return query( aBox, aLevel - 1, 2 * aNode + 1, aFirst, aCount, aVisitor );
+
+        return true;
+    }
+
+    std::vector<std::vector<NODE>> m_levels;
+};
+
+
+std::shared_ptr<const SHAPE_LINE_CHAIN::SEGMENT_BVH> SHAPE_LINE_CHAIN::segmentBVH() const
+{
+    if( SegmentCount() < BVH_MIN_SEGMENTS )
+        return nullptr;
+
+    std::shared_ptr<const SEGMENT_BVH> bvh = std::atomic_load( &m_bvh );
+
+    if( !bvh )
+    {
+        // Concurrent queries may each build one; the first one stored wins
+        std::shared_ptr<const SEGMENT_BVH> built = std::make_shared<SEGMENT_BVH>( *this );
+
+        if( std::atomic_compare_exchange_strong( &m_bvh, &bvh, built ) )
+            bvh = built;
+    }
+
+    return bvh;
+}
+
+
+template <class VISITOR>
+void SHAPE_LINE_CHAIN::querySegments( const BOX2I& aBox, int aFirst, VISITOR aVisitor ) const
+{
+    BOX2I box( aBox );
+    box.Normalize();
+
+    int minX = box.GetX(), minY = box.GetY(), maxX = box.GetRight(), maxY = box.GetBottom();
+
+    auto visitRun =
+            [&]( int aStart, int aEnd ) -> bool
+            {
+                for( int i = aStart; i < aEnd; i++ )
+                {
+                    const VECTOR2I& a = m_points[i];
+                    const VECTOR2I& b = m_points[i + 1 == PointCount() ? 0 : i + 1];
+
+                    if( ( a.x < minX && b.x < minX ) || ( a.x > maxX && b.x > maxX )
+                            || ( a.y < minY && b.y < minY ) || ( a.y > maxY && b.y > maxY ) )
+                        continue;
+
+                    if( !aVisitor( i ) )
+                        return false;
+                }
+
+                return true;
+            };
+
+    std::shared_ptr<const SEGMENT_BVH> bvh = segmentBVH();
+
+    if( bvh )
+        bvh->Query( minX, minY, maxX, maxY, aFirst, SegmentCount(), visitRun );
+    else
+        visitRun( aFirst, SegmentCount() );
+}
+
+
+void SHAPE_LINE_CHAIN::QuerySegments( const BOX2I& aBox,
+                                      const std::function<bool( int )>& aVisitor ) const
+{
+    querySegments( aBox, 0, aVisitor );
+}
+
+
+// The box of the segments which may be closer than aClearance to aSeg, with a margin for
+// the rounding of the distance computations (see SEG::PointCloserThan()).
+static BOX2I collisionBox( const SEG& aSeg, int aClearance )
+{
+    BOX2I box( aSeg.A, aSeg.B - aSeg.A );
+    box.Normalize();
+    box.Inflate( std::abs( aClearance ) + 2 );
+
+    return box;
+}
+
+
 SHAPE_LINE_CHAIN::SHAPE_LINE_CHAIN( const std::vector<int>& aV)
     : SHAPE( SH_LINE_CHAIN ), m_closed( false ), m_width( 0 )
 {
@@ -45,18 +241,16 @@ SHAPE_LINE_CHAIN::SHAPE_LINE_CHAIN( const std::vector<int>& aV)
     }
 }
 
-ClipperLib::Path SHAPE_LINE_CHAIN::convertToClipper( bool aRequiredOrientation ) const
+ClipperLib::IntPairPath SHAPE_LINE_CHAIN::clipperPath( bool aRequiredOrientation ) const
 {
-    ClipperLib::Path c_path;
+    static_assert( sizeof( VECTOR2I ) == 2 * sizeof( int ),
+                   "VECTOR2I must be made of two consecutive ints" );
 
-    for( int i = 0; i < PointCount(); i++ )
-    {
-        const VECTOR2I& vertex = CPoint( i );
-        c_path.push_back( ClipperLib::IntPoint( vertex.x, vertex.y ) );
-    }
+    ClipperLib::IntPairPath c_path( reinterpret_cast<const int*>( m_points.data() ),
+                                    m_points.size() );
 
     if( Orientation( c_path ) != aRequiredOrientation )
-        ReversePath( c_path );
+        c_path.Reversed = true;
 
     return c_path;
 }
@@ -104,6 +298,8 @@ void SHAPE_LINE_CHAIN::Rotate( double aAngle, const VECTOR2I& aCenter )
 
     for( auto& arc : m_arcs )
         arc.Rotate( aAngle, aCenter );
+
+    invalidateBVH();
 }
 
 
@@ -111,22 +307,23 @@ bool SHAPE_LINE_CHAIN::Collide( const SEG& aSeg, int aClearance ) const
 {
     BOX2I box_a( aSeg.A, aSeg.B - aSeg.A );
     BOX2I::ecoord_type dist_sq = (BOX2I::ecoord_type) aClearance * aClearance;
+    bool collide = false;
 
-    for( int i = 0; i < SegmentCount(); i++ )
-    {
-        const SEG& s = CSegment( i );
-        BOX2I box_b( s.A, s.B - s.A );
+    querySegments( collisionBox( aSeg, aClearance ), 0,
+            [&]( int i ) -> bool
+            {
+                const SEG& s = CSegment( i );
+                BOX2I box_b( s.A, s.B - s.A );
 
-        BOX2I::ecoord_type d = box_a.SquaredDistance( box_b );
+                BOX2I::ecoord_type d = box_a.SquaredDistance( box_b );
 
-        if( d < dist_sq )
-        {
-            if( s.Collide( aSeg, aClearance ) )
-                return true;
-        }
-    }
+                if( d < dist_sq && s.Collide( aSeg, aClearance ) )
+                    collide = true;
 
-    return false;
+                return !collide;
+            } );
+
+    return collide;
 }
 
 
@@ -175,6 +372,8 @@ void SHAPE_LINE_CHAIN::Mirror( bool aX, bool aY, const VECTOR2I& aRef )
 
     for( auto& arc : m_arcs )
         arc.Mirror( aX, aY, aRef );
+
+    invalidateBVH();
 }
 
 
@@ -187,6 +386,7 @@ void SHAPE_LINE_CHAIN::Replace( int aStartIndex, int aEndIndex, const VECTOR2I&
         aStartIndex += PointCount();
 
     aEndIndex = std::min( aEndIndex, PointCount() - 1 );
+    invalidateBVH();
 
     // N.B. This works because convertArc changes m_shapes on the first run
     for( int ind = aStartIndex; ind <= aEndIndex; ind++ )
@@ -229,6 +429,7 @@ void SHAPE_LINE_CHAIN::Replace( int aStartIndex, int aEndIndex, const SHAPE_LINE
     m_shapes.insert( m_shapes.begin() + aStartIndex, new_shapes.begin(), new_shapes.end() );
     m_points.insert( m_points.begin() + aStartIndex, aLine.m_points.begin(), aLine.m_points.end() );
     m_arcs.insert( m_arcs.end(), aLine.m_arcs.begin(), aLine.m_arcs.end() );
+    invalidateBVH();
 
     assert( m_shapes.size() == m_points.size() );
 }
@@ -261,6 +462,7 @@ void SHAPE_LINE_CHAIN::Remove( int aStartIndex, int aEndIndex )
 
     m_shapes.erase( m_shapes.begin() + aStartIndex, m_shapes.begin() + aEndIndex + 1 );
     m_points.erase( m_points.begin() + aStartIndex, m_points.begin() + aEndIndex + 1 );
+    invalidateBVH();
     assert( m_shapes.size() == m_points.size() );
 }
 
@@ -310,6 +512,7 @@ int SHAPE_LINE_CHAIN::Split( const VECTOR2I& aP )
     {
         m_points.insert( m_points.begin() + ii + 1, aP );
         m_shapes.insert( m_shapes.begin() + ii + 1, ssize_t( SHAPE_IS_PT ) );
+        invalidateBVH();
 
         return ii + 1;
     }
@@ -388,6 +591,7 @@ void SHAPE_LINE_CHAIN::Append( const SHAPE_LINE_CHAIN& aOtherLine )
         m_bbox.Merge( p );
     }
 
+    invalidateBVH();
     assert( m_shapes.size() == m_points.size() );
 }
 
@@ -403,6 +607,7 @@ void SHAPE_LINE_CHAIN::Append( const SHAPE_ARC& aArc )
     }
 
     m_arcs.push_back( aArc );
+    invalidateBVH();
 
     assert( m_shapes.size() == m_points.size() );
 }
@@ -415,6 +620,7 @@ void SHAPE_LINE_CHAIN::Insert( size_t aVertex, const VECTOR2I& aP )
 
     m_points.insert( m_points.begin() + aVertex, aP );
     m_shapes.insert( m_shapes.begin() + aVertex, ssize_t( SHAPE_IS_PT ) );
+    invalidateBVH();
 
     assert( m_shapes.size() == m_points.size() );
 }
@@ -446,6 +652,7 @@ void SHAPE_LINE_CHAIN::Insert( size_t aVertex, const SHAPE_ARC& aArc )
     /// Step 3: Add the vector of indices to the shape vector
     std::vector<size_t> new_points( chain.PointCount(), arc_pos );
     m_shapes.insert( m_shapes.begin() + aVertex, new_points.begin(), new_points.end() );
+    invalidateBVH();
     assert( m_shapes.size() == m_points.size() );
 }
 
@@ -467,19 +674,22 @@ struct compareOriginDistance
 
 int SHAPE_LINE_CHAIN::Intersect( const SEG& aSeg, INTERSECTIONS& aIp ) const
 {
-    for( int s = 0; s < SegmentCount(); s++ )
-    {
-        OPT_VECTOR2I p = CSegment( s ).Intersect( aSeg );
+    querySegments( collisionBox( aSeg, 0 ), 0,
+            [&]( int s ) -> bool
+            {
+                OPT_VECTOR2I p = CSegment( s ).Intersect( aSeg );
 
-        if( p )
-        {
-            INTERSECTION is;
-            is.our = CSegment( s );
-            is.their = aSeg;
-            is.p = *p;
-            aIp.push_back( is );
-        }
-    }
+                if( p )
+                {
+                    INTERSECTION is;
+                    is.our = CSegment( s );
+                    is.their = aSeg;
+                    is.p = *p;
+                    aIp.push_back( is );
+                }
+
+                return true;
+            } );
 
     compareOriginDistance comp( aSeg.A );
     sort( aIp.begin(), aIp.end(), comp );
@@ -518,34 +728,38 @@ int SHAPE_LINE_CHAIN::Intersect( const SHAPE_LINE_CHAIN& aChain, INTERSECTIONS&
         if( !bb_other.Intersects( bb_cur ) )
             continue;
 
-        for( int s2 = 0; s2 < aChain.SegmentCount(); s2++ )
-        {
-            const SEG& b = aChain.CSegment( s2 );
-            INTERSECTION is;
-
-            if( a.Collinear( b ) )
-            {
-                is.our = a;
-                is.their = b;
-
-                if( a.Contains( b.A ) ) { is.p = b.A; addIntersection(aIp, PointCount(), is); }
-                if( a.Contains( b.B ) ) { is.p = b.B; addIntersection(aIp, PointCount(), is); }
-                if( b.Contains( a.A ) ) { is.p = a.A; addIntersection(aIp, PointCount(), is); }
-                if( b.Contains( a.B ) ) { is.p = a.B; addIntersection(aIp, PointCount(), is); }
-            }
-            else
-            {
-                OPT_VECTOR2I p = a.Intersect( b );
-
-                if( p )
+        // Only the segments of aChain near a can intersect it, or contain one of its ends
+        aChain.querySegments( collisionBox( a, 0 ), 0,
+                [&]( int s2 ) -> bool
                 {
-                    is.p = *p;
-                    is.our = a;
-                    is.their = b;
-                    addIntersection(aIp, PointCount(), is);
-                }
-            }
-        }
+                    const SEG& b = aChain.CSegment( s2 );
+                    INTERSECTION is;
+
+                    if( a.Collinear( b ) )
+                    {
+                        is.our = a;
+                        is.their = b;
+
+                        if( a.Contains( b.A ) ) { is.p = b.A; addIntersection(aIp, PointCount(), is); }
+                        if( a.Contains( b.B ) ) { is.p = b.B; addIntersection(aIp, PointCount(), is); }
+                        if( b.Contains( a.A ) ) { is.p = a.A; addIntersection(aIp, PointCount(), is); }
+                        if( b.Contains( a.B ) ) { is.p = a.B; addIntersection(aIp, PointCount(), is); }
+                    }
+                    else
+                    {
+                        OPT_VECTOR2I p = a.Intersect( b );
+
+                        if( p )
+                        {
+                            is.p = *p;
+                            is.our = a;
+                            is.their = b;
+                            addIntersection(aIp, PointCount(), is);
+                        }
+                    }
+
+                    return true;
+                } );
     }
 
     return aIp.size();
@@ -586,8 +800,6 @@ bool SHAPE_LINE_CHAIN::PointInside( const VECTOR2I& aPt, int aAccuracy, bool aUs
     if( !m_closed || PointCount() < 3 )
         return false;
 
-    bool inside = false;
-
     /**
      * To check for interior points, we draw a line in the positive x direction from
      * the point.  If it intersects an even number of segments, the point is outside the
@@ -596,26 +808,20 @@ bool SHAPE_LINE_CHAIN::PointInside( const VECTOR2I& aPt, int aAccuracy, bool aUs
      * Note: slope might be denormal here in the case of a horizontal line but we require our
      * y to move from above to below the point (or vice versa)
      *
-     * Note: we open-code CPoint() here so that we don't end up calculating the size of the
-     * vector number-of-points times.  This has a non-trivial impact on zone fill times.
+     * Note: the edges which do not straddle the horizontal line through the point are
+     * rejected by a vectorized kernel, several at a time.  This has a non-trivial impact on
+     * zone fill times.
      */
     const std::vector<VECTOR2I>& points = CPoints();
-    int pointCount = points.size();
 
-    for( int i = 0; i < pointCount; )
-    {
-        const auto p1 = points[ i++ ];
-        const auto p2 = points[ i == pointCount ? 0 : i ];
-        const auto diff = p2 - p1;
+    bool inside = RayCrossingParity( points.data(), (int) points.size(), aPt.y,
+            [&aPt]( const VECTOR2I& p1, const VECTOR2I& p2 ) -> bool
+            {
+                const auto diff = p2 - p1;
+                const int  d = rescale( diff.x, ( aPt.y - p1.y ), diff.y );
 
-        if( diff.y != 0 )
-        {
-            const int d = rescale( diff.x, ( aPt.y - p1.y ), diff.y );
-
-            if( ( ( p1.y > aPt.y ) != ( p2.y > aPt.y ) ) && ( aPt.x - p1.x < d ) )
-                inside = !inside;
-        }
-    }
+                return aPt.x - p1.x < d;
+            } );
 
     // If accuracy is 0 then we need to make sure the point isn't actually on the edge.
     // If accuracy is 1 then we don't really care whether or not the point is *exactly* on the
@@ -646,18 +852,7 @@ int SHAPE_LINE_CHAIN::EdgeContainingPoint( const VECTOR2I& aPt, int aAccuracy )
 	    return ( hypot( dist.x, dist.y ) <= aAccuracy + 1 ) ? 0 : -1;
     }
 
-    for( int i = 0; i < SegmentCount(); i++ )
-    {
-        const SEG s = CSegment( i );
-
-        if( s.A == aPt || s.B == aPt )
-            return i;
-
-        if( s.Distance( aPt ) <= aAccuracy + 1 )
-            return i;
-    }
-
-    return -1;
+    return findEdgeNear( aPt, aAccuracy + 1 );
 }
 
 
@@ -669,66 +864,83 @@ bool SHAPE_LINE_CHAIN::CheckClearance( const VECTOR2I& aP, const int aDist) cons
     else if( PointCount() == 1 )
         return m_points[0] == aP;
 
-    for( int i = 0; i < SegmentCount(); i++ )
-    {
-        const SEG s = CSegment( i );
+    return findEdgeNear( aP, aDist ) >= 0;
+}
 
-        if( s.A == aP || s.B == aP )
-            return true;
 
-        if( s.Distance( aP ) <= aDist )
-            return true;
-    }
+int SHAPE_LINE_CHAIN::findEdgeNear( const VECTOR2I& aP, int aDist ) const
+{
+    // SEG::Distance() truncates, so a segment may be reported at aDist when it is a little
+    // farther.  Its nearest point is still closer than aDist + 2 in each direction.
+    int64_t margin = std::max( aDist, -1 ) + 2;
+    int     minX = (int) std::max<int64_t>( INT_MIN, aP.x - margin );
+    int     minY = (int) std::max<int64_t>( INT_MIN, aP.y - margin );
+    int     maxX = (int) std::min<int64_t>( INT_MAX, aP.x + margin );
+    int     maxY = (int) std::min<int64_t>( INT_MAX, aP.y + margin );
+
+    return FirstEdgeInBox( m_points.data(), (int) m_points.size(), m_closed,
+                           minX, minY, maxX, maxY,
+            [&aP, aDist]( const VECTOR2I& a, const VECTOR2I& b ) -> bool
+            {
+                if( a == aP || b == aP )
+                    return true;
 
-    return false;
+                return SEG( a, b ).Distance( aP ) <= aDist;
+            } );
 }
 
 
 const OPT<SHAPE_LINE_CHAIN::INTERSECTION> SHAPE_LINE_CHAIN::SelfIntersecting() const
 {
-    for( int s1 = 0; s1 < SegmentCount(); s1++ )
-    {
-        for( int s2 = s1 + 1; s2 < SegmentCount(); s2++ )
-        {
-            const VECTOR2I s2a = CSegment( s2 ).A, s2b = CSegment( s2 ).B;
+    OPT<SHAPE_LINE_CHAIN::INTERSECTION> found;
 
-            if( s1 + 1 != s2 && CSegment( s1 ).Contains( s2a ) )
-            {
-                INTERSECTION is;
-                is.our = CSegment( s1 );
-                is.their = CSegment( s2 );
-                is.p = s2a;
-                return is;
-            }
-            else if( CSegment( s1 ).Contains( s2b ) &&
-                     // for closed polylines, the ending point of the
-                     // last segment == starting point of the first segment
-                     // this is a normal case, not self intersecting case
-                     !( IsClosed() && s1 == 0 && s2 == SegmentCount()-1 ) )
-            {
-                INTERSECTION is;
-                is.our = CSegment( s1 );
-                is.their = CSegment( s2 );
-                is.p = s2b;
-                return is;
-            }
-            else
-            {
-                OPT_VECTOR2I p = CSegment( s1 ).Intersect( CSegment( s2 ), true );
-
-                if( p )
+    for( int s1 = 0; s1 < SegmentCount() && !found; s1++ )
+    {
+        // The following segments which are not near s1 can neither cross it nor touch it
+        querySegments( collisionBox( CSegment( s1 ), 0 ), s1 + 1,
+                [&]( int s2 ) -> bool
                 {
-                    INTERSECTION is;
-                    is.our = CSegment( s1 );
-                    is.their = CSegment( s2 );
-                    is.p = *p;
-                    return is;
-                }
-            }
-        }
+                    const VECTOR2I s2a = CSegment( s2 ).A, s2b = CSegment( s2 ).B;
+
+                    if( s1 + 1 != s2 && CSegment( s1 ).Contains( s2a ) )
+                    {
+                        INTERSECTION is;
+                        is.our = CSegment( s1 );
+                        is.their = CSegment( s2 );
+                        is.p = s2a;
+                        found = is;
+                    }
+                    else if( CSegment( s1 ).Contains( s2b ) &&
+                             // for closed polylines, the ending point of the
+                             // last segment == starting point of the first segment
+                             // this is a normal case, not self intersecting case
+                             !( IsClosed() && s1 == 0 && s2 == SegmentCount()-1 ) )
+                    {
+                        INTERSECTION is;
+                        is.our = CSegment( s1 );
+                        is.their = CSegment( s2 );
+                        is.p = s2b;
+                        found = is;
+                    }
+                    else
+                    {
+                        OPT_VECTOR2I p = CSegment( s1 ).Intersect( CSegment( s2 ), true );
+
+                        if( p )
+                        {
+                            INTERSECTION is;
+                            is.our = CSegment( s1 );
+                            is.their = CSegment( s2 );
+                            is.p = *p;
+                            found = is;
+                        }
+                    }
+
+                    return !found;
+                } );
     }
 
-    return OPT<SHAPE_LINE_CHAIN::INTERSECTION>();
+    return found;
 }
 
 
@@ -744,7 +956,10 @@ SHAPE_LINE_CHAIN& SHAPE_LINE_CHAIN::Simplify()
     else if( PointCount() == 2 )
     {
         if( m_points[0] == m_points[1] )
+        {
             m_points.pop_back();
+            invalidateBVH();
+        }
 
         return *this;
     }
@@ -768,6 +983,7 @@ SHAPE_LINE_CHAIN& SHAPE_LINE_CHAIN::Simplify()
 
     m_points.clear();
     m_shapes.clear();
+    invalidateBVH();
     np = pts_unique.size();
 
     i = 0;
@@ -927,6 +1143,7 @@ bool SHAPE_LINE_CHAIN::Parse( std::stringstream& aStream )
     size_t n_arcs;
 
     m_points.clear();
+    invalidateBVH();
     aStream >> n_pts;
 
     // Rough sanity check, just make sure the loop bounds aren't absolutely outlandish
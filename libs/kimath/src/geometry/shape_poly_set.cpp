@@ -28,19 +28,23 @@
 
 #include <algorithm>
 #include <assert.h>                          // for assert
+#include <atomic>
 #include <cmath>                             // for sqrt, cos, hypot, isinf
 #include <cstdio>
+#include <future>
 #include <istream>                           // for operator<<, operator>>
 #include <limits>                            // for numeric_limits
 #include <memory>
 #include <set>
 #include <string>                            // for char_traits, operator!=
+#include <thread>
 #include <type_traits>                       // for swap, move
 #include <unordered_set>
 #include <vector>
 
 #include <clipper.hpp>                       // for Clipper, PolyNode, Clipp...
 #include <geometry/geometry_utils.h>
+#include <geometry/poly_set_index.h>
 #include <geometry/polygon_triangulation.h>
 #include <geometry/seg.h>                    // for SEG, OPT_VECTOR2I
 #include <geometry/shape.h>
@@ -72,10 +76,7 @@ SHAPE_POLY_SET::SHAPE_POLY_SET( const SHAPE_POLY_SET& aOther, bool aDeepCopy ) :
 {
     if( aOther.IsTriangulationUpToDate() )
     {
-        for( unsigned i = 0; i < aOther.TriangulatedPolyCount(); i++ )
-            m_triangulatedPolys.push_back(
-                    std::make_unique<TRIANGULATED_POLYGON>( *aOther.TriangulatedPolygon( i ) ) );
-
+        m_triangulatedPolys = aOther.m_triangulatedPolys;
         m_hash = aOther.GetHash();
         m_triangulationValid = true;
     }
@@ -150,7 +151,7 @@ bool SHAPE_POLY_SET::GetGlobalIndex( SHAPE_POLY_SET::VERTEX_INDEX aRelativeIndic
 
         for( unsigned int polygonIdx = 0; polygonIdx < selectedPolygon; polygonIdx++ )
         {
-            currentPolygon = Polygon( polygonIdx );
+            currentPolygon = CPolygon( polygonIdx );
 
             for( unsigned int contourIdx = 0; contourIdx < currentPolygon.size(); contourIdx++ )
             {
@@ -158,7 +159,7 @@ bool SHAPE_POLY_SET::GetGlobalIndex( SHAPE_POLY_SET::VERTEX_INDEX aRelativeIndic
             }
         }
 
-        currentPolygon = Polygon( selectedPolygon );
+        currentPolygon = CPolygon( selectedPolygon );
 
         for( unsigned int contourIdx = 0; contourIdx < selectedContour; contourIdx++ )
         {
@@ -283,7 +284,7 @@ SHAPE_POLY_SET SHAPE_POLY_SET::Subset( int aFirstPolygon, int aLastPolygon )
 
     for( int index = aFirstPolygon; index < aLastPolygon; index++ )
     {
-        newPolySet.m_polys.push_back( Polygon( index ) );
+        newPolySet.m_polys.push_back( CPolygon( index ) );
     }
 
     return newPolySet;
@@ -462,16 +463,16 @@ void SHAPE_POLY_SET::booleanOp( ClipperLib::ClipType aType,
 
     c.StrictlySimple( aFastMode == PM_STRICTLY_SIMPLE );
 
-    for( auto poly : aShape.m_polys )
+    for( const POLYGON& poly : aShape.m_polys )
     {
         for( size_t i = 0 ; i < poly.size(); i++ )
-            c.AddPath( poly[i].convertToClipper( i == 0 ), ptSubject, true );
+            c.AddPath( poly[i].clipperPath( i == 0 ), ptSubject, true );
     }
 
-    for( auto poly : aOtherShape.m_polys )
+    for( const POLYGON& poly : aOtherShape.m_polys )
     {
         for( size_t i = 0; i < poly.size(); i++ )
-            c.AddPath( poly[i].convertToClipper( i == 0 ), ptClip, true );
+            c.AddPath( poly[i].clipperPath( i == 0 ), ptClip, true );
     }
 
     PolyTree solution;
@@ -508,6 +509,23 @@ void SHAPE_POLY_SET::BooleanAdd( const SHAPE_POLY_SET& a,
 }
 
 
+void SHAPE_POLY_SET::BooleanAdd( const std::vector<SHAPE_POLY_SET>& aSets,
+                                 POLYGON_MODE aFastMode )
+{
+    std::vector<const SHAPE_POLY_SET*> parts;
+
+    for( const SHAPE_POLY_SET& set : aSets )
+    {
+        if( set.OutlineCount() )
+            parts.push_back( &set );
+    }
+
+    SHAPE_POLY_SET result;
+    result.unionParts( parts, aFastMode );
+    *this = result;
+}
+
+
 void SHAPE_POLY_SET::BooleanSubtract( const SHAPE_POLY_SET& a,
         const SHAPE_POLY_SET& b,
         POLYGON_MODE aFastMode )
@@ -534,7 +552,7 @@ void SHAPE_POLY_SET::InflateWithLinkedHoles( int aFactor, int aCircleSegmentsCou
 
 
 void SHAPE_POLY_SET::Inflate( int aAmount, int aCircleSegmentsCount,
-                              CORNER_STRATEGY aCornerStrategy )
+                              CORNER_STRATEGY aCornerStrategy, bool aCompactCorners )
 {
     // A static table to avoid repetitive calculations of the coefficient
     // 1.0 - cos( M_PI / aCircleSegmentsCount )
@@ -583,7 +601,7 @@ void SHAPE_POLY_SET::Inflate( int aAmount, int aCircleSegmentsCount,
     for( const POLYGON& poly : m_polys )
     {
         for( size_t i = 0; i < poly.size(); i++ )
-            c.AddPath( poly[i].convertToClipper( i == 0 ), joinType, etClosedPolygon );
+            c.AddPath( poly[i].clipperPath( i == 0 ), joinType, etClosedPolygon );
     }
 
     PolyTree solution;
@@ -610,6 +628,7 @@ void SHAPE_POLY_SET::Inflate( int aAmount, int aCircleSegmentsCount,
     c.ArcTolerance = std::abs( aAmount ) * coeff;
     c.MiterLimit = miterLimit;
     c.MiterFallback = miterFallback;
+    c.CompactJoins = aCompactCorners;
     c.Execute( solution, aAmount );
 
     importTree( &solution );
@@ -1051,6 +1070,209 @@ void SHAPE_POLY_SET::Simplify( POLYGON_MODE aFastMode )
 }
 
 
+void SHAPE_POLY_SET::SimplifyParallel( POLYGON_MODE aFastMode )
+{
+    std::vector<SHAPE_POLY_SET>        outlines( OutlineCount() );
+    std::vector<const SHAPE_POLY_SET*> parts;
+
+    for( int ii = 0; ii < OutlineCount(); ii++ )
+    {
+        outlines[ii].m_polys.push_back( std::move( m_polys[ii] ) );
+        parts.push_back( &outlines[ii] );
+    }
+
+    unionParts( parts, aFastMode );
+}
+
+
+///> Number of helper threads currently started by parallelFor(), over all callers
+static std::atomic<size_t> s_parallelHelpers( 0 );
+
+
+/**
+ * Runs aFunc( 0 ) ... aFunc( aCount - 1 ) on as many threads as there are cores.  Callers
+ * may already run on several threads (the zone filler does), so the helper threads started
+ * by all the concurrent calls are limited to the number of cores too; the calling thread
+ * always takes part.
+ */
+template <class FUNC>
+static void parallelFor( size_t aCount, FUNC aFunc )
+{
+    std::atomic<size_t> nextItem( 0 );
+    size_t              cores = std::max<size_t>( std::thread::hardware_concurrency(), 1 );
+    size_t              parallelThreadCount = 1;
+
+    while( parallelThreadCount < std::min( cores, aCount ) )
+    {
+        if( s_parallelHelpers.fetch_add( 1 ) >= cores )
+        {
+            s_parallelHelpers--;
+            break;
+        }
+
+        parallelThreadCount++;
+    }
+
+    auto worker =
+            [&]()
+            {
+                for( size_t i = nextItem.fetch_add( 1 ); i < aCount; i = nextItem.fetch_add( 1 ) )
+                    aFunc( i );
+            };
+
+    std::vector<std::future<void>> returns;
+
+    for( size_t ii = 1; ii < parallelThreadCount; ++ii )
+        returns.push_back( std::async( std::launch::async, worker ) );
+
+    worker();
+
+    for( std::future<void>& ret : returns )
+        ret.wait();
+
+    s_parallelHelpers -= parallelThreadCount - 1;
+}
+
+
+///> Interleaves the bits of two 16 bit coordinates (Z-order curve)
+static uint32_t mortonCode( uint32_t aX, uint32_t aY )
+{
+    auto spread =
+            []( uint32_t v ) -> uint32_t
+            {
+                v = ( v | ( v << 8 ) ) & 0x00FF00FF;
+                v = ( v | ( v << 4 ) ) & 0x0F0F0F0F;
+                v = ( v | ( v << 2 ) ) & 0x33333333;
+                v = ( v | ( v << 1 ) ) & 0x55555555;
+                return v;
+            };
+
+    return spread( aX ) | ( spread( aY ) << 1 );
+}
+
+
+void SHAPE_POLY_SET::unionOp( const std::vector<const SHAPE_POLY_SET*>& aSets,
+                              POLYGON_MODE aFastMode )
+{
+    Clipper c;
+
+    c.StrictlySimple( aFastMode == PM_STRICTLY_SIMPLE );
+
+    for( const SHAPE_POLY_SET* set : aSets )
+    {
+        for( const POLYGON& poly : set->m_polys )
+        {
+            for( size_t i = 0; i < poly.size(); i++ )
+                c.AddPath( poly[i].clipperPath( i == 0 ), ptSubject, true );
+        }
+    }
+
+    PolyTree solution;
+
+    c.Execute( ctUnion, solution, pftNonZero, pftNonZero );
+
+    importTree( &solution );
+}
+
+
+void SHAPE_POLY_SET::unionParts( const std::vector<const SHAPE_POLY_SET*>& aParts,
+                                 POLYGON_MODE aFastMode )
+{
+    // Clipper is superlinear in the number of edges, so unions of a few thousand vertices at
+    // a time are much faster than a single one.  A smaller leaf size only adds merges.
+    const int LEAF_VERTICES = 2048;
+
+    int totalVertices = 0;
+
+    for( const SHAPE_POLY_SET* part : aParts )
+        totalVertices += part->TotalVertices();
+
+    if( aParts.size() < 2 || totalVertices <= LEAF_VERTICES )
+    {
+        unionOp( aParts, aFastMode );
+        return;
+    }
+
+    // Sort the parts along a Z-order curve of their bounding box centres, so that neighbouring
+    // parts are merged first: partial unions of overlapping parts are smaller than their inputs.
+    std::vector<VECTOR2I> centres;
+    VECTOR2I              minPt( std::numeric_limits<int>::max(), std::numeric_limits<int>::max() );
+    VECTOR2I              maxPt( std::numeric_limits<int>::min(), std::numeric_limits<int>::min() );
+
+    for( const SHAPE_POLY_SET* part : aParts )
+    {
+        VECTOR2I centre = part->BBox().Centre();
+
+        minPt.x = std::min( minPt.x, centre.x );
+        minPt.y = std::min( minPt.y, centre.y );
+        maxPt.x = std::max( maxPt.x, centre.x );
+        maxPt.y = std::max( maxPt.y, centre.y );
+        centres.push_back( centre );
+    }
+
+    int64_t spanX = std::max<int64_t>( 1, (int64_t) maxPt.x - minPt.x );
+    int64_t spanY = std::max<int64_t>( 1, (int64_t) maxPt.y - minPt.y );
+
+    std::vector<std::pair<uint32_t, size_t>> order;
+
+    for( size_t ii = 0; ii < aParts.size(); ii++ )
+    {
+        uint32_t x = (uint32_t) ( ( (int64_t) centres[ii].x - minPt.x ) * 0xFFFF / spanX );
+        uint32_t y = (uint32_t) ( ( (int64_t) centres[ii].y - minPt.y ) * 0xFFFF / spanY );
+
+        order.emplace_back( mortonCode( x, y ), ii );
+    }
+
+    std::sort( order.begin(), order.end() );
+
+    // Group consecutive parts into leaves of about LEAF_VERTICES vertices
+    std::vector<std::vector<const SHAPE_POLY_SET*>> leaves( 1 );
+    int                                             leafVertices = 0;
+
+    for( const std::pair<uint32_t, size_t>& entry : order )
+    {
+        const SHAPE_POLY_SET* part = aParts[entry.second];
+
+        if( leafVertices >= LEAF_VERTICES )
+        {
+            leaves.emplace_back();
+            leafVertices = 0;
+        }
+
+        leaves.back().push_back( part );
+        leafVertices += part->TotalVertices();
+    }
+
+    std::vector<SHAPE_POLY_SET> level( leaves.size() );
+
+    parallelFor( leaves.size(),
+            [&]( size_t aLeaf )
+            {
+                level[aLeaf].unionOp( leaves[aLeaf], aFastMode );
+            } );
+
+    // Then merge the partial unions in pairs, which are still neighbours along the curve
+    while( level.size() > 1 )
+    {
+        std::vector<SHAPE_POLY_SET> next( ( level.size() + 1 ) / 2 );
+
+        parallelFor( next.size(),
+                [&]( size_t aPair )
+                {
+                    if( 2 * aPair + 1 < level.size() )
+                        next[aPair].unionOp( { &level[2 * aPair], &level[2 * aPair + 1] },
+                                             aFastMode );
+                    else
+                        next[aPair] = level[2 * aPair];
+                } );
+
+        level.swap( next );
+    }
+
+    *this = level[0];
+}
+
+
 int SHAPE_POLY_SET::NormalizeAreaOutlines()
 {
     // We are expecting only one main outline, but this main outline can have holes
@@ -1342,7 +1564,15 @@ void SHAPE_POLY_SET::DeletePolygon( int aIdx )
 
 void SHAPE_POLY_SET::Append( const SHAPE_POLY_SET& aSet )
 {
-    m_polys.insert( m_polys.end(), aSet.m_polys.begin(), aSet.m_polys.end() );
+    // Appending to an empty set is a copy, which can share the storage of aSet
+    if( m_polys.empty() && this != &aSet )
+    {
+        m_polys = aSet.m_polys;
+        return;
+    }
+
+    const POLYSET_STORAGE& polys = aSet.m_polys;
+    m_polys.insert( m_polys.end(), polys.begin(), polys.end() );
 }
 
 
@@ -1424,10 +1654,8 @@ void SHAPE_POLY_SET::BuildBBoxCaches()
 {
     for( int polygonIdx = 0; polygonIdx < OutlineCount(); polygonIdx++ )
     {
-        Outline( polygonIdx ).GenerateBBoxCache();
-
-        for( int holeIdx = 0; holeIdx < HoleCount( polygonIdx ); holeIdx++ )
-            Hole( polygonIdx, holeIdx ).GenerateBBoxCache();
+        for( SHAPE_LINE_CHAIN& contour : m_polys[polygonIdx] )
+            contour.GenerateBBoxCache();
     }
 }
 
@@ -1453,6 +1681,17 @@ bool SHAPE_POLY_SET::Contains( const VECTOR2I& aP, int aSubpolyIndex, int aAccur
 }
 
 
+std::shared_ptr<const POLY_SET_INDEX> SHAPE_POLY_SET::GetIndex() const
+{
+    std::shared_ptr<const POLY_SET_INDEX> index = m_polys.CachedIndex();
+
+    if( !index )
+        index = m_polys.CacheIndex( std::make_shared<POLY_SET_INDEX>( *this ) );
+
+    return index;
+}
+
+
 void SHAPE_POLY_SET::RemoveVertex( int aGlobalIndex )
 {
     VERTEX_INDEX index;
@@ -1934,23 +2173,56 @@ void SHAPE_POLY_SET::CacheTriangulation()
     m_triangulatedPolys.clear();
     m_triangulationValid = true;
 
+    // Large sets are worth triangulating in parallel; small ones are not worth the threads
+    const int PARALLEL_MIN_VERTICES = 10000;
+
     while( tmpSet.OutlineCount() > 0 )
     {
-        m_triangulatedPolys.push_back( std::make_unique<TRIANGULATED_POLYGON>() );
-        PolygonTriangulation tess( *m_triangulatedPolys.back() );
+        size_t                                             count = tmpSet.OutlineCount();
+        std::vector<std::shared_ptr<TRIANGULATED_POLYGON>> results( count );
+        std::vector<char>                                  succeeded( count );
 
-        // If the tesselation fails, we re-fracture the polygon, which will
-        // first simplify the system before fracturing and removing the holes
-        // This may result in multiple, disjoint polygons.
-        if( !tess.TesselatePolygon( tmpSet.Polygon( 0 ).front() ) )
+        auto tesselate =
+                [&]( size_t aIndex )
+                {
+                    results[aIndex] = std::make_shared<TRIANGULATED_POLYGON>();
+                    PolygonTriangulation tess( *results[aIndex] );
+
+                    succeeded[aIndex] = tess.TesselatePolygon( tmpSet.CPolygon( aIndex ).front() );
+                };
+
+        if( count > 1 && tmpSet.TotalVertices() >= PARALLEL_MIN_VERTICES )
+            parallelFor( count, tesselate );
+        else
         {
-            tmpSet.Fracture( PM_FAST );
-            m_triangulationValid = false;
-            continue;
+            for( size_t ii = 0; ii < count; ii++ )
+            {
+                tesselate( ii );
+
+                if( !succeeded[ii] )
+                    break;
+            }
         }
 
-        tmpSet.DeletePolygon( 0 );
-        m_triangulationValid = true;
+        size_t failed = 0;
+
+        while( failed < count && succeeded[failed] )
+            m_triangulatedPolys.push_back( results[failed++] );
+
+        if( failed == count )
+        {
+            m_triangulationValid = true;
+            break;
+        }
+
+        // If the tesselation fails, we re-fracture the remaining polygons, which will
+        // first simplify the system before fracturing and removing the holes
+        // This may result in multiple, disjoint polygons.
+        // (The failed triangulation is kept, as it always has been.)
+        m_triangulatedPolys.push_back( results[failed] );
+        tmpSet = tmpSet.Subset( failed, count );
+        tmpSet.Fracture( PM_FAST );
+        m_triangulationValid = false;
     }
 
     if( m_triangulationValid )
@@ -1958,6 +2230,62 @@ void SHAPE_POLY_SET::CacheTriangulation()
 }
 
 
+bool SHAPE_POLY_SET::SetTriangulation(
+        std::vector<std::unique_ptr<TRIANGULATED_POLYGON>>&& aTriangulation,
+        const std::string& aChecksum )
+{
+    MD5_HASH hash = checksum();
+
+    if( hash.Format() != aChecksum )
+        return false;
+
+    // Don't trust the indices of an external triangulation
+    for( const auto& tri_poly : aTriangulation )
+    {
+        int vertexCount = tri_poly->GetVertexCount();
+
+        for( size_t i = 0; i < tri_poly->GetTriangleCount(); i++ )
+        {
+            const TRIANGULATED_POLYGON::TRI& tri = tri_poly->GetTriangleIndices( i );
+
+            if( tri.a < 0 || tri.a >= vertexCount || tri.b < 0 || tri.b >= vertexCount
+                    || tri.c < 0 || tri.c >= vertexCount )
+            {
+                return false;
+            }
+        }
+    }
+
+    m_triangulatedPolys.clear();
+
+    for( auto& tri_poly : aTriangulation )
+        m_triangulatedPolys.push_back( std::move( tri_poly ) );
+
+    m_hash = hash;
+    m_triangulationValid = true;
+
+    return true;
+}
+
+
+bool SHAPE_POLY_SET::ShareTriangulation( const SHAPE_POLY_SET& aOther )
+{
+    if( !aOther.IsTriangulationUpToDate() )
+        return false;
+
+    MD5_HASH hash = checksum();
+
+    if( hash != aOther.m_hash )
+        return false;
+
+    m_triangulatedPolys = aOther.m_triangulatedPolys;
+    m_hash = hash;
+    m_triangulationValid = true;
+
+    return true;
+}
+
+
 MD5_HASH SHAPE_POLY_SET::checksum() const
 {
     MD5_HASH hash;
@@ -0,0 +1,308 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file simd_kernels.cpp
+ */
+
+#include <geometry/simd_kernels.h>
+
+// SSE2 is part of x86-64, so only AVX2 needs a runtime check.  The AVX2 kernels are built
+// with a target attribute (GCC and Clang) so that the rest of the file, and of KiCad, does
+// not require an AVX2 CPU.
+#if defined( __x86_64__ ) || defined( _M_X64 )
+#define KIGEOM_SSE2
+#include <emmintrin.h>
+
+#if defined( __GNUC__ ) || defined( __clang__ )
+#define KIGEOM_AVX2
+#define KIGEOM_TARGET_AVX2 __attribute__( ( target( "avx2" ) ) )
+#include <immintrin.h>
+#elif defined( _MSC_VER )
+#define KIGEOM_AVX2
+#define KIGEOM_TARGET_AVX2
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+#endif
+
+
+static uint32_t straddlingEdgesScalar( const int* aXY, int aY )
+{
+    uint32_t mask = 0;
+
+    for( int i = 0; i < SIMD_EDGE_BLOCK; i++ )
+    {
+        if( ( aXY[2 * i + 1] > aY ) != ( aXY[2 * i + 3] > aY ) )
+            mask |= 1 << i;
+    }
+
+    return mask;
+}
+
+
+static uint32_t edgesTouchingBoxScalar( const int* aXY, int aMinX, int aMinY, int aMaxX,
+                                        int aMaxY )
+{
+    uint32_t mask = 0;
+
+    for( int i = 0; i < SIMD_EDGE_BLOCK; i++ )
+    {
+        int ax = aXY[2 * i],     ay = aXY[2 * i + 1];
+        int bx = aXY[2 * i + 2], by = aXY[2 * i + 3];
+
+        if( ( ax < aMinX && bx < aMinX ) || ( ax > aMaxX && bx > aMaxX )
+                || ( ay < aMinY && by < aMinY ) || ( ay > aMaxY && by > aMaxY ) )
+            continue;
+
+        mask |= 1 << i;
+    }
+
+    return mask;
+}
+
+
+#ifdef KIGEOM_SSE2
+
+// The x and y coordinates of the 4 points at aXY
+static inline __m128i xCoords4( const int* aXY )
+{
+    __m128 lo = _mm_castsi128_ps( _mm_loadu_si128( (const __m128i*) aXY ) );
+    __m128 hi = _mm_castsi128_ps( _mm_loadu_si128( (const __m128i*) ( aXY + 4 ) ) );
+
+    return _mm_castps_si128( _mm_shuffle_ps( lo, hi, _MM_SHUFFLE( 2, 0, 2, 0 ) ) );
+}
+
+
+static inline __m128i yCoords4( const int* aXY )
+{
+    __m128 lo = _mm_castsi128_ps( _mm_loadu_si128( (const __m128i*) aXY ) );
+    __m128 hi = _mm_castsi128_ps( _mm_loadu_si128( (const __m128i*) ( aXY + 4 ) ) );
+
+    return _mm_castps_si128( _mm_shuffle_ps( lo, hi, _MM_SHUFFLE( 3, 1, 3, 1 ) ) );
+}
+
+
+static inline uint32_t straddlingEdges4SSE2( const int* aXY, __m128i aY )
+{
+    __m128i above1 = _mm_cmpgt_epi32( yCoords4( aXY ), aY );
+    __m128i above2 = _mm_cmpgt_epi32( yCoords4( aXY + 2 ), aY );
+
+    return _mm_movemask_ps( _mm_castsi128_ps( _mm_xor_si128( above1, above2 ) ) );
+}
+
+
+static uint32_t straddlingEdgesSSE2( const int* aXY, int aY )
+{
+    __m128i y = _mm_set1_epi32( aY );
+
+    return straddlingEdges4SSE2( aXY, y ) | ( straddlingEdges4SSE2( aXY + 8, y ) << 4 );
+}
+
+
+// An edge misses the box when both its ends are on the same outer side of one of the box edges
+static inline __m128i bothOutside( __m128i aA, __m128i aB, __m128i aMin, __m128i aMax )
+{
+    __m128i below = _mm_and_si128( _mm_cmplt_epi32( aA, aMin ), _mm_cmplt_epi32( aB, aMin ) );
+    __m128i above = _mm_and_si128( _mm_cmpgt_epi32( aA, aMax ), _mm_cmpgt_epi32( aB, aMax ) );
+
+    return _mm_or_si128( below, above );
+}
+
+
+static inline uint32_t edgesTouchingBox4SSE2( const int* aXY, __m128i aMinX, __m128i aMinY,
+                                              __m128i aMaxX, __m128i aMaxY )
+{
+    __m128i missX = bothOutside( xCoords4( aXY ), xCoords4( aXY + 2 ), aMinX, aMaxX );
+    __m128i missY = bothOutside( yCoords4( aXY ), yCoords4( aXY + 2 ), aMinY, aMaxY );
+
+    return ~_mm_movemask_ps( _mm_castsi128_ps( _mm_or_si128( missX, missY ) ) ) & 0xF;
+}
+
+
+static uint32_t edgesTouchingBoxSSE2( const int* aXY, int aMinX, int aMinY, int aMaxX,
+                                      int aMaxY )
+{
+    __m128i minX = _mm_set1_epi32( aMinX );
+    __m128i minY = _mm_set1_epi32( aMinY );
+    __m128i maxX = _mm_set1_epi32( aMaxX );
+    __m128i maxY = _mm_set1_epi32( aMaxY );
+
+    return edgesTouchingBox4SSE2( aXY, minX, minY, maxX, maxY )
+           | ( edgesTouchingBox4SSE2( aXY + 8, minX, minY, maxX, maxY ) << 4 );
+}
+
+#endif    // KIGEOM_SSE2
+
+
+#ifdef KIGEOM_AVX2
+
+// The x or y coordinates of the 8 points at aXY.  The in-lane shuffle leaves the 64 bit
+// quarters in the order 0, 2, 1, 3, which the permutation restores.
+KIGEOM_TARGET_AVX2 static inline __m256i coords8AVX2( const int* aXY, bool aY )
+{
+    __m256 lo = _mm256_castsi256_ps( _mm256_loadu_si256( (const __m256i*) aXY ) );
+    __m256 hi = _mm256_castsi256_ps( _mm256_loadu_si256( (const __m256i*) ( aXY + 8 ) ) );
+    __m256 c = aY ? _mm256_shuffle_ps( lo, hi, _MM_SHUFFLE( 3, 1, 3, 1 ) )
+                  : _mm256_shuffle_ps( lo, hi, _MM_SHUFFLE( 2, 0, 2, 0 ) );
+
+    return _mm256_permute4x64_epi64( _mm256_castps_si256( c ), _MM_SHUFFLE( 3, 1, 2, 0 ) );
+}
+
+
+KIGEOM_TARGET_AVX2 static uint32_t straddlingEdgesAVX2( const int* aXY, int aY )
+{
+    __m256i y = _mm256_set1_epi32( aY );
+    __m256i above1 = _mm256_cmpgt_epi32( coords8AVX2( aXY, true ), y );
+    __m256i above2 = _mm256_cmpgt_epi32( coords8AVX2( aXY + 2, true ), y );
+
+    return _mm256_movemask_ps( _mm256_castsi256_ps( _mm256_xor_si256( above1, above2 ) ) );
+}
+
+
+KIGEOM_TARGET_AVX2 static inline __m256i bothOutsideAVX2( __m256i aA, __m256i aB,
+                                                          __m256i aMin, __m256i aMax )
+{
+    __m256i below = _mm256_and_si256( _mm256_cmpgt_epi32( aMin, aA ),
+                                      _mm256_cmpgt_epi32( aMin, aB ) );
+    __m256i above = _mm256_and_si256( _mm256_cmpgt_epi32( aA, aMax ),
+                                      _mm256_cmpgt_epi32( aB, aMax ) );
+
+    return _mm256_or_si256( below, above );
+}
+
+
+KIGEOM_TARGET_AVX2 static uint32_t edgesTouchingBoxAVX2( const int* aXY, int aMinX, int aMinY,
+                                                         int aMaxX, int aMaxY )
+{
+    __m256i missX = bothOutsideAVX2( coords8AVX2( aXY, false ), coords8AVX2( aXY + 2, false ),
+                                     _mm256_set1_epi32( aMinX ), _mm256_set1_epi32( aMaxX ) );
+    __m256i missY = bothOutsideAVX2( coords8AVX2( aXY, true ), coords8AVX2( aXY + 2, true ),
+                                     _mm256_set1_epi32( aMinY ), _mm256_set1_epi32( aMaxY ) );
+
+    return ~_mm256_movemask_ps( _mm256_castsi256_ps( _mm256_or_si256( missX, missY ) ) ) & 0xFF;
+}
+
+
+static bool cpuHasAVX2()
+{
+#if defined( _MSC_VER ) && !defined( __clang__ )
+    int info[4];
+
+    __cpuid( info, 0 );
+
+    if( info[0] < 7 )
+        return false;
+
+    // The OS must save the AVX registers (OSXSAVE, and the XMM and YMM state in XCR0)
+    __cpuid( info, 1 );
+
+    if( !( info[2] & ( 1 << 27 ) ) || ( _xgetbv( 0 ) & 0x6 ) != 0x6 )
+        return false;
+
+    __cpuidex( info, 7, 0 );
+    return ( info[1] & ( 1 << 5 ) ) != 0;
+#else
+    return __builtin_cpu_supports( "avx2" );
+#endif
+}
+
+#endif    // KIGEOM_AVX2
+
+
+struct SIMD_KERNELS
+{
+    SIMD_LEVEL m_level;
+    uint32_t ( *m_straddlingEdges )( const int*, int );
+    uint32_t ( *m_edgesTouchingBox )( const int*, int, int, int, int );
+};
+
+
+static SIMD_LEVEL bestSimdLevel()
+{
+#if defined( KIGEOM_AVX2 )
+    if( cpuHasAVX2() )
+        return SIMD_LEVEL::AVX2;
+#endif
+
+#if defined( KIGEOM_SSE2 )
+    return SIMD_LEVEL::SSE2;
+#else
+    return SIMD_LEVEL::SCALAR;
+#endif
+}
+
+
+static SIMD_KERNELS makeKernels( SIMD_LEVEL aLevel )
+{
+    switch( aLevel )
+    {
+#ifdef KIGEOM_AVX2
+    case SIMD_LEVEL::AVX2:
+        return { aLevel, straddlingEdgesAVX2, edgesTouchingBoxAVX2 };
+#endif
+#ifdef KIGEOM_SSE2
+    case SIMD_LEVEL::SSE2:
+        return { aLevel, straddlingEdgesSSE2, edgesTouchingBoxSSE2 };
+#endif
+    default:
+        return { SIMD_LEVEL::SCALAR, straddlingEdgesScalar, edgesTouchingBoxScalar };
+    }
+}
+
+
+static SIMD_KERNELS& kernels()
+{
+    static SIMD_KERNELS s_kernels = makeKernels( bestSimdLevel() );
+
+    return s_kernels;
+}
+
+
+SIMD_LEVEL GetSimdLevel()
+{
+    return kernels().m_level;
+}
+
+
+SIMD_LEVEL SetSimdLevel( SIMD_LEVEL aLevel )
+{
+    if( aLevel > bestSimdLevel() )
+        aLevel = bestSimdLevel();
+
+    kernels() = makeKernels( aLevel );
+
+    return kernels().m_level;
+}
+
+
+uint32_t StraddlingEdges( const int* aXY, int aY )
+{
+    return kernels().m_straddlingEdges( aXY, aY );
+}
+
+
+uint32_t EdgesTouchingBox( const int* aXY, int aMinX, int aMinY, int aMaxX, int aMaxY )
+{
+    return kernels().m_edgesTouchingBox( aXY, aMinX, aMinY, aMaxX, aMaxY );
+}
@@ -102,16 +102,15 @@ std::string MD5_HASH::Format()
         char lsb = ( m_hash[ii] & 0x0F ) + '0';
 
         if( lsb > '9' )
-            lsb += 'A'-'9';
+            lsb += 'A' - '9' - 1;
 
         char msb = ( ( m_hash[ii] >> 4 ) & 0x0F ) + '0';
 
         if( msb > '9' )
-            msb += 'A'-'9';
+            msb += 'A' - '9' - 1;
 
          data += msb;
          data += lsb;
-         data += ' ';
     }
 
     return data;
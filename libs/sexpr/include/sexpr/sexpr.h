@@ -41,10 +41,16 @@ namespace SEXPR
 
     typedef std::vector< class SEXPR * > SEXPR_VECTOR;
 
+    class SEXPR_ARENA;
+
     class SEXPR
     {
+        friend class SEXPR_ARENA;
+        friend class SEXPR_LIST;
+
     protected:
         SEXPR_TYPE m_type;
+        bool m_inArena;     ///< owned by a SEXPR_ARENA, which frees it
         SEXPR( SEXPR_TYPE aType, size_t aLineNumber );
         SEXPR( SEXPR_TYPE aType );
         size_t m_lineNumber;
@@ -106,13 +112,20 @@ namespace SEXPR
 
     struct SEXPR_SYMBOL : public SEXPR
     {
-        std::string m_value;
+        std::string m_value;            ///< empty for an interned symbol: use GetSymbol()
+        const std::string* m_interned;  ///< the string of a SEXPR_ARENA, or nullptr
 
         SEXPR_SYMBOL( std::string aValue ) :
-            SEXPR( SEXPR_TYPE::SEXPR_TYPE_ATOM_SYMBOL ), m_value( aValue ) {};
+            SEXPR( SEXPR_TYPE::SEXPR_TYPE_ATOM_SYMBOL ), m_value( aValue ),
+            m_interned( nullptr ) {};
 
         SEXPR_SYMBOL( std::string aValue, int aLineNumber ) :
-            SEXPR( SEXPR_TYPE::SEXPR_TYPE_ATOM_SYMBOL, aLineNumber ), m_value( aValue ) {};
+            SEXPR( SEXPR_TYPE::SEXPR_TYPE_ATOM_SYMBOL, aLineNumber ), m_value( aValue ),
+            m_interned( nullptr ) {};
+
+        SEXPR_SYMBOL( const std::string* aInterned, int aLineNumber ) :
+            SEXPR( SEXPR_TYPE::SEXPR_TYPE_ATOM_SYMBOL, aLineNumber ),
+            m_interned( aInterned ) {};
     };
 
     struct _OUT_STRING
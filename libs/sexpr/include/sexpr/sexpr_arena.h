@@ -0,0 +1,93 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SEXPR_ARENA_H_
+#define SEXPR_ARENA_H_
+
+#include "sexpr/sexpr.h"
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+
+namespace SEXPR
+{
+    /**
+     * SEXPR_ARENA
+     * Owns the nodes of s-expression trees, which are allocated in large blocks and all
+     * freed at once with the arena.  The symbols are interned: a symbol seen many times in a
+     * file is stored once.
+     *
+     * The nodes of an arena must not be deleted: the lists they belong to leave them to the
+     * arena.  Not thread safe.
+     */
+    class SEXPR_ARENA
+    {
+    public:
+        SEXPR_ARENA();
+        ~SEXPR_ARENA();
+
+        SEXPR_ARENA( const SEXPR_ARENA& ) = delete;
+        SEXPR_ARENA& operator=( const SEXPR_ARENA& ) = delete;
+
+        /**
+         * Build a node in the arena, which owns it.
+         */
+        template <typename T, typename... Args>
+        T* Create( Args&&... aArgs )
+        {
+            void* mem = allocate( sizeof( T ), alignof( T ) );
+            T*    node = new( mem ) T( std::forward<Args>( aArgs )... );
+
+            static_cast<SEXPR*>( node )->m_inArena = true;
+            m_nodes.push_back( node );
+
+            return node;
+        }
+
+        /**
+         * @return the string of the arena equal to \a aSymbol, valid as long as the arena.
+         */
+        const std::string* Intern( const std::string& aSymbol );
+
+        /**
+         * Free all the nodes and interned strings of the arena.
+         */
+        void Clear();
+
+        size_t GetNodeCount() const { return m_nodes.size(); }
+
+    private:
+        void* allocate( size_t aSize, size_t aAlign );
+
+        static constexpr size_t BLOCK_SIZE = 64 * 1024;
+
+        std::vector<std::unique_ptr<char[]>> m_blocks;
+        size_t                               m_blockUsed;   ///< bytes used in the last block
+        std::vector<SEXPR*>                  m_nodes;       ///< to run their destructors
+        std::unordered_set<std::string>      m_symbols;
+    };
+}
+
+#endif
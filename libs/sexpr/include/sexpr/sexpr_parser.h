@@ -19,6 +19,7 @@
 #define SEXPR_PARSER_H_
 
 #include "sexpr/sexpr.h"
+#include "sexpr/sexpr_arena.h"
 
 #include <memory>
 #include <string>
@@ -34,13 +35,37 @@ namespace SEXPR
         ~PARSER();
         std::unique_ptr<SEXPR> Parse( const std::string& aString );
         std::unique_ptr<SEXPR> ParseFromFile( const std::string& aFilename );
+
+        /**
+         * Parse in an arena: the nodes are allocated in \a aArena, which frees them all at
+         * once, and the symbols are interned.  Much faster than the other modes on large files.
+         *
+         * @return the root node, owned by \a aArena (not to be deleted), or nullptr.
+         */
+        SEXPR* Parse( const std::string& aString, SEXPR_ARENA& aArena );
+        SEXPR* ParseFromFile( const std::string& aFilename, SEXPR_ARENA& aArena );
+
         static std::string GetFileContents( const std::string &aFilename );
 
     private:
-        std::unique_ptr<SEXPR> parseString(
-                const std::string& aString, std::string::const_iterator& it );
+        /**
+         * @param aArena the arena of the nodes, or nullptr to allocate them on the heap.
+         */
+        SEXPR* parseString( const std::string& aString, std::string::const_iterator& it,
+                            SEXPR_ARENA* aArena );
+
+        template <typename T, typename... Args>
+        T* newNode( SEXPR_ARENA* aArena, Args&&... aArgs )
+        {
+            if( aArena )
+                return aArena->Create<T>( std::forward<Args>( aArgs )... );
+
+            return new T( std::forward<Args>( aArgs )... );
+        }
+
         static const std::string whitespaceCharacters;
         int m_lineNumber;
+        SEXPR_VECTOR m_children;    ///< children of the lists being parsed in an arena
     };
 }
 
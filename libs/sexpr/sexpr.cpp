@@ -26,12 +26,12 @@
 namespace SEXPR
 {
     SEXPR::SEXPR( SEXPR_TYPE aType, size_t aLineNumber ) :
-        m_type( aType ), m_lineNumber( aLineNumber )
+        m_type( aType ), m_inArena( false ), m_lineNumber( aLineNumber )
     {
     }
 
     SEXPR::SEXPR(SEXPR_TYPE aType) :
-        m_type( aType ), m_lineNumber( 1 )
+        m_type( aType ), m_inArena( false ), m_lineNumber( 1 )
     {
     }
 
@@ -134,7 +134,9 @@ namespace SEXPR
             throw INVALID_TYPE_EXCEPTION( err_msg );
         }
 
-        return static_cast< SEXPR_SYMBOL const * >(this)->m_value;
+        SEXPR_SYMBOL const * symbol = static_cast< SEXPR_SYMBOL const * >( this );
+
+        return symbol->m_interned ? *symbol->m_interned : symbol->m_value;
     }
 
 
@@ -204,9 +206,11 @@ namespace SEXPR
 
     SEXPR_LIST::~SEXPR_LIST()
     {
+        // The nodes of an arena are freed with the arena
         for( auto child : m_children )
         {
-            delete child;
+            if( !child->m_inArena )
+                delete child;
         }
 
         m_children.clear();
@@ -0,0 +1,64 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "sexpr/sexpr_arena.h"
+
+namespace SEXPR
+{
+    SEXPR_ARENA::SEXPR_ARENA() : m_blockUsed( BLOCK_SIZE )
+    {
+    }
+
+    SEXPR_ARENA::~SEXPR_ARENA()
+    {
+        Clear();
+    }
+
+    const std::string* SEXPR_ARENA::Intern( const std::string& aSymbol )
+    {
+        return &*m_symbols.insert( aSymbol ).first;
+    }
+
+    void SEXPR_ARENA::Clear()
+    {
+        // The lists do not delete the children of the arena, so the order does not matter
+        for( SEXPR* node : m_nodes )
+            node->~SEXPR();
+
+        m_nodes.clear();
+        m_blocks.clear();
+        m_blockUsed = BLOCK_SIZE;
+        m_symbols.clear();
+    }
+
+    void* SEXPR_ARENA::allocate( size_t aSize, size_t aAlign )
+    {
+        size_t offset = ( m_blockUsed + aAlign - 1 ) & ~( aAlign - 1 );
+
+        if( offset + aSize > BLOCK_SIZE )
+        {
+            m_blocks.emplace_back( new char[BLOCK_SIZE] );
+            offset = 0;
+        }
+
+        m_blockUsed = offset + aSize;
+
+        return m_blocks.back().get() + offset;
+    }
+}
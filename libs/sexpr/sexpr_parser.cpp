@@ -44,7 +44,7 @@ namespace SEXPR
     std::unique_ptr<SEXPR> PARSER::Parse( const std::string& aString )
     {
         std::string::const_iterator it = aString.begin();
-        return parseString( aString, it );
+        return std::unique_ptr<SEXPR>( parseString( aString, it, nullptr ) );
     }
 
     std::unique_ptr<SEXPR> PARSER::ParseFromFile( const std::string& aFileName )
@@ -52,7 +52,24 @@ namespace SEXPR
         std::string str = GetFileContents( aFileName );
 
         std::string::const_iterator it = str.begin();
-        return parseString( str, it );
+        return std::unique_ptr<SEXPR>( parseString( str, it, nullptr ) );
+    }
+
+    SEXPR* PARSER::Parse( const std::string& aString, SEXPR_ARENA& aArena )
+    {
+        std::string::const_iterator it = aString.begin();
+
+        // A previous parse may have thrown halfway
+        m_children.clear();
+
+        return parseString( aString, it, &aArena );
+    }
+
+    SEXPR* PARSER::ParseFromFile( const std::string& aFileName, SEXPR_ARENA& aArena )
+    {
+        std::string str = GetFileContents( aFileName );
+
+        return Parse( str, aArena );
     }
 
     std::string PARSER::GetFileContents( const std::string &aFileName )
@@ -77,8 +94,8 @@ namespace SEXPR
         return str;
     }
 
-    std::unique_ptr<SEXPR> PARSER::parseString(
-            const std::string& aString, std::string::const_iterator& it )
+    SEXPR* PARSER::parseString( const std::string& aString, std::string::const_iterator& it,
+                                SEXPR_ARENA* aArena )
     {
         for( ; it != aString.end(); ++it )
         {
@@ -92,7 +109,13 @@ namespace SEXPR
             {
                 std::advance( it, 1 );
 
-                auto list = std::make_unique<SEXPR_LIST>( m_lineNumber );
+                SEXPR_LIST* list = newNode<SEXPR_LIST>( aArena, m_lineNumber );
+
+                // The heap nodes are freed on errors by their parents
+                std::unique_ptr<SEXPR_LIST> owner( aArena ? nullptr : list );
+
+                // The children of an arena list are gathered first, to size its vector once
+                size_t firstChild = m_children.size();
 
                 while( it != aString.end() && *it != ')' )
                 {
@@ -106,13 +129,24 @@ namespace SEXPR
                         continue;
                     }
 
-                    std::unique_ptr<SEXPR> item = parseString( aString, it );
-                    list->AddChild( item.release() );
+                    SEXPR* item = parseString( aString, it, aArena );
+
+                    if( aArena )
+                        m_children.push_back( item );
+                    else
+                        list->AddChild( item );
+                }
+
+                if( aArena )
+                {
+                    list->m_children.assign( m_children.begin() + firstChild, m_children.end() );
+                    m_children.resize( firstChild );
                 }
 
                 if( it != aString.end() )
                     std::advance( it, 1 );
 
+                owner.release();
                 return list;
             }
             else if( *it == ')' )
@@ -134,7 +168,7 @@ namespace SEXPR
 
                 if( closingPos != std::string::npos )
                 {
-                    auto str = std::make_unique<SEXPR_STRING>(
+                    SEXPR* str = newNode<SEXPR_STRING>( aArena,
                             aString.substr( startPos, closingPos - startPos ), m_lineNumber );
                     std::advance( it, closingPos - startPos + 2 );
 
@@ -159,18 +193,18 @@ namespace SEXPR
                         ( tmp.size() > 1 && tmp[0] == '-'
                           && tmp.find_first_not_of( "0123456789.", 1 ) == std::string::npos ) )
                     {
-                        std::unique_ptr<SEXPR> res;
+                        SEXPR* res;
 
                         if( tmp.find( '.' ) != std::string::npos )
                         {
-                            res = std::make_unique<SEXPR_DOUBLE>(
-                                    strtod( tmp.c_str(), nullptr ), m_lineNumber );
+                            res = newNode<SEXPR_DOUBLE>(
+                                    aArena, strtod( tmp.c_str(), nullptr ), m_lineNumber );
                             //floating point type
                         }
                         else
                         {
-                            res = std::make_unique<SEXPR_INTEGER>(
-                                    strtoll( tmp.c_str(), nullptr, 0 ), m_lineNumber );
+                            res = newNode<SEXPR_INTEGER>( aArena,
+                                    (int64_t) strtoll( tmp.c_str(), nullptr, 0 ), m_lineNumber );
                         }
 
                         std::advance( it, closingPos - startPos );
@@ -178,7 +212,14 @@ namespace SEXPR
                     }
                     else
                     {
-                        auto str = std::make_unique<SEXPR_SYMBOL>( tmp, m_lineNumber );
+                        SEXPR* str;
+
+                        if( aArena )
+                            str = aArena->Create<SEXPR_SYMBOL>( aArena->Intern( tmp ),
+                                                                m_lineNumber );
+                        else
+                            str = new SEXPR_SYMBOL( tmp, m_lineNumber );
+
                         std::advance( it, closingPos - startPos );
 
                         return str;
@@ -39,6 +39,7 @@
 #include <compoundfilereader.h>
 #include <convert_basic_shapes_to_polygon.h>
 #include <project.h>
+#include <thread_pool.h>
 #include <trigo.h>
 #include <utf.h>
 #include <wx/docview.h>
@@ -339,9 +340,113 @@ ALTIUM_PCB::~ALTIUM_PCB()
 {
 }
 
+/**
+ * Decode all the records of a binary stream.  Does not throw: the error is kept in \a aRecords.
+ */
+template <typename RECORD, typename... ARGS>
+static void decodeRecords( ALTIUM_RECORDS<RECORD>& aRecords, const CFB::CompoundFileReader& aReader,
+        const CFB::COMPOUND_FILE_ENTRY* aEntry, const char* aStreamName, ARGS... aArgs )
+{
+    aRecords.m_decoded = true;
+
+    try
+    {
+        ALTIUM_PARSER reader( aReader, aEntry );
+
+        while( reader.GetRemainingBytes() >= 4 /* TODO: use Header section of file */ )
+            aRecords.m_records.emplace_back( reader, aArgs... );
+
+        if( reader.GetRemainingBytes() != 0 )
+            THROW_IO_ERROR( wxString::Format( "%s stream is not fully parsed", aStreamName ) );
+    }
+    catch( ... )
+    {
+        aRecords.m_error = std::current_exception();
+    }
+}
+
+
+/**
+ * @return the records of a binary stream, decoded now if they were not already.  Throws the
+ * decoding error of the stream, if any.
+ */
+template <typename RECORD, typename... ARGS>
+static std::vector<RECORD> takeRecords( ALTIUM_RECORDS<RECORD>& aRecords,
+        const CFB::CompoundFileReader& aReader, const CFB::COMPOUND_FILE_ENTRY* aEntry,
+        const char* aStreamName, ARGS... aArgs )
+{
+    if( !aRecords.m_decoded )
+        decodeRecords( aRecords, aReader, aEntry, aStreamName, aArgs... );
+
+    if( aRecords.m_error )
+        std::rethrow_exception( aRecords.m_error );
+
+    return std::move( aRecords.m_records );
+}
+
+
+void ALTIUM_PCB::DecodeStreams( const CFB::CompoundFileReader& aReader,
+        const std::map<ALTIUM_PCB_DIR, std::string>&           aFileMapping )
+{
+    TASK_GROUP decoders;
+
+    auto decode = [&]( ALTIUM_PCB_DIR aDirectory,
+                          std::function<void( const CFB::COMPOUND_FILE_ENTRY* )> aDecoder )
+    {
+        const auto& mappedDirectory = aFileMapping.find( aDirectory );
+
+        if( mappedDirectory == aFileMapping.end() )
+            return;
+
+        const CFB::COMPOUND_FILE_ENTRY* file =
+                FindStream( aReader, mappedDirectory->second.c_str() );
+
+        // A missing stream is reported by Parse()
+        if( file != nullptr )
+            decoders.Run( [aDecoder, file]() { aDecoder( file ); } );
+    };
+
+    decode( ALTIUM_PCB_DIR::ARCS6, [&]( const CFB::COMPOUND_FILE_ENTRY* aEntry ) {
+        decodeRecords( m_arcs, aReader, aEntry, "Arcs6" );
+    } );
+    decode( ALTIUM_PCB_DIR::COMPONENTBODIES6, [&]( const CFB::COMPOUND_FILE_ENTRY* aEntry ) {
+        decodeRecords( m_componentBodies, aReader, aEntry, "ComponentsBodies6" );
+    } );
+    decode( ALTIUM_PCB_DIR::PADS6, [&]( const CFB::COMPOUND_FILE_ENTRY* aEntry ) {
+        decodeRecords( m_pads, aReader, aEntry, "Pads6" );
+    } );
+    decode( ALTIUM_PCB_DIR::VIAS6, [&]( const CFB::COMPOUND_FILE_ENTRY* aEntry ) {
+        decodeRecords( m_vias, aReader, aEntry, "Vias6" );
+    } );
+    decode( ALTIUM_PCB_DIR::TRACKS6, [&]( const CFB::COMPOUND_FILE_ENTRY* aEntry ) {
+        decodeRecords( m_tracks, aReader, aEntry, "Tracks6" );
+    } );
+    decode( ALTIUM_PCB_DIR::TEXTS6, [&]( const CFB::COMPOUND_FILE_ENTRY* aEntry ) {
+        decodeRecords( m_texts, aReader, aEntry, "Texts6" );
+    } );
+    decode( ALTIUM_PCB_DIR::FILLS6, [&]( const CFB::COMPOUND_FILE_ENTRY* aEntry ) {
+        decodeRecords( m_fills, aReader, aEntry, "Fills6" );
+    } );
+    decode( ALTIUM_PCB_DIR::BOARDREGIONS, [&]( const CFB::COMPOUND_FILE_ENTRY* aEntry ) {
+        decodeRecords( m_boardRegions, aReader, aEntry, "BoardRegions", false );
+    } );
+    decode( ALTIUM_PCB_DIR::SHAPEBASEDREGIONS6, [&]( const CFB::COMPOUND_FILE_ENTRY* aEntry ) {
+        decodeRecords( m_shapeBasedRegions, aReader, aEntry, "ShapeBasedRegions6", true );
+    } );
+    decode( ALTIUM_PCB_DIR::REGIONS6, [&]( const CFB::COMPOUND_FILE_ENTRY* aEntry ) {
+        decodeRecords( m_regions, aReader, aEntry, "Regions6", false );
+    } );
+
+    // The errors are thrown when the records are used, so they come in the order of Parse()
+    decoders.Wait();
+}
+
+
 void ALTIUM_PCB::Parse( const CFB::CompoundFileReader& aReader,
         const std::map<ALTIUM_PCB_DIR, std::string>&   aFileMapping )
 {
+    DecodeStreams( aReader, aFileMapping );
+
     // this vector simply declares in which order which functions to call.
     const std::vector<std::tuple<bool, ALTIUM_PCB_DIR, PARSE_FUNCTION_POINTER_fp>> parserOrder = {
         { true, ALTIUM_PCB_DIR::FILE_HEADER,
@@ -826,11 +931,10 @@ void ALTIUM_PCB::ParseComponents6Data(
 void ALTIUM_PCB::ParseComponentsBodies6Data(
         const CFB::CompoundFileReader& aReader, const CFB::COMPOUND_FILE_ENTRY* aEntry )
 {
-    ALTIUM_PARSER reader( aReader, aEntry );
-
-    while( reader.GetRemainingBytes() >= 4 /* TODO: use Header section of file */ )
+    for( const ACOMPONENTBODY6& elem :
+            takeRecords( m_componentBodies, aReader, aEntry, "ComponentsBodies6" ) )
     {
-        ACOMPONENTBODY6 elem( reader ); // TODO: implement
+        // TODO: implement
 
         if( elem.component == ALTIUM_COMPONENT_NONE )
         {
@@ -887,11 +991,6 @@ void ALTIUM_PCB::ParseComponentsBodies6Data(
 
         module->Models().push_back( modelSettings );
     }
-
-    if( reader.GetRemainingBytes() != 0 )
-    {
-        THROW_IO_ERROR( "ComponentsBodies6 stream is not fully parsed" );
-    }
 }
 
 
@@ -1392,29 +1491,16 @@ void ALTIUM_PCB::ParseRules6Data(
 void ALTIUM_PCB::ParseBoardRegionsData(
         const CFB::CompoundFileReader& aReader, const CFB::COMPOUND_FILE_ENTRY* aEntry )
 {
-    ALTIUM_PARSER reader( aReader, aEntry );
-
-    while( reader.GetRemainingBytes() >= 4 /* TODO: use Header section of file */ )
-    {
-        AREGION6 elem( reader, false );
-
-        // TODO: implement?
-    }
-
-    if( reader.GetRemainingBytes() != 0 )
-    {
-        THROW_IO_ERROR( "BoardRegions stream is not fully parsed" );
-    }
+    // TODO: implement? The records are only checked for now
+    takeRecords( m_boardRegions, aReader, aEntry, "BoardRegions", false );
 }
 
 void ALTIUM_PCB::ParseShapeBasedRegions6Data(
         const CFB::CompoundFileReader& aReader, const CFB::COMPOUND_FILE_ENTRY* aEntry )
 {
-    ALTIUM_PARSER reader( aReader, aEntry );
-
-    while( reader.GetRemainingBytes() >= 4 /* TODO: use Header section of file */ )
+    for( const AREGION6& elem :
+            takeRecords( m_shapeBasedRegions, aReader, aEntry, "ShapeBasedRegions6", true ) )
     {
-        AREGION6 elem( reader, true );
 
         if( elem.kind == ALTIUM_REGION_KIND::BOARD_CUTOUT )
         {
@@ -1494,18 +1580,11 @@ void ALTIUM_PCB::ParseShapeBasedRegions6Data(
                     elem.kind, LSET::Name( GetKicadLayer( elem.layer ) ) ) );
         }
     }
-
-    if( reader.GetRemainingBytes() != 0 )
-    {
-        THROW_IO_ERROR( "ShapeBasedRegions6 stream is not fully parsed" );
-    }
 }
 
 void ALTIUM_PCB::ParseRegions6Data(
         const CFB::CompoundFileReader& aReader, const CFB::COMPOUND_FILE_ENTRY* aEntry )
 {
-    ALTIUM_PARSER reader( aReader, aEntry );
-
     for( ZONE_CONTAINER* zone : m_polygons )
     {
         if( zone != nullptr )
@@ -1514,9 +1593,8 @@ void ALTIUM_PCB::ParseRegions6Data(
         }
     }
 
-    while( reader.GetRemainingBytes() >= 4 /* TODO: use Header section of file */ )
+    for( const AREGION6& elem : takeRecords( m_regions, aReader, aEntry, "Regions6", false ) )
     {
-        AREGION6 elem( reader, false );
 
 #if 0 // TODO: it seems this code has multiple issues right now, and we can manually fill anyways
         if( elem.subpolyindex != ALTIUM_POLYGON_NONE )
@@ -1552,21 +1630,13 @@ void ALTIUM_PCB::ParseRegions6Data(
         }
 #endif
     }
-
-    if( reader.GetRemainingBytes() != 0 )
-    {
-        THROW_IO_ERROR( "Regions6 stream is not fully parsed" );
-    }
 }
 
 void ALTIUM_PCB::ParseArcs6Data(
         const CFB::CompoundFileReader& aReader, const CFB::COMPOUND_FILE_ENTRY* aEntry )
 {
-    ALTIUM_PARSER reader( aReader, aEntry );
-
-    while( reader.GetRemainingBytes() >= 4 /* TODO: use Header section of file */ )
+    for( const AARC6& elem : takeRecords( m_arcs, aReader, aEntry, "Arcs6" ) )
     {
-        AARC6 elem( reader );
 
         if( elem.is_polygonoutline || elem.subpolyindex != ALTIUM_POLYGON_NONE )
         {
@@ -1670,21 +1740,13 @@ void ALTIUM_PCB::ParseArcs6Data(
             HelperDrawsegmentSetLocalCoord( ds, elem.component );
         }
     }
-
-    if( reader.GetRemainingBytes() != 0 )
-    {
-        THROW_IO_ERROR( "Arcs6 stream is not fully parsed" );
-    }
 }
 
 void ALTIUM_PCB::ParsePads6Data(
         const CFB::CompoundFileReader& aReader, const CFB::COMPOUND_FILE_ENTRY* aEntry )
 {
-    ALTIUM_PARSER reader( aReader, aEntry );
-
-    while( reader.GetRemainingBytes() >= 4 /* TODO: use Header section of file */ )
+    for( const APAD6& elem : takeRecords( m_pads, aReader, aEntry, "Pads6" ) )
     {
-        APAD6 elem( reader );
 
         // It is possible to place altium pads on non-copper layers -> we need to interpolate them using drawings!
         if( !IsAltiumLayerCopper( elem.layer ) && !IsAltiumLayerAPlane( elem.layer )
@@ -1883,11 +1945,6 @@ void ALTIUM_PCB::ParsePads6Data(
             pad->SetLayerSet( pad->GetLayerSet().reset( B_Mask ) );
         }
     }
-
-    if( reader.GetRemainingBytes() != 0 )
-    {
-        THROW_IO_ERROR( "Pads6 stream is not fully parsed" );
-    }
 }
 
 void ALTIUM_PCB::HelperParsePad6NonCopper( const APAD6& aElem )
@@ -2076,11 +2133,8 @@ void ALTIUM_PCB::HelperParsePad6NonCopper( const APAD6& aElem )
 void ALTIUM_PCB::ParseVias6Data(
         const CFB::CompoundFileReader& aReader, const CFB::COMPOUND_FILE_ENTRY* aEntry )
 {
-    ALTIUM_PARSER reader( aReader, aEntry );
-
-    while( reader.GetRemainingBytes() >= 4 /* TODO: use Header section of file */ )
+    for( const AVIA6& elem : takeRecords( m_vias, aReader, aEntry, "Vias6" ) )
     {
-        AVIA6 elem( reader );
 
         VIA* via = new VIA( m_board );
         m_board->Add( via, ADD_MODE::APPEND );
@@ -2121,21 +2175,13 @@ void ALTIUM_PCB::ParseVias6Data(
         // we need VIATYPE set!
         via->SetLayerPair( start_klayer, end_klayer );
     }
-
-    if( reader.GetRemainingBytes() != 0 )
-    {
-        THROW_IO_ERROR( "Vias6 stream is not fully parsed" );
-    }
 }
 
 void ALTIUM_PCB::ParseTracks6Data(
         const CFB::CompoundFileReader& aReader, const CFB::COMPOUND_FILE_ENTRY* aEntry )
 {
-    ALTIUM_PARSER reader( aReader, aEntry );
-
-    while( reader.GetRemainingBytes() >= 4 /* TODO: use Header section of file */ )
+    for( const ATRACK6& elem : takeRecords( m_tracks, aReader, aEntry, "Tracks6" ) )
     {
-        ATRACK6 elem( reader );
 
         if( elem.is_polygonoutline || elem.subpolyindex != ALTIUM_POLYGON_NONE )
         {
@@ -2203,24 +2249,14 @@ void ALTIUM_PCB::ParseTracks6Data(
             ds->SetLayer( klayer );
             HelperDrawsegmentSetLocalCoord( ds, elem.component );
         }
-
-        reader.SkipSubrecord();
-    }
-
-    if( reader.GetRemainingBytes() != 0 )
-    {
-        THROW_IO_ERROR( "Tracks6 stream is not fully parsed" );
     }
 }
 
 void ALTIUM_PCB::ParseTexts6Data(
         const CFB::CompoundFileReader& aReader, const CFB::COMPOUND_FILE_ENTRY* aEntry )
 {
-    ALTIUM_PARSER reader( aReader, aEntry );
-
-    while( reader.GetRemainingBytes() >= 4 /* TODO: use Header section of file */ )
+    for( const ATEXT6& elem : takeRecords( m_texts, aReader, aEntry, "Texts6" ) )
     {
-        ATEXT6 elem( reader );
 
         if( elem.fonttype == ALTIUM_TEXT_TYPE::BARCODE )
         {
@@ -2379,21 +2415,13 @@ void ALTIUM_PCB::ParseTexts6Data(
             }
         }
     }
-
-    if( reader.GetRemainingBytes() != 0 )
-    {
-        THROW_IO_ERROR( "Texts6 stream is not fully parsed" );
-    }
 }
 
 void ALTIUM_PCB::ParseFills6Data(
         const CFB::CompoundFileReader& aReader, const CFB::COMPOUND_FILE_ENTRY* aEntry )
 {
-    ALTIUM_PARSER reader( aReader, aEntry );
-
-    while( reader.GetRemainingBytes() >= 4 /* TODO: use Header section of file */ )
+    for( const AFILL6& elem : takeRecords( m_fills, aReader, aEntry, "Fills6" ) )
     {
-        AFILL6 elem( reader );
 
         wxPoint p11( elem.pos1.x, elem.pos1.y );
         wxPoint p12( elem.pos1.x, elem.pos2.y );
@@ -2466,9 +2494,4 @@ void ALTIUM_PCB::ParseFills6Data(
             }
         }
     }
-
-    if( reader.GetRemainingBytes() != 0 )
-    {
-        THROW_IO_ERROR( "Fills6 stream is not fully parsed" );
-    }
 }
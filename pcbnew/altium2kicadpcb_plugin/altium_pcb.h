@@ -24,6 +24,7 @@
 #ifndef ALTIUM_PCB_H
 #define ALTIUM_PCB_H
 
+#include <exception>
 #include <functional>
 #include <layers_id_colors_and_visibility.h>
 #include <vector>
@@ -111,6 +112,18 @@ typedef std::function<void( const CFB::CompoundFileReader&, const CFB::COMPOUND_
         PARSE_FUNCTION_POINTER_fp;
 
 
+/**
+ * The records of a binary stream, decoded before the board items are built.
+ */
+template <typename RECORD>
+struct ALTIUM_RECORDS
+{
+    std::vector<RECORD> m_records;
+    std::exception_ptr  m_error;           ///< the decoding error, thrown when the records are used
+    bool                m_decoded = false;
+};
+
+
 class ALTIUM_PCB
 {
 public:
@@ -126,6 +139,13 @@ private:
     const ARULE6* GetRule( ALTIUM_RULE_KIND aKind, const wxString& aName ) const;
     const ARULE6* GetRuleDefault( ALTIUM_RULE_KIND aKind ) const;
 
+    /**
+     * Decode the records of the binary streams concurrently.  They do not depend on each other,
+     * nor on the board: the board items are built from them afterwards, in the usual order.
+     */
+    void DecodeStreams( const CFB::CompoundFileReader&   aReader,
+            const std::map<ALTIUM_PCB_DIR, std::string>& aFileMapping );
+
     void ParseFileHeader(
             const CFB::CompoundFileReader& aReader, const CFB::COMPOUND_FILE_ENTRY* aEntry );
 
@@ -192,6 +212,17 @@ private:
 
     std::map<ALTIUM_LAYER, ZONE_CONTAINER*> m_outer_plane;
 
+    ALTIUM_RECORDS<AARC6>           m_arcs;
+    ALTIUM_RECORDS<ACOMPONENTBODY6> m_componentBodies;
+    ALTIUM_RECORDS<APAD6>           m_pads;
+    ALTIUM_RECORDS<AVIA6>           m_vias;
+    ALTIUM_RECORDS<ATRACK6>         m_tracks;
+    ALTIUM_RECORDS<ATEXT6>          m_texts;
+    ALTIUM_RECORDS<AFILL6>          m_fills;
+    ALTIUM_RECORDS<AREGION6>        m_boardRegions;
+    ALTIUM_RECORDS<AREGION6>        m_shapeBasedRegions;
+    ALTIUM_RECORDS<AREGION6>        m_regions;
+
     /// Altium stores pour order across all layers
     int m_highest_pour_index;
 };
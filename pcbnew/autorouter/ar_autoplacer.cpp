@@ -45,6 +45,9 @@
 #include "ar_autoplacer.h"
 #include "ar_cell.h"
 #include "ar_matrix.h"
+#include <thread_pool.h>
+
+#include <algorithm>
 #include <memory>
 
 #define AR_GAIN            16
@@ -427,11 +430,67 @@ void AR_AUTOPLACER::genModuleOnRoutingMatrix( MODULE* Module )
 }
 
 
+void AR_AUTOPLACER::buildMatrixSums()
+{
+    int stride = m_matrix.m_Ncols + 1;
+    int size = ( m_matrix.m_Nrows + 1 ) * stride;
+
+    for( int side = 0; side < AR_MAX_ROUTING_LAYERS_COUNT; side++ )
+    {
+        MATRIX_SUMS& sums = m_matrixSums[side];
+
+        sums.m_OutOfBoard.assign( size, 0 );
+        sums.m_Occupied.assign( size, 0 );
+        sums.m_KeepOut.assign( size, 0 );
+
+        if( !m_matrix.m_BoardSide[side] || !m_matrix.m_DistSide[side] )
+            continue;
+
+        for( int row = 0; row < m_matrix.m_Nrows; row++ )
+        {
+            int     outOfBoard = 0;
+            int     occupied = 0;
+            int64_t keepOut = 0;
+
+            for( int col = 0; col < m_matrix.m_Ncols; col++ )
+            {
+                unsigned int data = m_matrix.GetCell( row, col, side );
+
+                outOfBoard += ( data & CELL_IS_ZONE ) == 0;
+                occupied += ( data & CELL_IS_MODULE ) != 0;
+                keepOut += m_matrix.GetDist( row, col, side );
+
+                int above = row * stride + col + 1;
+                int current = above + stride;
+
+                sums.m_OutOfBoard[current] = sums.m_OutOfBoard[above] + outOfBoard;
+                sums.m_Occupied[current] = sums.m_Occupied[above] + occupied;
+                sums.m_KeepOut[current] = sums.m_KeepOut[above] + keepOut;
+            }
+        }
+    }
+}
+
+
+/**
+ * @return the sum of the cells [aRowMin, aRowMax] x [aColMin, aColMax] from the summed-area
+ *         table aSums
+ */
+template <typename T>
+static T rectangleSum( const std::vector<T>& aSums, int aStride, int aRowMin, int aRowMax,
+                       int aColMin, int aColMax )
+{
+    return aSums[( aRowMax + 1 ) * aStride + aColMax + 1] - aSums[aRowMin * aStride + aColMax + 1]
+           - aSums[( aRowMax + 1 ) * aStride + aColMin] + aSums[aRowMin * aStride + aColMin];
+}
+
+
 /* Test if the rectangular area (ux, ux .. y0, y1):
  * - is a free zone (except OCCUPED_By_MODULE returns)
  * - is on the working surface of the board (otherwise returns OUT_OF_BOARD)
  *
  * Returns OUT_OF_BOARD, or OCCUPED_By_MODULE or FREE_CELL if OK
+ * (OUT_OF_BOARD if a cell is out of the board, even if another one is occupied)
  */
 int AR_AUTOPLACER::testRectangle( const EDA_RECT& aRect, int side )
 {
@@ -468,19 +527,17 @@ int AR_AUTOPLACER::testRectangle( const EDA_RECT& aRect, int side )
     if( col_max >= ( m_matrix.m_Ncols - 1 ) )
         col_max = m_matrix.m_Ncols - 1;
 
-    for( int row = row_min; row <= row_max; row++ )
-    {
-        for( int col = col_min; col <= col_max; col++ )
-        {
-            unsigned int data = m_matrix.GetCell( row, col, side );
+    if( row_min > row_max || col_min > col_max )
+        return AR_FREE_CELL;
 
-            if( ( data & CELL_IS_ZONE ) == 0 )
-                return AR_OUT_OF_BOARD;
+    const MATRIX_SUMS& sums = m_matrixSums[side];
+    int                stride = m_matrix.m_Ncols + 1;
 
-            if( (data & CELL_IS_MODULE) )
-                return AR_OCCUIPED_BY_MODULE;
-        }
-    }
+    if( rectangleSum( sums.m_OutOfBoard, stride, row_min, row_max, col_min, col_max ) )
+        return AR_OUT_OF_BOARD;
+
+    if( rectangleSum( sums.m_Occupied, stride, row_min, row_max, col_min, col_max ) )
+        return AR_OCCUIPED_BY_MODULE;
 
     return AR_FREE_CELL;
 }
@@ -537,21 +594,14 @@ unsigned int AR_AUTOPLACER::calculateKeepOutArea( const EDA_RECT& aRect, int sid
     if( col_max >= ( m_matrix.m_Ncols - 1 ) )
         col_max = m_matrix.m_Ncols - 1;
 
-    unsigned int keepOutCost = 0;
-
-    for( int row = row_min; row <= row_max; row++ )
-    {
-        for( int col = col_min; col <= col_max; col++ )
-        {
-            // m_matrix.GetDist returns the "cost" of the cell
-            // at position (row, col)
-            // in autoplace this is the cost of the cell, if it is
-            // inside aRect
-            keepOutCost += m_matrix.GetDist( row, col, side );
-        }
-    }
+    if( row_min > row_max || col_min > col_max )
+        return 0;
 
-    return keepOutCost;
+    // m_matrix.GetDist returns the "cost" of the cell at position (row, col): in autoplace
+    // this is the cost of the cell, if it is inside aRect.  The sum wraps around as the sum
+    // of the cells did.
+    return (unsigned int) rectangleSum( m_matrixSums[side].m_KeepOut, m_matrix.m_Ncols + 1,
+                                        row_min, row_max, col_min, col_max );
 }
 
 
@@ -559,7 +609,7 @@ unsigned int AR_AUTOPLACER::calculateKeepOutArea( const EDA_RECT& aRect, int sid
  * Returns the value TstRectangle().
  * Module is known by its bounding box
  */
-int AR_AUTOPLACER::testModuleOnBoard( MODULE* aModule, bool TstOtherSide, const wxPoint& aOffset )
+int AR_AUTOPLACER::testModuleOnBoard( MODULE* aModule, bool TstOtherSide, const EDA_RECT& aFpBBox )
 {
     int side = AR_SIDE_TOP;
     int otherside = AR_SIDE_BOTTOM;
@@ -569,10 +619,7 @@ int AR_AUTOPLACER::testModuleOnBoard( MODULE* aModule, bool TstOtherSide, const
         side = AR_SIDE_BOTTOM; otherside = AR_SIDE_TOP;
     }
 
-    EDA_RECT    fpBBox = aModule->GetFootprintRect();
-    fpBBox.Move( -aOffset );
-
-    buildFpAreas( aModule, 0 );
+    EDA_RECT    fpBBox = aFpBBox;
 
     int diag = //testModuleByPolygon( aModule, side, aOffset );
         testRectangle( fpBBox, side );
@@ -600,7 +647,7 @@ int AR_AUTOPLACER::getOptimalModulePlacement(MODULE* aModule)
 {
     int     error = 1;
     wxPoint LastPosOK;
-    double  min_cost, curr_cost, Score;
+    double  min_cost;
     bool    TstOtherSide;
 
     aModule->CalculateBoundingBox();
@@ -625,7 +672,6 @@ int AR_AUTOPLACER::getOptimalModulePlacement(MODULE* aModule)
     initialPos.y    -= initialPos.y % m_matrix.m_GridRouting;
 
     m_curPosition = initialPos;
-    auto moduleOffset = mod_pos - m_curPosition;
 
     /* Examine pads, and set TstOtherSide to true if a footprint
      * has at least 1 pad through.
@@ -649,39 +695,68 @@ int AR_AUTOPLACER::getOptimalModulePlacement(MODULE* aModule)
     fpBBox.SetOrigin( fpBBoxOrg + m_curPosition );
 
     min_cost = -1.0;
-//    m_frame->SetStatusText( wxT( "Score ??, pos ??" ) );
 
+    buildMatrixSums();
+    buildPadIndex( aModule );
 
-    for( ; m_curPosition.x < xylimit.x; m_curPosition.x += m_matrix.m_GridRouting )
+    // The candidate positions are tested in parallel, by column.  The best position of each
+    // column, then the best column, are chosen in the order of the serial sweep (the last of
+    // the positions with the same score) so the placement does not depend on the threads.
+    struct COLUMN_BEST
     {
-        m_curPosition.y = initialPos.y;
+        bool    m_Found = false;
+        double  m_Score = 0.0;
+        wxPoint m_Pos;
+    };
 
-        for( ; m_curPosition.y < xylimit.y; m_curPosition.y += m_matrix.m_GridRouting )
-        {
+    int columnCount = 0;
 
-            fpBBox.SetOrigin( fpBBoxOrg + m_curPosition );
-            moduleOffset = mod_pos - m_curPosition;
-            int keepOutCost = testModuleOnBoard( aModule, TstOtherSide, moduleOffset );
+    if( xylimit.x > initialPos.x )
+        columnCount = ( xylimit.x - initialPos.x - 1 ) / m_matrix.m_GridRouting + 1;
 
-            if( keepOutCost >= 0 )    // i.e. if the module can be put here
+    std::vector<COLUMN_BEST> columns( columnCount );
+
+    THREAD_POOL::GetInstance().ParallelFor( columns.size(),
+            [&]( size_t aColumn )
             {
-                error = 0;
-                // m_frame->build_ratsnest_module( aModule ); // fixme
-                curr_cost   = computePlacementRatsnestCost( aModule, moduleOffset );
-                Score       = curr_cost + keepOutCost;
+                COLUMN_BEST& best = columns[aColumn];
+                wxPoint      pos( initialPos.x + (int) aColumn * m_matrix.m_GridRouting,
+                                  initialPos.y );
 
-                if( (min_cost >= Score ) || (min_cost < 0 ) )
+                for( ; pos.y < xylimit.y; pos.y += m_matrix.m_GridRouting )
                 {
-                    LastPosOK   = m_curPosition;
-                    min_cost    = Score;
-                    wxString msg;
-/*                    msg.Printf( wxT( "Score %g, pos %s, %s" ),
-                                min_cost,
-                                GetChars( ::CoordinateToString( LastPosOK.x ) ),
-                                GetChars( ::CoordinateToString( LastPosOK.y ) ) );
-                    m_frame->SetStatusText( msg );*/
+                    EDA_RECT candidateBBox = fpBBox;
+                    candidateBBox.SetOrigin( fpBBoxOrg + pos );
+
+                    wxPoint offset = mod_pos - pos;
+                    int     keepOutCost = testModuleOnBoard( aModule, TstOtherSide, candidateBBox );
+
+                    if( keepOutCost >= 0 )    // i.e. if the module can be put here
+                    {
+                        double score = computePlacementRatsnestCost( aModule, offset )
+                                       + keepOutCost;
+
+                        if( !best.m_Found || best.m_Score >= score )
+                        {
+                            best.m_Found = true;
+                            best.m_Score = score;
+                            best.m_Pos = pos;
+                        }
+                    }
                 }
-            }
+            } );
+
+    for( const COLUMN_BEST& best : columns )
+    {
+        if( !best.m_Found )
+            continue;
+
+        error = 0;
+
+        if( (min_cost >= best.m_Score ) || (min_cost < 0 ) )
+        {
+            LastPosOK   = best.m_Pos;
+            min_cost    = best.m_Score;
         }
     }
 
@@ -693,32 +768,85 @@ int AR_AUTOPLACER::getOptimalModulePlacement(MODULE* aModule)
 }
 
 
-const D_PAD* AR_AUTOPLACER::nearestPad( MODULE *aRefModule, D_PAD* aRefPad, const wxPoint& aOffset)
+void AR_AUTOPLACER::buildPadIndex( MODULE* aRefModule )
 {
-    const D_PAD* nearest = nullptr;
-    int64_t nearestDist = INT64_MAX;
+    size_t rank = 0;
 
-    for ( auto mod : m_board->Modules() )
+    m_padsByNet.clear();
+
+    for( auto mod : m_board->Modules() )
     {
-        if ( mod == aRefModule )
+        if( mod == aRefModule )
             continue;
 
         if( !m_matrix.m_BrdBox.Contains( mod->GetPosition() ) )
             continue;
 
-        for ( auto pad: mod->Pads() )
+        for( auto pad : mod->Pads() )
         {
-            if ( pad->GetNetCode() != aRefPad->GetNetCode() || pad->GetNetCode() <= 0 )
-                continue;
+            if( pad->GetNetCode() > 0 )
+                m_padsByNet[pad->GetNetCode()].push_back( { pad->GetPosition(), rank, pad } );
 
-            auto dist = (VECTOR2I( aRefPad->GetPosition() - aOffset ) - VECTOR2I( pad->GetPosition() ) ).EuclideanNorm();
+            rank++;
+        }
+    }
 
-            if ( dist < nearestDist )
-            {
-                nearestDist = dist;
-                nearest = pad;
-            }
+    for( auto& net : m_padsByNet )
+    {
+        std::sort( net.second.begin(), net.second.end(),
+                   []( const INDEXED_PAD& a, const INDEXED_PAD& b )
+                   {
+                       return a.m_Pos.x < b.m_Pos.x;
+                   } );
+    }
+}
+
+
+const D_PAD* AR_AUTOPLACER::nearestPad( MODULE *aRefModule, D_PAD* aRefPad, const wxPoint& aOffset)
+{
+    const D_PAD* nearest = nullptr;
+    size_t       nearestRank = 0;
+    int64_t      nearestDist = INT64_MAX;
+
+    auto net = m_padsByNet.find( aRefPad->GetNetCode() );
+
+    if( aRefPad->GetNetCode() <= 0 || net == m_padsByNet.end() )
+        return nullptr;
+
+    const std::vector<INDEXED_PAD>& pads = net->second;
+    VECTOR2I                        refPos( aRefPad->GetPosition() - aOffset );
+
+    // The first pad of the board wins between pads at the same distance, as when the pads
+    // were searched in the board order
+    auto testPad = [&]( const INDEXED_PAD& aPad )
+    {
+        int64_t dist = ( refPos - VECTOR2I( aPad.m_Pos ) ).EuclideanNorm();
+
+        if( dist < nearestDist || ( dist == nearestDist && aPad.m_Rank < nearestRank ) )
+        {
+            nearestDist = dist;
+            nearestRank = aPad.m_Rank;
+            nearest = aPad.m_Pad;
         }
+    };
+
+    // Search both ways from the X of the pad, until the X distance alone is too large
+    auto first = std::lower_bound( pads.begin(), pads.end(), refPos.x,
+                                   []( const INDEXED_PAD& aPad, int aX )
+                                   {
+                                       return aPad.m_Pos.x < aX;
+                                   } );
+
+    for( auto it = first; it != pads.end() && (int64_t) it->m_Pos.x - refPos.x <= nearestDist;
+         ++it )
+    {
+        testPad( *it );
+    }
+
+    for( auto it = first; it != pads.begin() && refPos.x - (int64_t) ( it - 1 )->m_Pos.x <= nearestDist;
+         --it )
+    {
+        testPad( *( it - 1 ) );
     }
 
     return nearest;
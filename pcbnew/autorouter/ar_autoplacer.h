@@ -39,6 +39,9 @@
 
 #include <view/view_overlay.h>
 
+#include <unordered_map>
+#include <vector>
+
 enum AR_CELL_STATE
 {
     AR_OUT_OF_BOARD = -2,
@@ -103,10 +106,16 @@ private:
     bool         fillMatrix();
     void         genModuleOnRoutingMatrix( MODULE* Module );
 
+    /**
+     * Build the summed-area tables of m_matrix, used by testRectangle() and
+     * calculateKeepOutArea().  To be called after any change of the matrix.
+     */
+    void         buildMatrixSums();
+
     int          testRectangle( const EDA_RECT& aRect, int side );
     int          testModuleByPolygon( MODULE* aModule,int aSide, const wxPoint& aOffset );
     unsigned int calculateKeepOutArea( const EDA_RECT& aRect, int side );
-    int          testModuleOnBoard( MODULE* aModule, bool TstOtherSide, const wxPoint& aOffset );
+    int          testModuleOnBoard( MODULE* aModule, bool TstOtherSide, const EDA_RECT& aFpBBox );
     int          getOptimalModulePlacement( MODULE* aModule );
     double       computePlacementRatsnestCost( MODULE* aModule, const wxPoint& aOffset );
 
@@ -120,6 +129,11 @@ private:
     void         placeModule( MODULE* aModule, bool aDoNotRecreateRatsnest, const wxPoint& aPos );
     const D_PAD* nearestPad( MODULE* aRefModule, D_PAD* aRefPad, const wxPoint& aOffset );
 
+    /**
+     * Index the pads of the footprints on the placement area but aRefModule, for nearestPad().
+     */
+    void         buildPadIndex( MODULE* aRefModule );
+
     // Add a polygonal shape (rectangle) to m_fpAreaFront and/or m_fpAreaBack
     void         addFpBody( wxPoint aStart, wxPoint aEnd, LSET aLayerMask );
 
@@ -131,6 +145,30 @@ private:
     void         buildFpAreas( MODULE* aFootprint, int aFpClearance );
 
     AR_MATRIX m_matrix;
+
+    /**
+     * The summed-area tables of a side of m_matrix: each entry holds the count of the cells
+     * out of the board, the count of the cells occupied by a footprint and the sum of the
+     * keepout costs of the cells above and left of it; the first row and column are zero.
+     */
+    struct MATRIX_SUMS
+    {
+        std::vector<int>     m_OutOfBoard;
+        std::vector<int>     m_Occupied;
+        std::vector<int64_t> m_KeepOut;
+    };
+
+    MATRIX_SUMS m_matrixSums[AR_MAX_ROUTING_LAYERS_COUNT];
+
+    struct INDEXED_PAD
+    {
+        wxPoint      m_Pos;
+        size_t       m_Rank;        ///< the order of the pad on the board, to break the ties
+        const D_PAD* m_Pad;
+    };
+
+    ///> The pads of buildPadIndex(), by net code and sorted by X
+    std::unordered_map<int, std::vector<INDEXED_PAD>> m_padsByNet;
     SHAPE_POLY_SET m_topFreeArea;       // The polygonal description of the top side free areas;
     SHAPE_POLY_SET m_bottomFreeArea;    // The polygonal description of the bottom side free areas;
     SHAPE_POLY_SET m_boardShape;        // The polygonal description of the board;
@@ -29,6 +29,11 @@
  *  japanese font with around 8500 characters and all the time was spent generating
  *  the bitmaps.
  *
+ *  (KiCad: the placed rectangles are indexed in a grid of cells, so testing a spot
+ *  only tests the rectangles near it, and the anchors covered by a rectangle are
+ *  not tried again: spreading thousands of footprints needed minutes.  The
+ *  placement is the same.)
+ *
  *  Also, for all we care, we could grow the parent rectangle.
  *
  *  I'd be interested in hearing of other approaches to this problem. Make sure
@@ -37,6 +42,8 @@
 
 #include "rect_placement.h"
 
+#include <algorithm>
+
 // --------------------------------------------------------------------------------
 // Name        :
 // Description :
@@ -45,7 +52,7 @@ void CRectPlacement::Init( int w, int h )
 {
     End();
     m_size = TRect( 0, 0, w, h );
-    m_vPositions.push_back( TPos( 0, 0 ) );
+    m_vPositions.push_back( TAnchor( TPos( 0, 0 ), false ) );
     m_area = 0;
 }
 
@@ -58,6 +65,8 @@ void CRectPlacement::End()
 {
     m_vPositions.clear();
     m_vRects.clear();
+    m_cells.clear();
+    m_cellSize = 0;
     m_size.w = 0;
 }
 
@@ -71,27 +80,162 @@ bool CRectPlacement::IsFree( const TRect& r ) const
     if( !m_size.Contains( r ) )
         return false;
 
-    for( CRectArray::const_iterator it = m_vRects.begin();
-         it != m_vRects.end(); ++it )
+    // Empty rects intersect nothing; the rects are indexed when not empty
+    if( r.w <= 0 || r.h <= 0 || m_cellSize == 0 )
+        return true;
+
+    for( int cy = r.y / m_cellSize; cy <= ( r.y + r.h - 1 ) / m_cellSize; cy++ )
     {
-        if( it->Intersects( r ) )
-            return false;
+        for( int cx = r.x / m_cellSize; cx <= ( r.x + r.w - 1 ) / m_cellSize; cx++ )
+        {
+            auto cell = m_cells.find( CellKey( cx, cy ) );
+
+            if( cell == m_cells.end() )
+                continue;
+
+            for( int index : cell->second )
+            {
+                if( m_vRects[index].Intersects( r ) )
+                    return false;
+            }
+        }
     }
 
     return true;
 }
 
 
+// --------------------------------------------------------------------------------
+// Name        : IndexRect
+// Description : Add the given rect of m_vRects to the cells it covers
+// --------------------------------------------------------------------------------
+void CRectPlacement::IndexRect( int index )
+{
+    const TRect& r = m_vRects[index];
+
+    if( r.w <= 0 || r.h <= 0 )
+        return;
+
+    for( int cy = r.y / m_cellSize; cy <= ( r.y + r.h - 1 ) / m_cellSize; cy++ )
+    {
+        for( int cx = r.x / m_cellSize; cx <= ( r.x + r.w - 1 ) / m_cellSize; cx++ )
+            m_cells[CellKey( cx, cy )].push_back( index );
+    }
+}
+
+
+// --------------------------------------------------------------------------------
+// Name        : FreeShiftLeft
+// Description : Return the largest move to the left of the given free rect keeping it free
+// --------------------------------------------------------------------------------
+int CRectPlacement::FreeShiftLeft( const TRect& r ) const
+{
+    int shift = r.x;
+
+    if( r.w <= 0 || r.h <= 0 || m_cellSize == 0 )
+        return shift;
+
+    // Walk the columns of cells to the left: a rect ending in a column ends after the
+    // rects of the columns on its left, so the first column with a rect on the way is
+    // the last one to search
+    for( int cx = ( r.x - 1 ) / m_cellSize; r.x > 0 && cx >= 0; cx-- )
+    {
+        bool found = false;
+
+        for( int cy = r.y / m_cellSize; cy <= ( r.y + r.h - 1 ) / m_cellSize; cy++ )
+        {
+            auto cell = m_cells.find( CellKey( cx, cy ) );
+
+            if( cell == m_cells.end() )
+                continue;
+
+            for( int index : cell->second )
+            {
+                const TRect& o = m_vRects[index];
+
+                if( o.y < r.y + r.h && o.y + o.h > r.y && o.x + o.w <= r.x )
+                {
+                    shift = std::min( shift, r.x - ( o.x + o.w ) );
+                    found = true;
+                }
+            }
+        }
+
+        if( found )
+            break;
+    }
+
+    return shift;
+}
+
+
+// --------------------------------------------------------------------------------
+// Name        : FreeShiftUp
+// Description : Return the largest move upwards of the given free rect keeping it free
+// --------------------------------------------------------------------------------
+int CRectPlacement::FreeShiftUp( const TRect& r ) const
+{
+    int shift = r.y;
+
+    if( r.w <= 0 || r.h <= 0 || m_cellSize == 0 )
+        return shift;
+
+    for( int cy = ( r.y - 1 ) / m_cellSize; r.y > 0 && cy >= 0; cy-- )
+    {
+        bool found = false;
+
+        for( int cx = r.x / m_cellSize; cx <= ( r.x + r.w - 1 ) / m_cellSize; cx++ )
+        {
+            auto cell = m_cells.find( CellKey( cx, cy ) );
+
+            if( cell == m_cells.end() )
+                continue;
+
+            for( int index : cell->second )
+            {
+                const TRect& o = m_vRects[index];
+
+                if( o.x < r.x + r.w && o.x + o.w > r.x && o.y + o.h <= r.y )
+                {
+                    shift = std::min( shift, r.y - ( o.y + o.h ) );
+                    found = true;
+                }
+            }
+        }
+
+        if( found )
+            break;
+    }
+
+    return shift;
+}
+
+
 // --------------------------------------------------------------------------------
 // Name        : AddPosition
 // Description : Add new anchor point
 // --------------------------------------------------------------------------------
 void CRectPlacement::AddPosition( const TPos& p )
 {
+    // An anchor covered by a rect cannot take any other rect.  It is still inserted, as
+    // the anchors inserted later are placed from it.
+    bool covered = false;
+
+    if( m_cellSize > 0 )
+    {
+        auto cell = m_cells.find( CellKey( p.x / m_cellSize, p.y / m_cellSize ) );
+
+        if( cell != m_cells.end() )
+        {
+            for( int index : cell->second )
+                covered = covered || m_vRects[index].Contains( p );
+        }
+    }
+
     // Try to insert anchor as close as possible to the top left corner
     // So it will be tried first
     bool bFound = false;
-    CPosArray::iterator it;
+    std::vector<TAnchor>::iterator it;
 
     for( it = m_vPositions.begin();
          !bFound && it != m_vPositions.end();
@@ -102,9 +246,9 @@ void CRectPlacement::AddPosition( const TPos& p )
     }
 
     if( bFound )
-        m_vPositions.insert( it, p );
+        m_vPositions.insert( it, TAnchor( p, covered ) );
     else
-        m_vPositions.push_back( p );
+        m_vPositions.push_back( TAnchor( p, covered ) );
 }
 
 
@@ -117,6 +261,29 @@ void CRectPlacement::AddRect( const TRect& r )
     m_vRects.push_back( r );
     m_area += r.w * r.h;
 
+    if( r.w > 0 && r.h > 0 )
+    {
+        int size = std::max( r.w, r.h );
+
+        if( m_cellSize == 0 || size * 2 < m_cellSize )
+        {
+            // Smaller cells for the smaller rects: index all the rects again
+            m_cellSize = size;
+            m_cells.clear();
+
+            for( int index = 0; index < (int) m_vRects.size(); index++ )
+                IndexRect( index );
+        }
+        else
+        {
+            IndexRect( (int) m_vRects.size() - 1 );
+        }
+
+        // None of the anchors covered by the rect can take another rect
+        for( TAnchor& p : m_vPositions )
+            p.covered = p.covered || r.Contains( p );
+    }
+
     // Add two new anchor points
     AddPosition( TPos( r.x, r.y + r.h ) );
     AddPosition( TPos( r.x + r.w, r.y ) );
@@ -131,12 +298,16 @@ bool CRectPlacement::AddAtEmptySpot( TRect& r )
 {
     // Find a valid spot among available anchors.
     bool bFound = false;
-    CPosArray::iterator it;
+    std::vector<TAnchor>::iterator it;
 
     for( it = m_vPositions.begin();
          !bFound && it != m_vPositions.end();
          ++it )
     {
+        // (an empty rect intersects nothing: it can take a covered anchor)
+        if( it->covered && r.w > 0 && r.h > 0 )
+            continue;
+
         TRect Rect( it->x, it->y, r.w, r.h );
 
         if( IsFree( Rect ) )
@@ -149,25 +320,14 @@ bool CRectPlacement::AddAtEmptySpot( TRect& r )
 
     if( bFound )
     {
-        int x, y;
-
         // Remove the used anchor point
         m_vPositions.erase( it );
 
         // Sometimes, anchors end up displaced from the optimal position
         // due to irregular sizes of the subrects.
         // So, try to adjut it up & left as much as possible.
-        for( x = 1; x <= r.x; x++ )
-        {
-            if( !IsFree( TRect( r.x - x, r.y, r.w, r.h ) ) )
-                break;
-        }
-
-        for( y = 1; y <= r.y; y++ )
-        {
-            if( !IsFree( TRect( r.x, r.y - y, r.w, r.h ) ) )
-                break;
-        }
+        int x = FreeShiftLeft( r ) + 1;
+        int y = FreeShiftUp( r ) + 1;
 
         if( y > x )
             r.y -= y - 1;
@@ -12,6 +12,8 @@
 #ifndef _RECT_PLACEMENT_H_
 #define _RECT_PLACEMENT_H_
 
+#include <cstdint>
+#include <unordered_map>
 #include <vector>
 
 // --------------------------------------------------------------------------------
@@ -88,17 +90,37 @@ public:
     bool AddAtEmptySpotAutoGrow( TRect* pRect, int maxW, int maxH );
 
 private:
+    // An anchor point, which cannot take any rect once covered by one
+    struct TAnchor : public TPos
+    {
+        bool covered;
+
+        TAnchor( const TPos& p, bool _covered ) : TPos( p ), covered( _covered ) { }
+    };
+
     TRect       m_size;
     CRectArray  m_vRects;
-    CPosArray   m_vPositions;
+    std::vector<TAnchor> m_vPositions;
     double      m_area;
 
+    // The rects of m_vRects by square cell of m_cellSize, to find the rects near a rect
+    // without testing all of them.  The cells are sized from the smallest rect added.
+    int         m_cellSize;
+    std::unordered_map<int64_t, std::vector<int>> m_cells;
+
     // ---------------------
 
     bool    IsFree( const TRect& r ) const;
     void    AddPosition( const TPos& p );
     void    AddRect( const TRect& r );
     bool    AddAtEmptySpot( TRect& r );
+
+    static int64_t CellKey( int cx, int cy ) { return ( (int64_t) cx << 32 ) | (uint32_t) cy; }
+    void    IndexRect( int index );
+
+    // How far r can move left (or up) until it touches a rect or the area border
+    int     FreeShiftLeft( const TRect& r ) const;
+    int     FreeShiftUp( const TRect& r ) const;
 };
 
 #endif    // _RECT_PLACEMENT_H_
@@ -42,6 +42,7 @@
 #include <class_board.h>
 #include <class_module.h>
 #include <rect_placement/rect_placement.h>
+#include <thread_pool.h>
 
 struct TSubRect : public CRectPlacement::TRect
 {
@@ -149,20 +150,11 @@ void spreadRectangles( CRectPlacement& aPlacementArea,
 }
 
 
-void moveFootprintsInArea( CRectPlacement& aPlacementArea,
+// Move the footprints to their place in aFreeArea, spread by spreadRectangles()
+void moveFootprintsInArea( const CSubRectArray& vecSubRects,
                            std::vector <MODULE*>& aModuleList,
-                           EDA_RECT& aFreeArea,
-                           bool aFindAreaOnly )
+                           EDA_RECT& aFreeArea )
 {
-    CSubRectArray   vecSubRects;
-
-    fillRectList( vecSubRects, aModuleList );
-    spreadRectangles( aPlacementArea, vecSubRects,
-                      aFreeArea.GetWidth(), aFreeArea.GetHeight() );
-
-    if( aFindAreaOnly )
-        return;
-
     for( unsigned it = 0; it < vecSubRects.size(); ++it )
     {
         wxPoint pos( vecSubRects[it].x, vecSubRects[it].y );
@@ -212,130 +204,121 @@ void SpreadFootprints( std::vector<MODULE*>* aFootprints,
     // sort footprints by sheet path. we group them later by sheet
     sort( footprintList.begin(), footprintList.end(), sortFootprintsbySheetPath );
 
-    // Extract and place footprints by sheet
-    std::vector <MODULE*> footprintListBySheet;
-    std::vector <EDA_RECT> placementSheetAreas;
-    double subsurface;
-    double placementsurface = 0.0;
+    // Extract footprints by sheet
+    std::vector<std::vector<MODULE*>> footprintListBySheet;
 
-    // The placement uses 2 passes:
-    // the first pass creates the rectangular areas to place footprints
-    // each sheet in schematic creates one rectangular area.
-    // the second pass moves footprints inside these areas
-    for( int pass = 0; pass < 2; pass++ )
+    for( unsigned ii = 0; ii < footprintList.size(); ii++ )
     {
-        int subareaIdx = 0;
-        footprintListBySheet.clear();
-        subsurface = 0.0;
-
-        int fp_max_width = 0;
-        int fp_max_height = 0;
+        if( ii == 0 ||
+            ( footprintList[ii]->GetPath().AsString().BeforeLast( '/' ) !=
+              footprintList[ii-1]->GetPath().AsString().BeforeLast( '/' ) ) )
+            footprintListBySheet.emplace_back();
 
-        for( unsigned ii = 0; ii < footprintList.size(); ii++ )
-        {
-            MODULE* footprint = footprintList[ii];
-            bool islastItem = false;
+        footprintListBySheet.back().push_back( footprintList[ii] );
+    }
 
-            if( ii == footprintList.size() - 1 ||
-                ( footprintList[ii]->GetPath().AsString().BeforeLast( '/' ) !=
-                  footprintList[ii+1]->GetPath().AsString().BeforeLast( '/' ) ) )
-                islastItem = true;
+    // The placement uses 2 steps:
+    // the first step creates the rectangular areas to place footprints:
+    // each sheet in schematic creates one rectangular area.
+    // the second step places these areas, and moves footprints inside them
+    size_t                     sheetCount = footprintListBySheet.size();
+    std::vector<CSubRectArray> sheetSubRects( sheetCount );
+    std::vector<EDA_RECT>      freeAreas( sheetCount );
+    std::vector<EDA_RECT>      placementSheetAreas( sheetCount );
+    double                     placementsurface = 0.0;
+
+    // The max size of the footprints is of the current and previous sheets
+    int fp_max_width = 0;
+    int fp_max_height = 0;
+
+    for( size_t sheet = 0; sheet < sheetCount; sheet++ )
+    {
+        double subsurface = 0.0;
 
-            footprintListBySheet.push_back( footprint );
+        for( MODULE* footprint : footprintListBySheet[sheet] )
+        {
             subsurface += footprint->GetArea( PADDING );
 
             // Calculate min size of placement area:
             EDA_RECT bbox = footprint->GetFootprintRect();
             fp_max_width = std::max( fp_max_width, bbox.GetWidth() );
             fp_max_height = std::max( fp_max_height, bbox.GetHeight() );
+        }
 
-            if( islastItem )
-            {
-                // end of the footprint sublist relative to the same sheet path
-                // calculate placement of the current sublist
-                EDA_RECT freeArea;
-                int Xsize_allowed = (int) ( sqrt( subsurface ) * 4.0 / 3.0 );
-                Xsize_allowed = std::max( fp_max_width, Xsize_allowed );
+        // calculate placement of the current sublist
+        int Xsize_allowed = (int) ( sqrt( subsurface ) * 4.0 / 3.0 );
+        Xsize_allowed = std::max( fp_max_width, Xsize_allowed );
+
+        int Ysize_allowed = (int) ( subsurface / Xsize_allowed );
+        Ysize_allowed = std::max( fp_max_height, Ysize_allowed );
 
-                int Ysize_allowed = (int) ( subsurface / Xsize_allowed );
-                Ysize_allowed = std::max( fp_max_height, Ysize_allowed );
+        freeAreas[sheet].SetWidth( Xsize_allowed );
+        freeAreas[sheet].SetHeight( Ysize_allowed );
+
+        fillRectList( sheetSubRects[sheet], footprintListBySheet[sheet] );
+    }
 
-                freeArea.SetWidth( Xsize_allowed );
-                freeArea.SetHeight( Ysize_allowed );
+    // The sheets are spread independently
+    THREAD_POOL::GetInstance().ParallelFor( sheetCount,
+            [&]( size_t aSheet )
+            {
                 CRectPlacement placementArea;
 
-                if( pass == 1 )
-                {
-                    wxPoint areapos = placementSheetAreas[subareaIdx].GetOrigin()
-                                      + aSpreadAreaPosition;
-                    freeArea.SetOrigin( areapos );
-                }
-
-                bool findAreaOnly = pass == 0;
-                moveFootprintsInArea( placementArea, footprintListBySheet,
-                                      freeArea, findAreaOnly );
-
-                if( pass == 0 )
-                {
-                    // Populate sheet placement areas list
-                    EDA_RECT sub_area;
-                    sub_area.SetWidth( placementArea.GetW()*scale );
-                    sub_area.SetHeight( placementArea.GetH()*scale );
-                    // Add a margin around the sheet placement area:
-                    sub_area.Inflate( Millimeter2iu( 1.5 ) );
-
-                    placementSheetAreas.push_back( sub_area );
-
-                    placementsurface += (double) sub_area.GetWidth()*
-                                        sub_area.GetHeight();
-                }
-
-                // Prepare buffers for next sheet
-                subsurface  = 0.0;
-                footprintListBySheet.clear();
-                subareaIdx++;
-            }
-        }
+                spreadRectangles( placementArea, sheetSubRects[aSheet],
+                                  freeAreas[aSheet].GetWidth(), freeAreas[aSheet].GetHeight() );
 
-        // End of pass:
-        // At the end of the first pass, we have to find position of each sheet
-        // placement area
-        if( pass == 0 )
-        {
-            int Xsize_allowed = (int) ( sqrt( placementsurface ) * 4.0 / 3.0 );
+                // Populate sheet placement areas list
+                EDA_RECT& sub_area = placementSheetAreas[aSheet];
+                sub_area.SetWidth( placementArea.GetW()*scale );
+                sub_area.SetHeight( placementArea.GetH()*scale );
+                // Add a margin around the sheet placement area:
+                sub_area.Inflate( Millimeter2iu( 1.5 ) );
+            } );
 
-            if( Xsize_allowed < 0 || Xsize_allowed > INT_MAX/2 )
-                Xsize_allowed = INT_MAX/2;
+    for( const EDA_RECT& sub_area : placementSheetAreas )
+        placementsurface += (double) sub_area.GetWidth()* sub_area.GetHeight();
 
-            int Ysize_allowed = (int) ( placementsurface / Xsize_allowed );
+    // Find the position of each sheet placement area
+    int Xsize_allowed = (int) ( sqrt( placementsurface ) * 4.0 / 3.0 );
 
-            if( Ysize_allowed < 0 || Ysize_allowed > INT_MAX/2 )
-                Ysize_allowed = INT_MAX/2;
+    if( Xsize_allowed < 0 || Xsize_allowed > INT_MAX/2 )
+        Xsize_allowed = INT_MAX/2;
 
-            CRectPlacement placementArea;
-            CSubRectArray  vecSubRects;
-            fillRectList( vecSubRects, placementSheetAreas );
-            spreadRectangles( placementArea, vecSubRects, Xsize_allowed, Ysize_allowed );
+    int Ysize_allowed = (int) ( placementsurface / Xsize_allowed );
 
-            for( unsigned it = 0; it < vecSubRects.size(); ++it )
-            {
-                TSubRect& srect = vecSubRects[it];
-                wxPoint pos( srect.x*scale, srect.y*scale );
-                wxSize size( srect.w*scale, srect.h*scale );
+    if( Ysize_allowed < 0 || Ysize_allowed > INT_MAX/2 )
+        Ysize_allowed = INT_MAX/2;
 
-                // Avoid too large coordinates: Overlapping components
-                // are better than out of screen components
-                if( (uint64_t)pos.x + (uint64_t)size.x > INT_MAX/2 )
-                    pos.x = 0;
+    CRectPlacement placementArea;
+    CSubRectArray  vecSubRects;
+    fillRectList( vecSubRects, placementSheetAreas );
+    spreadRectangles( placementArea, vecSubRects, Xsize_allowed, Ysize_allowed );
 
-                if( (uint64_t)pos.y + (uint64_t)size.y > INT_MAX/2 )
-                    pos.y = 0;
+    for( unsigned it = 0; it < vecSubRects.size(); ++it )
+    {
+        TSubRect& srect = vecSubRects[it];
+        wxPoint pos( srect.x*scale, srect.y*scale );
+        wxSize size( srect.w*scale, srect.h*scale );
 
-                placementSheetAreas[srect.n].SetOrigin( pos );
-                placementSheetAreas[srect.n].SetSize( size );
-            }
-        }
-    }   // End pass
+        // Avoid too large coordinates: Overlapping components
+        // are better than out of screen components
+        if( (uint64_t)pos.x + (uint64_t)size.x > INT_MAX/2 )
+            pos.x = 0;
+
+        if( (uint64_t)pos.y + (uint64_t)size.y > INT_MAX/2 )
+            pos.y = 0;
+
+        placementSheetAreas[srect.n].SetOrigin( pos );
+        placementSheetAreas[srect.n].SetSize( size );
+    }
+
+    // Move the footprints inside their sheet area, as spread above
+    for( size_t sheet = 0; sheet < sheetCount; sheet++ )
+    {
+        freeAreas[sheet].SetOrigin( placementSheetAreas[sheet].GetOrigin() + aSpreadAreaPosition );
+        moveFootprintsInArea( sheetSubRects[sheet], footprintListBySheet[sheet],
+                              freeAreas[sheet] );
+    }
 }
 
 
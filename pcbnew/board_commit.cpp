@@ -32,12 +32,20 @@
 #include <tools/pcb_tool_base.h>
 #include <tools/pcb_actions.h>
 #include <connectivity/connectivity_data.h>
+#include <drc/drc.h>
+#include <router/pns_tool_base.h>
+#include <zone_filler.h>
+#include <zone_knockout_cache.h>
 
 #include <functional>
 using namespace std::placeholders;
 
 #include "pcb_draw_panel_gal.h"
 
+/// Above this number of changes, the spatial indexes are rebuilt once instead of
+/// being updated for each item
+static const size_t BULK_COMMIT_SIZE = 100;
+
 BOARD_COMMIT::BOARD_COMMIT( PCB_TOOL_BASE* aTool )
 {
     m_toolMgr = aTool->GetManager();
@@ -93,9 +101,22 @@ void BOARD_COMMIT::Push( const wxString& aMessage, bool aCreateUndoEntry, bool a
     SELECTION_TOOL*     selTool = m_toolMgr->GetTool<SELECTION_TOOL>();
     bool                itemsDeselected = false;
 
+    // Items to re-test with the incremental DRC, and to update in the router worlds
+    std::vector<BOARD_ITEM*> changedItems;
+    std::vector<BOARD_ITEM*> removedItems;
+    std::vector<KIID>        drcRemoved;
+
     if( Empty() )
         return;
 
+    bool bulkUpdate = m_changes.size() > BULK_COMMIT_SIZE;
+
+    if( bulkUpdate )
+    {
+        view->BeginBulkAdd();
+        connectivity->BeginBulkUpdate();
+    }
+
     for( COMMIT_LINE& ent : m_changes )
     {
         int changeType = ent.m_type & CHT_TYPE;
@@ -164,6 +185,13 @@ void BOARD_COMMIT::Push( const wxString& aMessage, bool aCreateUndoEntry, bool a
                 }
 
                 view->Add( boardItem );
+
+                if( boardItem->Type() != PCB_MARKER_T )
+                    changedItems.push_back( boardItem );
+
+                if( !m_editModules )
+                    ZONE_FILLER::AddDirtyItem( board, boardItem );
+
                 break;
             }
 
@@ -172,12 +200,27 @@ void BOARD_COMMIT::Push( const wxString& aMessage, bool aCreateUndoEntry, bool a
                 if( !m_editModules && aCreateUndoEntry )
                     undoList.PushItem( ITEM_PICKER( boardItem, UR_DELETED ) );
 
+                if( boardItem->Type() != PCB_MARKER_T )
+                {
+                    removedItems.push_back( boardItem );
+                    drcRemoved.push_back( boardItem->m_Uuid );
+
+                    if( boardItem->Type() == PCB_MODULE_T )
+                    {
+                        for( D_PAD* pad : static_cast<MODULE*>( boardItem )->Pads() )
+                            drcRemoved.push_back( pad->m_Uuid );
+                    }
+                }
+
                 if( boardItem->IsSelected() )
                 {
                     selTool->RemoveItemFromSel( boardItem, true /* quiet mode */ );
                     itemsDeselected = true;
                 }
 
+                if( !m_editModules )
+                    ZONE_FILLER::AddDirtyItem( board, boardItem );
+
                 switch( boardItem->Type() )
                 {
                 // Module items
@@ -203,6 +246,9 @@ void BOARD_COMMIT::Push( const wxString& aMessage, bool aCreateUndoEntry, bool a
                     {
                         MODULE* module = static_cast<MODULE*>( boardItem->GetParent() );
                         wxASSERT( module && module->Type() == PCB_MODULE_T );
+
+                        // The board listeners don't see the items of the footprints
+                        board->OnItemChanged( module );
                         module->Delete( boardItem );
                     }
 
@@ -261,9 +307,22 @@ void BOARD_COMMIT::Push( const wxString& aMessage, bool aCreateUndoEntry, bool a
                     connectivity->MarkItemNetAsDirty( static_cast<BOARD_ITEM*>( ent.m_copy ) );
 
                 connectivity->Update( boardItem );
+                board->GetZoneKnockoutCache()->Invalidate( boardItem );
                 view->Update( boardItem );
                 board->OnItemChanged( boardItem );
 
+                if( boardItem->Type() != PCB_MARKER_T )
+                    changedItems.push_back( boardItem );
+
+                // Both the old and the new position of the item are out of date in the fills
+                if( !m_editModules )
+                {
+                    ZONE_FILLER::AddDirtyItem( board, boardItem );
+
+                    if( ent.m_copy )
+                        ZONE_FILLER::AddDirtyItem( board, static_cast<BOARD_ITEM*>( ent.m_copy ) );
+                }
+
                 // if no undo entry is needed, the copy would create a memory leak
                 if( !aCreateUndoEntry )
                     delete ent.m_copy;
@@ -277,6 +336,12 @@ void BOARD_COMMIT::Push( const wxString& aMessage, bool aCreateUndoEntry, bool a
         }
     }
 
+    if( bulkUpdate )
+    {
+        view->EndBulkAdd();
+        connectivity->EndBulkUpdate();
+    }
+
     if ( !m_editModules )
     {
         size_t num_changes = m_changes.size();
@@ -309,8 +374,21 @@ void BOARD_COMMIT::Push( const wxString& aMessage, bool aCreateUndoEntry, bool a
                 }
 
                 view->Update( boardItem );
+                changedItems.push_back( boardItem );
+                ZONE_FILLER::AddDirtyItem( board, boardItem );
             }
         }
+
+        // Re-test the changed items once the connectivity is up to date.  The markers are
+        // pushed in a separate commit, which doesn't trigger another test.
+        DRC* drcTool = m_toolMgr->GetTool<DRC>();
+
+        if( drcTool && ( !changedItems.empty() || !drcRemoved.empty() ) )
+            drcTool->TestChangedItems( changedItems, drcRemoved );
+
+        // The routers bring their worlds up to date on their next run
+        for( PNS::TOOL_BASE* routerTool : PNS::TOOL_BASE::RouterTools( m_toolMgr ) )
+            routerTool->MarkWorldDirty( changedItems, removedItems );
     }
 
     if( !m_editModules && aCreateUndoEntry )
@@ -322,7 +400,13 @@ void BOARD_COMMIT::Push( const wxString& aMessage, bool aCreateUndoEntry, bool a
         m_toolMgr->PostEvent( EVENTS::UnselectedEvent );
 
     if( aSetDirtyBit )
-        frame->OnModify();
+    {
+        // The dirty regions of the zone fills were recorded above
+        if( PCB_EDIT_FRAME* editFrame = dynamic_cast<PCB_EDIT_FRAME*>( frame ) )
+            editFrame->OnCommitModify();
+        else
+            frame->OnModify();
+    }
 
     frame->UpdateMsgPanel();
 
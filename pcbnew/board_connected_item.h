@@ -151,6 +151,15 @@ public:
         return m_netinfo->GetShortNetname();
     }
 
+    /**
+     * Function GetDisplayNetname
+     * @return wxString - the unescaped short netname, the label drawn on the item
+     */
+    const wxString& GetDisplayNetname() const
+    {
+        return m_netinfo->GetDisplayNetname();
+    }
+
     /**
      * Function GetClearance
      * returns the clearance in internal units.  If \a aItem is not NULL then the
@@ -42,26 +42,6 @@
 #include <geometry/geometry_utils.h>
 #include <math/util.h>      // for KiROUND
 
-// A helper struct for the callback function
-// These variables are parameters used in addTextSegmToPoly.
-// But addTextSegmToPoly is a call-back function,
-// so we cannot send them as arguments.
-struct TSEGM_2_POLY_PRMS {
-    int m_textWidth;
-    int m_error;
-    SHAPE_POLY_SET* m_cornerBuffer;
-};
-TSEGM_2_POLY_PRMS prms;
-
-// This is a call back function, used by GRText to draw the 3D text shape:
-static void addTextSegmToPoly( int x0, int y0, int xf, int yf, void* aData )
-{
-    TSEGM_2_POLY_PRMS* prm = static_cast<TSEGM_2_POLY_PRMS*>( aData );
-    TransformSegmentToPolygon( *prm->m_cornerBuffer,
-                               wxPoint( x0, y0 ), wxPoint( xf, yf ),
-                               prm->m_error, prm->m_textWidth );
-}
-
 
 void BOARD::ConvertBrdLayerToPolygonalContours( PCB_LAYER_ID aLayer, SHAPE_POLY_SET& aOutlines )
 {
@@ -218,24 +198,19 @@ void MODULE::TransformGraphicShapesWithClearanceToPolygonSet( PCB_LAYER_ID aLaye
             texts.push_back( &Value() );
     }
 
-    prms.m_cornerBuffer = &aCornerBuffer;
-
     for( TEXTE_MODULE* textmod : texts )
     {
-        bool forceBold = true;
-        int  penWidth = 0;      // force max width for bold text
-
-        prms.m_textWidth  = textmod->GetEffectiveTextPenWidth() + ( 2 * aInflateValue );
-        prms.m_error = aError;
-        wxSize size = textmod->GetTextSize();
+        int textWidth = textmod->GetEffectiveTextPenWidth() + ( 2 * aInflateValue );
 
-        if( textmod->IsMirrored() )
-            size.x = -size.x;
+        // penWidth 0 forces max width for bold text
+        std::shared_ptr<const std::vector<wxPoint>> segments =
+                textmod->GetStrokeSegments( textmod->GetDrawRotation(), 0 );
 
-        GRText( NULL, textmod->GetTextPos(), BLACK, textmod->GetShownText(),
-                textmod->GetDrawRotation(), size, textmod->GetHorizJustify(),
-                textmod->GetVertJustify(), penWidth, textmod->IsItalic(), forceBold,
-                addTextSegmToPoly, &prms );
+        for( size_t ii = 0; ii + 1 < segments->size(); ii += 2 )
+        {
+            TransformSegmentToPolygon( aCornerBuffer, ( *segments )[ii], ( *segments )[ii + 1],
+                                       aError, textWidth );
+        }
     }
 }
 
@@ -311,38 +286,15 @@ void EDA_TEXT::TransformBoundingBoxWithClearanceToPolygon( SHAPE_POLY_SET* aCorn
 void TEXTE_PCB::TransformShapeWithClearanceToPolygonSet( SHAPE_POLY_SET& aCornerBuffer,
                                                          int aClearanceValue, int aError ) const
 {
-    wxSize size = GetTextSize();
-
-    if( IsMirrored() )
-        size.x = -size.x;
-
-    bool forceBold = true;
-    int  penWidth = GetEffectiveTextPenWidth();
-
-    prms.m_cornerBuffer = &aCornerBuffer;
-    prms.m_textWidth = GetEffectiveTextPenWidth() + ( 2 * aClearanceValue );
-    prms.m_error = aError;
-    COLOR4D color = COLOR4D::BLACK;  // not actually used, but needed by GRText
+    int textWidth = GetEffectiveTextPenWidth() + ( 2 * aClearanceValue );
 
-    if( IsMultilineAllowed() )
-    {
-        wxArrayString strings_list;
-        wxStringSplit( GetShownText(), strings_list, '\n' );
-        std::vector<wxPoint> positions;
-        positions.reserve( strings_list.Count() );
-        GetLinePositions( positions, strings_list.Count() );
+    std::shared_ptr<const std::vector<wxPoint>> segments =
+            GetStrokeSegments( GetTextAngle(), GetEffectiveTextPenWidth() );
 
-        for( unsigned ii = 0; ii < strings_list.Count(); ii++ )
-        {
-            wxString txt = strings_list.Item( ii );
-            GRText( NULL, positions[ii], color, txt, GetTextAngle(), size, GetHorizJustify(),
-                    GetVertJustify(), penWidth, IsItalic(), forceBold, addTextSegmToPoly, &prms );
-        }
-    }
-    else
+    for( size_t ii = 0; ii + 1 < segments->size(); ii += 2 )
     {
-        GRText( NULL, GetTextPos(), color, GetShownText(), GetTextAngle(), size, GetHorizJustify(),
-                GetVertJustify(), penWidth, IsItalic(), forceBold, addTextSegmToPoly, &prms );
+        TransformSegmentToPolygon( aCornerBuffer, ( *segments )[ii], ( *segments )[ii + 1],
+                                   aError, textWidth );
     }
 }
 
@@ -494,6 +446,17 @@ void D_PAD::TransformShapeWithClearanceToPolygon( SHAPE_POLY_SET& aCornerBuffer,
 {
     wxASSERT_MSG( !ignoreLineWidth, "IgnoreLineWidth has no meaning for pads." );
 
+    // The shape with no clearance is the cached board polygon, but for custom pads
+    if( aClearanceValue == 0 && GetShape() != PAD_SHAPE_CUSTOM )
+        aCornerBuffer.Append( GetBoardPolygon( aError ) );
+    else
+        transformShapeToPolygon( aCornerBuffer, aClearanceValue, aError );
+}
+
+
+void D_PAD::transformShapeToPolygon( SHAPE_POLY_SET& aCornerBuffer, int aClearanceValue,
+                                     int aError ) const
+{
     // minimal segment count to approximate a circle to create the polygonal pad shape
     // This minimal value is mainly for very small pads, like SM0402.
     // Most of time pads are using the segment count given by aError value.
@@ -595,11 +558,8 @@ void D_PAD::TransformShapeWithClearanceToPolygon( SHAPE_POLY_SET& aCornerBuffer,
 
     case PAD_SHAPE_CUSTOM:
     {
-        SHAPE_POLY_SET outline;     // Will contain the corners in board coordinates
-        outline.Append( m_customShapeAsPolygon );
-        CustomShapeAsPolygonToBoardPosition( &outline, GetPosition(), GetOrientation() );
-        // TODO: do we need the Simplify() & Fracture() if we're not inflating?
-        outline.Simplify( SHAPE_POLY_SET::PM_FAST );
+        // The corners in board coordinates, simplified
+        SHAPE_POLY_SET outline = boardPolygon( aError )->m_Simplified;
 
         if( aClearanceValue )
         {
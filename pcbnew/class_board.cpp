@@ -51,6 +51,7 @@
 #include <class_drawsegment.h>
 #include <class_pcb_target.h>
 #include <connectivity/connectivity_data.h>
+#include <zone_knockout_cache.h>
 #include <pgm_base.h>
 #include <pcbnew_settings.h>
 
@@ -136,11 +137,41 @@ BOARD::BOARD() :
 
     // Initialize ratsnest
     m_connectivity.reset( new CONNECTIVITY_DATA() );
+
+    m_zoneKnockoutCache.reset( new ZONE_KNOCKOUT_CACHE() );
+
+    m_memoryAccount.Set( "zone fills",
+            [this]()
+            {
+                MEMORY_ACCOUNTING::USAGE usage;
+
+                auto addZone = [&]( const ZONE_CONTAINER* aZone )
+                {
+                    usage.m_Bytes += sizeof( ZONE_CONTAINER ) + aZone->GetFillMemoryUsage();
+                    usage.m_Items++;
+                };
+
+                for( const ZONE_CONTAINER* zone : m_ZoneDescriptorList )
+                    addZone( zone );
+
+                for( const MODULE* module : m_modules )
+                {
+                    for( const MODULE_ZONE_CONTAINER* zone : module->Zones() )
+                        addZone( zone );
+                }
+
+                return usage;
+            } );
 }
 
 
 BOARD::~BOARD()
 {
+    m_memoryAccount.Reset();
+
+    InvokeListeners( &BOARD_LISTENER::OnBoardDestroyed, *this );
+    m_listeners.clear();
+
     while( m_ZoneDescriptorList.size() )
     {
         ZONE_CONTAINER* area_to_remove = m_ZoneDescriptorList[0];
@@ -599,6 +630,7 @@ void BOARD::Add( BOARD_ITEM* aBoardItem, ADD_MODE aMode )
 
     aBoardItem->SetParent( this );
     aBoardItem->ClearEditFlags();
+    cacheItem( aBoardItem );
     m_connectivity->Add( aBoardItem );
 
     InvokeListeners( &BOARD_LISTENER::OnBoardItemAdded, *this, aBoardItem );
@@ -679,7 +711,9 @@ void BOARD::Remove( BOARD_ITEM* aBoardItem )
         wxFAIL_MSG( wxT( "BOARD::Remove() needs more ::Type() support" ) );
     }
 
+    uncacheItem( aBoardItem );
     m_connectivity->Remove( aBoardItem );
+    m_zoneKnockoutCache->Invalidate( aBoardItem );
 
     InvokeListeners( &BOARD_LISTENER::OnBoardItemRemoved, *this, aBoardItem );
 }
@@ -695,7 +729,10 @@ void BOARD::DeleteMARKERs()
 {
     // the vector does not know how to delete the MARKER_PCB, it holds pointers
     for( MARKER_PCB* marker : m_markers )
+    {
+        uncacheItem( marker );
         delete marker;
+    }
 
     m_markers.clear();
 }
@@ -705,17 +742,127 @@ void BOARD::DeleteZONEOutlines()
 {
     // the vector does not know how to delete the ZONE Outlines, it holds pointers
     for( ZONE_CONTAINER* zone : m_ZoneDescriptorList )
+    {
+        uncacheItem( zone );
         delete zone;
+    }
 
     m_ZoneDescriptorList.clear();
 }
 
 
+/**
+ * @return the item of aModule (not aModule itself) with the KIID aID, or nullptr
+ */
+static BOARD_ITEM* findModuleItem( MODULE* aModule, const KIID& aID )
+{
+    for( D_PAD* pad : aModule->Pads() )
+        if( pad->m_Uuid == aID )
+            return pad;
+
+    if( aModule->Reference().m_Uuid == aID )
+        return &aModule->Reference();
+
+    if( aModule->Value().m_Uuid == aID )
+        return &aModule->Value();
+
+    for( BOARD_ITEM* drawing : aModule->GraphicalItems() )
+        if( drawing->m_Uuid == aID )
+            return drawing;
+
+    return nullptr;
+}
+
+
+void BOARD::cacheItem( BOARD_ITEM* aItem )
+{
+    if( aItem->Type() == PCB_NETINFO_T )
+        return;
+
+    m_itemByIdCache[ aItem->m_Uuid ] = aItem;
+
+    if( aItem->Type() == PCB_MODULE_T )
+    {
+        MODULE* module = static_cast<MODULE*>( aItem );
+
+        for( D_PAD* pad : module->Pads() )
+            m_moduleIdCache[ pad->m_Uuid ] = module->m_Uuid;
+
+        m_moduleIdCache[ module->Reference().m_Uuid ] = module->m_Uuid;
+        m_moduleIdCache[ module->Value().m_Uuid ] = module->m_Uuid;
+
+        for( BOARD_ITEM* drawing : module->GraphicalItems() )
+            m_moduleIdCache[ drawing->m_Uuid ] = module->m_Uuid;
+    }
+}
+
+
+void BOARD::uncacheItem( BOARD_ITEM* aItem )
+{
+    if( aItem->Type() == PCB_NETINFO_T )
+        return;
+
+    auto it = m_itemByIdCache.find( aItem->m_Uuid );
+
+    if( it != m_itemByIdCache.end() && it->second == aItem )
+    {
+        m_itemByIdCache.erase( it );
+    }
+    else
+    {
+        // The KIID of the item changed since it was added (or the item was not added): the
+        // index must not keep a pointer to it
+        for( it = m_itemByIdCache.begin(); it != m_itemByIdCache.end(); )
+        {
+            if( it->second == aItem )
+                it = m_itemByIdCache.erase( it );
+            else
+                ++it;
+        }
+    }
+
+    // The module items left in m_moduleIdCache are harmless: they only refer to a KIID
+    if( aItem->Type() == PCB_MODULE_T )
+    {
+        MODULE* module = static_cast<MODULE*>( aItem );
+
+        for( D_PAD* pad : module->Pads() )
+            m_moduleIdCache.erase( pad->m_Uuid );
+
+        m_moduleIdCache.erase( module->Reference().m_Uuid );
+        m_moduleIdCache.erase( module->Value().m_Uuid );
+
+        for( BOARD_ITEM* drawing : module->GraphicalItems() )
+            m_moduleIdCache.erase( drawing->m_Uuid );
+    }
+}
+
+
 BOARD_ITEM* BOARD::GetItem( const KIID& aID )
 {
     if( aID == niluuid )
         return nullptr;
 
+    auto it = m_itemByIdCache.find( aID );
+
+    if( it != m_itemByIdCache.end() && it->second->m_Uuid == aID )
+        return it->second;
+
+    auto moduleIdIt = m_moduleIdCache.find( aID );
+
+    if( moduleIdIt != m_moduleIdCache.end() )
+    {
+        it = m_itemByIdCache.find( moduleIdIt->second );
+
+        if( it != m_itemByIdCache.end() && it->second->Type() == PCB_MODULE_T )
+        {
+            if( BOARD_ITEM* item = findModuleItem( static_cast<MODULE*>( it->second ), aID ) )
+                return item;
+        }
+    }
+
+    // Not indexed (added to a module after the module was added to the board, or not added
+    // through Add()): search the board
     for( TRACK* track : Tracks() )
         if( track->m_Uuid == aID )
             return track;
@@ -725,19 +872,11 @@ BOARD_ITEM* BOARD::GetItem( const KIID& aID )
         if( module->m_Uuid == aID )
             return module;
 
-        for( D_PAD* pad : module->Pads() )
-            if( pad->m_Uuid == aID )
-                return pad;
-
-        if( module->Reference().m_Uuid == aID )
-            return &module->Reference();
-
-        if( module->Value().m_Uuid == aID )
-            return &module->Value();
-
-        for( BOARD_ITEM* drawing : module->GraphicalItems() )
-            if( drawing->m_Uuid == aID )
-                return drawing;
+        if( BOARD_ITEM* item = findModuleItem( module, aID ) )
+        {
+            m_moduleIdCache[ aID ] = module->m_Uuid;
+            return item;
+        }
     }
 
     for( ZONE_CONTAINER* zone : Zones() )
@@ -33,12 +33,14 @@
 #include <common.h> // PAGE_INFO
 #include <eda_rect.h>
 #include <layers_id_colors_and_visibility.h>
+#include <memory_accounting.h>
 #include <netinfo.h>
 #include <pcb_plot_params.h>
 #include <title_block.h>
 #include <zone_settings.h>
 
 #include <memory>
+#include <unordered_map>
 
 class PCB_BASE_FRAME;
 class PCB_EDIT_FRAME;
@@ -54,6 +56,8 @@ class NETLIST;
 class REPORTER;
 class SHAPE_POLY_SET;
 class CONNECTIVITY_DATA;
+class ZONE_KNOCKOUT_CACHE;
+struct CN_SNAPSHOT;
 class COMPONENT;
 class PROJECT;
 
@@ -166,6 +170,9 @@ public:
     virtual void OnBoardNetSettingsChanged( BOARD& aBoard ) { }
     virtual void OnBoardItemChanged( BOARD& aBoard, BOARD_ITEM* aBoardItem ) { }
     virtual void OnBoardHighlightNetChanged( BOARD& aBoard ) { }
+
+    /// Called first by the destructor of the board, which forgets its listeners afterwards
+    virtual void OnBoardDestroyed( BOARD& aBoard ) { }
 };
 
 
@@ -210,6 +217,10 @@ private:
     int                     m_fileFormatVersionAtLoad;  // the version loaded from the file
 
     std::shared_ptr<CONNECTIVITY_DATA>      m_connectivity;
+    std::shared_ptr<ZONE_KNOCKOUT_CACHE>    m_zoneKnockoutCache;
+    std::shared_ptr<CN_SNAPSHOT>            m_connectivitySnapshot;
+
+    MEMORY_ACCOUNT          m_memoryAccount;            // the memory of the zone fills
 
     BOARD_DESIGN_SETTINGS   m_designSettings;
     PCBNEW_SETTINGS*        m_generalSettings;      // reference only; I have no ownership
@@ -221,6 +232,16 @@ private:
 
     std::vector<BOARD_LISTENER*> m_listeners;
 
+    /// The items added to the board by their KIID, to find them without searching the board
+    std::unordered_map<KIID, BOARD_ITEM*> m_itemByIdCache;
+
+    /// The KIID of the module of the module items (pads, texts, graphics) by their KIID.
+    /// The module is looked up in m_itemByIdCache, so its items can be replaced freely.
+    std::unordered_map<KIID, KIID>        m_moduleIdCache;
+
+    void cacheItem( BOARD_ITEM* aItem );
+    void uncacheItem( BOARD_ITEM* aItem );
+
     // The default copy constructor & operator= are inadequate,
     // either write one or do not use it at all
     BOARD( const BOARD& aOther ) = delete;
@@ -318,11 +339,20 @@ public:
     void DeleteAllModules()
     {
         for( MODULE* mod : m_modules )
+        {
+            uncacheItem( mod );
             delete mod;
+        }
 
         m_modules.clear();
     }
 
+    /**
+     * Function GetItem()
+     * Finds the item of the board with the KIID aID, through a hash index of the items
+     * added by Add() (the board is searched only if the item is not in the index).
+     * @return the item, nullptr for niluuid, or a DELETED_BOARD_ITEM if not found
+     */
     BOARD_ITEM* GetItem( const KIID& aID );
 
     void FillItemMap( std::map<KIID, EDA_ITEM*>& aMap );
@@ -334,6 +364,31 @@ public:
      */
     std::shared_ptr<CONNECTIVITY_DATA> GetConnectivity() const { return m_connectivity; }
 
+    /**
+     * Function GetZoneKnockoutCache()
+     * returns the cache of the item knockouts built by the zone filler.
+     */
+    std::shared_ptr<ZONE_KNOCKOUT_CACHE> GetZoneKnockoutCache() const
+    {
+        return m_zoneKnockoutCache;
+    }
+
+    /**
+     * Function SetConnectivitySnapshot()
+     * sets the connections saved with the board file, restored by the connectivity builds
+     * instead of searched.  The loader of the board clears it once the board is loaded: it
+     * would not match an edited board.
+     */
+    void SetConnectivitySnapshot( std::shared_ptr<CN_SNAPSHOT> aSnapshot )
+    {
+        m_connectivitySnapshot = aSnapshot;
+    }
+
+    const std::shared_ptr<CN_SNAPSHOT>& GetConnectivitySnapshot() const
+    {
+        return m_connectivitySnapshot;
+    }
+
     /**
      * Builds or rebuilds the board connectivity database for the board,
      * especially the list of connected items, list of nets and rastnest data
@@ -40,12 +40,15 @@
 #include <class_board.h>
 #include <class_edge_mod.h>
 #include <class_module.h>
+#include <class_zone.h>
 #include <convert_basic_shapes_to_polygon.h>
 #include <view/view.h>
 
 MODULE::MODULE( BOARD* parent ) :
     BOARD_ITEM_CONTAINER( (BOARD_ITEM*) parent, PCB_MODULE_T ),
-    m_initial_comments( 0 )
+    m_initial_comments( 0 ),
+    m_poly_courtyard_built( false ),
+    m_poly_courtyard_valid( true )
 {
     m_Attributs    = MOD_DEFAULT;
     m_Layer        = F_Cu;
@@ -147,6 +150,10 @@ MODULE::MODULE( const MODULE& aModule ) :
 
     m_initial_comments = aModule.m_initial_comments ?
                             new wxArrayString( *aModule.m_initial_comments ) : nullptr;
+
+    // The courtyard polygons are not copied; they will be rebuilt when needed
+    m_poly_courtyard_built = false;
+    m_poly_courtyard_valid = true;
 }
 
 
@@ -190,6 +197,10 @@ MODULE& MODULE::operator=( const MODULE& aOther )
     m_Link          = aOther.m_Link;
     m_Path          = aOther.m_Path;
 
+    // The courtyard polygons are not copied; they will be rebuilt when needed
+    m_poly_courtyard_built = false;
+    m_poly_courtyard_valid = true;
+
     m_LocalClearance                = aOther.m_LocalClearance;
     m_LocalSolderMaskMargin         = aOther.m_LocalSolderMaskMargin;
     m_LocalSolderPasteMargin        = aOther.m_LocalSolderPasteMargin;
@@ -296,6 +307,19 @@ void MODULE::ClearAllNets()
 }
 
 
+size_t MODULE::GetMemoryUsage( bool aCountSharedFills ) const
+{
+    // The texts are counted as graphic items, which are as large
+    size_t bytes = sizeof( MODULE ) + m_pads.size() * sizeof( D_PAD )
+                   + ( m_drawings.size() + 2 ) * sizeof( EDGE_MODULE );
+
+    for( const MODULE_ZONE_CONTAINER* zone : m_fp_zones )
+        bytes += sizeof( MODULE_ZONE_CONTAINER ) + zone->GetFillMemoryUsage( aCountSharedFills );
+
+    return bytes;
+}
+
+
 void MODULE::Add( BOARD_ITEM* aBoardItem, ADD_MODE aMode )
 {
     switch( aBoardItem->Type() )
@@ -1458,15 +1482,69 @@ double MODULE::CoverageRatio( const GENERAL_COLLECTOR& aCollector ) const
 extern bool ConvertOutlineToPolygon( std::vector<DRAWSEGMENT*>& aSegList, SHAPE_POLY_SET& aPolygons,
         wxString* aErrorText, unsigned int aTolerance, wxPoint* aErrorLocation = nullptr );
 
+bool MODULE::COURTYARD_KEY::ITEM::operator==( const ITEM& aOther ) const
+{
+    return m_Layer == aOther.m_Layer
+        && m_Shape == aOther.m_Shape
+        && m_Start == aOther.m_Start
+        && m_End == aOther.m_End
+        && m_BezierC1 == aOther.m_BezierC1
+        && m_BezierC2 == aOther.m_BezierC2
+        && m_Angle == aOther.m_Angle
+        && m_PolyPoints == aOther.m_PolyPoints;
+}
+
+
+bool MODULE::COURTYARD_KEY::operator==( const COURTYARD_KEY& aOther ) const
+{
+    return m_Pos == aOther.m_Pos
+        && m_Orient == aOther.m_Orient
+        && m_Items == aOther.m_Items;
+}
+
+
+MODULE::COURTYARD_KEY MODULE::courtyardKey( const std::vector<DRAWSEGMENT*>& aItems ) const
+{
+    COURTYARD_KEY key;
+
+    // Polygons are stored relative to the footprint
+    key.m_Pos = m_Pos;
+    key.m_Orient = m_Orient;
+    key.m_Items.reserve( aItems.size() );
+
+    for( const DRAWSEGMENT* item : aItems )
+    {
+        COURTYARD_KEY::ITEM itemKey;
+
+        itemKey.m_Layer = item->GetLayer();
+        itemKey.m_Shape = item->GetShape();
+        itemKey.m_Start = item->GetStart();
+        itemKey.m_End = item->GetEnd();
+        itemKey.m_BezierC1 = item->GetBezControl1();
+        itemKey.m_BezierC2 = item->GetBezControl2();
+        itemKey.m_Angle = item->GetAngle();
+
+        if( item->GetShape() == S_POLYGON )
+        {
+            for( auto it = item->GetPolyShape().CIterate(); it; it++ )
+                itemKey.m_PolyPoints.emplace_back( (wxPoint) *it );
+        }
+
+        key.m_Items.push_back( std::move( itemKey ) );
+    }
+
+    return key;
+}
+
+
 bool MODULE::BuildPolyCourtyard()
 {
-    m_poly_courtyard_front.RemoveAllContours();
-    m_poly_courtyard_back.RemoveAllContours();
     // Build the courtyard area from graphic items on the courtyard.
     // Only PCB_MODULE_EDGE_T have meaning, graphic texts are ignored.
     // Collect items:
     std::vector< DRAWSEGMENT* > list_front;
     std::vector< DRAWSEGMENT* > list_back;
+    std::vector< DRAWSEGMENT* > list_all;
 
     for( auto item : GraphicalItems() )
     {
@@ -1477,6 +1555,21 @@ bool MODULE::BuildPolyCourtyard()
             list_front.push_back( static_cast< DRAWSEGMENT* > ( item ) );
     }
 
+    list_all = list_front;
+    list_all.insert( list_all.end(), list_back.begin(), list_back.end() );
+
+    // Converting the outlines is slow; don't redo it while the courtyard is unchanged.
+    COURTYARD_KEY key = courtyardKey( list_all );
+
+    if( m_poly_courtyard_built && key == m_poly_courtyard_key )
+        return m_poly_courtyard_valid;
+
+    m_poly_courtyard_front.RemoveAllContours();
+    m_poly_courtyard_back.RemoveAllContours();
+    m_poly_courtyard_key = std::move( key );
+    m_poly_courtyard_built = true;
+    m_poly_courtyard_valid = true;
+
     // Note: if no item found on courtyard layers, return true.
     // false is returned only when the shape defined on courtyard layers
     // is not convertible to a polygon
@@ -1504,6 +1597,12 @@ bool MODULE::BuildPolyCourtyard()
                                         error_msg) );
     }
 
+    // The courtyard tests rely on the bounding box caches
+    m_poly_courtyard_front.BuildBBoxCaches();
+    m_poly_courtyard_back.BuildBBoxCaches();
+
+    m_poly_courtyard_valid = success;
+
     return success;
 }
 
@@ -43,6 +43,7 @@
 class LINE_READER;
 class EDA_3D_CANVAS;
 class D_PAD;
+class DRAWSEGMENT;
 class BOARD;
 class MSG_PANEL_ITEM;
 
@@ -191,6 +192,13 @@ public:
         return m_drawings;
     }
 
+    /**
+     * Function GetMemoryUsage
+     * estimates the memory held by the footprint and its items.
+     * @param aCountSharedFills = false to leave out the zone fills shared with other zones
+     */
+    size_t GetMemoryUsage( bool aCountSharedFills = true ) const;
+
     /**
      * @return true if the given module has any non smd pins, such as through hole
      * and therefore cannot be placed automatically.
@@ -668,7 +676,9 @@ public:
     SHAPE_POLY_SET& GetPolyCourtyardBack() { return m_poly_courtyard_back; }
 
     /**
-     * Builds a complex polygon of the courtyard area from graphic items on the courtyard layer
+     * Builds a complex polygon of the courtyard area from graphic items on the courtyard layer.
+     * The polygons are only rebuilt if the courtyard items (or the footprint placement) have
+     * changed since the last call.
      * @return true if OK, or no courtyard defined,
      *         false only if the polygon cannot be built due to a malformed courtyard shape
      */
@@ -681,6 +691,33 @@ public:
 #endif
 
 private:
+    /// The inputs of the courtyard polygons, compared to build them again only when needed
+    struct COURTYARD_KEY
+    {
+        /// The properties of a courtyard item which its outline depends on
+        struct ITEM
+        {
+            PCB_LAYER_ID         m_Layer;
+            STROKE_T             m_Shape;
+            wxPoint              m_Start;
+            wxPoint              m_End;
+            wxPoint              m_BezierC1;
+            wxPoint              m_BezierC2;
+            double               m_Angle;
+            std::vector<wxPoint> m_PolyPoints;     ///< the corners of a S_POLYGON
+
+            bool operator==( const ITEM& aOther ) const;
+        };
+
+        wxPoint           m_Pos;
+        double            m_Orient;
+        std::vector<ITEM> m_Items;                 ///< front items first, then back items
+
+        bool operator==( const COURTYARD_KEY& aOther ) const;
+    };
+
+    COURTYARD_KEY courtyardKey( const std::vector<DRAWSEGMENT*>& aItems ) const;
+
     DRAWINGS        m_drawings;         // BOARD_ITEMs for drawings on the board, owned by pointer.
     PADS            m_pads;             // D_PAD items, owned by pointer
     MODULE_ZONE_CONTAINERS m_fp_zones;  // MODULE_ZONE_CONTAINER items, owned by pointer
@@ -719,6 +756,9 @@ private:
     /// Note also a footprint can have courtyards on both board sides
     SHAPE_POLY_SET m_poly_courtyard_front;
     SHAPE_POLY_SET m_poly_courtyard_back;
+    COURTYARD_KEY  m_poly_courtyard_key;    ///< inputs of the courtyard when last built
+    bool           m_poly_courtyard_built;  ///< false until built, and in a copy
+    bool           m_poly_courtyard_valid;  ///< result of the last BuildPolyCourtyard()
 };
 
 #endif     // MODULE_H_
@@ -388,9 +388,8 @@ const EDA_RECT D_PAD::GetBoundingBox() const
 
     case PAD_SHAPE_CUSTOM:
         {
-        SHAPE_POLY_SET polySet( m_customShapeAsPolygon );
-        // Move shape to actual position
-        CustomShapeAsPolygonToBoardPosition( &polySet, GetPosition(), GetOrientation() );
+        // The shape at its actual position
+        SHAPE_POLY_SET polySet = GetBoardPolygon();
         quadrant1 = m_Pos;
         quadrant2 = m_Pos;
 
@@ -466,6 +465,84 @@ void D_PAD::SetProperty( PAD_PROP_T aProperty )
 }
 
 
+bool D_PAD::BOARD_POLYGON_KEY::operator==( const BOARD_POLYGON_KEY& aOther ) const
+{
+    return m_Pos == aOther.m_Pos
+        && m_Offset == aOther.m_Offset
+        && m_Size == aOther.m_Size
+        && m_DeltaSize == aOther.m_DeltaSize
+        && m_Orient == aOther.m_Orient
+        && m_Shape == aOther.m_Shape
+        && m_RoundRectRadiusScale == aOther.m_RoundRectRadiusScale
+        && m_ChamferRectScale == aOther.m_ChamferRectScale
+        && m_ChamferPositions == aOther.m_ChamferPositions
+        && m_MaxError == aOther.m_MaxError;
+}
+
+
+D_PAD::BOARD_POLYGON_KEY D_PAD::boardPolygonKey( int aMaxError ) const
+{
+    BOARD_POLYGON_KEY key;
+
+    key.m_Pos = m_Pos;
+    key.m_Offset = m_Offset;
+    key.m_Size = m_Size;
+    key.m_DeltaSize = m_DeltaSize;
+    key.m_Orient = m_Orient;
+    key.m_Shape = m_padShape;
+    key.m_RoundRectRadiusScale = m_padRoundRectRadiusScale;
+    key.m_ChamferRectScale = m_padChamferRectScale;
+    key.m_ChamferPositions = m_chamferPositions;
+
+    // The custom shape is already approximated: the error only matters for the other shapes
+    key.m_MaxError = ( m_padShape == PAD_SHAPE_CUSTOM ) ? 0 : aMaxError;
+
+    return key;
+}
+
+
+std::shared_ptr<const D_PAD::BOARD_POLYGON> D_PAD::boardPolygon( int aMaxError ) const
+{
+    BOARD_POLYGON_KEY                    key = boardPolygonKey( aMaxError );
+    std::shared_ptr<const BOARD_POLYGON> cached = std::atomic_load( &m_boardPolygon );
+
+    if( cached && cached->m_Key == key )
+        return cached;
+
+    auto           polygon = std::make_shared<BOARD_POLYGON>();
+    SHAPE_POLY_SET outline;
+
+    if( GetShape() == PAD_SHAPE_CUSTOM )
+    {
+        outline.Append( m_customShapeAsPolygon );
+        CustomShapeAsPolygonToBoardPosition( &outline, GetPosition(), GetOrientation() );
+
+        SHAPE_POLY_SET simplified( outline );
+        simplified.Simplify( SHAPE_POLY_SET::PM_FAST );
+        polygon->m_Simplified = simplified;
+    }
+    else
+    {
+        transformShapeToPolygon( outline, 0, aMaxError );
+    }
+
+    // Assigned, the polygons get a storage which their copies can share
+    polygon->m_Key = key;
+    polygon->m_Polygon = outline;
+
+    // Two threads may build it together: both are the same
+    std::atomic_store( &m_boardPolygon, std::shared_ptr<const BOARD_POLYGON>( polygon ) );
+
+    return polygon;
+}
+
+
+void D_PAD::invalidateBoardPolygon()
+{
+    std::atomic_store( &m_boardPolygon, std::shared_ptr<const BOARD_POLYGON>() );
+}
+
+
 void D_PAD::SetOrientation( double aAngle )
 {
     NORMALIZE_ANGLE_POS( aAngle );
@@ -531,6 +608,7 @@ void D_PAD::FlipPrimitives()
 
     // Flip local coordinates in merged Polygon
     m_customShapeAsPolygon.Mirror( false, true );
+    invalidateBoardPolygon();
 }
 
 
@@ -563,6 +641,8 @@ void D_PAD::MirrorXPrimitives( int aX )
         SHAPE_LINE_CHAIN& poly = m_customShapeAsPolygon.Outline( cnt );
         poly.Mirror( true, false );
     }
+
+    invalidateBoardPolygon();
 }
 
 
@@ -1574,6 +1654,20 @@ unsigned int D_PAD::ViewGetLOD( int aLayer, KIGFX::VIEW* aView ) const
 }
 
 
+int D_PAD::ViewGetProxyLayer() const
+{
+    // The copper layer of ViewGetLayers()
+    if( IsOnLayer( F_Cu ) && IsOnLayer( B_Cu ) )
+        return LAYER_PADS_TH;
+    else if( IsOnLayer( F_Cu ) )
+        return LAYER_PAD_FR;
+    else if( IsOnLayer( B_Cu ) )
+        return LAYER_PAD_BK;
+
+    return -1;
+}
+
+
 const BOX2I D_PAD::ViewBBox() const
 {
     // Bounding box includes soldermask too
@@ -38,6 +38,8 @@
 #include <pad_shapes.h>
 #include <pcbnew.h>
 
+#include <memory>
+
 class DRAWSEGMENT;
 class PARAM_CFG;
 
@@ -362,6 +364,21 @@ public:
      */
     const SHAPE_POLY_SET& GetCustomShapeAsPolygon() const { return m_customShapeAsPolygon; }
 
+    /**
+     * The pad shape at its board position: the custom shape polygon as moved by
+     * CustomShapeAsPolygonToBoardPosition() to the pad position, or the polygon built by
+     * TransformShapeWithClearanceToPolygon() with no clearance for the other shapes.
+     *
+     * It is built once and kept until the pad shape, size, position or orientation changes.
+     * The copy shares the polygon storage: it is cheap.  Can be called from several threads.
+     *
+     * @param aMaxError is the maximum error from true when converting arcs
+     */
+    SHAPE_POLY_SET GetBoardPolygon( int aMaxError = ARC_HIGH_DEF ) const
+    {
+        return boardPolygon( aMaxError )->m_Polygon;
+    }
+
     void Flip( const wxPoint& aCentre, bool aFlipLeftRight ) override;
 
     /**
@@ -801,6 +818,8 @@ public:
 
     virtual unsigned int ViewGetLOD( int aLayer, KIGFX::VIEW* aView ) const override;
 
+    virtual int ViewGetProxyLayer() const override;
+
     virtual const BOX2I ViewBBox() const override;
 
     virtual void SwapData( BOARD_ITEM* aImage ) override;
@@ -819,6 +838,46 @@ private:
 
     bool buildCustomPadPolygon( SHAPE_POLY_SET* aMergedPolygon, int aError );
 
+    /// TransformShapeWithClearanceToPolygon(), without the board polygon cache
+    void transformShapeToPolygon( SHAPE_POLY_SET& aCornerBuffer, int aClearanceValue,
+                                  int aMaxError ) const;
+
+    /// Drop the board polygon, when m_customShapeAsPolygon changes
+    void invalidateBoardPolygon();
+
+    /**
+     * What the board polygon is built from: it is built again when one of them changes.
+     * Compared on each access instead of being reset by each setter, as the members are
+     * also changed directly (moves, rotations, flips...).
+     */
+    struct BOARD_POLYGON_KEY
+    {
+        wxPoint     m_Pos;
+        wxPoint     m_Offset;
+        wxSize      m_Size;
+        wxSize      m_DeltaSize;
+        double      m_Orient;
+        PAD_SHAPE_T m_Shape;
+        double      m_RoundRectRadiusScale;
+        double      m_ChamferRectScale;
+        int         m_ChamferPositions;
+        int         m_MaxError;
+
+        bool operator==( const BOARD_POLYGON_KEY& aOther ) const;
+    };
+
+    struct BOARD_POLYGON
+    {
+        BOARD_POLYGON_KEY m_Key;
+        SHAPE_POLY_SET    m_Polygon;
+        SHAPE_POLY_SET    m_Simplified;     ///< for custom pads, m_Polygon simplified
+    };
+
+    BOARD_POLYGON_KEY boardPolygonKey( int aMaxError ) const;
+
+    /// @return the cached board polygon, built again if the pad changed
+    std::shared_ptr<const BOARD_POLYGON> boardPolygon( int aMaxError ) const;
+
 private:    // Private variable members:
 
     // Actually computed and cached on demand by the accessor
@@ -846,6 +905,11 @@ private:    // Private variable members:
      */
     SHAPE_POLY_SET m_customShapeAsPolygon;
 
+    /// The cached GetBoardPolygon(), immutable once built, shared by the copies of the pad.
+    /// Accessed with std::atomic_load/atomic_store: the DRC and the zone filler threads
+    /// build it concurrently.
+    mutable std::shared_ptr<const BOARD_POLYGON> m_boardPolygon;
+
     /**
      * How to build the custom shape in zone, to create the clearance area:
      * CUST_PAD_SHAPE_IN_ZONE_OUTLINE = use pad shape
@@ -39,6 +39,41 @@
 #include <pgm_base.h>
 #include <settings/color_settings.h>
 #include <settings/settings_manager.h>
+#include <connectivity/connectivity_pool.h>
+
+
+template <class T>
+using TRACK_POOL = CN_POOL<sizeof( T ), alignof( T )>;
+
+
+void* TRACK::operator new( size_t aSize )
+{
+    // A class derived from them elsewhere gets the default allocation
+    if( aSize == sizeof( TRACK ) )
+        return TRACK_POOL<TRACK>::Instance().Allocate();
+    else if( aSize == sizeof( ARC ) )
+        return TRACK_POOL<ARC>::Instance().Allocate();
+    else if( aSize == sizeof( VIA ) )
+        return TRACK_POOL<VIA>::Instance().Allocate();
+
+    return ::operator new( aSize );
+}
+
+
+void TRACK::operator delete( void* aPtr, size_t aSize )
+{
+    if( !aPtr )
+        return;
+
+    if( aSize == sizeof( TRACK ) )
+        TRACK_POOL<TRACK>::Instance().Free( aPtr );
+    else if( aSize == sizeof( ARC ) )
+        TRACK_POOL<ARC>::Instance().Free( aPtr );
+    else if( aSize == sizeof( VIA ) )
+        TRACK_POOL<VIA>::Instance().Free( aPtr );
+    else
+        ::operator delete( aPtr );
+}
 
 
 TRACK::TRACK( BOARD_ITEM* aParent, KICAD_T idtype ) :
@@ -496,6 +531,12 @@ unsigned int TRACK::ViewGetLOD( int aLayer, KIGFX::VIEW* aView ) const
 }
 
 
+int TRACK::ViewGetProxyLayer() const
+{
+    return GetLayer();
+}
+
+
 const BOX2I TRACK::ViewBBox() const
 {
     BOX2I bbox = GetBoundingBox();
@@ -539,6 +580,18 @@ void VIA::ViewGetLayers( int aLayers[], int& aCount ) const
 }
 
 
+int VIA::ViewGetProxyLayer() const
+{
+    switch( GetViaType() )
+    {
+    case VIATYPE::THROUGH:      return LAYER_VIA_THROUGH;
+    case VIATYPE::BLIND_BURIED: return LAYER_VIA_BBLIND;
+    case VIATYPE::MICROVIA:     return LAYER_VIA_MICROVIA;
+    default:                    return -1;
+    }
+}
+
+
 unsigned int VIA::ViewGetLOD( int aLayer, KIGFX::VIEW* aView ) const
 {
     constexpr unsigned int HIDE = std::numeric_limits<unsigned int>::max();
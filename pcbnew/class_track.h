@@ -94,6 +94,11 @@ public:
 
     // Do not create a copy constructor.  The one generated by the compiler is adequate.
 
+    ///> Tracks, arcs and vias are taken from pools, one per class: a large board has hundreds
+    ///> of thousands of them, which are then packed together in large blocks.
+    static void* operator new( size_t aSize );
+    static void operator delete( void* aPtr, size_t aSize );
+
     void Move( const wxPoint& aMoveVector ) override
     {
         m_Start += aMoveVector;
@@ -220,6 +225,8 @@ public:
 
     virtual unsigned int ViewGetLOD( int aLayer, KIGFX::VIEW* aView ) const override;
 
+    virtual int ViewGetProxyLayer() const override;
+
     const BOX2I ViewBBox() const override;
 
     virtual void SwapData( BOARD_ITEM* aImage ) override;
@@ -424,6 +431,8 @@ public:
 
     unsigned int ViewGetLOD( int aLayer, KIGFX::VIEW* aView ) const override;
 
+    int ViewGetProxyLayer() const override;
+
     void Flip( const wxPoint& aCentre, bool aFlipLeftRight ) override;
 
 #if defined (DEBUG)
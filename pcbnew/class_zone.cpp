@@ -38,6 +38,7 @@
 #include <class_zone.h>
 #include <pcbnew.h>
 #include <zones.h>
+#include <zone_fill_pack.h>
 #include <math_for_graphics.h>
 #include <geometry/polygon_test_point_inside.h>
 #include <math/util.h>      // for KiROUND
@@ -77,6 +78,10 @@ ZONE_CONTAINER::ZONE_CONTAINER( BOARD_ITEM_CONTAINER* aParent, bool aInModule )
     aParent->GetZoneSettings().ExportSetting( *this );
 
     m_needRefill = false;   // True only after some edition.
+
+    m_dirtyRegionValid = false;
+    m_fillSettingsHash = 0;
+    m_fillInputsRevision = 0;
 }
 
 
@@ -107,10 +112,11 @@ ZONE_CONTAINER& ZONE_CONTAINER::operator=( const ZONE_CONTAINER& aOther )
     SetHatchStyle( aOther.GetHatchStyle() );
     SetHatchPitch( aOther.GetHatchPitch() );
     m_HatchLines = aOther.m_HatchLines;     // copy vector <SEG>
-    m_FilledPolysList.RemoveAllContours();
-    m_FilledPolysList.Append( aOther.m_FilledPolysList );
-    m_FillSegmList.clear();
+    // The polygons are shared with aOther until one of the zones is refilled
+    m_FilledPolysList = aOther.m_FilledPolysList;
     m_FillSegmList = aOther.m_FillSegmList;
+    m_packedFill = aOther.m_packedFill;
+    m_fillFingerprint = aOther.m_fillFingerprint;
 
     m_HatchFillTypeThickness = aOther.m_HatchFillTypeThickness;
     m_HatchFillTypeGap = aOther.m_HatchFillTypeGap;
@@ -120,6 +126,9 @@ ZONE_CONTAINER& ZONE_CONTAINER::operator=( const ZONE_CONTAINER& aOther )
 
     SetLayerSet( aOther.GetLayerSet() );
 
+    // The raw fill is not copied, so an incremental refill has nothing to start from
+    InvalidateDirtyRegion();
+
     return *this;
 }
 
@@ -158,8 +167,10 @@ void ZONE_CONTAINER::initDataFromSrcInCopyCtor( const ZONE_CONTAINER& aZone )
     m_PadConnection = aZone.m_PadConnection;
     m_ThermalReliefGap = aZone.m_ThermalReliefGap;
     m_ThermalReliefCopperBridge = aZone.m_ThermalReliefCopperBridge;
-    m_FilledPolysList.Append( aZone.m_FilledPolysList );
+    m_FilledPolysList = aZone.m_FilledPolysList; // shared until one of the zones is refilled
     m_FillSegmList = aZone.m_FillSegmList;      // vector <> copy
+    m_packedFill = aZone.m_packedFill;
+    m_fillFingerprint = aZone.m_fillFingerprint;
 
     m_doNotAllowCopperPour = aZone.m_doNotAllowCopperPour;
     m_doNotAllowVias = aZone.m_doNotAllowVias;
@@ -189,6 +200,11 @@ void ZONE_CONTAINER::initDataFromSrcInCopyCtor( const ZONE_CONTAINER& aZone )
     m_area = aZone.m_area;
 
     SetNeedRefill( aZone.NeedRefill() );
+
+    // The raw fill is not copied, so an incremental refill has nothing to start from
+    m_dirtyRegionValid = false;
+    m_fillSettingsHash = 0;
+    m_fillInputsRevision = 0;
 }
 
 
@@ -198,6 +214,24 @@ EDA_ITEM* ZONE_CONTAINER::Clone() const
 }
 
 
+void ZONE_CONTAINER::CopyFill( const ZONE_CONTAINER& aZone )
+{
+    m_IsFilled = aZone.m_IsFilled;
+    m_needRefill = aZone.m_needRefill;
+    m_FilledPolysUseThickness = aZone.m_FilledPolysUseThickness;
+    m_FilledPolysList = aZone.m_FilledPolysList;    // shared until one of the zones is refilled
+    m_RawPolysList = aZone.m_RawPolysList;
+    m_FillSegmList = aZone.m_FillSegmList;
+    m_packedFill = aZone.m_packedFill;
+    m_area = aZone.m_area;
+
+    m_dirtyRegion = aZone.m_dirtyRegion;
+    m_dirtyRegionValid = aZone.m_dirtyRegionValid;
+    m_fillSettingsHash = aZone.m_fillSettingsHash;
+    m_fillFingerprint = aZone.m_fillFingerprint;
+}
+
+
 bool ZONE_CONTAINER::UnFill()
 {
     bool change = ( !m_FilledPolysList.IsEmpty() || m_FillSegmList.size() > 0 );
@@ -205,6 +239,7 @@ bool ZONE_CONTAINER::UnFill()
     m_FilledPolysList.RemoveAllContours();
     m_FillSegmList.clear();
     m_IsFilled = false;
+    m_fillFingerprint.clear();
 
     return change;
 }
@@ -1085,6 +1120,67 @@ void ZONE_CONTAINER::CacheTriangulation()
 }
 
 
+void ZONE_CONTAINER::PackFill()
+{
+    if( m_packedFill || m_FilledPolysList.IsStorageShared() )
+        return;
+
+    if( m_FilledPolysList.IsEmpty() && m_FillSegmList.empty() )
+        return;
+
+    m_packedFill = ZONE_FILL_PACK::Pack( m_FilledPolysList, m_FillSegmList );
+
+    if( m_packedFill )
+    {
+        m_FilledPolysList.RemoveAllContours();
+        m_FillSegmList.clear();
+        m_FillSegmList.shrink_to_fit();
+    }
+}
+
+
+void ZONE_CONTAINER::UnpackFill()
+{
+    if( !m_packedFill )
+        return;
+
+    // A corrupted pack leaves the zone unfilled: a refill restores it
+    if( !m_packedFill->Unpack( m_FilledPolysList, m_FillSegmList ) )
+        wxLogDebug( wxT( "ZONE_CONTAINER::UnpackFill(): corrupted fill" ) );
+
+    m_packedFill.reset();
+}
+
+
+size_t ZONE_CONTAINER::GetFillMemoryUsage( bool aCountShared ) const
+{
+    // A point of a chain is a VECTOR2I and the index of its arc
+    const size_t pointSize = sizeof( VECTOR2I ) + sizeof( ssize_t );
+    size_t       bytes = m_FillSegmList.capacity() * sizeof( SEG );
+
+    if( aCountShared || !m_FilledPolysList.IsStorageShared() )
+    {
+        bytes += m_FilledPolysList.TotalVertices() * pointSize;
+
+        for( unsigned ii = 0; ii < m_FilledPolysList.TriangulatedPolyCount(); ii++ )
+        {
+            const SHAPE_POLY_SET::TRIANGULATED_POLYGON* tri =
+                    m_FilledPolysList.TriangulatedPolygon( ii );
+
+            bytes += tri->GetVertexCount() * sizeof( VECTOR2I );
+            bytes += tri->GetTriangleCount() * sizeof( SHAPE_POLY_SET::TRIANGULATED_POLYGON::TRI );
+        }
+    }
+
+    bytes += m_RawPolysList.TotalVertices() * pointSize;
+
+    if( m_packedFill )
+        bytes += m_packedFill->GetSize();
+
+    return bytes;
+}
+
+
 /*
  * Some intersecting zones, despite being on the same layer with the same net, cannot be
  * merged due to other parameters such as fillet radius.  The copper pour will end up
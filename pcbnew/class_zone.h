@@ -30,6 +30,7 @@
 #define CLASS_ZONE_H_
 
 
+#include <memory>
 #include <vector>
 #include <gr_basic.h>
 #include <class_board_item.h>
@@ -38,6 +39,8 @@
 #include <geometry/shape_poly_set.h>
 #include <zone_settings.h>
 
+class ZONE_FILL_PACK;
+
 
 class EDA_RECT;
 class LINE_READER;
@@ -591,6 +594,29 @@ public:
         m_FilledPolysList = aPolysList;
     }
 
+    /**
+     * Function SetFilledPolysTriangulation
+     * installs a triangulation of the filled polygons built earlier (i.e. read from the board
+     * file), so that CacheTriangulation() has nothing to do.
+     * @return false if aTriangulation was not built from the current filled polygons.
+     */
+    bool SetFilledPolysTriangulation(
+            std::vector<std::unique_ptr<SHAPE_POLY_SET::TRIANGULATED_POLYGON>>&& aTriangulation,
+            const std::string& aChecksum )
+    {
+        return m_FilledPolysList.SetTriangulation( std::move( aTriangulation ), aChecksum );
+    }
+
+    /**
+     * Function SetFilledPolysTriangulation
+     * takes the triangulation of a copy of the filled polygons, triangulated in the background.
+     * @return false if the filled polygons were modified since the copy was made.
+     */
+    bool SetFilledPolysTriangulation( const SHAPE_POLY_SET& aTriangulated )
+    {
+        return m_FilledPolysList.ShareTriangulation( aTriangulated );
+    }
+
     /**
       * Function SetFilledPolysList
       * sets the list of filled polygons.
@@ -600,6 +626,31 @@ public:
         m_RawPolysList = aPolysList;
     }
 
+    /**
+     * Function PackFill
+     * replaces the filled polygons and the fill segments by a compressed copy of them (see
+     * ZONE_FILL_PACK), unless the polygons are shared with another zone (copying them costs
+     * nothing then).  Meant for the copies of zones kept by the undo and redo lists, which
+     * must be unpacked before being used.
+     */
+    void PackFill();
+
+    /**
+     * Function UnpackFill
+     * restores the filled polygons and the fill segments replaced by PackFill().
+     */
+    void UnpackFill();
+
+    bool IsFillPacked() const { return m_packedFill != nullptr; }
+
+    /**
+     * Function GetFillMemoryUsage
+     * estimates the memory held by the filled polygons, their triangulation, the fill segments
+     * and the packed fill.
+     * @param aCountShared = false to leave out the filled polygons shared with another zone
+     */
+    size_t GetFillMemoryUsage( bool aCountShared = true ) const;
+
 
     /**
      * Function GetSmoothedPoly
@@ -744,6 +795,73 @@ public:
      */
     void BuildHashValue() { m_filledPolysHash = m_FilledPolysList.GetHash(); }
 
+    /**
+     * Adds an area to the dirty region of the zone: the part of its fill made out of date by
+     * the board items changed since the last fill.  ZONE_FILLER can then refill only that
+     * region (see ZONE_FILLER::AddDirtyItem()).
+     */
+    void AddDirtyRegion( const BOX2I& aRegion )
+    {
+        if( m_dirtyRegion.GetWidth() == 0 && m_dirtyRegion.GetHeight() == 0 )
+            m_dirtyRegion = aRegion;
+        else
+            m_dirtyRegion.Merge( aRegion );
+
+        m_fillInputsRevision++;
+    }
+
+    /**
+     * Marks the whole fill as out of date, so that the next fill is not incremental.
+     */
+    void InvalidateDirtyRegion()
+    {
+        m_dirtyRegionValid = false;
+        m_fillInputsRevision++;
+    }
+
+    /**
+     * @return a counter incremented each time the dirty region grows or is invalidated, so
+     * that a fill built from a copy of the board can tell whether the zone has changed since.
+     */
+    unsigned GetFillInputsRevision() const { return m_fillInputsRevision; }
+
+    /**
+     * @param aRegion [out] is the dirty region (empty if nothing changed since the last fill)
+     * @param aSettingsHash is the hash of the board settings used by the last fill
+     * @return false if the dirty region is not known, and the whole zone must be refilled
+     */
+    bool GetDirtyRegion( BOX2I& aRegion, size_t& aSettingsHash ) const
+    {
+        aRegion = m_dirtyRegion;
+        aSettingsHash = m_fillSettingsHash;
+        return m_dirtyRegionValid;
+    }
+
+    /**
+     * The fill fingerprint is a digest of everything the fill was built from: the zone, the
+     * board items near it and the board settings.  It is saved with the fill, so ZONE_FILLER
+     * can tell a fill is still up to date without refilling the zone.  Empty if not known.
+     */
+    const std::string& GetFillFingerprint() const { return m_fillFingerprint; }
+    void SetFillFingerprint( const std::string& aFingerprint ) { m_fillFingerprint = aFingerprint; }
+
+    /**
+     * Called by ZONE_FILLER once the zone is filled: clears the dirty region.
+     */
+    void SetFillUpToDate( size_t aSettingsHash )
+    {
+        m_dirtyRegion = BOX2I();
+        m_dirtyRegionValid = true;
+        m_fillSettingsHash = aSettingsHash;
+    }
+
+    /**
+     * Copies the fill of aZone, with what ZONE_FILLER knows about it (raw fill, dirty region
+     * and fingerprint).  Used to move fills between the zones of a board and those of a copy
+     * of the board.  The fill inputs revision is left as it is.
+     */
+    void CopyFill( const ZONE_CONTAINER& aZone );
+
 
 
 #if defined(DEBUG)
@@ -840,6 +958,9 @@ protected:
      */
     ZONE_SEGMENT_FILL          m_FillSegmList;
 
+    /// The filled polygons and fill segments, when packed by PackFill()
+    std::shared_ptr<const ZONE_FILL_PACK> m_packedFill;
+
     /* set of filled polygons used to draw a zone as a filled area.
      * from outlines (m_Poly) but unlike m_Poly these filled polygons have no hole
      * (they are all in one piece)  In very simple cases m_FilledPolysList is same
@@ -853,6 +974,12 @@ protected:
     MD5_HASH              m_filledPolysHash;    // A hash value used in zone filling calculations
                                                 // to see if the filled areas are up to date
 
+    BOX2I                 m_dirtyRegion;        // Area changed since the last fill
+    bool                  m_dirtyRegionValid;   // false if the whole fill is out of date
+    size_t                m_fillSettingsHash;   // board settings used by the last fill
+    std::string           m_fillFingerprint;    // digest of the inputs of the fill
+    unsigned              m_fillInputsRevision; // see GetFillInputsRevision()
+
     ZONE_HATCH_STYLE      m_hatchStyle;     // hatch style, see enum above
     int                   m_hatchPitch;     // for DIAGONAL_EDGE, distance between 2 hatch lines
     std::vector<SEG>      m_HatchLines;     // hatch lines
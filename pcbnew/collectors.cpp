@@ -35,6 +35,9 @@
 #include <macros.h>
 #include <math/util.h>      // for KiROUND
 
+#include <algorithm>
+#include <unordered_set>
+
 
 /* This module contains out of line member functions for classes given in
  * collectors.h.  Those classes augment the functionality of class PCB_EDIT_FRAME.
@@ -553,6 +556,75 @@ void GENERAL_COLLECTOR::Collect( BOARD_ITEM* aItem, const KICAD_T aScanList[],
 
     aItem->Visit( m_inspector, NULL, m_ScanTypes );
 
+    endCollect();
+}
+
+
+void GENERAL_COLLECTOR::Collect( BOARD_ITEM* aItem, const KICAD_T aScanList[],
+                                 const wxPoint& aRefPos, const COLLECTORS_GUIDE& aGuide,
+                                 KIGFX::VIEW* aView )
+{
+    Empty();
+    Empty2nd();
+    SetGuide( &aGuide );
+    SetScanTypes( aScanList );
+    SetRefPos( aRefPos );
+
+    // The widest hit test of Inspect() is the one of the zone corners
+    int   margin = KiROUND( 10 * aGuide.OnePixelInIU() ) + 1;
+    BOX2I area( VECTOR2I( aRefPos ), VECTOR2I( 0, 0 ) );
+
+    area.Inflate( margin );
+
+    std::vector<KIGFX::VIEW::LAYER_ITEM_PAIR> found;
+    aView->Query( area, found );
+
+    // The candidates, in the order Visit() would give them: by their rank in the scan list
+    std::vector<std::pair<int, BOARD_ITEM*>> candidates;
+    std::unordered_set<BOARD_ITEM*>          seen;
+
+    for( const KIGFX::VIEW::LAYER_ITEM_PAIR& pair : found )
+    {
+        BOARD_ITEM* item = dynamic_cast<BOARD_ITEM*>( pair.first );
+
+        // An item is found once per layer it is on
+        if( !item || !seen.insert( item ).second )
+            continue;
+
+        int rank = 0;
+
+        while( aScanList[rank] != EOT && aScanList[rank] != item->Type() )
+            rank++;
+
+        if( aScanList[rank] == EOT )
+            continue;
+
+        // Only the items of aItem (the view may show other items, e.g. previews)
+        EDA_ITEM* owner = item;
+
+        while( owner && owner != aItem )
+            owner = owner->GetParent();
+
+        if( owner )
+            candidates.emplace_back( rank, item );
+    }
+
+    std::stable_sort( candidates.begin(), candidates.end(),
+                      []( const std::pair<int, BOARD_ITEM*>& a,
+                          const std::pair<int, BOARD_ITEM*>& b )
+                      {
+                          return a.first < b.first;
+                      } );
+
+    for( const std::pair<int, BOARD_ITEM*>& candidate : candidates )
+        Inspect( candidate.second, nullptr );
+
+    endCollect();
+}
+
+
+void GENERAL_COLLECTOR::endCollect()
+{
     // record the length of the primary list before concatenating on to it.
     m_PrimaryLength = m_List.size();
 
@@ -375,6 +375,22 @@ public:
      */
     void Collect( BOARD_ITEM* aItem, const KICAD_T aScanList[],
                  const wxPoint& aRefPos, const COLLECTORS_GUIDE& aGuide );
+
+    /**
+     * Same as the Collect() above, but only the items of aItem found by aView near aRefPos
+     * are inspected instead of all the items of aItem: use it to hit test the items of a
+     * board on a click, without visiting the whole board.
+     *
+     * @param aView The view showing aItem.  Its spatial index must be up to date (the view
+     *  must have been redrawn since the items were changed).  The items only on the hidden
+     *  layers of the view are not found.
+     */
+    void Collect( BOARD_ITEM* aItem, const KICAD_T aScanList[],
+                 const wxPoint& aRefPos, const COLLECTORS_GUIDE& aGuide, KIGFX::VIEW* aView );
+
+private:
+    /// Finish a collection: appends the secondary list to the primary one
+    void endCollect();
 };
 
 
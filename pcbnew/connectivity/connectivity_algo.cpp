@@ -23,20 +23,31 @@
  */
 
 #include <connectivity/connectivity_algo.h>
+#include <connectivity/connectivity_snapshot.h>
 #include <widgets/progress_reporter.h>
 #include <geometry/geometry_utils.h>
 #include <board_commit.h>
+#include <thread_pool.h>
+#include <trace_events.h>
 
-#include <thread>
+#include <atomic>
 #include <mutex>
 #include <algorithm>
-#include <future>
 
 #ifdef PROFILE
 #include <profile.h>
 #endif
 
 
+static std::atomic<uint64_t> s_netStatsSerial( 0 );
+
+
+CN_CONNECTIVITY_ALGO::CN_CONNECTIVITY_ALGO() :
+        m_firstNetStatsSerial( ++s_netStatsSerial )
+{
+}
+
+
 bool CN_CONNECTIVITY_ALGO::Remove( BOARD_ITEM* aItem )
 {
     markItemNetAsDirty( aItem );
@@ -46,6 +57,7 @@ bool CN_CONNECTIVITY_ALGO::Remove( BOARD_ITEM* aItem )
     case PCB_MODULE_T:
         for( auto pad : static_cast<MODULE*>( aItem ) -> Pads() )
         {
+            removeNetStats( pad );
             m_itemMap[ static_cast<BOARD_CONNECTED_ITEM*>( pad ) ].MarkItemsAsInvalid();
             m_itemMap.erase( static_cast<BOARD_CONNECTED_ITEM*>( pad ) );
         }
@@ -54,6 +66,7 @@ bool CN_CONNECTIVITY_ALGO::Remove( BOARD_ITEM* aItem )
         break;
 
     case PCB_PAD_T:
+        removeNetStats( static_cast<BOARD_CONNECTED_ITEM*>( aItem ) );
         m_itemMap[ static_cast<BOARD_CONNECTED_ITEM*>( aItem ) ].MarkItemsAsInvalid();
         m_itemMap.erase( static_cast<BOARD_CONNECTED_ITEM*>( aItem ) );
         m_itemList.SetDirty( true );
@@ -61,12 +74,14 @@ bool CN_CONNECTIVITY_ALGO::Remove( BOARD_ITEM* aItem )
 
     case PCB_TRACE_T:
     case PCB_ARC_T:
+        removeNetStats( static_cast<BOARD_CONNECTED_ITEM*>( aItem ) );
         m_itemMap[ static_cast<BOARD_CONNECTED_ITEM*>( aItem ) ].MarkItemsAsInvalid();
         m_itemMap.erase( static_cast<BOARD_CONNECTED_ITEM*>( aItem ) );
         m_itemList.SetDirty( true );
         break;
 
     case PCB_VIA_T:
+        removeNetStats( static_cast<BOARD_CONNECTED_ITEM*>( aItem ) );
         m_itemMap[ static_cast<BOARD_CONNECTED_ITEM*>( aItem ) ].MarkItemsAsInvalid();
         m_itemMap.erase( static_cast<BOARD_CONNECTED_ITEM*>( aItem ) );
         m_itemList.SetDirty( true );
@@ -132,6 +147,7 @@ bool CN_CONNECTIVITY_ALGO::Add( BOARD_ITEM* aItem )
                 return false;
 
             add( m_itemList, pad );
+            addNetStats( pad );
         }
 
         break;
@@ -141,6 +157,7 @@ bool CN_CONNECTIVITY_ALGO::Add( BOARD_ITEM* aItem )
             return false;
 
         add( m_itemList, static_cast<D_PAD*>( aItem ) );
+        addNetStats( static_cast<D_PAD*>( aItem ) );
 
         break;
 
@@ -150,6 +167,7 @@ bool CN_CONNECTIVITY_ALGO::Add( BOARD_ITEM* aItem )
             return false;
 
         add( m_itemList, static_cast<TRACK*>( aItem ) );
+        addNetStats( static_cast<TRACK*>( aItem ) );
 
         break;
     }
@@ -160,6 +178,7 @@ bool CN_CONNECTIVITY_ALGO::Add( BOARD_ITEM* aItem )
             return false;
 
         add( m_itemList, static_cast<ARC*>( aItem ) );
+        addNetStats( static_cast<ARC*>( aItem ) );
 
         break;
     }
@@ -169,6 +188,7 @@ bool CN_CONNECTIVITY_ALGO::Add( BOARD_ITEM* aItem )
             return false;
 
         add( m_itemList, static_cast<VIA*>( aItem ) );
+        addNetStats( static_cast<VIA*>( aItem ) );
 
         break;
 
@@ -197,6 +217,8 @@ bool CN_CONNECTIVITY_ALGO::Add( BOARD_ITEM* aItem )
 
 void CN_CONNECTIVITY_ALGO::searchConnections()
 {
+    TRACE_SCOPE trace( "connectivity-search" );
+
 #ifdef CONNECTIVITY_DEBUG
     printf("Search start\n");
 #endif
@@ -209,6 +231,20 @@ void CN_CONNECTIVITY_ALGO::searchConnections()
 
     m_itemList.RemoveInvalidItems( garbage );
 
+    // The net of a removed item may have changed before it was removed, so the ratsnest
+    // clusters holding it are not necessarily marked as dirty: rebuild them too.
+    if( !garbage.empty() )
+    {
+        for( const auto& cluster : m_ratsnestClusters )
+        {
+            if( std::any_of( cluster->begin(), cluster->end(),
+                             []( CN_ITEM* aItem ) { return !aItem->Valid(); } ) )
+            {
+                MarkNetAsDirty( cluster->OriginNet() );
+            }
+        }
+    }
+
     for( auto item : garbage )
         delete item;
 
@@ -229,48 +265,22 @@ void CN_CONNECTIVITY_ALGO::searchConnections()
 
     if( m_itemList.IsDirty() )
     {
-        size_t parallelThreadCount = std::min<size_t>( std::thread::hardware_concurrency(),
-                ( dirtyItems.size() + 7 ) / 8 );
-
-        std::atomic<size_t> nextItem( 0 );
-        std::vector<std::future<size_t>> returns( parallelThreadCount );
-
-        auto conn_lambda = [&nextItem, &dirtyItems]
-                            ( CN_LIST* aItemList, PROGRESS_REPORTER* aReporter) -> size_t
+        auto conn_lambda = [&dirtyItems, this]( size_t i )
         {
-            for( size_t i = nextItem++; i < dirtyItems.size(); i = nextItem++ )
-            {
-                CN_VISITOR visitor( dirtyItems[i] );
-                aItemList->FindNearby( dirtyItems[i], visitor );
-
-                if( aReporter )
-                    aReporter->AdvanceProgress();
-            }
+            CN_VISITOR visitor( dirtyItems[i] );
+            m_itemList.FindNearby( dirtyItems[i], visitor );
 
-            return 1;
+            if( m_progressReporter )
+                m_progressReporter->AdvanceProgress();
         };
 
-        if( parallelThreadCount <= 1 )
-            conn_lambda( &m_itemList, m_progressReporter );
-        else
-        {
-            for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-                returns[ii] = std::async( std::launch::async, conn_lambda,
-                        &m_itemList, m_progressReporter );
+        // Keep the progress dialog alive while the pool searches the connections
+        std::function<void()> keepRefreshing;
 
-            for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-            {
-                // Here we balance returns with a 100ms timeout to allow UI updating
-                std::future_status status;
-                do
-                {
-                    if( m_progressReporter )
-                        m_progressReporter->KeepRefreshing();
+        if( m_progressReporter )
+            keepRefreshing = [this]() { m_progressReporter->KeepRefreshing(); };
 
-                    status = returns[ii].wait_for( std::chrono::milliseconds( 100 ) );
-                } while( status != std::future_status::ready );
-            }
-        }
+        THREAD_POOL::GetInstance().ParallelFor( dirtyItems.size(), conn_lambda, keepRefreshing );
 
         if( m_progressReporter )
             m_progressReporter->KeepRefreshing();
@@ -304,63 +314,69 @@ const CN_CONNECTIVITY_ALGO::CLUSTERS CN_CONNECTIVITY_ALGO::SearchClusters( CLUST
 
 
 const CN_CONNECTIVITY_ALGO::CLUSTERS CN_CONNECTIVITY_ALGO::SearchClusters( CLUSTER_SEARCH_MODE aMode,
-        const KICAD_T aTypes[], int aSingleNet )
+        const KICAD_T aTypes[], int aSingleNet, const BOARD_CONNECTED_ITEM* aRootItem )
+{
+    if( !aRootItem )
+        return searchClusters( aMode, aTypes, aSingleNet, nullptr );
+
+    return searchClusters( aMode, aTypes, aSingleNet,
+                           [aRootItem]( CN_ITEM* aItem ) { return aItem->Parent() == aRootItem; } );
+}
+
+
+const CN_CONNECTIVITY_ALGO::CLUSTERS CN_CONNECTIVITY_ALGO::searchClusters( CLUSTER_SEARCH_MODE aMode,
+        const KICAD_T aTypes[], int aSingleNet, const std::function<bool( CN_ITEM* )>& aIsRoot )
 {
     bool withinAnyNet = ( aMode != CSM_PROPAGATE );
 
     std::deque<CN_ITEM*> Q;
-    CN_ITEM* head = nullptr;
+    std::vector<CN_ITEM*> roots;
     CLUSTERS clusters;
 
     if( m_itemList.IsDirty() )
         searchConnections();
 
-    auto addToSearchList = [&head, withinAnyNet, aSingleNet, aTypes] ( CN_ITEM *aItem )
+    auto isSearched = [withinAnyNet, aSingleNet, aTypes] ( CN_ITEM *aItem )
     {
         if( withinAnyNet && aItem->Net() <= 0 )
-            return;
+            return false;
 
         if( !aItem->Valid() )
-            return;
+            return false;
 
         if( aSingleNet >=0 && aItem->Net() != aSingleNet )
-            return;
-
-        bool found = false;
+            return false;
 
         for( int i = 0; aTypes[i] != EOT; i++ )
         {
             if( aItem->Parent()->Type() == aTypes[i] )
-            {
-                found = true;
-                break;
-            }
+                return true;
         }
 
-        if( !found )
-            return;
+        return false;
+    };
 
-        aItem->ListClear();
-        aItem->SetVisited( false );
+    // Items which are not searched are marked as visited, so that the search never walks
+    // through them.  Only the clusters holding a root are built.
+    for( CN_ITEM* item : m_itemList )
+    {
+        bool searched = isSearched( item );
 
-        if( !head )
-            head = aItem;
-        else
-            head->ListInsert( aItem );
-    };
+        item->SetVisited( !searched );
 
-    std::for_each( m_itemList.begin(), m_itemList.end(), addToSearchList );
+        if( searched && ( !aIsRoot || aIsRoot( item ) ) )
+            roots.push_back( item );
+    }
 
-    while( head )
+    for( CN_ITEM* root : roots )
     {
+        if( root->Visited() )
+            continue;
+
         CN_CLUSTER_PTR cluster ( new CN_CLUSTER() );
 
         Q.clear();
-        CN_ITEM* root = head;
         root->SetVisited ( true );
-
-        head = root->ListRemove();
-
         Q.push_back( root );
 
         while( Q.size() )
@@ -379,7 +395,6 @@ const CN_CONNECTIVITY_ALGO::CLUSTERS CN_CONNECTIVITY_ALGO::SearchClusters( CLUST
                 {
                     n->SetVisited( true );
                     Q.push_back( n );
-                    head = n->ListRemove();
                 }
             }
         }
@@ -408,6 +423,10 @@ const CN_CONNECTIVITY_ALGO::CLUSTERS CN_CONNECTIVITY_ALGO::SearchClusters( CLUST
 
 void CN_CONNECTIVITY_ALGO::Build( BOARD* aBoard )
 {
+    TRACE_SCOPE trace( "connectivity-build" );
+
+    m_itemList.BeginBulkLoad();
+
     for( int i = 0; i<aBoard->GetAreaCount(); i++ )
     {
         auto zone = aBoard->GetArea( i );
@@ -423,14 +442,126 @@ void CN_CONNECTIVITY_ALGO::Build( BOARD* aBoard )
             Add( pad );
     }
 
+    m_itemList.EndBulkLoad();
+
     /*wxLogTrace( "CN", "zones : %lu, pads : %lu vias : %lu tracks : %lu\n",
             m_zoneList.Size(), m_padList.Size(),
             m_viaList.Size(), m_trackList.Size() );*/
 }
 
 
+std::vector<CN_ITEM*> CN_CONNECTIVITY_ALGO::boardItems( const BOARD* aBoard )
+{
+    std::vector<CN_ITEM*> items;
+
+    items.reserve( m_itemList.Size() );
+
+    auto addItems = [&]( const BOARD_ITEM* aItem )
+    {
+        auto entry = m_itemMap.find( aItem );
+
+        if( entry != m_itemMap.end() )
+        {
+            for( CN_ITEM* item : entry->second.GetItems() )
+                items.push_back( item );
+        }
+    };
+
+    for( int i = 0; i < aBoard->GetAreaCount(); i++ )
+        addItems( aBoard->GetArea( i ) );
+
+    for( auto tv : aBoard->Tracks() )
+        addItems( tv );
+
+    for( auto mod : aBoard->Modules() )
+    {
+        for( auto pad : mod->Pads() )
+            addItems( pad );
+    }
+
+    return items;
+}
+
+
+/**
+ * What a snapshot item must have in common with the item it is restored to
+ */
+static uint32_t snapshotItemKey( const CN_ITEM* aItem )
+{
+    return ( (uint32_t) aItem->Parent()->Type() << 16 )
+           | ( (uint32_t) ( aItem->Layers().Start() & 0xFF ) << 8 )
+           | (uint32_t) ( aItem->Layers().End() & 0xFF );
+}
+
+
+void CN_CONNECTIVITY_ALGO::GetSnapshot( const BOARD* aBoard, CN_SNAPSHOT& aSnapshot )
+{
+    if( m_itemList.IsDirty() )
+        searchConnections();
+
+    std::vector<CN_ITEM*>                  items = boardItems( aBoard );
+    std::unordered_map<CN_ITEM*, uint32_t> ranks;
+
+    aSnapshot.m_items.clear();
+    aSnapshot.m_connections.clear();
+
+    for( CN_ITEM* item : items )
+    {
+        ranks[item] = aSnapshot.m_items.size();
+        aSnapshot.m_items.push_back( snapshotItemKey( item ) );
+    }
+
+    for( uint32_t rank = 0; rank < items.size(); ++rank )
+    {
+        for( CN_ITEM* connected : items[rank]->ConnectedItems() )
+        {
+            auto connectedRank = ranks.find( connected );
+
+            // The connections go both ways: save each one once
+            if( connectedRank != ranks.end() && connectedRank->second > rank )
+                aSnapshot.m_connections.emplace_back( rank, connectedRank->second );
+        }
+    }
+}
+
+
+bool CN_CONNECTIVITY_ALGO::RestoreSnapshot( const BOARD* aBoard, const CN_SNAPSHOT& aSnapshot )
+{
+    std::vector<CN_ITEM*> items = boardItems( aBoard );
+
+    // All the items must be the board's, or the search would miss the others
+    if( items.size() != aSnapshot.m_items.size() || items.size() != (size_t) m_itemList.Size() )
+        return false;
+
+    for( size_t i = 0; i < items.size(); ++i )
+    {
+        if( !items[i]->Dirty() || snapshotItemKey( items[i] ) != aSnapshot.m_items[i] )
+            return false;
+    }
+
+    for( const std::pair<uint32_t, uint32_t>& connection : aSnapshot.m_connections )
+    {
+        if( connection.first >= items.size() || connection.second >= items.size() )
+            return false;
+    }
+
+    for( const std::pair<uint32_t, uint32_t>& connection : aSnapshot.m_connections )
+    {
+        items[connection.first]->Connect( items[connection.second] );
+        items[connection.second]->Connect( items[connection.first] );
+    }
+
+    // The bounding boxes were computed by the bulk load of Build(): nothing is left to search
+    m_itemList.ClearDirtyFlags();
+
+    return true;
+}
+
+
 void CN_CONNECTIVITY_ALGO::Build( const std::vector<BOARD_ITEM*>& aItems )
 {
+    m_itemList.BeginBulkLoad();
+
     for( auto item : aItems )
     {
         switch( item->Type() )
@@ -456,6 +587,8 @@ void CN_CONNECTIVITY_ALGO::Build( const std::vector<BOARD_ITEM*>& aItems )
                 break;
         }
     }
+
+    m_itemList.EndBulkLoad();
 }
 
 
@@ -489,7 +622,9 @@ void CN_CONNECTIVITY_ALGO::propagateConnections( BOARD_COMMIT* aCommit )
                         if( aCommit )
                             aCommit->Modify( item->Parent() );
 
+                        removeNetStats( item->Parent() );
                         item->Parent()->SetNetCode( cluster->OriginNet() );
+                        addNetStats( item->Parent() );
                         n_changed++;
                     }
                 }
@@ -513,7 +648,13 @@ void CN_CONNECTIVITY_ALGO::propagateConnections( BOARD_COMMIT* aCommit )
 
 void CN_CONNECTIVITY_ALGO::PropagateNets( BOARD_COMMIT* aCommit )
 {
-    m_connClusters = SearchClusters( CSM_PROPAGATE );
+    constexpr KICAD_T no_zones[] =
+    { PCB_TRACE_T, PCB_ARC_T, PCB_PAD_T, PCB_VIA_T, PCB_MODULE_T, EOT };
+
+    // Every change of the connections of an item marks its net as dirty, so the clusters
+    // without any item of a dirty net have nothing new to propagate.
+    m_connClusters = searchClusters( CSM_PROPAGATE, no_zones, -1,
+                                     [this]( CN_ITEM* aItem ) { return IsNetDirty( aItem->Net() ); } );
     propagateConnections( aCommit );
 }
 
@@ -547,36 +688,80 @@ void CN_CONNECTIVITY_ALGO::FindIsolatedCopperIslands( ZONE_CONTAINER* aZone, std
     wxLogTrace( "CN", "Found %u isolated islands\n", (unsigned)aIslands.size() );
 }
 
+bool CN_CONNECTIVITY_ALGO::zoneFillInGraph( const ZONE_CONTAINER* aZone ) const
+{
+    const SHAPE_POLY_SET& polys = aZone->GetFilledPolysList();
+    auto                  entry = m_itemMap.find( aZone );
+
+    if( entry == m_itemMap.end() )
+        return polys.IsEmpty();
+
+    const std::list<CN_ITEM*>& items = entry->second.m_items;
+
+    if( (int) items.size() != polys.OutlineCount() )
+        return false;
+
+    for( const CN_ITEM* item : items )
+    {
+        if( !item->Valid() || item->Layer() != aZone->GetLayer() )
+            return false;
+    }
+
+    return items.empty() || static_cast<const CN_ZONE*>( items.front() )->Index()->Matches( polys );
+}
+
+
 void CN_CONNECTIVITY_ALGO::FindIsolatedCopperIslands( std::vector<CN_ZONE_ISOLATED_ISLAND_LIST>& aZones )
 {
-    for ( auto& z : aZones )
-        Remove( z.m_zone );
+    // The zones whose fill did not change since they were added keep their items and
+    // connections.  The fills are compared, and indexed for Add(), in parallel.
+    std::vector<char> unchanged( aZones.size() );
+
+    THREAD_POOL::GetInstance().ParallelFor( aZones.size(),
+            [&aZones, &unchanged, this]( size_t i )
+            {
+                const SHAPE_POLY_SET& polys = aZones[i].m_zone->GetFilledPolysList();
+
+                if( !polys.IsEmpty() )
+                    polys.GetIndex();
 
-    for ( auto& z : aZones )
+                unchanged[i] = zoneFillInGraph( aZones[i].m_zone );
+            } );
+
+    std::unordered_map<const BOARD_ITEM*, CN_ZONE_ISOLATED_ISLAND_LIST*> zones;
+
+    for( size_t i = 0; i < aZones.size(); i++ )
     {
-        if( !z.m_zone->GetFilledPolysList().IsEmpty() )
-            Add( z.m_zone );
+        if( !unchanged[i] )
+            Remove( aZones[i].m_zone );
+
+        zones[aZones[i].m_zone] = &aZones[i];
     }
 
-    m_connClusters = SearchClusters( CSM_CONNECTIVITY_CHECK );
+    for( size_t i = 0; i < aZones.size(); i++ )
+    {
+        if( !unchanged[i] && !aZones[i].m_zone->GetFilledPolysList().IsEmpty() )
+            Add( aZones[i].m_zone );
+    }
 
-    for ( auto& zone : aZones )
+    // Only the clusters holding the zones are needed
+    constexpr KICAD_T types[] =
+    { PCB_TRACE_T, PCB_ARC_T, PCB_PAD_T, PCB_VIA_T, PCB_ZONE_AREA_T, PCB_MODULE_T, EOT };
+
+    m_connClusters = searchClusters( CSM_CONNECTIVITY_CHECK, types, -1,
+            [&zones]( CN_ITEM* aItem ) { return zones.count( aItem->Parent() ) > 0; } );
+
+    for( const auto& cluster : m_connClusters )
     {
-        if( zone.m_zone->GetFilledPolysList().IsEmpty() )
+        if( !cluster->IsOrphaned() )
             continue;
 
-        for( const auto& cluster : m_connClusters )
+        for( auto z : *cluster )
         {
-            if( cluster->Contains( zone.m_zone ) && cluster->IsOrphaned() )
-            {
-                for( auto z : *cluster )
-                {
-                    if( z->Parent() == zone.m_zone )
-                    {
-                        zone.m_islands.push_back( static_cast<CN_ZONE*>(z)->SubpolyIndex() );
-                    }
-                }
-            }
+            auto zone = zones.find( z->Parent() );
+
+            if( zone != zones.end() )
+                zone->second->m_islands.push_back( static_cast<CN_ZONE*>( z )->SubpolyIndex() );
         }
     }
 }
@@ -584,7 +769,25 @@ void CN_CONNECTIVITY_ALGO::FindIsolatedCopperIslands( std::vector<CN_ZONE_ISOLAT
 
 const CN_CONNECTIVITY_ALGO::CLUSTERS& CN_CONNECTIVITY_ALGO::GetClusters()
 {
-    m_ratsnestClusters = SearchClusters( CSM_RATSNEST );
+    constexpr KICAD_T types[] =
+    { PCB_TRACE_T, PCB_ARC_T, PCB_PAD_T, PCB_VIA_T, PCB_ZONE_AREA_T, PCB_MODULE_T, EOT };
+
+    // Ratsnest clusters never span several nets: only the clusters of the dirty nets are
+    // searched again, the others are kept.
+    CLUSTERS clusters = searchClusters( CSM_RATSNEST, types, -1,
+                                        [this]( CN_ITEM* aItem ) { return IsNetDirty( aItem->Net() ); } );
+
+    for( const auto& cluster : m_ratsnestClusters )
+    {
+        if( !IsNetDirty( cluster->OriginNet() ) )
+            clusters.push_back( cluster );
+    }
+
+    std::sort( clusters.begin(), clusters.end(), []( CN_CLUSTER_PTR a, CN_CLUSTER_PTR b ) {
+        return a->OriginNet() < b->OriginNet();
+    } );
+
+    m_ratsnestClusters = std::move( clusters );
     return m_ratsnestClusters;
 }
 
@@ -745,8 +948,149 @@ void CN_CONNECTIVITY_ALGO::Clear()
     m_itemMap.clear();
     m_itemList.Clear();
 
+    // The consumers of the statistics must read them all again
+    m_netStats.clear();
+    m_netStatsChanges.clear();
+    m_firstNetStatsSerial = ++s_netStatsSerial;
+}
+
+
+/**
+ * @return what aItem counts for in the statistics of its net
+ */
+static CN_NET_STATS itemNetStats( const BOARD_CONNECTED_ITEM* aItem )
+{
+    CN_NET_STATS stats;
+
+    switch( aItem->Type() )
+    {
+    case PCB_PAD_T:
+        stats.m_PadCount = 1;
+        stats.m_PadToDieLength = static_cast<const D_PAD*>( aItem )->GetPadToDieLength();
+        break;
+
+    case PCB_VIA_T:
+        stats.m_ViaCount = 1;
+        break;
+
+    case PCB_TRACE_T:
+    case PCB_ARC_T:
+        stats.m_TrackLength = KiROUND( static_cast<const TRACK*>( aItem )->GetLength() );
+        break;
+
+    default:
+        break;
+    }
+
+    return stats;
+}
+
+
+void CN_CONNECTIVITY_ALGO::addNetStats( const BOARD_CONNECTED_ITEM* aItem )
+{
+    ITEM_MAP_ENTRY& entry = m_itemMap[aItem];
+
+    entry.m_StatsNet = aItem->GetNetCode();
+    entry.m_Stats = itemNetStats( aItem );
+
+    changeNetStats( entry.m_StatsNet, entry.m_Stats, true );
 }
 
+
+void CN_CONNECTIVITY_ALGO::removeNetStats( const BOARD_CONNECTED_ITEM* aItem )
+{
+    auto entry = m_itemMap.find( aItem );
+
+    if( entry == m_itemMap.end() )
+        return;
+
+    // The item may be in another net now: remove it from the one it was counted in
+    changeNetStats( entry->second.m_StatsNet, entry->second.m_Stats, false );
+    entry->second.m_StatsNet = -1;
+}
+
+
+void CN_CONNECTIVITY_ALGO::changeNetStats( int aNet, const CN_NET_STATS& aStats, bool aAdd )
+{
+    if( aNet < 0 )
+        return;
+
+    NET_STATS_ENTRY& entry = m_netStats[aNet];
+
+    if( aAdd )
+        entry.m_Stats += aStats;
+    else
+        entry.m_Stats -= aStats;
+
+    if( entry.m_Serial )
+        m_netStatsChanges.erase( entry.m_Serial );
+
+    entry.m_Serial = ++s_netStatsSerial;
+    m_netStatsChanges[entry.m_Serial] = aNet;
+}
+
+
+const CN_NET_STATS& CN_CONNECTIVITY_ALGO::GetNetStats( int aNet ) const
+{
+    static const CN_NET_STATS empty;
+
+    auto entry = m_netStats.find( aNet );
+
+    return entry != m_netStats.end() ? entry->second.m_Stats : empty;
+}
+
+
+uint64_t CN_CONNECTIVITY_ALGO::GetNetStatsSerial() const
+{
+    return m_netStatsChanges.empty() ? m_firstNetStatsSerial : m_netStatsChanges.rbegin()->first;
+}
+
+
+bool CN_CONNECTIVITY_ALGO::GetChangedNetStats( uint64_t aSerial, std::vector<int>& aNets ) const
+{
+    if( aSerial < m_firstNetStatsSerial )
+        return false;
+
+    for( auto change = m_netStatsChanges.upper_bound( aSerial ); change != m_netStatsChanges.end();
+            ++change )
+    {
+        aNets.push_back( change->second );
+    }
+
+    return true;
+}
+
+size_t CN_CONNECTIVITY_ALGO::GetMemoryUsage() const
+{
+    // An anchor is allocated with the control block of its shared_ptr
+    const size_t anchorSize = sizeof( CN_ANCHOR ) + 2 * sizeof( void* ) + sizeof( CN_ANCHOR_PTR );
+    // A hash map node holds the entry, the list of its items and the link to the next node
+    const size_t mapNodeSize = sizeof( std::pair<const BOARD_ITEM*, ITEM_MAP_ENTRY> )
+                               + sizeof( void* ) * 4;
+    size_t       bytes = 0;
+
+    for( const CN_ITEM* item : m_itemList )
+    {
+        bytes += sizeof( CN_ITEM ) + item->Anchors().size() * anchorSize;
+        bytes += item->ConnectedItems().capacity() * sizeof( CN_ITEM* );
+    }
+
+    bytes += m_itemMap.size() * mapNodeSize;
+    bytes += m_netStats.size()
+             * ( sizeof( std::pair<const int, NET_STATS_ENTRY> ) + sizeof( void* ) * 2 );
+    bytes += m_netStatsChanges.size()
+             * ( sizeof( std::pair<const uint64_t, int> ) + sizeof( void* ) * 4 );
+
+    for( const CLUSTERS* clusters : { &m_connClusters, &m_ratsnestClusters } )
+    {
+        for( const CN_CLUSTER_PTR& cluster : *clusters )
+            bytes += sizeof( CN_CLUSTER ) + cluster->Size() * sizeof( CN_ITEM* );
+    }
+
+    return bytes;
+}
+
+
 void CN_CONNECTIVITY_ALGO::SetProgressReporter( PROGRESS_REPORTER* aReporter )
 {
     m_progressReporter = aReporter;
@@ -34,14 +34,15 @@
 #include <class_zone.h>
 
 #include <geometry/shape_poly_set.h>
-#include <geometry/poly_grid_partition.h>
+#include <geometry/poly_set_index.h>
 
 #include <memory>
 #include <algorithm>
+#include <map>
+#include <unordered_map>
 #include <functional>
 #include <vector>
 #include <deque>
-#include <intrusive_list.h>
 
 #include <connectivity/connectivity_rtree.h>
 #include <connectivity/connectivity_data.h>
@@ -54,6 +55,7 @@ class BOARD_CONNECTED_ITEM;
 class BOARD_ITEM;
 class ZONE_CONTAINER;
 class PROGRESS_REPORTER;
+struct CN_SNAPSHOT;
 
 class CN_EDGE
 {
@@ -141,6 +143,16 @@ private:
         }
 
         std::list<CN_ITEM*> m_items;
+
+        ///> The net and the statistics the item was counted in
+        int          m_StatsNet = -1;
+        CN_NET_STATS m_Stats;
+    };
+
+    struct NET_STATS_ENTRY
+    {
+        CN_NET_STATS m_Stats;
+        uint64_t     m_Serial = 0;      ///< of the last change
     };
 
     CN_LIST m_itemList;
@@ -152,8 +164,26 @@ private:
     std::vector<bool> m_dirtyNets;
     PROGRESS_REPORTER* m_progressReporter = nullptr;
 
+    ///> The statistics of each net, and the nets by serial of their last change
+    std::unordered_map<int, NET_STATS_ENTRY> m_netStats;
+    std::map<uint64_t, int>                  m_netStatsChanges;
+
+    ///> The changes of the statistics have greater serials (unique to all the instances)
+    uint64_t m_firstNetStatsSerial;
+
     void    searchConnections();
 
+    ///> True if the items of aZone in the graph were built from its current filled polygons
+    bool    zoneFillInGraph( const ZONE_CONTAINER* aZone ) const;
+
+    /**
+     * Searches the clusters of the items of types aTypes (and of net aSingleNet if >= 0).
+     * @param aIsRoot restricts the search to the clusters holding an item for which it
+     *                returns true, or is empty to search all the clusters.
+     */
+    const CLUSTERS searchClusters( CLUSTER_SEARCH_MODE aMode, const KICAD_T aTypes[],
+                                   int aSingleNet, const std::function<bool( CN_ITEM* )>& aIsRoot );
+
     void    update();
 
     void    propagateConnections( BOARD_COMMIT* aCommit = nullptr );
@@ -168,9 +198,20 @@ private:
 
     void markItemNetAsDirty( const BOARD_ITEM* aItem );
 
+    ///> Counts aItem (already in m_itemMap) in the statistics of its net
+    void addNetStats( const BOARD_CONNECTED_ITEM* aItem );
+
+    ///> Removes aItem from the statistics of the net it was counted in
+    void removeNetStats( const BOARD_CONNECTED_ITEM* aItem );
+
+    void changeNetStats( int aNet, const CN_NET_STATS& aStats, bool aAdd );
+
+    ///> The items of aBoard, in the order Build( aBoard ) adds them
+    std::vector<CN_ITEM*> boardItems( const BOARD* aBoard );
+
 public:
 
-    CN_CONNECTIVITY_ALGO() {}
+    CN_CONNECTIVITY_ALGO();
     ~CN_CONNECTIVITY_ALGO() { Clear(); }
 
     bool ItemExists( const BOARD_CONNECTED_ITEM* aItem ) const
@@ -188,6 +229,10 @@ public:
         if( aNet < 0 )
             return false;
 
+        // a net never seen by MarkNetAsDirty() is new
+        if( aNet >= (int) m_dirtyNets.size() )
+            return true;
+
         return m_dirtyNets[ aNet ];
     }
 
@@ -216,12 +261,45 @@ public:
     void    Build( BOARD* aBoard );
     void    Build( const std::vector<BOARD_ITEM*>& aItems );
 
+    /**
+     * Function GetSnapshot()
+     * Searches the connections of the items of aBoard if needed, and returns them to be
+     * saved with the board file.
+     */
+    void    GetSnapshot( const BOARD* aBoard, CN_SNAPSHOT& aSnapshot );
+
+    /**
+     * Function RestoreSnapshot()
+     * Connects the items added by Build( aBoard ) as in aSnapshot, instead of searching their
+     * connections.
+     * @return false if aSnapshot was not taken from the same items (they are then left to
+     *         the search).
+     */
+    bool    RestoreSnapshot( const BOARD* aBoard, const CN_SNAPSHOT& aSnapshot );
+
     void Clear();
 
+    ///> An estimate of the memory held by the items, anchors and clusters
+    size_t  GetMemoryUsage() const;
+
+    ///> The number of items in the graph
+    size_t  GetItemCount() const { return m_itemList.Size(); }
+
     bool    Remove( BOARD_ITEM* aItem );
     bool    Add( BOARD_ITEM* aItem );
 
-    const CLUSTERS  SearchClusters( CLUSTER_SEARCH_MODE aMode, const KICAD_T aTypes[], int aSingleNet );
+    ///> Defers the indexing of the added items until EndBulkUpdate(), to add many items at once
+    void    BeginBulkUpdate() { m_itemList.BeginBulkLoad(); }
+
+    ///> Rebuilds the index of the items in one go
+    void    EndBulkUpdate() { m_itemList.EndBulkLoad(); }
+
+    /**
+     * Searches the clusters of the items of types aTypes (and of net aSingleNet if >= 0).
+     * @param aRootItem if not null, only the clusters holding aRootItem are searched.
+     */
+    const CLUSTERS  SearchClusters( CLUSTER_SEARCH_MODE aMode, const KICAD_T aTypes[],
+                                    int aSingleNet, const BOARD_CONNECTED_ITEM* aRootItem = nullptr );
     const CLUSTERS  SearchClusters( CLUSTER_SEARCH_MODE aMode );
 
     /**
@@ -268,6 +346,15 @@ public:
     void MarkNetAsDirty( int aNet );
     void SetProgressReporter( PROGRESS_REPORTER* aReporter );
 
+    ///> @copydoc CONNECTIVITY_DATA::GetNetStats()
+    const CN_NET_STATS& GetNetStats( int aNet ) const;
+
+    ///> @copydoc CONNECTIVITY_DATA::GetNetStatsSerial()
+    uint64_t GetNetStatsSerial() const;
+
+    ///> @copydoc CONNECTIVITY_DATA::GetChangedNetStats()
+    bool GetChangedNetStats( uint64_t aSerial, std::vector<int>& aNets ) const;
+
 };
 
 /**
@@ -27,18 +27,23 @@
 #include <profile.h>
 #endif
 
-#include <thread>
 #include <algorithm>
-#include <future>
 
 #include <connectivity/connectivity_data.h>
 #include <connectivity/connectivity_algo.h>
+#include <connectivity/connectivity_snapshot.h>
+#include <connectivity/connectivity_version.h>
 #include <ratsnest_data.h>
+#include <thread_pool.h>
+#include <trace_events.h>
 
 CONNECTIVITY_DATA::CONNECTIVITY_DATA()
 {
     m_connAlgo.reset( new CN_CONNECTIVITY_ALGO );
     m_progressReporter = nullptr;
+    std::atomic_store( &m_version, std::make_shared<const CONNECTIVITY_VERSION>(
+                                           0, std::vector<CONNECTIVITY_VERSION::NET_PTR>() ) );
+    setMemoryAccount();
 }
 
 
@@ -46,15 +51,48 @@ CONNECTIVITY_DATA::CONNECTIVITY_DATA( const std::vector<BOARD_ITEM*>& aItems )
 {
     Build( aItems );
     m_progressReporter = nullptr;
+    setMemoryAccount();
 }
 
 
 CONNECTIVITY_DATA::~CONNECTIVITY_DATA()
 {
+    m_memoryAccount.Reset();
     Clear();
 }
 
 
+void CONNECTIVITY_DATA::setMemoryAccount()
+{
+    m_memoryAccount.Set( "connectivity",
+            [this]()
+            {
+                MEMORY_ACCOUNTING::USAGE     usage;
+                std::unique_lock<std::mutex> lock( m_lock, std::try_to_lock );
+
+                // Not counted while the ratsnest is updated by another thread
+                if( !lock || !m_connAlgo )
+                    return usage;
+
+                usage.m_Bytes = m_connAlgo->GetMemoryUsage();
+                usage.m_Items = m_connAlgo->GetItemCount();
+
+                for( const RN_NET* net : m_nets )
+                {
+                    if( !net )
+                        continue;
+
+                    // The nodes and edges of the last update are kept for the next one
+                    usage.m_Bytes += sizeof( RN_NET );
+                    usage.m_Bytes += 2 * net->GetNodeCount() * sizeof( CN_ANCHOR_PTR );
+                    usage.m_Bytes += 2 * net->GetEdges().size() * sizeof( CN_EDGE );
+                }
+
+                return usage;
+            } );
+}
+
+
 bool CONNECTIVITY_DATA::Add( BOARD_ITEM* aItem )
 {
     m_connAlgo->Add( aItem );
@@ -77,14 +115,39 @@ bool CONNECTIVITY_DATA::Update( BOARD_ITEM* aItem )
 }
 
 
+void CONNECTIVITY_DATA::BeginBulkUpdate()
+{
+    m_connAlgo->BeginBulkUpdate();
+}
+
+
+void CONNECTIVITY_DATA::EndBulkUpdate()
+{
+    m_connAlgo->EndBulkUpdate();
+}
+
+
 void CONNECTIVITY_DATA::Build( BOARD* aBoard )
 {
     m_connAlgo.reset( new CN_CONNECTIVITY_ALGO );
     m_connAlgo->Build( aBoard );
+
+    if( aBoard->GetConnectivitySnapshot()
+            && !m_connAlgo->RestoreSnapshot( aBoard, *aBoard->GetConnectivitySnapshot() ) )
+    {
+        wxLogTrace( "CN", "The connectivity snapshot does not match the board" );
+    }
+
     RecalculateRatsnest();
 }
 
 
+void CONNECTIVITY_DATA::GetSnapshot( const BOARD* aBoard, CN_SNAPSHOT& aSnapshot )
+{
+    m_connAlgo->GetSnapshot( aBoard, aSnapshot );
+}
+
+
 void CONNECTIVITY_DATA::Build( const std::vector<BOARD_ITEM*>& aItems )
 {
     m_connAlgo.reset( new CN_CONNECTIVITY_ALGO );
@@ -96,6 +159,7 @@ void CONNECTIVITY_DATA::Build( const std::vector<BOARD_ITEM*>& aItems )
 
 void CONNECTIVITY_DATA::updateRatsnest()
 {
+    TRACE_SCOPE trace( "ratsnest-update" );
     #ifdef PROFILE
     PROF_COUNTER rnUpdate( "update-ratsnest" );
     #endif
@@ -106,31 +170,19 @@ void CONNECTIVITY_DATA::updateRatsnest()
     std::copy_if( m_nets.begin() + 1, m_nets.end(), std::back_inserter( dirty_nets ),
             [] ( RN_NET* aNet ) { return aNet->IsDirty() && aNet->GetNodeCount() > 0; } );
 
-    // We don't want to spin up a new thread for fewer than 8 nets (overhead costs)
-    size_t parallelThreadCount = std::min<size_t>( std::thread::hardware_concurrency(),
-            ( dirty_nets.size() + 7 ) / 8 );
-
-    std::atomic<size_t> nextNet( 0 );
-    std::vector<std::future<size_t>> returns( parallelThreadCount );
-
-    auto update_lambda = [&nextNet, &dirty_nets]() -> size_t
+    // We don't want to wake the pool for fewer than 8 nets (overhead costs)
+    if( dirty_nets.size() < 8 )
     {
-        for( size_t i = nextNet++; i < dirty_nets.size(); i = nextNet++ )
-            dirty_nets[i]->Update();
-
-        return 1;
-    };
-
-    if( parallelThreadCount == 1 )
-        update_lambda();
+        for( RN_NET* net : dirty_nets )
+            net->Update();
+    }
     else
     {
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-            returns[ii] = std::async( std::launch::async, update_lambda );
-
-        // Finalize the ratsnest threads
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-            returns[ii].wait();
+        THREAD_POOL::GetInstance().ParallelFor( dirty_nets.size(),
+                [&dirty_nets]( size_t i )
+                {
+                    dirty_nets[i]->Update();
+                } );
     }
 
     #ifdef PROFILE
@@ -149,6 +201,8 @@ void CONNECTIVITY_DATA::addRatsnestCluster( const std::shared_ptr<CN_CLUSTER>& a
 
 void CONNECTIVITY_DATA::RecalculateRatsnest( BOARD_COMMIT* aCommit  )
 {
+    m_dynamicItems.clear();
+    m_dynamicNodeIndex.clear();
     m_connAlgo->PropagateNets( aCommit );
 
     int lastNet = m_connAlgo->NetCount();
@@ -165,12 +219,14 @@ void CONNECTIVITY_DATA::RecalculateRatsnest( BOARD_COMMIT* aCommit  )
     auto clusters = m_connAlgo->GetClusters();
 
     int dirtyNets = 0;
+    std::vector<int> changedNets;
 
     for( int net = 0; net < lastNet; net++ )
     {
         if( m_connAlgo->IsNetDirty( net ) )
         {
             m_nets[net]->Clear();
+            changedNets.push_back( net );
             dirtyNets++;
         }
     }
@@ -188,6 +244,134 @@ void CONNECTIVITY_DATA::RecalculateRatsnest( BOARD_COMMIT* aCommit  )
     m_connAlgo->ClearDirtyFlags();
 
     updateRatsnest();
+
+    publishVersion( std::move( changedNets ) );
+}
+
+
+void CONNECTIVITY_DATA::publishVersion( std::vector<int> aChangedNets )
+{
+    std::shared_ptr<const CONNECTIVITY_VERSION> prev = std::atomic_load( &m_version );
+    int netCount = (int) m_nets.size();
+    int prevNetCount = prev ? prev->GetNetCount() : 0;
+
+    std::vector<bool> changed( netCount, false );
+
+    // The stats of a net change with its items, even if its connections did not
+    if( !m_connAlgo->GetChangedNetStats( m_versionStatsSerial, aChangedNets ) )
+        changed.assign( netCount, true );
+
+    for( int net : aChangedNets )
+    {
+        if( net >= 0 && net < netCount )
+            changed[net] = true;
+    }
+
+    std::vector<CONNECTIVITY_VERSION::NET_PTR> nets( netCount );
+    std::vector<std::shared_ptr<CN_NET_VERSION>> built( netCount );
+    std::vector<int> toBuild;
+
+    // Net 0 is reserved for not-connected
+    for( int net = 1; net < netCount; net++ )
+    {
+        if( changed[net] || net >= prevNetCount )
+        {
+            built[net] = std::make_shared<CN_NET_VERSION>();
+            built[net]->m_Net = net;
+            toBuild.push_back( net );
+        }
+        else
+        {
+            nets[net] = prev->GetNet( net );
+        }
+    }
+
+    for( const auto& cluster : m_connAlgo->GetClusters() )
+    {
+        int net = cluster->OriginNet();
+
+        if( net <= 0 || net >= netCount || !built[net] )
+            continue;
+
+        CN_NET_VERSION& netVersion = *built[net];
+        int clusterIndex = netVersion.m_ClusterCount++;
+
+        for( CN_ITEM* item : *cluster )
+        {
+            if( item->Valid() )
+                netVersion.m_Items.push_back( { item->Parent()->m_Uuid, item->Parent()->Type(),
+                                                clusterIndex } );
+        }
+    }
+
+    auto buildNet = [&]( int aNet )
+    {
+        CN_NET_VERSION& netVersion = *built[aNet];
+
+        std::sort( netVersion.m_Items.begin(), netVersion.m_Items.end(),
+                   []( const CN_NET_VERSION::ITEM& aLeft, const CN_NET_VERSION::ITEM& aRight )
+                   {
+                       if( aLeft.m_Uuid == aRight.m_Uuid )
+                           return aLeft.m_Cluster < aRight.m_Cluster;
+
+                       return aLeft.m_Uuid < aRight.m_Uuid;
+                   } );
+
+        // The outlines of a zone are items of their own, maybe in the same cluster
+        netVersion.m_Items.erase( std::unique( netVersion.m_Items.begin(),
+                                               netVersion.m_Items.end(),
+                                               []( const CN_NET_VERSION::ITEM& aLeft,
+                                                   const CN_NET_VERSION::ITEM& aRight )
+                                               {
+                                                   return aLeft.m_Uuid == aRight.m_Uuid
+                                                          && aLeft.m_Cluster == aRight.m_Cluster;
+                                               } ),
+                                  netVersion.m_Items.end() );
+
+        for( const CN_EDGE& edge : m_nets[aNet]->GetUnconnected() )
+        {
+            const CN_ANCHOR_PTR& source = edge.GetSourceNode();
+            const CN_ANCHOR_PTR& target = edge.GetTargetNode();
+
+            netVersion.m_Unconnected.push_back( { source->Parent()->m_Uuid,
+                                                  target->Parent()->m_Uuid,
+                                                  source->Pos(), target->Pos() } );
+        }
+
+        netVersion.m_Stats = m_connAlgo->GetNetStats( aNet );
+    };
+
+    // We don't want to wake the pool for fewer than 8 nets (overhead costs)
+    if( toBuild.size() < 8 )
+    {
+        for( int net : toBuild )
+            buildNet( net );
+    }
+    else
+    {
+        THREAD_POOL::GetInstance().ParallelFor( toBuild.size(),
+                [&]( size_t i )
+                {
+                    buildNet( toBuild[i] );
+                } );
+    }
+
+    for( int net : toBuild )
+    {
+        if( !built[net]->m_Items.empty() )
+            nets[net] = std::move( built[net] );
+    }
+
+    std::atomic_store( &m_version, std::make_shared<const CONNECTIVITY_VERSION>(
+                                           ++m_versionSerial, std::move( nets ) ) );
+
+    m_versionStatsSerial = m_connAlgo->GetNetStatsSerial();
+}
+
+
+std::shared_ptr<const CONNECTIVITY_VERSION> CONNECTIVITY_DATA::GetVersion() const
+{
+    return std::atomic_load( &m_version );
 }
 
 
@@ -255,7 +439,14 @@ void CONNECTIVITY_DATA::ComputeDynamicRatsnest( const std::vector<BOARD_ITEM*>&
     }
 
     CONNECTIVITY_DATA connData( aItems );
-    BlockRatsnestItems( aItems );
+
+    // The unselected part of the nets does not change while the same items are dragged
+    if( aItems != m_dynamicItems )
+    {
+        BlockRatsnestItems( aItems );
+        m_dynamicItems = aItems;
+        m_dynamicNodeIndex.clear();
+    }
 
     for( unsigned int nc = 1; nc < connData.m_nets.size(); nc++ )
     {
@@ -263,9 +454,12 @@ void CONNECTIVITY_DATA::ComputeDynamicRatsnest( const std::vector<BOARD_ITEM*>&
 
         if( dynNet->GetNodeCount() != 0 )
         {
-            auto ourNet = m_nets[nc];
+            auto& ourNet = m_dynamicNodeIndex[nc];
             CN_ANCHOR_PTR nodeA, nodeB;
 
+            if( !ourNet )
+                ourNet = std::make_shared<RN_NODE_INDEX>( *m_nets[nc] );
+
             if( ourNet->NearestBicoloredPair( *dynNet, nodeA, nodeB ) )
             {
                 RN_DYNAMIC_LINE l;
@@ -306,6 +500,8 @@ void CONNECTIVITY_DATA::ComputeDynamicRatsnest( const std::vector<BOARD_ITEM*>&
 void CONNECTIVITY_DATA::ClearDynamicRatsnest()
 {
     m_connAlgo->ForEachAnchor( [] ( CN_ANCHOR& anchor ) { anchor.SetNoLine( false ); } );
+    m_dynamicItems.clear();
+    m_dynamicNodeIndex.clear();
     HideDynamicRatsnest();
 }
 
@@ -345,10 +541,17 @@ unsigned int CONNECTIVITY_DATA::GetUnconnectedCount() const
 
 void CONNECTIVITY_DATA::Clear()
 {
+    m_dynamicItems.clear();
+    m_dynamicNodeIndex.clear();
+
     for( auto net : m_nets )
         delete net;
 
     m_nets.clear();
+
+    std::atomic_store( &m_version, std::make_shared<const CONNECTIVITY_VERSION>(
+                                           ++m_versionSerial,
+                                           std::vector<CONNECTIVITY_VERSION::NET_PTR>() ) );
 }
 
 
@@ -358,21 +561,20 @@ const std::vector<BOARD_CONNECTED_ITEM*> CONNECTIVITY_DATA::GetConnectedItems(
         bool aIgnoreNetcodes ) const
 {
     std::vector<BOARD_CONNECTED_ITEM*> rv;
+
+    // Only the clusters holding aItem are built
     const auto clusters = m_connAlgo->SearchClusters(
             aIgnoreNetcodes ?
                     CN_CONNECTIVITY_ALGO::CSM_PROPAGATE :
                     CN_CONNECTIVITY_ALGO::CSM_CONNECTIVITY_CHECK, aTypes,
-            aIgnoreNetcodes ? -1 : aItem->GetNetCode() );
+            aIgnoreNetcodes ? -1 : aItem->GetNetCode(), aItem );
 
     for( auto cl : clusters )
     {
-        if( cl->Contains( aItem ) )
+        for( const auto item : *cl )
         {
-            for( const auto item : *cl )
-            {
-                if( item->Valid() )
-                    rv.push_back( item->Parent() );
-            }
+            if( item->Valid() )
+                rv.push_back( item->Parent() );
         }
     }
 
@@ -521,6 +723,24 @@ unsigned int CONNECTIVITY_DATA::GetPadCount( int aNet ) const
 }
 
 
+const CN_NET_STATS& CONNECTIVITY_DATA::GetNetStats( int aNet ) const
+{
+    return m_connAlgo->GetNetStats( aNet );
+}
+
+
+uint64_t CONNECTIVITY_DATA::GetNetStatsSerial() const
+{
+    return m_connAlgo->GetNetStatsSerial();
+}
+
+
+bool CONNECTIVITY_DATA::GetChangedNetStats( uint64_t aSerial, std::vector<int>& aNets ) const
+{
+    return m_connAlgo->GetChangedNetStats( aSerial, aNets );
+}
+
+
 const std::vector<VECTOR2I> CONNECTIVITY_DATA::NearestUnconnectedTargets(
         const BOARD_CONNECTED_ITEM* aRef,
         const VECTOR2I& aPos,
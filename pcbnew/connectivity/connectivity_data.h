@@ -29,17 +29,21 @@
 
 #include <core/typeinfo.h>
 
+#include <cstdint>
 #include <memory>
 #include <mutex>
+#include <unordered_map>
 #include <vector>
 #include <wx/string.h>
 
 #include <math/vector2d.h>
+#include <memory_accounting.h>
 #include <geometry/shape_poly_set.h>
 #include <class_zone.h>
 
 class CN_CLUSTER;
 class CN_CONNECTIVITY_ALGO;
+class CONNECTIVITY_VERSION;
 class CN_EDGE;
 class BOARD;
 class BOARD_COMMIT;
@@ -48,10 +52,12 @@ class BOARD_ITEM;
 class ZONE_CONTAINER;
 class RN_DATA;
 class RN_NET;
+class RN_NODE_INDEX;
 class TRACK;
 class D_PAD;
 class MODULE;
 class PROGRESS_REPORTER;
+struct CN_SNAPSHOT;
 
 struct CN_DISJOINT_NET_ENTRY
 {
@@ -76,6 +82,36 @@ struct RN_DYNAMIC_LINE
     VECTOR2I a, b;
 };
 
+/**
+ * The counts and lengths of the items of a net, which CONNECTIVITY_DATA keeps up to date
+ * as the items are added, removed and updated.
+ */
+struct CN_NET_STATS
+{
+    int     m_PadCount = 0;
+    int     m_ViaCount = 0;
+    int64_t m_TrackLength = 0;      ///< the length of the tracks and arcs
+    int64_t m_PadToDieLength = 0;
+
+    CN_NET_STATS& operator+=( const CN_NET_STATS& aOther )
+    {
+        m_PadCount += aOther.m_PadCount;
+        m_ViaCount += aOther.m_ViaCount;
+        m_TrackLength += aOther.m_TrackLength;
+        m_PadToDieLength += aOther.m_PadToDieLength;
+        return *this;
+    }
+
+    CN_NET_STATS& operator-=( const CN_NET_STATS& aOther )
+    {
+        m_PadCount -= aOther.m_PadCount;
+        m_ViaCount -= aOther.m_ViaCount;
+        m_TrackLength -= aOther.m_TrackLength;
+        m_PadToDieLength -= aOther.m_PadToDieLength;
+        return *this;
+    }
+};
+
 // a wrapper class encompassing the connectivity computation algorithm and the
 class CONNECTIVITY_DATA
 {
@@ -87,7 +123,8 @@ public:
 
     /**
      * Function Build()
-     * Builds the connectivity database for the board aBoard.
+     * Builds the connectivity database for the board aBoard.  The connections of the board
+     * snapshot, if any, are restored instead of searched.
      */
     void Build( BOARD* aBoard );
 
@@ -97,6 +134,12 @@ public:
      */
     void Build( const std::vector<BOARD_ITEM*>& aItems );
 
+    /**
+     * Function GetSnapshot()
+     * Returns the connections of the items of aBoard, to be saved with the board file.
+     */
+    void GetSnapshot( const BOARD* aBoard, CN_SNAPSHOT& aSnapshot );
+
     /**
      * Function Add()
      * Adds an item to the connectivity data.
@@ -121,6 +164,20 @@ public:
      */
     bool Update( BOARD_ITEM* aItem );
 
+    /**
+     * Function BeginBulkUpdate()
+     * Defers the spatial indexing of the items added or updated until EndBulkUpdate(), which
+     * is much faster when adding or updating many items at once.  The connections are not
+     * searched until EndBulkUpdate().
+     */
+    void BeginBulkUpdate();
+
+    /**
+     * Function EndBulkUpdate()
+     * Indexes the items added or updated since BeginBulkUpdate().
+     */
+    void EndBulkUpdate();
+
     /**
      * Function Clear()
      * Erases the connectivity database.
@@ -173,6 +230,35 @@ public:
 
     unsigned int GetPadCount( int aNet = -1 ) const;
 
+    /**
+     * Function GetNetStats()
+     * Returns the pad and via counts and the track lengths of the net aNet, maintained with
+     * the items instead of computed.
+     */
+    const CN_NET_STATS& GetNetStats( int aNet ) const;
+
+    /**
+     * Function GetNetStatsSerial()
+     * Returns the serial of the last change of the net statistics, to find the nets changed
+     * since with GetChangedNetStats().
+     */
+    uint64_t GetNetStatsSerial() const;
+
+    /**
+     * Function GetChangedNetStats()
+     * Returns in aNets the nets whose statistics changed after the serial aSerial.
+     * @return false if the connectivity was rebuilt since aSerial: any net may have changed
+     */
+    bool GetChangedNetStats( uint64_t aSerial, std::vector<int>& aNets ) const;
+
+    /**
+     * Function GetVersion()
+     * Returns the immutable copy of the connections and of the ratsnest published by the last
+     * ratsnest update (never nullptr).  Unlike the rest of the class, it can be called from
+     * any thread without locking, and the version stays valid while the board is edited.
+     */
+    std::shared_ptr<const CONNECTIVITY_VERSION> GetVersion() const;
+
     const std::vector<TRACK*> GetConnectedTracks( const BOARD_CONNECTED_ITEM* aItem ) const;
 
     const std::vector<D_PAD*> GetConnectedPads( const BOARD_CONNECTED_ITEM* aItem ) const;
@@ -201,6 +287,9 @@ public:
      * Function ComputeDynamicRatsnest()
      * Calculates the temporary dynamic ratsnest (i.e. the ratsnest lines that)
      * for the set of items aItems.
+     * The first call for a given set of items starts a drag session: the static part of their
+     * nets is indexed once, and the next calls with the same items only link the moved nodes
+     * to it.  The session ends with ClearDynamicRatsnest() or a ratsnest update.
      */
     void ComputeDynamicRatsnest( const std::vector<BOARD_ITEM*>& aItems );
 
@@ -255,14 +344,35 @@ private:
     void    updateRatsnest();
     void    addRatsnestCluster( const std::shared_ptr<CN_CLUSTER>& aCluster );
 
+    /**
+     * Publishes a new version of the connectivity, copying the nets aChangedNets and those
+     * whose statistics changed, and sharing the other nets with the previous version.
+     */
+    void    publishVersion( std::vector<int> aChangedNets );
+
     std::shared_ptr<CN_CONNECTIVITY_ALGO> m_connAlgo;
 
     std::vector<RN_DYNAMIC_LINE> m_dynamicRatsnest;
+
+    ///> The items of the current dynamic ratsnest session, and the index of the static
+    ///> nodes of each of their nets (built on demand)
+    std::vector<BOARD_ITEM*> m_dynamicItems;
+    std::unordered_map<int, std::shared_ptr<RN_NODE_INDEX>> m_dynamicNodeIndex;
     std::vector<RN_NET*> m_nets;
 
     PROGRESS_REPORTER* m_progressReporter;
 
     std::mutex m_lock;
+
+    ///> The last published version, only accessed with std::atomic_load/atomic_store
+    std::shared_ptr<const CONNECTIVITY_VERSION> m_version;
+    uint64_t m_versionSerial = 0;
+    uint64_t m_versionStatsSerial = 0;     ///< the net stats serial of m_version
+
+    ///> The memory of the connectivity graph and of the ratsnest
+    MEMORY_ACCOUNT m_memoryAccount;
+
+    void setMemoryAccount();
 };
 
 #endif
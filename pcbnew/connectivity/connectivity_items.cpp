@@ -26,6 +26,33 @@
 
 #include <connectivity/connectivity_items.h>
 
+
+///> The pool of the items: its chunks hold a CN_ITEM or a CN_ZONE
+using CN_ITEM_POOL = CN_POOL<std::max( sizeof( CN_ITEM ), sizeof( CN_ZONE ) ),
+                             std::max( alignof( CN_ITEM ), alignof( CN_ZONE ) )>;
+
+
+void* CN_ITEM::operator new( size_t aSize )
+{
+    if( aSize <= CN_ITEM_POOL::CHUNK_SIZE )
+        return CN_ITEM_POOL::Instance().Allocate();
+
+    return ::operator new( aSize );
+}
+
+
+void CN_ITEM::operator delete( void* aPtr, size_t aSize )
+{
+    if( !aPtr )
+        return;
+
+    if( aSize <= CN_ITEM_POOL::CHUNK_SIZE )
+        CN_ITEM_POOL::Instance().Free( aPtr );
+    else
+        ::operator delete( aPtr );
+}
+
+
 int CN_ITEM::AnchorCount() const
 {
     if( !m_valid )
@@ -268,12 +295,13 @@ CN_ITEM* CN_LIST::Add( ARC* aArc )
  const std::vector<CN_ITEM*> CN_LIST::Add( ZONE_CONTAINER* zone )
  {
      const auto& polys = zone->GetFilledPolysList();
+     auto        index = polys.GetIndex();
 
      std::vector<CN_ITEM*> rv;
 
      for( int j = 0; j < polys.OutlineCount(); j++ )
      {
-         CN_ZONE* zitem = new CN_ZONE( zone, false, j );
+         CN_ZONE* zitem = new CN_ZONE( zone, false, j, index );
          const auto& outline = zone->GetFilledPolysList().COutline( j );
 
          for( int k = 0; k < outline.PointCount(); k++ )
@@ -308,11 +336,27 @@ void CN_LIST::RemoveInvalidItems( std::vector<CN_ITEM*>& aGarbage )
 
     m_items.resize( lastItem - m_items.begin() );
 
-    for( auto item : m_items )
-        item->RemoveInvalidRefs();
+    // Connections are always made both ways, so only the items connected to the removed
+    // ones refer to them
+    for( auto garbage : aGarbage )
+    {
+        for( auto item : garbage->ConnectedItems() )
+        {
+            if( item->Valid() )
+                item->RemoveInvalidRefs();
+        }
+    }
 
-    for( auto item : aGarbage )
-        m_index.Remove( item );
+    // Rebuilding the index is faster than removing many items from it one by one
+    if( aGarbage.size() > m_items.size() / 8 )
+    {
+        m_index.BulkLoad( m_items );
+    }
+    else
+    {
+        for( auto item : aGarbage )
+            m_index.Remove( item );
+    }
 
     m_hasInvalid = false;
 }
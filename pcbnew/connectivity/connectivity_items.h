@@ -36,17 +36,17 @@
 #include <class_zone.h>
 
 #include <geometry/shape_poly_set.h>
-#include <geometry/poly_grid_partition.h>
+#include <geometry/poly_set_index.h>
 
 #include <memory>
 #include <algorithm>
 #include <functional>
 #include <vector>
 #include <deque>
-#include <intrusive_list.h>
 
 #include <connectivity/connectivity_rtree.h>
 #include <connectivity/connectivity_data.h>
+#include <connectivity/connectivity_pool.h>
 
 class CN_ITEM;
 class CN_CLUSTER;
@@ -157,7 +157,7 @@ typedef std::vector<CN_ANCHOR_PTR>  CN_ANCHORS;
 
 
 // basic connectivity item
-class CN_ITEM : public INTRUSIVE_LIST<CN_ITEM>
+class CN_ITEM
 {
 public:
     using CONNECTED_ITEMS = std::vector<CN_ITEM*>;
@@ -209,9 +209,14 @@ public:
 
     virtual ~CN_ITEM() {};
 
+    ///> Items (and zone items) are taken from a pool, see CN_POOL
+    static void* operator new( size_t aSize );
+    static void operator delete( void* aPtr, size_t aSize );
+
     void AddAnchor( const VECTOR2I& aPos )
     {
-        m_anchors.emplace_back( std::make_shared<CN_ANCHOR>( aPos, this ) );
+        m_anchors.emplace_back(
+                std::allocate_shared<CN_ANCHOR>( CN_POOL_ALLOCATOR<CN_ANCHOR>(), aPos, this ) );
     }
 
     CN_ANCHORS& Anchors()
@@ -219,6 +224,11 @@ public:
         return m_anchors;
     }
 
+    const CN_ANCHORS& Anchors() const
+    {
+        return m_anchors;
+    }
+
     void SetValid( bool aValid )
     {
         m_valid = aValid;
@@ -347,16 +357,16 @@ typedef std::shared_ptr<CN_ITEM> CN_ITEM_PTR;
 class CN_ZONE : public CN_ITEM
 {
 public:
-    CN_ZONE( ZONE_CONTAINER* aParent, bool aCanChangeNet, int aSubpolyIndex ) :
+    /**
+     * @param aIndex is the index of aParent's filled polygons (see SHAPE_POLY_SET::GetIndex()),
+     *               shared by the items of all the filled polygons of the zone.
+     */
+    CN_ZONE( ZONE_CONTAINER* aParent, bool aCanChangeNet, int aSubpolyIndex,
+             std::shared_ptr<const POLY_SET_INDEX> aIndex ) :
         CN_ITEM( aParent, aCanChangeNet ),
+        m_index( std::move( aIndex ) ),
         m_subpolyIndex( aSubpolyIndex )
     {
-        SHAPE_LINE_CHAIN outline = aParent->GetFilledPolysList().COutline( aSubpolyIndex );
-
-        outline.SetClosed( true );
-        outline.Simplify();
-
-        m_cachedPoly = std::make_unique<POLY_GRID_PARTITION>( outline, 16 );
     }
 
     int SubpolyIndex() const
@@ -364,6 +374,11 @@ public:
         return m_subpolyIndex;
     }
 
+    const std::shared_ptr<const POLY_SET_INDEX>& Index() const
+    {
+        return m_index;
+    }
+
     bool ContainsAnchor( const CN_ANCHOR_PTR anchor ) const
     {
         return ContainsPoint( anchor->Pos() );
@@ -373,13 +388,13 @@ public:
     {
         auto zone = static_cast<ZONE_CONTAINER*> ( Parent() );
         int clearance = zone->GetFilledPolysUseThickness() ? zone->GetMinThickness() / 2 : 0;
-        return m_cachedPoly->ContainsPoint( p, clearance );
+        return m_index->Collide( p, clearance, m_subpolyIndex );
     }
 
     const BOX2I& BBox()
     {
         if( m_dirty )
-            m_bbox = m_cachedPoly->BBox();
+            m_bbox = m_index->BBox( m_subpolyIndex );
 
         return m_bbox;
     }
@@ -388,9 +403,8 @@ public:
     virtual const VECTOR2I  GetAnchor( int n ) const override;
 
 private:
-    std::vector<VECTOR2I> m_testOutlinePoints;
-    std::unique_ptr<POLY_GRID_PARTITION> m_cachedPoly;
-    int m_subpolyIndex;
+    std::shared_ptr<const POLY_SET_INDEX> m_index;
+    int                                   m_subpolyIndex;
 };
 
 class CN_LIST
@@ -398,6 +412,7 @@ class CN_LIST
 private:
     bool m_dirty;
     bool m_hasInvalid;
+    bool m_bulkLoad;
 
     CN_RTREE<CN_ITEM*> m_index;
 
@@ -406,7 +421,8 @@ protected:
 
     void addItemtoTree( CN_ITEM* item )
     {
-        m_index.Insert( item );
+        if( !m_bulkLoad )
+            m_index.Insert( item );
     }
 
 public:
@@ -414,6 +430,20 @@ public:
     {
         m_dirty = false;
         m_hasInvalid = false;
+        m_bulkLoad = false;
+    }
+
+    ///> Stops indexing the added items until EndBulkLoad(), to add many items at once
+    void BeginBulkLoad()
+    {
+        m_bulkLoad = true;
+    }
+
+    ///> Rebuilds the index of all the items in one go
+    void EndBulkLoad()
+    {
+        m_bulkLoad = false;
+        m_index.BulkLoad( m_items );
     }
 
     void Clear()
@@ -0,0 +1,152 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef PCBNEW_CONNECTIVITY_POOL_H_
+#define PCBNEW_CONNECTIVITY_POOL_H_
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+
+/**
+ * CN_POOL
+ * A free list of memory chunks of SIZE bytes, allocated in large blocks.
+ *
+ * The connectivity items and anchors are created and destroyed by the hundred thousand on
+ * each build of a large board.  Recycling their memory saves most of the heap traffic, and
+ * keeps the objects of a build close to each other.  The memory is kept for the next
+ * builds, and is never returned to the system.  Thread safe.
+ *
+ * The board tracks and vias are also taken from pools, for the same reasons.
+ */
+template <size_t SIZE, size_t ALIGN>
+class CN_POOL
+{
+public:
+    static constexpr size_t CHUNK_SIZE = SIZE;
+
+    ///> The pool of the chunks of this size.  It is never destroyed, as anchors may be
+    ///> released by static objects at exit.
+    static CN_POOL& Instance()
+    {
+        static CN_POOL* pool = new CN_POOL;
+
+        return *pool;
+    }
+
+    void* Allocate()
+    {
+        std::lock_guard<std::mutex> lock( m_lock );
+
+        if( !m_free )
+        {
+            m_blocks.emplace_back( new CHUNK[BLOCK_SIZE] );
+
+            for( size_t i = 0; i < BLOCK_SIZE; i++ )
+            {
+                m_blocks.back()[i].m_next = m_free;
+                m_free = &m_blocks.back()[i];
+            }
+        }
+
+        CHUNK* chunk = m_free;
+        m_free = chunk->m_next;
+
+        return chunk;
+    }
+
+    void Free( void* aChunk )
+    {
+        std::lock_guard<std::mutex> lock( m_lock );
+        CHUNK*                      chunk = static_cast<CHUNK*>( aChunk );
+
+        chunk->m_next = m_free;
+        m_free = chunk;
+    }
+
+private:
+    union CHUNK
+    {
+        CHUNK*                                       m_next;
+        typename std::aligned_storage<SIZE, ALIGN>::type m_storage;
+    };
+
+    static constexpr size_t BLOCK_SIZE = 4096;
+
+    std::mutex                              m_lock;
+    CHUNK*                                  m_free = nullptr;
+    std::vector<std::unique_ptr<CHUNK[]>>   m_blocks;
+};
+
+
+/**
+ * CN_POOL_ALLOCATOR
+ * A standard allocator taking the single objects from a CN_POOL, for std::allocate_shared().
+ */
+template <class T>
+class CN_POOL_ALLOCATOR
+{
+public:
+    typedef T value_type;
+
+    CN_POOL_ALLOCATOR() = default;
+
+    template <class U>
+    CN_POOL_ALLOCATOR( const CN_POOL_ALLOCATOR<U>& )
+    {
+    }
+
+    T* allocate( size_t aCount )
+    {
+        if( aCount == 1 )
+            return static_cast<T*>( CN_POOL<sizeof( T ), alignof( T )>::Instance().Allocate() );
+
+        return static_cast<T*>( ::operator new( aCount * sizeof( T ) ) );
+    }
+
+    void deallocate( T* aPtr, size_t aCount )
+    {
+        if( aCount == 1 )
+            CN_POOL<sizeof( T ), alignof( T )>::Instance().Free( aPtr );
+        else
+            ::operator delete( aPtr );
+    }
+
+    template <class U>
+    bool operator==( const CN_POOL_ALLOCATOR<U>& ) const
+    {
+        return true;
+    }
+
+    template <class U>
+    bool operator!=( const CN_POOL_ALLOCATOR<U>& ) const
+    {
+        return false;
+    }
+};
+
+#endif /* PCBNEW_CONNECTIVITY_POOL_H_ */
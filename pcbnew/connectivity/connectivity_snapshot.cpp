@@ -0,0 +1,211 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <connectivity/connectivity_snapshot.h>
+
+#include <cstring>
+
+#include <md5_hash.h>
+
+#include <wx/ffile.h>
+#include <wx/filefn.h>
+#include <wx/filename.h>
+
+
+static const char     SNAPSHOT_MAGIC[8] = { 'K', 'I', 'C', 'A', 'D', 'C', 'N', '1' };
+static const uint32_t SNAPSHOT_BYTE_ORDER = 0x01020304;
+
+
+/**
+ * The hash of the contents of a file.  Hashing a big board costs a fraction of parsing it.
+ */
+static bool hashFile( const wxString& aFileName, std::string& aHash, uint64_t& aSize )
+{
+    wxFFile file( aFileName, "rb" );
+
+    if( !file.IsOpened() )
+        return false;
+
+    std::vector<uint8_t> block( 1 << 20 );
+    MD5_HASH             hash;
+
+    hash.Init();
+    aSize = 0;
+
+    for( ;; )
+    {
+        size_t count = file.Read( block.data(), block.size() );
+
+        if( count == 0 )
+            break;
+
+        hash.Hash( block.data(), (uint32_t) count );
+        aSize += count;
+    }
+
+    if( file.Error() )
+        return false;
+
+    hash.Finalize();
+    aHash = hash.Format();
+
+    return true;
+}
+
+
+template <typename T>
+static bool writeValues( wxFFile& aFile, const T* aValues, size_t aCount )
+{
+    return aCount == 0 || aFile.Write( aValues, aCount * sizeof( T ) ) == aCount * sizeof( T );
+}
+
+
+template <typename T>
+static bool readValues( wxFFile& aFile, T* aValues, size_t aCount )
+{
+    return aCount == 0 || aFile.Read( aValues, aCount * sizeof( T ) ) == aCount * sizeof( T );
+}
+
+
+wxString ConnectivitySnapshotFileName( const wxString& aBoardFileName )
+{
+    return aBoardFileName + "-snapshot";
+}
+
+
+bool WriteConnectivitySnapshot( const wxString& aBoardFileName, const CN_SNAPSHOT& aSnapshot )
+{
+    wxString    fileName = ConnectivitySnapshotFileName( aBoardFileName );
+    std::string boardHash;
+    uint64_t    boardSize;
+
+    if( !hashFile( aBoardFileName, boardHash, boardSize ) )
+        return false;
+
+    uint64_t itemCount = aSnapshot.m_items.size();
+    uint64_t connectionCount = aSnapshot.m_connections.size();
+    bool     ok;
+
+    {
+        wxFFile file( fileName, "wb" );
+
+        ok = file.IsOpened()
+             && writeValues( file, SNAPSHOT_MAGIC, sizeof( SNAPSHOT_MAGIC ) )
+             && writeValues( file, &SNAPSHOT_BYTE_ORDER, 1 )
+             && writeValues( file, &boardSize, 1 )
+             && writeValues( file, boardHash.data(), boardHash.size() )
+             && writeValues( file, &itemCount, 1 )
+             && writeValues( file, aSnapshot.m_items.data(), itemCount )
+             && writeValues( file, &connectionCount, 1 );
+
+        for( const std::pair<uint32_t, uint32_t>& connection : aSnapshot.m_connections )
+        {
+            if( !ok )
+                break;
+
+            ok = writeValues( file, &connection.first, 1 )
+                 && writeValues( file, &connection.second, 1 );
+        }
+
+        ok = file.Close() && ok;
+    }
+
+    // A partial snapshot would only be rejected when read
+    if( !ok )
+        wxRemoveFile( fileName );
+
+    return ok;
+}
+
+
+bool ReadConnectivitySnapshot( const wxString& aBoardFileName, CN_SNAPSHOT& aSnapshot )
+{
+    wxString fileName = ConnectivitySnapshotFileName( aBoardFileName );
+
+    if( !wxFileExists( fileName ) )
+        return false;
+
+    wxFFile file( fileName, "rb" );
+
+    if( !file.IsOpened() )
+        return false;
+
+    char        magic[sizeof( SNAPSHOT_MAGIC )];
+    uint32_t    byteOrder = 0;
+    uint64_t    savedSize = 0;
+    std::string savedHash( 32, ' ' );
+    std::string boardHash;
+    uint64_t    boardSize;
+
+    if( !readValues( file, magic, sizeof( magic ) )
+            || memcmp( magic, SNAPSHOT_MAGIC, sizeof( magic ) ) != 0
+            || !readValues( file, &byteOrder, 1 ) || byteOrder != SNAPSHOT_BYTE_ORDER
+            || !readValues( file, &savedSize, 1 )
+            || !readValues( file, &savedHash[0], savedHash.size() ) )
+    {
+        return false;
+    }
+
+    // The size is checked first: most changed boards are rejected without hashing them
+    wxULongLong currentSize = wxFileName::GetSize( aBoardFileName );
+
+    if( currentSize == wxInvalidSize || currentSize.GetValue() != savedSize )
+        return false;
+
+    if( !hashFile( aBoardFileName, boardHash, boardSize ) || boardSize != savedSize
+            || boardHash != savedHash )
+    {
+        return false;
+    }
+
+    uint64_t itemCount = 0;
+    uint64_t connectionCount = 0;
+
+    // The counts are checked against the snapshot size before anything is allocated
+    uint64_t remaining = (uint64_t) ( file.Length() - file.Tell() );
+
+    if( !readValues( file, &itemCount, 1 ) || itemCount * sizeof( uint32_t ) > remaining )
+        return false;
+
+    aSnapshot.m_items.resize( itemCount );
+
+    if( !readValues( file, aSnapshot.m_items.data(), itemCount )
+            || !readValues( file, &connectionCount, 1 )
+            || connectionCount * 2 * sizeof( uint32_t ) > remaining )
+    {
+        return false;
+    }
+
+    aSnapshot.m_connections.resize( connectionCount );
+
+    for( std::pair<uint32_t, uint32_t>& connection : aSnapshot.m_connections )
+    {
+        if( !readValues( file, &connection.first, 1 ) || !readValues( file, &connection.second, 1 )
+                || connection.first >= itemCount || connection.second >= itemCount )
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
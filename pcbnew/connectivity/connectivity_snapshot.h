@@ -0,0 +1,72 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef __CONNECTIVITY_SNAPSHOT_H
+#define __CONNECTIVITY_SNAPSHOT_H
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include <wx/string.h>
+
+/**
+ * CN_SNAPSHOT
+ * holds the connections found between the copper items of a board.  Saved next to the board
+ * file, they let pcbnew reopen a big board without searching them again.
+ *
+ * The items are identified by their rank in the order CN_CONNECTIVITY_ALGO::Build( BOARD* )
+ * adds them, which is the order of the board file.
+ */
+struct CN_SNAPSHOT
+{
+    ///> the type and layers of each item, to check that the snapshot matches the board
+    std::vector<uint32_t>                      m_items;
+
+    ///> the ranks of the connected items, the lower first
+    std::vector<std::pair<uint32_t, uint32_t>> m_connections;
+};
+
+
+/**
+ * @return the name of the snapshot file kept next to a board file.
+ */
+wxString ConnectivitySnapshotFileName( const wxString& aBoardFileName );
+
+/**
+ * Function WriteConnectivitySnapshot
+ * writes the snapshot of a board just saved to aBoardFileName.  The snapshot holds a hash of
+ * the board file: it is ignored once the board file is changed.
+ * @return false if the snapshot could not be written (there is then no snapshot file).
+ */
+bool WriteConnectivitySnapshot( const wxString& aBoardFileName, const CN_SNAPSHOT& aSnapshot );
+
+/**
+ * Function ReadConnectivitySnapshot
+ * reads the snapshot of a board file.
+ * @return false if there is no snapshot, or if it was written for another version of the
+ *         board file.
+ */
+bool ReadConnectivitySnapshot( const wxString& aBoardFileName, CN_SNAPSHOT& aSnapshot );
+
+#endif
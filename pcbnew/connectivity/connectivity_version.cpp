@@ -0,0 +1,75 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <connectivity/connectivity_version.h>
+
+#include <algorithm>
+
+
+void CN_NET_VERSION::GetClusters( const KIID& aUuid, std::vector<int>& aClusters ) const
+{
+    auto range = std::equal_range( m_Items.begin(), m_Items.end(), ITEM{ aUuid, TYPE_NOT_INIT, 0 },
+                                   []( const ITEM& aLeft, const ITEM& aRight )
+                                   {
+                                       return aLeft.m_Uuid < aRight.m_Uuid;
+                                   } );
+
+    for( auto it = range.first; it != range.second; ++it )
+        aClusters.push_back( it->m_Cluster );
+}
+
+
+CONNECTIVITY_VERSION::CONNECTIVITY_VERSION( uint64_t aSerial, std::vector<NET_PTR> aNets ) :
+        m_serial( aSerial ),
+        m_nets( std::move( aNets ) ),
+        m_unconnectedCount( 0 )
+{
+    for( const NET_PTR& net : m_nets )
+    {
+        if( net )
+            m_unconnectedCount += net->m_Unconnected.size();
+    }
+}
+
+
+bool CONNECTIVITY_VERSION::IsConnected( int aNet, const KIID& aA, const KIID& aB ) const
+{
+    NET_PTR net = GetNet( aNet );
+
+    if( !net )
+        return false;
+
+    std::vector<int> clustersA;
+    std::vector<int> clustersB;
+
+    net->GetClusters( aA, clustersA );
+    net->GetClusters( aB, clustersB );
+
+    for( int cluster : clustersA )
+    {
+        if( std::find( clustersB.begin(), clustersB.end(), cluster ) != clustersB.end() )
+            return true;
+    }
+
+    return false;
+}
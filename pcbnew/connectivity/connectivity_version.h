@@ -0,0 +1,114 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef __CONNECTIVITY_VERSION_H
+#define __CONNECTIVITY_VERSION_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <common.h>
+#include <core/typeinfo.h>
+#include <math/vector2d.h>
+#include <connectivity/connectivity_data.h>
+
+
+/**
+ * CN_NET_VERSION
+ * holds the connections and the ratsnest of one net, as of an update of the ratsnest.  It
+ * is never modified once built: the versions of the connectivity in which the net did not
+ * change share it.
+ *
+ * The items are identified by their uuid: they may be deleted while the version is read.
+ */
+struct CN_NET_VERSION
+{
+    struct ITEM
+    {
+        KIID    m_Uuid;
+        KICAD_T m_Type;
+        int     m_Cluster;      ///< the items of a cluster are connected together
+    };
+
+    struct EDGE
+    {
+        KIID     m_SourceItem;
+        KIID     m_TargetItem;
+        VECTOR2I m_Source;
+        VECTOR2I m_Target;
+    };
+
+    int               m_Net = 0;
+    int               m_ClusterCount = 0;
+    std::vector<ITEM> m_Items;          ///< sorted by uuid, a zone once per cluster it is in
+    std::vector<EDGE> m_Unconnected;    ///< the ratsnest edges
+    CN_NET_STATS      m_Stats;
+
+    /**
+     * Appends the clusters of the item aUuid to aClusters (none if it is not in the net).
+     */
+    void GetClusters( const KIID& aUuid, std::vector<int>& aClusters ) const;
+};
+
+
+/**
+ * CONNECTIVITY_VERSION
+ * an immutable copy of the connections and of the ratsnest of a board, published by
+ * CONNECTIVITY_DATA after each update of the ratsnest (see CONNECTIVITY_DATA::GetVersion()).
+ *
+ * A version can be read by any thread without locking, while the board is edited: it is
+ * only released once its last reader drops it.  The nets which did not change between two
+ * versions are shared by them, so publishing a version only copies the changed nets.
+ */
+class CONNECTIVITY_VERSION
+{
+public:
+    using NET_PTR = std::shared_ptr<const CN_NET_VERSION>;
+
+    CONNECTIVITY_VERSION( uint64_t aSerial, std::vector<NET_PTR> aNets );
+
+    /// @return the number of the version, greater than that of the previous ones
+    uint64_t GetSerial() const { return m_serial; }
+
+    int GetNetCount() const { return (int) m_nets.size(); }
+
+    /// @return the net aNet, or nullptr if it has no connected item
+    NET_PTR GetNet( int aNet ) const
+    {
+        return aNet >= 0 && aNet < (int) m_nets.size() ? m_nets[aNet] : nullptr;
+    }
+
+    /// @return the number of ratsnest edges of all the nets
+    unsigned int GetUnconnectedCount() const { return m_unconnectedCount; }
+
+    /// @return true if the items aA and aB of the net aNet are connected together
+    bool IsConnected( int aNet, const KIID& aA, const KIID& aB ) const;
+
+private:
+    uint64_t             m_serial;
+    std::vector<NET_PTR> m_nets;
+    unsigned int         m_unconnectedCount;
+};
+
+#endif
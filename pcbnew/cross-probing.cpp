@@ -44,6 +44,7 @@
 #include <netlist_reader/pcb_netlist.h>
 #include <pcb_edit_frame.h>
 #include <pcb_painter.h>
+#include <pcb_view.h>
 #include <pcbnew.h>
 #include <pgm_base.h>
 #include <tool/tool_manager.h>
@@ -189,7 +190,7 @@ void PCB_EDIT_FRAME::ExecuteRemoteCommand( const char* cmdline )
     else if( strcmp( idcmd, "$CLEAR" ) == 0 )
     {
         renderSettings->SetHighlight( false );
-        view->UpdateAllLayersColor();
+        GetCanvas()->GetView()->UpdateHighlightColors();
 
         pcb->ResetNetHighLight();
         SetMsgPanel( pcb );
@@ -266,7 +267,7 @@ void PCB_EDIT_FRAME::ExecuteRemoteCommand( const char* cmdline )
         view->SetCenter( bbox.Centre() );
     }
 
-    view->UpdateAllLayersColor();
+    GetCanvas()->GetView()->UpdateHighlightColors();
     // Ensure the display is refreshed, because in some installs the refresh is done only
     // when the gal canvas has the focus, and that is not the case when crossprobing from
     // Eeschema:
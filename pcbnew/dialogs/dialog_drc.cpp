@@ -94,6 +94,7 @@ DIALOG_DRC::~DIALOG_DRC()
     settings->m_DrcDialog.refill_zones       = m_cbRefillZones->GetValue();
     settings->m_DrcDialog.test_track_to_zone = m_cbReportAllTrackErrors->GetValue();
     settings->m_DrcDialog.test_footprints    = m_cbTestFootprints->GetValue();
+    settings->m_DrcDialog.incremental        = m_cbIncremental->GetValue();
     settings->m_DrcDialog.severities         = m_severities;
 
     m_markerTreeModel->DecRef();
@@ -146,6 +147,7 @@ void DIALOG_DRC::initValues()
     m_cbRefillZones->SetValue( cfg->m_DrcDialog.refill_zones );
     m_cbReportAllTrackErrors->SetValue( cfg->m_DrcDialog.test_track_to_zone );
     m_cbTestFootprints->SetValue( cfg->m_DrcDialog.test_footprints );
+    m_cbIncremental->SetValue( cfg->m_DrcDialog.incremental );
 
     m_severities = cfg->m_DrcDialog.severities;
     m_markerTreeModel->SetSeverities( m_severities );
@@ -405,6 +407,13 @@ void DIALOG_DRC::OnDRCItemRClick( wxDataViewEvent& aEvent )
 }
 
 
+void DIALOG_DRC::OnIncrementalCheck( wxCommandEvent& aEvent )
+{
+    // The incremental DRC reads the setting on each commit, so it applies from now on
+    m_brdEditor->GetPcbNewSettings()->m_DrcDialog.incremental = m_cbIncremental->GetValue();
+}
+
+
 void DIALOG_DRC::OnSeverity( wxCommandEvent& aEvent )
 {
     int flag = 0;
@@ -75,6 +75,7 @@ private:
     void OnDRCItemDClick( wxDataViewEvent& aEvent ) override;
     void OnDRCItemRClick( wxDataViewEvent& aEvent ) override;
 
+    void OnIncrementalCheck( wxCommandEvent& aEvent ) override;
     void OnSeverity( wxCommandEvent& aEvent ) override;
   	void OnSaveReport( wxCommandEvent& aEvent ) override;
 
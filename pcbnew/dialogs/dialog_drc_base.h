@@ -55,6 +55,7 @@ class DIALOG_DRC_BASE : public DIALOG_SHIM
 		wxCheckBox* m_cbReportAllTrackErrors;
 		wxCheckBox* m_cbReportTracksToZonesErrors;
 		wxCheckBox* m_cbTestFootprints;
+		wxCheckBox* m_cbIncremental;
 		wxTextCtrl* m_Messages;
 		wxNotebook* m_Notebook;
 		wxPanel* m_panelViolations;
@@ -85,6 +86,7 @@ class DIALOG_DRC_BASE : public DIALOG_SHIM
 		virtual void OnDRCItemDClick( wxDataViewEvent& event ) { event.Skip(); }
 		virtual void OnDRCItemRClick( wxDataViewEvent& event ) { event.Skip(); }
 		virtual void OnDRCItemSelected( wxDataViewEvent& event ) { event.Skip(); }
+		virtual void OnIncrementalCheck( wxCommandEvent& event ) { event.Skip(); }
 		virtual void OnSeverity( wxCommandEvent& event ) { event.Skip(); }
 		virtual void OnSaveReport( wxCommandEvent& event ) { event.Skip(); }
 		virtual void OnDeleteOneClick( wxCommandEvent& event ) { event.Skip(); }
@@ -56,6 +56,9 @@ enum FPGeneratorRowNames
 DIALOG_FOOTPRINT_WIZARD_LIST::DIALOG_FOOTPRINT_WIZARD_LIST( wxWindow* aParent )
     : DIALOG_FOOTPRINT_WIZARD_LIST_BASE( aParent )
 {
+    // The footprint editor may be opened before the board editor has loaded the wizards
+    PythonPluginsEnsureLoaded();
+
     initLists();
 
     auto cfg = Pgm().GetSettingsManager().GetAppSettings<PCBNEW_SETTINGS>();
@@ -92,6 +92,7 @@ bool DIALOG_GENDRILL::m_Merge_PTH_NPTH  = false;    // Only for Excellon format
 int DIALOG_GENDRILL::m_mapFileType      = 1;
 int DIALOG_GENDRILL::m_drillFileType    = 0;
 bool DIALOG_GENDRILL::m_UseRouteModeForOvalHoles = true;    // Use G00 route mode to "drill" oval holes
+bool DIALOG_GENDRILL::m_OptimizeHolesPath = true;
 
 DIALOG_GENDRILL::~DIALOG_GENDRILL()
 {
@@ -107,6 +108,7 @@ void DIALOG_GENDRILL::initDialog()
     m_Mirror                   = cfg->m_GenDrill.mirror;
     m_UnitDrillIsInch          = cfg->m_GenDrill.unit_drill_is_inch;
     m_UseRouteModeForOvalHoles = cfg->m_GenDrill.use_route_for_oval_holes;
+    m_OptimizeHolesPath        = cfg->m_GenDrill.optimize_holes_path;
     m_drillFileType            = cfg->m_GenDrill.drill_file_type;
     m_mapFileType              = cfg->m_GenDrill.map_file_type;
     m_ZerosFormat              = cfg->m_GenDrill.zeros_format;
@@ -243,6 +245,7 @@ void DIALOG_GENDRILL::UpdateConfig()
     cfg->m_GenDrill.mirror                   = m_Mirror;
     cfg->m_GenDrill.unit_drill_is_inch       = m_UnitDrillIsInch;
     cfg->m_GenDrill.use_route_for_oval_holes = m_UseRouteModeForOvalHoles;
+    cfg->m_GenDrill.optimize_holes_path      = m_OptimizeHolesPath;
     cfg->m_GenDrill.drill_file_type          = m_drillFileType;
     cfg->m_GenDrill.map_file_type            = m_mapFileType;
     cfg->m_GenDrill.zeros_format             = m_ZerosFormat;
@@ -396,6 +399,7 @@ void DIALOG_GENDRILL::GenDrillAndMapFiles( bool aGenDrill, bool aGenMap )
                                   m_Precision.m_lhs, m_Precision.m_rhs );
         excellonWriter.SetOptions( m_Mirror, m_MinimalHeader, m_FileDrillOffset, m_Merge_PTH_NPTH );
         excellonWriter.SetRouteModeForOvalHoles( m_UseRouteModeForOvalHoles );
+        excellonWriter.SetHolesPathOptimization( m_OptimizeHolesPath );
         excellonWriter.SetMapFileFormat( filefmt[choice] );
 
         excellonWriter.CreateDrillandMapFilesSet( outputDir.GetFullPath(), aGenDrill, aGenMap,
@@ -409,6 +413,7 @@ void DIALOG_GENDRILL::GenDrillAndMapFiles( bool aGenDrill, bool aGenMap )
         // the integer part precision is always 4, and units always mm
         gerberWriter.SetFormat( m_plotOpts.GetGerberPrecision() );
         gerberWriter.SetOptions( m_FileDrillOffset );
+        gerberWriter.SetHolesPathOptimization( m_OptimizeHolesPath );
         gerberWriter.SetMapFileFormat( filefmt[choice] );
 
         gerberWriter.CreateDrillandMapFilesSet( outputDir.GetFullPath(),
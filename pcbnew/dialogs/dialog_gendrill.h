@@ -53,6 +53,7 @@ public:
     wxPoint          m_FileDrillOffset;          // Drill offset: 0,0 for absolute coordinates,
                                                  // or origin of the auxiliary axis
     static bool      m_UseRouteModeForOvalHoles; // True to use a G00 route command for oval holes
+    static bool      m_OptimizeHolesPath;        // True to shorten the spindle travel of each tool
                                                  // False to use a G85 canned mode for oval holes
 
 private:
@@ -368,6 +368,9 @@ bool DIALOG_GLOBAL_EDIT_TRACKS_AND_VIAS::TransferDataFromWindow()
 
         for( auto segment : m_brd->Tracks() )
             m_parent->GetCanvas()->GetView()->Update( segment );
+
+        // The tracks are edited in place, not through a commit
+        m_parent->OnModify();
     }
 
     return !m_failedDRC;
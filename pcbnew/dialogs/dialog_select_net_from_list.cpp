@@ -35,8 +35,8 @@
 #include <view/view.h>
 #include <view/view_controls.h>
 #include <pcb_painter.h>
+#include <pcb_view.h>
 #include <connectivity/connectivity_data.h>
-#include <connectivity/connectivity_algo.h>
 
 struct DIALOG_SELECT_NET_FROM_LIST::COLUMN_ID
 {
@@ -128,6 +128,7 @@ DIALOG_SELECT_NET_FROM_LIST::DIALOG_SELECT_NET_FROM_LIST(
 {
     m_brd = aParent->GetBoard();
     m_wasSelected = false;
+    m_netStatsSerial = 0;
 
     m_netsList->AppendTextColumn(
             COLUMN_NET.display_name, wxDATAVIEW_CELL_INERT, 0, wxALIGN_LEFT, 0 );
@@ -244,48 +245,16 @@ bool DIALOG_SELECT_NET_FROM_LIST::netFilterMatches( NETINFO_ITEM* aNet ) const
 }
 
 
-struct NETCODE_CMP_LESS
+void DIALOG_SELECT_NET_FROM_LIST::setNetStats( LIST_ITEM& aItem ) const
 {
-    bool operator()( const CN_ITEM* a, const CN_ITEM* b ) const
-    {
-        return a->Net() < b->Net();
-    }
-
-    bool operator()( const CN_ITEM* a, int b ) const
-    {
-        return a->Net() < b;
-    }
-
-    bool operator()( int a, const CN_ITEM* b ) const
-    {
-        return a < b->Net();
-    }
-};
-
-
-std::vector<CN_ITEM*> DIALOG_SELECT_NET_FROM_LIST::relevantConnectivityItems() const
-{
-    // pre-filter the connectivity items and sort them by netcode.
-    // this avoids quadratic runtime when building the whole net list and
-    // calculating the total length for each net.
-
-    const auto type_bits = std::bitset<MAX_STRUCT_TYPE_ID>()
-        .set( PCB_TRACE_T )
-        .set( PCB_VIA_T )
-        .set( PCB_PAD_T );
-
-    std::vector<CN_ITEM*> cn_items;
-    cn_items.reserve( 1024 );
+    // The connectivity keeps the statistics up to date with the items
+    const CN_NET_STATS& stats = m_brd->GetConnectivity()->GetNetStats( aItem.m_net->GetNet() );
 
-    for( auto& cn_item : m_brd->GetConnectivity()->GetConnectivityAlgo()->ItemList() )
-    {
-        if( cn_item->Valid() && type_bits[cn_item->Parent()->Type()] )
-            cn_items.push_back( cn_item );
-    }
-
-    std::sort( cn_items.begin(), cn_items.end(), NETCODE_CMP_LESS() );
-
-    return cn_items;
+    aItem.m_pad_count         = stats.m_PadCount;
+    aItem.m_via_count         = stats.m_ViaCount;
+    aItem.m_board_wire_length = (int) stats.m_TrackLength;
+    aItem.m_chip_wire_length  = (int) stats.m_PadToDieLength;
+    aItem.m_total_length      = aItem.m_board_wire_length + aItem.m_chip_wire_length;
 }
 
 
@@ -314,12 +283,36 @@ void DIALOG_SELECT_NET_FROM_LIST::deleteRow( const ROW_DESC& aRow )
 
     m_netsList->DeleteItem( aRow.row_num );
     m_list_items.erase( aRow.by_row );
+    m_list_items_by_net.erase( aRow.by_net );
+
+    // the rows after the deleted one moved up
+    for( unsigned int& i : m_list_items_by_net )
+    {
+        if( i > (unsigned int) aRow.row_num )
+            --i;
+    }
+}
 
-    std::iter_swap( aRow.by_net, m_list_items_by_net.end() - 1 );
-    m_list_items_by_net.pop_back();
 
-    std::sort( m_list_items_by_net.begin(), m_list_items_by_net.end(),
-            LIST_ITEM_NET_CMP_LESS( m_list_items ) );
+void DIALOG_SELECT_NET_FROM_LIST::appendRow( const LIST_ITEM& aItem )
+{
+    m_list_items.push_back( aItem );
+
+    auto i = std::lower_bound( m_list_items_by_net.begin(), m_list_items_by_net.end(),
+            aItem.m_net, LIST_ITEM_NET_CMP_LESS( m_list_items ) );
+
+    m_list_items_by_net.insert( i, m_list_items.size() - 1 );
+
+    wxVector<wxVariant> new_row( 7 );
+    new_row[COLUMN_NET]          = formatNetCode( aItem.m_net );
+    new_row[COLUMN_NAME]         = formatNetName( aItem.m_net );
+    new_row[COLUMN_PAD_COUNT]    = formatCount( aItem.m_pad_count );
+    new_row[COLUMN_VIA_COUNT]    = formatCount( aItem.m_via_count );
+    new_row[COLUMN_BOARD_LENGTH] = formatLength( aItem.m_board_wire_length );
+    new_row[COLUMN_CHIP_LENGTH]  = formatLength( aItem.m_chip_wire_length );
+    new_row[COLUMN_TOTAL_LENGTH] = formatLength( aItem.m_total_length );
+
+    m_netsList->AppendItem( new_row );
 }
 
 
@@ -363,57 +356,17 @@ void DIALOG_SELECT_NET_FROM_LIST::OnBoardItemAdded( BOARD& aBoard, BOARD_ITEM* a
         // passes the netname filter test.
         if( netFilterMatches( net ) )
         {
-            m_list_items.emplace_back( net );
-            m_list_items_by_net.push_back( m_list_items.size() - 1 );
-
-            std::sort( m_list_items_by_net.begin(), m_list_items_by_net.end(),
-                    LIST_ITEM_NET_CMP_LESS( m_list_items ) );
-
-            auto& new_i       = m_list_items.back();
-            new_i.m_pad_count = m_brd->GetNodesCount( net->GetNet() );
-
-            wxVector<wxVariant> new_row( 7 );
-            new_row[COLUMN_NET]          = formatNetCode( net );
-            new_row[COLUMN_NAME]         = formatNetName( net );
-            new_row[COLUMN_PAD_COUNT]    = formatCount( new_i.m_pad_count );
-            new_row[COLUMN_VIA_COUNT]    = formatCount( new_i.m_via_count );
-            new_row[COLUMN_BOARD_LENGTH] = formatLength( new_i.m_board_wire_length );
-            new_row[COLUMN_CHIP_LENGTH]  = formatLength( new_i.m_chip_wire_length );
-            new_row[COLUMN_TOTAL_LENGTH] = formatLength( new_i.m_total_length );
-
-            m_netsList->AppendItem( new_row );
+            LIST_ITEM new_i( net );
+            setNetStats( new_i );
+            appendRow( new_i );
         }
 
         return;
     }
-    else if( auto* i = dynamic_cast<BOARD_CONNECTED_ITEM*>( aBoardItem ) )
+    else if( dynamic_cast<BOARD_CONNECTED_ITEM*>( aBoardItem ) != nullptr
+            || dynamic_cast<MODULE*>( aBoardItem ) != nullptr )
     {
-        auto r = findRow( i->GetNet() );
-
-        if( r )
-        {
-            // try to handle frequent operations quickly.
-            if( auto* track = dynamic_cast<TRACK*>( i ) )
-            {
-                int len = track->GetLength();
-                r.by_row->m_board_wire_length += len;
-                r.by_row->m_total_length += len;
-
-                setValue( r, COLUMN_BOARD_LENGTH, formatLength( r.by_row->m_board_wire_length ) );
-                setValue( r, COLUMN_TOTAL_LENGTH, formatLength( r.by_row->m_total_length ) );
-
-                if( track->Type() == PCB_VIA_T )
-                {
-                    r.by_row->m_via_count += 1;
-                    setValue( r, COLUMN_VIA_COUNT, formatCount( r.by_row->m_via_count ) );
-                }
-
-                return;
-            }
-        }
-
-        // resort to generic slower net update otherwise.
-        updateNet( i->GetNet() );
+        updateChangedNets();
     }
 }
 
@@ -425,51 +378,10 @@ void DIALOG_SELECT_NET_FROM_LIST::OnBoardItemRemoved( BOARD& aBoard, BOARD_ITEM*
         deleteRow( findRow( net ) );
         return;
     }
-    else if( auto* mod = dynamic_cast<MODULE*>( aBoardItem ) )
-    {
-        for( const D_PAD* pad : mod->Pads() )
-        {
-            auto r = findRow( pad->GetNet() );
-
-            if( r )
-            {
-                r.by_row->m_pad_count -= 1;
-
-                if( r.by_row->m_pad_count == 0 && !m_cbShowZeroPad->IsChecked() )
-                    deleteRow( r );
-                else
-                    setValue( r, COLUMN_PAD_COUNT, formatCount( r.by_row->m_pad_count ) );
-            }
-        }
-    }
-    else if( auto* i = dynamic_cast<BOARD_CONNECTED_ITEM*>( aBoardItem ) )
+    else if( dynamic_cast<BOARD_CONNECTED_ITEM*>( aBoardItem ) != nullptr
+            || dynamic_cast<MODULE*>( aBoardItem ) != nullptr )
     {
-        auto r = findRow( i->GetNet() );
-
-        if( r )
-        {
-            // try to handle frequent operations quickly.
-            if( auto* track = dynamic_cast<TRACK*>( i ) )
-            {
-                int len = track->GetLength();
-                r.by_row->m_board_wire_length -= len;
-                r.by_row->m_total_length -= len;
-
-                setValue( r, COLUMN_BOARD_LENGTH, formatLength( r.by_row->m_board_wire_length ) );
-                setValue( r, COLUMN_TOTAL_LENGTH, formatLength( r.by_row->m_total_length ) );
-
-                if( track->Type() == PCB_VIA_T )
-                {
-                    r.by_row->m_via_count -= 1;
-                    setValue( r, COLUMN_VIA_COUNT, formatCount( r.by_row->m_via_count ) );
-                }
-
-                return;
-            }
-
-            // resort to generic slower net update otherwise.
-            updateNet( i->GetNet() );
-        }
+        updateChangedNets();
     }
 }
 
@@ -479,8 +391,7 @@ void DIALOG_SELECT_NET_FROM_LIST::OnBoardItemChanged( BOARD& aBoard, BOARD_ITEM*
     if( dynamic_cast<BOARD_CONNECTED_ITEM*>( aBoardItem ) != nullptr
             || dynamic_cast<MODULE*>( aBoardItem ) != nullptr )
     {
-        buildNetsList();
-        m_netsList->Refresh();
+        updateChangedNets();
     }
 }
 
@@ -501,6 +412,28 @@ void DIALOG_SELECT_NET_FROM_LIST::OnBoardNetSettingsChanged( BOARD& aBoard )
 }
 
 
+void DIALOG_SELECT_NET_FROM_LIST::updateChangedNets()
+{
+    auto             connectivity = m_brd->GetConnectivity();
+    std::vector<int> changed_nets;
+
+    if( !connectivity->GetChangedNetStats( m_netStatsSerial, changed_nets ) )
+    {
+        buildNetsList();
+        m_netsList->Refresh();
+        return;
+    }
+
+    m_netStatsSerial = connectivity->GetNetStatsSerial();
+
+    for( int netcode : changed_nets )
+    {
+        if( NETINFO_ITEM* net = m_brd->FindNet( netcode ) )
+            updateNet( net );
+    }
+}
+
+
 void DIALOG_SELECT_NET_FROM_LIST::updateNet( NETINFO_ITEM* aNet )
 {
     // something for the specified net has changed, update that row.
@@ -512,57 +445,18 @@ void DIALOG_SELECT_NET_FROM_LIST::updateNet( NETINFO_ITEM* aNet )
 
     auto cur_net_row = findRow( aNet );
 
-    const unsigned int node_count = m_brd->GetNodesCount( aNet->GetNet() );
+    LIST_ITEM list_item( aNet );
+    setNetStats( list_item );
 
-    if( node_count == 0 && !m_cbShowZeroPad->IsChecked() )
+    if( list_item.m_pad_count == 0 && !m_cbShowZeroPad->IsChecked() )
     {
         deleteRow( cur_net_row );
         return;
     }
 
-    auto all_cn_items = relevantConnectivityItems();
-
-    LIST_ITEM list_item( aNet );
-    list_item.m_pad_count = node_count;
-
-    const auto cn_items = std::equal_range(
-            all_cn_items.begin(), all_cn_items.end(), aNet->GetNet(), NETCODE_CMP_LESS() );
-
-    for( auto i = cn_items.first; i != cn_items.second; ++i )
-    {
-        auto item = ( *i )->Parent();
-
-        if( item->Type() == PCB_PAD_T )
-            list_item.m_chip_wire_length += static_cast<D_PAD*>( item )->GetPadToDieLength();
-
-        else if( auto* track = dynamic_cast<TRACK*>( item ) )
-        {
-            list_item.m_board_wire_length += track->GetLength();
-
-            if( item->Type() == PCB_VIA_T )
-                list_item.m_via_count += 1;
-        }
-    }
-
-    list_item.m_total_length = list_item.m_board_wire_length + list_item.m_chip_wire_length;
-
     if( !cur_net_row )
     {
-        m_list_items.push_back( list_item );
-        m_list_items_by_net.push_back( m_list_items.size() - 1 );
-        std::sort( m_list_items_by_net.begin(), m_list_items_by_net.end(),
-                LIST_ITEM_NET_CMP_LESS( m_list_items ) );
-
-        wxVector<wxVariant> new_row( 7 );
-        new_row[COLUMN_NET]          = formatNetCode( aNet );
-        new_row[COLUMN_NAME]         = formatNetName( aNet );
-        new_row[COLUMN_PAD_COUNT]    = formatCount( list_item.m_pad_count );
-        new_row[COLUMN_VIA_COUNT]    = formatCount( list_item.m_via_count );
-        new_row[COLUMN_BOARD_LENGTH] = formatLength( list_item.m_board_wire_length );
-        new_row[COLUMN_CHIP_LENGTH]  = formatLength( list_item.m_chip_wire_length );
-        new_row[COLUMN_TOTAL_LENGTH] = formatLength( list_item.m_total_length );
-
-        m_netsList->AppendItem( new_row );
+        appendRow( list_item );
     }
     else
     {
@@ -587,87 +481,22 @@ void DIALOG_SELECT_NET_FROM_LIST::buildNetsList()
     m_netsList->DeleteAllItems();
     m_list_items.clear();
 
-    std::vector<CN_ITEM*> prefiltered_cn_items = relevantConnectivityItems();
-
+    m_netStatsSerial = m_brd->GetConnectivity()->GetNetStatsSerial();
 
     // collect all nets which pass the filter string.
 
-    struct NET_INFO
-    {
-        int           netcode;
-        NETINFO_ITEM* net;
-        unsigned int  pad_count;
-    };
-
-    struct NET_INFO_CMP_LESS
-    {
-        bool operator()( const NET_INFO& a, const NET_INFO& b ) const
-        {
-            return a.netcode < b.netcode;
-        }
-        bool operator()( const NET_INFO& a, int b ) const
-        {
-            return a.netcode < b;
-        }
-        bool operator()( int a, const NET_INFO& b ) const
-        {
-            return a < b.netcode;
-        }
-    };
-
-    std::vector<NET_INFO> nets;
-    nets.reserve( m_brd->GetNetInfo().NetsByNetcode().size() );
-
     for( auto&& ni : m_brd->GetNetInfo().NetsByNetcode() )
     {
-        if( netFilterMatches( ni.second ) )
-            nets.emplace_back( NET_INFO{ ni.first, ni.second, 0 } );
-    }
-
-    // count the pads for each net.  since the nets are sorted by netcode
-    // this way around is faster than using counting pads for each net.
-
-    for( auto&& mod : m_brd->Modules() )
-    {
-        for( auto&& pad : mod->Pads() )
-        {
-            auto i = std::lower_bound(
-                    nets.begin(), nets.end(), pad->GetNetCode(), NET_INFO_CMP_LESS() );
-
-            if( i != nets.end() && i->netcode == pad->GetNetCode() )
-                i->pad_count += 1;
-        }
-    }
-
-    for( auto&& ni : nets )
-    {
-        if( !m_cbShowZeroPad->IsChecked() && ni.pad_count == 0 )
+        if( !netFilterMatches( ni.second ) )
             continue;
 
-        m_list_items.emplace_back( ni.net );
-        auto& list_item = m_list_items.back();
-
-        const auto cn_items = std::equal_range( prefiltered_cn_items.begin(),
-                prefiltered_cn_items.end(), ni.netcode, NETCODE_CMP_LESS() );
+        LIST_ITEM list_item( ni.second );
+        setNetStats( list_item );
 
-        for( auto i = cn_items.first; i != cn_items.second; ++i )
-        {
-            auto item = ( *i )->Parent();
-
-            if( item->Type() == PCB_PAD_T )
-                list_item.m_chip_wire_length += static_cast<D_PAD*>( item )->GetPadToDieLength();
-
-            else if( auto* track = dynamic_cast<TRACK*>( item ) )
-            {
-                list_item.m_board_wire_length += track->GetLength();
-
-                if( track->Type() == PCB_VIA_T )
-                    list_item.m_via_count += 1;
-            }
-        }
+        if( !m_cbShowZeroPad->IsChecked() && list_item.m_pad_count == 0 )
+            continue;
 
-        list_item.m_pad_count    = ni.pad_count;
-        list_item.m_total_length = list_item.m_board_wire_length + list_item.m_chip_wire_length;
+        m_list_items.push_back( list_item );
     }
 
     wxVector<wxVariant> dataLine;
@@ -736,7 +565,7 @@ void DIALOG_SELECT_NET_FROM_LIST::highlightNetOnBoard( NETINFO_ITEM* aNet ) cons
     KIGFX::RENDER_SETTINGS *render = m_frame->GetCanvas()->GetView()->GetPainter()->GetSettings();
     render->SetHighlight( netCode >= 0, netCode );
 
-    m_frame->GetCanvas()->GetView()->UpdateAllLayersColor();
+    m_frame->GetCanvas()->GetView()->UpdateHighlightColors();
     m_frame->GetCanvas()->Refresh();
 }
 
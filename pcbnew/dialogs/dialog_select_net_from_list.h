@@ -31,7 +31,6 @@
 class PCB_EDIT_FRAME;
 class NETINFO_ITEM;
 class BOARD;
-class CN_ITEM;
 
 class DIALOG_SELECT_NET_FROM_LIST : public DIALOG_SELECT_NET_FROM_LIST_BASE, public BOARD_LISTENER
 {
@@ -75,10 +74,16 @@ private:
 
     struct ROW_DESC;
 
+    // in addition to the displayed list data, we also keep some auxiliary
+    // data for each list item in order to speed up update of the displayed list.
+    struct LIST_ITEM;
+    struct LIST_ITEM_NET_CMP_LESS;
+
     ROW_DESC findRow( NETINFO_ITEM* aNet );
     ROW_DESC findRow( int aNetCode );
 
     void deleteRow( const ROW_DESC& aRow );
+    void appendRow( const LIST_ITEM& aItem );
     void setValue( const ROW_DESC& aRow, const COLUMN_ID& aCol, wxString aVal );
 
     wxString formatNetCode( const NETINFO_ITEM* aNet ) const;
@@ -86,10 +91,16 @@ private:
     wxString formatCount( unsigned int aValue ) const;
     wxString formatLength( int aValue ) const;
 
-    std::vector<CN_ITEM*> relevantConnectivityItems() const;
-    bool                  netFilterMatches( NETINFO_ITEM* aNet ) const;
-    void                  updateNet( NETINFO_ITEM* aNet );
-    void                  highlightNetOnBoard( NETINFO_ITEM* aNet ) const;
+    bool netFilterMatches( NETINFO_ITEM* aNet ) const;
+    void setNetStats( LIST_ITEM& aItem ) const;
+    void updateNet( NETINFO_ITEM* aNet );
+    void highlightNetOnBoard( NETINFO_ITEM* aNet ) const;
+
+    /**
+     * Updates the rows of the nets whose statistics changed since the last update, as
+     * told by the connectivity.
+     */
+    void updateChangedNets();
 
     void onSelChanged( wxDataViewEvent& event ) override;
     void onFilterChange( wxCommandEvent& event ) override;
@@ -103,11 +114,6 @@ private:
     void onUnitsChanged( wxCommandEvent& event );
     void onBoardChanged( wxCommandEvent& event );
 
-    // in addition to the displayed list data, we also keep some auxiliary
-    // data for each list item in order to speed up update of the displayed list.
-    struct LIST_ITEM;
-    struct LIST_ITEM_NET_CMP_LESS;
-
     // primary vector, sorted by rows
     std::vector<LIST_ITEM> m_list_items;
 
@@ -116,6 +122,9 @@ private:
     // keep indices instead and look the them up in m_list_items.
     std::vector<unsigned int> m_list_items_by_net;
 
+    // the serial of the net statistics of the last update
+    uint64_t m_netStatsSerial;
+
 
     EDA_PATTERN_MATCH_WILDCARD m_netFilter;
 
@@ -971,7 +971,7 @@ wxString PANEL_FP_LIB_TABLE::m_lastBrowseDir;
 
 void InvokePcbLibTableEditor( KIWAY* aKiway, wxWindow* aCaller )
 {
-    FP_LIB_TABLE* globalTable = &GFootprintTable;
+    FP_LIB_TABLE* globalTable = &FP_LIB_TABLE::GetGlobalLibTable();
     wxString      globalTablePath = FP_LIB_TABLE::GetGlobalTableFileName();
     FP_LIB_TABLE* projectTable = aKiway->Prj().PcbFootprintLibs();
     wxString      projectTablePath = aKiway->Prj().FootprintLibTblName();
@@ -61,6 +61,7 @@ bool PANEL_PCBNEW_SETTINGS::TransferDataToWindow()
     m_magneticTrackChoice->SetSelection( static_cast<int>( general_opts.m_MagneticItems.tracks ) );
     m_magneticGraphicsChoice->SetSelection( !general_opts.m_MagneticItems.graphics );
     m_FlipLeftRight->SetValue( general_opts.m_FlipLeftRight );
+    m_autoRefillZones->SetValue( general_opts.m_AutoRefillZones );
 
     m_Show_Page_Limits->SetValue( m_Frame->ShowPageLimits() );
 
@@ -85,6 +86,7 @@ bool PANEL_PCBNEW_SETTINGS::TransferDataFromWindow()
     m_Frame->Settings().m_MagneticItems.graphics = !m_magneticGraphicsChoice->GetSelection();
 
     m_Frame->Settings().m_FlipLeftRight = m_FlipLeftRight->GetValue();
+    m_Frame->Settings().m_AutoRefillZones = m_autoRefillZones->GetValue();
 
     m_Frame->SetShowPageLimits( m_Show_Page_Limits->GetValue() );
 
@@ -47,6 +47,11 @@ PANEL_PCBNEW_SETTINGS_BASE::PANEL_PCBNEW_SETTINGS_BASE( wxWindow* parent, wxWind
 	m_FlipLeftRight = new wxCheckBox( bOptionsSizer->GetStaticBox(), wxID_ANY, _("Flip board items L/R (default is T/B)"), wxDefaultPosition, wxDefaultSize, 0 );
 	bOptionsSizer->Add( m_FlipLeftRight, 0, wxBOTTOM|wxRIGHT|wxLEFT, 5 );
 
+	m_autoRefillZones = new wxCheckBox( bOptionsSizer->GetStaticBox(), wxID_ANY, _("Refill zones in the background after edits"), wxDefaultPosition, wxDefaultSize, 0 );
+	m_autoRefillZones->SetToolTip( _("Keep the filled zones up to date while editing.  The zones are refilled without blocking the editor.") );
+
+	bOptionsSizer->Add( m_autoRefillZones, 0, wxBOTTOM|wxRIGHT|wxLEFT, 5 );
+
 	wxFlexGridSizer* fgSizer12;
 	fgSizer12 = new wxFlexGridSizer( 0, 2, 0, 0 );
 	fgSizer12->AddGrowableCol( 1 );
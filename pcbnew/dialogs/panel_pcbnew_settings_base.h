@@ -45,6 +45,7 @@ class PANEL_PCBNEW_SETTINGS_BASE : public wxPanel
 		wxRadioBox* m_UnitsSelection;
 		wxCheckBox* m_Segments_45_Only_Ctrl;
 		wxCheckBox* m_FlipLeftRight;
+		wxCheckBox* m_autoRefillZones;
 		wxStaticText* m_staticTextRotationAngle;
 		wxTextCtrl* m_RotationAngle;
 		wxStaticText* m_staticText2;
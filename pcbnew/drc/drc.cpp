@@ -47,7 +47,8 @@
 #include <netlist_reader/pcb_netlist.h>
 #include <math/util.h>      // for KiROUND
 #include <dialog_drc.h>
-#include <wx/progdlg.h>
+#include <view/view.h>
+#include <pcbnew_settings.h>
 #include <board_commit.h>
 #include <geometry/shape_arc.h>
 #include <drc/drc.h>
@@ -57,9 +58,16 @@
 #include <drc/drc_drilled_hole_tester.h>
 #include <drc/drc_keepout_tester.h>
 #include <drc/drc_netclass_tester.h>
+#include <drc/drc_report_sink.h>
 #include <drc/drc_textvar_tester.h>
 #include <drc/footprint_tester.h>
 #include <dialogs/panel_setup_rules.h>
+#include <trace_events.h>
+#include <thread_pool.h>
+#include <widgets/progress_reporter.h>
+
+#include <atomic>
+#include <set>
 
 DRC::DRC() :
         PCB_TOOL_BASE( "pcbnew.DRCTool" ),
@@ -67,7 +75,15 @@ DRC::DRC() :
         m_pcb( nullptr ),
         m_board_outline_valid( false ),
         m_drcDialog( nullptr ),
-        m_largestClearance( 0 )
+        m_largestClearance( 0 ),
+        m_indexInflate( 0 ),
+        m_listenedBoard( nullptr ),
+        m_indicesValid( false ),
+        m_outlineStale( true ),
+        m_reportSink( nullptr ),
+        m_reportCount( 0 ),
+        m_threadCount( 0 ),
+        m_progressReporter( nullptr )
 {
     // establish initial values for everything:
     m_doUnconnectedTest = true;         // enable unconnected tests
@@ -84,6 +100,8 @@ DRC::DRC() :
 
 DRC::~DRC()
 {
+    setListenedBoard( nullptr );
+
     for( DRC_ITEM* unconnectedItem : m_unconnected )
         delete unconnectedItem;
 
@@ -103,6 +121,137 @@ void DRC::Reset( RESET_REASON aReason )
 
         m_pcb = m_editFrame->GetBoard();
     }
+
+    setListenedBoard( m_editFrame->GetBoard() );
+}
+
+
+void DRC::setListenedBoard( BOARD* aBoard )
+{
+    if( m_listenedBoard == aBoard )
+        return;
+
+    if( m_listenedBoard )
+        m_listenedBoard->RemoveListener( this );
+
+    m_listenedBoard = aBoard;
+
+    if( m_listenedBoard )
+        m_listenedBoard->AddListener( this );
+
+    m_indicesValid = false;
+    m_outlineStale = true;
+}
+
+
+void DRC::OnBoardItemAdded( BOARD& aBoard, BOARD_ITEM* aBoardItem )
+{
+    boardItemChanged( aBoardItem, true );
+}
+
+
+void DRC::OnBoardItemRemoved( BOARD& aBoard, BOARD_ITEM* aBoardItem )
+{
+    boardItemChanged( aBoardItem, false );
+}
+
+
+void DRC::OnBoardItemChanged( BOARD& aBoard, BOARD_ITEM* aBoardItem )
+{
+    boardItemChanged( aBoardItem, true );
+}
+
+
+void DRC::OnBoardDestroyed( BOARD& aBoard )
+{
+    if( &aBoard != m_listenedBoard )
+        return;
+
+    // The board forgets its listeners itself
+    m_listenedBoard = nullptr;
+    m_indicesValid = false;
+
+    if( m_pcb == &aBoard )
+    {
+        m_padIndex.Clear();
+        m_trackIndex.Clear();
+        m_itemHashes.clear();
+        m_indexedPads.clear();
+        m_sortedPads.clear();
+    }
+}
+
+
+void DRC::boardItemChanged( BOARD_ITEM* aItem, bool aOnBoard )
+{
+    switch( aItem->Type() )
+    {
+    case PCB_LINE_T:
+        // The layer may have changed too, so any graphic can be part of the outline
+        m_outlineStale = true;
+        break;
+
+    case PCB_MODULE_T:
+        for( BOARD_ITEM* item : static_cast<MODULE*>( aItem )->GraphicalItems() )
+        {
+            if( item->GetLayer() == Edge_Cuts )
+                m_outlineStale = true;
+        }
+
+        break;
+
+    default:
+        break;
+    }
+
+    if( !m_indicesValid )
+        return;
+
+    switch( aItem->Type() )
+    {
+    case PCB_TRACE_T:
+    case PCB_ARC_T:
+    case PCB_VIA_T:
+    {
+        TRACK* track = static_cast<TRACK*>( aItem );
+
+        m_trackIndex.Remove( track );
+        m_itemHashes.erase( track );
+
+        if( aOnBoard )
+            m_staleTracks.insert( track );
+        else
+            m_staleTracks.erase( track );
+
+        break;
+    }
+
+    case PCB_PAD_T:
+        // The pads of the board are edited through their footprint
+        if( aItem->GetParent() && aItem->GetParent()->Type() == PCB_MODULE_T )
+            boardItemChanged( aItem->GetParent(), true );
+
+        break;
+
+    case PCB_MODULE_T:
+    {
+        // Undo swaps the pads of a footprint, so the indexed ones are not necessarily its
+        // current ones
+        MODULE* module = static_cast<MODULE*>( aItem );
+
+        unindexPads( module );
+
+        if( aOnBoard )
+            m_staleModules.insert( module );
+        else
+            m_staleModules.erase( module );
+
+        break;
+    }
+
+    default:
+        break;
+    }
 }
 
 
@@ -165,7 +314,69 @@ void DRC::addMarkerToPcb( BOARD_COMMIT& aCommit, MARKER_PCB* aMarker )
         return;
     }
 
-    aCommit.Add( aMarker );
+    if( m_reportSink )
+        reportMarker( aMarker );
+    else
+        aCommit.Add( aMarker );
+}
+
+
+void DRC::addMarker( std::vector<MARKER_PCB*>& aMarkers, MARKER_PCB* aMarker )
+{
+    if( m_pcb->GetDesignSettings().Ignore( aMarker->GetRCItem()->GetErrorCode() ) )
+    {
+        delete aMarker;
+        return;
+    }
+
+    if( m_reportSink )
+        reportMarker( aMarker );
+    else
+        aMarkers.push_back( aMarker );
+}
+
+
+void DRC::reportMarker( MARKER_PCB* aMarker )
+{
+    const DRC_ITEM* item = static_cast<const DRC_ITEM*>( aMarker->GetRCItem() );
+    SEVERITY        severity = (SEVERITY) m_pcb->GetDesignSettings().GetSeverity(
+                                                                        item->GetErrorCode() );
+
+    {
+        std::lock_guard<std::mutex> lock( m_reportMutex );
+
+        m_reportSink->Report( *item, aMarker->GetPos(), severity );
+        m_reportCount++;
+    }
+
+    delete aMarker;
+}
+
+
+void DRC::parallelFor( size_t aCount, const std::function<void( size_t )>& aFunc ) const
+{
+    auto func =
+            [&]( size_t ii )
+            {
+                if( !isCancelled() )
+                    aFunc( ii );
+            };
+
+    if( m_threadCount == 1 )
+    {
+        for( size_t ii = 0; ii < aCount; ++ii )
+            func( ii );
+    }
+    else
+    {
+        THREAD_POOL::GetInstance().ParallelFor( aCount, func );
+    }
+}
+
+
+bool DRC::isCancelled() const
+{
+    return m_progressReporter && m_progressReporter->IsCancelled();
 }
 
 
@@ -181,34 +392,50 @@ void DRC::DestroyDRCDialog( int aReason )
 
 bool DRC::LoadRules()
 {
-    wxString   rulesFilepath = m_editFrame->Prj().AbsolutePath( "drc-rules" );
-    wxFileName rulesFile( rulesFilepath );
+    wxString rulesFilepath = m_editFrame->Prj().AbsolutePath( "drc-rules" );
 
-    if( rulesFile.FileExists() )
+    try
+    {
+        loadRules( rulesFilepath );
+    }
+    catch( PARSE_ERROR& pe )
+    {
+        wxSafeYield( m_editFrame );
+        m_editFrame->ShowBoardSetupDialog( _( "Rules" ), pe.What(), ID_RULES_EDITOR,
+                                           pe.lineNumber, pe.byteIndex );
+
+        return false;
+    }
+
+    return true;
+}
+
+
+void DRC::loadRules( const wxString& aRulesFilepath )
+{
+    wxFileName rulesFile( aRulesFilepath );
+
+    if( !aRulesFilepath.IsEmpty() && rulesFile.FileExists() )
     {
         m_ruleSelectors.clear();
         m_rules.clear();
 
-        FILE* fp = wxFopen( rulesFilepath, wxT( "rt" ) );
+        FILE* fp = wxFopen( aRulesFilepath, wxT( "rt" ) );
 
         if( fp )
         {
             try
             {
-                DRC_RULES_PARSER parser( m_pcb, fp, rulesFilepath );
+                DRC_RULES_PARSER parser( m_pcb, fp, aRulesFilepath );
                 parser.Parse( m_ruleSelectors, m_rules );
             }
-            catch( PARSE_ERROR& pe )
+            catch( PARSE_ERROR& )
             {
                 // Don't leave possibly malformed stuff around for us to trip over
                 m_ruleSelectors.clear();
                 m_rules.clear();
 
-                wxSafeYield( m_editFrame );
-                m_editFrame->ShowBoardSetupDialog( _( "Rules" ), pe.What(), ID_RULES_EDITOR,
-                                                   pe.lineNumber, pe.byteIndex );
-
-                return false;
+                throw;
             }
         }
     }
@@ -218,47 +445,150 @@ bool DRC::LoadRules()
     BOARD_DESIGN_SETTINGS& bds = m_pcb->GetDesignSettings();
     bds.m_DRCRuleSelectors = m_ruleSelectors;
     bds.m_DRCRules = m_rules;
-
-    return true;
+    bds.m_DRCRuleTable = std::make_shared<DRC_RULE_TABLE>( m_ruleSelectors );
 }
 
 
 void DRC::RunTests( wxTextCtrl* aMessages )
 {
+    TRACE_SCOPE trace( "drc" );
+
     // Make absolutely sure these are up-to-date
     if( !LoadRules() )
         return;
 
     wxASSERT( m_pcb == m_editFrame->GetBoard() );
 
-    BOARD_COMMIT           commit( m_editFrame );
-    BOARD_DESIGN_SETTINGS& bds = m_pcb->GetDesignSettings();
+    BOARD_COMMIT commit( m_editFrame );
 
-    m_largestClearance = bds.GetBiggestClearanceValue();
+    // caller (a wxTopLevelFrame) is the wxDialog or the Pcb Editor frame that call DRC:
+    wxWindow* caller = aMessages ? aMessages->GetParent() : m_editFrame;
 
-    if( !bds.Ignore( DRCE_INVALID_OUTLINE )
-        || !bds.Ignore( DRCE_TRACK_NEAR_EDGE )
-        || !bds.Ignore( DRCE_VIA_NEAR_EDGE )
-        || !bds.Ignore( DRCE_PAD_NEAR_EDGE ) )
+    if( !runBoardTests( &commit, aMessages, caller, m_editFrame->GetCanvas()->GetWorksheet() ) )
+    {
+        commit.Push( wxEmptyString, false, false );
+
+        // update the m_drcDialog listboxes
+        updatePointers();
+
+        return;
+    }
+
+    for( DRC_ITEM* footprintItem : m_footprints )
+        delete footprintItem;
+
+    m_footprints.clear();
+    m_footprintsTested = false;
+
+    if( m_testFootprints && !Kiface().IsSingle() )
     {
         if( aMessages )
         {
-            aMessages->AppendText( _( "Board Outline...\n" ) );
-            wxSafeYield();
+            aMessages->AppendText( _( "Checking footprints against schematic...\n" ) );
+            aMessages->Refresh();
         }
 
-        testOutline( commit );
+        NETLIST netlist;
+        m_editFrame->FetchNetlistFromSchematic( netlist, PCB_EDIT_FRAME::ANNOTATION_DIALOG );
+
+        if( m_drcDialog )
+            m_drcDialog->Raise();
+
+        TestFootprints( netlist, m_pcb, m_footprints );
+        m_footprintsTested = true;
     }
 
+    commit.Push( wxEmptyString, false, false );
+    m_drcRun = true;
+
+    // update the m_drcDialog listboxes
+    updatePointers();
+
     if( aMessages )
     {
-        aMessages->AppendText( _( "Netclasses...\n" ) );
-        wxSafeYield();
+        // no newline on this one because it is last, don't want the window
+        // to unnecessarily scroll.
+        aMessages->AppendText( _( "Finished" ) );
+    }
+}
+
+
+size_t DRC::RunHeadless( BOARD* aBoard, DRC_REPORT_SINK& aSink, int aThreadCount,
+                         const wxString& aRulesFilepath )
+{
+    m_pcb = aBoard;
+    m_board_outline_valid = false;
+
+    loadRules( aRulesFilepath );
+
+    m_reportSink = &aSink;
+    m_reportCount = 0;
+    m_threadCount = aThreadCount;
+
+    aSink.Begin();
+    runBoardTests( nullptr, nullptr, nullptr, nullptr );
+    aSink.End();
+
+    m_reportSink = nullptr;
+    m_threadCount = 0;
+
+    return m_reportCount;
+}
+
+
+bool DRC::runBoardTests( BOARD_COMMIT* aCommit, wxTextCtrl* aMessages, wxWindow* aCaller,
+                         KIGFX::WS_PROXY_VIEW_ITEM* aWorksheet )
+{
+    BOARD_DESIGN_SETTINGS& bds = m_pcb->GetDesignSettings();
+
+    m_largestClearance = bds.GetBiggestClearanceValue();
+
+    auto appendMessage =
+            [&]( const wxString& aMessage )
+            {
+                if( aMessages )
+                {
+                    aMessages->AppendText( aMessage );
+                    wxSafeYield();
+                }
+            };
+
+    // Headless runs report the markers as they are found, so their lists stay empty
+    auto mergeMarkers =
+            [&]( std::vector<MARKER_PCB*>& aMarkers )
+            {
+                for( MARKER_PCB* marker : aMarkers )
+                    aCommit->Add( marker );
+
+                aMarkers.clear();
+            };
+
+    //-----<serial prerequisites>------------------------------------------
+    //
+    // These tests either modify the board (zone fills, connectivity) or produce data which
+    // the other tests depend on (board outline), so they run first and one at a time.
+
+    std::vector<MARKER_PCB*> outlineMarkers;
+
+    if( !bds.Ignore( DRCE_INVALID_OUTLINE )
+        || !bds.Ignore( DRCE_TRACK_NEAR_EDGE )
+        || !bds.Ignore( DRCE_VIA_NEAR_EDGE )
+        || !bds.Ignore( DRCE_PAD_NEAR_EDGE ) )
+    {
+        appendMessage( _( "Board Outline...\n" ) );
+        testOutline( outlineMarkers );
     }
 
+    mergeMarkers( outlineMarkers );
+
+    appendMessage( _( "Netclasses...\n" ) );
+
     DRC_NETCLASS_TESTER netclassTester( [&]( MARKER_PCB* aMarker )
                                         {
-                                            addMarkerToPcb( commit, aMarker );
+                                            if( m_reportSink )
+                                                reportMarker( aMarker );
+                                            else
+                                                addMarkerToPcb( *aCommit, aMarker );
                                         } );
 
     if( !netclassTester.RunDRC( userUnits(), *m_pcb ) )
@@ -270,382 +600,804 @@ void DRC::RunTests( wxTextCtrl* aMessages )
         if( aMessages )
             aMessages->AppendText( _( "NETCLASS VIOLATIONS: Aborting DRC\n" ) );
 
-        commit.Push( wxEmptyString, false, false );
+        return false;
+    }
 
-        // update the m_drcDialog listboxes
-        updatePointers();
+    // The zone filler is a tool of the PCB editor, so headless runs test the zones as they
+    // are filled on the board.
+    if( !m_reportSink )
+    {
+        if( m_refillZones )
+        {
+            if( aMessages )
+                aMessages->AppendText( _( "Refilling all zones...\n" ) );
 
-        return;
+            m_toolMgr->GetTool<ZONE_FILLER_TOOL>()->FillAllZones( aCaller );
+        }
+        else
+        {
+            if( aMessages )
+                aMessages->AppendText( _( "Checking zone fills...\n" ) );
+
+            m_toolMgr->GetTool<ZONE_FILLER_TOOL>()->CheckAllZones( aCaller );
+        }
     }
 
+    if( !bds.Ignore( DRCE_DANGLING_TRACK ) || !bds.Ignore( DRCE_DANGLING_VIA ) )
+    {
+        std::shared_ptr<CONNECTIVITY_DATA> connectivity = m_pcb->GetConnectivity();
+
+        connectivity->Clear();
+        connectivity->Build( m_pcb ); // just in case. This really needs to be reliable.
+    }
+
+    // Prime the lazily-computed pad and courtyard caches so that the concurrent tests only
+    // read them
+    for( MODULE* module : m_pcb->Modules() )
+    {
+        for( D_PAD* pad : module->Pads() )
+            pad->GetBoundingRadius();
+
+        module->BuildPolyCourtyard();
+    }
+
+    buildSpatialIndices();
+
+    m_padPairCache.BeginRun();
+    m_trackPadCache.BeginRun();
+
+    //-----<concurrent tests>----------------------------------------------
+    //
+    // The remaining tests only read the board.  Each one collects its markers into its own
+    // list; the lists are merged into the commit afterwards in the order given here, so the
+    // result does not depend on the order in which the tests finish.
+
+    std::vector<DRC_TEST_TASK>  tasks;
+    KIGFX::WS_PROXY_VIEW_ITEM*  worksheet = aWorksheet;
+
+    auto addTask =
+            [&]( const wxString& aMessage, std::function<void( std::vector<MARKER_PCB*>& )> aTest )
+            {
+                tasks.push_back( DRC_TEST_TASK{ aMessage, std::move( aTest ), {} } );
+            };
+
     // test pad to pad clearances, nothing to do with tracks, vias or zones.
     if( !bds.Ignore( DRCE_PAD_NEAR_EDGE )
         || !bds.Ignore( DRCE_PAD_NEAR_PAD )
         || !bds.Ignore( DRCE_HOLE_NEAR_PAD ) )
     {
-        if( aMessages )
+        addTask( _( "Pad clearances...\n" ),
+                 [this]( std::vector<MARKER_PCB*>& aMarkers )
+                 {
+                     testPadClearances( aMarkers );
+                 } );
+    }
+
+    // test drilled holes
+    if( !bds.Ignore( DRCE_DRILLED_HOLES_TOO_CLOSE )
+        || !bds.Ignore( DRCE_TOO_SMALL_PAD_DRILL )
+        || !bds.Ignore( DRCE_TOO_SMALL_VIA_DRILL )
+        || !bds.Ignore( DRCE_TOO_SMALL_MICROVIA_DRILL ) )
+    {
+        addTask( _( "Drill sizes and clearances...\n" ),
+                 [this]( std::vector<MARKER_PCB*>& aMarkers )
+                 {
+                     DRC_DRILLED_HOLE_TESTER tester( [&]( MARKER_PCB* aMarker )
+                                                     {
+                                                         addMarker( aMarkers, aMarker );
+                                                     } );
+
+                     tester.RunDRC( userUnits(), *m_pcb );
+                 } );
+    }
+
+    // test zone clearances to other zones
+    addTask( _( "Zone to zone clearances...\n" ),
+             [this]( std::vector<MARKER_PCB*>& aMarkers )
+             {
+                 testZones( aMarkers );
+             } );
+
+    // find and gather vias, tracks, pads inside keepout areas.
+    if( m_doKeepoutTest )
+    {
+        addTask( _( "Keepout areas ...\n" ),
+                 [this]( std::vector<MARKER_PCB*>& aMarkers )
+                 {
+                     DRC_KEEPOUT_TESTER tester( [&]( MARKER_PCB* aMarker )
+                                                {
+                                                    addMarker( aMarkers, aMarker );
+                                                } );
+
+                     tester.RunDRC( userUnits(), *m_pcb );
+                 } );
+    }
+
+    // find and gather vias, tracks, pads inside text boxes.
+    if( !bds.Ignore( DRCE_VIA_NEAR_COPPER )
+        || !bds.Ignore( DRCE_TRACK_NEAR_COPPER ) )
+    {
+        addTask( _( "Text and graphic clearances...\n" ),
+                 [this]( std::vector<MARKER_PCB*>& aMarkers )
+                 {
+                     testCopperTextAndGraphics( aMarkers );
+                 } );
+    }
+
+    // test courtyards
+    if( !bds.Ignore( DRCE_OVERLAPPING_FOOTPRINTS )
+        || !bds.Ignore( DRCE_MISSING_COURTYARD )
+        || !bds.Ignore( DRCE_MALFORMED_COURTYARD )
+        || !bds.Ignore( DRCE_PTH_IN_COURTYARD )
+        || !bds.Ignore( DRCE_NPTH_IN_COURTYARD ) )
+    {
+        addTask( _( "Courtyard areas...\n" ),
+                 [this]( std::vector<MARKER_PCB*>& aMarkers )
+                 {
+                     DRC_COURTYARD_TESTER tester( [&]( MARKER_PCB* aMarker )
+                                                  {
+                                                      addMarker( aMarkers, aMarker );
+                                                  } );
+
+                     tester.RunDRC( userUnits(), *m_pcb );
+                 } );
+    }
+
+    // Check if there are items on disabled layers
+    if( !bds.Ignore( DRCE_DISABLED_LAYER_ITEM ) )
+    {
+        addTask( _( "Items on disabled layers...\n" ),
+                 [this]( std::vector<MARKER_PCB*>& aMarkers )
+                 {
+                     testDisabledLayers( aMarkers );
+                 } );
+    }
+
+    if( !bds.Ignore( DRCE_UNRESOLVED_VARIABLE ) )
+    {
+        addTask( _( "Unresolved text variables...\n" ),
+                 [this, worksheet]( std::vector<MARKER_PCB*>& aMarkers )
+                 {
+                     DRC_TEXTVAR_TESTER tester( [&]( MARKER_PCB* aMarker )
+                                                {
+                                                    addMarker( aMarkers, aMarker );
+                                                },
+                                                worksheet );
+
+                     tester.RunDRC( userUnits(), *m_pcb );
+                 } );
+    }
+
+    // test track and via clearances to other tracks, pads, and vias
+    addTask( _( "Track clearances...\n" ),
+             [this]( std::vector<MARKER_PCB*>& aMarkers )
+             {
+                 testTracks( aMarkers );
+             } );
+
+    // The track test is the longest one: on large boards, show its progress in a dialog
+    // whose cancel button stops all the tests (they poll isCancelled()).  The markers found
+    // until then are kept.  The dialog is refreshed while the UI thread waits for the tests,
+    // so there is none for a serial run (which is headless anyway).
+    std::unique_ptr<WX_PROGRESS_REPORTER> progressReporter;
+
+    if( aCaller && m_threadCount != 1 && m_pcb->Tracks().size() > 2000 )
+    {
+        progressReporter = std::make_unique<WX_PROGRESS_REPORTER>( aCaller,
+                                                                   _( "Track clearances" ), 1 );
+        progressReporter->SetMaxProgress( m_pcb->Tracks().size() );
+    }
+
+    m_progressReporter = progressReporter.get();
+
+    if( m_threadCount == 1 )
+    {
+        for( DRC_TEST_TASK& task : tasks )
+        {
+            appendMessage( task.m_Name );
+            task.m_Test( task.m_Markers );
+        }
+    }
+    else
+    {
+        // The tests read the board while they run, so the event loop must not be entered
+        // until they are done (the user could edit or close the board meanwhile): the
+        // messages of the tests which have started are painted without yielding, and the
+        // progress dialog only processes its own events (it disables its parent), that is
+        // its painting and its cancel button.
+        std::vector<std::atomic<bool>> started( tasks.size() );
+        size_t                         reported = 0;
+
+        auto reportStarted =
+                [&]()
+                {
+                    for( ; aMessages && reported < tasks.size() && started[reported]; ++reported )
+                    {
+                        aMessages->AppendText( tasks[reported].m_Name );
+                        aMessages->Update();
+                    }
+                };
+
+        auto keepRefreshing =
+                [&]()
+                {
+                    reportStarted();
+
+                    if( m_progressReporter )
+                        m_progressReporter->KeepRefreshing();
+                };
+
+        TASK_GROUP tests;
+
+        for( size_t ii = 0; ii < tasks.size(); ++ii )
+        {
+            tests.Run( [&tasks, &started, ii]()
+                       {
+                           started[ii] = true;
+                           tasks[ii].m_Test( tasks[ii].m_Markers );
+                       } );
+        }
+
+        if( aMessages || m_progressReporter )
+        {
+            tests.Wait( keepRefreshing );
+            reportStarted();
+        }
+        else
+        {
+            tests.Wait();
+        }
+    }
+
+    m_progressReporter = nullptr;
+    progressReporter.reset();
+
+    for( DRC_TEST_TASK& task : tasks )
+        mergeMarkers( task.m_Markers );
+
+    //-----<serial follow-ups>---------------------------------------------
+
+    // find and gather unconnected pads.
+    if( m_doUnconnectedTest
+        && !bds.Ignore( DRCE_UNCONNECTED_ITEMS ) )
+    {
+        if( aMessages )
+        {
+            aMessages->AppendText( _( "Unconnected pads...\n" ) );
+            aMessages->Refresh();
+        }
+
+        testUnconnected();
+    }
+
+    return true;
+}
+
+
+void DRC::updatePointers()
+{
+    // update my pointers, m_editFrame is the only unchangeable one
+    m_pcb = m_editFrame->GetBoard();
+
+    m_editFrame->ResolveDRCExclusions();
+
+    if( m_drcDialog )  // Use diag list boxes only in DRC dialog
+    {
+        m_drcDialog->SetMarkersProvider( new BOARD_DRC_ITEMS_PROVIDER( m_pcb ) );
+        m_drcDialog->SetUnconnectedProvider( new RATSNEST_DRC_ITEMS_PROVIDER( m_editFrame,
+                                                                              &m_unconnected ) );
+        m_drcDialog->SetFootprintsProvider( new VECTOR_DRC_ITEMS_PROVIDER( m_editFrame,
+                                                                           &m_footprints ) );
+    }
+}
+
+
+/**
+ * The area of a pad which takes part in the clearance tests: its shape and its hole.
+ */
+static EDA_RECT padBoundingBox( D_PAD* aPad )
+{
+    EDA_RECT bbox = aPad->GetBoundingBox();
+
+    if( aPad->GetDrillSize().x > 0 )
+    {
+        int      holeRadius = std::max( aPad->GetDrillSize().x, aPad->GetDrillSize().y ) / 2;
+        EDA_RECT holeBox( aPad->GetPosition(), wxSize( 0, 0 ) );
+
+        holeBox.Inflate( holeRadius );
+        bbox.Merge( holeBox );
+    }
+
+    return bbox;
+}
+
+
+/**
+ * The copper layers on which a pad takes part in the clearance tests.  A pad's hole goes
+ * through all copper layers, whichever layers the pad itself is on.
+ */
+static LSET padIndexLayers( D_PAD* aPad )
+{
+    if( aPad->GetDrillSize().x > 0 )
+        return LSET::AllCuMask();
+
+    return aPad->GetLayerSet() & LSET::AllCuMask();
+}
+
+
+void DRC::buildSpatialIndices()
+{
+    m_sortedPads.clear();
+    m_padIndex.Clear();
+    m_trackIndex.Clear();
+    m_itemHashes.clear();
+    m_indexedPads.clear();
+    m_staleTracks.clear();
+    m_staleModules.clear();
+
+    m_pcb->GetSortedPadListByXthenYCoord( m_sortedPads );
+
+    // The indexed boxes must be inflated by the largest clearance any pair can need,
+    // including the local (pad and footprint) overrides which the netclass and rule based
+    // m_largestClearance doesn't account for.
+    m_indexInflate = std::max( m_largestClearance, m_pcb->GetDesignSettings().m_MinClearance );
+
+    for( D_PAD* pad : m_sortedPads )
+        m_indexInflate = std::max( m_indexInflate, pad->GetLocalClearance() );
+
+    for( TRACK* track : m_pcb->Tracks() )
+        m_indexInflate = std::max( m_indexInflate, track->GetLocalClearance() );
+
+    for( D_PAD* pad : m_sortedPads )
+        indexItem( pad );
+
+    for( TRACK* track : m_pcb->Tracks() )
+        indexItem( track );
+
+    // The listener keeps track of the changes of the edited board only
+    m_indicesValid = ( m_pcb == m_listenedBoard );
+}
+
+
+void DRC::indexItem( BOARD_CONNECTED_ITEM* aItem )
+{
+    if( aItem->Type() == PCB_PAD_T )
+    {
+        D_PAD*   pad = static_cast<D_PAD*>( aItem );
+        EDA_RECT bbox = padBoundingBox( pad );
+
+        bbox.Inflate( m_indexInflate );
+
+        m_padIndex.Insert( pad, padIndexLayers( pad ), bbox );
+        m_indexedPads[ pad->GetParent() ].push_back( pad );
+    }
+    else
+    {
+        m_trackIndex.Insert( aItem, aItem->GetLayerSet(), m_indexInflate );
+    }
+
+    m_itemHashes[ aItem ] = DRC_PAIR_CACHE::ItemHash( aItem );
+}
+
+
+void DRC::unindexPads( const BOARD_ITEM* aFootprint )
+{
+    auto it = m_indexedPads.find( aFootprint );
+
+    if( it == m_indexedPads.end() )
+        return;
+
+    for( D_PAD* pad : it->second )
+    {
+        m_padIndex.Remove( pad );
+        m_itemHashes.erase( pad );
+    }
+
+    m_indexedPads.erase( it );
+}
+
+
+void DRC::updateSpatialIndices()
+{
+    int  inflate = std::max( m_largestClearance, m_pcb->GetDesignSettings().m_MinClearance );
+    bool rebuild = !m_indicesValid || m_pcb != m_listenedBoard || inflate > m_indexInflate;
+
+    for( TRACK* track : m_staleTracks )
+    {
+        if( track->GetLocalClearance() > m_indexInflate )
+            rebuild = true;
+    }
+
+    for( MODULE* module : m_staleModules )
+    {
+        for( D_PAD* pad : module->Pads() )
         {
-            aMessages->AppendText( _( "Pad clearances...\n" ) );
-            wxSafeYield();
+            if( pad->GetLocalClearance() > m_indexInflate )
+                rebuild = true;
         }
-
-        testPadClearances( commit );
     }
 
-    // test drilled holes
-    if( !bds.Ignore( DRCE_DRILLED_HOLES_TOO_CLOSE )
-        || !bds.Ignore( DRCE_TOO_SMALL_PAD_DRILL )
-        || !bds.Ignore( DRCE_TOO_SMALL_VIA_DRILL )
-        || !bds.Ignore( DRCE_TOO_SMALL_MICROVIA_DRILL ) )
+    if( !rebuild )
     {
-        if( aMessages )
+        for( TRACK* track : m_staleTracks )
+            indexItem( track );
+
+        for( MODULE* module : m_staleModules )
         {
-            aMessages->AppendText( _( "Drill sizes and clearances...\n" ) );
-            wxSafeYield();
+            for( D_PAD* pad : module->Pads() )
+                indexItem( pad );
         }
 
-        DRC_DRILLED_HOLE_TESTER tester( [&]( MARKER_PCB* aMarker )
-                                        {
-                                            addMarkerToPcb( commit, aMarker );
-                                        } );
+        m_staleTracks.clear();
+        m_staleModules.clear();
 
-        tester.RunDRC( userUnits(), *m_pcb );
+        // A track added or removed without notice would leave the index out of date
+        rebuild = m_trackIndex.size() != m_pcb->Tracks().size();
     }
 
-    // caller (a wxTopLevelFrame) is the wxDialog or the Pcb Editor frame that call DRC:
-    wxWindow* caller = aMessages ? aMessages->GetParent() : m_editFrame;
+    if( rebuild )
+        buildSpatialIndices();
+}
 
-    if( m_refillZones )
-    {
-        if( aMessages )
-            aMessages->AppendText( _( "Refilling all zones...\n" ) );
 
-        m_toolMgr->GetTool<ZONE_FILLER_TOOL>()->FillAllZones( caller );
-    }
-    else
+/**
+ * The error codes reported by the item tests which TestChangedItems() re-runs.  Markers with
+ * other codes are left alone unless they involve a removed item.
+ */
+static bool isItemTestCode( int aCode )
+{
+    switch( aCode )
     {
-        if( aMessages )
-            aMessages->AppendText( _( "Checking zone fills...\n" ) );
-
-        m_toolMgr->GetTool<ZONE_FILLER_TOOL>()->CheckAllZones( caller );
+    case DRCE_TRACK_NEAR_HOLE:
+    case DRCE_TRACK_NEAR_PAD:
+    case DRCE_TRACK_NEAR_VIA:
+    case DRCE_TRACK_NEAR_ZONE:
+    case DRCE_VIA_NEAR_VIA:
+    case DRCE_VIA_NEAR_TRACK:
+    case DRCE_TRACK_ENDS:
+    case DRCE_TRACK_SEGMENTS_TOO_CLOSE:
+    case DRCE_TRACKS_CROSSING:
+    case DRCE_TRACK_NEAR_EDGE:
+    case DRCE_VIA_NEAR_EDGE:
+    case DRCE_PAD_NEAR_EDGE:
+    case DRCE_PAD_NEAR_PAD:
+    case DRCE_DANGLING_VIA:
+    case DRCE_DANGLING_TRACK:
+    case DRCE_HOLE_NEAR_PAD:
+    case DRCE_TOO_SMALL_TRACK_WIDTH:
+    case DRCE_TOO_LARGE_TRACK_WIDTH:
+    case DRCE_TOO_SMALL_VIA:
+    case DRCE_TOO_SMALL_VIA_ANNULUS:
+    case DRCE_VIA_HOLE_BIGGER:
+    case DRCE_MICROVIA_NOT_ALLOWED:
+    case DRCE_MICROVIA_TOO_MANY_LAYERS:
+    case DRCE_TOO_SMALL_MICROVIA:
+    case DRCE_BURIED_VIA_NOT_ALLOWED:
+        return true;
+
+    default:
+        return false;
     }
+}
 
-    // test track and via clearances to other tracks, pads, and vias
-    if( aMessages )
-    {
-        aMessages->AppendText( _( "Track clearances...\n" ) );
-        wxSafeYield();
-    }
 
-    testTracks( commit, aMessages ? aMessages->GetParent() : m_editFrame, true );
+void DRC::TestChangedItems( const std::vector<BOARD_ITEM*>& aChangedItems,
+                            const std::vector<KIID>& aRemovedItems )
+{
+    if( !m_editFrame || !m_editFrame->GetPcbNewSettings()->m_DrcDialog.incremental )
+        return;
 
-    // test zone clearances to other zones
-    if( aMessages )
-    {
-        aMessages->AppendText( _( "Zone to zone clearances...\n" ) );
-        wxSafeYield();
-    }
+    m_pcb = m_editFrame->GetBoard();
 
-    testZones( commit );
+    std::set<BOARD_CONNECTED_ITEM*> changed;
 
-    // find and gather unconnected pads.
-    if( m_doUnconnectedTest
-        && !bds.Ignore( DRCE_UNCONNECTED_ITEMS ) )
+    for( BOARD_ITEM* item : aChangedItems )
     {
-        if( aMessages )
+        switch( item->Type() )
         {
-            aMessages->AppendText( _( "Unconnected pads...\n" ) );
-            aMessages->Refresh();
-        }
+        case PCB_TRACE_T:
+        case PCB_ARC_T:
+        case PCB_VIA_T:
+        case PCB_PAD_T:
+            changed.insert( static_cast<BOARD_CONNECTED_ITEM*>( item ) );
+            break;
 
-        testUnconnected();
-    }
+        case PCB_MODULE_T:
+            for( D_PAD* pad : static_cast<MODULE*>( item )->Pads() )
+                changed.insert( pad );
 
-    // find and gather vias, tracks, pads inside keepout areas.
-    if( m_doKeepoutTest )
-    {
-        if( aMessages )
-        {
-            aMessages->AppendText( _( "Keepout areas ...\n" ) );
-            aMessages->Refresh();
+            break;
+
+        default:
+            break;
         }
+    }
 
-        DRC_KEEPOUT_TESTER tester( [&]( MARKER_PCB* aMarker )
-                                   {
-                                       addMarkerToPcb( commit, aMarker );
-                                   } );
+    if( changed.empty() && aRemovedItems.empty() )
+        return;
 
-        tester.RunDRC( userUnits(), *m_pcb );
-    }
+    m_largestClearance = m_pcb->GetDesignSettings().GetBiggestClearanceValue();
 
-    // find and gather vias, tracks, pads inside text boxes.
-    if( !bds.Ignore( DRCE_VIA_NEAR_COPPER )
-        || !bds.Ignore( DRCE_TRACK_NEAR_COPPER ) )
-    {
-        if( aMessages )
-        {
-            aMessages->AppendText( _( "Text and graphic clearances...\n" ) );
-            wxSafeYield();
-        }
+    // Only the items changed since the last update are indexed again, and the outline is
+    // only re-chained when one of its items has changed.
+    updateSpatialIndices();
 
-        testCopperTextAndGraphics( commit );
+    if( m_outlineStale )
+    {
+        m_board_outlines.RemoveAllContours();
+        m_board_outline_valid = m_pcb->GetBoardPolygonOutlines( m_board_outlines );
+        m_outlineStale = false;
     }
 
-    // test courtyards
-    if( !bds.Ignore( DRCE_OVERLAPPING_FOOTPRINTS )
-        || !bds.Ignore( DRCE_MISSING_COURTYARD )
-        || !bds.Ignore( DRCE_MALFORMED_COURTYARD )
-        || !bds.Ignore( DRCE_PTH_IN_COURTYARD )
-        || !bds.Ignore( DRCE_NPTH_IN_COURTYARD ) )
+    // A changed pad may invalidate the results of the (unchanged) tracks around it, as the
+    // track to pad clearances are tested from the track side.  Those tracks are re-tested
+    // too.
+    std::set<BOARD_CONNECTED_ITEM*> dirty = changed;
+
+    for( BOARD_CONNECTED_ITEM* item : changed )
     {
-        if( aMessages )
-        {
-            aMessages->AppendText( _( "Courtyard areas...\n" ) );
-            aMessages->Refresh();
-        }
+        if( item->Type() != PCB_PAD_T )
+            continue;
 
-        DRC_COURTYARD_TESTER tester( [&]( MARKER_PCB* aMarker )
-                                     {
-                                         addMarkerToPcb( commit, aMarker );
-                                     } );
+        D_PAD* pad = static_cast<D_PAD*>( item );
 
-        tester.RunDRC( userUnits(), *m_pcb );
+        m_trackIndex.QueryColliding( padBoundingBox( pad ), padIndexLayers( pad ),
+                [&]( const DRC_RTREE::ITEM& aItem ) -> bool
+                {
+                    dirty.insert( aItem.m_item );
+                    return true;
+                } );
     }
 
-    for( DRC_ITEM* footprintItem : m_footprints )
-        delete footprintItem;
+    std::set<KIID> removedIds( aRemovedItems.begin(), aRemovedItems.end() );
+    std::set<KIID> dirtyIds;
 
-    m_footprints.clear();
-    m_footprintsTested = false;
+    for( BOARD_CONNECTED_ITEM* item : dirty )
+        dirtyIds.insert( item->m_Uuid );
 
-    if( m_testFootprints && !Kiface().IsSingle() )
+    // Drop the markers which the new tests supersede, remembering which of them the user
+    // had excluded so that the exclusions survive the re-test.
+    KIGFX::VIEW*       view = getView();
+    std::set<wxString> exclusions;
+    MARKERS            staleMarkers;
+
+    for( MARKER_PCB* marker : m_pcb->Markers() )
     {
-        if( aMessages )
+        const RC_ITEM* rcItem = marker->GetRCItem();
+        KIID           mainId = rcItem->GetMainItemID();
+        KIID           auxId = rcItem->GetAuxItemID();
+
+        if( removedIds.count( mainId ) || removedIds.count( auxId )
+            || ( isItemTestCode( rcItem->GetErrorCode() )
+                 && ( dirtyIds.count( mainId ) || dirtyIds.count( auxId ) ) ) )
         {
-            aMessages->AppendText( _( "Checking footprints against schematic...\n" ) );
-            aMessages->Refresh();
+            if( marker->IsExcluded() )
+                exclusions.insert( marker->Serialize() );
+
+            staleMarkers.push_back( marker );
         }
+    }
 
-        NETLIST netlist;
-        m_editFrame->FetchNetlistFromSchematic( netlist, PCB_EDIT_FRAME::ANNOTATION_DIALOG );
+    for( MARKER_PCB* marker : staleMarkers )
+    {
+        view->Remove( marker );
+        m_pcb->Delete( marker );
+    }
 
-        if( m_drcDialog )
-            m_drcDialog->Raise();
+    // Re-test the dirty items against their neighbourhoods.  The dirty items are tested in
+    // index order, and a dirty neighbour is only tested from the first of the pair, so that
+    // each pair is still tested once.
+    std::vector<MARKER_PCB*> markers;
 
-        TestFootprints( netlist, m_pcb, m_footprints );
-        m_footprintsTested = true;
-    }
+    auto isCandidate =
+            [&]( const DRC_RTREE::ITEM& aRef, const DRC_RTREE::ITEM& aItem ) -> bool
+            {
+                return aItem.m_index > aRef.m_index || !dirty.count( aItem.m_item );
+            };
 
-    // Check if there are items on disabled layers
-    if( !bds.Ignore( DRCE_DISABLED_LAYER_ITEM ) )
+    std::vector<DRC_RTREE::ITEM> dirtyTracks;
+    std::vector<DRC_RTREE::ITEM> dirtyPads;
+
+    for( BOARD_CONNECTED_ITEM* item : dirty )
     {
-        if( aMessages )
+        if( item->Type() == PCB_PAD_T )
         {
-            aMessages->AppendText( _( "Items on disabled layers...\n" ) );
-            aMessages->Refresh();
+            if( m_padIndex.IndexOf( item ) >= 0 )
+                dirtyPads.push_back( { item, m_padIndex.IndexOf( item ) } );
+        }
+        else
+        {
+            if( m_trackIndex.IndexOf( item ) >= 0 )
+                dirtyTracks.push_back( { item, m_trackIndex.IndexOf( item ) } );
         }
-
-        testDisabledLayers( commit );
     }
 
-    if( !bds.Ignore( DRCE_UNRESOLVED_VARIABLE ) )
+    auto indexOrder =
+            []( const DRC_RTREE::ITEM& a, const DRC_RTREE::ITEM& b )
+            {
+                return a.m_index < b.m_index;
+            };
+
+    std::sort( dirtyTracks.begin(), dirtyTracks.end(), indexOrder );
+    std::sort( dirtyPads.begin(), dirtyPads.end(), indexOrder );
+
+    for( const DRC_RTREE::ITEM& ref : dirtyTracks )
     {
-        if( aMessages )
-        {
-            aMessages->AppendText( _( "Unresolved text variables...\n" ) );
-            aMessages->Refresh();
-        }
+        TRACK* track = static_cast<TRACK*>( ref.m_item );
 
-        DRC_TEXTVAR_TESTER tester( [&]( MARKER_PCB* aMarker )
-                                   {
-                                       addMarkerToPcb( commit, aMarker );
-                                   },
-                                   m_editFrame->GetCanvas()->GetWorksheet() );
+        doTrackDrc( markers, track,
+                    [&]( const DRC_RTREE::ITEM& aItem )
+                    {
+                        return isCandidate( ref, aItem );
+                    },
+                    m_testTracksAgainstZones );
 
-        tester.RunDRC( userUnits(), *m_pcb );
+        testTrackDangling( markers, track );
     }
 
-    commit.Push( wxEmptyString, false, false );
-    m_drcRun = true;
+    for( const DRC_RTREE::ITEM& ref : dirtyPads )
+    {
+        doPadDrc( markers, static_cast<D_PAD*>( ref.m_item ),
+                  [&]( const DRC_RTREE::ITEM& aItem )
+                  {
+                      return isCandidate( ref, aItem );
+                  } );
+    }
 
-    // update the m_drcDialog listboxes
-    updatePointers();
+    BOARD_COMMIT commit( m_editFrame );
 
-    if( aMessages )
+    for( MARKER_PCB* marker : markers )
     {
-        // no newline on this one because it is last, don't want the window
-        // to unnecessarily scroll.
-        aMessages->AppendText( _( "Finished" ) );
+        if( exclusions.count( marker->Serialize() ) )
+            marker->SetExcluded( true );
+
+        commit.Add( marker );
     }
-}
 
+    commit.Push( wxEmptyString, false, false );
 
-void DRC::updatePointers()
-{
-    // update my pointers, m_editFrame is the only unchangeable one
-    m_pcb = m_editFrame->GetBoard();
+    // update the m_drcDialog listboxes
+    if( m_drcDialog )
+        updatePointers();
+}
 
-    m_editFrame->ResolveDRCExclusions();
 
-    if( m_drcDialog )  // Use diag list boxes only in DRC dialog
+void DRC::testPadClearances( std::vector<MARKER_PCB*>& aMarkers )
+{
+    // Test the pads.  Each pair is tested once: the reference pad is tested only against
+    // the pads which follow it in the sorted list.
+    for( int padIndex = 0; padIndex < (int) m_sortedPads.size(); ++padIndex )
     {
-        m_drcDialog->SetMarkersProvider( new BOARD_DRC_ITEMS_PROVIDER( m_pcb ) );
-        m_drcDialog->SetUnconnectedProvider( new RATSNEST_DRC_ITEMS_PROVIDER( m_editFrame,
-                                                                              &m_unconnected ) );
-        m_drcDialog->SetFootprintsProvider( new VECTOR_DRC_ITEMS_PROVIDER( m_editFrame,
-                                                                           &m_footprints ) );
+        if( isCancelled() )
+            break;
+
+        doPadDrc( aMarkers, m_sortedPads[ padIndex ],
+                  [padIndex]( const DRC_RTREE::ITEM& aItem )
+                  {
+                      return aItem.m_index > padIndex;
+                  } );
     }
 }
 
 
-void DRC::testPadClearances( BOARD_COMMIT& aCommit )
+void DRC::doPadDrc( std::vector<MARKER_PCB*>& aMarkers, D_PAD* aPad,
+                    const std::function<bool( const DRC_RTREE::ITEM& )>& aIsCandidate )
 {
-    BOARD_DESIGN_SETTINGS& bds = m_pcb->GetDesignSettings();
-    std::vector<D_PAD*>    sortedPads;
-
-    m_pcb->GetSortedPadListByXthenYCoord( sortedPads );
-
-    if( sortedPads.empty() )
-        return;
+    wxString msg;
+    wxString clearanceSource;
 
-    // find the max size of the pads (used to stop the pad-to-pad tests)
-    int max_size = 0;
+    BOARD_DESIGN_SETTINGS& bds = m_pcb->GetDesignSettings();
 
-    for( D_PAD* pad : sortedPads )
+    if( !bds.Ignore( DRCE_PAD_NEAR_EDGE ) && m_board_outline_valid )
     {
-        // GetBoundingRadius() is the radius of the minimum sized circle fully containing the pad
-        int radius = pad->GetBoundingRadius();
-
-        if( radius > max_size )
-            max_size = radius;
-    }
+        int minClearance = bds.m_CopperEdgeClearance;
+        clearanceSource = _( "board edge" );
 
-    // Better to be fast than accurate; this keeps us from having to look up / calculate the
-    // actual clearances
-    max_size += m_largestClearance;
+        static DRAWSEGMENT dummyEdge;
+        dummyEdge.SetLayer( Edge_Cuts );
 
-    // Upper limit of pad list (limit not included)
-    D_PAD** listEnd = &sortedPads[0] + sortedPads.size();
+        if( aPad->GetRuleClearance( &dummyEdge, &minClearance, &clearanceSource ) )
+            /* minClearance and clearanceSource set in GetRuleClearance() */;
 
-    // Test the pads
-    for( auto& pad : sortedPads )
-    {
-        if( !bds.Ignore( DRCE_PAD_NEAR_EDGE ) && m_board_outline_valid )
+        for( auto it = m_board_outlines.IterateSegmentsWithHoles(); it; it++ )
         {
-            int minClearance = bds.m_CopperEdgeClearance;
-            m_clearanceSource = _( "board edge" );
-
-            static DRAWSEGMENT dummyEdge;
-            dummyEdge.SetLayer( Edge_Cuts );
+            int actual;
 
-            if( pad->GetRuleClearance( &dummyEdge, &minClearance, &m_clearanceSource ) )
-                /* minClearance and m_clearanceSource set in GetRuleClearance() */;
-
-            for( auto it = m_board_outlines.IterateSegmentsWithHoles(); it; it++ )
+            if( !checkClearanceSegmToPad( *it, 0, aPad, minClearance, &actual ) )
             {
-                int actual;
+                actual = std::max( 0, actual );
+                DRC_ITEM* drcItem = new DRC_ITEM( DRCE_PAD_NEAR_EDGE );
 
-                if( !checkClearanceSegmToPad( *it, 0, pad, minClearance, &actual ) )
-                {
-                    actual = std::max( 0, actual );
-                    DRC_ITEM* drcItem = new DRC_ITEM( DRCE_PAD_NEAR_EDGE );
-
-                    m_msg.Printf( drcItem->GetErrorText() + _( " (%s clearance %s; actual %s)" ),
-                                  m_clearanceSource,
-                                  MessageTextFromValue( userUnits(), minClearance, true ),
-                                  MessageTextFromValue( userUnits(), actual, true ) );
+                msg.Printf( drcItem->GetErrorText() + _( " (%s clearance %s; actual %s)" ),
+                            clearanceSource,
+                            MessageTextFromValue( userUnits(), minClearance, true ),
+                            MessageTextFromValue( userUnits(), actual, true ) );
 
-                    drcItem->SetErrorMessage( m_msg );
-                    drcItem->SetItems( pad );
+                drcItem->SetErrorMessage( msg );
+                drcItem->SetItems( aPad );
 
-                    MARKER_PCB* marker = new MARKER_PCB( drcItem, pad->GetPosition() );
-                    addMarkerToPcb( aCommit, marker );
+                MARKER_PCB* marker = new MARKER_PCB( drcItem, aPad->GetPosition() );
+                addMarker( aMarkers, marker );
 
-                    break;
-                }
+                break;
             }
         }
+    }
 
-        if( !bds.Ignore( DRCE_PAD_NEAR_PAD ) || !bds.Ignore( DRCE_HOLE_NEAR_PAD ) )
-        {
-            int x_limit = pad->GetPosition().x + pad->GetBoundingRadius() + max_size;
+    if( !bds.Ignore( DRCE_PAD_NEAR_PAD ) || !bds.Ignore( DRCE_HOLE_NEAR_PAD ) )
+    {
+        std::vector<DRC_RTREE::ITEM> found;
+        std::vector<D_PAD*>          candidates;
 
-            doPadToPadsDrc( aCommit, pad, &pad, listEnd, x_limit );
-        }
+        m_padIndex.QueryColliding( padBoundingBox( aPad ), padIndexLayers( aPad ),
+                [&]( const DRC_RTREE::ITEM& aItem ) -> bool
+                {
+                    if( aItem.m_item != aPad && aIsCandidate( aItem ) )
+                        found.push_back( aItem );
+
+                    return true;
+                } );
+
+        std::sort( found.begin(), found.end(),
+                   []( const DRC_RTREE::ITEM& a, const DRC_RTREE::ITEM& b )
+                   {
+                       return a.m_index < b.m_index;
+                   } );
+
+        for( const DRC_RTREE::ITEM& item : found )
+            candidates.push_back( static_cast<D_PAD*>( item.m_item ) );
+
+        doPadToPadsDrc( aMarkers, aPad, candidates );
     }
 }
 
 
-void DRC::testTracks( BOARD_COMMIT& aCommit, wxWindow *aActiveWindow, bool aShowProgressBar )
+void DRC::testTracks( std::vector<MARKER_PCB*>& aMarkers )
 {
-    wxProgressDialog* progressDialog = NULL;
-    const int         delta = 500;  // This is the number of tests between 2 calls to the
-                                    // progress bar
-    int               count = m_pcb->Tracks().size();
-    int               deltamax = count/delta;
+    // Connectivity has been rebuilt by RunTests() if the dangling tests are enabled
+
+    int trackIndex = 0;
 
-    if( aShowProgressBar && deltamax > 3 )
+    for( auto seg_it = m_pcb->Tracks().begin(); seg_it != m_pcb->Tracks().end();
+         seg_it++, trackIndex++ )
     {
-        // Do not use wxPD_APP_MODAL style here: it is not necessary and create issues
-        // on OSX
-        progressDialog = new wxProgressDialog( _( "Track clearances" ), wxEmptyString,
-                                               deltamax, aActiveWindow,
-                                               wxPD_AUTO_HIDE | wxPD_CAN_ABORT | wxPD_ELAPSED_TIME );
-        progressDialog->Update( 0, wxEmptyString );
-    }
+        if( isCancelled() )
+            break;
 
-    std::shared_ptr<CONNECTIVITY_DATA> connectivity = m_pcb->GetConnectivity();
-    BOARD_DESIGN_SETTINGS&             settings = m_pcb->GetDesignSettings();
+        // Test new segment against tracks and pads, optionally against copper zones.  Only
+        // the tracks which follow it are tested, as the earlier ones have already been tested
+        // against it.
+        doTrackDrc( aMarkers, *seg_it,
+                    [trackIndex]( const DRC_RTREE::ITEM& aItem )
+                    {
+                        return aItem.m_index > trackIndex;
+                    },
+                    m_testTracksAgainstZones );
 
+        testTrackDangling( aMarkers, *seg_it );
 
-    if( !m_pcb->GetDesignSettings().Ignore( DRCE_DANGLING_TRACK )
-            || !m_pcb->GetDesignSettings().Ignore( DRCE_DANGLING_VIA ) )
-    {
-        connectivity->Clear();
-        connectivity->Build( m_pcb ); // just in case. This really needs to be reliable.
+        if( m_progressReporter )
+            m_progressReporter->AdvanceProgress();
     }
+}
 
-    int ii = 0;
-    count = 0;
-
-    for( auto seg_it = m_pcb->Tracks().begin(); seg_it != m_pcb->Tracks().end(); seg_it++ )
-    {
-        if( ii++ > delta )
-        {
-            ii = 0;
-            count++;
-
-            if( progressDialog )
-            {
-                if( !progressDialog->Update( count, wxEmptyString ) )
-                    break;  // Aborted by user
-#ifdef __WXMAC__
-                // Work around a dialog z-order issue on OS X
-                if( count == deltamax )
-                    aActiveWindow->Raise();
-#endif
-            }
-        }
 
-        // Test new segment against tracks and pads, optionally against copper zones
-        doTrackDrc( aCommit, *seg_it, seg_it + 1, m_pcb->Tracks().end(), m_testTracksAgainstZones );
+void DRC::testTrackDangling( std::vector<MARKER_PCB*>& aMarkers, TRACK* aTrack )
+{
+    int     code = aTrack->Type() == PCB_VIA_T ? DRCE_DANGLING_VIA : DRCE_DANGLING_TRACK;
+    wxPoint pos;
 
-        // Test for dangling items
-        int code = (*seg_it)->Type() == PCB_VIA_T ? DRCE_DANGLING_VIA : DRCE_DANGLING_TRACK;
-        wxPoint pos;
+    if( m_pcb->GetDesignSettings().Ignore( code ) )
+        return;
 
-        if( !settings.Ignore( code ) && connectivity->TestTrackEndpointDangling( *seg_it, &pos ) )
-        {
-            DRC_ITEM* drcItem = new DRC_ITEM( code );
-            drcItem->SetItems( *seg_it );
+    if( m_pcb->GetConnectivity()->TestTrackEndpointDangling( aTrack, &pos ) )
+    {
+        DRC_ITEM* drcItem = new DRC_ITEM( code );
+        drcItem->SetItems( aTrack );
 
-            MARKER_PCB* marker = new MARKER_PCB( drcItem, pos );
-            addMarkerToPcb( aCommit, marker );
-        }
+        MARKER_PCB* marker = new MARKER_PCB( drcItem, pos );
+        addMarker( aMarkers, marker );
     }
-
-    if( progressDialog )
-        progressDialog->Destroy();
 }
 
 
@@ -669,14 +1421,35 @@ void DRC::testUnconnected()
     {
         DRC_ITEM* item = new DRC_ITEM( DRCE_UNCONNECTED_ITEMS );
         item->SetItems( edge.GetSourceNode()->Parent(), edge.GetTargetNode()->Parent() );
-        m_unconnected.push_back( item );
+
+        if( m_reportSink )
+            reportMarker( new MARKER_PCB( item, (wxPoint) edge.GetSourcePos() ) );
+        else
+            m_unconnected.push_back( item );
     }
 }
 
 
-void DRC::testZones( BOARD_COMMIT& aCommit )
+/**
+ * A pair of zones to compare in testZones(), along with the results of the comparison.
+ */
+struct ZONE_PAIR
+{
+    int                    m_ref;
+    int                    m_test;
+    int                    m_clearance;
+    wxString               m_clearanceSource;
+    std::vector<wxPoint>   m_refCorners;      // corners of m_ref inside m_test
+    std::vector<wxPoint>   m_testCorners;     // corners of m_test inside m_ref
+    std::map<wxPoint, int> m_conflictPoints;
+};
+
+
+void DRC::testZones( std::vector<MARKER_PCB*>& aMarkers )
 {
-    BOARD*                 board = m_editFrame->GetBoard();
+    wxString msg;
+
+    BOARD*                 board = m_pcb;
     BOARD_DESIGN_SETTINGS& bds = board->GetDesignSettings();
 
     // Test copper areas for valid netcodes
@@ -709,7 +1482,7 @@ void DRC::testZones( BOARD_COMMIT& aCommit )
                 drcItem->SetItems( zone );
 
                 MARKER_PCB* marker = new MARKER_PCB( drcItem, zone->GetPosition() );
-                addMarkerToPcb( aCommit, marker );
+                addMarker( aMarkers, marker );
             }
         }
 
@@ -720,7 +1493,17 @@ void DRC::testZones( BOARD_COMMIT& aCommit )
         zoneRef->BuildSmoothedPoly( smoothed_polys[ii], &colinearCorners );
     }
 
-    // iterate through all areas
+    // Collect the zone pairs which need to be compared.  Clearances are resolved here, as the
+    // pairs whose outlines are further apart than their clearance are skipped.
+    std::vector<BOX2I>     bboxes( board->GetAreaCount() );
+    std::vector<ZONE_PAIR> pairs;
+
+    for( int ia = 0; ia < board->GetAreaCount(); ia++ )
+    {
+        smoothed_polys[ia].BuildBBoxCaches();
+        bboxes[ia] = smoothed_polys[ia].BBoxFromCaches();
+    }
+
     for( int ia = 0; ia < board->GetAreaCount(); ia++ )
     {
         ZONE_CONTAINER* zoneRef = board->GetArea( ia );
@@ -728,8 +1511,6 @@ void DRC::testZones( BOARD_COMMIT& aCommit )
         if( !zoneRef->IsOnCopperLayer() )
             continue;
 
-        // If we are testing a single zone, then iterate through all other zones
-        // Otherwise, we have already tested the zone combination
         for( int ia2 = ia + 1; ia2 < board->GetAreaCount(); ia2++ )
         {
             ZONE_CONTAINER* zoneToTest = board->GetArea( ia2 );
@@ -753,133 +1534,167 @@ void DRC::testZones( BOARD_COMMIT& aCommit )
             if( zoneRef->GetIsKeepout() != zoneToTest->GetIsKeepout() )
                 continue;
 
-            // Examine a candidate zone: compare zoneToTest to zoneRef
+            ZONE_PAIR pair;
+            pair.m_ref = ia;
+            pair.m_test = ia2;
 
             // Get clearance used in zone to zone test.  The policy used to
             // obtain that value is now part of the zone object itself by way of
             // ZONE_CONTAINER::GetClearance().
-            int zone2zoneClearance = zoneRef->GetClearance( zoneToTest, &m_clearanceSource );
+            pair.m_clearance = zoneRef->GetClearance( zoneToTest, &pair.m_clearanceSource );
 
             // Keepout areas have no clearance, so set zone2zoneClearance to 1
             // ( zone2zoneClearance = 0  can create problems in test functions)
             if( zoneRef->GetIsKeepout() )
-                zone2zoneClearance = 1;
+                pair.m_clearance = 1;
 
-            // test for some corners of zoneRef inside zoneToTest
-            for( auto iterator = smoothed_polys[ia].IterateWithHoles(); iterator; iterator++ )
-            {
-                VECTOR2I currentVertex = *iterator;
-                wxPoint pt( currentVertex.x, currentVertex.y );
+            // Zones whose outlines are further apart than the clearance cannot collide
+            BOX2I inflated = bboxes[ia];
+            inflated.Inflate( pair.m_clearance );
 
-                if( smoothed_polys[ia2].Contains( currentVertex ) )
-                {
-                    DRC_ITEM* drcItem = new DRC_ITEM( DRCE_ZONES_INTERSECT );
-                    drcItem->SetItems( zoneRef, zoneToTest );
+            if( !inflated.Intersects( bboxes[ia2] ) )
+                continue;
 
-                    MARKER_PCB* marker = new MARKER_PCB( drcItem, pt );
-                    addMarkerToPcb( aCommit, marker );
-                }
-            }
+            pairs.push_back( pair );
+        }
+    }
 
-            // test for some corners of zoneToTest inside zoneRef
-            for( auto iterator = smoothed_polys[ia2].IterateWithHoles(); iterator; iterator++ )
+    // The outline comparisons only read the smoothed polygons, so they run in parallel.
+    // Markers are created afterwards, in pair order, so the results do not depend on the
+    // thread scheduling.
+    parallelFor( pairs.size(),
+            [&]( size_t aIndex )
             {
-                VECTOR2I currentVertex = *iterator;
-                wxPoint pt( currentVertex.x, currentVertex.y );
+                ZONE_PAIR&            pair = pairs[aIndex];
+                const SHAPE_POLY_SET& refPoly = smoothed_polys[pair.m_ref];
+                const SHAPE_POLY_SET& testPoly = smoothed_polys[pair.m_test];
 
-                if( smoothed_polys[ia].Contains( currentVertex ) )
+                // test for some corners of zoneRef inside zoneToTest
+                for( auto iterator = refPoly.CIterateWithHoles(); iterator; iterator++ )
                 {
-                    DRC_ITEM* drcItem = new DRC_ITEM( DRCE_ZONES_INTERSECT );
-                    drcItem->SetItems( zoneToTest, zoneRef );
-
-                    MARKER_PCB* marker = new MARKER_PCB( drcItem, pt );
-                    addMarkerToPcb( aCommit, marker );
+                    if( testPoly.Contains( *iterator, -1, 0, true ) )
+                        pair.m_refCorners.emplace_back( iterator->x, iterator->y );
                 }
-            }
 
-            // Iterate through all the segments of refSmoothedPoly
-            std::map<wxPoint, int> conflictPoints;
+                // test for some corners of zoneToTest inside zoneRef
+                for( auto iterator = testPoly.CIterateWithHoles(); iterator; iterator++ )
+                {
+                    if( refPoly.Contains( *iterator, -1, 0, true ) )
+                        pair.m_testCorners.emplace_back( iterator->x, iterator->y );
+                }
 
-            for( auto refIt = smoothed_polys[ia].IterateSegmentsWithHoles(); refIt; refIt++ )
-            {
-                // Build ref segment
-                SEG refSegment = *refIt;
+                // Only the segments of zoneRef which come within the clearance of the outline
+                // of zoneToTest need to be compared with its segments
+                BOX2I testBBox = bboxes[pair.m_test];
+                testBBox.Inflate( pair.m_clearance );
 
-                // Iterate through all the segments in smoothed_polys[ia2]
-                for( auto testIt = smoothed_polys[ia2].IterateSegmentsWithHoles(); testIt; testIt++ )
+                for( auto refIt = refPoly.CIterateSegments( 0, -1, true ); refIt; refIt++ )
                 {
-                    // Build test segment
-                    SEG testSegment = *testIt;
-                    wxPoint pt;
-
-                    int ax1, ay1, ax2, ay2;
-                    ax1 = refSegment.A.x;
-                    ay1 = refSegment.A.y;
-                    ax2 = refSegment.B.x;
-                    ay2 = refSegment.B.y;
-
-                    int bx1, by1, bx2, by2;
-                    bx1 = testSegment.A.x;
-                    by1 = testSegment.A.y;
-                    bx2 = testSegment.B.x;
-                    by2 = testSegment.B.y;
-
-                    int d = GetClearanceBetweenSegments( bx1, by1, bx2, by2,
-                                                         0,
-                                                         ax1, ay1, ax2, ay2,
-                                                         0,
-                                                         zone2zoneClearance,
-                                                         &pt.x, &pt.y );
-
-                    if( d < zone2zoneClearance )
+                    // Build ref segment
+                    SEG   refSegment = *refIt;
+                    BOX2I refBBox( refSegment.A, refSegment.B - refSegment.A );
+
+                    if( !testBBox.Intersects( refBBox ) )
+                        continue;
+
+                    // Iterate through all the segments of zoneToTest
+                    for( auto testIt = testPoly.CIterateSegments( 0, -1, true ); testIt; testIt++ )
                     {
-                        if( conflictPoints.count( pt ) )
-                            conflictPoints[ pt ] = std::min( conflictPoints[ pt ], d );
-                        else
-                            conflictPoints[ pt ] = d;
+                        // Build test segment
+                        SEG testSegment = *testIt;
+                        wxPoint pt;
+
+                        int ax1, ay1, ax2, ay2;
+                        ax1 = refSegment.A.x;
+                        ay1 = refSegment.A.y;
+                        ax2 = refSegment.B.x;
+                        ay2 = refSegment.B.y;
+
+                        int bx1, by1, bx2, by2;
+                        bx1 = testSegment.A.x;
+                        by1 = testSegment.A.y;
+                        bx2 = testSegment.B.x;
+                        by2 = testSegment.B.y;
+
+                        int d = GetClearanceBetweenSegments( bx1, by1, bx2, by2,
+                                                             0,
+                                                             ax1, ay1, ax2, ay2,
+                                                             0,
+                                                             pair.m_clearance,
+                                                             &pt.x, &pt.y );
+
+                        if( d < pair.m_clearance )
+                        {
+                            auto ins = pair.m_conflictPoints.emplace( pt, d );
+
+                            if( !ins.second )
+                                ins.first->second = std::min( ins.first->second, d );
+                        }
                     }
                 }
-            }
+            } );
 
-            for( const std::pair<const wxPoint, int>& conflict : conflictPoints )
-            {
-                int       actual = conflict.second;
-                DRC_ITEM* drcItem;
+    for( const ZONE_PAIR& pair : pairs )
+    {
+        ZONE_CONTAINER* zoneRef = board->GetArea( pair.m_ref );
+        ZONE_CONTAINER* zoneToTest = board->GetArea( pair.m_test );
 
-                if( actual <= 0 )
-                {
-                    drcItem = new DRC_ITEM( DRCE_ZONES_INTERSECT );
-                }
-                else
-                {
-                    drcItem = new DRC_ITEM( DRCE_ZONES_TOO_CLOSE );
+        for( const wxPoint& pt : pair.m_refCorners )
+        {
+            DRC_ITEM* drcItem = new DRC_ITEM( DRCE_ZONES_INTERSECT );
+            drcItem->SetItems( zoneRef, zoneToTest );
+
+            MARKER_PCB* marker = new MARKER_PCB( drcItem, pt );
+            addMarker( aMarkers, marker );
+        }
 
-                    m_msg.Printf( drcItem->GetErrorText() + _( " (%s clearance %s; actual %s)" ),
-                                  m_clearanceSource,
-                                  MessageTextFromValue( userUnits(), zone2zoneClearance, true ),
-                                  MessageTextFromValue( userUnits(), conflict.second, true ) );
+        for( const wxPoint& pt : pair.m_testCorners )
+        {
+            DRC_ITEM* drcItem = new DRC_ITEM( DRCE_ZONES_INTERSECT );
+            drcItem->SetItems( zoneToTest, zoneRef );
 
-                    drcItem->SetErrorMessage( m_msg );
-                }
+            MARKER_PCB* marker = new MARKER_PCB( drcItem, pt );
+            addMarker( aMarkers, marker );
+        }
+
+        for( const std::pair<const wxPoint, int>& conflict : pair.m_conflictPoints )
+        {
+            int       actual = conflict.second;
+            DRC_ITEM* drcItem;
+
+            if( actual <= 0 )
+            {
+                drcItem = new DRC_ITEM( DRCE_ZONES_INTERSECT );
+            }
+            else
+            {
+                drcItem = new DRC_ITEM( DRCE_ZONES_TOO_CLOSE );
 
-                drcItem->SetItems( zoneRef, zoneToTest );
+                msg.Printf( drcItem->GetErrorText() + _( " (%s clearance %s; actual %s)" ),
+                            pair.m_clearanceSource,
+                            MessageTextFromValue( userUnits(), pair.m_clearance, true ),
+                            MessageTextFromValue( userUnits(), conflict.second, true ) );
 
-                MARKER_PCB* marker = new MARKER_PCB( drcItem, conflict.first );
-                addMarkerToPcb( aCommit, marker );
+                drcItem->SetErrorMessage( msg );
             }
+
+            drcItem->SetItems( zoneRef, zoneToTest );
+
+            MARKER_PCB* marker = new MARKER_PCB( drcItem, conflict.first );
+            addMarker( aMarkers, marker );
         }
     }
 }
 
 
-void DRC::testCopperTextAndGraphics( BOARD_COMMIT& aCommit )
+void DRC::testCopperTextAndGraphics( std::vector<MARKER_PCB*>& aMarkers )
 {
     // Test copper items for clearance violations with vias, tracks and pads
 
     for( BOARD_ITEM* brdItem : m_pcb->Drawings() )
     {
         if( IsCopperLayer( brdItem->GetLayer() ) )
-            testCopperDrawItem( aCommit, brdItem );
+            testCopperDrawItem( aMarkers, brdItem );
     }
 
     for( MODULE* module : m_pcb->Modules() )
@@ -888,10 +1703,10 @@ void DRC::testCopperTextAndGraphics( BOARD_COMMIT& aCommit )
         TEXTE_MODULE& val = module->Value();
 
         if( ref.IsVisible() && IsCopperLayer( ref.GetLayer() ) )
-            testCopperDrawItem( aCommit, &ref );
+            testCopperDrawItem( aMarkers, &ref );
 
         if( val.IsVisible() && IsCopperLayer( val.GetLayer() ) )
-            testCopperDrawItem( aCommit, &val );
+            testCopperDrawItem( aMarkers, &val );
 
         if( module->IsNetTie() )
             continue;
@@ -901,17 +1716,20 @@ void DRC::testCopperTextAndGraphics( BOARD_COMMIT& aCommit )
             if( IsCopperLayer( item->GetLayer() ) )
             {
                 if( item->Type() == PCB_MODULE_TEXT_T && ( (TEXTE_MODULE*) item )->IsVisible() )
-                    testCopperDrawItem( aCommit, item );
+                    testCopperDrawItem( aMarkers, item );
                 else if( item->Type() == PCB_MODULE_EDGE_T )
-                    testCopperDrawItem( aCommit, item );
+                    testCopperDrawItem( aMarkers, item );
             }
         }
     }
 }
 
 
-void DRC::testCopperDrawItem( BOARD_COMMIT& aCommit, BOARD_ITEM* aItem )
+void DRC::testCopperDrawItem( std::vector<MARKER_PCB*>& aMarkers, BOARD_ITEM* aItem )
 {
+    wxString msg;
+    wxString clearanceSource;
+
     EDA_RECT         bbox;
     std::vector<SEG> itemShape;
     int              itemWidth;
@@ -1012,7 +1830,7 @@ void DRC::testCopperDrawItem( BOARD_COMMIT& aCommit, BOARD_ITEM* aItem )
         if( !track->IsOnLayer( aItem->GetLayer() ) )
             continue;
 
-        int minClearance = track->GetClearance( aItem, &m_clearanceSource );
+        int minClearance = track->GetClearance( aItem, &clearanceSource );
         int widths = ( track->GetWidth() + itemWidth ) / 2;
         int center2centerAllowed = minClearance + widths;
 
@@ -1043,17 +1861,17 @@ void DRC::testCopperDrawItem( BOARD_COMMIT& aCommit, BOARD_ITEM* aItem )
                                                                  : DRCE_TRACK_NEAR_COPPER;
             DRC_ITEM* drcItem = new DRC_ITEM( errorCode );
 
-            m_msg.Printf( drcItem->GetErrorText() + _( " (%s clearance %s; actual %s)" ),
-                          m_clearanceSource,
-                          MessageTextFromValue( userUnits(), minClearance, true ),
-                          MessageTextFromValue( userUnits(), actual, true ) );
+            msg.Printf( drcItem->GetErrorText() + _( " (%s clearance %s; actual %s)" ),
+                        clearanceSource,
+                        MessageTextFromValue( userUnits(), minClearance, true ),
+                        MessageTextFromValue( userUnits(), actual, true ) );
 
-            drcItem->SetErrorMessage( m_msg );
+            drcItem->SetErrorMessage( msg );
             drcItem->SetItems( track, aItem );
 
             wxPoint     pos = GetLocation( track, minSeg.get() );
             MARKER_PCB* marker = new MARKER_PCB( drcItem, pos );
-            addMarkerToPcb( aCommit, marker );
+            addMarker( aMarkers, marker );
         }
     }
 
@@ -1067,7 +1885,7 @@ void DRC::testCopperDrawItem( BOARD_COMMIT& aCommit, BOARD_ITEM* aItem )
         if( drawItem && pad->GetParent() == drawItem->GetParent() )
             continue;
 
-        int minClearance = pad->GetClearance( aItem, &m_clearanceSource );
+        int minClearance = pad->GetClearance( aItem, &clearanceSource );
         int widths = itemWidth / 2;
         int center2centerAllowed = minClearance + widths;
 
@@ -1101,28 +1919,33 @@ void DRC::testCopperDrawItem( BOARD_COMMIT& aCommit, BOARD_ITEM* aItem )
             int       actual = std::max( 0.0, sqrt( center2center_squared ) - widths );
             DRC_ITEM* drcItem = new DRC_ITEM( DRCE_PAD_NEAR_COPPER );
 
-            m_msg.Printf( drcItem->GetErrorText() + _( " (%s clearance %s; actual %s)" ),
-                          m_clearanceSource,
-                          MessageTextFromValue( userUnits(), minClearance, true ),
-                          MessageTextFromValue( userUnits(), actual, true ) );
+            msg.Printf( drcItem->GetErrorText() + _( " (%s clearance %s; actual %s)" ),
+                        clearanceSource,
+                        MessageTextFromValue( userUnits(), minClearance, true ),
+                        MessageTextFromValue( userUnits(), actual, true ) );
 
-            drcItem->SetErrorMessage( m_msg );
+            drcItem->SetErrorMessage( msg );
             drcItem->SetItems( pad, aItem );
 
             MARKER_PCB* marker = new MARKER_PCB( drcItem, pad->GetPosition() );
-            addMarkerToPcb( aCommit, marker );
+            addMarker( aMarkers, marker );
         }
     }
 }
 
 
-void DRC::testOutline( BOARD_COMMIT& aCommit )
+void DRC::testOutline( std::vector<MARKER_PCB*>& aMarkers )
 {
+    wxString msg;
+
     wxPoint error_loc( m_pcb->GetBoardEdgesBoundingBox().GetPosition() );
 
     m_board_outlines.RemoveAllContours();
     m_board_outline_valid = false;
 
+    // The outline of the edited board is now up to date for TestChangedItems()
+    m_outlineStale = ( m_pcb != m_listenedBoard );
+
     if( m_pcb->GetBoardPolygonOutlines( m_board_outlines, nullptr, &error_loc ) )
     {
         m_board_outline_valid = true;
@@ -1131,20 +1954,22 @@ void DRC::testOutline( BOARD_COMMIT& aCommit )
     {
         DRC_ITEM* drcItem = new DRC_ITEM( DRCE_INVALID_OUTLINE );
 
-        m_msg.Printf( drcItem->GetErrorText() + _( " (not a closed shape)" ) );
+        msg.Printf( drcItem->GetErrorText() + _( " (not a closed shape)" ) );
 
-        drcItem->SetErrorMessage( m_msg );
+        drcItem->SetErrorMessage( msg );
         drcItem->SetItems( m_pcb );
 
         MARKER_PCB* marker = new MARKER_PCB( drcItem, error_loc );
-        addMarkerToPcb( aCommit, marker );
+        addMarker( aMarkers, marker );
     }
 }
 
 
-void DRC::testDisabledLayers( BOARD_COMMIT& aCommit )
+void DRC::testDisabledLayers( std::vector<MARKER_PCB*>& aMarkers )
 {
-    BOARD*   board = m_editFrame->GetBoard();
+    wxString msg;
+
+    BOARD*   board = m_pcb;
     wxCHECK( board, /*void*/ );
 
     LSET     disabledLayers = board->GetEnabledLayers().flip();
@@ -1158,14 +1983,14 @@ void DRC::testDisabledLayers( BOARD_COMMIT& aCommit )
         {
             DRC_ITEM* drcItem = new DRC_ITEM( DRCE_DISABLED_LAYER_ITEM );
 
-            m_msg.Printf( drcItem->GetErrorText() + _( "layer %s" ),
-                          track->GetLayerName() );
+            msg.Printf( drcItem->GetErrorText() + _( "layer %s" ),
+                        track->GetLayerName() );
 
-            drcItem->SetErrorMessage( m_msg );
+            drcItem->SetErrorMessage( msg );
             drcItem->SetItems( track );
 
             MARKER_PCB* marker = new MARKER_PCB( drcItem, track->GetPosition() );
-            addMarkerToPcb( aCommit, marker );
+            addMarker( aMarkers, marker );
         }
     }
 
@@ -1178,14 +2003,14 @@ void DRC::testDisabledLayers( BOARD_COMMIT& aCommit )
                         {
                             DRC_ITEM* drcItem = new DRC_ITEM( DRCE_DISABLED_LAYER_ITEM );
 
-                            m_msg.Printf( drcItem->GetErrorText() + _( "layer %s" ),
-                                          child->GetLayerName() );
+                            msg.Printf( drcItem->GetErrorText() + _( "layer %s" ),
+                                        child->GetLayerName() );
 
-                            drcItem->SetErrorMessage( m_msg );
+                            drcItem->SetErrorMessage( msg );
                             drcItem->SetItems( child );
 
                             MARKER_PCB* marker = new MARKER_PCB( drcItem, child->GetPosition() );
-                            addMarkerToPcb( aCommit, marker );
+                            addMarker( aMarkers, marker );
                         }
                     } );
     }
@@ -1196,22 +2021,25 @@ void DRC::testDisabledLayers( BOARD_COMMIT& aCommit )
         {
             DRC_ITEM* drcItem = new DRC_ITEM( DRCE_DISABLED_LAYER_ITEM );
 
-            m_msg.Printf( drcItem->GetErrorText() + _( "layer %s" ),
-                          zone->GetLayerName() );
+            msg.Printf( drcItem->GetErrorText() + _( "layer %s" ),
+                        zone->GetLayerName() );
 
-            drcItem->SetErrorMessage( m_msg );
+            drcItem->SetErrorMessage( msg );
             drcItem->SetItems( zone );
 
             MARKER_PCB* marker = new MARKER_PCB( drcItem, zone->GetPosition() );
-            addMarkerToPcb( aCommit, marker );
+            addMarker( aMarkers, marker );
         }
     }
 }
 
 
-bool DRC::doPadToPadsDrc( BOARD_COMMIT& aCommit, D_PAD* aRefPad, D_PAD** aStart, D_PAD** aEnd,
-                          int x_limit )
+bool DRC::doPadToPadsDrc( std::vector<MARKER_PCB*>& aMarkers, D_PAD* aRefPad,
+                          const std::vector<D_PAD*>& aCandidates )
 {
+    wxString msg;
+    wxString clearanceSource;
+
     const static LSET all_cu = LSET::AllCuMask();
     constexpr int TOLERANCE = 1;    // 1nm tolerance for rotated pad rounding errors.
 
@@ -1229,18 +2057,11 @@ bool DRC::doPadToPadsDrc( BOARD_COMMIT& aCommit, D_PAD* aRefPad, D_PAD** aStart,
     // Ensure the hole is on all copper layers
     dummypad.SetLayerSet( all_cu | dummypad.GetLayerSet() );
 
-    for( D_PAD** pad_list = aStart;  pad_list<aEnd;  ++pad_list )
+    for( D_PAD* pad : aCandidates )
     {
-        D_PAD* pad = *pad_list;
-
         if( pad == aRefPad )
             continue;
 
-        // We can stop the test when pad->GetPosition().x > x_limit
-        // because the list is sorted by X values
-        if( pad->GetPosition().x > x_limit )
-            break;
-
         // No problem if pads which are on copper layers are on different copper layers,
         // (pads can be only on a technical layer, to build complex pads)
         // but their hole (if any ) can create DRC error because they are on all
@@ -1275,23 +2096,23 @@ bool DRC::doPadToPadsDrc( BOARD_COMMIT& aCommit, D_PAD* aRefPad, D_PAD** aStart,
                                                            PAD_SHAPE_OVAL : PAD_SHAPE_CIRCLE );
                 dummypad.SetOrientation( pad->GetOrientation() );
 
-                int minClearance = aRefPad->GetClearance( nullptr, &m_clearanceSource );
+                int minClearance = aRefPad->GetClearance( nullptr, &clearanceSource );
                 int actual;
 
                 if( !checkClearancePadToPad( aRefPad, &dummypad, minClearance, &actual ) )
                 {
                     DRC_ITEM* drcItem = new DRC_ITEM( DRCE_HOLE_NEAR_PAD );
 
-                    m_msg.Printf( drcItem->GetErrorText() + _( " (%s clearance %s; actual %s)" ),
-                                  m_clearanceSource,
-                                  MessageTextFromValue( userUnits(), minClearance, true ),
-                                  MessageTextFromValue( userUnits(), actual, true ) );
+                    msg.Printf( drcItem->GetErrorText() + _( " (%s clearance %s; actual %s)" ),
+                                clearanceSource,
+                                MessageTextFromValue( userUnits(), minClearance, true ),
+                                MessageTextFromValue( userUnits(), actual, true ) );
 
-                    drcItem->SetErrorMessage( m_msg );
+                    drcItem->SetErrorMessage( msg );
                     drcItem->SetItems( pad, aRefPad );
 
                     MARKER_PCB* marker = new MARKER_PCB( drcItem, pad->GetPosition() );
-                    addMarkerToPcb( aCommit, marker );
+                    addMarker( aMarkers, marker );
                     return false;
                 }
             }
@@ -1304,23 +2125,23 @@ bool DRC::doPadToPadsDrc( BOARD_COMMIT& aCommit, D_PAD* aRefPad, D_PAD** aStart,
                                                                PAD_SHAPE_OVAL : PAD_SHAPE_CIRCLE );
                 dummypad.SetOrientation( aRefPad->GetOrientation() );
 
-                int minClearance = pad->GetClearance( nullptr, &m_clearanceSource );
+                int minClearance = pad->GetClearance( nullptr, &clearanceSource );
                 int actual;
 
                 if( !checkClearancePadToPad( pad, &dummypad, minClearance, &actual ) )
                 {
                     DRC_ITEM* drcItem = new DRC_ITEM( DRCE_HOLE_NEAR_PAD );
 
-                    m_msg.Printf( drcItem->GetErrorText() + _( " (%s clearance %s; actual %s)" ),
-                                  m_clearanceSource,
-                                  MessageTextFromValue( userUnits(), minClearance, true ),
-                                  MessageTextFromValue( userUnits(), actual, true ) );
+                    msg.Printf( drcItem->GetErrorText() + _( " (%s clearance %s; actual %s)" ),
+                                clearanceSource,
+                                MessageTextFromValue( userUnits(), minClearance, true ),
+                                MessageTextFromValue( userUnits(), actual, true ) );
 
-                    drcItem->SetErrorMessage( m_msg );
+                    drcItem->SetErrorMessage( msg );
                     drcItem->SetItems( aRefPad, pad );
 
                     MARKER_PCB* marker = new MARKER_PCB( drcItem, aRefPad->GetPosition() );
-                    addMarkerToPcb( aCommit, marker );
+                    addMarker( aMarkers, marker );
                     return false;
                 }
             }
@@ -1352,25 +2173,33 @@ bool DRC::doPadToPadsDrc( BOARD_COMMIT& aCommit, D_PAD* aRefPad, D_PAD** aStart,
             continue;
         }
 
-        int  minClearance = aRefPad->GetClearance( pad, &m_clearanceSource ) - TOLERANCE;
-        int  actual;
+        int    minClearance = aRefPad->GetClearance( pad, &clearanceSource ) - TOLERANCE;
+        int    actual;
+        size_t pairKey = DRC_PAIR_CACHE::PairKey( itemHash( aRefPad ), itemHash( pad ),
+                                                  minClearance );
+
+        // Unchanged since the last run, which found it clean
+        if( m_padPairCache.IsClean( pairKey ) )
+            continue;
 
         if( !checkClearancePadToPad( aRefPad, pad, minClearance, &actual ) )
         {
             DRC_ITEM* drcItem = new DRC_ITEM( DRCE_PAD_NEAR_PAD );
 
-            m_msg.Printf( drcItem->GetErrorText() + _( " (%s clearance %s; actual %s)" ),
-                          m_clearanceSource,
-                          MessageTextFromValue( userUnits(), minClearance, true ),
-                          MessageTextFromValue( userUnits(), actual, true ) );
+            msg.Printf( drcItem->GetErrorText() + _( " (%s clearance %s; actual %s)" ),
+                        clearanceSource,
+                        MessageTextFromValue( userUnits(), minClearance, true ),
+                        MessageTextFromValue( userUnits(), actual, true ) );
 
-            drcItem->SetErrorMessage( m_msg );
+            drcItem->SetErrorMessage( msg );
             drcItem->SetItems( aRefPad, pad );
 
             MARKER_PCB* marker = new MARKER_PCB( drcItem, aRefPad->GetPosition() );
-            addMarkerToPcb( aCommit, marker );
+            addMarker( aMarkers, marker );
             return false;
         }
+
+        m_padPairCache.SetClean( pairKey );
     }
 
     return true;
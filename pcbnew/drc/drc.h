@@ -29,9 +29,15 @@
 #include <class_board.h>
 #include <class_track.h>
 #include <class_marker_pcb.h>
+#include <drc/drc_pair_cache.h>
+#include <drc/drc_rtree.h>
 #include <geometry/seg.h>
 #include <geometry/shape_poly_set.h>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include <tools/pcb_tool_base.h>
 
@@ -125,6 +131,7 @@ class DIALOG_DRC;
 class BOARD_ITEM;
 class BOARD;
 class D_PAD;
+class MODULE;
 class ZONE_CONTAINER;
 class TRACK;
 class MARKER_PCB;
@@ -136,6 +143,25 @@ class NETLIST;
 class wxWindow;
 class wxString;
 class wxTextCtrl;
+class DRC_REPORT_SINK;
+class PROGRESS_REPORTER;
+
+namespace KIGFX
+{
+class WS_PROXY_VIEW_ITEM;
+}
+
+
+/**
+ * A single DRC test which only reads the board, and can therefore run concurrently with
+ * the other tests of a DRC run.  Each task collects its markers into its own list.
+ */
+struct DRC_TEST_TASK
+{
+    wxString                                          m_Name;
+    std::function<void( std::vector<MARKER_PCB*>& )>  m_Test;
+    std::vector<MARKER_PCB*>                          m_Markers;
+};
 
 
 /**
@@ -146,7 +172,7 @@ class wxTextCtrl;
  * This class is given access to the windows and the BOARD
  * that it needs via its constructor or public access functions.
  */
-class DRC : public PCB_TOOL_BASE
+class DRC : public PCB_TOOL_BASE, public BOARD_LISTENER
 {
     friend class DIALOG_DRC;
 
@@ -157,6 +183,11 @@ public:
     /// @copydoc TOOL_INTERACTIVE::Reset()
     void Reset( RESET_REASON aReason ) override;
 
+    void OnBoardItemAdded( BOARD& aBoard, BOARD_ITEM* aBoardItem ) override;
+    void OnBoardItemRemoved( BOARD& aBoard, BOARD_ITEM* aBoardItem ) override;
+    void OnBoardItemChanged( BOARD& aBoard, BOARD_ITEM* aBoardItem ) override;
+    void OnBoardDestroyed( BOARD& aBoard ) override;
+
 private:
     bool     m_doUnconnectedTest;       // enable unconnected tests
     bool     m_testTracksAgainstZones;  // enable zone to items clearance tests
@@ -180,13 +211,38 @@ private:
     std::vector<DRC_RULE*>     m_rules;
 
     // Temp variables for performance during a single DRC run
-    //
-    // wxString's c'tor is surprisingly expensive, and in the world of DRC everything matters
-    //
-    wxString                   m_msg;
-    wxString                   m_clearanceSource;
     int                        m_largestClearance;
 
+    // Broad-phase spatial indices, rebuilt at the start of each DRC run.  The incremental DRC
+    // then updates them for the items changed since (see updateSpatialIndices()).
+    std::vector<D_PAD*>        m_sortedPads;       // pads in m_padIndex order, as last rebuilt
+    DRC_RTREE                  m_padIndex;
+    DRC_RTREE                  m_trackIndex;       // tracks and vias
+    std::unordered_map<const BOARD_CONNECTED_ITEM*, size_t> m_itemHashes;
+    int                        m_indexInflate;     // the clearance the boxes are inflated by
+
+    // Changes of the edited board, as reported by the board listener
+    BOARD*                     m_listenedBoard;
+    bool                       m_indicesValid;     // false when they must be rebuilt
+    bool                       m_outlineStale;     // an item of the outline has changed
+    std::unordered_set<TRACK*> m_staleTracks;      // added or changed since indexed
+    std::unordered_set<MODULE*> m_staleModules;    // whose pads must be indexed again
+    std::unordered_map<const BOARD_ITEM*, std::vector<D_PAD*>> m_indexedPads;  // by footprint
+
+    // Pairs found clean by the previous runs.  The pad and the track tests run concurrently,
+    // so each has its own cache.
+    DRC_PAIR_CACHE             m_padPairCache;     // pad to pad
+    DRC_PAIR_CACHE             m_trackPadCache;    // track to pad
+
+    // Headless runs report the violations to a sink instead of creating markers
+    DRC_REPORT_SINK*           m_reportSink;
+    std::mutex                 m_reportMutex;      // serializes the calls to m_reportSink
+    size_t                     m_reportCount;
+    int                        m_threadCount;      // 1 to run the tests serially
+
+    // The progress dialog of the tests, whose cancel button stops them early; null if none
+    PROGRESS_REPORTER*         m_progressReporter;
+
 private:
     ///> Sets up handlers for various events.
     void setTransitions() override;
@@ -196,72 +252,162 @@ private:
      */
     void updatePointers();
 
-    EDA_UNITS userUnits() const { return m_editFrame->GetUserUnits(); }
+    EDA_UNITS userUnits() const
+    {
+        return m_editFrame ? m_editFrame->GetUserUnits() : EDA_UNITS::MILLIMETRES;
+    }
+
+    /**
+     * Run aFunc( ii ) for each ii in [0, aCount) on the thread pool, or one after the other
+     * on the calling thread for a serial run.  The remaining items are skipped once the
+     * tests are cancelled.
+     */
+    void parallelFor( size_t aCount, const std::function<void( size_t )>& aFunc ) const;
+
+    /**
+     * @return true if the user cancelled the tests.  Cheap enough to be polled by the tests
+     *         for each item, from any thread.
+     */
+    bool isCancelled() const;
+
+    /**
+     * The tests shared by RunTests() and RunHeadless().
+     *
+     * @param aCommit receives the markers, or is null when reporting to m_reportSink
+     * @param aMessages is an optional text control for progress messages
+     * @param aCaller is the parent window of the progress dialogs, or null for none
+     * @param aWorksheet is the drawing sheet whose text variables are tested, if any
+     * @return false if the DRC was aborted because of netclass violations
+     */
+    bool runBoardTests( BOARD_COMMIT* aCommit, wxTextCtrl* aMessages, wxWindow* aCaller,
+                        KIGFX::WS_PROXY_VIEW_ITEM* aWorksheet );
+
+    /**
+     * Passes a marker's violation to m_reportSink and deletes the marker.
+     */
+    void reportMarker( MARKER_PCB* aMarker );
+
+    /**
+     * Parses the custom rules file (if it exists) into the board's design settings.
+     *
+     * @throw PARSE_ERROR if the rules cannot be parsed
+     */
+    void loadRules( const wxString& aRulesFilepath );
 
     /**
      * Adds a DRC marker to the PCB through the COMMIT mechanism.
      */
     void addMarkerToPcb( BOARD_COMMIT& aCommit, MARKER_PCB* aMarker );
 
+    /**
+     * Adds a DRC marker to the list of markers collected by a single test task.  Markers
+     * for ignored error codes are deleted right away.
+     *
+     * The test tasks of a DRC run can execute concurrently, so each one collects into its
+     * own list; the lists are merged into the BOARD_COMMIT once all tasks have finished.
+     */
+    void addMarker( std::vector<MARKER_PCB*>& aMarkers, MARKER_PCB* aMarker );
+
+    /**
+     * Build the spatial indices of pads and tracks used as the broad phase of the clearance
+     * tests.  Items are indexed on each copper layer they occupy (drilled pads on all copper
+     * layers), with their bounding boxes inflated by the largest clearance on the board.
+     */
+    void buildSpatialIndices();
+
+    /**
+     * Bring the spatial indices up to date with the changes reported by the board listener
+     * since they were built.  Only the changed items are indexed again, unless the indices
+     * cannot follow the changes (no listened board, or a clearance larger than the indexed
+     * boxes allow for), in which case they are rebuilt.
+     */
+    void updateSpatialIndices();
+
+    void indexItem( BOARD_CONNECTED_ITEM* aItem );
+
+    void unindexPads( const BOARD_ITEM* aFootprint );
+
+    /**
+     * Follow the changes of aBoard, whose listener the DRC becomes.
+     */
+    void setListenedBoard( BOARD* aBoard );
+
+    /**
+     * Records an item added to, changed on, or (if !aOnBoard) removed from the listened
+     * board, for updateSpatialIndices().
+     */
+    void boardItemChanged( BOARD_ITEM* aItem, bool aOnBoard );
+
+    /**
+     * Returns the DRC_PAIR_CACHE::ItemHash() of an item of the spatial indices, or 0 (not
+     * cacheable) for other items.
+     */
+    size_t itemHash( const BOARD_CONNECTED_ITEM* aItem ) const
+    {
+        auto it = m_itemHashes.find( aItem );
+        return it == m_itemHashes.end() ? 0 : it->second;
+    }
+
     //-----<categorical group tests>-----------------------------------------
 
     /**
      * Perform the DRC on all tracks.
-     *
-     * This test can take a while, a progress bar can be displayed
-     * @param aActiveWindow = the active window ued as parent for the progress bar
-     * @param aShowProgressBar = true to show a progress bar
-     * (Note: it is shown only if there are many tracks)
      */
-    void testTracks( BOARD_COMMIT& aCommit, wxWindow * aActiveWindow, bool aShowProgressBar );
+    void testTracks( std::vector<MARKER_PCB*>& aMarkers );
 
-    void testPadClearances( BOARD_COMMIT& aCommit );
+    void testPadClearances( std::vector<MARKER_PCB*>& aMarkers );
+
+    /**
+     * Test for tracks and vias with an unconnected end.  The connectivity must be up to date.
+     */
+    void testTrackDangling( std::vector<MARKER_PCB*>& aMarkers, TRACK* aTrack );
 
     void testUnconnected();
 
-    void testZones( BOARD_COMMIT& aCommit );
+    void testZones( std::vector<MARKER_PCB*>& aMarkers );
 
-    void testCopperDrawItem( BOARD_COMMIT& aCommit, BOARD_ITEM* aDrawing );
+    void testCopperDrawItem( std::vector<MARKER_PCB*>& aMarkers, BOARD_ITEM* aDrawing );
 
-    void testCopperTextAndGraphics( BOARD_COMMIT& aCommit );
+    void testCopperTextAndGraphics( std::vector<MARKER_PCB*>& aMarkers );
 
     // Tests for items placed on disabled layers (causing false connections).
-    void testDisabledLayers( BOARD_COMMIT& aCommit );
+    void testDisabledLayers( std::vector<MARKER_PCB*>& aMarkers );
 
     /**
      * Test that the board outline is contiguous and composed of valid elements
      */
-    void testOutline( BOARD_COMMIT& aCommit );
+    void testOutline( std::vector<MARKER_PCB*>& aMarkers );
 
     //-----<single "item" tests>-----------------------------------------
 
+    /**
+     * Test the clearance between aPad and the board edge, and between aPad and the pads
+     * accepted by aIsCandidate among those found by the broad phase.
+     */
+    void doPadDrc( std::vector<MARKER_PCB*>& aMarkers, D_PAD* aPad,
+                   const std::function<bool( const DRC_RTREE::ITEM& )>& aIsCandidate );
+
     /**
      * Test the clearance between aRefPad and other pads.
      *
-     * The pad list must be sorted by x coordinate.
-     *
      * @param aRefPad is the pad to test
-     * @param aStart is the first pad of the list to test against aRefPad
-     * @param aEnd is the end of the list and is not included
-     * @param x_limit is used to stop the test
-     * (i.e. when the current pad pos X in list exceeds this limit, because the list
-     * is sorted by X coordinate)
+     * @param aCandidates are the pads to test against aRefPad, as found by the broad phase
+     * @return true if no problems, else false (only the first problem is reported)
      */
-    bool doPadToPadsDrc( BOARD_COMMIT& aCommit, D_PAD* aRefPad, D_PAD** aStart, D_PAD** aEnd,
-                         int x_limit );
+    bool doPadToPadsDrc( std::vector<MARKER_PCB*>& aMarkers, D_PAD* aRefPad,
+                         const std::vector<D_PAD*>& aCandidates );
 
     /**
      * Test the current segment.
      *
      * @param aRefSeg The segment to test
-     * @param aStartIt the iterator to the first track to test
-     * @param aEndIt the marker for the iterator end
+     * @param aIsCandidate selects the tracks of m_trackIndex to test against aRefSeg, so that
+     *                     each pair of tracks is tested once
      * @param aTestZones true if should do copper zones test. This can be very time consumming
-     * @return bool - true if no problems, else false and m_currentMarker is
-     *          filled in with the problem information.
      */
-    void doTrackDrc( BOARD_COMMIT& aCommit, TRACK* aRefSeg, TRACKS::iterator aStartIt,
-                     TRACKS::iterator aEndIt, bool aTestZones );
+    void doTrackDrc( std::vector<MARKER_PCB*>& aMarkers, TRACK* aRefSeg,
+                     const std::function<bool( const DRC_RTREE::ITEM& )>& aIsCandidate,
+                     bool aTestZones );
 
     //-----<single tests>----------------------------------------------
 
@@ -342,9 +488,53 @@ public:
     /**
      * Run all the tests specified with a previous call to
      * SetSettings()
+     *
+     * Tests which modify the board (zone fills, connectivity) run first; the read-only tests
+     * then run concurrently on the thread pool, without yielding to the event loop.
+     *
      * @param aMessages = a wxTextControl where to display some activity messages. Can be NULL
      */
     void RunTests( wxTextCtrl* aMessages = NULL );
+
+    /**
+     * Run the DRC on a board without a PCB editor frame, for batch use.  Violations are
+     * passed to aSink as they are found instead of being added to the board as markers, so
+     * they come in no particular order.  Zones are tested as they are filled on the board,
+     * and footprints are not tested against the schematic.
+     *
+     * @param aBoard is the board to test
+     * @param aSink receives the violations
+     * @param aThreadCount is 1 to run the tests one after the other on the calling thread;
+     *                     otherwise they run concurrently on the thread pool
+     * @param aRulesFilepath is the custom rules file to use, if any
+     * @return the number of violations reported
+     * @throw PARSE_ERROR if the rules file cannot be parsed
+     */
+    size_t RunHeadless( BOARD* aBoard, DRC_REPORT_SINK& aSink, int aThreadCount = 0,
+                        const wxString& aRulesFilepath = wxEmptyString );
+
+    /**
+     * Returns the number of pad to pad and track to pad pairs the last run had to test,
+     * i.e. which were not known clean from the previous runs.
+     */
+    size_t GetPairCacheMisses() const
+    {
+        return m_padPairCache.GetMisses() + m_trackPadCache.GetMisses();
+    }
+
+    /**
+     * Incremental DRC: re-run the item tests (clearances, via and track sizes, dangling ends)
+     * for the items changed by a BOARD_COMMIT, and for the tracks near changed pads.  The
+     * markers involving those items, or the removed items, are replaced by the results of
+     * the new tests; the rest of the board is not re-tested.
+     *
+     * Does nothing unless incremental DRC is enabled in the DRC settings.
+     *
+     * @param aChangedItems are the items added or modified by the commit
+     * @param aRemovedItems are the UUIDs of the items (and their children) removed by the commit
+     */
+    void TestChangedItems( const std::vector<BOARD_ITEM*>& aChangedItems,
+                           const std::vector<KIID>& aRemovedItems );
 };
 
 
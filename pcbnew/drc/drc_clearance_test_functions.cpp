@@ -136,9 +136,13 @@ bool poly2segmentDRC( wxPoint* aTref, int aTrefCount, wxPoint aSegStart, wxPoint
 }
 
 
-void DRC::doTrackDrc( BOARD_COMMIT& aCommit, TRACK* aRefSeg, TRACKS::iterator aStartIt,
-                      TRACKS::iterator aEndIt, bool aTestZones )
+void DRC::doTrackDrc( std::vector<MARKER_PCB*>& aMarkers, TRACK* aRefSeg,
+                      const std::function<bool( const DRC_RTREE::ITEM& )>& aIsCandidate,
+                      bool aTestZones )
 {
+    wxString msg;
+    wxString clearanceSource;
+
     BOARD_DESIGN_SETTINGS&     bds = m_pcb->GetDesignSettings();
 
     SEG          refSeg( aRefSeg->GetStart(), aRefSeg->GetEnd() );
@@ -158,7 +162,7 @@ void DRC::doTrackDrc( BOARD_COMMIT& aCommit, TRACK* aRefSeg, TRACKS::iterator aS
     {
         VIA *refvia = static_cast<VIA*>( aRefSeg );
         int viaAnnulus = ( refvia->GetWidth() - refvia->GetDrill() ) / 2;
-        int minAnnulus = refvia->GetMinAnnulus( &m_clearanceSource );
+        int minAnnulus = refvia->GetMinAnnulus( &clearanceSource );
 
         // test if the via size is smaller than minimum
         if( refvia->GetViaType() == VIATYPE::MICROVIA )
@@ -167,31 +171,31 @@ void DRC::doTrackDrc( BOARD_COMMIT& aCommit, TRACK* aRefSeg, TRACKS::iterator aS
             {
                 DRC_ITEM* drcItem = new DRC_ITEM( DRCE_TOO_SMALL_VIA_ANNULUS );
 
-                m_msg.Printf( drcItem->GetErrorText() + _( " (%s %s; actual %s)" ),
-                              m_clearanceSource,
-                              MessageTextFromValue( userUnits(), minAnnulus, true ),
-                              MessageTextFromValue( userUnits(), viaAnnulus, true ) );
+                msg.Printf( drcItem->GetErrorText() + _( " (%s %s; actual %s)" ),
+                            clearanceSource,
+                            MessageTextFromValue( userUnits(), minAnnulus, true ),
+                            MessageTextFromValue( userUnits(), viaAnnulus, true ) );
 
-                drcItem->SetErrorMessage( m_msg );
+                drcItem->SetErrorMessage( msg );
                 drcItem->SetItems( refvia );
 
                 MARKER_PCB* marker = new MARKER_PCB( drcItem, refvia->GetPosition() );
-                addMarkerToPcb( aCommit, marker );
+                addMarker( aMarkers, marker );
             }
 
             if( refvia->GetWidth() < bds.m_MicroViasMinSize )
             {
                 DRC_ITEM* drcItem = new DRC_ITEM( DRCE_TOO_SMALL_MICROVIA );
 
-                m_msg.Printf( drcItem->GetErrorText() + _( " (board minimum %s; actual %s)" ),
-                              MessageTextFromValue( userUnits(), bds.m_MicroViasMinSize, true ),
-                              MessageTextFromValue( userUnits(), refvia->GetWidth(), true ) );
+                msg.Printf( drcItem->GetErrorText() + _( " (board minimum %s; actual %s)" ),
+                            MessageTextFromValue( userUnits(), bds.m_MicroViasMinSize, true ),
+                            MessageTextFromValue( userUnits(), refvia->GetWidth(), true ) );
 
-                drcItem->SetErrorMessage( m_msg );
+                drcItem->SetErrorMessage( msg );
                 drcItem->SetItems( refvia );
 
                 MARKER_PCB* marker = new MARKER_PCB( drcItem, refvia->GetPosition() );
-                addMarkerToPcb( aCommit, marker );
+                addMarker( aMarkers, marker );
             }
         }
         else
@@ -199,38 +203,38 @@ void DRC::doTrackDrc( BOARD_COMMIT& aCommit, TRACK* aRefSeg, TRACKS::iterator aS
             if( bds.m_ViasMinAnnulus > minAnnulus )
             {
                 minAnnulus = bds.m_ViasMinAnnulus;
-                m_clearanceSource = _( "board minimum" );
+                clearanceSource = _( "board minimum" );
             }
 
             if( viaAnnulus < minAnnulus )
             {
                 DRC_ITEM* drcItem = new DRC_ITEM( DRCE_TOO_SMALL_VIA_ANNULUS );
 
-                m_msg.Printf( drcItem->GetErrorText() + _( " (%s %s; actual %s)" ),
-                              m_clearanceSource,
-                              MessageTextFromValue( userUnits(), minAnnulus, true ),
-                              MessageTextFromValue( userUnits(), viaAnnulus, true ) );
+                msg.Printf( drcItem->GetErrorText() + _( " (%s %s; actual %s)" ),
+                            clearanceSource,
+                            MessageTextFromValue( userUnits(), minAnnulus, true ),
+                            MessageTextFromValue( userUnits(), viaAnnulus, true ) );
 
-                drcItem->SetErrorMessage( m_msg );
+                drcItem->SetErrorMessage( msg );
                 drcItem->SetItems( refvia );
 
                 MARKER_PCB* marker = new MARKER_PCB( drcItem, refvia->GetPosition() );
-                addMarkerToPcb( aCommit, marker );
+                addMarker( aMarkers, marker );
             }
 
             if( refvia->GetWidth() < bds.m_ViasMinSize )
             {
                 DRC_ITEM* drcItem = new DRC_ITEM( DRCE_TOO_SMALL_VIA );
 
-                m_msg.Printf( drcItem->GetErrorText() + _( " (board minimum %s; actual %s)" ),
-                              MessageTextFromValue( userUnits(), bds.m_ViasMinSize, true ),
-                              MessageTextFromValue( userUnits(), refvia->GetWidth(), true ) );
+                msg.Printf( drcItem->GetErrorText() + _( " (board minimum %s; actual %s)" ),
+                            MessageTextFromValue( userUnits(), bds.m_ViasMinSize, true ),
+                            MessageTextFromValue( userUnits(), refvia->GetWidth(), true ) );
 
-                drcItem->SetErrorMessage( m_msg );
+                drcItem->SetErrorMessage( msg );
                 drcItem->SetItems( refvia );
 
                 MARKER_PCB* marker = new MARKER_PCB( drcItem, refvia->GetPosition() );
-                addMarkerToPcb( aCommit, marker );
+                addMarker( aMarkers, marker );
             }
         }
 
@@ -241,15 +245,15 @@ void DRC::doTrackDrc( BOARD_COMMIT& aCommit, TRACK* aRefSeg, TRACKS::iterator aS
         {
             DRC_ITEM* drcItem = new DRC_ITEM( DRCE_VIA_HOLE_BIGGER );
 
-            m_msg.Printf( drcItem->GetErrorText() + _( " (diameter %s; drill %s)" ),
-                          MessageTextFromValue( userUnits(), refvia->GetWidth(), true ),
-                          MessageTextFromValue( userUnits(), refvia->GetDrillValue(), true ) );
+            msg.Printf( drcItem->GetErrorText() + _( " (diameter %s; drill %s)" ),
+                        MessageTextFromValue( userUnits(), refvia->GetWidth(), true ),
+                        MessageTextFromValue( userUnits(), refvia->GetDrillValue(), true ) );
 
-            drcItem->SetErrorMessage( m_msg );
+            drcItem->SetErrorMessage( msg );
             drcItem->SetItems( refvia );
 
             MARKER_PCB* marker = new MARKER_PCB( drcItem, refvia->GetPosition() );
-            addMarkerToPcb( aCommit, marker );
+            addMarker( aMarkers, marker );
         }
 
         // test if the type of via is allowed due to design rules
@@ -257,12 +261,12 @@ void DRC::doTrackDrc( BOARD_COMMIT& aCommit, TRACK* aRefSeg, TRACKS::iterator aS
         {
             DRC_ITEM* drcItem = new DRC_ITEM( DRCE_MICROVIA_NOT_ALLOWED );
 
-            m_msg.Printf( drcItem->GetErrorText() + _( " (board design rule constraints)" ) );
-            drcItem->SetErrorMessage( m_msg );
+            msg.Printf( drcItem->GetErrorText() + _( " (board design rule constraints)" ) );
+            drcItem->SetErrorMessage( msg );
             drcItem->SetItems( refvia );
 
             MARKER_PCB* marker = new MARKER_PCB( drcItem, refvia->GetPosition() );
-            addMarkerToPcb( aCommit, marker );
+            addMarker( aMarkers, marker );
         }
 
         // test if the type of via is allowed due to design rules
@@ -270,12 +274,12 @@ void DRC::doTrackDrc( BOARD_COMMIT& aCommit, TRACK* aRefSeg, TRACKS::iterator aS
         {
             DRC_ITEM* drcItem = new DRC_ITEM( DRCE_BURIED_VIA_NOT_ALLOWED );
 
-            m_msg.Printf( drcItem->GetErrorText() + _( " (board design rule constraints)" ) );
-            drcItem->SetErrorMessage( m_msg );
+            msg.Printf( drcItem->GetErrorText() + _( " (board design rule constraints)" ) );
+            drcItem->SetErrorMessage( msg );
             drcItem->SetItems( refvia );
 
             MARKER_PCB* marker = new MARKER_PCB( drcItem, refvia->GetPosition() );
-            addMarkerToPcb( aCommit, marker );
+            addMarker( aMarkers, marker );
         }
 
         // For microvias: test if they are blind vias and only between 2 layers
@@ -300,15 +304,15 @@ void DRC::doTrackDrc( BOARD_COMMIT& aCommit, TRACK* aRefSeg, TRACKS::iterator aS
             {
                 DRC_ITEM* drcItem = new DRC_ITEM( DRCE_MICROVIA_TOO_MANY_LAYERS );
 
-                m_msg.Printf( drcItem->GetErrorText() + _( " (%s and %s not adjacent)" ),
-                              m_pcb->GetLayerName( layer1 ),
-                              m_pcb->GetLayerName( layer2 ) );
+                msg.Printf( drcItem->GetErrorText() + _( " (%s and %s not adjacent)" ),
+                            m_pcb->GetLayerName( layer1 ),
+                            m_pcb->GetLayerName( layer2 ) );
 
-                drcItem->SetErrorMessage( m_msg );
+                drcItem->SetErrorMessage( msg );
                 drcItem->SetItems( refvia );
 
                 MARKER_PCB* marker = new MARKER_PCB( drcItem, refvia->GetPosition() );
-                addMarkerToPcb( aCommit, marker );
+                addMarker( aMarkers, marker );
             }
         }
 
@@ -316,7 +320,7 @@ void DRC::doTrackDrc( BOARD_COMMIT& aCommit, TRACK* aRefSeg, TRACKS::iterator aS
     else    // This is a track segment
     {
         int minWidth, maxWidth;
-        aRefSeg->GetWidthConstraints( &minWidth, &maxWidth, &m_clearanceSource );
+        aRefSeg->GetWidthConstraints( &minWidth, &maxWidth, &clearanceSource );
 
         int errorCode = 0;
         int constraintWidth;
@@ -338,16 +342,16 @@ void DRC::doTrackDrc( BOARD_COMMIT& aCommit, TRACK* aRefSeg, TRACKS::iterator aS
 
             DRC_ITEM* drcItem = new DRC_ITEM( errorCode );
 
-            m_msg.Printf( drcItem->GetErrorText() + _( " (%s %s; actual %s)" ),
-                          m_clearanceSource,
-                          MessageTextFromValue( userUnits(), constraintWidth, true ),
-                          MessageTextFromValue( userUnits(), refSegWidth, true ) );
+            msg.Printf( drcItem->GetErrorText() + _( " (%s %s; actual %s)" ),
+                        clearanceSource,
+                        MessageTextFromValue( userUnits(), constraintWidth, true ),
+                        MessageTextFromValue( userUnits(), refSegWidth, true ) );
 
-            drcItem->SetErrorMessage( m_msg );
+            drcItem->SetErrorMessage( msg );
             drcItem->SetItems( aRefSeg );
 
             MARKER_PCB* marker = new MARKER_PCB( drcItem, refsegMiddle );
-            addMarkerToPcb( aCommit, marker );
+            addMarker( aMarkers, marker );
         }
     }
 
@@ -356,106 +360,139 @@ void DRC::doTrackDrc( BOARD_COMMIT& aCommit, TRACK* aRefSeg, TRACKS::iterator aS
     /* Phase 1 : test DRC track to pads :     */
     /******************************************/
 
-    // Compute the min distance to pads
-    for( MODULE* mod : m_pcb->Modules() )
-    {
-        // Don't preflight at the module level.  Getting a module's bounding box goes
-        // through all its pads anyway (so it's no faster), and also all its drawings
-        // (so it's in fact slower).
-
-        for( D_PAD* pad : mod->Pads() )
-        {
-            // Preflight based on bounding boxes.
-            EDA_RECT inflatedBB = refSegBB;
-            inflatedBB.Inflate( pad->GetBoundingRadius() + m_largestClearance );
-
-            if( !inflatedBB.Contains( pad->GetPosition() ) )
-                continue;
-
-            if( !( pad->GetLayerSet() & refLayerSet ).any() )
-                continue;
+    // Preflight based on bounding boxes: only pads whose inflated bounding boxes overlap the
+    // track are candidates.  They are visited in index order so that the reported errors
+    // don't depend on the R-tree layout.
+    auto indexOrder = []( const DRC_RTREE::ITEM& a, const DRC_RTREE::ITEM& b )
+                      {
+                          return a.m_index < b.m_index;
+                      };
 
-            // No need to check pads with the same net as the refSeg.
-            if( pad->GetNetCode() && aRefSeg->GetNetCode() == pad->GetNetCode() )
-                continue;
+    std::vector<DRC_RTREE::ITEM> candidates;
 
-            if( pad->GetDrillSize().x > 0 )
+    m_padIndex.QueryColliding( refSegBB, refLayerSet,
+            [&]( const DRC_RTREE::ITEM& aItem ) -> bool
             {
-                int minClearance = aRefSeg->GetClearance( nullptr, &m_clearanceSource );
+                candidates.push_back( aItem );
+                return true;
+            } );
 
-                /* Treat an oval hole as a line segment along the hole's major axis,
-                 * shortened by half its minor axis.
-                 * A circular hole is just a degenerate case of an oval hole.
-                 */
-                wxPoint slotStart, slotEnd;
-                int     slotWidth;
+    std::sort( candidates.begin(), candidates.end(), indexOrder );
 
-                pad->GetOblongGeometry( pad->GetDrillSize(), &slotStart, &slotEnd, &slotWidth );
-                slotStart += pad->GetPosition();
-                slotEnd += pad->GetPosition();
+    size_t refSegHash = itemHash( aRefSeg );
 
-                SEG     slotSeg( slotStart, slotEnd );
-                int     widths = ( slotWidth + refSegWidth ) / 2;
-                int     center2centerAllowed = minClearance + widths;
+    // Compute the min distance to pads
+    for( const DRC_RTREE::ITEM& candidate : candidates )
+    {
+        D_PAD* pad = static_cast<D_PAD*>( candidate.m_item );
 
-                // Avoid square-roots if possible (for performance)
-                SEG::ecoord center2center_squared = refSeg.SquaredDistance( slotSeg );
+        if( !( pad->GetLayerSet() & refLayerSet ).any() )
+            continue;
 
-                if( center2center_squared < SEG::Square( center2centerAllowed ) )
-                {
-                    int       actual = std::max( 0.0, sqrt( center2center_squared ) - widths );
-                    DRC_ITEM* drcItem = new DRC_ITEM( DRCE_TRACK_NEAR_HOLE );
+        // No need to check pads with the same net as the refSeg.
+        if( pad->GetNetCode() && aRefSeg->GetNetCode() == pad->GetNetCode() )
+            continue;
 
-                    m_msg.Printf( drcItem->GetErrorText() + _( " (%s clearance %s; actual %s)" ),
-                                  m_clearanceSource,
-                                  MessageTextFromValue( userUnits(), minClearance, true ),
-                                  MessageTextFromValue( userUnits(), actual, true ) );
+        if( pad->GetDrillSize().x > 0 )
+        {
+            int minClearance = aRefSeg->GetClearance( nullptr, &clearanceSource );
 
-                    drcItem->SetErrorMessage( m_msg );
-                    drcItem->SetItems( aRefSeg, pad );
+            /* Treat an oval hole as a line segment along the hole's major axis,
+             * shortened by half its minor axis.
+             * A circular hole is just a degenerate case of an oval hole.
+             */
+            wxPoint slotStart, slotEnd;
+            int     slotWidth;
 
-                    MARKER_PCB* marker = new MARKER_PCB( drcItem, GetLocation( aRefSeg, slotSeg ) );
-                    addMarkerToPcb( aCommit, marker );
+            pad->GetOblongGeometry( pad->GetDrillSize(), &slotStart, &slotEnd, &slotWidth );
+            slotStart += pad->GetPosition();
+            slotEnd += pad->GetPosition();
 
-                    if( !m_reportAllTrackErrors )
-                        return;
-                }
-            }
+            SEG     slotSeg( slotStart, slotEnd );
+            int     widths = ( slotWidth + refSegWidth ) / 2;
+            int     center2centerAllowed = minClearance + widths;
 
-            int minClearance = aRefSeg->GetClearance( pad, &m_clearanceSource );
-            int actual;
+            // Avoid square-roots if possible (for performance)
+            SEG::ecoord center2center_squared = refSeg.SquaredDistance( slotSeg );
 
-            if( !checkClearanceSegmToPad( refSeg, refSegWidth, pad, minClearance, &actual ) )
+            if( center2center_squared < SEG::Square( center2centerAllowed ) )
             {
-                actual = std::max( 0, actual );
-                SEG       padSeg( pad->GetPosition(), pad->GetPosition() );
-                DRC_ITEM* drcItem = new DRC_ITEM( DRCE_TRACK_NEAR_PAD );
+                int       actual = std::max( 0.0, sqrt( center2center_squared ) - widths );
+                DRC_ITEM* drcItem = new DRC_ITEM( DRCE_TRACK_NEAR_HOLE );
 
-                m_msg.Printf( drcItem->GetErrorText() + _( " (%s clearance %s; actual %s)" ),
-                              m_clearanceSource,
-                              MessageTextFromValue( userUnits(), minClearance, true ),
-                              MessageTextFromValue( userUnits(), actual, true ) );
+                msg.Printf( drcItem->GetErrorText() + _( " (%s clearance %s; actual %s)" ),
+                            clearanceSource,
+                            MessageTextFromValue( userUnits(), minClearance, true ),
+                            MessageTextFromValue( userUnits(), actual, true ) );
 
-                drcItem->SetErrorMessage( m_msg );
+                drcItem->SetErrorMessage( msg );
                 drcItem->SetItems( aRefSeg, pad );
 
-                MARKER_PCB* marker = new MARKER_PCB( drcItem, GetLocation( aRefSeg, padSeg ) );
-                addMarkerToPcb( aCommit, marker );
+                MARKER_PCB* marker = new MARKER_PCB( drcItem, GetLocation( aRefSeg, slotSeg ) );
+                addMarker( aMarkers, marker );
 
                 if( !m_reportAllTrackErrors )
                     return;
             }
         }
+
+        int    minClearance = aRefSeg->GetClearance( pad, &clearanceSource );
+        int    actual;
+        size_t pairKey = DRC_PAIR_CACHE::PairKey( refSegHash, itemHash( pad ), minClearance );
+
+        // Unchanged since the last run, which found it clean
+        if( m_trackPadCache.IsClean( pairKey ) )
+            continue;
+
+        if( !checkClearanceSegmToPad( refSeg, refSegWidth, pad, minClearance, &actual ) )
+        {
+            actual = std::max( 0, actual );
+            SEG       padSeg( pad->GetPosition(), pad->GetPosition() );
+            DRC_ITEM* drcItem = new DRC_ITEM( DRCE_TRACK_NEAR_PAD );
+
+            msg.Printf( drcItem->GetErrorText() + _( " (%s clearance %s; actual %s)" ),
+                        clearanceSource,
+                        MessageTextFromValue( userUnits(), minClearance, true ),
+                        MessageTextFromValue( userUnits(), actual, true ) );
+
+            drcItem->SetErrorMessage( msg );
+            drcItem->SetItems( aRefSeg, pad );
+
+            MARKER_PCB* marker = new MARKER_PCB( drcItem, GetLocation( aRefSeg, padSeg ) );
+            addMarker( aMarkers, marker );
+
+            if( !m_reportAllTrackErrors )
+                return;
+
+            continue;
+        }
+
+        m_trackPadCache.SetClean( pairKey );
     }
 
     /***********************************************/
     /* Phase 2: test DRC with other track segments */
     /***********************************************/
 
+    // Tracks which have already been tested against the reference segment are skipped by
+    // the caller's filter.
+    candidates.clear();
+
+    m_trackIndex.QueryColliding( refSegBB, refLayerSet,
+            [&]( const DRC_RTREE::ITEM& aItem ) -> bool
+            {
+                if( aItem.m_item != aRefSeg && aIsCandidate( aItem ) )
+                    candidates.push_back( aItem );
+
+                return true;
+            } );
+
+    std::sort( candidates.begin(), candidates.end(), indexOrder );
+
     // Test the reference segment with other track segments
-    for( auto it = aStartIt; it != aEndIt; it++ )
+    for( const DRC_RTREE::ITEM& candidate : candidates )
     {
-        TRACK* track = *it;
+        TRACK* track = static_cast<TRACK*>( candidate.m_item );
 
         // No problem if segments have the same net code:
         if( aRefSeg->GetNetCode() == track->GetNetCode() )
@@ -484,14 +521,7 @@ void DRC::doTrackDrc( BOARD_COMMIT& aCommit, TRACK* aRefSeg, TRACKS::iterator aS
         if( !sameLayers )
             continue;
 
-        // Preflight based on worst-case inflated bounding boxes:
-        EDA_RECT trackBB = track->GetBoundingBox();
-        trackBB.Inflate( m_largestClearance );
-
-        if( !trackBB.Intersects( refSegBB ) )
-            continue;
-
-        int minClearance = aRefSeg->GetClearance( track, &m_clearanceSource );
+        int minClearance = aRefSeg->GetClearance( track, &clearanceSource );
         SEG trackSeg( track->GetStart(), track->GetEnd() );
         int widths = ( refSegWidth + track->GetWidth() ) / 2;
         int center2centerAllowed = minClearance + widths;
@@ -504,11 +534,10 @@ void DRC::doTrackDrc( BOARD_COMMIT& aCommit, TRACK* aRefSeg, TRACKS::iterator aS
         if( intersection )
         {
             DRC_ITEM* drcItem = new DRC_ITEM( DRCE_TRACKS_CROSSING );
-            drcItem->SetErrorMessage( m_msg );
             drcItem->SetItems( aRefSeg, track );
 
             MARKER_PCB* marker = new MARKER_PCB( drcItem, (wxPoint) intersection.get() );
-            addMarkerToPcb( aCommit, marker );
+            addMarker( aMarkers, marker );
 
             if( !m_reportAllTrackErrors )
                 return;
@@ -527,16 +556,16 @@ void DRC::doTrackDrc( BOARD_COMMIT& aCommit, TRACK* aRefSeg, TRACKS::iterator aS
             int       actual = std::max( 0.0, sqrt( center2center_squared ) - widths );
             DRC_ITEM* drcItem = new DRC_ITEM( errorCode );
 
-            m_msg.Printf( drcItem->GetErrorText() + _( " (%s clearance %s; actual %s)" ),
-                          m_clearanceSource,
-                          MessageTextFromValue( userUnits(), minClearance, true ),
-                          MessageTextFromValue( userUnits(), actual, true ) );
+            msg.Printf( drcItem->GetErrorText() + _( " (%s clearance %s; actual %s)" ),
+                        clearanceSource,
+                        MessageTextFromValue( userUnits(), minClearance, true ),
+                        MessageTextFromValue( userUnits(), actual, true ) );
 
-            drcItem->SetErrorMessage( m_msg );
+            drcItem->SetErrorMessage( msg );
             drcItem->SetItems( aRefSeg, track );
 
             MARKER_PCB* marker = new MARKER_PCB( drcItem, GetLocation( aRefSeg, trackSeg ) );
-            addMarkerToPcb( aCommit, marker );
+            addMarker( aMarkers, marker );
 
             if( !m_reportAllTrackErrors )
                 return;
@@ -562,7 +591,7 @@ void DRC::doTrackDrc( BOARD_COMMIT& aCommit, TRACK* aRefSeg, TRACKS::iterator aS
             if( zone->GetNetCode() && zone->GetNetCode() == aRefSeg->GetNetCode() )
                 continue;
 
-            int             minClearance = aRefSeg->GetClearance( zone, &m_clearanceSource );
+            int             minClearance = aRefSeg->GetClearance( zone, &clearanceSource );
             int             widths = refSegWidth / 2;
             int             center2centerAllowed = minClearance + widths;
             SHAPE_POLY_SET* outline = const_cast<SHAPE_POLY_SET*>( &zone->GetFilledPolysList() );
@@ -579,16 +608,16 @@ void DRC::doTrackDrc( BOARD_COMMIT& aCommit, TRACK* aRefSeg, TRACKS::iterator aS
                 int       actual = std::max( 0.0, sqrt( center2center_squared ) - widths );
                 DRC_ITEM* drcItem = new DRC_ITEM( DRCE_TRACK_NEAR_ZONE );
 
-                m_msg.Printf( drcItem->GetErrorText() + _( " (%s clearance %s; actual %s)" ),
-                              m_clearanceSource,
-                              MessageTextFromValue( userUnits(), minClearance, true ),
-                              MessageTextFromValue( userUnits(), actual, true ) );
+                msg.Printf( drcItem->GetErrorText() + _( " (%s clearance %s; actual %s)" ),
+                            clearanceSource,
+                            MessageTextFromValue( userUnits(), minClearance, true ),
+                            MessageTextFromValue( userUnits(), actual, true ) );
 
-                drcItem->SetErrorMessage( m_msg );
+                drcItem->SetErrorMessage( msg );
                 drcItem->SetItems( aRefSeg, zone );
 
                 MARKER_PCB* marker = new MARKER_PCB( drcItem, GetLocation( aRefSeg, zone ) );
-                addMarkerToPcb( aCommit, marker );
+                addMarker( aMarkers, marker );
             }
         }
     }
@@ -599,13 +628,13 @@ void DRC::doTrackDrc( BOARD_COMMIT& aCommit, TRACK* aRefSeg, TRACKS::iterator aS
     if( m_board_outline_valid )
     {
         int minClearance = bds.m_CopperEdgeClearance;
-        m_clearanceSource = _( "board edge" );
+        clearanceSource = _( "board edge" );
 
         static DRAWSEGMENT dummyEdge;
         dummyEdge.SetLayer( Edge_Cuts );
 
-        if( aRefSeg->GetRuleClearance( &dummyEdge, &minClearance, &m_clearanceSource ) )
-            /* minClearance and m_clearanceSource set in GetRuleClearance() */;
+        if( aRefSeg->GetRuleClearance( &dummyEdge, &minClearance, &clearanceSource ) )
+            /* minClearance and clearanceSource set in GetRuleClearance() */;
 
         SEG testSeg( aRefSeg->GetStart(), aRefSeg->GetEnd() );
         int halfWidth = refSegWidth / 2;
@@ -646,16 +675,16 @@ void DRC::doTrackDrc( BOARD_COMMIT& aCommit, TRACK* aRefSeg, TRACKS::iterator aS
                                                                        : DRCE_TRACK_NEAR_EDGE;
                 DRC_ITEM* drcItem = new DRC_ITEM( errorCode );
 
-                m_msg.Printf( drcItem->GetErrorText() + _( " (%s clearance %s; actual %s)" ),
-                              m_clearanceSource,
-                              MessageTextFromValue( userUnits(), minClearance, true ),
-                              MessageTextFromValue( userUnits(), actual, true ) );
+                msg.Printf( drcItem->GetErrorText() + _( " (%s clearance %s; actual %s)" ),
+                            clearanceSource,
+                            MessageTextFromValue( userUnits(), minClearance, true ),
+                            MessageTextFromValue( userUnits(), actual, true ) );
 
-                drcItem->SetErrorMessage( m_msg );
+                drcItem->SetErrorMessage( msg );
                 drcItem->SetItems( aRefSeg, edge );
 
                 MARKER_PCB* marker = new MARKER_PCB( drcItem, (wxPoint) pt );
-                addMarkerToPcb( aCommit, marker );
+                addMarker( aMarkers, marker );
             }
         }
     }
@@ -767,12 +796,11 @@ bool DRC::checkClearancePadToPad( D_PAD* aRefPad, D_PAD* aPad, int aMinClearance
         }
         else if( aRefPad->GetShape() == PAD_SHAPE_CUSTOM )
         {
-            polysetref.Append( aRefPad->GetCustomShapeAsPolygon() );
+            polysetref.Append( aRefPad->GetBoardPolygon() );
 
-            // The reference pad can be rotated.  Calculate the rotated coordinates.
+            // The reference pad can be rotated: its board polygon is rotated.
             // (note, the ref pad position is the origin of coordinates for this drc test)
-            aRefPad->CustomShapeAsPolygonToBoardPosition( &polysetref, wxPoint( 0, 0 ),
-                                                          aRefPad->GetOrientation() );
+            polysetref.Move( VECTOR2I( -aRefPad->GetPosition() ) );
         }
         else
         {
@@ -815,12 +843,11 @@ bool DRC::checkClearancePadToPad( D_PAD* aRefPad, D_PAD* aPad, int aMinClearance
             }
             else if( aPad->GetShape() == PAD_SHAPE_CUSTOM )
             {
-                polysetcompare.Append( aPad->GetCustomShapeAsPolygon() );
+                polysetcompare.Append( aPad->GetBoardPolygon() );
 
-                // The pad to compare can be rotated. Calculate the rotated coordinates.
+                // The pad to compare can be rotated: its board polygon is rotated.
                 // ( note, the pad to compare position is the relativePadPos for this drc test)
-                aPad->CustomShapeAsPolygonToBoardPosition( &polysetcompare, relativePadPos,
-                                                           aPad->GetOrientation() );
+                polysetcompare.Move( VECTOR2I( relativePadPos - aPad->GetPosition() ) );
             }
             else
             {
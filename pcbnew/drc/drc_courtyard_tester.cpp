@@ -29,8 +29,10 @@
 #include <class_module.h>
 #include <drc/drc.h>
 
+#include <thread_pool.h>
 #include <widgets/ui_common.h>
 
+#include <algorithm>
 #include <memory>
 
 
@@ -40,6 +42,154 @@ DRC_COURTYARD_TESTER::DRC_COURTYARD_TESTER( MARKER_HANDLER aMarkerHandler ) :
 }
 
 
+/**
+ * A footprint which has a courtyard, with the bounding box of its courtyards on both sides.
+ */
+struct COURTYARD_ITEM
+{
+    MODULE* m_footprint;
+    size_t  m_index;        ///< index of the footprint in the board
+    BOX2I   m_bbox;
+};
+
+
+/**
+ * A pair of footprints whose courtyard bounding boxes overlap, and the result of the test
+ */
+struct COURTYARD_PAIR
+{
+    const COURTYARD_ITEM* m_first;
+    const COURTYARD_ITEM* m_second;
+    bool                  m_overlap;
+    wxPoint               m_pos;
+};
+
+
+/**
+ * Test whether two courtyard polygons overlap.
+ *
+ * @param aPos [out] is set to a point of the overlap, if any
+ */
+static bool courtyardsOverlap( const SHAPE_POLY_SET& aFirst, const SHAPE_POLY_SET& aSecond,
+                               wxPoint* aPos )
+{
+    if( aFirst.OutlineCount() == 0 || aSecond.OutlineCount() == 0
+        || !aFirst.BBoxFromCaches().Intersects( aSecond.BBoxFromCaches() ) )
+    {
+        return false;
+    }
+
+    SHAPE_POLY_SET intersection = aFirst;
+
+    // Build the common area between footprint and the test:
+    intersection.BooleanIntersection( aSecond, SHAPE_POLY_SET::PM_FAST );
+
+    // If the intersection exists then they overlap
+    if( intersection.OutlineCount() > 0 )
+    {
+        *aPos = (wxPoint) intersection.CVertex( 0, 0, -1 );
+        return true;
+    }
+
+    return false;
+}
+
+
+void DRC_COURTYARD_TESTER::testOverlappingCourtyards( BOARD& aBoard, bool& aSuccess )
+{
+    std::vector<COURTYARD_ITEM> items;
+    size_t                      index = 0;
+
+    for( MODULE* footprint : aBoard.Modules() )
+    {
+        const SHAPE_POLY_SET& front = footprint->GetPolyCourtyardFront();
+        const SHAPE_POLY_SET& back = footprint->GetPolyCourtyardBack();
+
+        if( front.OutlineCount() == 0 && back.OutlineCount() == 0 )
+        {
+            index++;
+            continue; // No courtyards defined
+        }
+
+        BOX2I bbox = front.OutlineCount() ? front.BBoxFromCaches() : back.BBoxFromCaches();
+
+        if( front.OutlineCount() && back.OutlineCount() )
+            bbox.Merge( back.BBoxFromCaches() );
+
+        items.push_back( { footprint, index++, bbox } );
+    }
+
+    // Sort and sweep along X: only the footprints whose bounding boxes overlap are tested
+    std::sort( items.begin(), items.end(),
+               []( const COURTYARD_ITEM& a, const COURTYARD_ITEM& b )
+               {
+                   return a.m_bbox.GetLeft() < b.m_bbox.GetLeft();
+               } );
+
+    std::vector<COURTYARD_PAIR> pairs;
+
+    for( size_t i = 0; i < items.size(); ++i )
+    {
+        for( size_t j = i + 1; j < items.size(); ++j )
+        {
+            if( items[j].m_bbox.GetLeft() > items[i].m_bbox.GetRight() )
+                break;
+
+            if( !items[i].m_bbox.Intersects( items[j].m_bbox ) )
+                continue;
+
+            if( items[i].m_index < items[j].m_index )
+                pairs.push_back( { &items[i], &items[j], false, wxPoint() } );
+            else
+                pairs.push_back( { &items[j], &items[i], false, wxPoint() } );
+        }
+    }
+
+    // Report in the board order of the footprints, whatever the sweep order
+    std::sort( pairs.begin(), pairs.end(),
+               []( const COURTYARD_PAIR& a, const COURTYARD_PAIR& b )
+               {
+                   if( a.m_first->m_index != b.m_first->m_index )
+                       return a.m_first->m_index < b.m_first->m_index;
+
+                   return a.m_second->m_index < b.m_second->m_index;
+               } );
+
+    // The polygon intersections are independent, so they run in parallel.  This is called
+    // from a DRC task on the thread pool, whose waits run only the items of this loop.
+    THREAD_POOL::GetInstance().ParallelFor( pairs.size(),
+            [&]( size_t aIndex )
+            {
+                COURTYARD_PAIR& pair = pairs[aIndex];
+                MODULE*         footprint = pair.m_first->m_footprint;
+                MODULE*         test = pair.m_second->m_footprint;
+
+                if( courtyardsOverlap( footprint->GetPolyCourtyardFront(),
+                                       test->GetPolyCourtyardFront(), &pair.m_pos ) )
+                {
+                    pair.m_overlap = true;
+                }
+
+                if( courtyardsOverlap( footprint->GetPolyCourtyardBack(),
+                                       test->GetPolyCourtyardBack(), &pair.m_pos ) )
+                {
+                    pair.m_overlap = true;
+                }
+            } );
+
+    for( const COURTYARD_PAIR& pair : pairs )
+    {
+        if( pair.m_overlap )
+        {
+            DRC_ITEM* drcItem = new DRC_ITEM( DRCE_OVERLAPPING_FOOTPRINTS );
+            drcItem->SetItems( pair.m_first->m_footprint, pair.m_second->m_footprint );
+            HandleMarker( new MARKER_PCB( drcItem, pair.m_pos ) );
+            aSuccess = false;
+        }
+    }
+}
+
+
 bool DRC_COURTYARD_TESTER::RunDRC( EDA_UNITS aUnits, BOARD& aBoard )
 {
     // Detects missing (or malformed) footprint courtyards and courtyard incursions (for those
@@ -61,11 +211,6 @@ bool DRC_COURTYARD_TESTER::RunDRC( EDA_UNITS aUnits, BOARD& aBoard )
                 HandleMarker( new MARKER_PCB( drcItem, footprint->GetPosition() ) );
                 success = false;
             }
-            else
-            {
-                footprint->GetPolyCourtyardFront().BuildBBoxCaches();
-                footprint->GetPolyCourtyardBack().BuildBBoxCaches();
-            }
         }
         else
         {
@@ -84,67 +229,7 @@ bool DRC_COURTYARD_TESTER::RunDRC( EDA_UNITS aUnits, BOARD& aBoard )
     }
 
     if( !aBoard.GetDesignSettings().Ignore( DRCE_OVERLAPPING_FOOTPRINTS ) )
-    {
-        for( auto it1 = aBoard.Modules().begin(); it1 != aBoard.Modules().end(); it1++ )
-        {
-            MODULE*         footprint = *it1;
-            SHAPE_POLY_SET& footprintFront = footprint->GetPolyCourtyardFront();
-            SHAPE_POLY_SET& footprintBack = footprint->GetPolyCourtyardBack();
-
-            if( footprintFront.OutlineCount() == 0 && footprintBack.OutlineCount() == 0 )
-                continue; // No courtyards defined
-
-            for( auto it2 = it1 + 1; it2 != aBoard.Modules().end(); it2++ )
-            {
-                MODULE*         test = *it2;
-                SHAPE_POLY_SET& testFront = test->GetPolyCourtyardFront();
-                SHAPE_POLY_SET& testBack = test->GetPolyCourtyardBack();
-                SHAPE_POLY_SET  intersection;
-                bool            overlap = false;
-                wxPoint         pos;
-
-                if( footprintFront.OutlineCount() > 0 && testFront.OutlineCount() > 0
-                    && footprintFront.BBoxFromCaches().Intersects( testFront.BBoxFromCaches() ) )
-                {
-                    intersection.RemoveAllContours();
-                    intersection.Append( footprintFront );
-
-                    // Build the common area between footprint and the test:
-                    intersection.BooleanIntersection( testFront, SHAPE_POLY_SET::PM_FAST );
-
-                    // If the intersection exists then they overlap
-                    if( intersection.OutlineCount() > 0 )
-                    {
-                        overlap = true;
-                        pos = (wxPoint) intersection.CVertex( 0, 0, -1 );
-                    }
-                }
-
-                if( footprintBack.OutlineCount() > 0 && testBack.OutlineCount() > 0
-                    && footprintBack.BBoxFromCaches().Intersects( testBack.BBoxFromCaches() ) )
-                {
-                    intersection.RemoveAllContours();
-                    intersection.Append( footprintBack );
-
-                    intersection.BooleanIntersection( testBack, SHAPE_POLY_SET::PM_FAST );
-
-                    if( intersection.OutlineCount() > 0 )
-                    {
-                        overlap = true;
-                        pos = (wxPoint) intersection.CVertex( 0, 0, -1 );
-                    }
-                }
-
-                if( overlap )
-                {
-                    DRC_ITEM* drcItem = new DRC_ITEM( DRCE_OVERLAPPING_FOOTPRINTS );
-                    drcItem->SetItems( footprint, test );
-                    HandleMarker( new MARKER_PCB( drcItem, pos ) );
-                    success = false;
-                }
-            }
-        }
-    }
+        testOverlappingCourtyards( aBoard, success );
 
     if( !aBoard.GetDesignSettings().Ignore( DRCE_PTH_IN_COURTYARD )
             || !aBoard.GetDesignSettings().Ignore( DRCE_NPTH_IN_COURTYARD ) )
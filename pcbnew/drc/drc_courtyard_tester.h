@@ -38,6 +38,13 @@ public:
     virtual ~DRC_COURTYARD_TESTER() {};
 
     bool RunDRC( EDA_UNITS aUnits, BOARD& aBoard ) override;
+
+private:
+    /**
+     * Test the courtyards of all footprint pairs for overlaps.  The footprints' courtyard
+     * polygons must have been built.
+     */
+    void testOverlappingCourtyards( BOARD& aBoard, bool& aSuccess );
 };
 
 #endif // DRC_COURTYARD_OVERLAP__H
@@ -29,6 +29,8 @@
 
 #include <widgets/ui_common.h>
 
+#include <unordered_map>
+
 
 DRC_DRILLED_HOLE_TESTER::DRC_DRILLED_HOLE_TESTER( MARKER_HANDLER aMarkerHandler ) :
         DRC_TEST_PROVIDER( std::move( aMarkerHandler ) ),
@@ -53,6 +55,7 @@ bool DRC_DRILLED_HOLE_TESTER::RunDRC( EDA_UNITS aUnits, BOARD& aBoard )
     m_board = &aBoard;
     m_holes.clear();
     m_largestRadius = 0;
+    m_counters.clear();
 
     for( MODULE* mod : aBoard.Modules() )
     {
@@ -230,10 +233,7 @@ bool DRC_DRILLED_HOLE_TESTER::checkHoles()
     // No need to check if we're ignoring DRCE_DRILLED_HOLES_TOO_CLOSE; if we are then we
     // won't have collected any holes to test.
 
-    // Sort holes by X for performance.  In the nested iteration we then need to look at
-    // following holes only while they are within the refHole's neighborhood as defined by
-    // the refHole radius + the minimum hole-to-hole clearance + the largest radius any of
-    // the following holes can have.
+    // Sort holes by position so the markers come out in a stable order.
     std::sort( m_holes.begin(), m_holes.end(),
                []( const DRILLED_HOLE& a, const DRILLED_HOLE& b )
                {
@@ -243,17 +243,71 @@ bool DRC_DRILLED_HOLE_TESTER::checkHoles()
                        return a.m_location.x < b.m_location.x;
                } );
 
+    // Bin the holes into a uniform grid.  Two holes can only be too close if their centres
+    // are less than the largest drill diameter plus the hole-to-hole clearance apart, so with
+    // cells of that size each hole only has to be compared with the holes in its own cell
+    // and in the eight cells around it.
+    int cellSize = std::max( 1, 2 * m_largestRadius + bds.m_HoleToHoleMin );
+
+    auto cellCoord =
+            [cellSize]( int aCoord ) -> int64_t
+            {
+                // Round towards negative infinity so the cells around the origin are full size
+                return aCoord >= 0 ? aCoord / cellSize : ( (int64_t) aCoord + 1 ) / cellSize - 1;
+            };
+
+    auto cellKey =
+            []( int64_t aX, int64_t aY ) -> uint64_t
+            {
+                // Cell coordinates fit in 32 bits; shift them unsigned, as shifting a negative
+                // signed value is undefined
+                return ( (uint64_t) (uint32_t) aX << 32 ) | (uint32_t) aY;
+            };
+
+    std::unordered_map<uint64_t, std::vector<size_t>> grid;
+
+    for( size_t ii = 0; ii < m_holes.size(); ++ii )
+    {
+        const wxPoint& pos = m_holes[ ii ].m_location;
+        grid[ cellKey( cellCoord( pos.x ), cellCoord( pos.y ) ) ].push_back( ii );
+    }
+
+    std::vector<size_t> candidates;
+    size_t              comparisons = 0;
+
     for( size_t ii = 0; ii < m_holes.size(); ++ii )
     {
         const DRILLED_HOLE& refHole = m_holes[ ii ];
-        int neighborhood = refHole.m_drillRadius + bds.m_HoleToHoleMin + m_largestRadius;
+        int64_t             cx = cellCoord( refHole.m_location.x );
+        int64_t             cy = cellCoord( refHole.m_location.y );
+
+        candidates.clear();
 
-        for( size_t jj = ii + 1; jj < m_holes.size(); ++jj )
+        for( int64_t dx = -1; dx <= 1; ++dx )
+        {
+            for( int64_t dy = -1; dy <= 1; ++dy )
+            {
+                auto cell = grid.find( cellKey( cx + dx, cy + dy ) );
+
+                if( cell == grid.end() )
+                    continue;
+
+                // Only look at following holes so each pair is tested once
+                for( size_t jj : cell->second )
+                {
+                    if( jj > ii )
+                        candidates.push_back( jj );
+                }
+            }
+        }
+
+        std::sort( candidates.begin(), candidates.end() );
+
+        for( size_t jj : candidates )
         {
             const DRILLED_HOLE& checkHole = m_holes[ jj ];
 
-            if( refHole.m_location.x + neighborhood < checkHole.m_location.x )
-                break;
+            comparisons++;
 
             // Holes with identical locations are allowable
             if( checkHole.m_location == refHole.m_location )
@@ -279,5 +333,7 @@ bool DRC_DRILLED_HOLE_TESTER::checkHoles()
         }
     }
 
+    m_counters[ "hole_comparisons" ] = comparisons;
+
     return success;
 }
@@ -26,14 +26,13 @@
 
 #include <class_module.h>
 #include <drc/drc.h>
+#include <thread_pool.h>
 
 
 DRC_KEEPOUT_TESTER::DRC_KEEPOUT_TESTER( MARKER_HANDLER aMarkerHandler ) :
         DRC_TEST_PROVIDER( std::move( aMarkerHandler ) ),
         m_units( EDA_UNITS::MILLIMETRES ),
-        m_board( nullptr ),
-        m_zone( nullptr ),
-        m_keepoutFlags( 0 )
+        m_board( nullptr )
 {
 }
 
@@ -47,91 +46,126 @@ bool DRC_KEEPOUT_TESTER::RunDRC( EDA_UNITS aUnits, BOARD& aBoard )
 
     // Get a list of all zones to inspect, from both board and footprints
     std::list<ZONE_CONTAINER*> areasToInspect = m_board->GetZoneList( true );
+    std::vector<AREA>          areas;
 
-    // Test keepout areas for vias, tracks and pads inside keepout areas
-    for( ZONE_CONTAINER* area : areasToInspect )
+    for( ZONE_CONTAINER* zone : areasToInspect )
     {
-        m_keepoutFlags = area->GetKeepouts( &m_sources );
+        AREA area;
 
-        if( m_keepoutFlags > 0 )
-        {
-            m_zone = area;
-            m_zoneBBox = area->GetBoundingBox();
+        area.m_KeepoutFlags = zone->GetKeepouts( &area.m_Sources );
 
-            success &= checkTracksAndVias();
-            success &= checkFootprints();
-            success &= checkDrawings();
+        if( area.m_KeepoutFlags > 0 )
+        {
+            area.m_Zone = zone;
+            area.m_BBox = zone->GetBoundingBox();
+            area.m_Success = true;
+            areas.push_back( std::move( area ) );
         }
     }
 
+    if( areas.empty() )
+        return true;
+
+    // Each area is only tested against the items in its bounding box
+    for( TRACK* track : m_board->Tracks() )
+        m_tracks.Insert( track );
+
+    for( MODULE* fp : m_board->Modules() )
+        m_footprints.Insert( fp );
+
+    for( BOARD_ITEM* drawing : m_board->Drawings() )
+        m_drawings.Insert( drawing );
+
+    // Test keepout areas for vias, tracks and pads inside keepout areas
+    THREAD_POOL::GetInstance().ParallelFor( areas.size(),
+            [&]( size_t aIndex )
+            {
+                AREA& area = areas[aIndex];
+
+                area.m_Success &= checkTracksAndVias( area );
+                area.m_Success &= checkFootprints( area );
+                area.m_Success &= checkDrawings( area );
+            } );
+
+    for( AREA& area : areas )
+    {
+        for( MARKER_PCB* marker : area.m_Markers )
+            HandleMarker( marker );
+
+        success &= area.m_Success;
+    }
+
     return success;
 }
 
 
-bool DRC_KEEPOUT_TESTER::checkTracksAndVias()
+bool DRC_KEEPOUT_TESTER::checkTracksAndVias( AREA& aArea ) const
 {
     constexpr int VIA_MASK = DISALLOW_VIAS | DISALLOW_MICRO_VIAS | DISALLOW_BB_VIAS;
     constexpr int CHECK_VIAS_MASK = VIA_MASK | DISALLOW_HOLES;
     constexpr int CHECK_TRACKS_AND_VIAS_MASK = CHECK_VIAS_MASK | DISALLOW_TRACKS;
 
-    if(( m_keepoutFlags & CHECK_TRACKS_AND_VIAS_MASK ) == 0 )
+    if(( aArea.m_KeepoutFlags & CHECK_TRACKS_AND_VIAS_MASK ) == 0 )
         return true;
 
-    bool success = true;
+    bool     success = true;
+    wxString msg;
 
-    for( TRACK* segm : m_board->Tracks() )
+    for( TRACK* segm : m_tracks.Query( aArea.m_BBox ) )
     {
-        if( !m_zoneBBox.Intersects( segm->GetBoundingBox() ) )
+        if( !aArea.m_BBox.Intersects( segm->GetBoundingBox() ) )
             continue;
 
-        if( segm->Type() == PCB_TRACE_T && ( m_keepoutFlags & DISALLOW_TRACKS ) != 0 )
+        if( segm->Type() == PCB_TRACE_T && ( aArea.m_KeepoutFlags & DISALLOW_TRACKS ) != 0 )
         {
             // Ignore if the keepout zone is not on the same layer
-            if( !m_zone->IsOnLayer( segm->GetLayer() ) )
+            if( !aArea.m_Zone->IsOnLayer( segm->GetLayer() ) )
                 continue;
 
             int         widths = segm->GetWidth() / 2;
             SEG         trackSeg( segm->GetStart(), segm->GetEnd() );
-            SEG::ecoord center2center_squared = m_zone->Outline()->SquaredDistance( trackSeg );
+            SEG::ecoord center2center_squared =
+                    aArea.m_Zone->Outline()->SquaredDistance( trackSeg );
 
             if( center2center_squared <= SEG::Square( widths) )
             {
                 DRC_ITEM* drcItem = new DRC_ITEM( DRCE_TRACK_INSIDE_KEEPOUT );
 
-                m_msg.Printf( drcItem->GetErrorText() + _( " (%s)" ),
-                              m_sources.at(DISALLOW_TRACKS ) );
+                msg.Printf( drcItem->GetErrorText() + _( " (%s)" ),
+                            aArea.m_Sources.at(DISALLOW_TRACKS ) );
 
-                drcItem->SetErrorMessage( m_msg );
-                drcItem->SetItems( segm, m_zone );
+                drcItem->SetErrorMessage( msg );
+                drcItem->SetItems( segm, aArea.m_Zone );
 
-                HandleMarker( new MARKER_PCB( drcItem, DRC::GetLocation( segm, m_zone ) ) );
+                aArea.m_Markers.push_back(
+                        new MARKER_PCB( drcItem, DRC::GetLocation( segm, aArea.m_Zone ) ) );
                 success = false;
             }
         }
-        else if( segm->Type() == PCB_VIA_T && ( m_keepoutFlags & CHECK_VIAS_MASK ) != 0 )
+        else if( segm->Type() == PCB_VIA_T && ( aArea.m_KeepoutFlags & CHECK_VIAS_MASK ) != 0 )
         {
             VIA* via = static_cast<VIA*>( segm );
             int  errorCode = 0;
             int  sourceId = 0;
 
-            if( ( m_keepoutFlags & DISALLOW_VIAS ) > 0 )
+            if( ( aArea.m_KeepoutFlags & DISALLOW_VIAS ) > 0 )
             {
                 errorCode = DRCE_VIA_INSIDE_KEEPOUT;
                 sourceId = DISALLOW_VIAS;
             }
             else if( via->GetViaType() == VIATYPE::MICROVIA
-                        && ( m_keepoutFlags & DISALLOW_MICRO_VIAS ) > 0 )
+                        && ( aArea.m_KeepoutFlags & DISALLOW_MICRO_VIAS ) > 0 )
             {
                 errorCode = DRCE_MICROVIA_INSIDE_KEEPOUT;
                 sourceId = DISALLOW_MICRO_VIAS;
             }
             else if( via->GetViaType() == VIATYPE::BLIND_BURIED
-                        && ( m_keepoutFlags & DISALLOW_BB_VIAS ) > 0 )
+                        && ( aArea.m_KeepoutFlags & DISALLOW_BB_VIAS ) > 0 )
             {
                 errorCode = DRCE_BBVIA_INSIDE_KEEPOUT;
                 sourceId = DISALLOW_BB_VIAS;
             }
-            else if( ( m_keepoutFlags & DISALLOW_HOLES ) > 0 )
+            else if( ( aArea.m_KeepoutFlags & DISALLOW_HOLES ) > 0 )
             {
                 errorCode = DRCE_HOLE_INSIDE_KEEPOUT;
                 sourceId = DISALLOW_HOLES;
@@ -145,16 +179,19 @@ bool DRC_KEEPOUT_TESTER::checkTracksAndVias()
             if( errorCode == DRCE_HOLE_INSIDE_KEEPOUT )
                 widths = via->GetDrillValue() / 2;
 
-            SEG::ecoord center2center_squared = m_zone->Outline()->SquaredDistance( viaPos );
+            SEG::ecoord center2center_squared =
+                    aArea.m_Zone->Outline()->SquaredDistance( viaPos );
 
             if( center2center_squared <= SEG::Square( widths ) )
             {
                 DRC_ITEM* drcItem = new DRC_ITEM( errorCode );
-                m_msg.Printf( drcItem->GetErrorText() + _( " (%s)" ), m_sources.at( sourceId ) );
-                drcItem->SetErrorMessage( m_msg );
-                drcItem->SetItems( segm, m_zone );
+                msg.Printf( drcItem->GetErrorText() + _( " (%s)" ),
+                            aArea.m_Sources.at( sourceId ) );
+                drcItem->SetErrorMessage( msg );
+                drcItem->SetItems( segm, aArea.m_Zone );
 
-                HandleMarker( new MARKER_PCB( drcItem, DRC::GetLocation( segm, m_zone ) ) );
+                aArea.m_Markers.push_back(
+                        new MARKER_PCB( drcItem, DRC::GetLocation( segm, aArea.m_Zone ) ) );
                 success = false;
             }
         }
@@ -164,24 +201,25 @@ bool DRC_KEEPOUT_TESTER::checkTracksAndVias()
 }
 
 
-bool DRC_KEEPOUT_TESTER::checkFootprints()
+bool DRC_KEEPOUT_TESTER::checkFootprints( AREA& aArea ) const
 {
     constexpr int CHECK_PADS_MASK = DISALLOW_PADS | DISALLOW_HOLES;
     constexpr int CHECK_FOOTPRINTS_MASK = CHECK_PADS_MASK | DISALLOW_FOOTPRINTS;
 
-    if(( m_keepoutFlags & CHECK_FOOTPRINTS_MASK ) == 0 )
+    if(( aArea.m_KeepoutFlags & CHECK_FOOTPRINTS_MASK ) == 0 )
         return true;
 
-    bool success = true;
+    bool     success = true;
+    wxString msg;
 
-    for( MODULE* fp : m_board->Modules() )
+    for( MODULE* fp : m_footprints.Query( aArea.m_BBox ) )
     {
-        if( !m_zoneBBox.Intersects( fp->GetBoundingBox() ) )
+        if( !aArea.m_BBox.Intersects( fp->GetBoundingBox() ) )
             continue;
 
-        if( ( m_keepoutFlags & DISALLOW_FOOTPRINTS ) > 0
-                && ( fp->IsFlipped() ? m_zone->CommonLayerExists( LSET::BackMask() )
-                                     : m_zone->CommonLayerExists( LSET::FrontMask() ) ) )
+        if( ( aArea.m_KeepoutFlags & DISALLOW_FOOTPRINTS ) > 0
+                && ( fp->IsFlipped() ? aArea.m_Zone->CommonLayerExists( LSET::BackMask() )
+                                     : aArea.m_Zone->CommonLayerExists( LSET::FrontMask() ) ) )
         {
             SHAPE_POLY_SET poly;
 
@@ -192,7 +230,7 @@ bool DRC_KEEPOUT_TESTER::checkFootprints()
                 poly = fp->GetBoundingPoly();
 
             // Build the common area between footprint and the keepout area:
-            poly.BooleanIntersection( *m_zone->Outline(), SHAPE_POLY_SET::PM_FAST );
+            poly.BooleanIntersection( *aArea.m_Zone->Outline(), SHAPE_POLY_SET::PM_FAST );
 
             // If it's not empty then we have a violation
             if( poly.OutlineCount() )
@@ -200,20 +238,20 @@ bool DRC_KEEPOUT_TESTER::checkFootprints()
                 const VECTOR2I& pt = poly.CVertex( 0, 0, -1 );
                 DRC_ITEM* drcItem = new DRC_ITEM( DRCE_FOOTPRINT_INSIDE_KEEPOUT );
 
-                m_msg.Printf( drcItem->GetErrorText() + _( " (%s)" ),
-                              m_sources.at( DISALLOW_FOOTPRINTS ) );
+                msg.Printf( drcItem->GetErrorText() + _( " (%s)" ),
+                            aArea.m_Sources.at( DISALLOW_FOOTPRINTS ) );
 
-                drcItem->SetErrorMessage( m_msg );
-                drcItem->SetItems( fp, m_zone );
+                drcItem->SetErrorMessage( msg );
+                drcItem->SetItems( fp, aArea.m_Zone );
 
-                HandleMarker( new MARKER_PCB( drcItem, (wxPoint) pt ) );
+                aArea.m_Markers.push_back( new MARKER_PCB( drcItem, (wxPoint) pt ) );
                 success = false;
             }
         }
 
-        if( ( m_keepoutFlags & CHECK_PADS_MASK ) > 0 )
+        if( ( aArea.m_KeepoutFlags & CHECK_PADS_MASK ) > 0 )
         {
-            success &= checkPads( fp );
+            success &= checkPads( aArea, fp );
         }
     }
 
@@ -221,29 +259,30 @@ bool DRC_KEEPOUT_TESTER::checkFootprints()
 }
 
 
-bool DRC_KEEPOUT_TESTER::checkPads( MODULE* aModule )
+bool DRC_KEEPOUT_TESTER::checkPads( AREA& aArea, MODULE* aModule ) const
 {
-    bool success = true;
+    bool     success = true;
+    wxString msg;
 
     for( D_PAD* pad : aModule->Pads() )
     {
-        if( !m_zone->CommonLayerExists( pad->GetLayerSet() ) )
+        if( !aArea.m_Zone->CommonLayerExists( pad->GetLayerSet() ) )
             continue;
 
         // Fast test to detect a pad inside the keepout area bounding box.
         EDA_RECT padBBox( pad->ShapePos(), wxSize() );
         padBBox.Inflate( pad->GetBoundingRadius() );
 
-        if( !m_zoneBBox.Intersects( padBBox ) )
+        if( !aArea.m_BBox.Intersects( padBBox ) )
             continue;
 
-        if( ( m_keepoutFlags & DISALLOW_PADS ) > 0 )
+        if( ( aArea.m_KeepoutFlags & DISALLOW_PADS ) > 0 )
         {
             SHAPE_POLY_SET outline;
             pad->TransformShapeWithClearanceToPolygon( outline, 0 );
 
             // Build the common area between pad and the keepout area:
-            outline.BooleanIntersection( *m_zone->Outline(), SHAPE_POLY_SET::PM_FAST );
+            outline.BooleanIntersection( *aArea.m_Zone->Outline(), SHAPE_POLY_SET::PM_FAST );
 
             // If it's not empty then we have a violation
             if( outline.OutlineCount() )
@@ -251,17 +290,17 @@ bool DRC_KEEPOUT_TESTER::checkPads( MODULE* aModule )
                 const VECTOR2I& pt = outline.CVertex( 0, 0, -1 );
                 DRC_ITEM* drcItem = new DRC_ITEM( DRCE_PAD_INSIDE_KEEPOUT );
 
-                m_msg.Printf( drcItem->GetErrorText() + _( " (%s)" ),
-                              m_sources.at( DISALLOW_PADS ) );
+                msg.Printf( drcItem->GetErrorText() + _( " (%s)" ),
+                            aArea.m_Sources.at( DISALLOW_PADS ) );
 
-                drcItem->SetErrorMessage( m_msg );
-                drcItem->SetItems( pad, m_zone );
+                drcItem->SetErrorMessage( msg );
+                drcItem->SetItems( pad, aArea.m_Zone );
 
-                HandleMarker( new MARKER_PCB( drcItem, (wxPoint) pt ) );
+                aArea.m_Markers.push_back( new MARKER_PCB( drcItem, (wxPoint) pt ) );
                 success = false;
             }
         }
-        else if( ( m_keepoutFlags & DISALLOW_HOLES ) > 0 )
+        else if( ( aArea.m_KeepoutFlags & DISALLOW_HOLES ) > 0 )
         {
             wxPoint slotStart, slotEnd;
             int     slotWidth;
@@ -271,20 +310,21 @@ bool DRC_KEEPOUT_TESTER::checkPads( MODULE* aModule )
             slotEnd += pad->GetPosition();
 
             SEG             slotSeg( slotStart, slotEnd );
-            SHAPE_POLY_SET* outline = const_cast<SHAPE_POLY_SET*>( &m_zone->GetFilledPolysList() );
+            SHAPE_POLY_SET* outline =
+                    const_cast<SHAPE_POLY_SET*>( &aArea.m_Zone->GetFilledPolysList() );
             SEG::ecoord     center2center_sq = outline->SquaredDistance( slotSeg );
 
             if( center2center_sq <= SEG::Square( slotWidth) )
             {
                 DRC_ITEM* drcItem = new DRC_ITEM( DRCE_HOLE_INSIDE_KEEPOUT );
 
-                m_msg.Printf( drcItem->GetErrorText() + _( " (%s)" ),
-                              m_sources.at( DISALLOW_HOLES ) );
+                msg.Printf( drcItem->GetErrorText() + _( " (%s)" ),
+                            aArea.m_Sources.at( DISALLOW_HOLES ) );
 
-                drcItem->SetErrorMessage( m_msg );
-                drcItem->SetItems( pad, m_zone );
+                drcItem->SetErrorMessage( msg );
+                drcItem->SetItems( pad, aArea.m_Zone );
 
-                HandleMarker( new MARKER_PCB( drcItem, pad->GetPosition() ) );
+                aArea.m_Markers.push_back( new MARKER_PCB( drcItem, pad->GetPosition() ) );
                 success = false;
             }
         }
@@ -294,30 +334,31 @@ bool DRC_KEEPOUT_TESTER::checkPads( MODULE* aModule )
 }
 
 
-bool DRC_KEEPOUT_TESTER::checkDrawings()
+bool DRC_KEEPOUT_TESTER::checkDrawings( AREA& aArea ) const
 {
     constexpr int CHECK_DRAWINGS_MASK = DISALLOW_TEXTS | DISALLOW_GRAPHICS;
     constexpr KICAD_T graphicTypes[] = { PCB_LINE_T, PCB_DIMENSION_T, PCB_TARGET_T, EOT };
 
-    if(( m_keepoutFlags & CHECK_DRAWINGS_MASK ) == 0 )
+    if(( aArea.m_KeepoutFlags & CHECK_DRAWINGS_MASK ) == 0 )
         return true;
 
-    bool success = true;
+    bool     success = true;
+    wxString msg;
 
-    for( BOARD_ITEM* drawing : m_board->Drawings() )
+    for( BOARD_ITEM* drawing : m_drawings.Query( aArea.m_BBox ) )
     {
-        if( !m_zoneBBox.Intersects( drawing->GetBoundingBox() ) )
+        if( !aArea.m_BBox.Intersects( drawing->GetBoundingBox() ) )
             continue;
 
         int  errorCode = 0;
         int  sourceId = 0;
 
-        if( drawing->IsType( graphicTypes ) && ( m_keepoutFlags & DISALLOW_GRAPHICS ) > 0 )
+        if( drawing->IsType( graphicTypes ) && ( aArea.m_KeepoutFlags & DISALLOW_GRAPHICS ) > 0 )
         {
             errorCode = DRCE_GRAPHICS_INSIDE_KEEPOUT;
             sourceId = DISALLOW_GRAPHICS;
         }
-        else if( drawing->Type() == PCB_TEXT_T && ( m_keepoutFlags & DISALLOW_TEXTS ) > 0 )
+        else if( drawing->Type() == PCB_TEXT_T && ( aArea.m_KeepoutFlags & DISALLOW_TEXTS ) > 0 )
         {
             errorCode = DRCE_TEXT_INSIDE_KEEPOUT;
             sourceId = DISALLOW_TEXTS;
@@ -329,18 +370,18 @@ bool DRC_KEEPOUT_TESTER::checkDrawings()
         drawing->TransformShapeWithClearanceToPolygon( poly, 0 );
 
         // Build the common area between footprint and the keepout area:
-        poly.BooleanIntersection( *m_zone->Outline(), SHAPE_POLY_SET::PM_FAST );
+        poly.BooleanIntersection( *aArea.m_Zone->Outline(), SHAPE_POLY_SET::PM_FAST );
 
         // If it's not empty then we have a violation
         if( poly.OutlineCount() )
         {
             const VECTOR2I& pt = poly.CVertex( 0, 0, -1 );
             DRC_ITEM* drcItem = new DRC_ITEM( errorCode );
-            m_msg.Printf( drcItem->GetErrorText() + _( " (%s)" ), m_sources.at( sourceId ) );
-            drcItem->SetErrorMessage( m_msg );
-            drcItem->SetItems( drawing, m_zone );
+            msg.Printf( drcItem->GetErrorText() + _( " (%s)" ), aArea.m_Sources.at( sourceId ) );
+            drcItem->SetErrorMessage( msg );
+            drcItem->SetItems( drawing, aArea.m_Zone );
 
-            HandleMarker( new MARKER_PCB( drcItem, (wxPoint) pt ) );
+            aArea.m_Markers.push_back( new MARKER_PCB( drcItem, (wxPoint) pt ) );
             success = false;
         }
     }
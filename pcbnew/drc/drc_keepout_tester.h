@@ -27,6 +27,11 @@
 
 #include <drc/drc_provider.h>
 
+#include <algorithm>
+#include <vector>
+
+#include <geometry/rtree.h>
+
 
 class BOARD;
 
@@ -38,24 +43,91 @@ public:
 
     virtual ~DRC_KEEPOUT_TESTER() {};
 
+    /**
+     * The keepout areas are tested concurrently, each one against the items found in its
+     * bounding box.  The markers are then handled in the order of the areas.
+     */
     bool RunDRC( EDA_UNITS aUnits, BOARD& aBoard ) override;
 
 private:
-    bool checkTracksAndVias();
-    bool checkFootprints();
-    bool checkPads( MODULE* aModule );
-    bool checkDrawings();
+    /**
+     * The items of a kind, indexed by their bounding box.  Queries only read the tree, so
+     * the areas can be tested concurrently.
+     */
+    template <class T>
+    class ITEM_INDEX
+    {
+    public:
+        void Insert( T* aItem )
+        {
+            EDA_RECT bbox = aItem->GetBoundingBox();
+            bbox.Normalize();
+
+            const int mmin[2] = { bbox.GetX(), bbox.GetY() };
+            const int mmax[2] = { bbox.GetRight(), bbox.GetBottom() };
+
+            m_tree.Insert( mmin, mmax, m_items.size() );
+            m_items.push_back( aItem );
+        }
+
+        /**
+         * @return the items whose bounding box intersects aBox, in their insertion order
+         */
+        std::vector<T*> Query( const EDA_RECT& aBox ) const
+        {
+            EDA_RECT box = aBox;
+            box.Normalize();
+
+            const int           mmin[2] = { box.GetX(), box.GetY() };
+            const int           mmax[2] = { box.GetRight(), box.GetBottom() };
+            std::vector<size_t> found;
+
+            m_tree.Search( mmin, mmax,
+                           [&]( const size_t& aIndex ) -> bool
+                           {
+                               found.push_back( aIndex );
+                               return true;
+                           } );
+
+            std::sort( found.begin(), found.end() );
+
+            std::vector<T*> items;
+            items.reserve( found.size() );
+
+            for( size_t index : found )
+                items.push_back( m_items[index] );
+
+            return items;
+        }
+
+    private:
+        std::vector<T*>               m_items;
+        RTree<size_t, int, 2, double> m_tree;
+    };
+
+    /// A keepout area, and the markers of its violations
+    struct AREA
+    {
+        ZONE_CONTAINER*          m_Zone;
+        EDA_RECT                 m_BBox;
+        int                      m_KeepoutFlags;   // bitset of DISALLOW_* flags
+        std::map<int, wxString>  m_Sources;        // map of DISALLOW_* flag to source
+        std::vector<MARKER_PCB*> m_Markers;
+        bool                     m_Success;
+    };
+
+    bool checkTracksAndVias( AREA& aArea ) const;
+    bool checkFootprints( AREA& aArea ) const;
+    bool checkPads( AREA& aArea, MODULE* aModule ) const;
+    bool checkDrawings( AREA& aArea ) const;
 
 private:
     EDA_UNITS                 m_units;
     BOARD*                    m_board;
 
-    // Temp variables for use while testing:
-    ZONE_CONTAINER*           m_zone;
-    EDA_RECT                  m_zoneBBox;
-    int                       m_keepoutFlags;   // bitset of DISALLOW_* flags
-    std::map<int, wxString>   m_sources;        // map of DISALLOW_* flag to source
-    wxString                  m_msg;            // avoid lots of calls to wxString's c'tor.
+    ITEM_INDEX<TRACK>         m_tracks;
+    ITEM_INDEX<MODULE>        m_footprints;
+    ITEM_INDEX<BOARD_ITEM>    m_drawings;
 };
 
 #endif // DRC_KEEPOUT_TESTER__H
@@ -0,0 +1,104 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+
+#include <drc/drc_pair_cache.h>
+#include <class_pad.h>
+#include <class_track.h>
+#include <hash_eda.h>
+
+#include <algorithm>
+#include <functional>
+
+
+// Mixes aValue into aSeed; unlike a plain sum, the result depends on the order of the values.
+template <typename T>
+static inline void hashCombine( size_t& aSeed, const T& aValue )
+{
+    aSeed ^= std::hash<T>{}( aValue ) + 0x9e3779b9 + ( aSeed << 6 ) + ( aSeed >> 2 );
+}
+
+
+size_t DRC_PAIR_CACHE::ItemHash( const BOARD_CONNECTED_ITEM* aItem )
+{
+    size_t ret = hash_eda( aItem, HASH_FLAGS::POSITION | HASH_FLAGS::ROTATION
+                                  | HASH_FLAGS::LAYER | HASH_FLAGS::NET );
+
+    // hash_eda() sums the coordinates, so an item mirrored across the diagonal would hash
+    // the same; mix the position in again, in order.
+    hashCombine( ret, aItem->GetPosition().x );
+    hashCombine( ret, aItem->GetPosition().y );
+
+    if( aItem->Type() == PCB_PAD_T )
+    {
+        const D_PAD* pad = static_cast<const D_PAD*>( aItem );
+
+        if( pad->GetShape() == PAD_SHAPE_CUSTOM )
+            return 0;
+
+        // hash_eda() sums the size, offset and delta terms too: a pad resized in x and y can
+        // keep the same sum
+        hashCombine( ret, pad->GetSize().x );
+        hashCombine( ret, pad->GetSize().y );
+        hashCombine( ret, pad->GetOffset().x );
+        hashCombine( ret, pad->GetOffset().y );
+        hashCombine( ret, pad->GetDelta().x );
+        hashCombine( ret, pad->GetDelta().y );
+        hashCombine( ret, (int) pad->GetShape() );
+        hashCombine( ret, (int) pad->GetAttribute() );
+        hashCombine( ret, static_cast<const BASE_SET&>( pad->GetLayerSet() ) );
+        hashCombine( ret, pad->GetDrillSize().x );
+        hashCombine( ret, pad->GetDrillSize().y );
+        hashCombine( ret, pad->GetRoundRectRadiusRatio() );
+        hashCombine( ret, pad->GetChamferRectRatio() );
+        hashCombine( ret, pad->GetChamferPositions() );
+        hashCombine( ret, pad->GetParent() );
+        hashCombine( ret, pad->GetName().ToStdString() );
+    }
+    else
+    {
+        const TRACK* track = static_cast<const TRACK*>( aItem );
+
+        hashCombine( ret, track->GetStart().x );
+        hashCombine( ret, track->GetStart().y );
+        hashCombine( ret, track->GetEnd().x );
+        hashCombine( ret, track->GetEnd().y );
+    }
+
+    // 0 is reserved for the items which cannot be cached
+    return ret ? ret : 1;
+}
+
+
+size_t DRC_PAIR_CACHE::PairKey( size_t aHashA, size_t aHashB, int aClearance )
+{
+    if( !aHashA || !aHashB )
+        return 0;
+
+    size_t ret = std::min( aHashA, aHashB );
+
+    hashCombine( ret, std::max( aHashA, aHashB ) );
+    hashCombine( ret, aClearance );
+
+    return ret ? ret : 1;
+}
@@ -0,0 +1,112 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+
+#ifndef DRC_PAIR_CACHE_H_
+#define DRC_PAIR_CACHE_H_
+
+#include <cstddef>
+#include <unordered_set>
+
+class BOARD_CONNECTED_ITEM;
+
+
+/**
+ * DRC_PAIR_CACHE -
+ * Remembers the item pairs which passed a clearance test, so that a later DRC run can skip
+ * the pairs which have not changed since.  A pair is keyed by the hashes of both items (see
+ * hash_eda()) and by the clearance resolved for the pair, so moving or editing either item,
+ * or changing the rules which apply to it, gives the pair a new key.
+ *
+ * Only clean pairs are cached: a pair which reports an error is tested again on each run.
+ */
+class DRC_PAIR_CACHE
+{
+public:
+    /**
+     * Returns the hash of the properties of aItem which the clearance tests depend on, or 0
+     * if the item cannot be cached (custom-shaped pads, whose primitives are not hashed).
+     */
+    static size_t ItemHash( const BOARD_CONNECTED_ITEM* aItem );
+
+    /**
+     * Returns the key of a pair of items, from their ItemHash() and the clearance resolved
+     * for the pair, or 0 if either item cannot be cached.  The key doesn't depend on the
+     * order of the items.
+     */
+    static size_t PairKey( size_t aHashA, size_t aHashB, int aClearance );
+
+    /**
+     * Starts a batch DRC run.  The pairs found clean by the previous run are kept for the
+     * lookups of this run only, so that the cache doesn't grow with stale pairs.
+     */
+    void BeginRun()
+    {
+        m_previous.swap( m_current );
+        m_current.clear();
+        m_misses = 0;
+    }
+
+    /**
+     * Returns true if the pair was found clean by this run or by the previous one.  A hit is
+     * kept for the next run, so an unchanged pair is never tested again.  A miss is counted
+     * as the pair is then tested.
+     */
+    bool IsClean( size_t aKey )
+    {
+        if( aKey && ( m_current.count( aKey ) || m_previous.count( aKey ) ) )
+        {
+            m_current.insert( aKey );
+            return true;
+        }
+
+        m_misses++;
+        return false;
+    }
+
+    void SetClean( size_t aKey )
+    {
+        if( aKey )
+            m_current.insert( aKey );
+    }
+
+    /**
+     * Returns the number of pairs looked up since BeginRun() which were not found clean.
+     */
+    size_t GetMisses() const { return m_misses; }
+
+    void Clear()
+    {
+        m_previous.clear();
+        m_current.clear();
+        m_misses = 0;
+    }
+
+private:
+    std::unordered_set<size_t> m_previous;
+    std::unordered_set<size_t> m_current;
+    size_t                     m_misses = 0;
+};
+
+
+#endif /* DRC_PAIR_CACHE_H_ */
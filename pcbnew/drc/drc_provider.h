@@ -29,6 +29,8 @@
 #include <class_marker_pcb.h>
 
 #include <functional>
+#include <map>
+#include <string>
 
 
 /**
@@ -54,6 +56,15 @@ public:
 
     virtual ~DRC_TEST_PROVIDER() {}
 
+    /**
+     * Returns the named work counters (e.g. the number of pairwise comparisons) of the last
+     * RunDRC() call.  These are only used for benchmarking.
+     */
+    const std::map<std::string, size_t>& GetCounters() const
+    {
+        return m_counters;
+    }
+
 protected:
     DRC_TEST_PROVIDER( MARKER_HANDLER aMarkerHandler ) :
             m_marker_handler( std::move( aMarkerHandler ) )
@@ -68,6 +79,9 @@ protected:
         m_marker_handler( aMarker );
     }
 
+    /// Work counters of the last run, reported by GetCounters()
+    std::map<std::string, size_t> m_counters;
+
 private:
     /// The handler for any generated markers
     MARKER_HANDLER m_marker_handler;
@@ -0,0 +1,154 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+
+#include <drc/drc_report_sink.h>
+
+#include <convert_to_biu.h>
+#include <drc/drc_item.h>
+#include <richio.h>
+
+
+static const char* severityName( SEVERITY aSeverity )
+{
+    switch( aSeverity )
+    {
+    case RPT_SEVERITY_ERROR:     return "error";
+    case RPT_SEVERITY_WARNING:   return "warning";
+    case RPT_SEVERITY_EXCLUSION: return "exclusion";
+    case RPT_SEVERITY_INFO:      return "info";
+    default:                     return "undefined";
+    }
+}
+
+
+/**
+ * Returns aText as the contents of a JSON string (without the enclosing quotes)
+ */
+static std::string jsonEscape( const wxString& aText )
+{
+    std::string utf8 = TO_UTF8( aText );
+    std::string escaped;
+
+    escaped.reserve( utf8.size() );
+
+    for( char c : utf8 )
+    {
+        switch( c )
+        {
+        case '"':  escaped += "\\\""; break;
+        case '\\': escaped += "\\\\"; break;
+        case '\n': escaped += "\\n";  break;
+        case '\r': escaped += "\\r";  break;
+        case '\t': escaped += "\\t";  break;
+
+        default:
+            if( (unsigned char) c < 0x20 )
+            {
+                char buf[8];
+                snprintf( buf, sizeof( buf ), "\\u%04x", c );
+                escaped += buf;
+            }
+            else
+            {
+                escaped += c;
+            }
+        }
+    }
+
+    return escaped;
+}
+
+
+/**
+ * Returns aText as a quoted CSV field
+ */
+static std::string csvQuote( const wxString& aText )
+{
+    std::string utf8 = TO_UTF8( aText );
+    std::string quoted = "\"";
+
+    for( char c : utf8 )
+    {
+        if( c == '"' )
+            quoted += '"';
+
+        quoted += c;
+    }
+
+    return quoted + '"';
+}
+
+
+void DRC_JSON_REPORT_SINK::Begin()
+{
+    m_count = 0;
+    m_output.Print( 0, "[" );
+}
+
+
+void DRC_JSON_REPORT_SINK::Report( const DRC_ITEM& aItem, const wxPoint& aPos,
+                                   SEVERITY aSeverity )
+{
+    m_output.Print( 0, "%s\n  { \"code\": %d, \"type\": \"%s\", \"severity\": \"%s\", "
+                       "\"message\": \"%s\", \"x\": %.6f, \"y\": %.6f, "
+                       "\"items\": [ \"%s\", \"%s\" ] }",
+                    m_count ? "," : "",
+                    aItem.GetErrorCode(),
+                    jsonEscape( aItem.GetErrorText( -1, false ) ).c_str(),
+                    severityName( aSeverity ),
+                    jsonEscape( aItem.GetErrorMessage() ).c_str(),
+                    Iu2Millimeter( aPos.x ),
+                    Iu2Millimeter( aPos.y ),
+                    TO_UTF8( aItem.GetMainItemID().AsString() ),
+                    TO_UTF8( aItem.GetAuxItemID().AsString() ) );
+
+    m_count++;
+}
+
+
+void DRC_JSON_REPORT_SINK::End()
+{
+    m_output.Print( 0, "\n]\n" );
+}
+
+
+void DRC_CSV_REPORT_SINK::Begin()
+{
+    m_output.Print( 0, "code,type,severity,message,x,y,item,aux_item\n" );
+}
+
+
+void DRC_CSV_REPORT_SINK::Report( const DRC_ITEM& aItem, const wxPoint& aPos,
+                                  SEVERITY aSeverity )
+{
+    m_output.Print( 0, "%d,%s,%s,%s,%.6f,%.6f,%s,%s\n",
+                    aItem.GetErrorCode(),
+                    csvQuote( aItem.GetErrorText( -1, false ) ).c_str(),
+                    severityName( aSeverity ),
+                    csvQuote( aItem.GetErrorMessage() ).c_str(),
+                    Iu2Millimeter( aPos.x ),
+                    Iu2Millimeter( aPos.y ),
+                    TO_UTF8( aItem.GetMainItemID().AsString() ),
+                    TO_UTF8( aItem.GetAuxItemID().AsString() ) );
+}
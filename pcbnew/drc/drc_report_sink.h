@@ -0,0 +1,112 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+
+#ifndef DRC_REPORT_SINK_H
+#define DRC_REPORT_SINK_H
+
+#include <widgets/ui_common.h>
+#include <wx/gdicmn.h>
+
+class DRC_ITEM;
+class OUTPUTFORMATTER;
+
+
+/**
+ * DRC_REPORT_SINK
+ * receives the violations found by a headless DRC run (see DRC::RunHeadless()), one at a
+ * time and as they are found, instead of having them added to the board as markers.
+ *
+ * The DRC serializes the calls to Report(), but they may come from any of its threads.
+ */
+class DRC_REPORT_SINK
+{
+public:
+    virtual ~DRC_REPORT_SINK() {}
+
+    /**
+     * Called once before the first violation is reported.
+     */
+    virtual void Begin() {}
+
+    /**
+     * Report a single violation.
+     *
+     * @param aItem is the violation
+     * @param aPos is the location of the violation
+     * @param aSeverity is the severity of the violation's error code in the board settings
+     */
+    virtual void Report( const DRC_ITEM& aItem, const wxPoint& aPos, SEVERITY aSeverity ) = 0;
+
+    /**
+     * Called once after the last violation has been reported.
+     */
+    virtual void End() {}
+};
+
+
+/**
+ * DRC_JSON_REPORT_SINK
+ * writes the violations as a JSON array, one object per line.  Coordinates are in
+ * millimetres.
+ */
+class DRC_JSON_REPORT_SINK : public DRC_REPORT_SINK
+{
+public:
+    DRC_JSON_REPORT_SINK( OUTPUTFORMATTER& aOutput ) :
+            m_output( aOutput ),
+            m_count( 0 )
+    {
+    }
+
+    void Begin() override;
+    void Report( const DRC_ITEM& aItem, const wxPoint& aPos, SEVERITY aSeverity ) override;
+    void End() override;
+
+private:
+    OUTPUTFORMATTER& m_output;
+    size_t           m_count;
+};
+
+
+/**
+ * DRC_CSV_REPORT_SINK
+ * writes the violations as CSV, with a header line and one line per violation.
+ * Coordinates are in millimetres.
+ */
+class DRC_CSV_REPORT_SINK : public DRC_REPORT_SINK
+{
+public:
+    DRC_CSV_REPORT_SINK( OUTPUTFORMATTER& aOutput ) :
+            m_output( aOutput )
+    {
+    }
+
+    void Begin() override;
+    void Report( const DRC_ITEM& aItem, const wxPoint& aPos, SEVERITY aSeverity ) override;
+
+private:
+    OUTPUTFORMATTER& m_output;
+};
+
+#endif // DRC_REPORT_SINK_H
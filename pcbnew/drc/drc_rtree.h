@@ -0,0 +1,240 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef DRC_RTREE_H_
+#define DRC_RTREE_H_
+
+#include <board_connected_item.h>
+#include <eda_rect.h>
+#include <layers_id_colors_and_visibility.h>
+
+#include <array>
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <geometry/rtree.h>
+
+
+/**
+ * DRC_RTREE -
+ * Implements a per-copper-layer R-tree of board items, used as the broad phase of the
+ * clearance tests.  Each item is indexed by its bounding box inflated by a caller-supplied
+ * clearance (usually the largest clearance on the board), so an overlap query with the
+ * plain bounding box of another item returns every item which may be too close to it.
+ * Items can be removed and re-inserted as they change.  Non-owning.
+ */
+class DRC_RTREE
+{
+public:
+    /**
+     * An indexed item, along with its insertion order.  The order lets callers visit each
+     * pair of items only once, by only testing candidates inserted after the reference item.
+     */
+    struct ITEM
+    {
+        BOARD_CONNECTED_ITEM* m_item;
+        int                   m_index;
+
+        bool operator==( const ITEM& aOther ) const
+        {
+            return m_item == aOther.m_item;
+        }
+    };
+
+private:
+    using drc_rtree = RTree<ITEM, int, 2, double>;
+
+public:
+    DRC_RTREE() :
+            m_count( 0 )
+    {
+        for( int layer = 0; layer < MAX_CU_LAYERS; ++layer )
+            m_tree[layer] = new drc_rtree();
+    }
+
+    ~DRC_RTREE()
+    {
+        for( drc_rtree* tree : m_tree )
+            delete tree;
+    }
+
+    // The trees are owned, so copies would delete them twice
+    DRC_RTREE( const DRC_RTREE& aOther ) = delete;
+    DRC_RTREE& operator=( const DRC_RTREE& aOther ) = delete;
+
+    /**
+     * Function Insert()
+     * Inserts an item into the tree of each of the copper layers in aLayers.  The item's
+     * bounding box is taken from GetBoundingBox() and inflated by aClearance.
+     */
+    void Insert( BOARD_CONNECTED_ITEM* aItem, LSET aLayers, int aClearance )
+    {
+        EDA_RECT bbox = aItem->GetBoundingBox();
+        bbox.Normalize();
+        bbox.Inflate( aClearance );
+
+        Insert( aItem, aLayers, bbox );
+    }
+
+    /**
+     * Function Insert()
+     * Inserts an item into the tree of each of the copper layers in aLayers, using the
+     * given (already inflated) bounding box.
+     */
+    void Insert( BOARD_CONNECTED_ITEM* aItem, LSET aLayers, const EDA_RECT& aBBox )
+    {
+        // An item inserted again is moved, and ordered after the items already indexed
+        Remove( aItem );
+
+        const int mmin[2] = { aBBox.GetX(), aBBox.GetY() };
+        const int mmax[2] = { aBBox.GetRight(), aBBox.GetBottom() };
+        ITEM      item = { aItem, m_count };
+        LSET      layers = aLayers & LSET::AllCuMask();
+
+        for( PCB_LAYER_ID layer : layers.Seq() )
+            m_tree[ layer ]->Insert( mmin, mmax, item );
+
+        m_entries[ aItem ] = { aBBox, layers, m_count };
+        m_count++;
+    }
+
+    /**
+     * Function Remove()
+     * Removes an item from the trees, if it is indexed.
+     */
+    void Remove( BOARD_CONNECTED_ITEM* aItem )
+    {
+        auto it = m_entries.find( aItem );
+
+        if( it == m_entries.end() )
+            return;
+
+        const ENTRY& entry = it->second;
+        const int    mmin[2] = { entry.m_BBox.GetX(), entry.m_BBox.GetY() };
+        const int    mmax[2] = { entry.m_BBox.GetRight(), entry.m_BBox.GetBottom() };
+        ITEM         item = { aItem, entry.m_Index };
+
+        for( PCB_LAYER_ID layer : entry.m_Layers.Seq() )
+            m_tree[ layer ]->Remove( mmin, mmax, item );
+
+        m_entries.erase( it );
+    }
+
+    /**
+     * Function Clear()
+     * Removes all items from the trees
+     */
+    void Clear()
+    {
+        for( drc_rtree* tree : m_tree )
+            tree->RemoveAll();
+
+        m_entries.clear();
+        m_count = 0;
+    }
+
+    /**
+     * Returns the insertion index of aItem (see ITEM), or -1 if it is not indexed.
+     */
+    int IndexOf( BOARD_CONNECTED_ITEM* aItem ) const
+    {
+        auto it = m_entries.find( aItem );
+
+        return it == m_entries.end() ? -1 : it->second.m_Index;
+    }
+
+    /**
+     * Function QueryColliding()
+     * Executes aVisitor for each item whose inflated bounding box intersects aBox on any of
+     * the copper layers in aLayers.  An item indexed on several of those layers is visited
+     * only once.  The visitor returns false to stop the query.
+     *
+     * Queries only read the trees, so they may run concurrently.
+     */
+    void QueryColliding( const EDA_RECT& aBox, LSET aLayers,
+                         const std::function<bool( const ITEM& )>& aVisitor ) const
+    {
+        EDA_RECT box = aBox;
+        box.Normalize();
+
+        const int mmin[2] = { box.GetX(), box.GetY() };
+        const int mmax[2] = { box.GetRight(), box.GetBottom() };
+        LSEQ      layers = ( aLayers & LSET::AllCuMask() ).Seq();
+
+        if( layers.size() == 1 )
+        {
+            m_tree[ layers[0] ]->Search( mmin, mmax, aVisitor );
+            return;
+        }
+
+        std::unordered_set<BOARD_CONNECTED_ITEM*> visited;
+        bool                                      finished = true;
+
+        auto visitOnce =
+                [&]( const ITEM& aItem ) -> bool
+                {
+                    if( !visited.insert( aItem.m_item ).second )
+                        return true;
+
+                    return aVisitor( aItem );
+                };
+
+        for( PCB_LAYER_ID layer : layers )
+        {
+            m_tree[ layer ]->Search( mmin, mmax, visitOnce, finished );
+
+            if( !finished )
+                break;
+        }
+    }
+
+    /**
+     * Returns the number of items in the tree
+     */
+    size_t size() const
+    {
+        return m_entries.size();
+    }
+
+    bool empty() const
+    {
+        return m_entries.empty();
+    }
+
+private:
+    ///> Where an item is indexed, to remove it
+    struct ENTRY
+    {
+        EDA_RECT m_BBox;
+        LSET     m_Layers;
+        int      m_Index;
+    };
+
+    std::array<drc_rtree*, MAX_CU_LAYERS>            m_tree;
+    std::unordered_map<BOARD_CONNECTED_ITEM*, ENTRY> m_entries;
+    int                                              m_count;     // next insertion index
+};
+
+
+#endif /* DRC_RTREE_H_ */
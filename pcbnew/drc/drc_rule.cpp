@@ -27,6 +27,9 @@
 #include <board_design_settings.h>
 #include <class_board.h>
 #include <class_board_item.h>
+#include <board_connected_item.h>
+
+#include <algorithm>
 
 /*
  * Rule tokens:
@@ -64,6 +67,179 @@
  *     (rule "disallowMicrovias" (disallow micro_via))
  */
 
+DRC_RULE_TABLE::DRC_RULE_TABLE( const std::vector<DRC_SELECTOR*>& aSelectors )
+{
+    for( DRC_SELECTOR* selector : aSelectors )
+    {
+        for( const NETCLASSPTR& netclass : selector->m_MatchNetclasses )
+            m_netclasses.emplace( netclass.get(), (int) m_netclasses.size() );
+
+        for( KICAD_T type : selector->m_MatchTypes )
+        {
+            if( std::find( m_types.begin(), m_types.end(), type ) == m_types.end() )
+                m_types.push_back( type );
+        }
+    }
+
+    wxASSERT( m_types.size() <= sizeof( unsigned ) * 8 );
+
+    const int otherNetclass = (int) m_netclasses.size();
+    const int noItem = otherNetclass + 1;
+
+    m_stride = noItem + 1;
+
+    auto typeBit =
+            [&]( KICAD_T aType ) -> unsigned
+            {
+                auto it = std::find( m_types.begin(), m_types.end(), aType );
+                return 1u << ( it - m_types.begin() );
+            };
+
+    for( int constraint = 0; constraint < CONSTRAINT_COUNT; ++constraint )
+    {
+        m_table[constraint].resize( m_stride * m_stride );
+
+        for( DRC_SELECTOR* selector : aSelectors )
+        {
+            if( !( selector->m_Rule->m_ConstraintFlags & ( 1 << constraint ) ) )
+                continue;
+
+            const std::vector<KICAD_T>&     types = selector->m_MatchTypes;
+            const std::vector<NETCLASSPTR>& netclasses = selector->m_MatchNetclasses;
+            COMPILED_SELECTOR               compiled;
+
+            // Like GetRule(), a selector with more than two types or netclasses doesn't filter
+            // on them
+            compiled.m_TypeCount = types.size() <= 2 ? (int) types.size() : 0;
+            compiled.m_TypeMasks[0] = compiled.m_TypeCount > 0 ? typeBit( types[0] ) : 0;
+            compiled.m_TypeMasks[1] = compiled.m_TypeCount > 1 ? typeBit( types[1] ) : 0;
+            compiled.m_MatchLayer = !selector->m_MatchLayers.empty();
+            compiled.m_Layer = compiled.m_MatchLayer ? selector->m_MatchLayers[0] : UNDEFINED_LAYER;
+            compiled.m_Selector = selector;
+
+            int first = -1;
+            int second = -1;
+
+            if( netclasses.size() == 1 || netclasses.size() == 2 )
+                first = m_netclasses.at( netclasses[0].get() );
+
+            if( netclasses.size() == 2 )
+                second = m_netclasses.at( netclasses[1].get() );
+
+            // The aItem index is never noItem; only bItem can be missing
+            for( int a = 0; a < noItem; ++a )
+            {
+                for( int b = 0; b <= noItem; ++b )
+                {
+                    if( second >= 0 )
+                    {
+                        if( b == noItem )
+                            continue;
+
+                        if( !( a == first && b == second ) && !( a == second && b == first ) )
+                            continue;
+                    }
+                    else if( first >= 0 )
+                    {
+                        if( a != first && !( b != noItem && b == first ) )
+                            continue;
+                    }
+
+                    m_table[constraint][ a * m_stride + b ].push_back( compiled );
+                }
+            }
+        }
+    }
+}
+
+
+int DRC_RULE_TABLE::netclassIndex( const BOARD_ITEM* aItem ) const
+{
+    if( !aItem )
+        return (int) m_netclasses.size() + 1;
+
+    const NETCLASS* netclass = nullptr;
+
+    if( aItem->IsConnected() )
+        netclass = static_cast<const BOARD_CONNECTED_ITEM*>( aItem )->GetEffectiveNetclass();
+
+    auto it = m_netclasses.find( netclass );
+
+    return it == m_netclasses.end() ? (int) m_netclasses.size() : it->second;
+}
+
+
+unsigned DRC_RULE_TABLE::typeMask( const BOARD_ITEM* aItem ) const
+{
+    unsigned mask = 0;
+
+    if( aItem )
+    {
+        for( size_t ii = 0; ii < m_types.size(); ++ii )
+        {
+            KICAD_T matchType[2] = { m_types[ii], EOT };
+
+            if( aItem->IsType( matchType ) )
+                mask |= 1u << ii;
+        }
+    }
+
+    return mask;
+}
+
+
+DRC_RULE* DRC_RULE_TABLE::Lookup( const BOARD_ITEM* aItem, const BOARD_ITEM* bItem,
+                                  int aConstraint ) const
+{
+    int constraint = 0;
+
+    while( constraint < CONSTRAINT_COUNT && !( aConstraint & ( 1 << constraint ) ) )
+        constraint++;
+
+    if( constraint == CONSTRAINT_COUNT )
+        return nullptr;
+
+    const std::vector<COMPILED_SELECTOR>& candidates =
+            m_table[constraint][ netclassIndex( aItem ) * m_stride + netclassIndex( bItem ) ];
+
+    if( candidates.empty() )
+        return nullptr;
+
+    unsigned aMask = typeMask( aItem );
+    unsigned bMask = typeMask( bItem );
+
+    for( const COMPILED_SELECTOR& candidate : candidates )
+    {
+        if( candidate.m_TypeCount == 2 )
+        {
+            if( !bItem )
+                continue;
+
+            unsigned first = candidate.m_TypeMasks[0];
+            unsigned second = candidate.m_TypeMasks[1];
+
+            if( !( ( aMask & first ) && ( bMask & second ) )
+                    && !( ( aMask & second ) && ( bMask & first ) ) )
+            {
+                continue;
+            }
+        }
+        else if( candidate.m_TypeCount == 1 )
+        {
+            if( !( ( aMask | bMask ) & candidate.m_TypeMasks[0] ) )
+                continue;
+        }
+
+        if( candidate.m_MatchLayer && !aItem->GetLayerSet().test( candidate.m_Layer ) )
+            continue;
+
+        return candidate.m_Selector->m_Rule;
+    }
+
+    return nullptr;
+}
+
+
 DRC_RULE* GetRule( const BOARD_ITEM* aItem, const BOARD_ITEM* bItem, int aConstraint )
 {
     // JEY TODO: the bulk of this will be replaced by Tom's expression evaluator
@@ -73,6 +249,11 @@ DRC_RULE* GetRule( const BOARD_ITEM* aItem, const BOARD_ITEM* bItem, int aConstr
     if( !board )
         return nullptr;
 
+    BOARD_DESIGN_SETTINGS& bds = board->GetDesignSettings();
+
+    if( bds.m_DRCRuleTable )
+        return bds.m_DRCRuleTable->Lookup( aItem, bItem, aConstraint );
+
     NETCLASS* aNetclass = nullptr;
     NETCLASS* bNetclass = nullptr;
 
@@ -28,6 +28,8 @@
 #include <netclass.h>
 #include <layers_id_colors_and_visibility.h>
 
+#include <unordered_map>
+
 
 class BOARD_ITEM;
 
@@ -104,6 +106,58 @@ public:
 };
 
 
+/**
+ * DRC_RULE_TABLE -
+ * The DRC rule selectors compiled into a lookup table.  The selectors which can match a pair
+ * of items are precomputed for each pair of netclasses and each constraint, so a lookup only
+ * has to test the item types (as bitmasks) and layers of a short list instead of walking all
+ * the selectors.
+ *
+ * The table refers to the selectors (and their rules) it was compiled from; it must be
+ * recompiled whenever they change.
+ */
+class DRC_RULE_TABLE
+{
+public:
+    /**
+     * Compiles aSelectors, which must be in priority order.
+     */
+    DRC_RULE_TABLE( const std::vector<DRC_SELECTOR*>& aSelectors );
+
+    /**
+     * Returns the same rule as matching the selectors in order would; see GetRule().
+     */
+    DRC_RULE* Lookup( const BOARD_ITEM* aItem, const BOARD_ITEM* bItem, int aConstraint ) const;
+
+private:
+    struct COMPILED_SELECTOR
+    {
+        int                 m_TypeCount;
+        unsigned            m_TypeMasks[2];
+        bool                m_MatchLayer;
+        PCB_LAYER_ID        m_Layer;
+        const DRC_SELECTOR* m_Selector;
+    };
+
+    static constexpr int CONSTRAINT_COUNT = 5;
+
+    int netclassIndex( const BOARD_ITEM* aItem ) const;
+    unsigned typeMask( const BOARD_ITEM* aItem ) const;
+
+    ///> The netclasses referred to by the selectors.  The index of a netclass in this list is
+    ///> its index in the table; m_netclasses.size() stands for any other netclass, and
+    ///> m_netclasses.size() + 1 for a missing second item.
+    std::unordered_map<const NETCLASS*, int>    m_netclasses;
+
+    ///> The item types referred to by the selectors, by bit of the item type masks
+    std::vector<KICAD_T>                        m_types;
+
+    ///> The selectors which match each pair of netclass indices, for each constraint bit
+    std::vector<std::vector<COMPILED_SELECTOR>> m_table[CONSTRAINT_COUNT];
+    int                                         m_stride;
+};
+
+
 DRC_RULE* GetRule( const BOARD_ITEM* aItem, const BOARD_ITEM* bItem, int aConstraint );
 
 
@@ -221,7 +221,6 @@ wxSize inline EAGLE_PLUGIN::kicad_fontz( const ECOORD& d ) const
 BOARD* EAGLE_PLUGIN::Load( const wxString& aFileName, BOARD* aAppendToMe,  const PROPERTIES* aProperties )
 {
     LOCALE_IO       toggle;     // toggles on, then off, the C locale.
-    wxXmlNode*      doc;
 
     init( aProperties );
 
@@ -236,22 +235,14 @@ BOARD* EAGLE_PLUGIN::Load( const wxString& aFileName, BOARD* aAppendToMe,  const
 
     try
     {
-        // Load the document
-        wxXmlDocument xmlDocument;
         wxFileName fn = aFileName;
 
-        if( !xmlDocument.Load( fn.GetFullPath() ) )
-            THROW_IO_ERROR( wxString::Format( _( "Unable to read file \"%s\"" ),
-                                              fn.GetFullPath() ) );
-
-        doc = xmlDocument.GetRoot();
-
         m_min_trace    = INT_MAX;
         m_min_hole     = INT_MAX;
         m_min_via      = INT_MAX;
         m_min_annulus  = INT_MAX;
 
-        loadAllSections( doc );
+        loadAllSections( fn.GetFullPath() );
 
         BOARD_DESIGN_SETTINGS& designSettings = m_board->GetDesignSettings();
 
@@ -338,48 +329,70 @@ void EAGLE_PLUGIN::clear_cu_map()
 }
 
 
-void EAGLE_PLUGIN::loadAllSections( wxXmlNode* aDoc )
+void EAGLE_PLUGIN::loadAllSections( const wxString& aFileName )
 {
-    wxXmlNode* drawing       = MapChildren( aDoc )["drawing"];
-    NODE_MAP drawingChildren = MapChildren( drawing );
-
-    wxXmlNode* board         = drawingChildren["board"];
-    NODE_MAP boardChildren   = MapChildren( board );
+    // The board is read as a stream: the signals, which are most of a routed board, are
+    // loaded one by one and freed.  The plain graphics, the libraries and the elements are
+    // kept until the end of the file, as they come before the design rules and the pads to
+    // nets map they need.
+    EAGLE_XML_READER           reader;
+    std::unique_ptr<wxXmlNode> plain;
+    std::unique_ptr<wxXmlNode> libs;
+    std::unique_ptr<wxXmlNode> elems;
+    int                        netCode = 1;
+
+    reader.OnElement( "eagle/drawing/layers",
+            [&]( std::unique_ptr<wxXmlNode> aLayers )
+            {
+                m_xpath->push( "layers" );
+                loadLayerDefs( aLayers.get() );
+                m_xpath->pop();
+            } );
 
-    m_xpath->push( "eagle.drawing" );
+    reader.OnElement( "eagle/drawing/board/designrules",
+            [&]( std::unique_ptr<wxXmlNode> aDesignRules )
+            {
+                m_xpath->push( "board" );
+                loadDesignRules( aDesignRules.get() );
+                m_xpath->pop();
+            } );
 
-    {
-        m_xpath->push( "board" );
+    reader.OnElement( "eagle/drawing/board/plain",
+            [&]( std::unique_ptr<wxXmlNode> aPlain )
+            {
+                plain = std::move( aPlain );
+            } );
 
-        wxXmlNode* designrules = boardChildren["designrules"];
-        loadDesignRules( designrules );
+    reader.OnElement( "eagle/drawing/board/libraries",
+            [&]( std::unique_ptr<wxXmlNode> aLibs )
+            {
+                libs = std::move( aLibs );
+            } );
 
-        m_xpath->pop();
-    }
+    reader.OnElement( "eagle/drawing/board/elements",
+            [&]( std::unique_ptr<wxXmlNode> aElems )
+            {
+                elems = std::move( aElems );
+            } );
 
-    {
-        m_xpath->push( "layers" );
+    reader.OnElement( "eagle/drawing/board/signals/signal",
+            [&]( std::unique_ptr<wxXmlNode> aSignal )
+            {
+                m_xpath->push( "board" );
+                loadSignal( aSignal.get(), netCode );
+                m_xpath->pop();
+            } );
 
-        wxXmlNode* layers = drawingChildren["layers"];
-        loadLayerDefs( layers );
+    m_xpath->push( "eagle.drawing" );
 
-        m_xpath->pop();
-    }
+    reader.Parse( aFileName );
 
     {
         m_xpath->push( "board" );
 
-        wxXmlNode* plain = boardChildren["plain"];
-        loadPlain( plain );
-
-        wxXmlNode*  signals = boardChildren["signals"];
-        loadSignals( signals );
-
-        wxXmlNode*  libs = boardChildren["libraries"];
-        loadLibraries( libs );
-
-        wxXmlNode* elems = boardChildren["elements"];
-        loadElements( elems );
+        loadPlain( plain.get() );
+        loadLibraries( libs.get() );
+        loadElements( elems.get() );
 
         m_xpath->pop();     // "board"
     }
@@ -2027,239 +2040,225 @@ void EAGLE_PLUGIN::deleteTemplates()
 }
 
 
-void EAGLE_PLUGIN::loadSignals( wxXmlNode* aSignals )
+void EAGLE_PLUGIN::loadSignal( wxXmlNode* aSignal, int& aNetCode )
 {
     ZONES zones;      // per net
+    bool  sawPad = false;
 
     m_xpath->push( "signals.signal", "name" );
 
-    int netCode = 1;
-
-    // Get the first signal and iterate
-    wxXmlNode* net = aSignals->GetChildren();
+    const wxString& netName = escapeName( aSignal->GetAttribute( "name" ) );
+    m_board->Add( new NETINFO_ITEM( m_board, netName, aNetCode ) );
 
-    while( net )
-    {
-        bool    sawPad = false;
+    m_xpath->Value( netName.c_str() );
 
-        zones.clear();
+    // Get the first net item and iterate
+    wxXmlNode* netItem = aSignal->GetChildren();
 
-        const wxString& netName = escapeName( net->GetAttribute( "name" ) );
-        m_board->Add( new NETINFO_ITEM( m_board, netName, netCode ) );
-
-        m_xpath->Value( netName.c_str() );
-
-        // Get the first net item and iterate
-        wxXmlNode* netItem = net->GetChildren();
+    // (contactref | polygon | wire | via)*
+    while( netItem )
+    {
+        const wxString& itemName = netItem->GetName();
 
-        // (contactref | polygon | wire | via)*
-        while( netItem )
+        if( itemName == "wire" )
         {
-            const wxString& itemName = netItem->GetName();
-
-            if( itemName == "wire" )
-            {
-                m_xpath->push( "wire" );
+            m_xpath->push( "wire" );
 
-                EWIRE        w( netItem );
-                PCB_LAYER_ID layer = kicad_layer( w.layer );
+            EWIRE        w( netItem );
+            PCB_LAYER_ID layer = kicad_layer( w.layer );
 
-                if( IsCopperLayer( layer ) )
+            if( IsCopperLayer( layer ) )
+            {
+                wxPoint start( kicad_x( w.x1 ), kicad_y( w.y1 ) );
+                double angle = 0.0;
+                double end_angle = 0.0;
+                double radius = 0.0;
+                double delta_angle = 0.0;
+                wxPoint center;
+
+                int width = w.width.ToPcbUnits();
+                if( width < m_min_trace )
+                    m_min_trace = width;
+
+                if( w.curve )
                 {
-                    wxPoint start( kicad_x( w.x1 ), kicad_y( w.y1 ) );
-                    double angle = 0.0;
-                    double end_angle = 0.0;
-                    double radius = 0.0;
-                    double delta_angle = 0.0;
-                    wxPoint center;
-
-                    int width = w.width.ToPcbUnits();
-                    if( width < m_min_trace )
-                        m_min_trace = width;
-
-                    if( w.curve )
-                    {
-                        center = ConvertArcCenter(
-                                wxPoint( kicad_x( w.x1 ), kicad_y( w.y1 ) ),
-                                wxPoint( kicad_x( w.x2 ), kicad_y( w.y2 ) ),
-                                *w.curve );
+                    center = ConvertArcCenter(
+                            wxPoint( kicad_x( w.x1 ), kicad_y( w.y1 ) ),
+                            wxPoint( kicad_x( w.x2 ), kicad_y( w.y2 ) ),
+                            *w.curve );
 
-                        angle = DEG2RAD( *w.curve );
+                    angle = DEG2RAD( *w.curve );
 
-                        end_angle = atan2( kicad_y( w.y2 ) - center.y,
-                                           kicad_x( w.x2 ) - center.x );
+                    end_angle = atan2( kicad_y( w.y2 ) - center.y,
+                                       kicad_x( w.x2 ) - center.x );
 
-                        radius = sqrt( pow( center.x - kicad_x( w.x1 ), 2 ) +
-                                       pow( center.y - kicad_y( w.y1 ), 2 ) );
+                    radius = sqrt( pow( center.x - kicad_x( w.x1 ), 2 ) +
+                                   pow( center.y - kicad_y( w.y1 ), 2 ) );
 
-                        // If we are curving, we need at least 2 segments otherwise
-                        // delta_angle == angle
-                        int segments = std::max( 2, GetArcToSegmentCount( KiROUND( radius ),
-                                ARC_HIGH_DEF, *w.curve ) - 1 );
-                        delta_angle = angle / segments;
-                    }
-
-                    while( fabs( angle ) > fabs( delta_angle ) )
-                    {
-                        wxASSERT( radius > 0.0 );
-                        wxPoint end( KiROUND( radius * cos( end_angle + angle ) + center.x ),
-                                     KiROUND( radius * sin( end_angle + angle ) + center.y ) );
-
-                        TRACK*  t = new TRACK( m_board );
-
-                        t->SetPosition( start );
-                        t->SetEnd( end );
-                        t->SetWidth( width );
-                        t->SetLayer( layer );
-                        t->SetNetCode( netCode );
-
-                        m_board->Add( t );
+                    // If we are curving, we need at least 2 segments otherwise
+                    // delta_angle == angle
+                    int segments = std::max( 2, GetArcToSegmentCount( KiROUND( radius ),
+                            ARC_HIGH_DEF, *w.curve ) - 1 );
+                    delta_angle = angle / segments;
+                }
 
-                        start = end;
-                        angle -= delta_angle;
-                    }
+                while( fabs( angle ) > fabs( delta_angle ) )
+                {
+                    wxASSERT( radius > 0.0 );
+                    wxPoint end( KiROUND( radius * cos( end_angle + angle ) + center.x ),
+                                 KiROUND( radius * sin( end_angle + angle ) + center.y ) );
 
                     TRACK*  t = new TRACK( m_board );
 
                     t->SetPosition( start );
-                    t->SetEnd( wxPoint( kicad_x( w.x2 ), kicad_y( w.y2 ) ) );
+                    t->SetEnd( end );
                     t->SetWidth( width );
                     t->SetLayer( layer );
-                    t->SetNetCode( netCode );
+                    t->SetNetCode( aNetCode );
 
                     m_board->Add( t );
-                }
-                else
-                {
-                    // put non copper wires where the sun don't shine.
+
+                    start = end;
+                    angle -= delta_angle;
                 }
 
-                m_xpath->pop();
-            }
+                TRACK*  t = new TRACK( m_board );
 
-            else if( itemName == "via" )
+                t->SetPosition( start );
+                t->SetEnd( wxPoint( kicad_x( w.x2 ), kicad_y( w.y2 ) ) );
+                t->SetWidth( width );
+                t->SetLayer( layer );
+                t->SetNetCode( aNetCode );
+
+                m_board->Add( t );
+            }
+            else
             {
-                m_xpath->push( "via" );
-                EVIA    v( netItem );
+                // put non copper wires where the sun don't shine.
+            }
 
-                PCB_LAYER_ID  layer_front_most = kicad_layer( v.layer_front_most );
-                PCB_LAYER_ID  layer_back_most  = kicad_layer( v.layer_back_most );
+            m_xpath->pop();
+        }
 
-                if( IsCopperLayer( layer_front_most ) &&
-                    IsCopperLayer( layer_back_most ) )
-                {
-                    int  kidiam;
-                    int  drillz = v.drill.ToPcbUnits();
-                    VIA* via = new VIA( m_board );
-                    m_board->Add( via );
+        else if( itemName == "via" )
+        {
+            m_xpath->push( "via" );
+            EVIA    v( netItem );
 
-                    via->SetLayerPair( layer_front_most, layer_back_most );
+            PCB_LAYER_ID  layer_front_most = kicad_layer( v.layer_front_most );
+            PCB_LAYER_ID  layer_back_most  = kicad_layer( v.layer_back_most );
 
-                    if( v.diam )
-                    {
-                        kidiam = v.diam->ToPcbUnits();
-                        via->SetWidth( kidiam );
-                    }
-                    else
-                    {
-                        double annulus = drillz * m_rules->rvViaOuter;  // eagle "restring"
-                        annulus = eagleClamp( m_rules->rlMinViaOuter, annulus,
-                                              m_rules->rlMaxViaOuter );
-                        kidiam = KiROUND( drillz + 2 * annulus );
-                        via->SetWidth( kidiam );
-                    }
+            if( IsCopperLayer( layer_front_most ) &&
+                IsCopperLayer( layer_back_most ) )
+            {
+                int  kidiam;
+                int  drillz = v.drill.ToPcbUnits();
+                VIA* via = new VIA( m_board );
+                m_board->Add( via );
 
-                    via->SetDrill( drillz );
+                via->SetLayerPair( layer_front_most, layer_back_most );
 
-                    // make sure the via diameter respects the restring rules
+                if( v.diam )
+                {
+                    kidiam = v.diam->ToPcbUnits();
+                    via->SetWidth( kidiam );
+                }
+                else
+                {
+                    double annulus = drillz * m_rules->rvViaOuter;  // eagle "restring"
+                    annulus = eagleClamp( m_rules->rlMinViaOuter, annulus,
+                                          m_rules->rlMaxViaOuter );
+                    kidiam = KiROUND( drillz + 2 * annulus );
+                    via->SetWidth( kidiam );
+                }
 
-                    if( !v.diam || via->GetWidth() <= via->GetDrill() )
-                    {
-                        double annulus = eagleClamp( m_rules->rlMinViaOuter,
-                                (double)( via->GetWidth() / 2 - via->GetDrill() ),
-                                m_rules->rlMaxViaOuter );
-                        via->SetWidth( drillz + 2 * annulus );
-                    }
+                via->SetDrill( drillz );
 
-                    if( kidiam < m_min_via )
-                        m_min_via = kidiam;
+                // make sure the via diameter respects the restring rules
 
-                    if( drillz < m_min_hole )
-                        m_min_hole = drillz;
+                if( !v.diam || via->GetWidth() <= via->GetDrill() )
+                {
+                    double annulus = eagleClamp( m_rules->rlMinViaOuter,
+                            (double)( via->GetWidth() / 2 - via->GetDrill() ),
+                            m_rules->rlMaxViaOuter );
+                    via->SetWidth( drillz + 2 * annulus );
+                }
 
-                    if( ( kidiam - drillz ) / 2 < m_min_annulus )
-                        m_min_annulus = ( kidiam - drillz ) / 2;
+                if( kidiam < m_min_via )
+                    m_min_via = kidiam;
 
-                    if( layer_front_most == F_Cu && layer_back_most == B_Cu )
-                        via->SetViaType( VIATYPE::THROUGH );
-                    else if( layer_front_most == F_Cu || layer_back_most == B_Cu )
-                        via->SetViaType( VIATYPE::MICROVIA );
-                    else
-                        via->SetViaType( VIATYPE::BLIND_BURIED );
+                if( drillz < m_min_hole )
+                    m_min_hole = drillz;
 
-                    wxPoint pos( kicad_x( v.x ), kicad_y( v.y ) );
+                if( ( kidiam - drillz ) / 2 < m_min_annulus )
+                    m_min_annulus = ( kidiam - drillz ) / 2;
 
-                    via->SetPosition( pos  );
-                    via->SetEnd( pos );
+                if( layer_front_most == F_Cu && layer_back_most == B_Cu )
+                    via->SetViaType( VIATYPE::THROUGH );
+                else if( layer_front_most == F_Cu || layer_back_most == B_Cu )
+                    via->SetViaType( VIATYPE::MICROVIA );
+                else
+                    via->SetViaType( VIATYPE::BLIND_BURIED );
 
-                    via->SetNetCode( netCode );
-                }
+                wxPoint pos( kicad_x( v.x ), kicad_y( v.y ) );
 
-                m_xpath->pop();
+                via->SetPosition( pos  );
+                via->SetEnd( pos );
+
+                via->SetNetCode( aNetCode );
             }
 
-            else if( itemName == "contactref" )
-            {
-                m_xpath->push( "contactref" );
-                // <contactref element="RN1" pad="7"/>
+            m_xpath->pop();
+        }
 
-                const wxString& reference = netItem->GetAttribute( "element" );
-                const wxString& pad       = netItem->GetAttribute( "pad" );
-                wxString key = makeKey( reference, pad ) ;
+        else if( itemName == "contactref" )
+        {
+            m_xpath->push( "contactref" );
+            // <contactref element="RN1" pad="7"/>
 
-                // D(printf( "adding refname:'%s' pad:'%s' netcode:%d netname:'%s'\n", reference.c_str(), pad.c_str(), netCode, netName.c_str() );)
+            const wxString& reference = netItem->GetAttribute( "element" );
+            const wxString& pad       = netItem->GetAttribute( "pad" );
+            wxString key = makeKey( reference, pad ) ;
 
-                m_pads_to_nets[ key ] = ENET( netCode, netName );
+            // D(printf( "adding refname:'%s' pad:'%s' netcode:%d netname:'%s'\n", reference.c_str(), pad.c_str(), aNetCode, netName.c_str() );)
 
-                m_xpath->pop();
+            m_pads_to_nets[ key ] = ENET( aNetCode, netName );
 
-                sawPad = true;
-            }
+            m_xpath->pop();
 
-            else if( itemName == "polygon" )
-            {
-                m_xpath->push( "polygon" );
-                auto* zone = loadPolygon( netItem );
+            sawPad = true;
+        }
 
-                if( zone )
-                {
-                    zones.push_back( zone );
+        else if( itemName == "polygon" )
+        {
+            m_xpath->push( "polygon" );
+            auto* zone = loadPolygon( netItem );
 
-                    if( !zone->GetIsKeepout() )
-                        zone->SetNetCode( netCode );
-                }
+            if( zone )
+            {
+                zones.push_back( zone );
 
-                m_xpath->pop();     // "polygon"
+                if( !zone->GetIsKeepout() )
+                    zone->SetNetCode( aNetCode );
             }
 
-            netItem = netItem->GetNext();
+            m_xpath->pop();     // "polygon"
         }
 
-        if( zones.size() && !sawPad )
-        {
-            // KiCad does not support an unconnected zone with its own non-zero netcode,
-            // but only when assigned netcode = 0 w/o a name...
-            for( ZONE_CONTAINER* zone : zones )
-                zone->SetNetCode( NETINFO_LIST::UNCONNECTED );
+        netItem = netItem->GetNext();
+    }
 
-            // therefore omit this signal/net.
-        }
-        else
-            netCode++;
+    if( zones.size() && !sawPad )
+    {
+        // KiCad does not support an unconnected zone with its own non-zero netcode,
+        // but only when assigned netcode = 0 w/o a name...
+        for( ZONE_CONTAINER* zone : zones )
+            zone->SetNetCode( NETINFO_LIST::UNCONNECTED );
 
-        // Get next signal
-        net = net->GetNext();
+        // therefore omit this signal/net.
     }
+    else
+        aNetCode++;
 
     m_xpath->pop();     // "signals.signal"
 }
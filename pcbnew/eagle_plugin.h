@@ -221,11 +221,21 @@ private:
 
     // all these loadXXX() throw IO_ERROR or ptree_error exceptions:
 
-    void loadAllSections( wxXmlNode* aDocument );
+    /**
+     * Function loadAllSections
+     * reads the board file as a stream, and loads its elements as they are read.
+     */
+    void loadAllSections( const wxString& aFileName );
     void loadDesignRules( wxXmlNode* aDesignRules );
     void loadLayerDefs( wxXmlNode* aLayers );
     void loadPlain( wxXmlNode* aPlain );
-    void loadSignals( wxXmlNode* aSignals );
+
+    /**
+     * Function loadSignal
+     * loads an Eagle "signal" XML element, as the net of code \a aNetCode, which is then
+     * incremented unless the signal is omitted.
+     */
+    void loadSignal( wxXmlNode* aSignal, int& aNetCode );
 
     /**
      * Function loadLibrary
@@ -0,0 +1,350 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <exporters/board_export_jobs.h>
+
+#include <class_board.h>
+#include <common.h>
+#include <pcbplot.h>
+#include <profile.h>
+#include <reporter.h>
+#include <richio.h>
+#include <thread_pool.h>
+#include <exporters/export_footprints_placefile.h>
+#include <exporters/gendrill_Excellon_writer.h>
+
+#include <algorithm>
+#include <map>
+#include <memory>
+
+#include <wx/filename.h>
+#include <wx/tokenzr.h>
+
+#if defined( __UNIX__ )
+#include <sys/resource.h>
+#endif
+
+
+/**
+ * @return the peak resident memory of the process, in kB (0 if it cannot be known)
+ */
+static long peakMemoryKb()
+{
+#if defined( __UNIX__ )
+    struct rusage usage;
+
+    if( getrusage( RUSAGE_SELF, &usage ) == 0 )
+    {
+#if defined( __APPLE__ )
+        return usage.ru_maxrss / 1024;     // in bytes on macOS
+#else
+        return usage.ru_maxrss;
+#endif
+    }
+#endif
+
+    return 0;
+}
+
+
+/**
+ * Returns aText as the contents of a JSON string (without the enclosing quotes)
+ */
+static std::string jsonEscape( const wxString& aText )
+{
+    std::string escaped;
+
+    for( char c : std::string( TO_UTF8( aText ) ) )
+    {
+        if( c == '"' || c == '\\' )
+            escaped += '\\';
+
+        if( (unsigned char) c >= 0x20 )
+            escaped += c;
+    }
+
+    return escaped;
+}
+
+
+BOARD_EXPORT_JOBS::BOARD_EXPORT_JOBS( BOARD* aBoard, const wxString& aOutputDir ) :
+        m_board( aBoard ),
+        m_outputDir( aOutputDir ),
+        m_msecs( 0.0 ),
+        m_threadCount( 0 )
+{
+}
+
+
+bool BOARD_EXPORT_JOBS::AddJobs( const wxString& aJobs, wxString& aError )
+{
+    static const std::map<wxString, PLOT_FORMAT> plotFormats = {
+        { "gerber", PLOT_FORMAT::GERBER },
+        { "pdf",    PLOT_FORMAT::PDF },
+        { "svg",    PLOT_FORMAT::SVG },
+        { "dxf",    PLOT_FORMAT::DXF },
+        { "ps",     PLOT_FORMAT::POST },
+        { "hpgl",   PLOT_FORMAT::HPGL }
+    };
+
+    std::vector<JOB>  jobs;
+    wxStringTokenizer lines( aJobs, "\r\n" );
+
+    while( lines.HasMoreTokens() )
+    {
+        wxString line = lines.GetNextToken().BeforeFirst( '#' ).Trim().Trim( false );
+
+        if( line.IsEmpty() )
+            continue;
+
+        wxArrayString words = wxSplit( line, ' ' );
+
+        words.erase( std::remove( words.begin(), words.end(), wxEmptyString ), words.end() );
+
+        JOB job;
+        job.m_Line = line;
+        job.m_Format = PLOT_FORMAT::UNDEFINED;
+        job.m_Option = false;
+        job.m_Success = false;
+        job.m_Msecs = 0.0;
+        job.m_PeakMemoryKb = 0;
+
+        wxString kind = words[0].Lower();
+        auto     format = plotFormats.find( kind );
+
+        if( format != plotFormats.end() )
+        {
+            job.m_Type = JOB_TYPE::PLOT;
+            job.m_Format = format->second;
+
+            for( size_t ii = 1; ii < words.size(); ++ii )
+            {
+                PCB_LAYER_ID layer = m_board->GetLayerID( words[ii] );
+
+                if( layer == UNDEFINED_LAYER )
+                {
+                    aError.Printf( _( "Unknown layer '%s' in '%s'" ), words[ii], line );
+                    return false;
+                }
+
+                job.m_Layers.push_back( layer );
+            }
+
+            if( job.m_Layers.empty() )
+            {
+                aError.Printf( _( "No layer to plot in '%s'" ), line );
+                return false;
+            }
+        }
+        else if( ( kind == "drill" || kind == "pos" ) && words.size() <= 2 )
+        {
+            job.m_Type = ( kind == "drill" ) ? JOB_TYPE::DRILL : JOB_TYPE::POS;
+
+            if( words.size() == 2 )
+            {
+                if( words[1].Lower() != ( kind == "drill" ? "map" : "csv" ) )
+                {
+                    aError.Printf( _( "Unknown option '%s' in '%s'" ), words[1], line );
+                    return false;
+                }
+
+                job.m_Option = true;
+            }
+        }
+        else
+        {
+            aError.Printf( _( "Unknown job '%s'" ), line );
+            return false;
+        }
+
+        jobs.push_back( job );
+    }
+
+    m_jobs.insert( m_jobs.end(), jobs.begin(), jobs.end() );
+    return true;
+}
+
+
+int BOARD_EXPORT_JOBS::Run( int aThreadCount )
+{
+    PROF_COUNTER timer;
+
+    // The locale is global to the process: set it for all the jobs before they start
+    LOCALE_IO toggle;
+
+    wxFileName outputDir = wxFileName::DirName( m_outputDir );
+
+    if( !EnsureFileDirectoryExists( &outputDir, m_board->GetFileName() ) )
+    {
+        for( JOB& job : m_jobs )
+            job.m_Success = false;
+
+        m_msecs = timer.msecs();
+        return (int) m_jobs.size();
+    }
+
+    m_outputDir = outputDir.GetPath();
+
+    auto runJob = [this]( JOB& aJob )
+    {
+        PROF_COUNTER jobTimer;
+
+        switch( aJob.m_Type )
+        {
+        case JOB_TYPE::PLOT:  aJob.m_Success = runPlotJob( aJob );  break;
+        case JOB_TYPE::DRILL: aJob.m_Success = runDrillJob( aJob ); break;
+        case JOB_TYPE::POS:   aJob.m_Success = runPosJob( aJob );   break;
+        }
+
+        aJob.m_Msecs = jobTimer.msecs();
+        aJob.m_PeakMemoryKb = peakMemoryKb();
+    };
+
+    // A plot job plots its layers concurrently, and changes the board max error while it
+    // plots the solder mask layers: the plot jobs do not run together
+    std::vector<JOB*> otherJobs;
+
+    for( JOB& job : m_jobs )
+    {
+        if( job.m_Type == JOB_TYPE::PLOT )
+            runJob( job );
+        else
+            otherJobs.push_back( &job );
+    }
+
+    std::unique_ptr<THREAD_POOL> ownPool;
+
+    if( aThreadCount > 0 )
+        ownPool = std::make_unique<THREAD_POOL>( aThreadCount );
+
+    THREAD_POOL& pool = ownPool ? *ownPool : THREAD_POOL::GetInstance();
+
+    m_threadCount = (int) pool.GetThreadCount();
+
+    pool.ParallelFor( otherJobs.size(),
+            [&]( size_t aIndex )
+            {
+                runJob( *otherJobs[aIndex] );
+            } );
+
+    m_msecs = timer.msecs();
+
+    return (int) std::count_if( m_jobs.begin(), m_jobs.end(),
+                                []( const JOB& aJob ) { return !aJob.m_Success; } );
+}
+
+
+bool BOARD_EXPORT_JOBS::runPlotJob( JOB& aJob )
+{
+    PCB_PLOT_PARAMS plotOpts = m_board->GetPlotOptions();
+
+    plotOpts.SetFormat( aJob.m_Format );
+    plotOpts.SetOutputDirectory( m_outputDir );
+
+    std::vector<wxString> fileNames;
+
+    for( PCB_LAYER_ID layer : aJob.m_Layers )
+    {
+        wxFileName fn( m_board->GetFileName() );
+        wxString   fileExt = GetDefaultPlotExtension( aJob.m_Format );
+
+        if( aJob.m_Format == PLOT_FORMAT::GERBER && plotOpts.GetUseGerberProtelExtensions() )
+            fileExt = GetGerberProtelExtension( layer );
+
+        BuildPlotFileName( &fn, m_outputDir, m_board->GetLayerName( layer ), fileExt );
+        fileNames.push_back( fn.GetFullPath() );
+    }
+
+    std::vector<bool> success = PlotBoardLayers( m_board, &plotOpts, aJob.m_Layers, fileNames,
+                                                 wxEmptyString );
+
+    return std::find( success.begin(), success.end(), false ) == success.end();
+}
+
+
+bool BOARD_EXPORT_JOBS::runDrillJob( JOB& aJob )
+{
+    EXCELLON_WRITER writer( m_board );
+
+    writer.SetFormat( true );
+    writer.SetOptions( false, false, wxPoint( 0, 0 ), false );
+    writer.SetMapFileFormat( PLOT_FORMAT::PDF );
+
+    wxString           messages;
+    WX_STRING_REPORTER reporter( &messages );
+
+    writer.CreateDrillandMapFilesSet( m_outputDir, true, aJob.m_Option, &reporter );
+
+    // The writer reports the files it cannot create between "**"
+    return !messages.Contains( "**" );
+}
+
+
+bool BOARD_EXPORT_JOBS::runPosJob( JOB& aJob )
+{
+    wxFileName fn( m_board->GetFileName() );
+
+    fn.SetPath( m_outputDir );
+    fn.SetName( fn.GetName() + "-all-pos" );
+    fn.SetExt( aJob.m_Option ? "csv" : "pos" );
+
+    PLACE_FILE_EXPORTER exporter( m_board, true, false, true, true, aJob.m_Option );
+    std::string         data = exporter.GenPositionData();
+
+    FILE* file = wxFopen( fn.GetFullPath(), wxT( "wt" ) );
+
+    if( !file )
+        return false;
+
+    bool success = fputs( data.c_str(), file ) >= 0;
+
+    return fclose( file ) == 0 && success;
+}
+
+
+void BOARD_EXPORT_JOBS::WriteReport( OUTPUTFORMATTER& aOutput ) const
+{
+    double seconds = m_msecs / 1000.0;
+    int    threads = std::max( m_threadCount, 1 );
+
+    aOutput.Print( 0, "{\n  \"jobs\": [" );
+
+    for( size_t ii = 0; ii < m_jobs.size(); ++ii )
+    {
+        const JOB& job = m_jobs[ii];
+
+        aOutput.Print( 0, "%s\n    { \"job\": \"%s\", \"success\": %s, \"seconds\": %.3f, "
+                          "\"peak_memory_kb\": %ld }",
+                       ii ? "," : "",
+                       jsonEscape( job.m_Line ).c_str(),
+                       job.m_Success ? "true" : "false",
+                       job.m_Msecs / 1000.0,
+                       job.m_PeakMemoryKb );
+    }
+
+    aOutput.Print( 0, "\n  ],\n  \"seconds\": %.3f,\n  \"threads\": %d,\n"
+                      "  \"jobs_per_second_per_thread\": %.3f\n}\n",
+                   seconds,
+                   threads,
+                   seconds > 0.0 ? m_jobs.size() / seconds / threads : 0.0 );
+}
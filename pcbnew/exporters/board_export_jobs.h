@@ -0,0 +1,109 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef BOARD_EXPORT_JOBS_H
+#define BOARD_EXPORT_JOBS_H
+
+#include <layers_id_colors_and_visibility.h>
+#include <plotter.h>
+
+#include <vector>
+
+class BOARD;
+class OUTPUTFORMATTER;
+
+
+/**
+ * BOARD_EXPORT_JOBS
+ * runs a list of fabrication exports of a board without any frame or view, for command line
+ * and CAM server scripts.
+ *
+ * The jobs are declared one per line, the '#' starting a comment:
+ *      gerber F.Cu B.Cu F.Mask B.Mask     plots each layer in its own file
+ *      pdf F.Cu F.SilkS                   (also svg, dxf, ps and hpgl)
+ *      drill [map]                        Excellon drill files, and their PDF map files
+ *      pos [csv]                          footprint position file, in mm, of both sides
+ *
+ * The board is only read by the jobs.  The plot jobs run one after the other, each one
+ * plotting its layers concurrently (see PlotBoardLayers()); the drill and position jobs then
+ * run concurrently.
+ */
+class BOARD_EXPORT_JOBS
+{
+public:
+    BOARD_EXPORT_JOBS( BOARD* aBoard, const wxString& aOutputDir );
+
+    /**
+     * Add the jobs of a job list.
+     * @param aJobs is the job list, in the syntax given above
+     * @param aError is set to the message of the first invalid line
+     * @return false if a line is invalid (no job is added then)
+     */
+    bool AddJobs( const wxString& aJobs, wxString& aError );
+
+    /**
+     * Run all the jobs.
+     * @param aThreadCount is the number of threads running the drill and position jobs
+     *                     (0 for one per core)
+     * @return the number of failed jobs
+     */
+    int Run( int aThreadCount = 0 );
+
+    /**
+     * Write the outcome, run time and process peak memory of each job run, and the overall
+     * throughput, as JSON.
+     */
+    void WriteReport( OUTPUTFORMATTER& aOutput ) const;
+
+private:
+    enum class JOB_TYPE
+    {
+        PLOT,
+        DRILL,
+        POS
+    };
+
+    struct JOB
+    {
+        JOB_TYPE                  m_Type;
+        wxString                  m_Line;       ///< the declaration of the job
+        PLOT_FORMAT               m_Format;     ///< for the plot jobs
+        std::vector<PCB_LAYER_ID> m_Layers;     ///< for the plot jobs
+        bool                      m_Option;     ///< drill map, or CSV position file
+        bool                      m_Success;
+        double                    m_Msecs;
+        long                      m_PeakMemoryKb;
+    };
+
+    bool runPlotJob( JOB& aJob );
+    bool runDrillJob( JOB& aJob );
+    bool runPosJob( JOB& aJob );
+
+    BOARD*           m_board;
+    wxString         m_outputDir;
+    std::vector<JOB> m_jobs;
+    double           m_msecs;           ///< the run time of all the jobs
+    int              m_threadCount;
+};
+
+#endif // BOARD_EXPORT_JOBS_H
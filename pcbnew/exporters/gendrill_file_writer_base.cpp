@@ -29,9 +29,14 @@
 #include <class_track.h>
 #include <collectors.h>
 #include <reporter.h>
+#include <math/util.h>      // for Clamp
+#include <math/vector2d.h>
 
 #include <gendrill_file_writer_base.h>
 
+#include <algorithm>
+#include <cmath>
+
 
 /* Helper function for sorting hole list.
  * Compare function used for sorting holes type type (plated then not plated)
@@ -70,6 +75,297 @@ static bool CmpHoleSorting( const HOLE_INFO& a, const HOLE_INFO& b )
 }
 
 
+/**
+ * A grid of the holes drilled by a tool, about one hole per cell, to find the nearest
+ * holes of a point without looking at all the holes.
+ */
+class HOLES_GRID
+{
+public:
+    HOLES_GRID( const std::vector<VECTOR2D>& aPoints ) :
+        m_points( aPoints )
+    {
+        m_origin = aPoints[0];
+        VECTOR2D end = aPoints[0];
+
+        for( const VECTOR2D& pt : aPoints )
+        {
+            m_origin.x = std::min( m_origin.x, pt.x );
+            m_origin.y = std::min( m_origin.y, pt.y );
+            end.x = std::max( end.x, pt.x );
+            end.y = std::max( end.y, pt.y );
+        }
+
+        VECTOR2D size = end - m_origin;
+        double   area = std::max( size.x, 1.0 ) * std::max( size.y, 1.0 );
+
+        m_cellSize = std::max( std::sqrt( area / aPoints.size() ), 1.0 );
+        m_cols = (int) ( size.x / m_cellSize ) + 1;
+        m_rows = (int) ( size.y / m_cellSize ) + 1;
+        m_cells.resize( (size_t) m_cols * m_rows );
+
+        for( size_t ii = 0; ii < aPoints.size(); ii++ )
+            m_cells[cellIndex( aPoints[ii] )].push_back( (int) ii );
+    }
+
+    /**
+     * Remove from the grid its point nearest to aPos.
+     * @return the removed point, or -1 if the grid is empty
+     */
+    int PopNearest( const VECTOR2D& aPos )
+    {
+        int    best = -1;
+        double bestDist = 0.0;
+        size_t bestCell = 0;
+
+        forRings( aPos,
+                [&]( size_t aCell )
+                {
+                    for( int ii : m_cells[aCell] )
+                    {
+                        double dist = ( m_points[ii] - aPos ).SquaredEuclideanNorm();
+
+                        if( best < 0 || dist < bestDist )
+                        {
+                            best = ii;
+                            bestDist = dist;
+                            bestCell = aCell;
+                        }
+                    }
+                },
+                [&]( double aMinDist )
+                {
+                    return best >= 0 && bestDist <= aMinDist * aMinDist;
+                } );
+
+        if( best >= 0 )
+        {
+            std::vector<int>& cell = m_cells[bestCell];
+            cell.erase( std::find( cell.begin(), cell.end(), best ) );
+        }
+
+        return best;
+    }
+
+    /**
+     * @return the aCount points of the grid nearest to aPoint (or less if the grid is
+     * smaller), nearest first
+     */
+    std::vector<int> Neighbours( int aPoint, size_t aCount )
+    {
+        const VECTOR2D& pos = m_points[aPoint];
+        std::vector<std::pair<double, int>> found;
+
+        forRings( pos,
+                [&]( size_t aCell )
+                {
+                    for( int ii : m_cells[aCell] )
+                    {
+                        if( ii != aPoint )
+                            found.emplace_back( ( m_points[ii] - pos ).SquaredEuclideanNorm(), ii );
+                    }
+                },
+                [&]( double aMinDist )
+                {
+                    if( found.size() < aCount )
+                        return false;
+
+                    std::nth_element( found.begin(), found.begin() + aCount - 1, found.end() );
+                    return found[aCount - 1].first <= aMinDist * aMinDist;
+                } );
+
+        std::sort( found.begin(), found.end() );
+
+        std::vector<int> neighbours;
+
+        for( size_t ii = 0; ii < found.size() && ii < aCount; ii++ )
+            neighbours.push_back( found[ii].second );
+
+        return neighbours;
+    }
+
+private:
+    size_t cellIndex( const VECTOR2D& aPos ) const
+    {
+        int col = Clamp( 0, (int) ( ( aPos.x - m_origin.x ) / m_cellSize ), m_cols - 1 );
+        int row = Clamp( 0, (int) ( ( aPos.y - m_origin.y ) / m_cellSize ), m_rows - 1 );
+
+        return (size_t) row * m_cols + col;
+    }
+
+    /**
+     * Visit the cells by square rings of increasing size around the cell of aPos, until
+     * aDone( the minimal distance from aPos to the cells not visited yet ) is true.
+     */
+    template <typename VISITOR, typename DONE>
+    void forRings( const VECTOR2D& aPos, VISITOR aVisit, DONE aDone ) const
+    {
+        size_t center = cellIndex( aPos );
+        int    col = (int) ( center % m_cols );
+        int    row = (int) ( center / m_cols );
+        int    maxRing = std::max( std::max( col, m_cols - 1 - col ),
+                                   std::max( row, m_rows - 1 - row ) );
+
+        for( int ring = 0; ring <= maxRing; ring++ )
+        {
+            for( int r = row - ring; r <= row + ring; r++ )
+            {
+                if( r < 0 || r >= m_rows )
+                    continue;
+
+                // The top and bottom rows of the ring are full, the others have two cells
+                int step = ( r == row - ring || r == row + ring ) ? 1 : 2 * ring;
+
+                for( int c = col - ring; c <= col + ring; c += std::max( step, 1 ) )
+                {
+                    if( c >= 0 && c < m_cols )
+                        aVisit( (size_t) r * m_cols + c );
+                }
+            }
+
+            // aPos is inside (or outside of the grid beyond) its cell, so the cells of the
+            // next rings are at least this far away
+            if( aDone( ring * m_cellSize ) )
+                return;
+        }
+    }
+
+    const std::vector<VECTOR2D>&  m_points;
+    VECTOR2D                      m_origin;
+    double                        m_cellSize;
+    int                           m_cols;
+    int                           m_rows;
+    std::vector<std::vector<int>> m_cells;
+};
+
+
+wxPoint OptimizeHolesPath( std::vector<HOLE_INFO>& aHoles, size_t aBegin, size_t aEnd,
+                           const wxPoint& aStart )
+{
+    // The number of neighbours of a hole tried by the 2-opt moves
+    const size_t NEIGHBOUR_COUNT = 8;
+    // The 2-opt passes stop when the path is no longer improved, or after this many passes
+    const int    MAX_PASSES = 10;
+
+    size_t count = aEnd - aBegin;
+
+    if( count < 3 )
+        return count ? aHoles[aEnd - 1].m_Hole_Pos : aStart;
+
+    std::vector<VECTOR2D> points;
+
+    for( size_t ii = aBegin; ii < aEnd; ii++ )
+        points.emplace_back( aHoles[ii].m_Hole_Pos );
+
+    std::vector<int> path;
+    std::vector<std::vector<int>> neighbours( count );
+
+    {
+        HOLES_GRID grid( points );
+
+        for( size_t ii = 0; ii < count; ii++ )
+            neighbours[ii] = grid.Neighbours( (int) ii, NEIGHBOUR_COUNT );
+
+        // Nearest neighbour path
+        VECTOR2D pos( aStart );
+
+        for( int next = grid.PopNearest( pos ); next >= 0; next = grid.PopNearest( pos ) )
+        {
+            path.push_back( next );
+            pos = points[next];
+        }
+    }
+
+    std::vector<size_t> rank( count );
+
+    for( size_t ii = 0; ii < count; ii++ )
+        rank[path[ii]] = ii;
+
+    auto dist = [&]( int a, int b )
+    {
+        return ( points[a] - points[b] ).EuclideanNorm();
+    };
+
+    // Reverse path[aFirst ... aLast]
+    auto reverse = [&]( size_t aFirst, size_t aLast )
+    {
+        std::reverse( path.begin() + aFirst, path.begin() + aLast + 1 );
+
+        for( size_t ii = aFirst; ii <= aLast; ii++ )
+            rank[path[ii]] = ii;
+    };
+
+    // 2-opt: replace the edges a-b and c-d by a-c and b-d, c being a neighbour of a.
+    // The first hole, the nearest to aStart, stays the first one.
+    bool improved = true;
+
+    for( int pass = 0; pass < MAX_PASSES && improved; pass++ )
+    {
+        improved = false;
+
+        for( size_t ii = 0; ii + 1 < count; ii++ )
+        {
+            int    a = path[ii];
+            int    b = path[ii + 1];
+            double dab = dist( a, b );
+
+            for( int c : neighbours[a] )
+            {
+                double dac = dist( a, c );
+
+                if( dac >= dab )
+                    break;
+
+                size_t jj = rank[c];
+
+                if( jj <= ii + 1 )
+                    continue;
+
+                // The path is open: when c is the last hole, the edge c-d does not exist
+                double gain = dab - dac;
+
+                if( jj + 1 < count )
+                {
+                    int d = path[jj + 1];
+                    gain += dist( c, d ) - dist( b, d );
+                }
+
+                if( gain > 1e-9 )
+                {
+                    reverse( ii + 1, jj );
+                    improved = true;
+                    b = path[ii + 1];
+                    dab = dist( a, b );
+                }
+            }
+        }
+    }
+
+    // The heuristic may be beaten by the sorted order on a few holes: keep the shortest one
+    double sortedLength = ( points[0] - VECTOR2D( aStart ) ).EuclideanNorm();
+    double pathLength = ( points[path[0]] - VECTOR2D( aStart ) ).EuclideanNorm();
+
+    for( size_t ii = 1; ii < count; ii++ )
+    {
+        sortedLength += dist( (int) ii - 1, (int) ii );
+        pathLength += dist( path[ii - 1], path[ii] );
+    }
+
+    if( sortedLength <= pathLength )
+        return aHoles[aEnd - 1].m_Hole_Pos;
+
+    std::vector<HOLE_INFO> sorted;
+    sorted.reserve( count );
+
+    for( int ii : path )
+        sorted.push_back( aHoles[aBegin + ii] );
+
+    std::copy( sorted.begin(), sorted.end(), aHoles.begin() + aBegin );
+
+    return aHoles[aEnd - 1].m_Hole_Pos;
+}
+
+
 void GENDRILL_WRITER_BASE::buildHolesList( DRILL_LAYER_PAIR aLayerPair,
                                            bool aGenerateNPTH_list )
 {
@@ -159,6 +455,24 @@ void GENDRILL_WRITER_BASE::buildHolesList( DRILL_LAYER_PAIR aLayerPair,
     // Sort holes per increasing diameter value
     sort( m_holeListBuffer.begin(), m_holeListBuffer.end(), CmpHoleSorting );
 
+    // Reorder the holes of each tool, the path of a tool starting where the previous one ends
+    if( m_optimizeHolesPath && !m_holeListBuffer.empty() )
+    {
+        wxPoint last = m_holeListBuffer[0].m_Hole_Pos;
+        size_t  first = 0;
+
+        for( size_t ii = 1; ii <= m_holeListBuffer.size(); ii++ )
+        {
+            if( ii < m_holeListBuffer.size()
+                    && m_holeListBuffer[ii].m_Hole_Diameter == m_holeListBuffer[first].m_Hole_Diameter
+                    && m_holeListBuffer[ii].m_Hole_NotPlated == m_holeListBuffer[first].m_Hole_NotPlated )
+                continue;
+
+            last = OptimizeHolesPath( m_holeListBuffer, first, ii, last );
+            first = ii;
+        }
+    }
+
     // build the tool list
     int last_hole = -1;     // Set to not initialized (this is a value not used
                             // for m_holeListBuffer[ii].m_Hole_Diameter)
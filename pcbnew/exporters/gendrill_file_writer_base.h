@@ -117,6 +117,18 @@ public:
 
 typedef std::pair<PCB_LAYER_ID, PCB_LAYER_ID>   DRILL_LAYER_PAIR;
 
+
+/**
+ * Function OptimizeHolesPath
+ * reorders the holes aHoles[aBegin ... aEnd - 1], all drilled by the same tool, to shorten
+ * the travel of the spindle between them.
+ * The path starts at the hole nearest to aStart, goes to the nearest hole not yet drilled
+ * (found in a grid of the holes), and is then improved by 2-opt moves between neighbour holes.
+ * @return the position of the last hole of the path
+ */
+wxPoint OptimizeHolesPath( std::vector<HOLE_INFO>& aHoles, size_t aBegin, size_t aEnd,
+                           const wxPoint& aStart );
+
 /**
  * GENDRILL_WRITER_BASE is a class to create drill maps and drill report,
  * and a helper class to created drill files.
@@ -143,6 +155,8 @@ protected:
                                                         // Excellon/Gerber units (i.e inches or mm)
     wxPoint                  m_offset;                  // Drill offset coordinates
     bool                     m_merge_PTH_NPTH;          // True to generate only one drill file
+    bool                     m_optimizeHolesPath;       // True to reorder the holes of each tool
+                                                        // for a shorter spindle travel
     std::vector<HOLE_INFO>   m_holeListBuffer;          // Buffer containing holes
     std::vector<DRILL_TOOL>  m_toolListBuffer;          // Buffer containing tools
 
@@ -160,6 +174,7 @@ protected:
         m_mapFileFmt      = PLOT_FORMAT::PDF;
         m_pageInfo        = NULL;
         m_merge_PTH_NPTH  = false;
+        m_optimizeHolesPath = false;
         m_zeroFormat      = DECIMAL_FORMAT;
     }
 
@@ -175,6 +190,12 @@ public:
      */
     void SetMergeOption( bool aMerge ) { m_merge_PTH_NPTH = aMerge; }
 
+    /**
+     * set the option to reorder the holes of each tool for a shorter spindle travel
+     * @param aOptimize = true to optimize the path, false to sort the holes by position
+     */
+    void SetHolesPathOptimization( bool aOptimize ) { m_optimizeHolesPath = aOptimize; }
+
     /**
      * Return the plot offset (usually the position
      * of the auxiliary axis
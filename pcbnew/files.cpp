@@ -37,8 +37,10 @@
 #include <ratsnest_data.h>
 #include <kiway.h>
 #include <kiway_player.h>
+#include <trace_events.h>
 #include <trace_helpers.h>
 #include <lockfile.cpp>
+#include <memory_accounting.h>
 #include <netlist_reader/pcb_netlist.h>
 #include <pcbnew.h>
 #include <pcbnew_id.h>
@@ -47,6 +49,9 @@
 #include <tool/tool_manager.h>
 #include <drc/drc.h>
 #include <class_board.h>
+#include <advanced_config.h>
+#include <connectivity/connectivity_data.h>
+#include <connectivity/connectivity_snapshot.h>
 #include <wx/stdpaths.h>
 #include <pcb_layer_widget.h>
 #include <wx/wupdlock.h>
@@ -543,6 +548,7 @@ bool PCB_EDIT_FRAME::OpenProjectFiles( const std::vector<wxString>& aFileSet, in
             unsigned startTime = GetRunningMicroSecs();
 #endif
 
+            TRACE_SCOPE trace( "board-load" );
             loadedBoard = pi->Load( fullFileName, NULL, &props );
 
 #if USE_INSTRUMENTATION
@@ -591,6 +597,15 @@ bool PCB_EDIT_FRAME::OpenProjectFiles( const std::vector<wxString>& aFileSet, in
         BOARD_DESIGN_SETTINGS& configBds = GetBoard()->GetDesignSettings();
         bds.m_DRCSeverities              = configBds.m_DRCSeverities;
 
+        // The connections saved with an unchanged board are restored instead of searched
+        std::shared_ptr<CN_SNAPSHOT> snapshot = std::make_shared<CN_SNAPSHOT>();
+
+        if( pluginType == IO_MGR::KICAD_SEXP
+                && ReadConnectivitySnapshot( fullFileName, *snapshot ) )
+        {
+            loadedBoard->SetConnectivitySnapshot( snapshot );
+        }
+
         SetBoard( loadedBoard );
 
         // we should not ask PLUGINs to do these items:
@@ -640,12 +655,17 @@ bool PCB_EDIT_FRAME::OpenProjectFiles( const std::vector<wxString>& aFileSet, in
 
     onBoardLoaded();
 
+    // The board may be edited from now on
+    GetBoard()->SetConnectivitySnapshot( nullptr );
+
     // Refresh the 3D view, if any
     EDA_3D_VIEWER* draw3DFrame = Get3DViewerFrame();
 
     if( draw3DFrame )
         draw3DFrame->NewDisplay();
 
+    MEMORY_ACCOUNTING::GetInstance().Trace( "board loaded" );
+
 #if 0 && defined(DEBUG)
     // Output the board object tree to stdout, but please run from command prompt:
     GetBoard()->Show( 0, std::cout );
@@ -702,6 +722,27 @@ wxString PCB_EDIT_FRAME::createBackupFile( const wxString& aFileName )
 }
 
 
+/**
+ * Writes the connectivity snapshot of a board file just saved, or removes the outdated one.
+ */
+static void saveConnectivitySnapshot( BOARD* aBoard, const wxString& aFileName )
+{
+    if( ADVANCED_CFG::GetCfg().m_SaveConnectivitySnapshots )
+    {
+        CN_SNAPSHOT snapshot;
+
+        aBoard->GetConnectivity()->GetSnapshot( aBoard, snapshot );
+
+        // The snapshot is optional: without it the board is opened as usual
+        WriteConnectivitySnapshot( aFileName, snapshot );
+    }
+    else if( wxFileExists( ConnectivitySnapshotFileName( aFileName ) ) )
+    {
+        wxRemoveFile( ConnectivitySnapshotFileName( aFileName ) );
+    }
+}
+
+
 bool PCB_EDIT_FRAME::SavePcbFile( const wxString& aFileName, bool aCreateBackupFile )
 {
     // please, keep it simple.  prompting goes elsewhere.
@@ -771,7 +812,10 @@ bool PCB_EDIT_FRAME::SavePcbFile( const wxString& aFileName, bool aCreateBackupF
     // Put the saved file in File History, unless aCreateBackupFile is false (which indicates
     // an autosave -- and we don't want autosave files in the file history).
     if( aCreateBackupFile )
+    {
         UpdateFileHistory( GetBoard()->GetFileName() );
+        saveConnectivitySnapshot( GetBoard(), pcbFileName.GetFullPath() );
+    }
 
     // Delete auto save file on successful save.
     wxFileName autoSaveFileName = pcbFileName;
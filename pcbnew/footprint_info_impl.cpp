@@ -34,11 +34,19 @@
 #include <lib_id.h>
 #include <macros.h>
 #include <pgm_base.h>
+#include <thread_pool.h>
 #include <wildcards_and_files_ext.h>
 #include <widgets/progress_reporter.h>
 
-#include <thread>
+#include <wx/dir.h>
+#include <wx/ffile.h>
+#include <wx/filename.h>
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
 #include <mutex>
+#include <unordered_map>
 
 
 void FOOTPRINT_INFO_IMPL::load()
@@ -118,10 +126,13 @@ void FOOTPRINT_LIST_IMPL::loader_job()
 bool FOOTPRINT_LIST_IMPL::ReadFootprintFiles( FP_LIB_TABLE* aTable, const wxString* aNickname,
                                               PROGRESS_REPORTER* aProgressReporter )
 {
-    long long int generatedTimestamp = aTable->GenerateTimestamp( aNickname );
+    if( !dropStaleLibraries( aTable, aNickname ) )
+    {
+        if( !aNickname )
+            publishNameIndex( aTable );
 
-    if( generatedTimestamp == m_list_timestamp )
         return true;
+    }
 
     m_progress_reporter = aProgressReporter;
     m_cancelled = false;
@@ -164,36 +175,117 @@ bool FOOTPRINT_LIST_IMPL::ReadFootprintFiles( FP_LIB_TABLE* aTable, const wxStri
             m_progress_reporter->AdvancePhase();
     }
 
-    if( m_cancelled )
-        m_list_timestamp = 0;       // God knows what we got before we were cancelled
-    else
-        m_list_timestamp = generatedTimestamp;
+    // God knows what we got before we were cancelled: the libraries stay out of date
+    if( !m_cancelled )
+    {
+        for( const auto& lib : m_stale_libs )
+        {
+            m_lib_timestamps[lib.first] = lib.second;
+            m_unsaved_libs.insert( lib.first );
+        }
+
+        if( !aNickname )
+            publishNameIndex( aTable );
+    }
+
+    m_stale_libs.clear();
 
     return m_errors.empty();
 }
 
 
+bool FOOTPRINT_LIST_IMPL::dropStaleLibraries( FP_LIB_TABLE* aTable, const wxString* aNickname )
+{
+    std::map<wxString, long long> timestamps;
+
+    if( aNickname )
+        timestamps[*aNickname] = aTable->GenerateTimestamp( aNickname );
+    else
+    {
+        for( const wxString& nickname : aTable->GetLogicalLibs() )
+            timestamps[nickname] = aTable->GenerateTimestamp( &nickname );
+    }
+
+    m_stale_libs.clear();
+
+    for( const auto& lib : timestamps )
+    {
+        auto it = m_lib_timestamps.find( lib.first );
+
+        if( it == m_lib_timestamps.end() || it->second != lib.second )
+            m_stale_libs.insert( lib );
+    }
+
+    // Footprints of other libraries or of libraries being read again, and of libraries
+    // whose reading was cancelled
+    auto isStale =
+            [&]( const std::unique_ptr<FOOTPRINT_INFO>& aInfo )
+            {
+                const wxString& nickname = aInfo->GetLibNickname();
+
+                return !timestamps.count( nickname ) || m_stale_libs.count( nickname )
+                       || !m_lib_timestamps.count( nickname );
+            };
+
+    m_list.erase( std::remove_if( m_list.begin(), m_list.end(), isStale ), m_list.end() );
+
+    for( auto it = m_lib_timestamps.begin(); it != m_lib_timestamps.end(); )
+    {
+        if( !timestamps.count( it->first ) || m_stale_libs.count( it->first ) )
+            it = m_lib_timestamps.erase( it );
+        else
+            ++it;
+    }
+
+    return !m_stale_libs.empty();
+}
+
+
+void FOOTPRINT_LIST_IMPL::publishNameIndex( FP_LIB_TABLE* aTable )
+{
+    std::vector<wxString>                  nicknames = aTable->GetLogicalLibs();
+    std::unordered_map<wxString, size_t>   order;
+    std::unordered_map<wxString, wxString> index;
+    long long                              timestamp = 0;
+
+    for( size_t ii = 0; ii < nicknames.size(); ++ii )
+        order[nicknames[ii]] = ii;
+
+    // The first library holding a name, as when the libraries are searched in turn
+    for( const std::unique_ptr<FOOTPRINT_INFO>& info : m_list )
+    {
+        auto it = index.emplace( info->GetFootprintName(), info->GetLibNickname() );
+
+        if( !it.second && order[info->GetLibNickname()] < order[it.first->second] )
+            it.first->second = info->GetLibNickname();
+    }
+
+    // The same sum as FP_LIB_TABLE::GenerateTimestamp() of all the libraries
+    for( const auto& lib : m_lib_timestamps )
+        timestamp += lib.second;
+
+    aTable->SetFootprintNameIndex( std::move( index ), timestamp );
+}
+
+
 void FOOTPRINT_LIST_IMPL::StartWorkers( FP_LIB_TABLE* aTable, wxString const* aNickname,
         FOOTPRINT_ASYNC_LOADER* aLoader, unsigned aNThreads )
 {
     m_loader = aLoader;
     m_lib_table = aTable;
 
-    // Clear data before reading files
+    // Clear data before reading files.  The footprints of the libraries up to date are kept.
     m_count_finished.store( 0 );
     m_errors.clear();
-    m_list.clear();
     m_threads.clear();
     m_queue_in.clear();
     m_queue_out.clear();
 
-    if( aNickname )
-        m_queue_in.push( *aNickname );
-    else
-    {
-        for( auto const& nickname : aTable->GetLogicalLibs() )
-            m_queue_in.push( nickname );
-    }
+    if( m_stale_libs.empty() )
+        dropStaleLibraries( aTable, aNickname );
+
+    for( const auto& lib : m_stale_libs )
+        m_queue_in.push( lib.first );
 
     m_loader->m_total_libs = m_queue_in.size();
 
@@ -218,9 +310,10 @@ void FOOTPRINT_LIST_IMPL::StopWorkers()
     m_queue_in.clear();
     m_count_finished.store( 0 );
 
-    // If we have cancelled in the middle of a load, clear our timestamp to re-load next time
+    // If we have cancelled in the middle of a load, the libraries being read are read again
+    // next time
     if( m_cancelled )
-        m_list_timestamp = 0;
+        m_stale_libs.clear();
 }
 
 bool FOOTPRINT_LIST_IMPL::JoinWorkers()
@@ -236,8 +329,6 @@ bool FOOTPRINT_LIST_IMPL::JoinWorkers()
         m_count_finished.store( 0 );
     }
 
-    size_t total_count = m_queue_out.size();
-
     LOCALE_IO toggle_locale;
 
     // Parse the footprints in parallel. WARNING! This requires changing the locale, which is
@@ -248,15 +339,38 @@ bool FOOTPRINT_LIST_IMPL::JoinWorkers()
     // TODO: blast LOCALE_IO into the sun
 
     SYNC_QUEUE<std::unique_ptr<FOOTPRINT_INFO>> queue_parsed;
-    std::vector<std::thread>                    threads;
+    std::vector<wxString>                       nicknames;
+    wxString                                    lib;
+
+    while( m_queue_out.pop( lib ) )
+        nicknames.push_back( lib );
+
+    TASK_GROUP parseGroup;
+
+    // Keep the progress dialog alive while the libraries are parsed, and stop when it is
+    // cancelled
+    std::function<void()> keepRefreshing;
 
-    for( size_t ii = 0; ii < std::thread::hardware_concurrency() + 1; ++ii )
+    if( m_progress_reporter )
     {
-        threads.emplace_back( [this, &queue_parsed]() {
-            wxString nickname;
+        keepRefreshing = [&]()
+                {
+                    if( !m_progress_reporter->KeepRefreshing() )
+                    {
+                        m_cancelled = true;
+                        parseGroup.Cancel();
+                    }
+                };
+    }
 
-            while( this->m_queue_out.pop( nickname ) && !m_cancelled )
+    parseGroup.ParallelFor( nicknames.size(),
+            [this, &queue_parsed, &nicknames]( size_t aIdx )
             {
+                const wxString& nickname = nicknames[aIdx];
+
+                if( m_cancelled )
+                    return;
+
                 wxArrayString fpnames;
 
                 try
@@ -284,28 +398,20 @@ bool FOOTPRINT_LIST_IMPL::JoinWorkers()
                 for( unsigned jj = 0; jj < fpnames.size() && !m_cancelled; ++jj )
                 {
                     wxString fpname = fpnames[jj];
-                    FOOTPRINT_INFO* fpinfo = new FOOTPRINT_INFO_IMPL( this, nickname, fpname );
-                    queue_parsed.move_push( std::unique_ptr<FOOTPRINT_INFO>( fpinfo ) );
+
+                    // The footprints are parsed here, so a broken file is reported and skipped
+                    CatchErrors( [&]() {
+                        FOOTPRINT_INFO* fpinfo = new FOOTPRINT_INFO_IMPL( this, nickname, fpname );
+                        queue_parsed.move_push( std::unique_ptr<FOOTPRINT_INFO>( fpinfo ) );
+                    } );
                 }
 
                 if( m_progress_reporter )
                     m_progress_reporter->AdvanceProgress();
 
                 m_count_finished.fetch_add( 1 );
-            }
-        } );
-    }
-
-    while( !m_cancelled && (size_t)m_count_finished.load() < total_count )
-    {
-        if( m_progress_reporter && !m_progress_reporter->KeepRefreshing() )
-            m_cancelled = true;
-
-        wxMilliSleep( 30 );
-    }
-
-    for( auto& thr : threads )
-        thr.join();
+            },
+            keepRefreshing );
 
     std::unique_ptr<FOOTPRINT_INFO> fpi;
 
@@ -325,7 +431,6 @@ bool FOOTPRINT_LIST_IMPL::JoinWorkers()
 FOOTPRINT_LIST_IMPL::FOOTPRINT_LIST_IMPL() :
     m_loader( nullptr ),
     m_count_finished( 0 ),
-    m_list_timestamp( 0 ),
     m_progress_reporter( nullptr ),
     m_cancelled( false )
 {
@@ -338,76 +443,212 @@ FOOTPRINT_LIST_IMPL::~FOOTPRINT_LIST_IMPL()
 }
 
 
-void FOOTPRINT_LIST_IMPL::WriteCacheToFile( wxTextFile* aCacheFile )
+/**
+ * The cache file of a library is a version tag, the library nickname and timestamp, and the
+ * footprint infos.  The strings are in UTF-8, prefixed by their length.
+ */
+static const char  fpCacheTag[] = "KiCad fp-info-cache 1\n";
+
+
+static void writeCacheInt( std::string& aBuffer, int64_t aValue )
+{
+    for( int ii = 0; ii < 8; ++ii )
+        aBuffer += (char) ( ( (uint64_t) aValue >> ( ii * 8 ) ) & 0xFF );
+}
+
+
+static void writeCacheString( std::string& aBuffer, const wxString& aText )
+{
+    wxScopedCharBuffer utf8 = aText.utf8_str();
+
+    writeCacheInt( aBuffer, utf8.length() );
+    aBuffer.append( utf8.data(), utf8.length() );
+}
+
+
+/**
+ * Reads the fields of a cache file, and throws std::out_of_range past its end.
+ */
+class FP_CACHE_FILE_READER
 {
-    if( aCacheFile->Exists() )
+public:
+    FP_CACHE_FILE_READER( const std::string& aData, size_t aStart ) :
+            m_data( aData ),
+            m_pos( aStart )
+    {
+    }
+
+    bool AtEnd() const { return m_pos == m_data.size(); }
+
+    int64_t ReadInt()
+    {
+        uint64_t value = 0;
+
+        need( 8 );
+
+        for( int ii = 0; ii < 8; ++ii )
+            value |= (uint64_t) (unsigned char) m_data[m_pos++] << ( ii * 8 );
+
+        return (int64_t) value;
+    }
+
+    wxString ReadString()
     {
-        if( !aCacheFile->Open() )
-            return;
+        int64_t len = ReadInt();
 
-        aCacheFile->Clear();
+        if( len < 0 )
+            throw std::out_of_range( "fp-info-cache" );
+
+        need( (size_t) len );
+        m_pos += (size_t) len;
+
+        return wxString::FromUTF8( m_data.data() + m_pos - len, (size_t) len );
     }
-    else
+
+private:
+    void need( size_t aCount )
     {
-        if( !aCacheFile->Create() )
-            return;
+        if( aCount > m_data.size() - m_pos )
+            throw std::out_of_range( "fp-info-cache" );
     }
 
-    aCacheFile->AddLine( wxString::Format( "%lld", m_list_timestamp ) );
+    const std::string& m_data;
+    size_t             m_pos;
+};
+
+
+static wxString cacheFileName( const wxString& aCachePath, const wxString& aNickname )
+{
+    wxString name = aNickname;
+
+    ReplaceIllegalFileNameChars( name, 0 );
+
+    return aCachePath + wxFileName::GetPathSeparator() + name;
+}
+
+
+void FOOTPRINT_LIST_IMPL::WriteCacheToFile( const wxString& aCachePath )
+{
+    if( m_unsaved_libs.empty() )
+        return;
+
+    // Former caches are a single text file
+    if( wxFileName::FileExists( aCachePath ) )
+        wxRemoveFile( aCachePath );
+
+    if( !wxFileName::DirExists( aCachePath ) && !wxFileName::Mkdir( aCachePath ) )
+        return;
 
-    for( auto& fpinfo : m_list )
+    for( const wxString& nickname : m_unsaved_libs )
     {
-        aCacheFile->AddLine( fpinfo->GetLibNickname() );
-        aCacheFile->AddLine( fpinfo->GetName() );
-        aCacheFile->AddLine( EscapeString( fpinfo->GetDescription(), CTX_DELIMITED_STR ) );
-        aCacheFile->AddLine( EscapeString( fpinfo->GetKeywords(), CTX_DELIMITED_STR ) );
-        aCacheFile->AddLine( wxString::Format( "%d", fpinfo->GetOrderNum() ) );
-        aCacheFile->AddLine( wxString::Format( "%u", fpinfo->GetPadCount() ) );
-        aCacheFile->AddLine( wxString::Format( "%u", fpinfo->GetUniquePadCount() ) );
+        auto timestamp = m_lib_timestamps.find( nickname );
+
+        if( timestamp == m_lib_timestamps.end() )
+            continue;
+
+        std::string buffer( fpCacheTag );
+
+        writeCacheString( buffer, nickname );
+        writeCacheInt( buffer, timestamp->second );
+
+        for( const std::unique_ptr<FOOTPRINT_INFO>& fpinfo : m_list )
+        {
+            if( fpinfo->GetLibNickname() != nickname )
+                continue;
+
+            writeCacheString( buffer, fpinfo->GetName() );
+            writeCacheString( buffer, fpinfo->GetDescription() );
+            writeCacheString( buffer, fpinfo->GetKeywords() );
+            writeCacheInt( buffer, fpinfo->GetOrderNum() );
+            writeCacheInt( buffer, fpinfo->GetPadCount() );
+            writeCacheInt( buffer, fpinfo->GetUniquePadCount() );
+        }
+
+        wxFFile file( cacheFileName( aCachePath, nickname ), "wb" );
+
+        if( file.IsOpened() )
+            file.Write( buffer.data(), buffer.size() );
     }
 
-    aCacheFile->Write();
-    aCacheFile->Close();
+    m_unsaved_libs.clear();
 }
 
 
-void FOOTPRINT_LIST_IMPL::ReadCacheFromFile( wxTextFile* aCacheFile )
+void FOOTPRINT_LIST_IMPL::ReadCacheFromFile( const wxString& aCachePath )
 {
-    m_list_timestamp = 0;
+    m_lib_timestamps.clear();
+    m_unsaved_libs.clear();
     m_list.clear();
 
-    try
+    wxDir    dir( aCachePath );
+    wxString fileName;
+
+    if( !wxFileName::DirExists( aCachePath ) || !dir.IsOpened()
+            || !dir.GetFirst( &fileName, wxEmptyString, wxDIR_FILES ) )
     {
-        if( aCacheFile->Exists() && aCacheFile->Open() )
+        return;
+    }
+
+    do
+    {
+        wxFFile     file( aCachePath + wxFileName::GetPathSeparator() + fileName, "rb" );
+        std::string data;
+
+        if( !file.IsOpened() || file.Length() <= 0 )
+            continue;
+
+        data.resize( (size_t) file.Length() );
+
+        if( file.Read( &data[0], data.size() ) != data.size()
+                || data.compare( 0, strlen( fpCacheTag ), fpCacheTag ) != 0 )
         {
-            aCacheFile->GetFirstLine().ToLongLong( &m_list_timestamp );
+            continue;
+        }
+
+        FPILIST   libList;
+        wxString  nickname;
+        long long timestamp;
+
+        try
+        {
+            FP_CACHE_FILE_READER reader( data, strlen( fpCacheTag ) );
 
-            while( aCacheFile->GetCurrentLine() + 6 < aCacheFile->GetLineCount() )
+            nickname = reader.ReadString();
+            timestamp = reader.ReadInt();
+
+            while( !reader.AtEnd() )
             {
-                wxString libNickname = aCacheFile->GetNextLine();
-                wxString name = aCacheFile->GetNextLine();
-                wxString description = UnescapeString( aCacheFile->GetNextLine() );
-                wxString keywords = UnescapeString( aCacheFile->GetNextLine() );
-                int orderNum = wxAtoi( aCacheFile->GetNextLine() );
-                unsigned int padCount = (unsigned) wxAtoi( aCacheFile->GetNextLine() );
-                unsigned int uniquePadCount = (unsigned) wxAtoi( aCacheFile->GetNextLine() );
-
-                auto* fpinfo = new FOOTPRINT_INFO_IMPL( libNickname, name, description, keywords,
+                wxString     name = reader.ReadString();
+                wxString     description = reader.ReadString();
+                wxString     keywords = reader.ReadString();
+                int          orderNum = (int) reader.ReadInt();
+                unsigned int padCount = (unsigned) reader.ReadInt();
+                unsigned int uniquePadCount = (unsigned) reader.ReadInt();
+
+                auto* fpinfo = new FOOTPRINT_INFO_IMPL( nickname, name, description, keywords,
                                                         orderNum, padCount, uniquePadCount );
-                m_list.emplace_back( std::unique_ptr<FOOTPRINT_INFO>( fpinfo ) );
+                libList.emplace_back( std::unique_ptr<FOOTPRINT_INFO>( fpinfo ) );
             }
         }
-    }
-    catch( ... )
-    {
-        // whatever went wrong, invalidate the cache
-        m_list_timestamp = 0;
-    }
+        catch( ... )
+        {
+            // whatever went wrong, the library is read again
+            continue;
+        }
+
+        // Sanity check: an empty library is very unlikely to be correct.
+        if( libList.empty() || m_lib_timestamps.count( nickname ) )
+            continue;
 
-    // Sanity check: an empty list is very unlikely to be correct.
-    if( m_list.size() == 0 )
-        m_list_timestamp = 0;
+        m_lib_timestamps[nickname] = timestamp;
 
-    if( aCacheFile->IsOpened() )
-        aCacheFile->Close();
+        for( std::unique_ptr<FOOTPRINT_INFO>& fpinfo : libList )
+            m_list.push_back( std::move( fpinfo ) );
+    } while( dir.GetNext( &fileName ) );
+
+    std::sort( m_list.begin(), m_list.end(), []( std::unique_ptr<FOOTPRINT_INFO> const& lhs,
+                                                 std::unique_ptr<FOOTPRINT_INFO> const& rhs ) -> bool
+                                             {
+                                                 return *lhs < *rhs;
+                                             } );
 }
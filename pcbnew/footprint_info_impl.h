@@ -22,7 +22,9 @@
 
 #include <atomic>
 #include <functional>
+#include <map>
 #include <memory>
+#include <set>
 #include <thread>
 #include <vector>
 
@@ -88,7 +90,15 @@ class FOOTPRINT_LIST_IMPL : public FOOTPRINT_LIST
     SYNC_QUEUE<wxString>     m_queue_in;
     SYNC_QUEUE<wxString>     m_queue_out;
     std::atomic_size_t       m_count_finished;
-    long long                m_list_timestamp;
+
+    ///> The timestamps of the libraries in m_list, for FP_LIB_TABLE::GenerateTimestamp()
+    std::map<wxString, long long> m_lib_timestamps;
+
+    ///> The libraries being read, with the timestamps they will have once read
+    std::map<wxString, long long> m_stale_libs;
+
+    ///> The libraries read since the last WriteCacheToFile()
+    std::set<wxString>       m_unsaved_libs;
     PROGRESS_REPORTER*       m_progress_reporter;
     std::atomic_bool         m_cancelled;
     std::mutex               m_join;
@@ -113,12 +123,27 @@ protected:
      */
     void loader_job();
 
+    /**
+     * Remove from m_list the footprints of the libraries which are not asked for, or are out
+     * of date, and fill m_stale_libs with the libraries to read.
+     *
+     * @param aNickname is the only library asked for, or NULL for all the libraries of aTable.
+     * @return true if there are libraries to read.
+     */
+    bool dropStaleLibraries( FP_LIB_TABLE* aTable, const wxString* aNickname );
+
+    /**
+     * Give aTable the index of the names of the footprints of m_list, which must hold all
+     * its libraries, for FP_LIB_TABLE::FootprintLoadWithOptionalNickname().
+     */
+    void publishNameIndex( FP_LIB_TABLE* aTable );
+
 public:
     FOOTPRINT_LIST_IMPL();
     virtual ~FOOTPRINT_LIST_IMPL();
 
-    void WriteCacheToFile( wxTextFile* aFile ) override;
-    void ReadCacheFromFile( wxTextFile* aFile ) override;
+    void WriteCacheToFile( const wxString& aCachePath ) override;
+    void ReadCacheFromFile( const wxString& aCachePath ) override;
 
     bool ReadFootprintFiles( FP_LIB_TABLE* aTable, const wxString* aNickname = nullptr,
                              PROGRESS_REPORTER* aProgressReporter = nullptr ) override;
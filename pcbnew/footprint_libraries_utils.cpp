@@ -517,8 +517,8 @@ bool PCB_BASE_EDIT_FRAME::AddLibrary( const wxString& aFilename )
         if( saveInGlobalTable )
         {
             auto row = new FP_LIB_TABLE_ROW( libName, normalizedPath, type, wxEmptyString );
-            GFootprintTable.InsertRow( row );
-            GFootprintTable.Save( FP_LIB_TABLE::GetGlobalTableFileName() );
+            FP_LIB_TABLE::GetGlobalLibTable().InsertRow( row );
+            FP_LIB_TABLE::GetGlobalLibTable().Save( FP_LIB_TABLE::GetGlobalTableFileName() );
         }
         else if( saveInProjectTable )
         {
@@ -101,7 +101,7 @@ void FP_TREE_SYNCHRONIZING_ADAPTER::Sync()
 
 int FP_TREE_SYNCHRONIZING_ADAPTER::GetLibrariesCount() const
 {
-    return GFootprintTable.GetCount();
+    return FP_LIB_TABLE::GetGlobalLibTable().GetCount();
 }
 
 
@@ -78,8 +78,13 @@ Vary: Accept-Encoding
 #include <wx/zipstrm.h>
 #include <wx/mstream.h>
 #include <wx/uri.h>
+#include <wx/ffile.h>
+#include <wx/filename.h>
+#include <wx/stdpaths.h>
 
 #include <fctsys.h>
+#include <common.h>
+#include <kicad_string.h>
 
 #include <io_mgr.h>
 #include <richio.h>
@@ -552,6 +557,73 @@ bool GITHUB_PLUGIN::repoURL_zipURL( const wxString& aRepoURL, std::string* aZipU
 }
 
 
+/**
+ * Return the directory of the downloaded zip archives, with a trailing separator, or an
+ * empty string if it cannot be created.  It is next to the 3D model cache:
+ *
+ * 1. OSX: ~/Library/Caches/kicad/github/
+ * 2. Linux: ${XDG_CACHE_HOME}/kicad/github ~/.cache/kicad/github/
+ * 3. MSWin: AppData\Local\kicad\github
+ */
+static wxString zipCacheDir()
+{
+    wxString cacheDir;
+
+#if defined(_WIN32)
+    wxStandardPaths::Get().UseAppInfo( wxStandardPaths::AppInfo_None );
+    cacheDir = wxStandardPaths::Get().GetUserLocalDataDir();
+    cacheDir.append( "\\kicad\\github" );
+#elif defined(__APPLE)
+    cacheDir = "${HOME}/Library/Caches/kicad/github";
+#else   // assume Linux
+    cacheDir = ExpandEnvVarSubstitutions( "${XDG_CACHE_HOME}", nullptr );
+
+    if( cacheDir.empty() || cacheDir == "${XDG_CACHE_HOME}" )
+        cacheDir = "${HOME}/.cache";
+
+    cacheDir.append( "/kicad/github" );
+#endif
+
+    wxFileName dir( ExpandEnvVarSubstitutions( cacheDir, nullptr ), "" );
+
+    if( !dir.DirExists() && !dir.Mkdir( wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL ) )
+        return wxEmptyString;
+
+    return dir.GetPathWithSep();
+}
+
+
+static bool readCacheFile( const wxString& aFileName, std::string* aData )
+{
+    wxFFile file;
+
+    if( !wxFileName::FileExists( aFileName ) || !file.Open( aFileName, "rb" ) )
+        return false;
+
+    aData->resize( (size_t) file.Length() );
+
+    return aData->empty() || file.Read( &(*aData)[0], aData->size() ) == aData->size();
+}
+
+
+static void writeCacheFile( const wxString& aFileName, const std::string& aData )
+{
+    // Written aside, then renamed: a concurrent reader never sees a partial file
+    wxString tmpName = aFileName + ".tmp";
+    wxFFile  file( tmpName, "wb" );
+
+    if( !file.IsOpened() )
+        return;
+
+    bool ok = file.Write( aData.data(), aData.size() ) == aData.size();
+
+    ok &= file.Close();
+
+    if( !ok || !wxRenameFile( tmpName, aFileName, true ) )
+        wxRemoveFile( tmpName );
+}
+
+
 void GITHUB_PLUGIN::remoteGetZip( const wxString& aRepoURL )
 {
     std::string  zip_url;
@@ -567,6 +639,42 @@ void GITHUB_PLUGIN::remoteGetZip( const wxString& aRepoURL )
 
     wxLogDebug( wxT( "Attempting to download: " ) + zip_url );
 
+    // The last download of each archive is kept, with its validators (the ETag and
+    // Last-Modified headers of the response) in a ".tag" file.  The server is asked for
+    // the archive only if it changed since, and answers 304 Not Modified otherwise.
+    wxString    cacheDir = zipCacheDir();
+    wxString    zipFile;
+    wxString    tagFile;
+    std::string cachedZip;
+    std::string etag;
+    std::string lastModified;
+
+    if( !cacheDir.empty() )
+    {
+        wxString name = zip_url;
+        std::string tags;
+
+        ReplaceIllegalFileNameChars( name, '_' );
+        name.Replace( "/", "_" );
+        name.Replace( ":", "_" );
+        zipFile = cacheDir + name + ".zip";
+        tagFile = cacheDir + name + ".tag";
+
+        if( readCacheFile( zipFile, &cachedZip ) && readCacheFile( tagFile, &tags ) )
+        {
+            size_t eol = tags.find( '\n' );
+
+            etag = tags.substr( 0, eol );
+
+            if( eol != std::string::npos )
+                lastModified = tags.substr( eol + 1 );
+        }
+        else
+        {
+            cachedZip.clear();
+        }
+    }
+
     KICAD_CURL_EASY kcurl;      // this can THROW_IO_ERROR
 
     kcurl.SetURL( zip_url.c_str() );
@@ -574,13 +682,42 @@ void GITHUB_PLUGIN::remoteGetZip( const wxString& aRepoURL )
     kcurl.SetHeader( "Accept", "application/zip" );
     kcurl.SetFollowRedirects( true );
 
+    // The libraries of a table are often all on github.com: their downloads, made by the
+    // footprint list loader threads, reuse the same connection and TLS session
+    kcurl.SetShareConnections();
+
+    if( !cachedZip.empty() )
+    {
+        if( !etag.empty() )
+            kcurl.SetHeader( "If-None-Match", etag );
+
+        if( !lastModified.empty() )
+            kcurl.SetHeader( "If-Modified-Since", lastModified );
+    }
+
     try
     {
         kcurl.Perform();
+
+        if( !cachedZip.empty() && kcurl.GetResponseCode() == 304 )
+        {
+            wxLogDebug( wxT( "Not modified, using the cached archive: " ) + zipFile );
+            m_zip_image = std::move( cachedZip );
+            return;
+        }
+
         m_zip_image = kcurl.GetBuffer();
     }
     catch( const IO_ERROR& ioe )
     {
+        // Offline: the last download is better than nothing
+        if( !cachedZip.empty() )
+        {
+            wxLogDebug( wxT( "Download failed, using the cached archive: " ) + zipFile );
+            m_zip_image = std::move( cachedZip );
+            return;
+        }
+
         // https "GET" has failed, report this to API caller.
         // Note: kcurl.Perform() does not return an error if the file to download is not found
         static const char errorcmd[] = "http GET command failed";  // Do not translate this message
@@ -607,6 +744,16 @@ void GITHUB_PLUGIN::remoteGetZip( const wxString& aRepoURL )
 
         THROW_IO_ERROR( msg );
     }
+
+    etag = kcurl.GetResponseHeader( "ETag" );
+    lastModified = kcurl.GetResponseHeader( "Last-Modified" );
+
+    if( !zipFile.empty() && kcurl.GetResponseCode() == 200
+            && ( !etag.empty() || !lastModified.empty() ) )
+    {
+        writeCacheFile( zipFile, m_zip_image );
+        writeCacheFile( tagFile, etag + "\n" + lastModified );
+    }
 }
 
 #if 0 && defined(STANDALONE)
@@ -222,6 +222,10 @@ protected:
      * fetches a zip file image from a github repo synchronously.  The byte image
      * is received into the m_input_stream. If the image has already been stored,
      * do nothing.
+     *
+     * The archive is kept in the user's cache directory, and downloaded again only if
+     * the server reports it changed (a conditional request on its ETag and Last-Modified
+     * date).  The cached archive is also used when the server cannot be reached.
      */
     void remoteGetZip( const wxString& aRepoURL );
 
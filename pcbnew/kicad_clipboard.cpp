@@ -34,6 +34,99 @@
 #include <kicad_plugin.h>
 #include <kicad_clipboard.h>
 
+#include <memory>
+
+
+/**
+ * The items last copied by this process, with the text they were copied as.  While the
+ * clipboard holds this text, a paste makes copies of these items instead of parsing it.
+ */
+static struct CLIPBOARD_CACHE
+{
+    std::string             m_Text;
+    std::unique_ptr<BOARD>  m_Board;    ///< if the text is a board
+    std::unique_ptr<MODULE> m_Module;   ///< if the text is a footprint
+
+    void Clear()
+    {
+        m_Text.clear();
+        m_Board.reset();
+        m_Module.reset();
+    }
+} s_clipboardCache;
+
+
+/**
+ * Clear the flags of aItem and its children: a parsed item has none.
+ */
+static void clearFlags( BOARD_ITEM* aItem )
+{
+    aItem->ClearFlags();
+
+    if( MODULE* module = dyn_cast<MODULE*>( aItem ) )
+        module->RunOnChildren( []( BOARD_ITEM* aChild ) { aChild->ClearFlags(); } );
+}
+
+
+/**
+ * Give the connected items of aItem (a footprint, a track or a zone of aBoard) the net of
+ * aBoard with the same name as their current net, adding the missing nets to aBoard.
+ */
+static void mapNetsByName( BOARD* aBoard, BOARD_ITEM* aItem )
+{
+    auto mapNet = [aBoard]( BOARD_CONNECTED_ITEM* aConnected )
+    {
+        NETINFO_ITEM* net = aBoard->FindNet( aConnected->GetNetname() );
+
+        if( !net )
+        {
+            net = new NETINFO_ITEM( aBoard, aConnected->GetNetname() );
+            aBoard->Add( net );
+        }
+
+        aConnected->SetNet( net );
+    };
+
+    if( MODULE* module = dyn_cast<MODULE*>( aItem ) )
+    {
+        for( D_PAD* pad : module->Pads() )
+            mapNet( pad );
+    }
+    else if( BOARD_CONNECTED_ITEM* connected = dyn_cast<BOARD_CONNECTED_ITEM*>( aItem ) )
+    {
+        mapNet( connected );
+    }
+}
+
+
+/**
+ * Add aItem to aBoard as the parser would: without flags, and with nets of aBoard.
+ */
+static void addParsedLike( BOARD* aBoard, BOARD_ITEM* aItem )
+{
+    clearFlags( aItem );
+    aBoard->Add( aItem, ADD_MODE::APPEND );
+    mapNetsByName( aBoard, aItem );
+}
+
+
+/**
+ * @return a copy of aModule as parsed from the clipboard: without board, nets and flags
+ */
+static MODULE* copyParsedLike( const MODULE& aModule )
+{
+    MODULE* copy = new MODULE( aModule );
+
+    copy->SetParent( nullptr );
+    clearFlags( copy );
+
+    for( D_PAD* pad : copy->Pads() )
+        pad->SetNet( NETINFO_LIST::OrphanedItem() );
+
+    return copy;
+}
+
+
 CLIPBOARD_IO::CLIPBOARD_IO():
     PCB_IO( CTL_STD_LAYER_NAMES ),
     m_formatter(),
@@ -75,6 +168,8 @@ void CLIPBOARD_IO::SaveSelection( const PCBNEW_SELECTION& aSelected )
     // Prepare net mapping that assures that net codes saved in a file are consecutive integers
     m_mapping->SetBoard( m_board );
 
+    s_clipboardCache.Clear();
+
     // Differentiate how it is formatted depending on what selection contains
     bool onlyModuleParts = true;
     for( const auto i : aSelected )
@@ -111,6 +206,8 @@ void CLIPBOARD_IO::SaveSelection( const PCBNEW_SELECTION& aSelected )
         newModule.Move( wxPoint( -refPoint.x, -refPoint.y ) );
 
         Format( static_cast<BOARD_ITEM*>( &newModule ) );
+
+        s_clipboardCache.m_Module.reset( copyParsedLike( newModule ) );
     }
     // partial module selected.
     else if( onlyModuleParts )
@@ -142,6 +239,7 @@ void CLIPBOARD_IO::SaveSelection( const PCBNEW_SELECTION& aSelected )
 
         Format( &partialModule, 0 );
 
+        s_clipboardCache.m_Module.reset( copyParsedLike( partialModule ) );
     }
     // lots of stuff selected
     else
@@ -161,6 +259,9 @@ void CLIPBOARD_IO::SaveSelection( const PCBNEW_SELECTION& aSelected )
 
         m_formatter.Print( 0, "\n" );
 
+        s_clipboardCache.m_Board = std::make_unique<BOARD>();
+        s_clipboardCache.m_Board->SetEnabledLayers( m_board->GetEnabledLayers() );
+
 
         for( const auto i : aSelected )
         {
@@ -182,11 +283,15 @@ void CLIPBOARD_IO::SaveSelection( const PCBNEW_SELECTION& aSelected )
                 clone->Move( (wxPoint) -refPoint );
 
                 Format( clone.get(), 1 );
+
+                addParsedLike( s_clipboardCache.m_Board.get(), clone.release() );
             }
         }
         m_formatter.Print( 0, "\n)" );
     }
 
+    s_clipboardCache.m_Text = m_formatter.GetString();
+
     // These are placed at the end to minimize the open time of the clipboard
     auto clipboard = wxTheClipboard;
     wxClipboardLocker clipboardLock( clipboard );
@@ -235,6 +340,35 @@ BOARD_ITEM* CLIPBOARD_IO::Parse()
         result = data.GetText();
     }
 
+    // The clipboard still holds the last copy of this process: copy the items instead of
+    // parsing them (much faster for large selections)
+    if( !s_clipboardCache.m_Text.empty()
+            && s_clipboardCache.m_Text == (const char*) result.utf8_str() )
+    {
+        if( s_clipboardCache.m_Module )
+            return copyParsedLike( *s_clipboardCache.m_Module );
+
+        if( s_clipboardCache.m_Board )
+        {
+            BOARD* board = new BOARD();
+
+            board->SetEnabledLayers( s_clipboardCache.m_Board->GetEnabledLayers() );
+
+            auto addCopies = [board]( const auto& aItems )
+            {
+                for( BOARD_ITEM* item : aItems )
+                    addParsedLike( board, static_cast<BOARD_ITEM*>( item->Clone() ) );
+            };
+
+            addCopies( s_clipboardCache.m_Board->Tracks() );
+            addCopies( s_clipboardCache.m_Board->Modules() );
+            addCopies( s_clipboardCache.m_Board->Drawings() );
+            addCopies( s_clipboardCache.m_Board->Zones() );
+
+            return board;
+        }
+    }
+
     try
     {
         item = PCB_IO::Parse( result );
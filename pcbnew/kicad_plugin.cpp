@@ -22,11 +22,15 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
  */
 
+#include <atomic>
+#include <exception>
+
 #include <fctsys.h>
 #include <kicad_string.h>
 #include <common.h>
 #include <build_version.h>      // LEGACY_BOARD_FILE_VERSION
 #include <macros.h>
+#include <memory_accounting.h>
 #include <wildcards_and_files_ext.h>
 #include <base_units.h>
 #include <trace_helpers.h>
@@ -52,6 +56,7 @@
 #include <connectivity/connectivity_data.h>
 #include <convert_basic_shapes_to_polygon.h>    // for enum RECT_CHAMFER_POSITIONS definition
 #include <kiface_i.h>
+#include <thread_pool.h>
 
 #include <advanced_config.h> // for pad pin function and pad property feature management
 
@@ -86,19 +91,26 @@ void filterNetClass( const BOARD& aBoard, NETCLASS& aNetClass )
 class FP_CACHE_ITEM
 {
     WX_FILENAME             m_filename;
-    std::unique_ptr<MODULE> m_module;
+    std::unique_ptr<MODULE> m_module;       ///< NULL until the file is parsed
+    long long               m_timestamp;    ///< of the file, when it was listed or saved
 
 public:
-    FP_CACHE_ITEM( MODULE* aModule, const WX_FILENAME& aFileName );
+    FP_CACHE_ITEM( MODULE* aModule, const WX_FILENAME& aFileName, long long aTimestamp = 0 );
 
     const WX_FILENAME& GetFileName() const { return m_filename; }
     const MODULE*      GetModule()   const { return m_module.get(); }
+    long long          GetTimestamp() const { return m_timestamp; }
+
+    void SetModule( MODULE* aModule ) { m_module.reset( aModule ); }
+    void SetTimestamp( long long aTimestamp ) { m_timestamp = aTimestamp; }
 };
 
 
-FP_CACHE_ITEM::FP_CACHE_ITEM( MODULE* aModule, const WX_FILENAME& aFileName ) :
+FP_CACHE_ITEM::FP_CACHE_ITEM( MODULE* aModule, const WX_FILENAME& aFileName,
+                              long long aTimestamp ) :
     m_filename( aFileName ),
-    m_module( aModule )
+    m_module( aModule ),
+    m_timestamp( aTimestamp )
 { }
 
 
@@ -112,13 +124,17 @@ class FP_CACHE
     PCB_IO*         m_owner;            // Plugin object that owns the cache.
     wxFileName      m_lib_path;         // The path of the library.
     wxString        m_lib_raw_path;     // For quick comparisons.
-    MODULE_MAP      m_modules;          // Map of footprint file name per MODULE*.
+    MODULE_MAP      m_modules;          // Map of footprint file name per MODULE*.  The
+                                        // footprints are parsed when first needed.
 
     bool            m_cache_dirty;      // Stored separately because it's expensive to check
                                         // m_cache_timestamp against all the files.
     long long       m_cache_timestamp;  // A hash of the timestamps for all the footprint
                                         // files.
 
+    MEMORY_ACCOUNT  m_memoryAccount;    // The memory of the parsed footprints.  Declared
+                                        // last, to be removed before them.
+
 public:
     FP_CACHE( PCB_IO* aOwner, const wxString& aLibraryPath );
 
@@ -139,8 +155,20 @@ public:
      */
     void Save( MODULE* aModule = NULL );
 
+    /**
+     * Function Load
+     * Lists the footprint files of the library.  The footprints of the files unchanged since
+     * the previous Load() are kept, the other files are parsed when their footprint is needed.
+     */
     void Load();
 
+    /**
+     * Function GetModule
+     * @return the footprint of \a aItem, after parsing its file if it was not parsed yet.
+     * @throw IO_ERROR if the file cannot be read or parsed.
+     */
+    const MODULE* GetModule( FP_CACHE_ITEM& aItem );
+
     void Remove( const wxString& aFootprintName );
 
     /**
@@ -180,6 +208,23 @@ FP_CACHE::FP_CACHE( PCB_IO* aOwner, const wxString& aLibraryPath )
     m_lib_path.SetPath( aLibraryPath );
     m_cache_timestamp = 0;
     m_cache_dirty = true;
+
+    m_memoryAccount.Set( "footprint library caches",
+            [this]()
+            {
+                MEMORY_ACCOUNTING::USAGE usage;
+
+                for( MODULE_CITER it = m_modules.begin(); it != m_modules.end(); ++it )
+                {
+                    if( const MODULE* module = it->second->GetModule() )
+                    {
+                        usage.m_Bytes += module->GetMemoryUsage();
+                        usage.m_Items++;
+                    }
+                }
+
+                return usage;
+            } );
 }
 
 
@@ -204,6 +249,10 @@ void FP_CACHE::Save( MODULE* aModule )
         if( aModule && aModule != it->second->GetModule() )
             continue;
 
+        // Saving the full library needs all the footprints
+        if( !aModule )
+            GetModule( *it->second );
+
         WX_FILENAME fn = it->second->GetFileName();
 
         wxString tempFileName =
@@ -241,7 +290,8 @@ void FP_CACHE::Save( MODULE* aModule )
             THROW_IO_ERROR( msg );
         }
 #endif
-        m_cache_timestamp += fn.GetTimestamp();
+        it->second->SetTimestamp( fn.GetTimestamp() );
+        m_cache_timestamp += it->second->GetTimestamp();
     }
 
     m_cache_timestamp += m_lib_path.GetModificationTime().GetValue().GetValue();
@@ -274,41 +324,51 @@ void FP_CACHE::Load()
     // the filename thereafter.
     WX_FILENAME fn( m_lib_raw_path, wxT( "dummyName" ) );
 
+    MODULE_MAP modules;
+
     if( dir.GetFirst( &fullName, fileSpec ) )
     {
-        wxString cacheError;
-
         do
         {
             fn.SetFullName( fullName );
 
-            // Queue I/O errors so only files that fail to parse don't get loaded.
-            try
+            wxString    fpName = fn.GetName();
+            long long   timestamp = fn.GetTimestamp();
+            MODULE_ITER it = m_modules.find( fpName );
+
+            if( it != m_modules.end() && it->second->GetTimestamp() == timestamp
+                    && it->second->GetFileName().GetFullPath() == fn.GetFullPath() )
             {
-                FILE_LINE_READER    reader( fn.GetFullPath() );
+                modules.insert( fpName, m_modules.release( it ).release() );
+            }
+            else
+            {
+                modules.insert( fpName, new FP_CACHE_ITEM( nullptr, fn, timestamp ) );
+            }
+
+            m_cache_timestamp += timestamp;
+        } while( dir.GetNext( &fullName ) );
+    }
 
-                m_owner->m_parser->SetLineReader( &reader );
+    m_modules.swap( modules );
+}
 
-                MODULE*     footprint = (MODULE*) m_owner->m_parser->Parse();
-                wxString    fpName = fn.GetName();
 
-                footprint->SetFPID( LIB_ID( wxEmptyString, fpName ) );
-                m_modules.insert( fpName, new FP_CACHE_ITEM( footprint, fn ) );
+const MODULE* FP_CACHE::GetModule( FP_CACHE_ITEM& aItem )
+{
+    if( !aItem.GetModule() )
+    {
+        MAPPED_FILE_LINE_READER reader( aItem.GetFileName().GetFullPath() );
 
-                m_cache_timestamp += fn.GetTimestamp();
-            }
-            catch( const IO_ERROR& ioe )
-            {
-                if( !cacheError.IsEmpty() )
-                    cacheError += "\n\n";
+        m_owner->m_parser->SetLineReader( &reader );
 
-                cacheError += ioe.What();
-            }
-        } while( dir.GetNext( &fullName ) );
+        MODULE* footprint = (MODULE*) m_owner->m_parser->Parse();
 
-        if( !cacheError.IsEmpty() )
-            THROW_IO_ERROR( cacheError );
+        footprint->SetFPID( LIB_ID( wxEmptyString, aItem.GetFileName().GetName() ) );
+        aItem.SetModule( footprint );
     }
+
+    return aItem.GetModule();
 }
 
 
@@ -364,12 +424,17 @@ void PCB_IO::Save( const wxString& aFileName, BOARD* aBoard, const PROPERTIES* a
     // Prepare net mapping that assures that net codes saved in a file are consecutive integers
     m_mapping->SetBoard( aBoard );
 
-    FILE_OUTPUTFORMATTER    formatter( aFileName );
+    std::unique_ptr<OUTPUTFORMATTER> formatter;
+
+    if( ADVANCED_CFG::GetCfg().m_CompressSavedFiles )
+        formatter.reset( new GZIP_FILE_OUTPUTFORMATTER( aFileName ) );
+    else
+        formatter.reset( new FILE_OUTPUTFORMATTER( aFileName ) );
 
-    m_out = &formatter;     // no ownership
+    m_out = formatter.get();     // no ownership
 
     m_out->Print( 0, "(kicad_pcb (version %d) (host pcbnew %s)\n", SEXPR_BOARD_FILE_VERSION,
-                  formatter.Quotew( GetBuildVersion() ).c_str() );
+                  formatter->Quotew( GetBuildVersion() ).c_str() );
 
     Format( aBoard, 1 );
 
@@ -786,15 +851,12 @@ void PCB_IO::format( BOARD* aBoard, int aNestLevel ) const
     formatHeader( aBoard, aNestLevel );
 
     // Save the modules.
-    for( auto module : aBoard->Modules() )
-    {
-        Format( module, aNestLevel );
-        m_out->Print( 0, "\n" );
-    }
+    formatItems( std::vector<BOARD_ITEM*>( aBoard->Modules().begin(), aBoard->Modules().end() ),
+                 aNestLevel, true );
 
     // Save the graphical items on the board (not owned by a module)
-    for( auto item : aBoard->Drawings() )
-        Format( item, aNestLevel );
+    formatItems( std::vector<BOARD_ITEM*>( aBoard->Drawings().begin(), aBoard->Drawings().end() ),
+                 aNestLevel, false );
 
     if( aBoard->Drawings().size() )
         m_out->Print( 0, "\n" );
@@ -802,15 +864,90 @@ void PCB_IO::format( BOARD* aBoard, int aNestLevel ) const
     // Do not save MARKER_PCBs, they can be regenerated easily.
 
     // Save the tracks and vias.
-    for( auto track : aBoard->Tracks() )
-        Format( track, aNestLevel );
+    formatItems( std::vector<BOARD_ITEM*>( aBoard->Tracks().begin(), aBoard->Tracks().end() ),
+                 aNestLevel, false );
 
     if( aBoard->Tracks().size() )
         m_out->Print( 0, "\n" );
 
     // Save the polygon (which are the newer technology) zones.
-    for( int i = 0; i < aBoard->GetAreaCount();  ++i )
-        Format( aBoard->GetArea( i ), aNestLevel );
+    formatItems( std::vector<BOARD_ITEM*>( aBoard->Zones().begin(), aBoard->Zones().end() ),
+                 aNestLevel, false );
+}
+
+
+void PCB_IO::formatItems( const std::vector<BOARD_ITEM*>& aItems, int aNestLevel,
+                          bool aSeparate ) const
+{
+    // Enough items to make the chunks worth a thread, and small enough chunks to share the
+    // big items (modules with many pads, filled zones) between the threads
+    const size_t chunkSize = 64;
+    size_t       chunkCount = ( aItems.size() + chunkSize - 1 ) / chunkSize;
+    THREAD_POOL& pool = THREAD_POOL::GetInstance();
+    size_t       threadCount = std::min<size_t>( pool.GetThreadCount() + 1, chunkCount );
+
+    if( threadCount <= 1 )
+    {
+        for( BOARD_ITEM* item : aItems )
+        {
+            Format( item, aNestLevel );
+
+            if( aSeparate )
+                m_out->Print( 0, "\n" );
+        }
+
+        return;
+    }
+
+    std::vector<std::string>        chunks( chunkCount );
+    std::vector<std::exception_ptr> errors( chunkCount );
+    std::atomic<size_t>             nextChunk( 0 );
+
+    // Each thread formats its chunks with its own PCB_IO, to a STRING_FORMATTER.  The
+    // LOCALE_IO of Save() is held meanwhile, so the locale is not changed by the threads.
+    auto formatChunks =
+            [&]()
+            {
+                PCB_IO formatter( m_ctl );
+
+                formatter.m_board = m_board;
+                formatter.m_props = m_props;
+                *formatter.m_mapping = *m_mapping;
+
+                for( size_t i = nextChunk.fetch_add( 1 ); i < chunkCount;
+                        i = nextChunk.fetch_add( 1 ) )
+                {
+                    try
+                    {
+                        size_t last = std::min( aItems.size(), ( i + 1 ) * chunkSize );
+
+                        for( size_t ii = i * chunkSize; ii < last; ++ii )
+                        {
+                            formatter.Format( aItems[ii], aNestLevel );
+
+                            if( aSeparate )
+                                formatter.m_out->Print( 0, "\n" );
+                        }
+
+                        chunks[i] = formatter.GetStringOutput( true );
+                    }
+                    catch( ... )
+                    {
+                        errors[i] = std::current_exception();
+                    }
+                }
+            };
+
+    // One runner per formatter, each one taking the next chunk not formatted yet
+    pool.ParallelFor( threadCount, [&]( size_t ) { formatChunks(); } );
+
+    for( size_t i = 0; i < chunkCount; ++i )
+    {
+        if( errors[i] )
+            std::rethrow_exception( errors[i] );
+
+        m_out->Write( chunks[i] );
+    }
 }
 
 
@@ -1964,6 +2101,12 @@ void PCB_IO::format( ZONE_CONTAINER* aZone, int aNestLevel ) const
         }
     }
 
+    if( m_ctl & CTL_OMIT_ZONE_FILLS )
+    {
+        m_out->Print( aNestLevel, ")\n" );
+        return;
+    }
+
     // Save the PolysList (filled areas)
     const SHAPE_POLY_SET& fv = aZone->GetFilledPolysList();
     newLine = 0;
@@ -2037,6 +2180,60 @@ void PCB_IO::format( ZONE_CONTAINER* aZone, int aNestLevel ) const
         m_out->Print( aNestLevel+1, ")\n" );
     }
 
+    if( aZone->IsFilled() && !aZone->GetFillFingerprint().empty() )
+    {
+        m_out->Print( aNestLevel+1, "(fill_fingerprint %s)\n",
+                      aZone->GetFillFingerprint().c_str() );
+    }
+
+    // Save the triangulation of the filled areas, so it is not rebuilt when the board is
+    // loaded.  The checksum of the filled areas lets the parser reject a stale triangulation.
+    if( !fv.IsEmpty() && fv.IsTriangulationUpToDate() )
+    {
+        m_out->Print( aNestLevel+1, "(fill_triangulation (checksum %s)\n",
+                      fv.GetHash().Format().c_str() );
+
+        for( unsigned ii = 0; ii < fv.TriangulatedPolyCount(); ii++ )
+        {
+            const SHAPE_POLY_SET::TRIANGULATED_POLYGON* tri_poly = fv.TriangulatedPolygon( ii );
+
+            m_out->Print( aNestLevel+2, "(polygon\n" );
+            m_out->Print( aNestLevel+3, "(vertices\n" );
+
+            for( size_t jj = 0; jj < tri_poly->GetVertexCount(); jj++ )
+            {
+                const VECTOR2I& pt = tri_poly->GetVertex( jj );
+
+                m_out->Print( jj % 5 ? 0 : aNestLevel+4, "%s(xy %s %s)", jj % 5 ? " " : "",
+                              FormatInternalUnits( pt.x ).c_str(),
+                              FormatInternalUnits( pt.y ).c_str() );
+
+                if( jj % 5 == 4 || jj + 1 == tri_poly->GetVertexCount() )
+                    m_out->Print( 0, "\n" );
+            }
+
+            m_out->Print( aNestLevel+3, ")\n" );
+            m_out->Print( aNestLevel+3, "(triangles\n" );
+
+            for( size_t jj = 0; jj < tri_poly->GetTriangleCount(); jj++ )
+            {
+                const SHAPE_POLY_SET::TRIANGULATED_POLYGON::TRI& tri =
+                        tri_poly->GetTriangleIndices( jj );
+
+                m_out->Print( jj % 8 ? 0 : aNestLevel+4, "%s%d %d %d", jj % 8 ? "  " : "",
+                              tri.a, tri.b, tri.c );
+
+                if( jj % 8 == 7 || jj + 1 == tri_poly->GetTriangleCount() )
+                    m_out->Print( 0, "\n" );
+            }
+
+            m_out->Print( aNestLevel+3, ")\n" );
+            m_out->Print( aNestLevel+2, ")\n" );
+        }
+
+        m_out->Print( aNestLevel+1, ")\n" );
+    }
+
     m_out->Print( aNestLevel, ")\n" );
 }
 
@@ -2062,7 +2259,7 @@ PCB_IO::~PCB_IO()
 
 BOARD* PCB_IO::Load( const wxString& aFileName, BOARD* aAppendToMe, const PROPERTIES* aProperties )
 {
-    FILE_LINE_READER    reader( aFileName );
+    MAPPED_FILE_LINE_READER reader( aFileName );
 
     init( aProperties );
 
@@ -2115,13 +2312,18 @@ void PCB_IO::init( const PROPERTIES* aProperties )
 
 void PCB_IO::validateCache( const wxString& aLibraryPath, bool checkModified )
 {
-    if( !m_cache || !m_cache->IsPath( aLibraryPath ) || ( checkModified && m_cache->IsModified() ) )
+    if( !m_cache || !m_cache->IsPath( aLibraryPath ) )
     {
         // a spectacular episode in memory management:
         delete m_cache;
         m_cache = new FP_CACHE( this, aLibraryPath );
         m_cache->Load();
     }
+    else if( checkModified && m_cache->IsModified() )
+    {
+        // Only the changed files will be parsed again
+        m_cache->Load();
+    }
 }
 
 
@@ -2172,14 +2374,14 @@ const MODULE* PCB_IO::getFootprint( const wxString& aLibraryPath,
         // do nothing with the error
     }
 
-    const MODULE_MAP& mods = m_cache->GetModules();
+    MODULE_MAP& mods = m_cache->GetModules();
 
-    MODULE_CITER it = mods.find( aFootprintName );
+    MODULE_ITER it = mods.find( aFootprintName );
 
     if( it == mods.end() )
         return nullptr;
 
-    return it->second->GetModule();
+    return m_cache->GetModule( *it->second );
 }
 
 
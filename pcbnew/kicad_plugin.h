@@ -27,6 +27,7 @@
 
 #include <io_mgr.h>
 #include <string>
+#include <vector>
 #include <layers_id_colors_and_visibility.h>
 
 class BOARD;
@@ -68,7 +69,8 @@ class TEXTE_PCB;
 //#define SEXPR_BOARD_FILE_VERSION    20200104  // pad property for fabrication
 //#define SEXPR_BOARD_FILE_VERSION    20200119  // arcs in tracks
 //#define SEXPR_BOARD_FILE_VERSION    20200512  // page -> paper
-#define SEXPR_BOARD_FILE_VERSION      20200518  // save hole_to_hole_min
+//#define SEXPR_BOARD_FILE_VERSION    20200518  // save hole_to_hole_min
+#define SEXPR_BOARD_FILE_VERSION      20200528  // zone fill fingerprint and triangulation
 
 #define CTL_STD_LAYER_NAMES         (1 << 0)    ///< Use English Standard layer names
 #define CTL_OMIT_NETS               (1 << 1)    ///< Omit pads net names (useless in library)
@@ -78,6 +80,7 @@ class TEXTE_PCB;
 #define CTL_OMIT_AT                 (1 << 5)    ///< Omit position and rotation
                                                 // (always saved with potion 0,0 and rotation = 0 in library)
 //#define CTL_OMIT_HIDE             (1 << 6)    // found and defined in eda_text.h
+#define CTL_OMIT_ZONE_FILLS         (1 << 7)    ///< Omit the filled areas of zones
 
 
 // common combinations of the above:
@@ -229,6 +232,15 @@ protected:
     /// writes everything that comes before the board_items, like settings and layers etc
     void formatHeader( BOARD* aBoard, int aNestLevel = 0 ) const;
 
+    /**
+     * Formats \a aItems in chunks, on several threads, and outputs the chunks in order: the
+     * output is the one of Format() called on each item.
+     *
+     * @param aSeparate tells to output a blank line after each item.
+     */
+    void formatItems( const std::vector<BOARD_ITEM*>& aItems, int aNestLevel,
+                      bool aSeparate ) const;
+
 private:
     void format( BOARD* aBoard, int aNestLevel = 0 ) const;
 
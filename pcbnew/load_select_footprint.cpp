@@ -309,6 +309,11 @@ MODULE* PCB_BASE_FRAME::loadFootprint( const LIB_ID& aFootprintId )
 
     wxCHECK_MSG( fptbl, NULL, wxT( "Cannot look up LIB_ID in NULL FP_LIB_TABLE." ) );
 
+    // A footprint without nickname is looked up in the footprint name index, built when the
+    // footprint list of all the libraries is read (mostly from the fp-info-cache)
+    if( aFootprintId.GetLibNickname().empty() && !fptbl->HasFootprintNameIndex() )
+        GFootprintList.ReadFootprintFiles( fptbl );
+
     MODULE *module = nullptr;
     try
     {
@@ -78,6 +78,8 @@ private:
 
     wxString m_ShortNetname;    ///< short net name, like vout from /mysheet/mysubsheet/vout
 
+    wxString m_DisplayNetname;  ///< unescaped short net name, shown on pads, vias and tracks
+
     NETCLASSPTR m_NetClass;
 
     BOARD*  m_parent;           ///< The parent board the net belongs to.
@@ -236,6 +238,13 @@ public:
      */
     const wxString& GetShortNetname() const { return m_ShortNetname; }
 
+    /**
+     * Function GetDisplayNetname
+     * @return const wxString &, a reference to the unescaped short netname, the label drawn
+     * on the items of the net
+     */
+    const wxString& GetDisplayNetname() const { return m_DisplayNetname; }
+
     bool IsCurrent() const { return m_isCurrent; }
 
     void SetIsCurrent( bool isCurrent ) { m_isCurrent = isCurrent; }
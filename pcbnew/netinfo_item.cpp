@@ -40,6 +40,7 @@
 #include <class_board.h>
 #include <class_module.h>
 #include <class_track.h>
+#include <connectivity/connectivity_data.h>
 
 
 /*********************************************************/
@@ -51,7 +52,8 @@ NETINFO_ITEM::NETINFO_ITEM( BOARD* aParent, const wxString& aNetName, int aNetCo
     m_NetCode( aNetCode ),
     m_isCurrent( true ),
     m_Netname( aNetName ),
-    m_ShortNetname( m_Netname.AfterLast( '/' ) )
+    m_ShortNetname( m_Netname.AfterLast( '/' ) ),
+    m_DisplayNetname( UnescapeString( m_ShortNetname ) )
 {
     m_parent = aParent;
 
@@ -78,8 +80,6 @@ void NETINFO_ITEM::SetClass( const NETCLASSPTR& aNetClass )
 void NETINFO_ITEM::GetMsgPanelInfo( EDA_DRAW_FRAME* aFrame, std::vector<MSG_PANEL_ITEM>& aList )
 {
     wxString  txt;
-    double    lengthnet = 0.0;      // This  is the length of tracks on pcb
-    double    lengthPadToDie = 0.0; // this is the length of internal ICs connections
 
     aList.emplace_back( _( "Net Name" ), GetNetname(), RED );
 
@@ -93,40 +93,15 @@ void NETINFO_ITEM::GetMsgPanelInfo( EDA_DRAW_FRAME* aFrame, std::vector<MSG_PANE
     if( board == NULL )
         return;
 
-    int count = 0;
-    for( auto mod : board->Modules() )
-    {
-        for( auto pad : mod->Pads() )
-        {
-            if( pad->GetNetCode() == GetNet() )
-            {
-                count++;
-                lengthPadToDie += pad->GetPadToDieLength();
-            }
-        }
-    }
-
-    txt.Printf( wxT( "%d" ), count );
-    aList.emplace_back( _( "Pads" ), txt, DARKGREEN );
-
-    count  = 0;
+    // The statistics are kept by the connectivity: nothing to walk through
+    const CN_NET_STATS& stats = board->GetConnectivity()->GetNetStats( GetNet() );
+    double              lengthnet = stats.m_TrackLength;          // the tracks on pcb
+    double              lengthPadToDie = stats.m_PadToDieLength;  // the internal ICs connections
 
-    for( auto track : board->Tracks() )
-    {
-        if( track->Type() == PCB_VIA_T )
-        {
-            if( track->GetNetCode() == GetNet() )
-                count++;
-        }
-
-        if( track->Type() == PCB_TRACE_T )
-        {
-            if( track->GetNetCode() == GetNet() )
-                lengthnet += track->GetLength();
-        }
-    }
+    txt.Printf( wxT( "%d" ), stats.m_PadCount );
+    aList.emplace_back( _( "Pads" ), txt, DARKGREEN );
 
-    txt.Printf( wxT( "%d" ), count );
+    txt.Printf( wxT( "%d" ), stats.m_ViaCount );
     aList.emplace_back( _( "Vias" ), txt, BLUE );
 
     // Displays the full net length (tracks on pcb + internal ICs connections ):
@@ -49,6 +49,9 @@
 
 #include <pcb_edit_frame.h>
 
+#include <unordered_map>
+#include <unordered_set>
+
 
 BOARD_NETLIST_UPDATER::BOARD_NETLIST_UPDATER( PCB_EDIT_FRAME* aFrame, BOARD* aBoard ) :
     m_frame( aFrame ),
@@ -312,10 +315,19 @@ bool BOARD_NETLIST_UPDATER::updateComponentPadConnections( MODULE* aPcbComponent
     MODULE* copy = m_commit.GetStatus( aPcbComponent ) ? nullptr : (MODULE*) aPcbComponent->Clone();
     bool changed = false;
 
+    // COMPONENT::GetNet() searches the pins: index them for the footprints with many pads.
+    // The first pin of a name wins, as in GetNet().
+    std::unordered_map<wxString, const COMPONENT_NET*> pinNets;
+    static const COMPONENT_NET emptyNet;
+
+    for( unsigned ii = 0; ii < aNewComponent->GetNetCount(); ii++ )
+        pinNets.emplace( aNewComponent->GetNet( ii ).GetPinName(), &aNewComponent->GetNet( ii ) );
+
     // At this point, the component footprint is updated.  Now update the nets.
     for( auto pad : aPcbComponent->Pads() )
     {
-        const COMPONENT_NET& net = aNewComponent->GetNet( pad->GetName() );
+        auto                 pinNet = pinNets.find( pad->GetName() );
+        const COMPONENT_NET& net = pinNet != pinNets.end() ? *pinNet->second : emptyNet;
 
         wxString pinFunction;
 
@@ -456,7 +468,7 @@ void BOARD_NETLIST_UPDATER::cacheCopperZoneConnections()
 bool BOARD_NETLIST_UPDATER::updateCopperZoneNets( NETLIST& aNetlist )
 {
     wxString msg;
-    std::set<wxString> netlistNetnames;
+    std::unordered_set<wxString> netlistNetnames;
 
     for( int ii = 0; ii < (int) aNetlist.GetCount(); ii++ )
     {
@@ -583,17 +595,29 @@ bool BOARD_NETLIST_UPDATER::updateCopperZoneNets( NETLIST& aNetlist )
 bool BOARD_NETLIST_UPDATER::deleteUnusedComponents( NETLIST& aNetlist )
 {
     wxString msg;
-    const COMPONENT* component;
+
+    // The components of the netlist, by path and by reference
+    std::set<KIID_PATH>          netlistPaths;
+    std::unordered_set<wxString> netlistReferences;
+
+    for( unsigned ii = 0; ii < aNetlist.GetCount(); ii++ )
+    {
+        if( m_lookupByTimestamp )
+            netlistPaths.insert( aNetlist.GetComponent( ii )->GetPath() );
+        else
+            netlistReferences.insert( aNetlist.GetComponent( ii )->GetReference() );
+    }
 
     for( auto module : m_board->Modules() )
     {
+        bool found;
 
         if( m_lookupByTimestamp )
-            component = aNetlist.GetComponentByPath( module->GetPath() );
+            found = netlistPaths.count( module->GetPath() ) > 0;
         else
-            component = aNetlist.GetComponentByReference( module->GetReference() );
+            found = netlistReferences.count( module->GetReference() ) > 0;
 
-        if( component == NULL )
+        if( !found )
         {
             if( module->IsLocked() )
             {
@@ -627,6 +651,15 @@ bool BOARD_NETLIST_UPDATER::deleteSinglePadNets()
 
     std::vector<D_PAD*> padlist = m_board->GetPads();
 
+    // The nets of the copper zones: a pad in one of them is not really alone
+    std::unordered_set<wxString> zoneNetnames;
+
+    for( ZONE_CONTAINER* zone : m_board->Zones() )
+    {
+        if( zone->IsOnCopperLayer() && !zone->GetIsKeepout() )
+            zoneNetnames.insert( zone->GetNetname() );
+    }
+
     // Sort pads by netlist name
     std::sort( padlist.begin(), padlist.end(),
         [ this ]( D_PAD* a, D_PAD* b ) -> bool { return getNetname( a ) < getNetname( b ); } );
@@ -642,21 +675,8 @@ bool BOARD_NETLIST_UPDATER::deleteSinglePadNets()
             {
                 // First, see if we have a copper zone attached to this pad.
                 // If so, this is not really a single pad net
-
-                for( ZONE_CONTAINER* zone : m_board->Zones() )
-                {
-                    if( !zone->IsOnCopperLayer() )
-                        continue;
-
-                    if( zone->GetIsKeepout() )
-                        continue;
-
-                    if( zone->GetNetname() == getNetname( previouspad ) )
-                    {
-                        count++;
-                        break;
-                    }
-                }
+                if( zoneNetnames.count( getNetname( previouspad ) ) )
+                    count++;
 
                 if( count == 1 )    // Really one pad, and nothing else
                 {
@@ -705,21 +725,33 @@ bool BOARD_NETLIST_UPDATER::testConnectivity( NETLIST& aNetlist )
     wxString msg;
     wxString padname;
 
+    // The first footprint of each reference, as BOARD::FindModuleByReference() finds it
+    std::unordered_map<wxString, MODULE*> footprintsByReference;
+
+    for( MODULE* footprint : m_board->Modules() )
+        footprintsByReference.emplace( footprint->GetReference(), footprint );
+
     for( int i = 0; i < (int) aNetlist.GetCount(); i++ )
     {
         const COMPONENT* component = aNetlist.GetComponent( i );
-        MODULE* footprint = m_board->FindModuleByReference( component->GetReference() );
+        auto             found = footprintsByReference.find( component->GetReference() );
 
-        if( footprint == NULL )    // It can be missing in partial designs
+        if( found == footprintsByReference.end() )    // It can be missing in partial designs
             continue;
 
+        MODULE* footprint = found->second;
+        std::unordered_set<wxString> padNames;
+
+        for( D_PAD* pad : footprint->Pads() )
+            padNames.insert( pad->GetName() );
+
         // Explore all pins/pads in component
         for( unsigned jj = 0; jj < component->GetNetCount(); jj++ )
         {
             const COMPONENT_NET& net = component->GetNet( jj );
             padname = net.GetPinName();
 
-            if( footprint->FindPadByName( padname ) )
+            if( padNames.count( padname ) )
                 continue;   // OK, pad found
 
             // not found: bad footprint, report error
@@ -742,7 +774,6 @@ bool BOARD_NETLIST_UPDATER::UpdateNetlist( NETLIST& aNetlist )
     m_errorCount = 0;
     m_warningCount = 0;
     m_newFootprintsCount = 0;
-    MODULE* lastPreexistingFootprint = m_board->Modules().empty() ? NULL : m_board->Modules().back();
 
     cacheCopperZoneConnections();
 
@@ -756,6 +787,25 @@ bool BOARD_NETLIST_UPDATER::UpdateNetlist( NETLIST& aNetlist )
             net->SetIsCurrent( net->GetNet() == 0 );
     }
 
+    // Index the footprints of the board by path and by reference (ignoring the case), in
+    // their board order.  The changes are only staged in m_commit until the end of the
+    // update, so the index holds the preexisting footprints only.
+    std::map<KIID_PATH, std::vector<MODULE*>>          footprintsByPath;
+    std::unordered_map<wxString, std::vector<MODULE*>> footprintsByReference;
+
+    for( MODULE* footprint : m_board->Modules() )
+    {
+        if( !footprint )
+            continue;
+
+        if( m_lookupByTimestamp )
+            footprintsByPath[ footprint->GetPath() ].push_back( footprint );
+        else
+            footprintsByReference[ footprint->GetReference().Lower() ].push_back( footprint );
+    }
+
+    static const std::vector<MODULE*> noFootprints;
+
     for( unsigned i = 0; i < aNetlist.GetCount(); i++ )
     {
         COMPONENT* component = aNetlist.GetComponent( i );
@@ -767,39 +817,37 @@ bool BOARD_NETLIST_UPDATER::UpdateNetlist( NETLIST& aNetlist )
                     component->GetFPID().Format().wx_str() );
         m_reporter->Report( msg, RPT_SEVERITY_INFO );
 
-        for( auto footprint : m_board->Modules() )
-        {
-            bool     match = false;
+        const std::vector<MODULE*>* matches = &noFootprints;
 
-            if( footprint )
-            {
-                if( m_lookupByTimestamp )
-                    match = footprint->GetPath() == component->GetPath();
-                else
-                    match = footprint->GetReference().CmpNoCase( component->GetReference() ) == 0;
-            }
+        if( m_lookupByTimestamp )
+        {
+            auto found = footprintsByPath.find( component->GetPath() );
 
-            if( match )
-            {
-                tmp = footprint;
+            if( found != footprintsByPath.end() )
+                matches = &found->second;
+        }
+        else
+        {
+            auto found = footprintsByReference.find( component->GetReference().Lower() );
 
-                if( m_replaceFootprints && component->GetFPID() != footprint->GetFPID() )
-                    tmp = replaceComponent( aNetlist, footprint, component );
+            if( found != footprintsByReference.end() )
+                matches = &found->second;
+        }
 
-                if( tmp )
-                {
-                    updateComponentParameters( tmp, component );
-                    updateComponentPadConnections( tmp, component );
-                }
+        for( MODULE* footprint : *matches )
+        {
+            tmp = footprint;
 
-                matchCount++;
-            }
+            if( m_replaceFootprints && component->GetFPID() != footprint->GetFPID() )
+                tmp = replaceComponent( aNetlist, footprint, component );
 
-            if( footprint == lastPreexistingFootprint )
+            if( tmp )
             {
-                // No sense going through the newly-created footprints: end of loop
-                break;
+                updateComponentParameters( tmp, component );
+                updateComponentPadConnections( tmp, component );
             }
+
+            matchCount++;
         }
 
         if( matchCount == 0 )
@@ -245,6 +245,7 @@ void D_PAD::DeletePrimitivesList()
 {
     m_basicShapes.clear();
     m_customShapeAsPolygon.RemoveAllContours();
+    invalidateBoardPolygon();
 }
 
 
@@ -360,7 +361,10 @@ bool D_PAD::MergePrimitivesAsPolygon( SHAPE_POLY_SET* aMergedPolygon )
     // if aMergedPolygon == NULL, use m_customShapeAsPolygon as target
 
     if( !aMergedPolygon )
+    {
         aMergedPolygon = &m_customShapeAsPolygon;
+        invalidateBoardPolygon();
+    }
 
     aMergedPolygon->RemoveAllContours();
 
@@ -46,19 +46,13 @@ PCB_BASE_EDIT_FRAME::PCB_BASE_EDIT_FRAME( KIWAY* aKiway, wxWindow* aParent,
         m_Layers( nullptr )
 {
     if( !GFootprintList.GetCount() )
-    {
-        wxTextFile footprintInfoCache( Prj().GetProjectPath() + "fp-info-cache" );
-        GFootprintList.ReadCacheFromFile( &footprintInfoCache );
-    }
+        GFootprintList.ReadCacheFromFile( Prj().GetProjectPath() + "fp-info-cache" );
 }
 
 PCB_BASE_EDIT_FRAME::~PCB_BASE_EDIT_FRAME()
 {
     if( wxFileName::IsDirWritable( Prj().GetProjectPath() ) )
-    {
-        wxTextFile footprintInfoCache( Prj().GetProjectPath() + "fp-info-cache" );
-        GFootprintList.WriteCacheToFile( &footprintInfoCache );
-    }
+        GFootprintList.WriteCacheToFile( Prj().GetProjectPath() + "fp-info-cache" );
 
     GetCanvas()->GetView()->Clear();
 }
@@ -128,7 +128,7 @@ FP_LIB_TABLE* PROJECT::PcbFootprintLibs()
         // Stack the project specific FP_LIB_TABLE overlay on top of the global table.
         // ~FP_LIB_TABLE() will not touch the fallback table, so multiple projects may
         // stack this way, all using the same global fallback table.
-        tbl = new FP_LIB_TABLE( &GFootprintTable );
+        tbl = new FP_LIB_TABLE( &FP_LIB_TABLE::GetGlobalLibTable() );
 
         SetElem( ELEM_FPTBL, tbl );
 
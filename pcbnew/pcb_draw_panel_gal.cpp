@@ -34,6 +34,7 @@
 #include <class_board.h>
 #include <class_module.h>
 #include <class_track.h>
+#include <class_zone.h>
 #include <class_marker_pcb.h>
 #include <pcb_base_frame.h>
 #include <pcbnew_settings.h>
@@ -42,10 +43,11 @@
 #include <confirm.h>
 
 #include <gal/graphics_abstraction_layer.h>
+#include <thread_pool.h>
 
+#include <algorithm>
 #include <functional>
 #include <memory>
-#include <thread>
 using namespace std::placeholders;
 
 const LAYER_NUM GAL_LAYER_ORDER[] =
@@ -109,7 +111,8 @@ const LAYER_NUM GAL_LAYER_ORDER[] =
 PCB_DRAW_PANEL_GAL::PCB_DRAW_PANEL_GAL( wxWindow* aParentWindow, wxWindowID aWindowId,
                                         const wxPoint& aPosition, const wxSize& aSize,
                                         KIGFX::GAL_DISPLAY_OPTIONS& aOptions, GAL_TYPE aGalType ) :
-        EDA_DRAW_PANEL_GAL( aParentWindow, aWindowId, aPosition, aSize, aOptions, aGalType )
+        EDA_DRAW_PANEL_GAL( aParentWindow, aWindowId, aPosition, aSize, aOptions, aGalType ),
+        m_triangulatedBoard( nullptr )
 {
     m_view = new KIGFX::PCB_VIEW( true );
     m_view->SetGAL( m_gal );
@@ -132,36 +135,27 @@ PCB_DRAW_PANEL_GAL::PCB_DRAW_PANEL_GAL( wxWindow* aParentWindow, wxWindowID aWin
     if( frame )
         static_cast<KIGFX::PCB_VIEW*>( m_view )->UpdateDisplayOptions(
                 frame->GetDisplayOptions() );
+
+    m_zoneTriangulationTimer.SetOwner( this );
+    Connect( m_zoneTriangulationTimer.GetId(), wxEVT_TIMER,
+            wxTimerEventHandler( PCB_DRAW_PANEL_GAL::onZoneTriangulationTimer ), NULL, this );
 }
 
 
 PCB_DRAW_PANEL_GAL::~PCB_DRAW_PANEL_GAL()
 {
+    cancelZoneTriangulation();
 }
 
 
 void PCB_DRAW_PANEL_GAL::DisplayBoard( BOARD* aBoard )
 {
+    cancelZoneTriangulation();
 
     m_view->Clear();
 
-    auto zones = aBoard->Zones();
-    std::atomic<size_t> next( 0 );
-    std::atomic<size_t> count_done( 0 );
-    size_t parallelThreadCount = std::max<size_t>( std::thread::hardware_concurrency(), 2 );
-
-    for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-    {
-        std::thread t = std::thread( [ &count_done, &next, &zones ]( )
-        {
-            for( size_t i = next.fetch_add( 1 ); i < zones.size(); i = next.fetch_add( 1 ) )
-                zones[i]->CacheTriangulation();
-
-            count_done++;
-        } );
-
-        t.detach();
-    }
+    // Index the items once they are all added, which is much faster than one by one
+    m_view->BeginBulkAdd();
 
     if( m_worksheet )
         m_worksheet->SetFileName( TO_UTF8( aBoard->GetFileName() ) );
@@ -182,17 +176,91 @@ void PCB_DRAW_PANEL_GAL::DisplayBoard( BOARD* aBoard )
     for( auto marker : aBoard->Markers() )
         m_view->Add( marker );
 
-    // Finalize the triangulation threads
-    while( count_done < parallelThreadCount )
-        std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
-
-    // Load zones
+    // Load zones.  Only OpenGL draws the zones from their triangulation: the others don't need
+    // to wait for it.  The fills read from the board file may be triangulated already, but
+    // checking it is not much faster than triangulating.
     for( auto zone : aBoard->Zones() )
-        m_view->Add( zone );
+    {
+        if( m_gal->IsOpenGlEngine() && zone->GetFilledPolysList().OutlineCount() > 0 )
+            m_pendingZones.emplace_back( zone, SHAPE_POLY_SET( zone->GetFilledPolysList() ) );
+        else
+            m_view->Add( zone );
+    }
 
     // Ratsnest
     m_ratsnest = std::make_unique<KIGFX::RATSNEST_VIEWITEM>( aBoard->GetConnectivity() );
     m_view->Add( m_ratsnest.get() );
+
+    m_view->EndBulkAdd();
+
+    if( m_pendingZones.empty() )
+        return;
+
+    m_triangulatedBoard = aBoard;
+
+    m_zoneTriangulation = std::make_unique<TASK_GROUP>();
+
+    // The vector is not resized until the tasks are done, or cancelled and waited for
+    for( auto& pending : m_pendingZones )
+    {
+        SHAPE_POLY_SET* fill = &pending.second;
+        m_zoneTriangulation->Run( [fill]() { fill->CacheTriangulation(); } );
+    }
+
+    m_zoneTriangulationTimer.Start( 50 );
+}
+
+
+void PCB_DRAW_PANEL_GAL::onZoneTriangulationTimer( wxTimerEvent& aEvent )
+{
+    if( !m_zoneTriangulation )
+    {
+        m_zoneTriangulationTimer.Stop();
+        return;
+    }
+
+    if( !m_zoneTriangulation->IsDone() )
+        return;
+
+    m_zoneTriangulationTimer.Stop();
+    m_zoneTriangulation->Wait();
+    m_zoneTriangulation.reset();
+
+    const ZONE_CONTAINERS& zones = m_triangulatedBoard->Zones();
+
+    for( auto& pending : m_pendingZones )
+    {
+        ZONE_CONTAINER* zone = pending.first;
+
+        // The zone may have been deleted, or already added back to the view by an undo
+        if( std::find( zones.begin(), zones.end(), zone ) == zones.end() || zone->viewPrivData() )
+            continue;
+
+        // If the zone was refilled meanwhile, it is triangulated when it is drawn
+        zone->SetFilledPolysTriangulation( pending.second );
+        m_view->Add( zone );
+    }
+
+    m_pendingZones.clear();
+    m_triangulatedBoard = nullptr;
+
+    Refresh();
+}
+
+
+void PCB_DRAW_PANEL_GAL::cancelZoneTriangulation()
+{
+    m_zoneTriangulationTimer.Stop();
+
+    if( m_zoneTriangulation )
+    {
+        // The zones not triangulated yet are triangulated when they are drawn
+        m_zoneTriangulation->Cancel();
+        m_zoneTriangulation->Wait();
+        m_zoneTriangulation.reset();
+    }
+    m_pendingZones.clear();
+    m_triangulatedBoard = nullptr;
 }
 
 
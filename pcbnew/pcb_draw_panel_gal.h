@@ -29,6 +29,15 @@
 #include <layers_id_colors_and_visibility.h>
 #include <pcb_view.h>
 #include <common.h>
+#include <geometry/shape_poly_set.h>
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <wx/timer.h>
+
+class TASK_GROUP;
 
 namespace KIGFX
 {
@@ -36,6 +45,8 @@ namespace KIGFX
     class RATSNEST_VIEWITEM;
 }
 
+class ZONE_CONTAINER;
+
 class PCB_DRAW_PANEL_GAL : public EDA_DRAW_PANEL_GAL
 {
 public:
@@ -48,6 +59,8 @@ public:
     /**
      * Function DisplayBoard
      * adds all items from the current board to the VIEW, so they can be displayed by GAL.
+     * The filled zones which are not triangulated yet are triangulated in the background,
+     * and added to the VIEW once done, so the rest of the board is shown without waiting.
      * @param aBoard is the PCB to be loaded.
      */
     void DisplayBoard( BOARD* aBoard );
@@ -117,11 +130,30 @@ protected:
     ///> Sets rendering targets & dependencies for layers.
     void setDefaultLayerDeps();
 
+    ///> Adds the zones triangulated in the background to the VIEW, once they are all done.
+    void onZoneTriangulationTimer( wxTimerEvent& aEvent );
+
+    ///> Waits for the background triangulation and forgets its zones, which may not exist
+    ///> anymore.
+    void cancelZoneTriangulation();
+
     ///> Currently used worksheet
     std::unique_ptr<KIGFX::WS_PROXY_VIEW_ITEM> m_worksheet;
 
     ///> Ratsnest view item
     std::unique_ptr<KIGFX::RATSNEST_VIEWITEM> m_ratsnest;
+
+    ///> Board owning the zones being triangulated in the background
+    BOARD* m_triangulatedBoard;
+
+    ///> Zones not in the VIEW yet, with the copies of their fills being triangulated.  The
+    ///> copies share the polygons of the zones, and are the only thing the background task
+    ///> touches.
+    std::vector<std::pair<ZONE_CONTAINER*, SHAPE_POLY_SET>> m_pendingZones;
+
+    ///> The triangulation tasks, one per pending zone
+    std::unique_ptr<TASK_GROUP> m_zoneTriangulation;
+    wxTimer                     m_zoneTriangulationTimer;
 };
 
 #endif /* PCB_DRAW_PANEL_GAL_H_ */
@@ -77,6 +77,7 @@
 #include <microwave/microwave_tool.h>
 #include <tools/position_relative_tool.h>
 #include <tools/zone_filler_tool.h>
+#include <zone_filler.h>
 #include <tools/pcb_actions.h>
 #include <router/router_tool.h>
 #include <router/length_tuner_tool.h>
@@ -345,6 +346,25 @@ PCB_EDIT_FRAME::PCB_EDIT_FRAME( KIWAY* aKiway, wxWindow* aParent ) :
     // Ensure the window is on top
     Raise();
 
+    // The Python plugins are not loaded with pcbnew, not to delay this frame: load them once
+    // it is shown
+#if defined( KICAD_SCRIPTING_ACTION_MENU )
+    CallAfter( [this]()
+               {
+                   // Add the menu items and buttons of the action plugins
+                   if( PythonPluginsEnsureLoaded() )
+                   {
+                       ReCreateMenuBar();
+                       ReCreateHToolbar();
+                   }
+               } );
+#elif defined( KICAD_SCRIPTING )
+    CallAfter( []()
+               {
+                   PythonPluginsEnsureLoaded();
+               } );
+#endif
+
 //    if( !appK2S.FileExists() )
  //       GetMenuBar()->FindItem( ID_GEN_EXPORT_FILE_STEP )->Enable( false );
 }
@@ -873,6 +893,16 @@ void PCB_EDIT_FRAME::SetLastPath( LAST_PATH_TYPE aType, const wxString& aLastPat
 
 
 void PCB_EDIT_FRAME::OnModify( )
+{
+    // Changes made outside of a BOARD_COMMIT (dialogs editing items in place, plugins,
+    // imports) don't record the dirty regions of the zone fills
+    ZONE_FILLER::InvalidateAllZones( GetBoard() );
+
+    OnCommitModify();
+}
+
+
+void PCB_EDIT_FRAME::OnCommitModify()
 {
     PCB_BASE_FRAME::OnModify();
 
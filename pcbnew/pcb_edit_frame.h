@@ -478,9 +478,16 @@ public:
      * Reloads the 3D view if required and calls the base PCB_BASE_FRAME::OnModify function
      * to update auxiliary information.
      * </p>
+     * The changed items are not known, so the next fill of every zone is a full one.
      */
     void OnModify() override;
 
+    /**
+     * Same as OnModify(), for the changes pushed by a BOARD_COMMIT.  The commit has recorded
+     * the dirty regions of the zone fills, so they are kept.
+     */
+    void OnCommitModify();
+
     /**
      * Function SetActiveLayer
      * will change the currently active layer to \a aLayer and also
@@ -403,6 +403,44 @@ bool PCB_PAINTER::Draw( const VIEW_ITEM* aItem, int aLayer )
 }
 
 
+void PCB_PAINTER::PrepareDraw( const VIEW_ITEM* aItem )
+{
+    // Only OpenGL draws the polygons from their triangulation
+    if( !m_gal->IsOpenGlEngine() )
+        return;
+
+    const EDA_ITEM* item = dynamic_cast<const EDA_ITEM*>( aItem );
+
+    if( !item )
+        return;
+
+    switch( item->Type() )
+    {
+    case PCB_LINE_T:
+    case PCB_MODULE_EDGE_T:
+    {
+        DRAWSEGMENT* segment = const_cast<DRAWSEGMENT*>( static_cast<const DRAWSEGMENT*>( item ) );
+
+        // Same as draw( const DRAWSEGMENT* ), which then has nothing left to do
+        if( segment->GetShape() == S_POLYGON && segment->GetPolyShape().OutlineCount() > 0 )
+            segment->GetPolyShape().CacheTriangulation();
+
+        break;
+    }
+
+    case PCB_ZONE_AREA_T:
+    case PCB_MODULE_ZONE_AREA_T:
+        // The zone fill is triangulated when it is filled or loaded, but it may have been
+        // modified since then
+        const_cast<ZONE_CONTAINER*>( static_cast<const ZONE_CONTAINER*>( item ) )->CacheTriangulation();
+        break;
+
+    default:
+        break;
+    }
+}
+
+
 void PCB_PAINTER::draw( const TRACK* aTrack, int aLayer )
 {
     VECTOR2D start( aTrack->GetStart() );
@@ -421,7 +459,7 @@ void PCB_PAINTER::draw( const TRACK* aTrack, int aLayer )
             if( length < 10 * width )
                 return;
 
-            const wxString& netName = UnescapeString( aTrack->GetShortNetname() );
+            const wxString& netName = aTrack->GetDisplayNetname();
             VECTOR2D textPosition = start + line / 2.0;     // center of the track
 
             double textOrientation;
@@ -548,7 +586,7 @@ void PCB_PAINTER::draw( const VIA* aVia, int aLayer )
 
             if( displayNetname )
             {
-                wxString netname = UnescapeString( aVia->GetShortNetname() );
+                const wxString& netname = aVia->GetDisplayNetname();
                 // calculate the size of net name text:
                 double tsize = 1.5 * size / netname.Length();
                 tsize = std::min( tsize, size );
@@ -720,7 +758,7 @@ void PCB_PAINTER::draw( const D_PAD* aPad, int aLayer )
 
             if( displayNetname )
             {
-                wxString netname = UnescapeString( aPad->GetShortNetname() );
+                const wxString& netname = aPad->GetDisplayNetname();
                 // calculate the size of net name text:
                 double tsize = 1.5 * padsize.x / netname.Length();
                 tsize = std::min( tsize, size );
@@ -842,6 +880,10 @@ void PCB_PAINTER::draw( const D_PAD* aPad, int aLayer )
 
         m_gal->Restore();
     }
+    else if( drawSimplePadShape( aPad, aLayer ) )
+    {
+        // Done with the GAL primitives
+    }
     else
     {
         SHAPE_POLY_SET polySet;
@@ -894,6 +936,71 @@ void PCB_PAINTER::draw( const D_PAD* aPad, int aLayer )
 }
 
 
+bool PCB_PAINTER::drawSimplePadShape( const D_PAD* aPad, int aLayer )
+{
+    if( aPad->GetShape() != PAD_SHAPE_CIRCLE && aPad->GetShape() != PAD_SHAPE_OVAL )
+        return false;
+
+    // Same sizes as D_PAD::TransformShapeWithClearanceToPolygon() on this layer
+    wxSize size = aPad->GetSize();
+    int    clearance = 0;
+
+    switch( aLayer )
+    {
+    case F_Mask:
+    case B_Mask:
+        clearance = aPad->GetSolderMaskMargin();
+        break;
+
+    case F_Paste:
+    case B_Paste:
+    {
+        wxSize margin = aPad->GetSolderPasteMargin();
+        size += margin + margin;
+        break;
+    }
+
+    default:
+        break;
+    }
+
+    int dx = size.x / 2 + clearance;
+    int dy = size.y / 2 + clearance;
+
+    if( dx <= 0 || dy <= 0 )
+        return false;
+
+    VECTOR2D position( aPad->ShapePos() );
+
+    // A circle (and an oval, a segment) is a single shaded primitive for the GAL, while
+    // its polygon is tesselated in many triangles
+    if( aPad->GetShape() == PAD_SHAPE_CIRCLE || dx == dy )
+    {
+        m_gal->DrawCircle( position, dx );
+        return true;
+    }
+
+    wxPoint offset;
+    int     width;
+
+    if( dy > dx )
+    {
+        offset.y = dy - dx;
+        width = dx * 2;
+    }
+    else
+    {
+        offset.x = dx - dy;
+        width = dy * 2;
+    }
+
+    RotatePoint( &offset, aPad->GetOrientation() );
+    m_gal->DrawSegment( position - VECTOR2D( offset ), position + VECTOR2D( offset ), width );
+
+    return true;
+}
+
+
 void PCB_PAINTER::draw( const DRAWSEGMENT* aSegment, int aLayer )
 {
     const COLOR4D& color = m_pcbSettings.GetColor( aSegment, aSegment->GetLayer() );
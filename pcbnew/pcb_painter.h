@@ -237,6 +237,9 @@ public:
     /// @copydoc PAINTER::Draw()
     virtual bool Draw( const VIEW_ITEM* aItem, int aLayer ) override;
 
+    /// @copydoc PAINTER::PrepareDraw()
+    virtual void PrepareDraw( const VIEW_ITEM* aItem ) override;
+
 protected:
     PCB_RENDER_SETTINGS m_pcbSettings;
 
@@ -245,6 +248,9 @@ protected:
     void draw( const ARC* aArc, int aLayer );
     void draw( const VIA* aVia, int aLayer );
     void draw( const D_PAD* aPad, int aLayer );
+
+    ///> draws a round or oval pad with a GAL primitive, returns false for the other shapes
+    bool drawSimplePadShape( const D_PAD* aPad, int aLayer );
     void draw( const DRAWSEGMENT* aSegment, int aLayer );
     void draw( const TEXTE_PCB* aText, int aLayer );
     void draw( const TEXTE_MODULE* aText, int aLayer );
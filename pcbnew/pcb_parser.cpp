@@ -27,10 +27,17 @@
  * @brief Pcbnew s-expression file format parser implementation.
  */
 
+#include <atomic>
+#include <cctype>
 #include <cerrno>
+#include <exception>
+#include <memory>
+
 #include <common.h>
 #include <confirm.h>
+#include <kicad_string.h>
 #include <macros.h>
+#include <thread_pool.h>
 #include <title_block.h>
 #include <trigo.h>
 
@@ -149,11 +156,16 @@ void PCB_PARSER::pushValueIntoMap( int aIndex, int aValue )
 
 double PCB_PARSER::parseDouble()
 {
-    char* tmp;
+    char*  tmp;
+    double fval;
+
+    // Most numbers are plain decimals, converted without strtod()
+    if( ParseDecimal( CurText(), &fval ) )
+        return fval;
 
     errno = 0;
 
-    double fval = strtod( CurText(), &tmp );
+    fval = strtod( CurText(), &tmp );
 
     if( errno )
     {
@@ -521,7 +533,20 @@ BOARD* PCB_PARSER::parseBOARD()
 {
     try
     {
-        return parseBOARD_unchecked();
+        try
+        {
+            return parseBOARD_unchecked();
+        }
+        catch( const IO_ERROR& )
+        {
+            // The modules are parsed after the rest of the board, but an error in a module
+            // coming before this one in the file must be the one reported.  Parsing the
+            // modules read so far throws their first error, if any.
+            if( !m_moduleBlocks.empty() )
+                parseModuleBlocks();
+
+            throw;
+        }
     }
     catch( const PARSE_ERROR& parse_error )
     {
@@ -596,7 +621,7 @@ BOARD* PCB_PARSER::parseBOARD_unchecked()
             break;
 
         case T_module:
-            m_board->Add( parseMODULE(), ADD_MODE::APPEND );
+            captureModuleBlock();
             break;
 
         case T_segment:
@@ -626,6 +651,8 @@ BOARD* PCB_PARSER::parseBOARD_unchecked()
         }
     }
 
+    parseModuleBlocks();
+
     if( m_undefinedLayers.size() > 0 )
     {
         bool deleteItems;
@@ -709,6 +736,128 @@ BOARD* PCB_PARSER::parseBOARD_unchecked()
 }
 
 
+/**
+ * A STRING_LINE_READER reporting the line numbers of the file its text was read from.
+ */
+class MODULE_BLOCK_READER : public STRING_LINE_READER
+{
+public:
+    MODULE_BLOCK_READER( const std::string& aText, const wxString& aSource, int aLineNumber ) :
+            STRING_LINE_READER( aText, aSource )
+    {
+        m_lineNum = aLineNumber - 1;
+    }
+};
+
+
+void PCB_PARSER::captureModuleBlock()
+{
+    MODULE_BLOCK block;
+
+    block.m_lineNumber = CurLineNumber();
+    block.m_text = "(module";
+
+    readListText( block.m_text );
+
+    block.m_hasZones = block.m_text.find( "(zone" ) != std::string::npos;
+    m_moduleBlocks.push_back( std::move( block ) );
+}
+
+
+void PCB_PARSER::parseModuleBlocks()
+{
+    std::vector<std::unique_ptr<MODULE>> modules( m_moduleBlocks.size() );
+    std::vector<std::exception_ptr>      errors( m_moduleBlocks.size() );
+    THREAD_POOL&                         pool = THREAD_POOL::GetInstance();
+    std::vector<PCB_PARSER>              parsers( std::max<size_t>( 1,
+            std::min<size_t>( pool.GetThreadCount() + 1, m_moduleBlocks.size() ) ) );
+    const wxString                       source = CurSource();
+
+    // Each parser reads the modules with the layer, net and version state of the board
+    for( PCB_PARSER& parser : parsers )
+    {
+        parser.m_board = m_board;
+        parser.m_layerIndices = m_layerIndices;
+        parser.m_layerMasks = m_layerMasks;
+        parser.m_netCodes = m_netCodes;
+        parser.m_requiredVersion = m_requiredVersion;
+        parser.m_tooRecent = m_tooRecent;
+        parser.m_showLegacyZoneWarning = m_showLegacyZoneWarning;
+    }
+
+    auto parseBlock =
+            [&]( PCB_PARSER& aParser, size_t aIndex )
+            {
+                try
+                {
+                    MODULE_BLOCK&       block = m_moduleBlocks[aIndex];
+                    MODULE_BLOCK_READER reader( block.m_text, source, block.m_lineNumber );
+
+                    aParser.SetLineReader( &reader );
+                    aParser.NextTok();      // T_LEFT
+                    aParser.NextTok();      // T_module
+                    modules[aIndex].reset( aParser.parseMODULE() );
+
+                    // The block text is not needed anymore
+                    std::string().swap( block.m_text );
+                }
+                catch( ... )
+                {
+                    errors[aIndex] = std::current_exception();
+                }
+            };
+
+    std::atomic<size_t> nextBlock( 0 );
+
+    auto parseBlocks =
+            [&]( PCB_PARSER& aParser )
+            {
+                for( size_t i = nextBlock.fetch_add( 1 ); i < m_moduleBlocks.size();
+                        i = nextBlock.fetch_add( 1 ) )
+                {
+                    if( !m_moduleBlocks[i].m_hasZones )
+                        parseBlock( aParser, i );
+                }
+            };
+
+    // One runner per parser, each one taking the next block not parsed yet
+    pool.ParallelFor( parsers.size(),
+            [&]( size_t ii )
+            {
+                parseBlocks( parsers[ii] );
+            } );
+
+    // The modules with zones are parsed in this thread, in file order
+    for( size_t i = 0; i < m_moduleBlocks.size(); ++i )
+    {
+        if( !modules[i] && !errors[i] )
+            parseBlock( parsers[0], i );
+    }
+
+    m_moduleBlocks.clear();
+
+    for( PCB_PARSER& parser : parsers )
+    {
+        m_undefinedLayers.insert( parser.m_undefinedLayers.begin(),
+                                  parser.m_undefinedLayers.end() );
+        m_requiredVersion = std::max( m_requiredVersion, parser.m_requiredVersion );
+        m_showLegacyZoneWarning = m_showLegacyZoneWarning && parser.m_showLegacyZoneWarning;
+    }
+
+    m_tooRecent = ( m_requiredVersion > SEXPR_BOARD_FILE_VERSION );
+
+    // Report the first error of the file
+    for( const std::exception_ptr& error : errors )
+    {
+        if( error )
+            std::rethrow_exception( error );
+    }
+
+    for( std::unique_ptr<MODULE>& module : modules )
+        m_board->Add( module.release(), ADD_MODE::APPEND );
+}
+
+
 void PCB_PARSER::parseHeader()
 {
     wxCHECK_RET( CurTok() == T_kicad_pcb,
@@ -3669,6 +3818,10 @@ ZONE_CONTAINER* PCB_PARSER::parseZONE_CONTAINER( BOARD_ITEM_CONTAINER* aParent )
     SHAPE_POLY_SET pts;
     bool inModule = false;
 
+    // the triangulation of the filled polygons, installed once they are all read
+    std::vector<std::unique_ptr<SHAPE_POLY_SET::TRIANGULATED_POLYGON>> triangulation;
+    std::string triangulationChecksum;
+
     if( dynamic_cast<MODULE*>( aParent ) )      // The zone belongs a footprint
         inModule = true;
 
@@ -4049,9 +4202,79 @@ ZONE_CONTAINER* PCB_PARSER::parseZONE_CONTAINER( BOARD_ITEM_CONTAINER* aParent )
             }
             break;
 
+        case T_fill_fingerprint:
+            NeedSYMBOLorNUMBER();
+            zone->SetFillFingerprint( CurText() );
+            NeedRIGHT();
+            break;
+
+        case T_fill_triangulation:
+            {
+                // "(fill_triangulation (checksum HASH)
+                //      (polygon (vertices (xy x y) ...) (triangles a b c ...)) ...)"
+                NeedLEFT();
+                token = NextTok();
+
+                if( token != T_checksum )
+                    Expecting( T_checksum );
+
+                NeedSYMBOLorNUMBER();
+                triangulationChecksum = CurText();
+                NeedRIGHT();
+
+                for( token = NextTok();  token != T_RIGHT;  token = NextTok() )
+                {
+                    if( token != T_LEFT )
+                        Expecting( T_LEFT );
+
+                    token = NextTok();
+
+                    if( token != T_polygon )
+                        Expecting( T_polygon );
+
+                    triangulation.push_back(
+                            std::make_unique<SHAPE_POLY_SET::TRIANGULATED_POLYGON>() );
+                    SHAPE_POLY_SET::TRIANGULATED_POLYGON& tri_poly = *triangulation.back();
+
+                    for( token = NextTok();  token != T_RIGHT;  token = NextTok() )
+                    {
+                        if( token != T_LEFT )
+                            Expecting( T_LEFT );
+
+                        token = NextTok();
+
+                        if( token == T_vertices )
+                        {
+                            for( token = NextTok();  token != T_RIGHT;  token = NextTok() )
+                                tri_poly.AddVertex( parseXY() );
+                        }
+                        else if( token == T_triangles )
+                        {
+                            for( token = NextTok();  token != T_RIGHT;  token = NextTok() )
+                            {
+                                if( token != T_NUMBER )
+                                    Expecting( T_NUMBER );
+
+                                int a = parseInt();
+                                int b = parseInt( "triangle vertex index" );
+                                int c = parseInt( "triangle vertex index" );
+
+                                tri_poly.AddTriangle( a, b, c );
+                            }
+                        }
+                        else
+                        {
+                            Expecting( "vertices or triangles" );
+                        }
+                    }
+                }
+            }
+            break;
+
         default:
             Expecting( "net, layer/layers, tstamp, hatch, priority, connect_pads, min_thickness, "
-                       "fill, polygon, filled_polygon, or fill_segments" );
+                       "fill, polygon, filled_polygon, fill_segments, fill_fingerprint, "
+                       "or fill_triangulation" );
         }
     }
 
@@ -4071,6 +4294,11 @@ ZONE_CONTAINER* PCB_PARSER::parseZONE_CONTAINER( BOARD_ITEM_CONTAINER* aParent )
     {
         zone->SetFilledPolysList( pts );
         zone->CalculateFilledArea();
+
+        // A triangulation which does not match the filled polygons is silently dropped; it
+        // will be rebuilt when the zone is drawn
+        if( !triangulation.empty() )
+            zone->SetFilledPolysTriangulation( std::move( triangulation ), triangulationChecksum );
     }
 
     // Ensure keepout and non copper zones do not have a net
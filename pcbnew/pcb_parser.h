@@ -36,7 +36,9 @@
 #include <math/util.h>                           // KiROUND, Clamp
 #include <pcb_lexer.h>
 
+#include <string>
 #include <unordered_map>
+#include <vector>
 
 
 class ARC;
@@ -81,6 +83,16 @@ class PCB_PARSER : public PCB_LEXER
 
     bool                m_showLegacyZoneWarning;
 
+    ///> The text of a board module, read by captureModuleBlock() to be parsed later
+    struct MODULE_BLOCK
+    {
+        std::string m_text;
+        int         m_lineNumber;       ///< file line of the block start
+        bool        m_hasZones;         ///< zones may ask the user, parse it in the main thread
+    };
+
+    std::vector<MODULE_BLOCK> m_moduleBlocks;   ///< modules of the board not parsed yet
+
     ///> Converts net code using the mapping table if available,
     ///> otherwise returns unchanged net code if < 0 or if is is out of range
     inline int getNetCode( int aNetCode )
@@ -123,6 +135,20 @@ class PCB_PARSER : public PCB_LEXER
      */
     void skipCurrent();
 
+    /**
+     * Function captureModuleBlock
+     * reads the text of the module whose "module" token was just read, up to its closing
+     * parenthesis, without tokenizing it, and stores it in m_moduleBlocks.
+     */
+    void captureModuleBlock();
+
+    /**
+     * Function parseModuleBlocks
+     * parses the modules stored in m_moduleBlocks on several threads, each one with its own
+     * copy of the board parsing state, and adds them to the board in file order.
+     */
+    void parseModuleBlocks();
+
     void parseHeader();
     void parseGeneralSection();
     void parsePAGE_INFO();
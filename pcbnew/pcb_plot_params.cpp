@@ -110,6 +110,7 @@ PCB_PLOT_PARAMS::PCB_PLOT_PARAMS()
     // we used 0.1mils for SVG step before, but nm precision is more accurate, so we use nm
     m_svgPrecision               = SVG_PRECISION_DEFAULT;
     m_svgUseInch                 = false;
+    m_svgOptimized               = false;
     m_excludeEdgeLayer           = true;
     m_lineWidth                  = g_DrawDefaultLineThickness;
     m_plotFrameRef               = false;
@@ -216,6 +217,9 @@ void PCB_PLOT_PARAMS::Format( OUTPUTFORMATTER* aFormatter,
     aFormatter->Print( aNestLevel+1, "(%s %d)\n", getTokenName( T_svgprecision ),
                        m_svgPrecision );
 
+    if( m_svgOptimized )    // save this option only if it is set, as for m_gerberPrecision
+        aFormatter->Print( aNestLevel+1, "(%s %s)\n", getTokenName( T_svgoptimized ), trueStr );
+
     aFormatter->Print( aNestLevel+1, "(%s %s)\n", getTokenName( T_excludeedgelayer ),
                        m_excludeEdgeLayer ? trueStr : falseStr );
     aFormatter->Print( aNestLevel+1, "(%s %f)\n", getTokenName( T_linewidth ),
@@ -310,6 +314,8 @@ bool PCB_PLOT_PARAMS::IsSameAs( const PCB_PLOT_PARAMS &aPcbPlotParams, bool aCom
         return false;
     if( m_svgUseInch != aPcbPlotParams.m_svgUseInch )
         return false;
+    if( m_svgOptimized != aPcbPlotParams.m_svgOptimized )
+        return false;
     if( m_useAuxOrigin != aPcbPlotParams.m_useAuxOrigin )
         return false;
     if( m_HPGLPenNum != aPcbPlotParams.m_HPGLPenNum )
@@ -469,6 +475,10 @@ void PCB_PLOT_PARAMS_PARSER::Parse( PCB_PLOT_PARAMS* aPcbPlotParams )
             aPcbPlotParams->m_svgUseInch = parseBool();
             break;
 
+        case T_svgoptimized:
+            aPcbPlotParams->m_svgOptimized = parseBool();
+            break;
+
         case T_psa4output:
             aPcbPlotParams->m_A4Output = parseBool();
             break;
@@ -131,6 +131,9 @@ private:
     /// false for metric, true for inch/mils
     bool        m_svgUseInch;
 
+    /// merge the strokes and reuse the repeated polygons in SVG plots
+    bool        m_svgOptimized;
+
     /// Plot gerbers using auxiliary (drill) origin instead of absolue coordinates
     bool        m_useAuxOrigin;
 
@@ -313,6 +316,9 @@ public:
     unsigned    GetSvgPrecision() const { return m_svgPrecision; }
     bool        GetSvgUseInch() const { return m_svgUseInch; }
 
+    void        SetSvgOptimized( bool aOptimized ) { m_svgOptimized = aOptimized; }
+    bool        GetSvgOptimized() const { return m_svgOptimized; }
+
     /** Default precision of coordinates in Gerber files.
      * when units are in mm (7 in inches, but Pcbnew uses mm).
      * 6 is the internal resolution of Pcbnew, so the default is 6
@@ -29,6 +29,10 @@
 #include <macros.h>
 #include <trigo.h>
 #include <pcb_screen.h>
+#include <class_drawsegment.h>
+#include <class_module.h>
+#include <class_track.h>
+#include <class_zone.h>
 #include <eda_text.h>                // FILLED
 #include <base_units.h>
 
@@ -153,6 +157,32 @@ static GRID_TYPE pcbGridList[] =
 };
 
 
+/**
+ * @return an estimate of the memory held by a copy of a board item in the undo list
+ */
+static size_t undoItemMemory( const EDA_ITEM* aItem )
+{
+    switch( aItem->Type() )
+    {
+    case PCB_ZONE_AREA_T:
+        // The fill of a copy is likely shared with the board, or packed
+        return sizeof( ZONE_CONTAINER )
+               + static_cast<const ZONE_CONTAINER*>( aItem )->GetFillMemoryUsage( false );
+
+    case PCB_MODULE_T:
+        return static_cast<const MODULE*>( aItem )->GetMemoryUsage( false );
+
+    case PCB_TRACE_T:
+    case PCB_ARC_T:
+    case PCB_VIA_T:
+        return sizeof( VIA );
+
+    default:
+        return sizeof( DRAWSEGMENT );
+    }
+}
+
+
 PCB_SCREEN::PCB_SCREEN( const wxSize& aPageSizeIU ) :
     BASE_SCREEN( SCREEN_T )
 {
@@ -169,11 +199,43 @@ PCB_SCREEN::PCB_SCREEN( const wxSize& aPageSizeIU ) :
     m_Route_Layer_TOP    = F_Cu;     // default layers pair for vias (bottom to top)
     m_Route_Layer_BOTTOM = B_Cu;
 
+    m_memoryAccount.Set( "undo history",
+            [this]()
+            {
+                MEMORY_ACCOUNTING::USAGE usage;
+
+                for( const UNDO_REDO_CONTAINER* list : { &m_UndoList, &m_RedoList } )
+                {
+                    for( const PICKED_ITEMS_LIST* command : list->m_CommandsList )
+                    {
+                        usage.m_Bytes += sizeof( PICKED_ITEMS_LIST )
+                                         + command->GetCount() * sizeof( ITEM_PICKER );
+                        usage.m_Items++;
+
+                        for( unsigned ii = 0; ii < command->GetCount(); ii++ )
+                        {
+                            // The list owns the copies and the deleted items
+                            const EDA_ITEM* item = command->GetPickedItemLink( ii );
+
+                            if( !item && command->GetPickedItemStatus( ii ) == UR_DELETED )
+                                item = command->GetPickedItem( ii );
+
+                            if( item )
+                                usage.m_Bytes += undoItemMemory( item );
+                        }
+                    }
+                }
+
+                return usage;
+            } );
+
     InitDataPoints( aPageSizeIU );
 }
 
 
 PCB_SCREEN::~PCB_SCREEN()
 {
+    m_memoryAccount.Reset();
     ClearUndoRedoList();
 }
+
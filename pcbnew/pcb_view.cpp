@@ -24,19 +24,36 @@
  */
 
 
+#include <algorithm>
 #include <functional>
+#include <iterator>
 using namespace std::placeholders;
 
 #include <pcb_view.h>
 #include <pcb_display_options.h>
 #include <pcb_painter.h>
 
+#include <board_connected_item.h>
 #include <class_module.h>
 
 namespace KIGFX {
 PCB_VIEW::PCB_VIEW( bool aIsDynamic ) :
-    VIEW( aIsDynamic )
+    VIEW( aIsDynamic ),
+    m_colorsUpToDate( false ),
+    m_colorsHighlightEnabled( false ),
+    m_colorsHighlightItems( false )
 {
+    // The items are indexed by net, for the highlight (see PCB_RENDER_SETTINGS::GetColor())
+    SetColorKeyFunction( []( const VIEW_ITEM* aItem )
+                         {
+                             const EDA_ITEM* item = dynamic_cast<const EDA_ITEM*>( aItem );
+
+                             if( auto conItem = dyn_cast<const BOARD_CONNECTED_ITEM*>( item ) )
+                                 return conItem->GetNetCode();
+
+                             return -1;
+                         } );
+
     // Set m_boundary to define the max area size. The default value
     // is acceptable for Pcbnew and Gerbview.
     // However, ensure this area has the right size (max size allowed by integer coordinates)
@@ -110,6 +127,55 @@ void PCB_VIEW::Update( KIGFX::VIEW_ITEM* aItem )
 }
 
 
+void PCB_VIEW::UpdateAllLayersColor()
+{
+    VIEW::UpdateAllLayersColor();
+
+    const RENDER_SETTINGS* settings = GetPainter()->GetSettings();
+
+    m_colorsUpToDate = true;
+    m_colorsHighlightEnabled = settings->IsHighlightEnabled();
+    m_colorsHighlightItems = settings->IsHighlightItems();
+    m_colorsHighlightNets = settings->GetHighlightNetCodes();
+}
+
+
+void PCB_VIEW::UpdateHighlightColors()
+{
+    const RENDER_SETTINGS* settings = GetPainter()->GetSettings();
+
+    // Dimming or not the other items, or highlighting the flagged items, recolors everything
+    if( !m_colorsUpToDate
+            || settings->IsHighlightEnabled() != m_colorsHighlightEnabled
+            || settings->IsHighlightItems() != m_colorsHighlightItems
+            || settings->IsHighlightItems() )
+    {
+        UpdateAllLayersColor();
+        return;
+    }
+
+    if( !settings->IsHighlightEnabled() )
+        return;
+
+    const std::set<int>& nets = settings->GetHighlightNetCodes();
+    std::set<int>        changedNets;
+
+    std::set_symmetric_difference( nets.begin(), nets.end(), m_colorsHighlightNets.begin(),
+                                   m_colorsHighlightNets.end(),
+                                   std::inserter( changedNets, changedNets.end() ) );
+
+    // The items without net are not indexed
+    if( !changedNets.empty() && *changedNets.begin() < 0 )
+    {
+        UpdateAllLayersColor();
+        return;
+    }
+
+    UpdateColorsOfKeys( changedNets );
+    m_colorsHighlightNets = nets;
+}
+
+
 void PCB_VIEW::UpdateDisplayOptions( const PCB_DISPLAY_OPTIONS& aOptions )
 {
     auto    painter     = static_cast<KIGFX::PCB_PAINTER*>( GetPainter() );
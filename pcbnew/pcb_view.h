@@ -51,7 +51,24 @@ public:
     /// @copydoc VIEW::Update()
     virtual void Update( VIEW_ITEM* aItem ) override;
 
+    /// @copydoc VIEW::UpdateAllLayersColor()
+    virtual void UpdateAllLayersColor() override;
+
+    /**
+     * Applies the highlight set in the RENDER_SETTINGS since the last color update.  When only
+     * the highlighted nets changed, only the items of the nets highlighted or not anymore are
+     * recolored, else all the items.
+     */
+    void UpdateHighlightColors();
+
     void UpdateDisplayOptions( const PCB_DISPLAY_OPTIONS& aOptions );
+
+private:
+    /// The highlight the item colors were last updated for
+    bool          m_colorsUpToDate;
+    bool          m_colorsHighlightEnabled;
+    bool          m_colorsHighlightItems;
+    std::set<int> m_colorsHighlightNets;
 };
 
 }
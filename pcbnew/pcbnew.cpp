@@ -154,11 +154,11 @@ static struct IFACE : public KIFACE_I
 
         // Return a new FP_LIB_TABLE with the global table installed as a fallback.
         case KIFACE_NEW_FOOTPRINT_TABLE:
-            return (void*) new FP_LIB_TABLE( &GFootprintTable );
+            return (void*) new FP_LIB_TABLE( &FP_LIB_TABLE::GetGlobalLibTable() );
 
         // Return a pointer to the global instance of the global footprint table.
         case KIFACE_GLOBAL_FOOTPRINT_TABLE:
-            return (void*) &GFootprintTable;
+            return (void*) &FP_LIB_TABLE::GetGlobalLibTable();
 
         default:
             return nullptr;
@@ -281,7 +281,7 @@ static bool scriptingSetup()
 
 #endif
 
-    if( !pcbnewInitPythonScripting( TO_UTF8( PyScriptingPath() ) ) )
+    if( !pcbnewInitPythonScripting() )
     {
         wxLogError( "pcbnewInitPythonScripting() failed." );
         return false;
@@ -292,6 +292,26 @@ static bool scriptingSetup()
 #endif  // KICAD_SCRIPTING
 
 
+#if defined( KICAD_SCRIPTING )
+/// Set once the Python plugins are loaded, by PythonPluginsEnsureLoaded()
+static bool pythonPluginsLoaded = false;
+#endif
+
+
+bool PythonPluginsEnsureLoaded()
+{
+#if defined( KICAD_SCRIPTING )
+    if( pythonPluginsLoaded )
+        return false;
+
+    PythonPluginsReloadBase();
+    return true;
+#else
+    return false;
+#endif
+}
+
+
 void PythonPluginsReloadBase()
 {
 #if defined( KICAD_SCRIPTING )
@@ -303,9 +323,11 @@ void PythonPluginsReloadBase()
 
     PyLOCK lock;
 
-    // ReRun the Python method pcbnew.LoadPlugins (already called when starting Pcbnew)
+    // ReRun the Python method pcbnew.LoadPlugins (first called by PythonPluginsEnsureLoaded())
     int retv = PyRun_SimpleString( cmd );
 
+    pythonPluginsLoaded = true;
+
     if( retv != 0 )
         wxLogError( "Python error %d occurred running command:\n\n`%s`", retv, cmd );
 #endif
@@ -343,26 +365,25 @@ bool IFACE::OnKifaceStart( PGM_BASE* aProgram, int aCtlBits )
     }
     else
     {
-        try
-        {
-            // The global table is not related to a specific project.  All projects
-            // will use the same global table.  So the KIFACE::OnKifaceStart() contract
-            // of avoiding anything project specific is not violated here.
-            if( !FP_LIB_TABLE::LoadGlobalTable( GFootprintTable ) )
-                return false;
-        }
-        catch( const IO_ERROR& ioe )
-        {
-            // if we are here, a incorrect global footprint library table was found.
-            // Incorrect global symbol library table is not a fatal error:
-            // the user just has to edit the (partially) loaded table.
-            wxString msg = _(
-                "An error occurred attempting to load the global footprint library table.\n"
-                "Please edit this global footprint library table in Preferences menu."
-                );
-
-            DisplayErrorMessage( NULL, msg, ioe.What() );
-        }
+        // The global table is not related to a specific project.  All projects
+        // will use the same global table.  So the KIFACE::OnKifaceStart() contract
+        // of avoiding anything project specific is not violated here.
+        //
+        // It is loaded in the background: the libraries may be on a network drive, and the
+        // table is only needed once a frame looks for a footprint.
+        FP_LIB_TABLE::LoadGlobalTableInBackground(
+                []( const IO_ERROR& ioe )
+                {
+                    // if we are here, a incorrect global footprint library table was found.
+                    // Incorrect global symbol library table is not a fatal error:
+                    // the user just has to edit the (partially) loaded table.
+                    wxString msg = _(
+                        "An error occurred attempting to load the global footprint library table.\n"
+                        "Please edit this global footprint library table in Preferences menu."
+                        );
+
+                    DisplayErrorMessage( NULL, msg, ioe.What() );
+                } );
     }
 
 #if defined( KICAD_SCRIPTING )
@@ -56,5 +56,15 @@ class TRACK;
  */
 void PythonPluginsReloadBase();
 
+/**
+ * Load the Python action plugins and footprint wizards, if not done yet.
+ *
+ * They are not loaded when pcbnew starts, not to delay its first frame: the board editor
+ * loads them once it is shown, and what lists them calls this first.
+ *
+ * @return true if they were loaded by this call
+ */
+bool PythonPluginsEnsureLoaded();
+
 
 #endif // PCBNEW_H
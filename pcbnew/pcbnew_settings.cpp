@@ -47,6 +47,7 @@ PCBNEW_SETTINGS::PCBNEW_SETTINGS()
         : APP_SETTINGS_BASE( "pcbnew", pcbnewSchemaVersion ),
           m_Use45DegreeGraphicSegments( false ),
           m_FlipLeftRight( false ),
+          m_AutoRefillZones( false ),
           m_ShowPageLimits( true ),
           m_PnsSettings( nullptr ),
           m_FootprintViewerAutoZoom( false ),
@@ -80,6 +81,9 @@ PCBNEW_SETTINGS::PCBNEW_SETTINGS()
 
     m_params.emplace_back( new PARAM<bool>( "editing.flip_left_right", &m_FlipLeftRight, true ) );
 
+    m_params.emplace_back(
+            new PARAM<bool>( "editing.auto_refill_zones", &m_AutoRefillZones, false ) );
+
     m_params.emplace_back(
             new PARAM<bool>( "editing.magnetic_graphics", &m_MagneticItems.graphics, true ) );
 
@@ -179,6 +183,9 @@ PCBNEW_SETTINGS::PCBNEW_SETTINGS()
     m_params.emplace_back( new PARAM<bool>( "drc_dialog.test_footprints",
             &m_DrcDialog.test_footprints, false ) );
 
+    m_params.emplace_back( new PARAM<bool>( "drc_dialog.incremental",
+            &m_DrcDialog.incremental, false ) );
+
     m_params.emplace_back( new PARAM<int>( "drc_dialog.severities",
             &m_DrcDialog.severities, RPT_SEVERITY_ERROR | RPT_SEVERITY_WARNING ) );
 
@@ -196,6 +203,9 @@ PCBNEW_SETTINGS::PCBNEW_SETTINGS()
     m_params.emplace_back( new PARAM<bool>( "gen_drill.use_route_for_oval_holes",
             &m_GenDrill.use_route_for_oval_holes, true ) );
 
+    m_params.emplace_back( new PARAM<bool>( "gen_drill.optimize_holes_path",
+            &m_GenDrill.optimize_holes_path, true ) );
+
     m_params.emplace_back( new PARAM<int>(
             "gen_drill.drill_file_type", &m_GenDrill.drill_file_type, 0 ) );
 
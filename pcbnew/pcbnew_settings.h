@@ -78,6 +78,7 @@ public:
         bool refill_zones;
         bool test_track_to_zone;
         bool test_footprints;
+        bool incremental;       // re-test changed items on each commit
         int  severities;
     };
 
@@ -134,6 +135,7 @@ public:
         bool mirror;
         bool unit_drill_is_inch;
         bool use_route_for_oval_holes;
+        bool optimize_holes_path;
         int  drill_file_type;
         int  map_file_type;
         int  zeros_format;
@@ -260,6 +262,8 @@ public:
     bool m_FlipLeftRight;                // True: Flip footprints across Y axis
     // False: Flip footprints across X axis
 
+    bool m_AutoRefillZones;              ///< Refill the filled zones in the background after edits
+
     bool m_PolarCoords;
 
     int m_RotationAngle;
@@ -44,6 +44,8 @@
 #include <build_version.h>
 #include <gbr_metadata.h>
 
+#include <algorithm>
+
 
 const wxString GetGerberProtelExtension( LAYER_NUM aLayer )
 {
@@ -494,6 +496,48 @@ bool PLOT_CONTROLLER::PlotLayer()
 }
 
 
+bool PLOT_CONTROLLER::PlotLayers( const std::vector<int>& aLayers, PLOT_FORMAT aFormat,
+                                  const wxString& aSheetDesc )
+{
+    LOCALE_IO toggle;
+
+    GetPlotOptions().SetFormat( aFormat );
+
+    // Ensure that the previous plot is closed
+    ClosePlot();
+
+    wxString   outputDirName = GetPlotOptions().GetOutputDirectory();
+    wxFileName outputDir = wxFileName::DirName( outputDirName );
+    wxString   boardFilename = m_board->GetFileName();
+
+    if( !EnsureFileDirectoryExists( &outputDir, boardFilename ) )
+        return false;
+
+    std::vector<PCB_LAYER_ID> layers;
+    std::vector<wxString>     fileNames;
+
+    for( int layer : aLayers )
+    {
+        PCB_LAYER_ID layerId = ToLAYER_ID( layer );
+        wxFileName   fn( boardFilename );
+        wxString     fileExt = GetDefaultPlotExtension( aFormat );
+
+        if( aFormat == PLOT_FORMAT::GERBER && GetPlotOptions().GetUseGerberProtelExtensions() )
+            fileExt = GetGerberProtelExtension( layerId );
+
+        BuildPlotFileName( &fn, outputDir.GetPath(), m_board->GetLayerName( layerId ), fileExt );
+
+        layers.push_back( layerId );
+        fileNames.push_back( fn.GetFullPath() );
+    }
+
+    std::vector<bool> success = PlotBoardLayers( m_board, &GetPlotOptions(), layers, fileNames,
+                                                 aSheetDesc );
+
+    return std::find( success.begin(), success.end(), false ) == success.end();
+}
+
+
 void PLOT_CONTROLLER::SetColorMode( bool aColorMode )
 {
     if( !m_plotter )
@@ -38,6 +38,8 @@
 #include <settings/settings_manager.h>
 #include <wx/filename.h>
 
+#include <vector>
+
 class PLOTTER;
 class TEXTE_PCB;
 class D_PAD;
@@ -168,6 +170,22 @@ PLOTTER* StartPlotBoard( BOARD* aBoard,
 void PlotOneBoardLayer( BOARD *aBoard, PLOTTER* aPlotter, PCB_LAYER_ID aLayer,
                         const PCB_PLOT_PARAMS& aPlotOpt );
 
+/**
+ * Function PlotBoardLayers
+ * plots several layers concurrently, each one in its own file with its own plotter.
+ * The board items are only read by the plot threads.
+ * @param aBoard = the board to plot
+ * @param aPlotOpts = the plot options, for all the layers
+ * @param aLayers = the layers to plot
+ * @param aFullFileNames = the file of each layer of aLayers
+ * @param aSheetDesc = the sheet description, for the frame reference
+ * @return for each layer of aLayers, true if its file was created and plotted
+ */
+std::vector<bool> PlotBoardLayers( BOARD* aBoard, PCB_PLOT_PARAMS* aPlotOpts,
+                                   const std::vector<PCB_LAYER_ID>& aLayers,
+                                   const std::vector<wxString>& aFullFileNames,
+                                   const wxString& aSheetDesc );
+
 /**
  * Function PlotStandardLayer
  * plot copper or technical layers.
@@ -54,6 +54,8 @@
 #include <pcbplot.h>
 #include <pcb_painter.h>
 #include <gbr_metadata.h>
+#include <thread_pool.h>
+
 
 /*
  * Plot a solder mask layer.  Solder mask layers have a minimum thickness value and cannot be
@@ -62,6 +64,9 @@
 static void PlotSolderMaskLayer( BOARD *aBoard, PLOTTER* aPlotter, LSET aLayerMask,
                                  const PCB_PLOT_PARAMS& aPlotOpt, int aMinThickness );
 
+// The max error of the arc to segment approximations used to build the solder mask layers
+static const int SOLDERMASK_MAX_ERROR = Millimeter2iu( 0.005 );
+
 void PlotOneBoardLayer( BOARD *aBoard, PLOTTER* aPlotter, PCB_LAYER_ID aLayer,
                         const PCB_PLOT_PARAMS& aPlotOpt )
 {
@@ -268,10 +273,9 @@ void PlotStandardLayer( BOARD *aBoard, PLOTTER* aPlotter,
             extraSize.x += width_adj;
             extraSize.y += width_adj;
 
-            // Store these parameters that can be modified to plot inflated/deflated pads shape
-            wxSize deltaSize = pad->GetDelta(); // has meaning only for trapezoidal pads
-            PAD_SHAPE_T padShape = pad->GetShape();
-            double padCornerRadius = pad->GetRoundRectCornerRadius();
+            // The inflated/deflated pad shape is plotted from a copy: the board is only read,
+            // and can be plotted by several threads (see PlotBoardLayers())
+            D_PAD dummy( *pad );
 
             if( pad->GetShape() == PAD_SHAPE_TRAPEZOID )
             {   // The easy way is to use BuildPadPolygon to calculate
@@ -304,7 +308,7 @@ void PlotStandardLayer( BOARD *aBoard, PLOTTER* aPlotter,
                 else
                     delta.y = coord[1].x - coord[0].x;
 
-                pad->SetDelta( delta );
+                dummy.SetDelta( delta );
             }
             else
                 padPlotsSize = pad->GetSize() + extraSize;
@@ -326,45 +330,42 @@ void PlotStandardLayer( BOARD *aBoard, PLOTTER* aPlotter,
             else if( sketchPads && aLayerMask[B_Fab] )
                 color = aPlotOpt.ColorSettings()->GetColor( B_Fab );
 
-            // Temporary set the pad size to the required plot size:
-            wxSize tmppadsize = pad->GetSize();
-
+            // Set the pad size to the required plot size:
             switch( pad->GetShape() )
             {
             case PAD_SHAPE_CIRCLE:
             case PAD_SHAPE_OVAL:
-                pad->SetSize( padPlotsSize );
+                dummy.SetSize( padPlotsSize );
 
                 if( aPlotOpt.GetSkipPlotNPTH_Pads() &&
                     ( aPlotOpt.GetDrillMarksType() == PCB_PLOT_PARAMS::NO_DRILL_SHAPE ) &&
-                    ( pad->GetSize() == pad->GetDrillSize() ) &&
-                    ( pad->GetAttribute() == PAD_ATTRIB_HOLE_NOT_PLATED ) )
+                    ( dummy.GetSize() == dummy.GetDrillSize() ) &&
+                    ( dummy.GetAttribute() == PAD_ATTRIB_HOLE_NOT_PLATED ) )
                     break;
 
-                itemplotter.PlotPad( pad, color, padPlotMode );
+                itemplotter.PlotPad( &dummy, color, padPlotMode );
                 break;
 
             case PAD_SHAPE_RECT:
                 if( margin.x > 0 )
                 {
-                    pad->SetShape( PAD_SHAPE_ROUNDRECT );
-                    pad->SetSize( padPlotsSize );
-                    pad->SetRoundRectCornerRadius( margin.x );
+                    dummy.SetShape( PAD_SHAPE_ROUNDRECT );
+                    dummy.SetSize( padPlotsSize );
+                    dummy.SetRoundRectCornerRadius( margin.x );
                 }
                 KI_FALLTHROUGH;
 
             case PAD_SHAPE_TRAPEZOID:
             case PAD_SHAPE_ROUNDRECT:
             case PAD_SHAPE_CHAMFERED_RECT:
-                pad->SetSize( padPlotsSize );
-                itemplotter.PlotPad( pad, color, padPlotMode );
+                dummy.SetSize( padPlotsSize );
+                itemplotter.PlotPad( &dummy, color, padPlotMode );
                 break;
 
             case PAD_SHAPE_CUSTOM:
             {
                 // inflate/deflate a custom shape is a bit complex.
-                // so build a similar pad shape, and inflate/deflate the polygonal shape
-                D_PAD dummy( *pad );
+                // so inflate/deflate the polygonal shape of the copy
                 SHAPE_POLY_SET shape;
                 pad->MergePrimitivesAsPolygon( &shape );
                 // Shape polygon can have holes so use InflateWithLinkedHoles(), not Inflate()
@@ -386,12 +387,6 @@ void PlotStandardLayer( BOARD *aBoard, PLOTTER* aPlotter,
             }
                 break;
             }
-
-            // Restore the pad parameters modified by the plot code
-            pad->SetSize( tmppadsize );
-            pad->SetDelta( deltaSize );
-            pad->SetShape( padShape );
-            pad->SetRoundRectCornerRadius( padCornerRadius );
         }
 
         aPlotter->EndBlock( NULL );
@@ -751,9 +746,12 @@ void PlotSolderMaskLayer( BOARD *aBoard, PLOTTER* aPlotter, LSET aLayerMask,
 {
     PCB_LAYER_ID    layer = aLayerMask[B_Mask] ? B_Mask : F_Mask;
 
-    // Set the current arc to segment max approx error
+    // Set the current arc to segment max approx error.  PlotBoardLayers() sets it before
+    // plotting the solder mask layers concurrently: the board is then not modified here.
     int currMaxError = aBoard->GetDesignSettings().m_MaxError;
-    aBoard->GetDesignSettings().m_MaxError = Millimeter2iu( 0.005 );
+
+    if( currMaxError != SOLDERMASK_MAX_ERROR )
+        aBoard->GetDesignSettings().m_MaxError = SOLDERMASK_MAX_ERROR;
 
     // We remove 1nm as we expand both sides of the shapes, so allowing for
     // a strictly greater than or equal comparison in the shape separation (boolean add)
@@ -878,7 +876,8 @@ void PlotSolderMaskLayer( BOARD *aBoard, PLOTTER* aPlotter, LSET aLayerMask,
     areas.Deflate( inflate, numSegs );
 
     // Restore initial settings:
-    aBoard->GetDesignSettings().m_MaxError = currMaxError;
+    if( currMaxError != SOLDERMASK_MAX_ERROR )
+        aBoard->GetDesignSettings().m_MaxError = currMaxError;
 
     // Restore normal option to build polygons from item shapes:
     DisableArcRadiusCorrection( false );
@@ -1030,6 +1029,7 @@ static void initializePlotter( PLOTTER *aPlotter, BOARD * aBoard,
     aPlotter->SetGerberCoordinatesFormat( aPlotOpts->GetGerberPrecision() );
     // Has meaning only for SVG plotter. Must be called only after SetViewport
     aPlotter->SetSvgCoordinatesFormat( aPlotOpts->GetSvgPrecision(), aPlotOpts->GetSvgUseInch() );
+    aPlotter->SetSvgOptimized( aPlotOpts->GetSvgOptimized() );
 
     aPlotter->SetCreator( wxT( "PCBNEW" ) );
     aPlotter->SetColorMode( false );        // default is plot in Black and White.
@@ -1183,3 +1183,74 @@ PLOTTER* StartPlotBoard( BOARD *aBoard, PCB_PLOT_PARAMS *aPlotOpts, int aLayer,
     delete plotter;
     return NULL;
 }
+
+
+std::vector<bool> PlotBoardLayers( BOARD* aBoard, PCB_PLOT_PARAMS* aPlotOpts,
+                                   const std::vector<PCB_LAYER_ID>& aLayers,
+                                   const std::vector<wxString>& aFullFileNames,
+                                   const wxString& aSheetDesc )
+{
+    wxASSERT( aLayers.size() == aFullFileNames.size() );
+
+    // The locale is global to the process: this also keeps it for the plot threads
+    LOCALE_IO toggle;
+
+    std::vector<PLOTTER*> plotters( aLayers.size(), nullptr );
+    std::vector<size_t>   layerJobs;
+    std::vector<size_t>   maskJobs;
+
+    // Starting a plot draws the frame reference from the shared page layout items, and
+    // caches the board bounding box: the plots are started one after the other
+    for( size_t ii = 0; ii < aLayers.size(); ++ii )
+    {
+        plotters[ii] = StartPlotBoard( aBoard, aPlotOpts, aLayers[ii], aFullFileNames[ii],
+                                       aSheetDesc );
+
+        if( !plotters[ii] )
+            continue;
+
+        if( aLayers[ii] == F_Mask || aLayers[ii] == B_Mask )
+            maskJobs.push_back( ii );
+        else
+            layerJobs.push_back( ii );
+    }
+
+    auto plotJobs = [&]( const std::vector<size_t>& aJobs )
+    {
+        THREAD_POOL::GetInstance().ParallelFor( aJobs.size(),
+                [&]( size_t i )
+                {
+                    size_t job = aJobs[i];
+
+                    PlotOneBoardLayer( aBoard, plotters[job], aLayers[job], *aPlotOpts );
+                } );
+    };
+
+    plotJobs( layerJobs );
+
+    // The solder mask layers are built with a finer max error than the other layers.  Set
+    // it once for all of them, while no other layer is plotted.
+    BOARD_DESIGN_SETTINGS& bds = aBoard->GetDesignSettings();
+    int                    currMaxError = bds.m_MaxError;
+
+    bds.m_MaxError = SOLDERMASK_MAX_ERROR;
+    plotJobs( maskJobs );
+    bds.m_MaxError = currMaxError;
+
+    std::vector<bool> success( aLayers.size(), false );
+
+    for( size_t ii = 0; ii < aLayers.size(); ++ii )
+    {
+        if( !plotters[ii] )
+            continue;
+
+        plotters[ii]->EndPlot();
+
+        delete plotters[ii]->RenderSettings();
+        delete plotters[ii];
+
+        success[ii] = true;
+    }
+
+    return success;
+}
@@ -258,13 +258,13 @@ void BRDITEMS_PLOTTER::PlotPad( D_PAD* aPad, COLOR4D aColor, EDA_DRAW_MODE_T aPl
 
     case PAD_SHAPE_CUSTOM:
         {
-        SHAPE_POLY_SET polygons;
-        aPad->MergePrimitivesAsPolygon( &polygons );
+        SHAPE_POLY_SET polygons = aPad->GetBoardPolygon();
 
         if( polygons.OutlineCount() == 0 )
             break;
 
-        aPad->CustomShapeAsPolygonToBoardPosition( &polygons, shape_pos, aPad->GetOrientation() );
+        if( shape_pos != aPad->GetPosition() )
+            polygons.Move( VECTOR2I( shape_pos - aPad->GetPosition() ) );
         m_plotter->FlashPadCustom( shape_pos, aPad->GetSize(), &polygons, aPlotMode, &gbr_metadata );
         }
         break;
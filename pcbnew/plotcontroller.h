@@ -33,6 +33,8 @@
 #include <pcb_plot_params.h>
 #include <layers_id_colors_and_visibility.h>
 
+#include <vector>
+
 class PLOTTER;
 class BOARD;
 
@@ -83,6 +85,17 @@ public:
      */
     bool PlotLayer();
 
+    /** Plot several layers concurrently, each one in its own file.  The current plot, if
+     * any, is closed first.
+     * @param aLayers is the list of the layers to plot
+     * @param aFormat is the plot file format identifier
+     * @param aSheetDesc
+     * @return true if all the files were created.  The file of a layer is named as
+     * OpenPlotfile() does, with the layer name as suffix.
+     */
+    bool PlotLayers( const std::vector<int>& aLayers, PLOT_FORMAT aFormat,
+                     const wxString& aSheetDesc );
+
     /**
      * @return the current plot full filename, set by OpenPlotfile
      */
@@ -33,12 +33,14 @@
 #endif
 
 #include <ratsnest_data.h>
+#include <trace_events.h>
 #include <functional>
 using namespace std::placeholders;
 
 #include <cassert>
 #include <algorithm>
 #include <limits>
+#include <map>
 
 static uint64_t getDistance( const CN_ANCHOR_PTR& aNode1, const CN_ANCHOR_PTR& aNode2 )
 {
@@ -55,7 +57,7 @@ static bool sortWeight( const CN_EDGE& aEdge1, const CN_EDGE& aEdge2 )
 }
 
 
-static const std::vector<CN_EDGE> kruskalMST( std::list<CN_EDGE>& aEdges,
+static const std::vector<CN_EDGE> kruskalMST( std::vector<CN_EDGE>& aEdges,
         std::vector<CN_ANCHOR_PTR>& aNodes )
 {
     unsigned int    nodeNumber = aNodes.size();
@@ -83,12 +85,12 @@ static const std::vector<CN_EDGE> kruskalMST( std::list<CN_EDGE>& aEdges,
         cycles[i].push_back( i );
 
     // Kruskal algorithm requires edges to be sorted by their weight
-    aEdges.sort( sortWeight );
+    std::stable_sort( aEdges.begin(), aEdges.end(), sortWeight );
 
-    while( mstSize < mstExpectedSize && !aEdges.empty() )
+    for( auto edge = aEdges.begin(); mstSize < mstExpectedSize && edge != aEdges.end(); ++edge )
     {
         //printf("mstSize %d %d\n", mstSize, mstExpectedSize);
-        auto& dt = aEdges.front();
+        auto& dt = *edge;
 
         int srcTag  = tags[dt.GetSourceNode()];
         int trgTag  = tags[dt.GetTargetNode()];
@@ -138,9 +140,6 @@ static const std::vector<CN_EDGE> kruskalMST( std::list<CN_EDGE>& aEdges,
             // Move nodes that were marked with old tag to the list marked with the new tag
             cycles[srcTag].splice( cycles[srcTag].end(), cycles[trgTag] );
         }
-
-        // Remove the edge that was just processed
-        aEdges.erase( aEdges.begin() );
     }
 
     // Probably we have discarded some of edges, so reduce the size
@@ -150,20 +149,50 @@ static const std::vector<CN_EDGE> kruskalMST( std::list<CN_EDGE>& aEdges,
 }
 
 
+/**
+ * TRIANGULATOR_STATE
+ * keeps the Delaunay triangulation of the node positions of a net between two updates.
+ *
+ * When only a few positions changed since the previous update, the triangulation is repaired
+ * around them instead of being built again: the hole left by a removed position is filled
+ * with the triangulation of its neighbours, and an added position is connected to the
+ * vertices of the triangulation of its neighbourhood.  The repaired graph keeps the edges
+ * which are not Delaunay anymore, which does not hurt the spanning tree.  It is rebuilt from
+ * scratch once too many positions changed.
+ */
 class RN_NET::TRIANGULATOR_STATE
 {
 private:
-    std::vector<CN_ANCHOR_PTR>  m_allNodes;
-
-    std::list<hed::EDGE_PTR> hedTriangulation( std::vector<hed::NODE_PTR>& aNodes )
+    struct VERTEX
+    {
+        VECTOR2I         m_pos;
+        CN_ANCHOR_PTR    m_rep;              ///< the node standing for the position
+        std::vector<int> m_adjacent;
+        int              m_first = 0;        ///< index of the first node at m_pos in m_allNodes
+        int              m_count = 0;        ///< number of nodes at m_pos
+        int              m_visit = 0;
+        bool             m_live = false;
+        bool             m_touched = false;  ///< its edges changed since the previous update
+    };
+
+    struct POS_HASH
     {
-        hed::TRIANGULATION triangulator;
-        triangulator.CreateDelaunay( aNodes.begin(), aNodes.end() );
-        std::list<hed::EDGE_PTR> edges;
-        triangulator.GetEdges( edges );
+        size_t operator()( const VECTOR2I& aPos ) const
+        {
+            return std::hash<int64_t>()( ( (int64_t) aPos.x << 32 ) ^ (uint32_t) aPos.y );
+        }
+    };
 
-        return edges;
-    }
+    ///> Below this number of positions, the triangulation is always built from scratch
+    static const int MIN_LOCAL_UPDATE = 64;
+
+    std::vector<CN_ANCHOR_PTR>                   m_allNodes;
+    std::vector<VERTEX>                          m_vertices;
+    std::vector<int>                             m_freeVertices;
+    std::unordered_map<VECTOR2I, int, POS_HASH>  m_vertexIndex;
+    int                                          m_liveCount = 0;
+    int                                          m_localChanges = 0;
+    int                                          m_visitStamp = 0;
 
 
     // Checks if all nodes in aNodes lie on a single line. Requires the nodes to
@@ -189,6 +218,196 @@ private:
         return true;
     }
 
+    ///> Calls aAddEdge( a, b ) for each edge of the triangulation of the vertices aIds
+    template <class FUNC>
+    void triangulate( const std::vector<int>& aIds, FUNC aAddEdge )
+    {
+        std::vector<hed::NODE_PTR> triNodes;
+
+        triNodes.reserve( aIds.size() );
+
+        for( unsigned i = 0; i < aIds.size(); i++ )
+        {
+            const VECTOR2I& pos = m_vertices[aIds[i]].m_pos;
+            auto            tn = std::make_shared<hed::NODE>( pos.x, pos.y );
+
+            tn->SetId( i );
+            triNodes.push_back( tn );
+        }
+
+        if( triNodes.size() < 2 )
+        {
+            return;
+        }
+        else if( areNodesColinear( triNodes ) )
+        {
+            // special case: all nodes are on the same line - there's no
+            // triangulation for such set. In this case, we sort along any coordinate
+            // and chain the nodes together.
+            std::sort( triNodes.begin(), triNodes.end(),
+                    [] ( const hed::NODE_PTR& aNode1, const hed::NODE_PTR& aNode2 )
+                    {
+                        return aNode1->GetY() < aNode2->GetY()
+                               || ( aNode1->GetY() == aNode2->GetY()
+                                    && aNode1->GetX() < aNode2->GetX() );
+                    } );
+
+            for( unsigned i = 0; i + 1 < triNodes.size(); i++ )
+                aAddEdge( aIds[triNodes[i]->Id()], aIds[triNodes[i + 1]->Id()] );
+        }
+        else
+        {
+            hed::TRIANGULATION       triangulator;
+            std::list<hed::EDGE_PTR> triangEdges;
+
+            triangulator.CreateDelaunay( triNodes.begin(), triNodes.end() );
+            triangulator.GetEdges( triangEdges );
+
+            for( const auto& e : triangEdges )
+                aAddEdge( aIds[e->GetSourceNode()->Id()], aIds[e->GetTargetNode()->Id()] );
+        }
+    }
+
+    void addEdge( int aA, int aB )
+    {
+        std::vector<int>& adjacent = m_vertices[aA].m_adjacent;
+
+        if( aA == aB || std::find( adjacent.begin(), adjacent.end(), aB ) != adjacent.end() )
+            return;
+
+        adjacent.push_back( aB );
+        m_vertices[aB].m_adjacent.push_back( aA );
+    }
+
+    int newVertex( int aFirst, int aCount )
+    {
+        int id;
+
+        if( m_freeVertices.empty() )
+        {
+            id = m_vertices.size();
+            m_vertices.emplace_back();
+        }
+        else
+        {
+            id = m_freeVertices.back();
+            m_freeVertices.pop_back();
+        }
+
+        VERTEX& v = m_vertices[id];
+
+        v.m_pos = m_allNodes[aFirst]->Pos();
+        v.m_rep = m_allNodes[aFirst];
+        v.m_first = aFirst;
+        v.m_count = aCount;
+        v.m_live = true;
+        v.m_touched = true;
+
+        m_vertexIndex[v.m_pos] = id;
+        m_liveCount++;
+
+        return id;
+    }
+
+    void removeVertex( int aId )
+    {
+        std::vector<int> hole;
+
+        hole.swap( m_vertices[aId].m_adjacent );
+
+        for( int n : hole )
+        {
+            std::vector<int>& adjacent = m_vertices[n].m_adjacent;
+
+            adjacent.erase( std::find( adjacent.begin(), adjacent.end(), aId ) );
+            m_vertices[n].m_touched = true;
+        }
+
+        m_vertexIndex.erase( m_vertices[aId].m_pos );
+        m_vertices[aId] = VERTEX();
+        m_freeVertices.push_back( aId );
+        m_liveCount--;
+
+        // The new Delaunay edges all join former neighbours of the removed vertex, and are
+        // edges of the triangulation of these neighbours.
+        triangulate( hole, [this]( int aA, int aB ) { addEdge( aA, aB ); } );
+    }
+
+    void insertVertex( int aFirst, int aCount, int& aNearby )
+    {
+        const VECTOR2I pos = m_allNodes[aFirst]->Pos();
+
+        // Walk to the vertex nearest to pos, which is found by always moving
+        // to a closer neighbour in a Delaunay triangulation
+        int nearest = aNearby;
+
+        for( bool moved = true; moved; )
+        {
+            moved = false;
+
+            for( int n : m_vertices[nearest].m_adjacent )
+            {
+                if( ( m_vertices[n].m_pos - pos ).SquaredEuclideanNorm()
+                        < ( m_vertices[nearest].m_pos - pos ).SquaredEuclideanNorm() )
+                {
+                    nearest = n;
+                    moved = true;
+                    break;
+                }
+            }
+        }
+
+        // The new neighbours are looked for within two edges from the nearest vertex
+        std::vector<int> local = { nearest };
+
+        m_vertices[nearest].m_visit = ++m_visitStamp;
+
+        for( size_t ring = 0, begin = 0; ring < 2; ring++ )
+        {
+            size_t end = local.size();
+
+            for( size_t i = begin; i < end; i++ )
+            {
+                for( int n : m_vertices[local[i]].m_adjacent )
+                {
+                    if( m_vertices[n].m_visit != m_visitStamp )
+                    {
+                        m_vertices[n].m_visit = m_visitStamp;
+                        local.push_back( n );
+                    }
+                }
+            }
+
+            begin = end;
+        }
+
+        int id = newVertex( aFirst, aCount );
+
+        local.push_back( id );
+
+        triangulate( local, [this, id]( int aA, int aB )
+                {
+                    if( aA == id || aB == id )
+                        addEdge( aA, aB );
+                } );
+
+        aNearby = id;
+    }
+
+    void rebuild( const std::vector<std::pair<int, int>>& aPositions )
+    {
+        Reset();
+
+        std::vector<int> ids;
+
+        ids.reserve( aPositions.size() );
+
+        for( const auto& p : aPositions )
+            ids.push_back( newVertex( p.first, p.second ) );
+
+        triangulate( ids, [this]( int aA, int aB ) { addEdge( aA, aB ); } );
+    }
+
 public:
 
     void Clear()
@@ -196,120 +415,178 @@ public:
         m_allNodes.clear();
     }
 
+    ///> Forgets the triangulation, so the next Update() builds it from scratch
+    void Reset()
+    {
+        m_vertices.clear();
+        m_freeVertices.clear();
+        m_vertexIndex.clear();
+        m_liveCount = 0;
+        m_localChanges = 0;
+    }
+
     void AddNode( CN_ANCHOR_PTR aNode )
     {
         m_allNodes.push_back( aNode );
     }
 
-    const std::list<CN_EDGE> Triangulate()
+    /**
+     * Function Update()
+     * updates the triangulation to the positions of the added nodes.
+     * @return true if the triangulation was repaired locally, false if it was rebuilt.
+     */
+    bool Update()
     {
-        std::list<CN_EDGE> mstEdges;
-        std::list<hed::EDGE_PTR> triangEdges;
-        std::vector<hed::NODE_PTR> triNodes;
+        // Nodes at the same position are sorted by address, so the node standing for a
+        // position does not change as long as it is there.
+        std::sort( m_allNodes.begin(), m_allNodes.end(),
+                [] ( const CN_ANCHOR_PTR& aNode1, const CN_ANCHOR_PTR& aNode2 )
+                {
+                    if( aNode1->Pos().y != aNode2->Pos().y )
+                        return aNode1->Pos().y < aNode2->Pos().y;
+                    else if( aNode1->Pos().x != aNode2->Pos().x )
+                        return aNode1->Pos().x < aNode2->Pos().x;
 
-        using ANCHOR_LIST = std::vector<CN_ANCHOR_PTR>;
-        std::vector<ANCHOR_LIST> anchorChains;
+                    return aNode1.get() < aNode2.get();
+                } );
 
-        triNodes.reserve( m_allNodes.size() );
-        anchorChains.resize( m_allNodes.size() );
+        std::vector<std::pair<int, int>> positions;
 
-        std::sort( m_allNodes.begin(), m_allNodes.end(),
-                [] ( const CN_ANCHOR_PTR& aNode1, const CN_ANCHOR_PTR& aNode2 )
+        for( int i = 0; i < (int) m_allNodes.size(); )
         {
-            if( aNode1->Pos().y < aNode2->Pos().y )
-                return true;
-            else if( aNode1->Pos().y == aNode2->Pos().y )
-            {
-                return aNode1->Pos().x < aNode2->Pos().x;
-            }
+            int first = i;
 
-            return false;
+            while( i < (int) m_allNodes.size() && m_allNodes[i]->Pos() == m_allNodes[first]->Pos() )
+                i++;
+
+            positions.emplace_back( first, i - first );
         }
-                );
 
-        CN_ANCHOR_PTR prev, last;
-        int id = 0;
+        for( VERTEX& v : m_vertices )
+        {
+            v.m_count = 0;
+            v.m_touched = false;
+        }
+
+        std::vector<std::pair<int, int>> added;
 
-        for( const auto& n : m_allNodes )
+        for( const auto& p : positions )
         {
-            if( !prev || prev->Pos() != n->Pos() )
-            {
-                auto tn = std::make_shared<hed::NODE> ( n->Pos().x, n->Pos().y );
+            auto it = m_vertexIndex.find( m_allNodes[p.first]->Pos() );
 
-                tn->SetId( id );
-                triNodes.push_back( tn );
+            if( it == m_vertexIndex.end() )
+            {
+                added.push_back( p );
+                continue;
             }
 
-            id++;
-            prev = n;
+            VERTEX& v = m_vertices[it->second];
+
+            v.m_first = p.first;
+            v.m_count = p.second;
+
+            if( v.m_rep != m_allNodes[p.first] )
+            {
+                v.m_rep = m_allNodes[p.first];
+                v.m_touched = true;
+            }
         }
 
-        int prevId = 0;
+        std::vector<int> removed;
+        int              nearby = -1;
 
-        for( const auto& n : triNodes )
+        for( int i = 0; i < (int) m_vertices.size(); i++ )
         {
-            for( int i = prevId; i < n->Id(); i++ )
-                anchorChains[prevId].push_back( m_allNodes[ i ] );
+            if( m_vertices[i].m_live && m_vertices[i].m_count == 0 )
+                removed.push_back( i );
+            else if( m_vertices[i].m_live )
+                nearby = i;
+        }
+
+        int changes = added.size() + removed.size();
 
-            prevId = n->Id();
+        if( (int) positions.size() < MIN_LOCAL_UPDATE || nearby < 0
+                || changes * 4 > m_liveCount || ( m_localChanges + changes ) * 2 > m_liveCount )
+        {
+            rebuild( positions );
+            return false;
         }
 
-        for( int i = prevId; i < id; i++ )
-            anchorChains[prevId].push_back( m_allNodes[ i ] );
+        m_localChanges += changes;
 
-        if( triNodes.size() == 1 )
+        for( int id : removed )
         {
-            return mstEdges;
+            if( nearby < 0 || nearby == id || !m_vertices[nearby].m_live )
+                nearby = m_vertices[id].m_adjacent.empty() ? -1 : m_vertices[id].m_adjacent[0];
+
+            removeVertex( id );
         }
-        else if( areNodesColinear( triNodes ) )
+
+        for( const auto& p : added )
         {
-            // special case: all nodes are on the same line - there's no
-            // triangulation for such set. In this case, we sort along any coordinate
-            // and chain the nodes together.
-            for(int i = 0; i < (int)triNodes.size() - 1; i++ )
+            // A vertex left alone by the removals cannot reach the others
+            if( nearby < 0 || m_vertices[nearby].m_adjacent.empty() )
             {
-                auto src = m_allNodes[ triNodes[i]->Id() ];
-                auto dst = m_allNodes[ triNodes[i + 1]->Id() ];
-                mstEdges.emplace_back( src, dst, getDistance( src, dst ) );
+                rebuild( positions );
+                return false;
             }
+
+            insertVertex( p.first, p.second, nearby );
         }
-        else
+
+        return true;
+    }
+
+    /**
+     * Function GetEdges()
+     * adds the edges of the triangulation and the connections between the nodes sharing
+     * a position to aEdges.
+     * @param aIsRedundant, if set, tells if an edge which did not change since the previous
+     *        update is not needed anymore.  It is not called for the other edges.
+     */
+    void GetEdges( std::vector<CN_EDGE>& aEdges,
+            const std::function<bool( const CN_ANCHOR_PTR&, const CN_ANCHOR_PTR& )>& aIsRedundant )
+    {
+        std::vector<CN_ANCHOR_PTR> chain;
+
+        for( int i = 0; i < (int) m_vertices.size(); i++ )
         {
-            hed::TRIANGULATION triangulator;
-            triangulator.CreateDelaunay( triNodes.begin(), triNodes.end() );
-            triangulator.GetEdges( triangEdges );
+            const VERTEX& v = m_vertices[i];
 
-            for( const auto& e : triangEdges )
+            if( !v.m_live )
+                continue;
+
+            for( int j : v.m_adjacent )
             {
-                auto    src = m_allNodes[ e->GetSourceNode()->Id() ];
-                auto    dst = m_allNodes[ e->GetTargetNode()->Id() ];
+                const VERTEX& w = m_vertices[j];
 
-                mstEdges.emplace_back( src, dst, getDistance( src, dst ) );
-            }
-        }
+                if( j < i )
+                    continue;
 
-        for( unsigned int i = 0; i < anchorChains.size(); i++ )
-        {
-            auto& chain = anchorChains[i];
+                if( !v.m_touched && !w.m_touched && aIsRedundant && aIsRedundant( v.m_rep, w.m_rep ) )
+                    continue;
+
+                aEdges.emplace_back( v.m_rep, w.m_rep, getDistance( v.m_rep, w.m_rep ) );
+            }
 
-            if( chain.size() < 2 )
+            if( v.m_count < 2 || m_liveCount < 2 )
                 continue;
 
+            chain.assign( m_allNodes.begin() + v.m_first, m_allNodes.begin() + v.m_first + v.m_count );
+
             std::sort( chain.begin(), chain.end(),
                     [] ( const CN_ANCHOR_PTR& a, const CN_ANCHOR_PTR& b ) {
                 return a->GetCluster().get() < b->GetCluster().get();
             } );
 
-            for( unsigned int j = 1; j < chain.size(); j++ )
+            for( unsigned int k = 1; k < chain.size(); k++ )
             {
-                const auto& prevNode    = chain[j - 1];
-                const auto& curNode     = chain[j];
+                const auto& prevNode    = chain[k - 1];
+                const auto& curNode     = chain[k];
                 int weight = prevNode->GetCluster() != curNode->GetCluster() ? 1 : 0;
-                mstEdges.emplace_back( prevNode, curNode, weight );
+                aEdges.emplace_back( prevNode, curNode, weight );
             }
         }
-
-        return mstEdges;
     }
 };
 
@@ -327,6 +604,9 @@ void RN_NET::compute()
     if( m_nodes.size() <= 2 )
     {
         m_rnEdges.clear();
+        m_triangulator->Reset();
+        m_prevNodes.clear();
+        m_prevRnEdges.clear();
 
         // Check if the only possible connection exists
         if( m_boardEdges.size() == 0 && m_nodes.size() == 2 )
@@ -361,14 +641,77 @@ void RN_NET::compute()
     #ifdef PROFILE
     PROF_COUNTER cnt("triangulate");
     #endif
-    auto triangEdges = m_triangulator->Triangulate();
+    bool incremental = m_triangulator->Update();
+
+    std::vector<CN_EDGE> triangEdges( m_boardEdges );
+
+    if( !incremental )
+    {
+        m_triangulator->GetEdges( triangEdges, nullptr );
+    }
+    else
+    {
+        // Repair the previous spanning tree.  The parts of it which are still there are
+        // found: the edges between surviving nodes, and the nodes which are in the same
+        // cluster as before (their tag is the one given by kruskalMST()).  An edge which did
+        // not change and joins two nodes of the same part was longer than the tree path
+        // between them, and still is, so it can be left out.
+        std::unordered_map<const CN_ANCHOR*, int> index;
+        std::vector<int>                          parts( m_nodes.size() );
+
+        for( unsigned i = 0; i < m_nodes.size(); i++ )
+        {
+            index[m_nodes[i].get()] = i;
+            parts[i] = i;
+        }
+
+        auto find = [&parts]( int aNode )
+        {
+            while( parts[aNode] != aNode )
+                aNode = parts[aNode] = parts[parts[aNode]];
+
+            return aNode;
+        };
+
+        std::map<std::pair<int, const CN_CLUSTER*>, int> clusterParts;
+
+        for( const auto& node : m_prevNodes )
+        {
+            auto it = index.find( node.get() );
+
+            if( it == index.end() )
+                continue;
+
+            auto part = clusterParts.emplace( std::make_pair( node->GetTag(),
+                                                              node->GetCluster().get() ),
+                                              it->second );
+
+            if( !part.second )
+                parts[find( it->second )] = find( part.first->second );
+        }
+
+        for( const auto& edge : m_prevRnEdges )
+        {
+            auto src = index.find( edge.GetSourceNode().get() );
+            auto dst = index.find( edge.GetTargetNode().get() );
+
+            if( src != index.end() && dst != index.end() )
+            {
+                parts[find( src->second )] = find( dst->second );
+                triangEdges.push_back( edge );
+            }
+        }
+
+        m_triangulator->GetEdges( triangEdges,
+                [&]( const CN_ANCHOR_PTR& aNode1, const CN_ANCHOR_PTR& aNode2 )
+                {
+                    return find( index[aNode1.get()] ) == find( index[aNode2.get()] );
+                } );
+    }
     #ifdef PROFILE
     cnt.Show();
     #endif
 
-    for( const auto& e : m_boardEdges )
-        triangEdges.push_back( e );
-
 // Get the minimal spanning tree
 #ifdef PROFILE
     PROF_COUNTER cnt2("mst");
@@ -377,14 +720,29 @@ void RN_NET::compute()
 #ifdef PROFILE
     cnt2.Show();
 #endif
-}
 
+    m_prevNodes = m_nodes;
+    m_prevRnEdges = m_rnEdges;
+}
 
 
 void RN_NET::Update()
 {
+    TRACE_SCOPE trace( "ratsnest-net" );
+
     compute();
 
+    m_bbox = BOX2I();
+
+    if( !m_rnEdges.empty() )
+        m_bbox = BOX2I( m_rnEdges[0].GetSourceNode()->Pos(), VECTOR2I( 0, 0 ) );
+
+    for( const CN_EDGE& edge : m_rnEdges )
+    {
+        m_bbox.Merge( edge.GetSourceNode()->Pos() );
+        m_bbox.Merge( edge.GetTargetNode()->Pos() );
+    }
+
     m_dirty = false;
 }
 
@@ -392,6 +750,7 @@ void RN_NET::Update()
 void RN_NET::Clear()
 {
     m_rnEdges.clear();
+    m_bbox = BOX2I();
     m_boardEdges.clear();
     m_nodes.clear();
 
@@ -463,6 +822,100 @@ bool RN_NET::NearestBicoloredPair( const RN_NET& aOtherNet, CN_ANCHOR_PTR& aNode
 }
 
 
+RN_NODE_INDEX::RN_NODE_INDEX( const RN_NET& aNet )
+{
+    for( const auto& node : aNet.m_nodes )
+    {
+        if( !node->GetNoLine() )
+            m_nodes.push_back( node );
+    }
+
+    build( 0, m_nodes.size(), 0 );
+}
+
+
+void RN_NODE_INDEX::build( int aFirst, int aLast, int aAxis )
+{
+    if( aLast - aFirst < 2 )
+        return;
+
+    // The median node splits the others along aAxis, the halves along the other axis
+    int mid = ( aFirst + aLast ) / 2;
+
+    std::nth_element( m_nodes.begin() + aFirst, m_nodes.begin() + mid, m_nodes.begin() + aLast,
+            [aAxis]( const CN_ANCHOR_PTR& aNode1, const CN_ANCHOR_PTR& aNode2 )
+            {
+                return aAxis ? aNode1->Pos().y < aNode2->Pos().y
+                             : aNode1->Pos().x < aNode2->Pos().x;
+            } );
+
+    build( aFirst, mid, !aAxis );
+    build( mid + 1, aLast, !aAxis );
+}
+
+
+void RN_NODE_INDEX::nearest( int aFirst, int aLast, int aAxis, const VECTOR2I& aPos,
+        int& aNearest, VECTOR2I::extended_type& aDist ) const
+{
+    if( aFirst >= aLast )
+        return;
+
+    int             mid = ( aFirst + aLast ) / 2;
+    const VECTOR2I& pos = m_nodes[mid]->Pos();
+    auto            dist = ( pos - aPos ).SquaredEuclideanNorm();
+
+    if( dist < aDist )
+    {
+        aDist = dist;
+        aNearest = mid;
+    }
+
+    VECTOR2I::extended_type delta = aAxis ? (VECTOR2I::extended_type) aPos.y - pos.y
+                                          : (VECTOR2I::extended_type) aPos.x - pos.x;
+
+    // Search the half containing aPos first, the other one only if it may be closer
+    if( delta < 0 )
+    {
+        nearest( aFirst, mid, !aAxis, aPos, aNearest, aDist );
+
+        if( delta * delta < aDist )
+            nearest( mid + 1, aLast, !aAxis, aPos, aNearest, aDist );
+    }
+    else
+    {
+        nearest( mid + 1, aLast, !aAxis, aPos, aNearest, aDist );
+
+        if( delta * delta < aDist )
+            nearest( aFirst, mid, !aAxis, aPos, aNearest, aDist );
+    }
+}
+
+
+bool RN_NODE_INDEX::NearestBicoloredPair( const RN_NET& aOtherNet, CN_ANCHOR_PTR& aNode1,
+        CN_ANCHOR_PTR& aNode2 ) const
+{
+    bool rv = false;
+
+    VECTOR2I::extended_type distMax = VECTOR2I::ECOORD_MAX;
+
+    for( const auto& nodeB : aOtherNet.m_nodes )
+    {
+        int nearestA = -1;
+
+        nearest( 0, m_nodes.size(), 0, nodeB->Pos(), nearestA, distMax );
+
+        if( nearestA >= 0 )
+        {
+            rv = true;
+            aNode1 = m_nodes[nearestA];
+            aNode2 = nodeB;
+        }
+    }
+
+    return rv;
+}
+
+
 void RN_NET::SetVisible( bool aEnabled )
 {
     for( auto& edge : m_rnEdges )
@@ -102,7 +102,8 @@ public:
 
     /**
      * Function Update()
-     * Recomputes ratsnest for a net.
+     * Recomputes ratsnest for a net.  When only a few nodes changed since the previous
+     * update, the previous triangulation and spanning tree are repaired around them.
      */
     void Update();
     void Clear();
@@ -127,6 +128,15 @@ public:
         return m_rnEdges;
     }
 
+    /**
+     * Function GetBoundingBox()
+     * Returns the box enclosing the nodes of the ratsnest edges, as of the last Update().
+     */
+    const BOX2I& GetBoundingBox() const
+    {
+        return m_bbox;
+    }
+
     /**
      * Function GetAllItems()
      * Adds all stored items to a list.
@@ -145,7 +155,9 @@ public:
     bool NearestBicoloredPair( const RN_NET& aOtherNet, CN_ANCHOR_PTR& aNode1, CN_ANCHOR_PTR& aNode2 ) const;
 
 protected:
-    ///> Recomputes ratsnest from scratch.
+    friend class RN_NODE_INDEX;
+
+    ///> Recomputes ratsnest, repairing the previous one when possible.
     void compute();
 
     ///> Vector of nodes
@@ -157,6 +169,13 @@ protected:
     ///> Vector of edges that makes ratsnest for a given net.
     std::vector<CN_EDGE> m_rnEdges;
 
+    ///> Nodes and ratsnest edges of the previous update (Clear() keeps them)
+    std::vector<CN_ANCHOR_PTR> m_prevNodes;
+    std::vector<CN_EDGE> m_prevRnEdges;
+
+    ///> Box enclosing the nodes of m_rnEdges
+    BOX2I m_bbox;
+
     ///> Flag indicating necessity of recalculation of ratsnest for a net.
     bool m_dirty;
 
@@ -165,4 +184,33 @@ protected:
     std::shared_ptr<TRIANGULATOR_STATE> m_triangulator;
 };
 
+
+/**
+ * RN_NODE_INDEX
+ * A nearest neighbour index (a 2D k-d tree) of the nodes of a net which can be ratsnest line
+ * targets.  It is built once when a drag starts, since the unselected part of the net does not
+ * change while the selection moves, and then links the moved nodes to the net quickly.
+ */
+class RN_NODE_INDEX
+{
+public:
+    RN_NODE_INDEX( const RN_NET& aNet );
+
+    /**
+     * Function NearestBicoloredPair()
+     * gives the same result as aNet.NearestBicoloredPair( aOtherNet, aNode1, aNode2 ), aNet
+     * being the net given to the constructor.
+     */
+    bool NearestBicoloredPair( const RN_NET& aOtherNet, CN_ANCHOR_PTR& aNode1,
+            CN_ANCHOR_PTR& aNode2 ) const;
+
+private:
+    void build( int aFirst, int aLast, int aAxis );
+
+    void nearest( int aFirst, int aLast, int aAxis, const VECTOR2I& aPos, int& aNearest,
+            VECTOR2I::extended_type& aDist ) const;
+
+    std::vector<CN_ANCHOR_PTR> m_nodes;
+};
+
 #endif /* RATSNEST_DATA_H */
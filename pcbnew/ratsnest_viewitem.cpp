@@ -80,6 +80,22 @@ void RATSNEST_VIEWITEM::ViewDraw( int aLayer, KIGFX::VIEW* aView ) const
     gal->SetStrokeColor( color.Brightened(0.5) );
 
     const bool curved_ratsnest = rs->GetCurvedRatsnestLinesEnabled();
+    const bool global_ratsnest = rs->GetGlobalRatsnestLinesEnabled();
+
+    // Only the static ratsnest lines crossing the viewport are drawn
+    const BOX2D viewport = aView->GetViewport();
+    const BOX2I clip( VECTOR2I( viewport.GetOrigin() ), VECTOR2I( viewport.GetSize() ) );
+
+    // A curved line bulges out of the box of its ends by less than a tenth of its length
+    auto inView = [&]( BOX2I aBox )
+    {
+        int margin = CROSS_SIZE;
+
+        if( curved_ratsnest )
+            margin += ( aBox.GetWidth() + aBox.GetHeight() ) / 10;
+
+        return aBox.Inflate( margin ).Intersects( clip );
+    };
 
     // Draw the "dynamic" ratsnest (i.e. for objects that may be currently being moved)
     for( const auto& l : m_data->GetDynamicRatsnest() )
@@ -112,7 +128,7 @@ void RATSNEST_VIEWITEM::ViewDraw( int aLayer, KIGFX::VIEW* aView ) const
     {
         RN_NET* net = m_data->GetRatsnestForNet( i );
 
-        if( !net )
+        if( !net || net->GetEdges().empty() || !inView( net->GetBoundingBox() ) )
             continue;
 
         // Draw the "static" ratsnest
@@ -121,7 +137,7 @@ void RATSNEST_VIEWITEM::ViewDraw( int aLayer, KIGFX::VIEW* aView ) const
         else
             gal->SetStrokeColor( color );  // using the default ratsnest color for not highlighted
 
-        for( const auto& edge : net->GetUnconnected() )
+        for( const auto& edge : net->GetEdges() )
         {
             //if ( !edge.IsVisible() )
             //    continue;
@@ -134,6 +150,9 @@ void RATSNEST_VIEWITEM::ViewDraw( int aLayer, KIGFX::VIEW* aView ) const
             if( !sourceNode->Valid() || !targetNode->Valid() )
                 continue;
 
+            if( !inView( BOX2I( source, target - source ) ) )
+                continue;
+
             bool enable =  !sourceNode->GetNoLine() && !targetNode->GetNoLine();
             bool show;
 
@@ -141,7 +160,7 @@ void RATSNEST_VIEWITEM::ViewDraw( int aLayer, KIGFX::VIEW* aView ) const
             // should be easy to turn off, so either element can disable it
             // If the global ratsnest is disabled, the local ratsnest should be easy to turn on
             // so either element can enable it.
-            if( rs->GetGlobalRatsnestLinesEnabled() )
+            if( global_ratsnest )
                 show = sourceNode->Parent()->GetLocalRatsnestVisible() &&
                        targetNode->Parent()->GetLocalRatsnestVisible();
             else
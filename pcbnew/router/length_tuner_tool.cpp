@@ -138,8 +138,7 @@ LENGTH_TUNER_TOOL::~LENGTH_TUNER_TOOL()
 
 void LENGTH_TUNER_TOOL::Reset( RESET_REASON aReason )
 {
-    if( aReason == RUN )
-        TOOL_BASE::Reset( aReason );
+    TOOL_BASE::Reset( aReason );
 }
 
 
@@ -42,6 +42,7 @@ DIFF_PAIR_PLACER::DIFF_PAIR_PLACER( ROUTER* aRouter ) :
     m_chainedPlacement = false;
     m_initialDiagonal = false;
     m_startDiagonal = false;
+    m_lastFitOk = false;
     m_fitOk = false;
     m_netP = 0;
     m_netN = 0;
@@ -363,6 +364,7 @@ const ITEM_SET DIFF_PAIR_PLACER::Traces()
 void DIFF_PAIR_PLACER::FlipPosture()
 {
     m_startDiagonal = !m_startDiagonal;
+    invalidateGateways();
 
     if( !m_idle )
         Move( m_currentEnd, NULL );
@@ -602,12 +604,20 @@ bool DIFF_PAIR_PLACER::Start( const VECTOR2I& aP, ITEM* aStartItem )
 }
 
 
+void DIFF_PAIR_PLACER::invalidateGateways()
+{
+    m_entryGateways = NULLOPT;
+    m_lastFitKey = NULLOPT;
+}
+
+
 void DIFF_PAIR_PLACER::initPlacement()
 {
     m_idle = false;
     m_orthoMode = false;
     m_currentEndItem = NULL;
     m_startDiagonal = m_initialDiagonal;
+    invalidateGateways();
 
     NODE* world = Router()->GetWorld();
 
@@ -636,15 +646,24 @@ bool DIFF_PAIR_PLACER::routeHead( const VECTOR2I& aP )
 {
     m_fitOk = false;
 
-    DP_GATEWAYS gwsEntry( gap() );
     DP_GATEWAYS gwsTarget( gap() );
 
     if( !m_prevPair )
+    {
         m_prevPair = m_start;
+        invalidateGateways();
+    }
 
-    gwsEntry.BuildFromPrimitivePair( *m_prevPair, m_startDiagonal );
+    // The entry gateways only depend on where the head starts
+    if( !m_entryGateways )
+    {
+        m_entryGateways = DP_GATEWAYS( gap() );
+        m_entryGateways->BuildFromPrimitivePair( *m_prevPair, m_startDiagonal );
+    }
 
+    DP_GATEWAYS& gwsEntry = *m_entryGateways;
     DP_PRIMITIVE_PAIR target;
+    OPT<HEAD_FIT_KEY> fitKey;
 
     if( findDpPrimitivePair( aP, m_currentEndItem, target ) )
     {
@@ -667,20 +686,10 @@ bool DIFF_PAIR_PLACER::routeHead( const VECTOR2I& aP )
         // on the extension of the starting segment pair of the DP)
         int lead_dist = ( fpProj - fp ).EuclideanNorm();
 
-        gwsTarget.SetFitVias( m_placingVia, m_sizes.ViaDiameter(), viaGap() );
+        bool straight = lead_dist <= m_sizes.DiffPairGap() + m_sizes.DiffPairWidth();
 
-        // far from the initial segment extension line -> allow a 45-degree obtuse turn
-        if( lead_dist > m_sizes.DiffPairGap() + m_sizes.DiffPairWidth() )
-        {
-            gwsTarget.BuildForCursor( fp );
-        }
-        // close to the initial segment extension line -> keep straight part only, project as close
-        // as possible to the cursor
-        else
-        {
-            gwsTarget.BuildForCursor( fpProj );
-            gwsTarget.FilterByOrientation( DIRECTION_45::ANG_STRAIGHT | DIRECTION_45::ANG_HALF_FULL, DIRECTION_45( dirV ) );
-        }
+        fitKey = HEAD_FIT_KEY{ straight ? fpProj : fp, dirV, straight, m_placingVia,
+                               m_sizes.ViaDiameter(), viaGap() };
 
         m_snapOnTarget = false;
     }
@@ -689,7 +698,45 @@ bool DIFF_PAIR_PLACER::routeHead( const VECTOR2I& aP )
     m_currentTrace.SetGap( gap() );
     m_currentTrace.SetLayer( m_currentLayer );
 
-    bool result = gwsEntry.FitGateways( gwsEntry, gwsTarget, m_startDiagonal, m_currentTrace );
+    bool result;
+
+    // The cursor often moves within a grid cell: the gateways, and so the head, are the same
+    if( fitKey && m_lastFitKey && *fitKey == *m_lastFitKey )
+    {
+        result = m_lastFitOk;
+
+        if( result )
+            m_currentTrace.SetShape( m_lastFitP, m_lastFitN );
+    }
+    else
+    {
+        if( fitKey )
+        {
+            gwsTarget.SetFitVias( m_placingVia, m_sizes.ViaDiameter(), viaGap() );
+
+            // far from the initial segment extension line -> allow a 45-degree obtuse turn.
+            // close to the initial segment extension line -> keep straight part only, project
+            // as close as possible to the cursor
+            gwsTarget.BuildForCursor( fitKey->m_cursor );
+
+            if( fitKey->m_straight )
+            {
+                gwsTarget.FilterByOrientation( DIRECTION_45::ANG_STRAIGHT | DIRECTION_45::ANG_HALF_FULL,
+                                               DIRECTION_45( fitKey->m_direction ) );
+            }
+        }
+
+        result = gwsEntry.FitGateways( gwsEntry, gwsTarget, m_startDiagonal, m_currentTrace );
+
+        m_lastFitKey = fitKey;
+        m_lastFitOk = result;
+
+        if( result )
+        {
+            m_lastFitP = m_currentTrace.CP();
+            m_lastFitN = m_currentTrace.CN();
+        }
+    }
 
     if( result )
     {
@@ -793,6 +840,7 @@ bool DIFF_PAIR_PLACER::FixRoute( const VECTOR2I& aP, ITEM* aEndItem, bool aForce
     topo.SimplifyLine( &lineN );
 
     m_prevPair = m_currentTrace.EndingPrimitives();
+    invalidateGateways();
 
     CommitPlacement();
     m_placingVia = false;
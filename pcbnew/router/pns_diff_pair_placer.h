@@ -258,6 +258,36 @@ private:
     DP_PRIMITIVE_PAIR m_start;
     OPT<DP_PRIMITIVE_PAIR> m_prevPair;
 
+    ///> cursor gateways the head was fitted to, see routeHead()
+    struct HEAD_FIT_KEY
+    {
+        VECTOR2I m_cursor;
+        VECTOR2I m_direction;
+        bool     m_straight;
+        bool     m_placingVia;
+        int      m_viaDiameter;
+        int      m_viaGap;
+
+        bool operator==( const HEAD_FIT_KEY& aOther ) const
+        {
+            return m_cursor == aOther.m_cursor && m_direction == aOther.m_direction
+                   && m_straight == aOther.m_straight && m_placingVia == aOther.m_placingVia
+                   && m_viaDiameter == aOther.m_viaDiameter && m_viaGap == aOther.m_viaGap;
+        }
+    };
+
+    ///> drops the gateways cached by routeHead(), when m_prevPair, the posture or the sizes
+    ///> change
+    void invalidateGateways();
+
+    ///> gateways of m_prevPair, the same for all the cursor moves until the next fix
+    OPT<DP_GATEWAYS> m_entryGateways;
+
+    ///> last head fitted to the cursor gateways, and its shape
+    OPT<HEAD_FIT_KEY> m_lastFitKey;
+    bool m_lastFitOk;
+    SHAPE_LINE_CHAIN m_lastFitP, m_lastFitN;
+
     ///> current algorithm iteration
     int m_iteration;
 
@@ -43,8 +43,9 @@ DP_MEANDER_PLACER::DP_MEANDER_PLACER( ROUTER* aRouter ) :
     m_padToDieN = 0;
 
     // Init temporary variables (do not leave uninitialized members)
-    m_initialSegment = NULL;
-    m_lastLength     = 0;
+    m_initialSegment  = NULL;
+    m_tunedPathLength = 0;
+    m_lastLength      = 0;
     m_lastStatus     = TOO_SHORT;
 }
 
@@ -112,6 +113,24 @@ bool DP_MEANDER_PLACER::Start( const VECTOR2I& aP, ITEM* aStartItem )
     m_padToDieN = GetTotalPadToDieLength( m_originPair.NLine() );
     m_padToDieLenth = std::max( m_padToDieP, m_padToDieN );
 
+    // The paths only change once the tuned lines are committed
+    long long int totalP = m_padToDieLenth;
+    long long int totalN = m_padToDieLenth;
+
+    for( const ITEM* item : m_tunedPathP.CItems() )
+    {
+        if( const LINE* l = dyn_cast<const LINE*>( item ) )
+            totalP += l->CLine().Length();
+    }
+
+    for( const ITEM* item : m_tunedPathN.CItems() )
+    {
+        if( const LINE* l = dyn_cast<const LINE*>( item ) )
+            totalN += l->CLine().Length();
+    }
+
+    m_tunedPathLength = std::max( totalP, totalN );
+
     m_world->Remove( m_originPair.PLine() );
     m_world->Remove( m_originPair.NLine() );
 
@@ -128,23 +147,7 @@ void DP_MEANDER_PLACER::release()
 
 long long int DP_MEANDER_PLACER::origPathLength() const
 {
-    long long int totalP = m_padToDieLenth;
-    long long int totalN = m_padToDieLenth;
-
-    for( const ITEM* item : m_tunedPathP.CItems() )
-    {
-        if( const LINE* l = dyn_cast<const LINE*>( item ) )
-            totalP += l->CLine().Length();
-
-    }
-
-    for( const ITEM* item : m_tunedPathN.CItems() )
-    {
-        if( const LINE* l = dyn_cast<const LINE*>( item ) )
-            totalN += l->CLine().Length();
-    }
-
-    return std::max( totalP, totalN );
+    return m_tunedPathLength;
 }
 
 
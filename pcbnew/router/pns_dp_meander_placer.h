@@ -147,6 +147,9 @@ private:
     MEANDERED_LINE m_result;
     SEGMENT* m_initialSegment;
 
+    ///> origPathLength(), measured once in Start()
+    long long int m_tunedPathLength;
+
     long long int m_lastLength;
     int           m_padToDieP;
     int           m_padToDieN;
@@ -48,6 +48,7 @@
 #include <geometry/shape_arc.h>
 #include <geometry/shape_simple.h>
 
+#include <functional>
 #include <memory>
 
 #include "tools/pcb_tool_base.h"
@@ -233,6 +234,11 @@ bool PNS_PCBNEW_RULE_RESOLVER::CollideHoles( const PNS::ITEM* aA, const PNS::ITE
 
 int PNS_PCBNEW_RULE_RESOLVER::localPadClearance( const PNS::ITEM* aItem ) const
 {
+    // Called twice for each collision check: rule out the tracks and vias, and the boards
+    // without any local clearance, before looking at the parent
+    if( m_localClearanceCache.empty() || aItem->Kind() != PNS::ITEM::SOLID_T )
+        return 0;
+
     if( !aItem->Parent() || aItem->Parent()->Type() != PCB_PAD_T )
         return 0;
 
@@ -533,6 +539,8 @@ PNS_KICAD_IFACE_BASE::PNS_KICAD_IFACE_BASE()
     m_router = nullptr;
     m_debugDecorator = nullptr;
     m_router = nullptr;
+    m_zonesChanged = false;
+    m_worstPadClearance = 0;
 }
 
 
@@ -632,9 +640,10 @@ std::unique_ptr<PNS::SOLID> PNS_KICAD_IFACE_BASE::syncPad( D_PAD* aPad )
     }
     else if( aPad->GetShape() == PAD_SHAPE_CUSTOM )
     {
-        SHAPE_POLY_SET outline;
-        outline.Append( aPad->GetCustomShapeAsPolygon() );
-        aPad->CustomShapeAsPolygonToBoardPosition( &outline, wx_c, aPad->GetOrientation() );
+        SHAPE_POLY_SET outline = aPad->GetBoardPolygon();
+
+        if( wx_c != aPad->GetPosition() )
+            outline.Move( VECTOR2I( wx_c - aPad->GetPosition() ) );
 
         SHAPE_SIMPLE* shape = new SHAPE_SIMPLE();
 
@@ -937,7 +946,8 @@ bool PNS_KICAD_IFACE_BASE::syncZone( PNS::NODE* aWorld, ZONE_CONTAINER* aZone )
 }
 
 
-bool PNS_KICAD_IFACE_BASE::syncTextItem( PNS::NODE* aWorld, EDA_TEXT* aText, PCB_LAYER_ID aLayer )
+bool PNS_KICAD_IFACE_BASE::syncTextItem( PNS::NODE* aWorld, const BOARD_ITEM* aOwner,
+                                         EDA_TEXT* aText, PCB_LAYER_ID aLayer )
 {
     if( !IsCopperLayer( aLayer ) )
         return false;
@@ -962,7 +972,7 @@ bool PNS_KICAD_IFACE_BASE::syncTextItem( PNS::NODE* aWorld, EDA_TEXT* aText, PCB
         solid->SetShape( new SHAPE_SEGMENT( start, end, textWidth ) );
         solid->SetRoutable( false );
 
-        aWorld->Add( std::move( solid ) );
+        addFixedItem( aWorld, aOwner, std::move( solid ) );
     }
 
     return true;
@@ -1076,7 +1086,7 @@ bool PNS_KICAD_IFACE_BASE::syncGraphicalItem( PNS::NODE* aWorld, DRAWSEGMENT* aI
         solid->SetShape( seg );
         solid->SetRoutable( false );
 
-        aWorld->Add( std::move( solid ) );
+        addFixedItem( aWorld, aItem, std::move( solid ) );
     }
 
     return true;
@@ -1145,93 +1155,243 @@ bool PNS_KICAD_IFACE::IsItemVisible( const PNS::ITEM* aItem )
 }
 
 
-void PNS_KICAD_IFACE_BASE::SyncWorld( PNS::NODE *aWorld )
+void PNS_KICAD_IFACE_BASE::addFixedItem( PNS::NODE* aWorld, const BOARD_ITEM* aOwner,
+                                         std::unique_ptr<PNS::SOLID> aSolid )
 {
-    int worstPadClearance = 0;
+    m_fixedItems[aOwner].push_back( aSolid.get() );
+    aWorld->Add( std::move( aSolid ) );
+}
 
-    if( !m_board )
+
+/**
+ * Calls aFunc for aItem, or for the items of aItem synced to the world if it is a footprint.
+ */
+static void forEachSyncedItem( BOARD_ITEM* aItem, const std::function<void( BOARD_ITEM* )>& aFunc )
+{
+    if( aItem->Type() != PCB_MODULE_T )
     {
-        wxLogTrace( "PNS", "No board attached, aborting sync." );
+        aFunc( aItem );
         return;
     }
 
-    for( auto gitem : m_board->Drawings() )
+    MODULE* module = static_cast<MODULE*>( aItem );
+
+    for( D_PAD* pad : module->Pads() )
+        aFunc( pad );
+
+    aFunc( &module->Reference() );
+    aFunc( &module->Value() );
+
+    for( MODULE_ZONE_CONTAINER* zone : module->Zones() )
+        aFunc( zone );
+
+    for( BOARD_ITEM* mgitem : module->GraphicalItems() )
+        aFunc( mgitem );
+}
+
+
+void PNS_KICAD_IFACE_BASE::syncItem( PNS::NODE* aWorld, BOARD_ITEM* aItem )
+{
+    // Graphics of net ties are not obstacles (they join the nets), but the reference and value are
+    auto isNetTieGraphic =
+            []( BOARD_ITEM* aGraphic )
+            {
+                MODULE* module = static_cast<MODULE*>( aGraphic->GetParent() );
+                return module && module->IsNetTie();
+            };
+
+    switch( aItem->Type() )
     {
-        if ( gitem->Type() == PCB_LINE_T )
-        {
-            syncGraphicalItem( aWorld, static_cast<DRAWSEGMENT*>( gitem ) );
-        }
-        else if( gitem->Type() == PCB_TEXT_T )
-        {
-            syncTextItem( aWorld, static_cast<TEXTE_PCB*>( gitem ), gitem->GetLayer() );
-        }
+    case PCB_LINE_T:
+        syncGraphicalItem( aWorld, static_cast<DRAWSEGMENT*>( aItem ) );
+        break;
+
+    case PCB_TEXT_T:
+        syncTextItem( aWorld, aItem, static_cast<TEXTE_PCB*>( aItem ), aItem->GetLayer() );
+        break;
+
+    case PCB_ZONE_AREA_T:
+    case PCB_MODULE_ZONE_AREA_T:
+        syncZone( aWorld, static_cast<ZONE_CONTAINER*>( aItem ) );
+        break;
+
+    case PCB_PAD_T:
+    {
+        D_PAD* pad = static_cast<D_PAD*>( aItem );
+
+        if( auto solid = syncPad( pad ) )
+            aWorld->Add( std::move( solid ) );
+
+        m_worstPadClearance = std::max( m_worstPadClearance, pad->GetLocalClearance() );
+        break;
     }
 
-    for( auto zone : m_board->Zones() )
+    case PCB_MODULE_TEXT_T:
     {
-        syncZone( aWorld, zone );
+        TEXTE_MODULE* text = static_cast<TEXTE_MODULE*>( aItem );
+
+        if( text->GetType() == TEXTE_MODULE::TEXT_is_DIVERS && isNetTieGraphic( aItem ) )
+            break;
+
+        syncTextItem( aWorld, aItem, text, text->GetLayer() );
+        break;
     }
 
-    for( auto module : m_board->Modules() )
+    case PCB_MODULE_EDGE_T:
+        if( !isNetTieGraphic( aItem ) )
+            syncGraphicalItem( aWorld, static_cast<DRAWSEGMENT*>( aItem ) );
+
+        break;
+
+    case PCB_TRACE_T:
+        if( auto segment = syncTrack( static_cast<TRACK*>( aItem ) ) )
+            aWorld->Add( std::move( segment ) );
+
+        break;
+
+    case PCB_ARC_T:
+        if( auto arc = syncArc( static_cast<ARC*>( aItem ) ) )
+            aWorld->Add( std::move( arc ) );
+
+        break;
+
+    case PCB_VIA_T:
+        if( auto via = syncVia( static_cast<VIA*>( aItem ) ) )
+            aWorld->Add( std::move( via ) );
+
+        break;
+
+    default:
+        break;
+    }
+}
+
+
+void PNS_KICAD_IFACE_BASE::syncRules( PNS::NODE* aWorld )
+{
+    int worstRuleClearance = m_board->GetDesignSettings().GetBiggestClearanceValue();
+
+    delete m_ruleResolver;
+    m_ruleResolver = new PNS_PCBNEW_RULE_RESOLVER( m_board, m_router );
+
+    aWorld->SetRuleResolver( m_ruleResolver );
+    aWorld->SetMaxClearance( 4 * std::max( m_worstPadClearance, worstRuleClearance ) );
+}
+
+
+void PNS_KICAD_IFACE_BASE::SyncWorld( PNS::NODE *aWorld )
+{
+    if( !m_board )
     {
-        for( auto pad : module->Pads() )
-        {
-            if( auto solid = syncPad( pad ) )
-                aWorld->Add( std::move( solid ) );
+        wxLogTrace( "PNS", "No board attached, aborting sync." );
+        return;
+    }
 
-            worstPadClearance = std::max( worstPadClearance, pad->GetLocalClearance() );
-        }
+    m_fixedItems.clear();
+    m_changedItems.clear();
+    m_removedItems.clear();
+    m_zonesChanged = false;
+    m_worstPadClearance = 0;
 
-        syncTextItem( aWorld, &module->Reference(), module->Reference().GetLayer() );
-        syncTextItem( aWorld, &module->Value(), module->Value().GetLayer() );
+    auto sync = [&]( BOARD_ITEM* aItem )
+                {
+                    syncItem( aWorld, aItem );
+                };
 
-        for( MODULE_ZONE_CONTAINER* zone : module->Zones() )
-            syncZone( aWorld, zone );
+    for( BOARD_ITEM* gitem : m_board->Drawings() )
+        sync( gitem );
 
-        if( module->IsNetTie() )
-            continue;
+    for( ZONE_CONTAINER* zone : m_board->Zones() )
+        sync( zone );
 
-        for( auto mgitem : module->GraphicalItems() )
-        {
-            if( mgitem->Type() == PCB_MODULE_EDGE_T )
+    for( MODULE* module : m_board->Modules() )
+        forEachSyncedItem( module, sync );
+
+    for( TRACK* track : m_board->Tracks() )
+        sync( track );
+
+    syncRules( aWorld );
+}
+
+
+void PNS_KICAD_IFACE_BASE::MarkItemChanged( BOARD_ITEM* aItem )
+{
+    forEachSyncedItem( aItem,
+            [&]( BOARD_ITEM* aChanged )
             {
-                syncGraphicalItem( aWorld, static_cast<DRAWSEGMENT*>( mgitem ) );
-            }
-            else if( mgitem->Type() == PCB_MODULE_TEXT_T )
+                m_changedItems.insert( aChanged );
+                m_zonesChanged |= aChanged->Type() == PCB_ZONE_AREA_T;
+            } );
+}
+
+
+void PNS_KICAD_IFACE_BASE::MarkItemRemoved( BOARD_ITEM* aItem )
+{
+    // The item may be deleted (and its memory reused by a new item) before the next update:
+    // it is only used as a key from now on
+    forEachSyncedItem( aItem,
+            [&]( BOARD_ITEM* aRemoved )
             {
-                syncTextItem( aWorld, static_cast<TEXTE_MODULE*>( mgitem ), mgitem->GetLayer() );
-            }
-        }
+                m_changedItems.erase( aRemoved );
+                m_removedItems.insert( aRemoved );
+                m_zonesChanged |= aRemoved->Type() == PCB_ZONE_AREA_T;
+            } );
+}
+
+
+bool PNS_KICAD_IFACE_BASE::UpdateWorld( PNS::NODE* aWorld )
+{
+    if( !m_board )
+        return false;
+
+    // The smoothed outline of a keepout depends on the other zones (see syncZone())
+    if( m_zonesChanged )
+    {
+        for( ZONE_CONTAINER* zone : m_board->Zones() )
+            m_changedItems.insert( zone );
     }
 
-    for( auto t : m_board->Tracks() )
+    std::unordered_set<const BOARD_ITEM*> outdated( m_removedItems );
+    std::unordered_set<const PNS::ITEM*>  outdatedFixed;
+
+    outdated.insert( m_changedItems.begin(), m_changedItems.end() );
+
+    for( const BOARD_ITEM* item : outdated )
     {
-        KICAD_T type = t->Type();
+        auto fixed = m_fixedItems.find( item );
 
-        if( type == PCB_TRACE_T )
+        if( fixed != m_fixedItems.end() )
         {
-            if( auto segment = syncTrack( t ) )
-                aWorld->Add( std::move( segment ) );
-        }
-        else if( type == PCB_ARC_T )
-        {
-            if( auto arc = syncArc( static_cast<ARC*>( t ) ) )
-                aWorld->Add( std::move( arc ) );
-        }
-        else if( type == PCB_VIA_T )
-        {
-            if( auto via = syncVia( static_cast<VIA*>( t ) ) )
-                aWorld->Add( std::move( via ) );
+            outdatedFixed.insert( fixed->second.begin(), fixed->second.end() );
+            m_fixedItems.erase( fixed );
         }
     }
 
-    int worstRuleClearance = m_board->GetDesignSettings().GetBiggestClearanceValue();
+    // The world items of connected board items (and keepouts) point to them, and may have
+    // been replaced by the router since the last sync: find them by parent
+    if( !outdated.empty() )
+    {
+        aWorld->RemoveIf(
+                [&]( const PNS::ITEM* aItem )
+                {
+                    return ( aItem->Parent() && outdated.count( aItem->Parent() ) )
+                           || outdatedFixed.count( aItem );
+                } );
+    }
 
-    delete m_ruleResolver;
-    m_ruleResolver = new PNS_PCBNEW_RULE_RESOLVER( m_board, m_router );
+    for( BOARD_ITEM* item : m_changedItems )
+        syncItem( aWorld, item );
 
-    aWorld->SetRuleResolver( m_ruleResolver );
-    aWorld->SetMaxClearance( 4 * std::max(worstPadClearance, worstRuleClearance ) );
+    wxLogTrace( "PNS", "Updated world: %d items changed, %d removed", (int) m_changedItems.size(),
+                (int) m_removedItems.size() );
+
+    m_changedItems.clear();
+    m_removedItems.clear();
+    m_zonesChanged = false;
+
+    syncRules( aWorld );
+
+    return true;
 }
 
 
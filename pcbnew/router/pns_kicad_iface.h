@@ -22,7 +22,9 @@
 #ifndef __PNS_KICAD_IFACE_H
 #define __PNS_KICAD_IFACE_H
 
+#include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include "pns_router.h"
 
@@ -31,6 +33,7 @@ class PNS_PCBNEW_DEBUG_DECORATOR;
 
 class BOARD;
 class BOARD_COMMIT;
+class BOARD_ITEM;
 class PCB_DISPLAY_OPTIONS;
 class PCB_TOOL_BASE;
 class MODULE;
@@ -53,6 +56,22 @@ public:
     void EraseView() override {};
     void SetBoard( BOARD* aBoard );
     void SyncWorld( PNS::NODE* aWorld ) override;
+
+    /**
+     * Function UpdateWorld()
+     * Brings a world built by SyncWorld() up to date with the items marked as changed or
+     * removed since then.  The world must have no children.
+     */
+    bool UpdateWorld( PNS::NODE* aWorld ) override;
+
+    /**
+     * Functions MarkItemChanged(), MarkItemRemoved()
+     * Record a board item added, modified or removed since the last sync, for the next
+     * UpdateWorld().  A footprint stands for all its pads, texts, graphics and zones.
+     * The items must still be alive when marked.
+     */
+    void MarkItemChanged( BOARD_ITEM* aItem );
+    void MarkItemRemoved( BOARD_ITEM* aItem );
     bool IsAnyLayerVisible( const LAYER_RANGE& aLayer ) override { return true; };
     bool IsItemVisible( const PNS::ITEM* aItem ) override { return true; }
     void HideItem( PNS::ITEM* aItem ) override {}
@@ -76,12 +95,29 @@ protected:
     std::unique_ptr<PNS::SEGMENT> syncTrack( TRACK* aTrack );
     std::unique_ptr<PNS::ARC> syncArc( ARC* aArc );
     std::unique_ptr<PNS::VIA> syncVia( VIA* aVia );
-    bool syncTextItem( PNS::NODE* aWorld, EDA_TEXT* aText, PCB_LAYER_ID aLayer );
+    bool syncTextItem( PNS::NODE* aWorld, const BOARD_ITEM* aOwner, EDA_TEXT* aText,
+                       PCB_LAYER_ID aLayer );
     bool syncGraphicalItem( PNS::NODE* aWorld, DRAWSEGMENT* aItem );
     bool syncZone( PNS::NODE* aWorld, ZONE_CONTAINER* aZone );
+    void syncItem( PNS::NODE* aWorld, BOARD_ITEM* aItem );
+    void syncRules( PNS::NODE* aWorld );
+
+    ///> adds a solid without parent (text, graphics) owned by the board item aOwner
+    void addFixedItem( PNS::NODE* aWorld, const BOARD_ITEM* aOwner,
+                       std::unique_ptr<PNS::SOLID> aSolid );
 
     PNS::ROUTER* m_router;
     BOARD* m_board;
+
+    ///> solids without parent in the world, by owning board item
+    std::unordered_map<const BOARD_ITEM*, std::vector<const PNS::ITEM*>> m_fixedItems;
+
+    ///> board items changed or removed since the last sync
+    std::unordered_set<BOARD_ITEM*> m_changedItems;
+    std::unordered_set<const BOARD_ITEM*> m_removedItems;
+    bool m_zonesChanged;
+
+    int m_worstPadClearance;
 };
 
 class PNS_KICAD_IFACE : public PNS_KICAD_IFACE_BASE {
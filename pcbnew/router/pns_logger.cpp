@@ -49,6 +49,13 @@ void LOGGER::Clear()
 {
     m_theLog.str( std::string() );
     m_groupOpened = false;
+    m_events.clear();
+}
+
+
+void LOGGER::Log( const EVENT_ENTRY& aEvent )
+{
+    m_events.push_back( aEvent );
 }
 
 
@@ -202,7 +209,49 @@ void LOGGER::Save( const std::string& aFilename )
     wxLogTrace( "PNS", "Saving to '%s' [%p]", aFilename.c_str(), f );
     const std::string s = m_theLog.str();
     fwrite( s.c_str(), 1, s.length(), f );
+
+    for( const EVENT_ENTRY& evt : m_events )
+    {
+        const std::string uuid = evt.uuid.AsString().ToStdString();
+
+        fprintf( f, "event %d %d %d %s %d %d %d %d\n", (int) evt.type, evt.p.x, evt.p.y,
+                 uuid.c_str(), evt.param, evt.durationUs, evt.collisionQueries,
+                 evt.shoveIterations );
+    }
+
     fclose( f );
 }
 
+
+std::vector<LOGGER::EVENT_ENTRY> LOGGER::ParseEvents( std::istream& aStream )
+{
+    std::vector<EVENT_ENTRY> events;
+    std::string              line;
+
+    while( std::getline( aStream, line ) )
+    {
+        std::istringstream tokens( line );
+        std::string        tag, uuid;
+        int                type;
+        EVENT_ENTRY        evt;
+
+        tokens >> tag;
+
+        if( tag != "event" )
+            continue;
+
+        tokens >> type >> evt.p.x >> evt.p.y >> uuid >> evt.param >> evt.durationUs
+               >> evt.collisionQueries >> evt.shoveIterations;
+
+        if( !tokens || type < EVT_START_ROUTE || type > EVT_ABORT )
+            continue;
+
+        evt.type = (EVENT_TYPE) type;
+        evt.uuid = KIID( wxString( uuid ) );
+        events.push_back( evt );
+    }
+
+    return events;
+}
+
 }
@@ -23,10 +23,12 @@
 #define __PNS_LOGGER_H
 
 #include <cstdio>
+#include <istream>
 #include <vector>
 #include <string>
 #include <sstream>
 
+#include <common.h>
 #include <math/vector2d.h>
 
 class SHAPE_LINE_CHAIN;
@@ -39,12 +41,46 @@ class ITEM;
 class LOGGER
 {
 public:
+    ///> router inputs, in the order they came
+    enum EVENT_TYPE
+    {
+        EVT_START_ROUTE = 0,
+        EVT_START_DRAG,
+        EVT_FIX,
+        EVT_MOVE,
+        EVT_ABORT
+    };
+
+    struct EVENT_ENTRY
+    {
+        EVENT_TYPE type;
+        VECTOR2I   p;
+        KIID       uuid;             ///< parent of the item of the event, niluuid if none
+        int        param;            ///< layer of EVT_START_ROUTE, drag mode of EVT_START_DRAG
+        int        durationUs;       ///< time the router took to process the event
+        int        collisionQueries;
+        int        shoveIterations;
+    };
+
     LOGGER();
     ~LOGGER();
 
     void Save( const std::string& aFilename );
     void Clear();
 
+    void Log( const EVENT_ENTRY& aEvent );
+
+    const std::vector<EVENT_ENTRY>& GetEvents() const
+    {
+        return m_events;
+    }
+
+    /**
+     * Function ParseEvents()
+     * Reads back the events of a log written by Save(), skipping the other records.
+     */
+    static std::vector<EVENT_ENTRY> ParseEvents( std::istream& aStream );
+
     void NewGroup( const std::string& aName, int aIter = 0 );
     void EndGroup();
 
@@ -58,6 +94,7 @@ private:
 
     bool m_groupOpened;
     std::stringstream m_theLog;
+    std::vector<EVENT_ENTRY> m_events;
 };
 
 }
@@ -38,6 +38,7 @@ MEANDER_PLACER::MEANDER_PLACER( ROUTER* aRouter ) :
 
     // Init temporary variables (do not leave uninitialized members)
     m_initialSegment = NULL;
+    m_tunedPathLength = 0;
     m_lastLength = 0;
     m_lastStatus = TOO_SHORT;
 }
@@ -82,6 +83,14 @@ bool MEANDER_PLACER::Start( const VECTOR2I& aP, ITEM* aStartItem )
     TOPOLOGY topo( m_world );
     m_tunedPath = topo.AssembleTrivialPath( m_initialSegment );
 
+    m_tunedPathLength = m_padToDieLenth;
+
+    for( const ITEM* item : m_tunedPath.CItems() )
+    {
+        if( const LINE* l = dyn_cast<const LINE*>( item ) )
+            m_tunedPathLength += l->CLine().Length();
+    }
+
     m_world->Remove( m_originLine );
 
     m_currentWidth = m_originLine.Width();
@@ -93,16 +102,7 @@ bool MEANDER_PLACER::Start( const VECTOR2I& aP, ITEM* aStartItem )
 
 long long int MEANDER_PLACER::origPathLength() const
 {
-    long long int total = m_padToDieLenth;
-    for( const ITEM* item : m_tunedPath.CItems() )
-    {
-        if( const LINE* l = dyn_cast<const LINE*>( item ) )
-        {
-            total += l->CLine().Length();
-        }
-    }
-
-    return total;
+    return m_tunedPathLength;
 }
 
 
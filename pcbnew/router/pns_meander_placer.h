@@ -102,6 +102,7 @@ protected:
 
     void setWorld( NODE* aWorld );
 
+    ///> length of the tuned path before tuning, pad to die length included
     virtual long long int origPathLength() const;
 
     ///> current routing start point (end of tail, beginning of head)
@@ -118,6 +119,10 @@ protected:
     MEANDERED_LINE   m_result;
     SEGMENT*         m_initialSegment;
 
+    ///> length of m_tunedPath, measured once in Start(): the path does not change during
+    ///> the tuning session, only the meandered section of the line does
+    long long int m_tunedPathLength;
+
     long long int m_lastLength;
     TUNING_STATUS m_lastStatus;
 };
@@ -105,13 +105,9 @@ bool MEANDER_SKEW_PLACER::Start( const VECTOR2I& aP, ITEM* aStartItem )
         m_coupledLength = itemsetLength( m_tunedPathP );
     }
 
-    return true;
-}
-
+    m_tunedPathLength = itemsetLength( m_tunedPath );
 
-long long int MEANDER_SKEW_PLACER::origPathLength() const
-{
-    return itemsetLength ( m_tunedPath );
+    return true;
 }
 
 
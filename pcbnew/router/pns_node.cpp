@@ -19,10 +19,13 @@
  * with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <atomic>
 #include <vector>
 #include <cassert>
 #include <utility>
 
+#include <boost/functional/hash.hpp>
+
 #include <math/vector2d.h>
 
 #include <geometry/seg.h>
@@ -44,6 +47,9 @@ namespace PNS {
 static std::unordered_set<NODE*> allocNodes;
 #endif
 
+// The walkaround queries the world from two threads
+static std::atomic<int64_t> collisionQueries( 0 );
+
 NODE::NODE()
 {
     wxLogTrace( "PNS", "NODE::create %p", this );
@@ -53,6 +59,9 @@ NODE::NODE()
     m_maxClearance = 800000;    // fixme: depends on how thick traces are.
     m_ruleResolver = NULL;
     m_index = new INDEX;
+    m_revision = 0;
+    m_clearRevision = 0;
+    m_clearRootRevision = 0;
 
 #ifdef DEBUG
     allocNodes.insert( this );
@@ -118,7 +127,8 @@ NODE* NODE::Branch()
     child->m_maxClearance = m_maxClearance;
 
     // Immmediate offspring of the root branch needs not copy anything. For the rest, deep-copy
-    // joints, overridden item maps and pointers to stored items.
+    // joints and pointers to stored items. The overridden item set is shared until one of
+    // the nodes modifies it.
     if( !isRoot() )
     {
         JOINT_MAP::iterator j;
@@ -131,7 +141,8 @@ NODE* NODE::Branch()
     }
 
     wxLogTrace( "PNS", "%d items, %d joints, %d overrides",
-            child->m_index->Size(), (int) child->m_joints.size(), (int) child->m_override.size() );
+            child->m_index->Size(), (int) child->m_joints.size(),
+            child->m_override ? (int) child->m_override->size() : 0 );
 
     return child;
 }
@@ -259,8 +270,15 @@ struct NODE::DEFAULT_OBSTACLE_VISITOR : public OBSTACLE_VISITOR
 };
 
 
+int64_t NODE::CollisionQueryCount()
+{
+    return collisionQueries.load( std::memory_order_relaxed );
+}
+
+
 int NODE::QueryColliding( const ITEM* aItem, OBSTACLE_VISITOR& aVisitor )
 {
+    collisionQueries.fetch_add( 1, std::memory_order_relaxed );
     aVisitor.SetWorld( this, NULL );
     m_index->Query( aItem, m_maxClearance, aVisitor );
 
@@ -280,6 +298,8 @@ int NODE::QueryColliding( const ITEM* aItem, NODE::OBSTACLES& aObstacles, int aK
 {
     DEFAULT_OBSTACLE_VISITOR visitor( aObstacles, aItem, aKindMask, aDifferentNetsOnly );
 
+    collisionQueries.fetch_add( 1, std::memory_order_relaxed );
+
 #ifdef DEBUG
     assert( allocNodes.find( this ) != allocNodes.end() );
 #endif
@@ -460,6 +480,60 @@ NODE::OPT_OBSTACLE NODE::CheckColliding( const ITEM* aItemA, int aKindMask )
 }
 
 
+size_t NODE::CLEAR_SEGMENT_HASH::operator()( const CLEAR_SEGMENT& aSeg ) const
+{
+    size_t hash = 0;
+
+    for( int v : { aSeg.m_a.x, aSeg.m_a.y, aSeg.m_b.x, aSeg.m_b.y, aSeg.m_width, aSeg.m_net,
+                   aSeg.m_layerStart, aSeg.m_layerEnd, aSeg.m_kindMask } )
+    {
+        boost::hash_combine( hash, v );
+    }
+
+    return hash;
+}
+
+
+bool NODE::IsLineColliding( const LINE* aLine, int aKindMask )
+{
+    // Bound the memory taken by a long session on an unchanged world
+    static const size_t MaxClearSegments = 65536;
+
+    if( m_clearRevision != m_revision || m_clearRootRevision != m_root->m_revision
+            || m_clearSegments.size() > MaxClearSegments )
+    {
+        m_clearSegments.clear();
+        m_clearRevision = m_revision;
+        m_clearRootRevision = m_root->m_revision;
+    }
+
+    OBSTACLES               obs;
+    const SHAPE_LINE_CHAIN& l = aLine->CLine();
+
+    for( int i = 0; i < l.SegmentCount(); i++ )
+    {
+        const SEG     seg = l.CSegment( i );
+        CLEAR_SEGMENT key = { seg.A, seg.B, aLine->Width(), aLine->Net(),
+                              aLine->Layers().Start(), aLine->Layers().End(), aKindMask };
+
+        if( m_clearSegments.count( key ) )
+            continue;
+
+        const SEGMENT s( *aLine, seg );
+
+        if( QueryColliding( &s, obs, aKindMask, 1 ) )
+            return true;
+
+        m_clearSegments.insert( key );
+    }
+
+    if( aLine->EndsWithVia() )
+        return QueryColliding( &aLine->Via(), obs, aKindMask, 1 ) > 0;
+
+    return false;
+}
+
+
 bool NODE::CheckColliding( const ITEM* aItemA, const ITEM* aItemB, int aKindMask, int aForceClearance )
 {
     assert( aItemB );
@@ -542,6 +616,7 @@ void NODE::addSolid( SOLID* aSolid )
         linkJoint( aSolid->Pos(), aSolid->Layers(), aSolid->Net(), aSolid );
 
     m_index->Add( aSolid );
+    m_revision++;
 }
 
 void NODE::Add( std::unique_ptr< SOLID > aSolid )
@@ -554,6 +629,7 @@ void NODE::addVia( VIA* aVia )
 {
     linkJoint( aVia->Pos(), aVia->Layers(), aVia->Net(), aVia );
     m_index->Add( aVia );
+    m_revision++;
 }
 
 void NODE::Add( std::unique_ptr< VIA > aVia )
@@ -615,6 +691,7 @@ void NODE::addSegment( SEGMENT* aSeg )
     linkJoint( aSeg->Seg().B, aSeg->Layers(), aSeg->Net(), aSeg );
 
     m_index->Add( aSeg );
+    m_revision++;
 }
 
 bool NODE::Add( std::unique_ptr< SEGMENT > aSegment, bool aAllowRedundant )
@@ -640,6 +717,7 @@ void NODE::addArc( ARC* aArc )
     linkJoint( aArc->Anchor( 1 ), aArc->Layers(), aArc->Net(), aArc );
 
     m_index->Add( aArc );
+    m_revision++;
 }
 
 void NODE::Add( std::unique_ptr< ARC > aArc )
@@ -668,17 +746,32 @@ void NODE::Add( std::unique_ptr< ITEM > aItem, bool aAllowRedundant )
 }
 
 
+void NODE::overrideItem( ITEM* aItem )
+{
+    if( !m_override )
+        m_override = std::make_shared<OVERRIDE_SET>();
+    else if( m_override.use_count() > 1 )
+        m_override = std::make_shared<OVERRIDE_SET>( *m_override );
+
+    m_override->insert( aItem );
+    m_revision++;
+}
+
+
 void NODE::doRemove( ITEM* aItem )
 {
     // case 1: removing an item that is stored in the root node from any branch:
     // mark it as overridden, but do not remove
     if( aItem->BelongsTo( m_root ) && !isRoot() )
-        m_override.insert( aItem );
+        overrideItem( aItem );
 
     // case 2: the item belongs to this branch or a parent, non-root branch,
     // or the root itself and we are the root: remove from the index
     else if( !aItem->BelongsTo( m_root ) || isRoot() )
+    {
         m_index->Remove( aItem );
+        m_revision++;
+    }
 
     // the item belongs to this particular branch: un-reference it
     if( aItem->BelongsTo( this ) )
@@ -1224,15 +1317,12 @@ void NODE::GetUpdatedItems( ITEM_VECTOR& aRemoved, ITEM_VECTOR& aAdded )
     if( isRoot() )
         return;
 
-    if( m_override.size() )
-        aRemoved.reserve( m_override.size() );
-    
+    if( m_override )
+        aRemoved.insert( aRemoved.end(), m_override->begin(), m_override->end() );
+
     if( m_index->Size() )
         aAdded.reserve( m_index->Size() );
 
-    for( ITEM* item : m_override )
-        aRemoved.push_back( item );
-
     for( INDEX::ITEM_SET::iterator i = m_index->begin(); i != m_index->end(); ++i )
         aAdded.push_back( *i );
 }
@@ -1270,8 +1360,11 @@ void NODE::Commit( NODE* aNode )
         if( aNode->isRoot() )
             return;
 
-        for( ITEM* item : aNode->m_override )
-            Remove( item );
+        if( aNode->m_override )
+        {
+            for( ITEM* item : *aNode->m_override )
+                Remove( item );
+        }
 
         for( auto i : *aNode->m_index )
         {
@@ -1337,6 +1430,25 @@ void NODE::RemoveByMarker( int aMarker )
         Remove( item );
 }
 
+
+void NODE::RemoveIf( const std::function<bool( const ITEM* )>& aFilter )
+{
+    assert( isRoot() && m_children.empty() );
+
+    std::vector<ITEM*> garbage;
+
+    for( ITEM* item : *m_index )
+    {
+        if( aFilter( item ) )
+            garbage.push_back( item );
+    }
+
+    for( ITEM* item : garbage )
+        Remove( item );
+
+    releaseGarbage();
+}
+
 SEGMENT* NODE::findRedundantSegment( const VECTOR2I& A, const VECTOR2I& B, const LAYER_RANGE& lr,
                                      int aNet )
 {
@@ -22,8 +22,10 @@
 #ifndef __PNS_NODE_H
 #define __PNS_NODE_H
 
+#include <functional>
 #include <vector>
 #include <list>
+#include <memory>
 #include <unordered_set>
 #include <unordered_map>
 
@@ -165,12 +167,14 @@ public:
     void SetMaxClearance( int aClearance )
     {
         m_maxClearance = aClearance;
+        m_revision++;
     }
 
     ///> Assigns a clerance resolution function object
     void SetRuleResolver( RULE_RESOLVER* aFunc )
     {
         m_ruleResolver = aFunc;
+        m_revision++;
     }
 
     RULE_RESOLVER* GetRuleResolver() const
@@ -213,6 +217,18 @@ public:
                          OBSTACLE_VISITOR& aVisitor
                       );
 
+    ///> total number of QueryColliding() calls on all the nodes, for the router event log
+    static int64_t CollisionQueryCount();
+
+    /**
+     * Function IsLineColliding()
+     *
+     * Tells if a line collides with anything in the node, as CheckColliding() does.  The
+     * segments found clear are remembered until the node or its root change: the optimizer
+     * tests the same segments of the head again on each mouse move.  Not thread safe.
+     */
+    bool IsLineColliding( const LINE* aLine, int aKindMask = ITEM::ANY_T );
+
     /**
      * Function NearestObstacle()
      *
@@ -416,6 +432,10 @@ public:
 
     void RemoveByMarker( int aMarker );
 
+    ///> Removes (and frees) the items for which aFilter returns true.  Applicable only to the
+    ///> root node, without children.
+    void RemoveIf( const std::function<bool( const ITEM* )>& aFilter );
+
     const ITEM_SET FindItemsByParent( const BOARD_CONNECTED_ITEM* aParent );
     ITEM* FindItemByParent( const BOARD_CONNECTED_ITEM* aParent );
 
@@ -433,7 +453,7 @@ public:
     ///> from the root branch.
     bool Overrides( ITEM* aItem ) const
     {
-        return m_override.find( aItem ) != m_override.end();
+        return m_override && m_override->find( aItem ) != m_override->end();
     }
 
 private:
@@ -487,6 +507,9 @@ private:
                                    const LAYER_RANGE & lr, int aNet );
     ARC* findRedundantArc( ARC* aSeg );
 
+    ///> marks a root item as overridden, un-sharing the override set first if needed
+    void overrideItem( ITEM* aItem );
+
     ///> scans the joint map, forming a line starting from segment (current).
     void followLine( LINKED_ITEM* aCurrent, int aScanDirection, int& aPos, int aLimit, VECTOR2I* aCorners,
             LINKED_ITEM** aSegments, bool& aGuardHit, bool aStopAtLockedJoints );
@@ -504,8 +527,12 @@ private:
     ///> list of nodes branched from this one
     std::set<NODE*> m_children;
 
-    ///> hash of root's items that have been changed in this node
-    std::unordered_set<ITEM*> m_override;
+    typedef std::unordered_set<ITEM*> OVERRIDE_SET;
+
+    ///> hash of root's items that have been changed in this node and its parents.  It is
+    ///> shared with the parent on Branch() and copied on the first write only, as most
+    ///> branches of the shove loop override a few items, if any.
+    std::shared_ptr<OVERRIDE_SET> m_override;
 
     ///> worst case item-item clearance
     int m_maxClearance;
@@ -519,6 +546,37 @@ private:
     ///> depth of the node (number of parent nodes in the inheritance chain)
     int m_depth;
 
+    ///> a segment of a line, as tested by IsLineColliding()
+    struct CLEAR_SEGMENT
+    {
+        VECTOR2I m_a, m_b;
+        int      m_width;
+        int      m_net;
+        int      m_layerStart, m_layerEnd;
+        int      m_kindMask;
+
+        bool operator==( const CLEAR_SEGMENT& aOther ) const
+        {
+            return m_a == aOther.m_a && m_b == aOther.m_b && m_width == aOther.m_width
+                   && m_net == aOther.m_net && m_layerStart == aOther.m_layerStart
+                   && m_layerEnd == aOther.m_layerEnd && m_kindMask == aOther.m_kindMask;
+        }
+    };
+
+    struct CLEAR_SEGMENT_HASH
+    {
+        size_t operator()( const CLEAR_SEGMENT& aSeg ) const;
+    };
+
+    ///> number of changes made to the items or rules of this node
+    int m_revision;
+
+    ///> segments known to be clear of the items of the node at m_clearRevision and of the
+    ///> root at m_clearRootRevision
+    std::unordered_set<CLEAR_SEGMENT, CLEAR_SEGMENT_HASH> m_clearSegments;
+    int m_clearRevision;
+    int m_clearRootRevision;
+
     std::unordered_set<ITEM*> m_garbageItems;
 };
 
@@ -432,6 +432,10 @@ bool OPTIMIZER::checkColliding( ITEM* aItem, bool aUpdateCache )
 {
     CACHE_VISITOR v( aItem, m_world, m_collisionKindMask );
 
+    // The bypasses are mostly made of segments tested on the previous mouse moves already
+    if( aItem->Kind() == ITEM::LINE_T )
+        return m_world->IsLineColliding( static_cast<LINE*>( aItem ) );
+
     return static_cast<bool>( m_world->CheckColliding( aItem ) );
 }
 
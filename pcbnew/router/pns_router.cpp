@@ -34,6 +34,8 @@
 
 #include <pcb_painter.h>
 #include <pcbnew_settings.h>
+#include <profile.h>
+#include <class_board_connected_item.h>
 
 #include <geometry/shape.h>
 #include <geometry/shape_line_chain.h>
@@ -77,6 +79,7 @@ ROUTER::ROUTER()
     m_snapshotIter = 0;
     m_violation = false;
     m_iface = nullptr;
+    m_shoveIterations = 0;
 }
 
 
@@ -86,15 +89,66 @@ ROUTER* ROUTER::GetInstance()
 }
 
 
+/**
+ * Times a router event, and adds it to the event log of the router when going out of scope.
+ */
+class EVENT_PROBE
+{
+public:
+    EVENT_PROBE( ROUTER* aRouter, LOGGER::EVENT_TYPE aType, const VECTOR2I& aP,
+                 const ITEM* aItem, int aParam = 0 ) :
+            m_router( aRouter ),
+            m_collisionQueries( NODE::CollisionQueryCount() ),
+            m_shoveIterations( aRouter->ShoveIterationCount() )
+    {
+        m_event.type = aType;
+        m_event.p = aP;
+        m_event.uuid = ( aItem && aItem->Parent() ) ? aItem->Parent()->m_Uuid : niluuid;
+        m_event.param = aParam;
+    }
+
+    ~EVENT_PROBE()
+    {
+        m_event.durationUs = (int) m_counter.SinceStart<std::chrono::microseconds>().count();
+        m_event.collisionQueries = (int) ( NODE::CollisionQueryCount() - m_collisionQueries );
+        m_event.shoveIterations = m_router->ShoveIterationCount() - m_shoveIterations;
+
+        m_router->Logger()->Log( m_event );
+    }
+
+private:
+    ROUTER*              m_router;
+    LOGGER::EVENT_ENTRY  m_event;
+    PROF_COUNTER         m_counter;
+    int64_t              m_collisionQueries;
+    int                  m_shoveIterations;
+};
+
+
 ROUTER::~ROUTER()
 {
     ClearWorld();
-    theRouter = nullptr;
+
+    if( theRouter == this )
+        theRouter = nullptr;
 }
 
 
 void ROUTER::SyncWorld()
 {
+    // The tools keep their routers between runs: the last one synced is the one in use
+    theRouter = this;
+
+    // Bring the existing world up to date if the interface can, instead of rebuilding it
+    if( m_world )
+    {
+        m_world->KillChildren();
+        m_placer.reset();
+
+        if( m_iface->UpdateWorld( m_world.get() ) )
+            return;
+    }
+
     ClearWorld();
 
     m_world = std::make_unique<NODE>( );
@@ -139,6 +193,10 @@ bool ROUTER::StartDragging( const VECTOR2I& aP, ITEM_SET aStartItems, int aDragM
     if( aStartItems.Empty() )
         return false;
 
+    m_logger.Clear();
+    EVENT_PROBE probe( this, LOGGER::EVT_START_DRAG, aP, aStartItems[0],
+                       aDragMode );
+
     if( aStartItems.Count( ITEM::SOLID_T ) == aStartItems.Size() )
     {
         m_dragger = std::make_unique<COMPONENT_DRAGGER>( this );
@@ -189,7 +247,9 @@ bool ROUTER::isStartingPointRoutable( const VECTOR2I& aWhere, int aLayer )
 }
 
 bool ROUTER::StartRouting( const VECTOR2I& aP, ITEM* aStartItem, int aLayer )
-{   
+{
+    m_logger.Clear();
+    EVENT_PROBE probe( this, LOGGER::EVT_START_ROUTE, aP, aStartItem, aLayer );
 
     if( ! isStartingPointRoutable( aP, aLayer ) )
     {
@@ -245,6 +305,8 @@ void ROUTER::DisplayItems( const ITEM_SET& aItems )
 
 void ROUTER::Move( const VECTOR2I& aP, ITEM* endItem )
 {
+    EVENT_PROBE probe( this, LOGGER::EVT_MOVE, aP, endItem );
+
     m_currentEnd = aP;
 
     switch( m_state )
@@ -390,6 +452,7 @@ void ROUTER::CommitRouting( NODE* aNode )
 
 bool ROUTER::FixRoute( const VECTOR2I& aP, ITEM* aEndItem, bool aForceFinish )
 {
+    EVENT_PROBE probe( this, LOGGER::EVT_FIX, aP, aEndItem, aForceFinish ? 1 : 0 );
     bool rv = false;
 
     switch( m_state )
@@ -445,6 +508,8 @@ void ROUTER::StopRouting()
     if( !RoutingInProgress() )
         return;
 
+    m_logger.Log( { LOGGER::EVT_ABORT, m_currentEnd, niluuid, 0, 0, 0, 0 } );
+
     m_placer.reset();
     m_dragger.reset();
 
@@ -525,6 +590,8 @@ void ROUTER::DumpLog()
 
     if( logger )
         logger->Save( "/tmp/shove.log" );
+
+    m_logger.Save( "/tmp/pns_events.log" );
 }
 
 
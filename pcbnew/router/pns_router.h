@@ -35,6 +35,7 @@
 #include "pns_sizes_settings.h"
 #include "pns_item.h"
 #include "pns_itemset.h"
+#include "pns_logger.h"
 #include "pns_node.h"
 
 namespace KIGFX
@@ -96,6 +97,7 @@ enum DRAG_MODE
 
         virtual void SetRouter( ROUTER* aRouter ) = 0;
         virtual void SyncWorld( NODE* aNode ) = 0;
+        virtual bool UpdateWorld( NODE* aNode ) = 0;
         virtual void AddItem( ITEM* aItem ) = 0;
         virtual void RemoveItem( ITEM* aItem ) = 0;
         virtual bool IsAnyLayerVisible( const LAYER_RANGE& aLayer ) = 0;
@@ -171,6 +173,23 @@ public:
 
     void DumpLog();
 
+    ///> the events of the current routing or dragging session, with their timings
+    LOGGER* Logger()
+    {
+        return &m_logger;
+    }
+
+    ///> adds to the shove iterations of the event being processed, for the event log
+    void CountShoveIterations( int aCount )
+    {
+        m_shoveIterations += aCount;
+    }
+
+    int ShoveIterationCount() const
+    {
+        return m_shoveIterations;
+    }
+
     RULE_RESOLVER* GetRuleResolver() const
     {
         return m_iface->GetRuleResolver();
@@ -283,6 +302,9 @@ private:
 
     wxString m_toolStatusbarName;
     wxString m_failureReason;
+
+    LOGGER m_logger;
+    int m_shoveIterations;
 };
 
 }
@@ -1223,6 +1223,8 @@ SHOVE::SHOVE_STATUS SHOVE::shoveMainLoop()
         }
     }
 
+    Router()->CountShoveIterations( m_iter );
+
     return st;
 }
 
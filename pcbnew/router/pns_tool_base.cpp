@@ -78,6 +78,7 @@ TOOL_BASE::TOOL_BASE( const std::string& aToolName ) :
     m_gridHelper = nullptr;
 
     m_cancelled = false;
+    m_worldOutdated = false;
 }
 
 
@@ -91,19 +92,36 @@ TOOL_BASE::~TOOL_BASE()
 
 void TOOL_BASE::Reset( RESET_REASON aReason )
 {
+    // The router and its world are kept between the runs of the tool, and only brought up to
+    // date with the board changes.  A new board or view needs a new router, made on the next
+    // run (the previous board may already be gone).
+    if( aReason != RUN )
+    {
+        m_worldOutdated = true;
+        return;
+    }
+
     delete m_gridHelper;
-    delete m_iface;
-    delete m_router;
 
-    m_iface = new PNS_KICAD_IFACE;
-    m_iface->SetBoard( board() );
-    m_iface->SetView( getView() );
+    if( !m_router || m_worldOutdated )
+    {
+        delete m_iface;
+        delete m_router;
+
+        m_iface = new PNS_KICAD_IFACE;
+        m_iface->SetBoard( board() );
+        m_iface->SetView( getView() );
+
+        m_router = new ROUTER;
+        m_router->SetInterface( m_iface );
+        m_router->ClearWorld();
+
+        m_worldOutdated = false;
+    }
+
     m_iface->SetHostTool( this );
     m_iface->SetDisplayOptions( &( frame()->GetDisplayOptions() ) );
 
-    m_router = new ROUTER;
-    m_router->SetInterface( m_iface );
-    m_router->ClearWorld();
     m_router->SyncWorld();
 
     m_router->UpdateSizes( m_savedSizes );
@@ -243,7 +261,7 @@ void TOOL_BASE::highlightNet( bool aEnabled, int aNetcode )
         m_startHighlight = false;
     }
 
-    getView()->UpdateAllLayersColor();
+    view()->UpdateHighlightColors();
 }
 
 bool TOOL_BASE::checkSnap( ITEM *aItem )
@@ -385,6 +403,41 @@ void TOOL_BASE::deleteTraces( ITEM* aStartItem, bool aWholeTrack )
 }
 
 
+void TOOL_BASE::MarkWorldDirty( const std::vector<BOARD_ITEM*>& aChanged,
+                                const std::vector<BOARD_ITEM*>& aRemoved )
+{
+    if( !m_iface )
+        return;
+
+    for( BOARD_ITEM* item : aRemoved )
+        m_iface->MarkItemRemoved( item );
+
+    for( BOARD_ITEM* item : aChanged )
+        m_iface->MarkItemChanged( item );
+}
+
+
+void TOOL_BASE::InvalidateWorld()
+{
+    if( m_router && !m_router->RoutingInProgress() )
+        m_router->ClearWorld();
+}
+
+
+std::vector<TOOL_BASE*> TOOL_BASE::RouterTools( TOOL_MANAGER* aToolMgr )
+{
+    std::vector<TOOL_BASE*> tools;
+
+    for( const char* name : { "pcbnew.InteractiveRouter", "pcbnew.LengthTuner" } )
+    {
+        if( TOOL_BASE* tool = dynamic_cast<TOOL_BASE*>( aToolMgr->FindTool( name ) ) )
+            tools.push_back( tool );
+    }
+
+    return tools;
+}
+
+
 ROUTER *TOOL_BASE::Router() const
 {
     return m_router;
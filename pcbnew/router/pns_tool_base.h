@@ -24,6 +24,7 @@
 #define __PNS_TOOL_BASE_H
 
 #include <memory>
+#include <vector>
 #include <import_export.h>
 
 #include <math/vector2d.h>
@@ -51,6 +52,22 @@ public:
 
     ROUTER* Router() const;
 
+    /**
+     * Records the board items added or modified (aChanged) and removed (aRemoved) by a commit,
+     * for the next sync of the router world.
+     */
+    void MarkWorldDirty( const std::vector<BOARD_ITEM*>& aChanged,
+                         const std::vector<BOARD_ITEM*>& aRemoved );
+
+    /**
+     * Drops the router world, so it is synced again from the whole board (after changes made
+     * outside of a commit, e.g. undo).
+     */
+    void InvalidateWorld();
+
+    ///> The router tools registered to aToolMgr.  Each has its own router and world.
+    static std::vector<TOOL_BASE*> RouterTools( TOOL_MANAGER* aToolMgr );
+
 protected:
     bool checkSnap( ITEM* aItem );
     const VECTOR2I snapToItem( bool aEnabled, ITEM* aItem, VECTOR2I aP);
@@ -77,6 +94,7 @@ protected:
     ROUTER* m_router;
 
     bool m_cancelled;
+    bool m_worldOutdated;                 ///< The board or view changed since the router was made
 };
 
 }
@@ -20,6 +20,7 @@
  */
 
 #include <core/optional.h>
+#include <thread_pool.h>
 
 #include <geometry/shape_line_chain.h>
 
@@ -52,11 +53,13 @@ NODE::OPT_OBSTACLE WALKAROUND::nearestObstacle( const LINE& aPath )
 }
 
 
-WALKAROUND::WALKAROUND_STATUS WALKAROUND::singleStep( LINE& aPath,
-                                                              bool aWindingDirection )
+WALKAROUND::WALKAROUND_STATUS WALKAROUND::singleStep( LINE& aPath, bool aWindingDirection,
+                                                      int aIteration, bool aDebug )
 {
     OPT<OBSTACLE>& current_obs =
         aWindingDirection ? m_currentObstacle[0] : m_currentObstacle[1];
+    int& blockageCount =
+        aWindingDirection ? m_recursiveBlockageCount[0] : m_recursiveBlockageCount[1];
 
     if( !current_obs )
         return DONE;
@@ -67,9 +70,9 @@ WALKAROUND::WALKAROUND_STATUS WALKAROUND::singleStep( LINE& aPath,
 
     if( ( current_obs->m_hull ).PointInside( last ) || ( current_obs->m_hull ).PointOnEdge( last ) )
     {
-        m_recursiveBlockageCount++;
+        blockageCount++;
 
-        if( m_recursiveBlockageCount < 3 )
+        if( blockageCount < 3 )
             aPath.Line().Append( current_obs->m_hull.NearestPoint( last ) );
         else
         {
@@ -88,9 +91,9 @@ WALKAROUND::WALKAROUND_STATUS WALKAROUND::singleStep( LINE& aPath,
         return STUCK;
     auto l =aPath.CLine();
 #ifdef DEBUG
-    if( m_logger )
+    if( aDebug && m_logger )
     {
-        m_logger->NewGroup( aWindingDirection ? "walk-cw" : "walk-ccw", m_iteration );
+        m_logger->NewGroup( aWindingDirection ? "walk-cw" : "walk-ccw", aIteration );
         m_logger->Log( &path_walk[0], 0, "path_walk" );
         m_logger->Log( &path_pre[0], 1, "path_pre" );
         m_logger->Log( &path_post[0], 4, "path_post" );
@@ -99,12 +102,12 @@ WALKAROUND::WALKAROUND_STATUS WALKAROUND::singleStep( LINE& aPath,
     }
 #endif
 
-    if ( Dbg() )
+    if ( aDebug && Dbg() )
     {
         char name[128];
-        snprintf(name, sizeof(name), "hull-%s-%d", aWindingDirection ? "cw" : "ccw", m_iteration );
+        snprintf(name, sizeof(name), "hull-%s-%d", aWindingDirection ? "cw" : "ccw", aIteration );
         Dbg()->AddLine( current_obs->m_hull, 0, 1, name);
-        snprintf(name, sizeof(name), "path-%s-%d", aWindingDirection ? "cw" : "ccw", m_iteration );
+        snprintf(name, sizeof(name), "path-%s-%d", aWindingDirection ? "cw" : "ccw", aIteration );
         Dbg()->AddLine( aPath.CLine(), 1, 1, name );
     }
 
@@ -153,7 +156,7 @@ WALKAROUND::WALKAROUND_STATUS WALKAROUND::singleStep( LINE& aPath,
 
 
 
-bool clipToLoopStart( SHAPE_LINE_CHAIN& l )
+bool clipToLoopStart( SHAPE_LINE_CHAIN& l, DEBUG_DECORATOR* aDbg )
 {
     auto ip = l.SelfIntersecting();
 
@@ -166,8 +169,8 @@ bool clipToLoopStart( SHAPE_LINE_CHAIN& l )
 
         int pidx2 = tail.Split( ip->p );
         
-        auto dbg = ROUTER::GetInstance()->GetInterface()->GetDebugDecorator();
-        dbg->AddPoint( ip->p, 5 );
+        if( aDbg )
+            aDbg->AddPoint( ip->p, 5 );
         
         l = lead;
         l.Append( tail.Slice( 0, pidx2 ) );
@@ -180,6 +183,28 @@ bool clipToLoopStart( SHAPE_LINE_CHAIN& l )
 
 
 
+void WALKAROUND::walkDirection( LINE& aPath, bool aWindingDirection,
+                                WALKAROUND_STATUS& aStatus, bool aDebug )
+{
+    DEBUG_DECORATOR* dbg = nullptr;
+
+    if( aDebug )
+        dbg = ROUTER::GetInstance()->GetInterface()->GetDebugDecorator();
+
+    for( int iteration = 0; iteration < m_iterationLimit; iteration++ )
+    {
+        if( aStatus != STUCK )
+            aStatus = singleStep( aPath, aWindingDirection, iteration, aDebug );
+
+        if( clipToLoopStart( aPath.Line(), dbg ) )
+            aStatus = ALMOST_DONE;
+
+        if( aStatus != IN_PROGRESS )
+            break;
+    }
+}
+
+
 const WALKAROUND::RESULT WALKAROUND::Route( const LINE& aInitialPath )
 {
     LINE path_cw( aInitialPath ), path_ccw( aInitialPath );
@@ -199,10 +224,7 @@ const WALKAROUND::RESULT WALKAROUND::Route( const LINE& aInitialPath )
     start( aInitialPath );
 
     m_currentObstacle[0] = m_currentObstacle[1] = nearestObstacle( aInitialPath );
-    m_recursiveBlockageCount = 0;
-
-    result.lineCw = aInitialPath;
-    result.lineCcw = aInitialPath;
+    m_recursiveBlockageCount[0] = m_recursiveBlockageCount[1] = 0;
 
     if( m_forceWinding )
     {
@@ -213,64 +235,38 @@ const WALKAROUND::RESULT WALKAROUND::Route( const LINE& aInitialPath )
         m_forceSingleDirection = false;
     }
 
-    while( m_iteration < m_iterationLimit )
+    // The two directions only share the (read-only) world: walk the counter-clockwise one
+    // in a task of the thread pool.  The debug output is not thread safe, it shows the
+    // clockwise walk only.
+    if( s_cw == IN_PROGRESS && s_ccw == IN_PROGRESS
+            && THREAD_POOL::GetInstance().GetThreadCount() > 1 )
     {
-        if( s_cw != STUCK )
-            s_cw = singleStep( path_cw, true );
-
-        if( s_ccw != STUCK )
-            s_ccw = singleStep( path_ccw, false );
-
-        //Dbg()->AddLine( path_cw.CLine(), 2, 10000 );
-
-
-        //printf("iter %d s_cw %d s_ccw %d\n", m_iteration, s_cw, s_ccw );
-        
-        auto old = path_cw.CLine();
-
-        if( clipToLoopStart( path_cw.Line() ))
-        {
-            //printf("ClipCW\n");
-            //Dbg()->AddLine( old, 1, 40000 );
-            s_cw = ALMOST_DONE;
-        }
-
-        if( clipToLoopStart( path_ccw.Line() ))
-        {
-            //printf("ClipCCW\n");
-            s_ccw = ALMOST_DONE;
-        }
+        TASK_GROUP ccw;
 
-        
-        if( s_cw != IN_PROGRESS )
-        {
-            result.lineCw = path_cw;
-            result.statusCw = s_cw;
-        }
-
-        if( s_ccw != IN_PROGRESS )
-        {
-            result.lineCcw = path_ccw;
-            result.statusCcw = s_ccw;
-        }
+        ccw.Run( [&]()
+                 {
+                     walkDirection( path_ccw, false, s_ccw, false );
+                 } );
 
-        if( s_cw != IN_PROGRESS && s_ccw != IN_PROGRESS )
-            break;
-
-        m_iteration++;
+        walkDirection( path_cw, true, s_cw, true );
+        ccw.Wait();
+    }
+    else
+    {
+        walkDirection( path_cw, true, s_cw, true );
+        walkDirection( path_ccw, false, s_ccw, true );
     }
 
+    result.lineCw = path_cw;
+    result.statusCw = s_cw;
+    result.lineCcw = path_ccw;
+    result.statusCcw = s_ccw;
+
     if( s_cw == IN_PROGRESS )
-    {
-        result.lineCw = path_cw;
         result.statusCw = ALMOST_DONE;
-    }
 
     if( s_ccw == IN_PROGRESS )
-    {
-        result.lineCcw = path_ccw;
         result.statusCcw = ALMOST_DONE;
-    }
 
     result.lineCw.Line().Simplify();
     result.lineCcw.Line().Simplify();
@@ -320,7 +316,7 @@ WALKAROUND::WALKAROUND_STATUS WALKAROUND::Route( const LINE& aInitialPath,
     start( aInitialPath );
 
     m_currentObstacle[0] = m_currentObstacle[1] = nearestObstacle( aInitialPath );
-    m_recursiveBlockageCount = 0;
+    m_recursiveBlockageCount[0] = m_recursiveBlockageCount[1] = 0;
 
     aWalkPath = aInitialPath;
 
@@ -336,10 +332,10 @@ WALKAROUND::WALKAROUND_STATUS WALKAROUND::Route( const LINE& aInitialPath,
     while( m_iteration < m_iterationLimit )
     {
         if( s_cw != STUCK )
-            s_cw = singleStep( path_cw, true );
+            s_cw = singleStep( path_cw, true, m_iteration );
 
         if( s_ccw != STUCK )
-            s_ccw = singleStep( path_ccw, false );
+            s_ccw = singleStep( path_ccw, false, m_iteration );
 
         if( ( s_cw == DONE && s_ccw == DONE ) || ( s_cw == STUCK && s_ccw == STUCK ) )
         {
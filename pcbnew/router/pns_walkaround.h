@@ -49,7 +49,7 @@ public:
         m_itemMask = ITEM::ANY_T;
 
         // Initialize other members, to avoid uninitialized variables.
-        m_recursiveBlockageCount = 0;
+        m_recursiveBlockageCount[0] = m_recursiveBlockageCount[1] = 0;
         m_recursiveCollision[0] = m_recursiveCollision[1] = false;
         m_iteration = 0;
         m_forceCw = false;
@@ -142,12 +142,18 @@ public:
 private:
     void start( const LINE& aInitialPath );
 
-    WALKAROUND_STATUS singleStep( LINE& aPath, bool aWindingDirection );
+    WALKAROUND_STATUS singleStep( LINE& aPath, bool aWindingDirection, int aIteration,
+                                  bool aDebug = true );
+
+    ///> walks around the obstacles in one direction, until done or out of iterations.
+    ///> Only reads the world, so both directions can be walked at the same time.
+    void walkDirection( LINE& aPath, bool aWindingDirection, WALKAROUND_STATUS& aStatus,
+                        bool aDebug );
     NODE::OPT_OBSTACLE nearestObstacle( const LINE& aPath );
 
     NODE* m_world;
 
-    int m_recursiveBlockageCount;
+    int m_recursiveBlockageCount[2];
     int m_iteration;
     int m_iterationLimit;
     int m_itemMask;
@@ -37,6 +37,7 @@
 #include <pcbnew.h>
 
 #include <memory>
+#include <unordered_map>
 
 // all outside the DSN namespace:
 class BOARD;
@@ -1794,12 +1795,17 @@ class PLACEMENT : public ELEM
 
     COMPONENTS  components;
 
+    /// the components by image name, of components[0..indexedComponents)
+    std::unordered_map<std::string, COMPONENT*> componentIndex;
+    unsigned    indexedComponents;
+
 public:
     PLACEMENT( ELEM* aParent ) :
         ELEM( T_placement, aParent )
     {
         unit = 0;
         flip_style = DSN_T( T_NONE );
+        indexedComponents = 0;
     }
 
     ~PLACEMENT()
@@ -1816,12 +1822,18 @@ public:
      */
     COMPONENT* LookupCOMPONENT( const std::string& imageName )
     {
-        for( unsigned i=0; i<components.size();  ++i )
+        // The parser adds components directly: index the ones added since the last lookup
+        for( ; indexedComponents < components.size(); ++indexedComponents )
         {
-            if( 0 == components[i].GetImageId().compare( imageName ) )
-                return &components[i];
+            COMPONENT* comp = &components[indexedComponents];
+            componentIndex.emplace( comp->GetImageId(), comp );
         }
 
+        auto found = componentIndex.find( imageName );
+
+        if( found != componentIndex.end() )
+            return found->second;
+
         COMPONENT* added = new COMPONENT(this);
         components.push_back( added );
         added->SetImageId( imageName );
@@ -2238,12 +2250,45 @@ class LIBRARY : public ELEM
     PADSTACKS       padstacks;      ///< all except vias, which are in 'vias'
     PADSTACKS       vias;
 
+    // The lookup indexes of images[0..indexedImages) and padstacks[0..indexedPadstacks).
+    // The parser adds images and padstacks directly, so they are indexed when looked up.
+    std::unordered_map<std::string, int>        imageIndex;     ///< first image by hash
+    std::unordered_map<std::string, int>        imageIdCount;   ///< no. images by image_id
+    std::unordered_map<std::string, PADSTACK*>  padstackIndex;  ///< first padstack by id
+    unsigned        indexedImages;
+    unsigned        indexedPadstacks;
+
+    void indexIMAGEs()
+    {
+        for( ; indexedImages < images.size(); ++indexedImages )
+        {
+            IMAGE* image = &images[indexedImages];
+
+            if( !image->hash.size() )
+                image->hash = image->makeHash();
+
+            imageIndex.emplace( image->hash, (int) indexedImages );
+            imageIdCount[image->image_id]++;
+        }
+    }
+
+    void indexPADSTACKs()
+    {
+        for( ; indexedPadstacks < padstacks.size(); ++indexedPadstacks )
+        {
+            PADSTACK* ps = &padstacks[indexedPadstacks];
+            padstackIndex.emplace( ps->GetPadstackId(), ps );
+        }
+    }
+
 public:
 
     LIBRARY( ELEM* aParent, DSN_T aType = T_library ) :
         ELEM( aType, aParent )
     {
         unit = 0;
+        indexedImages = 0;
+        indexedPadstacks = 0;
 //        via_start_index = -1;       // 0 or greater means there is at least one via
     }
     ~LIBRARY()
@@ -2276,21 +2321,22 @@ public:
      */
     int FindIMAGE( IMAGE* aImage )
     {
-        unsigned i;
-        for( i=0;  i<images.size();  ++i )
-        {
-            if( 0 == IMAGE::Compare( aImage, &images[i] ) )
-                return (int) i;
-        }
+        indexIMAGEs();
+
+        if( !aImage->hash.size() )
+            aImage->hash = aImage->makeHash();
+
+        auto found = imageIndex.find( aImage->hash );
+
+        if( found != imageIndex.end() )
+            return found->second;
 
         // There is no match to the IMAGE contents, but now generate a unique
         // name for it.
-        int dups = 1;
-        for( i=0;  i<images.size();  ++i )
-        {
-            if( 0 == aImage->image_id.compare( images[i].image_id ) )
-                aImage->duplicated = dups++;
-        }
+        auto dups = imageIdCount.find( aImage->image_id );
+
+        if( dups != imageIdCount.end() )
+            aImage->duplicated = dups->second;
 
         return -1;
     }
@@ -2387,12 +2433,13 @@ public:
      */
     PADSTACK* FindPADSTACK( const std::string& aPadstackId )
     {
-        for( unsigned i=0;  i<padstacks.size();  ++i )
-        {
-            PADSTACK* ps = &padstacks[i];
-            if( 0 == ps->GetPadstackId().compare( aPadstackId ) )
-                return ps;
-        }
+        indexPADSTACKs();
+
+        auto found = padstackIndex.find( aPadstackId );
+
+        if( found != padstackIndex.end() )
+            return found->second;
+
         return NULL;
     }
 
@@ -48,6 +48,8 @@
 #include <math/util.h>      // for KiROUND
 #include <pcbnew_settings.h>
 
+#include <unordered_map>
+
 using namespace DSN;
 
 
@@ -340,6 +342,12 @@ void SPECCTRA_DB::FromSESSION( BOARD* aBoard )
 
     if( session->placement )
     {
+        // The footprints by reference, the first one of a reference as FindModuleByReference()
+        std::unordered_map<wxString, MODULE*> modulesByRef;
+
+        for( MODULE* module : aBoard->Modules() )
+            modulesByRef.emplace( module->GetReference(), module );
+
         // Walk the PLACEMENT object's COMPONENTs list, and for each PLACE within
         // each COMPONENT, reposition and re-orient each component and put on
         // correct side of the board.
@@ -352,7 +360,8 @@ void SPECCTRA_DB::FromSESSION( BOARD* aBoard )
                 PLACE* place = &places[i];  // '&' even though places[] holds a pointer!
 
                 wxString reference = FROM_UTF8( place->component_id.c_str() );
-                MODULE* module = aBoard->FindModuleByReference( reference );
+                auto    found = modulesByRef.find( reference );
+                MODULE* module = found != modulesByRef.end() ? found->second : nullptr;
 
                 if( !module )
                 {
@@ -31,12 +31,21 @@
 #undef HAVE_CLOCK_GETTIME  // macro is defined in Python.h and causes redefine warning
 
 #include <action_plugin.h>
+#include <board_commit.h>
 #include <build_version.h>
 #include <class_board.h>
+#include <class_module.h>
+#include <class_pad.h>
+#include <class_track.h>
 #include <cstdlib>
+#include <cstring>
+#include <drc/drc.h>
+#include <drc/drc_report_sink.h>
+#include <exporters/board_export_jobs.h>
 #include <io_mgr.h>
 #include <kicad_string.h>
 #include <macros.h>
+#include <math/util.h>      // for KiROUND
 #include <pcb_draw_panel_gal.h>
 #include <pcbnew.h>
 #include <pcbnew_scripting_helpers.h>
@@ -105,6 +114,434 @@ bool SaveBoard( wxString& aFileName, BOARD* aBoard )
 }
 
 
+int WriteDRCReport( BOARD* aBoard, const wxString& aFileName, const wxString& aFormat,
+                    int aThreadCount )
+{
+    wxString rulesFilepath;
+
+    if( !aBoard->GetFileName().IsEmpty() )
+    {
+        wxFileName rulesFile( aBoard->GetFileName() );
+        rulesFile.SetFullName( "drc-rules" );
+        rulesFilepath = rulesFile.GetFullPath();
+    }
+
+    try
+    {
+        LOCALE_IO            toggle;   // report floats with a '.' decimal separator
+        FILE_OUTPUTFORMATTER output( aFileName );
+        DRC                  drc;
+
+        std::unique_ptr<DRC_REPORT_SINK> sink;
+
+        if( aFormat == wxT( "csv" ) )
+            sink = std::make_unique<DRC_CSV_REPORT_SINK>( output );
+        else
+            sink = std::make_unique<DRC_JSON_REPORT_SINK>( output );
+
+        return (int) drc.RunHeadless( aBoard, *sink, aThreadCount, rulesFilepath );
+    }
+    catch( const IO_ERROR& ioe )
+    {
+        wxLogError( ioe.What() );
+        return -1;
+    }
+}
+
+
+int RunExportJobs( BOARD* aBoard, const wxString& aJobs, const wxString& aOutputDir,
+                   const wxString& aReportFile, int aThreadCount )
+{
+    BOARD_EXPORT_JOBS jobs( aBoard, aOutputDir );
+    wxString          error;
+
+    if( !jobs.AddJobs( aJobs, error ) )
+    {
+        wxLogError( error );
+        return -1;
+    }
+
+    int failed = jobs.Run( aThreadCount );
+
+    if( !aReportFile.IsEmpty() )
+    {
+        try
+        {
+            LOCALE_IO            toggle;   // report floats with a '.' decimal separator
+            FILE_OUTPUTFORMATTER output( aReportFile );
+
+            jobs.WriteReport( output );
+        }
+        catch( const IO_ERROR& ioe )
+        {
+            wxLogError( ioe.What() );
+            return -1;
+        }
+    }
+
+    return failed;
+}
+
+
+// The number of values of an item in the buffers of the bulk data functions
+static const size_t TRACK_COLUMNS = 7;
+static const size_t VIA_COLUMNS = 8;
+static const size_t PAD_COLUMNS = 8;
+static const size_t MODULE_COLUMNS = 4;
+
+
+static PyObject* packData( const std::vector<int32_t>& aData )
+{
+    return PyBytes_FromStringAndSize( (const char*) aData.data(),
+                                      aData.size() * sizeof( int32_t ) );
+}
+
+
+/**
+ * Copy the int32 values of a buffer given by a script.
+ * @return false if it is not a buffer of aCount values
+ */
+static bool unpackData( PyObject* aData, size_t aCount, std::vector<int32_t>& aValues )
+{
+    Py_buffer view;
+
+    if( PyObject_GetBuffer( aData, &view, PyBUF_C_CONTIGUOUS ) != 0 )
+    {
+        PyErr_Clear();
+        return false;
+    }
+
+    bool ok = (size_t) view.len == aCount * sizeof( int32_t );
+
+    if( ok )
+    {
+        aValues.resize( aCount );
+        memcpy( aValues.data(), view.buf, view.len );
+    }
+
+    PyBuffer_Release( &view );
+    return ok;
+}
+
+
+/**
+ * Applies the changes of the Set*Data() functions, through one commit if the board is the
+ * one of the editor.  In an action plugin the changes are made directly, the plugin runner
+ * saving the undo state of the board itself.
+ */
+class BULK_CHANGES
+{
+public:
+    BULK_CHANGES( BOARD* aBoard ) :
+            m_board( aBoard ),
+            m_count( 0 )
+    {
+        if( s_PcbEditFrame && s_PcbEditFrame->GetBoard() == aBoard && !IsActionRunning() )
+            m_commit = std::make_unique<BOARD_COMMIT>( s_PcbEditFrame );
+    }
+
+    bool IsValidNet( int aNetCode ) const { return m_board->FindNet( aNetCode ) != nullptr; }
+
+    /// To call before changing aItem (a pad is saved with its footprint)
+    void Modify( BOARD_ITEM* aItem )
+    {
+        if( m_commit )
+            m_commit->Modify( aItem );
+
+        m_count++;
+    }
+
+    int Push()
+    {
+        if( m_commit && m_count )
+            m_commit->Push( _( "Python script" ) );
+
+        return m_count;
+    }
+
+private:
+    BOARD*                        m_board;
+    std::unique_ptr<BOARD_COMMIT> m_commit;
+    int                           m_count;
+};
+
+
+static std::vector<TRACK*> collectTracks( BOARD* aBoard, KICAD_T aType )
+{
+    std::vector<TRACK*> tracks;
+
+    for( TRACK* track : aBoard->Tracks() )
+    {
+        if( track->Type() == aType )
+            tracks.push_back( track );
+    }
+
+    return tracks;
+}
+
+
+static std::vector<D_PAD*> collectPads( BOARD* aBoard )
+{
+    std::vector<D_PAD*> pads;
+
+    for( MODULE* module : aBoard->Modules() )
+    {
+        for( D_PAD* pad : module->Pads() )
+            pads.push_back( pad );
+    }
+
+    return pads;
+}
+
+
+PyObject* GetTracksData( BOARD* aBoard )
+{
+    std::vector<TRACK*>  tracks = collectTracks( aBoard, PCB_TRACE_T );
+    std::vector<int32_t> data;
+
+    data.reserve( tracks.size() * TRACK_COLUMNS );
+
+    for( TRACK* track : tracks )
+    {
+        data.insert( data.end(), { track->GetStart().x, track->GetStart().y,
+                                   track->GetEnd().x, track->GetEnd().y,
+                                   track->GetWidth(), track->GetLayer(),
+                                   track->GetNetCode() } );
+    }
+
+    return packData( data );
+}
+
+
+int SetTracksData( BOARD* aBoard, PyObject* aData )
+{
+    std::vector<TRACK*>  tracks = collectTracks( aBoard, PCB_TRACE_T );
+    std::vector<int32_t> data;
+    BULK_CHANGES         changes( aBoard );
+
+    if( !unpackData( aData, tracks.size() * TRACK_COLUMNS, data ) )
+        return -1;
+
+    for( size_t ii = 0; ii < tracks.size(); ii++ )
+    {
+        const int32_t* row = &data[ii * TRACK_COLUMNS];
+
+        if( !IsCopperLayer( row[5] ) || !changes.IsValidNet( row[6] ) )
+            return -1;
+    }
+
+    for( size_t ii = 0; ii < tracks.size(); ii++ )
+    {
+        const int32_t* row = &data[ii * TRACK_COLUMNS];
+        TRACK*         track = tracks[ii];
+        wxPoint        start( row[0], row[1] );
+        wxPoint        end( row[2], row[3] );
+
+        if( start == track->GetStart() && end == track->GetEnd() && row[4] == track->GetWidth()
+                && row[5] == track->GetLayer() && row[6] == track->GetNetCode() )
+        {
+            continue;
+        }
+
+        changes.Modify( track );
+        track->SetStart( start );
+        track->SetEnd( end );
+        track->SetWidth( row[4] );
+        track->SetLayer( ToLAYER_ID( row[5] ) );
+        track->SetNetCode( row[6] );
+    }
+
+    return changes.Push();
+}
+
+
+PyObject* GetViasData( BOARD* aBoard )
+{
+    std::vector<TRACK*>  vias = collectTracks( aBoard, PCB_VIA_T );
+    std::vector<int32_t> data;
+
+    data.reserve( vias.size() * VIA_COLUMNS );
+
+    for( TRACK* track : vias )
+    {
+        VIA*         via = static_cast<VIA*>( track );
+        PCB_LAYER_ID top, bottom;
+
+        via->LayerPair( &top, &bottom );
+        data.insert( data.end(), { via->GetPosition().x, via->GetPosition().y,
+                                   via->GetWidth(), via->GetDrill(), top, bottom,
+                                   via->GetNetCode(), (int32_t) via->GetViaType() } );
+    }
+
+    return packData( data );
+}
+
+
+int SetViasData( BOARD* aBoard, PyObject* aData )
+{
+    std::vector<TRACK*>  vias = collectTracks( aBoard, PCB_VIA_T );
+    std::vector<int32_t> data;
+    BULK_CHANGES         changes( aBoard );
+
+    if( !unpackData( aData, vias.size() * VIA_COLUMNS, data ) )
+        return -1;
+
+    for( size_t ii = 0; ii < vias.size(); ii++ )
+    {
+        const int32_t* row = &data[ii * VIA_COLUMNS];
+
+        if( !IsCopperLayer( row[4] ) || !IsCopperLayer( row[5] )
+                || !changes.IsValidNet( row[6] ) )
+        {
+            return -1;
+        }
+    }
+
+    for( size_t ii = 0; ii < vias.size(); ii++ )
+    {
+        const int32_t* row = &data[ii * VIA_COLUMNS];
+        VIA*           via = static_cast<VIA*>( vias[ii] );
+        wxPoint        pos( row[0], row[1] );
+        PCB_LAYER_ID   top, bottom;
+
+        via->LayerPair( &top, &bottom );
+
+        if( pos == via->GetPosition() && row[2] == via->GetWidth() && row[3] == via->GetDrill()
+                && row[4] == top && row[5] == bottom && row[6] == via->GetNetCode() )
+        {
+            continue;
+        }
+
+        changes.Modify( via );
+        via->SetPosition( pos );
+        via->SetWidth( row[2] );
+        via->SetDrill( row[3] );
+        via->SetLayerPair( ToLAYER_ID( row[4] ), ToLAYER_ID( row[5] ) );
+        via->SetNetCode( row[6] );
+    }
+
+    return changes.Push();
+}
+
+
+PyObject* GetPadsData( BOARD* aBoard )
+{
+    std::vector<D_PAD*>  pads = collectPads( aBoard );
+    std::vector<int32_t> data;
+
+    data.reserve( pads.size() * PAD_COLUMNS );
+
+    for( D_PAD* pad : pads )
+    {
+        data.insert( data.end(), { pad->GetPosition().x, pad->GetPosition().y,
+                                   pad->GetSize().x, pad->GetSize().y,
+                                   KiROUND( pad->GetOrientation() ),
+                                   pad->GetDrillSize().x, pad->GetDrillSize().y,
+                                   pad->GetNetCode() } );
+    }
+
+    return packData( data );
+}
+
+
+int SetPadsData( BOARD* aBoard, PyObject* aData )
+{
+    std::vector<D_PAD*>  pads = collectPads( aBoard );
+    std::vector<int32_t> data;
+    BULK_CHANGES         changes( aBoard );
+    MODULE*              modified = nullptr;
+
+    if( !unpackData( aData, pads.size() * PAD_COLUMNS, data ) )
+        return -1;
+
+    for( size_t ii = 0; ii < pads.size(); ii++ )
+    {
+        if( !changes.IsValidNet( data[ii * PAD_COLUMNS + 7] ) )
+            return -1;
+    }
+
+    for( size_t ii = 0; ii < pads.size(); ii++ )
+    {
+        const int32_t* row = &data[ii * PAD_COLUMNS];
+        D_PAD*         pad = pads[ii];
+        wxPoint        pos( row[0], row[1] );
+        wxSize         size( row[2], row[3] );
+        wxSize         drill( row[5], row[6] );
+
+        if( pos == pad->GetPosition() && size == pad->GetSize()
+                && row[4] == KiROUND( pad->GetOrientation() ) && drill == pad->GetDrillSize()
+                && row[7] == pad->GetNetCode() )
+        {
+            continue;
+        }
+
+        // The pads of a footprint are next to each other: save the footprint once
+        if( pad->GetParent() != modified )
+        {
+            modified = pad->GetParent();
+            changes.Modify( modified );
+        }
+
+        pad->SetPosition( pos );
+        pad->SetLocalCoord();
+        pad->SetSize( size );
+
+        if( row[4] != KiROUND( pad->GetOrientation() ) )
+            pad->SetOrientation( row[4] );
+
+        pad->SetDrillSize( drill );
+        pad->SetNetCode( row[7] );
+    }
+
+    return changes.Push();
+}
+
+
+PyObject* GetModulesData( BOARD* aBoard )
+{
+    std::vector<int32_t> data;
+
+    data.reserve( aBoard->Modules().size() * MODULE_COLUMNS );
+
+    for( MODULE* module : aBoard->Modules() )
+    {
+        data.insert( data.end(), { module->GetPosition().x, module->GetPosition().y,
+                                   KiROUND( module->GetOrientation() ),
+                                   module->GetLayer() } );
+    }
+
+    return packData( data );
+}
+
+
+int SetModulesData( BOARD* aBoard, PyObject* aData )
+{
+    std::vector<int32_t> data;
+    BULK_CHANGES         changes( aBoard );
+    size_t               ii = 0;
+
+    if( !unpackData( aData, aBoard->Modules().size() * MODULE_COLUMNS, data ) )
+        return -1;
+
+    for( MODULE* module : aBoard->Modules() )
+    {
+        const int32_t* row = &data[ii++ * MODULE_COLUMNS];
+        wxPoint        pos( row[0], row[1] );
+
+        if( pos == module->GetPosition() && row[2] == KiROUND( module->GetOrientation() ) )
+            continue;
+
+        changes.Modify( module );
+        module->SetPosition( pos );
+
+        if( row[2] != KiROUND( module->GetOrientation() ) )
+            module->SetOrientation( row[2] );
+    }
+
+    return changes.Push();
+}
+
+
 bool ExportSpecctraDSN( wxString& aFullFilename )
 {
     if( s_PcbEditFrame )
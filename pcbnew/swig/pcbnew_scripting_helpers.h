@@ -49,6 +49,68 @@ BOARD*  LoadBoard( wxString& aFileName );
 // so no option to choose the file format.
 bool    SaveBoard( wxString& aFileName, BOARD* aBoard );
 
+/**
+ * Runs the DRC on aBoard without the PCB editor, and writes the violations to a report
+ * file as they are found.  No markers are added to the board.  The custom rules are read
+ * from the "drc-rules" file next to the board file, if there is one.
+ *
+ * @param aFormat is "json" (the default) or "csv"
+ * @param aThreadCount is 1 to run the DRC tests serially, otherwise they run concurrently
+ * @return the number of violations reported, or -1 if the rules could not be read or
+ *         the report could not be written
+ */
+int     WriteDRCReport( BOARD* aBoard, const wxString& aFileName,
+                        const wxString& aFormat = "json", int aThreadCount = 0 );
+
+// Run a list of plot, drill and position file jobs (see BOARD_EXPORT_JOBS) and write a JSON
+// report of their run time and memory.  Returns the number of failed jobs, -1 on error.
+int     RunExportJobs( BOARD* aBoard, const wxString& aJobs, const wxString& aOutputDir,
+                       const wxString& aReportFile = "", int aThreadCount = 0 );
+
+/*
+ * Bulk access to the items of a board, to avoid the cost of the Python proxy of each item in
+ * scripts handling many items.  The data of the items are packed in a bytes object of int32
+ * values, one row of values per item in board order, so that they can be read with:
+ *     numpy.frombuffer( data, dtype=numpy.int32 ).reshape( -1, columns )
+ *
+ * The Set functions take a buffer in the same layout (bytes, bytearray or an int32 numpy
+ * array) for the same items, and change the items whose values differ, in one undoable
+ * commit when aBoard is the board of the editor.  They return the number of items changed,
+ * or -1 if the buffer does not match the items or holds an unknown net or layer.
+ */
+#ifndef SWIG
+struct _object;
+typedef _object PyObject;
+#endif
+
+/**
+ * The tracks (not the vias), 7 columns: start x, start y, end x, end y, width, layer,
+ * net code.
+ */
+PyObject* GetTracksData( BOARD* aBoard );
+int       SetTracksData( BOARD* aBoard, PyObject* aData );
+
+/**
+ * The vias, 8 columns: x, y, width, drill (-1 for the netclass drill), top layer,
+ * bottom layer, net code, via type (read only).
+ */
+PyObject* GetViasData( BOARD* aBoard );
+int       SetViasData( BOARD* aBoard, PyObject* aData );
+
+/**
+ * The pads of the footprints, footprint by footprint, 8 columns: x, y, size x, size y,
+ * orientation (tenths of degree), drill size x, drill size y, net code.
+ */
+PyObject* GetPadsData( BOARD* aBoard );
+int       SetPadsData( BOARD* aBoard, PyObject* aData );
+
+/**
+ * The footprints, 4 columns: x, y, orientation (tenths of degree), layer (read only: use
+ * MODULE::Flip() to change the side).
+ */
+PyObject* GetModulesData( BOARD* aBoard );
+int       SetModulesData( BOARD* aBoard, PyObject* aData );
+
 /**
  * will export the current BOARD to a specctra dsn file.
  * See http://www.autotraxeda.com/docs/SPECCTRA/SPECCTRA.pdf for the
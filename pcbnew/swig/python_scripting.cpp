@@ -151,10 +151,9 @@ PyThreadState* g_PythonMainTState;
  *
  * This initializes all the wxPython interface and returns the python thread control structure
  */
-bool pcbnewInitPythonScripting( const char * aUserScriptingPath )
+bool pcbnewInitPythonScripting()
 {
     int  retv;
-    char cmd[1024];
 
     swigAddBuiltin();           // add builtin functions
     swigAddModules();           // add our own modules
@@ -171,6 +170,8 @@ bool pcbnewInitPythonScripting( const char * aUserScriptingPath )
     // Make sure that that the correct version of wxPython is loaded. In systems where there
     // are different versions of wxPython installed this can lead to select wrong wxPython
     // version being selected.
+    char cmd[1024];
+
     snprintf( cmd, sizeof( cmd ), "import wxversion;  wxversion.select( '%s' )", WXPYTHON_VERSION );
 
     retv = PyRun_SimpleString( cmd );
@@ -206,18 +207,18 @@ bool pcbnewInitPythonScripting( const char * aUserScriptingPath )
 
 #endif  // ifdef KICAD_SCRIPTING_WXPYTHON
 
-    // Load pcbnew inside Python and load all the user plugins, TODO: add system wide plugins
+    // Load pcbnew inside Python.  The user plugins are loaded later, by
+    // PythonPluginsEnsureLoaded(), not to delay the first frame.
     {
         PyLOCK lock;
 
-        snprintf( cmd, sizeof( cmd ), "import sys, traceback\n"
-                  "sys.path.append(\".\")\n"
-                  "import pcbnew\n"
-                  "pcbnew.LoadPlugins(\"%s\")", aUserScriptingPath );
-        retv = PyRun_SimpleString( cmd );
+        const char* import = "import sys, traceback\n"
+                             "sys.path.append(\".\")\n"
+                             "import pcbnew\n";
+        retv = PyRun_SimpleString( import );
 
         if( retv != 0 )
-            wxLogError( "Python error %d occurred running command:\n\n`%s`", retv, cmd );
+            wxLogError( "Python error %d occurred running command:\n\n`%s`", retv, import );
     }
 
     return true;
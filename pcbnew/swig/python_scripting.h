@@ -52,9 +52,10 @@
 
 
 /**
- * Initialize the Python engine inside pcbnew.
+ * Initialize the Python engine inside pcbnew.  The plugins are not loaded: see
+ * PythonPluginsEnsureLoaded().
  */
-bool        pcbnewInitPythonScripting( const char * aUserScriptingPath );
+bool        pcbnewInitPythonScripting();
 void        pcbnewFinishPythonScripting();
 
 /**
@@ -50,7 +50,8 @@ using namespace std::placeholders;
 
 
 GRID_HELPER::GRID_HELPER( PCB_BASE_FRAME* aFrame ) :
-    m_frame( aFrame )
+    m_frame( aFrame ),
+    m_board( aFrame->GetBoard() )
 {
     m_enableSnap = true;
     m_enableGrid = true;
@@ -77,11 +78,60 @@ GRID_HELPER::GRID_HELPER( PCB_BASE_FRAME* aFrame ) :
     m_viewSnapLine.SetDrawAtZero( true );
     view->Add( &m_viewSnapLine );
     view->SetVisible( &m_viewSnapLine, false );
+
+    if( m_board )
+        m_board->AddListener( this );
 }
 
 
 GRID_HELPER::~GRID_HELPER()
 {
+    if( m_board )
+        m_board->RemoveListener( this );
+}
+
+
+void GRID_HELPER::OnBoardItemAdded( BOARD& aBoard, BOARD_ITEM* aBoardItem )
+{
+    // The item may have the address of an item deleted without notice
+    invalidateAnchors( aBoardItem );
+}
+
+
+void GRID_HELPER::OnBoardItemRemoved( BOARD& aBoard, BOARD_ITEM* aBoardItem )
+{
+    invalidateAnchors( aBoardItem );
+}
+
+
+void GRID_HELPER::OnBoardItemChanged( BOARD& aBoard, BOARD_ITEM* aBoardItem )
+{
+    invalidateAnchors( aBoardItem );
+}
+
+
+void GRID_HELPER::OnBoardDestroyed( BOARD& aBoard )
+{
+    m_anchorCache.clear();
+    m_board = nullptr;
+}
+
+
+void GRID_HELPER::invalidateAnchors( BOARD_ITEM* aItem )
+{
+    m_anchorCache.erase( aItem );
+
+    // The pads, graphics and texts of a changed footprint change with it
+    if( aItem->Type() == PCB_MODULE_T )
+    {
+        for( auto it = m_anchorCache.begin(); it != m_anchorCache.end(); )
+        {
+            if( it->second.m_Parent == aItem )
+                it = m_anchorCache.erase( it );
+            else
+                ++it;
+        }
+    }
 }
 
 
@@ -388,54 +438,136 @@ BOARD_ITEM* GRID_HELPER::GetSnapped( void ) const
 
 void GRID_HELPER::computeAnchors( BOARD_ITEM* aItem, const VECTOR2I& aRefPos, bool aFrom )
 {
-    VECTOR2I origin;
-    auto     view = m_frame->GetCanvas()->GetView();
-    auto     activeLayers = view->GetPainter()->GetSettings()->GetActiveLayers();
-    bool     isHighContrast = view->GetPainter()->GetSettings()->GetHighContrast();
+    auto view = m_frame->GetCanvas()->GetView();
+    auto activeLayers = view->GetPainter()->GetSettings()->GetActiveLayers();
+    bool isHighContrast = view->GetPainter()->GetSettings()->GetHighContrast();
 
-    switch( aItem->Type() )
+    if( aItem->Type() == PCB_MODULE_T )
     {
-        case PCB_MODULE_T:
-        {
-            MODULE* mod = static_cast<MODULE*>( aItem );
+        MODULE* mod = static_cast<MODULE*>( aItem );
 
-            for( auto pad : mod->Pads() )
+        for( auto pad : mod->Pads() )
+        {
+            // Getting pads from the module requires re-checking that the pad is shown
+            if( ( aFrom ||
+                  m_frame->GetMagneticItemsSettings()->pads == MAGNETIC_OPTIONS::CAPTURE_ALWAYS )
+                    && pad->GetBoundingBox().Contains( wxPoint( aRefPos.x, aRefPos.y ) )
+                    && view->IsVisible( pad )
+                    && ( !isHighContrast || activeLayers.count( pad->GetLayer() ) )
+                    && pad->ViewGetLOD( pad->GetLayer(), view ) < view->GetScale() )
             {
-                // Getting pads from the module requires re-checking that the pad is shown
-                if( ( aFrom ||
-                      m_frame->GetMagneticItemsSettings()->pads == MAGNETIC_OPTIONS::CAPTURE_ALWAYS )
-                        && pad->GetBoundingBox().Contains( wxPoint( aRefPos.x, aRefPos.y ) )
-                        && view->IsVisible( pad )
-                        && ( !isHighContrast || activeLayers.count( pad->GetLayer() ) )
-                        && pad->ViewGetLOD( pad->GetLayer(), view ) < view->GetScale() )
-                {
-                    addAnchor( pad->GetPosition(), CORNER | SNAPPABLE, pad );
-                    break;
-                }
+                addAnchor( pad->GetPosition(), CORNER | SNAPPABLE, pad );
+                break;
             }
-
-            // if the cursor is not over a pad, then drag the module by its origin
-            addAnchor( mod->GetPosition(), ORIGIN | SNAPPABLE, mod );
-            break;
         }
 
+        // if the cursor is not over a pad, then drag the module by its origin
+        addAnchor( mod->GetPosition(), ORIGIN | SNAPPABLE, mod );
+        return;
+    }
+
+    if( !isMagnetic( aItem, aFrom ) )
+        return;
+
+    const ITEM_ANCHORS& itemAnchors = getItemAnchors( aItem );
+
+    m_anchors.insert( m_anchors.end(), itemAnchors.m_Anchors.begin(),
+                      itemAnchors.m_Anchors.end() );
+
+    if( itemAnchors.m_Outline.PointCount() )
+        addAnchor( itemAnchors.m_Outline.NearestPoint( aRefPos ), OUTLINE, aItem );
+}
+
+
+bool GRID_HELPER::isMagnetic( BOARD_ITEM* aItem, bool aFrom ) const
+{
+    switch( aItem->Type() )
+    {
+    case PCB_PAD_T:
+        return aFrom || m_frame->GetMagneticItemsSettings()->pads == MAGNETIC_OPTIONS::CAPTURE_ALWAYS;
+
+    case PCB_MODULE_EDGE_T:
+    case PCB_LINE_T:
+        return m_frame->GetMagneticItemsSettings()->graphics;
+
+    case PCB_TRACE_T:
+    case PCB_ARC_T:
+    case PCB_VIA_T:
+        return aFrom || m_frame->GetMagneticItemsSettings()->tracks == MAGNETIC_OPTIONS::CAPTURE_ALWAYS;
+
+    default:
+        return true;
+    }
+}
+
+
+const GRID_HELPER::ITEM_ANCHORS& GRID_HELPER::getItemAnchors( BOARD_ITEM* aItem )
+{
+    // The board may have been replaced (a new file loaded) since the last query
+    if( m_board != m_frame->GetBoard() )
+    {
+        if( m_board )
+            m_board->RemoveListener( this );
+
+        m_anchorCache.clear();
+        m_board = m_frame->GetBoard();
+
+        if( m_board )
+            m_board->AddListener( this );
+    }
+
+    // The items being moved, point edited or drawn change before their commit
+    auto isEdited = []( const EDA_ITEM* aEdaItem )
+    {
+        return aEdaItem->IsSelected() || aEdaItem->IsMoving() || aEdaItem->IsDragging()
+               || aEdaItem->IsNew();
+    };
+
+    BOARD_ITEM* parent = aItem->GetParent();
+
+    if( !m_board || isEdited( aItem ) || ( parent && isEdited( parent ) ) )
+    {
+        buildItemAnchors( aItem, m_uncachedAnchors );
+        return m_uncachedAnchors;
+    }
+
+    auto it = m_anchorCache.find( aItem );
+
+    if( it == m_anchorCache.end() )
+    {
+        it = m_anchorCache.emplace( aItem, ITEM_ANCHORS() ).first;
+        buildItemAnchors( aItem, it->second );
+    }
+
+    return it->second;
+}
+
+
+void GRID_HELPER::buildItemAnchors( BOARD_ITEM* aItem, ITEM_ANCHORS& aAnchors ) const
+{
+    VECTOR2I origin;
+
+    aAnchors.m_Parent = aItem->GetParent();
+    aAnchors.m_Anchors.clear();
+    aAnchors.m_Outline.Clear();
+
+    auto addAnchor = [&]( const VECTOR2I& aPos, int aFlags, BOARD_ITEM* aAnchorItem )
+    {
+        aAnchors.m_Anchors.emplace_back( aPos, aFlags, aAnchorItem );
+    };
+
+    switch( aItem->Type() )
+    {
         case PCB_PAD_T:
         {
-            if( aFrom || m_frame->GetMagneticItemsSettings()->pads == MAGNETIC_OPTIONS::CAPTURE_ALWAYS )
-            {
-                D_PAD* pad = static_cast<D_PAD*>( aItem );
-                addAnchor( pad->GetPosition(), CORNER | SNAPPABLE, pad );
-            }
-
+            D_PAD* pad = static_cast<D_PAD*>( aItem );
+            addAnchor( pad->GetPosition(), CORNER | SNAPPABLE, pad );
             break;
         }
 
         case PCB_MODULE_EDGE_T:
         case PCB_LINE_T:
         {
-            if( !m_frame->GetMagneticItemsSettings()->graphics )
-                break;
-
             DRAWSEGMENT* dseg = static_cast<DRAWSEGMENT*>( aItem );
             VECTOR2I start = dseg->GetStart();
             VECTOR2I end = dseg->GetEnd();
@@ -498,18 +630,14 @@ void GRID_HELPER::computeAnchors( BOARD_ITEM* aItem, const VECTOR2I& aRefPos, bo
         case PCB_TRACE_T:
         case PCB_ARC_T:
         {
-            if( aFrom || m_frame->GetMagneticItemsSettings()->tracks == MAGNETIC_OPTIONS::CAPTURE_ALWAYS )
-            {
-                TRACK* track = static_cast<TRACK*>( aItem );
-                VECTOR2I start = track->GetStart();
-                VECTOR2I end = track->GetEnd();
-                origin.x = start.x + ( start.x - end.x ) / 2;
-                origin.y = start.y + ( start.y - end.y ) / 2;
-                addAnchor( start, CORNER | SNAPPABLE, track );
-                addAnchor( end, CORNER | SNAPPABLE, track );
-                addAnchor( origin, ORIGIN, track);
-            }
-
+            TRACK* track = static_cast<TRACK*>( aItem );
+            VECTOR2I start = track->GetStart();
+            VECTOR2I end = track->GetEnd();
+            origin.x = start.x + ( start.x - end.x ) / 2;
+            origin.y = start.y + ( start.y - end.y ) / 2;
+            addAnchor( start, CORNER | SNAPPABLE, track );
+            addAnchor( end, CORNER | SNAPPABLE, track );
+            addAnchor( origin, ORIGIN, track);
             break;
         }
 
@@ -519,18 +647,14 @@ void GRID_HELPER::computeAnchors( BOARD_ITEM* aItem, const VECTOR2I& aRefPos, bo
             break;
 
         case PCB_VIA_T:
-        {
-            if( aFrom || m_frame->GetMagneticItemsSettings()->tracks == MAGNETIC_OPTIONS::CAPTURE_ALWAYS )
-                addAnchor( aItem->GetPosition(), ORIGIN | CORNER | SNAPPABLE, aItem );
-
+            addAnchor( aItem->GetPosition(), ORIGIN | CORNER | SNAPPABLE, aItem );
             break;
-        }
 
         case PCB_ZONE_AREA_T:
         {
             const SHAPE_POLY_SET* outline = static_cast<const ZONE_CONTAINER*>( aItem )->Outline();
 
-            SHAPE_LINE_CHAIN lc;
+            SHAPE_LINE_CHAIN& lc = aAnchors.m_Outline;
             lc.SetClosed( true );
 
             for( auto iter = outline->CIterateWithHoles(); iter; iter++ )
@@ -539,8 +663,7 @@ void GRID_HELPER::computeAnchors( BOARD_ITEM* aItem, const VECTOR2I& aRefPos, bo
                 lc.Append( *iter );
             }
 
-            addAnchor( lc.NearestPoint( aRefPos ), OUTLINE, aItem );
-
+            // The nearest point of the outline is added for each cursor position
             break;
         }
 
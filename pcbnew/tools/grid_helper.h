@@ -26,6 +26,7 @@
 #ifndef __GRID_HELPER_H
 #define __GRID_HELPER_H
 
+#include <unordered_map>
 #include <vector>
 #include <math/vector2d.h>
 #include <core/optional.h>
@@ -33,15 +34,21 @@
 #include <layers_id_colors_and_visibility.h>
 #include <geometry/seg.h>
 #include <geometry/shape_arc.h>
+#include <geometry/shape_line_chain.h>
+#include <class_board.h>
 
 class PCB_BASE_FRAME;
 
-class GRID_HELPER {
+class GRID_HELPER : public BOARD_LISTENER
+{
 public:
 
     GRID_HELPER( PCB_BASE_FRAME* aFrame );
     ~GRID_HELPER();
 
+    GRID_HELPER( const GRID_HELPER& ) = delete;
+    GRID_HELPER& operator=( const GRID_HELPER& ) = delete;
+
     VECTOR2I GetGrid() const;
     VECTOR2I GetOrigin() const;
 
@@ -96,6 +103,12 @@ public:
         m_enableGrid = aGrid;
     }
 
+    ///> The anchors cached for an item are forgotten when the board reports its change
+    void OnBoardItemAdded( BOARD& aBoard, BOARD_ITEM* aBoardItem ) override;
+    void OnBoardItemRemoved( BOARD& aBoard, BOARD_ITEM* aBoardItem ) override;
+    void OnBoardItemChanged( BOARD& aBoard, BOARD_ITEM* aBoardItem ) override;
+    void OnBoardDestroyed( BOARD& aBoard ) override;
+
 private:
     enum ANCHOR_FLAGS {
         CORNER = 0x1,
@@ -122,6 +135,16 @@ private:
         }
     };
 
+    /**
+     * The anchors of an item which do not depend on the cursor position.
+     */
+    struct ITEM_ANCHORS
+    {
+        BOARD_ITEM*         m_Parent;   ///< the parent of the item when they were computed
+        std::vector<ANCHOR> m_Anchors;
+        SHAPE_LINE_CHAIN    m_Outline;  ///< the chain of the nearest OUTLINE anchor, if any
+    };
+
     std::vector<ANCHOR> m_anchors;
 
     std::set<BOARD_ITEM*> queryVisible( const BOX2I& aArea,
@@ -144,6 +167,22 @@ private:
      */
     void computeAnchors( BOARD_ITEM* aItem, const VECTOR2I& aRefPos, bool aFrom = false );
 
+    /**
+     * @return true if the magnetic settings let the cursor snap to aItem
+     */
+    bool isMagnetic( BOARD_ITEM* aItem, bool aFrom ) const;
+
+    /**
+     * Return the anchors of aItem from the cache, computing them if they are not cached.
+     * The anchors of the items being edited (which change without notifying the board)
+     * are not cached.
+     */
+    const ITEM_ANCHORS& getItemAnchors( BOARD_ITEM* aItem );
+
+    void buildItemAnchors( BOARD_ITEM* aItem, ITEM_ANCHORS& aAnchors ) const;
+
+    void invalidateAnchors( BOARD_ITEM* aItem );
+
     void clearAnchors()
     {
         m_anchors.clear();
@@ -159,6 +198,10 @@ private:
     ANCHOR*  m_snapItem;            ///< Pointer to the currently snapped item in m_anchors (NULL if not snapped)
     VECTOR2I m_skipPoint;           ///< When drawing a line, we avoid snapping to the source point
 
+    BOARD*                 m_board;    ///< the board listened to for m_anchorCache
+    std::unordered_map<BOARD_ITEM*, ITEM_ANCHORS> m_anchorCache;
+    ITEM_ANCHORS           m_uncachedAnchors;
+
     KIGFX::ORIGIN_VIEWITEM m_viewSnapPoint;
     KIGFX::ORIGIN_VIEWITEM m_viewSnapLine;
     KIGFX::ORIGIN_VIEWITEM m_viewAxis;
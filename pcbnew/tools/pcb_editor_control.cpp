@@ -848,7 +848,6 @@ int PCB_EDITOR_CONTROL::modifyLockSelected( MODIFY_MODE aMode )
         }
 
         m_toolMgr->PostEvent( EVENTS::SelectedItemsModified );
-        m_frame->OnModify();
     }
 
     return 0;
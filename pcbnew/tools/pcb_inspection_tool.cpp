@@ -183,7 +183,7 @@ int PCB_INSPECTION_TOOL::HighlightItem( const TOOL_EVENT& aEvent )
     {
         m_lastNetcode = *settings->GetHighlightNetCodes().begin();
         settings->SetHighlight( enableHighlight, net );
-        m_toolMgr->GetView()->UpdateAllLayersColor();
+        view()->UpdateHighlightColors();
     }
 
     // Store the highlighted netcode in the current board (for dialogs for instance)
@@ -222,13 +222,13 @@ int PCB_INSPECTION_TOOL::HighlightNet( const TOOL_EVENT& aEvent )
     {
         m_lastNetcode = *settings->GetHighlightNetCodes().begin();
         settings->SetHighlight( true, netcode );
-        m_toolMgr->GetView()->UpdateAllLayersColor();
+        view()->UpdateHighlightColors();
     }
     else if( aEvent.IsAction( &PCB_ACTIONS::toggleLastNetHighlight ) )
     {
         int temp = *settings->GetHighlightNetCodes().begin();
         settings->SetHighlight( true, m_lastNetcode );
-        m_toolMgr->GetView()->UpdateAllLayersColor();
+        view()->UpdateHighlightColors();
         m_lastNetcode = temp;
     }
     else    // Highlight the net belonging to the item under the cursor
@@ -247,7 +247,7 @@ int PCB_INSPECTION_TOOL::ClearHighlight( const TOOL_EVENT& aEvent )
 
     board->ResetNetHighLight();
     settings->SetHighlight( false );
-    m_toolMgr->GetView()->UpdateAllLayersColor();
+    view()->UpdateHighlightColors();
     m_frame->SetMsgPanel( board );
     m_frame->SendCrossProbeNetName( "" );
     return 0;
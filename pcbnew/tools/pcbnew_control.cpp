@@ -490,9 +490,15 @@ int PCBNEW_CONTROL::DeleteItemCursor( const TOOL_EVENT& aEvent )
             collector.m_Threshold = KiROUND( getView()->ToWorld( HITTEST_THRESHOLD_PIXELS ) );
 
             if( m_editModules )
-                collector.Collect( board, GENERAL_COLLECTOR::ModuleItems, (wxPoint) aPos, guide );
+            {
+                collector.Collect( board, GENERAL_COLLECTOR::ModuleItems, (wxPoint) aPos, guide,
+                                   getView() );
+            }
             else
-                collector.Collect( board, GENERAL_COLLECTOR::BoardLevelItems, (wxPoint) aPos, guide );
+            {
+                collector.Collect( board, GENERAL_COLLECTOR::BoardLevelItems, (wxPoint) aPos,
+                                   guide, getView() );
+            }
 
             // Remove unselectable items
             for( int i = collector.GetCount() - 1; i >= 0; --i )
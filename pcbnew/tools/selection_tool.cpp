@@ -410,7 +410,7 @@ bool SELECTION_TOOL::selectPoint( const VECTOR2I& aWhere, bool aOnDrag,
 
     collector.Collect( board(),
         m_editModules ? GENERAL_COLLECTOR::ModuleItems : GENERAL_COLLECTOR::AllBoardItems,
-        wxPoint( aWhere.x, aWhere.y ), guide );
+        wxPoint( aWhere.x, aWhere.y ), guide, getView() );
 
     // Remove unselectable items
     for( int i = collector.GetCount() - 1; i >= 0; --i )
@@ -31,25 +31,44 @@
 #include <wx/event.h>
 #include <tool/tool_manager.h>
 #include <bitmaps.h>
+#include <pcb_edit_frame.h>
+#include <pcbnew_settings.h>
 #include "pcb_actions.h"
 #include "selection_tool.h"
 #include "zone_filler_tool.h"
 #include "zone_filler.h"
 
 
+// The period of the checks for zones to refill in the background
+static const int s_BackgroundFillPollMs = 250;
+
+
 ZONE_FILLER_TOOL::ZONE_FILLER_TOOL() :
-    PCB_TOOL_BASE( "pcbnew.ZoneFiller" )
+    PCB_TOOL_BASE( "pcbnew.ZoneFiller" ),
+    m_fillInProgress( false )
 {
 }
 
 
 ZONE_FILLER_TOOL::~ZONE_FILLER_TOOL()
 {
+    m_backgroundFillTimer.Stop();
 }
 
 
 void ZONE_FILLER_TOOL::Reset( RESET_REASON aReason )
 {
+    // A fill of a snapshot of the previous board is of no use
+    if( aReason == MODEL_RELOAD )
+        cancelBackgroundFill();
+
+    if( !m_backgroundFillTimer.GetOwner() )
+    {
+        m_backgroundFillTimer.SetOwner( frame() );
+        frame()->Bind( wxEVT_TIMER, &ZONE_FILLER_TOOL::onBackgroundFillTimer, this,
+                       m_backgroundFillTimer.GetId() );
+        m_backgroundFillTimer.Start( s_BackgroundFillPollMs );
+    }
 }
 
 
@@ -58,6 +77,8 @@ void ZONE_FILLER_TOOL::CheckAllZones( wxWindow* aCaller )
     if( !getEditFrame<PCB_EDIT_FRAME>()->m_ZoneFillsDirty )
         return;
 
+    cancelBackgroundFill();
+
     std::vector<ZONE_CONTAINER*> toFill;
 
     for( auto zone : board()->Zones() )
@@ -68,11 +89,15 @@ void ZONE_FILLER_TOOL::CheckAllZones( wxWindow* aCaller )
     ZONE_FILLER filler( frame()->GetBoard(), &commit );
     filler.InstallNewProgressReporter( aCaller, _( "Checking Zones" ), 4 );
 
+    m_fillInProgress = true;
+
     if( filler.Fill( toFill, true ) )
     {
         getEditFrame<PCB_EDIT_FRAME>()->m_ZoneFillsDirty = false;
         canvas()->Refresh();
     }
+
+    m_fillInProgress = false;
 }
 
 
@@ -83,8 +108,83 @@ void ZONE_FILLER_TOOL::singleShotRefocus( wxIdleEvent& )
 }
 
 
+void ZONE_FILLER_TOOL::onBackgroundFillTimer( wxTimerEvent& aEvent )
+{
+    PCB_EDIT_FRAME* editFrame = getEditFrame<PCB_EDIT_FRAME>();
+
+    if( !editFrame->Settings().m_AutoRefillZones )
+    {
+        cancelBackgroundFill();
+        return;
+    }
+
+    // The progress dialog of a modal fill processes the events: the timer runs meanwhile.
+    // The zones are also left alone while a tool or a dialog is working on the board.
+    if( m_fillInProgress || !editFrame->ToolStackIsEmpty() || !editFrame->IsEnabled() )
+        return;
+
+    if( !m_backgroundFiller )
+        m_backgroundFiller = std::make_unique<BACKGROUND_ZONE_FILLER>( board() );
+
+    if( m_backgroundFiller->IsRunning() )
+    {
+        if( !m_backgroundFiller->IsDone() )
+            return;
+
+        applyBackgroundFill();
+
+        if( m_backgroundFiller->IsRunning() )
+            return;
+    }
+
+    // The zones whose fill was discarded are still out of date, and are refilled with the others
+    std::vector<ZONE_CONTAINER*> toFill = m_backgroundFiller->GetOutOfDateZones();
+
+    if( !toFill.empty() )
+        m_backgroundFiller->Start( toFill );
+}
+
+
+void ZONE_FILLER_TOOL::applyBackgroundFill()
+{
+    auto connectivity = board()->GetConnectivity();
+
+    // Same as ZONE_FILLER::Fill(): try again later if the connectivity is in use
+    std::unique_lock<std::mutex> lock( connectivity->GetLock(), std::try_to_lock );
+
+    if( !lock )
+        return;
+
+    int                          discarded = 0;
+    std::vector<ZONE_CONTAINER*> filled = m_backgroundFiller->Apply( discarded );
+
+    if( filled.empty() )
+        return;
+
+    for( ZONE_CONTAINER* zone : filled )
+    {
+        connectivity->Update( zone );
+        view()->Update( zone );
+    }
+
+    connectivity->RecalculateRatsnest();
+
+    // The fills are saved with the board
+    frame()->GetScreen()->SetModify();
+    canvas()->Refresh();
+}
+
+
+void ZONE_FILLER_TOOL::cancelBackgroundFill()
+{
+    m_backgroundFiller.reset();
+}
+
+
 void ZONE_FILLER_TOOL::FillAllZones( wxWindow* aCaller )
 {
+    cancelBackgroundFill();
+
     std::vector<ZONE_CONTAINER*> toFill;
 
     BOARD_COMMIT commit( this );
@@ -94,10 +194,15 @@ void ZONE_FILLER_TOOL::FillAllZones( wxWindow* aCaller )
 
     ZONE_FILLER filler( board(), &commit );
     filler.InstallNewProgressReporter( aCaller, _( "Fill All Zones" ),  4 );
+    filler.SetIncremental( true );
+
+    m_fillInProgress = true;
 
     if( filler.Fill( toFill ) )
         getEditFrame<PCB_EDIT_FRAME>()->m_ZoneFillsDirty = false;
 
+    m_fillInProgress = false;
+
     canvas()->Refresh();
 
     // wxWidgets has keyboard focus issues after the progress reporter.  Re-setting the focus
@@ -108,6 +213,8 @@ void ZONE_FILLER_TOOL::FillAllZones( wxWindow* aCaller )
 
 int ZONE_FILLER_TOOL::ZoneFill( const TOOL_EVENT& aEvent )
 {
+    cancelBackgroundFill();
+
     std::vector<ZONE_CONTAINER*> toFill;
 
     BOARD_COMMIT commit( this );
@@ -128,7 +235,11 @@ int ZONE_FILLER_TOOL::ZoneFill( const TOOL_EVENT& aEvent )
 
     ZONE_FILLER filler( board(), &commit );
     filler.InstallNewProgressReporter( frame(), _( "Fill Zone" ), 4 );
+    filler.SetIncremental( true );
+
+    m_fillInProgress = true;
     filler.Fill( toFill );
+    m_fillInProgress = false;
 
     canvas()->Refresh();
     return 0;
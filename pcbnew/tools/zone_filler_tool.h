@@ -25,15 +25,20 @@
 #ifndef ZONE_FILLER_TOOL_H
 #define ZONE_FILLER_TOOL_H
 
+#include <memory>
+#include <wx/timer.h>
 #include <tools/pcb_tool_base.h>
 
 
 class PCB_EDIT_FRAME;
+class BACKGROUND_ZONE_FILLER;
 
 /**
  * ZONE_FILLER_TOOL
  *
- * Handles actions specific to filling copper zones.
+ * Handles actions specific to filling copper zones.  When PCBNEW_SETTINGS::m_AutoRefillZones
+ * is set, it also refills the filled zones made out of date by the edits, in the background
+ * (see BACKGROUND_ZONE_FILLER).
  */
 class ZONE_FILLER_TOOL : public PCB_TOOL_BASE
 {
@@ -56,8 +61,21 @@ private:
     ///> Refocuses on an idle event (used after the Progress Reporter messes up the focus)
     void singleShotRefocus( wxIdleEvent& );
 
+    ///> Applies the background fill once done, and starts the next one
+    void onBackgroundFillTimer( wxTimerEvent& aEvent );
+
+    ///> Moves the fills of the background fill into the board zones
+    void applyBackgroundFill();
+
+    ///> Stops the background fill, before a fill which does not wait for it
+    void cancelBackgroundFill();
+
     ///> Sets up handlers for various events.
     void setTransitions() override;
+
+    std::unique_ptr<BACKGROUND_ZONE_FILLER> m_backgroundFiller;
+    wxTimer                                 m_backgroundFillTimer;
+    bool                                    m_fillInProgress;   ///< a modal fill is running
 };
 
 #endif
@@ -39,6 +39,10 @@
 #include <tools/global_edit_tool.h>
 #include <tracks_cleaner.h>
 
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
 
 /* Install the cleanup dialog frame to know what should be cleaned
 */
@@ -168,9 +172,22 @@ bool TRACKS_CLEANER::cleanupVias()
             vias.push_back( via );
     }
 
-    for( auto via1_it = vias.begin(); via1_it != vias.end(); via1_it++ )
+    // The vias at each position, in the order of the board, and the rank of each via among
+    // the vias at its position: only these have to be compared
+    std::unordered_map<wxPoint, std::vector<VIA*>> viasAt;
+    std::vector<size_t>                           rankAt( vias.size() );
+
+    for( size_t ii = 0; ii < vias.size(); ii++ )
+    {
+        std::vector<VIA*>& samePosition = viasAt[ vias[ii]->GetPosition() ];
+
+        rankAt[ii] = samePosition.size();
+        samePosition.push_back( vias[ii] );
+    }
+
+    for( size_t ii = 0; ii < vias.size(); ii++ )
     {
-        auto via1 = *via1_it;
+        auto via1 = vias[ii];
 
         if( via1->IsLocked() )
             continue;
@@ -199,11 +216,13 @@ bool TRACKS_CLEANER::cleanupVias()
             }
         }
 
-        for( auto via2_it = via1_it + 1; via2_it != vias.end(); via2_it++ )
+        const std::vector<VIA*>& samePosition = viasAt[ via1->GetPosition() ];
+
+        for( size_t jj = rankAt[ii] + 1; jj < samePosition.size(); jj++ )
         {
-            auto via2 = *via2_it;
+            auto via2 = samePosition[jj];
 
-            if( via1->GetPosition() != via2->GetPosition() || via2->IsLocked() )
+            if( via2->IsLocked() )
                 continue;
 
             if( via1->GetViaType() == via2->GetViaType() )
@@ -258,46 +277,62 @@ bool TRACKS_CLEANER::testTrackEndpointIsNode( TRACK* aTrack, bool aTstStart )
 
 bool TRACKS_CLEANER::deleteDanglingTracks()
 {
-    bool item_erased = false;
     bool modified = false;
 
-    do // Iterate when at least one track is deleted
+    // Ensure the connectivity is up to date
+    m_brd->BuildConnectivity();
+
+    auto connectivity = m_brd->GetConnectivity();
+
+    // Test all the tracks, then only the ones connected to a removed track: a track connected
+    // to a deleted track perhaps is not connected anymore and should be deleted
+    std::vector<TRACK*> toTest( m_brd->Tracks().begin(), m_brd->Tracks().end() );
+
+    while( !toTest.empty() )
     {
-        item_erased = false;
-        // Ensure the connectivity is up to date, especially after removind a dangling segment
-        m_brd->BuildConnectivity();
+        std::vector<TRACK*>        nextToTest;
+        std::unordered_set<TRACK*> queued;
 
-        for( TRACK* track : m_brd->Tracks() )
+        for( TRACK* track : toTest )
         {
-            bool    flag_erase = false; // Start without a good reason to erase it
+            if( track->HasFlag( IS_DELETED ) )
+                continue;
+
             wxPoint pos;
 
             // Tst if a track (or a via) endpoint is not connected to another track or to a zone.
-            if( m_brd->GetConnectivity()->TestTrackEndpointDangling( track, &pos ) )
-                flag_erase = true;
+            if( !connectivity->TestTrackEndpointDangling( track, &pos ) )
+                continue;
 
-            if( flag_erase )
-            {
-                int errorCode = track->IsTrack() ? CLEANUP_DANGLING_TRACK : CLEANUP_DANGLING_VIA;
-                DRC_ITEM* item = new DRC_ITEM( errorCode );
-                item->SetItems( track );
-                m_itemsList->push_back( item );
+            int errorCode = track->IsTrack() ? CLEANUP_DANGLING_TRACK : CLEANUP_DANGLING_VIA;
+            DRC_ITEM* item = new DRC_ITEM( errorCode );
+            item->SetItems( track );
+            m_itemsList->push_back( item );
 
-                if( !m_dryRun )
+            if( !m_dryRun )
+            {
+                for( TRACK* neighbour : connectivity->GetConnectedTracks( track ) )
                 {
-                    m_brd->Remove( track );
-                    m_commit.Removed( track );
-
-                    /* keep iterating, because a track connected to the deleted track
-                     * now perhaps is not connected and should be deleted */
-                    item_erased = true;
-                    modified = true;
+                    if( queued.insert( neighbour ).second )
+                        nextToTest.push_back( neighbour );
                 }
-                // Fix me: In dry run we should disable the track to erase and retry with this disabled track
-                // However the connectivity algo does not handle disabled items.
+
+                track->SetFlags( IS_DELETED );
+                m_brd->Remove( track );
+                m_commit.Removed( track );
+                modified = true;
             }
+            // Fix me: In dry run we should disable the track to erase and retry with this disabled track
+            // However the connectivity algo does not handle disabled items.
         }
-    } while( item_erased ); // A segment was erased: test for some new dangling segments
+
+        // Drop the removed tracks from the connections of their neighbours; only the nets of
+        // the removed tracks are searched again
+        if( !nextToTest.empty() )
+            connectivity->RecalculateRatsnest();
+
+        toTest = std::move( nextToTest );
+    }
 
     return modified;
 }
@@ -361,17 +396,38 @@ bool TRACKS_CLEANER::cleanupSegments()
 
     std::set<BOARD_ITEM*> toRemove;
 
-    // Remove duplicate segments (2 superimposed identical segments):
-    for( auto it = m_brd->Tracks().begin(); it != m_brd->Tracks().end(); it++ )
+    // Remove duplicate segments (2 superimposed identical segments).
+    // Both ends of a duplicate are on the ends of the track, so its start is one of them:
+    // only the later tracks starting at one of the track ends are compared to it
+    std::vector<TRACK*>                              tracks( m_brd->Tracks().begin(),
+                                                             m_brd->Tracks().end() );
+    std::unordered_map<wxPoint, std::vector<size_t>> tracksStartingAt;
+
+    for( size_t ii = 0; ii < tracks.size(); ii++ )
+        tracksStartingAt[ tracks[ii]->GetStart() ].push_back( ii );
+
+    for( size_t ii = 0; ii < tracks.size(); ii++ )
     {
-        auto track1 = *it;
+        auto track1 = tracks[ii];
 
         if( track1->Type() != PCB_TRACE_T || track1->HasFlag( IS_DELETED ) || track1->IsLocked() )
             continue;
 
-        for( auto it2 = it + 1; it2 != m_brd->Tracks().end(); it2++ )
+        std::vector<size_t> candidates = tracksStartingAt[ track1->GetStart() ];
+
+        if( track1->GetEnd() != track1->GetStart() )
+        {
+            const std::vector<size_t>& atEnd = tracksStartingAt[ track1->GetEnd() ];
+            candidates.insert( candidates.end(), atEnd.begin(), atEnd.end() );
+            std::sort( candidates.begin(), candidates.end() );
+        }
+
+        for( size_t jj : candidates )
         {
-            auto track2 = *it2;
+            if( jj <= ii )
+                continue;
+
+            auto track2 = tracks[jj];
 
             if( track2->HasFlag( IS_DELETED ) )
                 continue;
@@ -28,6 +28,7 @@
 #include <functional>
 using namespace std::placeholders;
 #include <fctsys.h>
+#include <advanced_config.h>
 #include <class_draw_panel_gal.h>
 #include <macros.h>
 #include <pcbnew.h>
@@ -43,6 +44,8 @@ using namespace std::placeholders;
 #include <class_edge_mod.h>
 #include <origin_viewitem.h>
 #include <connectivity/connectivity_data.h>
+#include <router/pns_tool_base.h>
+#include <zone_knockout_cache.h>
 #include <pcbnew_settings.h>
 #include <tool/tool_manager.h>
 #include <tool/actions.h>
@@ -179,6 +182,28 @@ static void SwapItemData( BOARD_ITEM* aItem, BOARD_ITEM* aImage )
     aItem->SetParent( parent );
 }
 
+/**
+ * Compress the fills of the zone copies of aList, if enabled.  They are only needed again
+ * by an undo or a redo.
+ */
+static void packZoneFills( PICKED_ITEMS_LIST& aList )
+{
+    if( !ADVANCED_CFG::GetCfg().m_CompactUndoFills )
+        return;
+
+    for( unsigned ii = 0; ii < aList.GetCount(); ii++ )
+    {
+        EDA_ITEM* image = aList.GetPickedItemLink( ii );
+
+        if( aList.GetPickedItemStatus( ii ) == UR_CHANGED && image
+                && image->Type() == PCB_ZONE_AREA_T )
+        {
+            static_cast<ZONE_CONTAINER*>( image )->PackFill();
+        }
+    }
+}
+
+
 void PCB_BASE_EDIT_FRAME::SaveCopyInUndoList( BOARD_ITEM* aItem, UNDO_REDO_T aCommandType,
                                               const wxPoint& aTransformPoint )
 {
@@ -314,6 +339,8 @@ void PCB_BASE_EDIT_FRAME::SaveCopyInUndoList( const PICKED_ITEMS_LIST& aItemsLis
 
     if( commandToUndo->GetCount() )
     {
+        packZoneFills( *commandToUndo );
+
         /* Save the copy in undo list */
         GetScreen()->PushCommandToUndoList( commandToUndo );
 
@@ -397,6 +424,18 @@ void PCB_BASE_EDIT_FRAME::PutDataInPreviousState( PICKED_ITEMS_LIST* aList, bool
     auto view = GetCanvas()->GetView();
     auto connectivity = GetBoard()->GetConnectivity();
 
+    // Undo and redo don't go through a BOARD_COMMIT, so the restored items are not added to
+    // the dirty regions of the zone fills, nor removed from the knockout cache: the next fill
+    // of every zone has to be a full one
+    for( ZONE_CONTAINER* zone : GetBoard()->Zones() )
+        zone->InvalidateDirtyRegion();
+
+    GetBoard()->GetZoneKnockoutCache()->Clear();
+
+    // Nor are they marked in the router worlds, which are synced again from the whole board
+    for( PNS::TOOL_BASE* routerTool : PNS::TOOL_BASE::RouterTools( m_toolManager ) )
+        routerTool->InvalidateWorld();
+
     // Undo in the reverse order of list creation: (this can allow stacked changes
     // like the same item can be changes and deleted in the same complex command
 
@@ -472,6 +511,9 @@ void PCB_BASE_EDIT_FRAME::PutDataInPreviousState( PICKED_ITEMS_LIST* aList, bool
             view->Remove( eda_item );
             connectivity->Remove( item );
 
+            if( image && image->Type() == PCB_ZONE_AREA_T )
+                static_cast<ZONE_CONTAINER*>( image )->UnpackFill();
+
             SwapItemData( item, image );
 
             view->Add( eda_item );
@@ -566,6 +608,9 @@ void PCB_BASE_EDIT_FRAME::PutDataInPreviousState( PICKED_ITEMS_LIST* aList, bool
         }
     }
 
+    // The copies now hold the states to redo (or undo again)
+    packZoneFills( *aList );
+
     if( not_found )
         wxMessageBox( _( "Incomplete undo/redo operation: some items not found" ) );
 
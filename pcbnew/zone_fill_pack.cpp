@@ -0,0 +1,265 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <zone_fill_pack.h>
+
+#include <wx/mstream.h>
+#include <wx/zstream.h>
+
+
+/*
+ * The encoded fill is a sequence of unsigned LEB128 varints: the version, the outline count,
+ * and for each outline its chain count, then for each chain its closed flag, its point count
+ * and its points; then the segment count and the segment ends.  A coordinate is stored as the
+ * zigzag encoded difference with the same coordinate of the previous point.
+ */
+
+static const uint64_t PACK_VERSION = 1;
+
+
+static void putVarint( std::string& aOut, uint64_t aValue )
+{
+    while( aValue >= 0x80 )
+    {
+        aOut.push_back( (char) ( ( aValue & 0x7F ) | 0x80 ) );
+        aValue >>= 7;
+    }
+
+    aOut.push_back( (char) aValue );
+}
+
+
+static void putCoord( std::string& aOut, int& aPrevious, int aValue )
+{
+    int64_t delta = (int64_t) aValue - aPrevious;
+
+    putVarint( aOut, ( (uint64_t) delta << 1 ) ^ (uint64_t) ( delta >> 63 ) );
+    aPrevious = aValue;
+}
+
+
+/**
+ * Reads the varints of an encoded fill, remembering any read past its end.
+ */
+class PACK_READER
+{
+public:
+    PACK_READER( const std::string& aData ) :
+            m_data( aData ),
+            m_pos( 0 ),
+            m_error( false )
+    {}
+
+    uint64_t Varint()
+    {
+        uint64_t value = 0;
+
+        for( int shift = 0; shift < 64; shift += 7 )
+        {
+            if( m_pos >= m_data.size() )
+                break;
+
+            uint8_t byte = m_data[m_pos++];
+            value |= (uint64_t) ( byte & 0x7F ) << shift;
+
+            if( !( byte & 0x80 ) )
+                return value;
+        }
+
+        Fail();
+        return 0;
+    }
+
+    int Coord( int& aPrevious )
+    {
+        uint64_t zigzag = Varint();
+        int64_t  delta = (int64_t) ( zigzag >> 1 ) ^ -(int64_t) ( zigzag & 1 );
+
+        aPrevious = (int) ( aPrevious + delta );
+        return aPrevious;
+    }
+
+    /// @return false if aCount items of at least one byte each cannot be left to read
+    bool CanRead( uint64_t aCount ) const
+    {
+        return !m_error && aCount <= m_data.size() - m_pos;
+    }
+
+    void Fail() { m_error = true; }
+
+    bool Failed() const { return m_error; }
+
+private:
+    const std::string& m_data;
+    size_t             m_pos;
+    bool               m_error;
+};
+
+
+std::shared_ptr<const ZONE_FILL_PACK> ZONE_FILL_PACK::Pack( const SHAPE_POLY_SET& aFill,
+                                                            const std::vector<SEG>& aSegments )
+{
+    std::string encoded;
+    int         x = 0;
+    int         y = 0;
+
+    putVarint( encoded, PACK_VERSION );
+    putVarint( encoded, aFill.OutlineCount() );
+
+    for( int ii = 0; ii < aFill.OutlineCount(); ii++ )
+    {
+        const SHAPE_POLY_SET::POLYGON& polygon = aFill.CPolygon( ii );
+
+        putVarint( encoded, polygon.size() );
+
+        for( const SHAPE_LINE_CHAIN& chain : polygon )
+        {
+            if( chain.ArcCount() )
+                return nullptr;
+
+            putVarint( encoded, chain.IsClosed() ? 1 : 0 );
+            putVarint( encoded, chain.PointCount() );
+
+            for( const VECTOR2I& pt : chain.CPoints() )
+            {
+                putCoord( encoded, x, pt.x );
+                putCoord( encoded, y, pt.y );
+            }
+        }
+    }
+
+    putVarint( encoded, aSegments.size() );
+
+    for( const SEG& seg : aSegments )
+    {
+        putCoord( encoded, x, seg.A.x );
+        putCoord( encoded, y, seg.A.y );
+        putCoord( encoded, x, seg.B.x );
+        putCoord( encoded, y, seg.B.y );
+    }
+
+    // The fastest level: a pack is made for each zone of each fill
+    wxMemoryOutputStream memory;
+
+    {
+        wxZlibOutputStream zlib( memory, 1, wxZLIB_ZLIB );
+        zlib.Write( encoded.data(), encoded.size() );
+        zlib.Close();
+    }
+
+    auto pack = std::make_shared<ZONE_FILL_PACK>();
+    pack->m_data.resize( memory.GetSize() );
+    memory.CopyTo( &pack->m_data[0], pack->m_data.size() );
+
+    return pack;
+}
+
+
+bool ZONE_FILL_PACK::Unpack( SHAPE_POLY_SET& aFill, std::vector<SEG>& aSegments ) const
+{
+    aFill.RemoveAllContours();
+    aSegments.clear();
+
+    std::string         encoded;
+    wxMemoryInputStream memory( m_data.data(), m_data.size() );
+    wxZlibInputStream   zlib( memory, wxZLIB_ZLIB );
+    char                buffer[65536];
+
+    do
+    {
+        zlib.Read( buffer, sizeof( buffer ) );
+        encoded.append( buffer, zlib.LastRead() );
+    } while( zlib.LastRead() > 0 );
+
+    PACK_READER reader( encoded );
+    int         x = 0;
+    int         y = 0;
+
+    if( reader.Varint() != PACK_VERSION )
+        return false;
+
+    uint64_t outlineCount = reader.Varint();
+
+    for( uint64_t ii = 0; ii < outlineCount && reader.CanRead( 1 ); ii++ )
+    {
+        uint64_t chainCount = reader.Varint();
+
+        for( uint64_t jj = 0; jj < chainCount && reader.CanRead( 2 ); jj++ )
+        {
+            SHAPE_LINE_CHAIN chain;
+            bool             closed = reader.Varint() != 0;
+            uint64_t         pointCount = reader.Varint();
+
+            // Two bytes at least per point: don't trust a corrupted count
+            if( pointCount > encoded.size() || !reader.CanRead( 2 * pointCount ) )
+            {
+                reader.Fail();
+                break;
+            }
+
+            for( uint64_t kk = 0; kk < pointCount; kk++ )
+            {
+                int px = reader.Coord( x );
+                int py = reader.Coord( y );
+                chain.Append( px, py, true );
+            }
+
+            chain.SetClosed( closed );
+
+            if( jj == 0 )
+                aFill.AddOutline( chain );
+            else
+                aFill.AddHole( chain );
+        }
+    }
+
+    uint64_t segmentCount = reader.Varint();
+
+    if( segmentCount <= encoded.size() && reader.CanRead( 4 * segmentCount ) )
+    {
+        aSegments.reserve( segmentCount );
+
+        for( uint64_t ii = 0; ii < segmentCount; ii++ )
+        {
+            VECTOR2I a, b;
+            a.x = reader.Coord( x );
+            a.y = reader.Coord( y );
+            b.x = reader.Coord( x );
+            b.y = reader.Coord( y );
+            aSegments.emplace_back( a, b );
+        }
+    }
+    else
+    {
+        reader.Fail();
+    }
+
+    if( reader.Failed() || (uint64_t) aFill.OutlineCount() != outlineCount )
+    {
+        aFill.RemoveAllContours();
+        aSegments.clear();
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,68 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef ZONE_FILL_PACK_H_
+#define ZONE_FILL_PACK_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <geometry/seg.h>
+#include <geometry/shape_poly_set.h>
+
+
+/**
+ * ZONE_FILL_PACK -
+ * The filled polygons and fill segments of a zone, packed in a compressed binary form.
+ *
+ * The copies of zones kept in the undo and redo lists are the ones of the whole zone fills
+ * (the zone filler changes all of them): they keep their fill packed, and unpack it when an
+ * undo or redo needs them again.  The vertices are stored as the differences between
+ * consecutive points, which compress well.  A pack is never modified, so the copies of a zone
+ * share it.
+ */
+class ZONE_FILL_PACK
+{
+public:
+    /**
+     * Packs aFill and aSegments.
+     * @return nullptr if aFill cannot be packed (it holds arcs)
+     */
+    static std::shared_ptr<const ZONE_FILL_PACK> Pack( const SHAPE_POLY_SET& aFill,
+                                                       const std::vector<SEG>& aSegments );
+
+    /**
+     * Rebuilds the packed fill.
+     * @return false if the pack is corrupted (aFill and aSegments are then empty)
+     */
+    bool Unpack( SHAPE_POLY_SET& aFill, std::vector<SEG>& aSegments ) const;
+
+    /// @return the size of the packed fill, in bytes
+    size_t GetSize() const { return m_data.size(); }
+
+private:
+    std::string m_data;         ///< the zlib stream of the encoded fill
+};
+
+#endif // ZONE_FILL_PACK_H_
@@ -23,9 +23,12 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
  */
 
-#include <thread>
 #include <algorithm>
-#include <future>
+#include <functional>
+#include <limits>
+#include <map>
+#include <set>
+#include <unordered_map>
 
 #include <class_board.h>
 #include <class_zone.h>
@@ -42,9 +45,17 @@
 #include <geometry/shape_file_io.h>
 #include <geometry/convex_hull.h>
 #include <geometry/geometry_utils.h>
+#include <geometry/poly_set_index.h>
+#include <geometry/rtree.h>
+#include <zone_knockout_cache.h>
+#include <kicad_plugin.h>
 #include <confirm.h>
 #include <convert_to_biu.h>
 #include <math/util.h>      // for KiROUND
+#include <profile.h>
+#include <thread_pool.h>
+#include <trace_events.h>
+#include <trace_helpers.h>
 
 #include "zone_filler.h"
 
@@ -73,11 +84,19 @@ private:
 static const double s_RoundPadThermalSpokeAngle = 450;
 static const bool s_DumpZonesWhenFilling = false;
 
+// Zones larger than this are filled in tiles of about this size, in parallel.  The tiling
+// only depends on the zone, so that a check of the fills gives the same result as the fill.
+static const int s_FillTileSize = Millimeter2iu( 25 );
+
 
 ZONE_FILLER::ZONE_FILLER(  BOARD* aBoard, COMMIT* aCommit ) :
     m_board( aBoard ),
     m_brdOutlinesValid( false ),
     m_commit( aCommit ),
+    m_incremental( false ),
+    m_cancelled( nullptr ),
+    m_knockoutCache( nullptr ),
+    m_thermalPads( nullptr ),
     m_progressReporter( nullptr ),
     m_high_def( 9 ),
     m_low_def( 6 )
@@ -98,31 +117,369 @@ void ZONE_FILLER::InstallNewProgressReporter( wxWindow* aParent, const wxString&
 }
 
 
+/**
+ * The previous fill of a zone, and the part of it which is out of date, when the zone can be
+ * refilled incrementally.
+ */
+struct ZONE_REFILL
+{
+    bool           m_incremental;
+    BOX2I          m_dirtyRegion;
+    SHAPE_POLY_SET m_previousFill;
+};
+
+
+/**
+ * A unit of work of the fill threads: a whole zone, or a tile of a large zone.
+ */
+struct FILL_JOB
+{
+    size_t m_zoneIndex;
+    int    m_tileIndex;     // -1 for a whole zone
+    BOX2I  m_tile;
+};
+
+
+/**
+ * Describe a zone, or the region of a zone being filled, for the traces of the filler.
+ */
+static wxString describeZone( const ZONE_CONTAINER* aZone, const BOX2I* aRegion = nullptr )
+{
+    wxString desc = wxString::Format( "zone '%s' on %s", aZone->GetNetname(),
+                                      aZone->GetLayerName() );
+
+    if( aRegion )
+    {
+        desc << wxString::Format( " (region %.2f, %.2f mm)",
+                                  Iu2Millimeter( aRegion->GetX() ),
+                                  Iu2Millimeter( aRegion->GetY() ) );
+    }
+
+    return desc;
+}
+
+
+/**
+ * Return true if the item, or one of its footprint graphics, is on the board outline layer.
+ * The board outline clips every zone.
+ */
+static bool isOnEdgeCuts( BOARD_ITEM* aItem )
+{
+    if( aItem->IsOnLayer( Edge_Cuts ) )
+        return true;
+
+    if( aItem->Type() == PCB_MODULE_T )
+    {
+        for( BOARD_ITEM* item : static_cast<MODULE*>( aItem )->GraphicalItems() )
+        {
+            if( item->IsOnLayer( Edge_Cuts ) )
+                return true;
+        }
+    }
+
+    return false;
+}
+
+
+/**
+ * Compute the area of the fill of a zone which an item can change.
+ * @return false if the item cannot change the fill of the zone at all.
+ */
+static bool getInfluenceArea( ZONE_CONTAINER* aZone, BOARD_ITEM* aItem, int aBiggestClearance,
+                              BOX2I& aArea )
+{
+    MODULE* module = aItem->Type() == PCB_MODULE_T ? static_cast<MODULE*>( aItem ) : nullptr;
+
+    // Pads and footprints knock out their holes on every layer, so are not filtered
+    if( !module && aItem->Type() != PCB_PAD_T
+            && !aZone->CommonLayerExists( aItem->GetLayerSet() ) )
+    {
+        return false;
+    }
+
+    // The fill is affected up to the clearance of the item (or to the end of the thermal
+    // spokes of a pad), and the min width pruning can grow that by the min thickness
+    int margin = std::max( aBiggestClearance, aZone->GetZoneClearance() )
+                 + aZone->GetMinThickness();
+    int reliefMargin = aZone->GetThermalReliefGap() + aZone->GetThermalReliefCopperBridge();
+
+    if( module )
+    {
+        for( D_PAD* pad : module->Pads() )
+        {
+            reliefMargin = std::max( reliefMargin, aZone->GetThermalReliefGap( pad )
+                                                   + aZone->GetThermalReliefCopperBridge( pad ) );
+        }
+    }
+    else if( aItem->Type() == PCB_PAD_T )
+    {
+        D_PAD* pad = static_cast<D_PAD*>( aItem );
+        reliefMargin = aZone->GetThermalReliefGap( pad )
+                       + aZone->GetThermalReliefCopperBridge( pad );
+    }
+
+    aArea = aItem->GetBoundingBox();
+    aArea.Inflate( margin + reliefMargin );
+
+    return true;
+}
+
+
+/**
+ * Builds the fingerprints of zone fills (see ZONE_CONTAINER::GetFillFingerprint()).  The
+ * board items are described as they are in the board file, so whatever is saved about an
+ * item is part of the fingerprint of the fills it can change.
+ */
+class FILL_FINGERPRINTER : public PCB_IO
+{
+public:
+    FILL_FINGERPRINTER( BOARD* aBoard, size_t aSettingsHash ) :
+            PCB_IO( CTL_STD_LAYER_NAMES | CTL_OMIT_ZONE_FILLS ),
+            m_settingsHash( aSettingsHash )
+    {
+        m_board = aBoard;
+    }
+
+    std::string Fingerprint( ZONE_CONTAINER* aZone )
+    {
+        MD5_HASH hash;
+        uint64_t settingsHash = m_settingsHash;
+        int      biggest_clearance = m_board->GetDesignSettings().GetBiggestClearanceValue();
+        BOX2I    zoneBB = aZone->GetBoundingBox();
+
+        hash.Hash( (uint8_t*) &settingsHash, sizeof( settingsHash ) );
+
+        auto hashItem =
+                [&]( BOARD_ITEM* aItem )
+                {
+                    const std::string& text = description( aItem );
+                    hash.Hash( (uint8_t*) text.data(), text.size() );
+                };
+
+        auto hashIfNear =
+                [&]( BOARD_ITEM* aItem )
+                {
+                    BOX2I area;
+
+                    if( isOnEdgeCuts( aItem )
+                            || ( getInfluenceArea( aZone, aItem, biggest_clearance, area )
+                                 && area.Intersects( zoneBB ) ) )
+                    {
+                        hashItem( aItem );
+                    }
+                };
+
+        hashItem( aZone );
+
+        for( MODULE* module : m_board->Modules() )
+            hashIfNear( module );
+
+        for( TRACK* track : m_board->Tracks() )
+            hashIfNear( track );
+
+        for( BOARD_ITEM* item : m_board->Drawings() )
+            hashIfNear( item );
+
+        for( ZONE_CONTAINER* zone : m_board->Zones() )
+        {
+            if( zone != aZone )
+                hashIfNear( zone );
+        }
+
+        hash.Finalize();
+        return hash.Format();
+    }
+
+    /**
+     * Forget the item descriptions, which must be done once the items are changed (a zone
+     * is described with its fill state).
+     */
+    void ClearCache()
+    {
+        m_descriptions.clear();
+    }
+
+private:
+    const std::string& description( BOARD_ITEM* aItem )
+    {
+        auto it = m_descriptions.find( aItem );
+
+        if( it == m_descriptions.end() )
+        {
+            Format( aItem );
+            it = m_descriptions.emplace( aItem, GetStringOutput( true ) ).first;
+        }
+
+        return it->second;
+    }
+
+    size_t                                        m_settingsHash;
+    std::unordered_map<BOARD_ITEM*, std::string>  m_descriptions;
+};
+
+
+/**
+ * The pads of the board which can be connected to zones, indexed by net, so that a zone only
+ * visits the pads of its net which are near it.  Also holds the bounding box of each pad at
+ * the orientation of its thermal spokes, which is the same for every zone.
+ *
+ * Built before the fill threads are started; the queries only read the index.
+ */
+class THERMAL_PAD_INDEX
+{
+public:
+    struct ENTRY
+    {
+        D_PAD* m_pad;
+        int    m_index;         // order of the pad on the board
+        BOX2I  m_bbox;          // bounding box of the pad
+        BOX2I  m_spokeFrameBB;  // bounding box of the pad unrotated, at position (0, 0)
+    };
+
+    THERMAL_PAD_INDEX( BOARD* aBoard ) :
+            m_maxPadGap( 0 )
+    {
+        for( MODULE* module : aBoard->Modules() )
+        {
+            for( D_PAD* pad : module->Pads() )
+            {
+                if( pad->GetNetCode() <= 0 )
+                    continue;
+
+                ENTRY entry;
+                entry.m_pad = pad;
+                entry.m_index = (int) m_entries.size();
+                entry.m_bbox = pad->GetBoundingBox();
+
+                // The spokes are laid out with the bounding box of the pad built at the same
+                // rotation as the spokes
+                wxPoint padPos = pad->GetPosition();
+                double  padAngle = pad->GetOrientation();
+                pad->SetOrientation( 0.0 );
+                pad->SetPosition( { 0, 0 } );
+                entry.m_spokeFrameBB = pad->GetBoundingBox();
+                pad->SetPosition( padPos );
+                pad->SetOrientation( padAngle );
+
+                m_entries.push_back( entry );
+                m_maxPadGap = std::max( m_maxPadGap, pad->GetThermalGap() );
+            }
+        }
+
+        for( const ENTRY& entry : m_entries )
+        {
+            std::unique_ptr<PAD_TREE>& tree = m_trees[ entry.m_pad->GetNetCode() ];
+
+            if( !tree )
+                tree = std::make_unique<PAD_TREE>();
+
+            const int mmin[2] = { entry.m_bbox.GetX(), entry.m_bbox.GetY() };
+            const int mmax[2] = { entry.m_bbox.GetRight(), entry.m_bbox.GetBottom() };
+            tree->Insert( mmin, mmax, &entry );
+        }
+    }
+
+    /**
+     * Returns the pads of a net whose thermal relief can reach aArea, that is the pads closer
+     * to it than their relief gap (aZoneGap unless the pad has its own).  The pads are sorted
+     * in board order, so that the fills do not depend on the layout of the index.
+     */
+    std::vector<const ENTRY*> Query( int aNetCode, const BOX2I& aArea, int aZoneGap ) const
+    {
+        std::vector<const ENTRY*> found;
+        auto                      it = m_trees.find( aNetCode );
+
+        if( it == m_trees.end() )
+            return found;
+
+        BOX2I area = aArea;
+        area.Inflate( std::max( aZoneGap, m_maxPadGap ) );
+
+        const int mmin[2] = { area.GetX(), area.GetY() };
+        const int mmax[2] = { area.GetRight(), area.GetBottom() };
+
+        it->second->Search( mmin, mmax,
+                            [&]( const ENTRY* aEntry ) -> bool
+                            {
+                                found.push_back( aEntry );
+                                return true;
+                            } );
+
+        std::sort( found.begin(), found.end(),
+                   []( const ENTRY* aLeft, const ENTRY* aRight )
+                   {
+                       return aLeft->m_index < aRight->m_index;
+                   } );
+
+        return found;
+    }
+
+private:
+    using PAD_TREE = RTree<const ENTRY*, int, 2, double>;
+
+    std::deque<ENTRY>                                  m_entries;
+    std::unordered_map<int, std::unique_ptr<PAD_TREE>> m_trees;
+    int                                                m_maxPadGap;  // biggest pad relief gap
+};
+
+
 bool ZONE_FILLER::Fill( const std::vector<ZONE_CONTAINER*>& aZones, bool aCheck )
 {
+    TRACE_SCOPE trace( "zone-fill" );
+
     std::vector<CN_ZONE_ISOLATED_ISLAND_LIST> toFill;
+    std::vector<ZONE_REFILL> refills;
     auto connectivity = m_board->GetConnectivity();
     bool filledPolyWithOutline = not m_board->GetDesignSettings().m_ZoneUseNoOutlineInFill;
+    size_t settingsHash = FillSettingsHash();
 
     std::unique_lock<std::mutex> lock( connectivity->GetLock(), std::try_to_lock );
 
     if( !lock )
         return false;
 
+    // The knockouts are shared by the zones of this fill.  They are kept for the next fills
+    // only when the board changes are tracked, as for the dirty regions.  A check builds them
+    // all again.
+    ZONE_KNOCKOUT_CACHE fillKnockoutCache;
+    m_knockoutCache = m_incremental && !aCheck ? m_board->GetZoneKnockoutCache().get()
+                                               : &fillKnockoutCache;
+
     if( m_progressReporter )
-    {
         m_progressReporter->Report( aCheck ? _( "Checking zone fills..." ) : _( "Building zone fills..." ) );
-        m_progressReporter->SetMaxProgress( toFill.size() );
-    }
 
     // The board outlines is used to clip solid areas inside the board (when outlines are valid)
     m_boardOutline.RemoveAllContours();
     m_brdOutlinesValid = m_board->GetBoardPolygonOutlines( m_boardOutline );
 
+    // A check trusts the fills whose inputs are unchanged since they were saved, usually the
+    // fills of a board just loaded.  This must be done before any zone is unfilled.
+    FILL_FINGERPRINTER          fingerprinter( m_board, settingsHash );
+    std::set<ZONE_CONTAINER*>   upToDate;
+
+    if( aCheck )
+    {
+        for( ZONE_CONTAINER* zone : aZones )
+        {
+            if( zone->GetIsKeepout()
+                    || ( zone->IsFilled() && !zone->GetFillFingerprint().empty()
+                         && zone->GetFillFingerprint() == fingerprinter.Fingerprint( zone ) ) )
+            {
+                upToDate.insert( zone );
+            }
+        }
+
+        if( upToDate.size() == aZones.size() )
+        {
+            m_knockoutCache = nullptr;
+            return true;
+        }
+    }
+
     for( auto zone : aZones )
     {
         // Keepout zones are not filled
-        if( zone->GetIsKeepout() )
+        if( zone->GetIsKeepout() || upToDate.count( zone ) )
             continue;
 
         if( m_commit )
@@ -135,59 +492,185 @@ bool ZONE_FILLER::Fill( const std::vector<ZONE_CONTAINER*>& aZones, bool aCheck
         // Add the zone to the list of zones to test or refill
         toFill.emplace_back( CN_ZONE_ISOLATED_ISLAND_LIST(zone) );
 
+        // Hatched fills are built over the whole zone, and non-copper zones are cheap to
+        // fill, so only solid copper fills are refilled incrementally
+        ZONE_REFILL refill;
+        size_t      fillHash = 0;
+
+        // A check only trusts the fills whose fingerprint matches (see above): it must not
+        // depend on the dirty regions, so the other zones are compared with a full fill
+        refill.m_incremental = m_incremental && !aCheck && zone->IsOnCopperLayer()
+                               && zone->GetFillMode() == ZONE_FILL_MODE::POLYGONS
+                               && zone->GetDirtyRegion( refill.m_dirtyRegion, fillHash )
+                               && fillHash == settingsHash
+                               && !zone->RawPolysList().IsEmpty();
+
+        if( refill.m_incremental )
+            refill.m_previousFill = zone->RawPolysList();
+
+        refills.push_back( std::move( refill ) );
+
+        zone->SetFilledPolysUseThickness( filledPolyWithOutline );
+
         // Remove existing fill first to prevent drawing invalid polygons
         // on some platforms
         zone->UnFill();
     }
 
-    std::atomic<size_t> nextItem( 0 );
-    size_t              parallelThreadCount =
-            std::min<size_t>( std::thread::hardware_concurrency(), aZones.size() );
-    std::vector<std::future<size_t>> returns( parallelThreadCount );
+    THERMAL_PAD_INDEX thermalPads( m_board );
+    m_thermalPads = &thermalPads;
 
-    auto fill_lambda = [&] ( PROGRESS_REPORTER* aReporter ) -> size_t
+    // Split the large solid copper zones in tiles, so that a board with one large zone per
+    // layer is not filled on a single core.  Incremental refills are already limited to the
+    // dirty regions, and hatch patterns are laid out over the whole zone.
+    std::vector<FILL_JOB>                    jobs;
+    std::vector<std::vector<SHAPE_POLY_SET>> tileFills( toFill.size() );
+
+    for( size_t i = 0; i < toFill.size(); ++i )
     {
-        size_t num = 0;
+        ZONE_CONTAINER* zone = toFill[i].m_zone;
+        BOX2I           bbox = zone->GetBoundingBox();
+        int             cols = 1;
+        int             rows = 1;
 
-        for( size_t i = nextItem++; i < toFill.size(); i = nextItem++ )
+        if( !refills[i].m_incremental && zone->IsOnCopperLayer()
+                && zone->GetFillMode() == ZONE_FILL_MODE::POLYGONS )
         {
-            ZONE_CONTAINER* zone = toFill[i].m_zone;
-            zone->SetFilledPolysUseThickness( filledPolyWithOutline );
-            SHAPE_POLY_SET rawPolys, finalPolys;
-            fillSingleZone( zone, rawPolys, finalPolys );
+            // The outer tiles must hold the fill up to the zone outline
+            bbox.Inflate( zone->GetMinThickness() );
+
+            cols = ( bbox.GetWidth() + s_FillTileSize - 1 ) / s_FillTileSize;
+            rows = ( bbox.GetHeight() + s_FillTileSize - 1 ) / s_FillTileSize;
+        }
+
+        if( cols * rows <= 1 )
+        {
+            jobs.push_back( { i, -1, BOX2I() } );
+            continue;
+        }
+
+        tileFills[i].resize( cols * rows );
+
+        // Neighbouring tiles share their edges exactly
+        std::vector<int> xs( cols + 1 );
+        std::vector<int> ys( rows + 1 );
+
+        for( int col = 0; col <= cols; ++col )
+            xs[col] = bbox.GetX() + int( (int64_t) bbox.GetWidth() * col / cols );
+
+        for( int row = 0; row <= rows; ++row )
+            ys[row] = bbox.GetY() + int( (int64_t) bbox.GetHeight() * row / rows );
+
+        for( int row = 0; row < rows; ++row )
+        {
+            for( int col = 0; col < cols; ++col )
+            {
+                VECTOR2I start( xs[col], ys[row] );
+                VECTOR2I end( xs[col + 1], ys[row + 1] );
+
+                jobs.push_back( { i, row * cols + col, BOX2I( start, end - start ) } );
+            }
+        }
+    }
+
+    if( m_progressReporter )
+        m_progressReporter->SetMaxProgress( jobs.size() );
+
+    auto isCancelled =
+            [&]()
+            {
+                return m_cancelled && *m_cancelled;
+            };
+
+    auto giveUp =
+            [&]()
+            {
+                if( m_commit )
+                    m_commit->Revert();
+
+                connectivity->SetProgressReporter( nullptr );
+                m_knockoutCache = nullptr;
+                m_thermalPads = nullptr;
+                return false;
+            };
+
+    // Keep the progress dialog alive while the pool fills the zones
+    std::function<void()> keepRefreshing;
 
-            zone->SetRawPolysList( rawPolys );
-            zone->SetFilledPolysList( finalPolys );
-            zone->SetIsFilled( true );
+    if( m_progressReporter )
+        keepRefreshing = [&]() { m_progressReporter->KeepRefreshing(); };
+
+    auto fill_lambda = [&]( size_t i )
+    {
+        const FILL_JOB& job = jobs[i];
+        ZONE_CONTAINER* zone = toFill[job.m_zoneIndex].m_zone;
+
+        if( isCancelled() )
+            return;
+
+        if( job.m_tileIndex >= 0 )
+        {
+            fillRegion( zone, job.m_tile, tileFills[job.m_zoneIndex][job.m_tileIndex] );
 
             if( m_progressReporter )
                 m_progressReporter->AdvanceProgress();
 
-            num++;
+            return;
         }
 
-        return num;
+        SHAPE_POLY_SET rawPolys, finalPolys;
+        const ZONE_REFILL& refill = refills[job.m_zoneIndex];
+
+        if( !refill.m_incremental )
+        {
+            fillSingleZone( zone, rawPolys, finalPolys );
+        }
+        else if( refill.m_dirtyRegion.GetWidth() == 0 && refill.m_dirtyRegion.GetHeight() == 0 )
+        {
+            // Nothing changed near the zone since its last fill
+            rawPolys = refill.m_previousFill;
+            finalPolys = refill.m_previousFill;
+            zone->SetNeedRefill( false );
+        }
+        else
+        {
+            refillDirtyRegion( zone, refill.m_dirtyRegion, refill.m_previousFill, rawPolys,
+                               finalPolys );
+        }
+
+        zone->SetRawPolysList( rawPolys );
+        zone->SetFilledPolysList( finalPolys );
+        zone->SetIsFilled( true );
+
+        if( m_progressReporter )
+            m_progressReporter->AdvanceProgress();
     };
 
-    if( parallelThreadCount <= 1 )
-        fill_lambda( m_progressReporter );
-    else
+    THREAD_POOL::GetInstance().ParallelFor( jobs.size(), fill_lambda, keepRefreshing );
+
+    if( isCancelled() )
+        return giveUp();
+
+    // Merge the tiles of the large zones.  The tiles share their edges, so their union has
+    // no seams.
+    for( size_t i = 0; i < toFill.size(); ++i )
     {
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-            returns[ii] = std::async( std::launch::async, fill_lambda, m_progressReporter );
+        if( tileFills[i].empty() )
+            continue;
 
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-        {
-            // Here we balance returns with a 100ms timeout to allow UI updating
-            std::future_status status;
-            do
-            {
-                if( m_progressReporter )
-                    m_progressReporter->KeepRefreshing();
+        ZONE_CONTAINER* zone = toFill[i].m_zone;
+        SHAPE_POLY_SET  rawPolys;
 
-                status = returns[ii].wait_for( std::chrono::milliseconds( 100 ) );
-            } while( status != std::future_status::ready );
-        }
+        for( const SHAPE_POLY_SET& tileFill : tileFills[i] )
+            rawPolys.Append( tileFill );
+
+        rawPolys.Simplify( SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
+        rawPolys.Fracture( SHAPE_POLY_SET::PM_FAST );
+
+        zone->SetRawPolysList( rawPolys );
+        zone->SetFilledPolysList( rawPolys );
+        zone->SetIsFilled( true );
+        zone->SetNeedRefill( false );
     }
 
     // Now update the connectivity to check for copper islands
@@ -198,14 +681,27 @@ bool ZONE_FILLER::Fill( const std::vector<ZONE_CONTAINER*>& aZones, bool aCheck
         m_progressReporter->KeepRefreshing();
     }
 
+    PROF_COUNTER islandTimer;
+
     connectivity->SetProgressReporter( m_progressReporter );
     connectivity->FindIsolatedCopperIslands( toFill );
 
+    wxLogTrace( traceZoneFiller, "island detection of %d zones: %.1f ms",
+                (int) toFill.size(), islandTimer.msecs( true ) );
+
     // Now remove insulated copper islands and islands outside the board edge
     bool outOfDate = false;
 
+    std::shared_ptr<const POLY_SET_INDEX> boardOutlineIndex;
+
+    if( m_brdOutlinesValid )
+        boardOutlineIndex = m_boardOutline.GetIndex();
+
     for( auto& zone : toFill )
     {
+        wxLogTrace( traceZoneFiller, "%s: %d insulated islands", describeZone( zone.m_zone ),
+                    (int) zone.m_islands.size() );
+
         std::sort( zone.m_islands.begin(), zone.m_islands.end(), std::greater<int>() );
         SHAPE_POLY_SET poly = zone.m_zone->GetFilledPolysList();
 
@@ -232,7 +728,7 @@ bool ZONE_FILLER::Fill( const std::vector<ZONE_CONTAINER*>& aZones, bool aCheck
             for( int idx = 0; idx < poly.OutlineCount(); )
             {
                 if( poly.Polygon( idx ).empty() ||
-                    !m_boardOutline.Contains( poly.Polygon( idx ).front().CPoint( 0 ) ) )
+                    !boardOutlineIndex->Contains( poly.Polygon( idx ).front().CPoint( 0 ) ) )
                 {
                     poly.DeletePolygon( idx );
                 }
@@ -248,6 +744,11 @@ bool ZONE_FILLER::Fill( const std::vector<ZONE_CONTAINER*>& aZones, bool aCheck
             outOfDate = true;
     }
 
+    wxLogTrace( traceZoneFiller, "island removal: %.1f ms", islandTimer.msecs( true ) );
+
+    if( isCancelled() )
+        return giveUp();
+
     if( aCheck && outOfDate )
     {
         PROGRESS_REPORTER_HIDER raii( m_progressReporter );
@@ -258,13 +759,7 @@ bool ZONE_FILLER::Fill( const std::vector<ZONE_CONTAINER*>& aZones, bool aCheck
         dlg.DoNotShowCheckbox( __FILE__, __LINE__ );
 
         if( dlg.ShowModal() == wxID_CANCEL )
-        {
-            if( m_commit )
-                m_commit->Revert();
-
-            connectivity->SetProgressReporter( nullptr );
-            return false;
-        }
+            return giveUp();
     }
 
     if( m_progressReporter )
@@ -275,67 +770,422 @@ bool ZONE_FILLER::Fill( const std::vector<ZONE_CONTAINER*>& aZones, bool aCheck
     }
 
 
-    nextItem = 0;
+    THREAD_POOL::GetInstance().ParallelFor( toFill.size(),
+            [&]( size_t i )
+            {
+                if( isCancelled() )
+                    return;
+
+                toFill[i].m_zone->CacheTriangulation();
+
+                if( m_progressReporter )
+                    m_progressReporter->AdvanceProgress();
+            },
+            keepRefreshing );
+
+    if( isCancelled() )
+        return giveUp();
+
+    if( m_progressReporter )
+    {
+        m_progressReporter->AdvancePhase();
+        m_progressReporter->Report( _( "Committing changes..." ) );
+        m_progressReporter->KeepRefreshing();
+    }
+
+    connectivity->SetProgressReporter( nullptr );
+
+    if( m_commit )
+    {
+        m_commit->Push( _( "Fill Zone(s)" ), false );
+    }
+    else
+    {
+        for( auto& i : toFill )
+            connectivity->Update( i.m_zone );
+
+        connectivity->RecalculateRatsnest();
+    }
+
+    // Must follow the commit, which marks the zones it modifies as dirty
+    for( auto& i : toFill )
+        i.m_zone->SetFillUpToDate( settingsHash );
+
+    fingerprinter.ClearCache();
+
+    for( auto& i : toFill )
+        i.m_zone->SetFillFingerprint( fingerprinter.Fingerprint( i.m_zone ) );
+
+    m_knockoutCache = nullptr;
+    m_thermalPads = nullptr;
+    return true;
+}
+
+
+size_t ZONE_FILLER::FillSettingsHash() const
+{
+    BOARD_DESIGN_SETTINGS& bds = m_board->GetDesignSettings();
+    size_t                 hash = 0;
+
+    auto combine =
+            [&hash]( size_t aValue )
+            {
+                hash ^= aValue + 0x9e3779b9 + ( hash << 6 ) + ( hash >> 2 );
+            };
+
+    combine( std::hash<int>()( bds.m_MaxError ) );
+    combine( std::hash<bool>()( bds.m_ZoneUseNoOutlineInFill ) );
+    combine( std::hash<int>()( bds.GetBiggestClearanceValue() ) );
+    combine( std::hash<int>()( bds.GetDefault()->GetClearance() ) );
+
+    for( const auto& netclass : bds.m_NetClasses )
+    {
+        combine( std::hash<std::string>()( netclass.first.ToStdString() ) );
+        combine( std::hash<int>()( netclass.second->GetClearance() ) );
+        combine( std::hash<size_t>()( netclass.second->GetCount() ) );
+    }
+
+    for( const DRC_RULE* rule : bds.m_DRCRules )
+    {
+        combine( std::hash<std::string>()( rule->m_Name.ToStdString() ) );
+        combine( std::hash<int>()( rule->m_ConstraintFlags ) );
+        combine( std::hash<int>()( rule->m_Clearance.Min ) );
+    }
+
+    for( const DRC_SELECTOR* selector : bds.m_DRCRuleSelectors )
+    {
+        combine( std::hash<int>()( selector->m_Priority ) );
+        combine( std::hash<size_t>()( selector->m_MatchNetclasses.size() ) );
+        combine( std::hash<size_t>()( selector->m_MatchLayers.size() ) );
+
+        if( selector->m_Rule )
+            combine( std::hash<std::string>()( selector->m_Rule->m_Name.ToStdString() ) );
+    }
 
-    auto tri_lambda = [&] ( PROGRESS_REPORTER* aReporter ) -> size_t
+    return hash;
+}
+
+
+void ZONE_FILLER::AddDirtyItem( BOARD* aBoard, BOARD_ITEM* aItem )
+{
+    if( !aBoard || !aItem || aItem->Type() == PCB_MARKER_T )
+        return;
+
+    if( aItem->Type() == PCB_ZONE_AREA_T )
+        static_cast<ZONE_CONTAINER*>( aItem )->InvalidateDirtyRegion();
+
+    bool  onEdgeCuts = isOnEdgeCuts( aItem );
+    int   biggest_clearance = aBoard->GetDesignSettings().GetBiggestClearanceValue();
+
+    for( ZONE_CONTAINER* zone : aBoard->Zones() )
     {
-        size_t num = 0;
+        if( zone == aItem || zone->GetIsKeepout() )
+            continue;
 
-        for( size_t i = nextItem++; i < toFill.size(); i = nextItem++ )
+        if( onEdgeCuts )
         {
-            toFill[i].m_zone->CacheTriangulation();
-            num++;
+            zone->InvalidateDirtyRegion();
+            continue;
+        }
 
-            if( m_progressReporter )
-                m_progressReporter->AdvanceProgress();
+        BOX2I dirtyBB;
+
+        if( getInfluenceArea( zone, aItem, biggest_clearance, dirtyBB )
+                && dirtyBB.Intersects( zone->GetBoundingBox() ) )
+        {
+            zone->AddDirtyRegion( dirtyBB );
         }
+    }
+}
 
-        return num;
-    };
 
-    if( parallelThreadCount <= 1 )
-        tri_lambda( m_progressReporter );
-    else
+void ZONE_FILLER::InvalidateAllZones( BOARD* aBoard )
+{
+    if( !aBoard )
+        return;
+
+    for( ZONE_CONTAINER* zone : aBoard->Zones() )
+        zone->InvalidateDirtyRegion();
+
+    aBoard->GetZoneKnockoutCache()->Clear();
+}
+
+
+BACKGROUND_ZONE_FILLER::BACKGROUND_ZONE_FILLER( BOARD* aBoard ) :
+        m_board( aBoard ),
+        m_settingsHash( 0 ),
+        m_done( false ),
+        m_cancelled( false ),
+        m_filled( false )
+{
+}
+
+
+BACKGROUND_ZONE_FILLER::~BACKGROUND_ZONE_FILLER()
+{
+    Cancel();
+}
+
+
+std::vector<ZONE_CONTAINER*> BACKGROUND_ZONE_FILLER::GetOutOfDateZones() const
+{
+    std::vector<ZONE_CONTAINER*> outOfDate;
+    size_t                       settingsHash = ZONE_FILLER( m_board ).FillSettingsHash();
+
+    for( ZONE_CONTAINER* zone : m_board->Zones() )
     {
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-            returns[ii] = std::async( std::launch::async, tri_lambda, m_progressReporter );
+        BOX2I  dirtyRegion;
+        size_t fillHash = 0;
 
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+        if( zone->GetIsKeepout() || !zone->IsFilled() )
+            continue;
+
+        if( !zone->GetDirtyRegion( dirtyRegion, fillHash ) || fillHash != settingsHash
+                || dirtyRegion.GetWidth() || dirtyRegion.GetHeight() )
+        {
+            outOfDate.push_back( zone );
+        }
+    }
+
+    return outOfDate;
+}
+
+
+void BACKGROUND_ZONE_FILLER::buildSnapshot( const std::vector<ZONE_CONTAINER*>& aZones )
+{
+    TRACE_SCOPE trace( "zone-fill-snapshot" );
+
+    m_snapshot = std::make_unique<BOARD>();
+    m_zones.clear();
+
+    BOARD* snapshot = m_snapshot.get();
+
+    // The copies of the design settings share their netclasses: the snapshot gets its own
+    BOARD_DESIGN_SETTINGS    settings = m_board->GetDesignSettings();
+    std::vector<NETCLASSPTR> netclasses;
+
+    netclasses.push_back( std::make_shared<NETCLASS>( *settings.GetDefault() ) );
+
+    for( const auto& netclass : settings.m_NetClasses )
+        netclasses.push_back( std::make_shared<NETCLASS>( *netclass.second ) );
+
+    settings.m_NetClasses.Clear();
+
+    for( const NETCLASSPTR& netclass : netclasses )
+        settings.m_NetClasses.Add( netclass );
+
+    snapshot->SetDesignSettings( settings );
+
+    NETCLASSES& snapshotNetclasses = snapshot->GetDesignSettings().m_NetClasses;
+
+    // The net codes of the snapshot are consecutive, which they usually already are.  The nets
+    // keep their netclass, so that FillSettingsHash() is the same for the snapshot.
+    std::map<int, int> netCodes;
+
+    for( NETINFO_ITEM* net : m_board->GetNetInfo() )
+    {
+        if( net->GetNet() > 0 )
+        {
+            NETINFO_ITEM* copy = new NETINFO_ITEM( snapshot, net->GetNetname(), net->GetNet() );
+            NETCLASSPTR   netclass = snapshotNetclasses.Find( net->GetClassName() );
+
+            copy->SetClass( netclass ? netclass : snapshotNetclasses.GetDefault() );
+            snapshot->Add( copy );
+            netCodes[net->GetNet()] = copy->GetNet();
+        }
+    }
+
+    auto setNet =
+            [&]( BOARD_CONNECTED_ITEM* aItem )
+            {
+                auto code = netCodes.find( aItem->GetNetCode() );
+                aItem->SetNetCode( code != netCodes.end() ? code->second : 0, true );
+            };
+
+    // Take the same items as the fingerprints of the fills, in the same order (the items are
+    // appended), so that the fingerprints built in the snapshot are those of the board
+    int biggest_clearance = settings.GetBiggestClearanceValue();
+
+    auto copyIfNear =
+            [&]( BOARD_ITEM* aItem, bool aFilled )
+            {
+                BOX2I area;
+                bool  isNear = aFilled || isOnEdgeCuts( aItem );
+
+                for( size_t ii = 0; !isNear && ii < aZones.size(); ++ii )
+                {
+                    isNear = getInfluenceArea( aZones[ii], aItem, biggest_clearance, area )
+                             && area.Intersects( aZones[ii]->GetBoundingBox() );
+                }
+
+                if( !isNear )
+                    return (BOARD_ITEM*) nullptr;
+
+                BOARD_ITEM* copy = static_cast<BOARD_ITEM*>( aItem->Clone() );
+
+                // The nets are those of the snapshot once the copy belongs to it
+                copy->SetParent( snapshot );
+
+                if( copy->Type() == PCB_MODULE_T )
+                {
+                    for( D_PAD* pad : static_cast<MODULE*>( copy )->Pads() )
+                        setNet( pad );
+
+                    for( MODULE_ZONE_CONTAINER* zone : static_cast<MODULE*>( copy )->Zones() )
+                        setNet( zone );
+                }
+                else if( copy->IsConnected() )
+                {
+                    setNet( static_cast<BOARD_CONNECTED_ITEM*>( copy ) );
+                }
+
+                snapshot->Add( copy, ADD_MODE::APPEND );
+                return copy;
+            };
+
+    for( MODULE* module : m_board->Modules() )
+        copyIfNear( module, false );
+
+    for( TRACK* track : m_board->Tracks() )
+        copyIfNear( track, false );
+
+    for( BOARD_ITEM* item : m_board->Drawings() )
+        copyIfNear( item, false );
+
+    for( ZONE_CONTAINER* zone : m_board->Zones() )
+    {
+        bool filled = std::find( aZones.begin(), aZones.end(), zone ) != aZones.end();
+        auto copy = static_cast<ZONE_CONTAINER*>( copyIfNear( zone, filled ) );
+
+        if( filled )
+        {
+            // The raw fill and the dirty region are not copied with the zone
+            copy->CopyFill( *zone );
+            m_zones.push_back( { zone, zone->m_Uuid, zone->GetFillInputsRevision(), copy } );
+        }
+    }
+
+    m_settingsHash = ZONE_FILLER( m_board ).FillSettingsHash();
+}
+
+
+void BACKGROUND_ZONE_FILLER::Start( const std::vector<ZONE_CONTAINER*>& aZones )
+{
+    wxCHECK_RET( !IsRunning(), "a background zone fill is already running" );
+
+    buildSnapshot( aZones );
+
+    m_cancelled = false;
+    m_filled = false;
+    m_done = false;
+    m_error = nullptr;
+
+    std::vector<ZONE_CONTAINER*> toFill;
+
+    for( const SNAPSHOT_ZONE& zone : m_zones )
+        toFill.push_back( zone.m_copy );
+
+    BOARD* snapshot = m_snapshot.get();
+
+    m_thread = std::thread(
+            [this, snapshot, toFill]()
+            {
+                try
+                {
+                    snapshot->BuildConnectivity();
+
+                    ZONE_FILLER filler( snapshot );
+                    filler.SetIncremental( true );
+                    filler.SetCancelFlag( &m_cancelled );
+
+                    m_filled = filler.Fill( toFill );
+                }
+                catch( ... )
+                {
+                    m_error = std::current_exception();
+                }
+
+                m_done = true;
+            } );
+}
+
+
+bool BACKGROUND_ZONE_FILLER::IsDone() const
+{
+    return m_thread.joinable() && m_done;
+}
+
+
+std::vector<ZONE_CONTAINER*> BACKGROUND_ZONE_FILLER::Apply( int& aDiscarded )
+{
+    std::vector<ZONE_CONTAINER*> filled;
+
+    aDiscarded = 0;
+
+    if( !m_thread.joinable() )
+        return filled;
+
+    m_thread.join();
+
+    if( m_error )
+    {
+        try
+        {
+            std::rethrow_exception( m_error );
+        }
+        catch( const std::exception& e )
+        {
+            wxLogTrace( traceZoneFiller, "background fill failed: %s", e.what() );
+        }
+        catch( ... )
+        {
+        }
+
+        m_filled = false;
+    }
+
+    // A change of the settings changes all the fills
+    bool current = m_filled && m_settingsHash == ZONE_FILLER( m_board ).FillSettingsHash();
+
+    for( const SNAPSHOT_ZONE& zone : m_zones )
+    {
+        const auto& zones = m_board->Zones();
+
+        // The zone may have been deleted, or changed since the snapshot
+        if( current && std::find( zones.begin(), zones.end(), zone.m_zone ) != zones.end()
+                && zone.m_zone->m_Uuid == zone.m_uuid
+                && zone.m_zone->GetFillInputsRevision() == zone.m_revision )
+        {
+            zone.m_zone->CopyFill( *zone.m_copy );
+            zone.m_zone->SetFillUpToDate( m_settingsHash );
+            filled.push_back( zone.m_zone );
+        }
+        else
         {
-            // Here we balance returns with a 100ms timeout to allow UI updating
-            std::future_status status;
-            do
-            {
-                if( m_progressReporter )
-                    m_progressReporter->KeepRefreshing();
-
-                status = returns[ii].wait_for( std::chrono::milliseconds( 100 ) );
-            } while( status != std::future_status::ready );
+            aDiscarded++;
         }
     }
 
-    if( m_progressReporter )
-    {
-        m_progressReporter->AdvancePhase();
-        m_progressReporter->Report( _( "Committing changes..." ) );
-        m_progressReporter->KeepRefreshing();
-    }
+    wxLogTrace( traceZoneFiller, "background fill: %d zones filled, %d discarded",
+                (int) filled.size(), aDiscarded );
 
-    connectivity->SetProgressReporter( nullptr );
+    m_snapshot.reset();
+    m_zones.clear();
 
-    if( m_commit )
-    {
-        m_commit->Push( _( "Fill Zone(s)" ), false );
-    }
-    else
-    {
-        for( auto& i : toFill )
-            connectivity->Update( i.m_zone );
+    return filled;
+}
 
-        connectivity->RecalculateRatsnest();
-    }
 
-    return true;
+void BACKGROUND_ZONE_FILLER::Cancel()
+{
+    if( !m_thread.joinable() )
+        return;
+
+    m_cancelled = true;
+    m_thread.join();
+
+    m_snapshot.reset();
+    m_zones.clear();
 }
 
 
@@ -392,12 +1242,10 @@ void ZONE_FILLER::addKnockout( D_PAD* aPad, int aGap, SHAPE_POLY_SET& aHoles )
     if( aPad->GetShape() == PAD_SHAPE_CUSTOM )
     {
         // the pad shape in zone can be its convex hull or the shape itself
-        SHAPE_POLY_SET outline( aPad->GetCustomShapeAsPolygon() );
+        SHAPE_POLY_SET outline = aPad->GetBoardPolygon();
         int numSegs = std::max( GetArcToSegmentCount( aGap, m_high_def, 360.0 ), 6 );
         double correction = GetCircletoPolyCorrectionFactor( numSegs );
         outline.Inflate( KiROUND( aGap * correction ), numSegs );
-        aPad->CustomShapeAsPolygonToBoardPosition( &outline, aPad->GetPosition(),
-                                                   aPad->GetOrientation() );
 
         if( aPad->GetCustomShapeInZoneOpt() == CUST_PAD_SHAPE_IN_ZONE_CONVEXHULL )
         {
@@ -468,11 +1316,37 @@ void ZONE_FILLER::addKnockout( BOARD_ITEM* aItem, int aGap, bool aIgnoreLineWidt
 }
 
 
+/**
+ * Add the knockout of an item from the knockout cache, building and caching it first if
+ * needed.  aKey is the board item the knockout is cached for.
+ */
+void ZONE_FILLER::addCachedKnockout( const BOARD_ITEM* aKey, int aGap, int aFlags,
+                                     const std::function<void( SHAPE_POLY_SET& )>& aBuild,
+                                     SHAPE_POLY_SET& aHoles )
+{
+    if( !m_knockoutCache )
+    {
+        aBuild( aHoles );
+        return;
+    }
+
+    if( m_knockoutCache->Append( aKey, aGap, m_high_def, aFlags, aHoles ) )
+        return;
+
+    SHAPE_POLY_SET knockout;
+    aBuild( knockout );
+
+    m_knockoutCache->Add( aKey, aGap, m_high_def, aFlags, knockout );
+    aHoles.Append( knockout );
+}
+
+
 /**
  * Removes thermal reliefs from the shape for any pads connected to the zone.  Does NOT add
  * in spokes, which must be done later.
  */
-void ZONE_FILLER::knockoutThermalReliefs( const ZONE_CONTAINER* aZone, SHAPE_POLY_SET& aFill )
+void ZONE_FILLER::knockoutThermalReliefs( const ZONE_CONTAINER* aZone, const BOX2I* aClipArea,
+                                          SHAPE_POLY_SET& aFill )
 {
     SHAPE_POLY_SET holes;
 
@@ -482,27 +1356,48 @@ void ZONE_FILLER::knockoutThermalReliefs( const ZONE_CONTAINER* aZone, SHAPE_POL
     // data, etc.
     MODULE  dummymodule( m_board );
     D_PAD   dummypad( &dummymodule );
+    BOX2I   area = aClipArea ? *aClipArea : BOX2I( aZone->GetBoundingBox() );
 
-    for( auto module : m_board->Modules() )
+    for( const THERMAL_PAD_INDEX::ENTRY* entry :
+            m_thermalPads->Query( aZone->GetNetCode(), area, aZone->GetThermalReliefGap() ) )
     {
-        for( auto pad : module->Pads() )
+        D_PAD* pad = entry->m_pad;
+
+        if( !hasThermalConnection( pad, aZone ) )
+            continue;
+
+        if( aClipArea )
         {
-            if( !hasThermalConnection( pad, aZone ) )
+            BOX2I reliefBB = entry->m_bbox;
+            reliefBB.Inflate( aZone->GetThermalReliefGap( pad ) );
+
+            if( !reliefBB.Intersects( *aClipArea ) )
                 continue;
+        }
 
-            // If the pad isn't on the current layer but has a hole, knock out a thermal relief
-            // for the hole.
-            if( !pad->IsOnLayer( aZone->GetLayer() ) )
-            {
-                if( pad->GetDrillSize().x == 0 && pad->GetDrillSize().y == 0 )
-                    continue;
+        D_PAD* knockoutPad = pad;
+        int    flags = 0;
 
-                setupDummyPadForHole( pad, dummypad );
-                pad = &dummypad;
-            }
+        // If the pad isn't on the current layer but has a hole, knock out a thermal relief
+        // for the hole.
+        if( !pad->IsOnLayer( aZone->GetLayer() ) )
+        {
+            if( pad->GetDrillSize().x == 0 && pad->GetDrillSize().y == 0 )
+                continue;
 
-            addKnockout( pad, aZone->GetThermalReliefGap( pad ), holes );
+            setupDummyPadForHole( pad, dummypad );
+            knockoutPad = &dummypad;
+            flags = ZONE_KNOCKOUT_CACHE::PAD_HOLE;
         }
+
+        int gap = aZone->GetThermalReliefGap( knockoutPad );
+
+        addCachedKnockout( pad, gap, flags,
+                           [&]( SHAPE_POLY_SET& aKnockout )
+                           {
+                               addKnockout( knockoutPad, gap, aKnockout );
+                           },
+                           holes );
     }
 
     holes.Simplify( SHAPE_POLY_SET::PM_FAST );
@@ -514,7 +1409,8 @@ void ZONE_FILLER::knockoutThermalReliefs( const ZONE_CONTAINER* aZone, SHAPE_POL
  * Removes clearance from the shape for copper items which share the zone's layer but are
  * not connected to it.
  */
-void ZONE_FILLER::buildCopperItemClearances( const ZONE_CONTAINER* aZone, SHAPE_POLY_SET& aHoles )
+void ZONE_FILLER::buildCopperItemClearances( const ZONE_CONTAINER* aZone, const BOX2I* aClipArea,
+                                             SHAPE_POLY_SET& aHoles )
 {
     static DRAWSEGMENT dummyEdge;
     dummyEdge.SetLayer( Edge_Cuts );
@@ -529,6 +1425,12 @@ void ZONE_FILLER::buildCopperItemClearances( const ZONE_CONTAINER* aZone, SHAPE_
     int                    zone_clearance = aZone->GetLocalClearance();
     EDA_RECT               zone_boundingbox = aZone->GetBoundingBox();
 
+    if( aClipArea )
+    {
+        zone_boundingbox = EDA_RECT( wxPoint( aClipArea->GetPosition() ),
+                                     wxSize( aClipArea->GetSize() ) );
+    }
+
     // items outside the zone bounding box are skipped, so it needs to be inflated by
     // the largest clearance value found in the netclasses and rules
     int biggest_clearance = std::max( zone_clearance, bds.GetBiggestClearanceValue() );
@@ -545,8 +1447,11 @@ void ZONE_FILLER::buildCopperItemClearances( const ZONE_CONTAINER* aZone, SHAPE_
     //
     for( auto module : m_board->Modules() )
     {
-        for( auto pad : module->Pads() )
+        for( auto boardPad : module->Pads() )
         {
+            D_PAD* pad = boardPad;
+            int    flags = 0;
+
             if( !pad->IsOnLayer( aZone->GetLayer() ) )
             {
                 if( pad->GetDrillSize().x == 0 && pad->GetDrillSize().y == 0 )
@@ -554,6 +1459,7 @@ void ZONE_FILLER::buildCopperItemClearances( const ZONE_CONTAINER* aZone, SHAPE_
 
                 setupDummyPadForHole( pad, dummypad );
                 pad = &dummypad;
+                flags = ZONE_KNOCKOUT_CACHE::PAD_HOLE;
             }
 
             if( pad->GetNetCode() != aZone->GetNetCode() || pad->GetNetCode() <= 0
@@ -570,7 +1476,12 @@ void ZONE_FILLER::buildCopperItemClearances( const ZONE_CONTAINER* aZone, SHAPE_
                     else
                         gap = aZone->GetClearance( pad );
 
-                    addKnockout( pad, gap, aHoles );
+                    addCachedKnockout( boardPad, gap, flags,
+                                       [&]( SHAPE_POLY_SET& aKnockout )
+                                       {
+                                           addKnockout( pad, gap, aKnockout );
+                                       },
+                                       aHoles );
                 }
             }
         }
@@ -590,7 +1501,13 @@ void ZONE_FILLER::buildCopperItemClearances( const ZONE_CONTAINER* aZone, SHAPE_
         {
             int gap = aZone->GetClearance( track ) + extra_margin;
 
-            track->TransformShapeWithClearanceToPolygon( aHoles, gap, m_low_def );
+            addCachedKnockout( track, gap, 0,
+                               [&]( SHAPE_POLY_SET& aKnockout )
+                               {
+                                   track->TransformShapeWithClearanceToPolygon( aKnockout, gap,
+                                                                                m_low_def );
+                               },
+                               aHoles );
         }
     }
 
@@ -608,8 +1525,14 @@ void ZONE_FILLER::buildCopperItemClearances( const ZONE_CONTAINER* aZone, SHAPE_
                 {
                     bool ignoreLineWidth = aItem->IsOnLayer( Edge_Cuts );
                     int  gap = aZone->GetClearance( aItem );
-
-                    addKnockout( aItem, gap, ignoreLineWidth, aHoles );
+                    int  flags = ignoreLineWidth ? ZONE_KNOCKOUT_CACHE::IGNORE_LINE_WIDTH : 0;
+
+                    addCachedKnockout( aItem, gap, flags,
+                                       [&]( SHAPE_POLY_SET& aKnockout )
+                                       {
+                                           addKnockout( aItem, gap, ignoreLineWidth, aKnockout );
+                                       },
+                                       aHoles );
                 }
             };
 
@@ -676,7 +1599,8 @@ void ZONE_FILLER::computeRawFilledArea( const ZONE_CONTAINER* aZone,
                                         const SHAPE_POLY_SET& aSmoothedOutline,
                                         std::set<VECTOR2I>* aPreserveCorners,
                                         SHAPE_POLY_SET& aRawPolys,
-                                        SHAPE_POLY_SET& aFinalPolys )
+                                        SHAPE_POLY_SET& aFinalPolys,
+                                        const BOX2I* aClipArea )
 {
     m_high_def = m_board->GetDesignSettings().m_MaxError;
     m_low_def = std::min( ARC_LOW_DEF, int( m_high_def*1.5 ) );   // Reasonable value
@@ -708,22 +1632,31 @@ void ZONE_FILLER::computeRawFilledArea( const ZONE_CONTAINER* aZone,
     std::unique_ptr<SHAPE_FILE_IO> dumper( new SHAPE_FILE_IO(
                     s_DumpZonesWhenFilling ? "zones_dump.txt" : "", SHAPE_FILE_IO::IOM_APPEND ) );
 
+    // Time the phases of the fill, to find the zones which are slow to fill (see
+    // traceZoneFiller).  The counter is read for each phase, so reading it is cheap.
+    PROF_COUNTER timer;
+    double       reliefTime, clearanceTime, spokeTime, spokeTestTime, knockoutTime;
+    double       minWidthTime, hatchTime, fractureTime;
+
     aRawPolys = aSmoothedOutline;
 
     if( s_DumpZonesWhenFilling )
         dumper->BeginGroup( "clipper-zone" );
 
-    knockoutThermalReliefs( aZone, aRawPolys );
+    knockoutThermalReliefs( aZone, aClipArea, aRawPolys );
+    reliefTime = timer.msecs( true );
 
     if( s_DumpZonesWhenFilling )
         dumper->Write( &aRawPolys, "solid-areas-minus-thermal-reliefs" );
 
-    buildCopperItemClearances( aZone, clearanceHoles );
+    buildCopperItemClearances( aZone, aClipArea, clearanceHoles );
+    clearanceTime = timer.msecs( true );
 
     if( s_DumpZonesWhenFilling )
         dumper->Write( &aRawPolys, "clearance holes" );
 
-    buildThermalSpokes( aZone, thermalSpokes );
+    buildThermalSpokes( aZone, aClipArea, thermalSpokes );
+    spokeTime = timer.msecs( true );
 
     // Create a temporary zone that we can hit-test spoke-ends against.  It's only temporary
     // because the "real" subtract-clearance-holes has to be done after the spokes are added.
@@ -734,36 +1667,68 @@ void ZONE_FILLER::computeRawFilledArea( const ZONE_CONTAINER* aZone,
     // Prune features that don't meet minimum-width criteria
     if( half_min_width - epsilon > epsilon )
     {
-        testAreas.Deflate( half_min_width - epsilon, numSegs, intermediatecornerStrategy );
-        testAreas.Inflate( half_min_width - epsilon, numSegs, intermediatecornerStrategy );
+        testAreas.Deflate( half_min_width - epsilon, numSegs, intermediatecornerStrategy,
+                           true );
+        testAreas.Inflate( half_min_width - epsilon, numSegs, intermediatecornerStrategy,
+                           true );
     }
 
-    // Spoke-end-testing is hugely expensive so we generate cached bounding-boxes to speed
-    // things up a bit.
-    testAreas.BuildBBoxCaches();
+    // Spoke-end-testing is hugely expensive, so all the spokes of the zone are tested in one
+    // go, against the containment index of the test areas as in the connectivity algorithm,
+    // and against the spokes found near their end by an R-tree.
+    using INDEX_TREE = RTree<int, int, 2, double>;
+
+    auto insertBox =
+            []( INDEX_TREE& aTree, const BOX2I& aBox, int aIndex )
+            {
+                const int mmin[2] = { aBox.GetX(), aBox.GetY() };
+                const int mmax[2] = { aBox.GetRight(), aBox.GetBottom() };
+                aTree.Insert( mmin, mmax, aIndex );
+            };
+
+    // Visits the items whose box is within 1 IU of aPt, while aVisitor returns true
+    auto searchPoint =
+            []( const INDEX_TREE& aTree, const VECTOR2I& aPt,
+                const std::function<bool( const int& )>& aVisitor )
+            {
+                const int mmin[2] = { aPt.x - 1, aPt.y - 1 };
+                const int mmax[2] = { aPt.x + 1, aPt.y + 1 };
+                aTree.Search( mmin, mmax, aVisitor );
+            };
+
+    std::shared_ptr<const POLY_SET_INDEX> testIndex = testAreas.GetIndex();
+    INDEX_TREE                            spokeTree;
+
+    for( size_t ii = 0; ii < thermalSpokes.size(); ii++ )
+        insertBox( spokeTree, thermalSpokes[ii].BBox(), (int) ii );
 
-    for( const SHAPE_LINE_CHAIN& spoke : thermalSpokes )
+    for( size_t ii = 0; ii < thermalSpokes.size(); ii++ )
     {
-        const VECTOR2I& testPt = spoke.CPoint( 3 );
+        const SHAPE_LINE_CHAIN& spoke = thermalSpokes[ii];
+        const VECTOR2I&         testPt = spoke.CPoint( 3 );
 
         // Hit-test against zone body
-        if( testAreas.Contains( testPt, -1, 1, USE_BBOX_CACHES ) )
-        {
-            aRawPolys.AddOutline( spoke );
-            continue;
-        }
+        bool connected = testIndex->Collide( testPt, 1 );
 
         // Hit-test against other spokes
-        for( const SHAPE_LINE_CHAIN& other : thermalSpokes )
+        if( !connected )
         {
-            if( &other != &spoke && other.PointInside( testPt, 1, USE_BBOX_CACHES  ) )
-            {
-                aRawPolys.AddOutline( spoke );
-                break;
-            }
+            searchPoint( spokeTree, testPt,
+                         [&]( const int& aIndex ) -> bool
+                         {
+                             connected = aIndex != (int) ii
+                                         && thermalSpokes[aIndex].PointInside( testPt, 1,
+                                                                               USE_BBOX_CACHES );
+                             return !connected;
+                         } );
         }
+
+        if( connected )
+            aRawPolys.AddOutline( spoke );
     }
 
+    spokeTestTime = timer.msecs( true );
+
     // Ensure previous changes (adding thermal stubs) do not add
     // filled areas outside the zone boundary
     aRawPolys.BooleanIntersection( aSmoothedOutline, SHAPE_POLY_SET::PM_FAST );
@@ -773,9 +1738,14 @@ void ZONE_FILLER::computeRawFilledArea( const ZONE_CONTAINER* aZone,
         dumper->Write( &aRawPolys, "solid-areas-with-thermal-spokes" );
 
     aRawPolys.BooleanSubtract( clearanceHoles, SHAPE_POLY_SET::PM_FAST );
+    knockoutTime = timer.msecs( true );
+
     // Prune features that don't meet minimum-width criteria
     if( half_min_width - epsilon > epsilon )
-        aRawPolys.Deflate( half_min_width - epsilon, numSegs, intermediatecornerStrategy );
+        aRawPolys.Deflate( half_min_width - epsilon, numSegs, intermediatecornerStrategy,
+                           true );
+
+    minWidthTime = timer.msecs( true );
 
     if( s_DumpZonesWhenFilling )
         dumper->Write( &aRawPolys, "solid-areas-before-hatching" );
@@ -784,6 +1754,8 @@ void ZONE_FILLER::computeRawFilledArea( const ZONE_CONTAINER* aZone,
     if( aZone->GetFillMode() == ZONE_FILL_MODE::HATCH_PATTERN )
         addHatchFillTypeOnZone( aZone, aRawPolys );
 
+    hatchTime = timer.msecs( true );
+
     if( s_DumpZonesWhenFilling )
         dumper->Write( &aRawPolys, "solid-areas-after-hatching" );
 
@@ -804,13 +1776,29 @@ void ZONE_FILLER::computeRawFilledArea( const ZONE_CONTAINER* aZone,
             aRawPolys.BooleanIntersection( aSmoothedOutline, SHAPE_POLY_SET::PM_FAST );
     }
 
+    minWidthTime += timer.msecs( true );
+
     aRawPolys.Fracture( SHAPE_POLY_SET::PM_FAST );
+    fractureTime = timer.msecs( true );
 
     if( s_DumpZonesWhenFilling )
         dumper->Write( &aRawPolys, "areas_fractured" );
 
     aFinalPolys = aRawPolys;
 
+    if( wxLog::IsAllowedTraceMask( traceZoneFiller ) )
+    {
+        wxLogTrace( traceZoneFiller,
+                    "%s: thermal reliefs %.1f ms, clearances %.1f ms (%d holes), "
+                    "thermal spokes %.1f ms (%d spokes), spoke tests %.1f ms, "
+                    "knockouts %.1f ms, min width %.1f ms, hatch %.1f ms, fracture %.1f ms, "
+                    "%d vertices (outline %d)",
+                    describeZone( aZone, aClipArea ), reliefTime, clearanceTime,
+                    clearanceHoles.OutlineCount(), spokeTime, (int) thermalSpokes.size(),
+                    spokeTestTime, knockoutTime, minWidthTime, hatchTime, fractureTime,
+                    aRawPolys.TotalVertices(), aSmoothedOutline.TotalVertices() );
+    }
+
     if( s_DumpZonesWhenFilling )
         dumper->EndGroup();
 }
@@ -824,6 +1812,8 @@ void ZONE_FILLER::computeRawFilledArea( const ZONE_CONTAINER* aZone,
 bool ZONE_FILLER::fillSingleZone( ZONE_CONTAINER* aZone, SHAPE_POLY_SET& aRawPolys,
                                   SHAPE_POLY_SET& aFinalPolys )
 {
+    TRACE_SCOPE trace( "zone-fill-single" );
+    PROF_COUNTER timer;
     SHAPE_POLY_SET smoothedPoly;
     std::set<VECTOR2I> colinearCorners;
     aZone->GetColinearCorners( m_board, colinearCorners );
@@ -836,6 +1826,8 @@ bool ZONE_FILLER::fillSingleZone( ZONE_CONTAINER* aZone, SHAPE_POLY_SET& aRawPol
     if ( !aZone->BuildSmoothedPoly( smoothedPoly, &colinearCorners ) )
         return false;
 
+    double smoothingTime = timer.msecs( true );
+
     if( aZone->IsOnCopperLayer() )
     {
         computeRawFilledArea( aZone, smoothedPoly, &colinearCorners, aRawPolys, aFinalPolys );
@@ -873,6 +1865,96 @@ bool ZONE_FILLER::fillSingleZone( ZONE_CONTAINER* aZone, SHAPE_POLY_SET& aRawPol
         aFinalPolys.Fracture( SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
     }
 
+    wxLogTrace( traceZoneFiller, "%s: outline smoothing %.1f ms, fill %.1f ms, %d vertices",
+                describeZone( aZone ), smoothingTime, timer.msecs( true ),
+                aFinalPolys.TotalVertices() );
+
+    aZone->SetNeedRefill( false );
+    return true;
+}
+
+
+static SHAPE_POLY_SET boxToPoly( const BOX2I& aBox )
+{
+    SHAPE_POLY_SET poly;
+
+    poly.NewOutline();
+    poly.Append( aBox.GetLeft(), aBox.GetTop() );
+    poly.Append( aBox.GetRight(), aBox.GetTop() );
+    poly.Append( aBox.GetRight(), aBox.GetBottom() );
+    poly.Append( aBox.GetLeft(), aBox.GetBottom() );
+
+    return poly;
+}
+
+
+bool ZONE_FILLER::fillRegion( ZONE_CONTAINER* aZone, const BOX2I& aRegion,
+                              SHAPE_POLY_SET& aFill )
+{
+    SHAPE_POLY_SET smoothedPoly;
+    std::set<VECTOR2I> colinearCorners;
+    aZone->GetColinearCorners( m_board, colinearCorners );
+
+    if ( !aZone->BuildSmoothedPoly( smoothedPoly, &colinearCorners ) )
+        return false;
+
+    // The fill inside the region depends on the items up to a clearance away from it, and
+    // the min width pruning is disturbed near the edges of the clipped outline.  The thermal
+    // spokes of the pads near the region are also hit-tested outside it.
+    int biggest_clearance = std::max( aZone->GetZoneClearance(),
+                                      m_board->GetDesignSettings().GetBiggestClearanceValue() );
+    int margin = 2 * aZone->GetMinThickness() + biggest_clearance;
+
+    BOX2I clipArea = aRegion;
+    clipArea.Inflate( margin );
+
+    for( auto module : m_board->Modules() )
+    {
+        for( auto pad : module->Pads() )
+        {
+            if( !hasThermalConnection( pad, aZone ) )
+                continue;
+
+            BOX2I reliefBB = pad->GetBoundingBox();
+            reliefBB.Inflate( aZone->GetThermalReliefGap( pad ) );
+
+            if( reliefBB.Intersects( aRegion ) )
+            {
+                reliefBB.Inflate( margin );
+                clipArea.Merge( reliefBB );
+            }
+        }
+    }
+
+    smoothedPoly.BooleanIntersection( boxToPoly( clipArea ), SHAPE_POLY_SET::PM_FAST );
+
+    SHAPE_POLY_SET finalPolys;
+
+    computeRawFilledArea( aZone, smoothedPoly, &colinearCorners, aFill, finalPolys,
+                          &clipArea );
+
+    aFill.BooleanIntersection( boxToPoly( aRegion ), SHAPE_POLY_SET::PM_FAST );
+    return true;
+}
+
+
+bool ZONE_FILLER::refillDirtyRegion( ZONE_CONTAINER* aZone, const BOX2I& aDirtyRegion,
+                                     const SHAPE_POLY_SET& aPreviousFill,
+                                     SHAPE_POLY_SET& aRawPolys, SHAPE_POLY_SET& aFinalPolys )
+{
+    SHAPE_POLY_SET dirtyFill;
+
+    if( !fillRegion( aZone, aDirtyRegion, dirtyFill ) )
+        return false;
+
+    // Splice the new fill of the dirty region into the previous fill
+    aRawPolys = aPreviousFill;
+    aRawPolys.BooleanSubtract( boxToPoly( aDirtyRegion ), SHAPE_POLY_SET::PM_FAST );
+    aRawPolys.BooleanAdd( dirtyFill, SHAPE_POLY_SET::PM_FAST );
+    aRawPolys.Fracture( SHAPE_POLY_SET::PM_FAST );
+
+    aFinalPolys = aRawPolys;
+
     aZone->SetNeedRefill( false );
     return true;
 }
@@ -881,10 +1963,10 @@ bool ZONE_FILLER::fillSingleZone( ZONE_CONTAINER* aZone, SHAPE_POLY_SET& aRawPol
 /**
  * Function buildThermalSpokes
  */
-void ZONE_FILLER::buildThermalSpokes( const ZONE_CONTAINER* aZone,
+void ZONE_FILLER::buildThermalSpokes( const ZONE_CONTAINER* aZone, const BOX2I* aClipArea,
                                       std::deque<SHAPE_LINE_CHAIN>& aSpokesList )
 {
-    auto zoneBB = aZone->GetBoundingBox();
+    BOX2I zoneBB = aClipArea ? *aClipArea : BOX2I( aZone->GetBoundingBox() );
     int  zone_clearance = aZone->GetZoneClearance();
     int  biggest_clearance = m_board->GetDesignSettings().GetBiggestClearanceValue();
     biggest_clearance = std::max( biggest_clearance, zone_clearance );
@@ -894,111 +1976,257 @@ void ZONE_FILLER::buildThermalSpokes( const ZONE_CONTAINER* aZone,
     // us avoid the question.
     int epsilon = KiROUND( IU_PER_MM * 0.04 );  // about 1.5 mil
 
-    for( auto module : m_board->Modules() )
+    // All the pads of the zone net near the zone, in one query
+    BOX2I queryArea = zoneBB;
+    queryArea.Inflate( epsilon );
+
+    for( const THERMAL_PAD_INDEX::ENTRY* entry :
+            m_thermalPads->Query( aZone->GetNetCode(), queryArea, aZone->GetThermalReliefGap() ) )
     {
-        for( auto pad : module->Pads() )
-        {
-            if( !hasThermalConnection( pad, aZone ) )
-                continue;
+        D_PAD* pad = entry->m_pad;
 
-            // We currently only connect to pads, not pad holes
-            if( !pad->IsOnLayer( aZone->GetLayer() ) )
-                continue;
+        if( !hasThermalConnection( pad, aZone ) )
+            continue;
 
-            int thermalReliefGap = aZone->GetThermalReliefGap( pad );
+        // We currently only connect to pads, not pad holes
+        if( !pad->IsOnLayer( aZone->GetLayer() ) )
+            continue;
 
-            // Calculate thermal bridge half width
-            int spoke_w = aZone->GetThermalReliefCopperBridge( pad );
-            // Avoid spoke_w bigger than the smaller pad size, because
-            // it is not possible to create stubs bigger than the pad.
-            // Possible refinement: have a separate size for vertical and horizontal stubs
-            spoke_w = std::min( spoke_w, pad->GetSize().x );
-            spoke_w = std::min( spoke_w, pad->GetSize().y );
+        int thermalReliefGap = aZone->GetThermalReliefGap( pad );
 
-            // Cannot create stubs having a width < zone min thickness
-            if( spoke_w <= aZone->GetMinThickness() )
-                continue;
+        // Calculate thermal bridge half width
+        int spoke_w = aZone->GetThermalReliefCopperBridge( pad );
+        // Avoid spoke_w bigger than the smaller pad size, because
+        // it is not possible to create stubs bigger than the pad.
+        // Possible refinement: have a separate size for vertical and horizontal stubs
+        spoke_w = std::min( spoke_w, pad->GetSize().x );
+        spoke_w = std::min( spoke_w, pad->GetSize().y );
 
-            int spoke_half_w = spoke_w / 2;
+        // Cannot create stubs having a width < zone min thickness
+        if( spoke_w <= aZone->GetMinThickness() )
+            continue;
 
-            // Quick test here to possibly save us some work
-            BOX2I itemBB = pad->GetBoundingBox();
-            itemBB.Inflate( thermalReliefGap + epsilon );
+        int spoke_half_w = spoke_w / 2;
 
-            if( !( itemBB.Intersects( zoneBB ) ) )
-                continue;
+        // Quick test here to possibly save us some work
+        BOX2I itemBB = entry->m_bbox;
+        itemBB.Inflate( thermalReliefGap + epsilon );
 
-            // Thermal spokes consist of segments from the pad center to points just outside
-            // the thermal relief.
-            //
-            // We use the bounding-box to lay out the spokes, but for this to work the
-            // bounding box has to be built at the same rotation as the spokes.
-
-            wxPoint shapePos = pad->ShapePos();
-            wxPoint padPos = pad->GetPosition();
-            double padAngle = pad->GetOrientation();
-            pad->SetOrientation( 0.0 );
-            pad->SetPosition( { 0, 0 } );
-            BOX2I reliefBB = pad->GetBoundingBox();
-            pad->SetPosition( padPos );
-            pad->SetOrientation( padAngle );
+        if( !( itemBB.Intersects( zoneBB ) ) )
+            continue;
+
+        // Thermal spokes consist of segments from the pad center to points just outside
+        // the thermal relief.
+        //
+        // We use the bounding-box to lay out the spokes, but for this to work the
+        // bounding box has to be built at the same rotation as the spokes.
+
+        wxPoint shapePos = pad->ShapePos();
+        double padAngle = pad->GetOrientation();
+        BOX2I reliefBB = entry->m_spokeFrameBB;
 
-            reliefBB.Inflate( thermalReliefGap + epsilon );
+        reliefBB.Inflate( thermalReliefGap + epsilon );
 
-            // For circle pads, the thermal spoke orientation is 45 deg
-            if( pad->GetShape() == PAD_SHAPE_CIRCLE )
-                padAngle = s_RoundPadThermalSpokeAngle;
+        // For circle pads, the thermal spoke orientation is 45 deg
+        if( pad->GetShape() == PAD_SHAPE_CIRCLE )
+            padAngle = s_RoundPadThermalSpokeAngle;
 
-            for( int i = 0; i < 4; i++ )
+        for( int i = 0; i < 4; i++ )
+        {
+            SHAPE_LINE_CHAIN spoke;
+            switch( i )
             {
-                SHAPE_LINE_CHAIN spoke;
-                switch( i )
-                {
-                case 0:       // lower stub
-                    spoke.Append( +spoke_half_w,       -spoke_half_w );
-                    spoke.Append( -spoke_half_w,       -spoke_half_w );
-                    spoke.Append( -spoke_half_w,       reliefBB.GetBottom() );
-                    spoke.Append( 0,                   reliefBB.GetBottom() );  // test pt
-                    spoke.Append( +spoke_half_w,       reliefBB.GetBottom() );
-                    break;
-
-                case 1:       // upper stub
-                    spoke.Append( +spoke_half_w,       spoke_half_w );
-                    spoke.Append( -spoke_half_w,       spoke_half_w );
-                    spoke.Append( -spoke_half_w,       reliefBB.GetTop() );
-                    spoke.Append( 0,                   reliefBB.GetTop() );     // test pt
-                    spoke.Append( +spoke_half_w,       reliefBB.GetTop() );
-                    break;
-
-                case 2:       // right stub
-                    spoke.Append( -spoke_half_w,       spoke_half_w );
-                    spoke.Append( -spoke_half_w,       -spoke_half_w );
-                    spoke.Append( reliefBB.GetRight(), -spoke_half_w );
-                    spoke.Append( reliefBB.GetRight(), 0 );                     // test pt
-                    spoke.Append( reliefBB.GetRight(), spoke_half_w );
-                    break;
-
-                case 3:       // left stub
-                    spoke.Append( spoke_half_w,        spoke_half_w );
-                    spoke.Append( spoke_half_w,        -spoke_half_w );
-                    spoke.Append( reliefBB.GetLeft(),  -spoke_half_w );
-                    spoke.Append( reliefBB.GetLeft(),  0 );                     // test pt
-                    spoke.Append( reliefBB.GetLeft(),  spoke_half_w );
-                    break;
-                }
+            case 0:       // lower stub
+                spoke.Append( +spoke_half_w,       -spoke_half_w );
+                spoke.Append( -spoke_half_w,       -spoke_half_w );
+                spoke.Append( -spoke_half_w,       reliefBB.GetBottom() );
+                spoke.Append( 0,                   reliefBB.GetBottom() );  // test pt
+                spoke.Append( +spoke_half_w,       reliefBB.GetBottom() );
+                break;
 
-                spoke.Rotate( -DECIDEG2RAD( padAngle ) );
-                spoke.Move( shapePos );
+            case 1:       // upper stub
+                spoke.Append( +spoke_half_w,       spoke_half_w );
+                spoke.Append( -spoke_half_w,       spoke_half_w );
+                spoke.Append( -spoke_half_w,       reliefBB.GetTop() );
+                spoke.Append( 0,                   reliefBB.GetTop() );     // test pt
+                spoke.Append( +spoke_half_w,       reliefBB.GetTop() );
+                break;
+
+            case 2:       // right stub
+                spoke.Append( -spoke_half_w,       spoke_half_w );
+                spoke.Append( -spoke_half_w,       -spoke_half_w );
+                spoke.Append( reliefBB.GetRight(), -spoke_half_w );
+                spoke.Append( reliefBB.GetRight(), 0 );                     // test pt
+                spoke.Append( reliefBB.GetRight(), spoke_half_w );
+                break;
 
-                spoke.SetClosed( true );
-                spoke.GenerateBBoxCache();
-                aSpokesList.push_back( std::move( spoke ) );
+            case 3:       // left stub
+                spoke.Append( spoke_half_w,        spoke_half_w );
+                spoke.Append( spoke_half_w,        -spoke_half_w );
+                spoke.Append( reliefBB.GetLeft(),  -spoke_half_w );
+                spoke.Append( reliefBB.GetLeft(),  0 );                     // test pt
+                spoke.Append( reliefBB.GetLeft(),  spoke_half_w );
+                break;
             }
-        }
+
+            spoke.Rotate( -DECIDEG2RAD( padAngle ) );
+            spoke.Move( shapePos );
+
+            spoke.SetClosed( true );
+            spoke.GenerateBBoxCache();
+            aSpokesList.push_back( std::move( spoke ) );
     }
 }
 
 
+/**
+ * Scans a polygon set row by row (from top to bottom) to classify the holes of a hatch
+ * pattern: the edges crossing each row give the parts of the row near the outlines, and
+ * the crossings of the middle of the row give which polygon contains a point of the row.
+ */
+class HATCH_ROW_SCANNER
+{
+public:
+    HATCH_ROW_SCANNER( const SHAPE_POLY_SET& aPolys ) :
+            m_next( 0 )
+    {
+        for( int ii = 0; ii < aPolys.OutlineCount(); ii++ )
+        {
+            for( const SHAPE_LINE_CHAIN& chain : aPolys.CPolygon( ii ) )
+            {
+                for( int jj = 0; jj < chain.SegmentCount(); jj++ )
+                    m_edges.push_back( { chain.CSegment( jj ), ii } );
+            }
+        }
+
+        std::sort( m_edges.begin(), m_edges.end(),
+                   []( const EDGE& aA, const EDGE& aB )
+                   {
+                       return std::min( aA.m_seg.A.y, aA.m_seg.B.y )
+                                < std::min( aB.m_seg.A.y, aB.m_seg.B.y );
+                   } );
+    }
+
+    /**
+     * Moves to the row between aTop and aBottom.  The parts of the row closer than aMargin
+     * to an edge are seen as near the outlines.
+     */
+    void SetRow( int aTop, int aBottom, int aMargin )
+    {
+        int top = aTop - aMargin;
+        int bottom = aBottom + aMargin;
+        int middle = aTop + ( aBottom - aTop ) / 2;
+
+        while( m_next < m_edges.size()
+                && std::min( m_edges[m_next].m_seg.A.y, m_edges[m_next].m_seg.B.y ) <= bottom )
+        {
+            m_active.push_back( &m_edges[m_next++] );
+        }
+
+        m_active.erase( std::remove_if( m_active.begin(), m_active.end(),
+                                        [top]( const EDGE* aEdge )
+                                        {
+                                            return std::max( aEdge->m_seg.A.y,
+                                                             aEdge->m_seg.B.y ) < top;
+                                        } ),
+                        m_active.end() );
+
+        m_nearOutlines.clear();
+        m_crossings.clear();
+
+        for( const EDGE* edge : m_active )
+        {
+            const VECTOR2I& a = edge->m_seg.A;
+            const VECTOR2I& b = edge->m_seg.B;
+
+            if( a.y == b.y )
+            {
+                m_nearOutlines.emplace_back( std::min( a.x, b.x ) - aMargin,
+                                             std::max( a.x, b.x ) + aMargin );
+                continue;
+            }
+
+            int x0 = xAt( a, b, std::max( top, std::min( a.y, b.y ) ) );
+            int x1 = xAt( a, b, std::min( bottom, std::max( a.y, b.y ) ) );
+
+            m_nearOutlines.emplace_back( std::min( x0, x1 ) - aMargin,
+                                         std::max( x0, x1 ) + aMargin );
+
+            if( std::min( a.y, b.y ) <= middle && middle < std::max( a.y, b.y ) )
+                m_crossings.emplace_back( xAt( a, b, middle ), edge->m_polygon );
+        }
+
+        std::sort( m_nearOutlines.begin(), m_nearOutlines.end() );
+        std::sort( m_crossings.begin(), m_crossings.end() );
+
+        // Merge the overlapping ranges, so that they can be searched
+        size_t count = 0;
+
+        for( const std::pair<int, int>& range : m_nearOutlines )
+        {
+            if( count && range.first <= m_nearOutlines[count - 1].second )
+                m_nearOutlines[count - 1].second = std::max( m_nearOutlines[count - 1].second,
+                                                             range.second );
+            else
+                m_nearOutlines[count++] = range;
+        }
+
+        m_nearOutlines.resize( count );
+    }
+
+    /**
+     * @return true if a part of the row between aLeft and aRight is near the outlines
+     */
+    bool NearOutlines( int aLeft, int aRight ) const
+    {
+        // The first range ending after aLeft
+        auto it = std::lower_bound( m_nearOutlines.begin(), m_nearOutlines.end(), aLeft,
+                                    []( const std::pair<int, int>& aRange, int aX )
+                                    {
+                                        return aRange.second < aX;
+                                    } );
+
+        return it != m_nearOutlines.end() && it->first <= aRight;
+    }
+
+    /**
+     * @return the index of the polygon containing the point aX of the middle of the row,
+     * or -1 if the point is outside the polygons.
+     */
+    int PolygonAt( int aX ) const
+    {
+        auto it = std::lower_bound( m_crossings.begin(), m_crossings.end(),
+                                    std::make_pair( aX, -1 ) );
+        size_t count = it - m_crossings.begin();
+
+        // Polygons don't overlap, so the edge crossed last to reach aX belongs to the polygon
+        // containing it (as its outline or one of its holes)
+        if( count % 2 == 0 )
+            return -1;
+
+        return m_crossings[count - 1].second;
+    }
+
+private:
+    struct EDGE
+    {
+        SEG m_seg;
+        int m_polygon;
+    };
+
+    static int xAt( const VECTOR2I& aA, const VECTOR2I& aB, int aY )
+    {
+        return aA.x + int( (int64_t) ( aY - aA.y ) * ( aB.x - aA.x ) / ( aB.y - aA.y ) );
+    }
+
+    std::vector<EDGE>                m_edges;
+    size_t                           m_next;
+    std::vector<const EDGE*>         m_active;
+    std::vector<std::pair<int, int>> m_nearOutlines;
+    std::vector<std::pair<int, int>> m_crossings;      // x and polygon index
+};
+
+
 void ZONE_FILLER::addHatchFillTypeOnZone( const ZONE_CONTAINER* aZone, SHAPE_POLY_SET& aRawPolys )
 {
     // Build grid:
@@ -1097,35 +2325,50 @@ void ZONE_FILLER::addHatchFillTypeOnZone( const ZONE_CONTAINER* aZone, SHAPE_POL
         }
     }
 
-    // Build holes
-    SHAPE_POLY_SET holes;
+    // Clamp holes to the area of filled zones with a outline thickness
+    // > aZone->GetMinThickness() to be sure the thermal pads can be built
+    int outline_margin = std::max( (aZone->GetMinThickness()*10)/9, linethickness/2 );
 
-    for( int xx = 0; ; xx++ )
+    // Build holes, row by row.  Most of the holes are far enough inside the filled areas to
+    // be used as they are: only the holes near the outlines are clamped by a boolean
+    // operation, and the others are added directly to the polygon containing them.
+    SHAPE_POLY_SET        holes;
+    std::vector<VECTOR2I> innerHoles;
+    HATCH_ROW_SCANNER     scanner( filledPolys );
+
+    for( int yy = 0; ; yy++ )
     {
-        int xpos = xx * gridsize;
+        int ypos = yy * gridsize;
 
-        if( xpos > bbox.GetWidth() )
+        if( ypos > bbox.GetHeight() )
             break;
 
-        for( int yy = 0; ; yy++ )
+        ypos += bbox.GetY();
+        scanner.SetRow( ypos, ypos + hole_size, outline_margin );
+
+        for( int xx = 0; ; xx++ )
         {
-            int ypos = yy * gridsize;
+            int xpos = xx * gridsize;
 
-            if( ypos > bbox.GetHeight() )
+            if( xpos > bbox.GetWidth() )
                 break;
 
-            // Generate hole
-            SHAPE_LINE_CHAIN hole( hole_base );
-            hole.Move( VECTOR2I( xpos, ypos ) );
-            holes.AddOutline( hole );
+            xpos += bbox.GetX();
+
+            if( scanner.NearOutlines( xpos, xpos + hole_size ) )
+            {
+                // Generate hole
+                SHAPE_LINE_CHAIN hole( hole_base );
+                hole.Move( VECTOR2I( xpos, ypos ) );
+                holes.AddOutline( hole );
+            }
+            else if( scanner.PolygonAt( xpos + hole_size / 2 ) >= 0 )
+            {
+                innerHoles.emplace_back( xpos, ypos );
+            }
         }
     }
 
-    holes.Move( bbox.GetPosition() );
-
-    // Clamp holes to the area of filled zones with a outline thickness
-    // > aZone->GetMinThickness() to be sure the thermal pads can be built
-    int outline_margin = std::max( (aZone->GetMinThickness()*10)/9, linethickness/2 );
     filledPolys.Deflate( outline_margin, 16 );
     holes.BooleanIntersection( filledPolys, SHAPE_POLY_SET::PM_FAST );
 
@@ -1147,4 +2390,43 @@ void ZONE_FILLER::addHatchFillTypeOnZone( const ZONE_CONTAINER* aZone, SHAPE_POL
     // create grid. Use SHAPE_POLY_SET::PM_STRICTLY_SIMPLE to
     // generate strictly simple polygons needed by Gerber files and Fracture()
     aRawPolys.BooleanSubtract( aRawPolys, holes, SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
+
+    if( innerHoles.empty() )
+        return;
+
+    // Find the polygon containing each inner hole (the polygons may have been split by the
+    // holes near the outlines), in the frame of the pattern
+    SHAPE_POLY_SET scannedPolys = aRawPolys;
+
+    if( orientation != 0.0 )
+        scannedPolys.Rotate( M_PI/180.0 * orientation, VECTOR2I( 0,0 ) );
+
+    HATCH_ROW_SCANNER polygonScanner( scannedPolys );
+    int               row = std::numeric_limits<int>::min();
+
+    for( const VECTOR2I& pos : innerHoles )
+    {
+        if( pos.y != row )
+        {
+            row = pos.y;
+            polygonScanner.SetRow( row, row + hole_size, 0 );
+        }
+
+        int polygon = polygonScanner.PolygonAt( pos.x + hole_size / 2 );
+
+        if( polygon < 0 )
+            continue;
+
+        SHAPE_LINE_CHAIN hole( hole_base );
+        hole.Move( pos );
+
+        if( orientation != 0.0 )
+            hole.Rotate( -M_PI/180.0 * orientation, VECTOR2I( 0,0 ) );
+
+        // Holes wind opposite to their outline
+        if( ( hole.Area() > 0 ) == ( aRawPolys.COutline( polygon ).Area() > 0 ) )
+            hole = hole.Reverse();
+
+        aRawPolys.AddHole( hole, polygon );
+    }
 }
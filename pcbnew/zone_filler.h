@@ -26,6 +26,11 @@
 #ifndef __ZONE_FILLER_H
 #define __ZONE_FILLER_H
 
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <thread>
 #include <vector>
 #include <class_zone.h>
 
@@ -34,6 +39,8 @@ class BOARD;
 class COMMIT;
 class SHAPE_POLY_SET;
 class SHAPE_LINE_CHAIN;
+class ZONE_KNOCKOUT_CACHE;
+class THERMAL_PAD_INDEX;
 
 
 class ZONE_FILLER
@@ -45,15 +52,68 @@ public:
     void InstallNewProgressReporter( wxWindow* aParent, const wxString& aTitle, int aNumPhases );
     bool Fill( const std::vector<ZONE_CONTAINER*>& aZones, bool aCheck = false );
 
+    /**
+     * Allows Fill() to refill only the dirty region of the zones (see
+     * ZONE_CONTAINER::AddDirtyRegion()) and to keep the fill of the zones which have not
+     * changed.  Ignored by a check (aCheck = true), which refills every zone whose fill
+     * fingerprint doesn't match in full.
+     * This relies on all board changes since the last fill having gone through a
+     * BOARD_COMMIT, or having invalidated the zones (see InvalidateAllZones()).
+     */
+    void SetIncremental( bool aIncremental ) { m_incremental = aIncremental; }
+
+    /**
+     * Makes Fill() give up and return false once aCancelled is set, which is tested between
+     * the fill jobs.  The zones being filled are left unfilled then (the commit, if any, is
+     * reverted).  For the fills run in background tasks.
+     */
+    void SetCancelFlag( const std::atomic<bool>* aCancelled ) { m_cancelled = aCancelled; }
+
+    /**
+     * Returns a hash of the board settings the fills depend on, which are not tracked in
+     * the dirty regions of the zones (clearances, netclasses, rules and arc precision).
+     */
+    size_t FillSettingsHash() const;
+
+    /**
+     * Adds the area of the zone fills affected by a change of aItem to the dirty regions of
+     * the zones of aBoard.  Called by BOARD_COMMIT for each changed item (and for the copy of
+     * modified items, to cover their previous position).
+     */
+    static void AddDirtyItem( BOARD* aBoard, BOARD_ITEM* aItem );
+
+    /**
+     * Marks the whole fill of every zone of aBoard as out of date, and forgets the cached
+     * knockouts.  For the board changes which don't go through a BOARD_COMMIT, and so don't
+     * record the dirty regions (see PCB_EDIT_FRAME::OnModify()).
+     */
+    static void InvalidateAllZones( BOARD* aBoard );
+
 private:
 
     void addKnockout( D_PAD* aPad, int aGap, SHAPE_POLY_SET& aHoles );
 
     void addKnockout( BOARD_ITEM* aItem, int aGap, bool aIgnoreLineWidth, SHAPE_POLY_SET& aHoles );
 
-    void knockoutThermalReliefs( const ZONE_CONTAINER* aZone, SHAPE_POLY_SET& aFill );
+    /**
+     * Appends the knockout of aKey built by aBuild for the clearance aGap to aHoles, going
+     * through the knockout cache (see ZONE_KNOCKOUT_CACHE::FLAGS for aFlags).
+     */
+    void addCachedKnockout( const BOARD_ITEM* aKey, int aGap, int aFlags,
+                            const std::function<void( SHAPE_POLY_SET& )>& aBuild,
+                            SHAPE_POLY_SET& aHoles );
 
-    void buildCopperItemClearances( const ZONE_CONTAINER* aZone, SHAPE_POLY_SET& aHoles );
+    /**
+     * @param aClipArea if not null, only the items touching this area are knocked out
+     */
+    void knockoutThermalReliefs( const ZONE_CONTAINER* aZone, const BOX2I* aClipArea,
+                                 SHAPE_POLY_SET& aFill );
+
+    /**
+     * @param aClipArea if not null, only the items touching this area are knocked out
+     */
+    void buildCopperItemClearances( const ZONE_CONTAINER* aZone, const BOX2I* aClipArea,
+                                    SHAPE_POLY_SET& aHoles );
 
     /**
      * Function computeRawFilledArea
@@ -65,17 +125,22 @@ private:
      * BuildFilledSolidAreasPolygons() call this function just after creating the
      *  filled copper area polygon (without clearance areas
      * @param aPcb: the current board
+     * @param aClipArea if not null, aSmoothedOutline has been clipped to this area, and only
+     * the items touching it are taken into account
      */
     void computeRawFilledArea( const ZONE_CONTAINER* aZone,
                                const SHAPE_POLY_SET& aSmoothedOutline,
                                std::set<VECTOR2I>* aPreserveCorners,
-                               SHAPE_POLY_SET& aRawPolys, SHAPE_POLY_SET& aFinalPolys );
+                               SHAPE_POLY_SET& aRawPolys, SHAPE_POLY_SET& aFinalPolys,
+                               const BOX2I* aClipArea = nullptr );
 
     /**
      * Function buildThermalSpokes
      * Constructs a list of all thermal spokes for the given zone.
+     * @param aClipArea if not null, only the pads touching this area get spokes
      */
-    void buildThermalSpokes( const ZONE_CONTAINER* aZone, std::deque<SHAPE_LINE_CHAIN>& aSpokes );
+    void buildThermalSpokes( const ZONE_CONTAINER* aZone, const BOX2I* aClipArea,
+                             std::deque<SHAPE_LINE_CHAIN>& aSpokes );
 
     /**
      * Build the filled solid areas polygons from zone outlines (stored in m_Poly)
@@ -94,6 +159,23 @@ private:
     bool fillSingleZone( ZONE_CONTAINER* aZone, SHAPE_POLY_SET& aRawPolys,
                          SHAPE_POLY_SET& aFinalPolys );
 
+    /**
+     * Computes the raw fill of a copper zone inside aRegion only.  The fill is computed over
+     * a slightly larger area so that the edges of that area don't change the result inside
+     * aRegion.
+     * @return true if OK, false if the solid polygons cannot be built
+     */
+    bool fillRegion( ZONE_CONTAINER* aZone, const BOX2I& aRegion, SHAPE_POLY_SET& aFill );
+
+    /**
+     * Recomputes the fill of a copper zone inside aDirtyRegion only, and splices it into
+     * the previous (raw) fill of the zone.
+     * @return true if OK, false if the solid polygons cannot be built
+     */
+    bool refillDirtyRegion( ZONE_CONTAINER* aZone, const BOX2I& aDirtyRegion,
+                            const SHAPE_POLY_SET& aPreviousFill, SHAPE_POLY_SET& aRawPolys,
+                            SHAPE_POLY_SET& aFinalPolys );
+
     /**
      * for zones having the ZONE_FILL_MODE::ZONE_FILL_MODE::HATCH_PATTERN, create a grid pattern
      * in filled areas of aZone, giving to the filled polygons a fill style like a grid
@@ -108,6 +190,10 @@ private:
     bool m_brdOutlinesValid;            // true if m_boardOutline can be calculated
                                         // false if not (not closed outlines for instance)
     COMMIT* m_commit;
+    bool m_incremental;                 // refill only the dirty regions of the zones
+    const std::atomic<bool>* m_cancelled;   // set to give up the fill, if not null
+    ZONE_KNOCKOUT_CACHE* m_knockoutCache;   // the item knockouts, during Fill() only
+    THERMAL_PAD_INDEX* m_thermalPads;       // the pads by net, during Fill() only
     WX_PROGRESS_REPORTER* m_progressReporter;
     std::unique_ptr<WX_PROGRESS_REPORTER> m_uniqueReporter;
 
@@ -121,4 +207,84 @@ private:
     int m_low_def;
 };
 
+
+/**
+ * BACKGROUND_ZONE_FILLER
+ * refills zones of a board in a background task, so that the zones can be kept filled while
+ * the board is edited.
+ *
+ * Start() copies the zones and the board items which can change their fill to a snapshot
+ * board, on the UI thread.  A ZONE_FILLER fills the zones of the snapshot on a thread of its
+ * own, incrementally when the board zones had a dirty region.  The fill is not a task of the
+ * thread pool (only its inner loops are), so no thread waiting for the pool can end up
+ * running the whole fill.  Once IsDone(), Apply() moves
+ * the fills into the board zones whose fill inputs have not changed since Start(); the other
+ * fills are discarded, and the zones are still out of date for the next Start().
+ *
+ * The fills are moved without a commit: they are not undoable, and do not make the zones
+ * around them dirty.
+ */
+class BACKGROUND_ZONE_FILLER
+{
+public:
+    BACKGROUND_ZONE_FILLER( BOARD* aBoard );
+
+    /// Cancels the fill in progress
+    ~BACKGROUND_ZONE_FILLER();
+
+    /**
+     * @return the filled zones of the board whose fill is out of date (see
+     * ZONE_CONTAINER::GetDirtyRegion())
+     */
+    std::vector<ZONE_CONTAINER*> GetOutOfDateZones() const;
+
+    /**
+     * Starts filling a snapshot of aZones in a background task.  Must not be called while a
+     * fill is running.
+     */
+    void Start( const std::vector<ZONE_CONTAINER*>& aZones );
+
+    /// @return true if a fill was started and not yet applied or cancelled
+    bool IsRunning() const { return m_thread.joinable(); }
+
+    /// @return true if the fill is started and done, so that Apply() does not wait for it
+    bool IsDone() const;
+
+    /**
+     * Moves the fills into the zones of the board whose fill inputs are unchanged since
+     * Start(), waiting for the fill to be done.  The connectivity and the view of the zones
+     * are left to the caller.
+     * @param aDiscarded [out] is the number of zones whose fill was out of date
+     * @return the zones of the board filled
+     */
+    std::vector<ZONE_CONTAINER*> Apply( int& aDiscarded );
+
+    /**
+     * Stops the fill in progress, and waits for the background thread to stop.
+     */
+    void Cancel();
+
+private:
+    /// A zone of the board, and its copy in the snapshot
+    struct SNAPSHOT_ZONE
+    {
+        ZONE_CONTAINER* m_zone;
+        KIID            m_uuid;
+        unsigned        m_revision;     // the fill inputs revision of m_zone in the snapshot
+        ZONE_CONTAINER* m_copy;
+    };
+
+    void buildSnapshot( const std::vector<ZONE_CONTAINER*>& aZones );
+
+    BOARD*                      m_board;
+    std::unique_ptr<BOARD>      m_snapshot;
+    std::vector<SNAPSHOT_ZONE>  m_zones;
+    size_t                      m_settingsHash; // the FillSettingsHash() of the board at Start()
+    std::thread                 m_thread;
+    std::exception_ptr          m_error;        // thrown by the fill, read once m_thread is joined
+    std::atomic<bool>           m_done;
+    std::atomic<bool>           m_cancelled;
+    std::atomic<bool>           m_filled;       // the snapshot fill has succeeded
+};
+
 #endif
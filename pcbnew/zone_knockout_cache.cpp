@@ -0,0 +1,265 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+
+#include <class_drawsegment.h>
+#include <class_module.h>
+#include <class_pad.h>
+#include <class_pcb_text.h>
+#include <class_text_mod.h>
+#include <class_track.h>
+
+#include <algorithm>
+#include <functional>
+
+#include "zone_knockout_cache.h"
+
+
+template <typename T>
+static inline void hashCombine( size_t& aSeed, const T& aValue )
+{
+    aSeed ^= std::hash<T>{}( aValue ) + 0x9e3779b9 + ( aSeed << 6 ) + ( aSeed >> 2 );
+}
+
+
+static inline void hashPoint( size_t& aSeed, const wxPoint& aPoint )
+{
+    hashCombine( aSeed, aPoint.x );
+    hashCombine( aSeed, aPoint.y );
+}
+
+
+static void hashPolygon( size_t& aSeed, const SHAPE_POLY_SET& aPolygon )
+{
+    for( auto it = aPolygon.CIterateWithHoles(); it; it++ )
+    {
+        hashCombine( aSeed, it->x );
+        hashCombine( aSeed, it->y );
+    }
+}
+
+
+static void hashText( size_t& aSeed, const EDA_TEXT* aText )
+{
+    hashCombine( aSeed, aText->GetText().ToStdString() );
+    hashPoint( aSeed, aText->GetTextPos() );
+    hashCombine( aSeed, aText->GetTextSize().x );
+    hashCombine( aSeed, aText->GetTextSize().y );
+    hashCombine( aSeed, aText->GetTextThickness() );
+    hashCombine( aSeed, aText->IsMirrored() );
+    hashCombine( aSeed, aText->IsItalic() );
+    hashCombine( aSeed, aText->IsBold() );
+    hashCombine( aSeed, aText->IsVisible() );
+    hashCombine( aSeed, aText->IsMultilineAllowed() );
+    hashCombine( aSeed, (int) aText->GetHorizJustify() );
+    hashCombine( aSeed, (int) aText->GetVertJustify() );
+}
+
+
+size_t ZONE_KNOCKOUT_CACHE::GeometryHash( const BOARD_ITEM* aItem )
+{
+    size_t ret = 0;
+
+    hashCombine( ret, (int) aItem->Type() );
+    hashCombine( ret, static_cast<const BASE_SET&>( aItem->GetLayerSet() ) );
+
+    switch( aItem->Type() )
+    {
+    case PCB_PAD_T:
+    {
+        const D_PAD* pad = static_cast<const D_PAD*>( aItem );
+
+        hashPoint( ret, pad->GetPosition() );
+        hashPoint( ret, pad->GetOffset() );
+        hashCombine( ret, pad->GetSize().x );
+        hashCombine( ret, pad->GetSize().y );
+        hashCombine( ret, pad->GetDelta().x );
+        hashCombine( ret, pad->GetDelta().y );
+        hashCombine( ret, pad->GetOrientation() );
+        hashCombine( ret, (int) pad->GetShape() );
+        hashCombine( ret, (int) pad->GetAnchorPadShape() );
+        hashCombine( ret, (int) pad->GetAttribute() );
+        hashCombine( ret, pad->GetDrillSize().x );
+        hashCombine( ret, pad->GetDrillSize().y );
+        hashCombine( ret, (int) pad->GetDrillShape() );
+        hashCombine( ret, pad->GetRoundRectRadiusRatio() );
+        hashCombine( ret, pad->GetChamferRectRatio() );
+        hashCombine( ret, pad->GetChamferPositions() );
+
+        if( pad->GetShape() == PAD_SHAPE_CUSTOM )
+            hashPolygon( ret, pad->GetCustomShapeAsPolygon() );
+
+        break;
+    }
+
+    case PCB_TRACE_T:
+    case PCB_VIA_T:
+    case PCB_ARC_T:
+    {
+        const TRACK* track = static_cast<const TRACK*>( aItem );
+
+        hashPoint( ret, track->GetStart() );
+        hashPoint( ret, track->GetEnd() );
+        hashCombine( ret, track->GetWidth() );
+
+        if( aItem->Type() == PCB_ARC_T )
+            hashPoint( ret, static_cast<const ARC*>( aItem )->GetMid() );
+        else if( aItem->Type() == PCB_VIA_T )
+            hashCombine( ret, static_cast<const VIA*>( aItem )->GetDrillValue() );
+
+        break;
+    }
+
+    case PCB_LINE_T:
+    case PCB_MODULE_EDGE_T:
+    {
+        const DRAWSEGMENT* segment = static_cast<const DRAWSEGMENT*>( aItem );
+
+        hashCombine( ret, (int) segment->GetShape() );
+        hashPoint( ret, segment->GetStart() );
+        hashPoint( ret, segment->GetEnd() );
+        hashPoint( ret, segment->GetBezControl1() );
+        hashPoint( ret, segment->GetBezControl2() );
+        hashCombine( ret, segment->GetAngle() );
+        hashCombine( ret, segment->GetWidth() );
+
+        if( segment->GetShape() == S_POLYGON )
+        {
+            hashPolygon( ret, segment->GetPolyShape() );
+
+            // The polygon of a footprint graphic is relative to the footprint
+            if( const MODULE* module = segment->GetParentModule() )
+            {
+                hashPoint( ret, module->GetPosition() );
+                hashCombine( ret, module->GetOrientation() );
+            }
+        }
+
+        break;
+    }
+
+    case PCB_TEXT_T:
+        hashText( ret, static_cast<const TEXTE_PCB*>( aItem ) );
+        hashCombine( ret, static_cast<const TEXTE_PCB*>( aItem )->GetTextAngle() );
+        break;
+
+    case PCB_MODULE_TEXT_T:
+        hashText( ret, static_cast<const TEXTE_MODULE*>( aItem ) );
+        hashCombine( ret, static_cast<const TEXTE_MODULE*>( aItem )->GetDrawRotation() );
+        break;
+
+    default:
+    {
+        EDA_RECT bbox = aItem->GetBoundingBox();
+
+        hashPoint( ret, bbox.GetOrigin() );
+        hashPoint( ret, wxPoint( bbox.GetWidth(), bbox.GetHeight() ) );
+        break;
+    }
+    }
+
+    return ret;
+}
+
+
+bool ZONE_KNOCKOUT_CACHE::Append( const BOARD_ITEM* aItem, int aGap, int aMaxError, int aFlags,
+                                  SHAPE_POLY_SET& aHoles ) const
+{
+    std::lock_guard<std::mutex> lock( m_lock );
+
+    auto it = m_cache.find( aItem );
+
+    if( it == m_cache.end() )
+        return false;
+
+    size_t geometryHash = GeometryHash( aItem );
+
+    for( const ENTRY& entry : it->second )
+    {
+        if( entry.m_geometryHash == geometryHash && entry.m_gap == aGap
+                && entry.m_maxError == aMaxError && entry.m_flags == aFlags )
+        {
+            aHoles.Append( entry.m_knockout );
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+void ZONE_KNOCKOUT_CACHE::Add( const BOARD_ITEM* aItem, int aGap, int aMaxError, int aFlags,
+                               const SHAPE_POLY_SET& aKnockout )
+{
+    std::lock_guard<std::mutex> lock( m_lock );
+
+    std::vector<ENTRY>& entries = m_cache[ aItem ];
+    size_t              geometryHash = GeometryHash( aItem );
+
+    // The knockouts of the item as it was before an in-place change are stale
+    entries.erase( std::remove_if( entries.begin(), entries.end(),
+                                   [&]( const ENTRY& aEntry )
+                                   {
+                                       return aEntry.m_geometryHash != geometryHash;
+                                   } ),
+                   entries.end() );
+
+    // Another fill thread may have built the same knockout in the meantime
+    for( const ENTRY& entry : entries )
+    {
+        if( entry.m_gap == aGap && entry.m_maxError == aMaxError && entry.m_flags == aFlags )
+            return;
+    }
+
+    entries.push_back( { geometryHash, aGap, aMaxError, aFlags, aKnockout } );
+}
+
+
+void ZONE_KNOCKOUT_CACHE::Invalidate( const BOARD_ITEM* aItem )
+{
+    std::lock_guard<std::mutex> lock( m_lock );
+
+    m_cache.erase( aItem );
+
+    if( aItem && aItem->Type() == PCB_MODULE_T )
+    {
+        const MODULE* module = static_cast<const MODULE*>( aItem );
+
+        m_cache.erase( &module->Reference() );
+        m_cache.erase( &module->Value() );
+
+        for( const D_PAD* pad : module->Pads() )
+            m_cache.erase( pad );
+
+        for( const BOARD_ITEM* item : module->GraphicalItems() )
+            m_cache.erase( item );
+    }
+}
+
+
+void ZONE_KNOCKOUT_CACHE::Clear()
+{
+    std::lock_guard<std::mutex> lock( m_lock );
+
+    m_cache.clear();
+}
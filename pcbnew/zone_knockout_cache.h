@@ -0,0 +1,100 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+
+#ifndef ZONE_KNOCKOUT_CACHE_H_
+#define ZONE_KNOCKOUT_CACHE_H_
+
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <geometry/shape_poly_set.h>
+
+class BOARD_ITEM;
+
+
+/**
+ * ZONE_KNOCKOUT_CACHE -
+ * Keeps the knockout polygons built by ZONE_FILLER for the board items, so that an item
+ * crossing several zones is only polygonized once for a given clearance, and so that a refill
+ * after a small edit only polygonizes the changed items.  The knockout shapes of the items
+ * don't depend on the layer of the zone, so the layer is not part of the key.
+ *
+ * Entries are keyed by the item pointer, and hold a hash of the item geometry (see
+ * GeometryHash()): an item changed in place without going through a BOARD_COMMIT misses, and
+ * its stale knockouts are replaced.  BOARD_COMMIT still invalidates the items it changes, and
+ * BOARD::Remove() the items removed from the board (their address may be reused).  The cache
+ * may be used by several zone fill threads at once.
+ */
+class ZONE_KNOCKOUT_CACHE
+{
+public:
+    enum FLAGS
+    {
+        IGNORE_LINE_WIDTH = 1,      ///< graphic item knocked out without its line width
+        PAD_HOLE          = 2       ///< hole of a pad which is not on the zone layer
+    };
+
+    /**
+     * Appends the cached knockout of aItem to aHoles.
+     * @return false if the knockout was not found in the cache
+     */
+    bool Append( const BOARD_ITEM* aItem, int aGap, int aMaxError, int aFlags,
+                 SHAPE_POLY_SET& aHoles ) const;
+
+    /**
+     * Stores the knockout of aItem for the given clearance, error and flags.
+     */
+    void Add( const BOARD_ITEM* aItem, int aGap, int aMaxError, int aFlags,
+              const SHAPE_POLY_SET& aKnockout );
+
+    /**
+     * Removes the knockouts of aItem (and of the pads and graphic items of a footprint).
+     */
+    void Invalidate( const BOARD_ITEM* aItem );
+
+    void Clear();
+
+    /**
+     * @return a hash of what the knockout of aItem is built from: its type, layers, position,
+     * orientation, size, shape and width (and the text of texts)
+     */
+    static size_t GeometryHash( const BOARD_ITEM* aItem );
+
+private:
+    struct ENTRY
+    {
+        size_t         m_geometryHash;
+        int            m_gap;
+        int            m_maxError;
+        int            m_flags;
+        SHAPE_POLY_SET m_knockout;
+    };
+
+    mutable std::mutex                                          m_lock;
+    std::unordered_map<const BOARD_ITEM*, std::vector<ENTRY>>   m_cache;
+};
+
+
+#endif /* ZONE_KNOCKOUT_CACHE_H_ */
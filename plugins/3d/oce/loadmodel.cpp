@@ -497,8 +497,17 @@ SCENEGRAPH* LoadModel( char const* filename )
     {
         TopoDS_Shape shape = data.m_assy->GetShape( frshapes.Value(id) );
 
-        if ( !shape.IsNull() && processNode( shape, data, data.scene, NULL ) )
-            ret = true;
+        if( !shape.IsNull() )
+        {
+            // mesh all the faces of the shape at once and in parallel; a face shared by
+            // several instances is only meshed once and processFace() then finds its
+            // triangulation instead of meshing the faces one by one
+            BRepMesh_IncrementalMesh mesh( shape, USER_PREC, Standard_False, USER_ANGLE,
+                                           Standard_True );
+
+            if( processNode( shape, data, data.scene, NULL ) )
+                ret = true;
+        }
 
         ++id;
     };
@@ -600,12 +609,16 @@ bool processSolid( const TopoDS_Shape& shape, DATA& data, SGNODE* parent,
     if( !partID.empty() )
         data.GetShape( partID, component );
 
+    // all the instances of a solid share its label; reuse the faces of the first one
+    // and only place them with this instance's transform
     if( component )
     {
         addItems( pptr, component );
 
         if( NULL != items )
             items->push_back( pptr );
+
+        return true;
     }
 
     // instantiate the solid
@@ -621,8 +634,14 @@ bool processSolid( const TopoDS_Shape& shape, DATA& data, SGNODE* parent,
 
     if( !ret )
         childNode.Destroy();
-    else if( NULL != items )
-        items->push_back( pptr );
+    else
+    {
+        if( !partID.empty() )
+            data.shapes.insert( NODEITEM( partID, itemList ) );
+
+        if( NULL != items )
+            items->push_back( pptr );
+    }
 
     return ret;
 }
@@ -875,6 +894,9 @@ bool processFace( const TopoDS_Face& face, DATA& data, SGNODE* parent,
     vface.CalcNormals( NULL );
     vshape.SetParent( parent );
 
+    if( NULL != items )
+        items->push_back( vshape.GetRawPtr() );
+
     if( !partID.empty() )
         data.faces.insert( std::pair< std::string,
             SGNODE* >( partID, vshape.GetRawPtr() ) );
@@ -896,6 +918,9 @@ bool processFace( const TopoDS_Face& face, DATA& data, SGNODE* parent,
         vface2.CalcNormals( NULL );
         vshape2.SetParent( parent );
 
+        if( NULL != items )
+            items->push_back( vshape2.GetRawPtr() );
+
         if( !partID.empty() )
             data.faces.insert( std::pair< std::string,
                 SGNODE* >( id2, vshape2.GetRawPtr() ) );
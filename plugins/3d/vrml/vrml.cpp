@@ -177,14 +177,15 @@ public:
 
 SCENEGRAPH* LoadVRML( const wxString& aFileName, bool useInline )
 {
-    FILE_LINE_READER* modelFile = NULL;
+    LINE_READER* modelFile = NULL;
     SCENEGRAPH* scene = NULL;
 
     try
     {
         // set the max char limit to 8MB; if a VRML file contains
-        // longer lines then perhaps it shouldn't be used
-        modelFile = new FILE_LINE_READER( aFileName, 0, 8388608 );
+        // longer lines then perhaps it shouldn't be used. The file is mapped
+        // rather than read so the large coordinate arrays are not copied around.
+        modelFile = new MAPPED_FILE_LINE_READER( aFileName, 0, 8388608 );
     }
     catch( IO_ERROR & )
     {
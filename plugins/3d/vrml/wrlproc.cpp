@@ -21,6 +21,9 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
  */
 
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
 #include <iostream>
 #include <sstream>
 #include <wx/filename.h>
@@ -179,6 +182,61 @@ bool WRLPROC::getRawLine( void )
 }
 
 
+static inline bool isNumberEnd( char aChar )
+{
+    return aChar <= 0x20 || ',' == aChar || '{' == aChar || '}' == aChar
+           || '[' == aChar || ']' == aChar;
+}
+
+
+bool WRLPROC::parseFloat( float& aValue )
+{
+    // the locale has been set to "C" by LoadVRML() so strtof() expects a '.'
+    const char* start = m_buf.c_str() + m_bufpos;
+    char*       end = nullptr;
+    float       value = strtof( start, &end );
+
+    if( end == start || !isNumberEnd( *end ) )
+        return false;
+
+    aValue = value;
+    m_bufpos += end - start;
+
+    // the comma is a special instance of blank space
+    if( ',' == *end )
+        ++m_bufpos;
+
+    return true;
+}
+
+
+bool WRLPROC::parseInt( int& aValue )
+{
+    const char* start = m_buf.c_str() + m_bufpos;
+    const char* digits = ( '-' == *start || '+' == *start ) ? start + 1 : start;
+    char*       end = nullptr;
+
+    // Rules: "0x" + "0-9, A-F" - VRML is case sensitive but in
+    // this instance we do no enforce case.
+    int base = ( '0' == digits[0] && ( 'x' == digits[1] || 'X' == digits[1] ) ) ? 16 : 10;
+
+    errno = 0;
+    long value = strtol( start, &end, base );
+
+    if( end == start || !isNumberEnd( *end ) || errno == ERANGE
+        || value < INT_MIN || value > INT_MAX )
+        return false;
+
+    aValue = (int) value;
+    m_bufpos += end - start;
+
+    if( ',' == *end )
+        ++m_bufpos;
+
+    return true;
+}
+
+
 bool WRLPROC::EatSpace( void )
 {
     if( !m_file )
@@ -811,26 +869,7 @@ bool WRLPROC::ReadSFFloat( float& aSFFloat )
             break;
     }
 
-    std::string tmp;
-
-    if( !ReadGlob( tmp ) )
-    {
-        std::ostringstream ostr;
-        ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
-        ostr << " * [INFO] failed on file '" << m_filename << "'\n";
-        ostr << " * [INFO] line " << fileline << ", char " << linepos << " -- ";
-        ostr << "line " << m_fileline << ", char " << m_bufpos << "\n";
-        ostr << " * [INFO] " << m_error;
-        m_error = ostr.str();
-
-        return false;
-    }
-
-    std::istringstream istr;
-    istr.str( tmp );
-    istr >> aSFFloat;
-
-    if( istr.fail() || !istr.eof() )
+    if( !parseFloat( aSFFloat ) )
     {
         std::ostringstream ostr;
         ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
@@ -871,36 +910,7 @@ bool WRLPROC::ReadSFInt( int& aSFInt32 )
             break;
     }
 
-    std::string tmp;
-
-    if( !ReadGlob( tmp ) )
-    {
-        std::ostringstream ostr;
-        ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
-        ostr << " * [INFO] failed on file '" << m_filename << "'\n";
-        ostr << " * [INFO] line " << fileline<< ", char " << linepos << " -- ";
-        ostr << "line " << m_fileline << ", char " << m_bufpos << "\n";
-        ostr << " * [INFO] " << m_error;
-        m_error = ostr.str();
-
-        return false;
-    }
-
-    if( std::string::npos != tmp.find( "0x" ) )
-    {
-        // Rules: "0x" + "0-9, A-F" - VRML is case sensitive but in
-        // this instance we do no enforce case.
-        std::stringstream sstr;
-        sstr << std::hex << tmp;
-        sstr >> aSFInt32;
-        return true;
-    }
-
-    std::istringstream istr;
-    istr.str( tmp );
-    istr >> aSFInt32;
-
-    if( istr.fail() || !istr.eof() )
+    if( !parseInt( aSFInt32 ) )
     {
         std::ostringstream ostr;
         ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
@@ -945,12 +955,11 @@ bool WRLPROC::ReadSFRotation( WRLROTATION& aSFRotation )
             break;
     }
 
-    std::string tmp;
     float trot[4];
 
     for( int i = 0; i < 4; ++i )
     {
-        if( !ReadGlob( tmp ) )
+        if( !EatSpace() )
         {
             std::ostringstream ostr;
             ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
@@ -963,11 +972,7 @@ bool WRLPROC::ReadSFRotation( WRLROTATION& aSFRotation )
             return false;
         }
 
-        std::istringstream istr;
-        istr.str( tmp );
-        istr >> trot[i];
-
-        if( istr.fail() || !istr.eof() )
+        if( !parseFloat( trot[i] ) )
         {
             std::ostringstream ostr;
             ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
@@ -1017,13 +1022,11 @@ bool WRLPROC::ReadSFVec2f( WRLVEC2F& aSFVec2f )
             break;
     }
 
-    std::string tmp;
-
     float tcol[2];
 
     for( int i = 0; i < 2; ++i )
     {
-        if( !ReadGlob( tmp ) )
+        if( !EatSpace() )
         {
             std::ostringstream ostr;
             ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
@@ -1036,11 +1039,7 @@ bool WRLPROC::ReadSFVec2f( WRLVEC2F& aSFVec2f )
             return false;
         }
 
-        std::istringstream istr;
-        istr.str( tmp );
-        istr >> tcol[i];
-
-        if( istr.fail() || !istr.eof() )
+        if( !parseFloat( tcol[i] ) )
         {
             std::ostringstream ostr;
             ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
@@ -1089,13 +1088,11 @@ bool WRLPROC::ReadSFVec3f( WRLVEC3F& aSFVec3f )
             break;
     }
 
-    std::string tmp;
-
     float tcol[3];
 
     for( int i = 0; i < 3; ++i )
     {
-        if( !ReadGlob( tmp ) )
+        if( !EatSpace() )
         {
             std::ostringstream ostr;
             ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
@@ -1108,18 +1105,7 @@ bool WRLPROC::ReadSFVec3f( WRLVEC3F& aSFVec3f )
             return false;
         }
 
-        // ignore any commas
-        if( !EatSpace() )
-            return false;
-
-        if( ',' == m_buf[m_bufpos] )
-            Pop();
-
-        std::istringstream istr;
-        istr.str( tmp );
-        istr >> tcol[i];
-
-        if( istr.fail() || !istr.eof() )
+        if( !parseFloat( tcol[i] ) )
         {
             std::ostringstream ostr;
             ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
@@ -1132,6 +1118,12 @@ bool WRLPROC::ReadSFVec3f( WRLVEC3F& aSFVec3f )
             return false;
         }
 
+        // ignore any commas
+        if( !EatSpace() )
+            return false;
+
+        if( ',' == m_buf[m_bufpos] )
+            Pop();
     }
 
     aSFVec3f.x = tcol[0];
@@ -1444,7 +1436,8 @@ bool WRLPROC::ReadMFFloat( std::vector< float >& aMFFloat )
         if( ']' == m_buf[m_bufpos] )
             break;
 
-        if( !ReadSFFloat( temp ) )
+        // the value is converted in place; ReadSFFloat() is only run again to report an error
+        if( !parseFloat( temp ) && !ReadSFFloat( temp ) )
         {
             std::ostringstream ostr;
             ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
@@ -1556,7 +1549,8 @@ bool WRLPROC::ReadMFInt( std::vector< int >& aMFInt32 )
         if( ']' == m_buf[m_bufpos] )
             break;
 
-        if( !ReadSFInt( temp ) )
+        // the value is converted in place; ReadSFInt() is only run again to report an error
+        if( !parseInt( temp ) && !ReadSFInt( temp ) )
         {
             std::ostringstream ostr;
             ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
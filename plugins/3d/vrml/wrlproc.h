@@ -58,6 +58,13 @@ private:
     // parameters are updated as appropriate.
     bool getRawLine( void );
 
+    // parseFloat and parseInt convert the number starting at m_bufpos in place, without
+    // copying it out of the buffer. The number must be followed by white space, a comma
+    // (which is consumed as in ReadGlob) or a brace or bracket; otherwise the functions
+    // return 'false' and leave m_bufpos unchanged.
+    bool parseFloat( float& aValue );
+    bool parseInt( int& aValue );
+
 public:
     WRLPROC( LINE_READER* aLineReader );
     ~WRLPROC();
@@ -0,0 +1,121 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <convert_basic_shapes_to_polygon.h>
+#include <geometry/approximation_cache.h>
+#include <geometry/shape_arc.h>
+#include <geometry/shape_line_chain.h>
+#include <geometry/shape_poly_set.h>
+
+
+BOOST_AUTO_TEST_SUITE( ApproximationCache )
+
+/**
+ * Checks that the cache builds each value once, and is emptied when full.
+ */
+BOOST_AUTO_TEST_CASE( Basic )
+{
+    APPROXIMATION_CACHE<2, int> cache( 3 );
+    int                         builds = 0;
+
+    auto build = [&]() { return ++builds; };
+
+    BOOST_CHECK_EQUAL( cache.Get( { 1, 2 }, build ), 1 );
+    BOOST_CHECK_EQUAL( cache.Get( { 1, 2 }, build ), 1 );
+    BOOST_CHECK_EQUAL( cache.Get( { 2, 1 }, build ), 2 );
+    BOOST_CHECK_EQUAL( cache.Get( { 1, cache.Bits( 0.5 ) }, build ), 3 );
+    BOOST_CHECK_EQUAL( cache.size(), 3 );
+
+    // Full: the cache is emptied before storing the new entry
+    BOOST_CHECK_EQUAL( cache.Get( { 3, 3 }, build ), 4 );
+    BOOST_CHECK_EQUAL( cache.size(), 1 );
+    BOOST_CHECK_EQUAL( cache.Get( { 1, 2 }, build ), 5 );
+}
+
+
+static bool sameVertices( const SHAPE_POLY_SET& aA, const SHAPE_POLY_SET& aB )
+{
+    if( aA.OutlineCount() != aB.OutlineCount() )
+        return false;
+
+    for( int i = 0; i < aA.OutlineCount(); i++ )
+    {
+        if( aA.COutline( i ) != aB.COutline( i ) )
+            return false;
+    }
+
+    return true;
+}
+
+
+/**
+ * Checks that the cached shapes are moved to the position of the shape being converted.
+ */
+BOOST_AUTO_TEST_CASE( TranslatedShapes )
+{
+    SHAPE_POLY_SET rect1, rect2;
+
+    TransformRoundChamferedRectToPolygon( rect1, wxPoint( 0, 0 ), wxSize( 1000, 600 ), 450.0,
+                                          100, 0.0, 0, 10 );
+    TransformRoundChamferedRectToPolygon( rect2, wxPoint( 5000, -3000 ), wxSize( 1000, 600 ),
+                                          450.0, 100, 0.0, 0, 10 );
+
+    rect1.Move( VECTOR2I( 5000, -3000 ) );
+    BOOST_CHECK( sameVertices( rect1, rect2 ) );
+
+    SHAPE_POLY_SET circle1, circle2;
+
+    TransformCircleToPolygon( circle1, wxPoint( 0, 0 ), 1000, 10 );
+    TransformCircleToPolygon( circle2, wxPoint( -700, 300 ), 1000, 10 );
+
+    circle1.Move( VECTOR2I( -700, 300 ) );
+    BOOST_CHECK( sameVertices( circle1, circle2 ) );
+
+    SHAPE_POLY_SET oval1, oval2;
+
+    // Reversed ends give the same oval
+    TransformOvalToPolygon( oval1, wxPoint( 0, 0 ), wxPoint( 2000, 500 ), 300, 10 );
+    TransformOvalToPolygon( oval2, wxPoint( 2000, 500 ), wxPoint( 0, 0 ), 300, 10 );
+
+    BOOST_CHECK( sameVertices( oval1, oval2 ) );
+}
+
+
+/**
+ * Checks that repeated arc conversions give the same polyline.
+ */
+BOOST_AUTO_TEST_CASE( ArcPolyline )
+{
+    SHAPE_ARC arc( VECTOR2I( 100, 100 ), VECTOR2I( 1100, 100 ), 90.0 );
+
+    const SHAPE_LINE_CHAIN first = arc.ConvertToPolyline( 5.0 );
+    const SHAPE_LINE_CHAIN coarse = arc.ConvertToPolyline( 50.0 );
+
+    BOOST_CHECK( !( arc.ConvertToPolyline( 5.0 ) != first ) );
+    BOOST_CHECK( !( arc.ConvertToPolyline( 50.0 ) != coarse ) );
+    BOOST_CHECK_GT( first.PointCount(), coarse.PointCount() );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
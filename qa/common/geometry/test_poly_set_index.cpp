@@ -0,0 +1,228 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <random>
+
+#include <geometry/poly_set_index.h>
+#include <geometry/shape_poly_set.h>
+
+
+BOOST_AUTO_TEST_SUITE( PolySetIndex )
+
+
+static SHAPE_LINE_CHAIN randomPolygon( std::mt19937& aRng, int aCenterX, int aCenterY,
+                                       int aRadius, int aCount )
+{
+    std::uniform_int_distribution<int> radius( aRadius / 3, aRadius );
+    SHAPE_LINE_CHAIN                   chain;
+
+    for( int i = 0; i < aCount; i++ )
+    {
+        double angle = 2 * M_PI * i / aCount;
+        int    r = radius( aRng );
+
+        chain.Append( aCenterX + (int) ( r * cos( angle ) ),
+                      aCenterY + (int) ( r * sin( angle ) ) );
+    }
+
+    chain.SetClosed( true );
+    return chain;
+}
+
+
+/**
+ * A set of several polygons with holes
+ */
+static SHAPE_POLY_SET makeTestSet( std::mt19937& aRng )
+{
+    SHAPE_POLY_SET set;
+    SHAPE_POLY_SET holes;
+
+    for( int i = 0; i < 4; i++ )
+        set.AddOutline( randomPolygon( aRng, i * 300000, ( i % 2 ) * 100000, 200000, 300 ) );
+
+    for( int i = 0; i < 8; i++ )
+        holes.AddOutline( randomPolygon( aRng, i * 150000, 20000, 40000, 50 ) );
+
+    set.Simplify( SHAPE_POLY_SET::PM_FAST );
+    set.BooleanSubtract( holes, SHAPE_POLY_SET::PM_FAST );
+
+    return set;
+}
+
+
+/**
+ * Points spread over the set, plus its vertices and points next to them
+ */
+static std::vector<VECTOR2I> testPoints( std::mt19937& aRng, const SHAPE_POLY_SET& aSet )
+{
+    BOX2I                              bbox = aSet.BBox( 1000 );
+    std::uniform_int_distribution<int> x( bbox.GetX(), bbox.GetRight() );
+    std::uniform_int_distribution<int> y( bbox.GetY(), bbox.GetBottom() );
+    std::uniform_int_distribution<int> offset( -3, 3 );
+    std::vector<VECTOR2I>              points;
+
+    for( int i = 0; i < 5000; i++ )
+        points.emplace_back( x( aRng ), y( aRng ) );
+
+    for( auto it = aSet.CIterateWithHoles(); it; it++ )
+    {
+        points.push_back( *it );
+        points.emplace_back( it->x + offset( aRng ), it->y + offset( aRng ) );
+    }
+
+    return points;
+}
+
+
+/**
+ * Checks the containment tests against SHAPE_POLY_SET::Contains().
+ */
+BOOST_AUTO_TEST_CASE( Contains )
+{
+    std::mt19937          rng( 7 );
+    SHAPE_POLY_SET        set = makeTestSet( rng );
+    POLY_SET_INDEX        index( set );
+    std::vector<VECTOR2I> points = testPoints( rng, set );
+
+    BOOST_REQUIRE( set.HoleCount( 0 ) > 0 || set.OutlineCount() > 4 );
+
+    for( int accuracy : { 0, 1, 5 } )
+    {
+        std::vector<bool> batch = index.ContainsPoints( points, -1, accuracy );
+
+        for( size_t i = 0; i < points.size(); i++ )
+        {
+            BOOST_CHECK_EQUAL( batch[i], set.Contains( points[i], -1, accuracy ) );
+
+            for( int poly = 0; poly < set.OutlineCount(); poly++ )
+            {
+                BOOST_CHECK_EQUAL( index.Contains( points[i], poly, accuracy ),
+                                   set.Contains( points[i], poly, accuracy ) );
+            }
+        }
+    }
+}
+
+
+/**
+ * Checks the clearance and crossing tests against a plain loop over the edges.
+ */
+BOOST_AUTO_TEST_CASE( CollideAndIntersects )
+{
+    std::mt19937                       rng( 11 );
+    SHAPE_POLY_SET                     set = makeTestSet( rng );
+    POLY_SET_INDEX                     index( set );
+    std::vector<VECTOR2I>              points = testPoints( rng, set );
+    std::uniform_int_distribution<int> length( -50000, 50000 );
+
+    auto edges = [&]() { return set.CIterateSegments( 0, set.OutlineCount() - 1, true ); };
+
+    for( int clearance : { 0, 10, 5000 } )
+    {
+        for( const VECTOR2I& p : points )
+        {
+            bool expected = set.Contains( p, -1, 1 );
+
+            for( auto it = edges(); it && !expected; it++ )
+                expected = ( *it ).SquaredDistance( p ) <= (SEG::ecoord) clearance * clearance;
+
+            BOOST_CHECK_EQUAL( index.Collide( p, clearance ), expected );
+        }
+    }
+
+    for( size_t i = 0; i < points.size(); i += 5 )
+    {
+        SEG  seg( points[i], points[i] + VECTOR2I( length( rng ), length( rng ) ) );
+        bool expected = false;
+
+        for( auto it = edges(); it && !expected; it++ )
+            expected = (bool) ( *it ).Intersect( seg );
+
+        BOOST_CHECK_EQUAL( index.Intersects( seg ), expected );
+    }
+}
+
+
+/**
+ * Checks that the index of a set is shared by its copies, and rebuilt once it is modified.
+ */
+BOOST_AUTO_TEST_CASE( SharedIndex )
+{
+    std::mt19937   rng( 3 );
+    SHAPE_POLY_SET set = makeTestSet( rng );
+    VECTOR2I       inside = set.Outline( 0 ).CPoint( 0 );
+
+    // Outline() leaks the polygons: the index is not kept
+    BOOST_CHECK( set.GetIndex() != set.GetIndex() );
+
+    SHAPE_POLY_SET                        copy = set;
+    std::shared_ptr<const POLY_SET_INDEX> index = copy.GetIndex();
+
+    BOOST_CHECK( copy.GetIndex() == index );
+
+    SHAPE_POLY_SET other = copy;
+
+    BOOST_CHECK( other.GetIndex() == index );
+    BOOST_CHECK( index->Collide( inside ) );
+
+    // Modifying a copy drops its index only
+    other.Move( VECTOR2I( 10000000, 0 ) );
+
+    BOOST_CHECK( other.GetIndex() != index );
+    BOOST_CHECK( copy.GetIndex() == index );
+    BOOST_CHECK( !other.GetIndex()->Collide( inside ) );
+    BOOST_CHECK( other.GetIndex()->Collide( inside + VECTOR2I( 10000000, 0 ) ) );
+}
+
+
+/**
+ * Checks that an index only matches the polygons it was built from.
+ */
+BOOST_AUTO_TEST_CASE( Matches )
+{
+    std::mt19937   rng( 5 );
+    SHAPE_POLY_SET set = makeTestSet( rng );
+    POLY_SET_INDEX index( set );
+    SHAPE_POLY_SET copy = set;
+
+    BOOST_CHECK( index.Matches( set ) );
+    BOOST_CHECK( index.Matches( copy ) );
+
+    copy.Move( VECTOR2I( 1, 0 ) );
+    BOOST_CHECK( !index.Matches( copy ) );
+
+    copy = set;
+    copy.DeletePolygon( copy.OutlineCount() - 1 );
+    BOOST_CHECK( !index.Matches( copy ) );
+
+    copy = set;
+    copy.Outline( 0 ).Append( copy.Outline( 0 ).CPoint( 0 ) + VECTOR2I( 0, 1 ) );
+    BOOST_CHECK( !index.Matches( copy ) );
+
+    BOOST_CHECK( !index.Matches( SHAPE_POLY_SET() ) );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -30,6 +30,8 @@
 
 #include "geom_test_utils.h"
 
+#include <random>
+
 BOOST_AUTO_TEST_SUITE( ShapeLineChain )
 
 BOOST_AUTO_TEST_CASE( ArcToPolyline )
@@ -59,4 +61,138 @@ BOOST_AUTO_TEST_CASE( ArcToPolyline )
 }
 
 
+/**
+ * A random walk long enough for the segment queries to use the segment hierarchy
+ */
+static SHAPE_LINE_CHAIN randomWalk( std::mt19937& aRng, int aCount, bool aClosed )
+{
+    SHAPE_LINE_CHAIN chain;
+    VECTOR2I         p( 0, 0 );
+
+    for( int i = 0; i < aCount; i++ )
+    {
+        p += VECTOR2I( (int) ( aRng() % 201 ) - 100, (int) ( aRng() % 201 ) - 100 );
+        chain.Append( p );
+    }
+
+    chain.SetClosed( aClosed );
+    return chain;
+}
+
+
+/**
+ * Checks the indexed segment queries against plain loops over the segments
+ */
+BOOST_AUTO_TEST_CASE( IndexedQueries )
+{
+    std::mt19937 rng( 7 );
+
+    for( bool closed : { false, true } )
+    {
+        SHAPE_LINE_CHAIN chain = randomWalk( rng, 1000, closed );
+        SHAPE_LINE_CHAIN other = randomWalk( rng, 300, false );
+
+        BOOST_REQUIRE( chain.SegmentCount() >= SHAPE_LINE_CHAIN::BVH_MIN_SEGMENTS );
+
+        for( int iter = 0; iter < 200; iter++ )
+        {
+            VECTOR2I a( (int) ( rng() % 2000 ) - 1000, (int) ( rng() % 2000 ) - 1000 );
+            VECTOR2I b = a + VECTOR2I( (int) ( rng() % 400 ) - 200, (int) ( rng() % 400 ) - 200 );
+            SEG      seg( a, b );
+            int      clearance = 1 + rng() % 50;
+            bool     collide = false;
+            int      crossings = 0;
+
+            for( int i = 0; i < chain.SegmentCount(); i++ )
+            {
+                const SEG s = chain.CSegment( i );
+                BOX2I::ecoord_type d = BOX2I( a, b - a ).SquaredDistance( BOX2I( s.A, s.B - s.A ) );
+
+                if( d < (BOX2I::ecoord_type) clearance * clearance && s.Collide( seg, clearance ) )
+                    collide = true;
+
+                if( chain.CSegment( i ).Intersect( seg ) )
+                    crossings++;
+            }
+
+            SHAPE_LINE_CHAIN::INTERSECTIONS ips;
+
+            BOOST_CHECK_EQUAL( chain.Collide( seg, clearance ), collide );
+            BOOST_CHECK_EQUAL( chain.Intersect( seg, ips ), crossings );
+
+            BOX2I box( a, b - a );
+            box.Normalize();
+            std::vector<int> expected, found;
+
+            for( int i = 0; i < chain.SegmentCount(); i++ )
+            {
+                BOX2I segBox( chain.CSegment( i ).A, chain.CSegment( i ).B - chain.CSegment( i ).A );
+                segBox.Normalize();
+
+                if( box.Intersects( segBox ) )
+                    expected.push_back( i );
+            }
+
+            chain.QuerySegments( box,
+                    [&]( int i ) -> bool
+                    {
+                        found.push_back( i );
+                        return true;
+                    } );
+
+            BOOST_CHECK( found == expected );
+        }
+
+        int chainCrossings = 0;
+
+        for( int i = 0; i < chain.SegmentCount(); i++ )
+        {
+            for( int j = 0; j < other.SegmentCount(); j++ )
+            {
+                if( !chain.CSegment( i ).Collinear( other.CSegment( j ) )
+                        && chain.CSegment( i ).Intersect( other.CSegment( j ) ) )
+                    chainCrossings++;
+            }
+        }
+
+        SHAPE_LINE_CHAIN::INTERSECTIONS ips;
+
+        // The random walks have no collinear overlaps, and rarely cross at a vertex
+        BOOST_CHECK_LE( chain.Intersect( other, ips ), chainCrossings );
+        BOOST_CHECK( chain.SelfIntersecting() );
+    }
+}
+
+
+/**
+ * Checks that the segment hierarchy follows the changes to the chain
+ */
+BOOST_AUTO_TEST_CASE( IndexedQueriesAfterChange )
+{
+    SHAPE_LINE_CHAIN chain;
+
+    // A zigzag along the x axis, far from the segment below
+    for( int i = 0; i < 400; i++ )
+        chain.Append( 10 * i, ( i % 2 ) * 10 );
+
+    SEG seg( VECTOR2I( 100, -100 ), VECTOR2I( 200, -100 ) );
+
+    BOOST_CHECK( !chain.Collide( seg, 50 ) );
+    BOOST_CHECK( !chain.SelfIntersecting() );
+
+    SHAPE_LINE_CHAIN copy( chain );
+
+    chain.Move( VECTOR2I( 0, -80 ) );
+    BOOST_CHECK( chain.Collide( seg, 50 ) );
+    BOOST_CHECK( !copy.Collide( seg, 50 ) );
+
+    chain.SetPoint( 10, VECTOR2I( 150, -500 ) );
+    chain.SetPoint( 20, VECTOR2I( 150, -500 ) );
+    BOOST_CHECK( chain.SelfIntersecting() );
+
+    copy.Append( VECTOR2I( 150, -120 ) );
+    BOOST_CHECK( copy.Collide( seg, 50 ) );
+}
+
+
 BOOST_AUTO_TEST_SUITE_END()
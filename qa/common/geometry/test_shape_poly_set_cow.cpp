@@ -0,0 +1,153 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <geometry/shape_line_chain.h>
+#include <geometry/shape_poly_set.h>
+
+#include <thread>
+
+/**
+ * Fixture for the copy-on-write tests: a single square outline.
+ */
+struct PolySetCowFixture
+{
+    SHAPE_POLY_SET square;
+
+    PolySetCowFixture()
+    {
+        square.NewOutline();
+        square.Append( 0, 0 );
+        square.Append( 100, 0 );
+        square.Append( 100, 100 );
+        square.Append( 0, 100 );
+    }
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( PolySetCopyOnWrite, PolySetCowFixture )
+
+/**
+ * Checks that a copy shares the polygons until one of the sets is modified.
+ */
+BOOST_AUTO_TEST_CASE( SharedUntilModified )
+{
+    SHAPE_POLY_SET copy = square;
+
+    BOOST_CHECK_EQUAL( &copy.CPolygon( 0 ), &square.CPolygon( 0 ) );
+
+    copy.Append( 50, 150 );
+
+    BOOST_CHECK_NE( &copy.CPolygon( 0 ), &square.CPolygon( 0 ) );
+    BOOST_CHECK_EQUAL( square.VertexCount(), 4 );
+    BOOST_CHECK_EQUAL( copy.VertexCount(), 5 );
+
+    square.Move( VECTOR2I( 10, 10 ) );
+
+    BOOST_CHECK_EQUAL( square.COutline( 0 ).CPoint( 0 ), VECTOR2I( 10, 10 ) );
+    BOOST_CHECK_EQUAL( copy.COutline( 0 ).CPoint( 0 ), VECTOR2I( 0, 0 ) );
+}
+
+/**
+ * Checks that a set modified through a reference returned by Outline() is never shared.
+ */
+BOOST_AUTO_TEST_CASE( OutlineReference )
+{
+    SHAPE_LINE_CHAIN& outline = square.Outline( 0 );
+    SHAPE_POLY_SET    copy = square;
+
+    outline.Append( 50, 150 );
+
+    BOOST_CHECK_EQUAL( square.VertexCount(), 5 );
+    BOOST_CHECK_EQUAL( copy.VertexCount(), 4 );
+}
+
+/**
+ * Checks that a copy keeps the triangulation of the original.
+ */
+BOOST_AUTO_TEST_CASE( SharedTriangulation )
+{
+    square.CacheTriangulation();
+
+    SHAPE_POLY_SET copy( square );
+
+    BOOST_CHECK( copy.IsTriangulationUpToDate() );
+    BOOST_CHECK_EQUAL( copy.TriangulatedPolyCount(), square.TriangulatedPolyCount() );
+
+    copy.Append( 50, 150 );
+
+    BOOST_CHECK( !copy.IsTriangulationUpToDate() );
+    BOOST_CHECK( square.IsTriangulationUpToDate() );
+}
+
+/**
+ * Checks that a triangulation is only taken from a set with the same polygons.
+ */
+BOOST_AUTO_TEST_CASE( ShareTriangulation )
+{
+    SHAPE_POLY_SET copy( square );
+
+    BOOST_CHECK( !square.ShareTriangulation( copy ) );
+
+    copy.CacheTriangulation();
+
+    BOOST_CHECK( square.ShareTriangulation( copy ) );
+    BOOST_CHECK( square.IsTriangulationUpToDate() );
+    BOOST_CHECK_EQUAL( square.TriangulatedPolygon( 0 ), copy.TriangulatedPolygon( 0 ) );
+
+    SHAPE_POLY_SET other( square, true );
+
+    other.Append( 50, 150 );
+    other.CacheTriangulation();
+
+    BOOST_CHECK( !square.ShareTriangulation( other ) );
+    BOOST_CHECK_EQUAL( square.TriangulatedPolygon( 0 ), copy.TriangulatedPolygon( 0 ) );
+}
+
+/**
+ * Checks that copies of a set may be modified concurrently, each in its own thread: the
+ * set which finds itself the only owner of the polygons, and modifies them in place, must not
+ * race with the copy still reading them to detach.  Best run with ThreadSanitizer.
+ */
+BOOST_AUTO_TEST_CASE( ConcurrentDetach )
+{
+    for( int i = 0; i < 200; ++i )
+    {
+        SHAPE_POLY_SET set( square );
+        SHAPE_POLY_SET copy( set );
+
+        std::thread thread( [&copy]() { copy.Append( 50, 150 ); } );
+
+        set.Append( 150, 50 );
+        thread.join();
+
+        BOOST_CHECK_EQUAL( set.VertexCount(), 5 );
+        BOOST_CHECK_EQUAL( copy.VertexCount(), 5 );
+        BOOST_CHECK_EQUAL( set.COutline( 0 ).CPoint( -1 ), VECTOR2I( 150, 50 ) );
+        BOOST_CHECK_EQUAL( copy.COutline( 0 ).CPoint( -1 ), VECTOR2I( 50, 150 ) );
+        BOOST_CHECK_EQUAL( square.VertexCount(), 4 );
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,124 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <random>
+
+#include <geometry/shape_line_chain.h>
+#include <geometry/shape_poly_set.h>
+#include <math/util.h>
+
+
+BOOST_AUTO_TEST_SUITE( PolySetInflate )
+
+
+static SHAPE_LINE_CHAIN circle( int aCenterX, int aCenterY, int aRadius, int aCount )
+{
+    SHAPE_LINE_CHAIN chain;
+
+    for( int i = 0; i < aCount; i++ )
+    {
+        double angle = 2 * M_PI * i / aCount;
+
+        chain.Append( aCenterX + KiROUND( aRadius * cos( angle ) ),
+                      aCenterY + KiROUND( aRadius * sin( angle ) ) );
+    }
+
+    chain.SetClosed( true );
+    return chain;
+}
+
+
+/**
+ * Compact corners replace the joins smaller than one circle segment by their miter point,
+ * which stays within the arc tolerance of the exact offset.
+ */
+BOOST_AUTO_TEST_CASE( CompactCorners )
+{
+    const int      radius = 1000000;
+    const int      amount = 100000;
+    const int      segments = 16;
+    const double   tolerance = amount * ( 1.0 - cos( M_PI / segments ) );
+    SHAPE_POLY_SET plain;
+
+    plain.AddOutline( circle( 0, 0, radius, 256 ) );
+
+    SHAPE_POLY_SET compact = plain;
+
+    plain.Inflate( amount, segments );
+    compact.Inflate( amount, segments, SHAPE_POLY_SET::ROUND_ALL_CORNERS, true );
+
+    BOOST_CHECK_EQUAL( plain.TotalVertices(), 512 );
+    BOOST_CHECK_EQUAL( compact.TotalVertices(), 256 );
+
+    for( const VECTOR2I& pt : compact.COutline( 0 ).CPoints() )
+    {
+        double dist = pt.EuclideanNorm();
+
+        BOOST_CHECK_GE( dist, radius + amount - 2 );
+        BOOST_CHECK_LE( dist, radius + amount + tolerance );
+    }
+}
+
+
+/**
+ * Repeated deflate/inflate rounds of a sheet with round holes must not multiply its vertices.
+ */
+BOOST_AUTO_TEST_CASE( CompactCornersRounds )
+{
+    std::mt19937                       rng( 5 );
+    std::uniform_int_distribution<int> x( 500000, 19500000 );
+    std::uniform_int_distribution<int> y( 500000, 9500000 );
+    SHAPE_POLY_SET                     sheet;
+    SHAPE_POLY_SET                     holes;
+
+    sheet.NewOutline();
+    sheet.Append( 0, 0 );
+    sheet.Append( 20000000, 0 );
+    sheet.Append( 20000000, 10000000 );
+    sheet.Append( 0, 10000000 );
+
+    for( int i = 0; i < 100; i++ )
+        holes.AddOutline( circle( x( rng ), y( rng ), 300000, 32 ) );
+
+    sheet.BooleanSubtract( holes, SHAPE_POLY_SET::PM_FAST );
+
+    SHAPE_POLY_SET plain = sheet;
+    SHAPE_POLY_SET compact = sheet;
+
+    for( int round = 0; round < 4; round++ )
+    {
+        plain.Deflate( 99000, 16, SHAPE_POLY_SET::CHAMFER_ALL_CORNERS );
+        plain.Inflate( 99000, 16, SHAPE_POLY_SET::CHAMFER_ALL_CORNERS );
+        compact.Deflate( 99000, 16, SHAPE_POLY_SET::CHAMFER_ALL_CORNERS, true );
+        compact.Inflate( 99000, 16, SHAPE_POLY_SET::CHAMFER_ALL_CORNERS, true );
+    }
+
+    BOOST_CHECK_GT( plain.TotalVertices(), sheet.TotalVertices() * 3 / 2 );
+    BOOST_CHECK_LT( compact.TotalVertices(), sheet.TotalVertices() * 5 / 4 );
+    BOOST_CHECK_EQUAL( compact.OutlineCount(), plain.OutlineCount() );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
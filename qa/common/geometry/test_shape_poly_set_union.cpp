@@ -0,0 +1,136 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <geometry/shape_line_chain.h>
+#include <geometry/shape_poly_set.h>
+
+
+/**
+ * Fixture for the multi-set union tests: a grid of overlapping squares, with enough vertices
+ * to use several groups in the reduction.
+ */
+struct PolySetUnionFixture
+{
+    std::vector<SHAPE_POLY_SET> squares;
+    SHAPE_POLY_SET              flat;
+
+    PolySetUnionFixture()
+    {
+        for( int i = 0; i < 60; i++ )
+        {
+            for( int j = 0; j < 60; j++ )
+            {
+                SHAPE_POLY_SET square;
+
+                square.NewOutline();
+                square.Append( 100 * i, 100 * j );
+                square.Append( 100 * i + 120, 100 * j );
+                square.Append( 100 * i + 120, 100 * j + 120 );
+                square.Append( 100 * i, 100 * j + 120 );
+
+                squares.push_back( square );
+                flat.Append( square );
+            }
+        }
+
+        flat.Simplify( SHAPE_POLY_SET::PM_FAST );
+    }
+};
+
+
+/**
+ * Returns the area of the polygons of a set, less the area of their holes
+ */
+static double netArea( const SHAPE_POLY_SET& aSet )
+{
+    double area = 0.0;
+
+    for( int ii = 0; ii < aSet.OutlineCount(); ii++ )
+    {
+        area += std::abs( aSet.COutline( ii ).Area() );
+
+        for( int jj = 0; jj < aSet.HoleCount( ii ); jj++ )
+            area -= std::abs( aSet.CHole( ii, jj ).Area() );
+    }
+
+    return area;
+}
+
+
+BOOST_FIXTURE_TEST_SUITE( PolySetUnion, PolySetUnionFixture )
+
+/**
+ * Checks that the multi-set union covers the same area as a flat union.
+ */
+BOOST_AUTO_TEST_CASE( MatchesFlatUnion )
+{
+    SHAPE_POLY_SET result;
+
+    result.BooleanAdd( squares, SHAPE_POLY_SET::PM_FAST );
+
+    BOOST_CHECK_EQUAL( result.OutlineCount(), flat.OutlineCount() );
+    BOOST_CHECK_EQUAL( netArea( result ), netArea( flat ) );
+
+    SHAPE_POLY_SET diff = result;
+    diff.BooleanSubtract( flat, SHAPE_POLY_SET::PM_FAST );
+    BOOST_CHECK_EQUAL( diff.OutlineCount(), 0 );
+
+    diff = flat;
+    diff.BooleanSubtract( result, SHAPE_POLY_SET::PM_FAST );
+    BOOST_CHECK_EQUAL( diff.OutlineCount(), 0 );
+}
+
+/**
+ * Checks the parallel simplification of a single set holding all the squares.
+ */
+BOOST_AUTO_TEST_CASE( SimplifyParallel )
+{
+    SHAPE_POLY_SET result;
+
+    for( const SHAPE_POLY_SET& square : squares )
+        result.Append( square );
+
+    result.SimplifyParallel( SHAPE_POLY_SET::PM_FAST );
+
+    BOOST_CHECK_EQUAL( result.OutlineCount(), flat.OutlineCount() );
+    BOOST_CHECK_EQUAL( netArea( result ), netArea( flat ) );
+}
+
+/**
+ * Checks the unions of no set and of a single one.
+ */
+BOOST_AUTO_TEST_CASE( Degenerate )
+{
+    SHAPE_POLY_SET result = flat;
+
+    result.BooleanAdd( std::vector<SHAPE_POLY_SET>(), SHAPE_POLY_SET::PM_FAST );
+    BOOST_CHECK_EQUAL( result.OutlineCount(), 0 );
+
+    result.BooleanAdd( { squares[0] }, SHAPE_POLY_SET::PM_FAST );
+    BOOST_CHECK_EQUAL( result.OutlineCount(), 1 );
+    BOOST_CHECK_EQUAL( netArea( result ), 120.0 * 120.0 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
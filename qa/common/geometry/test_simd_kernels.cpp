@@ -0,0 +1,100 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <geometry/shape_line_chain.h>
+#include <geometry/simd_kernels.h>
+
+#include <random>
+
+
+BOOST_AUTO_TEST_SUITE( SimdKernels )
+
+/**
+ * Checks that every instruction set gives the same masks as the scalar kernels.
+ */
+BOOST_AUTO_TEST_CASE( MasksMatchScalar )
+{
+    std::mt19937 rng( 42 );
+    int          xy[2 * ( SIMD_EDGE_BLOCK + 1 )];
+
+    for( int iter = 0; iter < 1000; iter++ )
+    {
+        for( int& c : xy )
+            c = (int) ( rng() % 200 ) - 100;
+
+        int y = (int) ( rng() % 200 ) - 100;
+        int x = (int) ( rng() % 200 ) - 100;
+
+        SetSimdLevel( SIMD_LEVEL::SCALAR );
+        uint32_t straddling = StraddlingEdges( xy, y );
+        uint32_t touching = EdgesTouchingBox( xy, x - 10, y - 10, x + 10, y + 10 );
+
+        for( SIMD_LEVEL level : { SIMD_LEVEL::SSE2, SIMD_LEVEL::AVX2 } )
+        {
+            if( SetSimdLevel( level ) != level )
+                continue;
+
+            BOOST_CHECK_EQUAL( StraddlingEdges( xy, y ), straddling );
+            BOOST_CHECK_EQUAL( EdgesTouchingBox( xy, x - 10, y - 10, x + 10, y + 10 ), touching );
+        }
+    }
+
+    SetSimdLevel( SIMD_LEVEL::AVX2 );
+}
+
+/**
+ * Checks the point-in-polygon and on-edge tests of a chain long enough to use the kernels.
+ */
+BOOST_AUTO_TEST_CASE( LineChainQueries )
+{
+    SHAPE_LINE_CHAIN comb;
+
+    // A comb with 10 teeth, 10 units wide and 100 units long, opening to the bottom
+    for( int i = 0; i < 10; i++ )
+    {
+        comb.Append( 20 * i, 0 );
+        comb.Append( 20 * i, 100 );
+        comb.Append( 20 * i + 10, 100 );
+        comb.Append( 20 * i + 10, 0 );
+    }
+
+    comb.Append( 190, -20 );
+    comb.Append( 0, -20 );
+    comb.SetClosed( true );
+
+    BOOST_CHECK( comb.PointInside( VECTOR2I( 5, 50 ) ) );
+    BOOST_CHECK( comb.PointInside( VECTOR2I( 185, 50 ) ) );
+    BOOST_CHECK( !comb.PointInside( VECTOR2I( 15, 50 ) ) );
+    BOOST_CHECK( !comb.PointInside( VECTOR2I( 175, 50 ) ) );
+    BOOST_CHECK( comb.PointInside( VECTOR2I( 95, -10 ) ) );
+
+    BOOST_CHECK_EQUAL( comb.EdgeContainingPoint( VECTOR2I( 180, 50 ) ), 36 );
+    BOOST_CHECK_EQUAL( comb.EdgeContainingPoint( VECTOR2I( 0, -10 ) ), 41 );
+    BOOST_CHECK_EQUAL( comb.EdgeContainingPoint( VECTOR2I( 15, 50 ) ), -1 );
+    BOOST_CHECK( comb.CheckClearance( VECTOR2I( 15, 50 ), 5 ) );
+    BOOST_CHECK( !comb.CheckClearance( VECTOR2I( 15, 50 ), 3 ) );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
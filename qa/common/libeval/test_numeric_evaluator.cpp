@@ -105,6 +105,37 @@ BOOST_AUTO_TEST_CASE( SetVar )
     BOOST_CHECK_EQUAL( m_eval.GetVar( "piish" ), 0.0 );
 }
 
+/**
+ * Check that evaluating a string again gives the same result, and follows the variables
+ */
+BOOST_AUTO_TEST_CASE( Reevaluate )
+{
+    for( int ii = 0; ii < 2; ii++ )
+    {
+        BOOST_CHECK_EQUAL( m_eval.Process( "1in + 1" ), true );
+        BOOST_CHECK_EQUAL( m_eval.Result(), "26.4" );
+        BOOST_CHECK_EQUAL( m_eval.OriginalText(), "1in + 1" );
+
+        BOOST_CHECK_EQUAL( m_eval.Process( "1 +" ), false );
+    }
+
+    m_eval.SetVar( "x", 2 );
+    m_eval.Process( "x * 3" );
+    BOOST_CHECK_EQUAL( m_eval.Result(), "6" );
+
+    m_eval.SetVar( "x", 3 );
+    m_eval.Process( "x * 3" );
+    BOOST_CHECK_EQUAL( m_eval.Result(), "9" );
+
+    // An assignment is done again, even if the string is the same
+    m_eval.Process( "y = 5; y + 1" );
+    BOOST_CHECK_EQUAL( m_eval.Result(), "6" );
+    m_eval.RemoveVar( "y" );
+    m_eval.Process( "y = 5; y + 1" );
+    BOOST_CHECK_EQUAL( m_eval.Result(), "6" );
+    BOOST_CHECK_EQUAL( m_eval.GetVar( "y" ), 5 );
+}
+
 /**
  * A list of valid test strings and the expected results
  */
@@ -242,4 +242,29 @@ BOOST_AUTO_TEST_CASE( MirrorImage )
     }
 }
 
+/**
+ * Check the image id changes with the image data, and is not shared by a copy
+ */
+BOOST_AUTO_TEST_CASE( ImageId )
+{
+    const int id = m_4tile.GetImageID();
+
+    BITMAP_BASE copied = m_4tile;
+    BOOST_CHECK_NE( copied.GetImageID(), id );
+
+    // Changing the scale does not change the image data
+    m_4tile.SetScale( 2.0 );
+    BOOST_CHECK_EQUAL( m_4tile.GetImageID(), id );
+
+    m_4tile.Rotate( false );
+    const int rotatedId = m_4tile.GetImageID();
+    BOOST_CHECK_NE( rotatedId, id );
+
+    m_4tile.Mirror( true );
+    BOOST_CHECK_NE( m_4tile.GetImageID(), rotatedId );
+
+    copied.ImportData( &m_4tile );
+    BOOST_CHECK_NE( copied.GetImageID(), m_4tile.GetImageID() );
+}
+
 BOOST_AUTO_TEST_SUITE_END()
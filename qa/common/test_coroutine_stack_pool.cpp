@@ -0,0 +1,68 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+
+#include <unit_test_utils/unit_test_utils.h>
+
+// Code under test
+#include <tool/coroutine_stack_pool.h>
+
+#include <cstring>
+
+
+BOOST_AUTO_TEST_SUITE( CoroutineStackPool )
+
+
+/**
+ * Checks that the whole stack can be used, and that a released stack is reused.
+ */
+BOOST_AUTO_TEST_CASE( Reuse )
+{
+    COROUTINE_STACK_POOL& pool = COROUTINE_STACK_POOL::GetInstance();
+    size_t                size = 100000;
+    char*                 first = nullptr;
+
+    {
+        COROUTINE_STACK_POOL::STACK stack = pool.Acquire( size );
+
+        BOOST_REQUIRE( stack );
+        BOOST_CHECK_GE( size, 100000 );
+
+        memset( stack.get(), 0x5A, size );
+        first = stack.get();
+    }
+
+    size_t sameSize = 100000;
+    COROUTINE_STACK_POOL::STACK again = pool.Acquire( sameSize );
+
+    BOOST_CHECK_EQUAL( sameSize, size );
+    BOOST_CHECK( again.get() == first );
+
+    // In use: another stack
+    size_t                      otherSize = 100000;
+    COROUTINE_STACK_POOL::STACK other = pool.Acquire( otherSize );
+
+    BOOST_CHECK( other.get() != again.get() );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,84 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <dsnlexer.h>
+
+
+static const KEYWORD testKeywords[] = {
+    { "at", 0 },
+    { "layer", 1 },
+    { "layers", 2 },
+    { "module", 3 },
+    { "pad", 4 },
+    { "segment", 5 },
+    { "width", 6 },
+};
+
+
+BOOST_AUTO_TEST_SUITE( DsnLexer )
+
+
+/**
+ * Checks the classification of keywords, symbols, numbers and strings.
+ */
+BOOST_AUTO_TEST_CASE( Tokens )
+{
+    DSNLEXER lexer( testKeywords, sizeof( testKeywords ) / sizeof( testKeywords[0] ),
+                    "(module \"R 1\" (layer F.Cu) (at 1.5 -2) layers\n(pads widths a))",
+                    "test" );
+
+    const std::vector<std::pair<int, std::string>> expected = {
+        { DSN_LEFT, "(" },      { 3, "module" },       { DSN_STRING, "R 1" },
+        { DSN_LEFT, "(" },      { 1, "layer" },        { DSN_SYMBOL, "F.Cu" },
+        { DSN_RIGHT, ")" },     { DSN_LEFT, "(" },     { 0, "at" },
+        { DSN_NUMBER, "1.5" },  { DSN_NUMBER, "-2" },  { DSN_RIGHT, ")" },
+        { 2, "layers" },        { DSN_LEFT, "(" },     { DSN_SYMBOL, "pads" },
+        { DSN_SYMBOL, "widths" }, { DSN_SYMBOL, "a" }, { DSN_RIGHT, ")" },
+        { DSN_RIGHT, ")" },     { DSN_EOF, "" },
+    };
+
+    for( const auto& token : expected )
+    {
+        BOOST_CHECK_EQUAL( lexer.NextTok(), token.first );
+
+        if( token.first != DSN_EOF )
+            BOOST_CHECK_EQUAL( lexer.CurStr(), token.second );
+    }
+}
+
+
+/**
+ * Checks that a lexer without keywords only finds symbols.
+ */
+BOOST_AUTO_TEST_CASE( NoKeywords )
+{
+    DSNLEXER lexer( "at layer", "test" );
+
+    BOOST_CHECK_EQUAL( lexer.NextTok(), DSN_SYMBOL );
+    BOOST_CHECK_EQUAL( lexer.NextTok(), DSN_SYMBOL );
+    BOOST_CHECK_EQUAL( lexer.NextTok(), DSN_EOF );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,194 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Tests of FOOTPRINT_FILTER, which indexes the footprints of its list.
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <footprint_filter.h>
+
+#include <vector>
+
+
+/**
+ * A footprint known by its library, name, pad count and keywords only
+ */
+class TEST_FOOTPRINT_INFO : public FOOTPRINT_INFO
+{
+public:
+    TEST_FOOTPRINT_INFO( const wxString& aLib, const wxString& aName, unsigned aPadCount,
+                         const wxString& aKeywords )
+    {
+        m_owner = nullptr;
+        m_loaded = true;
+        m_nickname = aLib;
+        m_fpname = aName;
+        m_num = 0;
+        m_pad_count = aPadCount;
+        m_unique_pad_count = aPadCount;
+        m_keywords = aKeywords;
+    }
+};
+
+
+class TEST_FOOTPRINT_LIST : public FOOTPRINT_LIST
+{
+public:
+    void Add( const wxString& aLib, const wxString& aName, unsigned aPadCount,
+              const wxString& aKeywords = wxEmptyString )
+    {
+        m_list.push_back(
+                std::make_unique<TEST_FOOTPRINT_INFO>( aLib, aName, aPadCount, aKeywords ) );
+    }
+
+    bool ReadFootprintFiles( FP_LIB_TABLE*, const wxString*, PROGRESS_REPORTER* ) override
+    {
+        return true;
+    }
+
+protected:
+    void StartWorkers( FP_LIB_TABLE*, wxString const*, FOOTPRINT_ASYNC_LOADER*,
+                       unsigned ) override
+    {
+    }
+
+    bool JoinWorkers() override { return true; }
+
+    void StopWorkers() override {}
+};
+
+
+struct FOOTPRINT_FILTER_FIXTURE
+{
+    FOOTPRINT_FILTER_FIXTURE()
+    {
+        m_list.Add( "Capacitor_SMD", "C_0603_1608Metric", 2, "capacitor" );
+        m_list.Add( "Capacitor_SMD", "C_0805_2012Metric", 2, "capacitor" );
+        m_list.Add( "Package_SO", "SOIC-8_3.9x4.9mm_P1.27mm", 8, "soic" );
+        m_list.Add( "Resistor_SMD", "R_0603_1608Metric", 2, "resistor" );
+        m_list.Add( "Resistor_SMD", "R_0805_2012Metric", 2, "resistor" );
+
+        m_filter.SetList( m_list );
+    }
+
+    /**
+     * @return the names of the footprints passing the filter, in the order of the list
+     */
+    std::vector<wxString> names()
+    {
+        std::vector<wxString> found;
+
+        for( FOOTPRINT_INFO& footprint : m_filter )
+            found.push_back( footprint.GetFootprintName() );
+
+        return found;
+    }
+
+    TEST_FOOTPRINT_LIST m_list;
+    FOOTPRINT_FILTER    m_filter;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( FootprintFilter, FOOTPRINT_FILTER_FIXTURE )
+
+
+BOOST_AUTO_TEST_CASE( Unfiltered )
+{
+    BOOST_CHECK_EQUAL( names().size(), 5 );
+}
+
+
+/**
+ * Checks the criteria, alone and together, and the filter used again with other criteria.
+ */
+BOOST_AUTO_TEST_CASE( Criteria )
+{
+    using NAMES = std::vector<wxString>;
+
+    m_filter.FilterByLibrary( "Resistor_SMD" );
+    BOOST_CHECK( names() == NAMES( { "R_0603_1608Metric", "R_0805_2012Metric" } ) );
+
+    m_filter.ClearFilters();
+    m_filter.FilterByPinCount( 8 );
+    BOOST_CHECK( names() == NAMES( { "SOIC-8_3.9x4.9mm_P1.27mm" } ) );
+
+    m_filter.ClearFilters();
+    m_filter.FilterByFootprintFilters( wxSplit( "c_* soic*", ' ' ) );
+    BOOST_CHECK( names() == NAMES( { "C_0603_1608Metric", "C_0805_2012Metric",
+                                     "SOIC-8_3.9x4.9mm_P1.27mm" } ) );
+
+    // Only the filters with a ':' are matched against the library name
+    m_filter.ClearFilters();
+    m_filter.FilterByFootprintFilters( wxSplit( "resistor_smd:*0805*", ' ' ) );
+    BOOST_CHECK( names() == NAMES( { "R_0805_2012Metric" } ) );
+
+    m_filter.ClearFilters();
+    m_filter.FilterByFootprintFilters( wxSplit( "*0603*", ' ' ) );
+    m_filter.FilterByPinCount( 2 );
+    m_filter.FilterByLibrary( "Capacitor_SMD" );
+    BOOST_CHECK( names() == NAMES( { "C_0603_1608Metric" } ) );
+
+    m_filter.ClearFilters();
+    m_filter.FilterByPinCount( 3 );
+    BOOST_CHECK( names().empty() );
+
+    m_filter.ClearFilters();
+    m_filter.FilterByLibrary( "Unknown" );
+    BOOST_CHECK( names().empty() );
+}
+
+
+/**
+ * Checks the text patterns, which replace the previous ones.
+ */
+BOOST_AUTO_TEST_CASE( TextPattern )
+{
+    using NAMES = std::vector<wxString>;
+
+    m_filter.FilterByTextPattern( "resistor" );
+    BOOST_CHECK( names() == NAMES( { "R_0603_1608Metric", "R_0805_2012Metric" } ) );
+
+    m_filter.ClearFilters();
+    m_filter.FilterByTextPattern( "capacitor 0805" );
+    BOOST_CHECK( names() == NAMES( { "C_0805_2012Metric" } ) );
+}
+
+
+/**
+ * Checks that the list is indexed again when it is set again.
+ */
+BOOST_AUTO_TEST_CASE( ChangedList )
+{
+    m_filter.FilterByLibrary( "Package_SO" );
+    BOOST_CHECK_EQUAL( names().size(), 1 );
+
+    m_list.Add( "Package_SO", "SOIC-14_3.9x8.7mm_P1.27mm", 14, "soic" );
+    m_filter.SetList( m_list );
+    m_filter.FilterByLibrary( "Package_SO" );
+    BOOST_CHECK_EQUAL( names().size(), 2 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
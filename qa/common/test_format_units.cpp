@@ -26,7 +26,11 @@
 #include <base_units.h>
 
 #include <algorithm>
+#include <cmath>
+#include <cstdio>
 #include <iostream>
+#include <limits>
+#include <vector>
 
 struct UnitFixture
 {
@@ -74,4 +78,61 @@ BOOST_AUTO_TEST_CASE( wxPointUnitFormat )
 }
 
 
+/**
+ * Check the fast formatting gives the text of the former printf() formats
+ */
+BOOST_AUTO_TEST_CASE( PrintfEquivalence )
+{
+    auto printfUnits = []( int aValue )
+    {
+        char   buf[50];
+        double engUnits = aValue / IU_PER_MM;
+        int    len;
+
+        if( engUnits != 0.0 && fabs( engUnits ) <= 0.0001 )
+        {
+            len = snprintf( buf, sizeof( buf ), "%.10f", engUnits );
+
+            while( --len > 0 && buf[len] == '0' )
+                buf[len] = '\0';
+
+            if( buf[len] != '.' )
+                ++len;
+        }
+        else
+        {
+            len = snprintf( buf, sizeof( buf ), "%.10g", engUnits );
+        }
+
+        return std::string( buf, len );
+    };
+
+    auto printfG = []( const char* aFormat, double aValue )
+    {
+        char buf[50];
+        int  len = snprintf( buf, sizeof( buf ), aFormat, aValue );
+
+        return std::string( buf, len );
+    };
+
+    std::vector<int> values = { 0, 1, -1, 9, 10, 99, 100, 101, -100, 1000, 123456, -350000,
+                                1000000, 25400000, std::numeric_limits<int>::min(),
+                                std::numeric_limits<int>::max() };
+
+    for( int i = 0; i < 10000; i++ )
+        values.push_back( ( i * 7919 - 5000 ) * ( i % 3 ? 1 : 1009 ) );
+
+    for( int v : values )
+    {
+        BOOST_CHECK_EQUAL( FormatInternalUnits( v ), printfUnits( v ) );
+        BOOST_CHECK_EQUAL( FormatAngle( v % 3600 ), printfG( "%.10g", ( v % 3600 ) / 10.0 ) );
+        BOOST_CHECK_EQUAL( Double2Str( v ), printfG( "%.16g", v ) );
+    }
+
+    BOOST_CHECK_EQUAL( FormatAngle( -0.0 ), "-0" );
+    BOOST_CHECK_EQUAL( FormatAngle( 450.5 ), "45.05" );
+    BOOST_CHECK_EQUAL( Double2Str( -0.0 ), "-0" );
+}
+
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -31,6 +31,9 @@
 // Code under test
 #include <kicad_string.h>
 
+#include <cmath>
+#include <cstdlib>
+
 /**
  * Declare the test suite
  */
@@ -107,4 +110,35 @@ BOOST_AUTO_TEST_CASE( NaturalNumberCompare )
     }
 }
 
+/**
+ * Test the #ParseDecimal method against strtod().
+ */
+BOOST_AUTO_TEST_CASE( ParseDecimalNumber )
+{
+    const std::vector<std::string> converted = {
+        "0", "-0", "1", "+3", "-0.5", ".25", "12.", "0.000001", "-2147.483648", "0.1",
+        "123456789012345", "99999.9999999999"
+    };
+
+    for( const std::string& c : converted )
+    {
+        double value = 42.0;
+
+        BOOST_CHECK_MESSAGE( ParseDecimal( c.c_str(), &value ), c );
+        BOOST_CHECK_MESSAGE( value == strtod( c.c_str(), nullptr )
+                                     && std::signbit( value ) == ( c[0] == '-' ), c );
+    }
+
+    // Left to strtod()
+    const std::vector<std::string> rejected = {
+        "", "-", ".", "1e5", "12.5x", "1 2", "nan", "1234567890123456", "0.0000000000000001"
+    };
+
+    for( const std::string& c : rejected )
+    {
+        double value;
+        BOOST_CHECK_MESSAGE( !ParseDecimal( c.c_str(), &value ), c );
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
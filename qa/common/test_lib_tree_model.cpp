@@ -0,0 +1,177 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Tests of the library tree searches, which use a trigram index of the items.
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <eda_pattern_match.h>
+#include <lib_tree_model.h>
+
+#include <wx/tokenzr.h>
+
+#include <set>
+
+
+/**
+ * A library item with a name and search text only
+ */
+class TEST_LIB_TREE_ITEM : public LIB_TREE_ITEM
+{
+public:
+    TEST_LIB_TREE_ITEM( const wxString& aLib, const wxString& aName, const wxString& aText ) :
+            m_lib( aLib ), m_name( aName ), m_text( aText )
+    {
+    }
+
+    LIB_ID   GetLibId() const override { return LIB_ID( m_lib, m_name ); }
+    wxString GetName() const override { return m_name; }
+    wxString GetLibNickname() const override { return m_lib; }
+    wxString GetDescription() override { return m_text; }
+    wxString GetSearchText() override { return m_text; }
+
+private:
+    wxString m_lib;
+    wxString m_name;
+    wxString m_text;
+};
+
+
+struct LIB_TREE_FIXTURE
+{
+    LIB_TREE_FIXTURE()
+    {
+        m_items.emplace_back( "Device", "R", "resistor res" );
+        m_items.emplace_back( "Device", "C", "unpolarized capacitor cap" );
+        m_items.emplace_back( "Device", "L", "inductor choke coil" );
+        m_items.emplace_back( "Connector", "Conn_01x02", "generic connector header" );
+        m_items.emplace_back( "Connector", "Jack_DC", "dc barrel jack" );
+
+        LIB_TREE_NODE_LIB& device = m_tree.AddLib( "Device", wxEmptyString );
+        LIB_TREE_NODE_LIB& connector = m_tree.AddLib( "Connector", wxEmptyString );
+
+        for( TEST_LIB_TREE_ITEM& item : m_items )
+            ( item.GetLibNickname() == "Device" ? device : connector ).AddItem( &item );
+
+        device.AssignIntrinsicRanks();
+        connector.AssignIntrinsicRanks();
+    }
+
+    /**
+     * Score the tree as LIB_TREE_MODEL_ADAPTER::UpdateSearchString() does.
+     *
+     * @return the names of the matching items
+     */
+    std::set<wxString> search( const wxString& aSearch, bool aNarrower = false )
+    {
+        m_tree.ResetScore( aNarrower );
+
+        wxStringTokenizer tokenizer( aSearch );
+
+        while( tokenizer.HasMoreTokens() )
+        {
+            EDA_COMBINED_MATCHER matcher( tokenizer.GetNextToken().Lower() );
+            m_tree.UpdateScore( matcher );
+        }
+
+        std::set<wxString> found;
+
+        for( auto& lib : m_tree.m_Children )
+        {
+            for( auto& item : lib->m_Children )
+            {
+                if( item->m_Score > 0 )
+                    found.insert( item->m_Name );
+            }
+        }
+
+        return found;
+    }
+
+    std::vector<TEST_LIB_TREE_ITEM> m_items;
+    LIB_TREE_NODE_ROOT              m_tree;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( LibTreeModel, LIB_TREE_FIXTURE )
+
+
+/**
+ * Checks the terms told apart from the patterns.
+ */
+BOOST_AUTO_TEST_CASE( PlainTerms )
+{
+    BOOST_CHECK( LIB_TREE_SEARCH_INDEX::IsPlainTerm( "conn_01x02" ) );
+    BOOST_CHECK( LIB_TREE_SEARCH_INDEX::IsPlainTerm( "sot-23 5" ) );
+    BOOST_CHECK( !LIB_TREE_SEARCH_INDEX::IsPlainTerm( "r*" ) );
+    BOOST_CHECK( !LIB_TREE_SEARCH_INDEX::IsPlainTerm( "r?s" ) );
+    BOOST_CHECK( !LIB_TREE_SEARCH_INDEX::IsPlainTerm( "^jack" ) );
+    BOOST_CHECK( !LIB_TREE_SEARCH_INDEX::IsPlainTerm( "r<10k" ) );
+    BOOST_CHECK( !LIB_TREE_SEARCH_INDEX::IsPlainTerm( "0.1" ) );
+}
+
+
+/**
+ * Checks the items found through the index, by name, text or library name.
+ */
+BOOST_AUTO_TEST_CASE( Search )
+{
+    using NAMES = std::set<wxString>;
+
+    BOOST_CHECK( search( "resistor" ) == NAMES( { "R" } ) );
+    BOOST_CHECK( search( "CAP" ) == NAMES( { "C" } ) );
+    BOOST_CHECK( search( "conn_01" ) == NAMES( { "Conn_01x02" } ) );
+    BOOST_CHECK( search( "connector" ) == NAMES( { "Conn_01x02", "Jack_DC" } ) );
+    BOOST_CHECK( search( "dev" ) == NAMES( { "R", "C", "L" } ) );
+    BOOST_CHECK( search( "device coil" ) == NAMES( { "L" } ) );
+    BOOST_CHECK( search( "xyz" ).empty() );
+
+    // Shorter than a trigram, and patterns: every item is matched
+    BOOST_CHECK( search( "dc" ) == NAMES( { "Jack_DC" } ) );
+    BOOST_CHECK( search( "ch*e" ) == NAMES( { "L" } ) );
+    BOOST_CHECK( search( "^j" ) == NAMES( { "Jack_DC" } ) );
+}
+
+
+/**
+ * Checks that a narrower search keeps the items out, and that a changed library does not.
+ */
+BOOST_AUTO_TEST_CASE( NarrowerSearch )
+{
+    using NAMES = std::set<wxString>;
+
+    // "co" is also in the name of the connector library
+    BOOST_CHECK( search( "co" ) == NAMES( { "L", "Conn_01x02", "Jack_DC" } ) );
+    BOOST_CHECK( search( "coi", true ) == NAMES( { "L" } ) );
+    BOOST_CHECK( search( "coil", true ) == NAMES( { "L" } ) );
+
+    m_items.emplace_back( "Device", "Coil_Small", "small inductor" );
+    static_cast<LIB_TREE_NODE_LIB*>( m_tree.m_Children[0].get() )->AddItem( &m_items.back() );
+
+    BOOST_CHECK( search( "coil", true ) == NAMES( { "L", "Coil_Small" } ) );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
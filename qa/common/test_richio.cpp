@@ -0,0 +1,147 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <richio.h>
+
+#include <wx/ffile.h>
+#include <wx/filename.h>
+
+
+/**
+ * Writes a temporary file, removed at the end of the test.
+ */
+struct TEMP_TEXT_FILE
+{
+    wxString m_path;
+
+    TEMP_TEXT_FILE( const std::string& aContents )
+    {
+        m_path = wxFileName::CreateTempFileName( "qa_richio" );
+
+        wxFFile file( m_path, "wb" );
+        file.Write( aContents.data(), aContents.size() );
+    }
+
+    ~TEMP_TEXT_FILE()
+    {
+        wxRemoveFile( m_path );
+    }
+};
+
+
+BOOST_AUTO_TEST_SUITE( RichIo )
+
+
+/**
+ * Checks that the mapped file lines are the same as the lines of a STRING_LINE_READER.
+ */
+BOOST_AUTO_TEST_CASE( MappedFileLines )
+{
+    const std::vector<std::string> cases = {
+        "",
+        "\n",
+        "(kicad_pcb (version 20200119)\n  (layers)\n)\n",
+        "no trailing newline",
+        "\n\nblank lines\n\n",
+        "crlf\r\nlines\r\n",
+    };
+
+    for( const std::string& contents : cases )
+    {
+        TEMP_TEXT_FILE          file( contents );
+        MAPPED_FILE_LINE_READER mapped( file.m_path );
+        STRING_LINE_READER      expected( contents, "test" );
+
+        for( ;; )
+        {
+            char* expectedLine = expected.ReadLine();
+            char* mappedLine = mapped.ReadLine();
+
+            BOOST_REQUIRE_EQUAL( mappedLine == nullptr, expectedLine == nullptr );
+            BOOST_CHECK_EQUAL( mapped.LineNumber(), expected.LineNumber() );
+
+            if( !expectedLine )
+                break;
+
+            BOOST_CHECK_EQUAL( mapped.Length(), expected.Length() );
+            BOOST_CHECK_EQUAL( std::string( mappedLine ), std::string( expectedLine ) );
+        }
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE( MappedFileMissing )
+{
+    BOOST_CHECK_THROW( MAPPED_FILE_LINE_READER( "/this/file/does/not/exist" ), IO_ERROR );
+}
+
+
+/**
+ * Checks that a gzip compressed file is read back as the text it was written from.
+ */
+BOOST_AUTO_TEST_CASE( GzipFileLines )
+{
+    const std::string contents = "(kicad_pcb (version 20200119)\n  (layers)\n)\n";
+    TEMP_TEXT_FILE    file( "" );
+
+    {
+        GZIP_FILE_OUTPUTFORMATTER formatter( file.m_path );
+
+        // More than one block of the formatter
+        for( int i = 0; i < 100000; ++i )
+            formatter.Print( 0, "%s", contents.c_str() );
+    }
+
+    wxFFile compressed( file.m_path, "rb" );
+    unsigned char magic[2] = { 0, 0 };
+
+    BOOST_REQUIRE_EQUAL( compressed.Read( magic, 2 ), 2 );
+    BOOST_CHECK( magic[0] == 0x1f && magic[1] == 0x8b );
+    BOOST_CHECK( compressed.Length() < (wxFileOffset) contents.size() * 100000 / 10 );
+    compressed.Close();
+
+    const std::vector<std::string> expected = { "(kicad_pcb (version 20200119)\n",
+                                                "  (layers)\n", ")\n" };
+    MAPPED_FILE_LINE_READER        reader( file.m_path );
+    int                            lines = 0;
+
+    while( char* line = reader.ReadLine() )
+    {
+        BOOST_REQUIRE_EQUAL( std::string( line ), expected[lines % 3] );
+        ++lines;
+    }
+
+    BOOST_CHECK_EQUAL( lines, 3 * 100000 );
+}
+
+
+BOOST_AUTO_TEST_CASE( GzipFileCorrupt )
+{
+    TEMP_TEXT_FILE file( std::string( "\x1f\x8b" ) + "not really compressed" );
+
+    BOOST_CHECK_THROW( MAPPED_FILE_LINE_READER( file.m_path ), IO_ERROR );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,182 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+// Code under test
+#include <thread_pool.h>
+
+#include <chrono>
+#include <stdexcept>
+
+
+BOOST_AUTO_TEST_SUITE( ThreadPool )
+
+
+/**
+ * Checks that each item of a loop is run exactly once.
+ */
+BOOST_AUTO_TEST_CASE( ParallelFor )
+{
+    THREAD_POOL                   pool( 4 );
+    std::vector<std::atomic<int>> counts( 1000 );
+
+    for( std::atomic<int>& count : counts )
+        count = 0;
+
+    pool.ParallelFor( counts.size(), [&]( size_t ii ) { counts[ii]++; } );
+
+    for( const std::atomic<int>& count : counts )
+        BOOST_CHECK_EQUAL( count, 1 );
+}
+
+
+/**
+ * Checks that a loop run inside the items of another loop does not block the pool.
+ */
+BOOST_AUTO_TEST_CASE( Nested )
+{
+    THREAD_POOL         pool( 2 );
+    std::atomic<size_t> total( 0 );
+
+    pool.ParallelFor( 16,
+            [&]( size_t )
+            {
+                pool.ParallelFor( 100, [&]( size_t ) { total++; } );
+            } );
+
+    BOOST_CHECK_EQUAL( total, 1600 );
+}
+
+
+/**
+ * Checks that the idle callback is used while waiting, the calling thread not running the loop.
+ */
+BOOST_AUTO_TEST_CASE( Idle )
+{
+    THREAD_POOL         pool( 2 );
+    std::thread::id     caller = std::this_thread::get_id();
+    std::atomic<bool>   ranOnCaller( false );
+    std::atomic<size_t> total( 0 );
+
+    pool.ParallelFor( 50,
+            [&]( size_t )
+            {
+                if( std::this_thread::get_id() == caller )
+                    ranOnCaller = true;
+
+                std::this_thread::sleep_for( std::chrono::milliseconds( 5 ) );
+                total++;
+            },
+            []() {} );
+
+    BOOST_CHECK_EQUAL( total, 50 );
+    BOOST_CHECK( !ranOnCaller );
+}
+
+
+/**
+ * Checks that a thread waiting for a group only runs the tasks of this group.
+ */
+BOOST_AUTO_TEST_CASE( WaitOwnGroupOnly )
+{
+    THREAD_POOL       pool( 1 );
+    TASK_GROUP        other( pool );
+    TASK_GROUP        mine( pool );
+    std::atomic<bool> started( false );
+    std::atomic<bool> release( false );
+    std::atomic<bool> otherRan( false );
+    std::atomic<bool> mineRan( false );
+
+    // Keep the only worker busy, so the tasks queued next are left to the waiting thread
+    other.Run( [&]()
+               {
+                   started = true;
+
+                   while( !release )
+                       std::this_thread::yield();
+               } );
+
+    while( !started )
+        std::this_thread::yield();
+
+    other.Run( [&]() { otherRan = true; } );
+
+    mine.Run( [&]() { mineRan = true; } );
+    mine.Wait();
+
+    BOOST_CHECK( mineRan );
+    BOOST_CHECK( !otherRan );
+
+    release = true;
+    other.Wait();
+
+    BOOST_CHECK( otherRan );
+}
+
+
+/**
+ * Checks that the items left are skipped once the group is cancelled.
+ */
+BOOST_AUTO_TEST_CASE( Cancel )
+{
+    THREAD_POOL         pool( 1 );
+    TASK_GROUP          group( pool );
+    std::atomic<size_t> total( 0 );
+
+    group.ParallelFor( 1000,
+            [&]( size_t ii )
+            {
+                total++;
+
+                if( ii == 10 )
+                    group.Cancel();
+            } );
+
+    BOOST_CHECK( group.IsCancelled() );
+    BOOST_CHECK_LT( total, 1000 );
+}
+
+
+/**
+ * Checks that an exception thrown by a task is thrown again by the wait.
+ */
+BOOST_AUTO_TEST_CASE( Exception )
+{
+    THREAD_POOL pool( 2 );
+    TASK_GROUP  group( pool );
+
+    group.Run( []() { throw std::runtime_error( "task error" ); } );
+
+    BOOST_CHECK_THROW( group.Wait(), std::runtime_error );
+
+    BOOST_CHECK_THROW( pool.ParallelFor( 100,
+                               []( size_t ii )
+                               {
+                                   if( ii == 50 )
+                                       throw std::runtime_error( "item error" );
+                               } ),
+            std::runtime_error );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,97 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+
+#include <unit_test_utils/unit_test_utils.h>
+
+// Code under test
+#include <trace_events.h>
+
+#include <thread_pool.h>
+
+#include <algorithm>
+
+
+static size_t countOf( const std::string& aText, const std::string& aPattern )
+{
+    size_t count = 0;
+
+    for( size_t pos = aText.find( aPattern ); pos != std::string::npos;
+            pos = aText.find( aPattern, pos + 1 ) )
+    {
+        count++;
+    }
+
+    return count;
+}
+
+
+BOOST_AUTO_TEST_SUITE( TraceEvents )
+
+
+/**
+ * Checks that nothing is recorded when no trace file is given.
+ */
+BOOST_AUTO_TEST_CASE( Disabled )
+{
+    TRACE_EVENTS events( false );
+
+    BOOST_CHECK( !events.IsEnabled() );
+
+    {
+        TRACE_SCOPE scope( "scope", events );
+    }
+
+    BOOST_CHECK_EQUAL( countOf( events.ToJson(), "\"ph\":\"X\"" ), 0 );
+}
+
+
+/**
+ * Checks that the scopes of all the threads are recorded, with their names escaped.
+ */
+BOOST_AUTO_TEST_CASE( Threads )
+{
+    TRACE_EVENTS events( true );
+    THREAD_POOL  pool( 4 );
+
+    BOOST_CHECK( events.IsEnabled() );
+
+    {
+        TRACE_SCOPE scope( "outer \"quoted\"", events );
+
+        // More than a chunk of events
+        pool.ParallelFor( 3000, [&]( size_t )
+                {
+                    TRACE_SCOPE inner( "inner", events );
+                } );
+    }
+
+    std::string json = events.ToJson();
+
+    BOOST_CHECK_EQUAL( countOf( json, "\"name\":\"inner\"" ), 3000 );
+    BOOST_CHECK_EQUAL( countOf( json, "\"name\":\"outer \\\"quoted\\\"\"" ), 1 );
+    BOOST_CHECK_EQUAL( json.front(), '{' );
+    BOOST_CHECK_EQUAL( json.substr( json.size() - 4 ), "\n]}\n" );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
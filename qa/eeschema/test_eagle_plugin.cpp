@@ -24,9 +24,12 @@
 
 #include <unit_test_utils/unit_test_utils.h>
 
+#include <eagle_parser.h>
 #include <kiway.h>
 #include <sch_io_mgr.h>
 
+#include <wx/xml/xml.h>
+
 #include "eeschema_test_utils.h"
 
 /**
@@ -67,3 +70,79 @@ BOOST_AUTO_TEST_CASE( Load )
     // const SCH_SHEET* sheet = pi->Load( fn.GetFullPath(), nullptr );
     // BOOST_CHECK_NE( nullptr, sheet );
 }
+
+
+/**
+ * Recursively compare two XML nodes, their attributes and their children.
+ */
+static void checkSameNodes( const wxXmlNode* aExpected, const wxXmlNode* aNode )
+{
+    for( ; aExpected && aNode; aExpected = aExpected->GetNext(), aNode = aNode->GetNext() )
+    {
+        BOOST_CHECK_EQUAL( aNode->GetType(), aExpected->GetType() );
+        BOOST_CHECK_EQUAL( aNode->GetName(), aExpected->GetName() );
+        BOOST_CHECK_EQUAL( aNode->GetContent(), aExpected->GetContent() );
+
+        const wxXmlAttribute* expectedAttr = aExpected->GetAttributes();
+        const wxXmlAttribute* attr = aNode->GetAttributes();
+
+        for( ; expectedAttr && attr; expectedAttr = expectedAttr->GetNext(), attr = attr->GetNext() )
+        {
+            BOOST_CHECK_EQUAL( attr->GetName(), expectedAttr->GetName() );
+            BOOST_CHECK_EQUAL( attr->GetValue(), expectedAttr->GetValue() );
+        }
+
+        BOOST_CHECK( !expectedAttr && !attr );
+
+        checkSameNodes( aExpected->GetChildren(), aNode->GetChildren() );
+    }
+
+    BOOST_CHECK( !aExpected && !aNode );
+}
+
+
+/**
+ * Check that the streamed elements are those of the document.
+ */
+BOOST_AUTO_TEST_CASE( StreamReader )
+{
+    const auto    fn = getEagleTestSchematic( "eagle-import-testfile.sch" );
+    wxXmlDocument xmlDocument;
+
+    BOOST_REQUIRE( xmlDocument.Load( fn.GetFullPath() ) );
+
+    NODE_MAP   drawing = MapChildren( MapChildren( xmlDocument.GetRoot() )["drawing"] );
+    wxXmlNode* expectedSheet = getChildrenNodes( MapChildren( drawing["schematic"] ), "sheets" );
+    wxString   version;
+    int        sheets = 0;
+
+    EAGLE_XML_READER reader;
+
+    reader.OnStart( "eagle",
+            [&]( const wxXmlNode& aNode )
+            {
+                version = aNode.GetAttribute( "version" );
+            } );
+
+    reader.OnElement( "eagle/drawing/layers",
+            [&]( std::unique_ptr<wxXmlNode> aNode )
+            {
+                checkSameNodes( drawing["layers"]->GetChildren(), aNode->GetChildren() );
+            } );
+
+    reader.OnElement( "eagle/drawing/schematic/sheets/sheet",
+            [&]( std::unique_ptr<wxXmlNode> aNode )
+            {
+                BOOST_REQUIRE( expectedSheet );
+                checkSameNodes( expectedSheet->GetChildren(), aNode->GetChildren() );
+
+                expectedSheet = expectedSheet->GetNext();
+                sheets++;
+            } );
+
+    reader.Parse( fn.GetFullPath() );
+
+    BOOST_CHECK_EQUAL( version, xmlDocument.GetRoot()->GetAttribute( "version" ) );
+    BOOST_CHECK( sheets > 0 );
+    BOOST_CHECK( !expectedSheet );
+}
@@ -0,0 +1,238 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file test_sch_lib_cache.cpp
+ * Tests of the symbol library caches, which parse the symbols when they are first needed.
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <wx/ffile.h>
+#include <wx/filename.h>
+
+#include <class_libentry.h>
+#include <properties.h>
+#include <sch_io_mgr.h>
+#include <symbol_lib_table.h>
+
+
+/**
+ * Writes a temporary library file, removed at the end of the test.
+ */
+struct TEMP_LIB_FILE
+{
+    wxString m_path;
+
+    TEMP_LIB_FILE( const std::string& aContents, const wxString& aExtension )
+    {
+        wxString base = wxFileName::CreateTempFileName( "qa_sch_lib" );
+
+        wxRemoveFile( base );
+        m_path = base + "." + aExtension;
+
+        wxFFile file( m_path, "wb" );
+        file.Write( aContents.data(), aContents.size() );
+    }
+
+    ~TEMP_LIB_FILE()
+    {
+        wxRemoveFile( m_path );
+    }
+};
+
+
+static const std::string sexprLibrary =
+        "(kicad_symbol_lib (version 20200126) (host kicad_symbol_editor \"5.99\")\n"
+        "  (symbol \"GND\" (power)\n"
+        "    (symbol \"GND_0_1\"\n"
+        "      (rectangle (start -1 -1) (end 1 1) (stroke (width 0.254)) (fill (type none)))\n"
+        "    )\n"
+        "  )\n"
+        "  (symbol \"R\"\n"
+        "    (symbol \"R_0_1\" (rectangle (start -1.016 -2.54) (end 1.016 2.54)\n"
+        "      (stroke (width 0.254)) (fill (type none))))\n"
+        "  )\n"
+        "  (symbol \"R_Small\" (extends \"R\"))\n"
+        ")\n";
+
+
+static const std::string legacyLibrary =
+        "EESchema-LIBRARY Version 2.4\n"
+        "#encoding utf-8\n"
+        "#\n"
+        "DEF GND #PWR 0 0 Y Y 1 F P\n"
+        "F0 \"#PWR\" 0 -250 50 H I C CNN\n"
+        "F1 \"GND\" 0 -150 50 H V C CNN\n"
+        "DRAW\n"
+        "P 2 0 1 0 0 0 0 -50 N\n"
+        "ENDDRAW\n"
+        "ENDDEF\n"
+        "#\n"
+        "DEF R R 0 0 N Y 1 F N\n"
+        "F0 \"R\" 80 0 50 V V C CNN\n"
+        "F1 \"R\" 0 0 50 V V C CNN\n"
+        "ALIAS R_Small\n"
+        "$FPLIST\n"
+        " ENDDEF\n"
+        "$ENDFPLIST\n"
+        "DRAW\n"
+        "S -40 -100 40 100 0 1 10 N\n"
+        "ENDDRAW\n"
+        "ENDDEF\n"
+        "#\n"
+        "#End Library\n";
+
+
+static void checkLibrary( SCH_IO_MGR::SCH_FILE_T aType, const std::string& aContents,
+                          const wxString& aExtension )
+{
+    TEMP_LIB_FILE                   lib( aContents, aExtension );
+    SCH_PLUGIN::SCH_PLUGIN_RELEASER pi( SCH_IO_MGR::FindPlugin( aType ) );
+    wxArrayString                   names;
+
+    pi->EnumerateSymbolLib( names, lib.m_path );
+
+    BOOST_REQUIRE_EQUAL( names.size(), 3 );
+    BOOST_CHECK_EQUAL( names[0], "GND" );
+    BOOST_CHECK_EQUAL( names[1], "R" );
+    BOOST_CHECK_EQUAL( names[2], "R_Small" );
+
+    PROPERTIES powerOnly;
+    powerOnly[SYMBOL_LIB_TABLE::PropPowerSymsOnly] = "";
+
+    names.clear();
+    pi->EnumerateSymbolLib( names, lib.m_path, &powerOnly );
+
+    BOOST_REQUIRE_EQUAL( names.size(), 1 );
+    BOOST_CHECK_EQUAL( names[0], "GND" );
+
+    // The alias is parsed with its parent
+    LIB_PART* alias = pi->LoadSymbol( lib.m_path, "R_Small" );
+
+    BOOST_REQUIRE( alias );
+    BOOST_CHECK( alias->IsAlias() );
+    BOOST_REQUIRE( alias->GetParent().lock() );
+    BOOST_CHECK_EQUAL( alias->GetParent().lock()->GetName(), "R" );
+    BOOST_CHECK_EQUAL( alias->GetParent().lock().get(), pi->LoadSymbol( lib.m_path, "R" ) );
+
+    BOOST_CHECK( pi->LoadSymbol( lib.m_path, "GND" )->IsPower() );
+    BOOST_CHECK( pi->LoadSymbol( lib.m_path, "C" ) == nullptr );
+
+    // Parsed or not, the symbols are all listed
+    std::vector<LIB_PART*> symbols;
+
+    pi->EnumerateSymbolLib( symbols, lib.m_path );
+    BOOST_CHECK_EQUAL( symbols.size(), 3 );
+
+    names.clear();
+    pi->EnumerateSymbolLib( names, lib.m_path );
+    BOOST_CHECK_EQUAL( names.size(), 3 );
+}
+
+
+BOOST_AUTO_TEST_SUITE( SchLibCache )
+
+
+/**
+ * Checks that the symbols of a s-expression library are found before they are parsed.
+ */
+BOOST_AUTO_TEST_CASE( SexprLibrary )
+{
+    checkLibrary( SCH_IO_MGR::SCH_KICAD, sexprLibrary, "kicad_sym" );
+}
+
+
+/**
+ * Checks that the symbols and aliases of a legacy library are found before they are parsed.
+ */
+BOOST_AUTO_TEST_CASE( LegacyLibrary )
+{
+    checkLibrary( SCH_IO_MGR::SCH_LEGACY, legacyLibrary, "lib" );
+}
+
+
+/**
+ * Checks that a broken symbol is reported when it is loaded, and stays listed.
+ */
+BOOST_AUTO_TEST_CASE( BrokenSymbol )
+{
+    TEMP_LIB_FILE lib( "(kicad_symbol_lib (version 20200126) (host kicad_symbol_editor \"5.99\")\n"
+                       "  (symbol \"A\" (extends \"missing\"))\n"
+                       "  (symbol \"B\")\n"
+                       ")\n",
+                       "kicad_sym" );
+    SCH_PLUGIN::SCH_PLUGIN_RELEASER pi( SCH_IO_MGR::FindPlugin( SCH_IO_MGR::SCH_KICAD ) );
+    wxArrayString                   names;
+
+    pi->EnumerateSymbolLib( names, lib.m_path );
+    BOOST_CHECK_EQUAL( names.size(), 2 );
+
+    BOOST_CHECK_THROW( pi->LoadSymbol( lib.m_path, "A" ), IO_ERROR );
+    BOOST_CHECK_THROW( pi->LoadSymbol( lib.m_path, "A" ), IO_ERROR );
+    BOOST_CHECK( pi->LoadSymbol( lib.m_path, "B" ) );
+
+    names.clear();
+    pi->EnumerateSymbolLib( names, lib.m_path );
+    BOOST_CHECK_EQUAL( names.size(), 2 );
+}
+
+
+/**
+ * Checks that a flattened derived symbol is shared until its library changes.
+ */
+BOOST_AUTO_TEST_CASE( FlattenedSymbol )
+{
+    TEMP_LIB_FILE    lib( sexprLibrary, "kicad_sym" );
+    SYMBOL_LIB_TABLE table;
+
+    table.InsertRow( new SYMBOL_LIB_TABLE_ROW( "test", lib.m_path, "KiCad" ) );
+
+    std::shared_ptr<const LIB_PART> flattened = table.LoadFlattenedSymbol( "test", "R_Small" );
+
+    BOOST_REQUIRE( flattened );
+    BOOST_CHECK( !flattened->IsAlias() );
+    BOOST_CHECK_EQUAL( flattened->GetName(), "R_Small" );
+    BOOST_CHECK_EQUAL( flattened->GetDrawItems().size( LIB_RECTANGLE_T ), 1 );
+
+    BOOST_CHECK_EQUAL( table.LoadFlattenedSymbol( "test", "R_Small" ), flattened );
+
+    // The root symbols are copies
+    std::shared_ptr<const LIB_PART> root = table.LoadFlattenedSymbol( "test", "R" );
+
+    BOOST_REQUIRE( root );
+    BOOST_CHECK( root.get() != table.LoadSymbol( "test", "R" ) );
+    BOOST_CHECK( table.LoadFlattenedSymbol( "test", "C" ) == nullptr );
+
+    // Saving a symbol of the library flattens the derived symbols again
+    std::unique_ptr<LIB_PART> parent( new LIB_PART( *table.LoadSymbol( "test", "R" ) ) );
+
+    table.SaveSymbol( "test", parent.get() );
+
+    std::shared_ptr<const LIB_PART> reflattened = table.LoadFlattenedSymbol( "test", "R_Small" );
+
+    BOOST_REQUIRE( reflattened );
+    BOOST_CHECK( reflattened != flattened );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,145 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file test_sch_reference_list.cpp
+ * Tests of the annotation of a SCH_REFERENCE_LIST.
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+// Code under test
+#include <sch_reference_list.h>
+
+#include <class_libentry.h>
+#include <sch_component.h>
+
+#include <memory>
+
+
+class TEST_SCH_REFERENCE_LIST_FIXTURE
+{
+public:
+    TEST_SCH_REFERENCE_LIST_FIXTURE() :
+            m_resistor( "R" ),
+            m_gate( "74HC00" )
+    {
+        m_gate.SetUnitCount( 2 );
+    }
+
+    /**
+     * Adds a component with the given reference to the list, left to right.
+     */
+    void addComponent( LIB_PART& aPart, const wxString& aRef, const wxString& aValue )
+    {
+        int x = (int) m_components.size() * 1000;
+
+        m_components.emplace_back( new SCH_COMPONENT( wxPoint( x, 0 ) ) );
+
+        SCH_COMPONENT* comp = m_components.back().get();
+
+        comp->SetRef( &m_path, aRef );
+        comp->GetField( VALUE )->SetText( aValue );
+
+        SCH_REFERENCE ref( comp, &aPart, m_path );
+        m_refs.AddItem( ref );
+    }
+
+    /**
+     * Annotates the list as the schematic editor does.
+     */
+    void annotate()
+    {
+        m_refs.SplitReferences();
+        m_refs.SortByXCoordinate();
+        m_refs.Annotate( false, 0, 0, SCH_MULTI_UNIT_REFERENCE_MAP() );
+        m_refs.SortByXCoordinate();
+    }
+
+    wxString fullRef( int aIndex )
+    {
+        return m_refs[aIndex].GetRef() + m_refs[aIndex].GetRefNumber();
+    }
+
+    LIB_PART                                    m_resistor;
+    LIB_PART                                    m_gate;
+    SCH_SHEET_PATH                              m_path;
+    std::vector<std::unique_ptr<SCH_COMPONENT>> m_components;
+    SCH_REFERENCE_LIST                          m_refs;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( SchReferenceList, TEST_SCH_REFERENCE_LIST_FIXTURE )
+
+
+/**
+ * Checks that the new references take the first free numbers of their prefix.
+ */
+BOOST_AUTO_TEST_CASE( FreeNumbers )
+{
+    addComponent( m_resistor, "R1", "10k" );
+    addComponent( m_resistor, "R?", "10k" );
+    addComponent( m_resistor, "R?", "1k" );
+    addComponent( m_resistor, "R3", "1k" );
+    addComponent( m_resistor, "R?", "1k" );
+    addComponent( m_resistor, "C?", "1u" );
+
+    annotate();
+
+    BOOST_REQUIRE_EQUAL( m_refs.GetCount(), 6 );
+
+    // Sorted by prefix, then left to right
+    BOOST_CHECK_EQUAL( fullRef( 0 ), "C1" );
+    BOOST_CHECK_EQUAL( fullRef( 1 ), "R1" );
+    BOOST_CHECK_EQUAL( fullRef( 2 ), "R2" );
+    BOOST_CHECK_EQUAL( fullRef( 3 ), "R4" );
+    BOOST_CHECK_EQUAL( fullRef( 4 ), "R3" );
+    BOOST_CHECK_EQUAL( fullRef( 5 ), "R5" );
+}
+
+
+/**
+ * Checks that the units of a multi-unit part are grouped into packages by value.
+ */
+BOOST_AUTO_TEST_CASE( MultiUnit )
+{
+    addComponent( m_gate, "U?", "74HC00" );
+    addComponent( m_gate, "U?", "74HC04" );
+    addComponent( m_gate, "U?", "74HC00" );
+    addComponent( m_gate, "U?", "74HC00" );
+
+    annotate();
+
+    BOOST_REQUIRE_EQUAL( m_refs.GetCount(), 4 );
+
+    BOOST_CHECK_EQUAL( fullRef( 0 ), "U1" );
+    BOOST_CHECK_EQUAL( m_refs[0].GetUnit(), 1 );
+    BOOST_CHECK_EQUAL( fullRef( 1 ), "U2" );
+    BOOST_CHECK_EQUAL( m_refs[1].GetUnit(), 1 );
+    BOOST_CHECK_EQUAL( fullRef( 2 ), "U1" );
+    BOOST_CHECK_EQUAL( m_refs[2].GetUnit(), 2 );
+    BOOST_CHECK_EQUAL( fullRef( 3 ), "U3" );
+    BOOST_CHECK_EQUAL( m_refs[3].GetUnit(), 1 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
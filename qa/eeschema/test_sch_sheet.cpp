@@ -29,6 +29,7 @@
 #include <unit_test_utils/unit_test_utils.h>
 
 // Code under test
+#include <sch_screen.h>
 #include <sch_sheet.h>
 #include <schematic.h>
 
@@ -102,6 +103,46 @@ BOOST_AUTO_TEST_CASE( SchematicParent )
     BOOST_CHECK_EQUAL( m_sheet.IsRootSheet(), true );
 }
 
+/**
+ * Test that the hierarchy of the schematic follows the sheets added and removed
+ */
+BOOST_AUTO_TEST_CASE( SchematicSheetList )
+{
+    SCHEMATIC schematic( nullptr );
+    SCH_SHEET* root = new SCH_SHEET( &schematic );
+
+    root->SetScreen( new SCH_SCREEN( &schematic ) );
+    root->GetScreen()->SetFileName( "root.kicad_sch" );
+    root->SetFileName( "root.kicad_sch" );
+    schematic.SetRoot( root );
+
+    BOOST_CHECK_EQUAL( schematic.GetSheets().size(), 1 );
+
+    SCH_SHEET* child = new SCH_SHEET( nullptr, wxPoint( 100, 100 ) );
+
+    child->SetScreen( new SCH_SCREEN( &schematic ) );
+    child->SetFileName( "child.kicad_sch" );
+    root->GetScreen()->Append( child );
+
+    SCH_SHEET_LIST sheets = schematic.GetSheets();
+
+    BOOST_REQUIRE_EQUAL( sheets.size(), 2 );
+    BOOST_CHECK_EQUAL( sheets[1].Last(), child );
+
+    // The copy returned can be changed without changing the hierarchy
+    sheets.clear();
+    BOOST_CHECK_EQUAL( schematic.GetSheets().size(), 2 );
+
+    root->GetScreen()->Remove( child );
+    BOOST_CHECK_EQUAL( schematic.GetSheets().size(), 1 );
+
+    root->GetScreen()->Append( child );
+    BOOST_CHECK_EQUAL( schematic.GetSheets().size(), 2 );
+
+    schematic.Reset();
+    BOOST_CHECK_EQUAL( schematic.GetSheets().size(), 0 );
+}
+
 /**
  * Test adding pins to a sheet
  */
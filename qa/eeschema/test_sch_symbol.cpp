@@ -31,6 +31,8 @@
 // Code under test
 #include <sch_component.h>
 
+#include <class_libentry.h>
+#include <lib_pin.h>
 #include <sch_edit_frame.h>
 
 class TEST_SCH_SYMBOL_FIXTURE
@@ -81,4 +83,39 @@ BOOST_AUTO_TEST_CASE( Orientation )
 }
 
 
+/**
+ * Check that the copies of a symbol share its library symbol, and keep their own pins.
+ */
+BOOST_AUTO_TEST_CASE( SharedLibSymbol )
+{
+    SCH_SHEET_PATH path;
+    LIB_PART*      part = new LIB_PART( "R", nullptr );
+    LIB_PIN*       pin = new LIB_PIN( part );
+
+    pin->SetNumber( "1" );
+    part->AddDrawItem( pin );
+    m_symbol.SetLibSymbol( part );
+
+    SCH_COMPONENT copy( m_symbol );
+
+    BOOST_CHECK_EQUAL( copy.GetPartRef().get(), part );
+    BOOST_REQUIRE_EQUAL( copy.GetSchPins( &path ).size(), 1 );
+    BOOST_CHECK( copy.GetSchPins( &path )[0]->GetParentComponent() == &copy );
+    BOOST_CHECK_EQUAL( copy.GetSchPins( &path )[0]->GetLibPin(), pin );
+
+    // Giving another symbol to the copy leaves the original alone
+    copy.SetLibSymbol( new LIB_PART( "C", nullptr ) );
+
+    BOOST_CHECK_EQUAL( m_symbol.GetPartRef().get(), part );
+    BOOST_CHECK_EQUAL( m_symbol.GetSchPins( &path ).size(), 1 );
+    BOOST_CHECK_EQUAL( copy.GetSchPins( &path ).size(), 0 );
+
+    copy.SwapData( &m_symbol );
+
+    BOOST_CHECK_EQUAL( copy.GetPartRef().get(), part );
+    BOOST_CHECK_EQUAL( copy.GetSchPins( &path ).size(), 1 );
+    BOOST_CHECK_EQUAL( m_symbol.GetSchPins( &path ).size(), 0 );
+}
+
+
 BOOST_AUTO_TEST_SUITE_END()
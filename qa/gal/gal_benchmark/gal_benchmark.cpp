@@ -0,0 +1,532 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file gal_benchmark.cpp
+ * Times the rendering of a board by the OpenGL GAL and the PCB painter, without any user.
+ *
+ * The board is displayed by a PCB_DRAW_PANEL_GAL, then a script of view changes is
+ * replayed a number of times, each command being followed by a frame drawn at once:
+ *      fit                 views the whole board
+ *      zoom <factor>       zooms about the center of the view
+ *      pan <dx> <dy>       moves the view, by fractions of its size
+ *      recache             recaches all the items, as a change of the display options does
+ *
+ * The percentiles of the frame times (command included) of each command, the GPU times of
+ * the frames and the GPU memory used by the cached items are the figures to compare
+ * between builds.
+ *
+ * The GAL draws on a window only: to run it without a display (CI), use a virtual X server
+ * and a software GL implementation, without waiting for the vertical blank:
+ *      LIBGL_ALWAYS_SOFTWARE=1 vblank_mode=0 xvfb-run -s "-screen 0 1920x1080x24" \
+ *              gal_benchmark -r 20 board.kicad_pcb
+ */
+
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <wx/app.h>
+#include <wx/cmdline.h>
+#include <wx/ffile.h>
+#include <wx/frame.h>
+#include <wx/tokenzr.h>
+#include <wx/utils.h>
+
+#include <class_board.h>
+#include <gal/graphics_abstraction_layer.h>
+#include <pcb_draw_panel_gal.h>
+#include <profile.h>
+#include <view/view.h>
+
+#include <pcbnew_utils/board_file_utils.h>
+
+#include <qa_utils/utility_program.h>
+
+
+/**
+ * Tool-specific return codes
+ */
+enum GAL_BENCHMARK_RET_CODES
+{
+    LOAD_FAILED = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+    NO_OPENGL,
+};
+
+
+static const char* g_defaultScript =
+        "fit\n"
+        "recache\n"
+        "zoom 1.5\nzoom 1.5\nzoom 1.5\nzoom 1.5\nzoom 1.5\nzoom 1.5\n"
+        "pan 0.5 0\npan 0.5 0\npan 0.5 0\npan 0.5 0\n"
+        "pan 0 0.5\npan 0 0.5\npan 0 0.5\npan 0 0.5\n"
+        "pan -0.5 0\npan -0.5 0\npan -0.5 0\npan -0.5 0\n"
+        "pan 0 -0.5\npan 0 -0.5\npan 0 -0.5\npan 0 -0.5\n"
+        "zoom 0.667\nzoom 0.667\nzoom 0.667\nzoom 0.667\nzoom 0.667\nzoom 0.667\n";
+
+
+/**
+ * A command of the script
+ */
+struct BENCH_STEP
+{
+    std::string m_Name;     ///< fit, zoom, pan or recache
+    double      m_X;        ///< zoom factor, or horizontal pan
+    double      m_Y;        ///< vertical pan
+};
+
+
+/**
+ * The times of the frames of one command, in milliseconds
+ */
+struct BENCH_TIMES
+{
+    std::vector<double> m_Frame;
+    std::vector<double> m_GpuItems;         ///< empty if the GAL does not measure them
+    std::vector<double> m_GpuCompositing;
+};
+
+
+/**
+ * Parse a script, one command per line, '#' starting a comment.
+ */
+static bool parseScript( const wxString& aScript, std::vector<BENCH_STEP>& aSteps,
+                         wxString& aError )
+{
+    wxStringTokenizer lines( aScript, "\r\n" );
+
+    while( lines.HasMoreTokens() )
+    {
+        wxString line = lines.GetNextToken().BeforeFirst( '#' ).Trim().Trim( false );
+
+        if( line.IsEmpty() )
+            continue;
+
+        wxArrayString words = wxSplit( line, ' ' );
+
+        words.erase( std::remove( words.begin(), words.end(), wxEmptyString ), words.end() );
+
+        BENCH_STEP step = { words[0].Lower().ToStdString(), 0.0, 0.0 };
+        size_t     argCount = 0;
+
+        if( step.m_Name == "zoom" )
+            argCount = 1;
+        else if( step.m_Name == "pan" )
+            argCount = 2;
+        else if( step.m_Name != "fit" && step.m_Name != "recache" )
+        {
+            aError.Printf( "Unknown command '%s'", line );
+            return false;
+        }
+
+        if( words.size() != argCount + 1
+                || ( argCount > 0 && !words[1].ToCDouble( &step.m_X ) )
+                || ( argCount > 1 && !words[2].ToCDouble( &step.m_Y ) )
+                || ( step.m_Name == "zoom" && step.m_X <= 0.0 ) )
+        {
+            aError.Printf( "Invalid arguments in '%s'", line );
+            return false;
+        }
+
+        aSteps.push_back( step );
+    }
+
+    if( aSteps.empty() )
+    {
+        aError = "Empty script";
+        return false;
+    }
+
+    return true;
+}
+
+
+/**
+ * The nearest-rank percentile of sorted times.
+ */
+static double percentile( const std::vector<double>& aSorted, int aPercent )
+{
+    size_t rank = ( aSorted.size() * aPercent + 99 ) / 100;
+
+    return aSorted[std::max<size_t>( rank, 1 ) - 1];
+}
+
+
+/**
+ * A canvas drawing its frames when asked to, rather than on paint events.
+ */
+class BENCHMARK_PANEL : public PCB_DRAW_PANEL_GAL
+{
+public:
+    BENCHMARK_PANEL( wxWindow* aParent, KIGFX::GAL_DISPLAY_OPTIONS& aOptions ) :
+            PCB_DRAW_PANEL_GAL( aParent, wxID_ANY, wxDefaultPosition, wxDefaultSize, aOptions,
+                                GAL_TYPE_OPENGL )
+    {
+    }
+
+    /**
+     * Draw a frame now, as the paint event handler does.
+     * @return the time of the frame, in milliseconds
+     */
+    double DrawFrame()
+    {
+        wxPaintEvent event;
+        onPaint( event );
+
+        return m_frameTime;
+    }
+
+    /**
+     * The paint event handler falls back to Cairo, with a message box, when OpenGL fails:
+     * there is nobody to close it, so give up instead.
+     */
+    bool SwitchBackend( GAL_TYPE aGalType ) override
+    {
+        if( aGalType != GAL_TYPE_OPENGL )
+            throw std::runtime_error( "OpenGL cannot be used" );
+
+        return PCB_DRAW_PANEL_GAL::SwitchBackend( aGalType );
+    }
+};
+
+
+class GAL_BENCHMARK_APP : public wxApp
+{
+public:
+    GAL_BENCHMARK_APP() :
+            m_repeat( 10 ),
+            m_peakCacheMemory( 0 ),
+            m_lastCacheMemory( 0 )
+    {
+    }
+
+    void OnInitCmdLine( wxCmdLineParser& aParser ) override;
+    bool OnCmdLineParsed( wxCmdLineParser& aParser ) override;
+
+    /// Run the benchmark instead of an event loop
+    int OnRun() override;
+
+private:
+    void applyStep( KIGFX::VIEW* aView, const BENCH_STEP& aStep );
+
+    void reportText( const std::vector<std::string>& aNames,
+                     const std::map<std::string, BENCH_TIMES>& aTimes ) const;
+    void reportCsv( const std::vector<std::string>& aNames,
+                    const std::map<std::string, BENCH_TIMES>& aTimes ) const;
+
+    wxString               m_boardFile;
+    wxString               m_scriptFile;
+    wxString               m_format;
+    long                   m_repeat;
+
+    std::unique_ptr<BOARD> m_board;         ///< outlives the canvas, destroyed with the frame
+    size_t                 m_peakCacheMemory;
+    size_t                 m_lastCacheMemory;
+};
+
+
+IMPLEMENT_APP( GAL_BENCHMARK_APP )
+
+
+void GAL_BENCHMARK_APP::OnInitCmdLine( wxCmdLineParser& aParser )
+{
+    wxApp::OnInitCmdLine( aParser );
+
+    aParser.AddUsageText( "This program times the rendering of a PCB file by the OpenGL GAL." );
+    aParser.AddOption( "r", "repeat", "replay the script the given number of times (default 10)",
+                       wxCMD_LINE_VAL_NUMBER );
+    aParser.AddOption( "s", "script", "file of the view commands to replay "
+                       "(fit, zoom <factor>, pan <dx> <dy>, recache)" );
+    aParser.AddOption( "f", "format", "print the timings as 'text' (default) or 'csv'" );
+    aParser.AddParam( "input file", wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL );
+}
+
+
+bool GAL_BENCHMARK_APP::OnCmdLineParsed( wxCmdLineParser& aParser )
+{
+    if( !wxApp::OnCmdLineParsed( aParser ) )
+        return false;
+
+    m_format = "text";
+
+    aParser.Found( "repeat", &m_repeat );
+    aParser.Found( "script", &m_scriptFile );
+    aParser.Found( "format", &m_format );
+
+    if( m_format != "text" && m_format != "csv" )
+    {
+        std::cerr << "Unknown format: " << m_format << std::endl;
+        return false;
+    }
+
+    if( aParser.GetParamCount() )
+        m_boardFile = aParser.GetParam( 0 );
+
+    return true;
+}
+
+
+int GAL_BENCHMARK_APP::OnRun()
+{
+    wxString script = g_defaultScript;
+
+    if( !m_scriptFile.IsEmpty() )
+    {
+        wxFFile file( m_scriptFile );
+
+        if( !file.IsOpened() || !file.ReadAll( &script ) )
+        {
+            std::cerr << "Cannot read the script " << m_scriptFile << std::endl;
+            return KI_TEST::RET_CODES::BAD_CMDLINE;
+        }
+    }
+
+    std::vector<BENCH_STEP> steps;
+    wxString                error;
+
+    if( !parseScript( script, steps, error ) )
+    {
+        std::cerr << error << std::endl;
+        return KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    m_board = KI_TEST::ReadBoardFromFileOrStream( m_boardFile.ToStdString() );
+
+    if( !m_board )
+        return GAL_BENCHMARK_RET_CODES::LOAD_FAILED;
+
+    m_board->BuildConnectivity();
+
+    // The frame is destroyed by the application cleanup, after OnRun()
+    wxFrame* frame = new wxFrame( nullptr, wxID_ANY, "GAL benchmark", wxDefaultPosition,
+                                  wxSize( 1280, 800 ) );
+
+    KIGFX::GAL_DISPLAY_OPTIONS options;
+    options.gl_antialiasing_mode = KIGFX::OPENGL_ANTIALIASING_MODE::NONE;
+
+    BENCHMARK_PANEL* panel = new BENCHMARK_PANEL( frame, options );
+
+    frame->Show( true );
+
+    // The GL canvas can be drawn on once it is mapped on the screen
+    for( int ii = 0; ii < 500 && !panel->GetGAL()->IsVisible(); ++ii )
+    {
+        wxYield();
+        wxMilliSleep( 10 );
+    }
+
+    if( !panel->GetGAL()->IsVisible() )
+    {
+        std::cerr << "The canvas cannot be shown (no display?)" << std::endl;
+        return GAL_BENCHMARK_RET_CODES::NO_OPENGL;
+    }
+
+    panel->DisplayBoard( m_board.get() );
+    panel->StartDrawing();
+    panel->GetGAL()->SetCollectFrameStats( true );
+
+    KIGFX::VIEW*                       view = panel->GetView();
+    std::vector<std::string>           names;
+    std::map<std::string, BENCH_TIMES> times;
+
+    try
+    {
+        // The first frame creates the GL resources and caches the items: it is not counted
+        applyStep( view, { "fit", 0.0, 0.0 } );
+        panel->DrawFrame();
+
+        for( long run = 0; run < std::max( 1L, m_repeat ); ++run )
+        {
+            for( const BENCH_STEP& step : steps )
+            {
+                PROF_COUNTER timer;
+
+                applyStep( view, step );
+                panel->DrawFrame();
+
+                const KIGFX::GAL_FRAME_STATS& stats = panel->GetGAL()->GetFrameStats();
+
+                if( !times.count( step.m_Name ) )
+                    names.push_back( step.m_Name );
+
+                BENCH_TIMES& stepTimes = times[step.m_Name];
+
+                stepTimes.m_Frame.push_back( timer.msecs() );
+
+                // The GPU queries of a frame are read during the next one, without waiting
+                if( stats.m_gpuItemsTime >= 0.0 )
+                    stepTimes.m_GpuItems.push_back( stats.m_gpuItemsTime );
+
+                if( stats.m_gpuCompositingTime >= 0.0 )
+                    stepTimes.m_GpuCompositing.push_back( stats.m_gpuCompositingTime );
+
+                m_peakCacheMemory = std::max( m_peakCacheMemory, stats.m_cacheMemory );
+                m_lastCacheMemory = stats.m_cacheMemory;
+            }
+        }
+    }
+    catch( const std::runtime_error& e )
+    {
+        std::cerr << e.what() << std::endl;
+        return GAL_BENCHMARK_RET_CODES::NO_OPENGL;
+    }
+
+    if( m_format == "csv" )
+        reportCsv( names, times );
+    else
+        reportText( names, times );
+
+    frame->Close( true );
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+void GAL_BENCHMARK_APP::applyStep( KIGFX::VIEW* aView, const BENCH_STEP& aStep )
+{
+    if( aStep.m_Name == "fit" )
+    {
+        EDA_RECT bbox = m_board->GetBoundingBox();
+
+        if( bbox.GetWidth() > 0 && bbox.GetHeight() > 0 )
+            aView->SetViewport( BOX2D( bbox.GetOrigin(), bbox.GetSize() ) );
+    }
+    else if( aStep.m_Name == "zoom" )
+    {
+        aView->SetScale( aView->GetScale() * aStep.m_X, aView->GetCenter() );
+    }
+    else if( aStep.m_Name == "pan" )
+    {
+        BOX2D viewport = aView->GetViewport();
+
+        aView->SetCenter( aView->GetCenter() + VECTOR2D( viewport.GetWidth() * aStep.m_X,
+                                                         viewport.GetHeight() * aStep.m_Y ) );
+    }
+    else if( aStep.m_Name == "recache" )
+    {
+        aView->RecacheAllItems();
+        aView->MarkDirty();
+    }
+}
+
+
+/**
+ * @return the percentiles of aTimes, in the order of the report columns
+ */
+static std::vector<double> summary( std::vector<double> aTimes )
+{
+    if( aTimes.empty() )
+        return std::vector<double>( 5, -1.0 );
+
+    std::sort( aTimes.begin(), aTimes.end() );
+
+    double total = 0.0;
+
+    for( double time : aTimes )
+        total += time;
+
+    return { percentile( aTimes, 50 ), percentile( aTimes, 90 ), percentile( aTimes, 99 ),
+             aTimes.back(), total / aTimes.size() };
+}
+
+
+void GAL_BENCHMARK_APP::reportText( const std::vector<std::string>& aNames,
+                                    const std::map<std::string, BENCH_TIMES>& aTimes ) const
+{
+    char line[256];
+
+    snprintf( line, sizeof( line ), "%-10s %-16s %6s %9s %9s %9s %9s %9s\n", "", "",
+              "frames", "p50 ms", "p90", "p99", "max", "mean" );
+    std::cout << line;
+
+    for( const std::string& name : aNames )
+    {
+        const BENCH_TIMES& times = aTimes.at( name );
+
+        std::vector<std::pair<const char*, const std::vector<double>*>> series = {
+            { "frame", &times.m_Frame },
+            { "GPU items", &times.m_GpuItems },
+            { "GPU compositing", &times.m_GpuCompositing }
+        };
+
+        for( const auto& measure : series )
+        {
+            std::vector<double> s = summary( *measure.second );
+
+            if( measure.second->empty() )
+            {
+                snprintf( line, sizeof( line ), "%-10s %-16s %6d %9s\n", name.c_str(),
+                          measure.first, 0, "n/a" );
+            }
+            else
+            {
+                snprintf( line, sizeof( line ), "%-10s %-16s %6d %9.3f %9.3f %9.3f %9.3f %9.3f\n",
+                          name.c_str(), measure.first, (int) measure.second->size(), s[0], s[1],
+                          s[2], s[3], s[4] );
+            }
+
+            std::cout << line;
+        }
+    }
+
+    snprintf( line, sizeof( line ), "\nGPU memory of the cached items: %.1f MB (peak %.1f MB)\n",
+              m_lastCacheMemory / ( 1024.0 * 1024.0 ), m_peakCacheMemory / ( 1024.0 * 1024.0 ) );
+    std::cout << line;
+}
+
+
+void GAL_BENCHMARK_APP::reportCsv( const std::vector<std::string>& aNames,
+                                   const std::map<std::string, BENCH_TIMES>& aTimes ) const
+{
+    std::cout << "command,measure,frames,p50_ms,p90_ms,p99_ms,max_ms,mean_ms" << std::endl;
+
+    for( const std::string& name : aNames )
+    {
+        const BENCH_TIMES& times = aTimes.at( name );
+
+        std::vector<std::pair<const char*, const std::vector<double>*>> series = {
+            { "frame", &times.m_Frame },
+            { "gpu_items", &times.m_GpuItems },
+            { "gpu_compositing", &times.m_GpuCompositing }
+        };
+
+        for( const auto& measure : series )
+        {
+            if( measure.second->empty() )
+                continue;
+
+            std::vector<double> s = summary( *measure.second );
+
+            std::cout << name << "," << measure.first << "," << measure.second->size() << ","
+                      << s[0] << "," << s[1] << "," << s[2] << "," << s[3] << "," << s[4]
+                      << std::endl;
+        }
+    }
+
+    std::cout << "cache_memory_bytes," << m_lastCacheMemory << std::endl;
+    std::cout << "peak_cache_memory_bytes," << m_peakCacheMemory << std::endl;
+}
@@ -0,0 +1,437 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file kimath_benchmark.cpp
+ * Times the main SHAPE_POLY_SET operations on a corpus of polygons.
+ *
+ * The corpus is a SHAPE_FILE_IO dump, as written by the polygon_generator tool of
+ * qa_pcbnew_tools (the pads, tracks and zones of a board) or by the zone filler when
+ * zone dumps are enabled (zones_dump.txt).  Every polygon set of the file is used, other
+ * shapes are skipped.
+ *
+ * Each benchmark is run once to warm up, then REPS times over the whole corpus.  The
+ * minimum and the median of the runs are the figures to compare between builds; the
+ * checksum shows whether both builds did the same work.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <geometry/poly_set_index.h>
+#include <geometry/seg.h>
+#include <geometry/shape.h>
+#include <geometry/shape_poly_set.h>
+
+
+using CLOCK = std::chrono::steady_clock;
+
+
+/**
+ * A polygon set of the corpus, and the inputs of the benchmarks derived from it
+ */
+struct BENCH_CASE
+{
+    SHAPE_POLY_SET        m_set;
+    SHAPE_POLY_SET        m_shifted;     ///< m_set moved by a quarter of its size
+    std::vector<VECTOR2I> m_points;      ///< a grid of points over the bounding box
+    std::vector<SEG>      m_segments;    ///< segments joining neighbouring grid points
+};
+
+
+using CORPUS = std::vector<BENCH_CASE>;
+
+///> Runs a benchmark over the corpus and returns a checksum of the results
+using BENCH_FUNC = std::function<long long( const CORPUS& )>;
+
+
+struct BENCHMARK
+{
+    char        m_triggerChar;
+    BENCH_FUNC  m_func;
+    std::string m_name;
+};
+
+
+///> Number of points per side of the grid of test points
+static const int GRID_SIZE = 64;
+
+///> Offset of Inflate() and Deflate(), 0.1 mm
+static const int OFFSET = 100000;
+
+static const int CIRCLE_SEGMENTS = 32;
+
+
+template <class OP>
+static long long forEachCopy( const CORPUS& aCorpus, OP aOp )
+{
+    long long acc = 0;
+
+    for( const BENCH_CASE& c : aCorpus )
+    {
+        SHAPE_POLY_SET copy = c.m_set;
+        aOp( copy, c );
+        acc += copy.TotalVertices();
+    }
+
+    return acc;
+}
+
+
+static long long benchUnion( const CORPUS& aCorpus )
+{
+    return forEachCopy( aCorpus,
+            []( SHAPE_POLY_SET& aSet, const BENCH_CASE& aCase )
+            {
+                aSet.BooleanAdd( aCase.m_shifted, SHAPE_POLY_SET::PM_FAST );
+            } );
+}
+
+
+static long long benchSubtract( const CORPUS& aCorpus )
+{
+    return forEachCopy( aCorpus,
+            []( SHAPE_POLY_SET& aSet, const BENCH_CASE& aCase )
+            {
+                aSet.BooleanSubtract( aCase.m_shifted, SHAPE_POLY_SET::PM_FAST );
+            } );
+}
+
+
+static long long benchIntersection( const CORPUS& aCorpus )
+{
+    return forEachCopy( aCorpus,
+            []( SHAPE_POLY_SET& aSet, const BENCH_CASE& aCase )
+            {
+                aSet.BooleanIntersection( aCase.m_shifted, SHAPE_POLY_SET::PM_FAST );
+            } );
+}
+
+
+static long long benchInflate( const CORPUS& aCorpus )
+{
+    return forEachCopy( aCorpus,
+            []( SHAPE_POLY_SET& aSet, const BENCH_CASE& )
+            {
+                aSet.Inflate( OFFSET, CIRCLE_SEGMENTS );
+            } );
+}
+
+
+static long long benchDeflate( const CORPUS& aCorpus )
+{
+    return forEachCopy( aCorpus,
+            []( SHAPE_POLY_SET& aSet, const BENCH_CASE& )
+            {
+                aSet.Deflate( OFFSET, CIRCLE_SEGMENTS );
+            } );
+}
+
+
+static long long benchFracture( const CORPUS& aCorpus )
+{
+    return forEachCopy( aCorpus,
+            []( SHAPE_POLY_SET& aSet, const BENCH_CASE& )
+            {
+                aSet.Fracture( SHAPE_POLY_SET::PM_FAST );
+            } );
+}
+
+
+static long long benchTriangulation( const CORPUS& aCorpus )
+{
+    long long acc = 0;
+
+    for( const BENCH_CASE& c : aCorpus )
+    {
+        // The corpus sets are never triangulated, so each copy is triangulated from scratch
+        SHAPE_POLY_SET copy = c.m_set;
+        copy.CacheTriangulation();
+
+        for( unsigned ii = 0; ii < copy.TriangulatedPolyCount(); ii++ )
+            acc += copy.TriangulatedPolygon( ii )->GetTriangleCount();
+    }
+
+    return acc;
+}
+
+
+static long long benchContains( const CORPUS& aCorpus )
+{
+    long long acc = 0;
+
+    for( const BENCH_CASE& c : aCorpus )
+    {
+        for( const VECTOR2I& p : c.m_points )
+            acc += c.m_set.Contains( p ) ? 1 : 0;
+    }
+
+    return acc;
+}
+
+
+static long long benchIndexContains( const CORPUS& aCorpus )
+{
+    long long acc = 0;
+
+    for( const BENCH_CASE& c : aCorpus )
+    {
+        // Includes building the index
+        POLY_SET_INDEX index( c.m_set );
+
+        for( const VECTOR2I& p : c.m_points )
+            acc += index.Contains( p ) ? 1 : 0;
+    }
+
+    return acc;
+}
+
+
+static long long benchCollide( const CORPUS& aCorpus )
+{
+    long long acc = 0;
+
+    for( const BENCH_CASE& c : aCorpus )
+    {
+        for( const SEG& seg : c.m_segments )
+            acc += c.m_set.Collide( seg ) ? 1 : 0;
+    }
+
+    return acc;
+}
+
+
+/**
+ * List of available benchmarks
+ */
+static std::vector<BENCHMARK> benchmarkList =
+{
+    { 'u', benchUnion,          "BooleanAdd" },
+    { 's', benchSubtract,       "BooleanSubtract" },
+    { 'i', benchIntersection,   "BooleanIntersection" },
+    { 'I', benchInflate,        "Inflate" },
+    { 'D', benchDeflate,        "Deflate" },
+    { 'f', benchFracture,       "Fracture" },
+    { 't', benchTriangulation,  "CacheTriangulation" },
+    { 'p', benchContains,       "Contains (PointInside)" },
+    { 'x', benchIndexContains,  "POLY_SET_INDEX::Contains" },
+    { 'c', benchCollide,        "Collide (SEG)" },
+};
+
+
+/**
+ * Reads the polygon sets of a SHAPE_FILE_IO dump.  Each shape is written as
+ * "shape <type> <name> <SHAPE::Format() output>", on one or more lines.
+ */
+static bool readCorpus( const std::string& aFilename, CORPUS& aCorpus )
+{
+    std::ifstream file( aFilename );
+
+    if( !file )
+        return false;
+
+    std::stringstream ss;
+    ss << file.rdbuf();
+
+    std::string token;
+
+    while( ss >> token )
+    {
+        if( token != "shape" )
+            continue;
+
+        int         type;
+        std::string name;
+
+        if( !( ss >> type >> name ) )
+            break;
+
+        if( type != SH_POLY_SET )
+            continue;
+
+        BENCH_CASE c;
+
+        if( !c.m_set.Parse( ss ) )
+            return false;
+
+        if( c.m_set.OutlineCount() )
+            aCorpus.push_back( std::move( c ) );
+    }
+
+    return true;
+}
+
+
+static void prepareCase( BENCH_CASE& aCase )
+{
+    BOX2I   bbox = aCase.m_set.BBox();
+    int64_t w = bbox.GetWidth();
+    int64_t h = bbox.GetHeight();
+
+    aCase.m_shifted = aCase.m_set;
+    aCase.m_shifted.Move( VECTOR2I( w / 4, h / 4 ) );
+
+    for( int iy = 0; iy <= GRID_SIZE; iy++ )
+    {
+        for( int ix = 0; ix <= GRID_SIZE; ix++ )
+        {
+            aCase.m_points.emplace_back( bbox.GetX() + (int) ( w * ix / GRID_SIZE ),
+                                         bbox.GetY() + (int) ( h * iy / GRID_SIZE ) );
+
+            // A diagonal of the grid cell on the left of and above the point
+            if( ix > 0 && iy > 0 )
+            {
+                size_t last = aCase.m_points.size() - 1;
+                aCase.m_segments.emplace_back( aCase.m_points[last],
+                                               aCase.m_points[last - GRID_SIZE - 2] );
+            }
+        }
+    }
+}
+
+
+struct BENCH_STATS
+{
+    double    m_min;
+    double    m_median;
+    double    m_mean;
+    double    m_stdDev;
+    long long m_checksum;
+};
+
+
+static BENCH_STATS runBenchmark( const BENCHMARK& aBenchmark, const CORPUS& aCorpus, int aReps )
+{
+    BENCH_STATS         stats;
+    std::vector<double> times;
+
+    // Warm up the caches (and the approximation caches of the library)
+    stats.m_checksum = aBenchmark.m_func( aCorpus );
+
+    for( int i = 0; i < aReps; i++ )
+    {
+        CLOCK::time_point start = CLOCK::now();
+        aBenchmark.m_func( aCorpus );
+        CLOCK::time_point end = CLOCK::now();
+
+        times.push_back( std::chrono::duration<double, std::milli>( end - start ).count() );
+    }
+
+    std::sort( times.begin(), times.end() );
+
+    double sum = 0.0;
+    double sumSq = 0.0;
+
+    for( double t : times )
+    {
+        sum += t;
+        sumSq += t * t;
+    }
+
+    stats.m_min = times.front();
+    stats.m_median = times[times.size() / 2];
+    stats.m_mean = sum / times.size();
+    stats.m_stdDev = std::sqrt( std::max( 0.0, sumSq / times.size()
+                                               - stats.m_mean * stats.m_mean ) );
+
+    return stats;
+}
+
+
+static std::string getBenchFlags()
+{
+    std::string flags;
+
+    for( const BENCHMARK& bmark : benchmarkList )
+        flags += bmark.m_triggerChar;
+
+    return flags;
+}
+
+
+int main( int argc, char* argv[] )
+{
+    auto& os = std::cout;
+
+    if( argc < 3 )
+    {
+        os << "Usage: " << argv[0] << " <CORPUS> <REPS> [" << getBenchFlags() << "]\n\n";
+        os << "Benchmarks:\n";
+
+        for( const BENCHMARK& bmark : benchmarkList )
+            os << "    " << bmark.m_triggerChar << ": " << bmark.m_name << "\n";
+
+        return 1;
+    }
+
+    CORPUS      corpus;
+    int         reps = std::max( 1, atoi( argv[2] ) );
+    std::string bench = argc > 3 ? argv[3] : getBenchFlags();
+
+    if( !readCorpus( argv[1], corpus ) || corpus.empty() )
+    {
+        os << "Could not read any polygon set from " << argv[1] << "\n";
+        return 2;
+    }
+
+    long long vertices = 0;
+
+    for( BENCH_CASE& c : corpus )
+    {
+        prepareCase( c );
+        vertices += c.m_set.TotalVertices();
+    }
+
+    os << "kimath benchmark\n";
+    os << "  Corpus:      " << argv[1] << " (" << corpus.size() << " polygon sets, " << vertices
+       << " vertices)\n";
+    os << "  Repetitions: " << reps << "\n\n";
+
+    char line[256];
+
+    snprintf( line, sizeof( line ), "%-28s %10s %10s %10s %10s %14s\n", "", "min ms", "median",
+              "mean", "stddev", "checksum" );
+    os << line;
+
+    for( const BENCHMARK& bmark : benchmarkList )
+    {
+        if( bench.find( bmark.m_triggerChar ) == std::string::npos )
+            continue;
+
+        BENCH_STATS stats = runBenchmark( bmark, corpus, reps );
+
+        snprintf( line, sizeof( line ), "%-28s %10.2f %10.2f %10.2f %10.2f %14lld\n",
+                  bmark.m_name.c_str(), stats.m_min, stats.m_median, stats.m_mean, stats.m_stdDev,
+                  stats.m_checksum );
+        os << line << std::flush;
+    }
+
+    return 0;
+}
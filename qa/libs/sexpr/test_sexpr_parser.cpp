@@ -237,4 +237,41 @@ BOOST_AUTO_TEST_CASE( StringRoundtrip )
     }
 }
 
+
+/**
+ * Test that a tree parsed in an arena is the same as a heap one, with interned symbols
+ */
+BOOST_AUTO_TEST_CASE( ArenaParse )
+{
+    const std::string  content{ "(symbol \"string\" 42 3.14 (nested 4 ()) (symbol -1))" };
+    SEXPR::SEXPR_ARENA arena;
+    SEXPR::SEXPR*      sexp = m_parser.Parse( content, arena );
+
+    BOOST_REQUIRE_NE( sexp, nullptr );
+    BOOST_REQUIRE_PREDICATE( KI_TEST::SexprIsListOfLength, ( *sexp )( 6 ) );
+    BOOST_CHECK_EQUAL( sexp->AsString(), Parse( content )->AsString() );
+    BOOST_CHECK_EQUAL( arena.GetNodeCount(), 12 );
+
+    BOOST_CHECK_PREDICATE( KI_TEST::SexprIsSymbolWithValue, ( *sexp->GetChild( 0 ) )( "symbol" ) );
+    BOOST_CHECK_PREDICATE( KI_TEST::SexprIsStringWithValue, ( *sexp->GetChild( 1 ) )( "string" ) );
+    BOOST_CHECK_PREDICATE( KI_TEST::SexprIsIntegerWithValue, ( *sexp->GetChild( 2 ) )( 42 ) );
+    BOOST_CHECK_PREDICATE( KI_TEST::SexprIsDoubleWithValue, ( *sexp->GetChild( 3 ) )( 3.14 ) );
+
+    // The same symbol is stored once
+    BOOST_CHECK_EQUAL( &sexp->GetChild( 0 )->GetSymbol(),
+                       &sexp->GetChild( 5 )->GetChild( 0 )->GetSymbol() );
+
+    // A failed parse leaves the parser usable
+    BOOST_CHECK_THROW( m_parser.Parse( "(symbol (nested \"string", arena ),
+                       SEXPR::PARSE_EXCEPTION );
+
+    sexp = m_parser.Parse( "(a b)", arena );
+
+    BOOST_REQUIRE_NE( sexp, nullptr );
+    BOOST_CHECK_PREDICATE( KI_TEST::SexprIsListOfLength, ( *sexp )( 2 ) );
+
+    arena.Clear();
+    BOOST_CHECK_EQUAL( arena.GetNodeCount(), 0 );
+}
+
 BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
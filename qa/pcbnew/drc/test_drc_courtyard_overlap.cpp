@@ -496,4 +496,28 @@ BOOST_AUTO_TEST_CASE( OverlapCases )
     }
 }
 
-BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
+/**
+ * Checks that the courtyard polygons are built again after the courtyard items are changed
+ * in place, the footprint itself staying where it is.
+ */
+BOOST_AUTO_TEST_CASE( CourtyardItemsChangedInPlace )
+{
+    BOARD board;
+    auto  module = MakeCourtyardTestModule( board,
+            { "U1", { { { 0, 0 }, { Millimeter2iu( 2 ), Millimeter2iu( 2 ) }, 0, true } },
+              { 0, 0 } } );
+
+    BOOST_REQUIRE( module->BuildPolyCourtyard() );
+    BOX2I before = module->GetPolyCourtyardFront().BBox();
+
+    for( BOARD_ITEM* item : module->GraphicalItems() )
+        item->Move( wxPoint( Millimeter2iu( 1 ), 0 ) );
+
+    BOOST_REQUIRE( module->BuildPolyCourtyard() );
+    BOX2I after = module->GetPolyCourtyardFront().BBox();
+
+    BOOST_CHECK_EQUAL( after.GetX(), before.GetX() + Millimeter2iu( 1 ) );
+    BOOST_CHECK_EQUAL( after.GetY(), before.GetY() );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,167 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <class_board.h>
+#include <class_module.h>
+#include <class_pad.h>
+#include <class_track.h>
+#include <drc/drc.h>
+#include <drc/drc_pair_cache.h>
+#include <drc/drc_report_sink.h>
+
+
+/**
+ * Counts the violations of a headless DRC run.
+ */
+class COUNTING_REPORT_SINK : public DRC_REPORT_SINK
+{
+public:
+    void Report( const DRC_ITEM& aItem, const wxPoint& aPos, SEVERITY aSeverity ) override
+    {
+        m_Count++;
+    }
+
+    size_t m_Count = 0;
+};
+
+
+/**
+ * Make a board without clearance violations, but whose pads and tracks are close enough to
+ * be compared: round pads on a diagonal, and a track along each side of the diagonal.
+ */
+std::unique_ptr<BOARD> MakeCleanBoard()
+{
+    auto    board = std::make_unique<BOARD>();
+    MODULE* module = new MODULE( board.get() );
+
+    const int padCount = 10;
+    const int diameter = Millimeter2iu( 1 );
+    const int pitch = Millimeter2iu( 0.9 );    // gap of 0.27mm on the diagonal
+    const int offset = Millimeter2iu( 1.28 );  // track edges 0.3mm away from the pads
+
+    for( int ii = 0; ii < padCount; ++ii )
+    {
+        wxPoint center( ii * pitch, ii * pitch );
+        D_PAD*  pad = new D_PAD( module );
+
+        pad->SetName( wxString::Format( "%d", ii + 1 ) );
+        pad->SetAttribute( PAD_ATTRIB_SMD );
+        pad->SetLayerSet( D_PAD::SMDMask() );
+        pad->SetDrillSize( wxSize( 0, 0 ) );
+        pad->SetShape( PAD_SHAPE_CIRCLE );
+        pad->SetSize( wxSize( diameter, diameter ) );
+        pad->SetPosition( center );
+        pad->SetPos0( center );
+        module->Add( pad );
+    }
+
+    board->Add( module );
+
+    // The lines x - y = offset and x - y = -offset
+    const wxPoint first( -diameter, -diameter );
+    const wxPoint last( padCount * pitch, padCount * pitch );
+
+    for( int side : { -1, 1 } )
+    {
+        TRACK* track = new TRACK( board.get() );
+        track->SetLayer( F_Cu );
+        track->SetWidth( Millimeter2iu( 0.2 ) );
+        track->SetStart( first + wxPoint( side * offset, 0 ) );
+        track->SetEnd( last + wxPoint( side * offset, 0 ) );
+        board->Add( track );
+    }
+
+    return board;
+}
+
+
+BOOST_AUTO_TEST_SUITE( DrcPairCache )
+
+
+/**
+ * Checks that a pair found clean stays cached over the following runs.
+ */
+BOOST_AUTO_TEST_CASE( CleanPairStaysCached )
+{
+    DRC_PAIR_CACHE cache;
+
+    cache.BeginRun();
+    BOOST_CHECK( !cache.IsClean( 42 ) );
+    cache.SetClean( 42 );
+    BOOST_CHECK_EQUAL( cache.GetMisses(), 1 );
+
+    for( int run = 0; run < 3; ++run )
+    {
+        cache.BeginRun();
+        BOOST_CHECK( cache.IsClean( 42 ) );
+        BOOST_CHECK_EQUAL( cache.GetMisses(), 0 );
+    }
+}
+
+
+/**
+ * Checks that DRC runs on an unchanged board test no pair again once the first run found
+ * them clean.
+ */
+BOOST_AUTO_TEST_CASE( UnchangedBoardIsNotRetested )
+{
+    std::unique_ptr<BOARD> board = MakeCleanBoard();
+    DRC                    drc;
+    COUNTING_REPORT_SINK   sink;
+
+    drc.RunHeadless( board.get(), sink );
+    BOOST_CHECK_GT( drc.GetPairCacheMisses(), 0 );
+
+    for( int run = 0; run < 2; ++run )
+    {
+        drc.RunHeadless( board.get(), sink );
+        BOOST_CHECK_EQUAL( drc.GetPairCacheMisses(), 0 );
+    }
+}
+
+
+/**
+ * Checks that a pad resized in both directions is tested again, even when the sum of its
+ * size terms doesn't change.
+ */
+BOOST_AUTO_TEST_CASE( ResizedPadIsRetested )
+{
+    std::unique_ptr<BOARD> board = MakeCleanBoard();
+    DRC                    drc;
+    COUNTING_REPORT_SINK   sink;
+    D_PAD*                 pad = board->Modules().front()->Pads().front();
+    size_t                 hash = DRC_PAIR_CACHE::ItemHash( pad );
+
+    drc.RunHeadless( board.get(), sink );
+
+    // From 1.0 x 1.0mm to 1.2 x 0.9mm
+    pad->SetSize( wxSize( Millimeter2iu( 1.2 ), Millimeter2iu( 0.9 ) ) );
+    BOOST_CHECK_NE( DRC_PAIR_CACHE::ItemHash( pad ), hash );
+
+    drc.RunHeadless( board.get(), sink );
+    BOOST_CHECK_GT( drc.GetPairCacheMisses(), 0 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
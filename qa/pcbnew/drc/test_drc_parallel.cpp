@@ -0,0 +1,138 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <pcbnew_utils/board_construction_utils.h>
+
+#include <class_board.h>
+#include <class_module.h>
+#include <class_track.h>
+#include <drc/drc.h>
+#include <drc/drc_item.h>
+#include <drc/drc_report_sink.h>
+
+
+/**
+ * Collects the violations of a headless DRC run as sortable strings.
+ */
+class RECORDING_REPORT_SINK : public DRC_REPORT_SINK
+{
+public:
+    void Report( const DRC_ITEM& aItem, const wxPoint& aPos, SEVERITY aSeverity ) override
+    {
+        wxString violation = wxString::Format( "%d (%d, %d) %s %s %s", aItem.GetErrorCode(),
+                                               aPos.x, aPos.y,
+                                               aItem.GetMainItemID().AsString(),
+                                               aItem.GetAuxItemID().AsString(),
+                                               aItem.GetErrorMessage() );
+
+        m_Violations.push_back( violation.ToStdString() );
+    }
+
+    std::vector<std::string> m_Violations;
+};
+
+
+/**
+ * Make a board with many clearance, crossing, dangling and courtyard violations: a grid of
+ * tracks of alternating nets placed too close together, and overlapping footprints.
+ */
+std::unique_ptr<BOARD> MakeViolatingBoard()
+{
+    auto board = std::make_unique<BOARD>();
+
+    const int netCount = 4;
+
+    for( int ii = 1; ii <= netCount; ++ii )
+        board->Add( new NETINFO_ITEM( board.get(), wxString::Format( "N%d", ii ), ii ) );
+
+    const int length = Millimeter2iu( 20 );
+    const int pitch = Millimeter2iu( 0.3 );
+
+    for( int ii = 0; ii < 40; ++ii )
+    {
+        TRACK* horizontal = new TRACK( board.get() );
+        horizontal->SetLayer( F_Cu );
+        horizontal->SetWidth( Millimeter2iu( 0.25 ) );
+        horizontal->SetStart( wxPoint( 0, ii * pitch ) );
+        horizontal->SetEnd( wxPoint( length, ii * pitch ) );
+        horizontal->SetNetCode( 1 + ii % netCount );
+        board->Add( horizontal );
+
+        TRACK* vertical = new TRACK( board.get() );
+        vertical->SetLayer( ii % 2 ? F_Cu : B_Cu );
+        vertical->SetWidth( Millimeter2iu( 0.25 ) );
+        vertical->SetStart( wxPoint( ii * pitch * 2, 0 ) );
+        vertical->SetEnd( wxPoint( ii * pitch * 2, length ) );
+        vertical->SetNetCode( 1 + ( ii + 1 ) % netCount );
+        board->Add( vertical );
+    }
+
+    for( int ii = 0; ii < 10; ++ii )
+    {
+        MODULE* module = new MODULE( board.get() );
+
+        KI_TEST::DrawRect( *module, { 0, 0 }, { Millimeter2iu( 3 ), Millimeter2iu( 3 ) }, 0,
+                           Millimeter2iu( 0.1 ), F_CrtYd );
+
+        module->SetReference( wxString::Format( "U%d", ii ) );
+        module->SetPosition( wxPoint( ii * Millimeter2iu( 2 ), Millimeter2iu( 30 ) ) );
+        board->Add( module );
+    }
+
+    return board;
+}
+
+
+std::vector<std::string> RunDrc( BOARD& aBoard, int aThreadCount )
+{
+    DRC                   drc;
+    RECORDING_REPORT_SINK sink;
+
+    drc.RunHeadless( &aBoard, sink, aThreadCount );
+
+    std::sort( sink.m_Violations.begin(), sink.m_Violations.end() );
+    return sink.m_Violations;
+}
+
+
+BOOST_AUTO_TEST_SUITE( DrcParallel )
+
+
+/**
+ * Checks that the concurrent DRC finds the same violations as the serial one.
+ */
+BOOST_AUTO_TEST_CASE( ParallelMatchesSerial )
+{
+    std::unique_ptr<BOARD> board = MakeViolatingBoard();
+
+    std::vector<std::string> serial = RunDrc( *board, 1 );
+    std::vector<std::string> parallel = RunDrc( *board, 0 );
+
+    BOOST_CHECK( !serial.empty() );
+    BOOST_CHECK_EQUAL_COLLECTIONS( serial.begin(), serial.end(), parallel.begin(),
+                                   parallel.end() );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
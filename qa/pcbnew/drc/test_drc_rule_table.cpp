@@ -0,0 +1,164 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <board_design_settings.h>
+#include <class_board.h>
+#include <class_module.h>
+#include <class_pad.h>
+#include <class_track.h>
+#include <drc/drc_rule.h>
+
+
+struct DRC_RULE_TABLE_FIXTURE
+{
+    DRC_RULE_TABLE_FIXTURE()
+    {
+        for( const char* name : { "A", "B", "C" } )
+            m_netclasses.push_back( std::make_shared<NETCLASS>( name ) );
+
+        // Net 0 has the default netclass
+        for( int ii = 1; ii <= 3; ++ii )
+        {
+            NETINFO_ITEM* net = new NETINFO_ITEM( &m_board, wxString::Format( "N%d", ii ), ii );
+            m_board.Add( net );
+            net->SetClass( m_netclasses[ii - 1] );
+        }
+
+        for( int netcode = 0; netcode <= 3; ++netcode )
+        {
+            TRACK* track = new TRACK( &m_board );
+            track->SetLayer( netcode % 2 ? F_Cu : B_Cu );
+            track->SetNetCode( netcode );
+            m_board.Add( track );
+            m_items.push_back( track );
+
+            VIA* via = new VIA( &m_board );
+            via->SetNetCode( netcode );
+            m_board.Add( via );
+            m_items.push_back( via );
+        }
+
+        MODULE* module = new MODULE( &m_board );
+        m_board.Add( module );
+
+        for( int netcode = 0; netcode <= 3; ++netcode )
+        {
+            D_PAD* pad = new D_PAD( module );
+            module->Add( pad );
+            pad->SetNetCode( netcode );
+            m_items.push_back( pad );
+        }
+    }
+
+    ~DRC_RULE_TABLE_FIXTURE()
+    {
+        BOARD_DESIGN_SETTINGS& bds = m_board.GetDesignSettings();
+
+        bds.m_DRCRuleSelectors.clear();
+        bds.m_DRCRuleTable.reset();
+    }
+
+    BOARD                    m_board;
+    std::vector<NETCLASSPTR> m_netclasses;
+    std::vector<BOARD_ITEM*> m_items;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( DrcRuleTable, DRC_RULE_TABLE_FIXTURE )
+
+
+/**
+ * Checks that the compiled table finds the same rule as the walk of the selectors, for
+ * selectors matching 0 to 3 netclasses and 0 to 3 item types.
+ */
+BOOST_AUTO_TEST_CASE( LookupMatchesWalk )
+{
+    const NETCLASSPTR& a = m_netclasses[0];
+    const NETCLASSPTR& b = m_netclasses[1];
+    const NETCLASSPTR& c = m_netclasses[2];
+
+    const std::vector<std::vector<NETCLASSPTR>> netclassLists = {
+        {}, { a }, { c }, { a, b }, { b, c }, { a, b, c }
+    };
+
+    const std::vector<std::vector<KICAD_T>> typeLists = {
+        {},
+        { PCB_TRACE_T },
+        { PCB_PAD_T },
+        { PCB_TRACE_T, PCB_VIA_T },
+        { PCB_VIA_T, PCB_PAD_T },
+        { PCB_TRACE_T, PCB_VIA_T, PCB_PAD_T },
+    };
+
+    DRC_RULE                                   rule;
+    std::vector<std::unique_ptr<DRC_SELECTOR>> selectors;
+
+    rule.m_ConstraintFlags = CLEARANCE_CONSTRAINT;
+
+    for( const std::vector<NETCLASSPTR>& netclasses : netclassLists )
+    {
+        for( const std::vector<KICAD_T>& types : typeLists )
+        {
+            selectors.push_back( std::make_unique<DRC_SELECTOR>() );
+            selectors.back()->m_MatchNetclasses = netclasses;
+            selectors.back()->m_MatchTypes = types;
+            selectors.back()->m_Rule = &rule;
+        }
+    }
+
+    BOARD_DESIGN_SETTINGS& bds = m_board.GetDesignSettings();
+
+    for( size_t ii = 0; ii < selectors.size(); ++ii )
+    {
+        BOOST_TEST_CONTEXT( "selector " << ii )
+        {
+            bds.m_DRCRuleSelectors = { selectors[ii].get() };
+
+            auto table = std::make_shared<DRC_RULE_TABLE>( bds.m_DRCRuleSelectors );
+
+            for( BOARD_ITEM* aItem : m_items )
+            {
+                std::vector<BOARD_ITEM*> others = m_items;
+                others.push_back( nullptr );
+
+                for( BOARD_ITEM* bItem : others )
+                {
+                    if( aItem == bItem )
+                        continue;
+
+                    bds.m_DRCRuleTable.reset();
+                    DRC_RULE* walked = GetRule( aItem, bItem, CLEARANCE_CONSTRAINT );
+
+                    bds.m_DRCRuleTable = table;
+                    DRC_RULE* looked = GetRule( aItem, bItem, CLEARANCE_CONSTRAINT );
+
+                    BOOST_CHECK_EQUAL( walked, looked );
+                }
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
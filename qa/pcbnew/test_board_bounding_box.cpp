@@ -0,0 +1,153 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+
+/**
+ * @file test_board_bounding_box.cpp
+ * Tests of the bounding boxes of the board.
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+// Code under test
+#include <class_board.h>
+
+#include <class_drawsegment.h>
+#include <class_track.h>
+
+
+BOOST_AUTO_TEST_SUITE( BoardBoundingBox )
+
+
+static bool sameRect( const EDA_RECT& aA, const EDA_RECT& aB )
+{
+    return aA.GetOrigin() == aB.GetOrigin() && aA.GetSize() == aB.GetSize();
+}
+
+
+/**
+ * Checks that the bounding boxes follow the items added, changed and removed.
+ */
+BOOST_AUTO_TEST_CASE( AddChangeRemove )
+{
+    BOARD        board;
+    DRAWSEGMENT* edge = new DRAWSEGMENT( &board );
+    TRACK*       track = new TRACK( &board );
+
+    board.SetVisibleLayers( LSET::AllLayersMask() );
+
+    edge->SetLayer( Edge_Cuts );
+    edge->SetStart( wxPoint( 0, 0 ) );
+    edge->SetEnd( wxPoint( 1000000, 1000000 ) );
+    edge->SetWidth( 100000 );
+    board.Add( edge );
+
+    BOOST_CHECK( sameRect( board.GetBoardEdgesBoundingBox(), edge->GetBoundingBox() ) );
+    BOOST_CHECK( sameRect( board.GetBoundingBox(), edge->GetBoundingBox() ) );
+
+    track->SetLayer( F_Cu );
+    track->SetStart( wxPoint( 2000000, 0 ) );
+    track->SetEnd( wxPoint( 3000000, 0 ) );
+    track->SetWidth( 200000 );
+    board.Add( track );
+
+    EDA_RECT expected = edge->GetBoundingBox();
+    expected.Merge( track->GetBoundingBox() );
+
+    BOOST_CHECK( sameRect( board.GetBoardEdgesBoundingBox(), edge->GetBoundingBox() ) );
+    BOOST_CHECK( sameRect( board.GetBoundingBox(), expected ) );
+
+    track->Move( wxPoint( 0, 5000000 ) );
+    board.OnItemChanged( track );
+
+    expected = edge->GetBoundingBox();
+    expected.Merge( track->GetBoundingBox() );
+
+    BOOST_CHECK( sameRect( board.GetBoundingBox(), expected ) );
+
+    board.Remove( track );
+
+    BOOST_CHECK( sameRect( board.GetBoundingBox(), edge->GetBoundingBox() ) );
+
+    delete track;
+}
+
+
+/**
+ * Checks that the bounding boxes follow the items moved without notifying the board, as the
+ * scripting and the footprint updater do.
+ */
+BOOST_AUTO_TEST_CASE( MovedInPlace )
+{
+    BOARD  board;
+    TRACK* track = new TRACK( &board );
+
+    board.SetVisibleLayers( LSET::AllLayersMask() );
+
+    track->SetLayer( F_Cu );
+    track->SetEnd( wxPoint( 1000000, 0 ) );
+    board.Add( track );
+
+    BOOST_CHECK( sameRect( board.GetBoundingBox(), track->GetBoundingBox() ) );
+
+    track->Move( wxPoint( 0, 5000000 ) );
+
+    BOOST_CHECK( sameRect( board.GetBoundingBox(), track->GetBoundingBox() ) );
+}
+
+
+/**
+ * Checks that the bounding box only covers the visible layers.
+ */
+BOOST_AUTO_TEST_CASE( VisibleLayers )
+{
+    BOARD  board;
+    TRACK* front = new TRACK( &board );
+    TRACK* back = new TRACK( &board );
+
+    board.SetVisibleLayers( LSET::AllLayersMask() );
+
+    front->SetLayer( F_Cu );
+    front->SetEnd( wxPoint( 1000000, 0 ) );
+    board.Add( front );
+
+    back->SetLayer( B_Cu );
+    back->SetStart( wxPoint( 0, 3000000 ) );
+    back->SetEnd( wxPoint( 1000000, 3000000 ) );
+    board.Add( back );
+
+    EDA_RECT expected = front->GetBoundingBox();
+    expected.Merge( back->GetBoundingBox() );
+
+    BOOST_CHECK( sameRect( board.GetBoundingBox(), expected ) );
+
+    LSET visible = LSET::AllLayersMask();
+
+    visible.reset( B_Cu );
+    board.SetVisibleLayers( visible );
+
+    BOOST_CHECK( sameRect( board.GetBoundingBox(), front->GetBoundingBox() ) );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,112 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+
+/**
+ * @file test_board_item_lookup.cpp
+ * Tests of the lookup of the board items by their KIID.
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+// Code under test
+#include <class_board.h>
+
+#include <class_module.h>
+#include <class_pad.h>
+#include <class_track.h>
+
+
+BOOST_AUTO_TEST_SUITE( BoardItemLookup )
+
+
+/**
+ * Checks that the items and the module items are found, and not once removed.
+ */
+BOOST_AUTO_TEST_CASE( AddRemove )
+{
+    BOARD   board;
+    TRACK*  track = new TRACK( &board );
+    MODULE* module = new MODULE( &board );
+    D_PAD*  pad = new D_PAD( module );
+
+    track->SetLayer( F_Cu );
+    module->Add( pad );
+    board.Add( track );
+    board.Add( module );
+
+    BOOST_CHECK( board.GetItem( niluuid ) == nullptr );
+    BOOST_CHECK( board.GetItem( track->m_Uuid ) == track );
+    BOOST_CHECK( board.GetItem( module->m_Uuid ) == module );
+    BOOST_CHECK( board.GetItem( pad->m_Uuid ) == pad );
+    BOOST_CHECK( board.GetItem( module->Reference().m_Uuid ) == &module->Reference() );
+    BOOST_CHECK( board.GetItem( board.m_Uuid ) == &board );
+
+    board.Remove( track );
+
+    BOOST_CHECK( board.GetItem( track->m_Uuid )->Type() == NOT_USED );
+
+    board.Add( track );
+
+    BOOST_CHECK( board.GetItem( track->m_Uuid ) == track );
+}
+
+
+/**
+ * Checks that the items not indexed when added to the board are still found.
+ */
+BOOST_AUTO_TEST_CASE( NotIndexed )
+{
+    BOARD   board;
+    MODULE* module = new MODULE( &board );
+
+    board.Add( module );
+
+    // Added to its module after the module was added to the board
+    D_PAD* pad = new D_PAD( module );
+    module->Add( pad );
+
+    BOOST_CHECK( board.GetItem( pad->m_Uuid ) == pad );
+    BOOST_CHECK( board.GetItem( pad->m_Uuid ) == pad );
+
+    // Removed from its module: the module is not a stale result
+    module->Remove( pad );
+
+    BOOST_CHECK( board.GetItem( pad->m_Uuid )->Type() == NOT_USED );
+
+    delete pad;
+
+    // A KIID changed once the module was added
+    KIID previous = module->m_Uuid;
+    const_cast<KIID&>( module->m_Uuid ) = KIID();
+
+    BOOST_CHECK( board.GetItem( module->m_Uuid ) == module );
+    BOOST_CHECK( board.GetItem( previous )->Type() == NOT_USED );
+
+    board.Remove( module );
+    delete module;
+
+    BOOST_CHECK( board.GetItem( previous )->Type() == NOT_USED );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,132 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+
+/**
+ * @file test_connectivity_version.cpp
+ * Tests of the immutable versions of the connectivity published by the ratsnest updates.
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+// Code under test
+#include <connectivity/connectivity_data.h>
+#include <connectivity/connectivity_version.h>
+
+#include <class_board.h>
+#include <class_track.h>
+
+
+static TRACK* addTrack( BOARD& aBoard, int aNet, const wxPoint& aStart, const wxPoint& aEnd )
+{
+    TRACK* track = new TRACK( &aBoard );
+    track->SetLayer( F_Cu );
+    track->SetStart( aStart );
+    track->SetEnd( aEnd );
+    track->SetNetCode( aNet );
+    aBoard.Add( track );
+
+    return track;
+}
+
+
+BOOST_AUTO_TEST_SUITE( ConnectivityVersion )
+
+
+/**
+ * Checks that a version holds the clusters, the ratsnest and the stats of the nets.
+ */
+BOOST_AUTO_TEST_CASE( Contents )
+{
+    BOARD board;
+
+    board.Add( new NETINFO_ITEM( &board, "A", 1 ) );
+
+    TRACK* first = addTrack( board, 1, wxPoint( 0, 0 ), wxPoint( 1000000, 0 ) );
+    TRACK* second = addTrack( board, 1, wxPoint( 1000000, 0 ), wxPoint( 2000000, 0 ) );
+    TRACK* apart = addTrack( board, 1, wxPoint( 10000000, 0 ), wxPoint( 11000000, 0 ) );
+
+    auto connectivity = board.GetConnectivity();
+    connectivity->RecalculateRatsnest();
+
+    auto version = connectivity->GetVersion();
+    BOOST_REQUIRE( version );
+
+    auto net = version->GetNet( 1 );
+    BOOST_REQUIRE( net );
+
+    BOOST_CHECK_EQUAL( net->m_Items.size(), 3 );
+    BOOST_CHECK_EQUAL( net->m_ClusterCount, 2 );
+    BOOST_CHECK_EQUAL( net->m_Stats.m_TrackLength, 3000000 );
+
+    BOOST_CHECK( version->IsConnected( 1, first->m_Uuid, second->m_Uuid ) );
+    BOOST_CHECK( !version->IsConnected( 1, first->m_Uuid, apart->m_Uuid ) );
+    BOOST_CHECK( !version->IsConnected( 2, first->m_Uuid, second->m_Uuid ) );
+
+    BOOST_CHECK_EQUAL( version->GetUnconnectedCount(), connectivity->GetUnconnectedCount() );
+    BOOST_CHECK( !version->GetNet( 0 ) );
+}
+
+
+/**
+ * Checks that a version is not changed by the next updates, and shares its unchanged nets
+ * with the next version.
+ */
+BOOST_AUTO_TEST_CASE( SharedNets )
+{
+    BOARD board;
+
+    board.Add( new NETINFO_ITEM( &board, "A", 1 ) );
+    board.Add( new NETINFO_ITEM( &board, "B", 2 ) );
+
+    addTrack( board, 1, wxPoint( 0, 0 ), wxPoint( 1000000, 0 ) );
+    TRACK* track = addTrack( board, 2, wxPoint( 0, 5000000 ), wxPoint( 1000000, 5000000 ) );
+
+    auto connectivity = board.GetConnectivity();
+    connectivity->RecalculateRatsnest();
+
+    auto before = connectivity->GetVersion();
+
+    track->SetEnd( wxPoint( 3000000, 5000000 ) );
+    connectivity->Update( track );
+    connectivity->RecalculateRatsnest();
+
+    auto after = connectivity->GetVersion();
+
+    BOOST_CHECK_GT( after->GetSerial(), before->GetSerial() );
+    BOOST_CHECK( after->GetNet( 1 ) == before->GetNet( 1 ) );
+    BOOST_CHECK( after->GetNet( 2 ) != before->GetNet( 2 ) );
+
+    BOOST_CHECK_EQUAL( before->GetNet( 2 )->m_Stats.m_TrackLength, 1000000 );
+    BOOST_CHECK_EQUAL( after->GetNet( 2 )->m_Stats.m_TrackLength, 3000000 );
+
+    // The items may be deleted while a version is read
+    board.Remove( track );
+    delete track;
+    connectivity->RecalculateRatsnest();
+
+    BOOST_CHECK_EQUAL( after->GetNet( 2 )->m_Items.size(), 1 );
+    BOOST_CHECK( !connectivity->GetVersion()->GetNet( 2 ) );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
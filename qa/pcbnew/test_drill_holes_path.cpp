@@ -0,0 +1,132 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file test_drill_holes_path.cpp
+ * Tests of the ordering of the holes of a drill tool.
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <class_board.h>
+#include <trigo.h>
+
+// Code under test
+#include <exporters/gendrill_file_writer_base.h>
+
+#include <algorithm>
+
+
+/**
+ * @return the travel of the spindle from aStart through all the holes
+ */
+static double pathLength( const std::vector<HOLE_INFO>& aHoles, const wxPoint& aStart )
+{
+    double  length = 0.0;
+    wxPoint pos = aStart;
+
+    for( const HOLE_INFO& hole : aHoles )
+    {
+        length += EuclideanNorm( hole.m_Hole_Pos - pos );
+        pos = hole.m_Hole_Pos;
+    }
+
+    return length;
+}
+
+
+/**
+ * Holes of a 20 x 20 grid, sorted by X then Y as buildHolesList() does.
+ */
+static std::vector<HOLE_INFO> gridHoles()
+{
+    std::vector<HOLE_INFO> holes;
+
+    for( int x = 0; x < 20; x++ )
+    {
+        for( int y = 0; y < 20; y++ )
+        {
+            HOLE_INFO hole;
+            hole.m_Hole_Pos = wxPoint( x * 1000000, y * 1000000 );
+            holes.push_back( hole );
+        }
+    }
+
+    return holes;
+}
+
+
+BOOST_AUTO_TEST_SUITE( DrillHolesPath )
+
+
+/**
+ * Checks that the holes are only reordered, and that the travel is shorter.
+ */
+BOOST_AUTO_TEST_CASE( ShorterPath )
+{
+    std::vector<HOLE_INFO> holes = gridHoles();
+    double                 sortedLength = pathLength( holes, holes[0].m_Hole_Pos );
+
+    wxPoint last = OptimizeHolesPath( holes, 0, holes.size(), holes[0].m_Hole_Pos );
+
+    BOOST_CHECK( last == holes.back().m_Hole_Pos );
+    BOOST_CHECK( holes.front().m_Hole_Pos == wxPoint( 0, 0 ) );
+    BOOST_CHECK_LT( pathLength( holes, wxPoint( 0, 0 ) ), sortedLength * 0.6 );
+
+    std::vector<HOLE_INFO> expected = gridHoles();
+
+    auto cmp = []( const HOLE_INFO& a, const HOLE_INFO& b )
+    {
+        return a.m_Hole_Pos.x < b.m_Hole_Pos.x
+               || ( a.m_Hole_Pos.x == b.m_Hole_Pos.x && a.m_Hole_Pos.y < b.m_Hole_Pos.y );
+    };
+
+    std::sort( holes.begin(), holes.end(), cmp );
+
+    for( size_t ii = 0; ii < holes.size(); ii++ )
+        BOOST_CHECK( holes[ii].m_Hole_Pos == expected[ii].m_Hole_Pos );
+}
+
+
+/**
+ * Checks that only the given range is reordered, from the hole nearest to the start.
+ */
+BOOST_AUTO_TEST_CASE( Range )
+{
+    std::vector<HOLE_INFO> holes = gridHoles();
+    std::vector<HOLE_INFO> expected = holes;
+
+    OptimizeHolesPath( holes, 20, 40, wxPoint( 5000000, 20000000 ) );
+
+    for( size_t ii = 0; ii < holes.size(); ii++ )
+    {
+        if( ii < 20 || ii >= 40 )
+            BOOST_CHECK( holes[ii].m_Hole_Pos == expected[ii].m_Hole_Pos );
+    }
+
+    // The second column, from its top
+    BOOST_CHECK( holes[20].m_Hole_Pos == wxPoint( 1000000, 19000000 ) );
+    BOOST_CHECK( holes[39].m_Hole_Pos == wxPoint( 1000000, 0 ) );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
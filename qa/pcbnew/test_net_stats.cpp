@@ -0,0 +1,140 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+
+/**
+ * @file test_net_stats.cpp
+ * Tests of the net statistics kept by the connectivity.
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+// Code under test
+#include <connectivity/connectivity_data.h>
+
+#include <class_board.h>
+#include <class_module.h>
+#include <class_pad.h>
+#include <class_track.h>
+
+#include <algorithm>
+
+
+BOOST_AUTO_TEST_SUITE( NetStats )
+
+
+/**
+ * Checks that the statistics follow the items added, updated and removed, and that the
+ * changed nets are reported.
+ */
+BOOST_AUTO_TEST_CASE( AddUpdateRemove )
+{
+    BOARD board;
+
+    board.Add( new NETINFO_ITEM( &board, "A", 1 ) );
+    board.Add( new NETINFO_ITEM( &board, "B", 2 ) );
+
+    auto     connectivity = board.GetConnectivity();
+    uint64_t serial = connectivity->GetNetStatsSerial();
+
+    TRACK* track = new TRACK( &board );
+    track->SetLayer( F_Cu );
+    track->SetStart( wxPoint( 0, 0 ) );
+    track->SetEnd( wxPoint( 3000000, 4000000 ) );
+    track->SetNetCode( 1 );
+    board.Add( track );
+
+    VIA* via = new VIA( &board );
+    via->SetNetCode( 1 );
+    board.Add( via );
+
+    MODULE* module = new MODULE( &board );
+    D_PAD*  pad = new D_PAD( module );
+    pad->SetNetCode( 1 );
+    pad->SetPadToDieLength( 500000 );
+    module->Add( pad );
+    board.Add( module );
+
+    const CN_NET_STATS& stats = connectivity->GetNetStats( 1 );
+
+    BOOST_CHECK_EQUAL( stats.m_PadCount, 1 );
+    BOOST_CHECK_EQUAL( stats.m_ViaCount, 1 );
+    BOOST_CHECK_EQUAL( stats.m_TrackLength, 5000000 );
+    BOOST_CHECK_EQUAL( stats.m_PadToDieLength, 500000 );
+
+    std::vector<int> changed;
+
+    BOOST_CHECK( connectivity->GetChangedNetStats( serial, changed ) );
+    BOOST_CHECK( changed == std::vector<int>{ 1 } );
+
+    // Moved to another net: counted in the net it was in, then in the new one
+    serial = connectivity->GetNetStatsSerial();
+    track->SetNetCode( 2 );
+    connectivity->Update( track );
+
+    BOOST_CHECK_EQUAL( connectivity->GetNetStats( 1 ).m_TrackLength, 0 );
+    BOOST_CHECK_EQUAL( connectivity->GetNetStats( 2 ).m_TrackLength, 5000000 );
+
+    changed.clear();
+    BOOST_CHECK( connectivity->GetChangedNetStats( serial, changed ) );
+    std::sort( changed.begin(), changed.end() );
+    BOOST_CHECK( changed == ( std::vector<int>{ 1, 2 } ) );
+
+    board.Remove( via );
+    delete via;
+
+    BOOST_CHECK_EQUAL( connectivity->GetNetStats( 1 ).m_ViaCount, 0 );
+    BOOST_CHECK_EQUAL( connectivity->GetNetStats( 1 ).m_PadCount, 1 );
+
+    // Nothing changed since the last serial
+    changed.clear();
+    BOOST_CHECK( connectivity->GetChangedNetStats( connectivity->GetNetStatsSerial(), changed ) );
+    BOOST_CHECK( changed.empty() );
+}
+
+
+/**
+ * Checks that a rebuilt connectivity tells the statistics must all be read again.
+ */
+BOOST_AUTO_TEST_CASE( Rebuild )
+{
+    BOARD board;
+
+    board.Add( new NETINFO_ITEM( &board, "A", 1 ) );
+
+    TRACK* track = new TRACK( &board );
+    track->SetLayer( F_Cu );
+    track->SetEnd( wxPoint( 1000000, 0 ) );
+    track->SetNetCode( 1 );
+    board.Add( track );
+
+    uint64_t         serial = board.GetConnectivity()->GetNetStatsSerial();
+    std::vector<int> changed;
+
+    board.BuildConnectivity();
+
+    BOOST_CHECK( !board.GetConnectivity()->GetChangedNetStats( serial, changed ) );
+    BOOST_CHECK_EQUAL( board.GetConnectivity()->GetNetStats( 1 ).m_TrackLength, 1000000 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
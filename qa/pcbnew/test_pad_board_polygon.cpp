@@ -0,0 +1,157 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file test_pad_board_polygon.cpp
+ * Tests of the board polygon cached by the pads.
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+// Code under test
+#include <class_pad.h>
+
+
+/**
+ * @return the polygon of a custom pad, built without the cache
+ */
+static SHAPE_POLY_SET uncachedPolygon( const D_PAD& aPad )
+{
+    SHAPE_POLY_SET polygon;
+
+    polygon.Append( aPad.GetCustomShapeAsPolygon() );
+    aPad.CustomShapeAsPolygonToBoardPosition( &polygon, aPad.GetPosition(),
+                                              aPad.GetOrientation() );
+
+    return polygon;
+}
+
+
+static bool samePolygon( const SHAPE_POLY_SET& aA, const SHAPE_POLY_SET& aB )
+{
+    if( aA.OutlineCount() != aB.OutlineCount() )
+        return false;
+
+    for( int ii = 0; ii < aA.OutlineCount(); ii++ )
+    {
+        if( aA.COutline( ii ).CPoints() != aB.COutline( ii ).CPoints() )
+            return false;
+    }
+
+    return true;
+}
+
+
+BOOST_AUTO_TEST_SUITE( PadBoardPolygon )
+
+
+/**
+ * Checks that the polygon of a rectangular pad follows the changes of the pad.
+ */
+BOOST_AUTO_TEST_CASE( RectPad )
+{
+    D_PAD pad( nullptr );
+
+    pad.SetShape( PAD_SHAPE_RECT );
+    pad.SetSize( wxSize( 1000000, 500000 ) );
+    pad.SetPosition( wxPoint( 2000000, 3000000 ) );
+
+    BOX2I bbox = pad.GetBoardPolygon().BBox();
+    BOOST_CHECK_EQUAL( bbox.GetWidth(), 1000000 );
+    BOOST_CHECK_EQUAL( bbox.GetHeight(), 500000 );
+    BOOST_CHECK_EQUAL( bbox.GetCenter(), VECTOR2I( 2000000, 3000000 ) );
+
+    // Moved directly, without a setter
+    pad.Move( wxPoint( 100000, 0 ) );
+    BOOST_CHECK_EQUAL( pad.GetBoardPolygon().BBox().GetCenter(), VECTOR2I( 2100000, 3000000 ) );
+
+    pad.SetOrientation( 900 );
+    bbox = pad.GetBoardPolygon().BBox();
+    BOOST_CHECK_EQUAL( bbox.GetWidth(), 500000 );
+    BOOST_CHECK_EQUAL( bbox.GetHeight(), 1000000 );
+
+    pad.SetSize( wxSize( 200000, 200000 ) );
+    BOOST_CHECK_EQUAL( pad.GetBoardPolygon().BBox().GetWidth(), 200000 );
+}
+
+
+/**
+ * Checks that the cached polygon of round rect pads is the one built without the cache,
+ * for each approximation error.
+ */
+BOOST_AUTO_TEST_CASE( RoundRectPad )
+{
+    D_PAD pad( nullptr );
+
+    pad.SetShape( PAD_SHAPE_ROUNDRECT );
+    pad.SetSize( wxSize( 1000002, 500002 ) );
+    pad.SetRoundRectRadiusRatio( 0.25 );
+    pad.SetPosition( wxPoint( -2000000, 3000000 ) );
+    pad.SetOrientation( 300 );
+
+    SHAPE_POLY_SET coarse;
+    pad.TransformShapeWithClearanceToPolygon( coarse, 0, 100000 );
+
+    SHAPE_POLY_SET fine;
+    pad.TransformShapeWithClearanceToPolygon( fine, 0, 1000 );
+
+    BOOST_CHECK_LT( coarse.TotalVertices(), fine.TotalVertices() );
+    BOOST_CHECK_EQUAL( pad.GetBoardPolygon( 1000 ).TotalVertices(), fine.TotalVertices() );
+
+    pad.SetRoundRectRadiusRatio( 0.5 );
+
+    SHAPE_POLY_SET rounder;
+    pad.TransformShapeWithClearanceToPolygon( rounder, 0, 1000 );
+    BOOST_CHECK( !samePolygon( rounder, fine ) );
+}
+
+
+/**
+ * Checks that the polygon of a custom pad is the custom shape at the pad position, and
+ * follows the changes of the primitives.
+ */
+BOOST_AUTO_TEST_CASE( CustomPad )
+{
+    D_PAD pad( nullptr );
+
+    pad.SetShape( PAD_SHAPE_CUSTOM );
+    pad.SetAnchorPadShape( PAD_SHAPE_RECT );
+    pad.SetSize( wxSize( 200000, 200000 ) );
+    pad.AddPrimitiveSegment( wxPoint( 0, 0 ), wxPoint( 1000000, 0 ), 200000 );
+    pad.SetPosition( wxPoint( 5000000, -5000000 ) );
+    pad.SetOrientation( 450 );
+
+    BOOST_CHECK( samePolygon( pad.GetBoardPolygon(), uncachedPolygon( pad ) ) );
+
+    pad.Rotate( wxPoint( 0, 0 ), 900 );
+    BOOST_CHECK( samePolygon( pad.GetBoardPolygon(), uncachedPolygon( pad ) ) );
+
+    int width = pad.GetBoardPolygon().BBox().GetWidth();
+
+    pad.DeletePrimitivesList();
+    pad.AddPrimitiveSegment( wxPoint( 0, 0 ), wxPoint( 3000000, 0 ), 200000 );
+    BOOST_CHECK_GT( pad.GetBoardPolygon().BBox().GetWidth(), width );
+    BOOST_CHECK( samePolygon( pad.GetBoardPolygon(), uncachedPolygon( pad ) ) );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,82 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+
+/**
+ * @file test_text_stroke_segments.cpp
+ * Tests of the cache of the segments of the text shapes.
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <class_board.h>
+
+// Code under test
+#include <class_pcb_text.h>
+
+
+BOOST_AUTO_TEST_SUITE( TextStrokeSegments )
+
+
+/**
+ * Checks that the segments are laid out once, and again when the text or its layout change.
+ */
+BOOST_AUTO_TEST_CASE( Invalidation )
+{
+    BOARD     board;
+    TEXTE_PCB text( &board );
+
+    text.SetText( wxT( "R1" ) );
+    text.SetTextSize( wxSize( 1000000, 1000000 ) );
+
+    std::shared_ptr<const std::vector<wxPoint>> segments = text.GetStrokeSegments( 0.0, 0 );
+
+    BOOST_CHECK( !segments->empty() );
+    BOOST_CHECK_EQUAL( segments->size() % 2, 0 );
+    BOOST_CHECK( text.GetStrokeSegments( 0.0, 0 ) == segments );
+
+    std::vector<wxPoint> corners;
+    text.TransformTextShapeToSegmentList( corners );
+    BOOST_CHECK( corners == *segments );
+
+    // A copy shares the laid out segments
+    TEXTE_PCB copy( text );
+    BOOST_CHECK( copy.GetStrokeSegments( 0.0, 0 ) == segments );
+
+    BOOST_CHECK( text.GetStrokeSegments( 900.0, 0 ) != segments );
+    BOOST_CHECK( text.GetStrokeSegments( 0.0, 150000 ) != segments );
+
+    segments = text.GetStrokeSegments( 0.0, 0 );
+    text.SetTextPos( wxPoint( 5000000, 0 ) );
+
+    std::shared_ptr<const std::vector<wxPoint>> moved = text.GetStrokeSegments( 0.0, 0 );
+
+    BOOST_REQUIRE( moved != segments );
+    BOOST_REQUIRE_EQUAL( moved->size(), segments->size() );
+    BOOST_CHECK( ( *moved )[0] == ( *segments )[0] + wxPoint( 5000000, 0 ) );
+
+    text.SetText( wxT( "R10" ) );
+    BOOST_CHECK( text.GetStrokeSegments( 0.0, 0 )->size() > moved->size() );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
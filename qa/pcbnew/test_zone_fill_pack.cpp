@@ -0,0 +1,149 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file test_zone_fill_pack.cpp
+ * Tests of the compressed zone fills kept by the undo list.
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <class_board.h>
+#include <class_zone.h>
+
+// Code under test
+#include <zone_fill_pack.h>
+
+
+/**
+ * A fill of outlines with holes, with large and negative coordinates.
+ */
+static SHAPE_POLY_SET testFill()
+{
+    SHAPE_POLY_SET fill;
+
+    for( int ii = 0; ii < 10; ii++ )
+    {
+        int                   x = ii * 20000000 - 100000000;
+        std::vector<VECTOR2I> outline = { VECTOR2I( x, -300000000 ),
+                                          VECTOR2I( x + 10000000, -300000000 ),
+                                          VECTOR2I( x + 10000000, 300000000 ),
+                                          VECTOR2I( x, 300000000 ) };
+        std::vector<VECTOR2I> hole = { VECTOR2I( x + 1000000, 1000000 ),
+                                       VECTOR2I( x + 2000000, 1000000 ),
+                                       VECTOR2I( x + 2000000, 2000001 ) };
+
+        fill.AddOutline( SHAPE_LINE_CHAIN( outline, true ) );
+        fill.AddHole( SHAPE_LINE_CHAIN( hole, true ) );
+    }
+
+    return fill;
+}
+
+
+static bool sameFill( const SHAPE_POLY_SET& aA, const SHAPE_POLY_SET& aB )
+{
+    if( aA.OutlineCount() != aB.OutlineCount() )
+        return false;
+
+    for( int ii = 0; ii < aA.OutlineCount(); ii++ )
+    {
+        const SHAPE_POLY_SET::POLYGON& a = aA.CPolygon( ii );
+        const SHAPE_POLY_SET::POLYGON& b = aB.CPolygon( ii );
+
+        if( a.size() != b.size() )
+            return false;
+
+        for( size_t jj = 0; jj < a.size(); jj++ )
+        {
+            if( a[jj].CPoints() != b[jj].CPoints() || a[jj].IsClosed() != b[jj].IsClosed() )
+                return false;
+        }
+    }
+
+    return true;
+}
+
+
+BOOST_AUTO_TEST_SUITE( ZoneFillPack )
+
+
+/**
+ * Checks that a packed fill is unpacked unchanged, and is smaller.
+ */
+BOOST_AUTO_TEST_CASE( RoundTrip )
+{
+    SHAPE_POLY_SET   fill = testFill();
+    std::vector<SEG> segments = { SEG( VECTOR2I( -5, 7 ), VECTOR2I( 2000000000, -2000000000 ) ) };
+
+    auto pack = ZONE_FILL_PACK::Pack( fill, segments );
+
+    BOOST_REQUIRE( pack );
+    BOOST_CHECK_LT( pack->GetSize(), fill.TotalVertices() * sizeof( VECTOR2I ) );
+
+    SHAPE_POLY_SET   unpacked;
+    std::vector<SEG> unpackedSegments;
+
+    BOOST_CHECK( pack->Unpack( unpacked, unpackedSegments ) );
+    BOOST_CHECK( sameFill( fill, unpacked ) );
+    BOOST_REQUIRE_EQUAL( unpackedSegments.size(), 1 );
+    BOOST_CHECK( unpackedSegments[0] == segments[0] );
+}
+
+
+/**
+ * Checks that a zone copy packs its fill, except while the fill is shared with the zone.
+ */
+BOOST_AUTO_TEST_CASE( ZonePackFill )
+{
+    BOARD          board;
+    ZONE_CONTAINER zone( &board );
+    SHAPE_POLY_SET fill = testFill();
+
+    zone.SetFilledPolysList( fill );
+    fill.RemoveAllContours();
+
+    ZONE_CONTAINER copy( zone );
+
+    // Shared with the zone: nothing to save
+    copy.PackFill();
+    BOOST_CHECK( !copy.IsFillPacked() );
+
+    // The zone is refilled
+    SHAPE_POLY_SET empty;
+    zone.SetFilledPolysList( empty );
+
+    copy.PackFill();
+    BOOST_CHECK( copy.IsFillPacked() );
+    BOOST_CHECK( copy.GetFilledPolysList().IsEmpty() );
+
+    // Copies of a packed zone share the pack
+    ZONE_CONTAINER copy2( copy );
+    BOOST_CHECK( copy2.IsFillPacked() );
+
+    copy.UnpackFill();
+    BOOST_CHECK( !copy.IsFillPacked() );
+    BOOST_CHECK( sameFill( copy.GetFilledPolysList(), testFill() ) );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
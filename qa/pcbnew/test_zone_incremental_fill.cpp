@@ -0,0 +1,134 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file test_zone_incremental_fill.cpp
+ * Tests of the incremental zone fills.
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <class_board.h>
+#include <class_track.h>
+#include <class_zone.h>
+
+// Code under test
+#include <zone_filler.h>
+#include <zone_knockout_cache.h>
+
+
+/**
+ * A board with a copper zone without net, crossed by a track of another net.
+ */
+struct ZONE_INCREMENTAL_FILL_FIXTURE
+{
+    ZONE_INCREMENTAL_FILL_FIXTURE()
+    {
+        m_board.Add( new NETINFO_ITEM( &m_board, "N1", 1 ) );
+
+        m_zone = new ZONE_CONTAINER( &m_board );
+        m_zone->SetLayer( F_Cu );
+        m_zone->SetFillMode( ZONE_FILL_MODE::POLYGONS );
+        m_zone->Outline()->NewOutline();
+        m_zone->Outline()->Append( 0, 0 );
+        m_zone->Outline()->Append( Millimeter2iu( 20 ), 0 );
+        m_zone->Outline()->Append( Millimeter2iu( 20 ), Millimeter2iu( 20 ) );
+        m_zone->Outline()->Append( 0, Millimeter2iu( 20 ) );
+        m_board.Add( m_zone );
+
+        m_track = new TRACK( &m_board );
+        m_track->SetLayer( F_Cu );
+        m_track->SetNetCode( 1 );
+        m_track->SetWidth( Millimeter2iu( 0.25 ) );
+        m_track->SetStart( wxPoint( Millimeter2iu( 5 ), Millimeter2iu( 10 ) ) );
+        m_track->SetEnd( wxPoint( Millimeter2iu( 15 ), Millimeter2iu( 10 ) ) );
+        m_board.Add( m_track );
+    }
+
+    /**
+     * Fills the zone, and returns the area of its fill.
+     */
+    double Fill( bool aIncremental )
+    {
+        ZONE_FILLER filler( &m_board );
+
+        filler.SetIncremental( aIncremental );
+        BOOST_REQUIRE( filler.Fill( { m_zone } ) );
+
+        return m_zone->CalculateFilledArea();
+    }
+
+    BOARD           m_board;
+    ZONE_CONTAINER* m_zone;
+    TRACK*          m_track;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( ZoneIncrementalFill, ZONE_INCREMENTAL_FILL_FIXTURE )
+
+
+/**
+ * Checks that a track widened in place, without a commit, is knocked out of the next
+ * incremental fill once the zones are invalidated, as PCB_EDIT_FRAME::OnModify() does.
+ */
+BOOST_AUTO_TEST_CASE( EditOutsideCommit )
+{
+    double narrowArea = Fill( true );
+
+    m_track->SetWidth( Millimeter2iu( 2 ) );
+    ZONE_FILLER::InvalidateAllZones( &m_board );
+
+    double refilledArea = Fill( true );
+
+    // Inside the widened track, outside the narrow one
+    BOOST_CHECK( !m_zone->GetFilledPolysList().Contains(
+            VECTOR2I( Millimeter2iu( 10 ), Millimeter2iu( 10.8 ) ) ) );
+    BOOST_CHECK_LT( refilledArea, narrowArea );
+
+    BOOST_CHECK_CLOSE( refilledArea, Fill( false ), 1e-6 );
+}
+
+
+/**
+ * Checks that the cached knockout of an item changed in place is not used anymore.
+ */
+BOOST_AUTO_TEST_CASE( KnockoutOfChangedItem )
+{
+    ZONE_KNOCKOUT_CACHE cache;
+    SHAPE_POLY_SET      knockout;
+    SHAPE_POLY_SET      holes;
+
+    m_track->TransformShapeWithClearanceToPolygon( knockout, 0 );
+    cache.Add( m_track, 0, ARC_HIGH_DEF, 0, knockout );
+
+    BOOST_CHECK( cache.Append( m_track, 0, ARC_HIGH_DEF, 0, holes ) );
+
+    m_track->SetWidth( Millimeter2iu( 2 ) );
+    BOOST_CHECK( !cache.Append( m_track, 0, ARC_HIGH_DEF, 0, holes ) );
+
+    m_track->SetWidth( Millimeter2iu( 0.25 ) );
+    m_track->Move( wxPoint( Millimeter2iu( 1 ), 0 ) );
+    BOOST_CHECK( !cache.Append( m_track, 0, ARC_HIGH_DEF, 0, holes ) );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,364 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file connectivity_benchmark.cpp
+ * Times the connectivity and ratsnest updates done by pcbnew on each edit.
+ *
+ * The board is loaded once, then each benchmark is run a number of times:
+ *  - a full connectivity build (CONNECTIVITY_DATA::Build(), ratsnest included),
+ *  - moving a random footprint and updating the connectivity as BOARD_COMMIT does,
+ *  - removing a random track from the connectivity,
+ *  - recomputing the ratsnest of all the nets.
+ *
+ * The edits are undone (untimed) after each run, so all the runs see the same board.
+ * The percentiles of the runs are the figures to compare between builds.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <common.h>
+#include <convert_to_biu.h>
+#include <profile.h>
+
+#include <wx/cmdline.h>
+
+#include <pcbnew_utils/board_file_utils.h>
+
+#include <class_board.h>
+#include <class_module.h>
+#include <class_track.h>
+#include <connectivity/connectivity_data.h>
+
+#include <qa_utils/utility_registry.h>
+
+
+using CONN_DURATION = std::chrono::microseconds;
+
+
+/**
+ * The timings of the runs of one benchmark
+ */
+struct CONN_BENCHMARK_RESULT
+{
+    std::string   m_name;
+    int           m_runs;
+    CONN_DURATION m_min;
+    CONN_DURATION m_p50;
+    CONN_DURATION m_p90;
+    CONN_DURATION m_p99;
+    CONN_DURATION m_max;
+    CONN_DURATION m_mean;
+    unsigned      m_unconnected;   ///< unconnected count after the last run (a sanity check)
+};
+
+
+/**
+ * A benchmark: runs one timed operation, and undoes it (untimed) afterwards
+ */
+struct CONN_BENCHMARK
+{
+    std::string           m_name;
+    std::function<void()> m_run;
+    std::function<void()> m_undo;
+};
+
+
+/**
+ * The nearest-rank percentile of sorted durations.
+ */
+static CONN_DURATION percentile( const std::vector<CONN_DURATION>& aSorted, int aPercent )
+{
+    size_t rank = ( aSorted.size() * aPercent + 99 ) / 100;
+
+    return aSorted[std::max<size_t>( rank, 1 ) - 1];
+}
+
+
+static CONN_BENCHMARK_RESULT runBenchmark( const CONN_BENCHMARK& aBenchmark, int aRuns,
+                                           CONNECTIVITY_DATA& aConnectivity )
+{
+    std::vector<CONN_DURATION> durations;
+    CONN_DURATION              total( 0 );
+
+    for( int run = 0; run < aRuns; ++run )
+    {
+        CONN_DURATION duration;
+        {
+            SCOPED_PROF_COUNTER<CONN_DURATION> timer( duration );
+            aBenchmark.m_run();
+        }
+
+        if( aBenchmark.m_undo )
+            aBenchmark.m_undo();
+
+        durations.push_back( duration );
+        total += duration;
+    }
+
+    std::sort( durations.begin(), durations.end() );
+
+    CONN_BENCHMARK_RESULT result;
+
+    result.m_name = aBenchmark.m_name;
+    result.m_runs = aRuns;
+    result.m_min = durations.front();
+    result.m_p50 = percentile( durations, 50 );
+    result.m_p90 = percentile( durations, 90 );
+    result.m_p99 = percentile( durations, 99 );
+    result.m_max = durations.back();
+    result.m_mean = total / aRuns;
+    result.m_unconnected = aConnectivity.GetUnconnectedCount();
+
+    return result;
+}
+
+
+static void reportText( const std::vector<CONN_BENCHMARK_RESULT>& aResults )
+{
+    char line[256];
+
+    snprintf( line, sizeof( line ), "%-24s %6s %10s %10s %10s %10s %10s %10s %12s\n", "",
+              "runs", "min us", "p50", "p90", "p99", "max", "mean", "unconnected" );
+    std::cout << line;
+
+    for( const CONN_BENCHMARK_RESULT& r : aResults )
+    {
+        snprintf( line, sizeof( line ),
+                  "%-24s %6d %10lld %10lld %10lld %10lld %10lld %10lld %12u\n",
+                  r.m_name.c_str(), r.m_runs, (long long) r.m_min.count(),
+                  (long long) r.m_p50.count(), (long long) r.m_p90.count(),
+                  (long long) r.m_p99.count(), (long long) r.m_max.count(),
+                  (long long) r.m_mean.count(), r.m_unconnected );
+        std::cout << line;
+    }
+}
+
+
+static void reportCsv( const std::vector<CONN_BENCHMARK_RESULT>& aResults )
+{
+    std::cout << "benchmark,runs,min_us,p50_us,p90_us,p99_us,max_us,mean_us,unconnected"
+              << std::endl;
+
+    for( const CONN_BENCHMARK_RESULT& r : aResults )
+    {
+        std::cout << '"' << r.m_name << "\"," << r.m_runs << "," << r.m_min.count() << ","
+                  << r.m_p50.count() << "," << r.m_p90.count() << "," << r.m_p99.count() << ","
+                  << r.m_max.count() << "," << r.m_mean.count() << "," << r.m_unconnected
+                  << std::endl;
+    }
+}
+
+
+static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
+    {
+            wxCMD_LINE_SWITCH,
+            "h",
+            "help",
+            _( "displays help on the command line parameters" ).mb_str(),
+            wxCMD_LINE_VAL_NONE,
+            wxCMD_LINE_OPTION_HELP,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "r",
+            "repeat",
+            _( "run each benchmark the given number of times (default 100)" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "s",
+            "seed",
+            _( "seed of the random choice of the edited items" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "f",
+            "format",
+            _( "print the timings as 'text' (default) or 'csv'" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+    },
+    {
+            wxCMD_LINE_PARAM,
+            nullptr,
+            nullptr,
+            _( "input file" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+            wxCMD_LINE_PARAM_OPTIONAL,
+    },
+    { wxCMD_LINE_NONE }
+};
+
+
+/**
+ * Tool-specific return codes
+ */
+enum CONN_BENCHMARK_RET_CODES
+{
+    LOAD_FAILED = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+};
+
+
+int connectivity_benchmark_main( int argc, char** argv )
+{
+    wxMessageOutput::Set( new wxMessageOutputStderr );
+    wxCmdLineParser cl_parser( argc, argv );
+    cl_parser.SetDesc( g_cmdLineDesc );
+    cl_parser.AddUsageText( _( "This program times the connectivity and ratsnest updates "
+                               "of pcbnew on a given PCB file." ) );
+
+    int cmd_parsed_ok = cl_parser.Parse();
+
+    if( cmd_parsed_ok != 0 )
+    {
+        // Help and invalid input both stop here
+        return ( cmd_parsed_ok == -1 ) ? KI_TEST::RET_CODES::OK : KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    long repeat = 100;
+    long seed = 1;
+    wxString format = "text";
+
+    cl_parser.Found( "repeat", &repeat );
+    cl_parser.Found( "seed", &seed );
+    cl_parser.Found( "format", &format );
+
+    if( format != "text" && format != "csv" )
+    {
+        std::cerr << "Unknown format: " << format << std::endl;
+        return KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    std::string filename;
+
+    if( cl_parser.GetParamCount() )
+        filename = cl_parser.GetParam( 0 ).ToStdString();
+
+    std::unique_ptr<BOARD> board = KI_TEST::ReadBoardFromFileOrStream( filename );
+
+    if( !board )
+        return CONN_BENCHMARK_RET_CODES::LOAD_FAILED;
+
+    board->BuildConnectivity();
+
+    std::shared_ptr<CONNECTIVITY_DATA> connectivity = board->GetConnectivity();
+    std::mt19937                       rng( (unsigned) seed );
+    std::vector<CONN_BENCHMARK>        benchmarks;
+
+    benchmarks.push_back( { "full build",
+            [&]()
+            {
+                connectivity->Build( board.get() );
+            },
+            nullptr } );
+
+    MODULES& modules = board->Modules();
+    MODULE*  movedModule = nullptr;
+    wxPoint  offset;
+
+    if( !modules.empty() )
+    {
+        benchmarks.push_back( { "move footprint",
+                [&]()
+                {
+                    std::uniform_int_distribution<size_t> pick( 0, modules.size() - 1 );
+                    std::uniform_int_distribution<int>    shift( -Millimeter2iu( 5 ),
+                                                                 Millimeter2iu( 5 ) );
+
+                    movedModule = modules[pick( rng )];
+                    offset = wxPoint( shift( rng ), shift( rng ) );
+
+                    movedModule->Move( offset );
+                    connectivity->Update( movedModule );
+                    connectivity->RecalculateRatsnest();
+                },
+                [&]()
+                {
+                    movedModule->Move( -offset );
+                    connectivity->Update( movedModule );
+                    connectivity->RecalculateRatsnest();
+                } } );
+    }
+
+    TRACKS& tracks = board->Tracks();
+    TRACK*  removedTrack = nullptr;
+
+    if( !tracks.empty() )
+    {
+        benchmarks.push_back( { "delete track",
+                [&]()
+                {
+                    std::uniform_int_distribution<size_t> pick( 0, tracks.size() - 1 );
+
+                    removedTrack = tracks[pick( rng )];
+
+                    connectivity->Remove( removedTrack );
+                    connectivity->RecalculateRatsnest();
+                },
+                [&]()
+                {
+                    connectivity->Add( removedTrack );
+                    connectivity->RecalculateRatsnest();
+                } } );
+    }
+
+    benchmarks.push_back( { "ratsnest (all nets)",
+            [&]()
+            {
+                for( MODULE* module : modules )
+                    connectivity->MarkItemNetAsDirty( module );
+
+                for( TRACK* track : tracks )
+                    connectivity->MarkItemNetAsDirty( track );
+
+                connectivity->RecalculateRatsnest();
+            },
+            nullptr } );
+
+    std::vector<CONN_BENCHMARK_RESULT> results;
+
+    for( const CONN_BENCHMARK& benchmark : benchmarks )
+        results.push_back( runBenchmark( benchmark, std::max( 1, (int) repeat ), *connectivity ) );
+
+    if( format == "csv" )
+        reportCsv( results );
+    else
+        reportText( results );
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+static bool registered = UTILITY_REGISTRY::Register( {
+        "connectivity_benchmark",
+        "Benchmark the connectivity and ratsnest updates on a PCB",
+        connectivity_benchmark_main,
+} );
@@ -21,6 +21,7 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
  */
 
+#include <algorithm>
 #include <string>
 
 #include <common.h>
@@ -32,11 +33,58 @@
 #include <widgets/ui_common.h>
 #include <pcbnew/drc/drc.h>
 #include <drc/drc_courtyard_tester.h>
+#include <drc/drc_drilled_hole_tester.h>
+#include <drc/drc_keepout_tester.h>
+#include <drc/drc_netclass_tester.h>
+#include <drc/drc_textvar_tester.h>
 
 #include <qa_utils/utility_registry.h>
 
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
 using DRC_DURATION = std::chrono::microseconds;
 
+
+/**
+ * Get the peak resident memory of the process so far, in kilobytes (0 if unknown).
+ */
+static long getPeakMemoryKb()
+{
+#if defined( _WIN32 )
+    return 0;
+#else
+    struct rusage usage;
+
+    if( getrusage( RUSAGE_SELF, &usage ) != 0 )
+        return 0;
+
+#if defined( __APPLE__ )
+    return usage.ru_maxrss / 1024;  // bytes on macOS
+#else
+    return usage.ru_maxrss;         // kilobytes on Linux and the BSDs
+#endif
+#endif
+}
+
+
+/**
+ * The timings of the repeated runs of one DRC provider
+ */
+struct DRC_BENCHMARK_RESULT
+{
+    std::string  m_name;
+    int          m_runs;
+    DRC_DURATION m_min;
+    DRC_DURATION m_mean;
+    DRC_DURATION m_max;
+    size_t       m_markers;        ///< markers reported by the last run
+    long         m_peakMemoryKb;   ///< peak memory of the process after the runs
+
+    std::map<std::string, size_t> m_counters;   ///< provider work counters of the last run
+};
+
 /**
  * DRC runner: provides a simple framework to run some DRC checks on #BOARDS.
  * The DRC_RUNNER can be set up as needed to instantiate a #DRC_TEST_PROVIDER to
@@ -54,6 +102,7 @@ public:
         bool m_verbose;
         bool m_print_times;
         bool m_print_markers;
+        int  m_repeat;          ///< number of times to run each provider
     };
 
     DRC_RUNNER( const EXECUTION_CONTEXT& aExecCtx ) : m_exec_context( aExecCtx )
@@ -64,7 +113,12 @@ public:
     {
     }
 
-    void Execute( BOARD& aBoard )
+    /**
+     * Run the DRC provider on the board m_repeat times.
+     *
+     * @return the timings of the runs
+     */
+    DRC_BENCHMARK_RESULT Execute( BOARD& aBoard )
     {
         if( m_exec_context.m_verbose )
             std::cout << "Running DRC check: " << getRunnerIntro() << std::endl;
@@ -80,18 +134,42 @@ public:
 
         std::unique_ptr<DRC_TEST_PROVIDER> drc_prov = createDrcProvider( aBoard, marker_handler );
 
-        DRC_DURATION duration;
+        DRC_BENCHMARK_RESULT result;
+        DRC_DURATION         total( 0 );
+
+        result.m_name = getRunnerIntro();
+        result.m_runs = std::max( 1, m_exec_context.m_repeat );
+        result.m_min = DRC_DURATION::max();
+        result.m_max = DRC_DURATION( 0 );
+
+        for( int run = 0; run < result.m_runs; ++run )
         {
-            SCOPED_PROF_COUNTER<DRC_DURATION> timer( duration );
-            drc_prov->RunDRC( EDA_UNITS::MILLIMETRES, aBoard );
+            markers.clear();
+
+            DRC_DURATION duration;
+            {
+                SCOPED_PROF_COUNTER<DRC_DURATION> timer( duration );
+                drc_prov->RunDRC( EDA_UNITS::MILLIMETRES, aBoard );
+            }
+
+            total += duration;
+            result.m_min = std::min( result.m_min, duration );
+            result.m_max = std::max( result.m_max, duration );
         }
 
+        result.m_mean = total / result.m_runs;
+        result.m_markers = markers.size();
+        result.m_peakMemoryKb = getPeakMemoryKb();
+        result.m_counters = drc_prov->GetCounters();
+
         // report results
         if( m_exec_context.m_print_times )
-            reportDuration( duration );
+            reportDuration( result );
 
         if( m_exec_context.m_print_markers )
             reportMarkers( aBoard, markers );
+
+        return result;
     }
 
 private:
@@ -108,9 +186,21 @@ private:
     virtual std::unique_ptr<DRC_TEST_PROVIDER> createDrcProvider(
             BOARD& aBoard, DRC_TEST_PROVIDER::MARKER_HANDLER aHandler ) = 0;
 
-    void reportDuration( const DRC_DURATION& aDuration ) const
+    void reportDuration( const DRC_BENCHMARK_RESULT& aResult ) const
     {
-        std::cout << "Took: " << aDuration.count() << "us" << std::endl;
+        if( aResult.m_runs == 1 )
+        {
+            std::cout << "Took: " << aResult.m_mean.count() << "us" << std::endl;
+        }
+        else
+        {
+            std::cout << "Took: " << aResult.m_mean.count() << "us mean over " << aResult.m_runs
+                      << " runs (min " << aResult.m_min.count() << "us, max "
+                      << aResult.m_max.count() << "us)" << std::endl;
+        }
+
+        for( const std::pair<const std::string, size_t>& counter : aResult.m_counters )
+            std::cout << "  " << counter.first << ": " << counter.second << std::endl;
     }
 
     void reportMarkers( BOARD& aBoard,
@@ -211,6 +301,181 @@ private:
 };
 
 
+/**
+ * DRC runner to run only DRC drilled hole checks
+ */
+class DRC_DRILLED_HOLE_RUNNER : public DRC_RUNNER
+{
+public:
+    DRC_DRILLED_HOLE_RUNNER( const EXECUTION_CONTEXT& aCtx ) : DRC_RUNNER( aCtx )
+    {
+    }
+
+private:
+    std::string getRunnerIntro() const override
+    {
+        return "Drilled holes";
+    }
+
+    BOARD_DESIGN_SETTINGS getDesignSettings() const override
+    {
+        return BOARD_DESIGN_SETTINGS();
+    }
+
+    std::unique_ptr<DRC_TEST_PROVIDER> createDrcProvider(
+            BOARD& aBoard, DRC_TEST_PROVIDER::MARKER_HANDLER aHandler ) override
+    {
+        return std::make_unique<DRC_DRILLED_HOLE_TESTER>( aHandler );
+    }
+};
+
+
+/**
+ * DRC runner to run only DRC keepout area checks
+ */
+class DRC_KEEPOUT_RUNNER : public DRC_RUNNER
+{
+public:
+    DRC_KEEPOUT_RUNNER( const EXECUTION_CONTEXT& aCtx ) : DRC_RUNNER( aCtx )
+    {
+    }
+
+private:
+    std::string getRunnerIntro() const override
+    {
+        return "Keepout areas";
+    }
+
+    BOARD_DESIGN_SETTINGS getDesignSettings() const override
+    {
+        return BOARD_DESIGN_SETTINGS();
+    }
+
+    std::unique_ptr<DRC_TEST_PROVIDER> createDrcProvider(
+            BOARD& aBoard, DRC_TEST_PROVIDER::MARKER_HANDLER aHandler ) override
+    {
+        return std::make_unique<DRC_KEEPOUT_TESTER>( aHandler );
+    }
+};
+
+
+/**
+ * DRC runner to run only DRC netclass checks
+ */
+class DRC_NETCLASS_RUNNER : public DRC_RUNNER
+{
+public:
+    DRC_NETCLASS_RUNNER( const EXECUTION_CONTEXT& aCtx ) : DRC_RUNNER( aCtx )
+    {
+    }
+
+private:
+    std::string getRunnerIntro() const override
+    {
+        return "Netclasses";
+    }
+
+    BOARD_DESIGN_SETTINGS getDesignSettings() const override
+    {
+        return BOARD_DESIGN_SETTINGS();
+    }
+
+    std::unique_ptr<DRC_TEST_PROVIDER> createDrcProvider(
+            BOARD& aBoard, DRC_TEST_PROVIDER::MARKER_HANDLER aHandler ) override
+    {
+        return std::make_unique<DRC_NETCLASS_TESTER>( aHandler );
+    }
+};
+
+
+/**
+ * DRC runner to run only DRC unresolved text variable checks (without a worksheet)
+ */
+class DRC_TEXTVAR_RUNNER : public DRC_RUNNER
+{
+public:
+    DRC_TEXTVAR_RUNNER( const EXECUTION_CONTEXT& aCtx ) : DRC_RUNNER( aCtx )
+    {
+    }
+
+private:
+    std::string getRunnerIntro() const override
+    {
+        return "Text variables";
+    }
+
+    BOARD_DESIGN_SETTINGS getDesignSettings() const override
+    {
+        return BOARD_DESIGN_SETTINGS();
+    }
+
+    std::unique_ptr<DRC_TEST_PROVIDER> createDrcProvider(
+            BOARD& aBoard, DRC_TEST_PROVIDER::MARKER_HANDLER aHandler ) override
+    {
+        return std::make_unique<DRC_TEXTVAR_TESTER>( aHandler, nullptr );
+    }
+};
+
+
+/**
+ * Print the benchmark results as CSV, one line per provider
+ */
+static void reportCsv( const std::vector<DRC_BENCHMARK_RESULT>& aResults )
+{
+    std::cout << "provider,runs,min_us,mean_us,max_us,markers,peak_memory_kb,counters"
+              << std::endl;
+
+    for( const DRC_BENCHMARK_RESULT& r : aResults )
+    {
+        std::cout << '"' << r.m_name << "\"," << r.m_runs << "," << r.m_min.count() << ","
+                  << r.m_mean.count() << "," << r.m_max.count() << "," << r.m_markers << ","
+                  << r.m_peakMemoryKb << ",\"";
+
+        // The counters go into a single column, as "name=value" pairs
+        for( auto it = r.m_counters.begin(); it != r.m_counters.end(); ++it )
+        {
+            std::cout << ( it == r.m_counters.begin() ? "" : ";" ) << it->first << "="
+                      << it->second;
+        }
+
+        std::cout << '"' << std::endl;
+    }
+}
+
+
+/**
+ * Print the benchmark results as a JSON array, one object per provider
+ */
+static void reportJson( const std::vector<DRC_BENCHMARK_RESULT>& aResults )
+{
+    std::cout << "[" << std::endl;
+
+    for( size_t i = 0; i < aResults.size(); ++i )
+    {
+        const DRC_BENCHMARK_RESULT& r = aResults[i];
+
+        std::cout << "  { \"provider\": \"" << r.m_name << "\", \"runs\": " << r.m_runs
+                  << ", \"min_us\": " << r.m_min.count()
+                  << ", \"mean_us\": " << r.m_mean.count()
+                  << ", \"max_us\": " << r.m_max.count()
+                  << ", \"markers\": " << r.m_markers
+                  << ", \"peak_memory_kb\": " << r.m_peakMemoryKb
+                  << ", \"counters\": {";
+
+        for( auto it = r.m_counters.begin(); it != r.m_counters.end(); ++it )
+        {
+            std::cout << ( it == r.m_counters.begin() ? " " : ", " ) << '"' << it->first
+                      << "\": " << it->second;
+        }
+
+        std::cout << ( r.m_counters.empty() ? "} }" : " } }" )
+                  << ( i + 1 < aResults.size() ? "," : "" ) << std::endl;
+    }
+
+    std::cout << "]" << std::endl;
+}
+
+
 static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
     {
             wxCMD_LINE_SWITCH,
@@ -256,6 +521,44 @@ static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
             "courtyard-missing",
             _( "perform courtyard-missing checking" ).mb_str(),
     },
+    {
+            wxCMD_LINE_SWITCH,
+            "d",
+            "drilled-holes",
+            _( "perform drilled hole checking" ).mb_str(),
+    },
+    {
+            wxCMD_LINE_SWITCH,
+            "k",
+            "keepouts",
+            _( "perform keepout area checking" ).mb_str(),
+    },
+    {
+            wxCMD_LINE_SWITCH,
+            "n",
+            "netclasses",
+            _( "perform netclass checking" ).mb_str(),
+    },
+    {
+            wxCMD_LINE_SWITCH,
+            "x",
+            "text-variables",
+            _( "perform unresolved text variable checking" ).mb_str(),
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "r",
+            "repeat",
+            _( "run each check the given number of times (benchmarking)" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "f",
+            "format",
+            _( "print a summary of the timings: 'csv' or 'json'" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+    },
     {
             wxCMD_LINE_PARAM,
             nullptr,
@@ -308,27 +611,71 @@ int drc_main_func( int argc, char** argv )
     if( !board )
         return PARSER_RET_CODES::PARSE_FAILED;
 
+    long repeat = 1;
+    cl_parser.Found( "repeat", &repeat );
+
+    wxString format;
+    cl_parser.Found( "format", &format );
+
+    if( !format.IsEmpty() && format != "csv" && format != "json" )
+    {
+        std::cerr << "Unknown summary format: " << format << std::endl;
+        return KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
     DRC_RUNNER::EXECUTION_CONTEXT exec_context{
         verbose,
         cl_parser.Found( "timings" ),
         cl_parser.Found( "print-markers" ),
+        (int) repeat,
     };
 
     const bool all = cl_parser.Found( "all-checks" );
 
+    std::vector<DRC_BENCHMARK_RESULT> results;
+
     // Run the DRC on the board
     if( all || cl_parser.Found( "courtyard-overlap" ) )
     {
         DRC_COURTYARD_OVERLAP_RUNNER runner( exec_context );
-        runner.Execute( *board );
+        results.push_back( runner.Execute( *board ) );
     }
 
     if( all || cl_parser.Found( "courtyard-missing" ) )
     {
         DRC_COURTYARD_MISSING_RUNNER runner( exec_context );
-        runner.Execute( *board );
+        results.push_back( runner.Execute( *board ) );
     }
 
+    if( all || cl_parser.Found( "drilled-holes" ) )
+    {
+        DRC_DRILLED_HOLE_RUNNER runner( exec_context );
+        results.push_back( runner.Execute( *board ) );
+    }
+
+    if( all || cl_parser.Found( "keepouts" ) )
+    {
+        DRC_KEEPOUT_RUNNER runner( exec_context );
+        results.push_back( runner.Execute( *board ) );
+    }
+
+    if( all || cl_parser.Found( "netclasses" ) )
+    {
+        DRC_NETCLASS_RUNNER runner( exec_context );
+        results.push_back( runner.Execute( *board ) );
+    }
+
+    if( all || cl_parser.Found( "text-variables" ) )
+    {
+        DRC_TEXTVAR_RUNNER runner( exec_context );
+        results.push_back( runner.Execute( *board ) );
+    }
+
+    if( format == "csv" )
+        reportCsv( results );
+    else if( format == "json" )
+        reportJson( results );
+
     return KI_TEST::RET_CODES::OK;
 }
 
@@ -23,24 +23,43 @@
 
 #include <qa_utils/utility_registry.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <new>
 #include <string>
+#include <vector>
 
 #include <common.h>
 #include <profile.h>
 
 #include <wx/cmdline.h>
 
+#include <class_board.h>
 #include <class_board_item.h>
+#include <class_marker_pcb.h>
 #include <kicad_plugin.h>
 #include <pcb_parser.h>
 #include <richio.h>
+#include <zone_filler.h>
+#include <drc/drc_courtyard_tester.h>
+#include <drc/drc_drilled_hole_tester.h>
+#include <drc/drc_keepout_tester.h>
+#include <drc/drc_netclass_tester.h>
+#include <drc/drc_textvar_tester.h>
 
 #include <wx/cmdline.h>
 
 #include <qa_utils/stdstream_line_reader.h>
 #include <qa_utils/utility_registry.h>
 
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
 
 using PARSE_DURATION = std::chrono::microseconds;
 
@@ -87,10 +106,242 @@ bool parse( std::istream& aStream, bool aVerbose )
 }
 
 
+/*
+ * The allocations of the process are counted for the benchmark, by replacing the global
+ * operator new.  The other forms of new and delete call these two.
+ */
+static std::atomic<size_t> g_allocCount( 0 );
+static std::atomic<size_t> g_allocBytes( 0 );
+
+
+void* operator new( std::size_t aSize )
+{
+    g_allocCount.fetch_add( 1, std::memory_order_relaxed );
+    g_allocBytes.fetch_add( aSize, std::memory_order_relaxed );
+
+    if( void* ptr = std::malloc( aSize ? aSize : 1 ) )
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+
+void operator delete( void* aPtr ) noexcept
+{
+    std::free( aPtr );
+}
+
+
+/**
+ * Get the peak resident memory of the process so far, in kilobytes (0 if unknown).
+ */
+static long getPeakMemoryKb()
+{
+#if defined( _WIN32 )
+    return 0;
+#else
+    struct rusage usage;
+
+    if( getrusage( RUSAGE_SELF, &usage ) != 0 )
+        return 0;
+
+#if defined( __APPLE__ )
+    return usage.ru_maxrss / 1024;  // bytes on macOS
+#else
+    return usage.ru_maxrss;         // kilobytes on Linux and the BSDs
+#endif
+#endif
+}
+
+
+/**
+ * The measures of the repeated runs of one phase of the benchmark on one board
+ */
+struct PHASE_RESULT
+{
+    std::string m_file;
+    std::string m_phase;
+    int         m_runs = 0;
+    double      m_minMs = 0.0;
+    double      m_totalMs = 0.0;
+    double      m_maxMs = 0.0;
+    size_t      m_allocations = 0;      ///< in all the runs
+    size_t      m_allocatedBytes = 0;   ///< in all the runs
+    long        m_peakMemoryKb = 0;     ///< of the process, after the last run
+};
+
+
+/**
+ * Time one run of a phase, and count its allocations.
+ */
+static void measurePhase( PHASE_RESULT& aResult, const std::function<void()>& aPhase )
+{
+    size_t allocCount = g_allocCount;
+    size_t allocBytes = g_allocBytes;
+
+    PROF_COUNTER timer;
+    aPhase();
+    double msecs = timer.msecs();
+
+    aResult.m_allocations += g_allocCount - allocCount;
+    aResult.m_allocatedBytes += g_allocBytes - allocBytes;
+    aResult.m_peakMemoryKb = getPeakMemoryKb();
+
+    aResult.m_minMs = aResult.m_runs ? std::min( aResult.m_minMs, msecs ) : msecs;
+    aResult.m_maxMs = std::max( aResult.m_maxMs, msecs );
+    aResult.m_totalMs += msecs;
+    aResult.m_runs++;
+}
+
+
+/**
+ * Run the phases of a board edit session on a board file, as pcbnew does them: load,
+ * connectivity build, zone refill, DRC (the standalone providers) and save (to memory).
+ * Each run starts from a new load of the file.
+ *
+ * @return false if the file cannot be loaded as a board
+ */
+static bool benchmarkBoard( const std::string& aFilename, int aRuns,
+                            std::vector<PHASE_RESULT>& aResults )
+{
+    const std::vector<std::string> phases = { "load", "connectivity", "zone fill", "drc",
+                                              "save" };
+    std::vector<PHASE_RESULT> results( phases.size() );
+
+    for( size_t ii = 0; ii < phases.size(); ++ii )
+    {
+        results[ii].m_file = aFilename;
+        results[ii].m_phase = phases[ii];
+    }
+
+    for( int run = 0; run < aRuns; ++run )
+    {
+        std::unique_ptr<BOARD> board;
+
+        try
+        {
+            measurePhase( results[0],
+                    [&]()
+                    {
+                        FILE_LINE_READER reader( aFilename );
+                        PCB_PARSER       parser( &reader );
+
+                        board.reset( dynamic_cast<BOARD*>( parser.Parse() ) );
+                    } );
+        }
+        catch( const IO_ERROR& parse_error )
+        {
+            std::cerr << parse_error.Problem() << std::endl;
+            std::cerr << parse_error.Where() << std::endl;
+        }
+
+        if( !board )
+            return false;
+
+        measurePhase( results[1],
+                [&]()
+                {
+                    board->BuildConnectivity();
+                } );
+
+        measurePhase( results[2],
+                [&]()
+                {
+                    ZONE_FILLER filler( board.get() );
+                    filler.Fill( board->Zones() );
+                } );
+
+        measurePhase( results[3],
+                [&]()
+                {
+                    DRC_TEST_PROVIDER::MARKER_HANDLER handler =
+                            []( MARKER_PCB* aMarker )
+                            {
+                                delete aMarker;
+                            };
+
+                    std::vector<std::unique_ptr<DRC_TEST_PROVIDER>> providers;
+
+                    providers.push_back( std::make_unique<DRC_COURTYARD_TESTER>( handler ) );
+                    providers.push_back( std::make_unique<DRC_DRILLED_HOLE_TESTER>( handler ) );
+                    providers.push_back( std::make_unique<DRC_KEEPOUT_TESTER>( handler ) );
+                    providers.push_back( std::make_unique<DRC_NETCLASS_TESTER>( handler ) );
+                    providers.push_back( std::make_unique<DRC_TEXTVAR_TESTER>( handler,
+                                                                                nullptr ) );
+
+                    for( const std::unique_ptr<DRC_TEST_PROVIDER>& provider : providers )
+                        provider->RunDRC( EDA_UNITS::MILLIMETRES, *board );
+                } );
+
+        measurePhase( results[4],
+                [&]()
+                {
+                    PCB_IO io;
+                    io.Format( board.get() );
+                } );
+    }
+
+    aResults.insert( aResults.end(), results.begin(), results.end() );
+    return true;
+}
+
+
+/**
+ * Print the benchmark results as CSV, one line per phase of each board
+ */
+static void reportCsv( const std::vector<PHASE_RESULT>& aResults )
+{
+    std::cout << "file,phase,runs,min_ms,mean_ms,max_ms,allocations,allocated_bytes,"
+                 "peak_memory_kb" << std::endl;
+
+    for( const PHASE_RESULT& r : aResults )
+    {
+        std::cout << '"' << r.m_file << "\",\"" << r.m_phase << "\"," << r.m_runs << ","
+                  << r.m_minMs << "," << r.m_totalMs / r.m_runs << "," << r.m_maxMs << ","
+                  << r.m_allocations / r.m_runs << "," << r.m_allocatedBytes / r.m_runs << ","
+                  << r.m_peakMemoryKb << std::endl;
+    }
+}
+
+
+/**
+ * Print the benchmark results as a JSON array, one object per phase of each board
+ */
+static void reportJson( const std::vector<PHASE_RESULT>& aResults )
+{
+    std::cout << "[" << std::endl;
+
+    for( size_t i = 0; i < aResults.size(); ++i )
+    {
+        const PHASE_RESULT& r = aResults[i];
+
+        std::cout << "  { \"file\": \"" << r.m_file << "\", \"phase\": \"" << r.m_phase
+                  << "\", \"runs\": " << r.m_runs
+                  << ", \"min_ms\": " << r.m_minMs
+                  << ", \"mean_ms\": " << r.m_totalMs / r.m_runs
+                  << ", \"max_ms\": " << r.m_maxMs
+                  << ", \"allocations\": " << r.m_allocations / r.m_runs
+                  << ", \"allocated_bytes\": " << r.m_allocatedBytes / r.m_runs
+                  << ", \"peak_memory_kb\": " << r.m_peakMemoryKb << " }"
+                  << ( i + 1 < aResults.size() ? "," : "" ) << std::endl;
+    }
+
+    std::cout << "]" << std::endl;
+}
+
+
 static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
     { wxCMD_LINE_SWITCH, "h", "help", _( "displays help on the command line parameters" ).mb_str(),
             wxCMD_LINE_VAL_NONE, wxCMD_LINE_OPTION_HELP },
     { wxCMD_LINE_SWITCH, "v", "verbose", _( "print parsing information" ).mb_str() },
+    { wxCMD_LINE_SWITCH, "b", "benchmark",
+            _( "time the load, connectivity, zone fill, DRC and save of the boards" ).mb_str() },
+    { wxCMD_LINE_OPTION, "r", "repeat",
+            _( "run the benchmark of each board the given number of times (default 1)" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER },
+    { wxCMD_LINE_OPTION, "f", "format",
+            _( "print the benchmark results as 'json' (default) or 'csv'" ).mb_str(),
+            wxCMD_LINE_VAL_STRING },
     { wxCMD_LINE_PARAM, nullptr, nullptr, _( "input file" ).mb_str(), wxCMD_LINE_VAL_STRING,
             wxCMD_LINE_PARAM_OPTIONAL | wxCMD_LINE_PARAM_MULTIPLE },
     { wxCMD_LINE_NONE }
@@ -115,7 +366,8 @@ int pcb_parser_main_func( int argc, char** argv )
     cl_parser.AddUsageText(
             _( "This program parses PCB files, either from the "
                "stdin stream or from the given filenames. This can be used either for "
-               "standalone testing of the parser or for fuzz testing." ) );
+               "standalone testing of the parser or for fuzz testing. With --benchmark, "
+               "it times the phases of a board edit session on a set of reference boards." ) );
 
     int cmd_parsed_ok = cl_parser.Parse();
     if( cmd_parsed_ok != 0 )
@@ -130,6 +382,46 @@ int pcb_parser_main_func( int argc, char** argv )
 
     const auto file_count = cl_parser.GetParamCount();
 
+    if( cl_parser.Found( "benchmark" ) )
+    {
+        long     repeat = 1;
+        wxString format = "json";
+
+        cl_parser.Found( "repeat", &repeat );
+        cl_parser.Found( "format", &format );
+
+        if( format != "json" && format != "csv" )
+        {
+            std::cerr << "Unknown format: " << format << std::endl;
+            return KI_TEST::RET_CODES::BAD_CMDLINE;
+        }
+
+        if( file_count == 0 )
+        {
+            std::cerr << "The benchmark needs board files" << std::endl;
+            return KI_TEST::RET_CODES::BAD_CMDLINE;
+        }
+
+        std::vector<PHASE_RESULT> results;
+
+        for( unsigned i = 0; i < file_count; i++ )
+        {
+            const auto filename = cl_parser.GetParam( i ).ToStdString();
+
+            if( verbose )
+                std::cout << "Benchmarking: " << filename << std::endl;
+
+            ok = benchmarkBoard( filename, std::max( 1, (int) repeat ), results ) && ok;
+        }
+
+        if( format == "csv" )
+            reportCsv( results );
+        else
+            reportJson( results );
+
+        return ok ? KI_TEST::RET_CODES::OK : PARSER_RET_CODES::PARSE_FAILED;
+    }
+
     if( file_count == 0 )
     {
         // Parse the file provided on stdin - used by AFL to drive the
@@ -166,4 +458,5 @@ int pcb_parser_main_func( int argc, char** argv )
 
 
 static bool registered = UTILITY_REGISTRY::Register(
-        { "pcb_parser", "Parse a KiCad PCB file", pcb_parser_main_func } );
\ No newline at end of file
+        { "pcb_parser", "Parse a KiCad PCB file, or benchmark the load and save of boards",
+          pcb_parser_main_func } );
\ No newline at end of file
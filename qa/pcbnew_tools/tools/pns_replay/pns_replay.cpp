@@ -0,0 +1,350 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file pns_replay.cpp
+ * Replays a router event log against a board, without a view, and reports the latency of
+ * the router events.
+ *
+ * The event log is the one saved by PNS::ROUTER::DumpLog() (the '0' key while routing, in
+ * debug builds).  It holds the events of the last routing or dragging session, which must
+ * be replayed against the board as it was when the session started.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <common.h>
+#include <profile.h>
+
+#include <wx/cmdline.h>
+
+#include <pcbnew_utils/board_file_utils.h>
+
+#include <class_board.h>
+#include <router/pns_kicad_iface.h>
+#include <router/pns_logger.h>
+#include <router/pns_node.h>
+#include <router/pns_router.h>
+#include <router/pns_routing_settings.h>
+#include <router/pns_sizes_settings.h>
+
+#include <qa_utils/utility_registry.h>
+
+
+using REPLAY_DURATION = std::chrono::microseconds;
+
+
+/**
+ * The measures of all the replayed events of one kind
+ */
+struct REPLAY_SAMPLES
+{
+    std::vector<REPLAY_DURATION> m_durations;
+    int64_t                      m_collisionQueries = 0;
+    int64_t                      m_shoveIterations = 0;
+};
+
+
+static const char* eventName( PNS::LOGGER::EVENT_TYPE aType )
+{
+    switch( aType )
+    {
+    case PNS::LOGGER::EVT_START_ROUTE: return "start route";
+    case PNS::LOGGER::EVT_START_DRAG:  return "start drag";
+    case PNS::LOGGER::EVT_FIX:         return "fix";
+    case PNS::LOGGER::EVT_MOVE:        return "move";
+    case PNS::LOGGER::EVT_ABORT:       return "stop";
+    }
+
+    return "unknown";
+}
+
+
+/**
+ * The nearest-rank percentile of sorted durations.
+ */
+static REPLAY_DURATION percentile( const std::vector<REPLAY_DURATION>& aSorted, int aPercent )
+{
+    size_t rank = ( aSorted.size() * aPercent + 99 ) / 100;
+
+    return aSorted[std::max<size_t>( rank, 1 ) - 1];
+}
+
+
+/**
+ * Sends one logged event to the router.
+ */
+static void replayEvent( PNS::ROUTER& aRouter, BOARD* aBoard,
+                         const PNS::LOGGER::EVENT_ENTRY& aEvent )
+{
+    PNS::ITEM* item = nullptr;
+
+    if( aEvent.uuid != niluuid )
+        item = aRouter.QueryItemByParent( aBoard->GetItem( aEvent.uuid ) );
+
+    switch( aEvent.type )
+    {
+    case PNS::LOGGER::EVT_START_ROUTE:
+    {
+        PNS::SIZES_SETTINGS sizes( aRouter.Sizes() );
+
+        sizes.Init( aBoard, item );
+        aRouter.UpdateSizes( sizes );
+        aRouter.StartRouting( aEvent.p, item, aEvent.param );
+        break;
+    }
+
+    case PNS::LOGGER::EVT_START_DRAG:
+        if( item )
+            aRouter.StartDragging( aEvent.p, item, aEvent.param );
+
+        break;
+
+    case PNS::LOGGER::EVT_FIX:
+        aRouter.FixRoute( aEvent.p, item, aEvent.param != 0 );
+        break;
+
+    case PNS::LOGGER::EVT_MOVE:
+        aRouter.Move( aEvent.p, item );
+        break;
+
+    case PNS::LOGGER::EVT_ABORT:
+        aRouter.StopRouting();
+        break;
+    }
+}
+
+
+static void reportText( const std::map<PNS::LOGGER::EVENT_TYPE, REPLAY_SAMPLES>& aSamples )
+{
+    char line[256];
+
+    snprintf( line, sizeof( line ), "%-12s %7s %10s %10s %10s %10s %12s %12s\n", "", "events",
+              "p50 us", "p90", "p99", "max", "queries/evt", "shoves/evt" );
+    std::cout << line;
+
+    for( const auto& entry : aSamples )
+    {
+        const std::vector<REPLAY_DURATION>& d = entry.second.m_durations;
+        int                                  n = (int) d.size();
+
+        snprintf( line, sizeof( line ), "%-12s %7d %10lld %10lld %10lld %10lld %12.1f %12.1f\n",
+                  eventName( entry.first ), n, (long long) percentile( d, 50 ).count(),
+                  (long long) percentile( d, 90 ).count(),
+                  (long long) percentile( d, 99 ).count(), (long long) d.back().count(),
+                  (double) entry.second.m_collisionQueries / n,
+                  (double) entry.second.m_shoveIterations / n );
+        std::cout << line;
+    }
+}
+
+
+static void reportCsv( const std::map<PNS::LOGGER::EVENT_TYPE, REPLAY_SAMPLES>& aSamples )
+{
+    std::cout << "event,count,p50_us,p90_us,p99_us,max_us,collision_queries,shove_iterations"
+              << std::endl;
+
+    for( const auto& entry : aSamples )
+    {
+        const std::vector<REPLAY_DURATION>& d = entry.second.m_durations;
+
+        std::cout << '"' << eventName( entry.first ) << "\"," << d.size() << ","
+                  << percentile( d, 50 ).count() << "," << percentile( d, 90 ).count() << ","
+                  << percentile( d, 99 ).count() << "," << d.back().count() << ","
+                  << entry.second.m_collisionQueries << "," << entry.second.m_shoveIterations
+                  << std::endl;
+    }
+}
+
+
+static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
+    {
+            wxCMD_LINE_SWITCH,
+            "h",
+            "help",
+            _( "displays help on the command line parameters" ).mb_str(),
+            wxCMD_LINE_VAL_NONE,
+            wxCMD_LINE_OPTION_HELP,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "r",
+            "repeat",
+            _( "replay the log the given number of times (default 1)" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "m",
+            "mode",
+            _( "routing mode: 'shove' (default), 'walkaround' or 'mark'" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "f",
+            "format",
+            _( "print the timings as 'text' (default) or 'csv'" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+    },
+    {
+            wxCMD_LINE_PARAM,
+            nullptr,
+            nullptr,
+            _( "board file" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+    },
+    {
+            wxCMD_LINE_PARAM,
+            nullptr,
+            nullptr,
+            _( "router event log" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+    },
+    { wxCMD_LINE_NONE }
+};
+
+
+/**
+ * Tool-specific return codes
+ */
+enum PNS_REPLAY_RET_CODES
+{
+    LOAD_FAILED = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+    NO_EVENTS,
+};
+
+
+int pns_replay_main( int argc, char** argv )
+{
+    wxMessageOutput::Set( new wxMessageOutputStderr );
+    wxCmdLineParser cl_parser( argc, argv );
+    cl_parser.SetDesc( g_cmdLineDesc );
+    cl_parser.AddUsageText( _( "This program replays an interactive router event log against "
+                               "a board, and reports the latency of the router." ) );
+
+    int cmd_parsed_ok = cl_parser.Parse();
+
+    if( cmd_parsed_ok != 0 )
+    {
+        // Help and invalid input both stop here
+        return ( cmd_parsed_ok == -1 ) ? KI_TEST::RET_CODES::OK : KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    long     repeat = 1;
+    wxString mode = "shove";
+    wxString format = "text";
+
+    cl_parser.Found( "repeat", &repeat );
+    cl_parser.Found( "mode", &mode );
+    cl_parser.Found( "format", &format );
+
+    std::map<wxString, PNS::PNS_MODE> modes = { { "shove", PNS::RM_Shove },
+                                                { "walkaround", PNS::RM_Walkaround },
+                                                { "mark", PNS::RM_MarkObstacles } };
+
+    if( !modes.count( mode ) || ( format != "text" && format != "csv" ) )
+    {
+        std::cerr << "Unknown mode or format" << std::endl;
+        return KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    std::unique_ptr<BOARD> board =
+            KI_TEST::ReadBoardFromFileOrStream( cl_parser.GetParam( 0 ).ToStdString() );
+
+    if( !board )
+        return PNS_REPLAY_RET_CODES::LOAD_FAILED;
+
+    std::ifstream logFile( cl_parser.GetParam( 1 ).ToStdString() );
+
+    if( !logFile )
+        return PNS_REPLAY_RET_CODES::LOAD_FAILED;
+
+    std::vector<PNS::LOGGER::EVENT_ENTRY> events = PNS::LOGGER::ParseEvents( logFile );
+
+    if( events.empty() )
+    {
+        std::cerr << "No router events in the log" << std::endl;
+        return PNS_REPLAY_RET_CODES::NO_EVENTS;
+    }
+
+    PNS::ROUTING_SETTINGS settings( nullptr, "" );
+    PNS_KICAD_IFACE_BASE  iface;
+    PNS::ROUTER           router;
+
+    settings.SetMode( modes[mode] );
+    iface.SetBoard( board.get() );
+    router.SetInterface( &iface );
+    router.LoadSettings( &settings );
+
+    std::map<PNS::LOGGER::EVENT_TYPE, REPLAY_SAMPLES> samples;
+
+    for( int run = 0; run < std::max( 1, (int) repeat ); ++run )
+    {
+        // Fixed routes go to the world only: start each run from the board again
+        router.ClearWorld();
+        router.SyncWorld();
+
+        for( const PNS::LOGGER::EVENT_ENTRY& evt : events )
+        {
+            REPLAY_SAMPLES& s = samples[evt.type];
+            int64_t         queries = PNS::NODE::CollisionQueryCount();
+            int             shoves = router.ShoveIterationCount();
+            REPLAY_DURATION duration;
+
+            {
+                SCOPED_PROF_COUNTER<REPLAY_DURATION> timer( duration );
+                replayEvent( router, board.get(), evt );
+            }
+
+            s.m_durations.push_back( duration );
+            s.m_collisionQueries += PNS::NODE::CollisionQueryCount() - queries;
+            s.m_shoveIterations += router.ShoveIterationCount() - shoves;
+        }
+
+        router.StopRouting();
+    }
+
+    for( auto& entry : samples )
+        std::sort( entry.second.m_durations.begin(), entry.second.m_durations.end() );
+
+    if( format == "csv" )
+        reportCsv( samples );
+    else
+        reportText( samples );
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+static bool registered = UTILITY_REGISTRY::Register( {
+        "pns_replay",
+        "Replay an interactive router event log and time it",
+        pns_replay_main,
+} );
@@ -1,3 +1,4 @@
+import array
 import code
 import unittest
 import os
@@ -88,6 +89,36 @@ class TestBoardClass(unittest.TestCase):
         self.assertEqual(pad.this, p2.this)
         self.assertEqual(pad.this, p3.this)
 
+    def test_pcb_bulk_tracks_data(self):
+        tracks = [t for t in self.pcb.GetTracks() if t.Type() == PCB_TRACE_T]
+        data = array.array('i', GetTracksData(self.pcb))
+        self.assertEqual(len(data), 7 * len(tracks))
+
+        first = tracks[0]
+        self.assertEqual(data[0], first.GetStart().x)
+        self.assertEqual(data[4], first.GetWidth())
+        self.assertEqual(data[6], first.GetNetCode())
+
+        data[4] = first.GetWidth() + FromMM(0.1)
+        self.assertEqual(SetTracksData(self.pcb, data), 1)
+        self.assertEqual(first.GetWidth(), data[4])
+
+        # unchanged, wrong size and unknown net buffers
+        self.assertEqual(SetTracksData(self.pcb, data), 0)
+        self.assertEqual(SetTracksData(self.pcb, data[:-1]), -1)
+        data[6] = 100000
+        self.assertEqual(SetTracksData(self.pcb, data), -1)
+
+    def test_pcb_bulk_modules_data(self):
+        modules = [m for m in self.pcb.GetModules()]
+        data = array.array('i', GetModulesData(self.pcb))
+        self.assertEqual(len(data), 4 * len(modules))
+
+        module = modules[0]
+        data[0] += FromMM(1.0)
+        self.assertEqual(SetModulesData(self.pcb, data), 1)
+        self.assertEqual(module.GetPosition().x, data[0])
+
     def test_pcb_save_and_load(self):
         pcb = BOARD()
         pcb.GetTitleBlock().SetTitle(self.TITLE)
@@ -445,7 +445,16 @@ bool Orientation( const Path& poly )
 
 // ------------------------------------------------------------------------------
 
-double Area( const Path& poly )
+bool Orientation( const IntPairPath& poly )
+{
+    return Area( poly ) >= 0;
+}
+
+
+// ------------------------------------------------------------------------------
+
+template <class PathType>
+static double PathArea( const PathType& poly )
 {
     int size = (int) poly.size();
 
@@ -464,6 +473,18 @@ double Area( const Path& poly )
 }
 
 
+double Area( const Path& poly )
+{
+    return PathArea( poly );
+}
+
+
+double Area( const IntPairPath& poly )
+{
+    return PathArea( poly );
+}
+
+
 // ------------------------------------------------------------------------------
 
 double Area( const OutPt* op )
@@ -1353,6 +1374,19 @@ TEdge* ClipperBase::ProcessBound( TEdge* E, bool NextIsForward )
 // ------------------------------------------------------------------------------
 
 bool ClipperBase::AddPath( const Path& pg, PolyType PolyTyp, bool Closed )
+{
+    return AddPathT( pg, PolyTyp, Closed );
+}
+
+
+bool ClipperBase::AddPath( const IntPairPath& pg, PolyType PolyTyp, bool Closed )
+{
+    return AddPathT( pg, PolyTyp, Closed );
+}
+
+
+template <class PathType>
+bool ClipperBase::AddPathT( const PathType& pg, PolyType PolyTyp, bool Closed )
 {
 #ifdef use_lines
 
@@ -4918,6 +4952,8 @@ ClipperOffset::ClipperOffset( double miterLimit, double arcTolerance )
 
     //Avoid uninitialized vars:
     MiterFallback = jtSquare;
+    CompactJoins = false;
+    m_compactTolerance = 0.0;
     m_delta = 1.0;
     m_sinA = 0.0;
     m_sin = 0.0;
@@ -4950,6 +4986,19 @@ void ClipperOffset::Clear()
 // ------------------------------------------------------------------------------
 
 void ClipperOffset::AddPath( const Path& path, JoinType joinType, EndType endType )
+{
+    AddPathT( path, joinType, endType );
+}
+
+
+void ClipperOffset::AddPath( const IntPairPath& path, JoinType joinType, EndType endType )
+{
+    AddPathT( path, joinType, endType );
+}
+
+
+template <class PathType>
+void ClipperOffset::AddPathT( const PathType& path, JoinType joinType, EndType endType )
 {
     int highI = (int) path.size() - 1;
 
@@ -5177,6 +5226,7 @@ void ClipperOffset::DoOffset( double delta )
     m_sin = std::sin( two_pi / steps );
     m_cos = std::cos( two_pi / steps );
     m_StepsPerRad = steps / two_pi;
+    m_compactTolerance = CompactJoins ? y : 0.0;
 
     if( delta < 0.0 )
         m_sin = -m_sin;
@@ -5381,7 +5431,7 @@ void ClipperOffset::OffsetPoint( int j, int& k, JoinType jointype )
         m_destPoly.push_back( IntPoint( Round( m_srcPoly[j].X + m_normals[j].X * m_delta ),
                         Round( m_srcPoly[j].Y + m_normals[j].Y * m_delta ) ) );
     }
-    else
+    else if( !CompactJoins || !CompactJoin( j, k ) )
         switch( jointype )
         {
         case jtMiter:
@@ -5440,6 +5490,22 @@ void ClipperOffset::DoMiter( int j, int k, double r )
 
 // ------------------------------------------------------------------------------
 
+bool ClipperOffset::CompactJoin( int j, int k )
+{
+    // The miter point is at m_delta * sqrt( 2 / r ) of the vertex, i.e. outside of the
+    // round join by at most the arc tolerance, so it can replace the two (or more) points
+    // of the round or square join.  Without this, each round of offsetting a polygon that
+    // has many small (e.g. already rounded) corners doubles its vertex count.
+    double r = 1 + ( m_normals[j].X * m_normals[k].X + m_normals[j].Y * m_normals[k].Y );
+
+    if( r <= 1.0 || std::fabs( m_delta ) * ( std::sqrt( 2 / r ) - 1 ) > m_compactTolerance )
+        return false;
+
+    DoMiter( j, k, r );
+    return true;
+}
+
+
 void ClipperOffset::DoRound( int j, int k )
 {
     double a = std::atan2( m_sinA,
@@ -116,6 +116,27 @@ struct IntPoint
 typedef std::vector<IntPoint>   Path;
 typedef std::vector<Path>       Paths;
 
+// A read only view of a path stored as consecutive 32 bit (x, y) pairs, optionally walked
+// backwards.  Such paths are added to Clipper and ClipperOffset without copying them to a
+// Path first.
+struct IntPairPath
+{
+    const int*  XY;
+    size_t      Count;
+    bool        Reversed;
+
+    IntPairPath( const int* xy = 0, size_t count = 0, bool reversed = false ) :
+        XY( xy ), Count( count ), Reversed( reversed ) {};
+
+    size_t size() const { return Count; };
+
+    IntPoint operator[]( size_t i ) const
+    {
+        size_t j = Reversed ? Count - 1 - i : i;
+        return IntPoint( XY[2 * j], XY[2 * j + 1] );
+    };
+};
+
 inline Path& operator <<( Path& poly, const IntPoint& p )
 {
     poly.push_back( p ); return poly;
@@ -203,7 +224,9 @@ private:
 };
 
 bool    Orientation( const Path& poly );
+bool    Orientation( const IntPairPath& poly );
 double  Area( const Path& poly );
+double  Area( const IntPairPath& poly );
 int     PointInPolygon( const IntPoint& pt, const Path& path );
 
 void SimplifyPolygon( const Path& in_poly, Paths& out_polys,
@@ -264,6 +287,7 @@ public:
     ClipperBase();
     virtual ~ClipperBase();
     virtual bool    AddPath( const Path& pg, PolyType PolyTyp, bool Closed );
+    bool            AddPath( const IntPairPath& pg, PolyType PolyTyp, bool Closed );
     bool            AddPaths( const Paths& ppg, PolyType PolyTyp, bool Closed );
     virtual void    Clear();
     IntRect         GetBounds();
@@ -272,6 +296,8 @@ public:
     void PreserveCollinear( bool value ) { m_PreserveCollinear = value; };
 
 protected:
+    template <class PathType>
+    bool            AddPathT( const PathType& pg, PolyType PolyTyp, bool Closed );
     void            DisposeLocalMinimaList();
     TEdge*          AddBoundsToLML( TEdge* e, bool IsClosed );
     virtual void    Reset();
@@ -412,6 +438,7 @@ public:
     ClipperOffset( double miterLimit = 2.0, double roundPrecision = 0.25 );
     ~ClipperOffset();
     void    AddPath( const Path& path, JoinType joinType, EndType endType );
+    void    AddPath( const IntPairPath& path, JoinType joinType, EndType endType );
     void    AddPaths( const Paths& paths, JoinType joinType, EndType endType );
     void    Execute( Paths& solution, double delta );
     void    Execute( PolyTree& solution, double delta );
@@ -420,6 +447,9 @@ public:
     double MiterLimit;
     JoinType MiterFallback;
     double ArcTolerance;
+    // when true, convex corners whose miter point is within the arc tolerance of the
+    // offset are made of that single point instead of the round or square join
+    bool CompactJoins;
 
 private:
     Paths m_destPolys;
@@ -428,14 +458,18 @@ private:
     std::vector<DoublePoint> m_normals;
     double m_delta, m_sinA, m_sin, m_cos;
     double m_miterLim, m_StepsPerRad;
+    double m_compactTolerance;
     IntPoint m_lowest;
     PolyNode m_polyNodes;
 
+    template <class PathType>
+    void    AddPathT( const PathType& path, JoinType joinType, EndType endType );
     void    FixOrientations();
     void    DoOffset( double delta );
     void    OffsetPoint( int j, int& k, JoinType jointype );
     void    DoSquare( int j, int k );
     void    DoMiter( int j, int k, double r );
+    bool    CompactJoin( int j, int k );
     void    DoRound( int j, int k );
 };
 // ------------------------------------------------------------------------------
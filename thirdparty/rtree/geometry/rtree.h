@@ -15,6 +15,7 @@
 //    * 2004 Templated C++ port by Greg Douglas
 //    * 2013 CERN (www.cern.ch)
 //    * 2020 KiCad Developers - Add std::iterator support for searching
+//    * 2020 KiCad Developers - Add Sort-Tile-Recursive bulk loading
 //
 //LICENSE:
 //
@@ -35,6 +36,8 @@
 #include <array>
 #include <functional>
 #include <iterator>
+#include <utility>
+#include <vector>
 
 #ifdef DEBUG
 #define ASSERT assert    // RTree uses ASSERT( condition )
@@ -186,6 +189,12 @@ public:
     /// Remove all entries from tree
     void    RemoveAll();
 
+    /// Replace the content of the tree by a_items, packed with the Sort-Tile-Recursive
+    /// algorithm.  This is much faster than inserting the items one by one, and the nodes of
+    /// the resulting tree overlap less, which speeds up the searches.
+    /// \param a_items the bounds and data of the items.  They are reordered by the call.
+    void    BulkLoad( std::vector<std::pair<Rect, DATATYPE>>& a_items );
+
     /// Count the data elements in this container.  This is slow as no internal counter is maintained.
     int     Count();
 
@@ -497,6 +506,10 @@ protected:
         bool isLeaf;
     };
 
+    typedef typename std::vector<Branch>::iterator BranchIter;
+
+    void            BulkPack( BranchIter a_first, BranchIter a_last, const int* a_axes,
+                              int a_axis, int a_level, std::vector<Branch>& a_parents );
     Node*           AllocNode();
     void            FreeNode( Node* a_node );
     void            InitNode( Node* a_node );
@@ -1090,6 +1103,105 @@ void RTREE_QUAL::RemoveAll()
 }
 
 
+RTREE_TEMPLATE
+void RTREE_QUAL::BulkLoad( std::vector<std::pair<Rect, DATATYPE>>& a_items )
+{
+    RemoveAll();
+
+    if( a_items.empty() )
+        return;
+
+    std::vector<Branch> branches( a_items.size() );
+    Rect                bounds = a_items[0].first;
+
+    for( size_t i = 0; i < a_items.size(); ++i )
+    {
+        branches[i].m_rect = a_items[i].first;
+        branches[i].m_data = a_items[i].second;
+        bounds = CombineRect( &bounds, &a_items[i].first );
+    }
+
+    // Tile along the axes of largest extent first: slicing along an axis spanning only a
+    // few values (such as a layer range) would give slabs covering the whole tree.
+    int axes[NUMDIMS];
+
+    for( int axis = 0; axis < NUMDIMS; ++axis )
+        axes[axis] = axis;
+
+    std::stable_sort( axes, axes + NUMDIMS, [&bounds]( int a, int b )
+            {
+                return (double) bounds.m_max[a] - bounds.m_min[a]
+                       > (double) bounds.m_max[b] - bounds.m_min[b];
+            } );
+
+    int level = 0;
+
+    while( branches.size() > MAXNODES )
+    {
+        std::vector<Branch> parents;
+
+        parents.reserve( branches.size() / MAXNODES + NUMDIMS );
+        BulkPack( branches.begin(), branches.end(), axes, 0, level, parents );
+        branches.swap( parents );
+        ++level;
+    }
+
+    m_root->m_level = level;
+
+    for( const Branch& branch : branches )
+        m_root->m_branch[m_root->m_count++] = branch;
+}
+
+
+RTREE_TEMPLATE
+void RTREE_QUAL::BulkPack( BranchIter a_first, BranchIter a_last, const int* a_axes,
+                           int a_axis, int a_level, std::vector<Branch>& a_parents )
+{
+    size_t count = a_last - a_first;
+    size_t nodes = ( count + MAXNODES - 1 ) / MAXNODES;
+    int    axis = a_axes[a_axis];
+
+    std::sort( a_first, a_last, [axis]( const Branch& a, const Branch& b )
+            {
+                return (double) a.m_rect.m_min[axis] + a.m_rect.m_max[axis]
+                       < (double) b.m_rect.m_min[axis] + b.m_rect.m_max[axis];
+            } );
+
+    if( a_axis == NUMDIMS - 1 || nodes <= 1 )
+    {
+        // Spread the branches evenly over the nodes
+        for( size_t i = 0; i < nodes; ++i )
+        {
+            Node* node = AllocNode();
+            node->m_level = a_level;
+
+            for( BranchIter it = a_first + count * i / nodes;
+                 it != a_first + count * ( i + 1 ) / nodes; ++it )
+            {
+                node->m_branch[node->m_count++] = *it;
+            }
+
+            Branch branch;
+            branch.m_rect = NodeCover( node );
+            branch.m_child = node;
+            a_parents.push_back( branch );
+        }
+
+        return;
+    }
+
+    // Cut the branches into slabs along this axis, each one made of whole nodes
+    size_t slabs = (size_t) std::ceil( std::pow( (double) nodes, 1.0 / ( NUMDIMS - a_axis ) ) );
+    size_t slabSize = ( ( nodes + slabs - 1 ) / slabs ) * MAXNODES;
+
+    for( size_t start = 0; start < count; start += slabSize )
+    {
+        BulkPack( a_first + start, a_first + std::min( count, start + slabSize ), a_axes,
+                  a_axis + 1, a_level, a_parents );
+    }
+}
+
+
 RTREE_TEMPLATE
 void RTREE_QUAL::Reset()
 {
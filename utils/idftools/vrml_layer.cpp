@@ -31,6 +31,7 @@
 // 3. a scheme is needed to tell a castellated edge from a plain board edge
 
 
+#include <algorithm>
 #include <sstream>
 #include <string>
 #include <iomanip>
@@ -316,7 +317,7 @@ int VRML_LAYER::NewContour(  bool aPlatedHole )
     if( fix )
         return -1;
 
-    std::list<int>* contour = new std::list<int>;
+    std::vector<int>* contour = new std::vector<int>;
 
     contours.push_back( contour );
     areas.push_back( 0.0 );
@@ -376,7 +377,7 @@ bool VRML_LAYER::EnsureWinding( int aContourID, bool aHoleFlag )
         return false;
     }
 
-    std::list<int>* cp = contours[aContourID];
+    std::vector<int>* cp = contours[aContourID];
 
     if( cp->size() < 3 )
     {
@@ -394,7 +395,7 @@ bool VRML_LAYER::EnsureWinding( int aContourID, bool aHoleFlag )
     // if dir is positive, winding is CW
     if( ( aHoleFlag && dir < 0 ) || ( !aHoleFlag && dir > 0 ) )
     {
-        cp->reverse();
+        std::reverse( cp->begin(), cp->end() );
         areas[aContourID] = -areas[aContourID];
     }
 
@@ -926,14 +927,14 @@ bool VRML_LAYER::pushOutline( VRML_LAYER* holes )
         return false;
     }
 
-    std::list<std::list<int>*>::const_iterator obeg = outline.begin();
-    std::list<std::list<int>*>::const_iterator oend = outline.end();
+    std::vector<std::vector<int>*>::const_iterator obeg = outline.begin();
+    std::vector<std::vector<int>*>::const_iterator oend = outline.end();
 
     int nc = 0; // number of contours pushed
 
     int pi;
-    std::list<int>::const_iterator  begin;
-    std::list<int>::const_iterator  end;
+    std::vector<int>::const_iterator  begin;
+    std::vector<int>::const_iterator  end;
     GLdouble pt[3];
     VERTEX_3D* vp;
 
@@ -1138,8 +1139,8 @@ bool VRML_LAYER::WriteIndices( bool aTopFlag, std::ostream& aOutFile )
     }
 
     // go through the triplet list and write out the indices based on order
-    std::list<TRIPLET_3D>::const_iterator   tbeg    = triplets.begin();
-    std::list<TRIPLET_3D>::const_iterator   tend    = triplets.end();
+    std::vector<TRIPLET_3D>::const_iterator   tbeg    = triplets.begin();
+    std::vector<TRIPLET_3D>::const_iterator   tend    = triplets.end();
 
     int i = 1;
 
@@ -1196,8 +1197,8 @@ bool VRML_LAYER::Write3DIndices( std::ostream& aOutFile, bool aIncludePlatedHole
         mark = ',';
 
         // go through the triplet list and write out the indices based on order
-        std::list<TRIPLET_3D>::const_iterator   tbeg    = triplets.begin();
-        std::list<TRIPLET_3D>::const_iterator   tend    = triplets.end();
+        std::vector<TRIPLET_3D>::const_iterator   tbeg    = triplets.begin();
+        std::vector<TRIPLET_3D>::const_iterator   tend    = triplets.end();
 
         // print out the top vertices
         aOutFile << tbeg->i1 << ", " << tbeg->i2 << ", " << tbeg->i3  << ", -1";
@@ -1245,11 +1246,11 @@ bool VRML_LAYER::Write3DIndices( std::ostream& aOutFile, bool aIncludePlatedHole
     int curPoint;
     int curContour = 0;
 
-    std::list<std::list<int>*>::const_iterator  obeg    = outline.begin();
-    std::list<std::list<int>*>::const_iterator  oend    = outline.end();
-    std::list<int>* cp;
-    std::list<int>::const_iterator  cbeg;
-    std::list<int>::const_iterator  cend;
+    std::vector<std::vector<int>*>::const_iterator  obeg    = outline.begin();
+    std::vector<std::vector<int>*>::const_iterator  oend    = outline.end();
+    std::vector<int>* cp;
+    std::vector<int>::const_iterator  cbeg;
+    std::vector<int>::const_iterator  cend;
 
     i = 2;
     while( obeg != oend )
@@ -1445,7 +1446,8 @@ void VRML_LAYER::glEnd( void )
     case GL_LINE_LOOP:
         {
             // add the loop to the list of outlines
-            std::list<int>* loop = new std::list<int>;
+            std::vector<int>* loop = new std::vector<int>;
+            loop->reserve( vlist.size() );
 
             double firstX = 0.0;
             double firstY = 0.0;
@@ -1624,8 +1626,8 @@ void VRML_LAYER::pushVertices( bool holes )
     // push the internally held vertices
     unsigned int i;
 
-    std::list<int>::const_iterator  begin;
-    std::list<int>::const_iterator  end;
+    std::vector<int>::const_iterator  begin;
+    std::vector<int>::const_iterator  end;
     GLdouble pt[3];
     VERTEX_3D* vp;
 
@@ -1737,8 +1739,8 @@ int VRML_LAYER::Import( int start, GLUtesselator* aTesselator )
     VERTEX_3D* vp;
     GLdouble pt[3];
 
-    std::list<int>::const_iterator cbeg;
-    std::list<int>::const_iterator cend;
+    std::vector<int>::const_iterator cbeg;
+    std::vector<int>::const_iterator cend;
 
     for( i = 0; i < contours.size(); ++i )
     {
@@ -1856,8 +1858,8 @@ bool VRML_LAYER::Get3DTriangles( std::vector< double >& aVertexList,
     if( !holes_only )
     {
         // go through the triplet list and write out the indices based on order
-        std::list< TRIPLET_3D >::const_iterator tbeg = triplets.begin();
-        std::list< TRIPLET_3D >::const_iterator tend = triplets.end();
+        std::vector< TRIPLET_3D >::const_iterator tbeg = triplets.begin();
+        std::vector< TRIPLET_3D >::const_iterator tend = triplets.end();
 
         std::vector< int > aIndexBot;
 
@@ -1884,11 +1886,11 @@ bool VRML_LAYER::Get3DTriangles( std::vector< double >& aVertexList,
     int curPoint;
     int curContour = 0;
 
-    std::list< std::list< int >* >::const_iterator  obeg = outline.begin();
-    std::list< std::list< int >* >::const_iterator  oend = outline.end();
-    std::list< int >* cp;
-    std::list< int >::const_iterator  cbeg;
-    std::list< int >::const_iterator  cend;
+    std::vector< std::vector< int >* >::const_iterator  obeg = outline.begin();
+    std::vector< std::vector< int >* >::const_iterator  oend = outline.end();
+    std::vector< int >* cp;
+    std::vector< int >::const_iterator  cbeg;
+    std::vector< int >::const_iterator  cend;
 
     i = 2;
     while( obeg != oend )
@@ -2010,8 +2012,8 @@ bool VRML_LAYER::Get2DTriangles( std::vector< double >& aVertexList,
         return false;
 
     // go through the triplet list and write out the indices based on order
-    std::list< TRIPLET_3D >::const_iterator tbeg = triplets.begin();
-    std::list< TRIPLET_3D >::const_iterator tend = triplets.end();
+    std::vector< TRIPLET_3D >::const_iterator tbeg = triplets.begin();
+    std::vector< TRIPLET_3D >::const_iterator tend = triplets.end();
 
     std::vector< int > aIndexBot;
 
@@ -106,12 +106,12 @@ private:
     int     idx;                            // vertex index (number of contained vertices)
     int     ord;                            // vertex order (number of ordered vertices)
     std::vector<VERTEX_3D*> vertices;       // vertices of all contours
-    std::vector<std::list<int>*> contours;  // lists of vertices for each contour
+    std::vector<std::vector<int>*> contours; // lists of vertices for each contour
     std::vector<bool>pth;                   // indicates whether a 'contour' is a PTH or not
     std::vector<bool>solid;                 // indicates whether a 'contour' is a solid or a hole
     std::vector< double > areas;            // area of the contours (positive if winding is CCW)
-    std::list<TRIPLET_3D> triplets;         // output facet triplet list (triplet of ORDER values)
-    std::list<std::list<int>*> outline;     // indices for outline outputs (index by ORDER values)
+    std::vector<TRIPLET_3D> triplets;       // output facet triplet list (triplet of ORDER values)
+    std::vector<std::vector<int>*> outline; // indices for outline outputs (index by ORDER values)
     std::vector<int> ordmap;                // mapping of ORDER to INDEX
 
     std::string error;                      // error message
@@ -394,3 +394,20 @@ bool KICADMODULE::ComposePCB( class PCBMODEL* aPCB, S3D_RESOLVER* resolver,
 
     return hasdata;
 }
+
+
+void KICADMODULE::GetModelFileNames( S3D_RESOLVER* resolver, std::vector<std::string>& aFileNames,
+    bool aComposeVirtual ) const
+{
+    if( m_virtual && !aComposeVirtual )
+        return;
+
+    for( auto i : m_models )
+    {
+        std::string fname( resolver->ResolvePath(
+            wxString::FromUTF8Unchecked( i->m_modelname.c_str() ) ).ToUTF8() );
+
+        if( !fname.empty() )
+            aFileNames.push_back( fname );
+    }
+}
@@ -77,6 +77,10 @@ public:
 
     bool ComposePCB( class PCBMODEL* aPCB, S3D_RESOLVER* resolver,
         DOUBLET aOrigin, bool aComposeVirtual = true );
+
+    // append the resolved file names of the models ComposePCB() adds to aFileNames
+    void GetModelFileNames( S3D_RESOLVER* resolver, std::vector<std::string>& aFileNames,
+        bool aComposeVirtual = true ) const;
 };
 
 #endif  // KICADMODULE_H
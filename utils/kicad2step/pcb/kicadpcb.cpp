@@ -137,9 +137,11 @@ bool KICADPCB::ReadFile( const wxString& aFileName )
 
     try
     {
+        // The whole tree is freed with the arena, at the end of the parsing
+        SEXPR::SEXPR_ARENA arena;
         SEXPR::PARSER parser;
         std::string infile( fname.GetFullPath().ToUTF8() );
-        std::unique_ptr<SEXPR::SEXPR> data( parser.ParseFromFile( infile ) );
+        SEXPR::SEXPR* data = parser.ParseFromFile( infile, arena );
 
         if( !data )
         {
@@ -147,7 +149,7 @@ bool KICADPCB::ReadFile( const wxString& aFileName )
             return false;
         }
 
-        if( !parsePCB( data.get() ) )
+        if( !parsePCB( data ) )
             return false;
     }
     catch( std::exception& e )
@@ -449,6 +451,13 @@ bool KICADPCB::ComposePCB( bool aComposeVirtual )
         m_pcb_model->AddOutlineSegment( &lcurve );
     }
 
+    std::vector<std::string> modelFiles;
+
+    for( auto i : m_modules )
+        i->GetModelFileNames( &m_resolver, modelFiles, aComposeVirtual );
+
+    m_pcb_model->ReadModels( modelFiles );
+
     for( auto i : m_modules )
         i->ComposePCB( m_pcb_model, &m_resolver, origin, aComposeVirtual );
 
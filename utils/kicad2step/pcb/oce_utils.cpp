@@ -22,9 +22,12 @@
  */
 
 #include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <future>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <utility>
 #include <wx/wx.h>
 #include <wx/filename.h>
@@ -41,6 +44,7 @@
 #include <IGESData_IGESModel.hxx>
 #include <Interface_Static.hxx>
 #include <Quantity_Color.hxx>
+#include <STEPCAFControl_Controller.hxx>
 #include <STEPCAFControl_Reader.hxx>
 #include <STEPCAFControl_Writer.hxx>
 #include <APIHeaderSection_MakeHeader.hxx>
@@ -62,7 +66,13 @@
 #include <BRepBuilderAPI_MakeFace.hxx>
 #include <BRepPrimAPI_MakePrism.hxx>
 #include <BRepPrimAPI_MakeCylinder.hxx>
+#include <BRepAlgoAPI_Common.hxx>
 #include <BRepAlgoAPI_Cut.hxx>
+#include <BRepAlgoAPI_Fuse.hxx>
+#include <BRepBndLib.hxx>
+#include <BRepPrimAPI_MakeBox.hxx>
+#include <Bnd_Box.hxx>
+#include <ShapeUpgrade_UnifySameDomain.hxx>
 
 #include <TopoDS.hxx>
 #include <TopoDS_Wire.hxx>
@@ -87,6 +97,10 @@ static constexpr double THICKNESS_DEFAULT = 1.6;
 static constexpr double BOARD_OFFSET = 0.05;
 // min. length**2 below which 2 points are considered coincident
 static constexpr double MIN_LENGTH2 = MIN_DISTANCE * MIN_DISTANCE;
+// The holes are cut in tiles of the board when there are at least this number of holes
+static constexpr size_t TILED_CUT_MIN_HOLES = 1000;
+// The approximate number of holes cut in a tile
+static constexpr size_t HOLES_PER_TILE = 500;
 
 static void getEndPoints( const KICADCURVE& aCurve, double& spx0, double& spy0,
     double& epx0, double& epy0 )
@@ -215,6 +229,90 @@ FormatType fileType( const char* aFileName )
 }
 
 
+// initialize the IGES and STEP readers; their settings are static, so this must not be
+// called while a model is read
+static bool initModelReaders()
+{
+    IGESControl_Controller::Init();
+    STEPCAFControl_Controller::Init();
+
+    // Enable user-defined shape precision
+    if( !Interface_Static::SetIVal( "read.precision.mode", 1 ) )
+        return false;
+
+    // Set the shape conversion precision to USER_PREC (default 0.0001 has too many triangles)
+    if( !Interface_Static::SetRVal( "read.precision.val", USER_PREC ) )
+        return false;
+
+    return true;
+}
+
+
+// the STEP or IGES files which may replace a WRL file, in order of preference
+static std::vector<std::string> alternateModelFileNames( const std::string& aFileName )
+{
+    wxFileName wrlName( aFileName );
+
+    wxString basePath = wrlName.GetPath();
+    wxString baseName = wrlName.GetName();
+
+    // List of alternate files to look for
+    // Given in order of preference
+    wxArrayString alts;
+
+    // Step files
+    alts.Add( "stp" );
+    alts.Add( "step" );
+    alts.Add( "STP" );
+    alts.Add( "STEP" );
+    alts.Add( "Stp" );
+    alts.Add( "Step" );
+
+    // IGES files
+    alts.Add( "iges" );
+    alts.Add( "IGES" );
+    alts.Add( "igs" );
+    alts.Add( "IGS" );
+
+    //TODO - Other alternative formats?
+
+    std::vector<std::string> fileNames;
+
+    for( const auto& alt : alts )
+    {
+        wxFileName altFile( basePath, baseName + "." + alt );
+
+        if( altFile.IsOk() && altFile.FileExists() )
+            fileNames.push_back( altFile.GetFullPath().ToStdString() );
+    }
+
+    return fileNames;
+}
+
+
+// subtract aTools from aShape, using the parallel mode of the boolean operations
+static bool cutShapes( TopoDS_Shape& aShape, const TopTools_ListOfShape& aTools )
+{
+    if( aTools.IsEmpty() )
+        return true;
+
+    BRepAlgoAPI_Cut Cut;
+    TopTools_ListOfShape args;
+    args.Append( aShape );
+
+    Cut.SetArguments( args );
+    Cut.SetTools( aTools );
+    Cut.SetRunParallel( Standard_True );
+    Cut.Build();
+
+    if( !Cut.IsDone() )
+        return false;
+
+    aShape = Cut.Shape();
+    return true;
+}
+
+
 PCBMODEL::PCBMODEL()
 {
     m_app = XCAFApp_Application::GetApplication();
@@ -776,23 +874,9 @@ bool PCBMODEL::CreatePCB()
             ReportMessage( wxString::Format( ". %d/%d\n", cur_count, cntmax ) );
         }
     }
-#else   // Much faster than first version: group all holes and cut only once
-    if( m_cutouts.size() )
-    {
-        BRepAlgoAPI_Cut Cut;
-        TopTools_ListOfShape mainbrd;
-        mainbrd.Append( board );
-
-        Cut.SetArguments( mainbrd );
-        TopTools_ListOfShape holelist;
-
-        for( auto hole : m_cutouts )
-             holelist.Append( hole );
-
-        Cut.SetTools( holelist );
-        Cut.Build();
-        board = Cut.Shape();
-    }
+#else   // Much faster than first version: group all holes and cut only once (per tile)
+    if( m_cutouts.size() && !cutHoles( board ) )
+        ReportMessage( "could not cut the board holes\n" );
 #endif
 
     // push the board to the data structure
@@ -824,6 +908,122 @@ bool PCBMODEL::CreatePCB()
 }
 
 
+bool PCBMODEL::cutHoles( TopoDS_Shape& aBoard )
+{
+    auto cutAll = [&]() -> bool
+    {
+        TopTools_ListOfShape holelist;
+
+        for( const TopoDS_Shape& hole : m_cutouts )
+            holelist.Append( hole );
+
+        return cutShapes( aBoard, holelist );
+    };
+
+    if( m_cutouts.size() < TILED_CUT_MIN_HOLES )
+        return cutAll();
+
+    // Each face of the board is split by all of its holes at once, which is much slower than
+    // splitting the faces of small tiles of the board: cut the holes in each tile, then fuse
+    // the tiles and merge back the faces they split.
+    Bnd_Box bbox;
+    BRepBndLib::Add( aBoard, bbox );
+
+    double xmin, ymin, zmin, xmax, ymax, zmax;
+    bbox.Get( xmin, ymin, zmin, xmax, ymax, zmax );
+
+    int    tiles = (int) std::ceil( std::sqrt( (double) m_cutouts.size() / HOLES_PER_TILE ) );
+    double dx = ( xmax - xmin ) / tiles;
+    double dy = ( ymax - ymin ) / tiles;
+
+    std::vector<Bnd_Box> holeBoxes( m_cutouts.size() );
+
+    for( size_t ii = 0; ii < m_cutouts.size(); ii++ )
+        BRepBndLib::Add( m_cutouts[ii], holeBoxes[ii] );
+
+    ReportMessage( wxString::Format( "Cut the holes in %d tiles\n", tiles * tiles ) );
+
+    TopTools_ListOfShape pieces;
+
+    for( int row = 0; row < tiles; row++ )
+    {
+        for( int col = 0; col < tiles; col++ )
+        {
+            gp_Pnt p0( xmin + col * dx, ymin + row * dy, zmin - 1.0 );
+            gp_Pnt p1( xmin + ( col + 1 ) * dx, ymin + ( row + 1 ) * dy, zmax + 1.0 );
+
+            BRepAlgoAPI_Common common( aBoard, BRepPrimAPI_MakeBox( p0, p1 ).Shape() );
+
+            if( !common.IsDone() )
+            {
+                ReportMessage( "could not split the board in tiles, cutting all the holes at once\n" );
+                return cutAll();
+            }
+
+            TopoDS_Shape    tile = common.Shape();
+            TopExp_Explorer solids( tile, TopAbs_SOLID );
+
+            if( !solids.More() )    // no board in this tile
+                continue;
+
+            Bnd_Box tileBox;
+            tileBox.Update( p0.X(), p0.Y(), p0.Z(), p1.X(), p1.Y(), p1.Z() );
+
+            TopTools_ListOfShape holelist;
+
+            for( size_t ii = 0; ii < m_cutouts.size(); ii++ )
+            {
+                if( !tileBox.IsOut( holeBoxes[ii] ) )
+                    holelist.Append( m_cutouts[ii] );
+            }
+
+            if( !cutShapes( tile, holelist ) )
+            {
+                ReportMessage( "could not cut the holes of a tile, cutting all the holes at once\n" );
+                return cutAll();
+            }
+
+            pieces.Append( tile );
+            ReportMessage( "." );
+        }
+    }
+
+    ReportMessage( "\n" );
+
+    if( pieces.IsEmpty() )
+        return cutAll();
+
+    if( pieces.Extent() == 1 )
+    {
+        aBoard = pieces.First();
+        return true;
+    }
+
+    BRepAlgoAPI_Fuse Fuse;
+    TopTools_ListOfShape args;
+    args.Append( pieces.First() );
+    pieces.RemoveFirst();
+
+    Fuse.SetArguments( args );
+    Fuse.SetTools( pieces );
+    Fuse.SetRunParallel( Standard_True );
+    Fuse.Build();
+
+    if( !Fuse.IsDone() )
+    {
+        ReportMessage( "could not fuse the board tiles, cutting all the holes at once\n" );
+        return cutAll();
+    }
+
+    ShapeUpgrade_UnifySameDomain unify( Fuse.Shape(), Standard_True, Standard_True,
+                                        Standard_False );
+    unify.Build();
+    aBoard = unify.Shape();
+
+    return true;
+}
+
+
 #ifdef SUPPORTS_IGES
 // write the assembly model in IGES format
 bool PCBMODEL::WriteIGES( const wxString& aFileName )
@@ -923,14 +1123,13 @@ bool PCBMODEL::getModelLabel( const std::string aFileName, TRIPLET aScale, TDF_L
     aLabel.Nullify();
 
     Handle( TDocStd_Document )  doc;
-    m_app->NewDocument( "MDTV-XCAF", doc );
 
     FormatType modelFmt = fileType( aFileName.c_str() );
 
     switch( modelFmt )
     {
         case FMT_IGES:
-            if( !readIGES( doc, aFileName.c_str() ) )
+            if( !getModelDocument( doc, aFileName, true ) )
             {
                 ReportMessage( wxString::Format( "readIGES() failed on filename %s\n",
                                aFileName ) );
@@ -939,7 +1138,7 @@ bool PCBMODEL::getModelLabel( const std::string aFileName, TRIPLET aScale, TDF_L
             break;
 
         case FMT_STEP:
-            if( !readSTEP( doc, aFileName.c_str() ) )
+            if( !getModelDocument( doc, aFileName, false ) )
             {
                 ReportMessage( wxString::Format( "readSTEP() failed on filename %s\n",
                                aFileName ) );
@@ -959,49 +1158,16 @@ bool PCBMODEL::getModelLabel( const std::string aFileName, TRIPLET aScale, TDF_L
              * for THAT file will be associated with the .wrl file
              *
              */
+            for( const std::string& altFileName : alternateModelFileNames( aFileName ) )
             {
-                wxFileName wrlName( aFileName );
-
-                wxString basePath = wrlName.GetPath();
-                wxString baseName = wrlName.GetName();
-
-                // List of alternate files to look for
-                // Given in order of preference
-                // (Break if match is found)
-                wxArrayString alts;
-
-                // Step files
-                alts.Add( "stp" );
-                alts.Add( "step" );
-                alts.Add( "STP" );
-                alts.Add( "STEP" );
-                alts.Add( "Stp" );
-                alts.Add( "Step" );
-
-                // IGES files
-                alts.Add( "iges" );
-                alts.Add( "IGES" );
-                alts.Add( "igs" );
-                alts.Add( "IGS" );
-
-                //TODO - Other alternative formats?
-
-                for( const auto& alt : alts )
+                if( getModelLabel( altFileName, aScale, aLabel ) )
                 {
-                    wxFileName altFile( basePath, baseName + "." + alt );
-
-                    if( altFile.IsOk() && altFile.FileExists() )
-                    {
-                        std::string altFileName = altFile.GetFullPath().ToStdString();
-
-                        if( getModelLabel( altFileName, aScale, aLabel ) )
-                        {
-                            return true;
-                        }
-                    }
+                    return true;
                 }
             }
 
+            // No replacement file: the model is empty
+            m_app->NewDocument( "MDTV-XCAF", doc );
             break;
 
         // TODO: implement IDF and EMN converters
@@ -1031,6 +1197,118 @@ bool PCBMODEL::getModelLabel( const std::string aFileName, TRIPLET aScale, TDF_L
 }
 
 
+bool PCBMODEL::getModelDocument( Handle( TDocStd_Document )& aDoc, const std::string& aFileName,
+    bool aIGES )
+{
+    auto it = m_readModels.find( aFileName );
+
+    if( it != m_readModels.end() )
+    {
+        aDoc = it->second;
+        m_readModels.erase( it );
+        return !aDoc.IsNull();
+    }
+
+    if( !initModelReaders() )
+        return false;
+
+    m_app->NewDocument( "MDTV-XCAF", aDoc );
+
+    return aIGES ? readIGES( aDoc, aFileName.c_str() ) : readSTEP( aDoc, aFileName.c_str() );
+}
+
+
+void PCBMODEL::ReadModels( const std::vector<std::string>& aFileNames )
+{
+    // The STEP and IGES files to read, the WRL files being replaced by their alternative
+    std::vector<std::string> files;
+
+    for( const std::string& fileName : aFileNames )
+    {
+        FormatType fmt = fileType( fileName.c_str() );
+
+        if( fmt == FMT_WRL )
+        {
+            std::vector<std::string> alts = alternateModelFileNames( fileName );
+
+            if( !alts.empty() )
+                files.push_back( alts.front() );
+        }
+        else if( fmt == FMT_STEP || fmt == FMT_IGES )
+        {
+            files.push_back( fileName );
+        }
+    }
+
+    std::sort( files.begin(), files.end() );
+    files.erase( std::unique( files.begin(), files.end() ), files.end() );
+
+    if( files.size() < 2 )
+        return;     // read when used
+
+    ReportMessage( wxString::Format( "Read %d models\n", (int) files.size() ) );
+
+    // The documents and the reader settings are shared: set them up before the threads
+    std::vector<bool>                         isIGES( files.size() );
+    std::vector<Handle( TDocStd_Document )>   docs( files.size() );
+
+    for( size_t ii = 0; ii < files.size(); ii++ )
+    {
+        isIGES[ii] = fileType( files[ii].c_str() ) == FMT_IGES;
+        m_app->NewDocument( "MDTV-XCAF", docs[ii] );
+    }
+
+    if( !initModelReaders() )
+        return;
+
+    std::vector<char>   readOk( files.size(), 0 );
+    std::atomic<size_t> nextItem( 0 );
+
+    auto read_lambda = [&]() -> size_t
+    {
+        size_t num = 0;
+
+        for( size_t ii = nextItem++; ii < files.size(); ii = nextItem++ )
+        {
+            try
+            {
+                readOk[ii] = isIGES[ii] ? readIGES( docs[ii], files[ii].c_str() )
+                                        : readSTEP( docs[ii], files[ii].c_str() );
+            }
+            catch( const Standard_Failure& )
+            {
+                readOk[ii] = false;
+            }
+
+            num++;
+        }
+
+        return num;
+    };
+
+    size_t parallelThreadCount = std::min<size_t>( std::thread::hardware_concurrency(),
+                                                   files.size() );
+    std::vector<std::future<size_t>> returns( parallelThreadCount );
+
+    if( parallelThreadCount <= 1 )
+    {
+        read_lambda();
+    }
+    else
+    {
+        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+            returns[ii] = std::async( std::launch::async, read_lambda );
+
+        for( auto& ret : returns )
+            ret.wait();
+    }
+
+    // The files which could not be read are not read again, and reported when used
+    for( size_t ii = 0; ii < files.size(); ii++ )
+        m_readModels[files[ii]] = readOk[ii] ? docs[ii] : Handle( TDocStd_Document )();
+}
+
+
 bool PCBMODEL::getModelLocation( bool aBottom, DOUBLET aPosition, double aRotation,
     TRIPLET aOffset, TRIPLET aOrientation, TopLoc_Location& aLocation )
 {
@@ -1089,21 +1367,13 @@ bool PCBMODEL::getModelLocation( bool aBottom, DOUBLET aPosition, double aRotati
 
 bool PCBMODEL::readIGES( Handle( TDocStd_Document )& doc, const char* fname )
 {
-    IGESControl_Controller::Init();
+    // The static settings of the reader are set by initModelReaders()
     IGESCAFControl_Reader reader;
     IFSelect_ReturnStatus stat  = reader.ReadFile( fname );
 
     if( stat != IFSelect_RetDone )
         return false;
 
-    // Enable user-defined shape precision
-    if( !Interface_Static::SetIVal( "read.precision.mode", 1 ) )
-        return false;
-
-    // Set the shape conversion precision to USER_PREC (default 0.0001 has too many triangles)
-    if( !Interface_Static::SetRVal( "read.precision.val", USER_PREC ) )
-        return false;
-
     // set other translation options
     reader.SetColorMode(true);  // use model colors
     reader.SetNameMode(false);  // don't use IGES label names
@@ -1128,20 +1398,13 @@ bool PCBMODEL::readIGES( Handle( TDocStd_Document )& doc, const char* fname )
 
 bool PCBMODEL::readSTEP( Handle(TDocStd_Document)& doc, const char* fname )
 {
+    // The static settings of the reader are set by initModelReaders()
     STEPCAFControl_Reader reader;
     IFSelect_ReturnStatus stat  = reader.ReadFile( fname );
 
     if( stat != IFSelect_RetDone )
         return false;
 
-    // Enable user-defined shape precision
-    if( !Interface_Static::SetIVal( "read.precision.mode", 1 ) )
-        return false;
-
-    // Set the shape conversion precision to USER_PREC (default 0.0001 has too many triangles)
-    if( !Interface_Static::SetRVal( "read.precision.val", USER_PREC ) )
-        return false;
-
     // set other translation options
     reader.SetColorMode(true);  // use model colors
     reader.SetNameMode(false);  // don't use label names
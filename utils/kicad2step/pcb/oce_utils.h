@@ -99,8 +99,18 @@ class PCBMODEL
     std::list< KICADCURVE >     m_curves;
     std::vector< TopoDS_Shape > m_cutouts;
 
+    // the model documents read by ReadModels() and not transferred yet (null if not readable)
+    std::map< std::string, Handle( TDocStd_Document ) > m_readModels;
+
     bool getModelLabel( const std::string aFileName, TRIPLET aScale, TDF_Label& aLabel );
 
+    // get the document of a model, read by ReadModels() or read now
+    bool getModelDocument( Handle( TDocStd_Document )& aDoc, const std::string& aFileName,
+        bool aIGES );
+
+    // subtract m_cutouts from aBoard, the board being split in tiles when there are many holes
+    bool cutHoles( TopoDS_Shape& aBoard );
+
     bool getModelLocation( bool aBottom, DOUBLET aPosition, double aRotation,
         TRIPLET aOffset, TRIPLET aOrientation, TopLoc_Location& aLocation );
 
@@ -120,6 +130,9 @@ public:
     // add a pad hole or slot (must be in final position)
     bool AddPadHole( KICADPAD* aPad );
 
+    // read concurrently the distinct model files of the components, before adding them
+    void ReadModels( const std::vector<std::string>& aFileNames );
+
     // add a component at the given position and orientation
     bool AddComponent( const std::string& aFileName, const std::string& aRefDes,
         bool aBottom, DOUBLET aPosition, double aRotation,